@@ -0,0 +1,119 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Baselines of the benchmarks in TESTS/benchmarks
+//
+// A baseline is the median expected for a benchmark on the target, in the
+// unit of the benchmark: the benchmark fails when its median exceeds it by
+// more than BENCHMARK_TOLERANCE percent. Baselines are 0, not checked, unless
+// given as macros in the application configuration. The benchmark_report
+// host test records the results of a target in benchmarks_<target>.json,
+// along with these macros set to the medians measured, ready to be copied
+// to the "macros" of an mbed_app.json:
+//
+//     "macros": ["BENCHMARK_BASELINE_MUTEX_LOCK_AND_UNLOCK=312", ...]
+//
+// The name of a macro is the description of its case in upper case, with
+// runs of other characters than letters and digits replaced by '_'.
+
+#ifndef BENCHMARK_BASELINES_H
+#define BENCHMARK_BASELINES_H
+
+#ifndef BENCHMARK_TOLERANCE
+#define BENCHMARK_TOLERANCE 10
+#endif
+
+#ifndef BENCHMARK_BASELINE_EQUEUE_CALL_AND_DISPATCH
+#define BENCHMARK_BASELINE_EQUEUE_CALL_AND_DISPATCH 0
+#endif
+#ifndef BENCHMARK_BASELINE_EQUEUE_CALL_IN_AND_CANCEL
+#define BENCHMARK_BASELINE_EQUEUE_CALL_IN_AND_CANCEL 0
+#endif
+#ifndef BENCHMARK_BASELINE_EQUEUE_EVENT_POST_AND_DISPATCH
+#define BENCHMARK_BASELINE_EQUEUE_EVENT_POST_AND_DISPATCH 0
+#endif
+
+#ifndef BENCHMARK_BASELINE_CALLBACK_TO_FUNCTION
+#define BENCHMARK_BASELINE_CALLBACK_TO_FUNCTION 0
+#endif
+#ifndef BENCHMARK_BASELINE_CALLBACK_TO_MEMBER
+#define BENCHMARK_BASELINE_CALLBACK_TO_MEMBER 0
+#endif
+#ifndef BENCHMARK_BASELINE_CALLBACK_ATTACH_AND_CALL
+#define BENCHMARK_BASELINE_CALLBACK_ATTACH_AND_CALL 0
+#endif
+
+#ifndef BENCHMARK_BASELINE_MUTEX_LOCK_AND_UNLOCK
+#define BENCHMARK_BASELINE_MUTEX_LOCK_AND_UNLOCK 0
+#endif
+#ifndef BENCHMARK_BASELINE_SEMAPHORE_WAIT_AND_RELEASE
+#define BENCHMARK_BASELINE_SEMAPHORE_WAIT_AND_RELEASE 0
+#endif
+#ifndef BENCHMARK_BASELINE_SEMAPHORE_ROUND_TRIP_BETWEEN_THREADS
+#define BENCHMARK_BASELINE_SEMAPHORE_ROUND_TRIP_BETWEEN_THREADS 0
+#endif
+
+#ifndef BENCHMARK_BASELINE_TIMEOUT_ATTACH_AND_DETACH
+#define BENCHMARK_BASELINE_TIMEOUT_ATTACH_AND_DETACH 0
+#endif
+#ifndef BENCHMARK_BASELINE_TIMEOUT_ATTACH_AND_DETACH_AMONG_16
+#define BENCHMARK_BASELINE_TIMEOUT_ATTACH_AND_DETACH_AMONG_16 0
+#endif
+
+#ifndef BENCHMARK_BASELINE_MALLOC_AND_FREE_16B
+#define BENCHMARK_BASELINE_MALLOC_AND_FREE_16B 0
+#endif
+#ifndef BENCHMARK_BASELINE_MALLOC_AND_FREE_256B
+#define BENCHMARK_BASELINE_MALLOC_AND_FREE_256B 0
+#endif
+#ifndef BENCHMARK_BASELINE_MEMCPY_16B
+#define BENCHMARK_BASELINE_MEMCPY_16B 0
+#endif
+#ifndef BENCHMARK_BASELINE_MEMCPY_1KB
+#define BENCHMARK_BASELINE_MEMCPY_1KB 0
+#endif
+#ifndef BENCHMARK_BASELINE_MEMCPY_1KB_UNALIGNED
+#define BENCHMARK_BASELINE_MEMCPY_1KB_UNALIGNED 0
+#endif
+#ifndef BENCHMARK_BASELINE_MEMSET_1KB
+#define BENCHMARK_BASELINE_MEMSET_1KB 0
+#endif
+
+#ifndef BENCHMARK_BASELINE_CRC_32_SOFTWARE_1KB
+#define BENCHMARK_BASELINE_CRC_32_SOFTWARE_1KB 0
+#endif
+#ifndef BENCHMARK_BASELINE_CRC_32_HARDWARE_1KB
+#define BENCHMARK_BASELINE_CRC_32_HARDWARE_1KB 0
+#endif
+
+#ifndef BENCHMARK_BASELINE_AES_128_BLOCK_ENCRYPTION
+#define BENCHMARK_BASELINE_AES_128_BLOCK_ENCRYPTION 0
+#endif
+#ifndef BENCHMARK_BASELINE_AES_128_CBC_1KB
+#define BENCHMARK_BASELINE_AES_128_CBC_1KB 0
+#endif
+#ifndef BENCHMARK_BASELINE_SHA_256_1KB
+#define BENCHMARK_BASELINE_SHA_256_1KB 0
+#endif
+
+#ifndef BENCHMARK_BASELINE_UDP_ROUND_TRIP_64B
+#define BENCHMARK_BASELINE_UDP_ROUND_TRIP_64B 0
+#endif
+#ifndef BENCHMARK_BASELINE_UDP_ROUND_TRIP_512B
+#define BENCHMARK_BASELINE_UDP_ROUND_TRIP_512B 0
+#endif
+
+#endif
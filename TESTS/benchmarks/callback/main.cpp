@@ -0,0 +1,104 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Calling through Callbacks
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "../baselines.h"
+
+using namespace utest::v1;
+
+static volatile uint32_t counter;
+
+static void function(uint32_t n)
+{
+    counter += n;
+}
+
+class Counter {
+public:
+    void add(uint32_t n)
+    {
+        _count += n;
+    }
+
+    volatile uint32_t _count;
+};
+
+static Counter object;
+static Callback<void(uint32_t)> function_callback(function);
+static Callback<void(uint32_t)> member_callback(&object, &Counter::add);
+static Callback<void(uint32_t)> attached;
+
+static void call_function()
+{
+    function_callback(1);
+}
+
+static void call_member()
+{
+    member_callback(1);
+}
+
+static void attach_and_call()
+{
+    attached.attach(&object, &Counter::add);
+    attached(1);
+}
+
+static const benchmark_t function_benchmark = {
+    call_function, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_CALLBACK_TO_FUNCTION, BENCHMARK_TOLERANCE
+};
+static const benchmark_t member_benchmark = {
+    call_member, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_CALLBACK_TO_MEMBER, BENCHMARK_TOLERANCE
+};
+static const benchmark_t attach_benchmark = {
+    attach_and_call, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_CALLBACK_ATTACH_AND_CALL, BENCHMARK_TOLERANCE
+};
+
+void test_called()
+{
+    counter = 0;
+    object._count = 0;
+    call_function();
+    call_member();
+    attach_and_call();
+    TEST_ASSERT_EQUAL(1, counter);
+    TEST_ASSERT_EQUAL(2, object._count);
+}
+
+Case cases[] = {
+    Case("Callbacks are called", test_called),
+    Case("Callback to function", function_benchmark),
+    Case("Callback to member", member_benchmark),
+    Case("Callback attach and call", attach_benchmark),
+};
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(30, "benchmark_report");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
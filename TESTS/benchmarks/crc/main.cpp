@@ -0,0 +1,108 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// CRC-32 of a buffer, in software and with the CRC unit of the target
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "crc_api.h"
+#include "../baselines.h"
+
+using namespace utest::v1;
+
+#define BUFFER_WORDS 256
+
+static uint32_t buffer[BUFFER_WORDS];
+static uint32_t table[256];
+static volatile uint32_t crc;
+
+// Reflected CRC-32, polynomial 0x04C11DB7, a byte at a time
+static uint32_t crc32_update(uint32_t remainder, const uint8_t *data, size_t length)
+{
+    while (length--) {
+        remainder = table[(remainder ^ *data++) & 0xFF] ^ (remainder >> 8);
+    }
+    return remainder;
+}
+
+static void software_crc()
+{
+    crc = crc32_update(0xFFFFFFFF, (const uint8_t *)buffer, sizeof(buffer)) ^ 0xFFFFFFFF;
+}
+
+static const benchmark_t software_benchmark = {
+    software_crc, 2, 100, BENCHMARK_CYCLES, BENCHMARK_BASELINE_CRC_32_SOFTWARE_1KB, BENCHMARK_TOLERANCE
+};
+
+void test_software()
+{
+    static const char check[] = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32_update(0xFFFFFFFF, (const uint8_t *)check, 9) ^ 0xFFFFFFFF);
+}
+
+#if DEVICE_CRC
+static void hardware_crc()
+{
+    crc = crc32_hw_update(0xFFFFFFFF, buffer, BUFFER_WORDS) ^ 0xFFFFFFFF;
+}
+
+static const benchmark_t hardware_benchmark = {
+    hardware_crc, 2, 100, BENCHMARK_CYCLES, BENCHMARK_BASELINE_CRC_32_HARDWARE_1KB, BENCHMARK_TOLERANCE
+};
+
+void test_hardware()
+{
+    software_crc();
+    uint32_t expected = crc;
+    hardware_crc();
+    TEST_ASSERT_EQUAL_HEX32(expected, crc);
+}
+#endif
+
+Case cases[] = {
+    Case("Software CRC-32 check value", test_software),
+    Case("CRC-32 software 1kB", software_benchmark),
+#if DEVICE_CRC
+    Case("Hardware CRC-32 matches software", test_hardware),
+    Case("CRC-32 hardware 1kB", hardware_benchmark),
+#endif
+};
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(30, "benchmark_report");
+
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t r = i;
+        for (int bit = 0; bit < 8; bit++) {
+            r = (r >> 1) ^ ((r & 1) ? 0xEDB88320 : 0);
+        }
+        table[i] = r;
+    }
+    for (int i = 0; i < BUFFER_WORDS; i++) {
+        buffer[i] = i * 0x9E3779B9;
+    }
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
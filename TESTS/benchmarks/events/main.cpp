@@ -0,0 +1,91 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Posting events to an EventQueue and dispatching them
+
+#include "mbed.h"
+#include "mbed_events.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "../baselines.h"
+
+using namespace utest::v1;
+
+static EventQueue queue(32 * EVENTS_EVENT_SIZE);
+static volatile uint32_t counter;
+
+static void handler()
+{
+    counter++;
+}
+
+static Event<void()> event(&queue, handler);
+
+static void call_and_dispatch()
+{
+    queue.call(handler);
+    queue.dispatch(0);
+}
+
+static void call_in_and_cancel()
+{
+    queue.cancel(queue.call_in(1000, handler));
+}
+
+static void event_post_and_dispatch()
+{
+    event.post();
+    queue.dispatch(0);
+}
+
+static const benchmark_t call_benchmark = {
+    call_and_dispatch, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_EQUEUE_CALL_AND_DISPATCH, BENCHMARK_TOLERANCE
+};
+static const benchmark_t call_in_benchmark = {
+    call_in_and_cancel, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_EQUEUE_CALL_IN_AND_CANCEL, BENCHMARK_TOLERANCE
+};
+static const benchmark_t event_benchmark = {
+    event_post_and_dispatch, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_EQUEUE_EVENT_POST_AND_DISPATCH, BENCHMARK_TOLERANCE
+};
+
+void test_dispatched()
+{
+    counter = 0;
+    call_and_dispatch();
+    event_post_and_dispatch();
+    TEST_ASSERT_EQUAL(2, counter);
+}
+
+Case cases[] = {
+    Case("Events are dispatched", test_dispatched),
+    Case("equeue call and dispatch", call_benchmark),
+    Case("equeue call_in and cancel", call_in_benchmark),
+    Case("equeue Event post and dispatch", event_benchmark),
+};
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(60, "benchmark_report");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,100 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// AES and SHA-256 of mbed TLS, on the accelerators of the target if it has
+// alternative implementations
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "../baselines.h"
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if !defined(MBEDTLS_AES_C) || !defined(MBEDTLS_CIPHER_MODE_CBC) || !defined(MBEDTLS_SHA256_C)
+  #error [NOT_SUPPORTED] Requires AES with CBC and SHA-256
+#endif
+
+#include "mbedtls/aes.h"
+#include "mbedtls/sha256.h"
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE 1024
+
+static mbedtls_aes_context aes;
+static unsigned char key[16];
+static unsigned char iv[16];
+static unsigned char input[BUFFER_SIZE];
+static unsigned char output[BUFFER_SIZE];
+static unsigned char digest[32];
+
+static void aes_block()
+{
+    mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, input, output);
+}
+
+static void aes_cbc()
+{
+    mbedtls_aes_crypt_cbc(&aes, MBEDTLS_AES_ENCRYPT, BUFFER_SIZE, iv, input, output);
+}
+
+static void sha256()
+{
+    mbedtls_sha256(input, BUFFER_SIZE, digest, 0);
+}
+
+static const benchmark_t aes_block_benchmark = {
+    aes_block, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_AES_128_BLOCK_ENCRYPTION, BENCHMARK_TOLERANCE
+};
+static const benchmark_t aes_cbc_benchmark = {
+    aes_cbc, 2, 100, BENCHMARK_CYCLES, BENCHMARK_BASELINE_AES_128_CBC_1KB, BENCHMARK_TOLERANCE
+};
+static const benchmark_t sha256_benchmark = {
+    sha256, 2, 100, BENCHMARK_CYCLES, BENCHMARK_BASELINE_SHA_256_1KB, BENCHMARK_TOLERANCE
+};
+
+Case cases[] = {
+    Case("AES-128 block encryption", aes_block_benchmark),
+    Case("AES-128-CBC 1kB", aes_cbc_benchmark),
+    Case("SHA-256 1kB", sha256_benchmark),
+};
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(60, "benchmark_report");
+
+    for (int i = 0; i < BUFFER_SIZE; i++) {
+        input[i] = (unsigned char)i;
+    }
+    mbedtls_aes_init(&aes);
+    TEST_ASSERT_EQUAL(0, mbedtls_aes_setkey_enc(&aes, key, 128));
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    int ret = !Harness::run(specification);
+    mbedtls_aes_free(&aes);
+    return ret;
+}
@@ -0,0 +1,105 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Heap allocations and memory copies
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "../baselines.h"
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE 1024
+
+MBED_ALIGN(4) static uint8_t src[BUFFER_SIZE + 4];
+MBED_ALIGN(4) static uint8_t dst[BUFFER_SIZE + 4];
+
+// Through a volatile pointer, so the compiler keeps the calls
+static void *(*volatile memcpy_function)(void *, const void *, size_t) = memcpy;
+static void *(*volatile memset_function)(void *, int, size_t) = memset;
+
+static void malloc_and_free_16()
+{
+    free(malloc(16));
+}
+
+static void malloc_and_free_256()
+{
+    free(malloc(256));
+}
+
+static void memcpy_16()
+{
+    memcpy_function(dst, src, 16);
+}
+
+static void memcpy_1k()
+{
+    memcpy_function(dst, src, BUFFER_SIZE);
+}
+
+static void memcpy_1k_unaligned()
+{
+    memcpy_function(dst + 1, src + 3, BUFFER_SIZE);
+}
+
+static void memset_1k()
+{
+    memset_function(dst, 0x55, BUFFER_SIZE);
+}
+
+static const benchmark_t malloc_16_benchmark = {
+    malloc_and_free_16, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_MALLOC_AND_FREE_16B, BENCHMARK_TOLERANCE
+};
+static const benchmark_t malloc_256_benchmark = {
+    malloc_and_free_256, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_MALLOC_AND_FREE_256B, BENCHMARK_TOLERANCE
+};
+static const benchmark_t memcpy_16_benchmark = {
+    memcpy_16, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_MEMCPY_16B, BENCHMARK_TOLERANCE
+};
+static const benchmark_t memcpy_1k_benchmark = {
+    memcpy_1k, 10, 200, BENCHMARK_CYCLES, BENCHMARK_BASELINE_MEMCPY_1KB, BENCHMARK_TOLERANCE
+};
+static const benchmark_t memcpy_1k_unaligned_benchmark = {
+    memcpy_1k_unaligned, 10, 200, BENCHMARK_CYCLES, BENCHMARK_BASELINE_MEMCPY_1KB_UNALIGNED, BENCHMARK_TOLERANCE
+};
+static const benchmark_t memset_1k_benchmark = {
+    memset_1k, 10, 200, BENCHMARK_CYCLES, BENCHMARK_BASELINE_MEMSET_1KB, BENCHMARK_TOLERANCE
+};
+
+Case cases[] = {
+    Case("malloc and free 16B", malloc_16_benchmark),
+    Case("malloc and free 256B", malloc_256_benchmark),
+    Case("memcpy 16B", memcpy_16_benchmark),
+    Case("memcpy 1kB", memcpy_1k_benchmark),
+    Case("memcpy 1kB unaligned", memcpy_1k_unaligned_benchmark),
+    Case("memset 1kB", memset_1k_benchmark),
+};
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(30, "benchmark_report");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,96 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Mutex and Semaphore operations, uncontended and between two threads
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+#include "../baselines.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define ECHO_STACK_SIZE 512
+
+static Mutex mutex;
+static Semaphore semaphore(1);
+static Semaphore ping(0);
+static Semaphore pong(0);
+
+static void mutex_lock_and_unlock()
+{
+    mutex.lock();
+    mutex.unlock();
+}
+
+static void semaphore_wait_and_release()
+{
+    semaphore.wait();
+    semaphore.release();
+}
+
+// Switches to the echo thread and back
+static void semaphore_round_trip()
+{
+    ping.release();
+    pong.wait();
+}
+
+static void echo()
+{
+    while (true) {
+        ping.wait();
+        pong.release();
+    }
+}
+
+static const benchmark_t mutex_benchmark = {
+    mutex_lock_and_unlock, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_MUTEX_LOCK_AND_UNLOCK, BENCHMARK_TOLERANCE
+};
+static const benchmark_t semaphore_benchmark = {
+    semaphore_wait_and_release, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_SEMAPHORE_WAIT_AND_RELEASE, BENCHMARK_TOLERANCE
+};
+static const benchmark_t round_trip_benchmark = {
+    semaphore_round_trip, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_SEMAPHORE_ROUND_TRIP_BETWEEN_THREADS, BENCHMARK_TOLERANCE
+};
+
+Case cases[] = {
+    Case("Mutex lock and unlock", mutex_benchmark),
+    Case("Semaphore wait and release", semaphore_benchmark),
+    Case("Semaphore round trip between threads", round_trip_benchmark),
+};
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(30, "benchmark_report");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    // Higher priority, so that each release switches to it
+    Thread thread(osPriorityAboveNormal, ECHO_STACK_SIZE);
+    thread.start(echo);
+    return !Harness::run(specification);
+}
@@ -0,0 +1,123 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// UDP round trips to the echo server of the host test, there being no
+// loopback interface to the stack
+
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "UDPSocket.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "../baselines.h"
+
+using namespace utest::v1;
+
+#define MAX_PAYLOAD 512
+
+static EthernetInterface eth;
+static UDPSocket sock;
+static SocketAddress echo_addr;
+static char tx_buffer[MAX_PAYLOAD];
+static char rx_buffer[MAX_PAYLOAD];
+static int lost;
+
+// Failures are counted rather than asserted, as an iteration can't fail
+static void round_trip(size_t size)
+{
+    SocketAddress from;
+    if (sock.sendto(echo_addr, tx_buffer, size) != (nsapi_size_or_error_t)size ||
+        sock.recvfrom(&from, rx_buffer, sizeof(rx_buffer)) != (nsapi_size_or_error_t)size ||
+        memcmp(rx_buffer, tx_buffer, size)) {
+        lost++;
+    }
+}
+
+static void round_trip_64()
+{
+    round_trip(64);
+}
+
+static void round_trip_512()
+{
+    round_trip(512);
+}
+
+static const benchmark_t round_trip_64_benchmark = {
+    round_trip_64, 5, 100, BENCHMARK_US, BENCHMARK_BASELINE_UDP_ROUND_TRIP_64B, BENCHMARK_TOLERANCE
+};
+static const benchmark_t round_trip_512_benchmark = {
+    round_trip_512, 5, 100, BENCHMARK_US, BENCHMARK_BASELINE_UDP_ROUND_TRIP_512B, BENCHMARK_TOLERANCE
+};
+
+void test_no_loss()
+{
+    TEST_ASSERT_EQUAL(0, lost);
+}
+
+Case cases[] = {
+    Case("UDP round trip 64B", round_trip_64_benchmark),
+    Case("UDP round trip 512B", round_trip_512_benchmark),
+    Case("Every datagram echoed", test_no_loss),
+};
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(120, "benchmark_report");
+
+    TEST_ASSERT_EQUAL(0, eth.connect());
+    greentea_send_kv("target_ip", eth.get_ip_address());
+
+    char recv_key[] = "host_port";
+    char ipbuf[60] = {0};
+    char portbuf[16] = {0};
+    unsigned int port = 0;
+
+    greentea_send_kv("host_ip", " ");
+    greentea_parse_kv(recv_key, ipbuf, sizeof(recv_key), sizeof(ipbuf));
+
+    greentea_send_kv("host_port", " ");
+    greentea_parse_kv(recv_key, portbuf, sizeof(recv_key), sizeof(portbuf));
+    sscanf(portbuf, "%u", &port);
+
+    echo_addr = SocketAddress(ipbuf, port);
+    TEST_ASSERT_EQUAL(0, sock.open(&eth));
+    sock.set_timeout(1000);
+
+    for (int i = 0; i < MAX_PAYLOAD; i++) {
+        tx_buffer[i] = (rand() % 10) + '0';
+    }
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+void test_teardown(const size_t passed, const size_t failed, const failure_t failure)
+{
+    sock.close();
+    eth.disconnect();
+    greentea_test_teardown_handler(passed, failed, failure);
+}
+
+Specification specification(test_setup, cases, test_teardown);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,82 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Inserting and removing events of the us ticker queue
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "../baselines.h"
+
+using namespace utest::v1;
+
+#define PENDING_TIMEOUTS    16
+
+static Timeout timeout;
+static Timeout pending[PENDING_TIMEOUTS];
+
+static void handler()
+{
+}
+
+static void attach_and_detach()
+{
+    timeout.attach_us(handler, 500000);
+    timeout.detach();
+}
+
+static const benchmark_t empty_benchmark = {
+    attach_and_detach, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_TIMEOUT_ATTACH_AND_DETACH, BENCHMARK_TOLERANCE
+};
+static const benchmark_t pending_benchmark = {
+    attach_and_detach, 10, 1000, BENCHMARK_CYCLES, BENCHMARK_BASELINE_TIMEOUT_ATTACH_AND_DETACH_AMONG_16, BENCHMARK_TOLERANCE
+};
+
+// Events due before and after the one inserted, which goes midway in the queue
+utest::v1::status_t pending_setup(const Case *const source, const size_t index_of_case)
+{
+    for (int i = 0; i < PENDING_TIMEOUTS; i++) {
+        pending[i].attach_us(handler, 400000 + 12500 * i);
+    }
+    return greentea_case_setup_handler(source, index_of_case);
+}
+
+utest::v1::status_t pending_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t reason)
+{
+    for (int i = 0; i < PENDING_TIMEOUTS; i++) {
+        pending[i].detach();
+    }
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+Case cases[] = {
+    Case("Timeout attach and detach", empty_benchmark),
+    Case("Timeout attach and detach among 16", pending_setup, pending_benchmark, pending_teardown),
+};
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(30, "benchmark_report");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
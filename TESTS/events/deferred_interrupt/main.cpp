@@ -0,0 +1,152 @@
+#include "mbed_events.h"
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#if !DEVICE_INTERRUPTIN
+#error [NOT_SUPPORTED] test not supported
+#endif
+
+// Nothing needs to be connected, edges are injected through the
+// InterruptIn interrupt handler
+#define EDGES_SIZE MBED_CONF_EVENTS_DEFERRED_INTERRUPT_BUFFER_SIZE
+
+struct record_t {
+    bool rise;
+    uint32_t timestamp;
+};
+
+static record_t records[EDGES_SIZE + 8];
+static int recorded;
+
+static void record(bool rise, uint32_t timestamp) {
+    if (recorded < (int)(sizeof(records) / sizeof(records[0]))) {
+        records[recorded].rise = rise;
+        records[recorded].timestamp = timestamp;
+    }
+    recorded++;
+}
+
+static void on_rise(uint32_t timestamp) { record(true, timestamp); }
+static void on_fall(uint32_t timestamp) { record(false, timestamp); }
+
+static void inject(DeferredInterruptIn &in, bool rise) {
+    InterruptIn::_irq_handler((uint32_t)static_cast<InterruptIn*>(&in), rise ? IRQ_RISE : IRQ_FALL);
+}
+
+void batch_test() {
+    EventQueue queue;
+    DeferredInterruptIn in(LED1, &queue);
+    in.rise(on_rise);
+    in.fall(on_fall);
+
+    recorded = 0;
+    inject(in, true);
+    inject(in, false);
+    inject(in, true);
+
+    // nothing runs in the interrupt
+    TEST_ASSERT_EQUAL(0, recorded);
+    queue.dispatch(0);
+
+    TEST_ASSERT_EQUAL(3, recorded);
+    TEST_ASSERT_TRUE(records[0].rise);
+    TEST_ASSERT_FALSE(records[1].rise);
+    TEST_ASSERT_TRUE(records[2].rise);
+    TEST_ASSERT_TRUE(records[2].timestamp - records[0].timestamp < 1000);
+    TEST_ASSERT_EQUAL(0, in.dropped());
+}
+
+void dropped_test() {
+    EventQueue queue;
+    DeferredInterruptIn in(LED1, &queue);
+    in.rise(on_rise);
+
+    recorded = 0;
+    for (int i = 0; i < EDGES_SIZE + 3; i++) {
+        inject(in, true);
+    }
+    queue.dispatch(0);
+
+    TEST_ASSERT_EQUAL(EDGES_SIZE, recorded);
+    TEST_ASSERT_EQUAL(3, in.dropped());
+
+    // the record is free again
+    inject(in, true);
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL(EDGES_SIZE + 1, recorded);
+}
+
+void coalesce_test() {
+    EventQueue queue;
+    DeferredInterruptIn in(LED1, &queue);
+    in.rise(on_rise);
+    in.fall(on_fall);
+    in.coalesce(true);
+
+    recorded = 0;
+    inject(in, false);
+    inject(in, true);
+    inject(in, false);
+    inject(in, true);
+    queue.dispatch(0);
+
+    // the last fall, then the last rise
+    TEST_ASSERT_EQUAL(2, recorded);
+    TEST_ASSERT_FALSE(records[0].rise);
+    TEST_ASSERT_TRUE(records[1].rise);
+}
+
+void debounce_test() {
+    EventQueue queue;
+    DeferredInterruptIn in(LED1, &queue);
+    in.rise(on_rise);
+    in.fall(on_fall);
+    // short of any pin filter, so debounced in software
+    in.debounce(900);
+
+    // bounce away from the current level
+    bool level = in.read();
+    recorded = 0;
+    uint32_t start = us_ticker_read();
+    inject(in, !level);
+    inject(in, level);
+    inject(in, !level);
+
+    // still bouncing
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL(0, recorded);
+
+    queue.dispatch(20);
+    TEST_ASSERT_EQUAL(1, recorded);
+    TEST_ASSERT_EQUAL(!level, records[0].rise);
+    TEST_ASSERT_TRUE(records[0].timestamp - start < 100);
+
+    // bouncing back to the same level reports nothing
+    inject(in, level);
+    inject(in, !level);
+    queue.dispatch(20);
+    TEST_ASSERT_EQUAL(1, recorded);
+}
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+const Case cases[] = {
+    Case("Testing edges dispatched in a batch", batch_test),
+    Case("Testing edges dropped when the record is full", dropped_test),
+    Case("Testing coalesced edges", coalesce_test),
+    Case("Testing software debounce", debounce_test),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,108 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed_events.h"
+#include "mbed.h"
+#include "rtos.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+
+using namespace utest::v1;
+
+#if !MBED_CONF_RTOS_PRESENT
+#error [NOT_SUPPORTED] PriorityEventQueue requires the RTOS
+#endif
+
+volatile bool slow_started = false;
+volatile bool slow_release = false;
+volatile bool fast_done = false;
+
+void slow_func() {
+    slow_started = true;
+    while (!slow_release) {
+        Thread::wait(1);
+    }
+}
+
+void fast_func() {
+    fast_done = true;
+}
+
+void separation_test() {
+    PriorityEventQueue queue(2);
+
+    slow_started = false;
+    slow_release = false;
+    fast_done = false;
+
+    TEST_ASSERT_NOT_EQUAL(0, queue.call(1, slow_func));
+    while (!slow_started) {
+        Thread::wait(1);
+    }
+
+    // the low level is blocked, the high level must still make progress
+    TEST_ASSERT_NOT_EQUAL(0, queue.call(0, fast_func));
+    Thread::wait(10);
+    TEST_ASSERT_TRUE(fast_done);
+
+    priority_event_stats_t stats;
+    queue.stats(1, &stats);
+    TEST_ASSERT_EQUAL(1, stats.backlog);
+
+    slow_release = true;
+    Thread::wait(10);
+
+    queue.stats(0, &stats);
+    TEST_ASSERT_EQUAL(0, stats.backlog);
+    TEST_ASSERT_EQUAL(1, stats.dispatched);
+    queue.stats(1, &stats);
+    TEST_ASSERT_EQUAL(0, stats.backlog);
+    TEST_ASSERT_EQUAL(1, stats.dispatched);
+}
+
+void cancel_backlog_test() {
+    PriorityEventQueue queue(2);
+
+    int id = queue.call_in(1, 1000, fast_func);
+    TEST_ASSERT_NOT_EQUAL(0, id);
+
+    priority_event_stats_t stats;
+    queue.stats(1, &stats);
+    TEST_ASSERT_EQUAL(1, stats.backlog);
+
+    queue.cancel(1, id);
+    queue.stats(1, &stats);
+    TEST_ASSERT_EQUAL(0, stats.backlog);
+    TEST_ASSERT_EQUAL(0, stats.dispatched);
+}
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+const Case cases[] = {
+    Case("Testing priority separation", separation_test),
+    Case("Testing backlog after cancel", cancel_backlog_test),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -224,6 +224,74 @@ void event_inference_test() {
     TEST_ASSERT_EQUAL(counter, 30);
 }
 
+void count_one() {
+    counter += 1;
+}
+
+void user_allocated_event_test() {
+    counter = 0;
+    EventQueue queue(2048);
+
+    UserAllocatedEvent e(&queue, count_one);
+    TEST_ASSERT(e.post());
+    TEST_ASSERT(!e.post());
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL(counter, 1);
+
+    for (int i = 0; i < 10; i++) {
+        e.call();
+        queue.dispatch(0);
+    }
+    TEST_ASSERT_EQUAL(counter, 11);
+
+    e.post();
+    e.cancel();
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL(counter, 11);
+
+    e.delay(10);
+    e.period(10);
+    e.post();
+    queue.dispatch(55);
+    TEST_ASSERT_EQUAL(counter, 16);
+    e.cancel();
+}
+
+int order[3];
+int orders;
+
+void log_order(int value) {
+    order[orders++] = value;
+}
+
+void deadline_test() {
+    EventQueue queue(2048);
+    orders = 0;
+
+    Event<void()> logging = queue.event(log_order, 0);
+    Event<void()> control = queue.event(log_order, 1);
+    Event<void()> urgent = queue.event(log_order, 2);
+    control.deadline(10);
+    urgent.deadline(0);
+
+    logging.post();
+    control.post();
+    urgent.post();
+    queue.dispatch(0);
+
+    TEST_ASSERT_EQUAL(3, orders);
+    TEST_ASSERT_EQUAL(2, order[0]);
+    TEST_ASSERT_EQUAL(1, order[1]);
+    TEST_ASSERT_EQUAL(0, order[2]);
+    TEST_ASSERT_EQUAL(0, queue.missed_deadlines());
+
+    Event<void()> late = queue.event(wait_ms, 20);
+    late.deadline(5);
+    late.post();
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL(1, queue.missed_deadlines());
+}
+
 
 // Test setup
 utest::v1::status_t test_setup(const size_t number_of_cases) {
@@ -248,6 +316,8 @@ const Case cases[] = {
     Case("Testing the event class", event_class_test),
     Case("Testing the event class helpers", event_class_helper_test),
     Case("Testing the event inference", event_inference_test),
+    Case("Testing user allocated events", user_allocated_event_test),
+    Case("Testing deadline dispatch order", deadline_test),
 };
 
 Specification specification(test_setup, cases);
@@ -0,0 +1,123 @@
+"""
+mbed SDK
+Copyright (c) 2011-2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+
+import os
+import re
+import json
+import socket
+from threading import Thread
+from SocketServer import BaseRequestHandler, UDPServer
+from mbed_host_tests import BaseHostTest, event_callback
+
+
+class BenchmarkEchoHandler(BaseRequestHandler):
+    def handle(self):
+        """ Echoes UDP packets back to the sender, for the socket benchmarks.
+        """
+        data, sock = self.request
+        sock.sendto(data, self.client_address)
+
+
+class BenchmarkReport(BaseHostTest):
+    """ Collects the results of the utest benchmark cases of the target and
+        merges them in benchmarks_<platform>.json, in the current directory.
+
+        Each result is reported by the target with the "utest_benchmark" key,
+        valued "description;min;median;p99;max;baseline;unit". The report
+        gives, for each description, the app config macro setting its
+        baseline, and lists these macros set to the medians measured, ready
+        to be copied to the "macros" of an mbed_app.json.
+
+        The target may also ask for a UDP echo server like udp_echo_client,
+        sending "target_ip", then "host_ip" and "host_port".
+    """
+
+    def __init__(self):
+        BaseHostTest.__init__(self)
+        self.results = {}
+        self.server = None
+        self.server_thread = None
+        self.server_ip = None
+        self.server_port = 0
+
+    @staticmethod
+    def baseline_macro(description):
+        return "BENCHMARK_BASELINE_" + re.sub("[^A-Z0-9]+", "_", description.upper()).strip("_")
+
+    @event_callback("utest_benchmark")
+    def _callback_benchmark(self, key, value, timestamp):
+        fields = value.split(";")
+        if len(fields) != 7:
+            self.log("HOST: malformed benchmark result: " + value)
+            return
+        description = fields[0]
+        minimum, median, p99, maximum, baseline = [int(f) for f in fields[1:6]]
+        self.results[description] = {
+            "min": minimum,
+            "median": median,
+            "p99": p99,
+            "max": maximum,
+            "baseline": baseline,
+            "unit": fields[6],
+            "macro": self.baseline_macro(description),
+        }
+        self.log("HOST: %s: median %d %s (baseline %d)" % (description, median, fields[6], baseline))
+
+    @event_callback("target_ip")
+    def _callback_target_ip(self, key, value, timestamp):
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        s.connect((value, 0))
+        self.server_ip = s.getsockname()[0]
+        s.close()
+
+        self.server = UDPServer((self.server_ip, 0), BenchmarkEchoHandler)
+        self.server_port = self.server.server_address[1]
+        self.server_thread = Thread(target=self.server.serve_forever)
+        self.server_thread.start()
+        self.log("HOST: Echoing UDP packets on " + self.server_ip + ":" + str(self.server_port))
+
+    @event_callback("host_ip")
+    def _callback_host_ip(self, key, value, timestamp):
+        self.send_kv("host_ip", self.server_ip)
+
+    @event_callback("host_port")
+    def _callback_host_port(self, key, value, timestamp):
+        self.send_kv("host_port", self.server_port)
+
+    def teardown(self):
+        if self.server:
+            self.server.shutdown()
+            self.server_thread.join()
+
+        if not self.results:
+            return
+        try:
+            platform = self.get_config_item("platform_name")
+        except Exception:
+            platform = None
+        filename = "benchmarks_%s.json" % (platform or "target")
+
+        report = {}
+        if os.path.exists(filename):
+            with open(filename) as f:
+                report = json.load(f)
+        report.setdefault("results", {}).update(self.results)
+        report["macros"] = sorted("%s=%d" % (r["macro"], r["median"])
+                                  for r in report["results"].values())
+        with open(filename, "w") as f:
+            json.dump(report, f, indent=4, sort_keys=True)
+        self.log("HOST: %d benchmark results written to %s" % (len(self.results), filename))
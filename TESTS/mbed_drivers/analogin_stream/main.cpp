@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_ANALOGIN_ASYNCH
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define RATE_HZ         10000
+#define HALF_SAMPLES    100
+#define RUN_MS          200
+
+static uint16_t samples[2 * 2 * HALF_SAMPLES];
+
+static volatile int halves;
+static volatile int fulls;
+static volatile int errors;
+
+static void on_samples(int event) {
+    if (event & ANALOGIN_EVENT_HALF_COMPLETE) {
+        halves = halves + 1;
+    }
+    if (event & ANALOGIN_EVENT_COMPLETE) {
+        fulls = fulls + 1;
+    }
+    if (event & ANALOGIN_EVENT_ERROR) {
+        errors = errors + 1;
+    }
+}
+
+static void reset_counts() {
+    halves = 0;
+    fulls = 0;
+    errors = 0;
+}
+
+void test_single_channel_rate()
+{
+    AnalogInStream stream(A0);
+
+    reset_counts();
+    TEST_ASSERT_EQUAL(0, stream.start(samples, 2 * HALF_SAMPLES, RATE_HZ, on_samples));
+    TEST_ASSERT(stream.active());
+    wait_ms(RUN_MS);
+    stream.stop();
+    TEST_ASSERT(!stream.active());
+
+    // one half every HALF_SAMPLES / RATE_HZ seconds
+    int expected = RUN_MS * RATE_HZ / 1000 / HALF_SAMPLES;
+    int got = halves + fulls;
+    TEST_ASSERT_INT_WITHIN(2, expected, got);
+    TEST_ASSERT_INT_WITHIN(1, halves, fulls);
+    TEST_ASSERT_EQUAL(0, errors);
+
+    // nothing comes after stop
+    wait_ms(20);
+    TEST_ASSERT_EQUAL(got, halves + fulls);
+}
+
+void test_two_channels()
+{
+    const PinName pins[] = { A0, A1 };
+    AnalogInStream stream(pins, 2);
+
+    TEST_ASSERT_EQUAL(2, stream.channels());
+    reset_counts();
+    TEST_ASSERT_EQUAL(0, stream.start(samples, sizeof(samples) / sizeof(samples[0]), RATE_HZ, on_samples));
+    wait_ms(RUN_MS);
+    stream.stop();
+
+    int expected = RUN_MS * RATE_HZ / 1000 / HALF_SAMPLES;
+    TEST_ASSERT_INT_WITHIN(2, expected, halves + fulls);
+    TEST_ASSERT_EQUAL(0, errors);
+}
+
+void test_bad_arguments()
+{
+    const PinName pins[] = { A0, A1 };
+    AnalogInStream stream(pins, 2);
+
+    // halves must hold whole scans
+    TEST_ASSERT_EQUAL(-1, stream.start(samples, 6, RATE_HZ, on_samples));
+    TEST_ASSERT_EQUAL(-1, stream.start(samples, 8, 0, on_samples));
+    TEST_ASSERT(!stream.active());
+
+    // one stream at a time
+    TEST_ASSERT_EQUAL(0, stream.start(samples, 8, RATE_HZ, on_samples));
+    TEST_ASSERT_EQUAL(-1, stream.start(samples, 8, RATE_HZ, on_samples));
+    stream.stop();
+}
+
+void test_single_reads_between_streams()
+{
+    AnalogIn in(A0);
+    AnalogInStream stream(A0);
+
+    TEST_ASSERT_EQUAL(0, stream.start(samples, 2 * HALF_SAMPLES, RATE_HZ, on_samples));
+    wait_ms(10);
+    stream.stop();
+
+    // single conversions are set up again after the stream
+    for (int i = 0; i < 10; i++) {
+        in.read_u16();
+    }
+
+    reset_counts();
+    TEST_ASSERT_EQUAL(0, stream.start(samples, 2 * HALF_SAMPLES, RATE_HZ, on_samples));
+    wait_ms(50);
+    stream.stop();
+    TEST_ASSERT(halves + fulls > 0);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Single channel at the requested rate", test_single_channel_rate),
+    Case("Two channels", test_two_channels),
+    Case("Bad arguments", test_bad_arguments),
+    Case("Single reads between streams", test_single_reads_between_streams),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_ANALOGOUT_ASYNCH
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#if defined(TARGET_STM)
+#define DAC_PIN         PA_4
+#else
+#define DAC_PIN         DAC0_OUT
+#endif
+
+#define RATE_HZ         10000
+#define SAMPLES         200
+#define RUN_MS          200
+
+static uint16_t wave[SAMPLES];
+
+static volatile int halves;
+static volatile int fulls;
+static volatile int errors;
+
+static void on_events(int event) {
+    if (event & ANALOGOUT_EVENT_HALF_COMPLETE) {
+        halves = halves + 1;
+    }
+    if (event & ANALOGOUT_EVENT_COMPLETE) {
+        fulls = fulls + 1;
+    }
+    if (event & ANALOGOUT_EVENT_ERROR) {
+        errors = errors + 1;
+    }
+}
+
+static void reset_counts() {
+    halves = 0;
+    fulls = 0;
+    errors = 0;
+}
+
+static void fill_ramp() {
+    for (int i = 0; i < SAMPLES; i++) {
+        wave[i] = i * (0xFFFF / (SAMPLES - 1));
+    }
+}
+
+void test_circular_rate()
+{
+    AnalogOut out(DAC_PIN);
+
+    fill_ramp();
+    reset_counts();
+    TEST_ASSERT_EQUAL(0, out.play(wave, SAMPLES, RATE_HZ, on_events, ANALOGOUT_EVENT_ALL, true));
+    TEST_ASSERT(out.playing());
+    wait_ms(RUN_MS);
+    out.stop();
+    TEST_ASSERT(!out.playing());
+
+    // one pass every SAMPLES / RATE_HZ seconds
+    int expected = RUN_MS * RATE_HZ / 1000 / SAMPLES;
+    TEST_ASSERT_INT_WITHIN(1, expected, fulls);
+    TEST_ASSERT_INT_WITHIN(1, halves, fulls);
+    TEST_ASSERT_EQUAL(0, errors);
+
+    // nothing comes after stop
+    int got = halves + fulls;
+    wait_ms(20);
+    TEST_ASSERT_EQUAL(got, halves + fulls);
+}
+
+void test_one_shot()
+{
+    AnalogOut out(DAC_PIN);
+
+    fill_ramp();
+    reset_counts();
+    TEST_ASSERT_EQUAL(0, out.play(wave, SAMPLES, RATE_HZ, on_events, ANALOGOUT_EVENT_COMPLETE));
+    wait_ms(2 * 1000 * SAMPLES / RATE_HZ);
+    TEST_ASSERT(!out.playing());
+    TEST_ASSERT_EQUAL(1, fulls);
+    TEST_ASSERT_EQUAL(0, halves);
+
+    // the output holds the last sample and takes writes again
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, wave[SAMPLES - 1] / 65535.0f, out.read());
+    out.write_u16(0);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, out.read());
+}
+
+void test_bad_arguments()
+{
+    AnalogOut out(DAC_PIN);
+
+    TEST_ASSERT_EQUAL(-1, out.play(wave, 0, RATE_HZ, on_events));
+    TEST_ASSERT_EQUAL(-1, out.play(wave, SAMPLES, 0, on_events));
+    TEST_ASSERT(!out.playing());
+
+    // one playback at a time
+    TEST_ASSERT_EQUAL(0, out.play(wave, SAMPLES, RATE_HZ, on_events, ANALOGOUT_EVENT_ALL, true));
+    TEST_ASSERT_EQUAL(-1, out.play(wave, SAMPLES, RATE_HZ, on_events));
+    out.stop();
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Circular playback at the requested rate", test_circular_rate),
+    Case("One-shot playback", test_one_shot),
+    Case("Bad arguments", test_bad_arguments),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
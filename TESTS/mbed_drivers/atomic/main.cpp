@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "Atomic.h"
+
+#if !defined(MBED_CONF_RTOS_PRESENT)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define THREAD_STACK_SIZE   512
+#define ITERATIONS          100000
+
+void test_c_functions()
+{
+    uint8_t u8 = 0xF0;
+    TEST_ASSERT_EQUAL(0xF0, core_util_atomic_fetch_or_u8(&u8, 0x0F));
+    TEST_ASSERT_EQUAL(0xFF, core_util_atomic_load_u8(&u8));
+
+    uint16_t u16 = 1;
+    TEST_ASSERT_EQUAL(1, core_util_atomic_fetch_sub_u16(&u16, 2));
+    TEST_ASSERT_EQUAL(0xFFFF, u16);
+
+    uint32_t u32 = 0xFF00FF00;
+    TEST_ASSERT_EQUAL_HEX32(0xFF00FF00, core_util_atomic_fetch_and_u32(&u32, 0x0FF00FF0));
+    TEST_ASSERT_EQUAL_HEX32(0x0F000F00, core_util_atomic_fetch_xor_u32(&u32, 0x0F000F00));
+    TEST_ASSERT_EQUAL(0, core_util_atomic_exchange_u32(&u32, 7));
+    core_util_atomic_store_u32(&u32, 9);
+    TEST_ASSERT_EQUAL(9, u32);
+
+    uint64_t u64 = 0xFFFFFFFF;
+    TEST_ASSERT_TRUE(core_util_atomic_incr_u64(&u64, 1) == 0x100000000ULL);
+    uint64_t expected = 0;
+    TEST_ASSERT_FALSE(core_util_atomic_cas_u64(&u64, &expected, 1));
+    TEST_ASSERT_TRUE(expected == 0x100000000ULL);
+    TEST_ASSERT_TRUE(core_util_atomic_cas_u64(&u64, &expected, 1));
+    TEST_ASSERT_TRUE(core_util_atomic_load_u64(&u64) == 1);
+
+    int values[2];
+    void *ptr = &values[0];
+    TEST_ASSERT_EQUAL_PTR(&values[0], core_util_atomic_exchange_ptr(&ptr, &values[1]));
+    TEST_ASSERT_EQUAL_PTR(&values[1], core_util_atomic_load_ptr(&ptr));
+}
+
+void test_template()
+{
+    Atomic<int16_t> i16(-1);
+    TEST_ASSERT_EQUAL(0, ++i16);
+    TEST_ASSERT_EQUAL(0, i16--);
+    TEST_ASSERT_EQUAL(-1, i16.load());
+
+    Atomic<uint32_t> flags;
+    flags |= 0x5;
+    flags &= ~0x1u;
+    TEST_ASSERT_EQUAL(0x4, flags.exchange(0));
+
+    uint32_t expected = 1;
+    TEST_ASSERT_FALSE(flags.compare_exchange(expected, 2));
+    TEST_ASSERT_EQUAL(0, expected);
+    TEST_ASSERT_TRUE(flags.compare_exchange(expected, 2));
+    TEST_ASSERT_EQUAL(2, flags);
+
+    Atomic<int64_t> i64(-2);
+    i64 += 0x100000000LL;
+    TEST_ASSERT_TRUE(i64.load() == 0xFFFFFFFELL);
+
+    int values[4];
+    Atomic<int *> ptr(values);
+    ptr += 2;
+    TEST_ASSERT_EQUAL_PTR(&values[2], ptr.load());
+    TEST_ASSERT_EQUAL_PTR(&values[2], ptr--);
+    TEST_ASSERT_EQUAL_PTR(&values[1], ptr.load());
+}
+
+static Atomic<uint32_t> counter32;
+static Atomic<uint64_t> counter64;
+static Atomic<uint8_t> counter8;
+
+static void increment()
+{
+    for (int i = 0; i < ITERATIONS; i++) {
+        counter32++;
+        counter64 += 3;
+        counter8.fetch_add(1);
+    }
+}
+
+// The threads preempt each other in the middle of the operations
+void test_contention()
+{
+    Thread thread1(osPriorityNormal, THREAD_STACK_SIZE);
+    Thread thread2(osPriorityNormal, THREAD_STACK_SIZE);
+    Thread thread3(osPriorityNormal, THREAD_STACK_SIZE);
+
+    thread1.start(increment);
+    thread2.start(increment);
+    thread3.start(increment);
+    thread1.join();
+    thread2.join();
+    thread3.join();
+
+    TEST_ASSERT_EQUAL(3 * ITERATIONS, counter32.load());
+    TEST_ASSERT_TRUE(counter64.load() == 9 * ITERATIONS);
+    TEST_ASSERT_EQUAL((uint8_t)(3 * ITERATIONS), counter8.load());
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("C functions", test_c_functions),
+    Case("template", test_template),
+    Case("contention", test_contention),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
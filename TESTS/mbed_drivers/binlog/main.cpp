@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_binlog.h"
+#include <string.h>
+
+using namespace utest::v1;
+
+// Records of the packets written by the log
+static uint8_t captured[MBED_CONF_PLATFORM_BINLOG_SIZE];
+static uint32_t captured_size;
+static uint32_t dropped_cnt;
+static bool bad_packet;
+
+static const char printf_format[] = "value %d name %s pi %f\n";
+
+static void capture_write(const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t magic;
+    uint16_t records_size, dropped;
+
+    memcpy(&magic, bytes, 4);
+    memcpy(&records_size, bytes + 4, 2);
+    memcpy(&dropped, bytes + 6, 2);
+    if (magic != MBED_BINLOG_MAGIC || size != 8u + records_size) {
+        bad_packet = true;
+        return;
+    }
+
+    dropped_cnt += dropped;
+    if (captured_size + records_size <= sizeof(captured)) {
+        memcpy(captured + captured_size, bytes + 8, records_size);
+        captured_size += records_size;
+    }
+}
+
+static void capture_reset()
+{
+    mbed_binlog_flush(capture_write);
+    captured_size = 0;
+    dropped_cnt = 0;
+    bad_packet = false;
+}
+
+// Header of the record at an offset of the captured records
+static mbed_binlog_header_t captured_header(uint32_t offset)
+{
+    mbed_binlog_header_t header;
+    memcpy(&header, captured + offset, sizeof(header));
+    return header;
+}
+
+void test_words()
+{
+    capture_reset();
+    MBED_BINLOG("rx %u bytes, status %x", 100, 0x5a);
+    MBED_BINLOG("no arguments");
+    mbed_binlog_flush(capture_write);
+
+    TEST_ASSERT_FALSE(bad_packet);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(mbed_binlog_header_t) * 2 + 8, captured_size);
+
+    mbed_binlog_header_t header = captured_header(0);
+    TEST_ASSERT_EQUAL_UINT8(MBED_BINLOG_SECTION_TYPE, header.type);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(header) + 8, header.size);
+    uint32_t args[2];
+    memcpy(args, captured + sizeof(header), sizeof(args));
+    TEST_ASSERT_EQUAL_UINT32(100, args[0]);
+    TEST_ASSERT_EQUAL_UINT32(0x5a, args[1]);
+
+    mbed_binlog_header_t second = captured_header(header.size);
+    TEST_ASSERT_EQUAL_UINT16(sizeof(second), second.size);
+    TEST_ASSERT(second.format != header.format);
+    TEST_ASSERT(second.time - header.time < 1000);
+}
+
+void test_printf()
+{
+    capture_reset();
+    mbed_binlog_printf(printf_format, -7, "binlog", 2.5);
+    mbed_binlog_flush(capture_write);
+
+    TEST_ASSERT_FALSE(bad_packet);
+    mbed_binlog_header_t header = captured_header(0);
+    TEST_ASSERT_EQUAL_UINT8(MBED_BINLOG_TYPE_PRINTF, header.type);
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)printf_format, header.format);
+    // Word, length byte and string, double
+    TEST_ASSERT_EQUAL_UINT16(sizeof(header) + 4 + 1 + 6 + 8, header.size);
+
+    const uint8_t *args = captured + sizeof(header);
+    int32_t value;
+    double pi;
+    memcpy(&value, args, 4);
+    memcpy(&pi, args + 11, 8);
+    TEST_ASSERT_EQUAL_INT32(-7, value);
+    TEST_ASSERT_EQUAL_UINT8(6, args[4]);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(args + 5, "binlog", 6));
+    TEST_ASSERT(pi == 2.5);
+}
+
+void test_dropped()
+{
+    const int records = MBED_CONF_PLATFORM_BINLOG_SIZE / (sizeof(mbed_binlog_header_t) + 4) + 10;
+
+    capture_reset();
+    for (int i = 0; i < records; i++) {
+        MBED_BINLOG("record %d", i);
+    }
+    mbed_binlog_flush(capture_write);
+
+    TEST_ASSERT_FALSE(bad_packet);
+    TEST_ASSERT(dropped_cnt >= 10);
+    TEST_ASSERT_EQUAL_UINT32(records, dropped_cnt + captured_size / (sizeof(mbed_binlog_header_t) + 4));
+}
+
+Case cases[] = {
+    Case("Test binlog words", test_words),
+    Case("Test binlog printf", test_printf),
+    Case("Test binlog dropped", test_dropped),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+int main()
+{
+    Harness::run(Specification(greentea_test_setup, cases));
+}
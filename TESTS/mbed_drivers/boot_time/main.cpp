@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_boot_time.h"
+
+#if !defined(MBED_CONF_PLATFORM_BOOT_TIME) || !MBED_CONF_PLATFORM_BOOT_TIME
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+// Startup is well under this on every target
+#define BOOT_TIME_MAX_US    5000000
+
+void test_phases_marked()
+{
+    TEST_ASSERT_EQUAL_UINT32(0, mbed_boot_time_get(MBED_BOOT_START));
+    TEST_ASSERT_NOT_EQUAL(MBED_BOOT_TIME_NONE, mbed_boot_time_get(MBED_BOOT_SDK_INIT));
+    TEST_ASSERT_NOT_EQUAL(MBED_BOOT_TIME_NONE, mbed_boot_time_get(MBED_BOOT_CONSTRUCTORS));
+    TEST_ASSERT_NOT_EQUAL(MBED_BOOT_TIME_NONE, mbed_boot_time_get(MBED_BOOT_MAIN));
+    TEST_ASSERT_EQUAL_UINT32(MBED_BOOT_TIME_NONE, mbed_boot_time_get(MBED_BOOT_PHASES));
+}
+
+void test_phases_in_order()
+{
+    uint32_t previous = 0;
+    for (int i = 0; i < MBED_BOOT_PHASES; i++) {
+        uint32_t time = mbed_boot_time_get((mbed_boot_phase_t)i);
+        if (time == MBED_BOOT_TIME_NONE) {
+            continue;
+        }
+        TEST_ASSERT(time >= previous);
+        previous = time;
+    }
+    TEST_ASSERT(previous < BOOT_TIME_MAX_US);
+}
+
+void test_first_mark_counts()
+{
+    uint32_t main_time = mbed_boot_time_get(MBED_BOOT_MAIN);
+    wait_ms(10);
+    mbed_boot_time_mark(MBED_BOOT_MAIN);
+    TEST_ASSERT_EQUAL_UINT32(main_time, mbed_boot_time_get(MBED_BOOT_MAIN));
+    mbed_boot_time_dump();
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Boot phases marked", test_phases_marked),
+    Case("Boot phases in order", test_phases_in_order),
+    Case("First mark of a phase counts", test_first_mark_counts),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_PORTOUT || !DEVICE_PORTINOUT
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+// Nothing needs to be connected, outputs read back their own level
+void test_out_round_trip()
+{
+    BusOut bus(LED1, LED2, LED3, NC, LED4);
+
+    for (int v = 0; v < 32; v++) {
+        bus = v;
+        TEST_ASSERT_EQUAL(v & bus.mask(), bus.read());
+    }
+}
+
+void test_unordered_pins()
+{
+    // pins out of the order of their port bits
+    PinName pins[16] = { D3, D2, D5, D4, NC, NC, NC, NC, NC, NC, NC, NC, NC, NC, NC, NC };
+    BusInOut bus(pins);
+
+    bus.output();
+    for (int v = 0; v < 16; v++) {
+        bus.write(v);
+        TEST_ASSERT_EQUAL(v, bus.read());
+    }
+    bus.input();
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("BusOut reads back its writes", test_out_round_trip),
+    Case("BusInOut with pins out of order", test_unordered_pins),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_cache.h"
+
+#if !defined(__DCACHE_PRESENT) || (__DCACHE_PRESENT != 1)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE     100
+
+MBED_CACHE_ALIGNED static uint8_t buffer[MBED_CACHE_ROUND_UP(BUFFER_SIZE)];
+
+static bool dcache_enabled()
+{
+    return SCB->CCR & SCB_CCR_DC_Msk;
+}
+
+void test_alignment()
+{
+    TEST_ASSERT_EQUAL(0, (uint32_t)buffer % MBED_CACHE_LINE_SIZE);
+    TEST_ASSERT_EQUAL(0, sizeof(buffer) % MBED_CACHE_LINE_SIZE);
+    TEST_ASSERT(sizeof(buffer) >= BUFFER_SIZE);
+    TEST_ASSERT_EQUAL(0, MBED_CACHE_ROUND_UP(0));
+    TEST_ASSERT_EQUAL(MBED_CACHE_LINE_SIZE, MBED_CACHE_ROUND_UP(1));
+}
+
+void test_invalidate_drops_writes()
+{
+    if (!dcache_enabled()) {
+        TEST_IGNORE_MESSAGE("data cache disabled");
+        return;
+    }
+
+    // Memory holds 0xAA once cleaned
+    memset(buffer, 0xAA, sizeof(buffer));
+    mbed_dcache_clean(buffer, sizeof(buffer));
+
+    // Writes only reaching the cache are lost by an invalidate
+    memset(buffer, 0x55, sizeof(buffer));
+    mbed_dcache_invalidate(buffer, sizeof(buffer));
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        TEST_ASSERT_EQUAL_HEX8(0xAA, buffer[i]);
+    }
+}
+
+void test_clean_invalidate_keeps_writes()
+{
+    if (!dcache_enabled()) {
+        TEST_IGNORE_MESSAGE("data cache disabled");
+        return;
+    }
+
+    memset(buffer, 0xAA, sizeof(buffer));
+    mbed_dcache_clean(buffer, sizeof(buffer));
+
+    // Partial range, the lines it touches are written back in whole
+    memset(buffer, 0x55, sizeof(buffer));
+    mbed_dcache_clean_invalidate(buffer + 1, BUFFER_SIZE - 2);
+    for (size_t i = 0; i < sizeof(buffer); i++) {
+        TEST_ASSERT_EQUAL_HEX8(0x55, buffer[i]);
+    }
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Cache aligned buffers", test_alignment),
+    Case("Invalidate drops cached writes", test_invalidate_drops_writes),
+    Case("Clean and invalidate keeps cached writes", test_clean_invalidate_keeps_writes),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
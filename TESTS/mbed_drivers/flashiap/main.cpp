@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_FLASH
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define DATA_SIZE       64
+#define TIMEOUT_US      5000000
+
+FlashIAP flash;
+
+static uint8_t data[DATA_SIZE];
+static uint8_t readback[DATA_SIZE];
+
+// the last sector, well past the test image
+static uint32_t last_sector()
+{
+    uint32_t end = flash.get_flash_start() + flash.get_flash_size();
+    return end - flash.get_sector_size(end - 1);
+}
+
+static void fill(uint8_t seed)
+{
+    for (int i = 0; i < DATA_SIZE; i++) {
+        data[i] = (uint8_t)(seed + i * 7);
+    }
+}
+
+void test_erase_program()
+{
+    uint32_t addr = last_sector();
+    uint32_t sector = flash.get_sector_size(addr);
+
+    TEST_ASSERT_EQUAL(0, flash.init());
+    TEST_ASSERT_EQUAL(0, DATA_SIZE % flash.get_page_size());
+
+    TEST_ASSERT_EQUAL(0, flash.erase(addr, sector));
+    TEST_ASSERT_EQUAL(0, flash.read(readback, addr, DATA_SIZE));
+    for (int i = 0; i < DATA_SIZE; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0xFF, readback[i]);
+    }
+
+    fill(1);
+    TEST_ASSERT_EQUAL(0, flash.program(data, addr, DATA_SIZE));
+    TEST_ASSERT_EQUAL(0, flash.read(readback, addr, DATA_SIZE));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, readback, DATA_SIZE);
+}
+
+void test_invalid()
+{
+    uint32_t addr = last_sector();
+    uint32_t end = flash.get_flash_start() + flash.get_flash_size();
+
+    TEST_ASSERT_EQUAL(MBED_FLASH_INVALID_SIZE, flash.get_sector_size(end));
+    TEST_ASSERT_EQUAL(-1, flash.erase(addr + flash.get_page_size(), flash.get_sector_size(addr)));
+    TEST_ASSERT_EQUAL(-1, flash.erase(addr, flash.get_sector_size(addr) + flash.get_page_size()));
+    TEST_ASSERT_EQUAL(-1, flash.program(data, end, DATA_SIZE));
+    TEST_ASSERT_EQUAL(-1, flash.read(readback, end - 1, 2));
+}
+
+#if DEVICE_FLASH_ASYNCH
+static volatile int event;
+
+static void done(int e)
+{
+    event = e;
+}
+
+static void wait_event()
+{
+    Timer timer;
+    timer.start();
+    while (!event && timer.read_us() < TIMEOUT_US);
+    TEST_ASSERT_EQUAL(FLASH_EVENT_COMPLETE, event);
+    TEST_ASSERT_FALSE(flash.busy());
+}
+
+void test_asynch()
+{
+    uint32_t addr = last_sector();
+    TEST_ASSERT_TRUE(flash.is_rww(addr));
+
+    event = 0;
+    TEST_ASSERT_EQUAL(0, flash.erase(addr, flash.get_sector_size(addr), done));
+    // one operation at a time
+    TEST_ASSERT_EQUAL(-1, flash.erase(addr, flash.get_sector_size(addr), done));
+    wait_event();
+
+    fill(2);
+    event = 0;
+    TEST_ASSERT_EQUAL(0, flash.program(data, addr, DATA_SIZE, done));
+    wait_event();
+    TEST_ASSERT_EQUAL(0, flash.read(readback, addr, DATA_SIZE));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, readback, DATA_SIZE);
+}
+#endif
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Erase, program and read back", test_erase_program),
+    Case("Ranges outside the flash or sectors", test_invalid),
+#if DEVICE_FLASH_ASYNCH
+    Case("Erase and program in the background", test_asynch),
+#endif
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
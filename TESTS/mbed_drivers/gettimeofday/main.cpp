@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2013-2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_RTC
+  #error [NOT_SUPPORTED] RTC not supported for this target
+#endif
+
+using namespace utest::v1;
+
+#define CUSTOM_TIME  1256729737
+
+static uint64_t to_us(const struct mbed_timeval &tv) {
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+void test_case_gettimeofday_seconds() {
+    set_time(CUSTOM_TIME);
+
+    struct mbed_timeval tv;
+    TEST_ASSERT_EQUAL(0, mbed_gettimeofday(&tv));
+    TEST_ASSERT_UINT32_WITHIN(1, CUSTOM_TIME, tv.tv_sec);
+    TEST_ASSERT_TRUE(tv.tv_usec < 1000000);
+
+    // seconds agree with time(), within the RTC's second
+    time_t seconds = time(NULL);
+    TEST_ASSERT_UINT32_WITHIN(1, seconds, tv.tv_sec);
+}
+
+void test_case_gettimeofday_elapsed() {
+    set_time(CUSTOM_TIME);
+
+    struct mbed_timeval start;
+    struct mbed_timeval end;
+    mbed_gettimeofday(&start);
+    wait_ms(100);
+    mbed_gettimeofday(&end);
+
+    // a reread RTC may move the time to its second boundary
+    uint64_t elapsed = to_us(end) - to_us(start);
+    TEST_ASSERT_TRUE(to_us(end) > to_us(start));
+    TEST_ASSERT_TRUE(elapsed < 1100000);
+}
+
+void test_case_gettimeofday_monotonic() {
+    set_time(CUSTOM_TIME);
+
+    struct mbed_timeval last;
+    mbed_gettimeofday(&last);
+
+    // across a few RTC seconds
+    Timer timer;
+    timer.start();
+    while (timer.read_ms() < 2500) {
+        struct mbed_timeval tv;
+        mbed_gettimeofday(&tv);
+        TEST_ASSERT_TRUE(tv.tv_usec < 1000000);
+        TEST_ASSERT_TRUE(to_us(tv) >= to_us(last));
+        last = tv;
+        wait_ms(10);
+    }
+}
+
+Case cases[] = {
+    Case("gettimeofday seconds", test_case_gettimeofday_seconds),
+    Case("gettimeofday elapsed", test_case_gettimeofday_elapsed),
+    Case("gettimeofday monotonic", test_case_gettimeofday_monotonic),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    Harness::run(specification);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_heap_region.h"
+#include <string.h>
+
+#if !MBED_CONF_PLATFORM_HEAP_REGION_FALLBACK
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+// The external region is left out, its memory needs to be set up by the
+// application first
+
+void test_default_region()
+{
+    void *ptr = mbed_malloc_region(MBED_HEAP_REGION_DEFAULT, 100);
+    TEST_ASSERT_NOT_NULL(ptr);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)ptr & 7);
+    memset(ptr, 0xa5, 100);
+    mbed_free_region(ptr);
+
+    mbed_tlsf_info_t info;
+    TEST_ASSERT_EQUAL(-1, mbed_heap_region_get_info(MBED_HEAP_REGION_DEFAULT, &info));
+}
+
+void test_fast_region()
+{
+    mbed_tlsf_info_t before, after;
+    bool present = mbed_heap_region_get_info(MBED_HEAP_REGION_FAST, &before) == 0;
+
+    void *ptr = mbed_malloc_region(MBED_HEAP_REGION_FAST, 256);
+    TEST_ASSERT_NOT_NULL(ptr);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)ptr & 7);
+    memset(ptr, 0x5a, 256);
+
+    if (present) {
+        TEST_ASSERT_EQUAL(0, mbed_heap_region_get_info(MBED_HEAP_REGION_FAST, &after));
+        TEST_ASSERT_EQUAL(before.used_cnt + 1, after.used_cnt);
+    }
+
+    mbed_free_region(ptr);
+
+    if (present) {
+        TEST_ASSERT_EQUAL(0, mbed_heap_region_get_info(MBED_HEAP_REGION_FAST, &after));
+        TEST_ASSERT_EQUAL(before.used_cnt, after.used_cnt);
+        TEST_ASSERT_EQUAL(before.free_size, after.free_size);
+    }
+}
+
+void test_fast_region_fallback()
+{
+    mbed_tlsf_info_t info;
+    if (mbed_heap_region_get_info(MBED_HEAP_REGION_FAST, &info) != 0) {
+        TEST_IGNORE_MESSAGE("No fast region");
+        return;
+    }
+
+    // Larger than the free memory of the region, comes from the malloc heap
+    void *ptr = mbed_malloc_region(MBED_HEAP_REGION_FAST, info.largest_free + 8);
+    if (ptr) {
+        mbed_tlsf_info_t after;
+        mbed_heap_region_get_info(MBED_HEAP_REGION_FAST, &after);
+        TEST_ASSERT_EQUAL(info.used_cnt, after.used_cnt);
+        mbed_free_region(ptr);
+    }
+}
+
+Case cases[] = {
+    Case("Test default region", test_default_region),
+    Case("Test fast region", test_fast_region),
+    Case("Test fast region fallback", test_fast_region_fallback),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+int main()
+{
+    Harness::run(Specification(greentea_test_setup, cases));
+}
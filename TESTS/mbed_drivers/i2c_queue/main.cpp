@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_I2C_ASYNCH || !TRANSACTION_QUEUE_SIZE_I2C
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define TIMEOUT_US      1000000
+// Nothing answers there, every transfer ends with an error event
+#define NO_SLAVE        0x10
+
+I2C i2c(I2C_SDA, I2C_SCL);
+
+static char reg = 0;
+static char data[4];
+
+static volatile int order[TRANSACTION_QUEUE_SIZE_I2C + 2];
+static volatile int done;
+static volatile int chained;
+
+static void record(int id) {
+    if (done < (int)(sizeof(order) / sizeof(order[0]))) {
+        order[done] = id;
+    }
+    done = done + 1;
+}
+
+static void done_1(int event) { record(1); }
+static void done_2(int event) { record(2); }
+static void done_3(int event) { record(3); }
+
+static void done_chain(int event) {
+    record(1);
+    // start the next transfer from the interrupt
+    if (chained++ == 0) {
+        i2c.transfer(NO_SLAVE, &reg, 1, data, sizeof(data), done_chain, I2C_EVENT_ALL);
+    }
+}
+
+static void wait_done(int count) {
+    Timer timer;
+    timer.start();
+    while (done < count && timer.read_us() < TIMEOUT_US);
+    TEST_ASSERT_EQUAL(count, done);
+}
+
+void test_queue_order()
+{
+    done = 0;
+    TEST_ASSERT_EQUAL(0, i2c.transfer(NO_SLAVE, &reg, 1, data, sizeof(data), done_1, I2C_EVENT_ALL));
+    TEST_ASSERT_EQUAL(0, i2c.transfer(NO_SLAVE, &reg, 1, data, sizeof(data), done_2, I2C_EVENT_ALL));
+    TEST_ASSERT_EQUAL(0, i2c.transfer(NO_SLAVE, &reg, 1, NULL, 0, done_3, I2C_EVENT_ALL));
+    wait_done(3);
+    TEST_ASSERT_EQUAL(1, order[0]);
+    TEST_ASSERT_EQUAL(2, order[1]);
+    TEST_ASSERT_EQUAL(3, order[2]);
+}
+
+void test_queue_full()
+{
+    int queued = 0;
+
+    done = 0;
+    while (i2c.transfer(NO_SLAVE, &reg, 1, data, sizeof(data), done_1, I2C_EVENT_ALL) == 0) {
+        queued++;
+        // some may complete meanwhile, the queue still fills up
+        TEST_ASSERT(queued <= 4 * (TRANSACTION_QUEUE_SIZE_I2C + 1));
+    }
+    TEST_ASSERT(queued >= TRANSACTION_QUEUE_SIZE_I2C);
+    wait_done(queued);
+}
+
+void test_unrequested_event()
+{
+    done = 0;
+    // the first callback is not called, the queue still moves on
+    TEST_ASSERT_EQUAL(0, i2c.transfer(NO_SLAVE, &reg, 1, data, sizeof(data), done_1, I2C_EVENT_TRANSFER_COMPLETE));
+    TEST_ASSERT_EQUAL(0, i2c.transfer(NO_SLAVE, &reg, 1, data, sizeof(data), done_2, I2C_EVENT_ALL));
+    wait_done(1);
+    TEST_ASSERT_EQUAL(2, order[0]);
+}
+
+void test_chain_from_callback()
+{
+    done = 0;
+    chained = 0;
+    TEST_ASSERT_EQUAL(0, i2c.transfer(NO_SLAVE, &reg, 1, data, sizeof(data), done_chain, I2C_EVENT_ALL));
+    wait_done(2);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Queued transfers run in order", test_queue_order),
+    Case("Queue full", test_queue_full),
+    Case("Queue moves on after unrequested events", test_unrequested_event),
+    Case("Transfer started from a callback", test_chain_from_callback),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+using namespace utest::v1;
+
+#if defined(MBED_CONF_PLATFORM_IRQ_MASK_PRIORITY) && defined(__CORTEX_M) && (__CORTEX_M >= 3)
+#define BASEPRI_SUPPORTED 1
+#else
+#define BASEPRI_SUPPORTED 0
+#endif
+
+static volatile uint32_t ticks;
+
+static void tick()
+{
+    ticks++;
+}
+
+// The ticker interrupt is of normal priority and waits for the section
+void test_masks_driver_interrupts()
+{
+    Timeout timeout;
+
+    ticks = 0;
+    uint32_t mask = core_util_irq_mask_enter();
+    timeout.attach_us(tick, 100);
+    wait_us(1000);
+    uint32_t during = ticks;
+    core_util_irq_mask_exit(mask);
+    wait_us(1000);
+
+    TEST_ASSERT_EQUAL(0, during);
+    TEST_ASSERT_EQUAL(1, ticks);
+}
+
+void test_nesting()
+{
+    uint32_t outer = core_util_irq_mask_enter();
+    uint32_t inner = core_util_irq_mask_enter();
+    core_util_critical_section_enter();
+    core_util_critical_section_exit();
+    core_util_irq_mask_exit(inner);
+#if BASEPRI_SUPPORTED
+    // Still masked, and interrupts above the priority keep running
+    TEST_ASSERT_NOT_EQUAL(0, __get_BASEPRI());
+    TEST_ASSERT_TRUE(core_util_are_interrupts_enabled());
+#else
+    TEST_ASSERT_FALSE(core_util_are_interrupts_enabled());
+#endif
+    core_util_irq_mask_exit(outer);
+
+#if BASEPRI_SUPPORTED
+    TEST_ASSERT_EQUAL(0, __get_BASEPRI());
+#endif
+    TEST_ASSERT_TRUE(core_util_are_interrupts_enabled());
+}
+
+void test_priorities_moved()
+{
+#if BASEPRI_SUPPORTED
+    // Whether or not it is enabled yet
+    TEST_ASSERT_EQUAL(MBED_CONF_PLATFORM_IRQ_MASK_PRIORITY, NVIC_GetPriority((IRQn_Type)0));
+#else
+    TEST_IGNORE_MESSAGE("needs platform.irq-mask-priority on Cortex-M3, M4 or M7");
+#endif
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("masks driver interrupts", test_masks_driver_interrupts),
+    Case("nesting", test_nesting),
+    Case("priorities moved", test_priorities_moved),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
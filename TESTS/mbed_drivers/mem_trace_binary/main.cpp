@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_mem_trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MBED_MEM_TRACING_ENABLED
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define CAPTURE_RECORDS     64
+
+// Records decoded from the packets written by the tracer
+static mbed_mem_trace_record_t captured[CAPTURE_RECORDS];
+static volatile uint32_t captured_cnt;
+static volatile uint32_t dropped_cnt;
+static volatile bool bad_packet;
+
+static void capture_write(const void *data, size_t size)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    uint32_t magic;
+    uint16_t count, dropped;
+
+    memcpy(&magic, bytes, 4);
+    memcpy(&count, bytes + 4, 2);
+    memcpy(&dropped, bytes + 6, 2);
+    if (magic != MBED_MEM_TRACE_BINARY_MAGIC || size != 8 + count * sizeof(mbed_mem_trace_record_t)) {
+        bad_packet = true;
+        return;
+    }
+
+    dropped_cnt += dropped;
+    for (uint16_t i = 0; i < count && captured_cnt < CAPTURE_RECORDS; i++) {
+        memcpy(&captured[captured_cnt++], bytes + 8 + i * sizeof(mbed_mem_trace_record_t),
+               sizeof(mbed_mem_trace_record_t));
+    }
+}
+
+static void capture_reset()
+{
+    // Records of earlier operations are discarded
+    mbed_mem_trace_binary_flush(capture_write);
+    captured_cnt = 0;
+    dropped_cnt = 0;
+    bad_packet = false;
+}
+
+// Index of the record of an operation on ptr, -1 if there is none
+static int find_record(uint8_t op, void *ptr)
+{
+    for (uint32_t i = 0; i < captured_cnt; i++) {
+        if ((captured[i].size_op & 7) == op && captured[i].ptr == (uint32_t)ptr) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void test_records()
+{
+    mbed_mem_trace_set_callback(mbed_mem_trace_binary_callback);
+    capture_reset();
+
+    void *p1 = malloc(50);
+    void *p2 = calloc(10, 4);
+    void *p3 = realloc(p1, 200);
+    free(p2);
+    free(p3);
+    mbed_mem_trace_set_callback(NULL);
+
+    mbed_mem_trace_binary_flush(capture_write);
+    TEST_ASSERT_FALSE(bad_packet);
+    TEST_ASSERT_EQUAL(0, dropped_cnt);
+
+    int i = find_record(MBED_MEM_TRACE_MALLOC, p1);
+    TEST_ASSERT(i >= 0);
+    TEST_ASSERT_EQUAL_UINT32(50, captured[i].size_op >> 3);
+
+    i = find_record(MBED_MEM_TRACE_CALLOC, p2);
+    TEST_ASSERT(i >= 0);
+    TEST_ASSERT_EQUAL_UINT32(40, captured[i].size_op >> 3);
+
+    // realloc frees the old block first
+    int freed = find_record(MBED_MEM_TRACE_FREE, p1);
+    i = find_record(MBED_MEM_TRACE_REALLOC, p3);
+    TEST_ASSERT(freed >= 0 && i > freed);
+    TEST_ASSERT_EQUAL_UINT32(200, captured[i].size_op >> 3);
+
+    TEST_ASSERT(find_record(MBED_MEM_TRACE_FREE, p2) > 0);
+    TEST_ASSERT(find_record(MBED_MEM_TRACE_FREE, p3) > i);
+
+    // Times never go backwards within one thread
+    for (uint32_t k = 1; k < captured_cnt; k++) {
+        TEST_ASSERT((int32_t)(captured[k].time - captured[k - 1].time) >= 0);
+    }
+}
+
+void test_dropped()
+{
+    mbed_mem_trace_set_callback(mbed_mem_trace_binary_callback);
+    capture_reset();
+
+    // More operations than the ring holds, each malloc and free is a record
+    const int ops = MBED_CONF_PLATFORM_MEM_TRACE_BINARY_RECORDS;
+    for (int i = 0; i < ops; i++) {
+        free(malloc(8));
+    }
+    mbed_mem_trace_set_callback(NULL);
+
+    mbed_mem_trace_binary_flush(capture_write);
+    TEST_ASSERT_FALSE(bad_packet);
+    TEST_ASSERT_EQUAL_UINT32(2 * ops, dropped_cnt + MBED_CONF_PLATFORM_MEM_TRACE_BINARY_RECORDS);
+}
+
+void test_drain_thread()
+{
+    capture_reset();
+    mbed_mem_trace_binary_start(capture_write);
+
+    void *ptr = malloc(24);
+    free(ptr);
+    Thread::wait(3 * MBED_CONF_PLATFORM_MEM_TRACE_BINARY_PERIOD);
+    mbed_mem_trace_set_callback(NULL);
+
+    TEST_ASSERT_FALSE(bad_packet);
+    TEST_ASSERT(find_record(MBED_MEM_TRACE_MALLOC, ptr) >= 0);
+    TEST_ASSERT(find_record(MBED_MEM_TRACE_FREE, ptr) >= 0);
+}
+
+Case cases[] = {
+    Case("Test binary records", test_records),
+    Case("Test dropped records", test_dropped),
+    Case("Test drain thread", test_drain_thread),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+int main()
+{
+    Harness::run(Specification(greentea_test_setup, cases));
+}
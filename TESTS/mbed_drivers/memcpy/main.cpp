@@ -0,0 +1,170 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// The benchmark reads the cycle counter whatever the build profile
+#define MBED_PROFILE_ENABLED 1
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "platform/mbed_memcpy.h"
+#include "platform/mbed_profile.h"
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE     1024
+#define MAX_SIZE        80
+#define GUARD           8
+
+MBED_ALIGN(4) static uint8_t src[BUFFER_SIZE + GUARD];
+MBED_ALIGN(4) static uint8_t dst[BUFFER_SIZE + GUARD];
+static uint8_t expected[BUFFER_SIZE + GUARD];
+
+static void fill(int seed)
+{
+    for (size_t i = 0; i < sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 7 + seed);
+        dst[i] = (uint8_t)(i * 13 + seed + 1);
+    }
+    memcpy(expected, dst, sizeof(expected));
+}
+
+static void byte_copy(uint8_t *d, const uint8_t *s, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        d[i] = s[i];
+    }
+}
+
+void test_memcpy()
+{
+    for (size_t n = 0; n <= MAX_SIZE; n++) {
+        for (size_t d = 0; d < 4; d++) {
+            for (size_t s = 0; s < 4; s++) {
+                fill(n + d + s);
+                byte_copy(&expected[d], &src[s], n);
+                TEST_ASSERT_EQUAL_PTR(&dst[d], mbed_memcpy(&dst[d], &src[s], n));
+                // nothing around the copy is touched
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, dst, MAX_SIZE + GUARD);
+            }
+        }
+    }
+}
+
+void test_memmove()
+{
+    for (size_t n = 0; n <= MAX_SIZE; n++) {
+        for (size_t d = 0; d < 8; d++) {
+            for (size_t s = 0; s < 8; s++) {
+                fill(n + d + s);
+                // overlapping both ways, in the destination buffer
+                uint8_t tmp[MAX_SIZE];
+                byte_copy(tmp, &expected[s], n);
+                byte_copy(&expected[d], tmp, n);
+                TEST_ASSERT_EQUAL_PTR(&dst[d], mbed_memmove(&dst[d], &dst[s], n));
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, dst, MAX_SIZE + GUARD);
+            }
+        }
+    }
+}
+
+void test_memset()
+{
+    for (size_t n = 0; n <= MAX_SIZE; n++) {
+        for (size_t d = 0; d < 4; d++) {
+            fill(n + d);
+            for (size_t i = 0; i < n; i++) {
+                expected[d + i] = 0xA5;
+            }
+            TEST_ASSERT_EQUAL_PTR(&dst[d], mbed_memset(&dst[d], 0x1A5, n));
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, dst, MAX_SIZE + GUARD);
+        }
+    }
+}
+
+template <typename F>
+static uint32_t cycles_of(F copy, size_t d, size_t s, size_t n)
+{
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < 8; i++) {
+        uint32_t start = mbed_profile_start();
+        copy(&dst[d], &src[s], n);
+        uint32_t cycles = mbed_profile_elapsed(start);
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    return best;
+}
+
+static void *library_memcpy(void *d, const void *s, size_t n)
+{
+    return memcpy(d, s, n);
+}
+
+static void *bytes_memcpy(void *d, const void *s, size_t n)
+{
+    // volatile, else the compiler makes the loop a call to memcpy
+    volatile uint8_t *vd = (volatile uint8_t *)d;
+    const uint8_t *vs = (const uint8_t *)s;
+    for (size_t i = 0; i < n; i++) {
+        vd[i] = vs[i];
+    }
+    return d;
+}
+
+void test_benchmark()
+{
+    static const size_t sizes[] = { 8, 32, 128, 512, BUFFER_SIZE };
+    static const size_t offsets[][2] = { { 0, 0 }, { 1, 1 }, { 0, 1 }, { 2, 0 } };
+
+    printf("cycles: size dst+src mbed_memcpy memcpy bytes\r\n");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        for (size_t j = 0; j < sizeof(offsets) / sizeof(offsets[0]); j++) {
+            size_t d = offsets[j][0], s = offsets[j][1];
+            size_t n = sizes[i] - (d > s ? d : s);
+            printf("cycles: %4u +%u+%u %6lu %6lu %6lu\r\n", (unsigned)n, (unsigned)d, (unsigned)s,
+                   (unsigned long)cycles_of(mbed_memcpy, d, s, n),
+                   (unsigned long)cycles_of(library_memcpy, d, s, n),
+                   (unsigned long)cycles_of(bytes_memcpy, d, s, n));
+        }
+    }
+
+    // No worse than one byte at a time on large copies, aligned or not
+    TEST_ASSERT(cycles_of(mbed_memcpy, 0, 0, BUFFER_SIZE) < cycles_of(bytes_memcpy, 0, 0, BUFFER_SIZE));
+    TEST_ASSERT(cycles_of(mbed_memcpy, 0, 1, BUFFER_SIZE - 1) < cycles_of(bytes_memcpy, 0, 1, BUFFER_SIZE - 1));
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(30, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("mbed_memcpy at all alignments", test_memcpy),
+    Case("mbed_memmove overlapping", test_memmove),
+    Case("mbed_memset at all alignments", test_memset),
+    Case("Cycles across sizes and alignments", test_benchmark),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+using namespace utest::v1;
+
+// A device made readable from interrupt context, after a delay
+class TestDevice : public FileHandle {
+public:
+    TestDevice() : _ready(false) {}
+
+    void ready_in(int us) {
+        _timeout.attach_us(callback(this, &TestDevice::make_ready), us);
+    }
+
+    virtual ssize_t write(const void *buffer, size_t length) { return length; }
+    virtual ssize_t read(void *buffer, size_t length) { _ready = false; return 0; }
+    virtual int close() { return 0; }
+    virtual int isatty() { return 0; }
+    virtual off_t lseek(off_t offset, int whence) { return -1; }
+    virtual int fsync() { return 0; }
+
+    virtual short poll(short events) const {
+        return (_ready ? POLLIN : 0) & events;
+    }
+
+private:
+    void make_ready() {
+        _ready = true;
+        poll_wake();
+    }
+
+    volatile bool _ready;
+    Timeout _timeout;
+};
+
+void test_poll_no_wait()
+{
+    TestDevice device;
+    pollfh fhs[2] = {{&device, POLLIN, 0}, {&device, POLLOUT, 0}};
+
+    TEST_ASSERT_EQUAL(0, poll(fhs, 2, 0));
+    TEST_ASSERT_EQUAL(0, fhs[0].revents);
+    TEST_ASSERT_EQUAL(0, fhs[1].revents);
+}
+
+void test_poll_timeout()
+{
+    TestDevice device;
+    pollfh fhs[1] = {{&device, POLLIN, 0}};
+    Timer timer;
+
+    timer.start();
+    TEST_ASSERT_EQUAL(0, poll(fhs, 1, 50));
+    TEST_ASSERT_INT_WITHIN(10000, 50000, timer.read_us());
+}
+
+void test_poll_wake()
+{
+    TestDevice device;
+    pollfh fhs[1] = {{&device, POLLIN, 0}};
+    Timer timer;
+
+    device.ready_in(20000);
+    timer.start();
+    TEST_ASSERT_EQUAL(1, poll(fhs, 1, 1000));
+    TEST_ASSERT_EQUAL(POLLIN, fhs[0].revents);
+    TEST_ASSERT_INT_WITHIN(10000, 20000, timer.read_us());
+}
+
+// Handles without readiness, such as files, never block
+class TestFile : public FileHandle {
+public:
+    virtual ssize_t write(const void *buffer, size_t length) { return length; }
+    virtual ssize_t read(void *buffer, size_t length) { return 0; }
+    virtual int close() { return 0; }
+    virtual int isatty() { return 0; }
+    virtual off_t lseek(off_t offset, int whence) { return 0; }
+    virtual int fsync() { return 0; }
+};
+
+void test_poll_default_ready()
+{
+    TestFile file;
+    pollfh fhs[2] = {{&file, POLLIN | POLLOUT, 0}, {NULL, POLLIN, 0}};
+
+    TEST_ASSERT_TRUE(file.readable());
+    TEST_ASSERT_TRUE(file.writable());
+    TEST_ASSERT_EQUAL(-1, file.set_blocking(false));
+    TEST_ASSERT_TRUE(file.is_blocking());
+
+    TEST_ASSERT_EQUAL(1, poll(fhs, 2, -1));
+    TEST_ASSERT_EQUAL(POLLIN | POLLOUT, fhs[0].revents);
+    TEST_ASSERT_EQUAL(0, fhs[1].revents);
+}
+
+Case cases[] = {
+    Case("Test poll without waiting", test_poll_no_wait),
+    Case("Test poll timeout", test_poll_timeout),
+    Case("Test poll woken by a device", test_poll_wake),
+    Case("Test handles ready by default", test_poll_default_ready),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+int main()
+{
+    Harness::run(Specification(greentea_test_setup, cases));
+}
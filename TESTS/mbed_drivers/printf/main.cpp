@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Checks the output of the compact printf of mbed_printf.h, and prints the
+// cycles and stack it takes next to the C library's vsnprintf. With the
+// platform.minimal-printf option on GCC both are the compact one. The code
+// size of the two is compared with the memory map of a build with and
+// without the option.
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_printf.h"
+#include "mbed_stats.h"
+
+#if !defined(MBED_CONF_RTOS_PRESENT)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE     64
+#define STACK_SIZE      2048
+
+static char buffer[BUFFER_SIZE];
+
+#define CHECK(expected, ...) do {                                   \
+        int n = mbed_snprintf(buffer, sizeof(buffer), __VA_ARGS__); \
+        TEST_ASSERT_EQUAL_STRING(expected, buffer);                 \
+        TEST_ASSERT_EQUAL(strlen(expected), n);                     \
+    } while (0)
+
+void test_integers()
+{
+    CHECK("0 -1 42", "%d %i %u", 0, -1, 42);
+    CHECK("-2147483648 4294967295", "%ld %lu", (long)INT32_MIN, (unsigned long)UINT32_MAX);
+    CHECK("[   42|42   |00042|+42| 42]", "[%5d|%-5d|%05d|%+d|% d]", 42, 42, 42, 42, 42);
+    CHECK("[007|| -007|0x0ff]", "[%.3d|%.0d|%5.3d|%#.3x]", 7, 0, -7, 255);
+    CHECK("deadbeef DEADBEEF 0xff 0XFF 010 0", "%x %X %#x %#X %#o %#o", 0xdeadbeef, 0xdeadbeef, 255, 255, 8, 0);
+    CHECK("44 4464 44 4464", "%hhd %hd %hhu %hu", 300, 70000, 300, 70000);
+    CHECK("[    5|5    ]", "[%*d|%-*d]", 5, 5, 5, 5);
+    CHECK("42 -3", "%zu %td", (size_t)42, (ptrdiff_t)-3);
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF_64BIT
+    CHECK("-1234567890123 18446744073709551615", "%lld %llu", -1234567890123LL, UINT64_MAX);
+#else
+    CHECK("-1 4294967295", "%lld %llu", -1LL, UINT64_MAX);
+#endif
+}
+
+void test_strings()
+{
+    CHECK("[abc|       abc|abc       |ab|       abc]", "[%s|%10s|%-10s|%.2s|%10.3s]", "abc", "abc", "abc", "abc", "abcdef");
+    CHECK("[a|  b|c  ]", "[%c|%3c|%-3c]", 'a', 'b', 'c');
+    CHECK("(null) % 0x1234", "%s %% %p", (char *)NULL, (void *)0x1234);
+
+    int n = 0;
+    CHECK("abc", "abc%n", &n);
+    TEST_ASSERT_EQUAL(3, n);
+}
+
+void test_floats()
+{
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOAT
+    CHECK("0.000000 1.500000 -2.250000", "%f %f %f", 0.0, 1.5, -2.25);
+    CHECK("[     3.142|3.142     |-00003.142|+2.00]", "[%10.3f|%-10.3f|%010.3f|%+.2f]", 3.14159, 3.14159, -3.14159, 2.0);
+    CHECK("0 2 2", "%.0f %.0f %.0f", 0.5, 1.5, 2.5);
+    CHECK("1.234568e+04 1.23E-04 1e+100", "%e %.2E %.0e", 12345.678, 0.00012345, 1e100);
+    CHECK("100000 1e+06 0.0001 1e-05 3.14", "%g %g %g %g %.3g", 100000.0, 1000000.0, 0.0001, 0.00001, 3.14159);
+    CHECK("inf -INF nan", "%f %F %f", HUGE_VAL, -HUGE_VAL, NAN);
+    // Powers of ten formatted with a single digit, after a conversion that left digits behind
+    CHECK("10.000000 1e+02 1e+03 1e+02 1e+10 100 1 10 1e+06", "%f %.0e %.0e %.1g %.1g %g %g %g %g",
+          10.0, 100.0, 1000.0, 100.0, 1e10, 100.0, 1.0, 10.0, 1000000.0);
+#else
+    CHECK("? ?", "%f %g", 1.5, 2.5);
+#endif
+}
+
+void test_truncate()
+{
+    char small[8];
+    int n = mbed_snprintf(small, sizeof(small), "%s", "0123456789");
+    TEST_ASSERT_EQUAL_STRING("0123456", small);
+    TEST_ASSERT_EQUAL(10, n);
+
+    TEST_ASSERT_EQUAL(5, mbed_snprintf(NULL, 0, "%d", 12345));
+}
+
+void test_no_heap()
+{
+#ifdef MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t before, after;
+
+    mbed_stats_heap_get(&before);
+    mbed_snprintf(buffer, sizeof(buffer), "%s %d %x %c", "abc", -1, 255, 'z');
+    mbed_printf("printf: %s\n", "no heap");
+    mbed_stats_heap_get(&after);
+
+    TEST_ASSERT_EQUAL(before.total_size, after.total_size);
+#else
+    TEST_IGNORE_MESSAGE("needs MBED_HEAP_STATS_ENABLED");
+#endif
+}
+
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+static void cycles_init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t cycles_read()
+{
+    return DWT->CYCCNT;
+}
+#else
+static void cycles_init()
+{
+}
+
+static uint32_t cycles_read()
+{
+    return us_ticker_read() * (SystemCoreClock / 1000000);
+}
+#endif
+
+typedef int (*format_t)(char *buffer, size_t size, const char *fmt, va_list args);
+
+static format_t format;
+static uint32_t format_cycles;
+
+static int call(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    uint32_t start = cycles_read();
+    int n = format(buffer, sizeof(buffer), fmt, args);
+    format_cycles = cycles_read() - start;
+    va_end(args);
+    return n;
+}
+
+static void format_line()
+{
+    call("%s: %5d %08lx %-6s|", "line", 1234, 0xbeefUL, "end");
+}
+
+static void measure(const char *name, format_t function)
+{
+    Thread thread(osPriorityNormal, STACK_SIZE);
+
+    format = function;
+    thread.start(format_line);
+    thread.join();
+
+    printf("printf: %-16s %6lu cycles %5lu bytes of stack\r\n", name,
+           (unsigned long)format_cycles, (unsigned long)thread.max_stack());
+}
+
+void test_benchmark()
+{
+    cycles_init();
+    measure("vsnprintf", vsnprintf);
+    measure("mbed_vsnprintf", mbed_vsnprintf);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("integers", test_integers),
+    Case("strings", test_strings),
+    Case("floats", test_floats),
+    Case("truncate", test_truncate),
+    Case("no heap", test_no_heap),
+    Case("benchmark", test_benchmark),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
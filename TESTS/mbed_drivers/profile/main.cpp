@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_profile.h"
+
+#ifndef MBED_PROFILE_ENABLED
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+// Short enough for the SysTick of an RTOS tick on M0
+#define DELAY_US    200
+
+static mbed_profile_region_t scope_region = MBED_PROFILE_REGION_INIT("scope");
+
+static void timed_scope()
+{
+    mbed::ProfileScope scope(&scope_region);
+    wait_us(DELAY_US);
+}
+
+void test_region()
+{
+    MBED_PROFILE_REGION(delay);
+    const uint32_t expected = SystemCoreClock / 1000000 * DELAY_US;
+
+    for (int i = 0; i < 4; i++) {
+        MBED_PROFILE_BEGIN(delay);
+        wait_us(DELAY_US);
+        MBED_PROFILE_END(delay);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(4, delay.count);
+    TEST_ASSERT(delay.min >= expected);
+    TEST_ASSERT(delay.max < 2 * expected);
+    TEST_ASSERT(delay.min <= delay.max);
+    TEST_ASSERT(delay.total >= 4 * (uint64_t)delay.min);
+    TEST_ASSERT(delay.total <= 4 * (uint64_t)delay.max);
+}
+
+void test_scope()
+{
+    timed_scope();
+    timed_scope();
+
+    TEST_ASSERT_EQUAL_UINT32(2, scope_region.count);
+    TEST_ASSERT(scope_region.min >= SystemCoreClock / 1000000 * DELAY_US);
+}
+
+void test_counter()
+{
+    MBED_PROFILE_COUNTER(bytes);
+
+    MBED_PROFILE_ADD(bytes, 10);
+    MBED_PROFILE_ADD(bytes, 30);
+    MBED_PROFILE_ADD(bytes, 20);
+
+    TEST_ASSERT_EQUAL_UINT32(3, bytes.count);
+    TEST_ASSERT_EQUAL_UINT32(10, bytes.min);
+    TEST_ASSERT_EQUAL_UINT32(30, bytes.max);
+    TEST_ASSERT_EQUAL_UINT64(60, bytes.total);
+
+    mbed_profile_dump();
+    mbed_profile_reset();
+
+    TEST_ASSERT_EQUAL_UINT32(0, bytes.count);
+    TEST_ASSERT_EQUAL_UINT32(0, scope_region.count);
+
+    // Still in the table after a reset
+    MBED_PROFILE_ADD(bytes, 5);
+    TEST_ASSERT_EQUAL_UINT32(1, bytes.count);
+    TEST_ASSERT_EQUAL_UINT32(5, bytes.max);
+    mbed_profile_dump();
+}
+
+Case cases[] = {
+    Case("Test profile region", test_region),
+    Case("Test profile scope", test_scope),
+    Case("Test profile counter", test_counter),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+int main()
+{
+    Harness::run(Specification(greentea_test_setup, cases));
+}
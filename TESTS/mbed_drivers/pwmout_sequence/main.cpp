@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_PWMOUT_ASYNCH
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define RATE_HZ         100000
+#define ENTRIES         1000
+#define RUN_MS          200
+
+// Nothing needs to be connected
+PwmOut pwm(D9);
+
+static uint16_t pulses[ENTRIES];
+
+static volatile int halves;
+static volatile int fulls;
+
+static void on_events(int event) {
+    if (event & PWMOUT_EVENT_HALF_COMPLETE) {
+        halves = halves + 1;
+    }
+    if (event & PWMOUT_EVENT_COMPLETE) {
+        fulls = fulls + 1;
+    }
+}
+
+static void fill(float low, float high) {
+    uint16_t a = pwm.sequence_pulse(RATE_HZ, low);
+    uint16_t b = pwm.sequence_pulse(RATE_HZ, high);
+    for (int i = 0; i < ENTRIES; i++) {
+        pulses[i] = (i & 1) ? b : a;
+    }
+}
+
+void test_circular_rate()
+{
+    fill(0.25f, 0.75f);
+    halves = 0;
+    fulls = 0;
+    TEST_ASSERT_EQUAL(0, pwm.play(pulses, ENTRIES, RATE_HZ, on_events, PWMOUT_EVENT_ALL, true));
+    TEST_ASSERT(pwm.playing());
+    wait_ms(RUN_MS);
+    pwm.stop();
+    TEST_ASSERT(!pwm.playing());
+
+    // one pass every ENTRIES / RATE_HZ seconds
+    int expected = RUN_MS * RATE_HZ / 1000 / ENTRIES;
+    TEST_ASSERT_INT_WITHIN(2, expected, fulls);
+    TEST_ASSERT_INT_WITHIN(1, halves, fulls);
+
+    int got = halves + fulls;
+    wait_ms(20);
+    TEST_ASSERT_EQUAL(got, halves + fulls);
+}
+
+void test_one_shot()
+{
+    fill(0.5f, 0.5f);
+    pulses[ENTRIES - 1] = pwm.sequence_pulse(RATE_HZ, 0.0f);
+    halves = 0;
+    fulls = 0;
+    TEST_ASSERT_EQUAL(0, pwm.play(pulses, ENTRIES, RATE_HZ, on_events, PWMOUT_EVENT_COMPLETE));
+    wait_ms(2 * 1000 * ENTRIES / RATE_HZ);
+    TEST_ASSERT(!pwm.playing());
+    TEST_ASSERT_EQUAL(1, fulls);
+    TEST_ASSERT_EQUAL(0, halves);
+}
+
+void test_bad_arguments()
+{
+    TEST_ASSERT_EQUAL(-1, pwm.play(pulses, 0, RATE_HZ, on_events));
+    TEST_ASSERT_EQUAL(-1, pwm.play(pulses, ENTRIES, 0, on_events));
+    TEST_ASSERT(!pwm.playing());
+
+    // one sequence at a time
+    TEST_ASSERT_EQUAL(0, pwm.play(pulses, ENTRIES, RATE_HZ, on_events, PWMOUT_EVENT_ALL, true));
+    TEST_ASSERT_EQUAL(-1, pwm.play(pulses, ENTRIES, RATE_HZ, on_events));
+    pwm.stop();
+}
+
+void test_regular_output_after()
+{
+    fill(0.5f, 0.5f);
+    TEST_ASSERT_EQUAL(0, pwm.play(pulses, ENTRIES, RATE_HZ, on_events));
+    wait_ms(2 * 1000 * ENTRIES / RATE_HZ);
+
+    // period() brings back the regular timebase
+    pwm.period_ms(10);
+    pwm.write(0.5f);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.5f, pwm.read());
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Circular sequence at the requested rate", test_circular_rate),
+    Case("One-shot sequence", test_one_shot),
+    Case("Bad arguments", test_bad_arguments),
+    Case("Regular output after a sequence", test_regular_output_after),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_sampler.h"
+
+#if !DEVICE_SAMPLE_TIMER || !defined(MBED_CONF_PLATFORM_SAMPLER) || !MBED_CONF_PLATFORM_SAMPLER
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define SAMPLE_HZ   1000
+#define SPIN_MS     200
+
+static mbed_sampler_entry_t entries[MBED_CONF_PLATFORM_SAMPLER_SLOTS];
+
+// Busy loop the samples of the test should land in
+static void spin(uint32_t ms)
+{
+    Timer timer;
+    timer.start();
+    while (timer.read_ms() < (int)ms) {
+    }
+}
+
+void test_samples()
+{
+    mbed_sampler_info_t info;
+
+    mbed_sampler_reset();
+    TEST_ASSERT_EQUAL(0, mbed_sampler_start(SAMPLE_HZ));
+    spin(SPIN_MS);
+    mbed_sampler_stop();
+
+    mbed_sampler_get_info(&info);
+    TEST_ASSERT_EQUAL_UINT32(SAMPLE_HZ, info.hz);
+    TEST_ASSERT_UINT32_WITHIN(SAMPLE_HZ * SPIN_MS / 1000 / 10, SAMPLE_HZ * SPIN_MS / 1000, info.samples);
+    TEST_ASSERT_EQUAL_UINT32(0, info.dropped);
+
+    size_t count = mbed_sampler_get_entries(entries, MBED_CONF_PLATFORM_SAMPLER_SLOTS);
+    TEST_ASSERT_EQUAL_UINT32(info.entries, count);
+
+    // Nearly all samples are of this thread
+    uint32_t total = 0;
+    uint32_t own = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += entries[i].count;
+        if (entries[i].thread == (uint32_t)osThreadGetId()) {
+            own += entries[i].count;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(info.samples, total);
+    TEST_ASSERT(own > total * 9 / 10);
+
+    mbed_sampler_dump();
+}
+
+void test_stopped()
+{
+    mbed_sampler_info_t before;
+    mbed_sampler_info_t after;
+
+    mbed_sampler_get_info(&before);
+    spin(50);
+    mbed_sampler_get_info(&after);
+    TEST_ASSERT_EQUAL_UINT32(before.samples, after.samples);
+
+    mbed_sampler_reset();
+    mbed_sampler_get_info(&after);
+    TEST_ASSERT_EQUAL_UINT32(0, after.samples);
+    TEST_ASSERT_EQUAL_UINT32(0, mbed_sampler_get_entries(entries, MBED_CONF_PLATFORM_SAMPLER_SLOTS));
+}
+
+Case cases[] = {
+    Case("Test sampler samples", test_samples),
+    Case("Test sampler stopped", test_stopped),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+int main()
+{
+    Harness::run(Specification(greentea_test_setup, cases));
+}
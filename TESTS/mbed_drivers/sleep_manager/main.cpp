@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_SLEEP
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+static void nothing() {
+}
+
+void test_lock_nesting()
+{
+    TEST_ASSERT(sleep_manager_can_deep_sleep());
+    sleep_manager_lock_deep_sleep();
+    sleep_manager_lock_deep_sleep();
+    TEST_ASSERT(!sleep_manager_can_deep_sleep());
+    sleep_manager_unlock_deep_sleep();
+    TEST_ASSERT(!sleep_manager_can_deep_sleep());
+    sleep_manager_unlock_deep_sleep();
+    TEST_ASSERT(sleep_manager_can_deep_sleep());
+}
+
+void test_driver_lock()
+{
+    DeepSleepLock lock;
+
+    // nested locks of a driver take one sleep manager lock
+    lock.lock();
+    lock.lock();
+    mbed_stats_sleep_t stats;
+    mbed_stats_sleep_get(&stats);
+    TEST_ASSERT_EQUAL(1, stats.lock_cnt);
+    lock.unlock();
+    TEST_ASSERT(!sleep_manager_can_deep_sleep());
+    lock.unlock();
+    TEST_ASSERT(sleep_manager_can_deep_sleep());
+
+    // released when the driver goes away
+    {
+        DeepSleepLock held;
+        held.lock();
+        TEST_ASSERT(!sleep_manager_can_deep_sleep());
+    }
+    TEST_ASSERT(sleep_manager_can_deep_sleep());
+}
+
+void test_timer_locks()
+{
+    Timer timer;
+
+    timer.start();
+    TEST_ASSERT(!sleep_manager_can_deep_sleep());
+    timer.stop();
+    timer.stop();
+    TEST_ASSERT(sleep_manager_can_deep_sleep());
+}
+
+void test_sleep_counted()
+{
+    mbed_stats_sleep_t before, after;
+    Timeout timeout;
+
+    mbed_stats_sleep_get(&before);
+    // the pending us ticker event keeps it out of deep sleep
+    timeout.attach_us(nothing, 1000);
+    TEST_ASSERT(!sleep_manager_can_deep_sleep());
+    core_util_critical_section_enter();
+    sleep_manager_sleep_auto();
+    core_util_critical_section_exit();
+    mbed_stats_sleep_get(&after);
+    TEST_ASSERT_EQUAL(before.sleep_cnt + 1, after.sleep_cnt);
+    TEST_ASSERT_EQUAL(before.deep_sleep_cnt, after.deep_sleep_cnt);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Deep sleep locks nest", test_lock_nesting),
+    Case("Driver lock", test_driver_lock),
+    Case("Running Timer locks deep sleep", test_timer_locks),
+    Case("Sleeps are counted", test_sleep_counted),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
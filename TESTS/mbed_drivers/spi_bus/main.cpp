@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+
+#if !DEVICE_SPI_ASYNCH
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define TRANSFER_SIZE   64
+#define TIMEOUT_US      1000000
+
+// Nothing needs to be connected, received data is not checked
+SPIBus bus(SPI_MOSI, SPI_MISO, SPI_SCK);
+SPIDevice display(bus, NC, 8, 0, 1000000, 0);
+SPIDevice flash(bus, NC, 8, 3, 4000000, 0);
+SPIDevice radio(bus, NC, 8, 0, 2000000, 1);
+
+static uint8_t tx[TRANSFER_SIZE];
+static uint8_t rx[TRANSFER_SIZE];
+
+static volatile int order[8];
+static volatile int done;
+
+static void record(int id) {
+    if (done < (int)(sizeof(order) / sizeof(order[0]))) {
+        order[done] = id;
+    }
+    done = done + 1;
+}
+
+static void done_1(int event) { record(1); }
+static void done_2(int event) { record(2); }
+static void done_3(int event) { record(3); }
+
+static void wait_done(int count) {
+    Timer timer;
+    timer.start();
+    while (done < count && timer.read_us() < TIMEOUT_US);
+    TEST_ASSERT_EQUAL(count, done);
+}
+
+void test_priority()
+{
+    done = 0;
+    // the first transfer starts at once, the radio goes before the second
+    TEST_ASSERT_EQUAL(0, display.transfer(tx, TRANSFER_SIZE, rx, TRANSFER_SIZE, done_1));
+    TEST_ASSERT_EQUAL(0, display.transfer(tx, TRANSFER_SIZE, rx, TRANSFER_SIZE, done_2));
+    TEST_ASSERT_EQUAL(0, radio.transfer(tx, TRANSFER_SIZE, rx, TRANSFER_SIZE, done_3));
+    wait_done(3);
+    TEST_ASSERT_EQUAL(1, order[0]);
+    TEST_ASSERT_EQUAL(3, order[1]);
+    TEST_ASSERT_EQUAL(2, order[2]);
+}
+
+void test_batching()
+{
+    done = 0;
+    // same priority, the device on the bus keeps it
+    TEST_ASSERT_EQUAL(0, display.transfer(tx, TRANSFER_SIZE, rx, TRANSFER_SIZE, done_1));
+    TEST_ASSERT_EQUAL(0, flash.transfer(tx, TRANSFER_SIZE, rx, TRANSFER_SIZE, done_2));
+    TEST_ASSERT_EQUAL(0, display.transfer(tx, TRANSFER_SIZE, rx, TRANSFER_SIZE, done_3));
+    wait_done(3);
+    TEST_ASSERT_EQUAL(1, order[0]);
+    TEST_ASSERT_EQUAL(3, order[1]);
+    TEST_ASSERT_EQUAL(2, order[2]);
+}
+
+void test_queue_full()
+{
+    int queued = 0;
+
+    done = 0;
+    while (flash.transfer(tx, TRANSFER_SIZE, rx, TRANSFER_SIZE, done_1) == 0) {
+        queued++;
+        // some may complete meanwhile, the queue still fills up
+        TEST_ASSERT(queued <= 2 * MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE);
+    }
+    TEST_ASSERT(queued > 0);
+    wait_done(queued);
+}
+
+void test_blocking_between()
+{
+    done = 0;
+    TEST_ASSERT_EQUAL(0, display.transfer(tx, TRANSFER_SIZE, rx, TRANSFER_SIZE, done_1));
+    // waits for the running transfer, then holds back the queued one
+    TEST_ASSERT_EQUAL(0, display.transfer(tx, TRANSFER_SIZE, rx, TRANSFER_SIZE, done_2));
+    char cmd[4] = { 0x03, 0x00, 0x00, 0x00 };
+    char data[8];
+    flash.select();
+    TEST_ASSERT_EQUAL(4, flash.write(cmd, sizeof(cmd), NULL, 0));
+    int before = done;
+    TEST_ASSERT_EQUAL(8, flash.write(NULL, 0, data, sizeof(data)));
+    TEST_ASSERT_EQUAL(before, done);
+    flash.deselect();
+    wait_done(2);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Higher priority device goes first", test_priority),
+    Case("Transfers of the current device are batched", test_batching),
+    Case("Queue full", test_queue_full),
+    Case("Blocking transfers between queued ones", test_blocking_between),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
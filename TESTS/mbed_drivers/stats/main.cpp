@@ -186,11 +186,77 @@ void test_case_realloc_size()
     TEST_ASSERT_EQUAL_UINT32(stats_start.current_size, stats_current.current_size);
 }
 
+void test_case_size_histogram()
+{
+    mbed_stats_heap_hist_t hist_start;
+    mbed_stats_heap_hist_t hist_current;
+
+    mbed_stats_heap_hist_get(&hist_start);
+
+    // 124 bytes are in the class of up to 128, 564 bytes in the one of up to 1024
+    void *small = malloc(ALLOCATION_SIZE_SMALL);
+    void *large = malloc(ALLOCATION_SIZE_DEFAULT);
+    TEST_ASSERT(small != NULL && large != NULL);
+    mbed_stats_heap_hist_get(&hist_current);
+    TEST_ASSERT_EQUAL_UINT32(hist_start.alloc_cnt[4] + 1, hist_current.alloc_cnt[4]);
+    TEST_ASSERT_EQUAL_UINT32(hist_start.current_cnt[4] + 1, hist_current.current_cnt[4]);
+    TEST_ASSERT_EQUAL_UINT32(hist_start.alloc_cnt[7] + 1, hist_current.alloc_cnt[7]);
+    TEST_ASSERT_EQUAL_UINT32(hist_start.current_cnt[7] + 1, hist_current.current_cnt[7]);
+
+    free(small);
+    free(large);
+    mbed_stats_heap_hist_get(&hist_current);
+    TEST_ASSERT_EQUAL_UINT32(hist_start.current_cnt[4], hist_current.current_cnt[4]);
+    TEST_ASSERT_EQUAL_UINT32(hist_start.current_cnt[7], hist_current.current_cnt[7]);
+}
+
+#if MBED_HEAP_STATS_CALLERS
+static mbed_stats_heap_caller_t callers[MBED_HEAP_STATS_CALLERS + 1];
+
+void test_case_callers()
+{
+    void *data[2];
+
+    size_t count = mbed_stats_heap_caller_get(callers, MBED_HEAP_STATS_CALLERS + 1);
+    uint32_t total_start = 0;
+    for (size_t i = 0; i < count; i++) {
+        total_start += callers[i].total_size;
+    }
+
+    // Both allocations come from the same call site
+    for (int i = 0; i < 2; i++) {
+        data[i] = malloc(ALLOCATION_SIZE_LARGE);
+        TEST_ASSERT(data[i] != NULL);
+    }
+
+    count = mbed_stats_heap_caller_get(callers, MBED_HEAP_STATS_CALLERS + 1);
+    TEST_ASSERT(count > 0);
+    uint32_t total_current = 0;
+    bool found = false;
+    for (size_t i = 0; i < count; i++) {
+        total_current += callers[i].total_size;
+        if (callers[i].current_cnt >= 2 && callers[i].current_size >= 2 * ALLOCATION_SIZE_LARGE) {
+            found = true;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(total_start + 2 * ALLOCATION_SIZE_LARGE, total_current);
+    TEST_ASSERT_TRUE(found);
+
+    free(data[0]);
+    free(data[1]);
+    mbed_stats_heap_dump();
+}
+#endif
+
 Case cases[] = {
     Case("malloc and free size", test_case_malloc_free_size),
     Case("allocate size zero", test_case_allocate_zero),
     Case("allocation failure", test_case_allocate_fail),
     Case("realloc size", test_case_realloc_size),
+    Case("size histogram", test_case_size_histogram),
+#if MBED_HEAP_STATS_CALLERS
+    Case("call sites", test_case_callers),
+#endif
 };
 
 utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_stdio_buffer.h"
+
+#if !DEVICE_SERIAL || !MBED_CONF_PLATFORM_STDIO_BUFFER_SIZE || MBED_CONF_PLATFORM_STDIO_BUFFER_SIZE < 256
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define LINE_LENGTH 100
+
+// Microseconds the UART takes for a number of bytes of 10 bits
+static uint32_t send_time_us(uint32_t bytes)
+{
+    return (uint64_t)bytes * 10 * 1000000 / MBED_CONF_PLATFORM_STDIO_BAUD_RATE;
+}
+
+static void print_line()
+{
+    char line[LINE_LENGTH];
+    memset(line, '.', sizeof(line) - 2);
+    line[sizeof(line) - 2] = '\n';
+    line[sizeof(line) - 1] = 0;
+    fputs(line, stdout);
+    fflush(stdout);
+}
+
+void test_write_returns_early()
+{
+    Timer timer;
+
+    mbed_stdio_buffer_flush();
+    timer.start();
+    print_line();
+    uint32_t written = timer.read_us();
+    mbed_stdio_buffer_flush();
+    uint32_t flushed = timer.read_us();
+
+    // The line is sent after the write returned, and by the flush
+    TEST_ASSERT(written < send_time_us(LINE_LENGTH) / 4);
+    TEST_ASSERT(flushed > send_time_us(LINE_LENGTH) / 2);
+}
+
+void test_fill_buffer()
+{
+    uint32_t dropped = mbed_stdio_buffer_get_dropped();
+
+    mbed_stdio_buffer_flush();
+    for (int i = 0; i < 2 * MBED_CONF_PLATFORM_STDIO_BUFFER_SIZE / LINE_LENGTH + 1; i++) {
+        print_line();
+    }
+    mbed_stdio_buffer_flush();
+
+    // Only the BLOCK policy keeps every byte
+    uint32_t now_dropped = mbed_stdio_buffer_get_dropped();
+#define STDIO_BUFFER_TEST_BLOCK 1
+#define STDIO_BUFFER_TEST_POLICY_(policy) STDIO_BUFFER_TEST_##policy
+#define STDIO_BUFFER_TEST_POLICY(policy) STDIO_BUFFER_TEST_POLICY_(policy)
+#if STDIO_BUFFER_TEST_POLICY(MBED_CONF_PLATFORM_STDIO_BUFFER_OVERFLOW) == STDIO_BUFFER_TEST_BLOCK
+    TEST_ASSERT_EQUAL_UINT32(dropped, now_dropped);
+#else
+    TEST_ASSERT(now_dropped > dropped);
+#endif
+}
+
+// Larger than the buffer, so that a single write has to wait for the TX interrupt
+static char large_write[2 * MBED_CONF_PLATFORM_STDIO_BUFFER_SIZE + LINE_LENGTH];
+
+void test_write_larger_than_buffer()
+{
+    uint32_t dropped = mbed_stdio_buffer_get_dropped();
+
+    memset(large_write, '.', sizeof(large_write));
+    for (size_t i = LINE_LENGTH - 1; i < sizeof(large_write); i += LINE_LENGTH) {
+        large_write[i] = '\n';
+    }
+    large_write[sizeof(large_write) - 1] = '\n';
+
+    mbed_stdio_buffer_flush();
+    mbed_stdio_buffer_write(large_write, sizeof(large_write));
+    mbed_stdio_buffer_flush();
+
+#if STDIO_BUFFER_TEST_POLICY(MBED_CONF_PLATFORM_STDIO_BUFFER_OVERFLOW) == STDIO_BUFFER_TEST_BLOCK
+    TEST_ASSERT_EQUAL_UINT32(dropped, mbed_stdio_buffer_get_dropped());
+#else
+    TEST_ASSERT(mbed_stdio_buffer_get_dropped() > dropped);
+#endif
+}
+
+Case cases[] = {
+    Case("Test write returns before sending", test_write_returns_early),
+    Case("Test write to a full buffer", test_fill_buffer),
+    Case("Test write larger than the buffer", test_write_larger_than_buffer),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+int main()
+{
+    Harness::run(Specification(greentea_test_setup, cases));
+}
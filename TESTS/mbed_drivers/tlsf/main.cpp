@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "mbed_tlsf.h"
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !MBED_CONF_PLATFORM_HEAP_TLSF || !defined(TOOLCHAIN_GCC) || defined(FEATURE_UVISOR)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define BLOCK_COUNT         64
+#define ITERATIONS          2000
+
+static void *blocks[BLOCK_COUNT];
+static uint8_t fill[BLOCK_COUNT];
+static size_t sizes[BLOCK_COUNT];
+
+static size_t random_size()
+{
+    return (rand() % 2) ? rand() % 64 : rand() % 1024;
+}
+
+static bool block_intact(int i)
+{
+    const uint8_t *data = (const uint8_t *)blocks[i];
+    for (size_t k = 0; k < sizes[i]; k++) {
+        if (data[k] != fill[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_malloc_goes_to_tlsf()
+{
+    mbed_tlsf_info_t before, after;
+
+    mbed_tlsf_get_info(&before);
+    void *data = malloc(100);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)data & 7);
+    mbed_tlsf_get_info(&after);
+    TEST_ASSERT_EQUAL(before.used_cnt + 1, after.used_cnt);
+
+    free(data);
+    mbed_tlsf_get_info(&after);
+    TEST_ASSERT_EQUAL(before.used_cnt, after.used_cnt);
+    TEST_ASSERT_EQUAL(0, mbed_tlsf_check());
+}
+
+void test_random_alloc_free()
+{
+    srand(1);
+    for (int it = 0; it < ITERATIONS; it++) {
+        int i = rand() % BLOCK_COUNT;
+        if (blocks[i]) {
+            TEST_ASSERT_TRUE(block_intact(i));
+            if (rand() % 3 == 0) {
+                size_t size = random_size() + 1;
+                void *data = realloc(blocks[i], size);
+                TEST_ASSERT_NOT_NULL(data);
+                blocks[i] = data;
+                if (size > sizes[i]) {
+                    memset((uint8_t *)data + sizes[i], fill[i], size - sizes[i]);
+                }
+                sizes[i] = size;
+            } else {
+                free(blocks[i]);
+                blocks[i] = NULL;
+            }
+        } else {
+            sizes[i] = random_size();
+            fill[i] = rand();
+            blocks[i] = (rand() % 2) ? malloc(sizes[i]) : calloc(1, sizes[i]);
+            TEST_ASSERT_NOT_NULL(blocks[i]);
+            memset(blocks[i], fill[i], sizes[i]);
+        }
+
+        if (it % 100 == 0) {
+            TEST_ASSERT_EQUAL(0, mbed_tlsf_check());
+        }
+    }
+
+    for (int i = 0; i < BLOCK_COUNT; i++) {
+        TEST_ASSERT_TRUE(!blocks[i] || block_intact(i));
+        free(blocks[i]);
+        blocks[i] = NULL;
+    }
+    TEST_ASSERT_EQUAL(0, mbed_tlsf_check());
+}
+
+void test_free_blocks_merge()
+{
+    mbed_tlsf_info_t before, after;
+    void *data[8];
+
+    // Grow the heap first so that it does not grow in between
+    free(malloc(8 * 256));
+    mbed_tlsf_get_info(&before);
+    for (int i = 0; i < 8; i++) {
+        data[i] = malloc(200);
+        TEST_ASSERT_NOT_NULL(data[i]);
+    }
+    // Free in an order that leaves holes before merging them
+    for (int i = 0; i < 8; i += 2) {
+        free(data[i]);
+    }
+    for (int i = 1; i < 8; i += 2) {
+        free(data[i]);
+    }
+    mbed_tlsf_get_info(&after);
+
+    TEST_ASSERT_EQUAL(0, mbed_tlsf_check());
+    TEST_ASSERT_EQUAL(before.used_cnt, after.used_cnt);
+    TEST_ASSERT_EQUAL(before.free_cnt, after.free_cnt);
+    TEST_ASSERT_EQUAL(before.largest_free, after.largest_free);
+}
+
+void test_realloc_in_place()
+{
+    void *data = malloc(256);
+    void *next = malloc(256);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_NOT_NULL(next);
+    memset(data, 0x5a, 256);
+
+    // Shrinking never moves
+    TEST_ASSERT_EQUAL_PTR(data, realloc(data, 64));
+
+    // Growing into the free neighbour does not move either
+    free(next);
+    TEST_ASSERT_EQUAL_PTR(data, realloc(data, 384));
+    for (int i = 0; i < 64; i++) {
+        TEST_ASSERT_EQUAL(0x5a, ((uint8_t *)data)[i]);
+    }
+
+    free(data);
+    TEST_ASSERT_EQUAL(0, mbed_tlsf_check());
+}
+
+void test_memalign()
+{
+    mbed_tlsf_info_t before, after;
+
+    // memalign goes to the TLSF heap as well, and its blocks free normally
+    mbed_tlsf_get_info(&before);
+    for (size_t align = 1; align <= 1024; align <<= 1) {
+        void *data = memalign(align, 100);
+        TEST_ASSERT_NOT_NULL(data);
+        TEST_ASSERT_EQUAL(0, (uintptr_t)data & (align - 1));
+        memset(data, 0x5a, 100);
+        TEST_ASSERT_EQUAL(0, mbed_tlsf_check());
+        free(data);
+    }
+    mbed_tlsf_get_info(&after);
+    TEST_ASSERT_EQUAL(before.used_cnt, after.used_cnt);
+
+    // Larger than a chunk the heap grows by
+    void *data = memalign(64, 2 * MBED_CONF_PLATFORM_HEAP_TLSF_GROW);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)data & 63);
+    free(data);
+
+    TEST_ASSERT_NULL(memalign(24, 100));
+    TEST_ASSERT_EQUAL(0, mbed_tlsf_check());
+}
+
+void test_alloc_fail()
+{
+    TEST_ASSERT_NULL(malloc(1024 * 1024 * 1024));
+    TEST_ASSERT_NULL(calloc(0x10000, 0x10001));
+    TEST_ASSERT_EQUAL(0, mbed_tlsf_check());
+}
+
+Case cases[] = {
+    Case("Test malloc uses the TLSF heap", test_malloc_goes_to_tlsf),
+    Case("Test random malloc, realloc and free", test_random_alloc_free),
+    Case("Test freed blocks are merged", test_free_blocks_merge),
+    Case("Test realloc in place", test_realloc_in_place),
+    Case("Test memalign", test_memalign),
+    Case("Test allocation failure", test_alloc_fail),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+int main()
+{
+    Harness::run(Specification(greentea_test_setup, cases));
+}
@@ -16,6 +16,7 @@
  */
 #include "mbed.h"
 #include "greentea-client/test_env.h"
+#include "unity/unity.h"
 #include "utest/utest.h"
 
 /**
@@ -39,8 +40,43 @@ void test_case_ticker() {
     }
 }
 
+// Reading the Timer around the wait takes some microseconds too
+#define WAIT_SLACK_US(us)   (5 + (us) / 20)
+
+template <int US>
+void test_case_short_wait_us() {
+    Timer timer;
+    // times the loop on Cortex-M0 first
+    wait_ns(1);
+    timer.start();
+    int begin = timer.read_us();
+    wait_us(US);
+    int elapsed = timer.read_us() - begin;
+    TEST_ASSERT(elapsed >= US);
+    TEST_ASSERT_INT_WITHIN(WAIT_SLACK_US(US), US, elapsed);
+}
+
+void test_case_wait_ns() {
+    Timer timer;
+    // times the loop on Cortex-M0 first
+    wait_ns(1);
+    timer.start();
+    int begin = timer.read_us();
+    for (int i = 0; i < 100; i++) {
+        wait_ns(1000);
+    }
+    int elapsed = timer.read_us() - begin;
+    // 100 us and the calls
+    TEST_ASSERT(elapsed >= 100);
+    TEST_ASSERT_INT_WITHIN(WAIT_SLACK_US(100) + 20, 100, elapsed);
+}
+
 // Test cases
 Case cases[] = {
+    Case("Timers: wait_us 10 us", test_case_short_wait_us<10>),
+    Case("Timers: wait_us 100 us", test_case_short_wait_us<100>),
+    Case("Timers: wait_us 999 us", test_case_short_wait_us<999>),
+    Case("Timers: wait_ns", test_case_wait_ns),
     Case("Timers: wait_us", test_case_ticker),
 };
 
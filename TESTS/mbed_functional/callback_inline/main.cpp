@@ -0,0 +1,107 @@
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "mbed_stats.h"
+
+using namespace utest::v1;
+
+
+// function objects with state
+struct Sum {
+    int a, b, c;
+    int operator()(int x) const { return a + b + c + x; }
+};
+
+struct Counter {
+    int *count;
+    int step;
+    void operator()() { *count += step; }
+};
+
+static int static_func() { return 0x55; }
+
+struct Thing {
+    int t;
+    int member_func() { return t; }
+};
+
+
+void test_functor() {
+    Sum sum = { 1, 2, 3 };
+    Callback<int(int), sizeof(Sum)> cb(sum);
+    TEST_ASSERT_EQUAL(16, cb(10));
+
+    Callback<int(int), sizeof(Sum)> copy(cb);
+    sum.a = 100;
+    TEST_ASSERT_EQUAL(7, copy(1));
+
+    int count = 0;
+    Counter counter = { &count, 3 };
+    Callback<void(), sizeof(Counter)> inc;
+    TEST_ASSERT_FALSE(inc);
+    inc.attach(counter);
+    inc();
+    inc();
+    TEST_ASSERT_EQUAL(6, count);
+}
+
+void test_other_callbacks() {
+    Callback<int(), sizeof(Callback<int()>)> cb(static_func);
+    TEST_ASSERT_EQUAL(0x55, cb());
+
+    Thing thing = { 0x66 };
+    cb.attach(&thing, &Thing::member_func);
+    TEST_ASSERT_EQUAL(0x66, cb());
+
+    // A plain Callback is itself a function object that fits
+    Callback<int()> plain(&thing, &Thing::member_func);
+    Callback<int(), sizeof(Callback<int()>)> wrapped(plain);
+    thing.t = 0x77;
+    TEST_ASSERT_EQUAL(0x77, wrapped());
+}
+
+void test_size() {
+    TEST_ASSERT_EQUAL(sizeof(Callback<void()>), sizeof(Callback<void(), 0>));
+    TEST_ASSERT(sizeof(Callback<void(), 16>) >= sizeof(Callback<void()>) + 16);
+    TEST_ASSERT(sizeof(Callback<void(), 16>) < sizeof(Callback<void()>) + 16 + sizeof(uintptr_t));
+}
+
+void test_no_heap() {
+#ifdef MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t before, after;
+    int count = 0;
+    Counter counter = { &count, 1 };
+
+    mbed_stats_heap_get(&before);
+    Callback<void(), sizeof(Counter)> cb(counter);
+    Callback<void(), sizeof(Counter)> copy(cb);
+    copy();
+    mbed_stats_heap_get(&after);
+
+    TEST_ASSERT_EQUAL(1, count);
+    TEST_ASSERT_EQUAL(before.total_size, after.total_size);
+#else
+    TEST_IGNORE_MESSAGE("needs MBED_HEAP_STATS_ENABLED");
+#endif
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing inline function objects", test_functor),
+    Case("Testing other callbacks in inline storage", test_other_callbacks),
+    Case("Testing the size of inline storage", test_size),
+    Case("Testing inline storage without heap", test_no_heap),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,165 @@
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "mbed_stats.h"
+#include "IntrusiveCallChain.h"
+
+using namespace utest::v1;
+
+
+static IntrusiveCallChain chain;
+static CallChainEntry entries[4];
+static char order[8];
+static int calls;
+
+static void record(char c) {
+    order[calls++] = c;
+}
+
+static void func_a() { record('a'); }
+static void func_b() { record('b'); }
+static void func_c() { record('c'); }
+static void func_d() { record('d'); }
+
+static void remove_self_and_next() {
+    record('r');
+    chain.remove(&entries[0]);
+    chain.remove(&entries[1]);
+}
+
+static void call_nested() {
+    static bool nested;
+    record('n');
+    if (!nested) {
+        nested = true;
+        chain.call();
+        nested = false;
+    }
+}
+
+static void clear_order() {
+    memset(order, 0, sizeof(order));
+    calls = 0;
+}
+
+static void reset() {
+    chain.clear();
+    clear_order();
+}
+
+
+void test_order() {
+    reset();
+    entries[0].attach(func_a);
+    entries[1].attach(func_b);
+    entries[2].attach(func_c);
+    entries[3].attach(func_d);
+
+    chain.add(&entries[1]);
+    chain.add(&entries[2]);
+    chain.add_front(&entries[0]);
+    chain.add(&entries[3]);
+    chain.call();
+    TEST_ASSERT_EQUAL_STRING("abcd", order);
+
+    TEST_ASSERT_TRUE(chain.remove(&entries[2]));
+    TEST_ASSERT_FALSE(chain.remove(&entries[2]));
+    TEST_ASSERT_NULL(entries[2].get_chain());
+    TEST_ASSERT_EQUAL_PTR(&chain, entries[3].get_chain());
+    TEST_ASSERT_EQUAL_PTR(&entries[3], chain.find(entries[3].get_callback()));
+    TEST_ASSERT_NULL(chain.find(entries[2].get_callback()));
+
+    clear_order();
+    chain();
+    TEST_ASSERT_EQUAL_STRING("abd", order);
+}
+
+void test_remove_while_calling() {
+    reset();
+    entries[0].attach(remove_self_and_next);
+    entries[1].attach(func_b);
+    entries[2].attach(func_c);
+
+    chain.add(&entries[0]);
+    chain.add(&entries[1]);
+    chain.add(&entries[2]);
+    chain.call();
+    TEST_ASSERT_EQUAL_STRING("rc", order);
+
+    clear_order();
+    chain.call();
+    TEST_ASSERT_EQUAL_STRING("c", order);
+
+    chain.remove(&entries[2]);
+    TEST_ASSERT_TRUE(chain.empty());
+}
+
+void test_nested_call() {
+    reset();
+    entries[0].attach(call_nested);
+    entries[1].attach(func_b);
+    chain.add(&entries[0]);
+    chain.add(&entries[1]);
+
+    // the nested call runs the whole chain, then the outer one goes on
+    chain.call();
+    TEST_ASSERT_EQUAL_STRING("nnbb", order);
+}
+
+void test_call_from_interrupt() {
+    reset();
+    entries[0].attach(func_a);
+    entries[1].attach(func_b);
+    chain.add(&entries[0]);
+    chain.add(&entries[1]);
+
+    Timeout timeout;
+    timeout.attach_us(callback(&chain, &IntrusiveCallChain::call), 1000);
+    wait_ms(10);
+    TEST_ASSERT_EQUAL_STRING("ab", order);
+}
+
+void test_no_heap() {
+#ifdef MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t before, after;
+
+    reset();
+    mbed_stats_heap_get(&before);
+    for (int i = 0; i < 4; i++) {
+        entries[i].attach(func_a);
+        chain.add(&entries[i]);
+    }
+    chain.call();
+    for (int i = 0; i < 4; i++) {
+        chain.remove(&entries[i]);
+    }
+    mbed_stats_heap_get(&after);
+
+    TEST_ASSERT_EQUAL(4, calls);
+    TEST_ASSERT_EQUAL(before.alloc_cnt, after.alloc_cnt);
+#else
+    TEST_IGNORE_MESSAGE("needs MBED_HEAP_STATS_ENABLED");
+#endif
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(10, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Testing call order", test_order),
+    Case("Testing remove while calling", test_remove_while_calling),
+    Case("Testing nested call", test_nested_call),
+    Case("Testing call from interrupt", test_call_from_interrupt),
+    Case("Testing chain without heap", test_no_heap),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,157 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "dma_api.h"
+
+using namespace utest::v1;
+
+#define BUFFER_SIZE     4096
+#define TIMEOUT_US      100000
+
+MBED_ALIGN(4) static uint8_t src[BUFFER_SIZE + 4];
+MBED_ALIGN(4) static uint8_t dst[BUFFER_SIZE + 4];
+
+static volatile int copy_event;
+static volatile uint32_t copy_id;
+
+static void fill(int seed) {
+    for (size_t i = 0; i < sizeof(src); i++) {
+        src[i] = (uint8_t)(i * 7 + seed);
+    }
+    memset(dst, 0, sizeof(dst));
+}
+
+static void on_copy(uint32_t id, int event) {
+    copy_id = id;
+    copy_event = event;
+}
+
+template <size_t dst_offset, size_t src_offset, size_t size>
+void test_dma_memcpy()
+{
+    fill(size);
+    TEST_ASSERT_EQUAL_PTR(dst + dst_offset, dma_memcpy(dst + dst_offset, src + src_offset, size));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(src + src_offset, dst + dst_offset, size);
+    // nothing around it is touched
+    TEST_ASSERT_EQUAL_UINT8(0, dst[dst_offset + size]);
+    if (dst_offset) {
+        TEST_ASSERT_EQUAL_UINT8(0, dst[dst_offset - 1]);
+    }
+}
+
+void test_async_copy()
+{
+    int channel = dma_channel_allocate(DMA_CAP_MEM_TO_MEM);
+    if (channel == DMA_ERROR_OUT_OF_CHANNELS) {
+        TEST_IGNORE_MESSAGE("no memory to memory DMA channel");
+        return;
+    }
+
+    fill(3);
+    copy_event = 0;
+    TEST_ASSERT_EQUAL(0, dma_memcpy_start(channel, dst, src, BUFFER_SIZE, on_copy, 42));
+    // one copy at a time on a channel
+    TEST_ASSERT_EQUAL(-1, dma_memcpy_start(channel, dst, src, BUFFER_SIZE, on_copy, 43));
+
+    Timer timer;
+    timer.start();
+    while (!copy_event && timer.read_us() < TIMEOUT_US);
+    TEST_ASSERT_EQUAL(DMA_MEMCPY_EVENT_COMPLETE, copy_event);
+    TEST_ASSERT_EQUAL(42, copy_id);
+    TEST_ASSERT_FALSE(dma_memcpy_active(channel));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(src, dst, BUFFER_SIZE);
+
+    dma_channel_free(channel);
+}
+
+void test_abort()
+{
+    int channel = dma_channel_allocate(DMA_CAP_MEM_TO_MEM);
+    if (channel == DMA_ERROR_OUT_OF_CHANNELS) {
+        TEST_IGNORE_MESSAGE("no memory to memory DMA channel");
+        return;
+    }
+
+    copy_event = 0;
+    TEST_ASSERT_EQUAL(0, dma_memcpy_start(channel, dst, src, BUFFER_SIZE, on_copy, 0));
+    dma_memcpy_abort(channel);
+    TEST_ASSERT_FALSE(dma_memcpy_active(channel));
+    wait_ms(1);
+    TEST_ASSERT_EQUAL(0, copy_event);
+
+    // the channel can copy again
+    TEST_ASSERT_EQUAL(0, dma_memcpy_start(channel, dst, src, 16, on_copy, 0));
+    while (dma_memcpy_active(channel));
+    dma_channel_free(channel);
+}
+
+void test_allocation()
+{
+    int channels[32];
+    int count = 0;
+
+    while (count < 32) {
+        int channel = dma_channel_allocate(DMA_CAP_MEM_TO_MEM);
+        if (channel == DMA_ERROR_OUT_OF_CHANNELS) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            TEST_ASSERT_NOT_EQUAL(channels[i], channel);
+        }
+        channels[count++] = channel;
+    }
+    TEST_ASSERT(count < 32);
+
+    // all taken, the helper still copies
+    fill(5);
+    dma_memcpy(dst, src, BUFFER_SIZE);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(src, dst, BUFFER_SIZE);
+
+    for (int i = 0; i < count; i++) {
+        dma_channel_free(channels[i]);
+    }
+    if (count) {
+        int channel = dma_channel_allocate(DMA_CAP_MEM_TO_MEM);
+        TEST_ASSERT_NOT_EQUAL(DMA_ERROR_OUT_OF_CHANNELS, channel);
+        dma_channel_free(channel);
+    }
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("dma_memcpy below the threshold", test_dma_memcpy<0, 0, 16>),
+    Case("dma_memcpy of words", test_dma_memcpy<0, 0, BUFFER_SIZE>),
+    Case("dma_memcpy of unaligned bytes", test_dma_memcpy<1, 2, BUFFER_SIZE - 1>),
+    Case("Copy with a completion handler", test_async_copy),
+    Case("Aborted copy", test_abort),
+    Case("Channel allocation", test_allocation),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,130 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "ticker_api.h"
+#include "us_ticker_api.h"
+
+using namespace utest::v1;
+
+/* Benchmarks the ticker event queue against a fake ticker whose interrupt
+ * never fires. Build once with the default configuration and once with
+ * "hal.ticker-heap-queue": true to compare the list and heap backends. */
+
+#define MAX_EVENTS 1000
+
+static timestamp_t fake_now;
+static uint32_t fired;
+static timestamp_t last_fired;
+static bool out_of_order;
+static ticker_event_t events[MAX_EVENTS];
+
+static void fake_init(void) {}
+static uint32_t fake_read(void) { return fake_now; }
+static void fake_disable_interrupt(void) {}
+static void fake_clear_interrupt(void) {}
+static void fake_set_interrupt(timestamp_t timestamp) {}
+
+static const ticker_interface_t fake_interface = {
+    fake_init,
+    fake_read,
+    fake_disable_interrupt,
+    fake_clear_interrupt,
+    fake_set_interrupt,
+};
+
+static ticker_event_queue_t fake_queue;
+
+static const ticker_data_t fake_data = {
+    &fake_interface,
+    &fake_queue,
+};
+
+static void fake_handler(uint32_t id) {
+    ticker_event_t *event = (ticker_event_t *)id;
+    if ((int)(event->timestamp - last_fired) < 0) {
+        out_of_order = true;
+    }
+    last_fired = event->timestamp;
+    fired++;
+}
+
+template <int N>
+void test_queue_benchmark() {
+    memset(events, 0, sizeof(events));
+    fake_now = 0;
+    ticker_set_handler(&fake_data, fake_handler);
+
+    // pseudo-random timestamps so the list backend sees average-case inserts
+    uint32_t seed = 0x12345678;
+    uint32_t insert_start = us_ticker_read();
+    for (int i = 0; i < N; i++) {
+        seed = seed * 1103515245 + 12345;
+        ticker_insert_event(&fake_data, &events[i], 1000 + (seed >> 16), (uint32_t)&events[i]);
+    }
+    uint32_t insert_time = us_ticker_read() - insert_start;
+
+    // remove and reinsert every other event, as Ticker rescheduling does
+    uint32_t remove_start = us_ticker_read();
+    for (int i = 0; i < N; i += 2) {
+        ticker_remove_event(&fake_data, &events[i]);
+    }
+    uint32_t remove_time = us_ticker_read() - remove_start;
+    for (int i = 0; i < N; i += 2) {
+        ticker_insert_event(&fake_data, &events[i], events[i].timestamp, (uint32_t)&events[i]);
+    }
+
+    fired = 0;
+    last_fired = 0;
+    out_of_order = false;
+    fake_now = 0xffff + 1000;
+    uint32_t dispatch_start = us_ticker_read();
+    ticker_irq_handler(&fake_data);
+    uint32_t dispatch_time = us_ticker_read() - dispatch_start;
+
+    printf("%s queue, %d events: insert %lu us, remove %lu us, dispatch %lu us\r\n",
+#if MBED_CONF_HAL_TICKER_HEAP_QUEUE
+            "heap",
+#else
+            "list",
+#endif
+            N, insert_time, remove_time, dispatch_time);
+
+    TEST_ASSERT_EQUAL_UINT32(N, fired);
+    TEST_ASSERT_FALSE(out_of_order);
+    timestamp_t next;
+    TEST_ASSERT_EQUAL(0, ticker_get_next_timestamp(&fake_data, &next));
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Ticker queue benchmark, 10 events", test_queue_benchmark<10>),
+    Case("Ticker queue benchmark, 100 events", test_queue_benchmark<100>),
+    Case("Ticker queue benchmark, 1000 events", test_queue_benchmark<MAX_EVENTS>),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,124 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "ticker_api.h"
+
+#if !MBED_CONF_HAL_TICKER_SLACK
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+/* Checks the interrupt times a fake ticker is set to, its interrupt only
+ * runs when the test calls ticker_irq_handler. */
+
+static timestamp_t fake_now;
+static timestamp_t fake_interrupt;
+static int fired;
+
+static void fake_init(void) {}
+static uint32_t fake_read(void) { return fake_now; }
+static void fake_disable_interrupt(void) {}
+static void fake_clear_interrupt(void) {}
+static void fake_set_interrupt(timestamp_t timestamp) { fake_interrupt = timestamp; }
+
+static const ticker_interface_t fake_interface = {
+    fake_init,
+    fake_read,
+    fake_disable_interrupt,
+    fake_clear_interrupt,
+    fake_set_interrupt,
+};
+
+static ticker_event_queue_t fake_queue;
+
+static const ticker_data_t fake_data = {
+    &fake_interface,
+    &fake_queue,
+};
+
+static void fake_handler(uint32_t id) {
+    fired++;
+}
+
+void test_overlapping_windows()
+{
+    ticker_event_t a, b, c;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    memset(&c, 0, sizeof(c));
+    fake_now = 0;
+    fired = 0;
+    ticker_set_handler(&fake_data, fake_handler);
+
+    ticker_insert_event_slack(&fake_data, &a, 1000, 500, (uint32_t)&a);
+    TEST_ASSERT_EQUAL_UINT32(1500, fake_interrupt);
+    // ends its window first, though it starts later
+    ticker_insert_event_slack(&fake_data, &b, 1200, 0, (uint32_t)&b);
+    TEST_ASSERT_EQUAL_UINT32(1200, fake_interrupt);
+    ticker_insert_event_slack(&fake_data, &c, 2000, 100, (uint32_t)&c);
+    TEST_ASSERT_EQUAL_UINT32(1200, fake_interrupt);
+
+    // a and b fire in one interrupt
+    fake_now = 1200;
+    ticker_irq_handler(&fake_data);
+    TEST_ASSERT_EQUAL(2, fired);
+    TEST_ASSERT_EQUAL_UINT32(2100, fake_interrupt);
+
+    fake_now = 2100;
+    ticker_irq_handler(&fake_data);
+    TEST_ASSERT_EQUAL(3, fired);
+}
+
+void test_no_slack()
+{
+    ticker_event_t a, b;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    fake_now = 0;
+    fired = 0;
+    ticker_set_handler(&fake_data, fake_handler);
+
+    ticker_insert_event(&fake_data, &a, 1000, (uint32_t)&a);
+    ticker_insert_event(&fake_data, &b, 1010, (uint32_t)&b);
+    TEST_ASSERT_EQUAL_UINT32(1000, fake_interrupt);
+
+    fake_now = 1000;
+    ticker_irq_handler(&fake_data);
+    TEST_ASSERT_EQUAL(1, fired);
+    TEST_ASSERT_EQUAL_UINT32(1010, fake_interrupt);
+    ticker_remove_event(&fake_data, &b);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Overlapping windows share an interrupt", test_overlapping_windows),
+    Case("Events without slack fire on time", test_no_slack),
+};
+
+Specification specification(test_setup, cases);
+
+int main() {
+    return !Harness::run(specification);
+}
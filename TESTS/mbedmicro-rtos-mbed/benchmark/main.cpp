@@ -0,0 +1,368 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Kernel latency benchmarks
+//
+// Each benchmark repeats an operation and prints the min, average and max
+// cycles it took. Cycles are counted with the DWT cycle counter where the
+// core has one, and derived from the us ticker otherwise, which is too
+// coarse for the shortest operations. The cases only fail when the kernel
+// does not work, the numbers are meant to be compared across targets and
+// releases.
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+#include "us_ticker_api.h"
+
+using namespace utest::v1;
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+#ifndef BENCHMARK_ROUNDS
+#define BENCHMARK_ROUNDS    1000
+#endif
+
+#define STACK_SIZE          512
+#define QUEUE_SIZE          16
+#define TIMER_PERIOD_MS     10
+#define TIMER_ROUNDS        50
+#define ISR_ROUNDS          100
+
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+static void cycles_init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t cycles_read()
+{
+    return DWT->CYCCNT;
+}
+#else
+static void cycles_init()
+{
+}
+
+static uint32_t cycles_read()
+{
+    return us_ticker_read() * (SystemCoreClock / 1000000);
+}
+#endif
+
+struct latency {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+};
+
+static void latency_reset(latency *l)
+{
+    l->min = UINT32_MAX;
+    l->max = 0;
+    l->sum = 0;
+    l->count = 0;
+}
+
+static void latency_add(latency *l, uint32_t cycles)
+{
+    if (cycles < l->min) {
+        l->min = cycles;
+    }
+    if (cycles > l->max) {
+        l->max = cycles;
+    }
+    l->sum += cycles;
+    l->count++;
+}
+
+static void latency_print(const char *name, const latency *l)
+{
+    TEST_ASSERT_TRUE_MESSAGE(l->count > 0, name);
+    printf("MBED: benchmark %-28s min %8lu avg %8lu max %8lu cycles\r\n", name,
+           (unsigned long)l->min, (unsigned long)(l->sum / l->count),
+           (unsigned long)l->max);
+}
+
+static latency result;
+
+
+// Thread switch, two threads of the same priority yielding to each other
+static volatile bool yield_started;
+static volatile uint32_t yield_start;
+static volatile uint32_t yield_end;
+
+static void yield_thread()
+{
+    if (!yield_started) {
+        yield_started = true;
+        yield_start = cycles_read();
+    }
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        Thread::yield();
+    }
+    yield_end = cycles_read();
+}
+
+void test_yield()
+{
+    Thread a(osPriorityNormal, STACK_SIZE);
+    Thread b(osPriorityNormal, STACK_SIZE);
+
+    yield_started = false;
+    a.start(yield_thread);
+    b.start(yield_thread);
+    a.join();
+    b.join();
+
+    // only the average is known, each yield switches threads
+    latency_reset(&result);
+    uint32_t per_switch = (yield_end - yield_start) / (2 * BENCHMARK_ROUNDS);
+    latency_add(&result, per_switch);
+    latency_print("thread switch (yield)", &result);
+}
+
+
+// Semaphore round trip to a higher priority thread and back
+static Semaphore ping;
+static Semaphore pong;
+
+static void pong_thread()
+{
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        ping.wait();
+        pong.release();
+    }
+}
+
+void test_semaphore()
+{
+    Thread thread(osPriorityHigh, STACK_SIZE);
+    thread.start(pong_thread);
+
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        uint32_t c = cycles_read();
+        ping.release();
+        pong.wait();
+        latency_add(&result, cycles_read() - c);
+    }
+    thread.join();
+
+    latency_print("semaphore round trip", &result);
+}
+
+
+// Mutex, uncontended and handed to a waiting higher priority thread
+static Mutex mutex;
+static Semaphore go;
+static Semaphore taken;
+static volatile uint32_t unlock_cycles;
+
+static void mutex_thread()
+{
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        go.wait();
+        mutex.lock();
+        latency_add(&result, cycles_read() - unlock_cycles);
+        mutex.unlock();
+        taken.release();
+    }
+}
+
+void test_mutex()
+{
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        uint32_t c = cycles_read();
+        mutex.lock();
+        mutex.unlock();
+        latency_add(&result, cycles_read() - c);
+    }
+    latency_print("mutex lock and unlock", &result);
+
+    Thread thread(osPriorityHigh, STACK_SIZE);
+    thread.start(mutex_thread);
+
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        mutex.lock();
+        // the thread runs and blocks on the mutex
+        go.release();
+        unlock_cycles = cycles_read();
+        mutex.unlock();
+        taken.wait();
+    }
+    thread.join();
+
+    latency_print("mutex handoff", &result);
+}
+
+
+// Wakeup of a thread by an interrupt handler
+static Semaphore isr_sem;
+static Semaphore isr_done;
+static Timeout timeout;
+static volatile uint32_t isr_cycles;
+
+static void wakeup_isr()
+{
+    isr_cycles = cycles_read();
+    isr_sem.release();
+}
+
+static void wakeup_thread()
+{
+    for (int i = 0; i < ISR_ROUNDS; i++) {
+        isr_sem.wait();
+        latency_add(&result, cycles_read() - isr_cycles);
+        isr_done.release();
+    }
+}
+
+void test_isr_wakeup()
+{
+    Thread thread(osPriorityHigh, STACK_SIZE);
+    thread.start(wakeup_thread);
+
+    latency_reset(&result);
+    for (int i = 0; i < ISR_ROUNDS; i++) {
+        timeout.attach_us(wakeup_isr, 500);
+        isr_done.wait();
+    }
+    thread.join();
+
+    latency_print("interrupt to thread wakeup", &result);
+}
+
+
+// Messages through a Queue between two threads of the same priority
+static Queue<uint32_t, QUEUE_SIZE> queue;
+static uint32_t message;
+
+static void queue_consumer()
+{
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        queue.get();
+    }
+}
+
+static void queue_consumer_n()
+{
+    uint32_t *batch[QUEUE_SIZE];
+    int n = 0;
+    while (n < BENCHMARK_ROUNDS) {
+        n += queue.get_n(batch, QUEUE_SIZE);
+    }
+}
+
+void test_queue()
+{
+    for (int pass = 0; pass < 2; pass++) {
+        Thread thread(osPriorityNormal, STACK_SIZE);
+        thread.start(pass == 0 ? queue_consumer : queue_consumer_n);
+
+        uint32_t c = cycles_read();
+        if (pass == 0) {
+            for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+                queue.put(&message, osWaitForever);
+            }
+        } else {
+            uint32_t *batch[QUEUE_SIZE];
+            for (int i = 0; i < QUEUE_SIZE; i++) {
+                batch[i] = &message;
+            }
+            int n = 0;
+            while (n < BENCHMARK_ROUNDS) {
+                int count = BENCHMARK_ROUNDS - n < QUEUE_SIZE ? BENCHMARK_ROUNDS - n : QUEUE_SIZE;
+                n += queue.put_n(batch, count, osWaitForever);
+            }
+        }
+        thread.join();
+
+        latency_reset(&result);
+        latency_add(&result, (cycles_read() - c) / BENCHMARK_ROUNDS);
+        latency_print(pass == 0 ? "queue message (put/get)" : "queue message (put_n/get_n)", &result);
+    }
+}
+
+
+// Period of a periodic RtosTimer
+static volatile uint32_t timer_last;
+static volatile int timer_count;
+static Semaphore timer_done;
+
+static void timer_tick()
+{
+    uint32_t c = cycles_read();
+    if (timer_count > 0) {
+        latency_add(&result, c - timer_last);
+    }
+    timer_last = c;
+    if (++timer_count == TIMER_ROUNDS + 1) {
+        timer_done.release();
+    }
+}
+
+void test_timer()
+{
+    RtosTimer timer(callback(timer_tick), osTimerPeriodic);
+
+    latency_reset(&result);
+    timer_count = 0;
+    timer.start(TIMER_PERIOD_MS);
+    timer_done.wait();
+    timer.stop();
+
+    latency_print("timer period (10ms)", &result);
+    int32_t period = SystemCoreClock / 1000 * TIMER_PERIOD_MS;
+    int32_t late = (int32_t)result.max - period;
+    int32_t early = period - (int32_t)result.min;
+    uint32_t jitter = late > early ? late : early;
+    printf("MBED: benchmark %-28s %8lu cycles\r\n", "timer jitter", (unsigned long)jitter);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(120, "default_auto");
+    cycles_init();
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Thread switch", test_yield),
+    Case("Semaphore", test_semaphore),
+    Case("Mutex", test_mutex),
+    Case("Interrupt wakeup", test_isr_wakeup),
+    Case("Queue", test_queue),
+    Case("Timer", test_timer),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
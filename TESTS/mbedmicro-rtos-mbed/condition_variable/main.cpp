@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define STACK_SIZE      512
+#define ITEMS           100
+#define QUEUE_SIZE      4
+
+static Mutex mutex;
+static ConditionVariable not_empty(mutex);
+static ConditionVariable not_full(mutex);
+static int queue[QUEUE_SIZE];
+static int count;
+static int head;
+static int woken;
+static bool in_order;
+
+static void consumer()
+{
+    for (int i = 0; i < ITEMS; i++) {
+        mutex.lock();
+        while (count == 0) {
+            not_empty.wait();
+        }
+        if (queue[head] != i) {
+            in_order = false;
+        }
+        head = (head + 1) % QUEUE_SIZE;
+        count--;
+        not_full.notify_one();
+        mutex.unlock();
+    }
+}
+
+static void waiter()
+{
+    mutex.lock();
+    not_empty.wait();
+    woken++;
+    mutex.unlock();
+}
+
+void test_producer_consumer()
+{
+    count = 0;
+    head = 0;
+    in_order = true;
+    Thread thread(osPriorityNormal, STACK_SIZE);
+    thread.start(consumer);
+
+    for (int i = 0; i < ITEMS; i++) {
+        mutex.lock();
+        while (count == QUEUE_SIZE) {
+            not_full.wait();
+        }
+        queue[(head + count) % QUEUE_SIZE] = i;
+        count++;
+        not_empty.notify_one();
+        mutex.unlock();
+    }
+
+    thread.join();
+    TEST_ASSERT_TRUE(in_order);
+    TEST_ASSERT_EQUAL(0, count);
+}
+
+void test_notify()
+{
+    woken = 0;
+    Thread thread1(osPriorityNormal, STACK_SIZE);
+    Thread thread2(osPriorityNormal, STACK_SIZE);
+    thread1.start(waiter);
+    thread2.start(waiter);
+    Thread::wait(10);
+
+    mutex.lock();
+    not_empty.notify_one();
+    mutex.unlock();
+    Thread::wait(10);
+    TEST_ASSERT_EQUAL(1, woken);
+
+    mutex.lock();
+    not_empty.notify_all();
+    mutex.unlock();
+    thread1.join();
+    thread2.join();
+    TEST_ASSERT_EQUAL(2, woken);
+}
+
+void test_timeout()
+{
+    Timer timer;
+    mutex.lock();
+    timer.start();
+    TEST_ASSERT_TRUE(not_empty.wait_for(50));
+    TEST_ASSERT_UINT32_WITHIN(5000, 50000, timer.read_us());
+    mutex.unlock();
+
+    // nothing left to notify
+    mutex.lock();
+    not_empty.notify_all();
+    mutex.unlock();
+    TEST_ASSERT_EQUAL_INT32(osOK, Thread::signal_wait(0, 0).status);
+}
+
+Case cases[] = {
+    Case("Producer and consumer", test_producer_consumer),
+    Case("Notify one and all", test_notify),
+    Case("Wait timeout", test_timeout),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases);
+
+int main()
+{
+    Harness::run(specification);
+}
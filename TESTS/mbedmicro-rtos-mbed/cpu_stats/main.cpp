@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "rtos.h"
+#include "mbed_stats.h"
+
+#if !defined(MBED_THREAD_CPU_STATS_ENABLED) || !MBED_THREAD_CPU_STATS_ENABLED
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define MAX_THREADS     16
+#define BUSY_MS         200
+
+static volatile bool busy_done;
+static mbed_stats_cpu_t busy_end;
+static mbed_stats_thread_cpu_t busy_stats;
+static bool busy_found;
+
+static bool find_thread(osThreadId id, mbed_stats_thread_cpu_t *stats)
+{
+    mbed_stats_thread_cpu_t threads[MAX_THREADS];
+    size_t count = mbed_stats_thread_cpu_get(threads, MAX_THREADS);
+
+    for (size_t i = 0; i < count; i++) {
+        if (threads[i].id == (uint32_t)(uintptr_t)id) {
+            *stats = threads[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static void busy_thread()
+{
+    Timer timer;
+    timer.start();
+    while (timer.read_ms() < BUSY_MS) {
+    }
+
+    // the stats of a thread go away with it
+    mbed_stats_cpu_get(&busy_end);
+    busy_found = find_thread(Thread::gettid(), &busy_stats);
+    busy_done = true;
+}
+
+static void ticking_thread()
+{
+    while (!busy_done) {
+        Thread::wait(5);
+    }
+}
+
+void test_idle_time()
+{
+    mbed_stats_cpu_t start, end;
+
+    mbed_stats_cpu_get(&start);
+    Thread::wait(100);
+    mbed_stats_cpu_get(&end);
+
+    uint64_t total = end.total_time - start.total_time;
+    uint64_t idle = end.idle_time - start.idle_time;
+    TEST_ASSERT_TRUE(end.clock > 0);
+    TEST_ASSERT_TRUE(total >= (uint64_t)end.clock / 20);
+    TEST_ASSERT_TRUE(idle * 10 >= total * 9);
+    TEST_ASSERT_TRUE(end.switches > start.switches);
+}
+
+void test_busy_thread()
+{
+    mbed_stats_cpu_t start;
+    Thread thread(osPriorityNormal);
+    Thread ticker(osPriorityAboveNormal);
+
+    busy_done = false;
+    mbed_stats_cpu_get(&start);
+    thread.start(busy_thread);
+    ticker.start(ticking_thread);
+    while (!busy_done) {
+        Thread::wait(10);
+    }
+    thread.join();
+    ticker.join();
+
+    // The busy thread took most of the time and was preempted by the ticker
+    TEST_ASSERT_TRUE(busy_found);
+    uint64_t total = busy_end.total_time - start.total_time;
+    TEST_ASSERT_TRUE(busy_stats.cpu_time * 10 >= total * 7);
+    TEST_ASSERT_TRUE(busy_stats.switches > 1);
+    TEST_ASSERT_TRUE(busy_stats.preemptions > 0);
+}
+
+Case cases[] = {
+    Case("Idle time", test_idle_time),
+    Case("Busy thread", test_busy_thread),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases);
+
+int main()
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define STACK_SIZE      512
+#define FLAG_A          0x01
+#define FLAG_B          0x02
+#define FLAG_C          0x04
+
+static EventFlags flags;
+static volatile uint32_t woken;
+
+static void wait_any_a_b()
+{
+    woken = flags.wait_any(FLAG_A | FLAG_B);
+}
+
+static void wait_all_a_b()
+{
+    woken = flags.wait_all(FLAG_A | FLAG_B);
+}
+
+static Timeout timeout;
+
+static void set_c_isr()
+{
+    flags.set(FLAG_C);
+}
+
+void test_no_wait()
+{
+    flags.clear();
+    TEST_ASSERT_EQUAL_UINT32(0, flags.wait_any(FLAG_A, 0));
+
+    flags.set(FLAG_A | FLAG_B);
+    TEST_ASSERT_EQUAL_UINT32(FLAG_A | FLAG_B, flags.wait_all(FLAG_A, 0, false));
+    TEST_ASSERT_EQUAL_UINT32(FLAG_A | FLAG_B, flags.get());
+
+    // clears only the flags waited for
+    TEST_ASSERT_EQUAL_UINT32(FLAG_A | FLAG_B, flags.wait_any(FLAG_A | FLAG_C, 0));
+    TEST_ASSERT_EQUAL_UINT32(FLAG_B, flags.get());
+
+    TEST_ASSERT_EQUAL_UINT32(FLAG_B, flags.clear());
+    TEST_ASSERT_EQUAL_UINT32(0, flags.get());
+}
+
+void test_wait_any()
+{
+    flags.clear();
+    woken = 0;
+    Thread thread(osPriorityNormal, STACK_SIZE);
+    thread.start(wait_any_a_b);
+    Thread::wait(10);
+
+    flags.set(FLAG_C);
+    Thread::wait(10);
+    TEST_ASSERT_EQUAL_UINT32(0, woken);
+
+    flags.set(FLAG_B);
+    thread.join();
+    TEST_ASSERT_EQUAL_UINT32(FLAG_B | FLAG_C, woken);
+    TEST_ASSERT_EQUAL_UINT32(FLAG_C, flags.get());
+}
+
+void test_wait_all()
+{
+    flags.clear();
+    woken = 0;
+    Thread thread(osPriorityNormal, STACK_SIZE);
+    thread.start(wait_all_a_b);
+    Thread::wait(10);
+
+    flags.set(FLAG_A);
+    Thread::wait(10);
+    TEST_ASSERT_EQUAL_UINT32(0, woken);
+
+    flags.set(FLAG_B);
+    thread.join();
+    TEST_ASSERT_EQUAL_UINT32(FLAG_A | FLAG_B, woken);
+    TEST_ASSERT_EQUAL_UINT32(0, flags.get());
+}
+
+void test_several_waiters()
+{
+    flags.clear();
+    Thread thread1(osPriorityNormal, STACK_SIZE);
+    Thread thread2(osPriorityNormal, STACK_SIZE);
+    thread1.start(wait_all_a_b);
+    thread2.start(wait_all_a_b);
+    Thread::wait(10);
+
+    // the first waiter consumes the flags, the second keeps waiting
+    flags.set(FLAG_A | FLAG_B);
+    thread1.join();
+    Thread::wait(10);
+    TEST_ASSERT_EQUAL(Thread::WaitingAnd, thread2.get_state());
+
+    flags.set(FLAG_A | FLAG_B);
+    thread2.join();
+}
+
+void test_timeout()
+{
+    flags.clear();
+    Timer timer;
+    timer.start();
+    TEST_ASSERT_EQUAL_UINT32(0, flags.wait_all(FLAG_A, 50));
+    TEST_ASSERT_UINT32_WITHIN(5000, 50000, timer.read_us());
+
+    // no stale signal left by the timed out wait
+    TEST_ASSERT_EQUAL_INT32(osOK, Thread::signal_wait(0, 0).status);
+}
+
+void test_set_from_isr()
+{
+    flags.clear();
+    timeout.attach_us(set_c_isr, 10000);
+    TEST_ASSERT_EQUAL_UINT32(FLAG_C, flags.wait_any(FLAG_C, 100));
+}
+
+Case cases[] = {
+    Case("Wait without blocking", test_no_wait),
+    Case("Wait for any flag", test_wait_any),
+    Case("Wait for all flags", test_wait_all),
+    Case("Several waiters", test_several_waiters),
+    Case("Wait timeout", test_timeout),
+    Case("Set from interrupt", test_set_from_isr),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases);
+
+int main()
+{
+    Harness::run(specification);
+}
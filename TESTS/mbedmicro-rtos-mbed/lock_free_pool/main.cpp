@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "rtos.h"
+#include "LockFreeMemoryPool.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define POOL_SIZE       8
+#define STACK_SIZE      512
+#define ROUNDS          1000
+
+struct packet_t {
+    uint32_t seq;
+    uint8_t data[20];
+};
+
+static LockFreeMemoryPool<packet_t, POOL_SIZE> pool;
+static volatile bool corrupted;
+
+// Allocates and frees with the pool shared by the main thread and a ticker
+static void churn()
+{
+    packet_t *p = pool.alloc();
+    if (p == NULL) {
+        return;
+    }
+    p->seq = (uint32_t)p;
+    for (int i = 0; i < 100; i++) {
+        __NOP();
+    }
+    if (p->seq != (uint32_t)p) {
+        corrupted = true;
+    }
+    pool.free(p);
+}
+
+static void churn_thread()
+{
+    for (int i = 0; i < ROUNDS; i++) {
+        churn();
+    }
+}
+
+void test_alloc_free()
+{
+    packet_t *blocks[POOL_SIZE];
+
+    for (int i = 0; i < POOL_SIZE; i++) {
+        blocks[i] = pool.calloc();
+        TEST_ASSERT_NOT_NULL(blocks[i]);
+        TEST_ASSERT_EQUAL_UINT32(0, blocks[i]->seq);
+        TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t)blocks[i] % 8);
+        memset(blocks[i], 0xA5, sizeof(packet_t));
+    }
+    TEST_ASSERT_NULL(pool.alloc());
+    TEST_ASSERT_EQUAL_UINT32(POOL_SIZE, pool.in_use());
+    TEST_ASSERT_EQUAL_UINT32(POOL_SIZE, pool.peak());
+    TEST_ASSERT_EQUAL_UINT32(1, pool.failures());
+
+    int local;
+    TEST_ASSERT_FALSE(pool.free((packet_t*)&local));
+    TEST_ASSERT_FALSE(pool.free((packet_t*)((uint8_t*)blocks[0] + 4)));
+
+    for (int i = 0; i < POOL_SIZE; i++) {
+        TEST_ASSERT_TRUE(pool.free(blocks[i]));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, pool.in_use());
+    TEST_ASSERT_EQUAL_UINT32(POOL_SIZE, pool.peak());
+}
+
+void test_isr_and_threads()
+{
+    Ticker ticker;
+    Thread thread(osPriorityNormal, STACK_SIZE);
+    corrupted = false;
+
+    ticker.attach_us(churn, 100);
+    thread.start(churn_thread);
+    for (int i = 0; i < ROUNDS; i++) {
+        churn();
+    }
+    thread.join();
+    ticker.detach();
+
+    TEST_ASSERT_FALSE(corrupted);
+    TEST_ASSERT_EQUAL_UINT32(0, pool.in_use());
+}
+
+Case cases[] = {
+    Case("Alloc and free", test_alloc_free),
+    Case("Interrupts and threads", test_isr_and_threads),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases);
+
+int main()
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "rtos.h"
+#include "mbed_stats.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+#if !defined(MBED_MUTEX_STATS_ENABLED) || !MBED_MUTEX_STATS_ENABLED
+  #error [NOT_SUPPORTED] mutex stats not enabled
+#endif
+
+using namespace utest::v1;
+
+#define MAX_MUTEXES     32
+#define STACK_SIZE      512
+#define HOLD_MS         50
+
+static Mutex mutex;
+
+static bool find_stats(Mutex *m, mbed_stats_mutex_t *found)
+{
+    mbed_stats_mutex_t stats[MAX_MUTEXES];
+    size_t count = mbed_stats_mutex_get(stats, MAX_MUTEXES);
+
+    for (size_t i = 0; i < count; i++) {
+        if (stats[i].id == (uint32_t)m) {
+            *found = stats[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static void locking_thread()
+{
+    mutex.lock();
+    mutex.unlock();
+}
+
+void test_uncontended()
+{
+    Mutex local;
+    mbed_stats_mutex_t stats;
+
+    TEST_ASSERT_TRUE(find_stats(&local, &stats));
+    TEST_ASSERT_EQUAL_UINT32(0, stats.acquire_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.holder);
+
+    // recursive locks keep the holder until the last unlock
+    local.lock();
+    local.lock();
+    local.unlock();
+    TEST_ASSERT_TRUE(find_stats(&local, &stats));
+    TEST_ASSERT_EQUAL_UINT32((uint32_t)Thread::gettid(), stats.holder);
+    local.unlock();
+
+    TEST_ASSERT_TRUE(find_stats(&local, &stats));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.acquire_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.contended_cnt);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.holder);
+}
+
+void test_contended()
+{
+    mbed_stats_mutex_t before, after;
+    TEST_ASSERT_TRUE(find_stats(&mutex, &before));
+
+    mutex.lock();
+    Thread thread(osPriorityNormal, STACK_SIZE);
+    thread.start(locking_thread);
+    Thread::wait(HOLD_MS);
+    mutex.unlock();
+    thread.join();
+
+    TEST_ASSERT_TRUE(find_stats(&mutex, &after));
+    TEST_ASSERT_EQUAL_UINT32(before.acquire_cnt + 2, after.acquire_cnt);
+    TEST_ASSERT_EQUAL_UINT32(before.contended_cnt + 1, after.contended_cnt);
+    TEST_ASSERT_TRUE(after.max_wait >= (HOLD_MS - 5) * 1000);
+    TEST_ASSERT_TRUE(after.total_wait >= after.max_wait);
+}
+
+void test_destroyed()
+{
+    mbed_stats_mutex_t stats;
+    Mutex *m = new Mutex;
+    TEST_ASSERT_TRUE(find_stats(m, &stats));
+    delete m;
+    TEST_ASSERT_FALSE(find_stats(m, &stats));
+}
+
+Case cases[] = {
+    Case("Uncontended locks", test_uncontended),
+    Case("Contended lock", test_contended),
+    Case("Destroyed mutex", test_destroyed),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases);
+
+int main()
+{
+    Harness::run(specification);
+}
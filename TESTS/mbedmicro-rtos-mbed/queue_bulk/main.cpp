@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define QUEUE_SIZE      8
+#define STACK_SIZE      512
+#define ITEMS           200
+#define BATCH           5
+
+static uint32_t values[ITEMS];
+static Queue<uint32_t, QUEUE_SIZE> queue;
+
+struct sample_t {
+    uint32_t seq;
+};
+static Mail<sample_t, QUEUE_SIZE> mail;
+
+static void queue_producer()
+{
+    uint32_t *batch[BATCH];
+    for (int i = 0; i < ITEMS; i += BATCH) {
+        for (int j = 0; j < BATCH; j++) {
+            batch[j] = &values[i + j];
+        }
+        uint32_t n = 0;
+        while (n < BATCH) {
+            n += queue.put_n(batch + n, BATCH - n, osWaitForever);
+        }
+    }
+}
+
+void test_queue_no_wait()
+{
+    uint32_t *in[QUEUE_SIZE + 2];
+    uint32_t *out[QUEUE_SIZE + 2];
+    for (int i = 0; i < QUEUE_SIZE + 2; i++) {
+        in[i] = &values[i];
+    }
+
+    // only as many as fit
+    TEST_ASSERT_EQUAL_UINT32(QUEUE_SIZE, queue.put_n(in, QUEUE_SIZE + 2));
+    TEST_ASSERT_EQUAL_UINT32(0, queue.put_n(in, 1));
+
+    TEST_ASSERT_EQUAL_UINT32(3, queue.get_n(out, 3, 0));
+    TEST_ASSERT_EQUAL_UINT32(QUEUE_SIZE - 3, queue.get_n(out + 3, QUEUE_SIZE + 2, 0));
+    for (int i = 0; i < QUEUE_SIZE; i++) {
+        TEST_ASSERT_EQUAL_PTR(in[i], out[i]);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, queue.get_n(out, 1, 0));
+}
+
+void test_queue_pipeline()
+{
+    for (int i = 0; i < ITEMS; i++) {
+        values[i] = i;
+    }
+
+    Thread thread(osPriorityNormal, STACK_SIZE);
+    thread.start(queue_producer);
+
+    uint32_t *out[QUEUE_SIZE];
+    int got = 0;
+    bool in_order = true;
+    while (got < ITEMS) {
+        uint32_t n = queue.get_n(out, QUEUE_SIZE, 1000);
+        TEST_ASSERT_TRUE(n > 0);
+        for (uint32_t i = 0; i < n; i++) {
+            if (*out[i] != (uint32_t)got) {
+                in_order = false;
+            }
+            got++;
+        }
+    }
+    thread.join();
+
+    TEST_ASSERT_TRUE(in_order);
+}
+
+void test_queue_timeout()
+{
+    uint32_t *out[1];
+    Timer timer;
+    timer.start();
+    TEST_ASSERT_EQUAL_UINT32(0, queue.get_n(out, 1, 50));
+    TEST_ASSERT_UINT32_WITHIN(5000, 50000, timer.read_us());
+}
+
+void test_mail()
+{
+    sample_t *in[QUEUE_SIZE];
+    sample_t *out[QUEUE_SIZE];
+
+    for (int i = 0; i < QUEUE_SIZE; i++) {
+        in[i] = mail.alloc();
+        TEST_ASSERT_NOT_NULL(in[i]);
+        in[i]->seq = i;
+    }
+    TEST_ASSERT_EQUAL_UINT32(QUEUE_SIZE, mail.put_n(in, QUEUE_SIZE));
+
+    TEST_ASSERT_EQUAL_UINT32(QUEUE_SIZE, mail.get_n(out, QUEUE_SIZE, 0));
+    for (int i = 0; i < QUEUE_SIZE; i++) {
+        // the blocks are passed, not copied
+        TEST_ASSERT_EQUAL_PTR(in[i], out[i]);
+        TEST_ASSERT_EQUAL_UINT32(i, out[i]->seq);
+        TEST_ASSERT_EQUAL(osOK, mail.free(out[i]));
+    }
+}
+
+Case cases[] = {
+    Case("Queue batches without waiting", test_queue_no_wait),
+    Case("Queue pipeline", test_queue_pipeline),
+    Case("Queue get timeout", test_queue_timeout),
+    Case("Mail batches", test_mail),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases);
+
+int main()
+{
+    Harness::run(specification);
+}
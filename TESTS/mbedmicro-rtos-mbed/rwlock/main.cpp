@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define STACK_SIZE      512
+
+static RWLock lock(2);
+static volatile int reading;
+static volatile int max_reading;
+static volatile int order[3];
+static volatile int orders;
+
+static void reader()
+{
+    lock.read_lock();
+    reading++;
+    if (reading > max_reading) {
+        max_reading = reading;
+    }
+    Thread::wait(20);
+    reading--;
+    lock.read_unlock();
+}
+
+static void ordered_reader()
+{
+    lock.read_lock();
+    order[orders++] = 0;
+    lock.read_unlock();
+}
+
+static void ordered_writer()
+{
+    lock.write_lock();
+    order[orders++] = 1;
+    lock.write_unlock();
+}
+
+void test_readers_share()
+{
+    max_reading = 0;
+    Thread thread1(osPriorityNormal, STACK_SIZE);
+    Thread thread2(osPriorityNormal, STACK_SIZE);
+    thread1.start(reader);
+    thread2.start(reader);
+    thread1.join();
+    thread2.join();
+    TEST_ASSERT_EQUAL(2, max_reading);
+}
+
+void test_readers_bounded()
+{
+    max_reading = 0;
+    Thread thread1(osPriorityNormal, STACK_SIZE);
+    Thread thread2(osPriorityNormal, STACK_SIZE);
+    Thread thread3(osPriorityNormal, STACK_SIZE);
+    thread1.start(reader);
+    thread2.start(reader);
+    thread3.start(reader);
+    thread1.join();
+    thread2.join();
+    thread3.join();
+    TEST_ASSERT_EQUAL(2, max_reading);
+}
+
+void test_writer_excludes()
+{
+    TEST_ASSERT_EQUAL(osOK, lock.write_lock());
+
+    Thread thread(osPriorityNormal, STACK_SIZE);
+    thread.start(reader);
+    Thread::wait(10);
+    TEST_ASSERT_EQUAL(0, reading);
+    lock.write_unlock();
+    thread.join();
+
+    TEST_ASSERT_EQUAL(osOK, lock.read_lock());
+    TEST_ASSERT_EQUAL(osErrorTimeoutResource, lock.write_lock(0));
+    lock.read_unlock();
+}
+
+void test_writer_preferred()
+{
+    orders = 0;
+    TEST_ASSERT_EQUAL(osOK, lock.read_lock());
+
+    // The writer waits for this reader, the reader after it waits for the writer
+    Thread writer(osPriorityNormal, STACK_SIZE);
+    Thread reader(osPriorityNormal, STACK_SIZE);
+    writer.start(ordered_writer);
+    Thread::wait(10);
+    reader.start(ordered_reader);
+    Thread::wait(10);
+    TEST_ASSERT_EQUAL(0, orders);
+
+    lock.read_unlock();
+    writer.join();
+    reader.join();
+    TEST_ASSERT_EQUAL(2, orders);
+    TEST_ASSERT_EQUAL(1, order[0]);
+    TEST_ASSERT_EQUAL(0, order[1]);
+}
+
+void test_timeout()
+{
+    Timer timer;
+    TEST_ASSERT_EQUAL(osOK, lock.read_lock());
+    timer.start();
+    TEST_ASSERT_EQUAL(osErrorTimeoutResource, lock.write_lock(50));
+    TEST_ASSERT_UINT32_WITHIN(5000, 50000, timer.read_us());
+
+    // The writer that gave up no longer holds readers back
+    TEST_ASSERT_EQUAL(osOK, lock.read_lock(0));
+    lock.read_unlock();
+    lock.read_unlock();
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Readers share the lock", test_readers_share),
+    Case("Readers are bounded", test_readers_bounded),
+    Case("A writer excludes readers", test_writer_excludes),
+    Case("A waiting writer goes before new readers", test_writer_preferred),
+    Case("Timed out lock", test_timeout),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
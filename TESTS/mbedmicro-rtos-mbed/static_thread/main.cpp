@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "rtos.h"
+#include "mbed_stats.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define STACK_SIZE      508
+
+static StaticThread<STACK_SIZE> thread(osPriorityBelowNormal);
+static volatile uintptr_t local_address;
+
+static void record_stack()
+{
+    int local;
+    local_address = (uintptr_t)&local;
+}
+
+void test_stack_in_object()
+{
+    uintptr_t start = (uintptr_t)&thread;
+
+    TEST_ASSERT_TRUE(sizeof(thread) >= sizeof(Thread) + STACK_SIZE);
+
+#if defined(MBED_HEAP_STATS_ENABLED) && MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t before, after;
+    mbed_stats_heap_get(&before);
+#endif
+
+    TEST_ASSERT_EQUAL(osOK, thread.start(record_stack));
+    thread.join();
+
+#if defined(MBED_HEAP_STATS_ENABLED) && MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_get(&after);
+    TEST_ASSERT_EQUAL_UINT32(before.total_size, after.total_size);
+#endif
+
+    TEST_ASSERT_TRUE(local_address > start);
+    TEST_ASSERT_TRUE(local_address < start + sizeof(thread));
+}
+
+static void wait_signal()
+{
+    Thread::signal_wait(0x1);
+}
+
+void test_stack_size()
+{
+    StaticThread<STACK_SIZE> waiting;
+    waiting.start(wait_signal);
+
+    // rounded up to 8 bytes
+    TEST_ASSERT_EQUAL_UINT32(512, waiting.stack_size());
+
+    waiting.signal_set(0x1);
+    waiting.join();
+}
+
+Case cases[] = {
+    Case("Stack in the object", test_stack_in_object),
+    Case("Stack size", test_stack_size),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases);
+
+int main()
+{
+    Harness::run(specification);
+}
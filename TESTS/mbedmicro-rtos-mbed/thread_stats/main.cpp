@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "rtos.h"
+#include "mbed_stats.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+using namespace utest::v1;
+
+#define MAX_THREADS     16
+#define STACK_SIZE      1024
+#define STACK_USED      256
+
+static void waiting_thread()
+{
+    // touch part of the stack for the high-water mark
+    volatile uint8_t buf[STACK_USED];
+    for (size_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = i;
+    }
+
+    Thread::signal_wait(0x1);
+}
+
+void test_thread_get()
+{
+    mbed_stats_thread_t stats[MAX_THREADS];
+    Thread thread(osPriorityBelowNormal, STACK_SIZE);
+    thread.start(waiting_thread);
+    Thread::wait(10);
+
+    size_t count = mbed_stats_thread_get(stats, MAX_THREADS);
+    // main, the idle thread and the test thread at least
+    TEST_ASSERT_TRUE(count >= 3);
+
+    mbed_stats_thread_t *found = NULL;
+    for (size_t i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(stats[i].stack_size > 0);
+        if (stats[i].arg == (uint32_t)(uintptr_t)&thread) {
+            found = &stats[i];
+        }
+    }
+
+    TEST_ASSERT_NOT_NULL(found);
+    TEST_ASSERT_EQUAL_UINT32(STACK_SIZE, found->stack_size);
+    TEST_ASSERT_EQUAL_INT32(osPriorityBelowNormal, found->priority);
+    TEST_ASSERT_EQUAL_UINT32(Thread::WaitingAnd, found->state);
+#if defined(MBED_STACK_STATS_ENABLED) && MBED_STACK_STATS_ENABLED
+    TEST_ASSERT_TRUE(found->max_stack >= STACK_USED);
+    TEST_ASSERT_TRUE(found->max_stack < STACK_SIZE);
+#endif
+
+    thread.signal_set(0x1);
+    thread.join();
+}
+
+void test_stack_get()
+{
+    mbed_stats_stack_t before, during;
+    mbed_stats_stack_get(&before);
+
+    Thread thread(osPriorityBelowNormal, STACK_SIZE);
+    thread.start(waiting_thread);
+    Thread::wait(10);
+    mbed_stats_stack_get(&during);
+
+    TEST_ASSERT_EQUAL_UINT32(before.stack_cnt + 1, during.stack_cnt);
+    TEST_ASSERT_EQUAL_UINT32(before.reserved_size + STACK_SIZE, during.reserved_size);
+    TEST_ASSERT_TRUE(during.max_size >= before.max_size);
+
+    thread.signal_set(0x1);
+    thread.join();
+}
+
+Case cases[] = {
+    Case("Thread stats", test_thread_get),
+    Case("Stack stats", test_stack_get),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases);
+
+int main()
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,49 @@
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "rtos.h"
+
+#if defined(MBED_RTOS_SINGLE_THREAD)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+#if !MBED_CONF_RTOS_TICKLESS || !DEVICE_LOWPOWERTIMER || !DEVICE_SLEEP
+  #error [NOT_SUPPORTED] tickless idle not enabled
+#endif
+
+/* Same ticks as the basic test, but the main thread waits for each tick
+ * with nothing else to run, so the kernel tick stops in between and the
+ * host measures the time the kernel counts across the wakeups. */
+
+const int total_ticks = 10;
+
+// Largest difference between kernel time and the low power timer, in ms
+const int max_drift_ms = 2;
+
+int main() {
+    GREENTEA_SETUP(total_ticks + 5, "timing_drift_auto");
+
+    LowPowerTimer timer;
+    bool result = true;
+    uint64_t kernel_us = 0;
+    uint32_t last = osKernelSysTick();
+
+    timer.start();
+    for (int i = 0; i <= total_ticks; i++) {
+        // split the second so that the sleeps don't end on a tick
+        Thread::wait(333);
+        Thread::wait(667);
+        greentea_send_kv("tick", i);
+
+        uint32_t now = osKernelSysTick();
+        kernel_us += (uint64_t)(now - last) * 1000000 / osKernelSysTickFrequency;
+        last = now;
+
+        int drift_ms = timer.read_ms() - (int)(kernel_us / 1000);
+        if (drift_ms > max_drift_ms || drift_ms < -max_drift_ms) {
+            printf("drift of %d ms after %d ms\r\n", drift_ms, timer.read_ms());
+            result = false;
+        }
+    }
+
+    GREENTEA_TESTSUITE_RESULT(result);
+}
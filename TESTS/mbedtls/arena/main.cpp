@@ -0,0 +1,190 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if !defined(MBEDTLS_MEMORY_ARENA)
+    #error [NOT_SUPPORTED] Requires the mbedtls.arena option
+#endif
+
+#include "mbedtls/platform.h"
+#include "mbedtls/bignum.h"
+#include "platform/inc/mbed_arena.h"
+
+using namespace utest::v1;
+
+#define ARENA_SIZE      4096
+#define ARENA_THREADS   2
+#define ARENA_BLOCKS    16
+
+static uint32_t arena_buf[ARENA_THREADS][ARENA_SIZE / 4];
+static mbedtls_arena arenas[ARENA_THREADS];
+static void *arena_blocks[ARENA_THREADS][ARENA_BLOCKS];
+
+static bool in_arena(int i, void *ptr)
+{
+    unsigned char *buf = (unsigned char *)arena_buf[i];
+    return (unsigned char *)ptr >= buf && (unsigned char *)ptr < buf + ARENA_SIZE;
+}
+
+void test_arena_heap()
+{
+    mbedtls_arena arena;
+    TEST_ASSERT_EQUAL(0, mbedtls_arena_init(&arena, arena_buf[0], ARENA_SIZE));
+
+    // Outside of an arena blocks come from the heap
+    void *ptr = mbedtls_calloc(1, 64);
+    TEST_ASSERT_NOT_NULL(ptr);
+    TEST_ASSERT_FALSE(in_arena(0, ptr));
+    mbedtls_free(ptr);
+
+    mbedtls_arena_enter(&arena);
+    ptr = mbedtls_calloc(1, 64);
+    TEST_ASSERT_NULL(mbedtls_calloc(1, ARENA_SIZE));
+    mbedtls_arena_leave(&arena);
+
+    TEST_ASSERT_TRUE(in_arena(0, ptr));
+    TEST_ASSERT_EQUAL(1, mbedtls_arena_blocks(&arena));
+    TEST_ASSERT_TRUE(mbedtls_arena_peak(&arena) >= 64);
+
+    // The block goes back to the arena from outside of it
+    mbedtls_free(ptr);
+    TEST_ASSERT_EQUAL(0, mbedtls_arena_blocks(&arena));
+    TEST_ASSERT_EQUAL(0, mbedtls_arena_free(&arena));
+}
+
+void test_arena_free_live()
+{
+    mbedtls_arena arena;
+    TEST_ASSERT_EQUAL(0, mbedtls_arena_init(&arena, arena_buf[0], ARENA_SIZE));
+
+    mbedtls_arena_enter(&arena);
+    unsigned char *ptr = (unsigned char *)mbedtls_calloc(1, 64);
+    mbedtls_arena_leave(&arena);
+    TEST_ASSERT_TRUE(in_arena(0, ptr));
+
+    // The arena is kept while a block is allocated, and the block stays usable
+    TEST_ASSERT_EQUAL(-1, mbedtls_arena_free(&arena));
+    memset(ptr, 0xa5, 64);
+    TEST_ASSERT_EQUAL(1, mbedtls_arena_blocks(&arena));
+
+    mbedtls_free(ptr);
+    TEST_ASSERT_EQUAL(0, mbedtls_arena_blocks(&arena));
+    TEST_ASSERT_EQUAL(0, mbedtls_arena_free(&arena));
+
+    // Once released, the arena no longer claims blocks from its buffer
+    ptr = (unsigned char *)mbedtls_calloc(1, 64);
+    TEST_ASSERT_NOT_NULL(ptr);
+    TEST_ASSERT_FALSE(in_arena(0, ptr));
+    mbedtls_free(ptr);
+}
+
+// Bignum operations of several threads allocate from their own arenas
+static void arena_thread(mbedtls_arena *arena)
+{
+    int i = arena - arenas;
+    mbedtls_arena_enter(arena);
+
+    mbedtls_mpi a, b, c;
+    mbedtls_mpi_init(&a);
+    mbedtls_mpi_init(&b);
+    mbedtls_mpi_init(&c);
+    for (int j = 0; j < 32; j++) {
+        TEST_ASSERT_EQUAL(0, mbedtls_mpi_lset(&a, j + 1));
+        TEST_ASSERT_EQUAL(0, mbedtls_mpi_shift_l(&a, 32 * (j % 8)));
+        TEST_ASSERT_EQUAL(0, mbedtls_mpi_mul_mpi(&b, &a, &a));
+        TEST_ASSERT_EQUAL(0, mbedtls_mpi_add_mpi(&c, &c, &b));
+        Thread::yield();
+    }
+
+    for (int j = 0; j < ARENA_BLOCKS; j++) {
+        arena_blocks[i][j] = mbedtls_calloc(1, 16 + j);
+        TEST_ASSERT_TRUE(in_arena(i, arena_blocks[i][j]));
+    }
+
+    TEST_ASSERT_TRUE(in_arena(i, c.p));
+    mbedtls_mpi_free(&a);
+    mbedtls_mpi_free(&b);
+    mbedtls_mpi_free(&c);
+
+    mbedtls_arena_leave(arena);
+}
+
+void test_arena_threads()
+{
+    Thread *threads[ARENA_THREADS];
+    for (int i = 0; i < ARENA_THREADS; i++) {
+        TEST_ASSERT_EQUAL(0, mbedtls_arena_init(&arenas[i], arena_buf[i], ARENA_SIZE));
+        threads[i] = new Thread(osPriorityNormal, 1024);
+        threads[i]->start(callback(arena_thread, &arenas[i]));
+    }
+
+    for (int i = 0; i < ARENA_THREADS; i++) {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    for (int i = 0; i < ARENA_THREADS; i++) {
+        TEST_ASSERT_EQUAL(ARENA_BLOCKS, mbedtls_arena_blocks(&arenas[i]));
+        TEST_ASSERT_TRUE(mbedtls_arena_peak(&arenas[i]) <= ARENA_SIZE);
+
+        // Blocks of another thread's arena are freed in that arena
+        for (int j = 0; j < ARENA_BLOCKS / 2; j++) {
+            mbedtls_free(arena_blocks[i][j]);
+        }
+        TEST_ASSERT_EQUAL(ARENA_BLOCKS / 2, mbedtls_arena_blocks(&arenas[i]));
+
+        // and the arena is only released once the rest are freed as well
+        TEST_ASSERT_EQUAL(-1, mbedtls_arena_free(&arenas[i]));
+        for (int j = ARENA_BLOCKS / 2; j < ARENA_BLOCKS; j++) {
+            mbedtls_free(arena_blocks[i][j]);
+        }
+        TEST_ASSERT_EQUAL(0, mbedtls_arena_blocks(&arenas[i]));
+        TEST_ASSERT_EQUAL(0, mbedtls_arena_free(&arenas[i]));
+    }
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+Case cases[] = {
+    Case("Arena heap fallback", test_arena_heap, greentea_failure_handler),
+    Case("Arena free with live blocks", test_arena_free_live, greentea_failure_handler),
+    Case("Arena threads", test_arena_threads, greentea_failure_handler),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(30, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+
+int main() {
+    return !Harness::run(specification);
+}
@@ -0,0 +1,600 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Port of the mbed TLS benchmark program
+//
+// Each operation is repeated for BENCHMARK_TIME_MS and reported as cycles
+// per byte or operations per second. Cycles are counted with the DWT cycle
+// counter where the core has one, and derived from the us ticker otherwise.
+//
+// The heap peak of an operation is taken from mbed_stats_heap_get, whose
+// high-water mark cannot be reset. The peak is exact when the operation
+// raises it, otherwise the operation used at most the printed amount.
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "mbed_stats.h"
+#include "us_ticker_api.h"
+
+using namespace utest::v1;
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#include "mbedtls/sha1.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/sha512.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/ccm.h"
+#include "mbedtls/rsa.h"
+#include "mbedtls/pk.h"
+#include "mbedtls/ecdsa.h"
+#include "mbedtls/ecdh.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/certs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef BENCHMARK_TIME_MS
+#define BENCHMARK_TIME_MS   500
+#endif
+
+#define BENCHMARK_BUFSIZE   1024
+
+static unsigned char buf[BENCHMARK_BUFSIZE];
+static unsigned char tmp[BENCHMARK_BUFSIZE];
+static Timer timer;
+
+// Not a source of randomness, timing does not depend on it
+static int myrand(void *rng_state, unsigned char *output, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        output[i] = rand();
+    }
+    return 0;
+}
+
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+static void cycles_init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t cycles_read()
+{
+    return DWT->CYCCNT;
+}
+#else
+static void cycles_init()
+{
+}
+
+static uint32_t cycles_read()
+{
+    return us_ticker_read() * (SystemCoreClock / 1000000);
+}
+#endif
+
+struct heap_mark {
+    uint32_t current;
+    uint32_t max;
+};
+
+static void heap_mark_get(heap_mark *mark)
+{
+    mark->current = 0;
+    mark->max = 0;
+#ifdef MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    mark->current = stats.current_size;
+    mark->max = stats.max_size;
+#endif
+}
+
+// Runs op for BENCHMARK_TIME_MS and prints its speed, bytes is the amount
+// of data processed by each call or 0 for operations without data
+static void benchmark(const char *name, int (*op)(), size_t bytes)
+{
+    heap_mark start, end;
+    uint64_t cycles = 0;
+    uint32_t ops = 0;
+
+    heap_mark_get(&start);
+    timer.reset();
+    timer.start();
+    do {
+        uint32_t c = cycles_read();
+        int ret = op();
+        cycles += cycles_read() - c;
+        TEST_ASSERT_EQUAL_MESSAGE(0, ret, name);
+        ops++;
+    } while (timer.read_ms() < BENCHMARK_TIME_MS);
+    timer.stop();
+    heap_mark_get(&end);
+
+    uint32_t heap = end.max - start.current;
+    const char *heap_bound = end.max > start.max ? "" : "<=";
+
+    if (bytes) {
+        uint32_t cpb = (uint32_t)(100 * cycles / ((uint64_t)ops * bytes));
+        uint32_t kibps = (uint32_t)((uint64_t)ops * bytes * 1000 / 1024 / timer.read_ms());
+        printf("MBED: benchmark %-28s %8lu KiB/s %5lu.%02lu cycles/byte heap %s%lu\r\n",
+               name, (unsigned long)kibps, (unsigned long)(cpb / 100),
+               (unsigned long)(cpb % 100), heap_bound, (unsigned long)heap);
+    } else {
+        uint32_t opsps = (uint32_t)((uint64_t)ops * 100000 / timer.read_ms());
+        printf("MBED: benchmark %-28s %5lu.%02lu ops/s %10lu cycles/op heap %s%lu\r\n",
+               name, (unsigned long)(opsps / 100), (unsigned long)(opsps % 100),
+               (unsigned long)(cycles / ops), heap_bound, (unsigned long)heap);
+    }
+}
+
+
+// Hashes
+#if defined(MBEDTLS_SHA1_C)
+static int sha1_op()
+{
+    mbedtls_sha1(buf, BENCHMARK_BUFSIZE, tmp);
+    return 0;
+}
+#endif
+
+#if defined(MBEDTLS_SHA256_C)
+static int sha256_op()
+{
+    mbedtls_sha256(buf, BENCHMARK_BUFSIZE, tmp, 0);
+    return 0;
+}
+#endif
+
+#if defined(MBEDTLS_SHA512_C)
+static int sha512_op()
+{
+    mbedtls_sha512(buf, BENCHMARK_BUFSIZE, tmp, 0);
+    return 0;
+}
+#endif
+
+void test_hashes()
+{
+    memset(buf, 0xaa, sizeof buf);
+#if defined(MBEDTLS_SHA1_C)
+    benchmark("SHA-1", sha1_op, BENCHMARK_BUFSIZE);
+#endif
+#if defined(MBEDTLS_SHA256_C)
+    benchmark("SHA-256", sha256_op, BENCHMARK_BUFSIZE);
+#endif
+#if defined(MBEDTLS_SHA512_C)
+    benchmark("SHA-512", sha512_op, BENCHMARK_BUFSIZE);
+#endif
+}
+
+
+// Ciphers
+static const unsigned keysizes[] = {128, 192, 256};
+static unsigned char key[32];
+static unsigned char iv[16];
+static unsigned char tag[16];
+static char title[32];
+
+#if defined(MBEDTLS_AES_C) && defined(MBEDTLS_CIPHER_MODE_CBC)
+static mbedtls_aes_context aes;
+
+static int aes_cbc_op()
+{
+    return mbedtls_aes_crypt_cbc(&aes, MBEDTLS_AES_ENCRYPT, BENCHMARK_BUFSIZE, iv, buf, buf);
+}
+#endif
+
+#if defined(MBEDTLS_GCM_C)
+static mbedtls_gcm_context gcm;
+
+static int aes_gcm_op()
+{
+    return mbedtls_gcm_crypt_and_tag(&gcm, MBEDTLS_GCM_ENCRYPT, BENCHMARK_BUFSIZE,
+                                     iv, 12, NULL, 0, buf, buf, 16, tag);
+}
+#endif
+
+#if defined(MBEDTLS_CCM_C)
+static mbedtls_ccm_context ccm;
+
+static int aes_ccm_op()
+{
+    return mbedtls_ccm_encrypt_and_tag(&ccm, BENCHMARK_BUFSIZE, iv, 12, NULL, 0,
+                                       buf, buf, tag, 16);
+}
+#endif
+
+void test_ciphers()
+{
+    memset(buf, 0, sizeof buf);
+    memset(key, 0, sizeof key);
+    memset(iv, 0, sizeof iv);
+
+    for (unsigned i = 0; i < sizeof keysizes / sizeof keysizes[0]; i++) {
+        unsigned keysize = keysizes[i];
+
+#if defined(MBEDTLS_AES_C) && defined(MBEDTLS_CIPHER_MODE_CBC)
+        snprintf(title, sizeof title, "AES-CBC-%u", keysize);
+        mbedtls_aes_init(&aes);
+        // accelerators may not support every key size
+        if (mbedtls_aes_setkey_enc(&aes, key, keysize) == 0) {
+            benchmark(title, aes_cbc_op, BENCHMARK_BUFSIZE);
+        }
+        mbedtls_aes_free(&aes);
+#endif
+
+#if defined(MBEDTLS_GCM_C)
+        snprintf(title, sizeof title, "AES-GCM-%u", keysize);
+        mbedtls_gcm_init(&gcm);
+        if (mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, keysize) == 0) {
+            benchmark(title, aes_gcm_op, BENCHMARK_BUFSIZE);
+        }
+        mbedtls_gcm_free(&gcm);
+#endif
+
+#if defined(MBEDTLS_CCM_C)
+        snprintf(title, sizeof title, "AES-CCM-%u", keysize);
+        mbedtls_ccm_init(&ccm);
+        if (mbedtls_ccm_setkey(&ccm, MBEDTLS_CIPHER_ID_AES, key, keysize) == 0) {
+            benchmark(title, aes_ccm_op, BENCHMARK_BUFSIZE);
+        }
+        mbedtls_ccm_free(&ccm);
+#endif
+    }
+}
+
+
+// RSA with the 2048 bit test key
+#if defined(MBEDTLS_RSA_C) && defined(MBEDTLS_PK_PARSE_C) && \
+    defined(MBEDTLS_CERTS_C) && defined(MBEDTLS_PEM_PARSE_C)
+static mbedtls_pk_context rsa_key;
+
+static int rsa_public_op()
+{
+    return mbedtls_rsa_public(mbedtls_pk_rsa(rsa_key), buf, tmp);
+}
+
+static int rsa_private_op()
+{
+    return mbedtls_rsa_private(mbedtls_pk_rsa(rsa_key), myrand, NULL, buf, tmp);
+}
+
+void test_rsa()
+{
+    mbedtls_pk_init(&rsa_key);
+    TEST_ASSERT_EQUAL(0, mbedtls_pk_parse_key(&rsa_key,
+            (const unsigned char *)mbedtls_test_srv_key_rsa,
+            mbedtls_test_srv_key_rsa_len, NULL, 0));
+    TEST_ASSERT_EQUAL(MBEDTLS_PK_RSA, mbedtls_pk_get_type(&rsa_key));
+
+    // input smaller than the modulus
+    memset(buf, 0x2a, sizeof buf);
+    buf[0] = 0;
+
+    snprintf(title, sizeof title, "RSA-%u public",
+             (unsigned)mbedtls_pk_get_bitlen(&rsa_key));
+    benchmark(title, rsa_public_op, 0);
+    snprintf(title, sizeof title, "RSA-%u private",
+             (unsigned)mbedtls_pk_get_bitlen(&rsa_key));
+    benchmark(title, rsa_private_op, 0);
+
+    mbedtls_pk_free(&rsa_key);
+}
+#endif
+
+
+// ECC on each enabled curve
+#if defined(MBEDTLS_ECP_C)
+static mbedtls_ecp_group grp;
+static mbedtls_mpi d, r, s, z;
+static mbedtls_ecp_point Q, peer;
+
+static void ecp_init()
+{
+    mbedtls_ecp_group_init(&grp);
+    mbedtls_mpi_init(&d);
+    mbedtls_mpi_init(&r);
+    mbedtls_mpi_init(&s);
+    mbedtls_mpi_init(&z);
+    mbedtls_ecp_point_init(&Q);
+    mbedtls_ecp_point_init(&peer);
+}
+
+static void ecp_free()
+{
+    mbedtls_ecp_group_free(&grp);
+    mbedtls_mpi_free(&d);
+    mbedtls_mpi_free(&r);
+    mbedtls_mpi_free(&s);
+    mbedtls_mpi_free(&z);
+    mbedtls_ecp_point_free(&Q);
+    mbedtls_ecp_point_free(&peer);
+}
+#endif
+
+#if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_SHA256_C)
+static int ecdsa_sign_op()
+{
+    return mbedtls_ecdsa_sign(&grp, &r, &s, &d, tmp, 32, myrand, NULL);
+}
+
+static int ecdsa_verify_op()
+{
+    return mbedtls_ecdsa_verify(&grp, tmp, 32, &Q, &r, &s);
+}
+
+void test_ecdsa()
+{
+    mbedtls_sha256(buf, BENCHMARK_BUFSIZE, tmp, 0);
+
+    for (const mbedtls_ecp_curve_info *curve = mbedtls_ecp_curve_list();
+            curve->grp_id != MBEDTLS_ECP_DP_NONE; curve++) {
+        ecp_init();
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_group_load(&grp, curve->grp_id));
+
+        // Montgomery curves do not sign
+        if (curve->grp_id == MBEDTLS_ECP_DP_CURVE25519) {
+            ecp_free();
+            continue;
+        }
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_gen_keypair(&grp, &d, &Q, myrand, NULL));
+        TEST_ASSERT_EQUAL(0, ecdsa_sign_op());
+
+        snprintf(title, sizeof title, "ECDSA-%s sign", curve->name);
+        benchmark(title, ecdsa_sign_op, 0);
+        snprintf(title, sizeof title, "ECDSA-%s verify", curve->name);
+        benchmark(title, ecdsa_verify_op, 0);
+
+        ecp_free();
+    }
+}
+#endif
+
+#if defined(MBEDTLS_ECDH_C)
+// Ephemeral ECDH, a key pair is generated for each shared secret
+static int ecdh_op()
+{
+    int ret = mbedtls_ecdh_gen_public(&grp, &d, &Q, myrand, NULL);
+    if (ret != 0) {
+        return ret;
+    }
+    return mbedtls_ecdh_compute_shared(&grp, &z, &peer, &d, myrand, NULL);
+}
+
+void test_ecdh()
+{
+    for (const mbedtls_ecp_curve_info *curve = mbedtls_ecp_curve_list();
+            curve->grp_id != MBEDTLS_ECP_DP_NONE; curve++) {
+        ecp_init();
+        TEST_ASSERT_EQUAL(0, mbedtls_ecp_group_load(&grp, curve->grp_id));
+        TEST_ASSERT_EQUAL(0, mbedtls_ecdh_gen_public(&grp, &z, &peer, myrand, NULL));
+
+        snprintf(title, sizeof title, "ECDHE-%s", curve->name);
+        benchmark(title, ecdh_op, 0);
+
+        ecp_free();
+    }
+}
+#endif
+
+
+// Handshake between a client and a server on the target, both sides
+// are included in the time
+#if defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_SSL_SRV_C) && \
+    defined(MBEDTLS_X509_CRT_PARSE_C) && defined(MBEDTLS_CERTS_C) && \
+    defined(MBEDTLS_PEM_PARSE_C) && defined(MBEDTLS_GCM_C) && \
+    defined(MBEDTLS_SHA256_C)
+#define HANDSHAKE_PIPE_SIZE 4096
+
+struct pipe {
+    unsigned char data[HANDSHAKE_PIPE_SIZE];
+    size_t len;
+};
+
+// Each side sends to one pipe and receives from the other
+struct endpoint {
+    pipe *tx;
+    pipe *rx;
+};
+
+static pipe to_server, to_client;
+static endpoint client_end = {&to_server, &to_client};
+static endpoint server_end = {&to_client, &to_server};
+
+static int pipe_send(void *ctx, const unsigned char *data, size_t len)
+{
+    pipe *p = ((endpoint *)ctx)->tx;
+    if (len > sizeof p->data - p->len) {
+        len = sizeof p->data - p->len;
+    }
+    if (len == 0) {
+        return MBEDTLS_ERR_SSL_WANT_WRITE;
+    }
+    memcpy(&p->data[p->len], data, len);
+    p->len += len;
+    return len;
+}
+
+static int pipe_recv(void *ctx, unsigned char *data, size_t len)
+{
+    pipe *p = ((endpoint *)ctx)->rx;
+    if (len > p->len) {
+        len = p->len;
+    }
+    if (len == 0) {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+    memcpy(data, p->data, len);
+    memmove(p->data, &p->data[len], p->len - len);
+    p->len -= len;
+    return len;
+}
+
+static mbedtls_ssl_config client_conf, server_conf;
+static mbedtls_x509_crt ca_crt, srv_crt;
+static mbedtls_pk_context srv_key;
+static int ciphersuites[2];
+
+static int handshake_op()
+{
+    mbedtls_ssl_context client, server;
+    int ret = 0;
+
+    to_server.len = 0;
+    to_client.len = 0;
+
+    mbedtls_ssl_init(&client);
+    mbedtls_ssl_init(&server);
+    if ((ret = mbedtls_ssl_setup(&client, &client_conf)) != 0 ||
+        (ret = mbedtls_ssl_setup(&server, &server_conf)) != 0 ||
+        (ret = mbedtls_ssl_set_hostname(&client, "localhost")) != 0) {
+        goto exit;
+    }
+    mbedtls_ssl_set_bio(&client, &client_end, pipe_send, pipe_recv, NULL);
+    mbedtls_ssl_set_bio(&server, &server_end, pipe_send, pipe_recv, NULL);
+
+    while (client.state != MBEDTLS_SSL_HANDSHAKE_OVER ||
+           server.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+        if (client.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+            ret = mbedtls_ssl_handshake_step(&client);
+            if (ret != 0 && ret != MBEDTLS_ERR_SSL_WANT_READ &&
+                ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+                goto exit;
+            }
+        }
+        if (server.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+            ret = mbedtls_ssl_handshake_step(&server);
+            if (ret != 0 && ret != MBEDTLS_ERR_SSL_WANT_READ &&
+                ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+                goto exit;
+            }
+        }
+    }
+    ret = 0;
+
+exit:
+    mbedtls_ssl_free(&client);
+    mbedtls_ssl_free(&server);
+    return ret;
+}
+
+static void handshake(const char *name, int ciphersuite,
+                      const char *ca, size_t ca_len,
+                      const char *crt, size_t crt_len,
+                      const char *key, size_t key_len)
+{
+    mbedtls_ssl_config_init(&client_conf);
+    mbedtls_ssl_config_init(&server_conf);
+    mbedtls_x509_crt_init(&ca_crt);
+    mbedtls_x509_crt_init(&srv_crt);
+    mbedtls_pk_init(&srv_key);
+
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_parse(&ca_crt, (const unsigned char *)ca, ca_len));
+    TEST_ASSERT_EQUAL(0, mbedtls_x509_crt_parse(&srv_crt, (const unsigned char *)crt, crt_len));
+    TEST_ASSERT_EQUAL(0, mbedtls_pk_parse_key(&srv_key, (const unsigned char *)key, key_len, NULL, 0));
+
+    ciphersuites[0] = ciphersuite;
+    ciphersuites[1] = 0;
+
+    TEST_ASSERT_EQUAL(0, mbedtls_ssl_config_defaults(&client_conf, MBEDTLS_SSL_IS_CLIENT,
+            MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT));
+    mbedtls_ssl_conf_rng(&client_conf, myrand, NULL);
+    mbedtls_ssl_conf_ca_chain(&client_conf, &ca_crt, NULL);
+    mbedtls_ssl_conf_authmode(&client_conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_ciphersuites(&client_conf, ciphersuites);
+
+    TEST_ASSERT_EQUAL(0, mbedtls_ssl_config_defaults(&server_conf, MBEDTLS_SSL_IS_SERVER,
+            MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT));
+    mbedtls_ssl_conf_rng(&server_conf, myrand, NULL);
+    TEST_ASSERT_EQUAL(0, mbedtls_ssl_conf_own_cert(&server_conf, &srv_crt, &srv_key));
+    mbedtls_ssl_conf_ciphersuites(&server_conf, ciphersuites);
+
+    benchmark(name, handshake_op, 0);
+
+    mbedtls_ssl_config_free(&client_conf);
+    mbedtls_ssl_config_free(&server_conf);
+    mbedtls_x509_crt_free(&ca_crt);
+    mbedtls_x509_crt_free(&srv_crt);
+    mbedtls_pk_free(&srv_key);
+}
+
+void test_handshake()
+{
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED) && defined(MBEDTLS_ECDSA_C)
+    handshake("TLS ECDHE-ECDSA-AES128-GCM",
+              MBEDTLS_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+              mbedtls_test_ca_crt_ec, mbedtls_test_ca_crt_ec_len,
+              mbedtls_test_srv_crt_ec, mbedtls_test_srv_crt_ec_len,
+              mbedtls_test_srv_key_ec, mbedtls_test_srv_key_ec_len);
+#endif
+#if defined(MBEDTLS_KEY_EXCHANGE_ECDHE_RSA_ENABLED) && defined(MBEDTLS_RSA_C)
+    handshake("TLS ECDHE-RSA-AES128-GCM",
+              MBEDTLS_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+              mbedtls_test_ca_crt_rsa, mbedtls_test_ca_crt_rsa_len,
+              mbedtls_test_srv_crt_rsa, mbedtls_test_srv_crt_rsa_len,
+              mbedtls_test_srv_key_rsa, mbedtls_test_srv_key_rsa_len);
+#endif
+}
+#endif
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(600, "default_auto");
+    cycles_init();
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Hashes", test_hashes),
+    Case("Ciphers", test_ciphers),
+#if defined(MBEDTLS_RSA_C) && defined(MBEDTLS_PK_PARSE_C) && \
+    defined(MBEDTLS_CERTS_C) && defined(MBEDTLS_PEM_PARSE_C)
+    Case("RSA", test_rsa),
+#endif
+#if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_SHA256_C)
+    Case("ECDSA", test_ecdsa),
+#endif
+#if defined(MBEDTLS_ECDH_C)
+    Case("ECDH", test_ecdh),
+#endif
+#if defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_SSL_SRV_C) && \
+    defined(MBEDTLS_X509_CRT_PARSE_C) && defined(MBEDTLS_CERTS_C) && \
+    defined(MBEDTLS_PEM_PARSE_C) && defined(MBEDTLS_GCM_C) && \
+    defined(MBEDTLS_SHA256_C)
+    Case("Handshake", test_handshake),
+#endif
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -28,8 +28,13 @@ using namespace utest::v1;
 #include MBEDTLS_CONFIG_FILE
 #endif
 
+#include "mbedtls/sha1.h"
 #include "mbedtls/sha256.h"
 #include "mbedtls/sha512.h"
+#include "mbedtls/aes.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/bignum.h"
+#include "mbedtls/ecp.h"
 #include "mbedtls/entropy.h"
 #include "mbedtls/entropy_poll.h"
 
@@ -55,6 +60,10 @@ using namespace utest::v1;
 
 #if defined(MBEDTLS_SELF_TEST)
 
+#if defined(MBEDTLS_SHA1_C)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_sha1_self_test)
+#endif
+
 #if defined(MBEDTLS_SHA256_C)
 MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_sha256_self_test)
 #endif
@@ -63,6 +72,22 @@ MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_sha256_self_test)
 MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_sha512_self_test)
 #endif
 
+#if defined(MBEDTLS_AES_C)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_aes_self_test)
+#endif
+
+#if defined(MBEDTLS_GCM_C) && defined(MBEDTLS_AES_C)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_gcm_self_test)
+#endif
+
+#if defined(MBEDTLS_BIGNUM_C)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_mpi_self_test)
+#endif
+
+#if defined(MBEDTLS_ECP_C)
+MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_ecp_self_test)
+#endif
+
 #if defined(MBEDTLS_ENTROPY_C)
 MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_entropy_self_test)
 #endif
@@ -71,9 +96,97 @@ MBEDTLS_SELF_TEST_TEST_CASE(mbedtls_entropy_self_test)
 #warning "MBEDTLS_SELF_TEST not enabled"
 #endif /* MBEDTLS_SELF_TEST */
 
+#if defined(MBEDTLS_SHA256_C)
+#define SHA256_THREADS      3
+#define SHA256_BLOCKS       64
+
+static unsigned char sha256_data[64];
+static unsigned char sha256_digests[SHA256_THREADS][32];
+
+// Hashes of several threads share the accelerator block by block
+static void sha256_thread(unsigned char *digest)
+{
+    mbedtls_sha256_context ctx;
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts(&ctx, 0);
+    for (int i = 0; i < SHA256_BLOCKS; i++) {
+        mbedtls_sha256_update(&ctx, sha256_data, sizeof sha256_data);
+        Thread::yield();
+    }
+    mbedtls_sha256_finish(&ctx, digest);
+    mbedtls_sha256_free(&ctx);
+}
+
+void mbedtls_sha256_threads_test_case()
+{
+    unsigned char expected[32];
+    mbedtls_sha256_context ctx;
+
+    for (unsigned i = 0; i < sizeof sha256_data; i++) {
+        sha256_data[i] = i;
+    }
+
+    mbedtls_sha256_init(&ctx);
+    mbedtls_sha256_starts(&ctx, 0);
+    for (int i = 0; i < SHA256_BLOCKS; i++) {
+        mbedtls_sha256_update(&ctx, sha256_data, sizeof sha256_data);
+    }
+    mbedtls_sha256_finish(&ctx, expected);
+    mbedtls_sha256_free(&ctx);
+
+    Thread *threads[SHA256_THREADS];
+    for (int i = 0; i < SHA256_THREADS; i++) {
+        threads[i] = new Thread(osPriorityNormal, 1024);
+        threads[i]->start(callback(sha256_thread, sha256_digests[i]));
+    }
+
+    for (int i = 0; i < SHA256_THREADS; i++) {
+        threads[i]->join();
+        delete threads[i];
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sha256_digests[i], sizeof expected);
+    }
+}
+#endif
+
+#if defined(MBEDTLS_ENTROPY_HARDWARE_ALT) && defined(MBED_CONF_MBEDTLS_TRNG_POOL_SIZE)
+#include "platform/inc/mbed_trng.h"
+
+extern "C" int mbedtls_hardware_poll(void *data, unsigned char *output, size_t len, size_t *olen);
+
+// Entropy requests are served from the pool the thread fills
+void mbed_trng_pool_test_case()
+{
+    unsigned char buf[32];
+    size_t olen = 0;
+
+    mbed_trng_pool_start();
+    for (int i = 0; i < 100 && mbed_trng_pool_level() < MBED_CONF_MBEDTLS_TRNG_POOL_SIZE; i++) {
+        Thread::wait(10);
+    }
+    TEST_ASSERT_EQUAL(MBED_CONF_MBEDTLS_TRNG_POOL_SIZE, mbed_trng_pool_level());
+
+    size_t len = sizeof buf < MBED_CONF_MBEDTLS_TRNG_POOL_SIZE ? sizeof buf : MBED_CONF_MBEDTLS_TRNG_POOL_SIZE;
+    TEST_ASSERT_EQUAL(0, mbedtls_hardware_poll(NULL, buf, len, &olen));
+    TEST_ASSERT_EQUAL(len, olen);
+    TEST_ASSERT_TRUE(mbed_trng_pool_level() <= MBED_CONF_MBEDTLS_TRNG_POOL_SIZE - len);
+}
+#endif
+
 Case cases[] = {
+#if defined(MBEDTLS_SHA256_C)
+    Case("mbedtls_sha256_threads", mbedtls_sha256_threads_test_case),
+#endif
+
+#if defined(MBEDTLS_ENTROPY_HARDWARE_ALT) && defined(MBED_CONF_MBEDTLS_TRNG_POOL_SIZE)
+    Case("mbed_trng_pool", mbed_trng_pool_test_case),
+#endif
+
 #if defined(MBEDTLS_SELF_TEST)
 
+#if defined(MBEDTLS_SHA1_C)
+    Case("mbedtls_sha1_self_test", mbedtls_sha1_self_test_test_case),
+#endif
+
 #if defined(MBEDTLS_SHA256_C)
     Case("mbedtls_sha256_self_test", mbedtls_sha256_self_test_test_case),
 #endif
@@ -82,6 +195,22 @@ Case cases[] = {
     Case("mbedtls_sha512_self_test", mbedtls_sha512_self_test_test_case),
 #endif
 
+#if defined(MBEDTLS_AES_C)
+    Case("mbedtls_aes_self_test", mbedtls_aes_self_test_test_case),
+#endif
+
+#if defined(MBEDTLS_GCM_C) && defined(MBEDTLS_AES_C)
+    Case("mbedtls_gcm_self_test", mbedtls_gcm_self_test_test_case),
+#endif
+
+#if defined(MBEDTLS_BIGNUM_C)
+    Case("mbedtls_mpi_self_test", mbedtls_mpi_self_test_test_case),
+#endif
+
+#if defined(MBEDTLS_ECP_C)
+    Case("mbedtls_ecp_self_test", mbedtls_ecp_self_test_test_case),
+#endif
+
 #if defined(MBEDTLS_ENTROPY_C)
     Case("mbedtls_entropy_self_test", mbedtls_entropy_self_test_test_case),
 #endif
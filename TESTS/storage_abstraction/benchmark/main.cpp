@@ -0,0 +1,266 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Driver_Storage MTD benchmarks
+//
+// Each benchmark erases, programs or reads the start of the first block of
+// the MTD in operations of one size, one after the other or at random
+// addresses, and prints the min, average and max microseconds an operation
+// took with the throughput. The cases only fail when the MTD does not work,
+// the numbers are meant to be compared across drivers and targets.
+
+#if !DEVICE_STORAGE
+    #error [NOT_SUPPORTED] Storage not supported for this target
+#endif
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "storage_abstraction/Driver_Storage.h"
+#include "us_ticker_api.h"
+
+using namespace utest::v1;
+
+extern ARM_DRIVER_STORAGE ARM_Driver_Storage_MTD_K64F;
+static ARM_DRIVER_STORAGE *drv = &ARM_Driver_Storage_MTD_K64F;
+
+// The storage erased by the benchmarks, at the start of the first block
+#ifndef BENCHMARK_REGION_SIZE
+#define BENCHMARK_REGION_SIZE   (64 * 1024)
+#endif
+
+#define BUFFER_SIZE             4096
+#define RANDOM_ROUNDS           64
+
+static uint8_t buffer[BUFFER_SIZE];
+static uint8_t programmed[BENCHMARK_REGION_SIZE / 16 / 8];
+
+static ARM_STORAGE_INFO info;
+static ARM_STORAGE_BLOCK block;
+static uint32_t region_size;
+
+static volatile bool done;
+static volatile int32_t done_status;
+
+static void storage_callback(int32_t status, ARM_STORAGE_OPERATION operation)
+{
+    (void)operation;
+    done_status = status;
+    done = true;
+}
+
+// The result of an operation, once completed if asynchronous
+static int32_t complete(int32_t rc)
+{
+    if (rc == ARM_DRIVER_OK) {
+        while (!done);
+        rc = done_status;
+    }
+    return rc;
+}
+
+static int32_t mtd_erase(uint64_t addr, uint32_t size)
+{
+    done = false;
+    return complete(drv->Erase(addr, size));
+}
+
+static int32_t mtd_program(uint64_t addr, uint32_t size)
+{
+    done = false;
+    return complete(drv->ProgramData(addr, buffer, size));
+}
+
+static int32_t mtd_read(uint64_t addr, uint32_t size)
+{
+    done = false;
+    return complete(drv->ReadData(addr, buffer, size));
+}
+
+struct latency {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+};
+
+static void latency_reset(latency *l)
+{
+    l->min = UINT32_MAX;
+    l->max = 0;
+    l->sum = 0;
+    l->count = 0;
+}
+
+static void latency_add(latency *l, uint32_t us)
+{
+    if (us < l->min) {
+        l->min = us;
+    }
+    if (us > l->max) {
+        l->max = us;
+    }
+    l->sum += us;
+    l->count++;
+}
+
+static void latency_print(const char *name, uint32_t size, const latency *l)
+{
+    TEST_ASSERT_TRUE_MESSAGE(l->count > 0, name);
+    uint64_t sum = l->sum ? l->sum : 1;
+    printf("MBED: benchmark %-18s %5lu B min %7lu avg %7lu max %7lu us %8lu KiB/s\r\n", name,
+           (unsigned long)size, (unsigned long)l->min, (unsigned long)(l->sum / l->count),
+           (unsigned long)l->max, (unsigned long)((uint64_t)size * l->count * 1000000 / sum / 1024));
+}
+
+static latency result;
+
+static void erase_region()
+{
+    for (uint32_t offset = 0; offset < region_size; offset += block.attributes.erase_unit) {
+        TEST_ASSERT_EQUAL(block.attributes.erase_unit, mtd_erase(block.addr + offset, block.attributes.erase_unit));
+    }
+}
+
+// A size the MTD can program, and within the region
+static bool supported(uint32_t size)
+{
+    if ((size % info.program_unit) || size > region_size) {
+        printf("MBED: benchmark skipped for %lu B\r\n", (unsigned long)size);
+        return false;
+    }
+    return true;
+}
+
+
+control_t test_setup(const size_t call_count)
+{
+    int32_t rc = drv->Initialize(storage_callback);
+    TEST_ASSERT(rc >= ARM_DRIVER_OK);
+    if (rc == ARM_DRIVER_OK) {
+        while (!done);
+    }
+
+    TEST_ASSERT_EQUAL(ARM_DRIVER_OK, drv->GetInfo(&info));
+    TEST_ASSERT_EQUAL(ARM_DRIVER_OK, drv->GetNextBlock(NULL, &block));
+    TEST_ASSERT(ARM_STORAGE_VALID_BLOCK(&block));
+    TEST_ASSERT(block.attributes.erasable && block.attributes.programmable);
+
+    region_size = (block.size < BENCHMARK_REGION_SIZE) ? (uint32_t)block.size : BENCHMARK_REGION_SIZE;
+    region_size -= region_size % block.attributes.erase_unit;
+    TEST_ASSERT(region_size > 0);
+    printf("MTD: program unit %lu B, erase unit %lu B, %lu KiB benchmarked at 0x%lx\r\n",
+           (unsigned long)info.program_unit, (unsigned long)block.attributes.erase_unit,
+           (unsigned long)(region_size / 1024), (unsigned long)block.addr);
+    return CaseNext;
+}
+
+void test_erase()
+{
+    Timer timer;
+    timer.start();
+    latency_reset(&result);
+    for (uint32_t offset = 0; offset < region_size; offset += block.attributes.erase_unit) {
+        uint32_t start = timer.read_us();
+        TEST_ASSERT_EQUAL(block.attributes.erase_unit, mtd_erase(block.addr + offset, block.attributes.erase_unit));
+        latency_add(&result, timer.read_us() - start);
+    }
+    latency_print("mtd erase", block.attributes.erase_unit, &result);
+}
+
+template <uint32_t SIZE, bool RANDOM>
+void test_program()
+{
+    if (!supported(SIZE)) {
+        return;
+    }
+    erase_region();
+    memset(buffer, 0x5A, SIZE);
+    memset(programmed, 0, sizeof(programmed));
+
+    // each unit is programmed once, at random or in order
+    uint32_t slots = region_size / SIZE;
+    uint32_t rounds = (RANDOM && slots > RANDOM_ROUNDS) ? RANDOM_ROUNDS : slots;
+    Timer timer;
+    timer.start();
+    latency_reset(&result);
+    for (uint32_t i = 0; i < rounds; i++) {
+        uint32_t slot = i;
+        if (RANDOM) {
+            do {
+                slot = rand() % slots;
+            } while (programmed[slot / 8] & (1 << (slot % 8)));
+            programmed[slot / 8] |= 1 << (slot % 8);
+        }
+        uint32_t start = timer.read_us();
+        TEST_ASSERT_EQUAL(SIZE, mtd_program(block.addr + slot * SIZE, SIZE));
+        latency_add(&result, timer.read_us() - start);
+    }
+    latency_print(RANDOM ? "mtd random program" : "mtd program", SIZE, &result);
+}
+
+template <uint32_t SIZE, bool RANDOM>
+void test_read()
+{
+    if (SIZE > region_size) {
+        return;
+    }
+    uint32_t slots = region_size / SIZE;
+    uint32_t rounds = (RANDOM && slots > RANDOM_ROUNDS) ? RANDOM_ROUNDS : slots;
+    Timer timer;
+    timer.start();
+    latency_reset(&result);
+    for (uint32_t i = 0; i < rounds; i++) {
+        uint32_t slot = RANDOM ? rand() % slots : i;
+        uint32_t start = timer.read_us();
+        TEST_ASSERT_EQUAL(SIZE, mtd_read(block.addr + slot * SIZE, SIZE));
+        latency_add(&result, timer.read_us() - start);
+    }
+    latency_print(RANDOM ? "mtd random read" : "mtd read", SIZE, &result);
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(300, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("MTD: setup", test_setup),
+    Case("MTD: erase", test_erase),
+    Case("MTD: program 16 B", test_program<16, false>),
+    Case("MTD: program 256 B", test_program<256, false>),
+    Case("MTD: program 1 KiB", test_program<1024, false>),
+    Case("MTD: program 4 KiB", test_program<4096, false>),
+    Case("MTD: random program 16 B", test_program<16, true>),
+    Case("MTD: random program 256 B", test_program<256, true>),
+    Case("MTD: random program 4 KiB", test_program<4096, true>),
+    Case("MTD: read 16 B", test_read<16, false>),
+    Case("MTD: read 256 B", test_read<256, false>),
+    Case("MTD: read 1 KiB", test_read<1024, false>),
+    Case("MTD: read 4 KiB", test_read<4096, false>),
+    Case("MTD: random read 16 B", test_read<16, true>),
+    Case("MTD: random read 256 B", test_read<256, true>),
+    Case("MTD: random read 4 KiB", test_read<4096, true>),
+};
+
+Specification specification(greentea_setup, cases, greentea_test_teardown_handler);
+
+int main()
+{
+    Harness::run(specification);
+}
@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+#include "utest/utest.h"
+#include "storage_abstraction/Driver_Storage.h"
+#include "LogFileSystem.h"
+#include <string.h>
+
+using namespace utest::v1;
+
+#define SECTOR_SIZE         1024
+#define SECTOR_COUNT        8
+#define PROGRAM_UNIT        8
+#define MAX_FILES           8
+#define CHUNK_SIZE          64
+
+// A synchronous NOR flash in RAM: erasing sets the bytes to 0xFF, and
+// programs fail once program_budget reaches 0, programming half the data
+static uint8_t flash[SECTOR_SIZE * SECTOR_COUNT];
+static uint32_t erase_count;
+static int program_budget = -1;
+
+static ARM_DRIVER_VERSION ram_get_version()
+{
+    ARM_DRIVER_VERSION version = {ARM_STORAGE_API_VERSION, ARM_STORAGE_API_VERSION};
+    return version;
+}
+
+static ARM_STORAGE_CAPABILITIES ram_get_capabilities()
+{
+    ARM_STORAGE_CAPABILITIES caps;
+    memset(&caps, 0, sizeof(caps));
+    return caps;
+}
+
+static int32_t ram_initialize(ARM_Storage_Callback_t callback)
+{
+    return 1;
+}
+
+static int32_t ram_uninitialize()
+{
+    return 1;
+}
+
+static int32_t ram_power_control(ARM_POWER_STATE state)
+{
+    return 1;
+}
+
+static int32_t ram_read_data(uint64_t addr, void *data, uint32_t size)
+{
+    if ((addr + size) > sizeof(flash)) {
+        return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    memcpy(data, &flash[addr], size);
+    return size;
+}
+
+static int32_t ram_program_data(uint64_t addr, const void *data, uint32_t size)
+{
+    if ((addr + size) > sizeof(flash) || (addr % PROGRAM_UNIT) || (size % PROGRAM_UNIT)) {
+        return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    if (program_budget == 0) {
+        memcpy(&flash[addr], data, size / 2);
+        return ARM_DRIVER_ERROR;
+    }
+    if (program_budget > 0) {
+        program_budget--;
+    }
+    memcpy(&flash[addr], data, size);
+    return size;
+}
+
+static int32_t ram_erase(uint64_t addr, uint32_t size)
+{
+    if ((addr + size) > sizeof(flash) || (addr % SECTOR_SIZE) || (size % SECTOR_SIZE)) {
+        return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    memset(&flash[addr], 0xFF, size);
+    erase_count += size / SECTOR_SIZE;
+    return size;
+}
+
+static int32_t ram_erase_all()
+{
+    return ARM_DRIVER_ERROR_UNSUPPORTED;
+}
+
+static ARM_STORAGE_STATUS ram_get_status()
+{
+    ARM_STORAGE_STATUS status;
+    memset(&status, 0, sizeof(status));
+    return status;
+}
+
+static int32_t ram_get_info(ARM_STORAGE_INFO *info)
+{
+    memset(info, 0, sizeof(*info));
+    info->total_storage        = sizeof(flash);
+    info->program_unit         = PROGRAM_UNIT;
+    info->optimal_program_unit = PROGRAM_UNIT;
+    info->erased_value         = 1;
+    return ARM_DRIVER_OK;
+}
+
+static uint32_t ram_resolve_address(uint64_t addr)
+{
+    return 0;
+}
+
+static int32_t ram_get_next_block(const ARM_STORAGE_BLOCK *prev_block, ARM_STORAGE_BLOCK *next_block)
+{
+    return ARM_DRIVER_ERROR;
+}
+
+static int32_t ram_get_block(uint64_t addr, ARM_STORAGE_BLOCK *block)
+{
+    if (addr >= sizeof(flash)) {
+        return ARM_DRIVER_ERROR_PARAMETER;
+    }
+    memset(block, 0, sizeof(*block));
+    block->addr                       = 0;
+    block->size                       = sizeof(flash);
+    block->attributes.erasable        = 1;
+    block->attributes.programmable    = 1;
+    block->attributes.erase_unit      = SECTOR_SIZE;
+    block->attributes.protection_unit = SECTOR_SIZE;
+    return ARM_DRIVER_OK;
+}
+
+static ARM_DRIVER_STORAGE ram_mtd = {
+    ram_get_version,
+    ram_get_capabilities,
+    ram_initialize,
+    ram_uninitialize,
+    ram_power_control,
+    ram_read_data,
+    ram_program_data,
+    ram_erase,
+    ram_erase_all,
+    ram_get_status,
+    ram_get_info,
+    ram_resolve_address,
+    ram_get_next_block,
+    ram_get_block,
+};
+
+static LogFileSystem fs("logfs", &ram_mtd, 0, sizeof(flash), MAX_FILES, CHUNK_SIZE);
+
+static void write_file(const char *name, const void *data, size_t size)
+{
+    FileHandle *file = fs.open(name, O_WRONLY | O_CREAT | O_TRUNC);
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL(size, file->write(data, size));
+    TEST_ASSERT_EQUAL(0, file->close());
+}
+
+static void check_file(const char *name, const void *data, size_t size)
+{
+    static uint8_t buffer[512];
+    FileHandle *file = fs.open(name, O_RDONLY);
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL(size, file->flen());
+    TEST_ASSERT_EQUAL(size, file->read(buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(data, buffer, size);
+    TEST_ASSERT_EQUAL(0, file->close());
+}
+
+static bool in_dir(const char *dir, const char *name)
+{
+    DirHandle *d = fs.opendir(dir);
+    TEST_ASSERT_NOT_NULL(d);
+    bool found = false;
+    while (struct dirent *e = d->readdir()) {
+        found = found || (strcmp(e->d_name, name) == 0);
+    }
+    TEST_ASSERT_EQUAL(0, d->closedir());
+    return found;
+}
+
+static uint8_t pattern[300];
+
+static void fill_pattern(uint8_t seed)
+{
+    for (size_t i = 0; i < sizeof(pattern); i++) {
+        pattern[i] = (uint8_t)(seed + i * 7);
+    }
+}
+
+void test_format_mount()
+{
+    memset(flash, 0, sizeof(flash));
+    TEST_ASSERT_NOT_EQUAL(0, fs.mount());
+    TEST_ASSERT_EQUAL(0, fs.format());
+    TEST_ASSERT_EQUAL(0, fs.mount());
+    TEST_ASSERT_NULL(fs.open("missing", O_RDONLY));
+}
+
+void test_write_read()
+{
+    fill_pattern(1);
+    write_file("data.bin", pattern, sizeof(pattern));
+    check_file("data.bin", pattern, sizeof(pattern));
+
+    FileHandle *file = fs.open("data.bin", O_WRONLY);
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL(100, file->lseek(100, SEEK_SET));
+    TEST_ASSERT_EQUAL(4, file->write("ABCD", 4));
+    TEST_ASSERT_EQUAL(0, file->close());
+    memcpy(&pattern[100], "ABCD", 4);
+    check_file("data.bin", pattern, sizeof(pattern));
+}
+
+void test_remount()
+{
+    TEST_ASSERT_EQUAL(0, fs.unmount());
+    TEST_ASSERT_EQUAL(0, fs.mount());
+    check_file("data.bin", pattern, sizeof(pattern));
+}
+
+void test_collect()
+{
+    uint32_t erased = erase_count;
+    for (int i = 0; i < 100; i++) {
+        fill_pattern(i);
+        write_file("data.bin", pattern, sizeof(pattern));
+    }
+    TEST_ASSERT(erase_count - erased >= SECTOR_COUNT);
+    check_file("data.bin", pattern, sizeof(pattern));
+
+    TEST_ASSERT_EQUAL(0, fs.unmount());
+    TEST_ASSERT_EQUAL(0, fs.mount());
+    check_file("data.bin", pattern, sizeof(pattern));
+}
+
+void test_interrupted_write()
+{
+    fill_pattern(0x55);
+    write_file("cut.bin", pattern, CHUNK_SIZE);
+
+    // A record is programmed in several parts: fail each of them in turn
+    for (int budget = 0; budget < 3; budget++) {
+        uint8_t update[CHUNK_SIZE];
+        memset(update, 0xA5, sizeof(update));
+        program_budget = budget;
+        FileHandle *file = fs.open("cut.bin", O_WRONLY);
+        TEST_ASSERT_NOT_NULL(file);
+        file->write(update, sizeof(update));
+        file->close();
+        program_budget = -1;
+
+        TEST_ASSERT_EQUAL(0, fs.unmount());
+        TEST_ASSERT_EQUAL(0, fs.mount());
+        check_file("cut.bin", pattern, CHUNK_SIZE);
+    }
+}
+
+void test_directories()
+{
+    TEST_ASSERT_EQUAL(0, fs.mkdir("dir", 0777));
+    TEST_ASSERT_NOT_EQUAL(0, fs.mkdir("dir", 0777));
+    TEST_ASSERT_NULL(fs.open("nodir/file", O_WRONLY | O_CREAT));
+    write_file("dir/file", "hello", 5);
+    TEST_ASSERT(in_dir("", "dir"));
+    TEST_ASSERT(in_dir("dir", "file"));
+
+    TEST_ASSERT_NOT_EQUAL(0, fs.remove("dir"));
+    TEST_ASSERT_EQUAL(0, fs.rename("dir/file", "moved"));
+    TEST_ASSERT(!in_dir("dir", "file"));
+    check_file("moved", "hello", 5);
+    TEST_ASSERT_EQUAL(0, fs.remove("dir"));
+    TEST_ASSERT_EQUAL(0, fs.remove("moved"));
+
+    TEST_ASSERT_EQUAL(0, fs.unmount());
+    TEST_ASSERT_EQUAL(0, fs.mount());
+    TEST_ASSERT(!in_dir("", "dir"));
+    TEST_ASSERT(!in_dir("", "moved"));
+    TEST_ASSERT(in_dir("", "data.bin"));
+}
+
+Case cases[] = {
+    Case("Test format and mount", test_format_mount),
+    Case("Test write and read back", test_write_read),
+    Case("Test files survive a remount", test_remount),
+    Case("Test sectors are collected", test_collect),
+    Case("Test interrupted write keeps the old data", test_interrupted_write),
+    Case("Test directories, rename and remove", test_directories),
+};
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(20, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+int main()
+{
+    Harness::run(Specification(greentea_test_setup, cases));
+}
@@ -0,0 +1,242 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// uVisor secure call and RPC latency benchmarks
+//
+// Each benchmark repeats a call and prints the min, average and max cycles
+// it took, measured by uVisor with uvisor_benchmark_start and
+// uvisor_benchmark_stop: the main box has no access to the DWT. The time
+// of an empty measurement is subtracted. The cases only fail when the
+// calls do not work, the numbers are meant to be compared across targets
+// and releases.
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "rtos.h"
+#include "uvisor-lib/uvisor-lib.h"
+
+using namespace utest::v1;
+
+// The main box ACL below lists the peripherals of the K64F
+#if !defined(FEATURE_UVISOR) || !defined(TARGET_UVISOR_SUPPORTED) || !defined(TARGET_K64F)
+  #error [NOT_SUPPORTED] test not supported
+#endif
+
+#ifndef BENCHMARK_ROUNDS
+#define BENCHMARK_ROUNDS    200
+#endif
+
+#define BOX_STACK_SIZE      1024
+#define BOX_HEAP_SIZE       2048
+
+
+static const UvisorBoxAclItem main_acl[] = {
+    {SIM,    sizeof(*SIM),    UVISOR_TACLDEF_PERIPH},
+    {OSC,    sizeof(*OSC),    UVISOR_TACLDEF_PERIPH},
+    {MCG,    sizeof(*MCG),    UVISOR_TACLDEF_PERIPH},
+    {PORTA,  sizeof(*PORTA),  UVISOR_TACLDEF_PERIPH},
+    {PORTB,  sizeof(*PORTB),  UVISOR_TACLDEF_PERIPH},
+    {PORTC,  sizeof(*PORTC),  UVISOR_TACLDEF_PERIPH},
+    {RTC,    sizeof(*RTC),    UVISOR_TACLDEF_PERIPH},
+    {LPTMR0, sizeof(*LPTMR0), UVISOR_TACLDEF_PERIPH},
+    {PIT,    sizeof(*PIT),    UVISOR_TACLDEF_PERIPH},
+    {SMC,    sizeof(*SMC),    UVISOR_TACLDEF_PERIPH},
+    {UART0,  sizeof(*UART0),  UVISOR_TACLDEF_PERIPH},
+};
+
+UVISOR_SET_MODE_ACL(UVISOR_ENABLED, main_acl);
+UVISOR_SET_PAGE_HEAP(8 * 1024, 3);
+
+
+// The box the calls go to, serving them from its main thread
+static uint32_t box_add(uint32_t a, uint32_t b);
+static uint32_t box_local_calls(uint32_t rounds);
+static void benchmark_box_main(const void *);
+
+UVISOR_BOX_NAMESPACE(NULL);
+UVISOR_BOX_HEAPSIZE(BOX_HEAP_SIZE);
+UVISOR_BOX_MAIN(benchmark_box_main, osPriorityNormal, BOX_STACK_SIZE);
+UVISOR_BOX_CONFIG(benchmark_box, BOX_STACK_SIZE);
+
+UVISOR_BOX_RPC_GATEWAY_SYNC(benchmark_box, box_add_sync, box_add, uint32_t, uint32_t, uint32_t);
+UVISOR_BOX_RPC_GATEWAY_ASYNC(benchmark_box, box_add_async, box_add, uint32_t, uint32_t, uint32_t);
+UVISOR_BOX_RPC_GATEWAY_SYNC(benchmark_box, box_local_calls_sync, box_local_calls, uint32_t, uint32_t);
+
+static uint32_t box_add(uint32_t a, uint32_t b)
+{
+    return a + b;
+}
+
+// Calls into its own box through the gateway, which skips the RPC
+static uint32_t box_local_calls(uint32_t rounds)
+{
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < rounds; i++) {
+        uvisor_benchmark_start();
+        uint32_t sum = box_add_sync(i, 1);
+        uint32_t cycles = uvisor_benchmark_stop();
+        if (sum != i + 1) {
+            return 0;
+        }
+        total += cycles;
+    }
+    return total / rounds;
+}
+
+static void benchmark_box_main(const void *)
+{
+    static const TFN_Ptr targets[] = {
+        (TFN_Ptr) box_add,
+        (TFN_Ptr) box_local_calls,
+    };
+
+    while (1) {
+        rpc_fncall_waitfor(targets, sizeof(targets) / sizeof(targets[0]), NULL, UVISOR_WAIT_FOREVER);
+    }
+}
+
+
+struct latency {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+};
+
+static latency result;
+static uint32_t overhead;
+
+static void latency_reset(latency *l)
+{
+    l->min = UINT32_MAX;
+    l->max = 0;
+    l->sum = 0;
+    l->count = 0;
+}
+
+static void latency_add(latency *l, uint32_t cycles)
+{
+    cycles = cycles > overhead ? cycles - overhead : 0;
+    if (cycles < l->min) {
+        l->min = cycles;
+    }
+    if (cycles > l->max) {
+        l->max = cycles;
+    }
+    l->sum += cycles;
+    l->count++;
+}
+
+static void latency_print(const char *name, const latency *l)
+{
+    TEST_ASSERT_TRUE_MESSAGE(l->count > 0, name);
+    printf("MBED: benchmark %-28s min %8lu avg %8lu max %8lu cycles\r\n", name,
+           (unsigned long)l->min, (unsigned long)(l->sum / l->count),
+           (unsigned long)l->max);
+}
+
+
+// The cost of the measurement itself, two secure calls
+void test_overhead()
+{
+    uvisor_benchmark_configure();
+
+    overhead = 0;
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        uvisor_benchmark_start();
+        latency_add(&result, uvisor_benchmark_stop());
+    }
+    latency_print("measurement", &result);
+    overhead = result.min;
+}
+
+// A secure call into uVisor and back, without switching boxes
+void test_secure_call()
+{
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        uvisor_benchmark_start();
+        int id = uvisor_box_id_self();
+        latency_add(&result, uvisor_benchmark_stop());
+        TEST_ASSERT_EQUAL(0, id);
+    }
+    latency_print("secure call", &result);
+}
+
+// A synchronous RPC: queued, switching to the box and its thread, and back
+void test_rpc_sync()
+{
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        uvisor_benchmark_start();
+        uint32_t sum = box_add_sync(i, 2);
+        latency_add(&result, uvisor_benchmark_stop());
+        TEST_ASSERT_EQUAL_UINT32(i + 2, sum);
+    }
+    latency_print("rpc sync", &result);
+}
+
+// An asynchronous RPC, started then waited for
+void test_rpc_async()
+{
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        uint32_t sum = 0;
+        uvisor_benchmark_start();
+        uvisor_rpc_result_t call = box_add_async(i, 3);
+        int status = rpc_fncall_wait(call, UVISOR_WAIT_FOREVER, &sum);
+        latency_add(&result, uvisor_benchmark_stop());
+        TEST_ASSERT_EQUAL(0, status);
+        TEST_ASSERT_EQUAL_UINT32(i + 3, sum);
+    }
+    latency_print("rpc async", &result);
+}
+
+// A synchronous gateway called from the box of its target: a direct call
+// after checking the box ID, with no RPC
+void test_rpc_local()
+{
+    uint32_t cycles = box_local_calls_sync(BENCHMARK_ROUNDS);
+    TEST_ASSERT_NOT_EQUAL(0, cycles);
+
+    latency_reset(&result);
+    latency_add(&result, cycles);
+    latency_print("rpc sync from the box (avg)", &result);
+}
+
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(60, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Measurement overhead", test_overhead),
+    Case("Secure call", test_secure_call),
+    Case("Synchronous RPC", test_rpc_sync),
+    Case("Asynchronous RPC", test_rpc_async),
+    Case("Synchronous gateway within the box", test_rpc_local),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
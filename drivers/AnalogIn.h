@@ -110,6 +110,7 @@ public:
     }
 
 protected:
+    friend class AnalogInStream;
 
     virtual void lock() {
         _mutex->lock();
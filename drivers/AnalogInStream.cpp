@@ -0,0 +1,82 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/AnalogInStream.h"
+#include "drivers/AnalogIn.h"
+#include "platform/critical.h"
+#include "platform/mbed_assert.h"
+
+#if DEVICE_ANALOGIN_ASYNCH
+
+namespace mbed {
+
+AnalogInStream::AnalogInStream(PinName pin) : _count(0), _irq(this) {
+    init(&pin, 1);
+}
+
+AnalogInStream::AnalogInStream(const PinName *pins, int count) : _count(0), _irq(this) {
+    init(pins, count);
+}
+
+AnalogInStream::~AnalogInStream() {
+    stop();
+}
+
+void AnalogInStream::init(const PinName *pins, int count) {
+    MBED_ASSERT(count > 0 && count <= ANALOGIN_STREAM_MAX_CHANNELS);
+
+    // analogin_init shares the ADC state with AnalogIn
+    AnalogIn::_mutex->lock();
+    for (int i = 0; i < count; i++) {
+        analogin_init(&_adc[i], pins[i]);
+        _channels[i] = &_adc[i];
+    }
+    _count = count;
+    AnalogIn::_mutex->unlock();
+}
+
+int AnalogInStream::start(uint16_t *buffer, size_t length, uint32_t hz, const event_callback_t &callback, int event) {
+    AnalogIn::_mutex->lock();
+    if (analogin_stream_active(_channels[0])) {
+        AnalogIn::_mutex->unlock();
+        return -1;
+    }
+    _callback = callback;
+    _irq.callback(&AnalogInStream::irq_handler_asynch);
+    int ret = analogin_stream_start(_channels, _count, buffer, length, hz, _irq.entry(), event);
+    AnalogIn::_mutex->unlock();
+    return ret;
+}
+
+void AnalogInStream::stop() {
+    core_util_critical_section_enter();
+    analogin_stream_stop(_channels[0]);
+    core_util_critical_section_exit();
+}
+
+bool AnalogInStream::active() {
+    return analogin_stream_active(_channels[0]);
+}
+
+void AnalogInStream::irq_handler_asynch(void) {
+    int event = analogin_stream_irq_handler(_channels[0]);
+    if (_callback && event) {
+        _callback.call(event);
+    }
+}
+
+} // namespace mbed
+
+#endif
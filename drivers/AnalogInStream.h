@@ -0,0 +1,132 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_ANALOGINSTREAM_H
+#define MBED_ANALOGINSTREAM_H
+
+#include "platform/platform.h"
+
+#if DEVICE_ANALOGIN_ASYNCH
+
+#include "hal/analogin_api.h"
+#include "platform/CThunk.h"
+#include "platform/FunctionPointer.h"
+
+/** Most channels sampled by one stream */
+#define ANALOGIN_STREAM_MAX_CHANNELS    8
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+/** Analog inputs sampled at a fixed rate into a double buffer
+ *
+ *  A hardware timer triggers the conversion of all the channels and DMA
+ *  writes the samples, channel after channel, into a circular buffer. The
+ *  callback is called from interrupt context with
+ *  ANALOGIN_EVENT_HALF_COMPLETE when the first half of the buffer is full,
+ *  and with ANALOGIN_EVENT_COMPLETE when the second half is, so each half
+ *  can be processed while the other one fills. Samples are at the scale of
+ *  AnalogIn::read_u16.
+ *
+ *  A half must be processed before the DMA comes back to it. The stream
+ *  stops with ANALOGIN_EVENT_ERROR if the ADC overruns.
+ *
+ * @Note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * const PinName pins[] = { A0, A1, A2 };
+ * AnalogInStream accel(pins, 3);
+ * uint16_t samples[3 * 2 * 256];
+ *
+ * void on_samples(int event) {
+ *     uint16_t *half = (event & ANALOGIN_EVENT_COMPLETE) ? &samples[3 * 256] : samples;
+ *     process_xyz(half, 256);
+ * }
+ *
+ * int main() {
+ *     accel.start(samples, sizeof(samples) / sizeof(samples[0]), 10000, on_samples);
+ * }
+ * @endcode
+ */
+class AnalogInStream {
+
+public:
+    /** Create a stream of one analog input
+     *
+     *  @param pin AnalogIn pin to connect to
+     */
+    AnalogInStream(PinName pin);
+
+    /** Create a stream of several analog inputs, on the same ADC
+     *
+     *  @param pins  AnalogIn pins to connect to, in the order of the samples
+     *  @param count Number of pins, up to ANALOGIN_STREAM_MAX_CHANNELS
+     */
+    AnalogInStream(const PinName *pins, int count);
+
+    virtual ~AnalogInStream();
+
+    /** Start sampling
+     *
+     *  @param buffer   Buffer of samples, stays in use until stop()
+     *  @param length   Number of samples in the buffer, a multiple of twice the number of channels
+     *  @param hz       Sampling rate of each channel
+     *  @param callback Called from interrupt context with the events
+     *  @param event    The logical OR of the events calling the callback
+     *  @return 0 if the stream started, -1 if it is already running or the
+     *          target cannot sample these channels at this rate
+     */
+    int start(uint16_t *buffer, size_t length, uint32_t hz, const event_callback_t &callback, int event = ANALOGIN_EVENT_ALL);
+
+    /** Stop sampling
+     */
+    void stop();
+
+    /** Check if the stream is running
+     *
+     *  @return true until stop() or an error
+     */
+    bool active();
+
+    /** Number of channels in each scan
+     *
+     *  @return The number of channels
+     */
+    int channels() const {
+        return _count;
+    }
+
+protected:
+    void init(const PinName *pins, int count);
+    void irq_handler_asynch(void);
+
+    analogin_t _adc[ANALOGIN_STREAM_MAX_CHANNELS];
+    analogin_t *_channels[ANALOGIN_STREAM_MAX_CHANNELS];
+    int _count;
+    CThunk<AnalogInStream> _irq;
+    event_callback_t _callback;
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
+
+/** @}*/
@@ -22,6 +22,11 @@
 
 #include "hal/analogout_api.h"
 #include "platform/PlatformMutex.h"
+#if DEVICE_ANALOGOUT_ASYNCH
+#include "platform/CThunk.h"
+#include "platform/FunctionPointer.h"
+#include "platform/critical.h"
+#endif
 
 namespace mbed {
 /** \addtogroup drivers */
@@ -57,7 +62,11 @@ public:
      *
      *  @param AnalogOut pin to connect to (18)
      */
-    AnalogOut(PinName pin) {
+    AnalogOut(PinName pin)
+#if DEVICE_ANALOGOUT_ASYNCH
+        : _irq(this)
+#endif
+    {
         analogout_init(&_dac, pin);
     }
 
@@ -123,12 +132,75 @@ public:
         return read();
     }
 
+#if DEVICE_ANALOGOUT_ASYNCH
+
+    /** Output a buffer of samples at a fixed rate
+     *
+     *  A hardware timer paces the samples and DMA feeds them, so the CPU is
+     *  free during the playback. A one-shot playback stops on the last sample
+     *  with ANALOGOUT_EVENT_COMPLETE. A circular one starts over at the end
+     *  of the buffer until stop(), and reports ANALOGOUT_EVENT_HALF_COMPLETE
+     *  and ANALOGOUT_EVENT_COMPLETE so each half can be refilled while the
+     *  other one plays. write() must not be used during a playback.
+     *
+     *  @param buffer   Samples at the scale of write_u16, stays in use until the playback stops
+     *  @param length   Number of samples in the buffer
+     *  @param hz       Output rate in samples per second
+     *  @param callback Called from interrupt context with the events
+     *  @param event    The logical OR of the events calling the callback
+     *  @param circular true to play the buffer in a loop
+     *  @return 0 if the playback started, -1 if one is already running or the
+     *          target cannot output at this rate
+     */
+    int play(const uint16_t *buffer, size_t length, uint32_t hz, const event_callback_t &callback,
+             int event = ANALOGOUT_EVENT_ALL, bool circular = false) {
+        lock();
+        if (analogout_stream_active(&_dac)) {
+            unlock();
+            return -1;
+        }
+        _callback = callback;
+        _irq.callback(&AnalogOut::irq_handler_asynch);
+        int ret = analogout_stream_start(&_dac, buffer, length, hz, circular, _irq.entry(), event);
+        unlock();
+        return ret;
+    }
+
+    /** Stop the playback, the output keeps its last value
+     */
+    void stop() {
+        core_util_critical_section_enter();
+        analogout_stream_stop(&_dac);
+        core_util_critical_section_exit();
+    }
+
+    /** Check if a playback is running
+     *
+     *  @return true until the playback completes or stop() is called
+     */
+    bool playing() {
+        return analogout_stream_active(&_dac);
+    }
+
+#endif
+
     virtual ~AnalogOut() {
-        // Do nothing
+#if DEVICE_ANALOGOUT_ASYNCH
+        stop();
+#endif
     }
 
 protected:
 
+#if DEVICE_ANALOGOUT_ASYNCH
+    void irq_handler_asynch(void) {
+        int event = analogout_stream_irq_handler(&_dac);
+        if (_callback && event) {
+            _callback.call(event);
+        }
+    }
+#endif
+
     virtual void lock() {
         _mutex.lock();
     }
@@ -139,6 +211,10 @@ protected:
 
     dac_t _dac;
     PlatformMutex _mutex;
+#if DEVICE_ANALOGOUT_ASYNCH
+    CThunk<AnalogOut> _irq;
+    event_callback_t _callback;
+#endif
 };
 
 } // namespace mbed
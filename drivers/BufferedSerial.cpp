@@ -0,0 +1,340 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/BufferedSerial.h"
+#include "platform/critical.h"
+#include "platform/mbed_assert.h"
+#include "platform/mbed_poll.h"
+#include "platform/mbed_sleep.h"
+#include <errno.h>
+#include <string.h>
+
+#if DEVICE_SERIAL
+
+namespace mbed {
+
+BufferedSerial::BufferedSerial(PinName tx, PinName rx, int baud, const char *name) :
+        SerialBase(tx, rx, baud), FileLike(name),
+        _rx_count(0), _rx_in(0), _rx_out(0), _rx_stalled(false),
+        _tx_count(0), _tx_in(0), _tx_out(0), _tx_len(0), _tx_active(false),
+        _blocking(true) {
+#if DEVICE_SERIAL_ASYNCH
+    set_dma_usage_tx(DMA_USAGE_OPPORTUNISTIC);
+#else
+    SerialBase::attach(callback(this, &BufferedSerial::tx_irq), TxIrq);
+    serial_irq_set(&_serial, (SerialIrq)TxIrq, 0);
+#endif
+
+    SerialBase::attach(callback(this, &BufferedSerial::rx_irq), RxIrq);
+}
+
+BufferedSerial::~BufferedSerial() {
+    // No lock can be used in destructor
+    SerialBase::attach(Callback<void()>(), RxIrq);
+#if DEVICE_SERIAL_ASYNCH
+    abort_write();
+#else
+    SerialBase::attach(Callback<void()>(), TxIrq);
+#endif
+}
+
+ssize_t BufferedSerial::write(const void *buffer, size_t length) {
+    const uint8_t *data = (const uint8_t *)buffer;
+    size_t written = 0;
+
+    lock();
+    while (written < length) {
+        if (!_blocking && _tx_count == TxBufferSize) {
+            break;
+        }
+
+        // wait for the transmitter to make room
+        wait_event(TxRoom);
+
+        size_t n = length - written;
+        if (n > TxBufferSize - _tx_count) {
+            n = TxBufferSize - _tx_count;
+        }
+        if (n > TxBufferSize - _tx_in) {
+            n = TxBufferSize - _tx_in;
+        }
+        memcpy(&_tx_buf[_tx_in], &data[written], n);
+        _tx_in = (_tx_in + n) % TxBufferSize;
+        core_util_atomic_incr_u32((uint32_t *)&_tx_count, n);
+        written += n;
+
+        core_util_critical_section_enter();
+        if (!_tx_active) {
+            start_tx();
+        }
+        core_util_critical_section_exit();
+    }
+    unlock();
+
+    if (written == 0 && length > 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    return written;
+}
+
+ssize_t BufferedSerial::read(void *buffer, size_t length) {
+    uint8_t *data = (uint8_t *)buffer;
+    size_t copied = 0;
+
+    lock();
+    if (!_blocking && length > 0 && _rx_count == 0) {
+        unlock();
+        errno = EAGAIN;
+        return -1;
+    }
+
+    // wait for at least one byte, then take whatever has arrived
+    if (length > 0) {
+        wait_event(RxData);
+    }
+
+    while (copied < length) {
+        const void *span;
+        ssize_t n = peek(&span);
+        if (n <= 0) {
+            break;
+        }
+        if ((size_t)n > length - copied) {
+            n = length - copied;
+        }
+        memcpy(&data[copied], span, n);
+        consume(n);
+        copied += n;
+    }
+    unlock();
+
+    return copied;
+}
+
+ssize_t BufferedSerial::peek(const void **data) {
+    lock();
+    size_t count = _rx_count;
+    if (count > RxBufferSize - _rx_out) {
+        count = RxBufferSize - _rx_out;
+    }
+    *data = &_rx_buf[_rx_out];
+    unlock();
+    return count;
+}
+
+void BufferedSerial::consume(size_t length) {
+    lock();
+    if (length > _rx_count) {
+        length = _rx_count;
+    }
+    _rx_out = (_rx_out + length) % RxBufferSize;
+    core_util_atomic_decr_u32((uint32_t *)&_rx_count, length);
+
+    if (_rx_stalled) {
+        // the receiver stopped on a full ring, restart it now there is room
+        core_util_critical_section_enter();
+        _rx_stalled = false;
+        serial_irq_set(&_serial, (SerialIrq)RxIrq, 1);
+        core_util_critical_section_exit();
+    }
+    unlock();
+}
+
+size_t BufferedSerial::readable() const {
+    return _rx_count;
+}
+
+size_t BufferedSerial::writeable() const {
+    return TxBufferSize - _tx_count;
+}
+
+int BufferedSerial::close() {
+    return 0;
+}
+
+int BufferedSerial::isatty() {
+    return 1;
+}
+
+off_t BufferedSerial::lseek(off_t offset, int whence) {
+    return -1;
+}
+
+int BufferedSerial::fsync() {
+    lock();
+    wait_event(TxIdle);
+    unlock();
+    return 0;
+}
+
+int BufferedSerial::set_blocking(bool blocking) {
+    _blocking = blocking;
+    return 0;
+}
+
+bool BufferedSerial::is_blocking() const {
+    return _blocking;
+}
+
+short BufferedSerial::poll(short events) const {
+    short revents = 0;
+    if (_rx_count > 0) {
+        revents |= POLLIN;
+    }
+    if (_tx_count < TxBufferSize) {
+        revents |= POLLOUT;
+    }
+    return revents & events;
+}
+
+void BufferedSerial::sigio(Callback<void()> func) {
+    core_util_critical_section_enter();
+    _sigio = func;
+    core_util_critical_section_exit();
+}
+
+// Called from interrupt context, when data arrived or room was freed
+void BufferedSerial::wake(uint32_t events) {
+#ifdef MBED_CONF_RTOS_PRESENT
+    _events.set(events);
+#endif
+    if (_sigio) {
+        _sigio();
+    }
+    poll_wake();
+}
+
+bool BufferedSerial::event_pending(uint32_t event) const {
+    switch (event) {
+        case RxData:
+            return _rx_count > 0;
+        case TxRoom:
+            return _tx_count < TxBufferSize;
+        default:
+            return !_tx_active;
+    }
+}
+
+// Called locked, returns locked once the event is pending. The lock is
+// released while sleeping, so other calls go on meanwhile.
+void BufferedSerial::wait_event(uint32_t event) {
+#ifdef MBED_CONF_RTOS_PRESENT
+    while (true) {
+        // clear first, so an interrupt after the check ends the wait
+        _events.clear(event);
+        if (event_pending(event)) {
+            break;
+        }
+        unlock();
+        _events.wait_any(event, osWaitForever, false);
+        lock();
+    }
+#else
+    // checked with interrupts masked, which still wake the core from sleep
+    core_util_critical_section_enter();
+    while (!event_pending(event)) {
+#if DEVICE_SLEEP
+        sleep_manager_sleep_auto();
+#endif
+        core_util_critical_section_exit();
+        core_util_critical_section_enter();
+    }
+    core_util_critical_section_exit();
+#endif
+}
+
+void BufferedSerial::lock() {
+    _mutex.lock();
+}
+
+void BufferedSerial::unlock() {
+    _mutex.unlock();
+}
+
+void BufferedSerial::rx_irq() {
+    bool received = false;
+    while (serial_readable(&_serial)) {
+        if (_rx_count == RxBufferSize) {
+            // leave the rest in the UART until the reader catches up
+            serial_irq_set(&_serial, (SerialIrq)RxIrq, 0);
+            _rx_stalled = true;
+            break;
+        }
+        _rx_buf[_rx_in] = serial_getc(&_serial);
+        _rx_in = (_rx_in + 1) % RxBufferSize;
+        core_util_atomic_incr_u32((uint32_t *)&_rx_count, 1);
+        received = true;
+    }
+
+    if (received) {
+        wake(RxData);
+    }
+}
+
+// Called with interrupts disabled or from interrupt context
+void BufferedSerial::start_tx() {
+    if (_tx_count == 0) {
+        _tx_active = false;
+        return;
+    }
+
+    _tx_active = true;
+#if DEVICE_SERIAL_ASYNCH
+    // send the longest contiguous span in one transfer
+    _tx_len = _tx_count;
+    if (_tx_len > TxBufferSize - _tx_out) {
+        _tx_len = TxBufferSize - _tx_out;
+    }
+    SerialBase::write(&_tx_buf[_tx_out], _tx_len,
+            callback(this, &BufferedSerial::tx_dma_done), SERIAL_EVENT_TX_COMPLETE);
+#else
+    serial_irq_set(&_serial, (SerialIrq)TxIrq, 1);
+#endif
+}
+
+#if DEVICE_SERIAL_ASYNCH
+void BufferedSerial::tx_dma_done(int event) {
+    _tx_out = (_tx_out + _tx_len) % TxBufferSize;
+    core_util_atomic_decr_u32((uint32_t *)&_tx_count, _tx_len);
+
+    start_tx();
+    wake(TxRoom | TxIdle);
+}
+#else
+void BufferedSerial::tx_irq() {
+    bool sent = false;
+    while (_tx_count > 0 && serial_writable(&_serial)) {
+        sent = true;
+        serial_putc(&_serial, _tx_buf[_tx_out]);
+        _tx_out = (_tx_out + 1) % TxBufferSize;
+        core_util_atomic_decr_u32((uint32_t *)&_tx_count, 1);
+    }
+
+    if (_tx_count == 0) {
+        serial_irq_set(&_serial, (SerialIrq)TxIrq, 0);
+        _tx_active = false;
+    }
+
+    if (sent) {
+        wake(TxRoom | TxIdle);
+    }
+}
+#endif
+
+} // namespace mbed
+
+#endif
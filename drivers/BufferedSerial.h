@@ -0,0 +1,227 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_BUFFEREDSERIAL_H
+#define MBED_BUFFEREDSERIAL_H
+
+#include "platform/platform.h"
+
+#if DEVICE_SERIAL
+
+#include "drivers/SerialBase.h"
+#include "drivers/FileLike.h"
+#include "platform/PlatformMutex.h"
+#include "hal/serial_api.h"
+#ifdef MBED_CONF_RTOS_PRESENT
+#include "rtos/EventFlags.h"
+#endif
+
+#ifndef MBED_CONF_DRIVERS_BUFFERED_SERIAL_RXBUF_SIZE
+#define MBED_CONF_DRIVERS_BUFFERED_SERIAL_RXBUF_SIZE 256
+#endif
+
+#ifndef MBED_CONF_DRIVERS_BUFFERED_SERIAL_TXBUF_SIZE
+#define MBED_CONF_DRIVERS_BUFFERED_SERIAL_TXBUF_SIZE 256
+#endif
+
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+/** A serial port with receive and transmit ring buffers
+ *
+ *  Reception is done in interrupt context straight into the receive ring.
+ *  Transmission drains the transmit ring by DMA where available, one
+ *  contiguous span per transfer. Blocking calls sleep until the interrupt
+ *  handlers make progress, without holding the port against other callers.
+ *
+ *  Received data can be read without copying with peek() and consume(),
+ *  or through the FileHandle interface, so a BufferedSerial can be opened
+ *  with fopen("/name", ...) when given a name. In non-blocking mode it
+ *  can be serviced along with other devices by mbed::poll().
+ *
+ * @Note Synchronization level: Thread safe
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * BufferedSerial modem(PTC17, PTC16, 921600);
+ *
+ * int main() {
+ *     while (1) {
+ *         const void *data;
+ *         ssize_t size = modem.peek(&data);
+ *         if (size > 0) {
+ *             handle_bytes(data, size);
+ *             modem.consume(size);
+ *         }
+ *     }
+ * }
+ * @endcode
+ */
+class BufferedSerial : private SerialBase, public FileLike {
+
+public:
+    /** Create a BufferedSerial port, connected to the specified transmit and receive pins
+     *
+     *  @param tx Transmit pin
+     *  @param rx Receive pin
+     *  @param baud The baud rate of the serial port
+     *  @param name The name of the port, used to open it with fopen (optional)
+     */
+    BufferedSerial(PinName tx, PinName rx, int baud = MBED_CONF_PLATFORM_DEFAULT_SERIAL_BAUD_RATE, const char *name = NULL);
+
+    virtual ~BufferedSerial();
+
+    using SerialBase::baud;
+    using SerialBase::format;
+    using SerialBase::send_break;
+#if DEVICE_SERIAL_FC
+    using SerialBase::set_flow_control;
+#endif
+
+    /** Write data to the transmit ring, blocking while it is full
+     *
+     *  In non-blocking mode only the data which fits is written.
+     *
+     *  @param buffer The data to write
+     *  @param length The number of bytes to write
+     *
+     *  @returns The number of bytes written, -1 with errno set to EAGAIN
+     *  in non-blocking mode if the ring is full
+     */
+    virtual ssize_t write(const void *buffer, size_t length);
+
+    /** Read data from the receive ring, blocking until at least one byte is available
+     *
+     *  @param buffer The buffer to read into
+     *  @param length The maximum number of bytes to read
+     *
+     *  @returns The number of bytes read, -1 with errno set to EAGAIN in
+     *  non-blocking mode if nothing was received
+     */
+    virtual ssize_t read(void *buffer, size_t length);
+
+    /** Get the longest contiguous span of received data without copying it
+     *
+     *  The span stays valid until consume() is called.
+     *
+     *  @param data Set to point at the first received byte
+     *
+     *  @returns The number of bytes in the span, 0 if nothing was received
+     */
+    ssize_t peek(const void **data);
+
+    /** Release received data previously returned by peek()
+     *
+     *  @param length The number of bytes to release from the start of the span
+     */
+    void consume(size_t length);
+
+    /** Number of received bytes waiting to be read
+     *
+     *  @returns The number of bytes in the receive ring
+     */
+    size_t readable() const;
+
+    /** Free space in the transmit ring
+     *
+     *  @returns The number of bytes that can be written without blocking
+     */
+    size_t writeable() const;
+
+    virtual int close();
+    virtual int isatty();
+    virtual off_t lseek(off_t offset, int whence);
+
+    /** Wait until all buffered transmit data has been sent
+     *
+     *  @returns 0
+     */
+    virtual int fsync();
+
+    virtual int set_blocking(bool blocking);
+    virtual bool is_blocking() const;
+
+    /** Check if the receive ring has data, or the transmit ring room
+     */
+    virtual short poll(short events) const;
+
+    /** Register a callback on data received or transmit room freed
+     *
+     *  Called from interrupt context.
+     */
+    virtual void sigio(Callback<void()> func);
+
+protected:
+    virtual void lock();
+    virtual void unlock();
+
+private:
+    static const size_t RxBufferSize = MBED_CONF_DRIVERS_BUFFERED_SERIAL_RXBUF_SIZE;
+    static const size_t TxBufferSize = MBED_CONF_DRIVERS_BUFFERED_SERIAL_TXBUF_SIZE;
+    // What the interrupt handlers signal to blocked calls
+    enum {
+        RxData = 1 << 0,
+        TxRoom = 1 << 1,
+        TxIdle = 1 << 2
+    };
+
+    void rx_irq();
+#if DEVICE_SERIAL_ASYNCH
+    void tx_dma_done(int event);
+#else
+    void tx_irq();
+#endif
+    void start_tx();
+    void wake(uint32_t events);
+    bool event_pending(uint32_t event) const;
+    void wait_event(uint32_t event);
+
+    uint8_t _rx_buf[RxBufferSize];
+    volatile uint32_t _rx_count;
+    uint32_t _rx_in;
+    uint32_t _rx_out;
+    volatile bool _rx_stalled;
+
+    uint8_t _tx_buf[TxBufferSize];
+    volatile uint32_t _tx_count;
+    uint32_t _tx_in;
+    uint32_t _tx_out;
+    uint32_t _tx_len;
+    volatile bool _tx_active;
+
+    bool _blocking;
+    Callback<void()> _sigio;
+
+    PlatformMutex _mutex;
+#ifdef MBED_CONF_RTOS_PRESENT
+    rtos::EventFlags _events;
+#endif
+
+    /* disallow copy constructor and assignment operators */
+    BufferedSerial(const BufferedSerial&);
+    BufferedSerial & operator = (const BufferedSerial&);
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
+
+/** @}*/
@@ -29,6 +29,9 @@ BusIn::BusIn(PinName p0, PinName p1, PinName p2, PinName p3, PinName p4, PinName
             _nc_mask |= (1 << i);
         }
     }
+#if DEVICE_PORTIN
+    _ports.init(pins, PIN_INPUT);
+#endif
 }
 
 BusIn::BusIn(PinName pins[16]) {
@@ -40,6 +43,9 @@ BusIn::BusIn(PinName pins[16]) {
             _nc_mask |= (1 << i);
         }
     }
+#if DEVICE_PORTIN
+    _ports.init(pins, PIN_INPUT);
+#endif
 }
 
 BusIn::~BusIn() {
@@ -54,8 +60,14 @@ BusIn::~BusIn() {
 int BusIn::read() {
     int v = 0;
     lock();
+    int per_pin = _nc_mask;
+#if DEVICE_PORTIN
+    // The pins on a port are sampled together
+    v = _ports.read();
+    per_pin &= ~_ports.mask();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (per_pin & (1 << i)) {
             v |= _pin[i]->read() << i;
         }
     }
@@ -65,8 +77,13 @@ int BusIn::read() {
 
 void BusIn::mode(PinMode pull) {
     lock();
+    int per_pin = _nc_mask;
+#if DEVICE_PORTIN
+    _ports.mode(pull);
+    per_pin &= ~_ports.mask();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (per_pin & (1 << i)) {
             _pin[i]->mode(pull);
         }
     }
@@ -19,6 +19,7 @@
 #include "platform/platform.h"
 #include "drivers/DigitalIn.h"
 #include "platform/PlatformMutex.h"
+#include "drivers/BusPorts.h"
 
 namespace mbed {
 /** \addtogroup drivers */
@@ -93,6 +94,11 @@ protected:
 
     PlatformMutex _mutex;
 
+#if DEVICE_PORTIN
+    /** Pins of the bus grouped by port, accessed together */
+    BusPorts _ports;
+#endif
+
     /* disallow copy constructor and assignment operators */
 private:
     virtual void lock();
@@ -29,6 +29,9 @@ BusInOut::BusInOut(PinName p0, PinName p1, PinName p2, PinName p3, PinName p4, P
             _nc_mask |= (1 << i);
         }
     }
+#if DEVICE_PORTINOUT
+    _ports.init(pins, PIN_INPUT);
+#endif
 }
 
 BusInOut::BusInOut(PinName pins[16]) {
@@ -40,6 +43,9 @@ BusInOut::BusInOut(PinName pins[16]) {
             _nc_mask |= (1 << i);
         }
     }
+#if DEVICE_PORTINOUT
+    _ports.init(pins, PIN_INPUT);
+#endif
 }
 
 BusInOut::~BusInOut() {
@@ -53,8 +59,14 @@ BusInOut::~BusInOut() {
 
 void BusInOut::write(int value) {
     lock();
+    int per_pin = _nc_mask;
+#if DEVICE_PORTINOUT
+    // The pins on a port change together
+    _ports.write(value);
+    per_pin &= ~_ports.mask();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (per_pin & (1 << i)) {
             _pin[i]->write((value >> i) & 1);
         }
     }
@@ -64,8 +76,13 @@ void BusInOut::write(int value) {
 int BusInOut::read() {
     lock();
     int v = 0;
+    int per_pin = _nc_mask;
+#if DEVICE_PORTINOUT
+    v = _ports.read();
+    per_pin &= ~_ports.mask();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (per_pin & (1 << i)) {
             v |= _pin[i]->read() << i;
         }
     }
@@ -75,8 +92,13 @@ int BusInOut::read() {
 
 void BusInOut::output() {
     lock();
+    int per_pin = _nc_mask;
+#if DEVICE_PORTINOUT
+    _ports.dir(PIN_OUTPUT);
+    per_pin &= ~_ports.mask();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (per_pin & (1 << i)) {
             _pin[i]->output();
         }
     }
@@ -85,8 +107,13 @@ void BusInOut::output() {
 
 void BusInOut::input() {
     lock();
+    int per_pin = _nc_mask;
+#if DEVICE_PORTINOUT
+    _ports.dir(PIN_INPUT);
+    per_pin &= ~_ports.mask();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (per_pin & (1 << i)) {
             _pin[i]->input();
         }
     }
@@ -95,8 +122,13 @@ void BusInOut::input() {
 
 void BusInOut::mode(PinMode pull) {
     lock();
+    int per_pin = _nc_mask;
+#if DEVICE_PORTINOUT
+    _ports.mode(pull);
+    per_pin &= ~_ports.mask();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (per_pin & (1 << i)) {
             _pin[i]->mode(pull);
         }
     }
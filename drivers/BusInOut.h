@@ -18,6 +18,7 @@
 
 #include "drivers/DigitalInOut.h"
 #include "platform/PlatformMutex.h"
+#include "drivers/BusPorts.h"
 
 namespace mbed {
 /** \addtogroup drivers */
@@ -114,6 +115,11 @@ protected:
 
     PlatformMutex _mutex;
 
+#if DEVICE_PORTINOUT
+    /** Pins of the bus grouped by port, accessed together */
+    BusPorts _ports;
+#endif
+
     /* disallow copy constructor and assignment operators */
 private:
     BusInOut(const BusInOut&);
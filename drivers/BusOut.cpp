@@ -29,6 +29,9 @@ BusOut::BusOut(PinName p0, PinName p1, PinName p2, PinName p3, PinName p4, PinNa
             _nc_mask |= (1 << i);
         }
     }
+#if DEVICE_PORTOUT
+    _ports.init(pins, PIN_OUTPUT);
+#endif
 }
 
 BusOut::BusOut(PinName pins[16]) {
@@ -40,6 +43,9 @@ BusOut::BusOut(PinName pins[16]) {
             _nc_mask |= (1 << i);
         }
     }
+#if DEVICE_PORTOUT
+    _ports.init(pins, PIN_OUTPUT);
+#endif
 }
 
 BusOut::~BusOut() {
@@ -53,8 +59,14 @@ BusOut::~BusOut() {
 
 void BusOut::write(int value) {
     lock();
+    int per_pin = _nc_mask;
+#if DEVICE_PORTOUT
+    // The pins on a port change together
+    _ports.write(value);
+    per_pin &= ~_ports.mask();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (per_pin & (1 << i)) {
             _pin[i]->write((value >> i) & 1);
         }
     }
@@ -64,8 +76,13 @@ void BusOut::write(int value) {
 int BusOut::read() {
     lock();
     int v = 0;
+    int per_pin = _nc_mask;
+#if DEVICE_PORTOUT
+    v = _ports.read();
+    per_pin &= ~_ports.mask();
+#endif
     for (int i=0; i<16; i++) {
-        if (_pin[i] != 0) {
+        if (per_pin & (1 << i)) {
             v |= _pin[i]->read() << i;
         }
     }
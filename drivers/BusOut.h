@@ -18,6 +18,7 @@
 
 #include "drivers/DigitalOut.h"
 #include "platform/PlatformMutex.h"
+#include "drivers/BusPorts.h"
 
 namespace mbed {
 /** \addtogroup drivers */
@@ -98,6 +99,11 @@ protected:
 
     PlatformMutex _mutex;
 
+#if DEVICE_PORTOUT
+    /** Pins of the bus grouped by port, accessed together */
+    BusPorts _ports;
+#endif
+
    /* disallow copy constructor and assignment operators */
 private:
     BusOut(const BusOut&);
@@ -0,0 +1,144 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/BusPorts.h"
+
+#if DEVICE_PORTIN || DEVICE_PORTOUT
+
+namespace mbed {
+
+BusPorts::BusPorts() : _groups(0), _count(0), _mask(0) {
+}
+
+BusPorts::~BusPorts() {
+    delete[] _groups;
+}
+
+void BusPorts::init(const PinName pins[16], PinDirection dir) {
+    PortName ports[16];
+    int port_masks[16];
+    int bus_masks[16];
+    int count = 0;
+
+    for (int i = 0; i < 16; i++) {
+        PortName port;
+        _bit[i] = -1;
+        if (pins[i] == NC) {
+            continue;
+        }
+        int bit = port_pin_bit(pins[i], &port);
+        if (bit < 0) {
+            continue;
+        }
+        int g = 0;
+        while (g < count && ports[g] != port) {
+            g++;
+        }
+        if (g == count) {
+            ports[g] = port;
+            port_masks[g] = 0;
+            bus_masks[g] = 0;
+            count++;
+        }
+        port_masks[g] |= 1U << bit;
+        bus_masks[g] |= 1 << i;
+        _bit[i] = bit;
+    }
+
+    if (count == 0) {
+        return;
+    }
+    _groups = new Group[count];
+    _count = count;
+    for (int g = 0; g < count; g++) {
+        Group &group = _groups[g];
+        group.bus_mask = bus_masks[g];
+        group.shift = 0;
+        group.in_order = true;
+        bool first = true;
+        for (int i = 0; i < 16; i++) {
+            if (!(bus_masks[g] & (1 << i))) {
+                continue;
+            }
+            if (first) {
+                group.shift = _bit[i] - i;
+                first = false;
+            } else if (_bit[i] - i != group.shift) {
+                group.in_order = false;
+            }
+        }
+        port_init(&group.port, ports[g], port_masks[g], dir);
+        _mask |= bus_masks[g];
+    }
+}
+
+int BusPorts::to_port(const Group &group, int value) const {
+    value &= group.bus_mask;
+    if (group.in_order) {
+        return (group.shift >= 0) ? (int)((unsigned)value << group.shift) : (value >> -group.shift);
+    }
+    int v = 0;
+    for (int i = 0; i < 16; i++) {
+        if (group.bus_mask & (1 << i)) {
+            v |= (int)(((unsigned)value >> i & 1) << _bit[i]);
+        }
+    }
+    return v;
+}
+
+int BusPorts::from_port(const Group &group, int value) const {
+    if (group.in_order) {
+        unsigned u = (unsigned)value;
+        u = (group.shift >= 0) ? (u >> group.shift) : (u << -group.shift);
+        return (int)u & group.bus_mask;
+    }
+    int v = 0;
+    for (int i = 0; i < 16; i++) {
+        if (group.bus_mask & (1 << i)) {
+            v |= (int)((unsigned)value >> _bit[i] & 1) << i;
+        }
+    }
+    return v;
+}
+
+void BusPorts::write(int value) {
+    for (int g = 0; g < _count; g++) {
+        port_write(&_groups[g].port, to_port(_groups[g], value));
+    }
+}
+
+int BusPorts::read() {
+    int v = 0;
+    for (int g = 0; g < _count; g++) {
+        v |= from_port(_groups[g], port_read(&_groups[g].port));
+    }
+    return v;
+}
+
+void BusPorts::dir(PinDirection direction) {
+    for (int g = 0; g < _count; g++) {
+        port_dir(&_groups[g].port, direction);
+    }
+}
+
+void BusPorts::mode(PinMode pull) {
+    for (int g = 0; g < _count; g++) {
+        port_mode(&_groups[g].port, pull);
+    }
+}
+
+} // namespace mbed
+
+#endif
@@ -0,0 +1,100 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_BUSPORTS_H
+#define MBED_BUSPORTS_H
+
+#include "platform/platform.h"
+
+#if DEVICE_PORTIN || DEVICE_PORTOUT
+
+#include "hal/port_api.h"
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+/** The GPIO ports behind the pins of a bus, used by BusOut, BusIn and BusInOut
+ *
+ *  The pins of the bus on the same port are accessed with one port
+ *  operation, so they change together. Bus bits on no known port are left
+ *  out of mask() for the bus to access pin by pin.
+ *
+ * @Note Synchronization level: Not protected
+ */
+class BusPorts {
+
+public:
+    BusPorts();
+    ~BusPorts();
+
+    /** Group the pins of a bus by port
+     *
+     *  @param pins Pin of each bus bit, NC for none
+     *  @param dir  Initial direction of the pins
+     */
+    void init(const PinName pins[16], PinDirection dir);
+
+    /** Bus bits accessed through ports
+     */
+    int mask() const {
+        return _mask;
+    }
+
+    /** Write the bus bits of mask()
+     */
+    void write(int value);
+
+    /** Read the bus bits of mask()
+     */
+    int read();
+
+    /** Set the direction of the bus bits of mask()
+     */
+    void dir(PinDirection direction);
+
+    /** Set the input mode of the bus bits of mask()
+     */
+    void mode(PinMode pull);
+
+private:
+    struct Group {
+        port_t port;
+        int bus_mask;
+        // port bit = bus bit + shift, when the bits are in order
+        int shift;
+        bool in_order;
+    };
+
+    int to_port(const Group &group, int value) const;
+    int from_port(const Group &group, int value) const;
+
+    Group *_groups;
+    int _count;
+    int _mask;
+    signed char _bit[16];
+
+    /* disallow copy constructor and assignment operators */
+    BusPorts(const BusPorts&);
+    BusPorts & operator = (const BusPorts&);
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
+
+/** @}*/
@@ -18,12 +18,17 @@
 #if DEVICE_CAN
 
 #include "cmsis.h"
+#include "hal/us_ticker_api.h"
 
 namespace mbed {
 
 static void donothing() {}
 
-CAN::CAN(PinName rd, PinName td) : _can(), _irq() {
+CAN::CAN(PinName rd, PinName td) : _can(), _irq()
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+        , _rx_dropped(0)
+#endif
+{
     // No lock needed in constructor
 
     for (int i = 0; i < sizeof _irq / sizeof _irq[0]; i++) {
@@ -32,6 +37,10 @@ CAN::CAN(PinName rd, PinName td) : _can(), _irq() {
 
     can_init(&_can, rd, td);
     can_irq_init(&_can, (&CAN::_irq_handler), (uint32_t)this);
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    // the buffer takes every message
+    can_irq_set(&_can, IRQ_RX, 1);
+#endif
 }
 
 CAN::~CAN() {
@@ -55,12 +64,27 @@ int CAN::write(CANMessage msg) {
 }
 
 int CAN::read(CANMessage &msg, int handle) {
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    if (handle == 0) {
+        return _rx_buffer.pop(msg) ? 1 : 0;
+    }
+#endif
     lock();
     int ret = can_read(&_can, &msg, handle);
     unlock();
     return ret;
 }
 
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+int CAN::read(CANMessage *msgs, int count) {
+    int n = 0;
+    while (n < count && _rx_buffer.pop(msgs[n])) {
+        n++;
+    }
+    return n;
+}
+#endif
+
 void CAN::reset() {
     lock();
     can_reset(&_can);
@@ -101,6 +125,20 @@ int CAN::filter(unsigned int id, unsigned int mask, CANFormat format, int handle
     return ret;
 }
 
+int CAN::filter_banks() {
+    lock();
+    int ret = can_filter_banks(&_can);
+    unlock();
+    return ret;
+}
+
+int CAN::filter_bank(int bank, unsigned int id, unsigned int mask, CANFormat format, FilterMode mode) {
+    lock();
+    int ret = can_filter_bank(&_can, bank, (CanFilterMode)mode, id, mask, format);
+    unlock();
+    return ret;
+}
+
 void CAN::attach(Callback<void()> func, IrqType type) {
     lock();
     if (func) {
@@ -108,6 +146,10 @@ void CAN::attach(Callback<void()> func, IrqType type) {
         can_irq_set(&_can, (CanIrqType)type, 1);
     } else {
         _irq[(CanIrqType)type].attach(donothing);
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+        // the buffer still needs the receive interrupt
+        if (type != RxIrq)
+#endif
         can_irq_set(&_can, (CanIrqType)type, 0);
     }
     unlock();
@@ -115,6 +157,20 @@ void CAN::attach(Callback<void()> func, IrqType type) {
 
 void CAN::_irq_handler(uint32_t id, CanIrqType type) {
     CAN *handler = (CAN*)id;
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    if (type == IRQ_RX) {
+        // the interrupt stays pending while messages are, one at a time
+        CANMessage msg;
+        if (can_read(&handler->_can, &msg, 0)) {
+            msg.timestamp = us_ticker_read();
+            if (handler->_rx_buffer.full()) {
+                handler->_rx_dropped++;
+            } else {
+                handler->_rx_buffer.push(msg);
+            }
+        }
+    }
+#endif
     handler->_irq[type].call();
 }
 
@@ -23,6 +23,9 @@
 #include "hal/can_api.h"
 #include "platform/Callback.h"
 #include "platform/PlatformMutex.h"
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+#include "platform/CircularBuffer.h"
+#endif
 
 namespace mbed {
 /** \addtogroup drivers */
@@ -43,6 +46,7 @@ public:
         format = CANStandard;
         id     = 0;
         memset(data, 0, 8);
+        timestamp = 0;
     }
 
     /** Creates CAN message with specific content.
@@ -53,6 +57,7 @@ public:
       format = _format;
       id     = _id;
       memcpy(data, _data, _len);
+      timestamp = 0;
     }
 
     /** Creates CAN remote message.
@@ -63,7 +68,11 @@ public:
       format = _format;
       id     = _id;
       memset(data, 0, 8);
+      timestamp = 0;
     }
+
+    /** us ticker time the message was received at, by the RX buffer of CAN */
+    unsigned int timestamp;
 };
 
 /** A can bus client, used for communicating with can devices
@@ -143,6 +152,29 @@ public:
      */
     int read(CANMessage &msg, int handle = 0);
 
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    /** Read the messages received into the RX buffer
+     *
+     *  With drivers.can-rx-buffer-size, the receive interrupt moves each
+     *  message into a buffer with its timestamp, and read(msg) with handle 0
+     *  also takes them from there. Interrupt safe.
+     *
+     *  @param msgs  Array to read to
+     *  @param count Most messages to read
+     *
+     *  @returns
+     *    Number of messages read, 0 if none arrived
+     */
+    int read(CANMessage *msgs, int count);
+
+    /** Number of messages lost since the CAN was created, as the RX
+     *  buffer was full
+     */
+    unsigned int rx_dropped() const {
+        return _rx_dropped;
+    }
+#endif
+
     /** Reset CAN interface.
      *
      * To use after error overflow.
@@ -187,6 +219,37 @@ public:
      */
     int filter(unsigned int id, unsigned int mask, CANFormat format = CANAny, int handle = 0);
 
+    enum FilterMode {
+        FilterOff = CAN_FILTER_OFF,
+        FilterMask = CAN_FILTER_MASK,
+        FilterList = CAN_FILTER_LIST
+    };
+
+    /** Number of hardware filter banks
+     *
+     *  @returns
+     *    Number of banks filter_bank can set, 0 if the target has none
+     */
+    int filter_banks();
+
+    /** Set a hardware filter bank
+     *
+     *  Messages that no bank in use accepts never reach the CPU, so busy
+     *  buses cost no interrupts for them.
+     *
+     *  @param bank Bank from 0 to filter_banks() - 1
+     *  @param id First identifier
+     *  @param mask Bits of id which must match with CAN::FilterMask, the
+     *    second identifier to accept with CAN::FilterList
+     *  @param format Format of the identifiers, CANAny matches both with CAN::FilterMask
+     *  @param mode CAN::FilterMask, CAN::FilterList or CAN::FilterOff to turn the bank off
+     *
+     *  @returns
+     *    0 if the bank or the mode is not supported,
+     *    1 if the bank was set
+     */
+    int filter_bank(int bank, unsigned int id, unsigned int mask, CANFormat format = CANAny, FilterMode mode = FilterMask);
+
     /** Returns number of read errors to detect read overflow errors.
      */
     unsigned char rderror();
@@ -251,6 +314,10 @@ protected:
     can_t               _can;
     Callback<void()>    _irq[IrqCnt];
     PlatformMutex       _mutex;
+#if MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE
+    CircularBuffer<CANMessage, MBED_CONF_DRIVERS_CAN_RX_BUFFER_SIZE> _rx_buffer;
+    unsigned int        _rx_dropped;
+#endif
 };
 
 } // namespace mbed
@@ -45,6 +45,22 @@ int Ethernet::read(char *data, int size) {
     return ethernet_read(data, size);
 }
 
+void *Ethernet::tx_acquire(int *size) {
+    return ethernet_tx_acquire(size);
+}
+
+int Ethernet::tx_send(void *buffer, int size) {
+    return ethernet_tx_send(buffer, size);
+}
+
+void *Ethernet::rx_acquire(int *size) {
+    return ethernet_rx_acquire(size);
+}
+
+void Ethernet::rx_release(void *buffer) {
+    ethernet_rx_release(buffer);
+}
+
 void Ethernet::address(char *mac) {
     return ethernet_address(mac);
 }
@@ -123,6 +123,46 @@ public:
      */
     int read(char *data, int size);
 
+    /** Gets the driver buffer of the next outgoing ethernet packet, to fill in place.
+     *  The packet is sent with tx_send, without copying it, on targets which
+     *  hand out their DMA buffers. Only one buffer can be held at a time,
+     *  and it must not be mixed with write and send.
+     *
+     *  @param size Set to the capacity of the buffer.
+     *  @returns
+     *    A pointer to the buffer,
+     *    or NULL if no buffer is free.
+     */
+    void *tx_acquire(int *size);
+
+    /** Sends the packet filled in the buffer from tx_acquire.
+     *
+     *  @param buffer The buffer returned by tx_acquire.
+     *  @param size The size of the packet.
+     *  @returns
+     *    0 if the sending was failed,
+     *    or the size of the packet successfully sent.
+     */
+    int tx_send(void *buffer, int size);
+
+    /** Gets an arrived ethernet packet in the driver buffer, without copying it.
+     *  The buffer stays valid until it is released with rx_release, which
+     *  must be done before the next packet can be received. It must not be
+     *  mixed with receive and read.
+     *
+     *  @param size Set to the size of the packet.
+     *  @returns
+     *    A pointer to the packet,
+     *    or NULL if no ethernet packet is arrived.
+     */
+    void *rx_acquire(int *size);
+
+    /** Gives the buffer from rx_acquire back to the driver.
+     *
+     *  @param buffer The buffer returned by rx_acquire.
+     */
+    void rx_release(void *buffer);
+
     /** Gives the ethernet address of the mbed.
      *
      *  @param mac Must be a pointer to a 6 byte char array to copy the ethernet address in.
@@ -0,0 +1,104 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_FASTDIGITALIN_H
+#define MBED_FASTDIGITALIN_H
+
+#include "platform/platform.h"
+#include "hal/gpio_api.h"
+#include "platform/critical.h"
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+/** A digital input bound to its pin at compile time
+ *
+ * On targets providing the pin-bound GPIO access of gpio_api.h, read()
+ * comes down to a single load of the port register, resolved by the
+ * compiler. On the other targets it behaves as a DigitalIn.
+ *
+ * @Note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * // Sample a clocked data line
+ * #include "mbed.h"
+ *
+ * FastDigitalIn<p5> clk;
+ * FastDigitalIn<p6, PullUp> data;
+ *
+ * int main() {
+ *     while(1) {
+ *         while (!clk);
+ *         printf("%d\n", data.read());
+ *         while (clk);
+ *     }
+ * }
+ * @endcode
+ */
+template <PinName Pin, PinMode Mode = PullDefault>
+class FastDigitalIn {
+
+public:
+    /** Create a FastDigitalIn connected to its pin, in its mode
+     */
+    FastDigitalIn() {
+        // No lock needed in the constructor
+#if GPIO_FAST
+        gpio_t gpio = gpio_t();
+#endif
+        gpio_init_in_ex(&gpio, Pin, Mode);
+    }
+
+    /** Read the input, represented as 0 or 1 (int)
+     *
+     *  @returns
+     *    An integer representing the state of the input pin,
+     *    0 for logical 0, 1 for logical 1
+     */
+    int read() {
+        // Thread safe / atomic HAL call
+#if GPIO_FAST
+        return gpio_fast_read(Pin);
+#else
+        return gpio_read(&gpio);
+#endif
+    }
+
+    /** An operator shorthand for read()
+     */
+    operator int() {
+        // Underlying read is thread safe
+        return read();
+    }
+
+private:
+    // NC has no port register to resolve
+    typedef char pin_is_connected[(Pin != NC) ? 1 : -1];
+
+#if !GPIO_FAST
+    gpio_t gpio;
+#endif
+
+    FastDigitalIn(const FastDigitalIn &);
+    FastDigitalIn &operator=(const FastDigitalIn &);
+};
+
+} // namespace mbed
+
+#endif
+
+/** @}*/
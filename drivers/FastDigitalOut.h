@@ -0,0 +1,139 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_FASTDIGITALOUT_H
+#define MBED_FASTDIGITALOUT_H
+
+#include "platform/platform.h"
+#include "hal/gpio_api.h"
+#include "platform/critical.h"
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+/** A digital output bound to its pin at compile time
+ *
+ * On targets providing the pin-bound GPIO access of gpio_api.h, the port
+ * register and the mask of the pin are resolved by the compiler, so that
+ * write() and toggle() come down to a single store, for bit-banged
+ * protocols or pins toggled from an interrupt. On the other targets it
+ * behaves as a DigitalOut.
+ *
+ * @Note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * // Toggle a LED as fast as possible
+ * #include "mbed.h"
+ *
+ * FastDigitalOut<LED1> led;
+ *
+ * int main() {
+ *     while(1) {
+ *         led.toggle();
+ *     }
+ * }
+ * @endcode
+ */
+template <PinName Pin>
+class FastDigitalOut {
+
+public:
+    /** Create a FastDigitalOut connected to its pin
+     *
+     *  @param value the initial pin value
+     */
+    FastDigitalOut(int value = 0) {
+        // No lock needed in the constructor
+#if GPIO_FAST
+        gpio_t gpio = gpio_t();
+#endif
+        gpio_init_out_ex(&gpio, Pin, value);
+    }
+
+    /** Set the output, specified as 0 or 1 (int)
+     *
+     *  @param value An integer specifying the pin output value,
+     *      0 for logical 0, 1 (or any other non-zero value) for logical 1
+     */
+    void write(int value) {
+        // Thread safe / atomic HAL call
+#if GPIO_FAST
+        gpio_fast_write(Pin, value);
+#else
+        gpio_write(&gpio, value);
+#endif
+    }
+
+    /** Return the output setting, represented as 0 or 1 (int)
+     *
+     *  @returns
+     *    an integer representing the output setting of the pin,
+     *    0 for logical 0, 1 for logical 1
+     */
+    int read() {
+        // Thread safe / atomic HAL call
+#if GPIO_FAST
+        return gpio_fast_read(Pin);
+#else
+        return gpio_read(&gpio);
+#endif
+    }
+
+    /** Invert the output
+     */
+    void toggle() {
+#if GPIO_FAST
+        gpio_fast_toggle(Pin);
+#else
+        core_util_critical_section_enter();
+        gpio_write(&gpio, !gpio_read(&gpio));
+        core_util_critical_section_exit();
+#endif
+    }
+
+    /** A shorthand for write()
+     */
+    FastDigitalOut& operator= (int value) {
+        // Underlying write is thread safe
+        write(value);
+        return *this;
+    }
+
+    /** A shorthand for read()
+     */
+    operator int() {
+        // Underlying call is thread safe
+        return read();
+    }
+
+private:
+    // NC has no port register to resolve
+    typedef char pin_is_connected[(Pin != NC) ? 1 : -1];
+
+#if !GPIO_FAST
+    gpio_t gpio;
+#endif
+
+    FastDigitalOut(const FastDigitalOut &);
+    FastDigitalOut &operator=(const FastDigitalOut &);
+};
+
+} // namespace mbed
+
+#endif
+
+/** @}*/
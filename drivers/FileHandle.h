@@ -28,6 +28,18 @@ typedef long off_t;
 #   include <sys/types.h>
 #endif
 
+#include "platform/Callback.h"
+
+/** Events reported by FileHandle::poll() and mbed::poll()
+ */
+#ifndef POLLIN
+#define POLLIN      0x0001  /**< Data can be read without blocking */
+#define POLLOUT     0x0004  /**< Data can be written without blocking */
+#define POLLERR     0x0008  /**< An error occurred, always reported */
+#define POLLHUP     0x0010  /**< The device was disconnected, always reported */
+#define POLLNVAL    0x0020  /**< The handle is invalid, always reported */
+#endif
+
 namespace mbed {
 /** \addtogroup drivers */
 /** @{*/
@@ -120,10 +132,87 @@ public:
         return res;
     }
 
+    /** Set blocking or non-blocking mode
+     *
+     *  In non-blocking mode read() and write() return -1 with errno set
+     *  to EAGAIN instead of waiting, when nothing can be transferred.
+     *
+     *  @param blocking true for blocking mode, false for non-blocking mode
+     *
+     *  @returns
+     *    0 on success,
+     *   -1 if the mode is not supported
+     */
+    virtual int set_blocking(bool blocking) {
+        return blocking ? 0 : -1;
+    }
+
+    /** Check the blocking mode
+     *
+     *  @returns true if the handle is in blocking mode
+     */
+    virtual bool is_blocking() const {
+        return true;
+    }
+
+    /** Check the events the handle is ready for
+     *
+     *  The default suits handles which never block, such as regular files.
+     *  Devices which can block report their true state, and call
+     *  mbed::poll_wake() whenever it changes.
+     *
+     *  @param events Mask of POLLIN and POLLOUT to check
+     *
+     *  @returns
+     *    Mask of the events ready, POLLERR, POLLHUP and POLLNVAL may be
+     *    set whatever was asked
+     */
+    virtual short poll(short events) const {
+        return events & (POLLIN | POLLOUT);
+    }
+
+    /** Check if data can be read without blocking
+     */
+    bool readable() const {
+        return poll(POLLIN) & POLLIN;
+    }
+
+    /** Check if data can be written without blocking
+     */
+    bool writable() const {
+        return poll(POLLOUT) & POLLOUT;
+    }
+
+    /** Register a callback on state changes
+     *
+     *  The callback is called, possibly from interrupt context, whenever
+     *  the handle may have become readable or writable, or hit an error.
+     *  It must not read or write itself, only signal a thread or queue an
+     *  event to do so. Handles which never block never call it.
+     *
+     *  @param func Function to call on state changes, or an empty callback
+     *              to stop the calls
+     */
+    virtual void sigio(Callback<void()> func) {
+        // Stub
+    }
+
     virtual ~FileHandle();
 
 protected:
 
+    /** Write the data buffered for this handle by the retarget layer
+     *
+     *  Files opened for writing with fopen have their small writes
+     *  gathered into a write-back buffer, see platform.file-buffer-size.
+     *  fclose writes it, a handle closed or destroyed otherwise must call
+     *  drain_buffer() first, as the FileHandle destructor can no longer
+     *  write it.
+     *
+     *  @returns 0 on success, -1 if the data could not be written
+     */
+    int drain_buffer();
+
     /** Acquire exclusive access to this object.
      */
     virtual void lock() {
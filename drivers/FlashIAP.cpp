@@ -0,0 +1,199 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/FlashIAP.h"
+#include <string.h>
+
+#if DEVICE_FLASH
+
+namespace mbed {
+
+SingletonPtr<PlatformMutex> FlashIAP::_mutex;
+
+FlashIAP::FlashIAP()
+#if DEVICE_FLASH_ASYNCH
+    : _irq(this),
+      _erase_addr(0),
+      _erase_end(0)
+#endif
+{
+    memset(&_flash, 0, sizeof(_flash));
+#if DEVICE_FLASH_ASYNCH
+    _irq.callback(&FlashIAP::irq_handler_asynch);
+#endif
+}
+
+FlashIAP::~FlashIAP() {
+}
+
+int FlashIAP::init() {
+    _mutex->lock();
+    int ret = flash_init(&_flash);
+    _mutex->unlock();
+    return ret ? -1 : 0;
+}
+
+int FlashIAP::deinit() {
+    _mutex->lock();
+    int ret = flash_free(&_flash);
+    _mutex->unlock();
+    return ret ? -1 : 0;
+}
+
+int FlashIAP::read(void *buffer, uint32_t addr, uint32_t size) {
+    uint32_t start = get_flash_start();
+    if (addr < start || size > get_flash_size() || addr - start > get_flash_size() - size) {
+        return -1;
+    }
+    // the flash is memory mapped
+    memcpy(buffer, (const void *)addr, size);
+    return 0;
+}
+
+int FlashIAP::program(const void *buffer, uint32_t addr, uint32_t size) {
+    _mutex->lock();
+    int ret = flash_program_page(&_flash, addr, static_cast<const uint8_t *>(buffer), size);
+    _mutex->unlock();
+    return ret ? -1 : 0;
+}
+
+int FlashIAP::erase(uint32_t addr, uint32_t size) {
+    if (!is_aligned_to_sectors(addr, size)) {
+        return -1;
+    }
+
+    int ret = 0;
+    _mutex->lock();
+    while (size && !ret) {
+        uint32_t sector = flash_get_sector_size(&_flash, addr);
+        ret = flash_erase_sector(&_flash, addr);
+        addr += sector;
+        size -= sector;
+    }
+    _mutex->unlock();
+    return ret ? -1 : 0;
+}
+
+uint32_t FlashIAP::get_page_size() const {
+    return flash_get_page_size(&_flash);
+}
+
+uint32_t FlashIAP::get_sector_size(uint32_t addr) const {
+    return flash_get_sector_size(&_flash, addr);
+}
+
+uint32_t FlashIAP::get_flash_start() const {
+    return flash_get_start_address(&_flash);
+}
+
+uint32_t FlashIAP::get_flash_size() const {
+    return flash_get_size(&_flash);
+}
+
+bool FlashIAP::is_aligned_to_sectors(uint32_t addr, uint32_t size) const {
+    // sectors may differ in size, walk them
+    uint32_t sector = flash_get_sector_size(&_flash, addr);
+    if (!size || sector == MBED_FLASH_INVALID_SIZE || (addr % sector)) {
+        return false;
+    }
+    while (size > sector) {
+        size -= sector;
+        addr += sector;
+        sector = flash_get_sector_size(&_flash, addr);
+        if (sector == MBED_FLASH_INVALID_SIZE) {
+            return false;
+        }
+    }
+    return size == sector;
+}
+
+#if DEVICE_FLASH_ASYNCH
+
+bool FlashIAP::is_rww(uint32_t addr) const {
+    return flash_is_rww(&_flash, addr) != 0;
+}
+
+int FlashIAP::program(const void *buffer, uint32_t addr, uint32_t size, const event_callback_t &callback) {
+    _mutex->lock();
+    if (flash_active(&_flash)) {
+        _mutex->unlock();
+        return -1;
+    }
+
+    _callback = callback;
+    _erase_addr = _erase_end = 0;
+    // the flash must keep its clock until the operation ends
+    _deep_sleep_lock.lock();
+    int ret = flash_program_page_asynch(&_flash, addr, static_cast<const uint8_t *>(buffer), size, _irq.entry());
+    if (ret) {
+        _deep_sleep_lock.unlock();
+    }
+    _mutex->unlock();
+    return ret ? -1 : 0;
+}
+
+int FlashIAP::erase(uint32_t addr, uint32_t size, const event_callback_t &callback) {
+    if (!is_aligned_to_sectors(addr, size) || !is_rww(addr) || !is_rww(addr + size - 1)) {
+        return -1;
+    }
+
+    _mutex->lock();
+    if (flash_active(&_flash)) {
+        _mutex->unlock();
+        return -1;
+    }
+
+    _callback = callback;
+    _erase_addr = addr + flash_get_sector_size(&_flash, addr);
+    _erase_end = addr + size;
+    _deep_sleep_lock.lock();
+    int ret = flash_erase_sector_asynch(&_flash, addr, _irq.entry());
+    if (ret) {
+        _deep_sleep_lock.unlock();
+    }
+    _mutex->unlock();
+    return ret ? -1 : 0;
+}
+
+bool FlashIAP::busy() {
+    return flash_active(&_flash) != 0;
+}
+
+void FlashIAP::irq_handler_asynch(void) {
+    int event = flash_irq_handler_asynch(&_flash);
+    if (!event) {
+        return;
+    }
+
+    if ((event & FLASH_EVENT_COMPLETE) && _erase_addr < _erase_end) {
+        uint32_t addr = _erase_addr;
+        _erase_addr += flash_get_sector_size(&_flash, addr);
+        if (flash_erase_sector_asynch(&_flash, addr, _irq.entry()) == 0) {
+            return;
+        }
+        event = FLASH_EVENT_ERROR;
+    }
+
+    _deep_sleep_lock.unlock();
+    if (_callback) {
+        _callback.call(event & FLASH_EVENT_ALL);
+    }
+}
+
+#endif
+
+} // namespace mbed
+
+#endif
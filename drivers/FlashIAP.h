@@ -0,0 +1,175 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_FLASHIAP_H
+#define MBED_FLASHIAP_H
+
+#include "platform/platform.h"
+
+#if DEVICE_FLASH
+
+#include "hal/flash_api.h"
+#include "platform/PlatformMutex.h"
+#include "platform/SingletonPtr.h"
+
+#if DEVICE_FLASH_ASYNCH
+#include "platform/CThunk.h"
+#include "platform/Callback.h"
+#include "platform/DeepSleepLock.h"
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+/** In application programming of the internal flash
+ *
+ *  Erases go by whole sectors, programming by whole pages; the sizes come
+ *  from get_sector_size() and get_page_size(). The blocking calls stall
+ *  the CPU, interrupts included, until the flash is done.
+ *
+ *  On DEVICE_FLASH_ASYNCH targets, the sectors is_rww() accepts are in a
+ *  bank the program doesn't run from, and can be erased and programmed in
+ *  the background: the callback gets a FLASH_EVENT_* once done. That bank
+ *  mustn't be read until then.
+ *
+ * @Note Synchronization level: Thread safe, the callbacks run in interrupt context
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * FlashIAP flash;
+ *
+ * int main() {
+ *     flash.init();
+ *     uint32_t addr = flash.get_flash_start() + flash.get_flash_size() - flash.get_sector_size(0);
+ *     uint8_t page[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+ *
+ *     flash.erase(addr, flash.get_sector_size(addr));
+ *     flash.program(page, addr, sizeof(page));
+ * }
+ * @endcode
+ */
+class FlashIAP {
+public:
+    FlashIAP();
+    ~FlashIAP();
+
+    /** Initialize the flash controller
+     *
+     *  @return 0 on success, -1 on error
+     */
+    int init();
+
+    /** Release the flash controller
+     *
+     *  @return 0 on success, -1 while a background operation runs
+     */
+    int deinit();
+
+    /** Read the flash
+     *
+     *  @param buffer The data read
+     *  @param addr   The first address read
+     *  @param size   The number of bytes
+     *  @return 0 on success, -1 outside the flash
+     */
+    int read(void *buffer, uint32_t addr, uint32_t size);
+
+    /** Program erased pages
+     *
+     *  @param buffer The data, not in the flash itself
+     *  @param addr   The start of a page
+     *  @param size   A multiple of the page size
+     *  @return 0 on success, -1 on error
+     */
+    int program(const void *buffer, uint32_t addr, uint32_t size);
+
+    /** Erase sectors
+     *
+     *  @param addr The start of a sector
+     *  @param size The size of the sectors, ending on a sector boundary
+     *  @return 0 on success, -1 on error
+     */
+    int erase(uint32_t addr, uint32_t size);
+
+    /** Size of a page, the unit of program() */
+    uint32_t get_page_size() const;
+
+    /** Size of the sector holding an address, the unit of erase()
+     *
+     *  @return The size, or MBED_FLASH_INVALID_SIZE outside the flash
+     */
+    uint32_t get_sector_size(uint32_t addr) const;
+
+    /** Address of the first byte of the flash */
+    uint32_t get_flash_start() const;
+
+    /** Size of the flash in bytes */
+    uint32_t get_flash_size() const;
+
+#if DEVICE_FLASH_ASYNCH
+    /** Whether the sector holding an address supports the background operations */
+    bool is_rww(uint32_t addr) const;
+
+    /** Start programming erased pages in the background
+     *
+     *  @param buffer   The data, valid until the callback runs
+     *  @param addr     The start of a page, in sectors is_rww() accepts
+     *  @param size     A multiple of the page size
+     *  @param callback Called with the FLASH_EVENT_* once done
+     *  @return 0 if started, -1 on error or while another operation runs
+     */
+    int program(const void *buffer, uint32_t addr, uint32_t size, const event_callback_t &callback);
+
+    /** Start erasing sectors in the background, one after another
+     *
+     *  @param addr     The start of a sector is_rww() accepts
+     *  @param size     The size of the sectors, ending on a sector boundary
+     *  @param callback Called with the FLASH_EVENT_* once done, or at the first error
+     *  @return 0 if started, -1 on error or while another operation runs
+     */
+    int erase(uint32_t addr, uint32_t size, const event_callback_t &callback);
+
+    /** Whether a background operation runs */
+    bool busy();
+#endif
+
+private:
+    bool is_aligned_to_sectors(uint32_t addr, uint32_t size) const;
+
+    flash_t _flash;
+    static SingletonPtr<PlatformMutex> _mutex;
+
+#if DEVICE_FLASH_ASYNCH
+    void irq_handler_asynch(void);
+
+    CThunk<FlashIAP> _irq;
+    event_callback_t _callback;
+    /* Sectors left to erase, after the one being erased */
+    uint32_t _erase_addr;
+    uint32_t _erase_end;
+    DeepSleepLock _deep_sleep_lock;
+#endif
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
+
+/** @}*/
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "drivers/I2C.h"
+#include "platform/critical.h"
 
 #if DEVICE_I2C
 
@@ -22,9 +23,13 @@ namespace mbed {
 I2C *I2C::_owner = NULL;
 SingletonPtr<PlatformMutex> I2C::_mutex;
 
+#if DEVICE_I2C_ASYNCH && TRANSACTION_QUEUE_SIZE_I2C
+CircularBuffer<Transaction<I2C, I2C::i2c_transaction_t>, TRANSACTION_QUEUE_SIZE_I2C> I2C::_transaction_buffer;
+#endif
+
 I2C::I2C(PinName sda, PinName scl) :
 #if DEVICE_I2C_ASYNCH
-                                     _irq(this), _usage(DMA_USAGE_NEVER),
+                                     _event(0), _irq(this), _usage(DMA_USAGE_NEVER),
 #endif
                                       _i2c(), _hz(100000) {
     // No lock needed in the constructor
@@ -124,37 +129,108 @@ void I2C::unlock() {
 
 int I2C::transfer(int address, const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length, const event_callback_t& callback, int event, bool repeated)
 {
-    lock();
-    if (i2c_active(&_i2c)) {
-        unlock();
-        return -1; // transaction ongoing
+    i2c_transaction_t t;
+
+    t.tx_buffer = tx_buffer;
+    t.tx_length = tx_length;
+    t.rx_buffer = rx_buffer;
+    t.rx_length = rx_length;
+    t.address = address;
+    t.event = event;
+    t.repeated = repeated;
+    t.callback = callback;
+
+    // No mutex, may be called from the callback of the previous transfer
+    int ret = 0;
+    core_util_critical_section_enter();
+    if (!i2c_active(&_i2c)) {
+        start_transaction(&t);
+    } else {
+#if TRANSACTION_QUEUE_SIZE_I2C
+        if (_transaction_buffer.full()) {
+            ret = -1; // the buffer is full
+        } else {
+            _transaction_buffer.push(Transaction<I2C, i2c_transaction_t>(this, t));
+        }
+#else
+        ret = -1; // transaction ongoing
+#endif
     }
-    aquire();
-
-    _callback = callback;
-    int stop = (repeated) ? 0 : 1;
-    _irq.callback(&I2C::irq_handler_asynch);
-    i2c_transfer_asynch(&_i2c, (void *)tx_buffer, tx_length, (void *)rx_buffer, rx_length, address, stop, _irq.entry(), event, _usage);
-    unlock();
-    return 0;
+    core_util_critical_section_exit();
+    return ret;
 }
 
 void I2C::abort_transfer(void)
 {
-    lock();
+    core_util_critical_section_enter();
     i2c_abort_asynch(&_i2c);
-    unlock();
+    if (_deep_sleep_lock.locked()) {
+        _deep_sleep_lock.unlock();
+    }
+    dequeue_transaction();
+    core_util_critical_section_exit();
 }
 
-void I2C::irq_handler_asynch(void)
+void I2C::clear_transfer_buffer()
 {
-    int event = i2c_irq_handler_asynch(&_i2c);
-    if (_callback && event) {
-        _callback.call(event);
+#if TRANSACTION_QUEUE_SIZE_I2C
+    _transaction_buffer.reset();
+#endif
+}
+
+void I2C::abort_all_transfers()
+{
+    clear_transfer_buffer();
+    abort_transfer();
+}
+
+void I2C::start_transaction(i2c_transaction_t *data)
+{
+    // aquire() without the mutex
+    if (_owner != this) {
+        i2c_frequency(&_i2c, _hz);
+        _owner = this;
     }
 
+    _callback = data->callback;
+    _event = data->event;
+    int stop = (data->repeated) ? 0 : 1;
+    _irq.callback(&I2C::irq_handler_asynch);
+    // the clocks must run until the transfer ends
+    _deep_sleep_lock.lock();
+    // All events, so the end of every transfer is seen
+    i2c_transfer_asynch(&_i2c, (void *)data->tx_buffer, data->tx_length, (void *)data->rx_buffer, data->rx_length,
+                        data->address, stop, _irq.entry(), I2C_EVENT_ALL, _usage);
+}
+
+void I2C::dequeue_transaction()
+{
+#if TRANSACTION_QUEUE_SIZE_I2C
+    Transaction<I2C, i2c_transaction_t> t;
+    if (_transaction_buffer.pop(t)) {
+        I2C *obj = t.get_object();
+        obj->start_transaction(t.get_transaction());
+    }
+#endif
 }
 
+void I2C::irq_handler_asynch(void)
+{
+    int event = i2c_irq_handler_asynch(&_i2c);
+    if (!event) {
+        return;
+    }
+    if (_deep_sleep_lock.locked()) {
+        _deep_sleep_lock.unlock();
+    }
+    if (_callback && (event & _event)) {
+        _callback.call(event & _event);
+    }
+    // The peripheral is free, unless the callback started a transfer
+    if (!i2c_active(&_i2c)) {
+        dequeue_transaction();
+    }
+}
 
 #endif
 
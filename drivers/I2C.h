@@ -27,7 +27,18 @@
 #if DEVICE_I2C_ASYNCH
 #include "platform/CThunk.h"
 #include "hal/dma_api.h"
+#include "platform/CircularBuffer.h"
 #include "platform/FunctionPointer.h"
+#include "platform/Transaction.h"
+#include "platform/DeepSleepLock.h"
+
+#ifndef TRANSACTION_QUEUE_SIZE_I2C
+#ifdef MBED_CONF_DRIVERS_I2C_TRANSACTION_QUEUE_SIZE
+#define TRANSACTION_QUEUE_SIZE_I2C MBED_CONF_DRIVERS_I2C_TRANSACTION_QUEUE_SIZE
+#else
+#define TRANSACTION_QUEUE_SIZE_I2C 4
+#endif
+#endif
 #endif
 
 namespace mbed {
@@ -156,6 +167,12 @@ public:
 #if DEVICE_I2C_ASYNCH
 
     /** Start non-blocking I2C transfer.
+     *
+     * The TX buffer is written first, then the RX buffer is read after a
+     * repeated start, so a register read is a single transfer. If the
+     * peripheral is busy, the transfer is queued and started from the
+     * interrupt that ends the previous one, so a sequence of transfers
+     * runs back to back. It can be called from a transfer callback.
      *
      * @param address   8/10 bit I2c slave address
      * @param tx_buffer The TX buffer with data to be transfered
@@ -165,18 +182,55 @@ public:
      * @param event     The logical OR of events to modify
      * @param callback  The event callback function
      * @param repeated Repeated start, true - do not send stop at end
-     * @return Zero if the transfer has started, or -1 if I2C peripheral is busy
+     * @return Zero if the transfer has started or was queued, or -1 if the queue is full
      */
     int transfer(int address, const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length, const event_callback_t& callback, int event = I2C_EVENT_TRANSFER_COMPLETE, bool repeated = false);
 
-    /** Abort the on-going I2C transfer
+    /** Abort the on-going I2C transfer, and continue with transfers in the queue if any.
      */
     void abort_transfer();
+
+    /** Clear the transaction buffer
+     */
+    void clear_transfer_buffer();
+
+    /** Clear the transaction buffer and abort on-going transfer.
+     */
+    void abort_all_transfers();
+
 protected:
+    /** I2C transaction data */
+    typedef struct {
+        const char *tx_buffer;     /**< Tx buffer */
+        int tx_length;             /**< Length of Tx buffer */
+        char *rx_buffer;           /**< Rx buffer */
+        int rx_length;             /**< Length of Rx buffer */
+        int address;               /**< Slave address */
+        int event;                 /**< Events reported to the callback */
+        bool repeated;             /**< No stop at the end */
+        event_callback_t callback; /**< User's callback */
+    } i2c_transaction_t;
+
     void irq_handler_asynch(void);
+
+    /** Configure the peripheral and start a transfer, in a critical section
+     *
+     *  @param data Transaction data
+     */
+    void start_transaction(i2c_transaction_t *data);
+
+    /** Start the next queued transaction, if any
+     */
+    void dequeue_transaction();
+
     event_callback_t _callback;
+    int _event;
     CThunk<I2C> _irq;
     DMAUsage _usage;
+    DeepSleepLock _deep_sleep_lock;
+#if TRANSACTION_QUEUE_SIZE_I2C
+    static CircularBuffer<Transaction<I2C, i2c_transaction_t>, TRANSACTION_QUEUE_SIZE_I2C> _transaction_buffer;
+#endif
 #endif
 
 protected:
@@ -14,12 +14,25 @@
  * limitations under the License.
  */
 #include "drivers/I2CSlave.h"
+#if DEVICE_I2CSLAVE_ASYNCH
+#include "platform/critical.h"
+#endif
 
 #if DEVICE_I2CSLAVE
 
 namespace mbed {
 
-I2CSlave::I2CSlave(PinName sda, PinName scl) : _i2c() {
+I2CSlave::I2CSlave(PinName sda, PinName scl) :
+    _i2c()
+#if DEVICE_I2CSLAVE_ASYNCH
+    , _irq(this)
+    , _event(0)
+    , _rx_buffer(NULL)
+    , _rx_length(0)
+    , _rx_index(0)
+    , _rx_count(0)
+#endif
+{
     i2c_init(&_i2c, sda, scl);
     i2c_frequency(&_i2c, 100000);
     i2c_slave_mode(&_i2c, 1);
@@ -58,6 +71,96 @@ void I2CSlave::stop(void) {
     i2c_stop(&_i2c);
 }
 
+#if DEVICE_I2CSLAVE_ASYNCH
+
+int I2CSlave::listen(uint8_t *buffer, size_t length, const event_callback_t &callback, int event) {
+    core_util_critical_section_enter();
+    if (i2c_slave_active(&_i2c)) {
+        core_util_critical_section_exit();
+        return -1;
+    }
+    _callback = callback;
+    _event = event;
+    _rx_buffer = buffer;
+    _rx_length = length;
+    _rx_index = 0;
+    _rx_count = 0;
+    _irq.callback(&I2CSlave::irq_handler_asynch);
+    // overflows are found at the end of the writes
+    int hal_event = (event & I2C_EVENT_SLAVE_RX_OVERFLOW) ? (event | I2C_EVENT_SLAVE_RECEIVED) : event;
+    int ret = i2c_slave_start_asynch(&_i2c, buffer, length, _irq.entry(), hal_event);
+    if (ret == 0) {
+        // address matches don't wake the target from deep sleep
+        _deep_sleep_lock.lock();
+    }
+    core_util_critical_section_exit();
+    return ret;
+}
+
+void I2CSlave::stop_listening() {
+    core_util_critical_section_enter();
+    if (i2c_slave_active(&_i2c)) {
+        i2c_slave_abort_asynch(&_i2c);
+        _deep_sleep_lock.unlock();
+    }
+    core_util_critical_section_exit();
+}
+
+bool I2CSlave::listening() {
+    return i2c_slave_active(&_i2c);
+}
+
+void I2CSlave::reply(const uint8_t *data, size_t length) {
+    i2c_slave_reply_asynch(&_i2c, data, length);
+}
+
+// Skips the bytes the ring overwrote, returns the number of bytes left
+size_t I2CSlave::drop_overwritten() {
+    uint32_t pending = i2c_slave_received(&_i2c) - _rx_count;
+    if (pending > _rx_length) {
+        uint32_t dropped = pending - _rx_length;
+        _rx_count += dropped;
+        _rx_index = (_rx_index + dropped) % _rx_length;
+        pending = _rx_length;
+    }
+    return pending;
+}
+
+size_t I2CSlave::readable() {
+    core_util_critical_section_enter();
+    size_t pending = i2c_slave_active(&_i2c) ? drop_overwritten() : 0;
+    core_util_critical_section_exit();
+    return pending;
+}
+
+size_t I2CSlave::read_buffered(uint8_t *data, size_t length) {
+    size_t n = readable();
+    if (n > length) {
+        n = length;
+    }
+    for (size_t i = 0; i < n; i++) {
+        data[i] = _rx_buffer[_rx_index];
+        if (++_rx_index == _rx_length) {
+            _rx_index = 0;
+        }
+    }
+    _rx_count += n;
+    return n;
+}
+
+void I2CSlave::irq_handler_asynch(void) {
+    int event = i2c_slave_irq_handler_asynch(&_i2c);
+    if ((event & I2C_EVENT_SLAVE_RECEIVED) && i2c_slave_received(&_i2c) - _rx_count > _rx_length) {
+        event |= I2C_EVENT_SLAVE_RX_OVERFLOW;
+    }
+    event &= _event;
+    if (_callback && event) {
+        _callback.call(event);
+    }
+}
+
+#endif
+
 }
 
 #endif
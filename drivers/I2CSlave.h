@@ -21,6 +21,11 @@
 #if DEVICE_I2CSLAVE
 
 #include "hal/i2c_api.h"
+#if DEVICE_I2CSLAVE_ASYNCH
+#include "platform/CThunk.h"
+#include "platform/FunctionPointer.h"
+#include "platform/DeepSleepLock.h"
+#endif
 
 namespace mbed {
 /** \addtogroup drivers */
@@ -147,8 +152,85 @@ public:
      */
     void stop(void);
 
+#if DEVICE_I2CSLAVE_ASYNCH
+
+    /** Receive into a ring buffer in the background
+     *
+     *  Once address() is set, the writes of the master are stored in the
+     *  ring and its reads answered with the reply set by
+     *  reply(const uint8_t *, size_t), without polling receive(). The
+     *  callback gets I2C_EVENT_SLAVE_RECEIVED or I2C_EVENT_SLAVE_TRANSMITTED
+     *  at the STOP or repeated start ending each transfer, and
+     *  I2C_EVENT_SLAVE_RX_OVERFLOW along with the first once bytes were
+     *  overwritten before being read.
+     *
+     *  @param buffer   The ring, in use until stop_listening()
+     *  @param length   The size of the ring in bytes
+     *  @param callback Called from interrupt context with the events
+     *  @param event    The logical OR of the events calling the callback
+     *  @return 0 if listening started, -1 if already listening or the
+     *          target can't listen
+     */
+    int listen(uint8_t *buffer, size_t length, const event_callback_t &callback,
+               int event = I2C_EVENT_SLAVE_ALL);
+
+    /** Stop receiving in the background
+     */
+    void stop_listening();
+
+    /** Check if receiving in the background
+     *
+     *  @return true between listen() and stop_listening()
+     */
+    bool listening();
+
+    /** Set the bytes sent when the master reads, while listening
+     *
+     *  Each read gets them from the start, then 0xFF once they run out.
+     *  Takes effect from the next read, e.g. set from the callback on
+     *  I2C_EVENT_SLAVE_RECEIVED to answer a register address.
+     *
+     *  @param data   The bytes, in use until replaced or stop_listening()
+     *  @param length The number of bytes
+     */
+    void reply(const uint8_t *data, size_t length);
+
+    /** Get the number of bytes received and not read yet
+     *
+     *  The ring holds the most recent bytes, older ones are dropped.
+     *
+     *  @return The number of bytes read_buffered() can read
+     */
+    size_t readable();
+
+    /** Read bytes received in the background, oldest first
+     *
+     *  @param data   The buffer to copy the bytes to
+     *  @param length The size of the buffer
+     *  @return The number of bytes read
+     */
+    size_t read_buffered(uint8_t *data, size_t length);
+
+#endif
+
 protected:
+#if DEVICE_I2CSLAVE_ASYNCH
+    void irq_handler_asynch(void);
+    size_t drop_overwritten();
+#endif
+
     i2c_t _i2c;
+
+#if DEVICE_I2CSLAVE_ASYNCH
+    CThunk<I2CSlave> _irq;
+    event_callback_t _callback;
+    int _event;
+    uint8_t *_rx_buffer;
+    size_t _rx_length;
+    size_t _rx_index;
+    uint32_t _rx_count;
+    DeepSleepLock _deep_sleep_lock;
+#endif
 };
 
 } // namespace mbed
@@ -45,13 +45,13 @@ int InterruptIn::read() {
 }
 
 void InterruptIn::mode(PinMode pull) {
-    core_util_critical_section_enter();
+    uint32_t mask = core_util_irq_mask_enter();
     gpio_mode(&gpio, pull);
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 void InterruptIn::rise(Callback<void()> func) {
-    core_util_critical_section_enter();
+    uint32_t mask = core_util_irq_mask_enter();
     if (func) {
         _rise.attach(func);
         gpio_irq_set(&gpio_irq, IRQ_RISE, 1);
@@ -59,11 +59,11 @@ void InterruptIn::rise(Callback<void()> func) {
         _rise.attach(donothing);
         gpio_irq_set(&gpio_irq, IRQ_RISE, 0);
     }
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 void InterruptIn::fall(Callback<void()> func) {
-    core_util_critical_section_enter();
+    uint32_t mask = core_util_irq_mask_enter();
     if (func) {
         _fall.attach(func);
         gpio_irq_set(&gpio_irq, IRQ_FALL, 1);
@@ -71,7 +71,7 @@ void InterruptIn::fall(Callback<void()> func) {
         _fall.attach(donothing);
         gpio_irq_set(&gpio_irq, IRQ_FALL, 0);
     }
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 void InterruptIn::_irq_handler(uint32_t id, gpio_irq_event event) {
@@ -83,16 +83,23 @@ void InterruptIn::_irq_handler(uint32_t id, gpio_irq_event event) {
     }
 }
 
+uint32_t InterruptIn::filter(uint32_t us) {
+    uint32_t mask = core_util_irq_mask_enter();
+    uint32_t width = gpio_irq_filter(&gpio_irq, us);
+    core_util_irq_mask_exit(mask);
+    return width;
+}
+
 void InterruptIn::enable_irq() {
-    core_util_critical_section_enter();
+    uint32_t mask = core_util_irq_mask_enter();
     gpio_irq_enable(&gpio_irq);
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 void InterruptIn::disable_irq() {
-    core_util_critical_section_enter();
+    uint32_t mask = core_util_irq_mask_enter();
     gpio_irq_disable(&gpio_irq);
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 InterruptIn::operator int() {
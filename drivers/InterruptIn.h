@@ -135,6 +135,17 @@ public:
      */
     void mode(PinMode pull);
 
+    /** Filter out pulses shorter than a given width in hardware
+     *
+     *  The filter delays each edge by its width and, depending on the
+     *  target, may be shared by all the filtered pins of the port. See
+     *  gpio_irq_filter().
+     *
+     *  @param us The width of the shortest pulse to keep, 0 to disable the filter
+     *  @returns The width applied in microseconds, 0 if the target has no filter
+     */
+    uint32_t filter(uint32_t us);
+
     /** Enable IRQ. This method depends on hw implementation, might enable one
      *  port interrupts. For further information, check gpio_irq_enable().
      */
@@ -19,8 +19,7 @@
 #include "drivers/InterruptManager.h"
 #include "platform/critical.h"
 #include <string.h>
-
-#define CHAIN_INITIAL_SIZE    4
+#include <stdio.h>
 
 namespace mbed {
 
@@ -49,9 +48,9 @@ InterruptManager* InterruptManager::get() {
     return _instance;
 }
 
-InterruptManager::InterruptManager() {
+InterruptManager::InterruptManager() : _handlers(NULL) {
     // No mutex needed in constructor
-    memset(_chains, 0, NVIC_NUM_VECTORS * sizeof(CallChain*));
+    memset(_chains, 0, NVIC_NUM_VECTORS * sizeof(IrqChain*));
 }
 
 void InterruptManager::destroy() {
@@ -65,35 +64,95 @@ void InterruptManager::destroy() {
 }
 
 InterruptManager::~InterruptManager() {
-    for(int i = 0; i < NVIC_NUM_VECTORS; i++)
-        if (NULL != _chains[i])
+    for(int i = 0; i < NVIC_NUM_VECTORS; i++) {
+        if (NULL != _chains[i]) {
+            // Entries of the callers are left out of any chain
+            _chains[i]->chain.clear();
             delete _chains[i];
+        }
+    }
+    while (NULL != _handlers) {
+        Handler *next = _handlers->next;
+        delete _handlers;
+        _handlers = next;
+    }
 }
 
-bool InterruptManager::must_replace_vector(IRQn_Type irq) {
+IntrusiveCallChain *InterruptManager::get_chain(IRQn_Type irq) {
     lock();
 
-    int ret = false;
     int irq_pos = get_irq_index(irq);
     if (NULL == _chains[irq_pos]) {
-        _chains[irq_pos] = new CallChain(CHAIN_INITIAL_SIZE);
-        _chains[irq_pos]->add((pvoidf)NVIC_GetVector(irq));
-        ret = true;
+        IrqChain *irq_chain = new IrqChain;
+        irq_chain->vector.attach((pvoidf)NVIC_GetVector(irq));
+        irq_chain->chain.add(&irq_chain->vector);
+#ifdef MBED_PROFILE_ENABLED
+        mbed_profile_region_t profile = MBED_PROFILE_REGION_INIT(irq_chain->name);
+        irq_chain->profile = profile;
+        snprintf(irq_chain->name, sizeof(irq_chain->name), "irq %d", (int)irq);
+#endif
+        _chains[irq_pos] = irq_chain;
+        NVIC_SetVector(irq, (uint32_t)&InterruptManager::static_irq_helper);
     }
     unlock();
-    return ret;
+    return &_chains[irq_pos]->chain;
 }
 
-pFunctionPointer_t InterruptManager::add_common(void (*function)(void), IRQn_Type irq, bool front) {
-    lock();
-    int irq_pos = get_irq_index(irq);
-    bool change = must_replace_vector(irq);
+void InterruptManager::add_entry(CallChainEntry *entry, IRQn_Type irq, bool front) {
+    IntrusiveCallChain *chain = get_chain(irq);
+    if (front) {
+        chain->add_front(entry);
+    } else {
+        chain->add(entry);
+    }
+}
 
-    pFunctionPointer_t pf = front ? _chains[irq_pos]->add_front(function) : _chains[irq_pos]->add(function);
-    if (change)
-        NVIC_SetVector(irq, (uint32_t)&InterruptManager::static_irq_helper);
+void InterruptManager::add_handler(CallChainEntry *entry, IRQn_Type irq) {
+    add_entry(entry, irq, false);
+}
+
+void InterruptManager::add_handler_front(CallChainEntry *entry, IRQn_Type irq) {
+    add_entry(entry, irq, true);
+}
+
+bool InterruptManager::remove_handler(CallChainEntry *entry, IRQn_Type irq) {
+    // Chains are only released with the instance, no lock needed
+    IrqChain *irq_chain = _chains[get_irq_index(irq)];
+    return irq_chain != NULL && irq_chain->chain.remove(entry);
+}
+
+void InterruptManager::trace_irq(IRQn_Type irq) {
+#ifdef MBED_PROFILE_ENABLED
+    get_chain(irq);
+#endif
+}
+
+bool InterruptManager::get_irq_profile(IRQn_Type irq, mbed_profile_region_t *profile) {
+#ifdef MBED_PROFILE_ENABLED
+    IrqChain *irq_chain = _chains[get_irq_index(irq)];
+    if (irq_chain == NULL) {
+        return false;
+    }
+
+    core_util_critical_section_enter();
+    *profile = irq_chain->profile;
+    core_util_critical_section_exit();
+    return true;
+#else
+    return false;
+#endif
+}
+
+pFunctionPointer_t InterruptManager::add_common(Callback<void()> func, IRQn_Type irq, bool front) {
+    Handler *handler = new Handler;
+    handler->entry.attach(func);
+
+    lock();
+    handler->next = _handlers;
+    _handlers = handler;
+    add_entry(&handler->entry, irq, front);
     unlock();
-    return pf;
+    return handler->entry.get_callback();
 }
 
 bool InterruptManager::remove_handler(pFunctionPointer_t handler, IRQn_Type irq) {
@@ -102,8 +161,18 @@ bool InterruptManager::remove_handler(pFunctionPointer_t handler, IRQn_Type irq)
 
     lock();
     if (_chains[irq_pos] != NULL) {
-        if (_chains[irq_pos]->remove(handler)) {
+        CallChainEntry *entry = _chains[irq_pos]->chain.find(handler);
+        if (entry != NULL && _chains[irq_pos]->chain.remove(entry)) {
             ret = true;
+            // Release the entry if it was allocated by add_handler
+            for (Handler **pos = &_handlers; *pos != NULL; pos = &(*pos)->next) {
+                if (&(*pos)->entry == entry) {
+                    Handler *found = *pos;
+                    *pos = found->next;
+                    delete found;
+                    break;
+                }
+            }
         }
     }
     unlock();
@@ -112,7 +181,14 @@ bool InterruptManager::remove_handler(pFunctionPointer_t handler, IRQn_Type irq)
 }
 
 void InterruptManager::irq_helper() {
-    _chains[__get_IPSR()]->call();
+#ifdef MBED_PROFILE_ENABLED
+    IrqChain *irq_chain = _chains[__get_IPSR()];
+    uint32_t start = mbed_profile_start();
+    irq_chain->chain.call();
+    mbed_profile_add(&irq_chain->profile, mbed_profile_elapsed(start));
+#else
+    _chains[__get_IPSR()]->chain.call();
+#endif
 }
 
 int InterruptManager::get_irq_index(IRQn_Type irq) {
@@ -18,7 +18,9 @@
 
 #include "cmsis.h"
 #include "platform/CallChain.h"
+#include "platform/IntrusiveCallChain.h"
 #include "platform/PlatformMutex.h"
+#include "platform/mbed_profile.h"
 #include <string.h>
 
 namespace mbed {
@@ -26,6 +28,16 @@ namespace mbed {
 /** @{*/
 
 /** Use this singleton if you need to chain interrupt handlers.
+ *
+ * The handlers of each interrupt are an IntrusiveCallChain, set up on the
+ * first handler of the interrupt, with the original vector at the front.
+ * Handlers added as a CallChainEntry of the caller do not allocate, the
+ * handlers added as functions allocate their entry.
+ *
+ * With MBED_PROFILE_ENABLED, the handlers of each interrupt are timed
+ * together as a region of mbed_profile_dump, named after the interrupt
+ * number, e.g. "irq 25". trace_irq times an interrupt without adding a
+ * handler to it.
  *
  * @Note Synchronization level: Thread safe
  *
@@ -60,6 +72,9 @@ public:
     static InterruptManager* get();
 
     /** Destroy the current instance of the interrupt manager
+     *
+     *  Not with MBED_PROFILE_ENABLED, the profile table keeps the regions
+     *  of the interrupts.
      */
     static void destroy();
 
@@ -129,6 +144,50 @@ public:
      */
     bool remove_handler(pFunctionPointer_t handler, IRQn_Type irq);
 
+    /** Add a handler entry for an interrupt at the end of the handler list
+     *
+     *  @param entry entry of the handler, not in a chain
+     *  @param irq interrupt number
+     */
+    void add_handler(CallChainEntry *entry, IRQn_Type irq);
+
+    /** Add a handler entry for an interrupt at the beginning of the handler list
+     *
+     *  @param entry entry of the handler, not in a chain
+     *  @param irq interrupt number
+     */
+    void add_handler_front(CallChainEntry *entry, IRQn_Type irq);
+
+    /** Remove a handler entry from an interrupt, can be called from interrupts
+     *
+     *  @param entry entry of the handler to remove
+     *  @param irq the interrupt number
+     *
+     *  @returns
+     *  true if the handler was found and removed, false otherwise
+     */
+    bool remove_handler(CallChainEntry *entry, IRQn_Type irq);
+
+    /** Time the handlers of an interrupt, including its original vector
+     *
+     *  Needs MBED_PROFILE_ENABLED, interrupts with handlers added are
+     *  timed already.
+     *
+     *  @param irq interrupt number
+     */
+    void trace_irq(IRQn_Type irq);
+
+    /** Read the times of an interrupt, in cycles of the profile counter
+     *
+     *  @param irq interrupt number
+     *  @param profile filled with the number of interrupts and the
+     *  min, max and total cycles their handlers took
+     *
+     *  @returns
+     *  true if the interrupt is timed, false otherwise
+     */
+    bool get_irq_profile(IRQn_Type irq, mbed_profile_region_t *profile);
+
 private:
     InterruptManager();
     ~InterruptManager();
@@ -142,27 +201,36 @@ private:
     InterruptManager(const InterruptManager&);
     InterruptManager& operator =(const InterruptManager&);
 
+    // Handlers of an interrupt, allocated once on its first handler
+    struct IrqChain {
+        IntrusiveCallChain chain;
+        CallChainEntry vector;
+#ifdef MBED_PROFILE_ENABLED
+        mbed_profile_region_t profile;
+        char name[8];
+#endif
+    };
+
+    // Entry of a handler added as a function
+    struct Handler {
+        CallChainEntry entry;
+        Handler *next;
+    };
+
     template<typename T>
     pFunctionPointer_t add_common(T *tptr, void (T::*mptr)(void), IRQn_Type irq, bool front=false) {
-        _mutex.lock();
-        int irq_pos = get_irq_index(irq);
-        bool change = must_replace_vector(irq);
-
-        pFunctionPointer_t pf = front ? _chains[irq_pos]->add_front(tptr, mptr) : _chains[irq_pos]->add(tptr, mptr);
-        if (change)
-            NVIC_SetVector(irq, (uint32_t)&InterruptManager::static_irq_helper);
-        _mutex.unlock();
-        return pf;
+        return add_common(Callback<void()>(tptr, mptr), irq, front);
     }
 
-    pFunctionPointer_t add_common(void (*function)(void), IRQn_Type irq, bool front=false);
-    bool must_replace_vector(IRQn_Type irq);
+    pFunctionPointer_t add_common(Callback<void()> func, IRQn_Type irq, bool front=false);
+    void add_entry(CallChainEntry *entry, IRQn_Type irq, bool front);
+    IntrusiveCallChain *get_chain(IRQn_Type irq);
     int get_irq_index(IRQn_Type irq);
     void irq_helper();
-    void add_helper(void (*function)(void), IRQn_Type irq, bool front=false);
     static void static_irq_helper();
 
-    CallChain* _chains[NVIC_NUM_VECTORS];
+    IrqChain* _chains[NVIC_NUM_VECTORS];
+    Handler* _handlers;
     static InterruptManager* _instance;
     PlatformMutex _mutex;
 };
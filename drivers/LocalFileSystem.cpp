@@ -112,9 +112,10 @@ LocalFileHandle::LocalFileHandle(FILEHANDLE fh) : _fh(fh), pos(0) {
 }
 
 int LocalFileHandle::close() {
+    int drained = drain_buffer();
     int retval = semihost_close(_fh);
     delete this;
-    return retval;
+    return drained ? drained : retval;
 }
 
 ssize_t LocalFileHandle::write(const void *buffer, size_t length) {
@@ -21,6 +21,11 @@
 #if DEVICE_PWMOUT
 #include "hal/pwmout_api.h"
 #include "platform/critical.h"
+#include "platform/DeepSleepLock.h"
+#if DEVICE_PWMOUT_ASYNCH
+#include "platform/CThunk.h"
+#include "platform/FunctionPointer.h"
+#endif
 
 namespace mbed {
 /** \addtogroup drivers */
@@ -63,10 +68,16 @@ public:
      *
      *  @param pin PwmOut pin to connect to
      */
-    PwmOut(PinName pin) {
+    PwmOut(PinName pin)
+#if DEVICE_PWMOUT_ASYNCH
+        : _irq(this)
+#endif
+    {
         core_util_critical_section_enter();
         pwmout_init(&_pwm, pin);
         core_util_critical_section_exit();
+        // the PWM timer stops in deep sleep
+        _deep_sleep_lock.lock();
     }
 
     /** Set the ouput duty-cycle, specified as a percentage (float)
@@ -172,8 +183,86 @@ public:
         return read();
     }
 
+#if DEVICE_PWMOUT_ASYNCH
+
+    /** Get the sequence entry for a duty cycle
+     *
+     *  @param hz      Sequence rate, in PWM periods per second
+     *  @param percent Duty cycle, from 0.0f to 1.0f
+     *  @return The entry to put in a sequence played at this rate
+     */
+    uint16_t sequence_pulse(uint32_t hz, float percent) {
+        return pwmout_sequence_pulse(&_pwm, hz, percent);
+    }
+
+    /** Output a sequence of pulse widths, one per PWM period
+     *
+     *  DMA loads the next pulse width at each period, so sequences run at
+     *  rates far above what an interrupt per period allows, for LED strips,
+     *  stepper ramps or IR remotes. A one-shot sequence calls the callback
+     *  with PWMOUT_EVENT_COMPLETE once its last entry is loaded and holds
+     *  that pulse width, so end it with the idle level. A circular one plays
+     *  until stop(), with PWMOUT_EVENT_HALF_COMPLETE and PWMOUT_EVENT_COMPLETE
+     *  telling which half can be refilled.
+     *
+     *  The sequence sets the period of every output on the same timer.
+     *  Call period() afterwards to go back to regular output.
+     *
+     *  @param pulses   Entries from sequence_pulse(), stays in use until the sequence ends
+     *  @param length   Number of entries
+     *  @param hz       Sequence rate, in PWM periods per second
+     *  @param callback Called from interrupt context with the events
+     *  @param event    The logical OR of the events calling the callback
+     *  @param circular true to play the sequence in a loop
+     *  @return 0 if the sequence started, -1 if one is already running or the
+     *          target cannot output this pin or rate
+     */
+    int play(const uint16_t *pulses, size_t length, uint32_t hz, const event_callback_t &callback,
+             int event = PWMOUT_EVENT_ALL, bool circular = false) {
+        core_util_critical_section_enter();
+        if (pwmout_sequence_active(&_pwm)) {
+            core_util_critical_section_exit();
+            return -1;
+        }
+        _callback = callback;
+        _irq.callback(&PwmOut::irq_handler_asynch);
+        int ret = pwmout_sequence_start(&_pwm, pulses, length, hz, circular, _irq.entry(), event);
+        core_util_critical_section_exit();
+        return ret;
+    }
+
+    /** Stop the sequence, the output holds its current pulse width
+     */
+    void stop() {
+        core_util_critical_section_enter();
+        pwmout_sequence_stop(&_pwm);
+        core_util_critical_section_exit();
+    }
+
+    /** Check if a sequence is running
+     *
+     *  @return true until the sequence completes or stop() is called
+     */
+    bool playing() {
+        return pwmout_sequence_active(&_pwm);
+    }
+
+#endif
+
 protected:
+#if DEVICE_PWMOUT_ASYNCH
+    void irq_handler_asynch(void) {
+        int event = pwmout_sequence_irq_handler(&_pwm);
+        if (_callback && event) {
+            _callback.call(event);
+        }
+    }
+
+    CThunk<PwmOut> _irq;
+    event_callback_t _callback;
+#endif
     pwmout_t _pwm;
+    DeepSleepLock _deep_sleep_lock;
 };
 
 } // namespace mbed
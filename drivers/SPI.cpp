@@ -32,11 +32,21 @@ SPI::SPI(PinName mosi, PinName miso, PinName sclk, PinName ssel) :
 #endif
         _bits(8),
         _mode(0),
-        _hz(1000000) {
+        _hz(1000000),
+        _write_fill(SPI_FILL_CHAR) {
     // No lock needed in the constructor
 
     spi_init(&_spi, mosi, miso, sclk, ssel);
     aquire();
+
+#if DEVICE_CLOCK_SCALING
+    lock();
+    if (_clock_entry->get_chain() == NULL) {
+        _clock_entry->attach(&SPI::clock_changed);
+        mbed_clock_attach(_clock_entry.get());
+    }
+    unlock();
+#endif
 }
 
 void SPI::format(int bits, int mode) {
@@ -59,6 +69,17 @@ void SPI::frequency(int hz) {
 SPI* SPI::_owner = NULL;
 SingletonPtr<PlatformMutex> SPI::_mutex;
 
+#if DEVICE_CLOCK_SCALING
+SingletonPtr<CallChainEntry> SPI::_clock_entry;
+
+// the frequency divider is set again on the next transfer
+void SPI::clock_changed() {
+    _mutex->lock();
+    _owner = NULL;
+    _mutex->unlock();
+}
+#endif
+
 // ignore the fact there are multiple physical spis, and always update if it wasnt us last
 void SPI::aquire() {
     lock();
@@ -78,6 +99,20 @@ int SPI::write(int value) {
     return ret;
 }
 
+int SPI::write(const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length) {
+    lock();
+    aquire();
+    int ret = spi_master_block_write(&_spi, tx_buffer, tx_length, rx_buffer, rx_length, _write_fill);
+    unlock();
+    return ret;
+}
+
+void SPI::set_default_write_value(char data) {
+    lock();
+    _write_fill = data;
+    unlock();
+}
+
 void SPI::lock() {
     _mutex->lock();
 }
@@ -100,6 +135,9 @@ int SPI::transfer(const void *tx_buffer, int tx_length, void *rx_buffer, int rx_
 void SPI::abort_transfer()
 {
     spi_abort_asynch(&_spi);
+    if (_deep_sleep_lock.locked()) {
+        _deep_sleep_lock.unlock();
+    }
 #if TRANSACTION_QUEUE_SIZE_SPI
     dequeue_transaction();
 #endif
@@ -162,6 +200,8 @@ void SPI::start_transfer(const void *tx_buffer, int tx_length, void *rx_buffer,
     aquire();
     _callback = callback;
     _irq.callback(&SPI::irq_handler_asynch);
+    // the clocks must run until the transfer ends
+    _deep_sleep_lock.lock();
     spi_master_transfer(&_spi, tx_buffer, tx_length, rx_buffer, rx_length, bit_width, _irq.entry(), event , _usage);
 }
 
@@ -187,6 +227,9 @@ void SPI::dequeue_transaction()
 void SPI::irq_handler_asynch(void)
 {
     int event = spi_irq_handler_asynch(&_spi);
+    if ((event & (SPI_EVENT_ALL | SPI_EVENT_INTERNAL_TRANSFER_COMPLETE)) && _deep_sleep_lock.locked()) {
+        _deep_sleep_lock.unlock();
+    }
     if (_callback && (event & SPI_EVENT_ALL)) {
         _callback.call(event & SPI_EVENT_ALL);
     }
@@ -30,6 +30,11 @@
 #include "platform/CircularBuffer.h"
 #include "platform/FunctionPointer.h"
 #include "platform/Transaction.h"
+#include "platform/DeepSleepLock.h"
+#endif
+
+#if DEVICE_CLOCK_SCALING
+#include "platform/mbed_clock.h"
 #endif
 
 namespace mbed {
@@ -118,6 +123,34 @@ public:
     */
     virtual int write(int value);
 
+    /** Write to the SPI Slave and obtain the response
+     *
+     *  The total number of bytes sent and received will be the maximum of
+     *  tx_length and rx_length. The bytes written will be padded with the
+     *  value set by set_default_write_value, 0xFF by default.
+     *
+     *  Unlike transfer(), this does not need asynchronous SPI, and the
+     *  frames are sent back to back in one call to the HAL.
+     *
+     *  @param tx_buffer Pointer to the byte-array of data to write to the device
+     *  @param tx_length Number of bytes to write, may be zero
+     *  @param rx_buffer Pointer to the byte-array of data to read from the device
+     *  @param rx_length Number of bytes to read, may be zero
+     *  @returns
+     *      The number of bytes written and read from the device. This is
+     *      maximum of tx_length and rx_length.
+     */
+    virtual int write(const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length);
+
+    /** Set default write data
+      * SPI requires the master to send some data during a read operation.
+      * Different devices may require different default byte values.
+      * For example: A SD Card requires default bytes to be 0xFF.
+      *
+      * @param data Default character to be transmitted while read operation
+      */
+    void set_default_write_value(char data);
+
     /** Acquire exclusive access to this SPI bus
      */
     virtual void lock(void);
@@ -246,14 +279,20 @@ protected:
     CThunk<SPI> _irq;
     event_callback_t _callback;
     DMAUsage _usage;
+    DeepSleepLock _deep_sleep_lock;
 #endif
 
     void aquire(void);
+#if DEVICE_CLOCK_SCALING
+    static void clock_changed(void);
+    static SingletonPtr<CallChainEntry> _clock_entry;
+#endif
     static SPI *_owner;
     static SingletonPtr<PlatformMutex> _mutex;
     int _bits;
     int _mode;
     int _hz;
+    char _write_fill;
 };
 
 } // namespace mbed
@@ -0,0 +1,255 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "drivers/SPIBus.h"
+#include "platform/critical.h"
+
+#if DEVICE_SPI
+
+namespace mbed {
+
+SPIBus::SPIBus(PinName mosi, PinName miso, PinName sclk) :
+        SPI(mosi, miso, sclk),
+        _current(NULL)
+#if DEVICE_SPI_ASYNCH
+        , _active(-1),
+        _claimed(false),
+        _order(0)
+#endif
+{
+#if DEVICE_SPI_ASYNCH
+    for (int i = 0; i < MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE; i++) {
+        _requests[i].device = NULL;
+    }
+    _callback = callback(this, &SPIBus::transfer_done);
+    _irq.callback(&SPIBus::irq_handler_asynch);
+#endif
+}
+
+SPIBus::~SPIBus() {
+#if DEVICE_SPI_ASYNCH
+    abort_transfer();
+#endif
+}
+
+void SPIBus::configure(SPIDevice *device) {
+    // another SPI on the peripheral may have changed it
+    if (_current != device || _owner != this) {
+        spi_format(&_spi, device->_bits, device->_mode, 0);
+        spi_frequency(&_spi, device->_hz);
+        _owner = this;
+        _current = device;
+    }
+}
+
+void SPIBus::invalidate(SPIDevice *device) {
+    core_util_critical_section_enter();
+    if (_current == device) {
+        _current = NULL;
+    }
+    core_util_critical_section_exit();
+}
+
+void SPIBus::select(SPIDevice *device) {
+    lock();
+#if DEVICE_SPI_ASYNCH
+    // wait for the running transfer, the queue waits for us afterwards
+    while (true) {
+        core_util_critical_section_enter();
+        if (_active < 0) {
+            _claimed = true;
+            core_util_critical_section_exit();
+            break;
+        }
+        core_util_critical_section_exit();
+    }
+#endif
+    configure(device);
+    if (device->_cs.is_connected()) {
+        device->_cs = 0;
+    }
+}
+
+void SPIBus::deselect(SPIDevice *device) {
+    if (device->_cs.is_connected()) {
+        device->_cs = 1;
+    }
+#if DEVICE_SPI_ASYNCH
+    core_util_critical_section_enter();
+    _claimed = false;
+    schedule();
+    core_util_critical_section_exit();
+#endif
+    unlock();
+}
+
+#if DEVICE_SPI_ASYNCH
+
+int SPIBus::queue(SPIDevice *device, const void *tx_buffer, int tx_length, void *rx_buffer, int rx_length,
+                  unsigned char bit_width, const event_callback_t &callback, int event) {
+    int ret = -1;
+
+    core_util_critical_section_enter();
+    for (int i = 0; i < MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE; i++) {
+        Request &r = _requests[i];
+        if (r.device == NULL) {
+            r.device = device;
+            r.tx_buffer = tx_buffer;
+            r.tx_length = tx_length;
+            r.rx_buffer = rx_buffer;
+            r.rx_length = rx_length;
+            r.bit_width = bit_width;
+            r.callback = callback;
+            r.event = event;
+            r.order = _order++;
+            schedule();
+            ret = 0;
+            break;
+        }
+    }
+    core_util_critical_section_exit();
+
+    return ret;
+}
+
+void SPIBus::schedule() {
+    if (_claimed || _active >= 0) {
+        return;
+    }
+
+    int next = -1;
+    for (int i = 0; i < MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE; i++) {
+        Request &r = _requests[i];
+        if (r.device == NULL) {
+            continue;
+        }
+        if (next < 0) {
+            next = i;
+            continue;
+        }
+
+        Request &n = _requests[next];
+        if (r.device->_priority != n.device->_priority) {
+            if (r.device->_priority > n.device->_priority) {
+                next = i;
+            }
+            continue;
+        }
+        // batch the transfers of the current device
+        bool r_current = r.device == _current;
+        bool n_current = n.device == _current;
+        if (r_current != n_current) {
+            if (r_current) {
+                next = i;
+            }
+            continue;
+        }
+        if ((int32_t)(r.order - n.order) < 0) {
+            next = i;
+        }
+    }
+    if (next < 0) {
+        return;
+    }
+
+    Request &r = _requests[next];
+    _active = next;
+    configure(r.device);
+    if (r.device->_cs.is_connected()) {
+        r.device->_cs = 0;
+    }
+    // all events, so the bus always knows when the transfer is over,
+    // SPI::irq_handler_asynch releases the deep sleep lock
+    _deep_sleep_lock.lock();
+    spi_master_transfer(&_spi, r.tx_buffer, r.tx_length, r.rx_buffer, r.rx_length, r.bit_width,
+                        _irq.entry(), SPI_EVENT_ALL, _usage);
+}
+
+void SPIBus::transfer_done(int event) {
+    Request &r = _requests[_active];
+    if (r.device->_cs.is_connected()) {
+        r.device->_cs = 1;
+    }
+
+    event_callback_t done = r.callback;
+    int mask = r.event;
+    r.device = NULL;
+    _active = -1;
+
+    // let the callback queue a follow-up before another device is picked
+    if (done && (event & mask)) {
+        done.call(event & mask);
+    }
+    schedule();
+}
+
+#endif
+
+SPIDevice::SPIDevice(SPIBus &bus, PinName cs, int bits, int mode, int hz, int priority) :
+        _bus(bus),
+        _cs(cs, 1),
+        _bits(bits),
+        _mode(mode),
+        _hz(hz),
+        _priority(priority),
+        _selected(0) {
+}
+
+void SPIDevice::format(int bits, int mode) {
+    _bus.lock();
+    _bits = bits;
+    _mode = mode;
+    _bus.invalidate(this);
+    _bus.unlock();
+}
+
+void SPIDevice::frequency(int hz) {
+    _bus.lock();
+    _hz = hz;
+    _bus.invalidate(this);
+    _bus.unlock();
+}
+
+void SPIDevice::select() {
+    _bus.lock();
+    if (_selected++ == 0) {
+        _bus.select(this);
+    }
+}
+
+void SPIDevice::deselect() {
+    if (--_selected == 0) {
+        _bus.deselect(this);
+    }
+    _bus.unlock();
+}
+
+int SPIDevice::write(int value) {
+    select();
+    int ret = spi_master_write(&_bus._spi, value);
+    deselect();
+    return ret;
+}
+
+int SPIDevice::write(const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length) {
+    select();
+    int ret = spi_master_block_write(&_bus._spi, tx_buffer, tx_length, rx_buffer, rx_length, SPI_FILL_CHAR);
+    deselect();
+    return ret;
+}
+
+} // namespace mbed
+
+#endif
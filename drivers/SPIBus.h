@@ -0,0 +1,248 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_SPIBUS_H
+#define MBED_SPIBUS_H
+
+#include "platform/platform.h"
+
+#if DEVICE_SPI
+
+#include "drivers/SPI.h"
+#include "drivers/DigitalOut.h"
+
+#ifndef MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE
+#define MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE 8
+#endif
+
+namespace mbed {
+/** \addtogroup drivers */
+/** @{*/
+
+class SPIDevice;
+
+/** A SPI master shared by several SPIDevices
+ *
+ *  The bus drives the chip select of each device and only reconfigures the
+ *  peripheral when the next transfer is for a device with a different
+ *  format or frequency.
+ *
+ *  Non-blocking transfers of all the devices go in one queue of
+ *  drivers.spi-bus-queue-size entries. When the bus is free, the transfer
+ *  of the highest priority device starts. Between devices of the same
+ *  priority, transfers of the device that used the bus last go first, so
+ *  back-to-back transfers to a device are not interleaved with
+ *  reconfigurations, then transfers start in the order they were queued.
+ *  A running transfer is never interrupted, so a device that must not wait
+ *  long, like a radio, needs the other devices to split long transfers.
+ *
+ *  Blocking transfers take the bus between two non-blocking ones.
+ *
+ * @Note Synchronization level: Thread safe
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * SPIBus bus(SPI_MOSI, SPI_MISO, SPI_SCK);
+ * SPIDevice flash(bus, D10, 8, 0, 20000000);
+ * SPIDevice radio(bus, D9, 8, 0, 8000000, 1);
+ *
+ * int main() {
+ *     char cmd[4] = { 0x03, 0x00, 0x00, 0x00 };
+ *     char data[16];
+ *
+ *     flash.select();
+ *     flash.write(cmd, sizeof(cmd), NULL, 0);
+ *     flash.write(NULL, 0, data, sizeof(data));
+ *     flash.deselect();
+ * }
+ * @endcode
+ */
+class SPIBus : private SPI {
+
+public:
+    /** Create a SPI bus connected to the specified pins
+     *
+     *  mosi or miso can be specfied as NC if not used
+     *
+     *  @param mosi SPI Master Out, Slave In pin
+     *  @param miso SPI Master In, Slave Out pin
+     *  @param sclk SPI Clock pin
+     */
+    SPIBus(PinName mosi, PinName miso, PinName sclk);
+
+    virtual ~SPIBus();
+
+#if DEVICE_SPI_ASYNCH
+    using SPI::set_dma_usage;
+#endif
+
+private:
+    friend class SPIDevice;
+
+    /* Claim the bus for blocking transfers of a device and select it */
+    void select(SPIDevice *device);
+    /* Deselect the device and hand the bus back to the queue */
+    void deselect(SPIDevice *device);
+    /* Apply the format and frequency of a device if not already set */
+    void configure(SPIDevice *device);
+    /* Forget the configuration of a device that changed it */
+    void invalidate(SPIDevice *device);
+
+    SPIDevice *_current;
+
+#if DEVICE_SPI_ASYNCH
+    struct Request {
+        SPIDevice *device;
+        const void *tx_buffer;
+        int tx_length;
+        void *rx_buffer;
+        int rx_length;
+        unsigned char bit_width;
+        event_callback_t callback;
+        int event;
+        uint32_t order;
+    };
+
+    int queue(SPIDevice *device, const void *tx_buffer, int tx_length, void *rx_buffer, int rx_length,
+              unsigned char bit_width, const event_callback_t &callback, int event);
+    /* Start the next queued transfer if the bus is free, in a critical section */
+    void schedule();
+    void transfer_done(int event);
+
+    Request _requests[MBED_CONF_DRIVERS_SPI_BUS_QUEUE_SIZE];
+    /* Index of the running request, -1 if none */
+    volatile int _active;
+    /* Held by blocking transfers */
+    volatile bool _claimed;
+    uint32_t _order;
+#endif
+};
+
+/** A device on a SPIBus, with its own chip select, format, frequency and
+ *  priority
+ *
+ *  The chip select is active low, and asserted for the duration of each
+ *  transfer, or from select() to deselect().
+ *
+ * @Note Synchronization level: Thread safe
+ */
+class SPIDevice {
+
+public:
+    /** Create a device on a SPI bus
+     *
+     *  @param bus      The bus the device is connected to
+     *  @param cs       Chip select pin of the device, NC if not used
+     *  @param bits     Number of bits per SPI frame (4 - 16)
+     *  @param mode     Clock polarity and phase mode (0 - 3)
+     *  @param hz       SCLK frequency in hz
+     *  @param priority Priority of the non-blocking transfers, higher goes first
+     */
+    SPIDevice(SPIBus &bus, PinName cs, int bits = 8, int mode = 0, int hz = 1000000, int priority = 0);
+
+    /** Configure the data transmission format of the device
+     *
+     *  @param bits Number of bits per SPI frame (4 - 16)
+     *  @param mode Clock polarity and phase mode (0 - 3)
+     */
+    void format(int bits, int mode = 0);
+
+    /** Set the SCLK frequency of the device
+     *
+     *  @param hz SCLK frequency in hz (default = 1MHz)
+     */
+    void frequency(int hz = 1000000);
+
+    /** Claim the bus and select the device until deselect()
+     *
+     *  Blocking transfers in between keep the chip select asserted. Calls
+     *  can be nested.
+     */
+    void select();
+
+    /** Deselect the device and release the bus
+     */
+    void deselect();
+
+    /** Write a frame to the device and return the response
+     *
+     *  @param value Data to be sent to the device
+     *
+     *  @returns
+     *    Response from the device
+     */
+    int write(int value);
+
+    /** Write and read bytes in one selection of the device
+     *
+     *  The longer of the two lengths is clocked, 0xFF is sent past the end
+     *  of tx_buffer and the data received past the end of rx_buffer is
+     *  dropped.
+     *
+     *  @param tx_buffer Data to send, NULL to send 0xFF
+     *  @param tx_length Number of bytes to send
+     *  @param rx_buffer Buffer for the received data, NULL to drop it
+     *  @param rx_length Number of bytes to receive
+     *
+     *  @returns
+     *    The number of frames clocked
+     */
+    int write(const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length);
+
+#if DEVICE_SPI_ASYNCH
+
+    /** Queue a non-blocking transfer to the device
+     *
+     *  The chip select is asserted when the transfer starts and released
+     *  before the callback is called. The buffers must stay valid until then.
+     *
+     * @param tx_buffer The TX buffer with data to be transfered. If NULL is passed,
+     *                  the default SPI value is sent
+     * @param tx_length The length of TX buffer in bytes
+     * @param rx_buffer The RX buffer which is used for received data. If NULL is passed,
+     *                  received data are ignored
+     * @param rx_length The length of RX buffer in bytes
+     * @param callback  The event callback function
+     * @param event     The logical OR of events to modify. Look at spi hal header file for SPI events.
+     * @return Zero if the transfer was queued, or -1 if the queue is full
+     */
+    template<typename Type>
+    int transfer(const Type *tx_buffer, int tx_length, Type *rx_buffer, int rx_length, const event_callback_t& callback, int event = SPI_EVENT_COMPLETE) {
+        return _bus.queue(this, tx_buffer, tx_length, rx_buffer, rx_length, sizeof(Type)*8, callback, event);
+    }
+
+#endif
+
+private:
+    friend class SPIBus;
+
+    SPIBus &_bus;
+    DigitalOut _cs;
+    int _bits;
+    int _mode;
+    int _hz;
+    int _priority;
+    int _selected;
+};
+
+} // namespace mbed
+
+#endif
+
+#endif
+
+/** @}*/
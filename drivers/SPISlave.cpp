@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "drivers/SPISlave.h"
+#if DEVICE_SPISLAVE_ASYNCH
+#include "platform/critical.h"
+#endif
 
 #if DEVICE_SPISLAVE
 
@@ -24,6 +27,14 @@ SPISlave::SPISlave(PinName mosi, PinName miso, PinName sclk, PinName ssel) :
     _bits(8),
     _mode(0),
     _hz(1000000)
+#if DEVICE_SPISLAVE_ASYNCH
+    , _irq(this)
+    , _event(0)
+    , _rx_buffer(NULL)
+    , _rx_length(0)
+    , _rx_index(0)
+    , _rx_count(0)
+#endif
  {
     spi_init(&_spi, mosi, miso, sclk, ssel);
     spi_format(&_spi, _bits, _mode, 1);
@@ -53,6 +64,96 @@ void SPISlave::reply(int value) {
     spi_slave_write(&_spi, value);
 }
 
+#if DEVICE_SPISLAVE_ASYNCH
+
+int SPISlave::listen(uint8_t *buffer, size_t length, const event_callback_t &callback, int event) {
+    core_util_critical_section_enter();
+    if (spi_slave_active(&_spi)) {
+        core_util_critical_section_exit();
+        return -1;
+    }
+    _callback = callback;
+    _event = event;
+    _rx_buffer = buffer;
+    _rx_length = length;
+    _rx_index = 0;
+    _rx_count = 0;
+    _irq.callback(&SPISlave::irq_handler_asynch);
+    // overflows are found at the end of the transactions
+    int hal_event = (event & SPI_EVENT_RX_OVERFLOW) ? (event | SPI_EVENT_COMPLETE) : event;
+    int ret = spi_slave_start_asynch(&_spi, buffer, length, _irq.entry(), hal_event);
+    if (ret == 0) {
+        // the DMA requests stop in deep sleep
+        _deep_sleep_lock.lock();
+    }
+    core_util_critical_section_exit();
+    return ret;
+}
+
+void SPISlave::stop_listening() {
+    core_util_critical_section_enter();
+    if (spi_slave_active(&_spi)) {
+        spi_slave_abort_asynch(&_spi);
+        _deep_sleep_lock.unlock();
+    }
+    core_util_critical_section_exit();
+}
+
+bool SPISlave::listening() {
+    return spi_slave_active(&_spi);
+}
+
+void SPISlave::reply(const uint8_t *data, size_t length) {
+    spi_slave_reply_asynch(&_spi, data, length);
+}
+
+// Skips the frames the ring overwrote, returns the number of frames left
+size_t SPISlave::drop_overwritten() {
+    uint32_t pending = spi_slave_received(&_spi) - _rx_count;
+    if (pending > _rx_length) {
+        uint32_t dropped = pending - _rx_length;
+        _rx_count += dropped;
+        _rx_index = (_rx_index + dropped) % _rx_length;
+        pending = _rx_length;
+    }
+    return pending;
+}
+
+size_t SPISlave::readable() {
+    core_util_critical_section_enter();
+    size_t pending = spi_slave_active(&_spi) ? drop_overwritten() : 0;
+    core_util_critical_section_exit();
+    return pending;
+}
+
+size_t SPISlave::read_buffered(uint8_t *data, size_t length) {
+    size_t n = readable();
+    if (n > length) {
+        n = length;
+    }
+    for (size_t i = 0; i < n; i++) {
+        data[i] = _rx_buffer[_rx_index];
+        if (++_rx_index == _rx_length) {
+            _rx_index = 0;
+        }
+    }
+    _rx_count += n;
+    return n;
+}
+
+void SPISlave::irq_handler_asynch(void) {
+    int event = spi_slave_irq_handler_asynch(&_spi);
+    if ((event & SPI_EVENT_COMPLETE) && spi_slave_received(&_spi) - _rx_count > _rx_length) {
+        event |= SPI_EVENT_RX_OVERFLOW;
+    }
+    event &= _event;
+    if (_callback && event) {
+        _callback.call(event);
+    }
+}
+
+#endif
+
 } // namespace mbed
 
 #endif
@@ -21,6 +21,11 @@
 #if DEVICE_SPISLAVE
 
 #include "hal/spi_api.h"
+#if DEVICE_SPISLAVE_ASYNCH
+#include "platform/CThunk.h"
+#include "platform/FunctionPointer.h"
+#include "platform/DeepSleepLock.h"
+#endif
 
 namespace mbed {
 /** \addtogroup drivers */
@@ -111,12 +116,88 @@ public:
      */
     void reply(int value);
 
+#if DEVICE_SPISLAVE_ASYNCH
+
+    /** Receive into a ring buffer in the background
+     *
+     *  DMA stores every frame, 8 bits at most, and sends the reply set by
+     *  reply(const uint8_t *, size_t), so multi-byte transactions run with no
+     *  interrupt per frame. The callback gets SPI_EVENT_COMPLETE when the
+     *  master deselects the slave, at the end of each transaction, and
+     *  SPI_EVENT_RX_OVERFLOW along with it once frames were overwritten before
+     *  being read.
+     *
+     *  @param buffer   The ring, in use until stop_listening()
+     *  @param length   The size of the ring in frames
+     *  @param callback Called from interrupt context with the events
+     *  @param event    The logical OR of the events calling the callback
+     *  @return 0 if listening started, -1 if already listening or the
+     *          target can't listen with these pins and format
+     */
+    int listen(uint8_t *buffer, size_t length, const event_callback_t &callback,
+               int event = SPI_EVENT_COMPLETE | SPI_EVENT_RX_OVERFLOW);
+
+    /** Stop receiving in the background
+     */
+    void stop_listening();
+
+    /** Check if receiving in the background
+     *
+     *  @return true between listen() and stop_listening()
+     */
+    bool listening();
+
+    /** Set the frames sent in the transactions, while listening
+     *
+     *  Each transaction sends them from the start, then 0xFF once they run
+     *  out. Takes effect at once, so set it between transactions, e.g. from
+     *  the callback on SPI_EVENT_COMPLETE.
+     *
+     *  @param data   The frames, in use until replaced or stop_listening()
+     *  @param length The number of frames, 0 to send 0xFF only
+     */
+    void reply(const uint8_t *data, size_t length);
+
+    /** Get the number of frames received and not read yet
+     *
+     *  The ring holds the most recent frames, older ones are dropped.
+     *
+     *  @return The number of frames read_buffered() can read
+     */
+    size_t readable();
+
+    /** Read frames received in the background, oldest first
+     *
+     *  @param data   The buffer to copy the frames to
+     *  @param length The size of the buffer
+     *  @return The number of frames read
+     */
+    size_t read_buffered(uint8_t *data, size_t length);
+
+#endif
+
 protected:
+#if DEVICE_SPISLAVE_ASYNCH
+    void irq_handler_asynch(void);
+    size_t drop_overwritten();
+#endif
+
     spi_t _spi;
 
     int _bits;
     int _mode;
     int _hz;
+
+#if DEVICE_SPISLAVE_ASYNCH
+    CThunk<SPISlave> _irq;
+    event_callback_t _callback;
+    int _event;
+    uint8_t *_rx_buffer;
+    size_t _rx_length;
+    size_t _rx_index;
+    uint32_t _rx_count;
+    DeepSleepLock _deep_sleep_lock;
+#endif
 };
 
 } // namespace mbed
@@ -36,6 +36,19 @@ int Serial::_putc(int c) {
     return _base_putc(c);
 }
 
+short Serial::poll(short events) const {
+    // readable and writeable only read the UART flags
+    Serial *self = const_cast<Serial *>(this);
+    short revents = 0;
+    if ((events & POLLIN) && self->SerialBase::readable()) {
+        revents |= POLLIN;
+    }
+    if ((events & POLLOUT) && self->SerialBase::writeable()) {
+        revents |= POLLOUT;
+    }
+    return revents;
+}
+
 void Serial::lock() {
     _mutex.lock();
 }
@@ -52,6 +52,7 @@ namespace mbed {
 class Serial : public SerialBase, public Stream {
 
 public:
+    using SerialBase::readable;
 #if DEVICE_SERIAL_ASYNCH
     using SerialBase::read;
     using SerialBase::write;
@@ -81,6 +82,18 @@ public:
      */
     Serial(PinName tx, PinName rx, int baud);
 
+    /** Check the events the port is ready for
+     *
+     *  The UART flags are read as they are, no interrupt calls
+     *  mbed::poll_wake() when they change, so mbed::poll() sees a change
+     *  only with its timeout or another handle waking it. BufferedSerial
+     *  wakes poll() itself.
+     *
+     *  @param events Mask of POLLIN and POLLOUT to check
+     *  @returns Mask of the events ready
+     */
+    virtual short poll(short events) const;
+
 protected:
     virtual int _getc();
     virtual int _putc(int c);
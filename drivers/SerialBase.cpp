@@ -38,7 +38,21 @@ SerialBase::SerialBase(PinName tx, PinName rx, int baud) :
     serial_init(&_serial, tx, rx);
     serial_baud(&_serial, _baud);
     serial_irq_handler(&_serial, SerialBase::_irq_handler, (uint32_t)this);
+
+#if DEVICE_CLOCK_SCALING
+    // The baud rate divider follows the bus clock
+    _clock_entry.attach(callback(this, &SerialBase::clock_changed));
+    mbed_clock_attach(&_clock_entry);
+#endif
+}
+
+#if DEVICE_CLOCK_SCALING
+void SerialBase::clock_changed() {
+    lock();
+    serial_baud(&_serial, _baud);
+    unlock();
 }
+#endif
 
 void SerialBase::baud(int baudrate) {
     lock();
@@ -173,17 +187,25 @@ void SerialBase::start_write(const void *buffer, int buffer_size, char buffer_wi
     _tx_callback = callback;
 
     _thunk_irq.callback(&SerialBase::interrupt_handler_asynch);
+    // the clocks must run until the transfer ends
+    _tx_deep_sleep_lock.lock();
     serial_tx_asynch(&_serial, buffer, buffer_size, buffer_width, _thunk_irq.entry(), event, _tx_usage);
 }
 
 void SerialBase::abort_write(void)
 {
     serial_tx_abort_asynch(&_serial);
+    if (_tx_deep_sleep_lock.locked()) {
+        _tx_deep_sleep_lock.unlock();
+    }
 }
 
 void SerialBase::abort_read(void)
 {
     serial_rx_abort_asynch(&_serial);
+    if (_rx_deep_sleep_lock.locked()) {
+        _rx_deep_sleep_lock.unlock();
+    }
 }
 
 int SerialBase::set_dma_usage_tx(DMAUsage usage)
@@ -228,12 +250,25 @@ void SerialBase::start_read(void *buffer, int buffer_size, char buffer_width, co
 {
     _rx_callback = callback;
     _thunk_irq.callback(&SerialBase::interrupt_handler_asynch);
+    _rx_deep_sleep_lock.lock();
     serial_rx_asynch(&_serial, buffer, buffer_size, buffer_width, _thunk_irq.entry(), event, char_match, _rx_usage);
 }
 
+int SerialBase::read_count() const
+{
+    return _serial.rx_buff.pos;
+}
+
 void SerialBase::interrupt_handler_asynch(void)
 {
     int event = serial_irq_handler_asynch(&_serial);
+    // the events may be masked, the transfers tell when they are over
+    if (_rx_deep_sleep_lock.locked() && !serial_rx_active(&_serial)) {
+        _rx_deep_sleep_lock.unlock();
+    }
+    if (_tx_deep_sleep_lock.locked() && !serial_tx_active(&_serial)) {
+        _tx_deep_sleep_lock.unlock();
+    }
     int rx_event = event & SERIAL_EVENT_RX_MASK;
     if (_rx_callback && rx_event) {
         _rx_callback.call(rx_event);
@@ -28,6 +28,11 @@
 #if DEVICE_SERIAL_ASYNCH
 #include "CThunk.h"
 #include "dma_api.h"
+#include "DeepSleepLock.h"
+#endif
+
+#if DEVICE_CLOCK_SCALING
+#include "platform/mbed_clock.h"
 #endif
 
 namespace mbed {
@@ -207,6 +212,21 @@ public:
      */
     int read(uint16_t *buffer, int length, const event_callback_t& callback, int event = SERIAL_EVENT_RX_COMPLETE, unsigned char char_match = SERIAL_RESERVED_CHAR_MATCH);
 
+    /** Get the number of words the last asynchronous read stored
+     *
+     *  Valid in the RX event callback, to find the end of a frame the read
+     *  ended on. On STM32 targets the count after
+     *  SERIAL_EVENT_RX_CHARACTER_MATCH includes the matching character;
+     *  other targets may stop before it.
+     *
+     *  SERIAL_EVENT_RX_IDLE is only reported on STM32F4, from the UART
+     *  idle-line interrupt: those reads are interrupt-driven and do not use
+     *  DMA.
+     *
+     *  @returns The number of words in the read buffer
+     */
+    int read_count() const;
+
     /** Abort the on-going read transfer
      */
     void abort_read();
@@ -234,8 +254,16 @@ protected:
 protected:
     SerialBase(PinName tx, PinName rx, int baud);
     virtual ~SerialBase() {
+#if DEVICE_CLOCK_SCALING
+        mbed_clock_detach(&_clock_entry);
+#endif
     }
 
+#if DEVICE_CLOCK_SCALING
+    void clock_changed();
+    CallChainEntry _clock_entry;
+#endif
+
     int _base_getc();
     int _base_putc(int c);
 
@@ -245,6 +273,8 @@ protected:
     event_callback_t _rx_callback;
     DMAUsage _tx_usage;
     DMAUsage _rx_usage;
+    DeepSleepLock _tx_deep_sleep_lock;
+    DeepSleepLock _rx_deep_sleep_lock;
 #endif
 
     serial_t         _serial;
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 #include "drivers/Stream.h"
+#include "platform/mbed_printf.h"
 
 namespace mbed {
 
@@ -115,12 +116,22 @@ int Stream::printf(const char* format, ...) {
     std::va_list arg;
     va_start(arg, format);
     fflush(_file);
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF
+    int r = mbed_vxprintf(printf_putc, this, format, arg);
+#else
     int r = vfprintf(_file, format, arg);
+#endif
     va_end(arg);
     unlock();
     return r;
 }
 
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF
+void Stream::printf_putc(char c, void *ctx) {
+    static_cast<Stream *>(ctx)->_putc(c);
+}
+#endif
+
 int Stream::scanf(const char* format, ...) {
     lock();
     std::va_list arg;
@@ -135,7 +146,11 @@ int Stream::scanf(const char* format, ...) {
 int Stream::vprintf(const char* format, std::va_list args) {
     lock();
     fflush(_file);
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF
+    int r = mbed_vxprintf(printf_putc, this, format, args);
+#else
     int r = vfprintf(_file, format, args);
+#endif
     unlock();
     return r;
 }
@@ -67,6 +67,11 @@ protected:
 private:
     Stream(const Stream&);
     Stream & operator = (const Stream&);
+
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF
+    /* Writes the characters of the compact printf straight to _putc */
+    static void printf_putc(char c, void *ctx);
+#endif
 };
 
 } // namespace mbed
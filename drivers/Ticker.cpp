@@ -23,18 +23,18 @@
 namespace mbed {
 
 void Ticker::detach() {
-    core_util_critical_section_enter();
+    uint32_t mask = core_util_irq_mask_enter();
     remove();
     _function.attach(0);
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 void Ticker::setup(timestamp_t t) {
-    core_util_critical_section_enter();
+    uint32_t mask = core_util_irq_mask_enter();
     remove();
     _delay = t;
     insert(_delay + ticker_read(_ticker_data));
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 void Ticker::handler() {
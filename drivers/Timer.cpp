@@ -20,60 +20,72 @@
 
 namespace mbed {
 
-Timer::Timer() : _running(), _start(), _time(), _ticker_data(get_us_ticker_data()) {
+Timer::Timer() : _running(), _start(), _time(), _ticker_data(get_us_ticker_data()), _lock_deep_sleep(true) {
     reset();
 }
 
-Timer::Timer(const ticker_data_t *data) : _running(), _start(), _time(), _ticker_data(data) {
+Timer::Timer(const ticker_data_t *data) : _running(), _start(), _time(), _ticker_data(data),
+        _lock_deep_sleep(data == get_us_ticker_data()) {
     reset();
 }
 
 void Timer::start() {
-    core_util_critical_section_enter();
+    uint32_t mask = core_util_irq_mask_enter();
     if (!_running) {
-        _start = ticker_read(_ticker_data);
+        // the us ticker stops in deep sleep
+        if (_lock_deep_sleep) {
+            _deep_sleep_lock.lock();
+        }
+        _start = ticker_read_us64(_ticker_data);
         _running = 1;
     }
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 void Timer::stop() {
-    core_util_critical_section_enter();
+    uint32_t mask = core_util_irq_mask_enter();
     _time += slicetime();
+    if (_running && _lock_deep_sleep) {
+        _deep_sleep_lock.unlock();
+    }
     _running = 0;
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 int Timer::read_us() {
-    core_util_critical_section_enter();
-    int time = _time + slicetime();
-    core_util_critical_section_exit();
+    return read_high_resolution_us();
+}
+
+us_timestamp_t Timer::read_high_resolution_us() {
+    uint32_t mask = core_util_irq_mask_enter();
+    us_timestamp_t time = _time + slicetime();
+    core_util_irq_mask_exit(mask);
     return time;
 }
 
 float Timer::read() {
-    return (float)read_us() / 1000000.0f;
+    return (float)read_high_resolution_us() / 1000000.0f;
 }
 
 int Timer::read_ms() {
-    return read_us() / 1000;
+    return read_high_resolution_us() / 1000;
 }
 
-int Timer::slicetime() {
-    core_util_critical_section_enter();
-    int ret = 0;
+us_timestamp_t Timer::slicetime() {
+    uint32_t mask = core_util_irq_mask_enter();
+    us_timestamp_t ret = 0;
     if (_running) {
-        ret = ticker_read(_ticker_data) - _start;
+        ret = ticker_read_us64(_ticker_data) - _start;
     }
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
     return ret;
 }
 
 void Timer::reset() {
-    core_util_critical_section_enter();
-    _start = ticker_read(_ticker_data);
+    uint32_t mask = core_util_irq_mask_enter();
+    _start = ticker_read_us64(_ticker_data);
     _time = 0;
-    core_util_critical_section_exit();
+    core_util_irq_mask_exit(mask);
 }
 
 Timer::operator float() {
@@ -18,12 +18,15 @@
 
 #include "platform/platform.h"
 #include "hal/ticker_api.h"
+#include "platform/DeepSleepLock.h"
 
 namespace mbed {
 /** \addtogroup drivers */
 /** @{*/
 
 /** A general purpose timer
+ *
+ * A running Timer on the us ticker locks deep sleep, which stops it.
  *
  * @Note Synchronization level: Interrupt safe
  *
@@ -78,16 +81,22 @@ public:
      */
     int read_us();
 
+    /** Get the time passed in micro-seconds, without wrapping
+     */
+    us_timestamp_t read_high_resolution_us();
+
     /** An operator shorthand for read()
      */
     operator float();
 
 protected:
-    int slicetime();
+    us_timestamp_t slicetime();
     int _running;          // whether the timer is running
-    unsigned int _start;   // the start time of the latest slice
-    int _time;             // any accumulated time from previous slices
+    us_timestamp_t _start; // the start time of the latest slice
+    us_timestamp_t _time;  // any accumulated time from previous slices
     const ticker_data_t *_ticker_data;
+    bool _lock_deep_sleep; // whether the ticker stops in deep sleep
+    DeepSleepLock _deep_sleep_lock;
 };
 
 } // namespace mbed
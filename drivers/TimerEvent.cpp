@@ -22,11 +22,11 @@
 
 namespace mbed {
 
-TimerEvent::TimerEvent() : event(), _ticker_data(get_us_ticker_data()) {
+TimerEvent::TimerEvent() : event(), _ticker_data(get_us_ticker_data()), _slack(0) {
     ticker_set_handler(_ticker_data, (&TimerEvent::irq));
 }
 
-TimerEvent::TimerEvent(const ticker_data_t *data) : event(), _ticker_data(data) {
+TimerEvent::TimerEvent(const ticker_data_t *data) : event(), _ticker_data(data), _slack(0) {
     ticker_set_handler(_ticker_data, (&TimerEvent::irq));
 }
 
@@ -41,7 +41,16 @@ TimerEvent::~TimerEvent() {
 
 // insert in to linked list
 void TimerEvent::insert(timestamp_t timestamp) {
-    ticker_insert_event(_ticker_data, &event, timestamp, (uint32_t)this);
+    ticker_insert_event_slack(_ticker_data, &event, timestamp, _slack, (uint32_t)this);
+}
+
+void TimerEvent::insert_absolute(us_timestamp_t timestamp) {
+    us_timestamp_t now = ticker_read_us64(_ticker_data);
+    if (timestamp < now) {
+        // stays in the past rather than wrapping into the future
+        timestamp = now;
+    }
+    ticker_insert_event_slack(_ticker_data, &event, (timestamp_t)timestamp, _slack, (uint32_t)this);
 }
 
 void TimerEvent::remove() {
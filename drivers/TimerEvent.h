@@ -40,6 +40,18 @@ public:
      */
     virtual ~TimerEvent();
 
+    /** Let the event fire late, to share the interrupt of other events
+     *
+     *  With hal.ticker-slack, events whose windows overlap fire in one
+     *  interrupt, so on low power devices they cost one wakeup. Applies
+     *  from the next time the event is set.
+     *
+     *  @param slack_us Microseconds the event may fire late, less than 2^30
+     */
+    void set_slack(uint32_t slack_us) {
+        _slack = slack_us;
+    }
+
 protected:
     // The handler called to service the timer event of the derived class
     virtual void handler() = 0;
@@ -47,12 +59,16 @@ protected:
     // insert in to linked list
     void insert(timestamp_t timestamp);
 
+    // insert at a time of ticker_read_us64 less than 2^31 us ahead, at once if it has passed
+    void insert_absolute(us_timestamp_t timestamp);
+
     // remove from linked list, if in it
     void remove();
 
     ticker_event_t event;
 
     const ticker_data_t *_ticker_data;
+    uint32_t _slack;
 };
 
 } // namespace mbed
@@ -0,0 +1,199 @@
+/* events
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "events/DeferredInterruptIn.h"
+
+#if DEVICE_INTERRUPTIN
+
+#include "hal/us_ticker_api.h"
+#include "platform/critical.h"
+
+namespace events {
+
+DeferredInterruptIn::DeferredInterruptIn(PinName pin, EventQueue *queue)
+    : InterruptIn(pin), _queue(queue), _dropped(0), _event(0),
+      _pending(false), _coalesce(false), _debounce_us(0), _burst(false),
+      _burst_level(false), _burst_start(0), _last_edge(0) {
+    _level = read();
+}
+
+DeferredInterruptIn::~DeferredInterruptIn() {
+    InterruptIn::rise(mbed::Callback<void()>());
+    InterruptIn::fall(mbed::Callback<void()>());
+    InterruptIn::filter(0);
+    if (_pending) {
+        _queue->cancel(_event);
+    }
+}
+
+void DeferredInterruptIn::rise(mbed::Callback<void(uint32_t)> func) {
+    _on_rise = func;
+    attach_irqs();
+}
+
+void DeferredInterruptIn::fall(mbed::Callback<void(uint32_t)> func) {
+    _on_fall = func;
+    attach_irqs();
+}
+
+void DeferredInterruptIn::debounce(uint32_t us) {
+    uint32_t width = InterruptIn::filter(us);
+
+    core_util_critical_section_enter();
+    _debounce_us = (width >= us) ? 0 : us;
+    _burst = false;
+    _level = read();
+    core_util_critical_section_exit();
+
+    attach_irqs();
+}
+
+void DeferredInterruptIn::coalesce(bool enable) {
+    _coalesce = enable;
+}
+
+void DeferredInterruptIn::attach_irqs() {
+    // debouncing follows the input level, which takes both edges
+    bool both = _debounce_us && (_on_rise || _on_fall);
+
+    if (_on_rise || both) {
+        InterruptIn::rise(mbed::callback(this, &DeferredInterruptIn::rise_irq));
+    } else {
+        InterruptIn::rise(mbed::Callback<void()>());
+    }
+    if (_on_fall || both) {
+        InterruptIn::fall(mbed::callback(this, &DeferredInterruptIn::fall_irq));
+    } else {
+        InterruptIn::fall(mbed::Callback<void()>());
+    }
+}
+
+void DeferredInterruptIn::rise_irq() {
+    edge_irq(true);
+}
+
+void DeferredInterruptIn::fall_irq() {
+    edge_irq(false);
+}
+
+void DeferredInterruptIn::edge_irq(bool rise) {
+    uint32_t now = us_ticker_read();
+    uint32_t delay_us = 0;
+
+    if (_debounce_us) {
+        _last_edge = now;
+        _burst_level = rise;
+        if (!_burst) {
+            _burst = true;
+            _burst_start = now;
+        }
+        delay_us = _debounce_us;
+    } else {
+        edge_t edge = { now, rise };
+        if (!_edges.push(edge)) {
+            _dropped = _dropped + 1;
+        }
+    }
+
+    // only the first edge since the last dispatch posts an event, if the
+    // queue is full the next edge tries again
+    if (!_pending) {
+        post(delay_us);
+    }
+}
+
+bool DeferredInterruptIn::post(uint32_t delay_us) {
+    core_util_critical_section_enter();
+    if (!_pending) {
+        int ms = (delay_us + 999) / 1000;
+        int id = _queue->call_in(ms, this, &DeferredInterruptIn::dispatch);
+        if (id) {
+            _event = id;
+            _pending = true;
+        }
+    }
+    bool posted = _pending;
+    core_util_critical_section_exit();
+    return posted;
+}
+
+void DeferredInterruptIn::dispatch() {
+    // edges recorded from here on post a new dispatch
+    _pending = false;
+
+    edge_t edge;
+    if (_coalesce) {
+        edge_t last[2];
+        bool seen[2] = { false, false };
+        bool rise_last = false;
+        while (_edges.pop(edge)) {
+            last[edge.rise] = edge;
+            seen[edge.rise] = true;
+            rise_last = edge.rise;
+        }
+
+        // in the order they happened
+        if (seen[!rise_last]) {
+            deliver(last[!rise_last]);
+        }
+        if (seen[rise_last]) {
+            deliver(last[rise_last]);
+        }
+    } else {
+        while (_edges.pop(edge)) {
+            deliver(edge);
+        }
+    }
+
+    if (_burst) {
+        settle();
+    }
+}
+
+void DeferredInterruptIn::deliver(const edge_t &edge) {
+    mbed::Callback<void(uint32_t)> &func = edge.rise ? _on_rise : _on_fall;
+    if (func) {
+        func(edge.timestamp);
+    }
+}
+
+void DeferredInterruptIn::settle() {
+    core_util_critical_section_enter();
+    uint32_t quiet = us_ticker_read() - _last_edge;
+    edge_t change = { _burst_start, _burst_level };
+    bool settled = quiet >= _debounce_us;
+    if (settled) {
+        _burst = false;
+    }
+    core_util_critical_section_exit();
+
+    if (!settled) {
+        // still bouncing, check again once it may have stopped; report the
+        // change early rather than never if the queue is full
+        if (post(_debounce_us - quiet)) {
+            return;
+        }
+        _burst = false;
+    }
+
+    if (change.rise != _level) {
+        _level = change.rise;
+        deliver(change);
+    }
+}
+
+}
+
+#endif
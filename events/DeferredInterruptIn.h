@@ -0,0 +1,158 @@
+/* events
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEFERRED_INTERRUPT_IN_H
+#define DEFERRED_INTERRUPT_IN_H
+
+#include "platform/platform.h"
+
+#if DEVICE_INTERRUPTIN
+
+#include "events/EventQueue.h"
+#include "drivers/InterruptIn.h"
+#include "platform/Callback.h"
+#include "platform/LockFreeCircularBuffer.h"
+
+namespace events {
+/** \addtogroup events */
+/** @{*/
+
+/** DeferredInterruptIn
+ *
+ *  InterruptIn whose rise and fall callbacks run on an event queue instead
+ *  of in interrupt context. The interrupt only records each edge and the
+ *  ticker time it happened at; a single event posted to the queue then
+ *  dispatches every edge recorded until it runs, so a burst of edges costs
+ *  one post. Edges arriving while the record is full are dropped and
+ *  counted.
+ *
+ *  With coalescing, each dispatch only calls the callbacks for the last
+ *  rising and the last falling edge it finds. With debouncing, an input
+ *  change is only reported once the input has been quiet for the debounce
+ *  time, with the time of the first edge of the change.
+ *
+ *  @Note Synchronization level: Interrupt safe
+ *
+ *  Example:
+ *  @code
+ *  #include "mbed.h"
+ *
+ *  EventQueue queue;
+ *  DeferredInterruptIn button(BUTTON1, &queue);
+ *
+ *  void pressed(uint32_t timestamp) {
+ *      printf("pressed at %lu us\n", timestamp);
+ *  }
+ *
+ *  int main() {
+ *      button.debounce(20000);
+ *      button.fall(pressed);
+ *      queue.dispatch_forever();
+ *  }
+ *  @endcode
+ */
+class DeferredInterruptIn : public mbed::InterruptIn {
+public:
+    /** Create a DeferredInterruptIn connected to the specified pin
+     *
+     *  @param pin      InterruptIn pin to connect to
+     *  @param queue    Event queue the callbacks are called from
+     */
+    DeferredInterruptIn(PinName pin, EventQueue *queue);
+
+    /** Detach the callbacks and cancel the pending dispatch
+     */
+    virtual ~DeferredInterruptIn();
+
+    /** Attach a function to call from the queue for each rising edge
+     *
+     *  @param func     Function called with the us ticker time of the edge,
+     *                  or 0 to set as none
+     */
+    void rise(mbed::Callback<void(uint32_t)> func);
+
+    /** Attach a function to call from the queue for each falling edge
+     *
+     *  @param func     Function called with the us ticker time of the edge,
+     *                  or 0 to set as none
+     */
+    void fall(mbed::Callback<void(uint32_t)> func);
+
+    /** Report input changes only once the input is stable
+     *
+     *  The pin glitch filter takes the debounce time when the target has
+     *  one wide enough, and software debouncing does the rest.
+     *
+     *  @param us       Time the input must be quiet after an edge, 0 to
+     *                  report every edge
+     */
+    void debounce(uint32_t us);
+
+    /** Only report the last rising and falling edges of each dispatch
+     *
+     *  @param enable   True to coalesce the edges, false to report all of them
+     */
+    void coalesce(bool enable);
+
+    /** Number of edges dropped because they arrived while the record was full
+     *
+     *  @return Edges dropped since the object was created
+     */
+    uint32_t dropped() const {
+        return _dropped;
+    }
+
+protected:
+    struct edge_t {
+        uint32_t timestamp;
+        bool rise;
+    };
+
+    void rise_irq();
+    void fall_irq();
+    void edge_irq(bool rise);
+    void attach_irqs();
+    bool post(uint32_t delay_us);
+    void dispatch();
+    void deliver(const edge_t &edge);
+    void settle();
+
+    EventQueue *_queue;
+    mbed::Callback<void(uint32_t)> _on_rise;
+    mbed::Callback<void(uint32_t)> _on_fall;
+    mbed::SPSCCircularBuffer<edge_t, MBED_CONF_EVENTS_DEFERRED_INTERRUPT_BUFFER_SIZE> _edges;
+
+    volatile uint32_t _dropped;
+    volatile int _event;
+    volatile bool _pending;
+    bool _coalesce;
+
+    // software debouncing, edges then bypass the record
+    uint32_t _debounce_us;
+    volatile bool _burst;
+    volatile bool _burst_level;
+    volatile uint32_t _burst_start;
+    volatile uint32_t _last_edge;
+    bool _level;
+};
+
+}
+
+#endif
+
+#endif
+
+/** @}*/
@@ -57,6 +57,7 @@ public:
             _event->id = 0;
             _event->delay = 0;
             _event->period = -1;
+            _event->deadline = -1;
 
             _event->post = &Event::event_post<F>;
             _event->dtor = &Event::event_dtor<F>;
@@ -120,6 +121,21 @@ public:
         }
     }
 
+    /** Configure the deadline of an event
+     *
+     *  Among the events due at the same time, those with a deadline are
+     *  dispatched first, earliest deadline first. Events completing after
+     *  their deadline are counted by EventQueue::missed_deadlines.
+     *
+     *  @param deadline Milliseconds after it is due by which the event
+     *                  should have completed, negative for none
+     */
+    void deadline(int deadline) {
+        if (_event) {
+            _event->deadline = deadline;
+        }
+    }
+
     /** Posts an event onto the underlying event queue
      *
      *  The event is posted to the underlying queue and is executed in the
@@ -193,6 +209,7 @@ private:
 
         int delay;
         int period;
+        int deadline;
 
         int (*post)(struct event *);
         void (*dtor)(struct event *);
@@ -212,6 +229,7 @@ private:
         new (p) C(*(F*)(e + 1));
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
+        equeue_event_deadline(p, e->deadline);
         equeue_event_dtor(p, &Event::function_dtor<C>);
         return equeue_post(e->equeue, &Event::function_call<C>, p);
     }
@@ -461,6 +479,7 @@ public:
             _event->id = 0;
             _event->delay = 0;
             _event->period = -1;
+            _event->deadline = -1;
 
             _event->post = &Event::event_post<F>;
             _event->dtor = &Event::event_dtor<F>;
@@ -524,6 +543,21 @@ public:
         }
     }
 
+    /** Configure the deadline of an event
+     *
+     *  Among the events due at the same time, those with a deadline are
+     *  dispatched first, earliest deadline first. Events completing after
+     *  their deadline are counted by EventQueue::missed_deadlines.
+     *
+     *  @param deadline Milliseconds after it is due by which the event
+     *                  should have completed, negative for none
+     */
+    void deadline(int deadline) {
+        if (_event) {
+            _event->deadline = deadline;
+        }
+    }
+
     /** Posts an event onto the underlying event queue
      *
      *  The event is posted to the underlying queue and is executed in the
@@ -597,6 +631,7 @@ private:
 
         int delay;
         int period;
+        int deadline;
 
         int (*post)(struct event *, A0 a0);
         void (*dtor)(struct event *);
@@ -616,6 +651,7 @@ private:
         new (p) C(*(F*)(e + 1), a0);
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
+        equeue_event_deadline(p, e->deadline);
         equeue_event_dtor(p, &Event::function_dtor<C>);
         return equeue_post(e->equeue, &Event::function_call<C>, p);
     }
@@ -865,6 +901,7 @@ public:
             _event->id = 0;
             _event->delay = 0;
             _event->period = -1;
+            _event->deadline = -1;
 
             _event->post = &Event::event_post<F>;
             _event->dtor = &Event::event_dtor<F>;
@@ -928,6 +965,21 @@ public:
         }
     }
 
+    /** Configure the deadline of an event
+     *
+     *  Among the events due at the same time, those with a deadline are
+     *  dispatched first, earliest deadline first. Events completing after
+     *  their deadline are counted by EventQueue::missed_deadlines.
+     *
+     *  @param deadline Milliseconds after it is due by which the event
+     *                  should have completed, negative for none
+     */
+    void deadline(int deadline) {
+        if (_event) {
+            _event->deadline = deadline;
+        }
+    }
+
     /** Posts an event onto the underlying event queue
      *
      *  The event is posted to the underlying queue and is executed in the
@@ -1001,6 +1053,7 @@ private:
 
         int delay;
         int period;
+        int deadline;
 
         int (*post)(struct event *, A0 a0, A1 a1);
         void (*dtor)(struct event *);
@@ -1020,6 +1073,7 @@ private:
         new (p) C(*(F*)(e + 1), a0, a1);
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
+        equeue_event_deadline(p, e->deadline);
         equeue_event_dtor(p, &Event::function_dtor<C>);
         return equeue_post(e->equeue, &Event::function_call<C>, p);
     }
@@ -1269,6 +1323,7 @@ public:
             _event->id = 0;
             _event->delay = 0;
             _event->period = -1;
+            _event->deadline = -1;
 
             _event->post = &Event::event_post<F>;
             _event->dtor = &Event::event_dtor<F>;
@@ -1332,6 +1387,21 @@ public:
         }
     }
 
+    /** Configure the deadline of an event
+     *
+     *  Among the events due at the same time, those with a deadline are
+     *  dispatched first, earliest deadline first. Events completing after
+     *  their deadline are counted by EventQueue::missed_deadlines.
+     *
+     *  @param deadline Milliseconds after it is due by which the event
+     *                  should have completed, negative for none
+     */
+    void deadline(int deadline) {
+        if (_event) {
+            _event->deadline = deadline;
+        }
+    }
+
     /** Posts an event onto the underlying event queue
      *
      *  The event is posted to the underlying queue and is executed in the
@@ -1405,6 +1475,7 @@ private:
 
         int delay;
         int period;
+        int deadline;
 
         int (*post)(struct event *, A0 a0, A1 a1, A2 a2);
         void (*dtor)(struct event *);
@@ -1424,6 +1495,7 @@ private:
         new (p) C(*(F*)(e + 1), a0, a1, a2);
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
+        equeue_event_deadline(p, e->deadline);
         equeue_event_dtor(p, &Event::function_dtor<C>);
         return equeue_post(e->equeue, &Event::function_call<C>, p);
     }
@@ -1673,6 +1745,7 @@ public:
             _event->id = 0;
             _event->delay = 0;
             _event->period = -1;
+            _event->deadline = -1;
 
             _event->post = &Event::event_post<F>;
             _event->dtor = &Event::event_dtor<F>;
@@ -1736,6 +1809,21 @@ public:
         }
     }
 
+    /** Configure the deadline of an event
+     *
+     *  Among the events due at the same time, those with a deadline are
+     *  dispatched first, earliest deadline first. Events completing after
+     *  their deadline are counted by EventQueue::missed_deadlines.
+     *
+     *  @param deadline Milliseconds after it is due by which the event
+     *                  should have completed, negative for none
+     */
+    void deadline(int deadline) {
+        if (_event) {
+            _event->deadline = deadline;
+        }
+    }
+
     /** Posts an event onto the underlying event queue
      *
      *  The event is posted to the underlying queue and is executed in the
@@ -1809,6 +1897,7 @@ private:
 
         int delay;
         int period;
+        int deadline;
 
         int (*post)(struct event *, A0 a0, A1 a1, A2 a2, A3 a3);
         void (*dtor)(struct event *);
@@ -1828,6 +1917,7 @@ private:
         new (p) C(*(F*)(e + 1), a0, a1, a2, a3);
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
+        equeue_event_deadline(p, e->deadline);
         equeue_event_dtor(p, &Event::function_dtor<C>);
         return equeue_post(e->equeue, &Event::function_call<C>, p);
     }
@@ -2077,6 +2167,7 @@ public:
             _event->id = 0;
             _event->delay = 0;
             _event->period = -1;
+            _event->deadline = -1;
 
             _event->post = &Event::event_post<F>;
             _event->dtor = &Event::event_dtor<F>;
@@ -2140,6 +2231,21 @@ public:
         }
     }
 
+    /** Configure the deadline of an event
+     *
+     *  Among the events due at the same time, those with a deadline are
+     *  dispatched first, earliest deadline first. Events completing after
+     *  their deadline are counted by EventQueue::missed_deadlines.
+     *
+     *  @param deadline Milliseconds after it is due by which the event
+     *                  should have completed, negative for none
+     */
+    void deadline(int deadline) {
+        if (_event) {
+            _event->deadline = deadline;
+        }
+    }
+
     /** Posts an event onto the underlying event queue
      *
      *  The event is posted to the underlying queue and is executed in the
@@ -2213,6 +2319,7 @@ private:
 
         int delay;
         int period;
+        int deadline;
 
         int (*post)(struct event *, A0 a0, A1 a1, A2 a2, A3 a3, A4 a4);
         void (*dtor)(struct event *);
@@ -2232,6 +2339,7 @@ private:
         new (p) C(*(F*)(e + 1), a0, a1, a2, a3, a4);
         equeue_event_delay(p, e->delay);
         equeue_event_period(p, e->period);
+        equeue_event_deadline(p, e->deadline);
         equeue_event_dtor(p, &Event::function_dtor<C>);
         return equeue_post(e->equeue, &Event::function_call<C>, p);
     }
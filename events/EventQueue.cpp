@@ -43,6 +43,10 @@ unsigned EventQueue::tick() {
     return equeue_tick();
 }
 
+unsigned EventQueue::missed_deadlines() {
+    return equeue_missed_deadlines(&_equeue);
+}
+
 void EventQueue::cancel(int id) {
     return equeue_cancel(&_equeue, id);
 }
@@ -57,6 +61,16 @@ void EventQueue::background(Callback<void(int)> update) {
     }
 }
 
+#ifdef EQUEUE_STATS
+void EventQueue::stats(struct equeue_stats *stats) {
+    return equeue_stats(&_equeue, stats);
+}
+
+void EventQueue::reset_stats() {
+    return equeue_stats_reset(&_equeue);
+}
+#endif
+
 void EventQueue::chain(EventQueue *target) {
     if (target) {
         equeue_chain(&_equeue, &target->_equeue);
@@ -106,6 +106,17 @@ public:
      */
     unsigned tick();
 
+    /** Count of events that missed their deadline
+     *
+     *  Events posted with a deadline, see Event::deadline, are counted
+     *  when they complete after it. Each missed period of a periodic
+     *  event counts.
+     *
+     *  @return         Number of missed deadlines since the queue was
+     *                  created
+     */
+    unsigned missed_deadlines();
+
     /** Cancel an in-flight event
      *
      *  Attempts to cancel an event referenced by the unique id returned from
@@ -157,6 +168,23 @@ public:
      */
     void chain(EventQueue *target);
 
+#ifdef EQUEUE_STATS
+    /** Read the statistics of the event queue
+     *
+     *  Only available when events.stats-enabled is set. Reports the latency
+     *  between events becoming due and being dispatched, the memory held
+     *  by events, fragmentation of freed memory and allocation failures.
+     *
+     *  @param stats    Filled in with the queue's statistics
+     *  @see equeue_stats
+     */
+    void stats(struct equeue_stats *stats);
+
+    /** Reset the latency histogram, peaks and failure count
+     */
+    void reset_stats();
+#endif
+
     /** Calls an event on the queue
      *
      *  The specified callback will be executed in the context of the event
@@ -2041,6 +2069,7 @@ public:
 protected:
     template <typename F>
     friend class Event;
+    friend class UserAllocatedEvent;
     struct equeue _equeue;
     mbed::Callback<void(int)> _update;
 
@@ -0,0 +1,68 @@
+/* events
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "events/PriorityEventQueue.h"
+
+#ifdef MBED_CONF_RTOS_PRESENT
+
+#include "platform/mbed_assert.h"
+#include <string.h>
+
+namespace events {
+
+PriorityEventQueue::PriorityEventQueue(unsigned levels, osPriority highest,
+        unsigned size, uint32_t stack_size) : _levels(levels) {
+    MBED_ASSERT(levels > 0 && levels <= EVENTS_PRIORITY_LEVELS_MAX);
+    memset(_stats, 0, sizeof(_stats));
+
+    for (unsigned i = 0; i < _levels; i++) {
+        // each level runs one priority lower, but never at idle priority
+        int priority = (int)highest - (int)i;
+        if (priority <= osPriorityIdle) {
+            priority = osPriorityIdle + 1;
+        }
+
+        _queues[i] = new EventQueue(size);
+        _threads[i] = new rtos::Thread((osPriority)priority, stack_size);
+        _threads[i]->start(mbed::callback(_queues[i], &EventQueue::dispatch_forever));
+    }
+}
+
+PriorityEventQueue::~PriorityEventQueue() {
+    for (unsigned i = 0; i < _levels; i++) {
+        _queues[i]->break_dispatch();
+        _threads[i]->join();
+        delete _threads[i];
+        delete _queues[i];
+    }
+}
+
+void PriorityEventQueue::stats(unsigned level, priority_event_stats_t *stats) {
+    core_util_critical_section_enter();
+    *stats = _stats[level];
+    core_util_critical_section_exit();
+}
+
+void PriorityEventQueue::reset_stats(unsigned level) {
+    core_util_critical_section_enter();
+    _stats[level].dispatched = 0;
+    _stats[level].max_latency = 0;
+    _stats[level].total_latency = 0;
+    core_util_critical_section_exit();
+}
+
+}
+
+#endif
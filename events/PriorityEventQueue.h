@@ -0,0 +1,225 @@
+/* events
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef PRIORITY_EVENT_QUEUE_H
+#define PRIORITY_EVENT_QUEUE_H
+
+#ifdef MBED_CONF_RTOS_PRESENT
+
+#include "events/EventQueue.h"
+#include "rtos/Thread.h"
+#include "platform/critical.h"
+
+namespace events {
+/** \addtogroup events */
+/** @{*/
+
+/** EVENTS_PRIORITY_LEVELS_MAX
+ *  Maximum number of priority levels in a PriorityEventQueue
+ */
+#define EVENTS_PRIORITY_LEVELS_MAX 4
+
+/** Statistics of one priority level of a PriorityEventQueue
+ */
+struct priority_event_stats_t {
+    unsigned backlog;       /**< Events posted and not yet completed or cancelled */
+    unsigned dispatched;    /**< Events dispatched since the last reset */
+    unsigned max_latency;   /**< Longest time an event waited past its due time, in ms */
+    unsigned total_latency; /**< Sum of the waiting time of the dispatched events, in ms */
+};
+
+/** PriorityEventQueue
+ *
+ *  Set of event queues, each dispatched by its own thread at its own RTOS
+ *  priority, so that slow work posted to a low level cannot hold up
+ *  latency-sensitive work posted to a higher one. Level 0 is the most
+ *  urgent.
+ *
+ *  Like EventQueue::call, posting is irq safe.
+ */
+class PriorityEventQueue {
+public:
+    /** Create a PriorityEventQueue and start its worker threads
+     *
+     *  @param levels       Number of priority levels, at most
+     *                      EVENTS_PRIORITY_LEVELS_MAX (default to 2)
+     *  @param highest      RTOS priority of the level 0 worker, each
+     *                      following level runs one RTOS priority lower
+     *                      (default to osPriorityAboveNormal)
+     *  @param size         Size of the event buffer of each level in bytes
+     *                      (default to EVENTS_QUEUE_SIZE)
+     *  @param stack_size   Stack size of each worker thread in bytes
+     *                      (default to DEFAULT_STACK_SIZE)
+     */
+    PriorityEventQueue(unsigned levels = 2,
+            osPriority highest = osPriorityAboveNormal,
+            unsigned size = EVENTS_QUEUE_SIZE,
+            uint32_t stack_size = DEFAULT_STACK_SIZE);
+
+    /** Stop the worker threads and destroy the queues
+     */
+    ~PriorityEventQueue();
+
+    /** Number of priority levels
+     */
+    unsigned levels() const {
+        return _levels;
+    }
+
+    /** Access the underlying queue of a priority level
+     *
+     *  Events posted directly on the returned queue are dispatched by the
+     *  level's worker but are not included in its statistics.
+     *
+     *  @param level    Priority level
+     *  @return         The level's event queue
+     */
+    EventQueue *queue(unsigned level) {
+        return _queues[level];
+    }
+
+    /** Calls an event on a priority level
+     *
+     *  @param level    Priority level, 0 being the most urgent
+     *  @param f        Function to execute in the context of the level's worker
+     *  @return         A unique id within the level that can be passed to
+     *                  cancel, or an id of 0 if there is not enough memory
+     *                  to allocate the event.
+     *  @see EventQueue::call
+     */
+    template <typename F>
+    int call(unsigned level, F f) {
+        return _queues[level]->call(timed<F>(f, &_stats[level], 0));
+    }
+
+    /** Calls an event on a priority level
+     *  @see PriorityEventQueue::call
+     */
+    template <typename T, typename R>
+    int call(unsigned level, T *obj, R (T::*method)()) {
+        return call(level, mbed::callback(obj, method));
+    }
+
+    /** Calls an event on a priority level after a specified delay
+     *
+     *  The latency of a delayed event is measured from the end of its delay.
+     *
+     *  @param level    Priority level, 0 being the most urgent
+     *  @param ms       Time to delay in milliseconds
+     *  @param f        Function to execute in the context of the level's worker
+     *  @return         A unique id within the level that can be passed to
+     *                  cancel, or an id of 0 if there is not enough memory
+     *                  to allocate the event.
+     *  @see EventQueue::call_in
+     */
+    template <typename F>
+    int call_in(unsigned level, int ms, F f) {
+        return _queues[level]->call_in(ms, timed<F>(f, &_stats[level], ms));
+    }
+
+    /** Calls an event on a priority level after a specified delay
+     *  @see PriorityEventQueue::call_in
+     */
+    template <typename T, typename R>
+    int call_in(unsigned level, int ms, T *obj, R (T::*method)()) {
+        return call_in(level, ms, mbed::callback(obj, method));
+    }
+
+    /** Cancel an in-flight event
+     *
+     *  @param level    Priority level the event was posted to
+     *  @param id       Unique id of the event
+     *  @see EventQueue::cancel
+     */
+    void cancel(unsigned level, int id) {
+        _queues[level]->cancel(id);
+    }
+
+    /** Read the statistics of a priority level
+     *
+     *  @param level    Priority level
+     *  @param stats    Filled in with the level's statistics
+     */
+    void stats(unsigned level, priority_event_stats_t *stats);
+
+    /** Reset the dispatch and latency statistics of a priority level
+     *
+     *  The backlog is not affected.
+     *
+     *  @param level    Priority level
+     */
+    void reset_stats(unsigned level);
+
+private:
+    /* Wraps a posted function to time it and track the backlog. Only
+     * copies made by posting are armed: every armed copy counts towards
+     * the backlog until it is destroyed, which equeue does once the event
+     * has run or been cancelled. */
+    template <typename F>
+    struct timed {
+        F f;
+        priority_event_stats_t *stats;
+        unsigned due;
+        bool armed;
+
+        timed(F f, priority_event_stats_t *stats, int ms)
+            : f(f), stats(stats), due(equeue_tick() + ms), armed(false) {}
+
+        timed(const timed &other)
+            : f(other.f), stats(other.stats), due(other.due), armed(true) {
+            core_util_atomic_incr_u32((uint32_t*)&stats->backlog, 1);
+        }
+
+        ~timed() {
+            if (armed) {
+                core_util_atomic_decr_u32((uint32_t*)&stats->backlog, 1);
+            }
+        }
+
+        void operator()() {
+            int latency = (int)(equeue_tick() - due);
+            if (latency < 0) {
+                latency = 0;
+            }
+            stats->dispatched += 1;
+            stats->total_latency += latency;
+            if ((unsigned)latency > stats->max_latency) {
+                stats->max_latency = latency;
+            }
+            f();
+        }
+
+    private:
+        timed &operator=(const timed &);
+    };
+
+    unsigned _levels;
+    EventQueue *_queues[EVENTS_PRIORITY_LEVELS_MAX];
+    rtos::Thread *_threads[EVENTS_PRIORITY_LEVELS_MAX];
+    priority_event_stats_t _stats[EVENTS_PRIORITY_LEVELS_MAX];
+
+    /* disallow copy constructor and assignment operators */
+    PriorityEventQueue(const PriorityEventQueue &);
+    PriorityEventQueue &operator=(const PriorityEventQueue &);
+};
+
+}
+
+#endif
+
+#endif
+
+/** @}*/
@@ -0,0 +1,164 @@
+/* events
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef USER_ALLOCATED_EVENT_H
+#define USER_ALLOCATED_EVENT_H
+
+#include "events/EventQueue.h"
+#include "platform/Callback.h"
+
+namespace events {
+/** \addtogroup events */
+/** @{*/
+
+/** UserAllocatedEvent
+ *
+ *  Event whose memory is part of the object, rather than allocated from
+ *  the buffer of its event queue. Posting it never allocates nor copies
+ *  the callback, so it can't fail for lack of memory and suits deferring
+ *  work from a high-rate interrupt to a thread:
+ *
+ *  @code
+ *  class Sensor {
+ *  public:
+ *      Sensor(EventQueue *queue) : _ready(queue, mbed::callback(this, &Sensor::read)) {
+ *          _irq.rise(mbed::callback(&_ready, &UserAllocatedEvent::call));
+ *      }
+ *  private:
+ *      void read();
+ *      InterruptIn _irq;
+ *      UserAllocatedEvent _ready;
+ *  };
+ *  @endcode
+ *
+ *  An event is posted at most once at a time; posting it again while it
+ *  waits in the queue does nothing. It can be posted again as soon as its
+ *  callback starts, including from the callback itself.
+ *
+ *  Posting and cancelling are irq safe. The event must outlive its
+ *  dispatch, it is cancelled when destroyed, but like EventQueue::cancel,
+ *  this doesn't stop a callback whose dispatch has already begun.
+ */
+class UserAllocatedEvent {
+public:
+    /** Create an event
+     *
+     *  @param q        Event queue to dispatch on
+     *  @param f        Function to execute when the event is dispatched
+     */
+    UserAllocatedEvent(EventQueue *q, mbed::Callback<void()> f)
+            : _equeue(&q->_equeue), _delay(0), _function(f) {
+        equeue_user_allocated_init(&_event + 1);
+    }
+
+    /** Destroy the event, cancelling it
+     */
+    ~UserAllocatedEvent() {
+        cancel();
+    }
+
+    /** Configure the delay of the event
+     *
+     *  @param delay    Millisecond delay before dispatching the event
+     */
+    void delay(int delay) {
+        _delay = delay;
+    }
+
+    /** Configure the period of the event
+     *
+     *  Only while the event is not posted. Once posted, a periodic event
+     *  is dispatched every period until cancelled.
+     *
+     *  @param period   Millisecond period for repeatedly dispatching the
+     *                  event, or a negative value for a single dispatch
+     */
+    void period(int period) {
+        equeue_event_period(&_event + 1, period);
+    }
+
+    /** Configure the deadline of the event
+     *
+     *  Only while the event is not posted.
+     *
+     *  @param deadline Milliseconds after it is due by which the event
+     *                  should have completed, negative for none
+     *  @see Event::deadline
+     */
+    void deadline(int deadline) {
+        equeue_event_deadline(&_event + 1, deadline);
+    }
+
+    /** Post the event onto its event queue
+     *
+     *  The post function is irq safe and runs in constant time.
+     *
+     *  @return         True if the event was posted, false if it already
+     *                  was and has not been dispatched yet
+     */
+    bool post() {
+        return equeue_post_user_allocated(_equeue,
+                &UserAllocatedEvent::event_dispatch, &_event + 1, _delay);
+    }
+
+    /** Post the event onto its event queue
+     *
+     *  @see UserAllocatedEvent::post
+     */
+    void call() {
+        post();
+    }
+
+    /** Post the event onto its event queue
+     *
+     *  @see UserAllocatedEvent::post
+     */
+    void operator()() {
+        post();
+    }
+
+    /** Cancel the event
+     *
+     *  The cancel function is irq safe. It is safe to call on an event
+     *  which is not posted.
+     */
+    void cancel() {
+        equeue_cancel_user_allocated(_equeue, &_event + 1);
+    }
+
+private:
+    // the event header comes first, so the dispatch finds the object
+    struct equeue_event _event;
+    equeue_t *_equeue;
+    int _delay;
+    mbed::Callback<void()> _function;
+
+    static void event_dispatch(void *p) {
+        UserAllocatedEvent *e = reinterpret_cast<UserAllocatedEvent *>(
+                static_cast<struct equeue_event *>(p) - 1);
+        e->_function();
+    }
+
+    // protection against copy construction and assignment, the queue
+    // links the event by its address
+    UserAllocatedEvent(const UserAllocatedEvent &);
+    UserAllocatedEvent &operator=(const UserAllocatedEvent &);
+};
+
+}
+
+#endif
+
+/** @}*/
@@ -66,7 +66,8 @@ int equeue_create_inplace(equeue_t *q, size_t size, void *buffer) {
         q->npw2++;
     }
 
-    q->chunks = 0;
+    memset(q->chunks, 0, sizeof(q->chunks));
+    q->chunk_mask = 0;
     q->slab.size = size;
     q->slab.data = buffer;
 
@@ -74,11 +75,17 @@ int equeue_create_inplace(equeue_t *q, size_t size, void *buffer) {
     q->tick = equeue_tick();
     q->generation = 0;
     q->breaks = 0;
+    q->missed = 0;
 
     q->background.active = false;
     q->background.update = 0;
     q->background.timer = 0;
 
+#ifdef EQUEUE_STATS
+    memset(&q->stats, 0, sizeof(q->stats));
+    q->stats.mem_size = size;
+#endif
+
     // initialize platform resources
     int err;
     err = equeue_sema_create(&q->eventsema);
@@ -122,30 +129,110 @@ void equeue_destroy(equeue_t *q) {
 }
 
 
+// equeue statistics, memory figures are updated with memlock held
+#ifdef EQUEUE_STATS
+static inline void equeue_stats_alloc(equeue_t *q, struct equeue_event *e) {
+    q->stats.mem_used += e->size;
+    if (q->stats.mem_used > q->stats.mem_peak) {
+        q->stats.mem_peak = q->stats.mem_used;
+    }
+    q->stats.slab_used = q->stats.mem_size - q->slab.size;
+}
+
+static inline void equeue_stats_dealloc(equeue_t *q, struct equeue_event *e) {
+    q->stats.mem_used -= e->size;
+}
+
+static inline void equeue_stats_fail(equeue_t *q) {
+    q->stats.alloc_failures += 1;
+}
+
+static inline void equeue_stats_dispatch(equeue_t *q, struct equeue_event *e,
+        unsigned tick) {
+    unsigned latency = equeue_clampdiff(tick, e->target);
+    unsigned bucket = 0;
+    while (latency >> bucket && bucket < EQUEUE_STATS_BUCKETS-1) {
+        bucket++;
+    }
+
+    q->stats.dispatched += 1;
+    q->stats.latency_hist[bucket] += 1;
+    if (latency > q->stats.latency_max) {
+        q->stats.latency_max = latency;
+    }
+}
+#else
+#define equeue_stats_alloc(q, e) ((void)0)
+#define equeue_stats_dealloc(q, e) ((void)0)
+#define equeue_stats_fail(q) ((void)0)
+#define equeue_stats_dispatch(q, e, tick) ((void)0)
+#endif
+
+
 // equeue chunk allocation functions
+static inline unsigned equeue_chunk_class(size_t size) {
+    // smallest n where size <= 2^n
+#if defined(__GNUC__) || defined(__clang__)
+    unsigned n = (size > 1) ? 8*sizeof(unsigned long)
+            - __builtin_clzl((unsigned long)(size-1)) : 0;
+#else
+    unsigned n = 0;
+    for (size_t s = size-1; s; s >>= 1) {
+        n++;
+    }
+#endif
+    return (n < EQUEUE_CHUNK_CLASSES-1) ? n : EQUEUE_CHUNK_CLASSES-1;
+}
+
+static inline struct equeue_event *equeue_chunk_take(equeue_t *q,
+        unsigned n, struct equeue_event **p) {
+    struct equeue_event *e = *p;
+    if (e->sibling) {
+        *p = e->sibling;
+        (*p)->next = e->next;
+    } else {
+        *p = e->next;
+    }
+
+    if (!q->chunks[n]) {
+        q->chunk_mask &= ~(1u << n);
+    }
+
+    return e;
+}
+
 static struct equeue_event *equeue_mem_alloc(equeue_t *q, size_t size) {
     // add event overhead
     size += sizeof(struct equeue_event);
     size = (size + sizeof(void*)-1) & ~(sizeof(void*)-1);
+    unsigned n = equeue_chunk_class(size);
 
     equeue_mutex_lock(&q->memlock);
 
-    // check if a good chunk is available
-    for (struct equeue_event **p = &q->chunks; *p; p = &(*p)->next) {
+    // check if a good chunk is available in our size class
+    for (struct equeue_event **p = &q->chunks[n]; *p; p = &(*p)->next) {
         if ((*p)->size >= size) {
-            struct equeue_event *e = *p;
-            if (e->sibling) {
-                *p = e->sibling;
-                (*p)->next = e->next;
-            } else {
-                *p = e->next;
-            }
-
+            struct equeue_event *e = equeue_chunk_take(q, n, p);
+            equeue_stats_alloc(q, e);
             equeue_mutex_unlock(&q->memlock);
             return e;
         }
     }
 
+    // any chunk in a larger size class fits, take the smallest one
+    unsigned larger = q->chunk_mask & ~((2u << n) - 1);
+    if (larger) {
+        unsigned m = n+1;
+        while (!(larger & (1u << m))) {
+            m++;
+        }
+
+        struct equeue_event *e = equeue_chunk_take(q, m, &q->chunks[m]);
+        equeue_stats_alloc(q, e);
+        equeue_mutex_unlock(&q->memlock);
+        return e;
+    }
+
     // otherwise allocate a new chunk out of the slab
     if (q->slab.size >= size) {
         struct equeue_event *e = (struct equeue_event *)q->slab.data;
@@ -154,19 +241,23 @@ static struct equeue_event *equeue_mem_alloc(equeue_t *q, size_t size) {
         e->size = size;
         e->id = 1;
 
+        equeue_stats_alloc(q, e);
         equeue_mutex_unlock(&q->memlock);
         return e;
     }
 
+    equeue_stats_fail(q);
     equeue_mutex_unlock(&q->memlock);
     return 0;
 }
 
 static void equeue_mem_dealloc(equeue_t *q, struct equeue_event *e) {
+    unsigned n = equeue_chunk_class(e->size);
+
     equeue_mutex_lock(&q->memlock);
 
-    // stick chunk into list of chunks
-    struct equeue_event **p = &q->chunks;
+    // stick chunk into the sorted list of its size class
+    struct equeue_event **p = &q->chunks[n];
     while (*p && (*p)->size < e->size) {
         p = &(*p)->next;
     }
@@ -179,7 +270,9 @@ static void equeue_mem_dealloc(equeue_t *q, struct equeue_event *e) {
         e->next = *p;
     }
     *p = e;
+    q->chunk_mask |= 1u << n;
 
+    equeue_stats_dealloc(q, e);
     equeue_mutex_unlock(&q->memlock);
 }
 
@@ -191,6 +284,7 @@ void *equeue_alloc(equeue_t *q, size_t size) {
 
     e->target = 0;
     e->period = -1;
+    e->deadline = -1;
     e->dtor = 0;
 
     return e + 1;
@@ -206,17 +300,34 @@ void equeue_dealloc(equeue_t *q, void *p) {
     equeue_mem_dealloc(q, e);
 }
 
+unsigned equeue_prealloc(equeue_t *q, size_t size, unsigned count) {
+    // allocate all the events before freeing any so none are reused
+    struct equeue_event *es = 0;
+    unsigned reserved = 0;
+    while (reserved < count) {
+        struct equeue_event *e = equeue_mem_alloc(q, size);
+        if (!e) {
+            break;
+        }
 
-// equeue scheduling functions
-static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick) {
-    // setup event and hash local id with buffer offset for unique id
-    int id = (e->id << q->npw2) | ((unsigned char *)e - q->buffer);
-    e->target = tick + equeue_clampdiff(e->target, tick);
-    e->generation = q->generation;
+        e->next = es;
+        es = e;
+        reserved++;
+    }
 
-    equeue_mutex_lock(&q->queuelock);
+    while (es) {
+        struct equeue_event *e = es;
+        es = e->next;
+        equeue_mem_dealloc(q, e);
+    }
 
-    // find the event slot
+    return reserved;
+}
+
+
+// equeue scheduling functions
+static void equeue_insert(equeue_t *q, struct equeue_event *e, unsigned tick) {
+    // find the event slot, with queuelock held
     struct equeue_event **p = &q->queue;
     while (*p && equeue_tickdiff((*p)->target, e->target) < 0) {
         p = &(*p)->next;
@@ -249,12 +360,45 @@ static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick) {
         q->background.update(q->background.timer,
                 equeue_clampdiff(e->target, tick));
     }
+}
+
+static int equeue_enqueue(equeue_t *q, struct equeue_event *e, unsigned tick) {
+    // setup event and hash local id with buffer offset for unique id
+    int id = (e->id << q->npw2) | ((unsigned char *)e - q->buffer);
+    e->target = tick + equeue_clampdiff(e->target, tick);
+    e->generation = q->generation;
 
+    equeue_mutex_lock(&q->queuelock);
+    equeue_insert(q, e, tick);
     equeue_mutex_unlock(&q->queuelock);
 
     return id;
 }
 
+// check if an event is being dispatched, with queuelock held
+static inline bool equeue_inflight(equeue_t *q, struct equeue_event *e) {
+    int diff = equeue_tickdiff(e->target, q->tick);
+    return diff < 0 || (diff == 0 && e->generation != q->generation);
+}
+
+static void equeue_unlink(struct equeue_event *e) {
+    // disentangle from queue, with queuelock held
+    if (e->sibling) {
+        e->sibling->next = e->next;
+        if (e->sibling->next) {
+            e->sibling->next->ref = &e->sibling->next;
+        }
+
+        *e->ref = e->sibling;
+        e->sibling->ref = e->ref;
+    } else {
+        *e->ref = e->next;
+        if (e->next) {
+            e->next->ref = e->ref;
+        }
+    }
+}
+
 static struct equeue_event *equeue_unqueue(equeue_t *q, int id) {
     // decode event from unique id and check that the local id matches
     struct equeue_event *e = (struct equeue_event *)
@@ -270,28 +414,12 @@ static struct equeue_event *equeue_unqueue(equeue_t *q, int id) {
     e->cb = 0;
     e->period = -1;
 
-    int diff = equeue_tickdiff(e->target, q->tick);
-    if (diff < 0 || (diff == 0 && e->generation != q->generation)) {
+    if (equeue_inflight(q, e)) {
         equeue_mutex_unlock(&q->queuelock);
         return 0;
     }
 
-    // disentangle from queue
-    if (e->sibling) {
-        e->sibling->next = e->next;
-        if (e->sibling->next) {
-            e->sibling->next->ref = &e->sibling->next;
-        }
-
-        *e->ref = e->sibling;
-        e->sibling->ref = e->ref;
-    } else {
-        *e->ref = e->next;
-        if (e->next) {
-            e->next->ref = e->ref;
-        }
-    }
-
+    equeue_unlink(e);
     equeue_incid(q, e);
     equeue_mutex_unlock(&q->queuelock);
 
@@ -364,6 +492,70 @@ void equeue_cancel(equeue_t *q, int id) {
     }
 }
 
+// user allocated events, their id is 1 while posted and 0 otherwise
+static inline bool equeue_is_user_allocated(equeue_t *q,
+        struct equeue_event *e) {
+    unsigned char *p = (unsigned char *)e;
+    return p < q->buffer || p >= q->slab.data + q->slab.size;
+}
+
+static void equeue_user_release(equeue_t *q, struct equeue_event *e) {
+    equeue_mutex_lock(&q->queuelock);
+    e->id = 0;
+    equeue_mutex_unlock(&q->queuelock);
+}
+
+void equeue_user_allocated_init(void *p) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+    e->size = 0;
+    e->id = 0;
+    e->target = 0;
+    e->period = -1;
+    e->deadline = -1;
+    e->dtor = 0;
+    e->cb = 0;
+}
+
+bool equeue_post_user_allocated(equeue_t *q, void (*cb)(void*), void *p,
+        int ms) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+    unsigned tick = equeue_tick();
+
+    equeue_mutex_lock(&q->queuelock);
+    if (e->id) {
+        equeue_mutex_unlock(&q->queuelock);
+        return false;
+    }
+
+    e->id = 1;
+    e->cb = cb;
+    e->target = tick + equeue_clampdiff(tick + ms, tick);
+    e->generation = q->generation;
+    equeue_insert(q, e, tick);
+    equeue_mutex_unlock(&q->queuelock);
+
+    equeue_sema_signal(&q->eventsema);
+    return true;
+}
+
+void equeue_cancel_user_allocated(equeue_t *q, void *p) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+
+    equeue_mutex_lock(&q->queuelock);
+    if (!e->id) {
+        equeue_mutex_unlock(&q->queuelock);
+        return;
+    }
+
+    // an event being dispatched is released by the dispatch loop
+    e->cb = 0;
+    if (!equeue_inflight(q, e)) {
+        equeue_unlink(e);
+        e->id = 0;
+    }
+    equeue_mutex_unlock(&q->queuelock);
+}
+
 void equeue_break(equeue_t *q) {
     equeue_mutex_lock(&q->queuelock);
     q->breaks++;
@@ -371,6 +563,51 @@ void equeue_break(equeue_t *q) {
     equeue_sema_signal(&q->eventsema);
 }
 
+// order due events earliest deadline first, stable so the events without
+// deadline and those with equal deadlines keep their posting order
+static struct equeue_event *equeue_edf_sort(struct equeue_event *es,
+        unsigned tick) {
+    bool deadlines = false;
+    for (struct equeue_event *e = es; e; e = e->next) {
+        if (e->deadline >= 0) {
+            deadlines = true;
+            break;
+        }
+    }
+
+    if (!deadlines) {
+        return es;
+    }
+
+    struct equeue_event *head = 0;
+    while (es) {
+        struct equeue_event *e = es;
+        es = e->next;
+
+        struct equeue_event **p = &head;
+        if (e->deadline >= 0) {
+            int d = equeue_tickdiff(e->target + e->deadline, tick);
+            while (*p && (*p)->deadline >= 0 && equeue_tickdiff(
+                    (*p)->target + (*p)->deadline, tick) <= d) {
+                p = &(*p)->next;
+            }
+        } else {
+            while (*p) {
+                p = &(*p)->next;
+            }
+        }
+
+        e->next = *p;
+        *p = e;
+    }
+
+    return head;
+}
+
+unsigned equeue_missed_deadlines(equeue_t *q) {
+    return q->missed;
+}
+
 void equeue_dispatch(equeue_t *q, int ms) {
     unsigned tick = equeue_tick();
     unsigned timeout = tick + ms;
@@ -378,21 +615,59 @@ void equeue_dispatch(equeue_t *q, int ms) {
 
     while (1) {
         // collect all the available events and next deadline
-        struct equeue_event *es = equeue_dequeue(q, tick);
+        struct equeue_event *es = equeue_edf_sort(
+                equeue_dequeue(q, tick), tick);
 
         // dispatch events
         while (es) {
             struct equeue_event *e = es;
             es = e->next;
 
-            // actually dispatch the callbacks
+            // the deadline is read first, as the event may be posted
+            // again, or its memory released, once the callback starts
+            bool timed = e->deadline >= 0;
+            unsigned deadline = e->target + e->deadline;
+
+            // user allocated events can be posted again once their
+            // callback starts, unless they are periodic
             void (*cb)(void *) = e->cb;
+            bool user = equeue_is_user_allocated(q, e);
+            bool held = user && cb && e->period >= 0;
+            if (user && !held) {
+                equeue_user_release(q, e);
+            }
+
+            // actually dispatch the callbacks
             if (cb) {
+                equeue_stats_dispatch(q, e, equeue_tick());
                 cb(e + 1);
+
+                if (timed && equeue_tickdiff(equeue_tick(), deadline) > 0) {
+                    equeue_mutex_lock(&q->queuelock);
+                    q->missed += 1;
+                    equeue_mutex_unlock(&q->queuelock);
+                }
             }
 
-            // reenqueue periodic events or deallocate
-            if (e->period >= 0) {
+            // reenqueue periodic events or deallocate, a user allocated
+            // event that was cancelled meanwhile is released when its
+            // null callback comes up, or here if cancelled by its own
+            // callback
+            if (user) {
+                if (held) {
+                    equeue_mutex_lock(&q->queuelock);
+                    if (e->cb) {
+                        unsigned now = equeue_tick();
+                        e->target = now + equeue_clampdiff(
+                                e->target + e->period, now);
+                        e->generation = q->generation;
+                        equeue_insert(q, e, now);
+                    } else {
+                        e->id = 0;
+                    }
+                    equeue_mutex_unlock(&q->queuelock);
+                }
+            } else if (e->period >= 0) {
                 e->target += e->period;
                 equeue_enqueue(q, e, equeue_tick());
             } else {
@@ -452,6 +727,39 @@ void equeue_dispatch(equeue_t *q, int ms) {
 }
 
 
+// statistics
+#ifdef EQUEUE_STATS
+void equeue_stats(equeue_t *q, struct equeue_stats *stats) {
+    equeue_mutex_lock(&q->memlock);
+    *stats = q->stats;
+
+    stats->chunk_bytes = 0;
+    stats->chunk_count = 0;
+    stats->chunk_sizes = 0;
+    for (unsigned n = 0; n < EQUEUE_CHUNK_CLASSES; n++) {
+        for (struct equeue_event *es = q->chunks[n]; es; es = es->next) {
+            stats->chunk_sizes += 1;
+            for (struct equeue_event *e = es; e; e = e->sibling) {
+                stats->chunk_bytes += e->size;
+                stats->chunk_count += 1;
+            }
+        }
+    }
+    equeue_mutex_unlock(&q->memlock);
+}
+
+void equeue_stats_reset(equeue_t *q) {
+    equeue_mutex_lock(&q->memlock);
+    q->stats.dispatched = 0;
+    q->stats.latency_max = 0;
+    memset(q->stats.latency_hist, 0, sizeof(q->stats.latency_hist));
+    q->stats.mem_peak = q->stats.mem_used;
+    q->stats.alloc_failures = 0;
+    equeue_mutex_unlock(&q->memlock);
+}
+#endif
+
+
 // event functions
 void equeue_event_delay(void *p, int ms) {
     struct equeue_event *e = (struct equeue_event*)p - 1;
@@ -463,6 +771,11 @@ void equeue_event_period(void *p, int ms) {
     e->period = ms;
 }
 
+void equeue_event_deadline(void *p, int ms) {
+    struct equeue_event *e = (struct equeue_event*)p - 1;
+    e->deadline = ms;
+}
+
 void equeue_event_dtor(void *p, void (*dtor)(void *)) {
     struct equeue_event *e = (struct equeue_event*)p - 1;
     e->dtor = dtor;
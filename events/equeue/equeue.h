@@ -32,6 +32,27 @@ extern "C" {
 #include <stdint.h>
 
 
+// Optional statistics
+//
+// Define EQUEUE_STATS, or enable events.stats-enabled in an mbed build, to
+// record dispatch latency and memory usage of each queue. The statistics
+// can be read with equeue_stats.
+#if !defined(EQUEUE_STATS) && defined(MBED_CONF_EVENTS_STATS_ENABLED)
+#if MBED_CONF_EVENTS_STATS_ENABLED
+#define EQUEUE_STATS
+#endif
+#endif
+
+// Number of buckets in the latency histogram, bucket n counts events
+// dispatched between 2^(n-1) and 2^n-1 ms late, the last bucket holds
+// everything later
+#define EQUEUE_STATS_BUCKETS 12
+
+// Number of size classes in the chunk allocator, freed chunks of
+// size 2^(n-1)+1 to 2^n bytes are kept in class n, the last class also
+// holds every larger chunk
+#define EQUEUE_CHUNK_CLASSES 16
+
 // The minimum size of an event
 // This size is guaranteed to fit events created by event_call
 #define EQUEUE_EVENT_SIZE (sizeof(struct equeue_event) + 2*sizeof(void*))
@@ -48,24 +69,45 @@ struct equeue_event {
 
     unsigned target;
     int period;
+    int deadline;
     void (*dtor)(void *);
 
     void (*cb)(void *);
     // data follows
 };
 
+// Event queue statistics
+struct equeue_stats {
+    unsigned dispatched;
+    unsigned latency_max;
+    unsigned latency_hist[EQUEUE_STATS_BUCKETS];
+
+    size_t mem_size;
+    size_t mem_used;
+    size_t mem_peak;
+    size_t slab_used;
+    unsigned alloc_failures;
+
+    // filled in by equeue_stats from the free chunk list
+    size_t chunk_bytes;
+    unsigned chunk_count;
+    unsigned chunk_sizes;
+};
+
 // Event queue structure
 typedef struct equeue {
     struct equeue_event *queue;
     unsigned tick;
     unsigned breaks;
     uint8_t generation;
+    unsigned missed;
 
     unsigned char *buffer;
     unsigned npw2;
     void *allocated;
 
-    struct equeue_event *chunks;
+    struct equeue_event *chunks[EQUEUE_CHUNK_CLASSES];
+    unsigned chunk_mask;
     struct equeue_slab {
         size_t size;
         unsigned char *data;
@@ -77,6 +119,10 @@ typedef struct equeue {
         void *timer;
     } background;
 
+#ifdef EQUEUE_STATS
+    struct equeue_stats stats;
+#endif
+
     equeue_sema_t eventsema;
     equeue_mutex_t queuelock;
     equeue_mutex_t memlock;
@@ -141,9 +187,12 @@ int equeue_call_every(equeue_t *queue, int ms, void (*cb)(void *), void *data);
 // Both equeue_alloc and equeue_dealloc are irq safe.
 //
 // The equeue allocator is designed to minimize jitter in interrupt contexts as
-// well as avoid memory fragmentation on small devices. The allocator achieves
-// both constant-runtime and zero-fragmentation for fixed-size events, however
-// grows linearly as the quantity of different sized allocations increases.
+// well as avoid memory fragmentation on small devices. Freed chunks are kept
+// in power-of-two size classes, so an allocation only searches the chunks of
+// its own class before taking the smallest chunk of the next non-empty class.
+// The allocator achieves both constant-runtime and zero-fragmentation for
+// fixed-size events, and its runtime only grows with the number of different
+// sizes within a single class.
 //
 // The equeue_alloc function returns a pointer to the event's allocated memory
 // and acts as a handle to the underlying event. If there is not enough memory
@@ -151,15 +200,43 @@ int equeue_call_every(equeue_t *queue, int ms, void (*cb)(void *), void *data);
 void *equeue_alloc(equeue_t *queue, size_t size);
 void equeue_dealloc(equeue_t *queue, void *event);
 
+// Preallocate events
+//
+// Reserves memory for count events of the given size so later allocations
+// of up to that size are served from freed chunks without touching the
+// remaining buffer. Calling equeue_prealloc right after creating a queue
+// partitions the buffer into fixed pools per event size.
+//
+// Returns the number of events reserved, which is less than count if the
+// queue runs out of memory.
+unsigned equeue_prealloc(equeue_t *queue, size_t size, unsigned count);
+
 // Configure an allocated event
 //
-// equeue_event_delay  - Millisecond delay before dispatching an event
-// equeue_event_period - Millisecond period for repeating dispatching an event
-// equeue_event_dtor   - Destructor to run when the event is deallocated
+// equeue_event_delay    - Millisecond delay before dispatching an event
+// equeue_event_period   - Millisecond period for repeating dispatching an event
+// equeue_event_deadline - Milliseconds after it is due by which an event
+//                         should have completed, negative for none
+// equeue_event_dtor     - Destructor to run when the event is deallocated
 void equeue_event_delay(void *event, int ms);
 void equeue_event_period(void *event, int ms);
+void equeue_event_deadline(void *event, int ms);
 void equeue_event_dtor(void *event, void (*dtor)(void *));
 
+// Deadline scheduling
+//
+// Events that are due at the same time are dispatched in the order they
+// were posted, unless some have a deadline set with equeue_event_deadline.
+// Then the due events are dispatched earliest deadline first, events without
+// a deadline going last in their posting order. Events that come due while
+// others are dispatched are considered once those are done, a callback is
+// never interrupted.
+//
+// The equeue_missed_deadlines function returns the number of events that
+// completed after their deadline, including each missed period of
+// periodic events.
+unsigned equeue_missed_deadlines(equeue_t *queue);
+
 // Post an event onto the event queue
 //
 // The equeue_post function takes a callback and a pointer to an event
@@ -187,6 +264,32 @@ int equeue_post(equeue_t *queue, void (*cb)(void *), void *event);
 // the event may have already begun executing.
 void equeue_cancel(equeue_t *queue, int id);
 
+// User allocated events
+//
+// An event can also live in memory owned by the caller, such as a member
+// of an object, and be posted again and again without allocating. The
+// memory holds a struct equeue_event immediately followed by the event's
+// data, and the functions take a pointer to the data, like those of
+// events allocated by equeue_alloc. The memory must stay valid while the
+// event is posted.
+//
+// equeue_user_allocated_init  - Prepare the event, before its first post
+// equeue_post_user_allocated  - Post the event after a millisecond delay
+// equeue_cancel_user_allocated - Cancel the event if posted
+//
+// The equeue_post_user_allocated function returns false, leaving the event
+// as it is, if it is already posted. A posted event can be posted again
+// once the dispatch of its callback has started, including from the
+// callback. A period set with equeue_event_period while the event is not
+// posted makes it repeat until cancelled. Destructors are not called.
+//
+// All three functions are irq safe. Cancellation behaves like
+// equeue_cancel, a callback whose dispatch has started may still run.
+void equeue_user_allocated_init(void *event);
+bool equeue_post_user_allocated(equeue_t *queue,
+        void (*cb)(void *), void *event, int ms);
+void equeue_cancel_user_allocated(equeue_t *queue, void *event);
+
 // Background an event queue onto a single-shot timer
 //
 // The provided update function will be called to indicate when the queue
@@ -213,6 +316,27 @@ void equeue_background(equeue_t *queue,
 // the context of a dispatch loop while still being managed independently.
 void equeue_chain(equeue_t *queue, equeue_t *target);
 
+// Read event queue statistics
+//
+// Only available when built with EQUEUE_STATS. Latency is the time between
+// an event becoming due and its dispatch, which for events posted without
+// a delay is the time spent waiting in the queue. Memory figures are in
+// bytes and include the per-event overhead:
+//
+// mem_used/mem_peak   - memory held by allocated events, now and at most
+// slab_used           - memory ever carved out of the queue's buffer
+// alloc_failures      - number of times equeue_alloc returned null
+// chunk_bytes/count   - memory and number of freed chunks awaiting reuse
+// chunk_sizes         - number of distinct sizes among the freed chunks,
+//                       which bounds the allocator's search
+//
+// The equeue_stats_reset function clears the latency histogram, peaks and
+// failure count.
+#ifdef EQUEUE_STATS
+void equeue_stats(equeue_t *queue, struct equeue_stats *stats);
+void equeue_stats_reset(equeue_t *queue);
+#endif
+
 
 #ifdef __cplusplus
 }
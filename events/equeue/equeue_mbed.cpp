@@ -23,41 +23,19 @@
 #include <stdbool.h>
 #include "mbed.h"
 
+// The low power ticker keeps running in deep sleep, the us ticker doesn't
+#if MBED_CONF_EVENTS_USE_LOWPOWER_TIMER_TICKER && DEVICE_LOWPOWERTIMER && DEVICE_SLEEP
+#define EQUEUE_LOWPOWER 1
+#define equeue_ticker_data get_lp_ticker_data
+#else
+#define equeue_ticker_data get_us_ticker_data
+#endif
 
-// Ticker operations
-static bool equeue_tick_inited = false;
-static unsigned equeue_minutes = 0;
-static unsigned equeue_timer[
-        (sizeof(Timer)+sizeof(unsigned)-1)/sizeof(unsigned)];
-static unsigned equeue_ticker[
-        (sizeof(Ticker)+sizeof(unsigned)-1)/sizeof(unsigned)];
-
-static void equeue_tick_update() {
-    reinterpret_cast<Timer*>(equeue_timer)->reset();
-    equeue_minutes += 1;
-}
-
-static void equeue_tick_init() {
-    MBED_ASSERT(sizeof(equeue_timer) >= sizeof(Timer));
-    MBED_ASSERT(sizeof(equeue_ticker) >= sizeof(Ticker));
-    new (equeue_timer) Timer;
-    new (equeue_ticker) Ticker;
-
-    equeue_minutes = 0;
-    reinterpret_cast<Timer*>(equeue_timer)->start();
-    reinterpret_cast<Ticker*>(equeue_ticker)
-            ->attach_us(equeue_tick_update, (1 << 16)*1000);
-
-    equeue_tick_inited = true;
-}
 
+// Ticker operations
 unsigned equeue_tick() {
-    if (!equeue_tick_inited) {
-        equeue_tick_init();
-    }
-
-    unsigned equeue_ms = reinterpret_cast<Timer*>(equeue_timer)->read_ms();
-    return (equeue_minutes << 16) + equeue_ms;
+    // the 64-bit ticker time does not wrap, its milliseconds wrap as unsigned
+    return (unsigned)(ticker_read_us64(equeue_ticker_data()) / 1000);
 }
 
 
@@ -118,6 +96,35 @@ static void equeue_sema_timeout(equeue_sema_t *s) {
     *s = -1;
 }
 
+#if EQUEUE_LOWPOWER
+bool equeue_sema_wait(equeue_sema_t *s, int ms) {
+    int signal = 0;
+    LowPowerTimeout timeout;
+    if (ms >= 0) {
+        // wake on the millisecond the queue computed its deadline against,
+        // rather than ms after now, so that wakeups are never late by the
+        // part of the current millisecond that already passed
+        us_timestamp_t now = ticker_read_us64(equeue_ticker_data());
+        us_timestamp_t deadline = (now / 1000 + ms) * 1000;
+        if (deadline <= now) {
+            // already due, only poll the semaphore
+            core_util_critical_section_enter();
+            signal = *s;
+            *s = false;
+            core_util_critical_section_exit();
+            return (signal > 0);
+        }
+        timeout.attach_us(s, equeue_sema_timeout, deadline - now);
+    }
+
+    // deep sleep between events unless a driver holds a lock
+    core_util_critical_section_enter();
+    while (!*s) {
+        sleep_manager_sleep_auto();
+        core_util_critical_section_exit();
+        core_util_critical_section_enter();
+    }
+#else
 bool equeue_sema_wait(equeue_sema_t *s, int ms) {
     int signal = 0;
     Timeout timeout;
@@ -129,6 +136,7 @@ bool equeue_sema_wait(equeue_sema_t *s, int ms) {
         core_util_critical_section_exit();
         core_util_critical_section_enter();
     }
+#endif
 
     signal = *s;
     *s = false;
@@ -175,6 +175,32 @@ void equeue_alloc_many_prof(int count) {
     equeue_destroy(&q);
 }
 
+void equeue_alloc_mixed_prof(int count) {
+    struct equeue q;
+    equeue_create(&q, count*(EQUEUE_EVENT_SIZE + count));
+
+    void *es[count];
+
+    // leave freed chunks of many different sizes in the allocator
+    for (int i = 0; i < count; i++) {
+        es[i] = equeue_alloc(&q, i);
+    }
+
+    for (int i = 0; i < count; i++) {
+        equeue_dealloc(&q, es[i]);
+    }
+
+    prof_loop() {
+        prof_start();
+        void *e = equeue_alloc(&q, count - 1);
+        prof_stop();
+
+        equeue_dealloc(&q, e);
+    }
+
+    equeue_destroy(&q);
+}
+
 void equeue_post_prof(void) {
     struct equeue q;
     equeue_create(&q, EQUEUE_EVENT_SIZE);
@@ -394,6 +420,7 @@ int main() {
     prof_measure(equeue_cancel_prof);
 
     prof_measure(equeue_alloc_many_prof, 1000);
+    prof_measure(equeue_alloc_mixed_prof, 100);
     prof_measure(equeue_post_many_prof, 1000);
     prof_measure(equeue_post_future_many_prof, 1000);
     prof_measure(equeue_dispatch_many_prof, 100);
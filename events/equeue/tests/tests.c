@@ -63,6 +63,10 @@ void sloth_func(void *p) {
     (*(int *)p)++;
 }
 
+void sloth_func_indirect(void *p) {
+    sloth_func(*(int **)p);
+}
+
 struct indirect {
     int *touched;
     uint8_t buffer[7];
@@ -621,6 +625,108 @@ static void *ethread_dispatch(void *p) {
     return 0;
 }
 
+void prealloc_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    unsigned reserved = equeue_prealloc(&q, 8, 4);
+    test_assert(reserved == 4);
+    size_t slab = q.slab.size;
+
+    // preallocated events are reused without touching the slab
+    void *es[4];
+    for (int i = 0; i < 4; i++) {
+        es[i] = equeue_alloc(&q, 8);
+        test_assert(es[i]);
+    }
+    test_assert(q.slab.size == slab);
+
+    for (int i = 0; i < 4; i++) {
+        equeue_dealloc(&q, es[i]);
+    }
+
+    // a larger size class serves a smaller allocation
+    void *p = equeue_alloc(&q, 200);
+    test_assert(p);
+    equeue_dealloc(&q, p);
+    slab = q.slab.size;
+    p = equeue_alloc(&q, 60);
+    test_assert(p);
+    test_assert(q.slab.size == slab);
+    equeue_dealloc(&q, p);
+
+    // reservations are limited by the buffer
+    reserved = equeue_prealloc(&q, 1024, 4);
+    test_assert(reserved == 1);
+
+    equeue_destroy(&q);
+}
+
+#ifdef EQUEUE_STATS
+void stats_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    struct equeue_stats stats;
+    equeue_stats(&q, &stats);
+    test_assert(stats.mem_size == 2048);
+    test_assert(stats.mem_used == 0);
+    test_assert(stats.dispatched == 0);
+
+    // events freed without dispatch go back to the chunk list
+    void *p1 = equeue_alloc(&q, 8);
+    void *p2 = equeue_alloc(&q, 32);
+    test_assert(p1 && p2);
+    equeue_stats(&q, &stats);
+    test_assert(stats.mem_used > 0);
+    test_assert(stats.mem_peak == stats.mem_used);
+    test_assert(stats.slab_used == stats.mem_used);
+
+    equeue_dealloc(&q, p1);
+    equeue_dealloc(&q, p2);
+    equeue_stats(&q, &stats);
+    test_assert(stats.mem_used == 0);
+    test_assert(stats.mem_peak > 0);
+    test_assert(stats.chunk_count == 2);
+    test_assert(stats.chunk_sizes == 2);
+    test_assert(stats.chunk_bytes == stats.slab_used);
+
+    // failures are counted
+    test_assert(!equeue_alloc(&q, 4096));
+    equeue_stats(&q, &stats);
+    test_assert(stats.alloc_failures == 1);
+
+    // dispatched events are counted in the histogram
+    int touched = 0;
+    equeue_call(&q, simple_func, &touched);
+    equeue_call(&q, simple_func, &touched);
+    usleep(20000);
+    equeue_dispatch(&q, 0);
+    test_assert(touched == 2);
+
+    equeue_stats(&q, &stats);
+    test_assert(stats.dispatched == 2);
+    test_assert(stats.latency_max >= 10);
+    unsigned total = 0;
+    for (int i = 0; i < EQUEUE_STATS_BUCKETS; i++) {
+        total += stats.latency_hist[i];
+    }
+    test_assert(total == 2);
+    test_assert(stats.latency_hist[0] == 0);
+
+    equeue_stats_reset(&q);
+    equeue_stats(&q, &stats);
+    test_assert(stats.dispatched == 0);
+    test_assert(stats.latency_max == 0);
+    test_assert(stats.alloc_failures == 0);
+    test_assert(stats.mem_peak == stats.mem_used);
+
+    equeue_destroy(&q);
+}
+#endif
+
 void multithreaded_barrage_test(int N) {
     equeue_t q;
     int err = equeue_create(&q, N*(EQUEUE_EVENT_SIZE+sizeof(struct timing)));
@@ -652,6 +758,242 @@ void multithreaded_barrage_test(int N) {
 }
 
 
+// User allocated event tests
+struct user_event {
+    struct equeue_event e;
+    equeue_t *q;
+    int count;
+    int reposts;
+};
+
+void user_func(void *p) {
+    struct user_event *u = (struct user_event*)((struct equeue_event*)p - 1);
+    u->count++;
+    if (u->reposts > 0) {
+        u->reposts--;
+        test_assert(equeue_post_user_allocated(u->q, user_func, p, 0));
+    }
+}
+
+void user_allocated_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, EQUEUE_EVENT_SIZE);
+    test_assert(!err);
+
+    // the queue's buffer is exhausted, user allocated events still post
+    void *p = equeue_alloc(&q, 2*sizeof(void*));
+    test_assert(p);
+    test_assert(!equeue_alloc(&q, 2*sizeof(void*)));
+
+    struct user_event u = {.q = &q};
+    equeue_user_allocated_init(&u.e + 1);
+
+    test_assert(equeue_post_user_allocated(&q, user_func, &u.e + 1, 0));
+    test_assert(!equeue_post_user_allocated(&q, user_func, &u.e + 1, 0));
+    equeue_dispatch(&q, 0);
+    test_assert(u.count == 1);
+
+    for (int i = 0; i < 10; i++) {
+        test_assert(equeue_post_user_allocated(&q, user_func, &u.e + 1, 0));
+        equeue_dispatch(&q, 0);
+    }
+    test_assert(u.count == 11);
+
+    test_assert(equeue_post_user_allocated(&q, user_func, &u.e + 1, 20));
+    equeue_dispatch(&q, 10);
+    test_assert(u.count == 11);
+    equeue_dispatch(&q, 20);
+    test_assert(u.count == 12);
+
+    u.count = 0;
+    equeue_event_period(&u.e + 1, 10);
+    test_assert(equeue_post_user_allocated(&q, user_func, &u.e + 1, 10));
+    equeue_dispatch(&q, 55);
+    test_assert(u.count == 5);
+    test_assert(!equeue_post_user_allocated(&q, user_func, &u.e + 1, 0));
+
+    equeue_cancel_user_allocated(&q, &u.e + 1);
+    equeue_dispatch(&q, 30);
+    test_assert(u.count == 5);
+
+    equeue_dealloc(&q, p);
+    equeue_destroy(&q);
+}
+
+struct user_cancel {
+    equeue_t *q;
+    struct user_event *u;
+};
+
+void user_cancel_func(void *p) {
+    struct user_cancel *c = (struct user_cancel*)p;
+    equeue_cancel_user_allocated(c->q, &c->u->e + 1);
+}
+
+void user_allocated_cancel_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    struct user_event u = {.q = &q};
+    equeue_user_allocated_init(&u.e + 1);
+
+    // cancelled while pending
+    test_assert(equeue_post_user_allocated(&q, user_func, &u.e + 1, 0));
+    equeue_cancel_user_allocated(&q, &u.e + 1);
+    equeue_dispatch(&q, 0);
+    test_assert(u.count == 0);
+
+    // cancelling an event that is not posted does nothing
+    for (int i = 0; i < 5; i++) {
+        equeue_cancel_user_allocated(&q, &u.e + 1);
+    }
+
+    // cancelled by an event dispatched just before it
+    struct user_cancel *c = equeue_alloc(&q, sizeof(struct user_cancel));
+    test_assert(c);
+    c->q = &q;
+    c->u = &u;
+    test_assert(equeue_post(&q, user_cancel_func, c));
+    test_assert(equeue_post_user_allocated(&q, user_func, &u.e + 1, 0));
+    equeue_dispatch(&q, 0);
+    test_assert(u.count == 0);
+
+    // released by the dispatch, it posts again
+    test_assert(equeue_post_user_allocated(&q, user_func, &u.e + 1, 0));
+    equeue_dispatch(&q, 0);
+    test_assert(u.count == 1);
+
+    equeue_destroy(&q);
+}
+
+void user_self_cancel_func(void *p) {
+    struct user_event *u = (struct user_event*)((struct equeue_event*)p - 1);
+    u->count++;
+    if (u->count == 3) {
+        equeue_cancel_user_allocated(u->q, p);
+    }
+}
+
+void user_allocated_self_cancel_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    struct user_event u = {.q = &q};
+    equeue_user_allocated_init(&u.e + 1);
+
+    // a periodic event cancelled by its own callback is released
+    equeue_event_period(&u.e + 1, 10);
+    test_assert(equeue_post_user_allocated(&q, user_self_cancel_func, &u.e + 1, 10));
+    equeue_dispatch(&q, 35);
+    test_assert(u.count == 3);
+    test_assert(!q.queue);
+
+    equeue_dispatch(&q, 30);
+    test_assert(u.count == 3);
+
+    // it posts again
+    equeue_event_period(&u.e + 1, -1);
+    test_assert(equeue_post_user_allocated(&q, user_self_cancel_func, &u.e + 1, 0));
+    equeue_dispatch(&q, 0);
+    test_assert(u.count == 4);
+
+    equeue_destroy(&q);
+}
+
+void user_allocated_repost_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    struct user_event u = {.q = &q, .reposts = 5};
+    equeue_user_allocated_init(&u.e + 1);
+
+    test_assert(equeue_post_user_allocated(&q, user_func, &u.e + 1, 0));
+    equeue_dispatch(&q, 10);
+    test_assert(u.count == 6);
+
+    equeue_destroy(&q);
+}
+
+
+// Deadline tests
+struct order {
+    int *log;
+    int *count;
+    int value;
+};
+
+void order_func(void *p) {
+    struct order *o = (struct order*)p;
+    o->log[(*o->count)++] = o->value;
+}
+
+static void post_order(equeue_t *q, int *log, int *count, int value,
+        int deadline) {
+    struct order *o = equeue_alloc(q, sizeof(struct order));
+    test_assert(o);
+    o->log = log;
+    o->count = count;
+    o->value = value;
+    equeue_event_deadline(o, deadline);
+    test_assert(equeue_post(q, order_func, o));
+}
+
+void deadline_order_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    int log[6];
+    int count = 0;
+    post_order(&q, log, &count, 0, -1);
+    post_order(&q, log, &count, 1, 50);
+    post_order(&q, log, &count, 2, -1);
+    post_order(&q, log, &count, 3, 10);
+    post_order(&q, log, &count, 4, 50);
+    post_order(&q, log, &count, 5, 0);
+
+    equeue_dispatch(&q, 0);
+    test_assert(count == 6);
+    test_assert(log[0] == 5);
+    test_assert(log[1] == 3);
+    test_assert(log[2] == 1);
+    test_assert(log[3] == 4);
+    test_assert(log[4] == 0);
+    test_assert(log[5] == 2);
+    test_assert(equeue_missed_deadlines(&q) == 0);
+
+    equeue_destroy(&q);
+}
+
+void deadline_miss_test(void) {
+    equeue_t q;
+    int err = equeue_create(&q, 2048);
+    test_assert(!err);
+
+    int touched = 0;
+    int *p = equeue_alloc(&q, sizeof(int*));
+    test_assert(p);
+    *(int **)p = &touched;
+    equeue_event_deadline(p, 5);
+    test_assert(equeue_post(&q, sloth_func_indirect, p));
+
+    p = equeue_alloc(&q, sizeof(int*));
+    test_assert(p);
+    *(int **)p = &touched;
+    equeue_event_deadline(p, 100);
+    test_assert(equeue_post(&q, sloth_func_indirect, p));
+
+    equeue_dispatch(&q, 0);
+    test_assert(touched == 2);
+    test_assert(equeue_missed_deadlines(&q) == 1);
+
+    equeue_destroy(&q);
+}
+
+
 int main() {
     printf("beginning tests...\n");
 
@@ -675,6 +1017,16 @@ int main() {
     test_run(simple_barrage_test, 20);
     test_run(fragmenting_barrage_test, 20);
     test_run(multithreaded_barrage_test, 20);
+    test_run(prealloc_test);
+    test_run(user_allocated_test);
+    test_run(user_allocated_cancel_test);
+    test_run(user_allocated_self_cancel_test);
+    test_run(user_allocated_repost_test);
+    test_run(deadline_order_test);
+    test_run(deadline_miss_test);
+#ifdef EQUEUE_STATS
+    test_run(stats_test);
+#endif
 
     printf("done!\n");
     return test_failure;
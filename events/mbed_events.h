@@ -27,6 +27,9 @@
 
 #include "events/EventQueue.h"
 #include "events/Event.h"
+#include "events/UserAllocatedEvent.h"
+#include "events/PriorityEventQueue.h"
+#include "events/DeferredInterruptIn.h"
 
 using namespace events;
 
@@ -0,0 +1,114 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BOND_STORE_H__
+#define __BOND_STORE_H__
+
+#include <stdint.h>
+
+#include "blecommon.h"
+#include "BLEProtocol.h"
+#include "FunctionPointerWithContext.h"
+
+/**
+ * Persistent database of the keys exchanged with bonded peers.
+ *
+ * A SecurityManager given a store with SecurityManager::setBondStore()
+ * adds the bonds it establishes to it, and restores the bonds of the
+ * store that its own bond table lacks, so a peer bonded before a reset
+ * resumes encryption with the stored keys instead of pairing again.
+ *
+ * Bonds are identified by the identity address of the peer; a store
+ * keeps at most one bond per peer. Like the rest of the BLE API, stores
+ * are only used from the thread processing the BLE events.
+ */
+class BondStore {
+public:
+    static const unsigned KEY_LEN  = 16; /**< Size of the LTK and IRK. */
+    static const unsigned RAND_LEN = 8;  /**< Size of the random number of an LTK. */
+
+    /**
+     * Long term key, and the values identifying it when the link is
+     * encrypted.
+     */
+    struct LongTermKey_t {
+        uint8_t  ltk[KEY_LEN];     /**< The key, LSB first. */
+        uint8_t  rand[RAND_LEN];   /**< Random number identifying the key. */
+        uint16_t ediv;             /**< Encrypted diversifier identifying the key. */
+        uint8_t  size;             /**< Size of the key in octets, 0 if the key wasn't distributed. */
+        uint8_t  authenticated;    /**< Nonzero if the key was exchanged with MITM protection. */
+        uint8_t  secureConnections; /**< Nonzero if the key comes from LE Secure Connections pairing. */
+    };
+
+    /**
+     * Keys of a bond, in the form they are stored.
+     */
+    struct Bond_t {
+        uint8_t                     peerAddrType; /**< BLEProtocol::AddressType_t of the identity address. */
+        BLEProtocol::AddressBytes_t peerAddr;     /**< Identity address of the peer. */
+        uint8_t                     ownRole;      /**< Gap::Role_t of this device when the bond was established. */
+        uint8_t                     irk[KEY_LEN]; /**< Identity resolving key of the peer, zero if it wasn't distributed. */
+        LongTermKey_t               peerLtk;      /**< Key distributed by the peer, used while it is the peripheral. */
+        LongTermKey_t               ownLtk;       /**< Key distributed to the peer, used while it is the central. */
+    };
+
+    typedef FunctionPointerWithContext<const Bond_t *> BondCallback_t;
+
+    virtual ~BondStore() {}
+
+    /**
+     * Store a bond, replacing the bond stored for the same peer.
+     *
+     * Storing the bond that is already stored does nothing, so bonds can
+     * be stored again whenever the stack updates them without wearing out
+     * the underlying storage.
+     *
+     * @param[in] bond  The bond to store.
+     *
+     * @return BLE_ERROR_NONE on success.
+     */
+    virtual ble_error_t store(const Bond_t &bond) = 0;
+
+    /**
+     * Remove the bond stored for a peer.
+     *
+     * @param[in] peerAddrType  Type of the identity address of the peer.
+     * @param[in] peerAddr      Identity address of the peer.
+     *
+     * @retval BLE_ERROR_NONE           On success.
+     * @retval BLE_ERROR_INVALID_PARAM  If no bond is stored for the peer.
+     */
+    virtual ble_error_t remove(BLEProtocol::AddressType_t peerAddrType, const BLEProtocol::AddressBytes_t peerAddr) = 0;
+
+    /**
+     * Remove all the stored bonds.
+     *
+     * @return BLE_ERROR_NONE on success.
+     */
+    virtual ble_error_t clear(void) = 0;
+
+    /**
+     * Call a function with each stored bond.
+     *
+     * @param[in] callback  Called with each bond, which is only valid
+     *                      during the call; it must not modify the store.
+     *
+     * @return BLE_ERROR_NONE on success.
+     */
+    virtual ble_error_t forEach(const BondCallback_t &callback) = 0;
+};
+
+#endif /* __BOND_STORE_H__ */
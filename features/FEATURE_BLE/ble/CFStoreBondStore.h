@@ -0,0 +1,73 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CFSTORE_BOND_STORE_H__
+#define __CFSTORE_BOND_STORE_H__
+
+#include "ble/BondStore.h"
+
+#if FEATURE_STORAGE
+
+#include "configuration-store/configuration_store.h"
+
+/**
+ * Bond store in the configuration store.
+ *
+ * Each bond is a non-volatile key named ble.bond. followed by the type and
+ * identity address of the peer, e.g. ble.bond.1.c0ffee012345. The store
+ * is flushed whenever a bond changes; bonds stored again unchanged, as
+ * the stack does on each reconnection, cause no writes.
+ *
+ * Only the synchronous mode of the configuration store is supported.
+ *
+ * @code
+ * CFStoreBondStore bonds;
+ * ble.securityManager().setBondStore(&bonds);
+ * ble.securityManager().init();
+ * @endcode
+ */
+class CFStoreBondStore : public BondStore {
+public:
+    /**
+     * Create a bond store.
+     *
+     * Initializes the configuration store, which may already be
+     * initialized by the application.
+     */
+    CFStoreBondStore();
+
+    virtual ~CFStoreBondStore();
+
+    virtual ble_error_t store(const Bond_t &bond);
+    virtual ble_error_t remove(BLEProtocol::AddressType_t peerAddrType, const BLEProtocol::AddressBytes_t peerAddr);
+    virtual ble_error_t clear(void);
+    virtual ble_error_t forEach(const BondCallback_t &callback);
+
+private:
+    void keyName(uint8_t peerAddrType, const BLEProtocol::AddressBytes_t peerAddr, char *name);
+    bool read(const char *name, Bond_t *bond);
+    bool erase(const char *name);
+
+    CFStoreBondStore(const CFStoreBondStore &);
+    CFStoreBondStore &operator=(const CFStoreBondStore &);
+
+    ARM_CFSTORE_DRIVER *drv;
+    bool                initialized;
+};
+
+#endif
+
+#endif /* __CFSTORE_BOND_STORE_H__ */
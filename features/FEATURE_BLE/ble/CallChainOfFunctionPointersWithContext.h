@@ -54,6 +54,20 @@
  *     chain.call();
  * }
  * @endcode
+ *
+ * The functions added with add() are copied into nodes allocated on the heap.
+ * A handler can instead provide its own node to addStatic(), which is linked
+ * into the chain as is; registering it doesn't allocate, and the node can be
+ * statically allocated:
+ *
+ * @code
+ *
+ * static FunctionPointerWithContext<void *> node(second);
+ *
+ * chain.addStatic(node);
+ * chain.call(NULL);
+ * chain.detach(node); // the node isn't freed
+ * @endcode
  */
 template <typename ContextType>
 class CallChainOfFunctionPointersWithContext : public SafeBool<CallChainOfFunctionPointersWithContext<ContextType> > {
@@ -67,7 +81,7 @@ public:
     /**
      * Create an empty chain.
      */
-    CallChainOfFunctionPointersWithContext() : chainHead(NULL) {
+    CallChainOfFunctionPointersWithContext() : chainHead(NULL), staticHead(NULL), currentCalled(NULL) {
         /* empty */
     }
 
@@ -114,11 +128,40 @@ public:
         return common_add(new FunctionPointerWithContext<ContextType>(func));
     }
 
+    /**
+     * Link a node provided by the caller at the front of the statically
+     * allocated part of the chain, without allocating memory.
+     *
+     * @param[in] node
+     *              The function to add. It is linked as is, not copied, and
+     *              must stay alive until detached or the chain is cleared. A
+     *              node can be linked in a single chain at a time.
+     *
+     * @return  The node, or NULL if it is already in the chain.
+     *
+     * @note Nodes added with addStatic() are called after the ones added with
+     *       add().
+     */
+    pFunctionPointerWithContext_t addStatic(FunctionPointerWithContext<ContextType>& node) {
+        for (pFunctionPointerWithContext_t current = staticHead; current; current = current->getNext()) {
+            if (current == &node) {
+                return NULL;
+            }
+        }
+
+        node.chainAsNext(staticHead);
+        staticHead = &node;
+
+        return staticHead;
+    }
+
     /**
      * Detach a function pointer from a callchain.
      *
      * @param[in] toDetach
      *              FunctionPointerWithContext to detach from this callchain.
+     *              The nodes allocated by add() are freed; the ones linked
+     *              with addStatic() are only unlinked.
      *
      * @return true if a function pointer has been detached and false otherwise.
      *
@@ -126,28 +169,16 @@ public:
      *       traversed by call(ContextType).
      */
     bool detach(const FunctionPointerWithContext<ContextType>& toDetach) {
-        pFunctionPointerWithContext_t current = chainHead;
-        pFunctionPointerWithContext_t previous = NULL;
-
-        while (current) {
-            if(*current == toDetach) {
-                if(previous == NULL) {
-                    if(currentCalled == current) {
-                        currentCalled = NULL;
-                    }
-                    chainHead = current->getNext();
-                } else {
-                    if(currentCalled == current) {
-                        currentCalled = previous;
-                    }
-                    previous->chainAsNext(current->getNext());
-                }
-                delete current;
-                return true;
-            }
+        pFunctionPointerWithContext_t detached = unlink(chainHead, toDetach);
+        if (detached) {
+            delete detached;
+            return true;
+        }
 
-            previous = current;
-            current = current->getNext();
+        detached = unlink(staticHead, toDetach);
+        if (detached) {
+            detached->chainAsNext(NULL);
+            return true;
         }
 
         return false;
@@ -164,7 +195,15 @@ public:
             delete deadPtr;
         }
 
+        fptr = staticHead;
+        while (fptr) {
+            pFunctionPointerWithContext_t unlinkedPtr = fptr;
+            fptr = unlinkedPtr->getNext();
+            unlinkedPtr->chainAsNext(NULL);
+        }
+
         chainHead = NULL;
+        staticHead = NULL;
     }
 
     /**
@@ -173,7 +212,7 @@ public:
      * @return true if the callchain is not empty and false otherwise.
      */
     bool hasCallbacksAttached(void) const {
-        return (chainHead != NULL);
+        return (chainHead != NULL) || (staticHead != NULL);
     }
 
     /**
@@ -187,17 +226,8 @@ public:
      * Same as call() above, but const.
      */
     void call(ContextType context) const {
-        currentCalled = chainHead;
-
-        while(currentCalled) {
-            currentCalled->call(context);
-            // if this was the head and the call removed the head
-            if(currentCalled == NULL) {
-                currentCalled = chainHead;
-            } else {
-                currentCalled = currentCalled->getNext();
-            }
-        }
+        callList(chainHead, context);
+        callList(staticHead, context);
     }
 
     /**
@@ -227,7 +257,7 @@ public:
      * @return true if the callchain is not empty and false otherwise.
      */
     bool toBool() const {
-        return chainHead != NULL;
+        return hasCallbacksAttached();
     }
 
 private:
@@ -247,12 +277,67 @@ private:
         return chainHead;
     }
 
+    /**
+     * Unlink the first callback equal to @p toRemove from the list starting
+     * at @p head, keeping a traversal of the list by call() valid.
+     *
+     * @return The callback unlinked, or NULL if there is none.
+     */
+    pFunctionPointerWithContext_t unlink(pFunctionPointerWithContext_t &head, const FunctionPointerWithContext<ContextType>& toRemove) {
+        pFunctionPointerWithContext_t current = head;
+        pFunctionPointerWithContext_t previous = NULL;
+
+        while (current) {
+            if(*current == toRemove) {
+                if(previous == NULL) {
+                    if(currentCalled == current) {
+                        currentCalled = NULL;
+                    }
+                    head = current->getNext();
+                } else {
+                    if(currentCalled == current) {
+                        currentCalled = previous;
+                    }
+                    previous->chainAsNext(current->getNext());
+                }
+                return current;
+            }
+
+            previous = current;
+            current = current->getNext();
+        }
+
+        return NULL;
+    }
+
+    /**
+     * Call the callbacks of the list starting at @p head.
+     */
+    void callList(const pFunctionPointerWithContext_t &head, ContextType context) const {
+        currentCalled = head;
+
+        while(currentCalled) {
+            currentCalled->call(context);
+            // if this was the head and the call removed the head
+            if(currentCalled == NULL) {
+                currentCalled = head;
+            } else {
+                currentCalled = currentCalled->getNext();
+            }
+        }
+    }
+
 private:
     /**
      * A pointer to the first callback in the callchain or NULL if the callchain is empty.
      */
     pFunctionPointerWithContext_t chainHead;
 
+    /**
+     * A pointer to the first callback linked with addStatic(), or NULL if there is none.
+     */
+    pFunctionPointerWithContext_t staticHead;
+
     /**
      * Iterator during a function call, this has to be mutable because the call function is const.
      *
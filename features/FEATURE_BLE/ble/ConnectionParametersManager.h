@@ -0,0 +1,164 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CONNECTION_PARAMETERS_MANAGER_H__
+#define __CONNECTION_PARAMETERS_MANAGER_H__
+
+#include "ble/BLE.h"
+#include "drivers/Timer.h"
+
+/**
+ * Switch the parameters of a connection between a fast profile, for
+ * traffic, and a slow one, saving power while the link is idle.
+ *
+ * The manager follows the first connection opened once it is created, and
+ * requests the fast profile for it. GATT traffic on the connection (reads,
+ * writes, notifications sent or received, notifications queued on the
+ * GattServer) and calls to activity() keep it there; once idleTimeout passes without
+ * any, it requests the slow profile. The next traffic requests the fast
+ * profile again. A profile is kept for at least minProfileTime, so a
+ * trickle of traffic doesn't make the parameters flap.
+ *
+ * Idle time is only checked by process(), to be called periodically from
+ * the application's event loop, e.g. every 100ms:
+ *
+ * @code
+ * ConnectionParametersManager manager(ble, fastParams, slowParams);
+ * eventQueue.call_every(100, &manager, &ConnectionParametersManager::process);
+ * @endcode
+ *
+ * The profiles are requested with Gap::updateConnectionParams(); a peer
+ * may refuse them or pick other values within their range.
+ */
+class ConnectionParametersManager {
+public:
+    /**
+     * The connection parameter profiles.
+     */
+    enum Profile_t {
+        PROFILE_FAST = 0, /**< For traffic: short connection interval. */
+        PROFILE_SLOW = 1, /**< While idle: long interval, slave latency. */
+        PROFILE_NONE = 2, /**< Not connected, or no profile requested yet. */
+    };
+
+    /**
+     * Time spent in each profile, and profile changes.
+     */
+    struct Statistics_t {
+        uint32_t fastTimeMs;     /**< Time spent in the fast profile. */
+        uint32_t slowTimeMs;     /**< Time spent in the slow profile. */
+        uint32_t switches;       /**< Profile changes requested successfully. */
+        uint32_t failedRequests; /**< Requests Gap::updateConnectionParams() failed, retried by process(). */
+    };
+
+    /**
+     * Create a manager, following the next connection.
+     *
+     * @param[in] ble
+     *              The BLE instance of the connection.
+     * @param[in] fast
+     *              Parameters requested while there is traffic.
+     * @param[in] slow
+     *              Parameters requested while the connection is idle.
+     * @param[in] idleTimeoutMs
+     *              Time without traffic before the slow profile is requested.
+     * @param[in] minProfileTimeMs
+     *              Minimum time between profile changes.
+     */
+    ConnectionParametersManager(BLE                             &ble,
+                                const Gap::ConnectionParams_t   &fast,
+                                const Gap::ConnectionParams_t   &slow,
+                                uint32_t                         idleTimeoutMs    = 2000,
+                                uint32_t                         minProfileTimeMs = 1000);
+
+    ~ConnectionParametersManager();
+
+    /**
+     * Report traffic the manager can't see, such as an upcoming bulk
+     * transfer, requesting the fast profile.
+     */
+    void activity(void);
+
+    /**
+     * Account the time elapsed, and request the slow profile once the
+     * connection is idle.
+     */
+    void process(void);
+
+    /**
+     * @return The current profile.
+     */
+    Profile_t getProfile(void) const {
+        return profile;
+    }
+
+    /**
+     * Get the statistics since the manager was created or they were reset.
+     */
+    void getStatistics(Statistics_t *stats);
+
+    /**
+     * Reset the statistics.
+     */
+    void resetStatistics(void);
+
+private:
+    void onConnection(const Gap::ConnectionCallbackParams_t *params);
+    void onDisconnection(const Gap::DisconnectionCallbackParams_t *params);
+    void onDataSent(unsigned count);
+    void onServerDataWritten(const GattWriteCallbackParams *params);
+    void onServerDataRead(const GattReadCallbackParams *params);
+    void onClientDataRead(const GattReadCallbackParams *params);
+    void onClientDataWritten(const GattWriteCallbackParams *params);
+    void onHVX(const GattHVXCallbackParams *params);
+
+    void traffic(Gap::Handle_t handle);
+    void elapse(void);
+    void apply(void);
+
+private:
+    BLE                     &ble;
+    Gap::ConnectionParams_t  profiles[2];
+    uint32_t                 idleTimeoutUs;
+    uint32_t                 minProfileTimeUs;
+
+    bool                     connected;
+    Gap::Handle_t            connectionHandle;
+    Profile_t                profile;        /**< The last profile requested successfully. */
+    Profile_t                wantedProfile;  /**< Differs from profile while a change waits. */
+    mbed::Timer              timer;          /**< Time since the last call to elapse(). */
+    uint32_t                 idleUs;         /**< Time since the last traffic, saturating. */
+    uint32_t                 profileUs;      /**< Time since the last profile change, saturating. */
+    uint32_t                 remainderUs;    /**< Time in the profile not yet accounted in stats. */
+    Statistics_t             stats;
+
+    /* Linked in the event chains, without allocating. */
+    Gap::ConnectionEventCallback_t      onConnectionHandler;
+    Gap::DisconnectionEventCallback_t   onDisconnectionHandler;
+    GattServer::DataSentCallback_t      onDataSentHandler;
+    GattServer::DataWrittenCallback_t   onServerDataWrittenHandler;
+    GattServer::DataReadCallback_t      onServerDataReadHandler;
+    GattClient::ReadCallback_t          onClientDataReadHandler;
+    GattClient::WriteCallback_t         onClientDataWrittenHandler;
+    GattClient::HVXCallback_t           onHVXHandler;
+
+private:
+    /* Disallow copy and assignment. */
+    ConnectionParametersManager(const ConnectionParametersManager &);
+    ConnectionParametersManager& operator=(const ConnectionParametersManager &);
+};
+
+#endif /* __CONNECTION_PARAMETERS_MANAGER_H__ */
@@ -185,6 +185,27 @@ public:
         uint16_t connectionSupervisionTimeout; /**< Connection Supervision Timeout in 10 ms units, see BLE_GAP_CP_LIMITS.*/
     } ConnectionParams_t;
 
+    /**
+     * Link layer PHYs, combined as a bit set where several are allowed.
+     */
+    enum Phy_t {
+        PHY_1M = 0x01, /**< 1 Mbit/s PHY. */
+        PHY_2M = 0x02, /**< 2 Mbit/s PHY. */
+    };
+
+    /**
+     * Link layer parameters of a connection, reported when a PHY update or
+     * data length change procedure completes. Refer to Gap::onLinkUpdate().
+     */
+    struct LinkUpdateCallbackParams_t {
+        Handle_t    handle;      /**< The connection the procedure ran on. */
+        ble_error_t status;      /**< BLE_ERROR_NONE if the procedure completed, the fields below hold the parameters in use either way. */
+        uint8_t     txPhy;       /**< PHY used for transmission, a Phy_t. */
+        uint8_t     rxPhy;       /**< PHY used for reception, a Phy_t. */
+        uint16_t    maxTxOctets; /**< Largest link layer payload sent, in bytes. */
+        uint16_t    maxRxOctets; /**< Largest link layer payload received, in bytes. */
+    };
+
     /**
      * Enumeration for the possible GAP roles of a BLE device.
      */
@@ -211,6 +232,33 @@ public:
      */
     typedef FunctionPointerWithContext<const AdvertisementCallbackParams_t *> AdvertisementReportCallback_t;
 
+    /**
+     * A scanned advertising packet, copied for batched delivery. Refer to
+     * Gap::startBatchedScan().
+     */
+    struct AdvertisementReport_t {
+        BLEProtocol::AddressBytes_t              peerAddr;           /**< The peer's BLE address. */
+        int8_t                                   rssi;               /**< The advertisement packet RSSI value. */
+        bool                                     isScanResponse;     /**< Whether this packet is the response to a scan request. */
+        GapAdvertisingParams::AdvertisingType_t  type;               /**< The type of advertisement. */
+        uint8_t                                  advertisingDataLen; /**< Length of the advertisement data. */
+        uint8_t                                  advertisingData[GAP_ADVERTISING_DATA_MAX_PAYLOAD]; /**< The advertisement packet's data. */
+    };
+
+    /**
+     * Reports delivered together. Refer to Gap::startBatchedScan().
+     */
+    struct AdvertisementReportBatch_t {
+        const AdvertisementReport_t *reports; /**< The reports, oldest first, in the buffer given to startBatchedScan(). */
+        uint8_t                      count;   /**< Number of reports. */
+    };
+
+    /**
+     * Type for the handlers of batched advertisement reports. Refer to
+     * Gap::startBatchedScan().
+     */
+    typedef FunctionPointerWithContext<const AdvertisementReportBatch_t *> AdvertisementReportBatchCallback_t;
+
     /**
      * Encapsulates the parameters of a connection. This information is passed
      * to the registered handler of connection events. Refer to Gap::onConnection().
@@ -328,6 +376,16 @@ public:
      */
     typedef CallChainOfFunctionPointersWithContext<const DisconnectionCallbackParams_t*> DisconnectionEventCallbackChain_t;
 
+    /**
+     * Type for the registered callbacks added to the link update event
+     * callchain. Refer to Gap::onLinkUpdate().
+     */
+    typedef FunctionPointerWithContext<const LinkUpdateCallbackParams_t *> LinkUpdateEventCallback_t;
+    /**
+     * Type for the link update event callchain. Refer to Gap::onLinkUpdate().
+     */
+    typedef CallChainOfFunctionPointersWithContext<const LinkUpdateCallbackParams_t *> LinkUpdateEventCallbackChain_t;
+
     /**
      * Type for the handlers of radio notification callback events. Refer to
      * Gap::onRadioNotification().
@@ -585,6 +643,50 @@ public:
         return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porter(s): override this API if this capability is supported. */
     }
 
+    /**
+     * Request a change of the PHYs of a connection. This initiates a Link
+     * Layer PHY update procedure; the PHYs chosen by the controllers among
+     * those allowed are reported to the onLinkUpdate() callbacks.
+     *
+     * @param[in] handle
+     *              Connection Handle.
+     * @param[in] txPhys
+     *              Set of Phy_t allowed for transmission.
+     * @param[in] rxPhys
+     *              Set of Phy_t allowed for reception.
+     *
+     * @return BLE_ERROR_NONE if the procedure was started.
+     */
+    virtual ble_error_t setPhy(Handle_t handle, uint8_t txPhys, uint8_t rxPhys) {
+        /* avoid compiler warnings about unused variables */
+        (void)handle;
+        (void)txPhys;
+        (void)rxPhys;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porter(s): override this API if this capability is supported. */
+    }
+
+    /**
+     * Request longer Link Layer payloads on a connection (Data Length
+     * Extension). This initiates a Link Layer data length update procedure;
+     * the payload sizes agreed with the peer are reported to the
+     * onLinkUpdate() callbacks.
+     *
+     * @param[in] handle
+     *              Connection Handle.
+     * @param[in] maxTxOctets
+     *              Largest payload to send, in bytes, 27 to 251.
+     *
+     * @return BLE_ERROR_NONE if the procedure was started.
+     */
+    virtual ble_error_t setDataLength(Handle_t handle, uint16_t maxTxOctets) {
+        /* avoid compiler warnings about unused variables */
+        (void)handle;
+        (void)maxTxOctets;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porter(s): override this API if this capability is supported. */
+    }
+
     /**
      * Set the device name characteristic in the GAP service.
      *
@@ -1351,6 +1453,7 @@ public:
         if (callback) {
             if ((err = startRadioScan(_scanningParams)) == BLE_ERROR_NONE) {
                 scanningActive = true;
+                scanStarted();
                 onAdvertisementReport.attach(callback);
             }
         }
@@ -1379,6 +1482,7 @@ public:
         if (object && callbackMember) {
             if ((err = startRadioScan(_scanningParams)) == BLE_ERROR_NONE) {
                 scanningActive = true;
+                scanStarted();
                 onAdvertisementReport.attach(object, callbackMember);
             }
         }
@@ -1386,6 +1490,89 @@ public:
         return err;
     }
 
+    /**
+     * Start scanning, with the reports copied into a buffer and delivered in
+     * batches rather than one callback per report.
+     *
+     * A batch is delivered once the buffer is full, and by the BLE stack
+     * specific implementation once it has processed the events pending from
+     * the stack; flushAdvertisementReports() delivers it at any other time.
+     * When many devices advertise, the callback is invoked once for many
+     * reports.
+     *
+     * @param[in] buffer
+     *              Storage for the reports, which must remain valid until
+     *              scanning is started again.
+     * @param[in] size
+     *              Number of reports the buffer holds.
+     * @param[in] callback
+     *              Invoked with each batch.
+     *
+     * @return BLE_ERROR_NONE if the device successfully started the scan
+     *         procedure.
+     */
+    ble_error_t startBatchedScan(AdvertisementReport_t                    *buffer,
+                                 uint8_t                                   size,
+                                 const AdvertisementReportBatchCallback_t &callback) {
+        if ((buffer == NULL) || (size == 0) || !callback) {
+            return BLE_ERROR_INVALID_PARAM;
+        }
+
+        ble_error_t err = startRadioScan(_scanningParams);
+        if (err == BLE_ERROR_NONE) {
+            scanningActive = true;
+            scanStarted();
+            onAdvertisementReport      = NULL;
+            reportBatchBuffer          = buffer;
+            reportBatchSize            = size;
+            onAdvertisementReportBatch = callback;
+        }
+
+        return err;
+    }
+
+    /**
+     * Deliver the reports buffered since the last batch, if any. Refer to
+     * Gap::startBatchedScan().
+     */
+    void flushAdvertisementReports(void) {
+        if (reportBatchCount == 0) {
+            return;
+        }
+
+        AdvertisementReportBatch_t batch = { reportBatchBuffer, reportBatchCount };
+        reportBatchCount = 0;
+        onAdvertisementReportBatch.call(&batch);
+    }
+
+    /**
+     * Enable or disable the filtering of duplicate advertising reports.
+     *
+     * With the filter enabled, a report is dropped if one with the same
+     * address, type and data was reported since scanning started, among the
+     * last SCAN_DUPLICATE_FILTER_SIZE reported. A device changing its
+     * advertising data is reported again; a device only changing its RSSI
+     * isn't. The remembered reports are forgotten on each start of scanning.
+     *
+     * Combined with the whitelist (refer to Gap::setScanningPolicyMode()),
+     * only the changes of known devices are reported.
+     *
+     * @param[in] enable
+     *              True to filter the duplicates out.
+     *
+     * @return BLE_ERROR_NONE if the filter was set.
+     */
+    ble_error_t setScanDuplicateFiltering(bool enable) {
+        scanDuplicateFiltering = enable;
+        return BLE_ERROR_NONE;
+    }
+
+    /**
+     * Number of recent reports the duplicate filter remembers. Refer to
+     * Gap::setScanDuplicateFiltering().
+     */
+    static const unsigned SCAN_DUPLICATE_FILTER_SIZE = 16;
+
     /**
      * Initialize radio-notification events to be generated from the stack.
      * This API doesn't need to be called directly.
@@ -1579,6 +1766,47 @@ public:
         return disconnectionCallChain;
     }
 
+    /**
+     * Set up a callback for the completion of PHY update and data length
+     * change procedures, whether requested locally through setPhy() and
+     * setDataLength() or by the peer.
+     *
+     * @param[in] callback
+     *              Event handler being registered.
+     *
+     * @note It is possible to unregister callbacks using
+     *       onLinkUpdate().detach(callback).
+     */
+    void onLinkUpdate(LinkUpdateEventCallback_t callback) {
+        linkUpdateCallChain.add(callback);
+    }
+
+    /**
+     * Same as Gap::onLinkUpdate(), but allows the possibility to add an object
+     * reference and member function as handler for link update event
+     * callbacks.
+     *
+     * @param[in] tptr
+     *              Pointer to the object of a class defining the member callback
+     *              function (@p mptr).
+     * @param[in] mptr
+     *              The member callback (within the context of an object) to be
+     *              invoked.
+     */
+    template<typename T>
+    void onLinkUpdate(T *tptr, void (T::*mptr)(const LinkUpdateCallbackParams_t*)) {
+        linkUpdateCallChain.add(tptr, mptr);
+    }
+
+    /**
+     * @brief Provide access to the callchain of link update event callbacks.
+     *
+     * @return A reference to the link update event callback chain.
+     */
+    LinkUpdateEventCallbackChain_t& onLinkUpdate() {
+        return linkUpdateCallChain;
+    }
+
     /**
      * Set the application callback for radio-notification events.
      *
@@ -1707,9 +1935,19 @@ public:
         timeoutCallbackChain.clear();
         connectionCallChain.clear();
         disconnectionCallChain.clear();
+        linkUpdateCallChain.clear();
         radioNotificationCallback = NULL;
         onAdvertisementReport     = NULL;
 
+        /* Clear batching and filtering of the reports */
+        reportBatchBuffer          = NULL;
+        reportBatchSize            = 0;
+        reportBatchCount           = 0;
+        onAdvertisementReportBatch = NULL;
+        scanDuplicateFiltering     = false;
+        scanDuplicateCount         = 0;
+        scanDuplicateNext          = 0;
+
         return BLE_ERROR_NONE;
     }
 
@@ -1729,7 +1967,16 @@ protected:
         radioNotificationCallback(),
         onAdvertisementReport(),
         connectionCallChain(),
-        disconnectionCallChain() {
+        disconnectionCallChain(),
+        linkUpdateCallChain(),
+        reportBatchBuffer(NULL),
+        reportBatchSize(0),
+        reportBatchCount(0),
+        onAdvertisementReportBatch(),
+        scanDuplicateFiltering(false),
+        scanDuplicates(),
+        scanDuplicateCount(0),
+        scanDuplicateNext(0) {
         _advPayload.clear();
         _scanResponse.clear();
     }
@@ -1793,6 +2040,19 @@ public:
         disconnectionCallChain.call(&callbackParams);
     }
 
+    /**
+     * Helper function that notifies all registered handlers of the
+     * completion of a PHY update or data length change procedure. This
+     * function is meant to be called from the BLE stack specific
+     * implementation when such an event occurs.
+     *
+     * @param[in] params
+     *              The link parameters of the connection.
+     */
+    void processLinkUpdateEvent(const LinkUpdateCallbackParams_t *params) {
+        linkUpdateCallChain.call(params);
+    }
+
     /**
      * Helper function that notifies the registered handler of a scanned
      * advertisement packet. This function is meant to be called from the
@@ -1817,6 +2077,25 @@ public:
                                     GapAdvertisingParams::AdvertisingType_t  type,
                                     uint8_t                                  advertisingDataLen,
                                     const uint8_t                           *advertisingData) {
+        if (scanDuplicateFiltering && isDuplicateReport(peerAddr, isScanResponse, type, advertisingDataLen, advertisingData)) {
+            return;
+        }
+
+        if (reportBatchBuffer) {
+            AdvertisementReport_t &report = reportBatchBuffer[reportBatchCount++];
+            memcpy(report.peerAddr, peerAddr, ADDR_LEN);
+            report.rssi               = rssi;
+            report.isScanResponse     = isScanResponse;
+            report.type               = type;
+            report.advertisingDataLen = (advertisingDataLen < GAP_ADVERTISING_DATA_MAX_PAYLOAD) ? advertisingDataLen : GAP_ADVERTISING_DATA_MAX_PAYLOAD;
+            memcpy(report.advertisingData, advertisingData, report.advertisingDataLen);
+
+            if (reportBatchCount == reportBatchSize) {
+                flushAdvertisementReports();
+            }
+            return;
+        }
+
         AdvertisementCallbackParams_t params;
         memcpy(params.peerAddr, peerAddr, ADDR_LEN);
         params.rssi               = rssi;
@@ -1902,6 +2181,11 @@ protected:
      * events.
      */
     DisconnectionEventCallbackChain_t disconnectionCallChain;
+    /**
+     * Callchain containing all registered callback handlers for link update
+     * events.
+     */
+    LinkUpdateEventCallbackChain_t    linkUpdateCallChain;
 
 private:
     /**
@@ -1910,6 +2194,65 @@ private:
      */
     GapShutdownCallbackChain_t shutdownCallChain;
 
+private:
+    /* A report remembered by the duplicate filter */
+    struct ScanDuplicate_t {
+        BLEProtocol::AddressBytes_t peerAddr;
+        uint16_t                    hash;     /**< Of the type and data of the report. */
+    };
+
+    /*
+     * Forget the reports of the previous scan, and switch back to reports
+     * delivered one by one.
+     */
+    void scanStarted(void) {
+        reportBatchBuffer  = NULL;
+        reportBatchCount   = 0;
+        scanDuplicateCount = 0;
+        scanDuplicateNext  = 0;
+    }
+
+    /*
+     * Check whether a report was already seen among the recent ones,
+     * remembering it otherwise.
+     */
+    bool isDuplicateReport(const BLEProtocol::AddressBytes_t        peerAddr,
+                           bool                                     isScanResponse,
+                           GapAdvertisingParams::AdvertisingType_t  type,
+                           uint8_t                                  advertisingDataLen,
+                           const uint8_t                           *advertisingData) {
+        /* FNV-1a, folded to 16 bits */
+        uint32_t hash = 2166136261UL;
+        hash = (hash ^ (type | (isScanResponse ? 0x80 : 0))) * 16777619UL;
+        for (uint8_t i = 0; i < advertisingDataLen; i++) {
+            hash = (hash ^ advertisingData[i]) * 16777619UL;
+        }
+        uint16_t folded = (uint16_t)(hash ^ (hash >> 16));
+
+        for (uint8_t i = 0; i < scanDuplicateCount; i++) {
+            if ((scanDuplicates[i].hash == folded) && (memcmp(scanDuplicates[i].peerAddr, peerAddr, ADDR_LEN) == 0)) {
+                return true;
+            }
+        }
+
+        memcpy(scanDuplicates[scanDuplicateNext].peerAddr, peerAddr, ADDR_LEN);
+        scanDuplicates[scanDuplicateNext].hash = folded;
+        scanDuplicateNext = (scanDuplicateNext + 1) % SCAN_DUPLICATE_FILTER_SIZE;
+        if (scanDuplicateCount < SCAN_DUPLICATE_FILTER_SIZE) {
+            scanDuplicateCount++;
+        }
+        return false;
+    }
+
+    AdvertisementReport_t              *reportBatchBuffer;
+    uint8_t                             reportBatchSize;
+    uint8_t                             reportBatchCount;
+    AdvertisementReportBatchCallback_t  onAdvertisementReportBatch;
+    bool                                scanDuplicateFiltering;
+    ScanDuplicate_t                     scanDuplicates[SCAN_DUPLICATE_FILTER_SIZE];
+    uint8_t                             scanDuplicateCount;
+    uint8_t                             scanDuplicateNext;
+
 private:
     /* Disallow copy and assignment. */
     Gap(const Gap &);
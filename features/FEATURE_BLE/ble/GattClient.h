@@ -76,6 +76,43 @@ public:
      */
     typedef CallChainOfFunctionPointersWithContext<const GattClient *> GattClientShutdownCallbackChain_t;
 
+    /**
+     * Parameters of an ATT MTU change. Refer to GattClient::onAttMtuChange().
+     */
+    struct AttMtuChangeCallbackParams_t {
+        Gap::Handle_t connHandle; /**< The connection the MTU applies to. */
+        ble_error_t   status;     /**< BLE_ERROR_NONE if the exchange completed. */
+        uint16_t      attMtuSize; /**< ATT MTU in use on the connection, in bytes. */
+    };
+
+    /**
+     * Type for the registered callbacks added to the ATT MTU change callchain.
+     * Refer to GattClient::onAttMtuChange().
+     */
+    typedef FunctionPointerWithContext<const AttMtuChangeCallbackParams_t*> AttMtuChangeCallback_t;
+    /**
+     * Type for the ATT MTU change callchain. Refer to GattClient::onAttMtuChange().
+     */
+    typedef CallChainOfFunctionPointersWithContext<const AttMtuChangeCallbackParams_t*> AttMtuChangeCallbackChain_t;
+
+    /**
+     * Parameters of the completion of a queued operation. Refer to
+     * GattClient::queueRead() and GattClient::queueWrite().
+     */
+    struct QueuedOperationCallbackParams_t {
+        Gap::Handle_t           connHandle; /**< The connection the operation ran on. */
+        GattAttribute::Handle_t handle;     /**< The attribute read or written. */
+        ble_error_t             status;     /**< BLE_ERROR_NONE if the operation completed. */
+        uint16_t                len;        /**< Length of the value read into the buffer, or written. */
+        const uint8_t          *data;       /**< The buffer of the operation. */
+    };
+
+    /**
+     * Type for the callbacks completing queued operations.
+     * Refer to GattClient::queueRead().
+     */
+    typedef FunctionPointerWithContext<const QueuedOperationCallbackParams_t*> QueuedOperationCallback_t;
+
     /*
      * The following functions are meant to be overridden in the platform-specific sub-class.
      */
@@ -241,6 +278,41 @@ public:
         /* Requesting action from porters: override this API if this capability is supported. */
     }
 
+    /**
+     * Enable or disable the caching of service discovery results.
+     *
+     * With the cache enabled, a complete discovery (no UUID filters, with a
+     * characteristic callback) records the services and characteristics of
+     * the peer, by peer address. A later launchServiceDiscovery() on a
+     * connection to the same peer replays them from the cache, without
+     * querying the peer: the callbacks, then the termination callback, are
+     * invoked before launchServiceDiscovery() returns.
+     *
+     * The cache trusts the peer's database not to change; clear it when the
+     * peer signals otherwise, or when it isn't bonded and may use another
+     * database under the same address. Disabling the cache clears it.
+     *
+     * @param[in] enable
+     *              True to enable the cache, false to disable and clear it.
+     *
+     * @return BLE_ERROR_NONE if successful.
+     */
+    virtual ble_error_t enableServiceDiscoveryCache(bool enable) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)enable;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
+    /**
+     * Forget the services and characteristics cached for all peers.
+     *
+     * @return BLE_ERROR_NONE if successful.
+     */
+    virtual ble_error_t clearServiceDiscoveryCache(void) {
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
     /**
      * Initiate a GATT Client read procedure by attribute-handle.
      *
@@ -297,6 +369,91 @@ public:
         return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
     }
 
+    /**
+     * Queue the read of a whole attribute value.
+     *
+     * Unlike read(), operations can be queued while others are outstanding:
+     * they run in order, each connection with one request at a time to the
+     * peer. A value longer than a read response is read in as many requests
+     * as needed, at increasing offsets.
+     *
+     * @param[in] connHandle
+     *              Handle of the connection.
+     * @param[in] attributeHandle
+     *              Handle of the attribute to read.
+     * @param[out] buffer
+     *              Buffer receiving the value, which must remain valid until
+     *              the operation completes.
+     * @param[in] size
+     *              Size of the buffer. A longer value is truncated.
+     * @param[in] callback
+     *              Invoked once the value is read, or the read failed. The
+     *              read isn't reported to the onDataRead() callbacks.
+     *
+     * @return BLE_ERROR_NONE if the read was queued, BLE_ERROR_NO_MEM if the
+     *         queue is full.
+     */
+    virtual ble_error_t queueRead(Gap::Handle_t                     connHandle,
+                                  GattAttribute::Handle_t           attributeHandle,
+                                  uint8_t                          *buffer,
+                                  uint16_t                          size,
+                                  const QueuedOperationCallback_t  &callback) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)connHandle;
+        (void)attributeHandle;
+        (void)buffer;
+        (void)size;
+        (void)callback;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
+    /**
+     * Queue the write of an attribute value.
+     *
+     * Operations run in order as for queueRead(). Write commands don't wait
+     * for a response: consecutive ones are sent back to back, as fast as the
+     * stack takes them, and complete once taken, possibly before
+     * queueWrite() returns. A write request longer than
+     * a write request can carry is written as a long write, with prepare
+     * write requests executed together.
+     *
+     * @param[in] cmd
+     *              GATT_OP_WRITE_REQ or GATT_OP_WRITE_CMD.
+     * @param[in] connHandle
+     *              Handle of the connection.
+     * @param[in] attributeHandle
+     *              Handle of the attribute to write.
+     * @param[in] value
+     *              The value, which must remain valid until the operation
+     *              completes.
+     * @param[in] length
+     *              Length of the value.
+     * @param[in] callback
+     *              Invoked once the value is written, or the write failed.
+     *              The write isn't reported to the onDataWritten() callbacks.
+     *
+     * @return BLE_ERROR_NONE if the write was queued, BLE_ERROR_NO_MEM if the
+     *         queue is full, BLE_ERROR_PARAM_OUT_OF_RANGE for a write command
+     *         longer than one packet.
+     */
+    virtual ble_error_t queueWrite(GattClient::WriteOp_t             cmd,
+                                   Gap::Handle_t                     connHandle,
+                                   GattAttribute::Handle_t           attributeHandle,
+                                   const uint8_t                    *value,
+                                   uint16_t                          length,
+                                   const QueuedOperationCallback_t  &callback) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)cmd;
+        (void)connHandle;
+        (void)attributeHandle;
+        (void)value;
+        (void)length;
+        (void)callback;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
     /* Event callback handlers. */
 public:
     /**
@@ -445,6 +602,46 @@ public:
         (void) characteristic;
     }
 
+    /**
+     * Exchange ATT MTUs with the peer, so that reads, writes and
+     * notifications can carry more than the default 20 bytes. The MTU in use
+     * once the exchange completes is reported to the onAttMtuChange()
+     * callbacks.
+     *
+     * @param[in] connHandle
+     *              Handle of the connection.
+     * @param[in] attMtuSize
+     *              The ATT MTU offered to the peer, in bytes.
+     *
+     * @return BLE_ERROR_NONE if the exchange was started.
+     */
+    virtual ble_error_t negotiateAttMtu(Gap::Handle_t connHandle, uint16_t attMtuSize) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)connHandle;
+        (void)attMtuSize;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
+    /**
+     * Set up a callback for when the ATT MTU of a connection changes.
+     *
+     * @note It is possible to unregister callbacks using
+     *       onAttMtuChange().detach(callbackToRemove).
+     */
+    void onAttMtuChange(AttMtuChangeCallback_t callback) {
+        onAttMtuChangeCallbackChain.add(callback);
+    }
+
+    /**
+     * @brief Provide access to the callchain of ATT MTU change callbacks.
+     *
+     * @return A reference to the ATT MTU change callbacks chain.
+     */
+    AttMtuChangeCallbackChain_t& onAttMtuChange() {
+        return onAttMtuChangeCallbackChain;
+    }
+
     /**
      * Set up a callback for when the GATT Client receives an update event
      * corresponding to a change in the value of a characteristic on the remote
@@ -543,6 +740,7 @@ public:
         onDataReadCallbackChain.clear();
         onDataWriteCallbackChain.clear();
         onHVXCallbackChain.clear();
+        onAttMtuChangeCallbackChain.clear();
 
         return BLE_ERROR_NONE;
     }
@@ -595,6 +793,19 @@ public:
         }
     }
 
+    /**
+     * Helper function that notifies all registered handlers of a change of
+     * the ATT MTU. This function is meant to be called from the BLE stack
+     * specific implementation when an MTU exchange completes.
+     *
+     * @param[in] params
+     *              The ATT MTU change parameters passed to the registered
+     *              handlers.
+     */
+    void processAttMtuChangeEvent(const AttMtuChangeCallbackParams_t *params) {
+        onAttMtuChangeCallbackChain(params);
+    }
+
 protected:
     /**
      * Callchain containing all registered callback handlers for data read
@@ -611,6 +822,11 @@ protected:
      * events.
      */
     HVXCallbackChain_t                onHVXCallbackChain;
+    /**
+     * Callchain containing all registered callback handlers for ATT MTU
+     * change events.
+     */
+    AttMtuChangeCallbackChain_t       onAttMtuChangeCallbackChain;
     /**
      * Callchain containing all registered callback handlers for shutdown
      * events.
@@ -73,6 +73,20 @@ public:
      */
     typedef FunctionPointerWithContext<GattAttribute::Handle_t> EventCallback_t;
 
+    /**
+     * Counters of the notification queue, refer to
+     * GattServer::queueNotification(). The counters accumulate from the
+     * start of the GattServer; the throughput achieved over an interval is
+     * the growth of bytesSent over it.
+     */
+    struct NotificationQueueStats_t {
+        uint32_t notificationsSent;    /**< Notifications passed to the link. */
+        uint32_t bytesSent;            /**< Bytes of value sent in these notifications. */
+        uint32_t notificationsDropped; /**< Notifications dropped as they could not be sent to the peer, for instance once disconnected. */
+        uint16_t queued;               /**< Notifications currently waiting for a TX buffer. */
+        uint16_t capacity;             /**< Number of notifications the queue can hold. */
+    };
+
 protected:
     /**
      * Construct a GattServer instance.
@@ -228,6 +242,60 @@ public:
         return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
     }
 
+    /**
+     * Queue a notification of a new value of a characteristic.
+     *
+     * Unlike write(), which sends its notification only if the stack has a
+     * free TX buffer, the value is copied into a queue and sent as soon as
+     * one is available, so a stream of notifications keeps every TX buffer
+     * of the connection filled. The queue is shared by the connections and
+     * characteristics; values are sent in the order they were queued.
+     *
+     * The local value of the characteristic is updated as the notification
+     * is sent. onDataSent() is still called as notifications are sent out.
+     *
+     * @param[in] connectionHandle
+     *              Connection handle.
+     * @param[in] attributeHandle
+     *              Handle for the value attribute of the characteristic,
+     *              which must have the notify property.
+     * @param[in] value
+     *              A pointer to a buffer holding the new value.
+     * @param[in] size
+     *              Size of the new value (in bytes), at most the ATT payload
+     *              size of a notification.
+     *
+     * @return BLE_ERROR_NONE if the notification has been queued.
+     * @return BLE_ERROR_NO_MEM if the queue is full; one entry is freed for
+     *         every notification sent, see onDataSent().
+     * @return BLE_ERROR_INVALID_PARAM if the characteristic does not have
+     *         the notify property, or the value is too long.
+     */
+    virtual ble_error_t queueNotification(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle, const uint8_t *value, uint16_t size) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)connectionHandle;
+        (void)attributeHandle;
+        (void)value;
+        (void)size;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
+    /**
+     * Read the counters of the notification queue.
+     *
+     * @param[out] statsP
+     *               Upon return, the counters of the queue.
+     *
+     * @return BLE_ERROR_NONE if the counters were read.
+     */
+    virtual ble_error_t getNotificationQueueStats(NotificationQueueStats_t *statsP) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)statsP;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if this capability is supported. */
+    }
+
     /**
      * Determine the updates-enabled status (notification or indication) for the current connection from a characteristic's CCCD.
      *
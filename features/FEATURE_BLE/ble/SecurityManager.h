@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 #include "Gap.h"
+#include "BondStore.h"
 #include "CallChainOfFunctionPointersWithContext.h"
 
 class SecurityManager {
@@ -151,9 +152,33 @@ public:
         return BLE_ERROR_NOT_IMPLEMENTED;
     }
 
+    /**
+     * Keep the bonds in a store of the application, such as a
+     * CFStoreBondStore, beyond the bond table of the stack.
+     *
+     * Once the Security Manager is initialized, the bonds of the store that
+     * the stack lacks are restored into its bond table, so peers bonded
+     * before a reset resume encryption with the stored LTKs instead of
+     * pairing again. Bonds the stack stores afterwards are added to the
+     * store. It may be called before or after init().
+     *
+     * @param[in]  store  The store, or NULL to stop using one.
+     *
+     * @return BLE_ERROR_NONE on success.
+     *
+     * @experimental
+     */
+    virtual ble_error_t setBondStore(BondStore *store) {
+        /* Avoid compiler warnings about unused variables. */
+        (void)store;
+
+        return BLE_ERROR_NOT_IMPLEMENTED; /* Requesting action from porters: override this API if security is supported. */
+    }
+
     /**
      * Delete all peer device context and all related bonding information from
-     * the database within the security manager.
+     * the database within the security manager, and from the bond store if
+     * one is set.
      *
      * @retval BLE_ERROR_NONE             On success, else an error code indicating reason for failure.
      * @retval BLE_ERROR_INVALID_STATE    If the API is called without module initialization or
@@ -0,0 +1,225 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/CFStoreBondStore.h"
+
+#if FEATURE_STORAGE
+
+#include <string.h>
+
+#define BOND_KEY_PREFIX "ble.bond."
+#define BOND_KEY_QUERY  BOND_KEY_PREFIX "*"
+
+/* prefix, address type, '.', 12 hex digits and the terminator */
+static const unsigned BOND_KEY_NAME_SIZE = sizeof(BOND_KEY_PREFIX) + 2 + 2 * BLEProtocol::ADDR_LEN;
+
+static bool readValue(ARM_CFSTORE_DRIVER *drv, ARM_CFSTORE_HANDLE hkey, BondStore::Bond_t *bond)
+{
+    ARM_CFSTORE_SIZE len = 0;
+    if (drv->GetValueLen(hkey, &len) < ARM_DRIVER_OK || len != sizeof(*bond)) {
+        return false;
+    }
+
+    return drv->Read(hkey, bond, &len) >= ARM_DRIVER_OK && len == sizeof(*bond);
+}
+
+CFStoreBondStore::CFStoreBondStore() :
+    drv(&cfstore_driver),
+    initialized(false) {
+    /* Bonds are stored and read inline, which needs synchronous mode. */
+    ARM_CFSTORE_CAPABILITIES caps = drv->GetCapabilities();
+    if (!caps.asynchronous_ops && drv->Initialize(NULL, NULL) >= ARM_DRIVER_OK) {
+        initialized = true;
+    }
+}
+
+CFStoreBondStore::~CFStoreBondStore()
+{
+    if (initialized) {
+        drv->Uninitialize();
+    }
+}
+
+void CFStoreBondStore::keyName(uint8_t peerAddrType, const BLEProtocol::AddressBytes_t peerAddr, char *name)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    size_t len = strlen(BOND_KEY_PREFIX);
+    memcpy(name, BOND_KEY_PREFIX, len);
+    name[len++] = hex[peerAddrType & 0xF];
+    name[len++] = '.';
+
+    /* Addresses are LSB first, they are named the way they are written. */
+    for (unsigned i = BLEProtocol::ADDR_LEN; i > 0; i--) {
+        name[len++] = hex[peerAddr[i - 1] >> 4];
+        name[len++] = hex[peerAddr[i - 1] & 0xF];
+    }
+    name[len] = '\0';
+}
+
+bool CFStoreBondStore::read(const char *name, Bond_t *bond)
+{
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ARM_CFSTORE_FMODE flags;
+    memset(&flags, 0, sizeof(flags));
+    flags.read = 1;
+
+    if (drv->Open(name, flags, hkey) < ARM_DRIVER_OK) {
+        return false;
+    }
+
+    bool found = readValue(drv, hkey, bond);
+    drv->Close(hkey);
+    return found;
+}
+
+bool CFStoreBondStore::erase(const char *name)
+{
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ARM_CFSTORE_FMODE flags;
+    memset(&flags, 0, sizeof(flags));
+    flags.write = 1;
+
+    if (drv->Open(name, flags, hkey) < ARM_DRIVER_OK) {
+        return false;
+    }
+
+    bool erased = drv->Delete(hkey) >= ARM_DRIVER_OK;
+    drv->Close(hkey);
+    return erased;
+}
+
+ble_error_t CFStoreBondStore::store(const Bond_t &bond)
+{
+    if (!initialized) {
+        return BLE_ERROR_INVALID_STATE;
+    }
+
+    char name[BOND_KEY_NAME_SIZE];
+    keyName(bond.peerAddrType, bond.peerAddr, name);
+
+    /* The stack stores the bond again on each reconnection. */
+    Bond_t stored;
+    if (read(name, &stored)) {
+        if (memcmp(&stored, &bond, sizeof(bond)) == 0) {
+            return BLE_ERROR_NONE;
+        }
+
+        erase(name);
+    }
+
+    ARM_CFSTORE_KEYDESC kdesc;
+    memset(&kdesc, 0, sizeof(kdesc));
+    kdesc.acl.perm_owner_read  = 1;
+    kdesc.acl.perm_owner_write = 1;
+    kdesc.drl                  = ARM_RETENTION_NVM;
+    kdesc.flags.read           = 1;
+    kdesc.flags.write          = 1;
+
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ble_error_t error = BLE_ERROR_UNSPECIFIED;
+    if (drv->Create(name, sizeof(bond), &kdesc, hkey) >= ARM_DRIVER_OK) {
+        ARM_CFSTORE_SIZE len = sizeof(bond);
+        if (drv->Write(hkey, (const char *)&bond, &len) >= ARM_DRIVER_OK && len == sizeof(bond)) {
+            error = BLE_ERROR_NONE;
+        }
+        drv->Close(hkey);
+
+        if (error != BLE_ERROR_NONE) {
+            erase(name);
+        }
+    } else {
+        error = BLE_ERROR_NO_MEM;
+    }
+
+    if (drv->Flush() < ARM_DRIVER_OK) {
+        error = BLE_ERROR_UNSPECIFIED;
+    }
+
+    return error;
+}
+
+ble_error_t CFStoreBondStore::remove(BLEProtocol::AddressType_t peerAddrType, const BLEProtocol::AddressBytes_t peerAddr)
+{
+    if (!initialized) {
+        return BLE_ERROR_INVALID_STATE;
+    }
+
+    char name[BOND_KEY_NAME_SIZE];
+    keyName(peerAddrType, peerAddr, name);
+
+    if (!erase(name)) {
+        return BLE_ERROR_INVALID_PARAM;
+    }
+
+    return (drv->Flush() < ARM_DRIVER_OK) ? BLE_ERROR_UNSPECIFIED : BLE_ERROR_NONE;
+}
+
+ble_error_t CFStoreBondStore::clear(void)
+{
+    if (!initialized) {
+        return BLE_ERROR_INVALID_STATE;
+    }
+
+    /* Find handles are read-only: each search finds the first bond left,
+     * which is then deleted through a handle opened for writing. */
+    bool erased = false;
+    char name[CFSTORE_KEY_NAME_MAX_LENGTH + 1];
+    for (;;) {
+        ARM_CFSTORE_HANDLE_INIT(prev);
+        ARM_CFSTORE_HANDLE_INIT(next);
+        if (drv->Find(BOND_KEY_QUERY, prev, next) != ARM_DRIVER_OK) {
+            break;
+        }
+
+        uint8_t len = sizeof(name);
+        int32_t ret = drv->GetKeyName(next, name, &len);
+        drv->Close(next);
+        if (ret < ARM_DRIVER_OK || !erase(name)) {
+            return BLE_ERROR_UNSPECIFIED;
+        }
+        erased = true;
+    }
+
+    if (erased && drv->Flush() < ARM_DRIVER_OK) {
+        return BLE_ERROR_UNSPECIFIED;
+    }
+
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t CFStoreBondStore::forEach(const BondCallback_t &callback)
+{
+    if (!initialized) {
+        return BLE_ERROR_INVALID_STATE;
+    }
+
+    ARM_CFSTORE_FIND_ITER_INIT(iter);
+    ARM_CFSTORE_HANDLE_INIT(prev);
+    ARM_CFSTORE_HANDLE_INIT(next);
+    while (drv->FindIter(iter, BOND_KEY_QUERY, prev, next) == ARM_DRIVER_OK) {
+        /* Values of another size were written by another version of Bond_t. */
+        Bond_t bond;
+        if (readValue(drv, next, &bond)) {
+            callback.call(&bond);
+        }
+        CFSTORE_HANDLE_SWAP(prev, next);
+    }
+
+    return BLE_ERROR_NONE;
+}
+
+#endif
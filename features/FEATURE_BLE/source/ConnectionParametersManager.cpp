@@ -0,0 +1,226 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ble/ConnectionParametersManager.h"
+#include <string.h>
+
+static uint32_t saturatingAdd(uint32_t a, uint32_t b)
+{
+    return (a > 0xFFFFFFFFUL - b) ? 0xFFFFFFFFUL : a + b;
+}
+
+ConnectionParametersManager::ConnectionParametersManager(BLE                           &bleIn,
+                                                         const Gap::ConnectionParams_t &fast,
+                                                         const Gap::ConnectionParams_t &slow,
+                                                         uint32_t                       idleTimeoutMs,
+                                                         uint32_t                       minProfileTimeMs) :
+    ble(bleIn),
+    idleTimeoutUs(idleTimeoutMs * 1000),
+    minProfileTimeUs(minProfileTimeMs * 1000),
+    connected(false),
+    connectionHandle(0),
+    profile(PROFILE_NONE),
+    wantedProfile(PROFILE_NONE),
+    timer(),
+    idleUs(0),
+    profileUs(0),
+    remainderUs(0),
+    stats(),
+    onConnectionHandler(this, &ConnectionParametersManager::onConnection),
+    onDisconnectionHandler(this, &ConnectionParametersManager::onDisconnection),
+    onDataSentHandler(this, &ConnectionParametersManager::onDataSent),
+    onServerDataWrittenHandler(this, &ConnectionParametersManager::onServerDataWritten),
+    onServerDataReadHandler(this, &ConnectionParametersManager::onServerDataRead),
+    onClientDataReadHandler(this, &ConnectionParametersManager::onClientDataRead),
+    onClientDataWrittenHandler(this, &ConnectionParametersManager::onClientDataWritten),
+    onHVXHandler(this, &ConnectionParametersManager::onHVX) {
+    profiles[PROFILE_FAST] = fast;
+    profiles[PROFILE_SLOW] = slow;
+
+    ble.gap().onConnection().addStatic(onConnectionHandler);
+    ble.gap().onDisconnection().addStatic(onDisconnectionHandler);
+    ble.gattServer().onDataSent().addStatic(onDataSentHandler);
+    ble.gattServer().onDataWritten().addStatic(onServerDataWrittenHandler);
+    ble.gattServer().onDataRead().addStatic(onServerDataReadHandler);
+    ble.gattClient().onDataRead().addStatic(onClientDataReadHandler);
+    ble.gattClient().onDataWritten().addStatic(onClientDataWrittenHandler);
+    ble.gattClient().onHVX().addStatic(onHVXHandler);
+
+    timer.start();
+}
+
+ConnectionParametersManager::~ConnectionParametersManager()
+{
+    ble.gap().onConnection().detach(onConnectionHandler);
+    ble.gap().onDisconnection().detach(onDisconnectionHandler);
+    ble.gattServer().onDataSent().detach(onDataSentHandler);
+    ble.gattServer().onDataWritten().detach(onServerDataWrittenHandler);
+    ble.gattServer().onDataRead().detach(onServerDataReadHandler);
+    ble.gattClient().onDataRead().detach(onClientDataReadHandler);
+    ble.gattClient().onDataWritten().detach(onClientDataWrittenHandler);
+    ble.gattClient().onHVX().detach(onHVXHandler);
+}
+
+void ConnectionParametersManager::activity(void)
+{
+    traffic(connectionHandle);
+}
+
+void ConnectionParametersManager::process(void)
+{
+    if (!connected) {
+        return;
+    }
+    elapse();
+
+    /* Notifications waiting for buffers are traffic to come. */
+    GattServer::NotificationQueueStats_t queueStats;
+    if ((ble.gattServer().getNotificationQueueStats(&queueStats) == BLE_ERROR_NONE) && (queueStats.queued > 0)) {
+        idleUs = 0;
+        wantedProfile = PROFILE_FAST;
+    }
+
+    if (idleUs >= idleTimeoutUs) {
+        wantedProfile = PROFILE_SLOW;
+    }
+    apply();
+}
+
+void ConnectionParametersManager::getStatistics(Statistics_t *statsP)
+{
+    elapse();
+    *statsP = stats;
+}
+
+void ConnectionParametersManager::resetStatistics(void)
+{
+    elapse();
+    memset(&stats, 0, sizeof(stats));
+    remainderUs = 0;
+}
+
+void ConnectionParametersManager::onConnection(const Gap::ConnectionCallbackParams_t *params)
+{
+    if (connected) {
+        return;
+    }
+
+    elapse();
+    connected        = true;
+    connectionHandle = params->handle;
+    idleUs           = 0;
+    profileUs        = 0;
+    wantedProfile    = PROFILE_FAST; /* discovery, security and the application's setup follow */
+    apply();
+}
+
+void ConnectionParametersManager::onDisconnection(const Gap::DisconnectionCallbackParams_t *params)
+{
+    if (!connected || (params->handle != connectionHandle)) {
+        return;
+    }
+
+    elapse();
+    connected     = false;
+    profile       = PROFILE_NONE;
+    wantedProfile = PROFILE_NONE;
+}
+
+void ConnectionParametersManager::onDataSent(unsigned count)
+{
+    /* Notifications aren't reported per connection: the one followed has them. */
+    (void)count;
+    traffic(connectionHandle);
+}
+
+void ConnectionParametersManager::onServerDataWritten(const GattWriteCallbackParams *params)
+{
+    traffic(params->connHandle);
+}
+
+void ConnectionParametersManager::onServerDataRead(const GattReadCallbackParams *params)
+{
+    traffic(params->connHandle);
+}
+
+void ConnectionParametersManager::onClientDataRead(const GattReadCallbackParams *params)
+{
+    traffic(params->connHandle);
+}
+
+void ConnectionParametersManager::onClientDataWritten(const GattWriteCallbackParams *params)
+{
+    traffic(params->connHandle);
+}
+
+void ConnectionParametersManager::onHVX(const GattHVXCallbackParams *params)
+{
+    traffic(params->connHandle);
+}
+
+void ConnectionParametersManager::traffic(Gap::Handle_t handle)
+{
+    if (!connected || (handle != connectionHandle)) {
+        return;
+    }
+
+    elapse();
+    idleUs        = 0;
+    wantedProfile = PROFILE_FAST;
+    apply();
+}
+
+void ConnectionParametersManager::elapse(void)
+{
+    uint32_t elapsedUs = timer.read_us();
+    timer.reset();
+
+    idleUs    = saturatingAdd(idleUs, elapsedUs);
+    profileUs = saturatingAdd(profileUs, elapsedUs);
+
+    if (profile != PROFILE_NONE) {
+        remainderUs += elapsedUs;
+        uint32_t elapsedMs = remainderUs / 1000;
+        remainderUs %= 1000;
+
+        if (profile == PROFILE_FAST) {
+            stats.fastTimeMs += elapsedMs;
+        } else {
+            stats.slowTimeMs += elapsedMs;
+        }
+    }
+}
+
+void ConnectionParametersManager::apply(void)
+{
+    if ((wantedProfile == profile) || (wantedProfile == PROFILE_NONE)) {
+        return;
+    }
+
+    /* Hysteresis: keep a profile for a while once requested. */
+    if ((profile != PROFILE_NONE) && (profileUs < minProfileTimeUs)) {
+        return;
+    }
+
+    if (ble.gap().updateConnectionParams(connectionHandle, &profiles[wantedProfile]) != BLE_ERROR_NONE) {
+        stats.failedRequests++;
+        return;
+    }
+
+    profile   = wantedProfile;
+    profileUs = 0;
+    stats.switches++;
+}
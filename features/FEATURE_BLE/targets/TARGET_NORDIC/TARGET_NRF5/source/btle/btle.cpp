@@ -218,6 +218,9 @@ static void btle_handler(ble_evt_t *p_ble_evt)
                                                            static_cast<BLEProtocol::AddressType_t>(peer->addr_type), peer->addr,
                                                            static_cast<BLEProtocol::AddressType_t>(own->addr_type),  own->addr,
                                                            params);
+#if !defined(TARGET_MCU_NRF51_16K_S110) && !defined(TARGET_MCU_NRF51_32K_S110)
+            ble.getGattClient().discovery().processConnection(handle, peer);
+#endif
             break;
         }
 
@@ -250,6 +253,8 @@ static void btle_handler(ble_evt_t *p_ble_evt)
             nRF5xGattClient& gattClient = ble.getGattClient();
             gattClient.characteristicDescriptorDiscoverer().terminate(handle, BLE_ERROR_INVALID_STATE);
             gattClient.discovery().terminate(handle);
+            gattClient.discovery().processDisconnection(handle);
+            gattClient.queue().terminate(handle, BLE_ERROR_INVALID_STATE);
 #endif
 
             gap.processDisconnectionEvent(handle, reason);
@@ -36,6 +36,10 @@ void bleGattcEventHandler(const ble_evt_t *p_ble_evt)
                     break;
 
                 case BLE_GATT_STATUS_ATTERR_ATTRIBUTE_NOT_FOUND:
+                    /* No service past the ones already discovered. */
+                    sdSingleton.completeServiceDiscovery();
+                    break;
+
                 default:
                     sdSingleton.terminate();
                     break;
@@ -62,6 +66,12 @@ void bleGattcEventHandler(const ble_evt_t *p_ble_evt)
             break;
 
         case BLE_GATTC_EVT_READ_RSP: {
+                if (gattClient.queue().processReadResponse(p_ble_evt->evt.gattc_evt.conn_handle,
+                                                           p_ble_evt->evt.gattc_evt.gatt_status,
+                                                           p_ble_evt->evt.gattc_evt.params.read_rsp)) {
+                    break;
+                }
+
                 GattReadCallbackParams response = {
                     .connHandle = p_ble_evt->evt.gattc_evt.conn_handle,
                     .handle     = p_ble_evt->evt.gattc_evt.params.read_rsp.handle,
@@ -74,6 +84,12 @@ void bleGattcEventHandler(const ble_evt_t *p_ble_evt)
             break;
 
         case BLE_GATTC_EVT_WRITE_RSP: {
+                if (gattClient.queue().processWriteResponse(p_ble_evt->evt.gattc_evt.conn_handle,
+                                                            p_ble_evt->evt.gattc_evt.gatt_status,
+                                                            p_ble_evt->evt.gattc_evt.params.write_rsp)) {
+                    break;
+                }
+
                 GattWriteCallbackParams response = {
                     .connHandle = p_ble_evt->evt.gattc_evt.conn_handle,
                     .handle     = p_ble_evt->evt.gattc_evt.params.write_rsp.handle,
@@ -142,5 +158,8 @@ void bleGattcEventHandler(const ble_evt_t *p_ble_evt)
 
     sdSingleton.progressCharacteristicDiscovery();
     sdSingleton.progressServiceDiscovery();
+
+    /* A procedure or buffers may have been freed for queued operations. */
+    gattClient.queue().process();
 }
 #endif
@@ -145,6 +145,15 @@ btle_purgeAllBondingState(void)
     }
 }
 
+ble_error_t
+btle_setBondStore(BondStore *store)
+{
+    /* The Device Manager keeps its bonds in pstorage only. */
+    (void)store;
+
+    return BLE_ERROR_NOT_IMPLEMENTED;
+}
+
 ble_error_t
 btle_getLinkSecurity(Gap::Handle_t connectionHandle, SecurityManager::LinkSecurityStatus_t *securityStatusP)
 {
@@ -74,6 +74,16 @@ ble_error_t btle_getLinkSecurity(Gap::Handle_t connectionHandle, SecurityManager
  */
 ble_error_t btle_setLinkSecurity(Gap::Handle_t connectionHandle, SecurityManager::SecurityMode_t securityMode);
 
+/**
+ * Keep the bonds in a store of the application in addition to the flash of
+ * the Peer Manager. See SecurityManager::setBondStore().
+ *
+ * @param[in]  store  The store, or NULL to stop using one.
+ *
+ * @return BLE_ERROR_NONE on success.
+ */
+ble_error_t btle_setBondStore(BondStore *store);
+
 /**
  * Function for deleting all peer device context and all related bonding
  * information from the database.
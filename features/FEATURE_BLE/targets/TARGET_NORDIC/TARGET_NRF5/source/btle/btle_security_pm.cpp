@@ -15,6 +15,8 @@
  */
 
 #if defined(S130) || defined(S132)
+#include <string.h>
+
 #include "btle.h"
 
 #include "nRF5xn.h"
@@ -33,6 +35,12 @@ static void pm_handler(pm_evt_t const *p_event);
 static bool _enc_in_progress = false; // helper flag for distinguish between state of link connected and link connected in progres of encryption establishing.
 volatile static uint32_t async_ret_code; // busy loop support variable for asyncronous API.
 
+static BondStore        *bondStore     = NULL;
+static bool              restorePending = false; // bonds of the store may be missing from the Peer Manager.
+static bool              restoreBusy    = false; // the Peer Manager couldn't take a bond during the current pass.
+static bool              restoringBond  = false; // a bond of the store is being written to flash.
+static pm_store_token_t  restoreToken;
+
 // default security parameters. Avoid "holes" between member assigments in order to compile by gcc++11.
 static ble_gap_sec_params_t securityParameters = {
     .bond          = true,         /**< Perform bonding. */
@@ -63,6 +71,135 @@ btle_hasInitializedSecurity(void)
     return initialized;
 }
 
+static void
+ltkFromEncKey(const ble_gap_enc_key_t &key, BondStore::LongTermKey_t &ltk)
+{
+    memcpy(ltk.ltk, key.enc_info.ltk, BLE_GAP_SEC_KEY_LEN);
+    memcpy(ltk.rand, key.master_id.rand, BLE_GAP_SEC_RAND_LEN);
+    ltk.ediv              = key.master_id.ediv;
+    ltk.size              = key.enc_info.ltk_len;
+    ltk.authenticated     = key.enc_info.auth;
+    ltk.secureConnections = key.enc_info.lesc;
+}
+
+static void
+encKeyFromLtk(const BondStore::LongTermKey_t &ltk, ble_gap_enc_key_t &key)
+{
+    memcpy(key.enc_info.ltk, ltk.ltk, BLE_GAP_SEC_KEY_LEN);
+    memcpy(key.master_id.rand, ltk.rand, BLE_GAP_SEC_RAND_LEN);
+    key.master_id.ediv    = ltk.ediv;
+    key.enc_info.ltk_len  = ltk.size;
+    key.enc_info.auth     = ltk.authenticated ? 1 : 0;
+    key.enc_info.lesc     = ltk.secureConnections ? 1 : 0;
+}
+
+static void
+bondFromPeerData(const pm_peer_data_bonding_t &data, BondStore::Bond_t &bond)
+{
+    memset(&bond, 0, sizeof(bond));
+    bond.peerAddrType = data.peer_id.id_addr_info.addr_type;
+    memcpy(bond.peerAddr, data.peer_id.id_addr_info.addr, BLE_GAP_ADDR_LEN);
+    bond.ownRole      = data.own_role; /* BLE_GAP_ROLE_ values are those of Gap::Role_t. */
+    memcpy(bond.irk, data.peer_id.id_info.irk, BLE_GAP_SEC_KEY_LEN);
+    ltkFromEncKey(data.peer_ltk, bond.peerLtk);
+    ltkFromEncKey(data.own_ltk, bond.ownLtk);
+}
+
+static void
+peerDataFromBond(const BondStore::Bond_t &bond, pm_peer_data_bonding_t &data)
+{
+    memset(&data, 0, sizeof(data));
+    data.peer_id.id_addr_info.addr_type = bond.peerAddrType;
+    memcpy(data.peer_id.id_addr_info.addr, bond.peerAddr, BLE_GAP_ADDR_LEN);
+    data.own_role = bond.ownRole;
+    memcpy(data.peer_id.id_info.irk, bond.irk, BLE_GAP_SEC_KEY_LEN);
+    encKeyFromLtk(bond.peerLtk, data.peer_ltk);
+    encKeyFromLtk(bond.ownLtk, data.own_ltk);
+}
+
+/*
+ * The Peer Manager doesn't check that a peer added with pm_peer_new() is
+ * new; peers are the same if they have the same identity address or IRK,
+ * as for the Peer Manager's own duplicate detection.
+ */
+static bool
+isKnownPeer(const pm_peer_data_bonding_t &data)
+{
+    static const uint8_t noIrk[BLE_GAP_SEC_KEY_LEN] = { 0 };
+    bool hasIrk = memcmp(data.peer_id.id_info.irk, noIrk, BLE_GAP_SEC_KEY_LEN) != 0;
+
+    pm_peer_id_t peer = pm_next_peer_id_get(PM_PEER_ID_INVALID);
+    while (peer != PM_PEER_ID_INVALID) {
+        pm_peer_data_bonding_t known;
+        if (pm_peer_data_bonding_load(peer, &known) == NRF_SUCCESS) {
+            if ((known.peer_id.id_addr_info.addr_type == data.peer_id.id_addr_info.addr_type) &&
+                (memcmp(known.peer_id.id_addr_info.addr, data.peer_id.id_addr_info.addr, BLE_GAP_ADDR_LEN) == 0)) {
+                return true;
+            }
+            if (hasIrk && (memcmp(known.peer_id.id_info.irk, data.peer_id.id_info.irk, BLE_GAP_SEC_KEY_LEN) == 0)) {
+                return true;
+            }
+        }
+        peer = pm_next_peer_id_get(peer);
+    }
+
+    return false;
+}
+
+static void
+restoreBond(const BondStore::Bond_t *bond)
+{
+    /* Bonds are added one at a time: the next pass starts once the bond
+     * being written is in flash, and can be told apart from the others. */
+    if (restoringBond || restoreBusy) {
+        return;
+    }
+
+    pm_peer_data_bonding_t data;
+    peerDataFromBond(*bond, data);
+    if (isKnownPeer(data)) {
+        return;
+    }
+
+    pm_peer_id_t peer;
+    ret_code_t   rc = pm_peer_new(&peer, &data, &restoreToken);
+    if (rc == NRF_SUCCESS) {
+        restoringBond = true;
+    } else if (rc == NRF_ERROR_BUSY) {
+        restoreBusy = true;
+    }
+    /* Other bonds, e.g. once the flash is full, are left in the store. */
+}
+
+/*
+ * Add the bonds of the store missing from the Peer Manager. Called after
+ * initialization and after each Peer Manager write, until a pass finds
+ * none left to add.
+ */
+static void
+restoreBonds(void)
+{
+    if (!initialized || !bondStore || !restorePending || restoringBond) {
+        return;
+    }
+
+    restoreBusy = false;
+    bondStore->forEach(restoreBond);
+    if (!restoringBond && !restoreBusy) {
+        restorePending = false;
+    }
+}
+
+ble_error_t
+btle_setBondStore(BondStore *store)
+{
+    bondStore      = store;
+    restorePending = (store != NULL);
+    restoreBonds();
+
+    return BLE_ERROR_NONE;
+}
+
 
 ble_error_t
 btle_initializeSecurity(bool                                      enableBonding,
@@ -119,6 +256,7 @@ btle_initializeSecurity(bool                                      enableBonding,
     switch (rc) {
         case NRF_SUCCESS:
             initialized = true;
+            restoreBonds();
             return BLE_ERROR_NONE;
 
         case NRF_ERROR_INVALID_STATE:
@@ -141,6 +279,7 @@ btle_purgeAllBondingState(void)
 {
     ret_code_t rc;
     
+    restorePending = false;
     async_ret_code = NRF_ERROR_BUSY;
     
     rc = pm_peers_delete(); // it is asynhronous API
@@ -157,6 +296,10 @@ btle_purgeAllBondingState(void)
 
     switch (rc) {
         case NRF_SUCCESS:
+            /* The bonds of the store go with those of the Peer Manager. */
+            if (bondStore && bondStore->clear() != BLE_ERROR_NONE) {
+                return BLE_ERROR_UNSPECIFIED;
+            }
             return BLE_ERROR_NONE;
             
         case NRF_ERROR_INVALID_STATE:
@@ -348,13 +491,32 @@ void pm_handler(pm_evt_t const *p_event)
             break;
         
         case PM_EVT_PEER_DATA_UPDATE_SUCCEEDED:
-            if (p_event->params.peer_data_update_succeeded.action == PM_PEER_DATA_OP_UPDATE)
+            if (restoringBond && p_event->params.peer_data_update_succeeded.token == restoreToken) {
+                // a bond of the store is back in the Peer Manager, restore the next one
+                restoringBond = false;
+            } else if (p_event->params.peer_data_update_succeeded.action == PM_PEER_DATA_OP_UPDATE)
             {
+                if (bondStore && p_event->params.peer_data_update_succeeded.data_id == PM_PEER_DATA_ID_BONDING) {
+                    pm_peer_data_bonding_t data;
+                    if (pm_peer_data_bonding_load(p_event->peer_id, &data) == NRF_SUCCESS) {
+                        BondStore::Bond_t bond;
+                        bondFromPeerData(data, bond);
+                        bondStore->store(bond);
+                    }
+                }
+
                 securityManager.processSecurityContextStoredEvent(p_event->conn_handle);
             }
+            restoreBonds();
             break;
             
         case PM_EVT_PEER_DATA_UPDATE_FAILED:
+            if (restoringBond && p_event->params.peer_data_update_failed.token == restoreToken) {
+                // retrying would fail again, the bonds left stay in the store
+                restoringBond  = false;
+                restorePending = false;
+            }
+            restoreBonds();
             break;
             
         case PM_EVT_PEERS_DELETE_SUCCEEDED:
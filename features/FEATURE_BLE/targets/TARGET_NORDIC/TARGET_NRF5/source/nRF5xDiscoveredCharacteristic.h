@@ -40,6 +40,10 @@ public:
     void setLastHandle(GattAttribute::Handle_t last) {
       lastHandle = last;
     }
+
+    void setConnectionHandle(Gap::Handle_t connectionHandleIn) {
+      connHandle = connectionHandleIn;
+    }
 };
 
 #endif /* __NRF_DISCOVERED_CHARACTERISTIC_H__ */
@@ -20,6 +20,7 @@
 #include "ble/GattClient.h"
 #include "nRF5xServiceDiscovery.h"
 #include "nRF5xCharacteristicDescriptorDiscoverer.h"
+#include "nRF5xGattClientQueue.h"
 
 class nRF5xGattClient : public GattClient
 {
@@ -89,6 +90,23 @@ public:
         _discovery.onTermination(callback);
     }
 
+    /**
+     * @brief Implementation of GattClient::enableServiceDiscoveryCache
+     * @see GattClient::enableServiceDiscoveryCache
+     */
+    virtual ble_error_t enableServiceDiscoveryCache(bool enable) {
+        return _discovery.enableCache(enable);
+    }
+
+    /**
+     * @brief Implementation of GattClient::clearServiceDiscoveryCache
+     * @see GattClient::clearServiceDiscoveryCache
+     */
+    virtual ble_error_t clearServiceDiscoveryCache(void) {
+        _discovery.clearCache();
+        return BLE_ERROR_NONE;
+    }
+
     /**
      * Is service-discovery currently active?
      */
@@ -168,6 +186,22 @@ public:
         }
     }
 
+    /**
+     * @brief Implementation of GattClient::queueRead
+     * @see GattClient::queueRead
+     */
+    virtual ble_error_t queueRead(Gap::Handle_t connHandle, GattAttribute::Handle_t attributeHandle, uint8_t *buffer, uint16_t size, const QueuedOperationCallback_t &callback) {
+        return _queue.queueRead(connHandle, attributeHandle, buffer, size, callback);
+    }
+
+    /**
+     * @brief Implementation of GattClient::queueWrite
+     * @see GattClient::queueWrite
+     */
+    virtual ble_error_t queueWrite(GattClient::WriteOp_t cmd, Gap::Handle_t connHandle, GattAttribute::Handle_t attributeHandle, const uint8_t *value, uint16_t length, const QueuedOperationCallback_t &callback) {
+        return _queue.queueWrite(cmd, connHandle, attributeHandle, value, length, callback);
+    }
+
     /**
      * @brief  Clear nRF5xGattClient's state.
      *
@@ -182,6 +216,7 @@ public:
 
         /* Clear derived class members */
         _discovery.reset();
+        _queue.reset();
 
         return BLE_ERROR_NONE;
     }
@@ -204,6 +239,10 @@ public:
         return _characteristicDescriptorDiscoverer;
     }
 
+    nRF5xGattClientQueue& queue() {
+        return _queue;
+    }
+
 private:
     nRF5xGattClient(const nRF5xGattClient &);
     const nRF5xGattClient& operator=(const nRF5xGattClient &);
@@ -211,6 +250,7 @@ private:
 private:
     nRF5xServiceDiscovery _discovery;
     nRF5xCharacteristicDescriptorDiscoverer _characteristicDescriptorDiscoverer;
+    nRF5xGattClientQueue _queue;
 
 #endif // if !S110
 };
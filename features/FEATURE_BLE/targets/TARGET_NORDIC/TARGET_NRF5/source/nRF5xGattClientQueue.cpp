@@ -0,0 +1,325 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "nRF5xGattClientQueue.h"
+#include "nrf_ble_err.h"
+#include <string.h>
+
+/* Payload of the PDUs, with the default ATT MTU the SoftDevice uses */
+static const uint16_t MAX_READ_LENGTH     = GATT_MTU_SIZE_DEFAULT - 1; /* opcode */
+static const uint16_t MAX_WRITE_LENGTH    = GATT_MTU_SIZE_DEFAULT - 3; /* opcode, handle */
+static const uint16_t MAX_PREPARE_LENGTH  = GATT_MTU_SIZE_DEFAULT - 5; /* opcode, handle, offset */
+
+static ble_error_t gattStatusToError(uint16_t status)
+{
+    switch (status) {
+        case BLE_GATT_STATUS_SUCCESS:
+            return BLE_ERROR_NONE;
+        case BLE_GATT_STATUS_ATTERR_READ_NOT_PERMITTED:
+        case BLE_GATT_STATUS_ATTERR_WRITE_NOT_PERMITTED:
+        case BLE_GATT_STATUS_ATTERR_INSUF_AUTHENTICATION:
+        case BLE_GATT_STATUS_ATTERR_INSUF_AUTHORIZATION:
+        case BLE_GATT_STATUS_ATTERR_INSUF_ENC_KEY_SIZE:
+        case BLE_GATT_STATUS_ATTERR_INSUF_ENCRYPTION:
+            return BLE_ERROR_OPERATION_NOT_PERMITTED;
+        case BLE_GATT_STATUS_ATTERR_INVALID_HANDLE:
+        case BLE_GATT_STATUS_ATTERR_INVALID_ATT_VAL_LENGTH:
+            return BLE_ERROR_INVALID_PARAM;
+        case BLE_GATT_STATUS_ATTERR_PREPARE_QUEUE_FULL:
+        case BLE_GATT_STATUS_ATTERR_INSUF_RESOURCES:
+            return BLE_ERROR_NO_MEM;
+        default:
+            return BLE_ERROR_UNSPECIFIED;
+    }
+}
+
+nRF5xGattClientQueue::nRF5xGattClientQueue() :
+    operations(),
+    count(0),
+    processing(false),
+    processAgain(false) {
+    // nothing to do
+}
+
+ble_error_t nRF5xGattClientQueue::queueRead(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle,
+                                            uint8_t *buffer, uint16_t size, const Callback_t &callback)
+{
+    if ((buffer == NULL) || (size == 0)) {
+        return BLE_ERROR_INVALID_PARAM;
+    }
+
+    Operation operation = { };
+    operation.type       = READ;
+    operation.connHandle = connectionHandle;
+    operation.handle     = attributeHandle;
+    operation.data       = buffer;
+    operation.size       = size;
+    operation.callback   = callback;
+    return enqueue(operation);
+}
+
+ble_error_t nRF5xGattClientQueue::queueWrite(GattClient::WriteOp_t cmd, Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle,
+                                             const uint8_t *value, uint16_t length, const Callback_t &callback)
+{
+    if ((cmd != GattClient::GATT_OP_WRITE_REQ) && (cmd != GattClient::GATT_OP_WRITE_CMD)) {
+        return BLE_ERROR_INVALID_PARAM;
+    }
+    if ((cmd == GattClient::GATT_OP_WRITE_CMD) && (length > MAX_WRITE_LENGTH)) {
+        return BLE_ERROR_PARAM_OUT_OF_RANGE;
+    }
+
+    Operation operation = { };
+    operation.type       = (cmd == GattClient::GATT_OP_WRITE_CMD) ? WRITE_CMD : WRITE_REQ;
+    operation.connHandle = connectionHandle;
+    operation.handle     = attributeHandle;
+    operation.data       = const_cast<uint8_t *>(value); /* only read from, for writes */
+    operation.size       = length;
+    operation.callback   = callback;
+    return enqueue(operation);
+}
+
+bool nRF5xGattClientQueue::processReadResponse(uint16_t connectionHandle, uint16_t status, const ble_gattc_evt_read_rsp_t &response)
+{
+    Operation *operation = outstanding(connectionHandle);
+    if ((operation == NULL) || (operation->type != READ)) {
+        return false;
+    }
+    operation->requested = false;
+
+    if (status != BLE_GATT_STATUS_SUCCESS) {
+        /* A value filling the last response exactly ends with an error on
+         * the next offset, or for a short attribute, on any offset. */
+        if ((operation->offset > 0) &&
+            ((status == BLE_GATT_STATUS_ATTERR_INVALID_OFFSET) || (status == BLE_GATT_STATUS_ATTERR_ATTRIBUTE_NOT_LONG))) {
+            complete(operation, BLE_ERROR_NONE, operation->offset);
+        } else {
+            complete(operation, gattStatusToError(status), 0);
+        }
+        return true;
+    }
+
+    uint16_t length = response.len;
+    if (length > operation->size - operation->offset) {
+        length = operation->size - operation->offset;
+    }
+    memcpy(operation->data + operation->offset, response.data, length);
+    operation->offset += length;
+
+    /* A full response may be followed by more of the value, read by process() */
+    if ((response.len < MAX_READ_LENGTH) || (operation->offset == operation->size)) {
+        complete(operation, BLE_ERROR_NONE, operation->offset);
+    }
+    return true;
+}
+
+bool nRF5xGattClientQueue::processWriteResponse(uint16_t connectionHandle, uint16_t status, const ble_gattc_evt_write_rsp_t &response)
+{
+    Operation *operation = outstanding(connectionHandle);
+    if ((operation == NULL) || (operation->type != WRITE_REQ)) {
+        return false;
+    }
+    operation->requested = false;
+
+    if (operation->size <= MAX_WRITE_LENGTH) {
+        ble_error_t err = gattStatusToError(status);
+        complete(operation, err, (err == BLE_ERROR_NONE) ? operation->size : 0);
+        return true;
+    }
+
+    if (!operation->executing) {
+        uint16_t length = operation->size - operation->offset;
+        if (length > MAX_PREPARE_LENGTH) {
+            length = MAX_PREPARE_LENGTH;
+        }
+
+        /* The server echoes what it prepared, which is checked before execution. */
+        if (status != BLE_GATT_STATUS_SUCCESS) {
+            operation->status = gattStatusToError(status);
+        } else if ((response.offset != operation->offset) || (response.len != length) ||
+                   (memcmp(response.data, operation->data + operation->offset, length) != 0)) {
+            operation->status = BLE_ERROR_UNSPECIFIED;
+        }
+
+        operation->offset += length;
+        if ((operation->status != BLE_ERROR_NONE) || (operation->offset == operation->size)) {
+            operation->executing = true;
+        }
+    } else {
+        ble_error_t err = operation->status;
+        if (err == BLE_ERROR_NONE) {
+            err = gattStatusToError(status);
+        }
+        complete(operation, err, (err == BLE_ERROR_NONE) ? operation->size : 0);
+    }
+    return true;
+}
+
+void nRF5xGattClientQueue::process(void)
+{
+    /* Completions run application callbacks, which may queue operations. */
+    if (processing) {
+        processAgain = true;
+        return;
+    }
+    processing = true;
+
+    do {
+        processAgain = false;
+        for (unsigned i = 0; (i < count) && !processAgain; ++i) {
+            Operation &operation = operations[i];
+            if (operation.requested || !first(i)) {
+                continue;
+            }
+
+            switch (send(operation)) {
+                case NRF_SUCCESS:
+                    if (operation.type == WRITE_CMD) {
+                        /* No response: the next operation of the connection goes right away. */
+                        complete(&operation, BLE_ERROR_NONE, operation.size);
+                    } else {
+                        operation.requested = true;
+                    }
+                    break;
+
+                case NRF_ERROR_BUSY:
+                case BLE_ERROR_NO_TX_PACKETS:
+                    /* Retried on the next event. */
+                    break;
+
+                case NRF_ERROR_INVALID_ADDR:
+                case NRF_ERROR_INVALID_PARAM:
+                    complete(&operation, BLE_ERROR_INVALID_PARAM, 0);
+                    break;
+
+                case BLE_ERROR_INVALID_CONN_HANDLE:
+                case NRF_ERROR_INVALID_STATE:
+                default:
+                    complete(&operation, BLE_ERROR_INVALID_STATE, 0);
+                    break;
+            }
+        }
+    } while (processAgain);
+
+    processing = false;
+}
+
+void nRF5xGattClientQueue::terminate(Gap::Handle_t connectionHandle, ble_error_t err)
+{
+    unsigned i = 0;
+    while (i < count) {
+        if (operations[i].connHandle == connectionHandle) {
+            complete(&operations[i], err, 0);
+            i = 0; /* the callback may have changed the queue */
+        } else {
+            ++i;
+        }
+    }
+}
+
+void nRF5xGattClientQueue::reset(void)
+{
+    count = 0;
+    processAgain = false;
+}
+
+ble_error_t nRF5xGattClientQueue::enqueue(const Operation &operation)
+{
+    if (count == QUEUE_SIZE) {
+        return BLE_ERROR_NO_MEM;
+    }
+    operations[count++] = operation;
+
+    process();
+    return BLE_ERROR_NONE;
+}
+
+nRF5xGattClientQueue::Operation *nRF5xGattClientQueue::outstanding(Gap::Handle_t connectionHandle)
+{
+    for (unsigned i = 0; i < count; ++i) {
+        if (operations[i].connHandle == connectionHandle) {
+            return operations[i].requested ? &operations[i] : NULL;
+        }
+    }
+    return NULL;
+}
+
+bool nRF5xGattClientQueue::first(unsigned index) const
+{
+    for (unsigned i = 0; i < index; ++i) {
+        if (operations[i].connHandle == operations[index].connHandle) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t nRF5xGattClientQueue::send(Operation &operation)
+{
+    if (operation.type == READ) {
+        return sd_ble_gattc_read(operation.connHandle, operation.handle, operation.offset);
+    }
+
+    ble_gattc_write_params_t writeParams;
+    writeParams.write_op = BLE_GATT_OP_WRITE_REQ;
+    writeParams.flags    = 0;
+    writeParams.handle   = operation.handle;
+    writeParams.offset   = 0;
+    writeParams.len      = operation.size;
+    writeParams.p_value  = operation.data;
+
+    if (operation.type == WRITE_CMD) {
+        writeParams.write_op = BLE_GATT_OP_WRITE_CMD;
+    } else if (operation.size > MAX_WRITE_LENGTH) {
+        if (!operation.executing) {
+            uint16_t length = operation.size - operation.offset;
+            writeParams.write_op = BLE_GATT_OP_PREP_WRITE_REQ;
+            writeParams.offset   = operation.offset;
+            writeParams.len      = (length > MAX_PREPARE_LENGTH) ? MAX_PREPARE_LENGTH : length;
+            writeParams.p_value  = operation.data + operation.offset;
+        } else {
+            writeParams.write_op = BLE_GATT_OP_EXEC_WRITE_REQ;
+            writeParams.flags    = (operation.status == BLE_ERROR_NONE) ? BLE_GATT_EXEC_WRITE_FLAG_PREPARED_WRITE
+                                                                        : BLE_GATT_EXEC_WRITE_FLAG_PREPARED_CANCEL;
+            writeParams.len      = 0;
+            writeParams.p_value  = NULL;
+        }
+    }
+
+    return sd_ble_gattc_write(operation.connHandle, &writeParams);
+}
+
+void nRF5xGattClientQueue::complete(Operation *operation, ble_error_t status, uint16_t len)
+{
+    CallbackParams_t params = {
+        operation->connHandle,
+        operation->handle,
+        status,
+        len,
+        operation->data
+    };
+    Callback_t callback = operation->callback;
+
+    /* Dequeue before the callback, which may queue again */
+    unsigned index = operation - operations;
+    for (unsigned i = index + 1; i < count; ++i) {
+        operations[i - 1] = operations[i];
+    }
+    --count;
+    processAgain = true;
+
+    if (callback) {
+        callback.call(&params);
+    }
+}
@@ -0,0 +1,124 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __NRF_GATT_CLIENT_QUEUE_H__
+#define __NRF_GATT_CLIENT_QUEUE_H__
+
+#include "ble/Gap.h"
+#include "ble/GattClient.h"
+#include "nrf_ble_gattc.h"
+
+/**
+ * @brief Run the operations queued with GattClient::queueRead() and
+ * GattClient::queueWrite().
+ * @details The operations run in the order they were queued, each connection
+ * with one request outstanding at a time, the SoftDevice taking a single
+ * GATT client procedure per connection. A request the SoftDevice refuses for
+ * being busy with another procedure, or out of buffers, is retried on its
+ * next event.
+ */
+class nRF5xGattClientQueue
+{
+    typedef GattClient::QueuedOperationCallback_t Callback_t;
+    typedef GattClient::QueuedOperationCallbackParams_t CallbackParams_t;
+
+public:
+    static const unsigned QUEUE_SIZE = 8; /**< Number of operations which can be queued, all connections together. */
+
+    nRF5xGattClientQueue();
+
+    /**
+     * @brief Queue the read of a whole attribute value.
+     * @note: this will be called by BLE API side.
+     */
+    ble_error_t queueRead(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle,
+                          uint8_t *buffer, uint16_t size, const Callback_t &callback);
+
+    /**
+     * @brief Queue the write of an attribute value.
+     * @note: this will be called by BLE API side.
+     */
+    ble_error_t queueWrite(GattClient::WriteOp_t cmd, Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle,
+                           const uint8_t *value, uint16_t length, const Callback_t &callback);
+
+    /**
+     * @brief Process a read response from the Nordic stack.
+     * @return true if the response is for a queued read, which isn't reported
+     * to the application otherwise.
+     */
+    bool processReadResponse(uint16_t connectionHandle, uint16_t status, const ble_gattc_evt_read_rsp_t &response);
+
+    /**
+     * @brief Process a write response from the Nordic stack.
+     * @return true if the response is for a queued write.
+     */
+    bool processWriteResponse(uint16_t connectionHandle, uint16_t status, const ble_gattc_evt_write_rsp_t &response);
+
+    /**
+     * @brief Send the requests which can be sent. Called after each event of
+     * the Nordic stack, as it may have freed a procedure or buffers.
+     */
+    void process(void);
+
+    /**
+     * @brief Fail the operations queued for a connection.
+     * @param connectionHandle The connection, closed.
+     * @param err The error the operations complete with.
+     */
+    void terminate(Gap::Handle_t connectionHandle, ble_error_t err);
+
+    /**
+     * @brief Drop all operations, without completing them.
+     */
+    void reset(void);
+
+private:
+    // protection against copy construction and assignment
+    nRF5xGattClientQueue(const nRF5xGattClientQueue&);
+    nRF5xGattClientQueue& operator=(const nRF5xGattClientQueue&);
+
+    enum Type_t {
+        READ,
+        WRITE_REQ,
+        WRITE_CMD
+    };
+
+    struct Operation {
+        Type_t                  type;
+        bool                    requested;  /**< A request of the operation is outstanding. */
+        bool                    executing;  /**< The prepared writes are sent, executed or cancelled. */
+        ble_error_t             status;     /**< The error cancelling the prepared writes. */
+        Gap::Handle_t           connHandle;
+        GattAttribute::Handle_t handle;
+        uint8_t                *data;       /**< The read buffer, or the written value. */
+        uint16_t                size;
+        uint16_t                offset;     /**< Bytes read or prepared so far. */
+        Callback_t              callback;
+    };
+
+    ble_error_t enqueue(const Operation &operation);
+    Operation *outstanding(Gap::Handle_t connectionHandle);
+    bool first(unsigned index) const;
+    uint32_t send(Operation &operation);
+    void complete(Operation *operation, ble_error_t status, uint16_t len);
+
+    Operation operations[QUEUE_SIZE];
+    unsigned  count;
+    bool      processing;
+    bool      processAgain;
+};
+
+#endif /* __NRF_GATT_CLIENT_QUEUE_H__ */
@@ -296,6 +296,84 @@ ble_error_t nRF5xGattServer::write(Gap::Handle_t connectionHandle, GattAttribute
     return returnValue;
 }
 
+ble_error_t nRF5xGattServer::queueNotification(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle, const uint8_t *value, uint16_t size)
+{
+    int characteristicIndex = resolveValueHandleToCharIndex(attributeHandle);
+    if ((characteristicIndex == -1) ||
+        !(p_characteristics[characteristicIndex]->getProperties() & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY) ||
+        (size > NOTIFICATION_MAX_SIZE)) {
+        return BLE_ERROR_INVALID_PARAM;
+    }
+
+    if (notificationCount == NOTIFICATION_QUEUE_SIZE) {
+        return BLE_ERROR_NO_MEM;
+    }
+
+    if (connectionHandle == BLE_CONN_HANDLE_INVALID) { /* use the default connection handle if the caller hasn't specified a valid connectionHandle. */
+        nRF5xGap &gap = (nRF5xGap &) nRF5xn::Instance(BLE::DEFAULT_INSTANCE).getGap();
+        connectionHandle = gap.getConnectionHandle();
+    }
+
+    QueuedNotification &entry = notificationQueue[(notificationHead + notificationCount) % NOTIFICATION_QUEUE_SIZE];
+    entry.connHandle      = connectionHandle;
+    entry.attributeHandle = attributeHandle;
+    entry.len             = size;
+    memcpy(entry.data, value, size);
+    notificationCount++;
+
+    sendQueuedNotifications();
+
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t nRF5xGattServer::getNotificationQueueStats(NotificationQueueStats_t *statsP)
+{
+    *statsP          = notificationStats;
+    statsP->queued   = notificationCount;
+    statsP->capacity = NOTIFICATION_QUEUE_SIZE;
+
+    return BLE_ERROR_NONE;
+}
+
+/**************************************************************************/
+/*!
+    @brief  Hand queued notifications to the SoftDevice while it has TX
+            buffers; called on queueing and on every TX complete event
+*/
+/**************************************************************************/
+void nRF5xGattServer::sendQueuedNotifications(void)
+{
+    while (notificationCount) {
+        QueuedNotification &entry = notificationQueue[notificationHead];
+        uint16_t len = entry.len;
+
+        ble_gatts_hvx_params_t hvx_params;
+        hvx_params.handle = entry.attributeHandle;
+        hvx_params.type   = BLE_GATT_HVX_NOTIFICATION;
+        hvx_params.offset = 0;
+        hvx_params.p_data = entry.data;
+        hvx_params.p_len  = &len;
+
+        error_t error = (error_t) sd_ble_gatts_hvx(entry.connHandle, &hvx_params);
+        if ((error == ERROR_BLE_NO_TX_BUFFERS) || (error == ERROR_BUSY)) {
+            /* Resumed by the next TX complete event */
+            return;
+        }
+
+        if (error == ERROR_NONE) {
+            notificationStats.notificationsSent++;
+            notificationStats.bytesSent += len;
+        } else {
+            /* Disconnected, or notifications not enabled by the peer: sending
+             * it again won't succeed */
+            notificationStats.notificationsDropped++;
+        }
+
+        notificationHead = (notificationHead + 1) % NOTIFICATION_QUEUE_SIZE;
+        notificationCount--;
+    }
+}
+
 ble_error_t nRF5xGattServer::areUpdatesEnabled(const GattCharacteristic &characteristic, bool *enabledP)
 {
     /* Forward the call with the default connection handle. */
@@ -353,6 +431,9 @@ ble_error_t nRF5xGattServer::reset(void)
     memset(nrfCharacteristicHandles, 0, sizeof(ble_gatts_char_handles_t));
     memset(nrfDescriptorHandles,     0, sizeof(nrfDescriptorHandles));
     descriptorCount = 0;
+    notificationHead = 0;
+    notificationCount = 0;
+    memset(&notificationStats, 0, sizeof(notificationStats));
 
     return BLE_ERROR_NONE;
 }
@@ -404,6 +485,8 @@ void nRF5xGattServer::hwCallback(ble_evt_t *p_ble_evt)
             break;
 
         case BLE_EVT_TX_COMPLETE: {
+            /* Refill the buffers just freed before the next connection event */
+            sendQueuedNotifications();
             handleDataSentEvent(p_ble_evt->evt.common_evt.params.tx_complete.count);
             return;
         }
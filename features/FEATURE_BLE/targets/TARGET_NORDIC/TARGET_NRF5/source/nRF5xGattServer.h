@@ -35,6 +35,8 @@ public:
     virtual ble_error_t write(Gap::Handle_t connectionHandle, GattAttribute::Handle_t, const uint8_t[], uint16_t, bool localOnly = false);
     virtual ble_error_t areUpdatesEnabled(const GattCharacteristic &characteristic, bool *enabledP);
     virtual ble_error_t areUpdatesEnabled(Gap::Handle_t connectionHandle, const GattCharacteristic &characteristic, bool *enabledP);
+    virtual ble_error_t queueNotification(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle, const uint8_t *value, uint16_t size);
+    virtual ble_error_t getNotificationQueueStats(NotificationQueueStats_t *statsP);
     virtual ble_error_t reset(void);
 
     /* nRF51 Functions */
@@ -45,6 +47,16 @@ public:
 private:
     const static unsigned BLE_TOTAL_CHARACTERISTICS = 20;
     const static unsigned BLE_TOTAL_DESCRIPTORS     = 8;
+    const static unsigned NOTIFICATION_QUEUE_SIZE   = 16;
+    const static unsigned NOTIFICATION_MAX_SIZE     = GATT_MTU_SIZE_DEFAULT - 3; /* ATT opcode and handle */
+
+    /* A notification waiting for a TX buffer */
+    struct QueuedNotification {
+        uint16_t connHandle;
+        uint16_t attributeHandle;
+        uint16_t len;
+        uint8_t  data[NOTIFICATION_MAX_SIZE];
+    };
 
 private:
     /**
@@ -79,19 +91,30 @@ private:
         return -1;
     }
 
+    /**
+     * Send queued notifications until the stack runs out of TX buffers or
+     * the queue is empty.
+     */
+    void sendQueuedNotifications(void);
+
 private:
     GattCharacteristic       *p_characteristics[BLE_TOTAL_CHARACTERISTICS];
     ble_gatts_char_handles_t  nrfCharacteristicHandles[BLE_TOTAL_CHARACTERISTICS];
     GattAttribute            *p_descriptors[BLE_TOTAL_DESCRIPTORS];
     uint8_t                   descriptorCount;
     uint16_t                  nrfDescriptorHandles[BLE_TOTAL_DESCRIPTORS];
+    QueuedNotification        notificationQueue[NOTIFICATION_QUEUE_SIZE];
+    uint8_t                   notificationHead;
+    uint8_t                   notificationCount;
+    NotificationQueueStats_t  notificationStats;
 
     /*
      * Allow instantiation from nRF5xn when required.
      */
     friend class nRF5xn;
 
-    nRF5xGattServer() : GattServer(), p_characteristics(), nrfCharacteristicHandles(), p_descriptors(), descriptorCount(0), nrfDescriptorHandles() {
+    nRF5xGattServer() : GattServer(), p_characteristics(), nrfCharacteristicHandles(), p_descriptors(), descriptorCount(0), nrfDescriptorHandles(),
+        notificationQueue(), notificationHead(0), notificationCount(0), notificationStats() {
         /* empty */
     }
 
@@ -42,6 +42,10 @@ public:
         return btle_setLinkSecurity(connectionHandle, securityMode);
     }
 
+    virtual ble_error_t setBondStore(BondStore *store) {
+        return btle_setBondStore(store);
+    }
+
     virtual ble_error_t purgeAllBondingState(void) {
         return btle_purgeAllBondingState();
     }
@@ -129,14 +129,7 @@ nRF5xServiceDiscovery::progressCharacteristicDiscovery(void)
 
     if ((discoveredCharacteristic != nRF5xDiscoveredCharacteristic()) && (numCharacteristics > 0)) {
         discoveredCharacteristic.setLastHandle(characteristics[0].getDeclHandle() - 1);
-
-        if ((matchingCharacteristicUUID == UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)) ||
-            ((matchingCharacteristicUUID == discoveredCharacteristic.getUUID()) &&
-             (matchingServiceUUID != UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)))) {
-            if (characteristicCallback) {
-                characteristicCallback(&discoveredCharacteristic);
-            }
-        }
+        characteristicDiscovered(discoveredCharacteristic);
     }
 
     for (uint8_t i = 0; i < numCharacteristics; ++i) {
@@ -151,13 +144,7 @@ nRF5xServiceDiscovery::progressCharacteristicDiscovery(void)
             characteristics[i].setLastHandle(characteristics[i + 1].getDeclHandle() - 1);
         }
 
-        if ((matchingCharacteristicUUID == UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)) ||
-            ((matchingCharacteristicUUID == characteristics[i].getUUID()) &&
-             (matchingServiceUUID != UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)))) {
-            if (characteristicCallback) {
-                characteristicCallback(&characteristics[i]);
-            }
-        }
+        characteristicDiscovered(characteristics[i]);
     }
 
     if (state != CHARACTERISTIC_DISCOVERY_ACTIVE) {
@@ -189,6 +176,7 @@ nRF5xServiceDiscovery::progressServiceDiscovery(void)
         if ((matchingServiceUUID == UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)) ||
             (matchingServiceUUID == services[serviceIndex].getUUID())) {
 
+            recordService(services[serviceIndex]);
             if (serviceCallback && (matchingCharacteristicUUID == UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN))) {
                 serviceCallback(&services[serviceIndex]);
             }
@@ -210,7 +198,7 @@ nRF5xServiceDiscovery::progressServiceDiscovery(void)
         resetDiscoveredServices(); /* Note: resetDiscoveredServices() must come after fetching endHandle. */
 
         if (endHandle == SRV_DISC_END_HANDLE) {
-            terminateServiceDiscovery();
+            completeServiceDiscovery();
         } else {
             // the next service is located after the last handle discovered
             // Launch a new discovery from [endHandle + 1 : 0xFFFF]
@@ -310,3 +298,205 @@ nRF5xServiceDiscovery::processDiscoverUUIDResponse(const ble_gattc_evt_char_val_
         }
     }
 }
+
+void
+nRF5xServiceDiscovery::characteristicDiscovered(nRF5xDiscoveredCharacteristic &characteristic)
+{
+    recordCharacteristic(characteristic);
+
+    if ((matchingCharacteristicUUID == UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)) ||
+        ((matchingCharacteristicUUID == characteristic.getUUID()) &&
+         (matchingServiceUUID != UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)))) {
+        if (characteristicCallback) {
+            characteristicCallback(&characteristic);
+        }
+    }
+}
+
+ble_error_t
+nRF5xServiceDiscovery::enableCache(bool enable)
+{
+    if (!enable) {
+        cacheRecord = NULL;
+        delete[] cache;
+        cache = NULL;
+        return BLE_ERROR_NONE;
+    }
+
+    if (cache == NULL) {
+        cache = new CachedPeer[CACHE_MAX_PEERS];
+        if (cache == NULL) {
+            return BLE_ERROR_NO_MEM;
+        }
+        clearCache();
+    }
+    return BLE_ERROR_NONE;
+}
+
+void
+nRF5xServiceDiscovery::clearCache(void)
+{
+    cacheRecord = NULL;
+    if (cache == NULL) {
+        return;
+    }
+    for (unsigned i = 0; i < CACHE_MAX_PEERS; i++) {
+        cache[i].valid = false;
+    }
+    cacheNextVictim = 0;
+}
+
+void
+nRF5xServiceDiscovery::processConnection(Gap::Handle_t connectionHandle, const ble_gap_addr_t *peer)
+{
+    for (unsigned i = 0; i < CACHE_MAX_CONNECTIONS; i++) {
+        if (connections[i].handle == BLE_CONN_HANDLE_INVALID) {
+            connections[i].handle = connectionHandle;
+            connections[i].peer   = *peer;
+            return;
+        }
+    }
+}
+
+void
+nRF5xServiceDiscovery::processDisconnection(Gap::Handle_t connectionHandle)
+{
+    for (unsigned i = 0; i < CACHE_MAX_CONNECTIONS; i++) {
+        if (connections[i].handle == connectionHandle) {
+            connections[i].handle = BLE_CONN_HANDLE_INVALID;
+        }
+    }
+}
+
+const ble_gap_addr_t *
+nRF5xServiceDiscovery::peerAddress(Gap::Handle_t connectionHandle) const
+{
+    for (unsigned i = 0; i < CACHE_MAX_CONNECTIONS; i++) {
+        if (connections[i].handle == connectionHandle) {
+            return &connections[i].peer;
+        }
+    }
+    return NULL;
+}
+
+static bool
+sameAddress(const ble_gap_addr_t &a, const ble_gap_addr_t &b)
+{
+    return (a.addr_type == b.addr_type) && (memcmp(a.addr, b.addr, BLE_GAP_ADDR_LEN) == 0);
+}
+
+bool
+nRF5xServiceDiscovery::replayCache(Gap::Handle_t connectionHandle)
+{
+    const ble_gap_addr_t *peer = peerAddress(connectionHandle);
+    if ((cache == NULL) || (peer == NULL)) {
+        return false;
+    }
+
+    const CachedPeer *entry = NULL;
+    for (unsigned i = 0; i < CACHE_MAX_PEERS; i++) {
+        if (cache[i].valid && sameAddress(cache[i].address, *peer)) {
+            entry = &cache[i];
+            break;
+        }
+    }
+    if (entry == NULL) {
+        return false;
+    }
+
+    /* Apply the filters of a discovery from the peer, stopping if a callback
+     * terminates the discovery. */
+    unsigned charIndex = 0;
+    for (unsigned srvIndex = 0; (srvIndex < entry->numServices) && (state == SERVICE_DISCOVERY_ACTIVE); srvIndex++) {
+        const DiscoveredService &service = entry->services[srvIndex];
+        bool matched = (matchingServiceUUID == UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)) ||
+                       (matchingServiceUUID == service.getUUID());
+
+        if (matched && serviceCallback && (matchingCharacteristicUUID == UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN))) {
+            serviceCallback(&service);
+        }
+
+        for (; (charIndex < entry->numCharacteristics) && (entry->characteristicServices[charIndex] == srvIndex); charIndex++) {
+            if (!matched || !characteristicCallback || (state != SERVICE_DISCOVERY_ACTIVE)) {
+                continue;
+            }
+
+            nRF5xDiscoveredCharacteristic characteristic = entry->characteristics[charIndex];
+            characteristic.setConnectionHandle(connectionHandle);
+            if ((matchingCharacteristicUUID == UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)) ||
+                ((matchingCharacteristicUUID == characteristic.getUUID()) &&
+                 (matchingServiceUUID != UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)))) {
+                characteristicCallback(&characteristic);
+            }
+        }
+    }
+
+    terminateServiceDiscovery();
+    return true;
+}
+
+void
+nRF5xServiceDiscovery::startCacheRecord(Gap::Handle_t connectionHandle)
+{
+    cacheRecord = NULL;
+
+    /* Only a discovery of every service and characteristic describes the peer. */
+    const ble_gap_addr_t *peer = peerAddress(connectionHandle);
+    if ((cache == NULL) || (peer == NULL) || !characteristicCallback ||
+        (matchingServiceUUID != UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)) ||
+        (matchingCharacteristicUUID != UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN))) {
+        return;
+    }
+
+    /* Record in the entry of the peer if it has one, else in a free one, else
+     * in the entries in turn. */
+    CachedPeer *entry = NULL;
+    for (unsigned i = 0; (i < CACHE_MAX_PEERS) && (entry == NULL); i++) {
+        if (sameAddress(cache[i].address, *peer)) {
+            entry = &cache[i];
+        }
+    }
+    for (unsigned i = 0; (i < CACHE_MAX_PEERS) && (entry == NULL); i++) {
+        if (!cache[i].valid) {
+            entry = &cache[i];
+        }
+    }
+    if (entry == NULL) {
+        entry = &cache[cacheNextVictim];
+        cacheNextVictim = (cacheNextVictim + 1) % CACHE_MAX_PEERS;
+    }
+
+    entry->valid              = false;
+    entry->address            = *peer;
+    entry->numServices        = 0;
+    entry->numCharacteristics = 0;
+    cacheRecord = entry;
+}
+
+void
+nRF5xServiceDiscovery::recordService(const DiscoveredService &service)
+{
+    if (cacheRecord == NULL) {
+        return;
+    }
+    if (cacheRecord->numServices == CACHE_MAX_SRV) {
+        /* The peer doesn't fit in the cache. */
+        cacheRecord = NULL;
+        return;
+    }
+    cacheRecord->services[cacheRecord->numServices++] = service;
+}
+
+void
+nRF5xServiceDiscovery::recordCharacteristic(const nRF5xDiscoveredCharacteristic &characteristic)
+{
+    if ((cacheRecord == NULL) || (cacheRecord->numServices == 0)) {
+        return;
+    }
+    if (cacheRecord->numCharacteristics == CACHE_MAX_CHAR) {
+        cacheRecord = NULL;
+        return;
+    }
+    cacheRecord->characteristicServices[cacheRecord->numCharacteristics] = cacheRecord->numServices - 1;
+    cacheRecord->characteristics[cacheRecord->numCharacteristics++]      = characteristic;
+}
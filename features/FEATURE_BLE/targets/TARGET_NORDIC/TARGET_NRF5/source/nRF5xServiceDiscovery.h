@@ -36,6 +36,12 @@ public:
     static const unsigned BLE_DB_DISCOVERY_MAX_SRV          = 4;      /**< Maximum number of services we can retain information for after a single discovery. */
     static const unsigned BLE_DB_DISCOVERY_MAX_CHAR_PER_SRV = 4;      /**< Maximum number of characteristics per service we can retain information for. */
 
+public:
+    static const unsigned CACHE_MAX_PEERS                   = 1;      /**< Number of peers whose discovery results are cached. */
+    static const unsigned CACHE_MAX_SRV                     = 8;      /**< Maximum number of services cached for a peer. */
+    static const unsigned CACHE_MAX_CHAR                    = 24;     /**< Maximum number of characteristics cached for a peer, all services together. */
+    static const unsigned CACHE_MAX_CONNECTIONS             = 4;      /**< Number of connections whose peer address is tracked for the cache. */
+
 public:
     nRF5xServiceDiscovery(nRF5xGattClient *gattcIn) :
         gattc(gattcIn),
@@ -47,8 +53,14 @@ public:
         characteristics(),
         serviceUUIDDiscoveryQueue(this),
         charUUIDDiscoveryQueue(this),
-        onTerminationCallback(NULL) {
-        /* empty */
+        onTerminationCallback(NULL),
+        cache(NULL),
+        cacheRecord(NULL),
+        cacheNextVictim(0),
+        connections() {
+        for (unsigned i = 0; i < CACHE_MAX_CONNECTIONS; i++) {
+            connections[i].handle = BLE_CONN_HANDLE_INVALID;
+        }
     }
 
     virtual ble_error_t launch(Gap::Handle_t                               connectionHandle,
@@ -68,6 +80,11 @@ public:
 
         serviceDiscoveryStarted(connectionHandle);
 
+        if (replayCache(connectionHandle)) {
+            return BLE_ERROR_NONE;
+        }
+        startCacheRecord(connectionHandle);
+
         uint32_t rc;
         if ((rc = sd_ble_gattc_primary_services_discover(connectionHandle, SRV_DISC_START_HANDLE, NULL)) != NRF_SUCCESS) {
             terminate();
@@ -104,6 +121,26 @@ public:
         onTerminationCallback = callback;
     }
 
+    /**
+     * Enable the cache of discovery results, or disable and free it.
+     */
+    ble_error_t enableCache(bool enable);
+
+    /**
+     * Forget the discovery results cached for all peers.
+     */
+    void clearCache(void);
+
+    /**
+     * Track the peer address of a new connection, to find its cached results.
+     */
+    void processConnection(Gap::Handle_t connectionHandle, const ble_gap_addr_t *peer);
+
+    /**
+     * Forget the peer address of a closed connection.
+     */
+    void processDisconnection(Gap::Handle_t connectionHandle);
+
     /**
      * @brief  Clear nRF5xServiceDiscovery's state.
      *
@@ -128,6 +165,11 @@ public:
 
         onTerminationCallback = NULL;
 
+        enableCache(false);
+        for (unsigned i = 0; i < CACHE_MAX_CONNECTIONS; i++) {
+            connections[i].handle = BLE_CONN_HANDLE_INVALID;
+        }
+
         return BLE_ERROR_NONE;
     }
 
@@ -147,26 +189,36 @@ private:
 
         bool wasActive = isActive();
         state = INACTIVE;
+        cacheRecord = NULL;
 
         if (wasActive && onTerminationCallback) {
             onTerminationCallback(connHandle);
         }
     }
 
+    /**
+     * Complete a discovery which went through the whole database of the
+     * peer, committing its results to the cache if they were recorded.
+     */
+    void completeServiceDiscovery(void) {
+        if (cacheRecord) {
+            cacheRecord->valid = true;
+        }
+        terminateServiceDiscovery();
+    }
+
     void terminateCharacteristicDiscovery(ble_error_t err) {
+        if (err != BLE_ERROR_NONE) {
+            /* The characteristics of the service are incomplete. */
+            cacheRecord = NULL;
+        }
+
         if (state == CHARACTERISTIC_DISCOVERY_ACTIVE) {
             if(discoveredCharacteristic != nRF5xDiscoveredCharacteristic()) {
                if(err == BLE_ERROR_NONE) {
                     // fullfill the last characteristic
                     discoveredCharacteristic.setLastHandle(services[serviceIndex].getEndHandle());
-
-                    if ((matchingCharacteristicUUID == UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)) ||
-                        ((matchingCharacteristicUUID == discoveredCharacteristic.getUUID()) &&
-                         (matchingServiceUUID != UUID::ShortUUIDBytes_t(BLE_UUID_UNKNOWN)))) {
-                        if (characteristicCallback) {
-                            characteristicCallback(&discoveredCharacteristic);
-                        }
-                    }
+                    characteristicDiscovered(discoveredCharacteristic);
                }
                discoveredCharacteristic = nRF5xDiscoveredCharacteristic();
             }
@@ -324,6 +376,39 @@ private:
     void progressCharacteristicDiscovery(void);
     void progressServiceDiscovery(void);
 
+    /**
+     * Report a characteristic to the application if it passes the filters,
+     * and record it in the cache.
+     */
+    void characteristicDiscovered(nRF5xDiscoveredCharacteristic &characteristic);
+
+private:
+    /*
+     * The services and characteristics found by a complete discovery of a
+     * peer, replayed on later connections to it.
+     */
+    struct CachedPeer {
+        bool                          valid;
+        ble_gap_addr_t                address;
+        uint8_t                       numServices;
+        uint8_t                       numCharacteristics;
+        DiscoveredService             services[CACHE_MAX_SRV];
+        nRF5xDiscoveredCharacteristic characteristics[CACHE_MAX_CHAR];
+        uint8_t                       characteristicServices[CACHE_MAX_CHAR]; /**< Index in services[] of each characteristic's service. */
+    };
+
+    /* The peer of a connection */
+    struct Connection {
+        Gap::Handle_t  handle;
+        ble_gap_addr_t peer;
+    };
+
+    const ble_gap_addr_t *peerAddress(Gap::Handle_t connectionHandle) const;
+    bool replayCache(Gap::Handle_t connectionHandle);
+    void startCacheRecord(Gap::Handle_t connectionHandle);
+    void recordService(const DiscoveredService &service);
+    void recordCharacteristic(const nRF5xDiscoveredCharacteristic &characteristic);
+
 private:
     nRF5xGattClient *gattc;
 
@@ -361,6 +446,11 @@ private:
      * discovered characteristic will be set to the last handle of its enclosing service.
      */
     nRF5xDiscoveredCharacteristic discoveredCharacteristic;
+
+    CachedPeer                 *cache;           /**< CACHE_MAX_PEERS entries, allocated while the cache is enabled. */
+    CachedPeer                 *cacheRecord;     /**< The entry filled by the ongoing discovery, if it is complete. */
+    uint8_t                     cacheNextVictim;
+    Connection                  connections[CACHE_MAX_CONNECTIONS];
 };
 
 #endif /*__NRF_SERVICE_DISCOVERY_H__*/
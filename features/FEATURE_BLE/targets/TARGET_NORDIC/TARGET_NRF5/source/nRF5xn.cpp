@@ -220,5 +220,8 @@ void nRF5xn::processEvents() {
     if (isEventsSignaled) {
         isEventsSignaled = false;
         intern_softdevice_events_execute();
+
+        /* Reports of all the events just processed go in a single batch. */
+        gapInstance.flushAdvertisementReports();
     }
 }
@@ -158,8 +158,10 @@ typedef enum sn_coap_status_ {
     COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED  = 5, /**< Blockwise message received but not supported by compiling switch */
     COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVED  = 6, /**< Blockwise message fully received and returned to app.
                                                          User must take care of releasing whole payload of the blockwise messages */
-    COAP_STATUS_BUILDER_MESSAGE_SENDING_FAILED = 7  /**< When re-transmissions have been done and ACK not received, CoAP library calls
+    COAP_STATUS_BUILDER_MESSAGE_SENDING_FAILED = 7, /**< When re-transmissions have been done and ACK not received, CoAP library calls
                                                          RX callback with this status */
+    COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED  = 8  /**< Last block of a blockwise message given to the block stream callback,
+                                                         see sn_coap_protocol_set_block_stream(). Payload is the one of the block */
 } sn_coap_status_e;
 
 
@@ -227,6 +229,14 @@ typedef struct sn_coap_hdr_ {
     sn_coap_options_list_s *options_list_ptr;   /**< Must be set to NULL if not used */
 } sn_coap_hdr_s;
 
+/**
+ * \brief Storage of a CoAP message parsed in place, see sn_coap_parser_in_place()
+ */
+typedef struct sn_coap_parsed_msg_ {
+    sn_coap_hdr_s           hdr;                /**< Parsed message, first so that the block can be freed by it */
+    sn_coap_options_list_s  options;            /**< Options of the message, hdr.options_list_ptr points here if any */
+} sn_coap_parsed_msg_s;
+
 /* * * * * * * * * * * * * * * * * * * * * * */
 /* * * * EXTERNAL FUNCTION PROTOTYPES  * * * */
 /* * * * * * * * * * * * * * * * * * * * * * */
@@ -263,6 +273,48 @@ extern sn_coap_hdr_s *sn_coap_parser(struct coap_s *handle, uint16_t packet_data
  */
 extern void sn_coap_parser_release_allocated_coap_msg_mem(struct coap_s *handle, sn_coap_hdr_s *freed_coap_msg_ptr);
 
+/**
+ * \fn sn_coap_hdr_s *sn_coap_parser_in_place(struct coap_s *handle, uint16_t packet_data_len, uint8_t *packet_data_ptr, coap_version_e *coap_version_ptr, sn_coap_parsed_msg_s *msg_storage_ptr)
+ *
+ * \brief Parses CoAP message from given Packet data without copying it
+ *
+ *        The token, the options and the payload of the parsed message point into
+ *        the Packet data, which must be kept as long as the message is used.
+ *        Options of several parts, like Uri-Path, are joined with their separators
+ *        in place, which modifies the Packet data.
+ *
+ *        The message is not for sn_coap_protocol functions that take over or
+ *        replace its buffers, and it is not released with
+ *        sn_coap_parser_release_allocated_coap_msg_mem().
+ *
+ * \param *handle Pointer to CoAP library handle
+ *
+ * \param packet_data_len is length of given Packet data to be parsed to CoAP message
+ *
+ * \param *packet_data_ptr is source for Packet data to be parsed to CoAP message
+ *
+ * \param *coap_version_ptr is destination for parsed CoAP specification version
+ *
+ * \param *msg_storage_ptr is storage for the parsed message. If NULL, one block is
+ *        allocated for it, released with sn_coap_parser_release_in_place_msg()
+ *
+ * \return Return value is pointer to parsed CoAP message, with coap_status set
+ *         like sn_coap_parser() does. NULL in failure in given pointer or in
+ *         memory allocation.
+ */
+extern sn_coap_hdr_s *sn_coap_parser_in_place(struct coap_s *handle, uint16_t packet_data_len, uint8_t *packet_data_ptr, coap_version_e *coap_version_ptr, sn_coap_parsed_msg_s *msg_storage_ptr);
+
+/**
+ * \fn void sn_coap_parser_release_in_place_msg(struct coap_s *handle, sn_coap_hdr_s *freed_coap_msg_ptr)
+ *
+ * \brief Releases the block of a CoAP message parsed in place without a given storage
+ *
+ * \param *handle Pointer to CoAP library handle
+ *
+ * \param *freed_coap_msg_ptr is pointer to released CoAP message
+ */
+extern void sn_coap_parser_release_in_place_msg(struct coap_s *handle, sn_coap_hdr_s *freed_coap_msg_ptr);
+
 /**
  * \fn int16_t sn_coap_builder(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr)
  *
@@ -308,6 +360,27 @@ extern uint16_t sn_coap_builder_calc_needed_packet_data_size(sn_coap_hdr_s *src_
  */
 extern int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size);
 
+/**
+ * \fn int16_t sn_coap_builder_sized(uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_len, sn_coap_hdr_s *src_coap_msg_ptr)
+ *
+ * \brief Builds an outgoing message buffer of already calculated size from a CoAP header structure.
+ *
+ *        Unlike sn_coap_builder_2(), the size is not calculated again: the message is
+ *        written once, straight into the given buffer.
+ *
+ * \param *dst_packet_data_ptr is pointer to allocated destination to built CoAP packet
+ *
+ * \param dst_packet_data_len is the size given by sn_coap_builder_calc_needed_packet_data_size_2()
+ *        for the message, with the blockwise payload size it is sent with
+ *
+ * \param *src_coap_msg_ptr is pointer to source structure for building Packet data
+ *
+ * \return Return value is byte count of built Packet data. In failure cases:\n
+ *          -1 = Failure in given CoAP header structure or size\n
+ *          -2 = Failure in given pointer (= NULL)
+ */
+extern int16_t sn_coap_builder_sized(uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_len, sn_coap_hdr_s *src_coap_msg_ptr);
+
 /**
  * \fn uint16_t sn_coap_builder_calc_needed_packet_data_size_2(sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size)
  *
@@ -89,6 +89,23 @@ extern int8_t sn_coap_protocol_destroy(struct coap_s *handle);
  */
 extern int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param);
 
+/**
+ * \fn int16_t sn_coap_protocol_build_sized(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_len, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
+ *
+ * \brief Builds Packet data of already calculated size from given CoAP header structure to be sent
+ *
+ *        Same as sn_coap_protocol_build(), for a destination sized with
+ *        sn_coap_builder_calc_needed_packet_data_size_2() and the block size of the
+ *        handle, so that the size is not calculated again.
+ *
+ * \param *dst_packet_data_ptr is pointer to destination of built Packet data
+ *
+ * \param dst_packet_data_len is the calculated size of the destination
+ *
+ * \return As sn_coap_protocol_build()
+ */
+extern int16_t sn_coap_protocol_build_sized(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_len, sn_coap_hdr_s *src_coap_msg_ptr, void *param);
+
 /**
  * \fn sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr)
  *
@@ -143,6 +160,32 @@ extern int8_t sn_coap_protocol_exec(struct coap_s *handle, uint32_t current_time
  */
 extern int8_t sn_coap_protocol_set_block_size(struct coap_s *handle, uint16_t block_size);
 
+/**
+ * \fn int8_t sn_coap_protocol_set_block_stream(struct coap_s *handle, int8_t (*block_stream_callback)(sn_coap_hdr_s *, uint32_t, bool, sn_nsdl_addr_s *, void *), uint8_t block2_window)
+ *
+ * \brief If block transfer is enabled, this function makes received blocks streamed to a callback
+ *
+ *        The blocks of Block1 requests and Block2 responses are given to the callback as they
+ *        arrive, instead of being stored until the whole payload is gathered: the callback
+ *        gets the message of the block, the offset of its payload in the whole payload and
+ *        whether more blocks follow. It returns 0 to go on with the transfer, the message is
+ *        otherwise returned with COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED and the transfer stops.
+ *
+ *        The message of the last block is returned with COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED,
+ *        for the request to be responded or the response to be handled.
+ *
+ *        When a Block2 response tells the whole size (Size2), up to block2_window following
+ *        blocks are requested at a time. The blocks may then arrive out of order.
+ *
+ * \param *block_stream_callback is the callback, NULL to gather the payloads again
+ * \param block2_window is the number of Block2 requests to keep in flight, 0 or 1 for one at a time
+ *
+ * \return  0 = success
+ *          -1 = failure
+ */
+extern int8_t sn_coap_protocol_set_block_stream(struct coap_s *handle,
+        int8_t (*block_stream_callback)(sn_coap_hdr_s *, uint32_t, bool, sn_nsdl_addr_s *, void *), uint8_t block2_window);
+
 /**
  * \fn int8_t sn_coap_protocol_set_duplicate_buffer_size(uint8_t message_count)
  *
@@ -212,6 +255,16 @@ extern void sn_coap_protocol_block_remove(struct coap_s *handle, sn_nsdl_addr_s
  */
 extern int8_t sn_coap_protocol_delete_retransmission(struct coap_s *handle, uint16_t msg_id);
 
+/**
+ * \fn uint16_t sn_coap_protocol_allocate_message_id(struct coap_s *handle)
+ *
+ * \param *handle Pointer to CoAP library handle
+ * \return returns a new message ID, 0 for invalid parameter
+ *
+ * \brief Takes the next message ID, for a Confirmable or Non-confirmable message built later with it.
+ */
+extern uint16_t sn_coap_protocol_allocate_message_id(struct coap_s *handle);
+
 #endif /* SN_COAP_PROTOCOL_H_ */
 
 #ifdef __cplusplus
@@ -83,6 +83,32 @@
  */
 #undef SN_COAP_MAX_INCOMING_MESSAGE_SIZE    /* UINT16_MAX */
 
+/**
+ * \def SN_COAP_HASH_BUCKETS
+ *
+ * \brief Sets the number of hash buckets the
+ * re-sending messages and the duplication infos are
+ * looked up with, by address, port and message ID.
+ * Must be 2^x. Default is 8.
+ */
+#undef SN_COAP_HASH_BUCKETS                 /* 8 */
+
+/**
+ * \def SN_COAP_MAX_ALLOWED_RESENDING_BUFF_SIZE_MSGS
+ *
+ * \brief Sets the largest re-sending queue the
+ * application can set, at most 255. Default is 6.
+ */
+#undef SN_COAP_MAX_ALLOWED_RESENDING_BUFF_SIZE_MSGS  /* 6 */
+
+/**
+ * \def SN_COAP_MAX_ALLOWED_DUPLICATION_MESSAGE_COUNT
+ *
+ * \brief Sets the largest duplication detection buffer
+ * the application can set, at most 255. Default is 6.
+ */
+#undef SN_COAP_MAX_ALLOWED_DUPLICATION_MESSAGE_COUNT /* 6 */
+
 #ifdef MBED_CLIENT_USER_CONFIG_FILE
 #include MBED_CLIENT_USER_CONFIG_FILE
 #endif
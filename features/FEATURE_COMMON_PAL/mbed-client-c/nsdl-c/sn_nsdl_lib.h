@@ -201,6 +201,8 @@ typedef struct sn_nsdl_resource_info_ {
     uint8_t                         *resource;                  /**< NULL if dynamic resource */
 
     ns_list_link_t                  link;
+
+    ns_list_link_t                  hash_link;                  /**< In the hash bucket of the path */
 } sn_nsdl_resource_info_s;
 
 /**
@@ -388,6 +390,24 @@ extern uint16_t sn_nsdl_send_observation_notification_with_uri_path(struct nsdl_
         uint8_t *uri_path_ptr,
         uint16_t uri_path_len);
 
+/**
+ * \fn extern int8_t sn_nsdl_set_notification_pmin(struct nsdl_s *handle, uint32_t pmin)
+ *
+ * \brief Sets the minimum period between the notifications of an observation
+ *
+ * A notification sent less than pmin seconds after the previous one with the same token is held back,
+ * and sent from sn_nsdl_exec() once the period has passed. A newer notification replaces the one held
+ * back, so only the latest value is sent; its message ID is returned for all the notifications it replaces.
+ * The maximum period (pmax) is left to the application, which owns the values.
+ *
+ * \param   *handle     Pointer to nsdl-library handle
+ * \param   pmin        Minimum period in seconds, 0 (default) sends every notification at once
+ *
+ * \return  0   Success
+ * \return  -1  Failure
+ */
+extern int8_t sn_nsdl_set_notification_pmin(struct nsdl_s *handle, uint32_t pmin);
+
 /**
  * \fn extern uint32_t sn_nsdl_get_version(void)
  *
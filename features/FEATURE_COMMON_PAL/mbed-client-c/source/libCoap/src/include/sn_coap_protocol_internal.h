@@ -67,7 +67,9 @@ struct sn_coap_hdr_;
 
 /* These parameters sets maximum values application can set with API */
 #define SN_COAP_MAX_ALLOWED_RESENDING_COUNT             6   /**< Maximum allowed count of re-sending */
-#define SN_COAP_MAX_ALLOWED_RESENDING_BUFF_SIZE_MSGS    6   /**< Maximum allowed number of saved re-sending messages */
+#ifndef SN_COAP_MAX_ALLOWED_RESENDING_BUFF_SIZE_MSGS
+#define SN_COAP_MAX_ALLOWED_RESENDING_BUFF_SIZE_MSGS    6   /**< Maximum allowed number of saved re-sending messages, at most 255 */
+#endif
 #define SN_COAP_MAX_ALLOWED_RESENDING_BUFF_SIZE_BYTES   512 /**< Maximum allowed size of re-sending buffer */
 #define SN_COAP_MAX_ALLOWED_RESPONSE_TIMEOUT            40  /**< Maximum allowed re-sending timeout */
 
@@ -91,12 +93,29 @@ struct sn_coap_hdr_;
 
 
 
-/* Maximum allowed number of saved messages for duplicate searching */
+/* Maximum allowed number of saved messages for duplicate searching, at most 255 */
+#ifndef SN_COAP_MAX_ALLOWED_DUPLICATION_MESSAGE_COUNT
 #define SN_COAP_MAX_ALLOWED_DUPLICATION_MESSAGE_COUNT   6
+#endif
 
 /* Maximum time in seconds of messages to be stored for duplication detection */
 #define SN_COAP_DUPLICATION_MAX_TIME_MSGS_STORED    60 /* RESPONSE_TIMEOUT * RESPONSE_RANDOM_FACTOR * (2 ^ MAX_RETRANSMIT - 1) + the expected maximum round trip time */
 
+/* * For looking up stored messages * */
+
+/* Number of hash buckets the re-sending messages and the duplication infos are looked up with,  */
+/* by address, port and message ID. Must be 2^x, setting it to 1 searches the whole lists.        */
+
+#ifdef YOTTA_CFG_COAP_HASH_BUCKETS
+#define SN_COAP_HASH_BUCKETS YOTTA_CFG_COAP_HASH_BUCKETS
+#elif defined MBED_CONF_MBED_CLIENT_SN_COAP_HASH_BUCKETS
+#define SN_COAP_HASH_BUCKETS MBED_CONF_MBED_CLIENT_SN_COAP_HASH_BUCKETS
+#endif
+
+#ifndef SN_COAP_HASH_BUCKETS
+#define SN_COAP_HASH_BUCKETS                        8
+#endif
+
 /* * For Message blockwising * */
 
 /* Init value for the maximum payload size to be sent and received at one blockwise message                         */
@@ -149,9 +168,11 @@ typedef struct coap_send_msg_ {
     void                *param;             /* Extra parameter that will be passed to TX/RX callback functions */
 
     ns_list_link_t      link;
+    ns_list_link_t      hash_link;          /* In the hash bucket of the destination and message ID */
 } coap_send_msg_s;
 
 typedef NS_LIST_HEAD(coap_send_msg_s, link) coap_send_msg_list_t;
+typedef NS_LIST_HEAD(coap_send_msg_s, hash_link) coap_send_msg_bucket_t;
 
 /* Structure which is stored to Linked list for message duplication detection purposes */
 typedef struct coap_duplication_info_ {
@@ -166,9 +187,11 @@ typedef struct coap_duplication_info_ {
     struct coap_s       *coap;  /* CoAP library handle */
 
     ns_list_link_t     link;
+    ns_list_link_t     hash_link;   /* In the hash bucket of the address and message ID */
 } coap_duplication_info_s;
 
 typedef NS_LIST_HEAD(coap_duplication_info_s, link) coap_duplication_info_list_t;
+typedef NS_LIST_HEAD(coap_duplication_info_s, hash_link) coap_duplication_info_bucket_t;
 
 /* Structure which is stored to Linked list for blockwise messages sending purposes */
 typedef struct coap_blockwise_msg_ {
@@ -176,6 +199,7 @@ typedef struct coap_blockwise_msg_ {
 
     sn_coap_hdr_s       *coap_msg_ptr;
     struct coap_s       *coap;      /* CoAP library handle */
+    uint32_t            size2;      /* Whole size of a streamed Block2 response, 0 if not known */
 
     ns_list_link_t     link;
 } coap_blockwise_msg_s;
@@ -208,17 +232,22 @@ struct coap_s {
 
     #if ENABLE_RESENDINGS /* If Message resending is not used at all, this part of code will not be compiled */
         coap_send_msg_list_t linked_list_resent_msgs; /* Active resending messages are stored to this Linked list */
+        coap_send_msg_bucket_t hash_resent_msgs[SN_COAP_HASH_BUCKETS]; /* and to these hash buckets, for looking them up */
         uint16_t count_resent_msgs;
+        uint16_t size_resent_msgs;  /* Total packet size of the resending messages */
     #endif
 
     #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT /* If Message duplication detection is not used at all, this part of code will not be compiled */
         coap_duplication_info_list_t  linked_list_duplication_msgs; /* Messages for duplicated messages detection is stored to this Linked list */
+        coap_duplication_info_bucket_t hash_duplication_msgs[SN_COAP_HASH_BUCKETS]; /* and to these hash buckets, for looking them up */
         uint16_t                      count_duplication_msgs;
     #endif
 
     #if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE /* If Message blockwise is not used at all, this part of code will not be compiled */
         coap_blockwise_msg_list_t     linked_list_blockwise_sent_msgs; /* Blockwise message to to be sent is stored to this Linked list */
         coap_blockwise_payload_list_t linked_list_blockwise_received_payloads; /* Blockwise payload to to be received is stored to this Linked list */
+        int8_t (*sn_coap_block_stream_callback)(sn_coap_hdr_s *, uint32_t, bool, sn_nsdl_addr_s *, void *); /* Received blocks are given to this, if set */
+        uint8_t sn_coap_block2_window;  /* Block2 requests in flight while streaming */
     #endif
 
     uint32_t system_time;    /* System time seconds */
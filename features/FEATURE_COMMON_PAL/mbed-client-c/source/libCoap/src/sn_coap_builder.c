@@ -100,6 +100,18 @@ int16_t sn_coap_builder(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_ms
 int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, uint16_t blockwise_payload_size)
 {
     tr_debug("sn_coap_builder_2");
+
+    /* * * * Check given pointers  * * * */
+    if (dst_packet_data_ptr == NULL || src_coap_msg_ptr == NULL) {
+        return -2;
+    }
+
+    return sn_coap_builder_sized(dst_packet_data_ptr, sn_coap_builder_calc_needed_packet_data_size_2(src_coap_msg_ptr, blockwise_payload_size),
+                                 src_coap_msg_ptr);
+}
+
+int16_t sn_coap_builder_sized(uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_len, sn_coap_hdr_s *src_coap_msg_ptr)
+{
     uint8_t *base_packet_data_ptr = NULL;
 
     /* * * * Check given pointers  * * * */
@@ -108,13 +120,12 @@ int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_
     }
 
     /* Initialize given Packet data memory area with zero values */
-    uint16_t dst_byte_count_to_be_built = sn_coap_builder_calc_needed_packet_data_size_2(src_coap_msg_ptr, blockwise_payload_size);
-    tr_debug("sn_coap_builder_2 - message len: [%d]", dst_byte_count_to_be_built);
-    if (!dst_byte_count_to_be_built) {
+    tr_debug("sn_coap_builder_sized - message len: [%d]", dst_packet_data_len);
+    if (!dst_packet_data_len) {
         return -1;
     }
 
-    memset(dst_packet_data_ptr, 0, dst_byte_count_to_be_built);
+    memset(dst_packet_data_ptr, 0, dst_packet_data_len);
 
     /* * * * Store base (= original) destination Packet data pointer for later usage * * * */
     base_packet_data_ptr = dst_packet_data_ptr;
@@ -47,10 +47,13 @@
 /* * * * * * * * * * * * * * * * * * * * */
 
 static void                  sn_coap_protocol_send_rst(struct coap_s *handle, uint16_t msg_id, sn_nsdl_addr_s *addr_ptr, void *param);
+#if ENABLE_RESENDINGS || SN_COAP_DUPLICATION_MAX_MSGS_COUNT
+static uint16_t              sn_coap_protocol_hash(const uint8_t *addr_ptr, uint8_t addr_len, uint16_t port, uint16_t msg_id);
+#endif
 #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT/* If Message duplication detection is not used at all, this part of code will not be compiled */
 static void                  sn_coap_protocol_linked_list_duplication_info_store(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
 static int8_t                sn_coap_protocol_linked_list_duplication_info_search(struct coap_s *handle, sn_nsdl_addr_s *scr_addr_ptr, uint16_t msg_id);
-static void                  sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *handle, uint8_t *scr_addr_ptr, uint16_t port, uint16_t msg_id);
+static void                  sn_coap_protocol_linked_list_duplication_info_release(struct coap_s *handle, coap_duplication_info_s *removed_duplication_info_ptr);
 static void                  sn_coap_protocol_linked_list_duplication_info_remove_old_ones(struct coap_s *handle);
 #endif
 #if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE /* If Message blockwising is not used at all, this part of code will not be compiled */
@@ -62,16 +65,19 @@ static void                  sn_coap_protocol_linked_list_blockwise_payload_remo
 static uint32_t              sn_coap_protocol_linked_list_blockwise_payloads_get_len(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr);
 static void                  sn_coap_protocol_linked_list_blockwise_remove_old_data(struct coap_s *handle);
 static sn_coap_hdr_s        *sn_coap_handle_blockwise_message(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *received_coap_msg_ptr, void *param);
+static sn_coap_hdr_s        *sn_coap_handle_block2_stream(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *received_coap_msg_ptr, void *param);
+static int8_t                sn_coap_protocol_send_block2_request(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, sn_coap_hdr_s *request_ptr, uint32_t block_number, uint8_t block_size_exp, uint32_t size2, void *param);
 static int8_t                sn_coap_convert_block_size(uint16_t block_size);
 static sn_coap_hdr_s        *sn_coap_protocol_copy_header(struct coap_s *handle, sn_coap_hdr_s *source_header_ptr);
 #endif
 #if ENABLE_RESENDINGS
-static void                  sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len, uint8_t *send_packet_data_ptr, uint32_t sending_time, void *param, uint8_t *uri_path_ptr, uint8_t uri_path_len);
+static bool                  sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len, uint8_t *send_packet_data_ptr, bool adopt_packet, uint32_t sending_time, void *param, uint8_t *uri_path_ptr, uint8_t uri_path_len);
 static sn_nsdl_transmit_s   *sn_coap_protocol_linked_list_send_msg_search(struct coap_s *handle,sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
 static void                  sn_coap_protocol_linked_list_send_msg_remove(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
-static coap_send_msg_s      *sn_coap_protocol_allocate_mem_for_msg(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t packet_data_len);
+static coap_send_msg_s      *sn_coap_protocol_linked_list_send_msg_find(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id);
+static void                  sn_coap_protocol_linked_list_send_msg_unlink(struct coap_s *handle, coap_send_msg_s *removed_msg_ptr);
+static coap_send_msg_s      *sn_coap_protocol_allocate_mem_for_msg(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr);
 static void                  sn_coap_protocol_release_allocated_send_msg_mem(struct coap_s *handle, coap_send_msg_s *freed_send_msg_ptr);
-static uint16_t              sn_coap_count_linked_list_size(const coap_send_msg_list_t *linked_list_ptr);
 #endif
 
 /* * * * * * * * * * * * * * * * * */
@@ -175,6 +181,9 @@ struct coap_s *sn_coap_protocol_init(void *(*used_malloc_func_ptr)(uint16_t), vo
 
     /* * * * Create Linked list for storing active resending messages  * * * */
     ns_list_init(&handle->linked_list_resent_msgs);
+    for (uint8_t i = 0; i < SN_COAP_HASH_BUCKETS; i++) {
+        ns_list_init(&handle->hash_resent_msgs[i]);
+    }
     handle->sn_coap_resending_queue_msgs = SN_COAP_RESENDING_QUEUE_SIZE_MSGS;
     handle->sn_coap_resending_queue_bytes = SN_COAP_RESENDING_QUEUE_SIZE_BYTES;
     handle->sn_coap_resending_intervall = DEFAULT_RESPONSE_TIMEOUT;
@@ -186,6 +195,9 @@ struct coap_s *sn_coap_protocol_init(void *(*used_malloc_func_ptr)(uint16_t), vo
 #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT /* If Message duplication detection is not used at all, this part of code will not be compiled */
     /* * * * Create Linked list for storing Duplication info * * * */
     ns_list_init(&handle->linked_list_duplication_msgs);
+    for (uint8_t i = 0; i < SN_COAP_HASH_BUCKETS; i++) {
+        ns_list_init(&handle->hash_duplication_msgs[i]);
+    }
     handle->sn_coap_duplication_buffer_size = SN_COAP_DUPLICATION_MAX_MSGS_COUNT;
 #endif
 
@@ -235,6 +247,23 @@ int8_t sn_coap_protocol_set_block_size(struct coap_s *handle, uint16_t block_siz
 
 }
 
+int8_t sn_coap_protocol_set_block_stream(struct coap_s *handle,
+        int8_t (*block_stream_callback)(sn_coap_hdr_s *, uint32_t, bool, sn_nsdl_addr_s *, void *), uint8_t block2_window)
+{
+    (void) handle;
+    (void) block_stream_callback;
+    (void) block2_window;
+#if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE
+    if (handle == NULL) {
+        return -1;
+    }
+    handle->sn_coap_block_stream_callback = block_stream_callback;
+    handle->sn_coap_block2_window = block2_window ? block2_window : 1;
+    return 0;
+#endif
+    return -1;
+}
+
 int8_t sn_coap_protocol_set_duplicate_buffer_size(struct coap_s *handle, uint8_t message_count)
 {
     (void) handle;
@@ -324,9 +353,31 @@ void sn_coap_protocol_clear_retransmission_buffer(struct coap_s *handle)
         handle->sn_coap_protocol_free(tmp);
         tmp = 0;
     }
+    /* All messages are gone, empty the hash buckets at once */
+    for (uint8_t i = 0; i < SN_COAP_HASH_BUCKETS; i++) {
+        ns_list_init(&handle->hash_resent_msgs[i]);
+    }
+    handle->size_resent_msgs = 0;
 #endif
 }
 
+uint16_t sn_coap_protocol_allocate_message_id(struct coap_s *handle)
+{
+    uint16_t msg_id;
+
+    if (handle == NULL) {
+        return 0;
+    }
+
+    msg_id = message_id;
+    message_id++;
+    if (message_id == 0) {
+        message_id = 1;
+    }
+
+    return msg_id;
+}
+
 int8_t sn_coap_protocol_delete_retransmission(struct coap_s *handle, uint16_t msg_id)
 {
 #if ENABLE_RESENDINGS /* If Message resending is not used at all, this part of code will not be compiled */
@@ -338,8 +389,7 @@ int8_t sn_coap_protocol_delete_retransmission(struct coap_s *handle, uint16_t ms
             uint16_t temp_msg_id = (tmp->send_msg_ptr->packet_ptr[2] << 8);
             temp_msg_id += (uint16_t)tmp->send_msg_ptr->packet_ptr[3];
             if(temp_msg_id == msg_id){
-                ns_list_remove(&handle->linked_list_resent_msgs, tmp);
-                --handle->count_resent_msgs;
+                sn_coap_protocol_linked_list_send_msg_unlink(handle, tmp);
                 sn_coap_protocol_release_allocated_send_msg_mem(handle, tmp);
                 return 0;
             }
@@ -391,7 +441,19 @@ int8_t prepare_blockwise_message(struct coap_s *handle, sn_coap_hdr_s *src_coap_
 int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr,
                                uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
 {
-    tr_debug("sn_coap_protocol_build - payload len %d", src_coap_msg_ptr->payload_len);
+    /* * * * Check given pointers  * * * */
+    if (src_coap_msg_ptr == NULL || handle == NULL) {
+        return -2;
+    }
+
+    return sn_coap_protocol_build_sized(handle, dst_addr_ptr, dst_packet_data_ptr,
+                                        sn_coap_builder_calc_needed_packet_data_size_2(src_coap_msg_ptr, handle->sn_coap_block_data_size),
+                                        src_coap_msg_ptr, param);
+}
+
+int16_t sn_coap_protocol_build_sized(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr,
+                                     uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_len, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
+{
     int16_t  byte_count_built     = 0;
 #if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE /* If Message blockwising is not used at all, this part of code will not be compiled */
     uint16_t original_payload_len = 0;
@@ -400,6 +462,7 @@ int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_p
     if ((dst_addr_ptr == NULL) || (dst_packet_data_ptr == NULL) || (src_coap_msg_ptr == NULL) || handle == NULL) {
         return -2;
     }
+    tr_debug("sn_coap_protocol_build - payload len %d", src_coap_msg_ptr->payload_len);
 
     if (dst_addr_ptr->addr_ptr == NULL) {
         return -2;
@@ -433,7 +496,7 @@ int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_p
     /* * * * Build Packet data from CoAP message by using CoAP Header builder  * * * */
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
-    byte_count_built = sn_coap_builder_2(dst_packet_data_ptr, src_coap_msg_ptr, handle->sn_coap_block_data_size);
+    byte_count_built = sn_coap_builder_sized(dst_packet_data_ptr, dst_packet_data_len, src_coap_msg_ptr);
 
     if (byte_count_built < 0) {
         return byte_count_built;
@@ -444,7 +507,7 @@ int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_p
     /* Check if built Message type was confirmable, only these messages are resent */
     if (src_coap_msg_ptr->msg_type == COAP_MSG_TYPE_CONFIRMABLE) {
         /* Store message to Linked list for resending purposes */
-        sn_coap_protocol_linked_list_send_msg_store(handle, dst_addr_ptr, byte_count_built, dst_packet_data_ptr,
+        sn_coap_protocol_linked_list_send_msg_store(handle, dst_addr_ptr, byte_count_built, dst_packet_data_ptr, false,
                 handle->system_time + (uint32_t)(handle->sn_coap_resending_intervall * RESPONSE_RANDOM_FACTOR),
                 param, src_coap_msg_ptr->uri_path_ptr, src_coap_msg_ptr->uri_path_len);
     }
@@ -622,7 +685,9 @@ sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src
             coap_duplication_info_s *stored_duplication_info_ptr = ns_list_get_first(&handle->linked_list_duplication_msgs);
 
             /* Remove oldest stored duplication message for getting room for new duplication message */
-            sn_coap_protocol_linked_list_duplication_info_remove(handle, stored_duplication_info_ptr->addr_ptr, stored_duplication_info_ptr->port, stored_duplication_info_ptr->msg_id);
+            if (stored_duplication_info_ptr) {
+                sn_coap_protocol_linked_list_duplication_info_release(handle, stored_duplication_info_ptr);
+            }
         }
 
         /* Store Duplication info to Linked list */
@@ -794,7 +859,7 @@ int8_t sn_coap_protocol_exec(struct coap_s *handle, uint32_t current_time)
 #if ENABLE_RESENDINGS  /* If Message resending is not used at all, this part of code will not be compiled */
 
 /**************************************************************************//**
- * \fn static void sn_coap_protocol_linked_list_send_msg_store(sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len, uint8_t *send_packet_data_ptr, uint32_t sending_time)
+ * \fn static bool sn_coap_protocol_linked_list_send_msg_store(sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len, uint8_t *send_packet_data_ptr, bool adopt_packet, uint32_t sending_time)
  *
  * \brief Stores message to Linked list for sending purposes.
 
@@ -804,38 +869,45 @@ int8_t sn_coap_protocol_exec(struct coap_s *handle, uint32_t current_time)
  *
  * \param *send_packet_data_ptr is Packet data to be stored
  *
+ * \param adopt_packet tells that the Packet data, allocated with the handle, is
+ *        kept by the stored message instead of a copy of it
+ *
  * \param sending_time is stored sending time
+ *
+ * \return true if the message was stored, and an adopted Packet data is then
+ *         owned by it
  *****************************************************************************/
 
-static void sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len,
-        uint8_t *send_packet_data_ptr, uint32_t sending_time, void *param, uint8_t *uri_path_ptr, uint8_t uri_path_len)
+static bool sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t send_packet_data_len,
+        uint8_t *send_packet_data_ptr, bool adopt_packet, uint32_t sending_time, void *param, uint8_t *uri_path_ptr, uint8_t uri_path_len)
 {
 
     coap_send_msg_s *stored_msg_ptr              = NULL;
 
     /* If both queue parameters are "0" or resending count is "0", then re-sending is disabled */
     if (((handle->sn_coap_resending_queue_msgs == 0) && (handle->sn_coap_resending_queue_bytes == 0)) || (handle->sn_coap_resending_count == 0)) {
-        return;
+        return false;
     }
 
     if (handle->sn_coap_resending_queue_msgs > 0) {
         if (handle->count_resent_msgs >= handle->sn_coap_resending_queue_msgs) {
-            return;
+            return false;
         }
     }
 
     /* Count resending queue size, if buffer size is defined */
     if (handle->sn_coap_resending_queue_bytes > 0) {
-        if ((sn_coap_count_linked_list_size(&handle->linked_list_resent_msgs) + send_packet_data_len) > handle->sn_coap_resending_queue_bytes) {
-            return;
+        if ((handle->size_resent_msgs + send_packet_data_len) > handle->sn_coap_resending_queue_bytes) {
+            return false;
         }
     }
 
     /* Allocating memory for stored message */
-    stored_msg_ptr = sn_coap_protocol_allocate_mem_for_msg(handle, dst_addr_ptr, send_packet_data_len);
+    stored_msg_ptr = sn_coap_protocol_allocate_mem_for_msg(handle, dst_addr_ptr, send_packet_data_len,
+                     adopt_packet ? send_packet_data_ptr : NULL);
 
     if (stored_msg_ptr == 0) {
-        return;
+        return false;
     }
 
     /* Filling of coap_send_msg_s with initialization values */
@@ -845,7 +917,9 @@ static void sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, s
     /* Filling of sn_nsdl_transmit_s */
     stored_msg_ptr->send_msg_ptr->protocol = SN_NSDL_PROTOCOL_COAP;
     stored_msg_ptr->send_msg_ptr->packet_len = send_packet_data_len;
-    memcpy(stored_msg_ptr->send_msg_ptr->packet_ptr, send_packet_data_ptr, send_packet_data_len);
+    if (!adopt_packet) {
+        memcpy(stored_msg_ptr->send_msg_ptr->packet_ptr, send_packet_data_ptr, send_packet_data_len);
+    }
 
     /* Filling of sn_nsdl_addr_s */
     stored_msg_ptr->send_msg_ptr->dst_addr_ptr->type = dst_addr_ptr->type;
@@ -859,36 +933,47 @@ static void sn_coap_protocol_linked_list_send_msg_store(struct coap_s *handle, s
     if (uri_path_len) {
         stored_msg_ptr->send_msg_ptr->uri_path_ptr = handle->sn_coap_protocol_malloc(uri_path_len);
         if (stored_msg_ptr->send_msg_ptr->uri_path_ptr == NULL){
-            return;
+            if (adopt_packet) {
+                stored_msg_ptr->send_msg_ptr->packet_ptr = NULL;
+            }
+            sn_coap_protocol_release_allocated_send_msg_mem(handle, stored_msg_ptr);
+            return false;
         }
         stored_msg_ptr->send_msg_ptr->uri_path_len = uri_path_len;
         memcpy(stored_msg_ptr->send_msg_ptr->uri_path_ptr, uri_path_ptr, uri_path_len);
     }
 
 
-    /* Storing Resending message to Linked list */
+    /* Storing Resending message to Linked list, and to the hash bucket of its destination and message ID */
+    uint16_t msg_id = (send_packet_data_ptr[2] << 8) + (uint16_t)send_packet_data_ptr[3];
+    uint16_t bucket = sn_coap_protocol_hash(dst_addr_ptr->addr_ptr, dst_addr_ptr->addr_len, dst_addr_ptr->port, msg_id);
     ns_list_add_to_end(&handle->linked_list_resent_msgs, stored_msg_ptr);
+    ns_list_add_to_end(&handle->hash_resent_msgs[bucket], stored_msg_ptr);
     ++handle->count_resent_msgs;
+    handle->size_resent_msgs += send_packet_data_len;
+    return true;
 }
 
 /**************************************************************************//**
- * \fn static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
+ * \fn static coap_send_msg_s *sn_coap_protocol_linked_list_send_msg_find(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
  *
- * \brief Searches stored resending message from Linked list
+ * \brief Looks up stored resending message from its hash bucket
  *
  * \param *src_addr_ptr is searching key for searched message
  *
  * \param msg_id is searching key for searched message
  *
- * \return Return value is pointer to found stored resending message in Linked
- *         list or NULL if message not found
+ * \return Return value is pointer to found stored resending message or NULL
+ *         if message not found
  *****************************************************************************/
 
-static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(struct coap_s *handle,
+static coap_send_msg_s *sn_coap_protocol_linked_list_send_msg_find(struct coap_s *handle,
         sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
 {
-    /* Loop all stored resending messages Linked list */
-    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->linked_list_resent_msgs) {
+    uint16_t bucket = sn_coap_protocol_hash(src_addr_ptr->addr_ptr, src_addr_ptr->addr_len, src_addr_ptr->port, msg_id);
+
+    /* Loop the stored resending messages of the hash bucket */
+    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->hash_resent_msgs[bucket]) {
         /* Get message ID from stored resending message */
         uint16_t temp_msg_id = (stored_msg_ptr->send_msg_ptr->packet_ptr[2] << 8);
         temp_msg_id += (uint16_t)stored_msg_ptr->send_msg_ptr->packet_ptr[3];
@@ -899,8 +984,8 @@ static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(struct c
             if (0 == memcmp(src_addr_ptr->addr_ptr, stored_msg_ptr->send_msg_ptr->dst_addr_ptr->addr_ptr, src_addr_ptr->addr_len)) {
                 /* If message's Source address port is same than is searched */
                 if (stored_msg_ptr->send_msg_ptr->dst_addr_ptr->port == src_addr_ptr->port) {
-                    /* * * Message found, return pointer to that stored resending message * * * */
-                    return stored_msg_ptr->send_msg_ptr;
+                    /* * * Message found * * * */
+                    return stored_msg_ptr;
                 }
             }
         }
@@ -909,6 +994,32 @@ static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(struct c
     /* Message not found */
     return NULL;
 }
+
+/**************************************************************************//**
+ * \fn static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
+ *
+ * \brief Searches stored resending message from Linked list
+ *
+ * \param *src_addr_ptr is searching key for searched message
+ *
+ * \param msg_id is searching key for searched message
+ *
+ * \return Return value is pointer to found stored resending message in Linked
+ *         list or NULL if message not found
+ *****************************************************************************/
+
+static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(struct coap_s *handle,
+        sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
+{
+    coap_send_msg_s *stored_msg_ptr = sn_coap_protocol_linked_list_send_msg_find(handle, src_addr_ptr, msg_id);
+
+    if (stored_msg_ptr == NULL) {
+        return NULL;
+    }
+
+    /* * * Message found, return pointer to that stored resending message * * * */
+    return stored_msg_ptr->send_msg_ptr;
+}
 /**************************************************************************//**
  * \fn static void sn_coap_protocol_linked_list_send_msg_remove(sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
  *
@@ -920,32 +1031,36 @@ static sn_nsdl_transmit_s *sn_coap_protocol_linked_list_send_msg_search(struct c
 
 static void sn_coap_protocol_linked_list_send_msg_remove(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t msg_id)
 {
-    /* Loop all stored resending messages in Linked list */
-    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, &handle->linked_list_resent_msgs) {
-        /* Get message ID from stored resending message */
-        uint16_t temp_msg_id = (stored_msg_ptr->send_msg_ptr->packet_ptr[2] << 8);
-        temp_msg_id += (uint16_t)stored_msg_ptr->send_msg_ptr->packet_ptr[3];
+    coap_send_msg_s *stored_msg_ptr = sn_coap_protocol_linked_list_send_msg_find(handle, src_addr_ptr, msg_id);
 
-        /* If message's Message ID is same than is searched */
-        if (temp_msg_id == msg_id) {
-            /* If message's Source address is same than is searched */
-            if (0 == memcmp(src_addr_ptr->addr_ptr, stored_msg_ptr->send_msg_ptr->dst_addr_ptr->addr_ptr, src_addr_ptr->addr_len)) {
-                /* If message's Source address port is same than is searched */
-                if (stored_msg_ptr->send_msg_ptr->dst_addr_ptr->port == src_addr_ptr->port) {
-                    /* * * Message found * * */
+    if (stored_msg_ptr != NULL) {
+        /* Remove message from Linked list */
+        sn_coap_protocol_linked_list_send_msg_unlink(handle, stored_msg_ptr);
 
-                    /* Remove message from Linked list */
-                    ns_list_remove(&handle->linked_list_resent_msgs, stored_msg_ptr);
-                    --handle->count_resent_msgs;
+        /* Free memory of stored message */
+        sn_coap_protocol_release_allocated_send_msg_mem(handle, stored_msg_ptr);
+    }
+}
 
-                    /* Free memory of stored message */
-                    sn_coap_protocol_release_allocated_send_msg_mem(handle, stored_msg_ptr);
+/**************************************************************************//**
+ * \fn static void sn_coap_protocol_linked_list_send_msg_unlink(struct coap_s *handle, coap_send_msg_s *removed_msg_ptr)
+ *
+ * \brief Removes stored resending message from Linked list and its hash bucket
+ *
+ * \param *removed_msg_ptr is pointer to removed message, not freed
+ *****************************************************************************/
 
-                    return;
-                }
-            }
-        }
-    }
+static void sn_coap_protocol_linked_list_send_msg_unlink(struct coap_s *handle, coap_send_msg_s *removed_msg_ptr)
+{
+    sn_nsdl_transmit_s *send_msg_ptr = removed_msg_ptr->send_msg_ptr;
+    uint16_t msg_id = (send_msg_ptr->packet_ptr[2] << 8) + (uint16_t)send_msg_ptr->packet_ptr[3];
+    uint16_t bucket = sn_coap_protocol_hash(send_msg_ptr->dst_addr_ptr->addr_ptr, send_msg_ptr->dst_addr_ptr->addr_len,
+                                            send_msg_ptr->dst_addr_ptr->port, msg_id);
+
+    ns_list_remove(&handle->linked_list_resent_msgs, removed_msg_ptr);
+    ns_list_remove(&handle->hash_resent_msgs[bucket], removed_msg_ptr);
+    --handle->count_resent_msgs;
+    handle->size_resent_msgs -= send_msg_ptr->packet_len;
 }
 #endif /* ENABLE_RESENDINGS */
 
@@ -969,6 +1084,24 @@ static void sn_coap_protocol_send_rst(struct coap_s *handle, uint16_t msg_id, sn
     handle->sn_coap_tx_callback(packet_ptr, 4, addr_ptr, param);
 
 }
+
+#if ENABLE_RESENDINGS || SN_COAP_DUPLICATION_MAX_MSGS_COUNT
+/**************************************************************************//**
+ * \fn static uint16_t sn_coap_protocol_hash(const uint8_t *addr_ptr, uint8_t addr_len, uint16_t port, uint16_t msg_id)
+ *
+ * \brief Gives the hash bucket of stored messages of an address, port and Message ID
+ *****************************************************************************/
+
+static uint16_t sn_coap_protocol_hash(const uint8_t *addr_ptr, uint8_t addr_len, uint16_t port, uint16_t msg_id)
+{
+    /* The end of the address differs most between the nodes */
+    uint16_t hash = msg_id ^ port;
+    for (uint8_t i = addr_len > 4 ? addr_len - 4 : 0; i < addr_len; i++) {
+        hash = (hash * 31) + addr_ptr[i];
+    }
+    return (hash ^ (hash >> 8)) & (SN_COAP_HASH_BUCKETS - 1);
+}
+#endif
 #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT /* If Message duplication detection is not used at all, this part of code will not be compiled */
 
 /**************************************************************************//**
@@ -1013,9 +1146,11 @@ static void sn_coap_protocol_linked_list_duplication_info_store(struct coap_s *h
 
     stored_duplication_info_ptr->coap = handle;
 
-    /* * * * Storing Duplication info to Linked list * * * */
+    /* * * * Storing Duplication info to Linked list, and to the hash bucket of its address and Message ID * * * */
 
+    uint16_t bucket = sn_coap_protocol_hash(addr_ptr->addr_ptr, addr_ptr->addr_len, addr_ptr->port, msg_id);
     ns_list_add_to_end(&handle->linked_list_duplication_msgs, stored_duplication_info_ptr);
+    ns_list_add_to_end(&handle->hash_duplication_msgs[bucket], stored_duplication_info_ptr);
     ++handle->count_duplication_msgs;
 }
 
@@ -1033,8 +1168,10 @@ static void sn_coap_protocol_linked_list_duplication_info_store(struct coap_s *h
 static int8_t sn_coap_protocol_linked_list_duplication_info_search(struct coap_s *handle,
         sn_nsdl_addr_s *addr_ptr, uint16_t msg_id)
 {
-    /* Loop all nodes in Linked list for searching Message ID */
-    ns_list_foreach(coap_duplication_info_s, stored_duplication_info_ptr, &handle->linked_list_duplication_msgs) {
+    uint16_t bucket = sn_coap_protocol_hash(addr_ptr->addr_ptr, addr_ptr->addr_len, addr_ptr->port, msg_id);
+
+    /* Loop the nodes of the hash bucket for searching Message ID */
+    ns_list_foreach(coap_duplication_info_s, stored_duplication_info_ptr, &handle->hash_duplication_msgs[bucket]) {
         /* If message's Message ID is same than is searched */
         if (stored_duplication_info_ptr->msg_id == msg_id) {
             /* If message's Source address is same than is searched */
@@ -1052,42 +1189,26 @@ static int8_t sn_coap_protocol_linked_list_duplication_info_search(struct coap_s
 }
 
 /**************************************************************************//**
- * \fn static void sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *handle, uint8_t *addr_ptr, uint16_t port, uint16_t msg_id)
- *
- * \brief Removes stored Duplication info from Linked list
+ * \fn static void sn_coap_protocol_linked_list_duplication_info_release(struct coap_s *handle, coap_duplication_info_s *removed_duplication_info_ptr)
  *
- * \param *addr_ptr is pointer to Address key to be removed
+ * \brief Removes stored Duplication info from Linked list and its hash bucket, and frees it
  *
- * \param port is Port key to be removed
- *
- * \param msg_id is Message ID key to be removed
+ * \param *removed_duplication_info_ptr is pointer to removed Duplication info
  *****************************************************************************/
 
-static void sn_coap_protocol_linked_list_duplication_info_remove(struct coap_s *handle, uint8_t *addr_ptr, uint16_t port, uint16_t msg_id)
+static void sn_coap_protocol_linked_list_duplication_info_release(struct coap_s *handle, coap_duplication_info_s *removed_duplication_info_ptr)
 {
-    /* Loop all stored duplication messages in Linked list */
-    ns_list_foreach(coap_duplication_info_s, removed_duplication_info_ptr, &handle->linked_list_duplication_msgs) {
-        /* If message's Address is same than is searched */
-        if (handle == removed_duplication_info_ptr->coap && 0 == memcmp(addr_ptr, removed_duplication_info_ptr->addr_ptr, removed_duplication_info_ptr->addr_len)) {
-            /* If message's Address prt is same than is searched */
-            if (removed_duplication_info_ptr->port == port) {
-                /* If Message ID is same than is searched */
-                if (removed_duplication_info_ptr->msg_id == msg_id) {
-                    /* * * * Correct Duplication info found, remove it from Linked list * * * */
-                    ns_list_remove(&handle->linked_list_duplication_msgs, removed_duplication_info_ptr);
-                    --handle->count_duplication_msgs;
-
-                    /* Free memory of stored Duplication info */
-                    handle->sn_coap_protocol_free(removed_duplication_info_ptr->addr_ptr);
-                    removed_duplication_info_ptr->addr_ptr = 0;
-                    handle->sn_coap_protocol_free(removed_duplication_info_ptr);
-                    removed_duplication_info_ptr = 0;
-
-                    return;
-                }
-            }
-        }
-    }
+    uint16_t bucket = sn_coap_protocol_hash(removed_duplication_info_ptr->addr_ptr, removed_duplication_info_ptr->addr_len,
+                                            removed_duplication_info_ptr->port, removed_duplication_info_ptr->msg_id);
+
+    ns_list_remove(&handle->linked_list_duplication_msgs, removed_duplication_info_ptr);
+    ns_list_remove(&handle->hash_duplication_msgs[bucket], removed_duplication_info_ptr);
+    --handle->count_duplication_msgs;
+
+    /* Free memory of stored Duplication info */
+    handle->sn_coap_protocol_free(removed_duplication_info_ptr->addr_ptr);
+    removed_duplication_info_ptr->addr_ptr = 0;
+    handle->sn_coap_protocol_free(removed_duplication_info_ptr);
 }
 
 /**************************************************************************//**
@@ -1102,14 +1223,7 @@ static void sn_coap_protocol_linked_list_duplication_info_remove_old_ones(struct
     ns_list_foreach_safe(coap_duplication_info_s, removed_duplication_info_ptr, &handle->linked_list_duplication_msgs) {
         if ((handle->system_time - removed_duplication_info_ptr->timestamp)  > SN_COAP_DUPLICATION_MAX_TIME_MSGS_STORED) {
             /* * * * Old Duplication info found, remove it from Linked list * * * */
-            ns_list_remove(&handle->linked_list_duplication_msgs, removed_duplication_info_ptr);
-            --handle->count_duplication_msgs;
-
-            /* Free memory of stored Duplication info */
-            handle->sn_coap_protocol_free(removed_duplication_info_ptr->addr_ptr);
-            removed_duplication_info_ptr->addr_ptr = 0;
-            handle->sn_coap_protocol_free(removed_duplication_info_ptr);
-            removed_duplication_info_ptr = 0;
+            sn_coap_protocol_linked_list_duplication_info_release(handle, removed_duplication_info_ptr);
         }
     }
 }
@@ -1362,11 +1476,12 @@ static void sn_coap_protocol_linked_list_blockwise_remove_old_data(struct coap_s
  *
  * \param *dst_addr_ptr is pointer to destination address where message will be sent
  * \param packet_data_len is length of allocated Packet data
+ * \param *packet_data_ptr is Packet data allocated with the handle to keep, NULL to allocate it
  *
  * \return pointer to allocated struct
  *****************************************************************************/
 
-coap_send_msg_s *sn_coap_protocol_allocate_mem_for_msg(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t packet_data_len)
+coap_send_msg_s *sn_coap_protocol_allocate_mem_for_msg(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr)
 {
 
     coap_send_msg_s *msg_ptr = handle->sn_coap_protocol_malloc(sizeof(coap_send_msg_s));
@@ -1395,11 +1510,14 @@ coap_send_msg_s *sn_coap_protocol_allocate_mem_for_msg(struct coap_s *handle, sn
 
     memset(msg_ptr->send_msg_ptr->dst_addr_ptr, 0, sizeof(sn_nsdl_addr_s));
 
-    msg_ptr->send_msg_ptr->packet_ptr = handle->sn_coap_protocol_malloc(packet_data_len);
+    /* A kept Packet data is attached last, so that the caller still owns it on failure */
+    if (packet_data_ptr == NULL) {
+        msg_ptr->send_msg_ptr->packet_ptr = handle->sn_coap_protocol_malloc(packet_data_len);
 
-    if (msg_ptr->send_msg_ptr->packet_ptr == NULL) {
-        sn_coap_protocol_release_allocated_send_msg_mem(handle, msg_ptr);
-        return 0;
+        if (msg_ptr->send_msg_ptr->packet_ptr == NULL) {
+            sn_coap_protocol_release_allocated_send_msg_mem(handle, msg_ptr);
+            return 0;
+        }
     }
 
     msg_ptr->send_msg_ptr->dst_addr_ptr->addr_ptr = handle->sn_coap_protocol_malloc(dst_addr_ptr->addr_len);
@@ -1411,6 +1529,10 @@ coap_send_msg_s *sn_coap_protocol_allocate_mem_for_msg(struct coap_s *handle, sn
 
     memset(msg_ptr->send_msg_ptr->dst_addr_ptr->addr_ptr, 0, dst_addr_ptr->addr_len);
 
+    if (packet_data_ptr != NULL) {
+        msg_ptr->send_msg_ptr->packet_ptr = packet_data_ptr;
+    }
+
     return msg_ptr;
 }
 
@@ -1456,26 +1578,6 @@ static void sn_coap_protocol_release_allocated_send_msg_mem(struct coap_s *handl
     }
 }
 
-/**************************************************************************//**
- * \fn static uint16_t sn_coap_count_linked_list_size(const coap_send_msg_list_t *linked_list_ptr)
- *
- * \brief Counts total message size of all messages in linked list
- *
- * \param const coap_send_msg_list_t *linked_list_ptr pointer to linked list
- *****************************************************************************/
-static uint16_t sn_coap_count_linked_list_size(const coap_send_msg_list_t *linked_list_ptr)
-{
-    uint16_t total_size = 0;
-
-    ns_list_foreach(coap_send_msg_s, stored_msg_ptr, linked_list_ptr) {
-        if (stored_msg_ptr->send_msg_ptr) {
-            total_size += stored_msg_ptr->send_msg_ptr->packet_len;
-        }
-    }
-
-    return total_size;
-}
-
 #endif
 
 #if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE
@@ -1609,7 +1711,7 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                         message_id = 1;
                     }
 
-                    sn_coap_builder_2(dst_ack_packet_data_ptr, src_coap_blockwise_ack_msg_ptr, handle->sn_coap_block_data_size);
+                    sn_coap_builder_sized(dst_ack_packet_data_ptr, dst_packed_data_needed_mem, src_coap_blockwise_ack_msg_ptr);
                     tr_debug("sn_coap_handle_blockwise_message - block1 request, send block msg id: [%d]", src_coap_blockwise_ack_msg_ptr->msg_id);
                     handle->sn_coap_tx_callback(dst_ack_packet_data_ptr, dst_packed_data_needed_mem, src_addr_ptr, param);
 
@@ -1636,7 +1738,18 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                 received_coap_msg_ptr->payload_len = handle->sn_coap_block_data_size;
             }
 
-            sn_coap_protocol_linked_list_blockwise_payload_store(handle, src_addr_ptr, received_coap_msg_ptr->payload_len, received_coap_msg_ptr->payload_ptr);
+            if (handle->sn_coap_block_stream_callback) {
+                /* Give the block to the application instead of storing it, the offset is in the block size of the sender */
+                uint32_t block1 = received_coap_msg_ptr->options_list_ptr->block1;
+                uint32_t offset = (block1 >> 4) * ((uint32_t)16 << ((block1 & 0x07) > 6 ? 6 : (block1 & 0x07)));
+
+                if (handle->sn_coap_block_stream_callback(received_coap_msg_ptr, offset, (block1 & 0x08) != 0, src_addr_ptr, param) != 0) {
+                    received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED;
+                    return received_coap_msg_ptr;
+                }
+            } else {
+                sn_coap_protocol_linked_list_blockwise_payload_store(handle, src_addr_ptr, received_coap_msg_ptr->payload_len, received_coap_msg_ptr->payload_ptr);
+            }
             /* If not last block (more value is set) */
             /* Block option length can be 1-3 bytes. First 4-20 bits are for block number. Last 4 bits are ALWAYS more bit + block size. */
             if (received_coap_msg_ptr->options_list_ptr->block1 & 0x08) {
@@ -1656,8 +1769,9 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
 
                 // Response with COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_TOO_LARGE if the payload size is more than we can handle
                 tr_debug("sn_coap_handle_blockwise_message - block1 received - incoming size: [%d]", received_coap_msg_ptr->options_list_ptr->size1);
+                /* A streamed payload is not held in memory */
                 uint32_t max_size = SN_COAP_MAX_INCOMING_BLOCK_MESSAGE_SIZE;
-                if (received_coap_msg_ptr->options_list_ptr->size1 > max_size) {
+                if (!handle->sn_coap_block_stream_callback && received_coap_msg_ptr->options_list_ptr->size1 > max_size) {
                     // Include maximum size that stack can handle into response
                     src_coap_blockwise_ack_msg_ptr->msg_code = COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_TOO_LARGE;
                     src_coap_blockwise_ack_msg_ptr->options_list_ptr->size1 = max_size;
@@ -1696,7 +1810,7 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                     return NULL;
                 }
 
-                sn_coap_builder_2(dst_ack_packet_data_ptr, src_coap_blockwise_ack_msg_ptr, handle->sn_coap_block_data_size);
+                sn_coap_builder_sized(dst_ack_packet_data_ptr, dst_packed_data_needed_mem, src_coap_blockwise_ack_msg_ptr);
                 tr_debug("sn_coap_handle_blockwise_message - block1 received - send msg id [%d]", src_coap_blockwise_ack_msg_ptr->msg_id);
                 handle->sn_coap_tx_callback(dst_ack_packet_data_ptr, dst_packed_data_needed_mem, src_addr_ptr, param);
 
@@ -1706,6 +1820,9 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
 
                 received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING;
 
+            } else if (handle->sn_coap_block_stream_callback) {
+                tr_debug("sn_coap_handle_blockwise_message - block1 received, last block streamed");
+                received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED;
             } else {
                 tr_debug("sn_coap_handle_blockwise_message - block1 received, last block received");
                 /* * * This is the last block when whole Blockwise payload from received * * */
@@ -1748,7 +1865,9 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
     else {
         tr_debug("sn_coap_handle_blockwise_message - block2 - message code: [%d]", received_coap_msg_ptr->msg_code);
         //This is response to request we made
-        if (received_coap_msg_ptr->msg_code > COAP_MSG_CODE_REQUEST_DELETE) {
+        if (received_coap_msg_ptr->msg_code > COAP_MSG_CODE_REQUEST_DELETE && handle->sn_coap_block_stream_callback) {
+            return sn_coap_handle_block2_stream(handle, src_addr_ptr, received_coap_msg_ptr, param);
+        } else if (received_coap_msg_ptr->msg_code > COAP_MSG_CODE_REQUEST_DELETE) {
             tr_debug("sn_coap_handle_blockwise_message - send block2 request");
             uint32_t block_number = 0;
 
@@ -1827,10 +1946,8 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                     sn_coap_parser_release_allocated_coap_msg_mem(handle, received_coap_msg_ptr);
                     return NULL;
                 }
-                memset(dst_ack_packet_data_ptr, 0, dst_packed_data_needed_mem);
-
                 /* * * Then build Acknowledgement message to Packed data * * */
-                if ((sn_coap_builder_2(dst_ack_packet_data_ptr, src_coap_blockwise_ack_msg_ptr, handle->sn_coap_block_data_size)) < 0) {
+                if ((sn_coap_builder_sized(dst_ack_packet_data_ptr, dst_packed_data_needed_mem, src_coap_blockwise_ack_msg_ptr)) < 0) {
                     handle->sn_coap_protocol_free(dst_ack_packet_data_ptr);
                     dst_ack_packet_data_ptr = 0;
                     handle->sn_coap_protocol_free(src_coap_blockwise_ack_msg_ptr->options_list_ptr);
@@ -1869,13 +1986,18 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                                             dst_packed_data_needed_mem, src_addr_ptr, param);
 
 #if ENABLE_RESENDINGS
-                sn_coap_protocol_linked_list_send_msg_store(handle, src_addr_ptr,
+                /* The built packet is kept for resending as it is */
+                if (sn_coap_protocol_linked_list_send_msg_store(handle, src_addr_ptr,
                         dst_packed_data_needed_mem,
-                        dst_ack_packet_data_ptr,
-                        handle->system_time + (uint32_t)(handle->sn_coap_resending_intervall * RESPONSE_RANDOM_FACTOR), param, NULL, 0);
+                        dst_ack_packet_data_ptr, true,
+                        handle->system_time + (uint32_t)(handle->sn_coap_resending_intervall * RESPONSE_RANDOM_FACTOR), param, NULL, 0)) {
+                    dst_ack_packet_data_ptr = 0;
+                }
 #endif
-                handle->sn_coap_protocol_free(dst_ack_packet_data_ptr);
-                dst_ack_packet_data_ptr = 0;
+                if (dst_ack_packet_data_ptr) {
+                    handle->sn_coap_protocol_free(dst_ack_packet_data_ptr);
+                    dst_ack_packet_data_ptr = 0;
+                }
             }
 
             //Last block received
@@ -1979,7 +2101,7 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
                     return NULL;
                 }
 
-                sn_coap_builder_2(dst_ack_packet_data_ptr, src_coap_blockwise_ack_msg_ptr, handle->sn_coap_block_data_size);
+                sn_coap_builder_sized(dst_ack_packet_data_ptr, dst_packed_data_needed_mem, src_coap_blockwise_ack_msg_ptr);
                 tr_debug("sn_coap_handle_blockwise_message - block2 received, send message: [%d]", src_coap_blockwise_ack_msg_ptr->msg_id);
                 handle->sn_coap_tx_callback(dst_ack_packet_data_ptr, dst_packed_data_needed_mem, src_addr_ptr, param);
 
@@ -2000,6 +2122,157 @@ static sn_coap_hdr_s *sn_coap_handle_blockwise_message(struct coap_s *handle, sn
     return received_coap_msg_ptr;
 }
 
+/**
+ * \fn static sn_coap_hdr_s *sn_coap_handle_block2_stream(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *received_coap_msg_ptr, void *param)
+ *
+ * \brief Gives a received Block2 response to the block stream callback and requests the following blocks
+ *
+ *        After the first block, the blocks up to the window are requested; each block
+ *        received then requests the one a window further. Without a known Size2 the
+ *        blocks are requested one at a time.
+ *
+ * \return The received message, or NULL if it was not a response to a block request
+ */
+static sn_coap_hdr_s *sn_coap_handle_block2_stream(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *received_coap_msg_ptr, void *param)
+{
+    coap_blockwise_msg_s *previous_blockwise_msg_ptr = NULL;
+    uint32_t block2 = received_coap_msg_ptr->options_list_ptr->block2;
+    uint32_t block_number = block2 >> 4;
+    uint8_t block_size_exp = (block2 & 0x07) > 6 ? 6 : (block2 & 0x07);
+    uint32_t block_size = (uint32_t)16 << block_size_exp;
+    bool more = (block2 & 0x08) != 0;
+    uint32_t size2;
+    uint32_t first_block;
+    uint32_t last_block;
+
+    tr_debug("sn_coap_handle_block2_stream - block: [%lu]", (unsigned long)block_number);
+
+    ns_list_foreach(coap_blockwise_msg_s, msg, &handle->linked_list_blockwise_sent_msgs) {
+        if (received_coap_msg_ptr->msg_id == msg->coap_msg_ptr->msg_id) {
+            previous_blockwise_msg_ptr = msg;
+            break;
+        }
+    }
+
+    if (!previous_blockwise_msg_ptr || !previous_blockwise_msg_ptr->coap_msg_ptr) {
+        sn_coap_parser_release_allocated_coap_msg_mem(handle, received_coap_msg_ptr);
+        return NULL;
+    }
+
+    ns_list_remove(&handle->linked_list_blockwise_sent_msgs, previous_blockwise_msg_ptr);
+
+    size2 = previous_blockwise_msg_ptr->size2;
+    if (received_coap_msg_ptr->options_list_ptr->use_size2) {
+        size2 = received_coap_msg_ptr->options_list_ptr->size2;
+    }
+
+    if (handle->sn_coap_block_stream_callback(received_coap_msg_ptr, block_number * block_size, more, src_addr_ptr, param) != 0) {
+        received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_REJECTED;
+    } else if (more) {
+        received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING;
+
+        /* The request of a block is made from the one it follows, for the same resource */
+        if (block_number == 0 && size2) {
+            first_block = 1;
+            last_block = handle->sn_coap_block2_window;
+        } else if (size2) {
+            first_block = last_block = block_number + handle->sn_coap_block2_window;
+        } else {
+            first_block = last_block = block_number + 1;
+        }
+
+        for (uint32_t i = first_block; i <= last_block; i++) {
+            if (size2 && i * block_size >= size2) {
+                break;
+            }
+            if (sn_coap_protocol_send_block2_request(handle, src_addr_ptr, previous_blockwise_msg_ptr->coap_msg_ptr,
+                    i, block_size_exp, size2, param) != 0) {
+                break;
+            }
+        }
+    } else {
+        received_coap_msg_ptr->coap_status = COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED;
+    }
+
+    if (previous_blockwise_msg_ptr->coap_msg_ptr->payload_ptr) {
+        handle->sn_coap_protocol_free(previous_blockwise_msg_ptr->coap_msg_ptr->payload_ptr);
+        previous_blockwise_msg_ptr->coap_msg_ptr->payload_ptr = 0;
+    }
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, previous_blockwise_msg_ptr->coap_msg_ptr);
+    handle->sn_coap_protocol_free(previous_blockwise_msg_ptr);
+
+    return received_coap_msg_ptr;
+}
+
+/**
+ * \fn static int8_t sn_coap_protocol_send_block2_request(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, sn_coap_hdr_s *request_ptr, uint32_t block_number, uint8_t block_size_exp, uint32_t size2, void *param)
+ *
+ * \brief Sends a confirmable request for a block of a streamed Block2 response
+ *
+ * \param *request_ptr is the request the block request is made from
+ * \param size2 is the whole size of the response, kept for the following requests
+ *
+ * \return 0 if the request was sent, -1 in memory allocation failure
+ */
+static int8_t sn_coap_protocol_send_block2_request(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr, sn_coap_hdr_s *request_ptr,
+        uint32_t block_number, uint8_t block_size_exp, uint32_t size2, void *param)
+{
+    coap_blockwise_msg_s *stored_blockwise_msg_ptr = NULL;
+    sn_coap_hdr_s *block_request_ptr = NULL;
+    uint8_t *packet_data_ptr = NULL;
+    uint16_t packet_data_len = 0;
+
+    block_request_ptr = sn_coap_protocol_copy_header(handle, request_ptr);
+    if (block_request_ptr == NULL || sn_coap_parser_alloc_options(handle, block_request_ptr) == NULL) {
+        sn_coap_parser_release_allocated_coap_msg_mem(handle, block_request_ptr);
+        return -1;
+    }
+
+    block_request_ptr->msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+    block_request_ptr->msg_id = message_id++;
+    if (message_id == 0) {
+        message_id = 1;
+    }
+    block_request_ptr->options_list_ptr->block2 = (block_number << 4) | block_size_exp;
+    block_request_ptr->options_list_ptr->use_size2 = false;
+
+    packet_data_len = sn_coap_builder_calc_needed_packet_data_size_2(block_request_ptr, handle->sn_coap_block_data_size);
+    if (packet_data_len) {
+        packet_data_ptr = handle->sn_coap_protocol_malloc(packet_data_len);
+    }
+    if (packet_data_ptr) {
+        stored_blockwise_msg_ptr = handle->sn_coap_protocol_malloc(sizeof(coap_blockwise_msg_s));
+    }
+    if (!stored_blockwise_msg_ptr || sn_coap_builder_sized(packet_data_ptr, packet_data_len, block_request_ptr) < 0) {
+        handle->sn_coap_protocol_free(stored_blockwise_msg_ptr);
+        handle->sn_coap_protocol_free(packet_data_ptr);
+        sn_coap_parser_release_allocated_coap_msg_mem(handle, block_request_ptr);
+        return -1;
+    }
+
+    /* * * Save to linked list, to match the response * * */
+    memset(stored_blockwise_msg_ptr, 0, sizeof(coap_blockwise_msg_s));
+    stored_blockwise_msg_ptr->timestamp = handle->system_time;
+    stored_blockwise_msg_ptr->coap_msg_ptr = block_request_ptr;
+    stored_blockwise_msg_ptr->coap = handle;
+    stored_blockwise_msg_ptr->size2 = size2;
+    ns_list_add_to_end(&handle->linked_list_blockwise_sent_msgs, stored_blockwise_msg_ptr);
+
+    handle->sn_coap_tx_callback(packet_data_ptr, packet_data_len, dst_addr_ptr, param);
+
+#if ENABLE_RESENDINGS
+    if (sn_coap_protocol_linked_list_send_msg_store(handle, dst_addr_ptr, packet_data_len, packet_data_ptr, true,
+            handle->system_time + (uint32_t)(handle->sn_coap_resending_intervall * RESPONSE_RANDOM_FACTOR), param, NULL, 0)) {
+        packet_data_ptr = NULL;
+    }
+#endif
+    if (packet_data_ptr) {
+        handle->sn_coap_protocol_free(packet_data_ptr);
+    }
+
+    return 0;
+}
+
 static int8_t sn_coap_convert_block_size(uint16_t block_size)
 {
     if (block_size == 16) {
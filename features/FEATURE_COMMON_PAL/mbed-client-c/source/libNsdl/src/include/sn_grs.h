@@ -38,6 +38,17 @@ extern "C" {
 #define SN_NDSL_RESOURCE_REGISTERING    1
 #define SN_NDSL_RESOURCE_REGISTERED     2
 
+/* Number of hash buckets the resources are looked up with, by path. Must be 2^x. */
+#ifdef YOTTA_CFG_GRS_HASH_BUCKETS
+#define SN_GRS_HASH_BUCKETS YOTTA_CFG_GRS_HASH_BUCKETS
+#elif defined MBED_CONF_MBED_CLIENT_SN_GRS_HASH_BUCKETS
+#define SN_GRS_HASH_BUCKETS MBED_CONF_MBED_CLIENT_SN_GRS_HASH_BUCKETS
+#endif
+
+#ifndef SN_GRS_HASH_BUCKETS
+#define SN_GRS_HASH_BUCKETS             16
+#endif
+
 /***** Structs *****/
 
 typedef struct sn_grs_version_ {
@@ -47,6 +58,7 @@ typedef struct sn_grs_version_ {
 } sn_grs_version_s;
 
 typedef NS_LIST_HEAD(sn_nsdl_resource_info_s, link) resource_list_t;
+typedef NS_LIST_HEAD(sn_nsdl_resource_info_s, hash_link) resource_bucket_t;
 
 struct grs_s {
     struct coap_s *coap;
@@ -58,8 +70,27 @@ struct grs_s {
 
     uint16_t resource_root_count;
     resource_list_t resource_root_list;
+    resource_bucket_t resource_hash[SN_GRS_HASH_BUCKETS]; /* The resources of the list, by the hash of their path */
 };
 
+/* The latest notification of an observation, held back until the minimum period from the previous one has passed */
+typedef struct sn_nsdl_notification_ {
+    uint8_t token[8];                   /* Identifies the observation */
+    uint8_t token_len;
+    bool pending;                       /* A notification is held back */
+    uint8_t msg_type;
+    uint8_t content_format;
+    uint16_t msg_id;                    /* Taken when the notification was first held back */
+    uint16_t payload_len;
+    uint16_t uri_path_len;
+    uint8_t *data_ptr;                  /* Payload followed by uri path */
+    sn_coap_observe_e observe;
+    uint32_t sent_time;                 /* Of the previous notification */
+
+    ns_list_link_t link;
+} sn_nsdl_notification_s;
+
+typedef NS_LIST_HEAD(sn_nsdl_notification_s, link) sn_nsdl_notification_list_t;
 
 struct nsdl_s {
     uint16_t update_register_msg_id;
@@ -87,6 +118,10 @@ struct nsdl_s {
     uint8_t (*sn_nsdl_rx_callback)(struct nsdl_s *, sn_coap_hdr_s *, sn_nsdl_addr_s *);
     void (*sn_nsdl_oma_bs_done_cb_handle)(sn_nsdl_oma_server_info_t *server_info_ptr,
                                           struct nsdl_s *handle); /* Callback to inform application when bootstrap is done with nsdl handle */
+
+    uint32_t sn_nsdl_time;                                                      /* Of the latest sn_nsdl_exec() */
+    uint32_t notification_pmin;                                                 /* Minimum period between notifications of an observation, 0 if not limited */
+    sn_nsdl_notification_list_t notification_list;                              /* Observations notified within the minimum period */
 };
 
 /***** Function prototypes *****/
@@ -123,6 +158,8 @@ extern int8_t                           sn_grs_create_resource(struct grs_s *han
 extern int8_t                           sn_grs_put_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res);
 extern int8_t                           sn_grs_delete_resource(struct grs_s *handle, uint16_t pathlen, uint8_t *path);
 extern void                             sn_grs_mark_resources_as_registered(struct nsdl_s *handle);
+extern void                             sn_grs_insert_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res);
+extern void                             sn_grs_remove_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res);
 
 #ifdef __cplusplus
 }
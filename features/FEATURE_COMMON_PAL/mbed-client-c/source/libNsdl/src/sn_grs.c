@@ -42,6 +42,8 @@
 /* Local static function prototypes */
 static int8_t                       sn_grs_resource_info_free(struct grs_s *handle, sn_nsdl_resource_info_s *resource_ptr);
 static uint8_t                     *sn_grs_convert_uri(uint16_t *uri_len, uint8_t *uri_ptr);
+static uint8_t                      sn_grs_path_hash(uint16_t pathlen, const uint8_t *path);
+static bool                         sn_grs_is_subresource(const sn_nsdl_resource_info_s *resource_ptr, uint16_t pathlen, const uint8_t *path);
 static int8_t                       sn_grs_add_resource_to_list(struct grs_s *handle, sn_nsdl_resource_info_s *resource_ptr);
 static int8_t                       sn_grs_core_request(struct nsdl_s *handle, sn_nsdl_addr_s *src_addr_ptr, sn_coap_hdr_s *coap_packet_ptr);
 static uint8_t                      coap_tx_callback(uint8_t *, uint16_t, sn_nsdl_addr_s *, void *);
@@ -61,8 +63,7 @@ extern int8_t sn_grs_destroy(struct grs_s *handle)
         return 0;
     }
     ns_list_foreach_safe(sn_nsdl_resource_info_s, tmp, &handle->resource_root_list) {
-        ns_list_remove(&handle->resource_root_list, tmp);
-        --handle->resource_root_count;
+        sn_grs_remove_resource(handle, tmp);
         sn_grs_resource_info_free(handle, tmp);
     }
     handle->sn_grs_free(handle);
@@ -256,18 +257,18 @@ extern int8_t sn_grs_delete_resource(struct grs_s *handle, uint16_t pathlen, uin
         return SN_NSDL_FAILURE;
     }
 
-    /* If found, delete it and delete also subresources, if there is any */
-    do {
-        /* Remove from list */
-        ns_list_remove(&handle->resource_root_list, resource_temp);
-        --handle->resource_root_count;
+    /* If found, delete it */
+    sn_grs_remove_resource(handle, resource_temp);
+    sn_grs_resource_info_free(handle, resource_temp);
 
-        /* Free */
-        sn_grs_resource_info_free(handle, resource_temp);
-
-        /* Search for subresources */
-        resource_temp = sn_grs_search_resource(handle, pathlen, path, SN_GRS_DELETE_METHOD);
-    } while (resource_temp != NULL);
+    /* Delete also subresources, if there is any, in one pass over the list */
+    path = sn_grs_convert_uri(&pathlen, path);
+    ns_list_foreach_safe(sn_nsdl_resource_info_s, tmp, &handle->resource_root_list) {
+        if (sn_grs_is_subresource(tmp, pathlen, path)) {
+            sn_grs_remove_resource(handle, tmp);
+            sn_grs_resource_info_free(handle, tmp);
+        }
+    }
 
     return SN_NSDL_SUCCESS;
 }
@@ -366,8 +367,7 @@ int8_t sn_grs_put_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res)
 
     res->is_put = true;
 
-    ns_list_add_to_start(&handle->resource_root_list, res);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res);
 
     return SN_NSDL_SUCCESS;
 }
@@ -675,7 +675,7 @@ extern int8_t sn_grs_send_coap_message(struct nsdl_s *handle, sn_nsdl_addr_s *ad
     }
 
     /* Build CoAP message */
-    if (sn_coap_protocol_build(handle->grs->coap, address_ptr, message_ptr, coap_hdr_ptr, (void *)handle) < 0) {
+    if (sn_coap_protocol_build_sized(handle->grs->coap, address_ptr, message_ptr, message_len, coap_hdr_ptr, (void *)handle) < 0) {
         handle->grs->sn_grs_free(message_ptr);
         message_ptr = 0;
         return SN_NSDL_FAILURE;
@@ -770,8 +770,8 @@ sn_nsdl_resource_info_s *sn_grs_search_resource(struct grs_s *handle, uint16_t p
 
     /* Searchs exact path */
     if (search_method == SN_GRS_SEARCH_METHOD) {
-        /* Scan all nodes on list */
-        ns_list_foreach(sn_nsdl_resource_info_s, resource_search_temp, &handle->resource_root_list) {
+        /* Scan the nodes in the hash bucket of the path */
+        ns_list_foreach(sn_nsdl_resource_info_s, resource_search_temp, &handle->resource_hash[sn_grs_path_hash(pathlen, path_temp_ptr)]) {
             /* If length equals.. */
             if (resource_search_temp->pathlen == pathlen) {
                 /* Compare paths, If same return node pointer*/
@@ -785,10 +785,7 @@ sn_nsdl_resource_info_s *sn_grs_search_resource(struct grs_s *handle, uint16_t p
     else if (search_method == SN_GRS_DELETE_METHOD) {
         /* Scan all nodes on list */
         ns_list_foreach(sn_nsdl_resource_info_s, resource_search_temp, &handle->resource_root_list) {
-            uint8_t *temp_path = resource_search_temp->path;
-            if (resource_search_temp->pathlen > pathlen &&
-                    (*(temp_path + (uint8_t)pathlen) == '/') &&
-                    0 == memcmp(resource_search_temp->path, path_temp_ptr, pathlen)) {
+            if (sn_grs_is_subresource(resource_search_temp, pathlen, path_temp_ptr)) {
                 return resource_search_temp;
             }
         }
@@ -920,13 +917,57 @@ static int8_t sn_grs_add_resource_to_list(struct grs_s *handle, sn_nsdl_resource
     }
 
     /* Add copied resource to the linked list */
-    ns_list_add_to_start(&handle->resource_root_list, resource_copy_ptr);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, resource_copy_ptr);
 
     return SN_NSDL_SUCCESS;
 }
 
 
+/**
+ * \fn  void sn_grs_insert_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res)
+ *
+ * \brief Adds given resource to the resource list and to the hash bucket of its path
+ *
+ *  The path of the resource must not start or end with '/'.
+ *
+*/
+void sn_grs_insert_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res)
+{
+    ns_list_add_to_start(&handle->resource_root_list, res);
+    ns_list_add_to_start(&handle->resource_hash[sn_grs_path_hash(res->pathlen, res->path)], res);
+    ++handle->resource_root_count;
+}
+
+/**
+ * \fn  void sn_grs_remove_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res)
+ *
+ * \brief Removes given resource from the resource list and its hash bucket, without freeing it
+ *
+*/
+void sn_grs_remove_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res)
+{
+    ns_list_remove(&handle->resource_root_list, res);
+    ns_list_remove(&handle->resource_hash[sn_grs_path_hash(res->pathlen, res->path)], res);
+    --handle->resource_root_count;
+}
+
+static uint8_t sn_grs_path_hash(uint16_t pathlen, const uint8_t *path)
+{
+    uint32_t hash = 0;
+    for (uint16_t i = 0; i < pathlen; i++) {
+        hash = (hash * 31) + path[i];
+    }
+    return (hash ^ (hash >> 8)) & (SN_GRS_HASH_BUCKETS - 1);
+}
+
+/* True if the resource is under the path, eg. dr/x/1 under dr/x */
+static bool sn_grs_is_subresource(const sn_nsdl_resource_info_s *resource_ptr, uint16_t pathlen, const uint8_t *path)
+{
+    return resource_ptr->pathlen > pathlen &&
+           resource_ptr->path[pathlen] == '/' &&
+           0 == memcmp(resource_ptr->path, path, pathlen);
+}
+
 /**
  * \fn  static uint8_t *sn_grs_convert_uri(uint16_t *uri_len, uint8_t *uri_ptr)
  *
@@ -109,6 +109,16 @@ static int8_t           set_endpoint_info(struct nsdl_s *handle, sn_nsdl_ep_para
 static bool             validateParameters(sn_nsdl_ep_parameters_s *parameter_ptr);
 static bool             validate(uint8_t* ptr, uint32_t len, char illegalChar);
 static bool             sn_nsdl_check_uint_overflow(uint16_t resource_size, uint16_t param_a, uint16_t param_b);
+static uint16_t         sn_nsdl_send_notification(struct nsdl_s *handle, uint16_t msg_id, uint8_t *token_ptr, uint8_t token_len,
+                                                  uint8_t *payload_ptr, uint16_t payload_len, sn_coap_observe_e observe,
+                                                  sn_coap_msg_type_e message_type, uint8_t content_format,
+                                                  uint8_t *uri_path_ptr, uint16_t uri_path_len);
+static sn_nsdl_notification_s *sn_nsdl_find_notification(struct nsdl_s *handle, const uint8_t *token_ptr, uint8_t token_len);
+static uint16_t         sn_nsdl_hold_notification(struct nsdl_s *handle, sn_nsdl_notification_s *notification,
+                                                  uint8_t *payload_ptr, uint16_t payload_len, sn_coap_observe_e observe,
+                                                  sn_coap_msg_type_e message_type, uint8_t content_format,
+                                                  uint8_t *uri_path_ptr, uint16_t uri_path_len);
+static void             sn_nsdl_flush_notifications(struct nsdl_s *handle, bool all);
 
 int8_t sn_nsdl_destroy(struct nsdl_s *handle)
 {
@@ -164,6 +174,12 @@ int8_t sn_nsdl_destroy(struct nsdl_s *handle)
         handle->sn_nsdl_free(handle->oma_bs_address_ptr);
     }
 
+    ns_list_foreach_safe(sn_nsdl_notification_s, notification, &handle->notification_list) {
+        ns_list_remove(&handle->notification_list, notification);
+        handle->sn_nsdl_free(notification->data_ptr);
+        handle->sn_nsdl_free(notification);
+    }
+
     /* Destroy also libCoap and grs part of libNsdl */
     sn_coap_protocol_destroy(handle->grs->coap);
     sn_grs_destroy(handle->grs);
@@ -535,14 +551,156 @@ uint16_t sn_nsdl_send_observation_notification_with_uri_path(struct nsdl_s *hand
         sn_coap_msg_type_e message_type, uint8_t content_format,
         uint8_t *uri_path_ptr, uint16_t uri_path_len)
 {
-    sn_coap_hdr_s   *notification_message_ptr;
-    uint16_t        return_msg_id = 0;
+    sn_nsdl_notification_s *notification;
+    uint16_t        return_msg_id;
 
     /* Check parameters */
     if (handle == NULL || handle->grs == NULL) {
         return 0;
     }
 
+    if (!handle->notification_pmin || token_len > sizeof(notification->token)) {
+        return sn_nsdl_send_notification(handle, 0, token_ptr, token_len, payload_ptr, payload_len, observe,
+                                         message_type, content_format, uri_path_ptr, uri_path_len);
+    }
+
+    /* Within the minimum period of the observation, replace what is held back for it */
+    notification = sn_nsdl_find_notification(handle, token_ptr, token_len);
+    if (notification &&
+            (notification->pending || handle->sn_nsdl_time - notification->sent_time < handle->notification_pmin)) {
+        return sn_nsdl_hold_notification(handle, notification, payload_ptr, payload_len, observe,
+                                         message_type, content_format, uri_path_ptr, uri_path_len);
+    }
+
+    return_msg_id = sn_nsdl_send_notification(handle, 0, token_ptr, token_len, payload_ptr, payload_len, observe,
+                                              message_type, content_format, uri_path_ptr, uri_path_len);
+    if (return_msg_id == 0) {
+        return 0;
+    }
+
+    /* Remember when the observation was notified. Without memory for it, the next notification is not held back. */
+    if (!notification) {
+        notification = handle->sn_nsdl_alloc(sizeof(sn_nsdl_notification_s));
+        if (!notification) {
+            return return_msg_id;
+        }
+        memset(notification, 0, sizeof(sn_nsdl_notification_s));
+        if (token_len) {
+            memcpy(notification->token, token_ptr, token_len);
+        }
+        notification->token_len = token_len;
+        ns_list_add_to_start(&handle->notification_list, notification);
+    }
+    notification->sent_time = handle->sn_nsdl_time;
+
+    return return_msg_id;
+}
+
+int8_t sn_nsdl_set_notification_pmin(struct nsdl_s *handle, uint32_t pmin)
+{
+    if (handle == NULL) {
+        return SN_NSDL_FAILURE;
+    }
+
+    handle->notification_pmin = pmin;
+
+    /* Without the period, send what was held back at once */
+    if (!pmin) {
+        sn_nsdl_flush_notifications(handle, true);
+    }
+
+    return SN_NSDL_SUCCESS;
+}
+
+static sn_nsdl_notification_s *sn_nsdl_find_notification(struct nsdl_s *handle, const uint8_t *token_ptr, uint8_t token_len)
+{
+    ns_list_foreach(sn_nsdl_notification_s, notification, &handle->notification_list) {
+        if (notification->token_len == token_len &&
+                (token_len == 0 || memcmp(notification->token, token_ptr, token_len) == 0)) {
+            return notification;
+        }
+    }
+    return NULL;
+}
+
+static uint16_t sn_nsdl_hold_notification(struct nsdl_s *handle, sn_nsdl_notification_s *notification,
+                                          uint8_t *payload_ptr, uint16_t payload_len, sn_coap_observe_e observe,
+                                          sn_coap_msg_type_e message_type, uint8_t content_format,
+                                          uint8_t *uri_path_ptr, uint16_t uri_path_len)
+{
+    uint8_t *data_ptr = NULL;
+
+    if (!sn_nsdl_check_uint_overflow(0, payload_len, uri_path_len)) {
+        return 0;
+    }
+
+    if (payload_len + uri_path_len) {
+        data_ptr = handle->sn_nsdl_alloc(payload_len + uri_path_len);
+        if (!data_ptr) {
+            return 0;
+        }
+        if (payload_len) {
+            memcpy(data_ptr, payload_ptr, payload_len);
+        }
+        if (uri_path_len) {
+            memcpy(data_ptr + payload_len, uri_path_ptr, uri_path_len);
+        }
+    }
+
+    /* The message ID is kept for the notifications it replaces, so that the one sent answers for them */
+    if (!notification->pending) {
+        notification->msg_id = sn_coap_protocol_allocate_message_id(handle->grs->coap);
+        notification->pending = true;
+    }
+
+    handle->sn_nsdl_free(notification->data_ptr);
+    notification->data_ptr = data_ptr;
+    notification->payload_len = payload_len;
+    notification->uri_path_len = uri_path_len;
+    notification->observe = observe;
+    notification->msg_type = message_type;
+    notification->content_format = content_format;
+
+    return notification->msg_id;
+}
+
+/* Sends the notifications held back whose minimum period has passed, or all of them, and forgets the
+ * observations not notified within the period */
+static void sn_nsdl_flush_notifications(struct nsdl_s *handle, bool all)
+{
+    ns_list_foreach_safe(sn_nsdl_notification_s, notification, &handle->notification_list) {
+        if (!all && handle->sn_nsdl_time - notification->sent_time < handle->notification_pmin) {
+            continue;
+        }
+
+        if (notification->pending) {
+            sn_nsdl_send_notification(handle, notification->msg_id, notification->token, notification->token_len,
+                                      notification->data_ptr, notification->payload_len, notification->observe,
+                                      (sn_coap_msg_type_e)notification->msg_type, notification->content_format,
+                                      notification->uri_path_len ? notification->data_ptr + notification->payload_len : NULL,
+                                      notification->uri_path_len);
+            handle->sn_nsdl_free(notification->data_ptr);
+            notification->data_ptr = NULL;
+            notification->pending = false;
+            notification->sent_time = handle->sn_nsdl_time;
+            if (!all) {
+                continue;
+            }
+        }
+
+        ns_list_remove(&handle->notification_list, notification);
+        handle->sn_nsdl_free(notification);
+    }
+}
+
+static uint16_t sn_nsdl_send_notification(struct nsdl_s *handle, uint16_t msg_id, uint8_t *token_ptr, uint8_t token_len,
+                                          uint8_t *payload_ptr, uint16_t payload_len, sn_coap_observe_e observe,
+                                          sn_coap_msg_type_e message_type, uint8_t content_format,
+                                          uint8_t *uri_path_ptr, uint16_t uri_path_len)
+{
+    sn_coap_hdr_s   *notification_message_ptr;
+    uint16_t        return_msg_id = 0;
+
     /* Allocate and initialize memory for header struct */
     notification_message_ptr = sn_coap_parser_alloc_message(handle->grs->coap);
     if (notification_message_ptr == NULL) {
@@ -557,6 +715,7 @@ uint16_t sn_nsdl_send_observation_notification_with_uri_path(struct nsdl_s *hand
     /* Fill header */
     notification_message_ptr->msg_type = message_type;
     notification_message_ptr->msg_code = COAP_MSG_CODE_RESPONSE_CONTENT;
+    notification_message_ptr->msg_id = msg_id;
 
     /* Fill token */
     notification_message_ptr->token_len = token_len;
@@ -898,7 +1057,8 @@ int8_t sn_nsdl_process_coap(struct nsdl_s *handle, uint8_t *packet_ptr, uint16_t
 #endif
     /* Check, if coap itself sends response, or block receiving is ongoing... */
     if (coap_packet_ptr->coap_status != COAP_STATUS_OK &&
-            coap_packet_ptr->coap_status != COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVED &&coap_packet_ptr &&
+            coap_packet_ptr->coap_status != COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVED &&
+            coap_packet_ptr->coap_status != COAP_STATUS_PARSER_BLOCKWISE_MSG_STREAMED && coap_packet_ptr &&
             !resource) {
         sn_coap_parser_release_allocated_coap_msg_mem(handle->grs->coap, coap_packet_ptr);
         return SN_NSDL_SUCCESS;
@@ -1020,6 +1180,11 @@ int8_t sn_nsdl_exec(struct nsdl_s *handle, uint32_t time)
     if(!handle || !handle->grs){
         return SN_NSDL_FAILURE;
     }
+    handle->sn_nsdl_time = time;
+    if (handle->notification_pmin) {
+        sn_nsdl_flush_notifications(handle, false);
+    }
+
     /* Call CoAP execution function */
     return sn_coap_protocol_exec(handle->grs->coap, time);
 }
@@ -1075,7 +1240,7 @@ static uint16_t sn_nsdl_internal_coap_send(struct nsdl_s *handle, sn_coap_hdr_s
 
     coap_header_len = coap_header_ptr->payload_len;
     /* Build message */
-    if (sn_coap_protocol_build(handle->grs->coap, dst_addr_ptr, coap_message_ptr, coap_header_ptr, (void *)handle) < 0) {
+    if (sn_coap_protocol_build_sized(handle->grs->coap, dst_addr_ptr, coap_message_ptr, coap_message_len, coap_header_ptr, (void *)handle) < 0) {
         handle->sn_nsdl_free(coap_message_ptr);
         return 0;
     }
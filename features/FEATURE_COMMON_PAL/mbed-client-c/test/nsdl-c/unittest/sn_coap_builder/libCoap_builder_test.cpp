@@ -148,6 +148,24 @@ TEST(libCoap_builder, build_message_ok_cases)
     CHECK(sn_coap_builder(buffer, &coap_header) == 11);
 }
 
+TEST(libCoap_builder, build_message_sized)
+{
+    uint8_t sized_buffer[356];
+
+    CHECK(sn_coap_builder_sized(NULL, 11, &coap_header) == -2);
+    CHECK(sn_coap_builder_sized(buffer, 11, NULL) == -2);
+    CHECK(sn_coap_builder_sized(buffer, 0, &coap_header) == -1);
+
+    coap_header.token_ptr = temp;
+    coap_header.token_len = 2;
+    coap_header.uri_path_ptr = temp;
+    coap_header.uri_path_len = 2;
+    uint16_t len = sn_coap_builder_calc_needed_packet_data_size_2(&coap_header, 0);
+    CHECK(sn_coap_builder_sized(sized_buffer, len, &coap_header) == len);
+    CHECK(sn_coap_builder_2(buffer, &coap_header, 0) == len);
+    CHECK(memcmp(buffer, sized_buffer, len) == 0);
+}
+
 TEST(libCoap_builder, build_message_options_token)
 {
     coap_header.token_ptr = temp;
@@ -980,3 +980,63 @@ bool test_sn_coap_parser_release_allocated_coap_msg_mem()
     return true; //this is a memory leak check, so that will pass/fail
 }
 
+
+bool test_sn_coap_parser_in_place()
+{
+    bool ret = true;
+    /* GET, token "tk", Uri-Path "a/bc", Uri-Query "x=1", payload "pl" */
+    uint8_t packet[] = {0x42, 0x01, 0x12, 0x34, 't', 'k',
+                        0xb1, 'a', 0x02, 'b', 'c', 0x43, 'x', '=', '1',
+                        0xff, 'p', 'l'};
+    struct coap_s* coap = (struct coap_s*)malloc(sizeof(struct coap_s));
+    coap->sn_coap_protocol_malloc = myMalloc;
+    coap->sn_coap_protocol_free = myFree;
+    coap_version_e ver;
+    sn_coap_parsed_msg_s storage;
+
+    if( sn_coap_parser_in_place(NULL, sizeof(packet), packet, &ver, &storage) ) {
+        ret = false;
+    }
+
+    retCounter = 0;
+    if( ret && sn_coap_parser_in_place(coap, sizeof(packet), packet, &ver, NULL) ) {
+        ret = false;
+    }
+
+    /* Nothing is allocated with a given storage */
+    sn_coap_hdr_s *hdr = NULL;
+    if( ret ) {
+        hdr = sn_coap_parser_in_place(coap, sizeof(packet), packet, &ver, &storage);
+    }
+    if( ret && (hdr != &storage.hdr || hdr->coap_status != COAP_STATUS_OK || hdr->msg_id != 0x1234) ) {
+        ret = false;
+    }
+    if( ret && (hdr->token_len != 2 || hdr->token_ptr != packet + 4) ) {
+        ret = false;
+    }
+    if( ret && (hdr->uri_path_len != 4 || memcmp(hdr->uri_path_ptr, "a/bc", 4)) ) {
+        ret = false;
+    }
+    if( ret && (hdr->options_list_ptr != &storage.options ||
+                hdr->options_list_ptr->uri_query_len != 3 ||
+                memcmp(hdr->options_list_ptr->uri_query_ptr, "x=1", 3)) ) {
+        ret = false;
+    }
+    if( ret && (hdr->payload_len != 2 || memcmp(hdr->payload_ptr, "pl", 2)) ) {
+        ret = false;
+    }
+
+    /* One block, released at once */
+    uint8_t packet2[] = {0x40, 0x01, 0x12, 0x34, 0xb1, 'a'};
+    retCounter = 1;
+    if( ret ) {
+        hdr = sn_coap_parser_in_place(coap, sizeof(packet2), packet2, &ver, NULL);
+        if( !hdr || hdr->coap_status != COAP_STATUS_OK || hdr->uri_path_ptr != packet2 + 5 ) {
+            ret = false;
+        }
+        sn_coap_parser_release_in_place_msg(coap, hdr);
+    }
+
+    free(coap);
+    return ret;
+}
@@ -123,6 +123,25 @@ TEST(libCoap_protocol, sn_coap_protocol_set_block_size)
     CHECK( -1 == sn_coap_protocol_set_block_size(coap_handle,1) );
 }
 
+int8_t null_block_stream_cb(sn_coap_hdr_s *a, uint32_t b, bool c, sn_nsdl_addr_s *d, void *e)
+{
+    return 0;
+}
+
+TEST(libCoap_protocol, sn_coap_protocol_set_block_stream)
+{
+#if SN_COAP_MAX_BLOCKWISE_PAYLOAD_SIZE
+    CHECK( -1 == sn_coap_protocol_set_block_stream(NULL, null_block_stream_cb, 2) );
+    CHECK( 0 == sn_coap_protocol_set_block_stream(coap_handle, null_block_stream_cb, 0) );
+    CHECK( 1 == coap_handle->sn_coap_block2_window );
+    CHECK( 0 == sn_coap_protocol_set_block_stream(coap_handle, null_block_stream_cb, 4) );
+    CHECK( 4 == coap_handle->sn_coap_block2_window );
+    CHECK( 0 == sn_coap_protocol_set_block_stream(coap_handle, NULL, 0) );
+#else
+    CHECK( -1 == sn_coap_protocol_set_block_stream(coap_handle, null_block_stream_cb, 2) );
+#endif
+}
+
 TEST(libCoap_protocol, sn_coap_protocol_set_duplicate_buffer_size)
 {
 #if SN_COAP_DUPLICATION_MAX_MSGS_COUNT
@@ -2258,3 +2277,74 @@ TEST(libCoap_protocol, sn_coap_protocol_block_remove)
     sn_coap_protocol_destroy(handle);
 }
 
+
+TEST(libCoap_protocol, sn_coap_protocol_acknowledgement_lookup)
+{
+#if ENABLE_RESENDINGS
+    retCounter = 20;
+    struct coap_s * handle = sn_coap_protocol_init(myMalloc, myFree, null_tx_cb, NULL);
+
+    uint8_t addr_a[4] = {10, 0, 0, 1};
+    uint8_t addr_b[4] = {10, 0, 0, 2};
+    sn_nsdl_addr_s dst_a;
+    sn_nsdl_addr_s dst_b;
+    memset(&dst_a, 0, sizeof(sn_nsdl_addr_s));
+    memset(&dst_b, 0, sizeof(sn_nsdl_addr_s));
+    dst_a.addr_ptr = addr_a;
+    dst_a.addr_len = 4;
+    dst_a.port = 5683;
+    dst_b.addr_ptr = addr_b;
+    dst_b.addr_len = 4;
+    dst_b.port = 5683;
+
+    sn_coap_hdr_s hdr;
+    memset(&hdr, 0, sizeof(sn_coap_hdr_s));
+    hdr.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+    hdr.msg_code = COAP_MSG_CODE_REQUEST_GET;
+    hdr.msg_id = 0x21;
+
+    /* Same message ID to two destinations */
+    uint8_t packet[4] = {0x40, 0x01, 0x00, 0x21};
+    sn_coap_builder_stub.expectedInt16 = 4;
+    CHECK( 0 < sn_coap_protocol_build(handle, &dst_a, packet, &hdr, NULL));
+    CHECK( 0 < sn_coap_protocol_build(handle, &dst_b, packet, &hdr, NULL));
+    CHECK( 2 == handle->count_resent_msgs );
+
+    uint8_t ack[4] = {0x60, 0x00, 0x00, 0x21};
+    sn_coap_header_check_stub.expectedInt8 = 0;
+
+    /* Acknowledgement of b only removes the message to b */
+    sn_coap_parser_stub.expectedHeader = (sn_coap_hdr_s *)malloc(sizeof(sn_coap_hdr_s));
+    memset(sn_coap_parser_stub.expectedHeader, 0, sizeof(sn_coap_hdr_s));
+    sn_coap_parser_stub.expectedHeader->msg_type = COAP_MSG_TYPE_ACKNOWLEDGEMENT;
+    sn_coap_parser_stub.expectedHeader->msg_id = 0x21;
+    sn_coap_hdr_s *ret = sn_coap_protocol_parse(handle, &dst_b, 4, ack, NULL);
+    CHECK( NULL != ret );
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, ret);
+    CHECK( 1 == handle->count_resent_msgs );
+
+    /* Other port, no match */
+    dst_a.port = 5684;
+    sn_coap_parser_stub.expectedHeader = (sn_coap_hdr_s *)malloc(sizeof(sn_coap_hdr_s));
+    memset(sn_coap_parser_stub.expectedHeader, 0, sizeof(sn_coap_hdr_s));
+    sn_coap_parser_stub.expectedHeader->msg_type = COAP_MSG_TYPE_ACKNOWLEDGEMENT;
+    sn_coap_parser_stub.expectedHeader->msg_id = 0x21;
+    ret = sn_coap_protocol_parse(handle, &dst_a, 4, ack, NULL);
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, ret);
+    CHECK( 1 == handle->count_resent_msgs );
+
+    dst_a.port = 5683;
+    sn_coap_parser_stub.expectedHeader = (sn_coap_hdr_s *)malloc(sizeof(sn_coap_hdr_s));
+    memset(sn_coap_parser_stub.expectedHeader, 0, sizeof(sn_coap_hdr_s));
+    sn_coap_parser_stub.expectedHeader->msg_type = COAP_MSG_TYPE_ACKNOWLEDGEMENT;
+    sn_coap_parser_stub.expectedHeader->msg_id = 0x21;
+    ret = sn_coap_protocol_parse(handle, &dst_a, 4, ack, NULL);
+    sn_coap_parser_release_allocated_coap_msg_mem(handle, ret);
+    CHECK( 0 == handle->count_resent_msgs );
+    CHECK( 0 == handle->size_resent_msgs );
+
+    sn_coap_builder_stub.expectedInt16 = 0;
+    retCounter = 0;
+    sn_coap_protocol_destroy(handle);
+#endif
+}
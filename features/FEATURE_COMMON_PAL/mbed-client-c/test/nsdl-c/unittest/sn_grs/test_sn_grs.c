@@ -60,8 +60,7 @@ bool test_sn_grs_destroy()
 
     sn_nsdl_resource_info_s* res = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
     memset(res, 0, sizeof(sn_nsdl_resource_info_s));
-    ns_list_add_to_start(&handle->resource_root_list, res);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res);
 
     if( SN_NSDL_SUCCESS != sn_grs_destroy(handle)){
         return false;
@@ -146,14 +145,12 @@ bool test_sn_grs_list_resource()
     memset(res, 0, sizeof(sn_nsdl_resource_info_s));
     res->path = (uint8_t*)malloc(5);
     res->pathlen = 5;
-    ns_list_add_to_start(&handle->resource_root_list, res);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res);
     sn_nsdl_resource_info_s* res2 = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
     memset(res2, 0, sizeof(sn_nsdl_resource_info_s));
     res2->path = (uint8_t*)malloc(4);
     res2->pathlen = 4;
-    ns_list_add_to_start(&handle->resource_root_list, res2);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res2);
     retCounter = 2;
     if( NULL != sn_grs_list_resource(handle, 5, path) ){
         return false;
@@ -205,8 +202,7 @@ bool test_sn_grs_get_first_resource()
 
     sn_nsdl_resource_info_s* res = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
     memset(res, 0, sizeof(sn_nsdl_resource_info_s));
-    ns_list_add_to_start(&handle->resource_root_list, res);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res);
 
     if( NULL == sn_grs_get_first_resource(handle) ){
         return false;
@@ -229,12 +225,10 @@ bool test_sn_grs_get_next_resource()
 
     sn_nsdl_resource_info_s* res = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
     memset(res, 0, sizeof(sn_nsdl_resource_info_s));
-    ns_list_add_to_start(&handle->resource_root_list, res);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res);
     sn_nsdl_resource_info_s* res2 = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
     memset(res2, 0, sizeof(sn_nsdl_resource_info_s));
-    ns_list_add_to_start(&handle->resource_root_list, res2);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res2);
 
     if( NULL != sn_grs_get_next_resource(handle, NULL) ){
         return false;
@@ -265,8 +259,7 @@ bool test_sn_grs_delete_resource()
     res->pathlen = 1;
     res->path[0] = 'a';
     res->path[1] = '\0';
-    ns_list_add_to_start(&handle->resource_root_list, res);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res);
 
     sn_nsdl_resource_info_s* res2 = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
     memset(res2, 0, sizeof(sn_nsdl_resource_info_s));
@@ -276,8 +269,7 @@ bool test_sn_grs_delete_resource()
     res2->path[1] = '/';
     res2->path[2] = '1';
     res2->path[3] = '\0';
-    ns_list_add_to_start(&handle->resource_root_list, res2);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res2);
 
     uint8_t path[2] = {'a', '\0'};
     if( SN_NSDL_SUCCESS != sn_grs_delete_resource(handle, 1, &path) ){
@@ -294,8 +286,7 @@ bool test_sn_grs_delete_resource()
     res3->pathlen = 1;
     res3->path[0] = 'a';
     res3->path[1] = '\0';
-    ns_list_add_to_start(&handle->resource_root_list, res3);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res3);
 
     /* a/1 */
     sn_nsdl_resource_info_s* res4 = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
@@ -306,8 +297,7 @@ bool test_sn_grs_delete_resource()
     res4->path[1] = '/';
     res4->path[2] = '1';
     res4->path[3] = '\0';
-    ns_list_add_to_start(&handle->resource_root_list, res4);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res4);
 
     /* a/1/0 */
     sn_nsdl_resource_info_s* res5 = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
@@ -320,8 +310,7 @@ bool test_sn_grs_delete_resource()
     res5->path[3] = '/';
     res5->path[4] = '0';
     res5->path[5] = '\0';
-    ns_list_add_to_start(&handle->resource_root_list, res5);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res5);
 
     /* a/10 */
     sn_nsdl_resource_info_s* res6 = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
@@ -333,8 +322,7 @@ bool test_sn_grs_delete_resource()
     res6->path[2] = '1';
     res6->path[3] = '0';
     res6->path[4] = '\0';
-    ns_list_add_to_start(&handle->resource_root_list, res6);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res6);
 
 
     /* a/10/0 */
@@ -349,8 +337,7 @@ bool test_sn_grs_delete_resource()
     res7->path[4] = '/';
     res7->path[5] = '0';
     res7->path[6] = '\0';
-    ns_list_add_to_start(&handle->resource_root_list, res7);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res7);
 
     uint8_t path2[4] = {'a', '/', '1', '\0'};
     if( SN_NSDL_SUCCESS != sn_grs_delete_resource(handle, 3, &path2) ){
@@ -402,16 +389,14 @@ bool test_sn_grs_update_resource()
     res->path[1] = '\0';
     res->resource = (uint8_t*)malloc(2);
     res->resourcelen = 2;
-    ns_list_add_to_start(&handle->resource_root_list, res);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res);
     sn_nsdl_resource_info_s* res2 = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
     memset(res2, 0, sizeof(sn_nsdl_resource_info_s));
     res2->path = (uint8_t*)malloc(2);
     res2->pathlen = 1;
     res2->path[0] = 'b';
     res2->path[1] = '\0';
-    ns_list_add_to_start(&handle->resource_root_list, res2);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res2);
 
     sn_nsdl_resource_info_s* res3 = (sn_nsdl_resource_info_s*)malloc(sizeof(sn_nsdl_resource_info_s));
     memset(res3, 0, sizeof(sn_nsdl_resource_info_s));
@@ -516,7 +501,7 @@ bool test_sn_grs_create_resource()
         return false;
     }
 
-    ns_list_add_to_start(&handle->resource_root_list, res);
+    sn_grs_insert_resource(handle, res);
     sn_grs_destroy(handle);
     return true;
 }
@@ -679,8 +664,7 @@ bool test_sn_grs_process_coap()
     res->sn_grs_dyn_res_callback = &myResCallback;
     res->resource_parameters_ptr = (sn_nsdl_resource_parameters_s*)malloc(sizeof(sn_nsdl_resource_parameters_s));
     memset(res->resource_parameters_ptr, 0, sizeof(sn_nsdl_resource_parameters_s));
-    ns_list_add_to_start(&handle->grs->resource_root_list, res);
-    ++handle->grs->resource_root_count;
+    sn_grs_insert_resource(handle->grs, res);
 
     hdr = (sn_coap_hdr_s*)malloc(sizeof(sn_coap_hdr_s));
     memset(hdr, 0, sizeof(sn_coap_hdr_s));
@@ -989,8 +973,7 @@ bool test_sn_grs_process_coap()
     res->access = SN_GRS_GET_ALLOWED;
     memset(res->resource_parameters_ptr, 0, sizeof(sn_nsdl_resource_parameters_s));
     res->resource_parameters_ptr->coap_content_type = 1;
-    ns_list_add_to_start(&handle->grs->resource_root_list, res);
-    ++handle->grs->resource_root_count;
+    sn_grs_insert_resource(handle->grs, res);
 
     hdr = (sn_coap_hdr_s*)malloc(sizeof(sn_coap_hdr_s));
     memset(hdr, 0, sizeof(sn_coap_hdr_s));
@@ -1169,8 +1152,7 @@ bool test_sn_grs_search_resource()
     res->path[1] = 'b';
     res->path[2] = 'c';
     res->pathlen = 3;
-    ns_list_add_to_start(&handle->resource_root_list, res);
-    ++handle->resource_root_count;
+    sn_grs_insert_resource(handle, res);
 
     if( NULL == sn_grs_search_resource(handle, 5, path, SN_GRS_SEARCH_METHOD) ){
         return false;
@@ -1210,8 +1192,7 @@ bool test_sn_grs_mark_resources_as_registered()
     res->resource_parameters_ptr = (sn_nsdl_resource_parameters_s*)malloc(sizeof(sn_nsdl_resource_parameters_s));
     memset(res->resource_parameters_ptr, 0, sizeof(sn_nsdl_resource_parameters_s));
     res->resource_parameters_ptr->registered = SN_NDSL_RESOURCE_REGISTERING;
-    ns_list_add_to_start(&handle->grs->resource_root_list, res);
-    ++handle->grs->resource_root_count;
+    sn_grs_insert_resource(handle->grs, res);
 
     sn_grs_mark_resources_as_registered(handle);
     if( SN_NDSL_RESOURCE_REGISTERED != res->resource_parameters_ptr->registered ){
@@ -1106,6 +1106,76 @@ bool test_sn_nsdl_send_observation_notification_with_uri_path()
     return true;
 }
 
+bool test_sn_nsdl_set_notification_pmin()
+{
+    if( SN_NSDL_FAILURE != sn_nsdl_set_notification_pmin(NULL, 5) ){
+        return false;
+    }
+    sn_grs_stub.retNull = false;
+    sn_grs_stub.expectedInt8 = SN_NSDL_SUCCESS;
+    retCounter = 4;
+    sn_grs_stub.expectedGrs = (struct grs_s *)malloc(sizeof(struct grs_s));
+    memset(sn_grs_stub.expectedGrs,0, sizeof(struct grs_s));
+    struct nsdl_s* handle = sn_nsdl_init(&nsdl_tx_callback, &nsdl_rx_callback, &myMalloc, &myFree);
+    sn_grs_stub.expectedGrs->coap = (struct coap_s *)malloc(sizeof(struct coap_s));
+    sn_grs_stub.expectedGrs->coap->sn_coap_protocol_free = myFree;
+    sn_grs_stub.expectedGrs->coap->sn_coap_protocol_malloc = myMalloc;
+
+    if( SN_NSDL_SUCCESS != sn_nsdl_set_notification_pmin(handle, 5) ){
+        return false;
+    }
+
+    /* Observation notified at 0 */
+    uint8_t token[] = {1, 2};
+    sn_nsdl_notification_s *notification = (sn_nsdl_notification_s*)malloc(sizeof(sn_nsdl_notification_s));
+    memset(notification, 0, sizeof(sn_nsdl_notification_s));
+    memcpy(notification->token, token, sizeof(token));
+    notification->token_len = sizeof(token);
+    ns_list_add_to_start(&handle->notification_list, notification);
+
+    /* Held back, and replaced keeping the message ID */
+    uint8_t payload[] = {"12"};
+    sn_coap_protocol_stub.expectedUint16 = 7;
+    retCounter = 1;
+    if( 7 != sn_nsdl_send_observation_notification(handle, token, sizeof(token), payload, 2, 1, COAP_MSG_TYPE_NON_CONFIRMABLE, 0) ){
+        return false;
+    }
+    sn_coap_protocol_stub.expectedUint16 = 8;
+    retCounter = 1;
+    if( 7 != sn_nsdl_send_observation_notification(handle, token, sizeof(token), payload, 1, 2, COAP_MSG_TYPE_NON_CONFIRMABLE, 0) ){
+        return false;
+    }
+    if( !notification->pending || notification->payload_len != 1 || notification->observe != 2 ){
+        return false;
+    }
+
+    retCounter = 0;
+    if( 0 != sn_nsdl_send_observation_notification(handle, token, sizeof(token), payload, 1, 3, COAP_MSG_TYPE_NON_CONFIRMABLE, 0) ){
+        return false;
+    }
+
+    sn_nsdl_exec(handle, 4);
+    if( !notification->pending ){
+        return false;
+    }
+
+    retCounter = 2;
+    sn_nsdl_exec(handle, 5);
+    if( notification->pending || notification->sent_time != 5 ){
+        return false;
+    }
+
+    /* Forgotten once the period has passed */
+    sn_nsdl_exec(handle, 10);
+    if( !ns_list_is_empty(&handle->notification_list) ){
+        return false;
+    }
+
+    free(sn_grs_stub.expectedGrs->coap);
+    sn_nsdl_destroy(handle);
+    return true;
+}
+
 bool test_sn_nsdl_oma_bootstrap()
 {
     if( 0 != sn_nsdl_oma_bootstrap(NULL, NULL, NULL, NULL)){
@@ -30,6 +30,8 @@ bool test_sn_nsdl_send_observation_notification();
 
 bool test_sn_nsdl_send_observation_notification_with_uri_path();
 
+bool test_sn_nsdl_set_notification_pmin();
+
 bool test_sn_nsdl_oma_bootstrap();
 
 bool test_sn_nsdl_get_certificates();
@@ -44,6 +44,11 @@ int16_t sn_coap_builder_2(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_
     return sn_coap_builder_stub.expectedInt16;
 }
 
+int16_t sn_coap_builder_sized(uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_len, sn_coap_hdr_s *src_coap_msg_ptr)
+{
+    return sn_coap_builder_stub.expectedInt16;
+}
+
 int16_t sn_coap_builder(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr)
 {
     return sn_coap_builder_stub.expectedInt16;
@@ -81,6 +81,16 @@ void sn_coap_parser_release_allocated_coap_msg_mem(struct coap_s *handle, sn_coa
     }
 }
 
+sn_coap_hdr_s *sn_coap_parser_in_place(struct coap_s *handle, uint16_t packet_data_len, uint8_t *packet_data_ptr, coap_version_e *coap_version_ptr, sn_coap_parsed_msg_s *msg_storage_ptr)
+{
+    return sn_coap_parser_stub.expectedHeader;
+}
+
+void sn_coap_parser_release_in_place_msg(struct coap_s *handle, sn_coap_hdr_s *freed_coap_msg_ptr)
+{
+    free(freed_coap_msg_ptr);
+}
+
 sn_coap_hdr_s *sn_coap_parser_init_message(sn_coap_hdr_s *coap_msg_ptr)
 {
     /* * * * Check given pointer * * * */
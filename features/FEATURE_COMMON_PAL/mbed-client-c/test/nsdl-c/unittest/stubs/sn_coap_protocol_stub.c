@@ -83,17 +83,34 @@ void sn_coap_protocol_clear_retransmission_buffer(struct coap_s *handle)
 {
 }
 
+uint16_t sn_coap_protocol_allocate_message_id(struct coap_s *handle)
+{
+    return sn_coap_protocol_stub.expectedUint16;
+}
+
 int8_t prepare_blockwise_message(struct coap_s *handle, sn_coap_hdr_s *src_coap_msg_ptr)
 {
     return sn_coap_protocol_stub.expectedInt8;
 }
 
+int8_t sn_coap_protocol_set_block_stream(struct coap_s *handle,
+        int8_t (*block_stream_callback)(sn_coap_hdr_s *, uint32_t, bool, sn_nsdl_addr_s *, void *), uint8_t block2_window)
+{
+    return sn_coap_protocol_stub.expectedInt8;
+}
+
 int16_t sn_coap_protocol_build(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr,
                                uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
 {
     return sn_coap_protocol_stub.expectedInt16;
 }
 
+int16_t sn_coap_protocol_build_sized(struct coap_s *handle, sn_nsdl_addr_s *dst_addr_ptr,
+                                     uint8_t *dst_packet_data_ptr, uint16_t dst_packet_data_len, sn_coap_hdr_s *src_coap_msg_ptr, void *param)
+{
+    return sn_coap_protocol_stub.expectedInt16;
+}
+
 sn_coap_hdr_s *sn_coap_protocol_parse(struct coap_s *handle, sn_nsdl_addr_s *src_addr_ptr, uint16_t packet_data_len, uint8_t *packet_data_ptr, void *param)
 {
     return sn_coap_protocol_stub.expectedHeader;
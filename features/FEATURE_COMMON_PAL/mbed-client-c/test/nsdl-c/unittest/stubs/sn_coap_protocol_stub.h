@@ -23,6 +23,7 @@
 typedef struct {
     int8_t expectedInt8;
     int16_t expectedInt16;
+    uint16_t expectedUint16;
     struct coap_s *expectedCoap;
     sn_coap_hdr_s *expectedHeader;
     coap_send_msg_s *expectedSendMsg;
@@ -178,3 +178,11 @@ void sn_grs_mark_resources_as_registered(struct nsdl_s *handle)
 {
 }
 
+
+void sn_grs_insert_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res)
+{
+}
+
+void sn_grs_remove_resource(struct grs_s *handle, sn_nsdl_resource_info_s *res)
+{
+}
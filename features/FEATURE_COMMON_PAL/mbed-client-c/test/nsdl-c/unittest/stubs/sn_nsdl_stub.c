@@ -101,6 +101,11 @@ uint16_t sn_nsdl_send_observation_notification_with_uri_path(struct nsdl_s *hand
     return sn_nsdl_stub.expectedUint16;
 }
 
+int8_t sn_nsdl_set_notification_pmin(struct nsdl_s *handle, uint32_t pmin)
+{
+    return sn_nsdl_stub.expectedInt8;
+}
+
 uint16_t sn_nsdl_send_observation_notification(struct nsdl_s *handle, uint8_t *token_ptr, uint8_t token_len,
         uint8_t *payload_ptr, uint16_t payload_len,
         sn_coap_observe_e observe,
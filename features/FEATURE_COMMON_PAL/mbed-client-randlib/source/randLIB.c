@@ -14,16 +14,10 @@
  * limitations under the License.
  */
 #include <stdint.h>
-#include <stdlib.h>
 #include <stdbool.h>
-#include <limits.h>
 #include "randLIB.h"
 #include "platform/arm_hal_random.h"
 
-#if ((RAND_MAX+1) & RAND_MAX) != 0
-#error "RAND_MAX isn't 2^n-1 :("
-#endif
-
 /**
  * This library is made for getting random numbers for Timing needs in protocols.
  *
@@ -31,6 +25,46 @@
  *
  */
 
+/* xoshiro128** (Blackman & Vigna) - 128 bits of state, one 32-bit output
+ * per step for a few shifts, rotates and two multiplies by constants. It has
+ * its own state, so it neither disturbs nor is disturbed by the application's
+ * use of rand(), and never goes through the C library's reentrancy support.
+ *
+ * The state must never be all zero; it starts from a fixed non-zero value,
+ * giving a repeatable sequence if randLIB_seed_random() is never called.
+ */
+static uint32_t state[4] = { 0x9E3779B9, 0x243F6A88, 0xB7E15162, 0x6A09E667 };
+
+static inline uint32_t rol32(uint32_t x, unsigned k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+static uint32_t xoshiro128starstar(void)
+{
+    const uint32_t result = rol32(state[1] * 5, 7) * 9;
+    const uint32_t t = state[1] << 9;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rol32(state[3], 11);
+
+    return result;
+}
+
+/* Mix a 32-bit value (the finaliser of Murmur3 with a Weyl increment), so
+ * that seeds differing in a few bits give unrelated states, and no seed gives
+ * an all-zero one. */
+static uint32_t seed_mix(uint32_t *x)
+{
+    uint32_t z = (*x += 0x9E3779B9);
+    z = (z ^ (z >> 16)) * 0x85EBCA6B;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35;
+    return z ^ (z >> 16);
+}
 
 /**
   * \brief Init seed for Pseudo Random.
@@ -43,7 +77,13 @@ void randLIB_seed_random(void)
     uint32_t rand_seed;
     arm_random_module_init();
     rand_seed = arm_random_seed_get();
-    srand(rand_seed);
+    for (int i = 0; i < 4; i++) {
+        state[i] = seed_mix(&rand_seed);
+    }
+    /* Should be impossible, but guard the one state xoshiro can't leave */
+    if (!(state[0] | state[1] | state[2] | state[3])) {
+        state[0] = 1;
+    }
 }
 
 /**
@@ -55,7 +95,7 @@ void randLIB_seed_random(void)
   */
 uint8_t randLIB_get_8bit(void)
 {
-    return rand();
+    return xoshiro128starstar() >> 24;
 }
 
 /**
@@ -67,14 +107,7 @@ uint8_t randLIB_get_8bit(void)
   */
 uint16_t randLIB_get_16bit(void)
 {
-    uint16_t ret_val;
-
-    ret_val = rand();
-#if RAND_MAX == 0x7FFF
-    ret_val |= (uint16_t) rand() << 15;
-#endif
-
-    return ret_val;
+    return xoshiro128starstar() >> 16;
 }
 /**
   * \brief Generate 32-bit random number.
@@ -85,21 +118,7 @@ uint16_t randLIB_get_16bit(void)
   */
 uint32_t randLIB_get_32bit(void)
 {
-    uint32_t ret_val;
-
-    ret_val = rand();
-#if RAND_MAX == 0x7FFF
-    ret_val |= (uint32_t) rand() << 15;
-    ret_val |= (uint32_t) rand() << 30;
-#elif RAND_MAX == 0x3FFFFFFF /* IAR */
-    ret_val |= (uint32_t) rand() << 30;
-#elif RAND_MAX == 0x7FFFFFFF
-    ret_val |= (uint32_t) rand() << 31;
-#else
-#error "randLIB_get_32bit - odd RAND_MAX"
-#endif
-
-    return ret_val;
+    return xoshiro128starstar();
 }
 
 
@@ -118,9 +137,22 @@ int8_t randLIB_get_n_bytes_random(uint8_t *data_ptr, uint8_t eight_bit_boundary)
         return -1;
     }
 
-    while (eight_bit_boundary) {
-        *data_ptr++ = randLIB_get_8bit();
-        eight_bit_boundary--;
+    /* One generator step per 4 bytes; stored bytewise as data_ptr needn't be
+     * aligned */
+    while (eight_bit_boundary >= 4) {
+        uint32_t r = xoshiro128starstar();
+        *data_ptr++ = r >> 24;
+        *data_ptr++ = r >> 16;
+        *data_ptr++ = r >> 8;
+        *data_ptr++ = r;
+        eight_bit_boundary -= 4;
+    }
+    if (eight_bit_boundary) {
+        uint32_t r = xoshiro128starstar();
+        while (eight_bit_boundary--) {
+            *data_ptr++ = r >> 24;
+            r <<= 8;
+        }
     }
     return 0;
 }
@@ -146,44 +178,30 @@ uint16_t randLIB_get_random_in_range(uint16_t min, uint16_t max)
         return randLIB_get_16bit();
     }
 
-    /* We get RAND_MAX+1 values from rand() in the range [0..RAND_MAX], and
-     * need to divvy them up into the number of values we need. And reroll any
-     * odd values off the end as we insist every value having equal chance.
+    /* We get 2^32 values from the generator in the range [0..0xFFFFFFFF],
+     * and need to divvy them up into the number of values we need. And reroll
+     * any odd values off the end as we insist every value having equal chance.
      *
-     * Special handling for systems where RAND_MAX is 0x7FFF; we use our
-     * randLIB_get_16bit() and have to be a bit more careful about
-     * unsigned integer overflow. (On other systems rand() returns int,
-     * so we can't overflow if we use unsigned int).
+     * To stay in 32-bit arithmetic the bands are sized from 0xFFFFFFFF rather
+     * than 2^32; that only fractionally increases the reroll chance.
      *
-     * Eg, range(1,3), RAND_MAX = 0x7FFFFFFF:
-     * We have 3 bands of size 0x2AAAAAAA (0x80000000/3).
+     * Eg, range(1,3):
+     * We have 3 bands of size 0x55555555 (0xFFFFFFFF/3).
      *
-     * We roll: 0x00000000..0x2AAAAAAA9 -> 1
-     *          0x2AAAAAAA..0x555555553 -> 2
-     *          0x55555554..0x7FFFFFFFD -> 3
-     *          0x7FFFFFFE..0x7FFFFFFFF -> reroll
+     * We roll: 0x00000000..0x55555554 -> 1
+     *          0x55555555..0xAAAAAAA9 -> 2
+     *          0xAAAAAAAA..0xFFFFFFFE -> 3
+     *          0xFFFFFFFF             -> reroll
      *
-     * (Bias problem clearly pretty insignificant there, but gets worse as
-     * range increases).
+     * (Bias problem clearly pretty insignificant there, and at most 1 in
+     * 65536 rerolls for any 16-bit range).
      */
-    unsigned int values_needed = max + 1 - min;
-#if RAND_MAX > 0xFFFF
-    unsigned int band_size = (RAND_MAX + 1u) / values_needed;
-#elif UINT_MAX > 0xFFFF
-    unsigned int band_size = 0x10000u / values_needed;
-#else
-    /* Avoid the need for long division, at the expense of fractionally
-     * increasing reroll chance. */
-    unsigned int band_size = 0xFFFFu / values_needed;
-#endif
-    unsigned int top_of_bands = band_size * values_needed;
-    unsigned int result;
+    uint32_t values_needed = (uint32_t) max + 1 - min;
+    uint32_t band_size = UINT32_MAX / values_needed;
+    uint32_t top_of_bands = band_size * values_needed;
+    uint32_t result;
     do {
-#if RAND_MAX > 0xFFFF
-        result = rand();
-#else
-        result = randLIB_get_16bit();
-#endif
+        result = xoshiro128starstar();
     } while (result >= top_of_bands);
 
     return min + (uint16_t)(result / band_size);
@@ -63,6 +63,26 @@ bool test_randLIB_get_n_bytes_random()
     if( ret != 0){
         return false;
     }
+
+    /* Bytes come from the same 32-bit outputs as randLIB_get_32bit(), most
+     * significant first, and a trailing part word takes a whole output */
+    uint8_t bytes[7];
+    randLIB_seed_random();
+    randLIB_get_n_bytes_random(bytes, 7);
+    randLIB_get_n_bytes_random(bytes + 4, 1);
+    randLIB_seed_random();
+    uint32_t first = randLIB_get_32bit();
+    uint32_t second = randLIB_get_32bit();
+    uint32_t third = randLIB_get_32bit();
+    if( bytes[0] != (uint8_t)(first >> 24) || bytes[3] != (uint8_t)first ){
+        return false;
+    }
+    if( bytes[5] != (uint8_t)(second >> 16) || bytes[6] != (uint8_t)(second >> 8) ){
+        return false;
+    }
+    if( bytes[4] != (uint8_t)(third >> 24) ){
+        return false;
+    }
     return true;
 }
 
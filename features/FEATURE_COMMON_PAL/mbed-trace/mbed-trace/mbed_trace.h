@@ -110,13 +110,37 @@ extern "C" {
 /** special level for cmdline. Behaviours like "plain mode" */
 #define TRACE_LEVEL_CMD           0x01
 
+/**
+ * Most verbose trace level compiled in. The tr_* calls of the more verbose
+ * levels compile to nothing and their arguments are not evaluated.
+ * Set it for the build with mbed-trace.max-level or YOTTA_CFG_MBED_TRACE_MAX_LEVEL,
+ * e.g. to TRACE_LEVEL_INFO, and for one trace group by defining TRACE_MAX_LEVEL
+ * like TRACE_GROUP, before including this header.
+ */
+#ifndef MBED_TRACE_MAX_LEVEL
+#if defined(MBED_CONF_MBED_TRACE_MAX_LEVEL)
+#define MBED_TRACE_MAX_LEVEL      MBED_CONF_MBED_TRACE_MAX_LEVEL
+#elif defined(YOTTA_CFG_MBED_TRACE_MAX_LEVEL)
+#define MBED_TRACE_MAX_LEVEL      YOTTA_CFG_MBED_TRACE_MAX_LEVEL
+#else
+#define MBED_TRACE_MAX_LEVEL      TRACE_LEVEL_DEBUG
+#endif
+#endif
+#ifndef TRACE_MAX_LEVEL
+#define TRACE_MAX_LEVEL           MBED_TRACE_MAX_LEVEL
+#endif
+
+/** mbed_tracef() if dlevel is compiled in, see TRACE_MAX_LEVEL */
+#define MBED_TRACE_AT_LEVEL(dlevel, ...) \
+    ((dlevel) <= (TRACE_MAX_LEVEL) ? mbed_tracef(dlevel, TRACE_GROUP, __VA_ARGS__) : (void) 0)
+
 //usage macros:
-#define tr_info(...)            mbed_tracef(TRACE_LEVEL_INFO,    TRACE_GROUP, __VA_ARGS__)   //!< Print info message
-#define tr_debug(...)           mbed_tracef(TRACE_LEVEL_DEBUG,   TRACE_GROUP, __VA_ARGS__)   //!< Print debug message
-#define tr_warning(...)         mbed_tracef(TRACE_LEVEL_WARN,    TRACE_GROUP, __VA_ARGS__)   //!< Print warning message
-#define tr_warn(...)            mbed_tracef(TRACE_LEVEL_WARN,    TRACE_GROUP, __VA_ARGS__)   //!< Alternative warning message
-#define tr_error(...)           mbed_tracef(TRACE_LEVEL_ERROR,   TRACE_GROUP, __VA_ARGS__)   //!< Print Error Message
-#define tr_err(...)             mbed_tracef(TRACE_LEVEL_ERROR,   TRACE_GROUP, __VA_ARGS__)   //!< Alternative error message
+#define tr_info(...)            MBED_TRACE_AT_LEVEL(TRACE_LEVEL_INFO,    __VA_ARGS__)   //!< Print info message
+#define tr_debug(...)           MBED_TRACE_AT_LEVEL(TRACE_LEVEL_DEBUG,   __VA_ARGS__)   //!< Print debug message
+#define tr_warning(...)         MBED_TRACE_AT_LEVEL(TRACE_LEVEL_WARN,    __VA_ARGS__)   //!< Print warning message
+#define tr_warn(...)            MBED_TRACE_AT_LEVEL(TRACE_LEVEL_WARN,    __VA_ARGS__)   //!< Alternative warning message
+#define tr_error(...)           MBED_TRACE_AT_LEVEL(TRACE_LEVEL_ERROR,   __VA_ARGS__)   //!< Print Error Message
+#define tr_err(...)             MBED_TRACE_AT_LEVEL(TRACE_LEVEL_ERROR,   __VA_ARGS__)   //!< Alternative error message
 #define tr_cmdline(...)         mbed_tracef(TRACE_LEVEL_CMD,     TRACE_GROUP, __VA_ARGS__)   //!< Special print for cmdline. See more from TRACE_LEVEL_CMD -level
 
 //aliases for the most commonly used functions and the helper functions
@@ -331,6 +355,32 @@ char* mbed_trace_ipv6_prefix(const uint8_t *prefix, uint8_t prefix_len);
  * which indicate that buffer is too small for array.
  */
 char* mbed_trace_array(const uint8_t* buf, uint16_t len);
+/**
+ * Queue the trace lines in a ring buffer instead of printing them
+ * The lines are still formatted by the trace calls, under the mutex if set,
+ * then copied to the ring. mbed_trace_ring_flush() prints them later with the
+ * print function, without taking the mutex, so it must be called from one
+ * thread only. Lines that do not fit in the ring are dropped, and counted in
+ * a line of their own. tr_cmdline() lines are printed right away with the
+ * cmdprint function, when one is set.
+ *
+ * @param buffer    ring buffer, NULL to print the lines right away again
+ * @param size      size of the buffer in bytes, a power of two
+ * @return 0 when success, -1 if size is not a power of two
+ */
+int mbed_trace_ring_set(char *buffer, size_t size);
+/**
+ * Print the trace lines queued in the ring buffer
+ * @return number of bytes of the lines printed
+ */
+size_t mbed_trace_ring_flush(void);
+/**
+ * Queue the trace lines in a ring buffer of MBED_CONF_MBED_TRACE_RING_SIZE bytes,
+ * flushed by a low priority thread every MBED_CONF_MBED_TRACE_RING_PERIOD ms.
+ * mbed OS with the RTOS only.
+ * @return 0 when success, otherwise non zero
+ */
+int mbed_trace_ring_start(void);
 
 #ifdef __cplusplus
 }
@@ -366,6 +416,9 @@ char* mbed_trace_array(const uint8_t* buf, uint16_t len);
 #undef mbed_trace_include_filters_get
 #undef mbed_tracef
 #undef mbed_vtracef
+#undef mbed_trace_ring_set
+#undef mbed_trace_ring_flush
+#undef mbed_trace_ring_start
 #undef mbed_trace_last
 #undef mbed_trace_ipv6
 #undef mbed_trace_ipv6_prefix
@@ -392,6 +445,9 @@ char* mbed_trace_array(const uint8_t* buf, uint16_t len);
 #define mbed_trace_last(...)                        ((const char *) 0)
 #define mbed_tracef(...)                            ((void) 0)
 #define mbed_vtracef(...)                           ((void) 0)
+#define mbed_trace_ring_set(...)                    ((int) 0)
+#define mbed_trace_ring_flush(...)                  ((size_t) 0)
+#define mbed_trace_ring_start(...)                  ((int) 0)
 /**
  * These helper functions accumulate strings in a buffer that is only flushed by actual trace calls. Using these
  * functions outside trace calls could cause the buffer to overflow.
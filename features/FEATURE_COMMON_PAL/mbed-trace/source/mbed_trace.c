@@ -23,6 +23,9 @@
 #endif
 
 #include "mbed-trace/mbed_trace.h"
+#if defined(MBED_CONF_PLATFORM_BINLOG_TRACE) && MBED_CONF_PLATFORM_BINLOG_TRACE
+#include "platform/mbed_binlog.h"
+#endif
 #if YOTTA_CFG_MBED_TRACE_FEA_IPV6 == 1
 #include "mbed-client-libservice/ip6string.h"
 #include "mbed-client-libservice/common_functions.h"
@@ -69,11 +72,21 @@
 #endif
 /** default max filters (include/exclude) length in bytes */
 #define DEFAULT_TRACE_FILTER_LENGTH       24
+/** marks the unused end of the ring buffer, a line does not wrap around */
+#define TRACE_RING_SKIP                   0xFF
+
+/** orders the copy of a line and the move of a ring position */
+#if defined(__GNUC__) || defined(__CC_ARM)
+#define TRACE_RING_BARRIER()              __sync_synchronize()
+#else
+#define TRACE_RING_BARRIER()
+#endif
 
 /** default print function, just redirect str to printf */
 static void mbed_trace_realloc( char **buffer, int *length_ptr, int new_length);
 static void mbed_trace_default_print(const char *str);
 static void mbed_trace_reset_tmp(void);
+static void mbed_trace_print(const char *str);
 
 typedef struct trace_s {
     /** trace configuration bits */
@@ -109,6 +122,18 @@ typedef struct trace_s {
     void (*mutex_release_f)(void);
     /** number of times the mutex has been locked */
     int mutex_lock_count;
+    /** ring buffer of the lines, NULL to print them right away */
+    char *ring;
+    /** ring buffer size - 1 */
+    uint32_t ring_mask;
+    /** free running position of the next line, moved by the trace calls */
+    volatile uint32_t ring_head;
+    /** free running position of the oldest line, moved by mbed_trace_ring_flush */
+    volatile uint32_t ring_tail;
+    /** lines dropped, counted by the trace calls */
+    volatile uint32_t ring_dropped;
+    /** dropped lines already reported by mbed_trace_ring_flush */
+    uint32_t ring_reported;
 } trace_t;
 
 static trace_t m_trace = {
@@ -122,7 +147,8 @@ static trace_t m_trace = {
     .cmd_printf = 0,
     .mutex_wait_f = 0,
     .mutex_release_f = 0,
-    .mutex_lock_count = 0
+    .mutex_lock_count = 0,
+    .ring = 0
 };
 
 int mbed_trace_init(void)
@@ -185,6 +211,7 @@ void mbed_trace_free(void)
     m_trace.mutex_wait_f = 0;
     m_trace.mutex_release_f = 0;
     m_trace.mutex_lock_count = 0;
+    m_trace.ring = 0;
 }
 static void mbed_trace_realloc( char **buffer, int *length_ptr, int new_length)
 {
@@ -281,6 +308,78 @@ static void mbed_trace_default_print(const char *str)
 {
     puts(str);
 }
+int mbed_trace_ring_set(char *buffer, size_t size)
+{
+    if (buffer && (size < 2 || (size & (size - 1)) != 0)) {
+        return -1;
+    }
+    m_trace.ring = 0;
+    m_trace.ring_mask = buffer ? size - 1 : 0;
+    m_trace.ring_head = 0;
+    m_trace.ring_tail = 0;
+    m_trace.ring_dropped = 0;
+    m_trace.ring_reported = 0;
+    m_trace.ring = buffer;
+    return 0;
+}
+static void mbed_trace_print(const char *str)
+{
+    if (!m_trace.ring) {
+        m_trace.printf(str);
+        return;
+    }
+    // the trace calls are the only producer, serialized by the mutex, and
+    // mbed_trace_ring_flush the only consumer, so the positions need no lock
+    uint32_t size = m_trace.ring_mask + 1;
+    uint32_t length = strlen(str) + 1;
+    uint32_t head = m_trace.ring_head;
+    uint32_t offset = head & m_trace.ring_mask;
+    uint32_t skip = (size - offset < length) ? size - offset : 0;
+    if (length + skip > size - (head - m_trace.ring_tail)) {
+        m_trace.ring_dropped++;
+        return;
+    }
+    if (skip) {
+        m_trace.ring[offset] = (char)TRACE_RING_SKIP;
+        head += skip;
+        offset = 0;
+    }
+    memcpy(&m_trace.ring[offset], str, length);
+    TRACE_RING_BARRIER();
+    m_trace.ring_head = head + length;
+}
+size_t mbed_trace_ring_flush(void)
+{
+    size_t printed = 0;
+    if (!m_trace.ring || !m_trace.printf) {
+        return 0;
+    }
+    uint32_t dropped = m_trace.ring_dropped;
+    if (dropped != m_trace.ring_reported) {
+        char notice[40];
+        snprintf(notice, sizeof(notice), "[TRACE] %lu lines dropped",
+                 (unsigned long)(dropped - m_trace.ring_reported));
+        m_trace.ring_reported = dropped;
+        m_trace.printf(notice);
+    }
+    uint32_t tail = m_trace.ring_tail;
+    while (tail != m_trace.ring_head) {
+        TRACE_RING_BARRIER();
+        uint32_t offset = tail & m_trace.ring_mask;
+        if ((uint8_t)m_trace.ring[offset] == TRACE_RING_SKIP) {
+            tail += m_trace.ring_mask + 1 - offset;
+        } else {
+            const char *line = &m_trace.ring[offset];
+            m_trace.printf(line);
+            size_t length = strlen(line) + 1;
+            printed += length - 1;
+            tail += length;
+        }
+        TRACE_RING_BARRIER();
+        m_trace.ring_tail = tail;
+    }
+    return printed;
+}
 void mbed_tracef(uint8_t dlevel, const char *grp, const char *fmt, ...)
 {
     va_list ap;
@@ -307,6 +406,14 @@ void mbed_vtracef(uint8_t dlevel, const char* grp, const char *fmt, va_list ap)
         goto end;
     }
     if ((m_trace.trace_config & TRACE_MASK_LEVEL) &  dlevel) {
+#if defined(MBED_CONF_PLATFORM_BINLOG_TRACE) && MBED_CONF_PLATFORM_BINLOG_TRACE
+        if (dlevel != TRACE_LEVEL_CMD) {
+            //formatted later by tools/binlog.py, the arguments are copied now
+            mbed_binlog_vtrace(dlevel, grp, fmt, ap);
+            mbed_trace_reset_tmp();
+            goto end;
+        }
+#endif
         bool color = (m_trace.trace_config & TRACE_MODE_COLOR) != 0;
         bool plain = (m_trace.trace_config & TRACE_MODE_PLAIN) != 0;
         bool cr    = (m_trace.trace_config & TRACE_CARRIAGE_RETURN) != 0;
@@ -321,7 +428,7 @@ void mbed_vtracef(uint8_t dlevel, const char* grp, const char *fmt, va_list ap)
                 m_trace.cmd_printf("\n");
             } else {
                 //print out whole data
-                m_trace.printf(m_trace.line);
+                mbed_trace_print(m_trace.line);
             }
         } else {
             if (color) {
@@ -446,7 +553,7 @@ void mbed_vtracef(uint8_t dlevel, const char* grp, const char *fmt, va_list ap)
                 }
             }
             //print out whole data
-            m_trace.printf(m_trace.line);
+            mbed_trace_print(m_trace.line);
         }
         //return tmp data pointer back to the beginning
         mbed_trace_reset_tmp();
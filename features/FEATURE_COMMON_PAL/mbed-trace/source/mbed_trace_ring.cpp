@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* The thread flushing the ring buffer in mbed OS. Not part of the yotta
+ * build, see CMakeLists.txt. */
+#ifndef YOTTA_CFG_MBED_TRACE
+#define YOTTA_CFG_MBED_TRACE 1
+#endif
+
+#include "mbed-trace/mbed_trace.h"
+
+#ifdef MBED_CONF_RTOS_PRESENT
+#include "rtos/Thread.h"
+
+#ifndef MBED_CONF_MBED_TRACE_RING_SIZE
+#define MBED_CONF_MBED_TRACE_RING_SIZE          1024
+#endif
+#ifndef MBED_CONF_MBED_TRACE_RING_PERIOD
+#define MBED_CONF_MBED_TRACE_RING_PERIOD        100
+#endif
+#ifndef MBED_CONF_MBED_TRACE_RING_STACK_SIZE
+#define MBED_CONF_MBED_TRACE_RING_STACK_SIZE    1024
+#endif
+
+static char trace_ring[MBED_CONF_MBED_TRACE_RING_SIZE];
+
+static void trace_ring_drain()
+{
+    while (true) {
+        mbed_trace_ring_flush();
+        rtos::Thread::wait(MBED_CONF_MBED_TRACE_RING_PERIOD);
+    }
+}
+#endif
+
+extern "C" int mbed_trace_ring_start(void)
+{
+#ifdef MBED_CONF_RTOS_PRESENT
+    static rtos::Thread *drain_thread;
+    if (drain_thread) {
+        return 0;
+    }
+    if (mbed_trace_ring_set(trace_ring, sizeof(trace_ring)) != 0) {
+        return -1;
+    }
+    drain_thread = new rtos::Thread(osPriorityLow, MBED_CONF_MBED_TRACE_RING_STACK_SIZE);
+    if (drain_thread->start(trace_ring_drain) != osOK) {
+        mbed_trace_ring_set(NULL, 0);
+        return -1;
+    }
+    return 0;
+#else
+    return -1;
+#endif
+}
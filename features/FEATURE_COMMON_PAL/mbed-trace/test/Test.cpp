@@ -38,6 +38,7 @@ void my_mutex_release()
 }
 
 char buf[1024];
+static int print_count = 0;
 #include <stdio.h>
 void myprint(const char* str)
 {
@@ -45,6 +46,7 @@ void myprint(const char* str)
       CHECK( (mutex_wait_count - mutex_release_count) > 0 );
   }
   strcpy(buf, str);
+  print_count++;
 }
 TEST_GROUP(trace)
 {
@@ -429,3 +431,59 @@ TEST(trace, uninitialized)
     STRCMP_EQUAL("hello", buf);
 }
 
+TEST(trace, max_level)
+{
+#define TRACE_GROUP "mygr"
+#undef TRACE_MAX_LEVEL
+#define TRACE_MAX_LEVEL TRACE_LEVEL_WARN
+    int evaluated = 0;
+    tr_warn("warn %d", ++evaluated);
+    STRCMP_EQUAL("warn 1", buf);
+    tr_info("info %d", ++evaluated);
+    tr_debug("debug %d", ++evaluated);
+    STRCMP_EQUAL("warn 1", buf);
+    CHECK(evaluated == 1);
+#undef TRACE_MAX_LEVEL
+#define TRACE_MAX_LEVEL MBED_TRACE_MAX_LEVEL
+    tr_debug("debug %d", ++evaluated);
+    STRCMP_EQUAL("debug 2", buf);
+#undef TRACE_GROUP
+}
+TEST(trace, ring)
+{
+    char ring[32];
+    CHECK(mbed_trace_ring_set(ring, 24) == -1);
+    CHECK(mbed_trace_ring_set(ring, sizeof(ring)) == 0);
+
+    buf[0] = 0;
+    mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "first");
+    mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "second");
+    STRCMP_EQUAL("", buf);
+    STRCMP_EQUAL("second", mbed_trace_last());
+
+    check_mutex_lock_status = false;
+    CHECK(mbed_trace_ring_flush() == 11);
+    STRCMP_EQUAL("second", buf);
+
+    mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "0123456789abcdef");
+    CHECK(mbed_trace_ring_flush() == 16);
+    STRCMP_EQUAL("0123456789abcdef", buf);
+
+    // the first line wraps around the end of the ring, the second does not fit
+    mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "0123456789ABCDEF");
+    mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "dropped 0123456789");
+    int count = print_count;
+    CHECK(mbed_trace_ring_flush() == 16);
+    CHECK(print_count == count + 2);
+    STRCMP_EQUAL("0123456789ABCDEF", buf);
+
+    mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "third");
+    CHECK(mbed_trace_ring_flush() == 5);
+    STRCMP_EQUAL("third", buf);
+    CHECK(mbed_trace_ring_flush() == 0);
+
+    CHECK(mbed_trace_ring_set(NULL, 0) == 0);
+    check_mutex_lock_status = true;
+    mbed_tracef(TRACE_LEVEL_DEBUG, "mygr", "direct");
+    STRCMP_EQUAL("direct", buf);
+}
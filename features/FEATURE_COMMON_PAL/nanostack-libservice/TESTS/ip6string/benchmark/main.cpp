@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// libip6string and IPv6 address helper benchmarks
+//
+// Each benchmark converts, compares or hashes a set of addresses of the
+// shapes the stack prints and parses - link-local, global with a long IID,
+// with and without zero runs - and prints the min, average and max cycles of
+// one call. The conversions are checked to round-trip.
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "us_ticker_api.h"
+#include "ip6string.h"
+#include "common_functions.h"
+
+using namespace utest::v1;
+
+#ifndef BENCHMARK_ROUNDS
+#define BENCHMARK_ROUNDS    2000
+#endif
+
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+static void cycles_init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t cycles_read()
+{
+    return DWT->CYCCNT;
+}
+#else
+static void cycles_init()
+{
+}
+
+static uint32_t cycles_read()
+{
+    return us_ticker_read() * (SystemCoreClock / 1000000);
+}
+#endif
+
+struct latency {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+};
+
+static void latency_reset(latency *l)
+{
+    l->min = UINT32_MAX;
+    l->max = 0;
+    l->sum = 0;
+    l->count = 0;
+}
+
+static void latency_add(latency *l, uint32_t cycles)
+{
+    if (cycles < l->min) {
+        l->min = cycles;
+    }
+    if (cycles > l->max) {
+        l->max = cycles;
+    }
+    l->sum += cycles;
+    l->count++;
+}
+
+static void latency_print(const char *name, const latency *l)
+{
+    TEST_ASSERT_TRUE_MESSAGE(l->count > 0, name);
+    printf("MBED: benchmark %-28s min %8lu avg %8lu max %8lu cycles\r\n", name,
+           (unsigned long)l->min, (unsigned long)(l->sum / l->count),
+           (unsigned long)l->max);
+}
+
+static const uint8_t addresses[][16] = {
+    { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0x02, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x55 },
+    { 0xfd, 0x00, 0x0d, 0xb8, 0, 0, 0, 0, 0x64, 0x3f, 0xf5, 0x4a, 0xec, 0x29, 0xcd, 0xbb },
+    { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 },
+    { 0x20, 0x01, 0x0d, 0xb8, 0xaa, 0xaa, 0xbb, 0xbb, 0xcc, 0xcc, 0xdd, 0xdd, 0xee, 0xee, 0x00, 0x01 },
+    { 0xff, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x1a },
+    { 0x20, 0x01, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1 },
+};
+
+#define ADDRESS_COUNT (sizeof(addresses) / sizeof(addresses[0]))
+
+static char strings[ADDRESS_COUNT][41];
+static uint8_t string_lengths[ADDRESS_COUNT];
+
+void test_ip6tos()
+{
+    latency result;
+    char buffer[41];
+
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        const uint8_t *addr = addresses[i % ADDRESS_COUNT];
+        uint32_t start = cycles_read();
+        uint_fast8_t len = ip6tos(addr, buffer);
+        latency_add(&result, cycles_read() - start);
+        TEST_ASSERT_EQUAL(strlen(buffer), len);
+    }
+    latency_print("ip6tos", &result);
+
+    for (unsigned i = 0; i < ADDRESS_COUNT; i++) {
+        string_lengths[i] = ip6tos(addresses[i], strings[i]);
+    }
+}
+
+void test_ip6_prefix_tos()
+{
+    latency result;
+    char buffer[45];
+
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        uint32_t start = cycles_read();
+        ip6_prefix_tos(addresses[i % ADDRESS_COUNT], 64, buffer);
+        latency_add(&result, cycles_read() - start);
+    }
+    latency_print("ip6_prefix_tos /64", &result);
+}
+
+void test_stoip6()
+{
+    latency result;
+    uint8_t addr[16];
+
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        unsigned n = i % ADDRESS_COUNT;
+        uint32_t start = cycles_read();
+        stoip6(strings[n], string_lengths[n], addr);
+        latency_add(&result, cycles_read() - start);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(addresses[n], addr, 16);
+    }
+    latency_print("stoip6", &result);
+}
+
+void test_ipv6_equal()
+{
+    latency equal_result;
+    latency memcmp_result;
+    volatile bool equal;
+
+    latency_reset(&equal_result);
+    latency_reset(&memcmp_result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        const uint8_t *a = addresses[i % ADDRESS_COUNT];
+        const uint8_t *b = addresses[(i / ADDRESS_COUNT) % ADDRESS_COUNT];
+        uint32_t start = cycles_read();
+        equal = common_ipv6_equal(a, b);
+        latency_add(&equal_result, cycles_read() - start);
+        TEST_ASSERT_EQUAL(memcmp(a, b, 16) == 0, equal);
+
+        start = cycles_read();
+        equal = memcmp(a, b, 16) == 0;
+        latency_add(&memcmp_result, cycles_read() - start);
+    }
+    latency_print("common_ipv6_equal", &equal_result);
+    latency_print("memcmp 16", &memcmp_result);
+}
+
+void test_ipv6_hash()
+{
+    latency result;
+    volatile uint16_t hash;
+
+    latency_reset(&result);
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        uint32_t start = cycles_read();
+        hash = common_ipv6_hash(addresses[i % ADDRESS_COUNT]);
+        latency_add(&result, cycles_read() - start);
+    }
+    (void)hash;
+    latency_print("common_ipv6_hash", &result);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(60, "default_auto");
+    cycles_init();
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("ip6tos", test_ip6tos),
+    Case("ip6_prefix_tos", test_ip6_prefix_tos),
+    Case("stoip6", test_stoip6),
+    Case("IPv6 compare", test_ipv6_equal),
+    Case("IPv6 hash", test_ipv6_hash),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// nsdynmemLIB benchmarks
+//
+// Each benchmark churns buffers through ns_dyn_mem on a heap holding
+// long-lived blocks between the holes, the way the stack uses it, and
+// prints the min, average and max cycles of an allocation and of a free.
+// Build once as is and once with NS_DYN_MEM_CLASS_COUNT defined to compare
+// the hole allocator with the size classes in front of it.
+
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "unity.h"
+#include "utest.h"
+#include "us_ticker_api.h"
+#include "nsdynmemLIB.h"
+
+using namespace utest::v1;
+
+#ifndef BENCHMARK_ROUNDS
+#define BENCHMARK_ROUNDS    5000
+#endif
+
+#define HEAP_SIZE           8192
+#define LONG_LIVED          24      // blocks kept allocated across the heap
+#define IN_FLIGHT           16      // buffers allocated at once
+
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+static void cycles_init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static uint32_t cycles_read()
+{
+    return DWT->CYCCNT;
+}
+#else
+static void cycles_init()
+{
+}
+
+static uint32_t cycles_read()
+{
+    return us_ticker_read() * (SystemCoreClock / 1000000);
+}
+#endif
+
+struct latency {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+};
+
+static void latency_reset(latency *l)
+{
+    l->min = UINT32_MAX;
+    l->max = 0;
+    l->sum = 0;
+    l->count = 0;
+}
+
+static void latency_add(latency *l, uint32_t cycles)
+{
+    if (cycles < l->min) {
+        l->min = cycles;
+    }
+    if (cycles > l->max) {
+        l->max = cycles;
+    }
+    l->sum += cycles;
+    l->count++;
+}
+
+static void latency_print(const char *name, const latency *l)
+{
+    TEST_ASSERT_TRUE_MESSAGE(l->count > 0, name);
+    printf("MBED: benchmark %-28s min %8lu avg %8lu max %8lu cycles\r\n", name,
+           (unsigned long)l->min, (unsigned long)(l->sum / l->count),
+           (unsigned long)l->max);
+}
+
+static uint8_t heap[HEAP_SIZE];
+static mem_stat_t stats;
+static bool heap_failed;
+
+static void heap_fail(heap_fail_t reason)
+{
+    heap_failed = true;
+}
+
+static uint32_t random_state;
+
+static uint32_t random_next()
+{
+    random_state = random_state * 1103515245 + 12345;
+    return random_state >> 16;
+}
+
+// Fills the heap with long-lived blocks of various sizes, so that the
+// buffers are allocated in the holes between them
+static void heap_setup()
+{
+    heap_failed = false;
+    random_state = 1;
+    ns_dyn_mem_init(heap, sizeof(heap), heap_fail, &stats);
+
+    void *temporary[LONG_LIVED];
+    for (int i = 0; i < LONG_LIVED; i++) {
+        temporary[i] = ns_dyn_mem_temporary_alloc(16 + random_next() % 96);
+        TEST_ASSERT_NOT_NULL(ns_dyn_mem_temporary_alloc(8 + random_next() % 64));
+    }
+    for (int i = 0; i < LONG_LIVED; i += 2) {
+        ns_dyn_mem_free(temporary[i]);
+    }
+}
+
+static void churn(const char *alloc_name, const char *free_name, uint16_t min_size, uint16_t max_size)
+{
+    latency alloc_result;
+    latency free_result;
+    void *buffers[IN_FLIGHT] = { NULL };
+
+    heap_setup();
+    latency_reset(&alloc_result);
+    latency_reset(&free_result);
+
+    for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+        int slot = random_next() % IN_FLIGHT;
+        uint32_t start;
+
+        if (buffers[slot]) {
+            start = cycles_read();
+            ns_dyn_mem_free(buffers[slot]);
+            latency_add(&free_result, cycles_read() - start);
+            buffers[slot] = NULL;
+        }
+
+        int16_t size = min_size + random_next() % (max_size - min_size + 1);
+        start = cycles_read();
+        buffers[slot] = ns_dyn_mem_temporary_alloc(size);
+        latency_add(&alloc_result, cycles_read() - start);
+        TEST_ASSERT_NOT_NULL(buffers[slot]);
+    }
+    for (int i = 0; i < IN_FLIGHT; i++) {
+        ns_dyn_mem_free(buffers[i]);
+    }
+
+    TEST_ASSERT_FALSE(heap_failed);
+    latency_print(alloc_name, &alloc_result);
+    latency_print(free_name, &free_result);
+
+#ifdef NS_DYN_MEM_CLASS_COUNT
+    for (int i = 0; i < NS_DYN_MEM_CLASS_COUNT; i++) {
+        printf("MBED: class %d: %lu hits, %lu misses, %u kept\r\n", i,
+               (unsigned long)stats.heap_class[i].hit_cnt,
+               (unsigned long)stats.heap_class[i].miss_cnt,
+               stats.heap_class[i].cached_cnt);
+    }
+#endif
+}
+
+
+// Small buffers, as for packet headers and timers
+void test_small()
+{
+    churn("alloc (8-128 B)", "free (8-128 B)", 8, 128);
+}
+
+// Buffers up to a full 6LoWPAN frame and beyond
+void test_mixed()
+{
+    churn("alloc (8-640 B)", "free (8-640 B)", 8, 640);
+}
+
+
+// Test setup
+utest::v1::status_t test_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(60, "default_auto");
+    cycles_init();
+#ifdef NS_DYN_MEM_CLASS_COUNT
+    printf("MBED: %d size classes, %d blocks kept per class\r\n", NS_DYN_MEM_CLASS_COUNT, NS_DYN_MEM_CLASS_DEPTH);
+#else
+    printf("MBED: no size classes\r\n");
+#endif
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+    Case("Small buffers", test_small),
+    Case("Mixed buffers", test_mixed),
+};
+
+Specification specification(test_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -303,6 +303,31 @@ uint8_t *bitcopy(uint8_t *restrict dst, const uint8_t *restrict src, uint_fast8_
  */
 uint8_t *bitcopy0(uint8_t *restrict dst, const uint8_t *restrict src, uint_fast8_t bits);
 
+/*
+ * Compare two IPv6 addresses
+ *
+ * The interface identifiers are compared first, as addresses sharing a
+ * prefix differ there.
+ *
+ * \param a pointer to first address
+ * \param b pointer to second address
+ *
+ * \return true if the addresses are equal
+ */
+bool common_ipv6_equal(const uint8_t a[__static 16], const uint8_t b[__static 16]);
+
+/*
+ * Hash an IPv6 address
+ *
+ * All bytes of the address are mixed in, so that addresses differing in any
+ * part spread over the hash values. Take the low bits for a table index.
+ *
+ * \param addr pointer to address
+ *
+ * \return 16-bit hash of the address
+ */
+uint16_t common_ipv6_hash(const uint8_t addr[__static 16]);
+
 /* Provide definitions, either for inlining, or for common_functions.c */
 #if defined NS_ALLOW_INLINING || defined COMMON_FUNCTIONS_FN
 #ifndef COMMON_FUNCTIONS_FN
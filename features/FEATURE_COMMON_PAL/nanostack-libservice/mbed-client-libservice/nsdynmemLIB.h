@@ -28,6 +28,27 @@ extern "C" {
 
 #include "ns_types.h"
 
+/*
+ * Size classes, off unless NS_DYN_MEM_CLASS_COUNT is defined.
+ *
+ * Allocations up to the largest of the NS_DYN_MEM_CLASS_SIZES (in bytes, in
+ * ascending order) are rounded up to the smallest class holding them, and
+ * up to NS_DYN_MEM_CLASS_DEPTH freed blocks of each class are kept to serve
+ * the next allocations of the class without searching or merging holes.
+ * The kept blocks are given back to the heap when an allocation fails.
+ */
+#ifdef NS_DYN_MEM_CLASS_COUNT
+#ifndef NS_DYN_MEM_CLASS_SIZES
+#if NS_DYN_MEM_CLASS_COUNT != 4
+#error "NS_DYN_MEM_CLASS_SIZES must list NS_DYN_MEM_CLASS_COUNT sizes"
+#endif
+#define NS_DYN_MEM_CLASS_SIZES 16, 32, 64, 128
+#endif
+#ifndef NS_DYN_MEM_CLASS_DEPTH
+#define NS_DYN_MEM_CLASS_DEPTH 8
+#endif
+#endif
+
 /*!
  * \enum heap_fail_t
  * \brief Dynamically heap system failure call back event types.
@@ -53,6 +74,14 @@ typedef struct mem_stat_t {
     int16_t heap_sector_allocated_bytes_max;    /**< Reserved Heap data in bytes max value. */
     uint32_t heap_alloc_total_bytes;            /**< Total Heap allocated bytes. */
     uint32_t heap_alloc_fail_cnt;               /**< Counter for Heap allocation fail. */
+#ifdef NS_DYN_MEM_CLASS_COUNT
+    /*Size class stats*/
+    struct {
+        uint16_t cached_cnt;                    /**< Freed blocks of the class kept for reuse. */
+        uint32_t hit_cnt;                       /**< Allocations of the class served by a kept block. */
+        uint32_t miss_cnt;                      /**< Allocations of the class served by the heap. */
+    } heap_class[NS_DYN_MEM_CLASS_COUNT];
+#endif
 } mem_stat_t;
 
 /**
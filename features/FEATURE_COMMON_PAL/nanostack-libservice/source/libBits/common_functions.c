@@ -84,3 +84,25 @@ uint8_t *bitcopy0(uint8_t *restrict dst, const uint8_t *restrict src, uint_fast8
 
     return dst;
 }
+
+bool common_ipv6_equal(const uint8_t a[__static 16], const uint8_t b[__static 16])
+{
+    for (int_fast8_t i = 15; i >= 0; i--) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint16_t common_ipv6_hash(const uint8_t addr[__static 16])
+{
+    uint32_t hash = 0;
+
+    for (uint_fast8_t i = 0; i < 16; i++) {
+        hash = (hash * 31) + addr[i];
+    }
+
+    return (uint16_t)(hash ^ (hash >> 16));
+}
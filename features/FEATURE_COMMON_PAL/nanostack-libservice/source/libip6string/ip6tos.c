@@ -13,11 +13,28 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include <stdio.h>
 #include <string.h>
 #include "common_functions.h"
 #include "ip6string.h"
 
+static const char hex_digits[16] = "0123456789abcdef";
+
+/* Write one 16-bit part in hex, without leading zeros */
+static char *ip6tos_part(char *p, uint_fast16_t part)
+{
+    if (part >= 0x1000) {
+        *p++ = hex_digits[part >> 12];
+    }
+    if (part >= 0x100) {
+        *p++ = hex_digits[(part >> 8) & 0xf];
+    }
+    if (part >= 0x10) {
+        *p++ = hex_digits[(part >> 4) & 0xf];
+    }
+    *p++ = hex_digits[part & 0xf];
+    return p;
+}
+
 /**
  * Print binary IPv6 address to a string.
  * String must contain enough room for full address, 40 bytes exact.
@@ -29,59 +46,43 @@ uint_fast8_t ip6tos(const void *ip6addr, char *p)
 {
     char *p_orig = p;
     uint_fast8_t zero_start = 255, zero_len = 1;
+    uint_fast8_t run_start = 0, run_len = 0;
     const uint8_t *addr = ip6addr;
-    uint_fast16_t part;
+    uint_fast16_t parts[8];
 
-    /* Follow RFC 5952 - pre-scan for longest run of zeros */
+    /* Follow RFC 5952 - find the longest run of zeros, reading the parts once.
+     * If runs are equal, we stick with the first one - RFC 5952 S4.2.3. Note
+     * that zero_len being initialised to 1 stops us shortening a 1-part run
+     * (S4.2.2.)
+     */
     for (uint_fast8_t n = 0; n < 8; n++) {
-        part = *addr++;
-        part = (part << 8) | *addr++;
-        if (part != 0) {
+        parts[n] = common_read_16_bit(addr);
+        addr += 2;
+        if (parts[n] != 0) {
+            run_len = 0;
             continue;
         }
-
-        /* We're at the start of a run of zeros - scan to non-zero (or end) */
-        uint_fast8_t n0 = n;
-        for (n = n0 + 1; n < 8; n++) {
-            part = *addr++;
-            part = (part << 8) | *addr++;
-            if (part != 0) {
-                break;
-            }
+        if (run_len++ == 0) {
+            run_start = n;
         }
-
-        /* Now n0->initial zero of run, n->after final zero in run. Is this the
-         * longest run yet? If equal, we stick with the previous one - RFC 5952
-         * S4.2.3. Note that zero_len being initialised to 1 stops us
-         * shortening a 1-part run (S4.2.2.)
-         */
-        if (n - n0 > zero_len) {
-            zero_start = n0;
-            zero_len = n - n0;
+        if (run_len > zero_len) {
+            zero_start = run_start;
+            zero_len = run_len;
         }
-
-        /* Continue scan for initial zeros from part n+1 - we've already
-         * consumed part n, and know it's non-zero. */
     }
 
-    /* Now go back and print, jumping over any zero run */
-    addr = ip6addr;
+    /* Now print, jumping over any zero run */
     for (uint_fast8_t n = 0; n < 8;) {
         if (n == zero_start) {
             if (n == 0) {
                 *p++ = ':';
             }
             *p++ = ':';
-            addr += 2 * zero_len;
             n += zero_len;
             continue;
         }
 
-        part = *addr++;
-        part = (part << 8) | *addr++;
-        n++;
-
-        p += sprintf(p, "%"PRIxFAST16, part);
+        p = ip6tos_part(p, parts[n++]);
 
         /* One iteration writes "part:" rather than ":part", and has the
          * explicit check for n == 8 below, to allow easy extension for
@@ -112,7 +113,15 @@ uint_fast8_t ip6_prefix_tos(const void *prefix, uint_fast8_t prefix_len, char *p
     bitcopy(addr, prefix, prefix_len);
     wptr += ip6tos(addr, wptr);
     // Add the prefix length part of the string
-    wptr += sprintf(wptr, "/%"PRIuFAST8, prefix_len);
+    *wptr++ = '/';
+    if (prefix_len >= 100) {
+        *wptr++ = '1';
+    }
+    if (prefix_len >= 10) {
+        *wptr++ = '0' + (prefix_len / 10) % 10;
+    }
+    *wptr++ = '0' + prefix_len % 10;
+    *wptr = '\0';
 
     // Return total length of generated string
     return wptr - p;
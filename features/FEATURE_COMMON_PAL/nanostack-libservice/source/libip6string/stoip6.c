@@ -19,7 +19,7 @@
 #include "common_functions.h"
 #include "ip6string.h"
 
-static uint16_t hex(const char *p);
+static int_fast8_t hex_digit(char c);
 
 /**
  * Convert numeric IPv6 address string to a binary.
@@ -31,7 +31,7 @@ static uint16_t hex(const char *p);
 void stoip6(const char *ip6addr, size_t len, void *dest)
 {
     uint8_t *addr;
-    const char *p, *q;
+    const char *p, *end;
     int_fast8_t field_no, coloncolon = -1;
 
     addr = dest;
@@ -40,20 +40,30 @@ void stoip6(const char *ip6addr, size_t len, void *dest)
         return;
     }
 
-    // First go forward the string, until end, noting :: position if any
-    for (field_no = 0, p = ip6addr; (len > (p - ip6addr)) && *p && field_no < 8; p = q + 1) {
-        q = p;
-        // Seek for ':' or end
-        while (*q && (*q != ':')) {
-            q++;
+    // Go forward the string once, until end, converting each part as it is read and noting :: position if any
+    end = ip6addr + len;
+    for (field_no = 0, p = ip6addr; p < end && *p && field_no < 8;) {
+        uint_fast16_t value = 0;
+        int_fast8_t digit;
+
+        while (p < end && (digit = hex_digit(*p)) >= 0) {
+            value = (value << 4) | digit;
+            p++;
+        }
+        // Skip anything else up to ':' or end
+        while (p < end && *p && *p != ':') {
+            p++;
         }
-        //Convert and write this part, (high-endian AKA network byte order)
-        addr = common_write_16_bit(hex(p), addr);
+        //Write this part, (high-endian AKA network byte order)
+        addr = common_write_16_bit(value, addr);
         field_no++;
-        //Check if we reached "::"
-        if ((len > (q - ip6addr)) && *q && (q[0] == ':') && (q[1] == ':')) {
-            coloncolon = field_no;
-            q++;
+        if (p < end && *p == ':') {
+            p++;
+            //Check if we reached "::"
+            if (p < end && *p == ':') {
+                coloncolon = field_no;
+                p++;
+            }
         }
     }
 
@@ -78,21 +88,14 @@ unsigned char  sipv6_prefixlength(const char *ip6addr)
     }
     return 0;
 }
-static uint16_t hex(const char *p)
+static int_fast8_t hex_digit(char c)
 {
-    uint16_t val = 0;
-
-    for (;;) {
-        char c = *p++;
-        if ((c >= '0') && (c <= '9')) {
-            val = (val << 4) | (c - '0');
-        } else if ((c >= 'A') && (c <= 'F')) {
-            val = (val << 4) | (10 + (c - 'A'));
-        } else if ((c >= 'a') && (c <= 'f')) {
-            val = (val << 4) | (10 + (c - 'a'));
-        } else {
-            break; // Non hex character
-        }
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    c |= 0x20; // Lower case for letters
+    if ((c >= 'a') && (c <= 'f')) {
+        return 10 + (c - 'a');
     }
-    return val;
+    return -1; // Non hex character
 }
@@ -63,6 +63,121 @@ static void heap_failure(heap_fail_t reason)
     }
 }
 
+#ifdef NS_DYN_MEM_CLASS_COUNT
+// A kept block is still allocated in the heap, linked through its data area
+typedef struct class_block_t {
+    struct class_block_t *next;
+} class_block_t;
+
+static const uint16_t class_sizes[NS_DYN_MEM_CLASS_COUNT] = { NS_DYN_MEM_CLASS_SIZES };
+static class_block_t *class_free[NS_DYN_MEM_CLASS_COUNT];
+static uint8_t class_cached[NS_DYN_MEM_CLASS_COUNT];
+
+// size of a class in our word units
+#define CLASS_SIZE(i) ((class_sizes[i] + sizeof(int) - 1) / sizeof(int))
+
+static void ns_free_and_merge_with_adjacent_blocks(int *cur_block, int data_size);
+
+static void class_init(void)
+{
+    for (int i = 0; i < NS_DYN_MEM_CLASS_COUNT; i++) {
+        class_free[i] = NULL;
+        class_cached[i] = 0;
+    }
+}
+
+// Class for an allocation of data_size words, -1 if larger than the classes
+static int class_for_allocation(int data_size)
+{
+    for (int i = 0; i < NS_DYN_MEM_CLASS_COUNT; i++) {
+        if (data_size <= (int)CLASS_SIZE(i)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Class of a block of exactly data_size words, -1 if none
+static int class_of_block(int data_size)
+{
+    for (int i = 0; i < NS_DYN_MEM_CLASS_COUNT; i++) {
+        if (data_size == (int)CLASS_SIZE(i)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int *class_get(int i)
+{
+    class_block_t *kept = class_free[i];
+    if (!kept) {
+        if (mem_stat_info_ptr) {
+            mem_stat_info_ptr->heap_class[i].miss_cnt++;
+        }
+        return NULL;
+    }
+    class_free[i] = kept->next;
+    class_cached[i]--;
+    if (mem_stat_info_ptr) {
+        mem_stat_info_ptr->heap_class[i].hit_cnt++;
+        mem_stat_info_ptr->heap_class[i].cached_cnt = class_cached[i];
+    }
+    return ((int *)kept) - 1;
+}
+
+// Checks whether an allocated block is one of the kept ones, freed already
+static bool class_kept(int *block, int data_size)
+{
+    int i = class_of_block(data_size);
+    if (i < 0) {
+        return false;
+    }
+    for (class_block_t *cur = class_free[i]; cur; cur = cur->next) {
+        if (cur == (class_block_t *)(block + 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Keep a freed block, returns false if it goes back to the heap
+static bool class_put(int *block, int data_size)
+{
+    int i = class_of_block(data_size);
+    if (i < 0 || class_cached[i] >= NS_DYN_MEM_CLASS_DEPTH) {
+        return false;
+    }
+    class_block_t *kept = (class_block_t *)(block + 1);
+    kept->next = class_free[i];
+    class_free[i] = kept;
+    class_cached[i]++;
+    if (mem_stat_info_ptr) {
+        mem_stat_info_ptr->heap_class[i].cached_cnt = class_cached[i];
+    }
+    return true;
+}
+
+// Give the kept blocks back to the heap, returns false if there were none
+static bool class_flush(void)
+{
+    bool flushed = false;
+    for (int i = 0; i < NS_DYN_MEM_CLASS_COUNT; i++) {
+        while (class_free[i]) {
+            int *block = ((int *)class_free[i]) - 1;
+            class_free[i] = class_free[i]->next;
+            ns_free_and_merge_with_adjacent_blocks(block, *block);
+            flushed = true;
+        }
+        class_cached[i] = 0;
+        if (mem_stat_info_ptr) {
+            mem_stat_info_ptr->heap_class[i].cached_cnt = 0;
+        }
+    }
+    return flushed;
+}
+#endif
+
 #endif
 
 void ns_dyn_mem_init(uint8_t *heap, uint16_t h_size, void (*passed_fptr)(heap_fail_t), mem_stat_t *info_ptr)
@@ -94,6 +209,9 @@ void ns_dyn_mem_init(uint8_t *heap, uint16_t h_size, void (*passed_fptr)(heap_fa
 
     ns_list_init(&holes_list);
     ns_list_add_to_start(&holes_list, hole_from_block_start(heap_main));
+#ifdef NS_DYN_MEM_CLASS_COUNT
+    class_init();
+#endif
 
     //RESET Memory by Hea Len
     if (info_ptr) {
@@ -180,6 +298,17 @@ static void *ns_dyn_mem_internal_alloc(const int16_t alloc_size, int direction)
         goto done;
     }
 
+#ifdef NS_DYN_MEM_CLASS_COUNT
+    int class_index = class_for_allocation(data_size);
+    if (class_index >= 0) {
+        data_size = CLASS_SIZE(class_index);
+        block_ptr = class_get(class_index);
+        if (block_ptr) {
+            goto done;
+        }
+    }
+search:
+#endif
     // ns_list_foreach, either forwards or backwards, result to ptr
     for (hole_t *cur_hole = direction > 0 ? ns_list_get_first(&holes_list)
                                           : ns_list_get_last(&holes_list);
@@ -201,6 +330,11 @@ static void *ns_dyn_mem_internal_alloc(const int16_t alloc_size, int direction)
     }
 
     if (!block_ptr) {
+#ifdef NS_DYN_MEM_CLASS_COUNT
+        if (class_flush()) {
+            goto search;
+        }
+#endif
         goto done;
     }
 
@@ -384,7 +518,14 @@ void ns_dyn_mem_free(void *block)
     } else {
         if (ns_block_validate(ptr, 1) != 0) {
             heap_failure(NS_DYN_MEM_HEAP_SECTOR_CORRUPTED);
+#ifdef NS_DYN_MEM_CLASS_COUNT
+        } else if (class_kept(ptr, size)) {
+            heap_failure(NS_DYN_MEM_DOUBLE_FREE);
+#endif
         } else {
+#ifdef NS_DYN_MEM_CLASS_COUNT
+            if (!class_put(ptr, size))
+#endif
             ns_free_and_merge_with_adjacent_blocks(ptr, size);
             if (mem_stat_info_ptr) {
                 //Update Free Counter
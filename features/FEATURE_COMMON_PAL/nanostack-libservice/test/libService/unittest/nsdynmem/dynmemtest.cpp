@@ -429,6 +429,54 @@ TEST(dynmem, test_invalid_pointer_freed) {
     free(heap);
 }
 
+#ifdef NS_DYN_MEM_CLASS_COUNT
+TEST(dynmem, class_reuse)
+{
+    uint16_t size = 1000;
+    mem_stat_t info;
+    uint8_t *heap = (uint8_t*)malloc(size);
+    CHECK(NULL != heap);
+    reset_heap_error();
+    ns_dyn_mem_init(heap, size, &heap_fail_callback, &info);
+    void *p = ns_dyn_mem_alloc(10);
+    CHECK(NULL != p);
+    CHECK(info.heap_class[0].miss_cnt == 1);
+    ns_dyn_mem_free(p);
+    CHECK(info.heap_class[0].cached_cnt == 1);
+    CHECK(ns_dyn_mem_temporary_alloc(12) == p);
+    CHECK(info.heap_class[0].hit_cnt == 1);
+    CHECK(info.heap_class[0].cached_cnt == 0);
+    ns_dyn_mem_free(p);
+    ns_dyn_mem_free(p);
+    CHECK(heap_have_failed());
+    CHECK(NS_DYN_MEM_DOUBLE_FREE == current_heap_error);
+    free(heap);
+}
+
+TEST(dynmem, class_flush_on_failure)
+{
+    uint16_t size = 1000;
+    mem_stat_t info;
+    uint8_t *heap = (uint8_t*)malloc(size);
+    void *p[NS_DYN_MEM_CLASS_DEPTH];
+    CHECK(NULL != heap);
+    reset_heap_error();
+    ns_dyn_mem_init(heap, size, &heap_fail_callback, &info);
+    for (int i = 0; i < NS_DYN_MEM_CLASS_DEPTH; i++) {
+        p[i] = ns_dyn_mem_alloc(8);
+    }
+    for (int i = 0; i < NS_DYN_MEM_CLASS_DEPTH; i++) {
+        ns_dyn_mem_free(p[i]);
+    }
+    CHECK(info.heap_class[0].cached_cnt == NS_DYN_MEM_CLASS_DEPTH);
+    // The kept blocks are merged back for an allocation of the whole heap
+    CHECK(NULL != ns_dyn_mem_alloc(info.heap_sector_size - 2 * sizeof(int)));
+    CHECK(info.heap_class[0].cached_cnt == 0);
+    CHECK(!heap_have_failed());
+    free(heap);
+}
+#endif
+
 //NOTE! This test must be last!
 TEST(dynmem, uninitialized_test){
     ns_dyn_mem_alloc(4);
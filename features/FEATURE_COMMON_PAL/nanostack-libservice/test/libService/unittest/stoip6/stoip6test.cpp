@@ -74,6 +74,25 @@ TEST(stoip6, TooManyFields)
     CHECK(0 == memcmp(ip, correct, 17)); // Note, we are checking 17, to make sure one byte after address in not touched.
 }
 
+TEST(stoip6, StopsAtLength)
+{
+    // Only the given length is parsed, even if the string goes on
+    const char *addr = "2001:db8::1234/64";
+    uint8_t ip[16];
+    const uint8_t correct[16] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x00, 0x12 };
+    stoip6(addr, 12, ip);
+    CHECK(0 == memcmp(ip, correct, 16));
+}
+
+TEST(stoip6, MixedCase)
+{
+    const char *addr = "FE80::aBcD:12eF";
+    uint8_t ip[16];
+    const uint8_t correct[16] = { 0xfe, 0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xab, 0xcd, 0x12, 0xef };
+    stoip6(addr, strlen(addr), ip);
+    CHECK(0 == memcmp(ip, correct, 16));
+}
+
 TEST(stoip6, Prefixlen)
 {
     CHECK(0 == sipv6_prefixlength("::"));
@@ -27,3 +27,13 @@ bool bitsequal(const uint8_t *a, const uint8_t *b, uint_fast8_t bits)
 {
     return false;
 }
+
+bool common_ipv6_equal(const uint8_t a[__static 16], const uint8_t b[__static 16])
+{
+    return false;
+}
+
+uint16_t common_ipv6_hash(const uint8_t addr[__static 16])
+{
+    return 0;
+}
@@ -44,6 +44,15 @@ typedef struct arm_event_s {
     uint32_t event_data;
 } arm_event_s;
 
+/**
+ * \struct arm_event_queue_stats_s
+ * \brief Depth of the event queue, per priority.
+ */
+typedef struct arm_event_queue_stats_s {
+    uint16_t depth[ARM_LIB_LOW_PRIORITY_EVENT + 1]; /**< Events queued now */
+    uint16_t max_depth[ARM_LIB_LOW_PRIORITY_EVENT + 1]; /**< Most events queued at once since the last reset */
+} arm_event_queue_stats_s;
+
 /**
  * \brief Send event to  event scheduler.
  *
@@ -68,6 +77,20 @@ extern int8_t eventOS_event_send(arm_event_s *event);
  *
  * */
 extern int8_t eventOS_event_handler_create(void (*handler_func_ptr)(arm_event_s *), uint8_t init_event_type);
+
+/**
+ * \brief Read the depth of the event queue
+ *
+ * \param stats filled with the events queued now and the most queued at once, per priority
+ *
+ */
+extern void eventOS_event_queue_stats_get(arm_event_queue_stats_s *stats);
+
+/**
+ * \brief Restart the maximum depths of the event queue from the current ones
+ *
+ */
+extern void eventOS_event_queue_stats_reset(void);
 #ifdef __cplusplus
 }
 #endif
@@ -37,9 +37,18 @@ typedef struct arm_core_event_s {
 } arm_core_event_s;
 
 static NS_LIST_DEFINE(arm_core_tasklet_list, arm_core_tasklet_list_s, link);
-static NS_LIST_DEFINE(event_queue_active, arm_core_event_s, link);
 static NS_LIST_DEFINE(free_event_entry, arm_core_event_s, link);
 
+#define EVENT_PRIORITY_COUNT (ARM_LIB_LOW_PRIORITY_EVENT + 1)
+
+/* One FIFO of active events per priority, so queueing and dequeueing never walk the events */
+static NS_LIST_HEAD(arm_core_event_s, link) event_queue_active[EVENT_PRIORITY_COUNT] = {
+    NS_LIST_INIT(event_queue_active[ARM_LIB_HIGH_PRIORITY_EVENT]),
+    NS_LIST_INIT(event_queue_active[ARM_LIB_MED_PRIORITY_EVENT]),
+    NS_LIST_INIT(event_queue_active[ARM_LIB_LOW_PRIORITY_EVENT]),
+};
+static arm_event_queue_stats_s event_queue_stats;
+
 /** Curr_tasklet tell to core and platform which task_let is active, Core Update this automatic when switch Tasklet. */
 int8_t curr_tasklet = 0;
 
@@ -174,11 +183,15 @@ static void event_core_free_push(arm_core_event_s *free)
 
 static arm_core_event_s *event_core_read(void)
 {
-    arm_core_event_s *event;
+    arm_core_event_s *event = NULL;
     platform_enter_critical();
-    event = ns_list_get_first(&event_queue_active);
-    if (event) {
-        ns_list_remove(&event_queue_active, event);
+    for (uint_fast8_t priority = 0; priority < EVENT_PRIORITY_COUNT; priority++) {
+        event = ns_list_get_first(&event_queue_active[priority]);
+        if (event) {
+            ns_list_remove(&event_queue_active[priority], event);
+            event_queue_stats.depth[priority]--;
+            break;
+        }
     }
     platform_exit_critical();
     return event;
@@ -186,18 +199,15 @@ static arm_core_event_s *event_core_read(void)
 
 void event_core_write(arm_core_event_s *event)
 {
-    platform_enter_critical();
-    bool added = false;
-    ns_list_foreach(arm_core_event_s, event_tmp, &event_queue_active) {
-        // note enum ordering means we're checking if event_tmp is LOWER priority than event
-        if (event_tmp->data.priority > event->data.priority) {
-            ns_list_add_before(&event_queue_active, event_tmp, event);
-            added = true;
-            break;
-        }
+    unsigned priority = event->data.priority;
+    if (priority >= EVENT_PRIORITY_COUNT) {
+        priority = ARM_LIB_LOW_PRIORITY_EVENT;
     }
-    if (!added) {
-        ns_list_add_to_end(&event_queue_active, event);
+
+    platform_enter_critical();
+    ns_list_add_to_end(&event_queue_active[priority], event);
+    if (++event_queue_stats.depth[priority] > event_queue_stats.max_depth[priority]) {
+        event_queue_stats.max_depth[priority] = event_queue_stats.depth[priority];
     }
 
     /* Wake From Idle */
@@ -205,6 +215,20 @@ void event_core_write(arm_core_event_s *event)
     eventOS_scheduler_signal();
 }
 
+void eventOS_event_queue_stats_get(arm_event_queue_stats_s *stats)
+{
+    platform_enter_critical();
+    *stats = event_queue_stats;
+    platform_exit_critical();
+}
+
+void eventOS_event_queue_stats_reset(void)
+{
+    platform_enter_critical();
+    memcpy(event_queue_stats.max_depth, event_queue_stats.depth, sizeof event_queue_stats.max_depth);
+    platform_exit_critical();
+}
+
 /**
  *
  * \brief Initialize Nanostack Core.
@@ -216,7 +240,10 @@ void eventOS_scheduler_init(void)
 {
     /* Reset Event List variables */
     ns_list_init(&free_event_entry);
-    ns_list_init(&event_queue_active);
+    for (uint_fast8_t priority = 0; priority < EVENT_PRIORITY_COUNT; priority++) {
+        ns_list_init(&event_queue_active[priority]);
+    }
+    memset(&event_queue_stats, 0, sizeof event_queue_stats);
     ns_list_init(&arm_core_tasklet_list);
 
     //Allocate 10 entry
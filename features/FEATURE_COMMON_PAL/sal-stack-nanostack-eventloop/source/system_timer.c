@@ -27,13 +27,24 @@
 #define ST_MAX 6
 #endif
 
+/* Slots of the timing wheel, a power of two: a tick only visits the timers of one slot */
+#ifndef ST_WHEEL_SIZE
+#define ST_WHEEL_SIZE 32
+#endif
+
+/* Buckets of the timers by receiver and message, a power of two, for cancelling */
+#ifndef ST_CANCEL_BUCKETS
+#define ST_CANCEL_BUCKETS 8
+#endif
+
 typedef struct sys_timer_struct_s {
-    uint32_t timer_sys_launch_time;
+    uint32_t timer_sys_launch_time; // tick of expiry
     int8_t timer_sys_launch_receiver;
     uint8_t timer_sys_launch_message;
     uint8_t timer_event_type;
 
-    ns_list_link_t link;
+    ns_list_link_t link;            // in its wheel slot, or the free list
+    ns_list_link_t cancel_link;     // in its cancel bucket
 } sys_timer_struct_s;
 
 #define TIMER_SLOTS_PER_MS          20
@@ -41,8 +52,13 @@ typedef struct sys_timer_struct_s {
 
 static uint32_t run_time_tick_ticks = 0;
 static NS_LIST_DEFINE(system_timer_free, sys_timer_struct_s, link);
-static NS_LIST_DEFINE(system_timer_list, sys_timer_struct_s, link);
+static NS_LIST_HEAD(sys_timer_struct_s, link) system_timer_wheel[ST_WHEEL_SIZE];
+static NS_LIST_HEAD(sys_timer_struct_s, cancel_link) system_timer_cancel[ST_CANCEL_BUCKETS];
+static uint16_t system_timer_count = 0;
+static bool system_timer_initialized = false;
 
+#define TIMER_WHEEL_SLOT(time)              ((time) & (ST_WHEEL_SIZE - 1))
+#define TIMER_CANCEL_BUCKET(receiver, msg)  (((uint8_t)(receiver) * 7u + (msg)) & (ST_CANCEL_BUCKETS - 1))
 
 static sys_timer_struct_s *sys_timer_dynamically_allocate(void);
 static void timer_sys_interrupt(void);
@@ -92,10 +108,22 @@ void timer_sys_init(void)
     run_time_tick_ticks = 0;
 
     // Clear old timers
-    ns_list_foreach_safe(sys_timer_struct_s, temp, &system_timer_list) {
-        ns_list_remove(&system_timer_list, temp);
-        ns_dyn_mem_free(temp);
+    if (system_timer_initialized) {
+        for (uint_fast8_t i = 0; i < ST_WHEEL_SIZE; i++) {
+            ns_list_foreach_safe(sys_timer_struct_s, temp, &system_timer_wheel[i]) {
+                ns_list_remove(&system_timer_wheel[i], temp);
+                ns_dyn_mem_free(temp);
+            }
+        }
+    }
+    for (uint_fast8_t i = 0; i < ST_WHEEL_SIZE; i++) {
+        ns_list_init(&system_timer_wheel[i]);
     }
+    for (uint_fast8_t i = 0; i < ST_CANCEL_BUCKETS; i++) {
+        ns_list_init(&system_timer_cancel[i]);
+    }
+    system_timer_count = 0;
+    system_timer_initialized = true;
     // Clear old free timer entrys
     ns_list_foreach_safe(sys_timer_struct_s, temp, &system_timer_free) {
         ns_list_remove(&system_timer_free, temp);
@@ -169,6 +197,14 @@ uint32_t timer_get_runtime_ticks(void)  // only used in dev_stats_internal.c
 
 
 
+static void timer_struct_free(sys_timer_struct_s *timer)
+{
+    ns_list_remove(&system_timer_wheel[TIMER_WHEEL_SLOT(timer->timer_sys_launch_time)], timer);
+    ns_list_remove(&system_timer_cancel[TIMER_CANCEL_BUCKET(timer->timer_sys_launch_receiver, timer->timer_sys_launch_message)], timer);
+    ns_list_add_to_start(&system_timer_free, timer);
+    system_timer_count--;
+}
+
 int8_t eventOS_event_timer_request(uint8_t snmessage, uint8_t event_type, int8_t tasklet_id, uint32_t time)
 {
     int8_t res = -1;
@@ -189,8 +225,10 @@ int8_t eventOS_event_timer_request(uint8_t snmessage, uint8_t event_type, int8_t
         timer->timer_sys_launch_message = snmessage;
         timer->timer_sys_launch_receiver = tasklet_id;
         timer->timer_event_type = event_type;
-        timer->timer_sys_launch_time = time;
-        ns_list_add_to_start(&system_timer_list, timer);
+        timer->timer_sys_launch_time = run_time_tick_ticks + time;
+        ns_list_add_to_end(&system_timer_wheel[TIMER_WHEEL_SLOT(timer->timer_sys_launch_time)], timer);
+        ns_list_add_to_start(&system_timer_cancel[TIMER_CANCEL_BUCKET(tasklet_id, snmessage)], timer);
+        system_timer_count++;
         res = 0;
     }
     platform_exit_critical();
@@ -201,10 +239,9 @@ int8_t eventOS_event_timer_cancel(uint8_t snmessage, int8_t tasklet_id)
 {
     int8_t res = -1;
     platform_enter_critical();
-    ns_list_foreach(sys_timer_struct_s, cur, &system_timer_list) {
+    ns_list_foreach(sys_timer_struct_s, cur, &system_timer_cancel[TIMER_CANCEL_BUCKET(tasklet_id, snmessage)]) {
         if (cur->timer_sys_launch_receiver == tasklet_id && cur->timer_sys_launch_message == snmessage) {
-            ns_list_remove(&system_timer_list, cur);
-            ns_list_add_to_start(&system_timer_free, cur);
+            timer_struct_free(cur);
             res = 0;
             break;
         }
@@ -220,9 +257,26 @@ uint32_t eventOS_event_timer_shortest_active_timer(void)
     uint32_t ret_val = 0;
 
     platform_enter_critical();
-    ns_list_foreach(sys_timer_struct_s, cur, &system_timer_list) {
-        if (ret_val == 0 || cur->timer_sys_launch_time < ret_val) {
-            ret_val = cur->timer_sys_launch_time;
+    if (system_timer_count) {
+        // The first slot holding a timer due within a turn of the wheel holds the next one
+        for (uint32_t ticks = 1; ticks <= ST_WHEEL_SIZE && ret_val == 0; ticks++) {
+            ns_list_foreach(sys_timer_struct_s, cur, &system_timer_wheel[TIMER_WHEEL_SLOT(run_time_tick_ticks + ticks)]) {
+                if (cur->timer_sys_launch_time - run_time_tick_ticks == ticks) {
+                    ret_val = ticks;
+                    break;
+                }
+            }
+        }
+        // Otherwise all the timers are further away
+        if (ret_val == 0) {
+            for (uint_fast8_t i = 0; i < ST_WHEEL_SIZE; i++) {
+                ns_list_foreach(sys_timer_struct_s, cur, &system_timer_wheel[i]) {
+                    uint32_t ticks = cur->timer_sys_launch_time - run_time_tick_ticks;
+                    if (ret_val == 0 || ticks < ret_val) {
+                        ret_val = ticks;
+                    }
+                }
+            }
         }
     }
 
@@ -236,26 +290,27 @@ void system_timer_tick_update(uint32_t ticks)
 {
     platform_enter_critical();
     //Keep runtime time
-    run_time_tick_ticks += ticks;
-    ns_list_foreach_safe(sys_timer_struct_s, cur, &system_timer_list) {
-        if (cur->timer_sys_launch_time <= ticks) {
-            arm_event_s event = {
-                .receiver = cur->timer_sys_launch_receiver,
-                .sender = 0, /**< Event sender Tasklet ID */
-                .data_ptr = NULL,
-                .event_type = cur->timer_event_type,
-                .event_id = cur->timer_sys_launch_message,
-                .event_data = 0,
-                .priority = ARM_LIB_MED_PRIORITY_EVENT,
-            };
-            eventOS_event_send(&event);
-            ns_list_remove(&system_timer_list, cur);
-            ns_list_add_to_start(&system_timer_free, cur);
-        } else {
-            cur->timer_sys_launch_time -= ticks;
+    uint32_t now = run_time_tick_ticks + ticks;
+    // Visit the slots of the elapsed ticks, all of them after a long sleep
+    uint32_t slots = ticks < ST_WHEEL_SIZE ? ticks : ST_WHEEL_SIZE;
+    for (uint32_t i = 1; i <= slots && system_timer_count; i++) {
+        ns_list_foreach_safe(sys_timer_struct_s, cur, &system_timer_wheel[TIMER_WHEEL_SLOT(run_time_tick_ticks + i)]) {
+            if ((int32_t)(cur->timer_sys_launch_time - now) <= 0) {
+                arm_event_s event = {
+                    .receiver = cur->timer_sys_launch_receiver,
+                    .sender = 0, /**< Event sender Tasklet ID */
+                    .data_ptr = NULL,
+                    .event_type = cur->timer_event_type,
+                    .event_id = cur->timer_sys_launch_message,
+                    .event_data = 0,
+                    .priority = ARM_LIB_MED_PRIORITY_EVENT,
+                };
+                eventOS_event_send(&event);
+                timer_struct_free(cur);
+            }
         }
     }
+    run_time_tick_ticks = now;
 
     platform_exit_critical();
 }
-
@@ -32,6 +32,32 @@ struct timeout_entry_t {
 static NS_LIST_HEAD(timeout_t, link) timeout_list = NS_LIST_INIT(timeout_list);
 static int8_t timeout_tasklet_id = -1;
 
+// Event IDs in use, the timer id being uint8_t; UINT8_MAX is never used
+static uint32_t timeout_ids[(UINT8_MAX + 31) / 32];
+
+static int timeout_id_alloc(void)
+{
+    for (uint_fast8_t i = 0; i < sizeof timeout_ids / sizeof timeout_ids[0]; i++) {
+        if (timeout_ids[i] != UINT32_MAX) {
+            uint_fast8_t bit = 0;
+            while (timeout_ids[i] & (1u << bit)) {
+                bit++;
+            }
+            if (i * 32 + bit >= UINT8_MAX) {
+                break;
+            }
+            timeout_ids[i] |= 1u << bit;
+            return i * 32 + bit;
+        }
+    }
+    return -1;
+}
+
+static void timeout_id_free(uint8_t id)
+{
+    timeout_ids[id / 32] &= ~(1u << (id % 32));
+}
+
 static void timeout_tasklet(arm_event_s *event)
 {
     if (TIMER_EVENT != event->event_type) {
@@ -43,6 +69,7 @@ static void timeout_tasklet(arm_event_s *event)
         if (cur->event_id == event->event_id) {
             found = cur;
             ns_list_remove(&timeout_list, cur);
+            timeout_id_free(cur->event_id);
             break;
         }
     }
@@ -55,8 +82,7 @@ static void timeout_tasklet(arm_event_s *event)
 
 timeout_t *eventOS_timeout_ms(void (*callback)(void *), uint32_t ms, void *arg)
 {
-    uint16_t count;
-    uint8_t index;
+    int index;
     timeout_t *e = ns_dyn_mem_alloc(sizeof(timeout_t));
     if (!e) {
         return NULL;
@@ -73,21 +99,11 @@ timeout_t *eventOS_timeout_ms(void (*callback)(void *), uint32_t ms, void *arg)
         }
     }
 
-    // Check that we still have indexes left. We have only 8bit timer id.
-    count = ns_list_count(&timeout_list);
-    if (count >= UINT8_MAX) { // Too big list, timer_id is uint8_t
+    // Take a free index, we have only 8bit timer id.
+    index = timeout_id_alloc();
+    if (index < 0) {
         goto FAIL;
     }
-
-    // Find next free index
-    index = 0;
-AGAIN:
-    ns_list_foreach(timeout_t, cur, &timeout_list) {
-        if (cur->event_id == index) { // This index was used
-            index++; // Check next one.
-            goto AGAIN; // Start checking from begining of the list, indexes are not in order
-        }
-    }
     e->event_id = index;
     ns_list_add_to_end(&timeout_list, e);
     eventOS_event_timer_request(index, TIMER_EVENT, timeout_tasklet_id, ms);
@@ -103,6 +119,7 @@ void eventOS_timeout_cancel(timeout_t *t)
         if (t == cur) {
             ns_list_remove(&timeout_list, cur);
             eventOS_event_timer_cancel(cur->event_id, timeout_tasklet_id);
+            timeout_id_free(cur->event_id);
             ns_dyn_mem_free(cur);
         }
     }
@@ -0,0 +1,68 @@
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+
+#include "mbed.h"
+#include "rtos.h"
+#include "EthernetInterface.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+
+namespace {
+    // Bring-up timeout, DHCP included
+    const int CONNECT_TIMEOUT_MS = 20000;
+
+    Semaphore global_up(0);
+    volatile nsapi_connection_status_t last_status = NSAPI_STATUS_DISCONNECTED;
+}
+
+void status_changed(nsapi_connection_status_t status) {
+    last_status = status;
+    if (status == NSAPI_STATUS_GLOBAL_UP) {
+        global_up.release();
+    }
+}
+
+int connect_async(EthernetInterface &eth) {
+    Timer timer;
+    timer.start();
+
+    int err = eth.connect();
+    if (err != 0) {
+        printf("MBED: connect failed with %d\r\n", err);
+        return -1;
+    }
+
+    // connect only starts the bring-up
+    if (global_up.wait(CONNECT_TIMEOUT_MS) <= 0) {
+        printf("MBED: no address after %dms\r\n", CONNECT_TIMEOUT_MS);
+        return -1;
+    }
+
+    printf("MBED: up in %dms, IP Address is %s\r\n", timer.read_ms(), eth.get_ip_address());
+    return 0;
+}
+
+int main() {
+    GREENTEA_SETUP(60, "default_auto");
+
+    bool result = true;
+    EthernetInterface eth;
+    eth.attach(status_changed);
+    TEST_ASSERT_EQUAL(0, eth.set_blocking(false));
+
+    // The second bring-up asks for the address of the first lease
+    for (int i = 0; i < 2 && result; i++) {
+        if (connect_async(eth) != 0 || eth.get_connection_status() != NSAPI_STATUS_GLOBAL_UP) {
+            result = false;
+        }
+
+        eth.disconnect();
+        if (last_status != NSAPI_STATUS_DISCONNECTED) {
+            printf("MBED: status %d after disconnect\r\n", last_status);
+            result = false;
+        }
+    }
+
+    GREENTEA_TESTSUITE_RESULT(result);
+}
@@ -0,0 +1,268 @@
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+
+import time
+import socket
+import struct
+from threading import Thread
+from mbed_host_tests import BaseHostTest, event_callback
+
+
+# iperf2 client header: flags, threads, port, buffer length, window, amount
+IPERF_HEADER = '>IIIIIi'
+IPERF_FLAGS_ANSWER_TEST = 0x80000000
+# iperf2 repeats the header at the start of every buffer it sends
+IPERF_BUFFER_SIZE = 128*1024
+# iperf2 udp datagram: id, seconds, microseconds
+IPERF_DATAGRAM = '>iII'
+IPERF_DATAGRAM_SIZE = 1470
+
+
+class IperfTest(BaseHostTest):
+    """
+    Host side of the iperf test. For each test case the target sends
+    iperf_start with the case name, the port the target listens on, the
+    duration in seconds and the udp rate in kbit/s. The host answers
+    iperf_ready with the port it listens on itself, if any, and runs its
+    side of the test in a thread. iperf_done returns the number of bytes
+    the host received and the time it took in ms.
+    """
+
+    def __init__(self):
+        BaseHostTest.__init__(self)
+        self.SERVER_IP = None # Will be determined after knowing the target IP
+        self.target_ip = None
+        self.worker = None
+        self.result = (0, 0)
+
+    @staticmethod
+    def find_interface_to_target_addr(target_ip):
+        """
+        Finds IP address of the interface through which it is connected to the target.
+
+        :return:
+        """
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        s.connect((target_ip, 0)) # Target IP, Any port
+        ip = s.getsockname()[0]
+        s.close()
+        return ip
+
+    @staticmethod
+    def iperf_buffer(header):
+        """
+        Buffer in the format of an iperf2 client, the header followed by digits.
+        """
+        data = ''.join(str(i % 10) for i in range(IPERF_BUFFER_SIZE - len(header)))
+        return header + data
+
+    def tcp_client(self, port, duration, header):
+        """
+        Sends to the target for the duration of the test.
+        """
+        s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        s.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        s.connect((self.target_ip, port))
+
+        # like iperf2, the first header is sent on its own
+        s.sendall(header)
+        time.sleep(0.1)
+
+        buf = self.iperf_buffer(header)
+        sent = 0
+        start = time.time()
+        while time.time() - start < duration:
+            s.sendall(buf)
+            sent += len(buf)
+        s.close()
+        self.result = (0, int(1000*(time.time() - start)))
+        self.log("HOST: iperf sent %d bytes" % (sent + len(header)))
+
+    def tcp_server(self, server, duration):
+        """
+        Counts what the target sends on the first connection.
+        """
+        server.settimeout(duration + 10)
+        try:
+            conn, addr = server.accept()
+        except socket.timeout:
+            self.log("HOST: iperf target did not connect")
+            server.close()
+            return
+
+        conn.settimeout(duration + 10)
+        received = 0
+        start = time.time()
+        try:
+            while True:
+                data = conn.recv(IPERF_BUFFER_SIZE)
+                if not data:
+                    break
+                received += len(data)
+        except socket.error as e:
+            self.log("HOST: iperf receive failed: %s" % e)
+        end = time.time()
+        conn.close()
+        server.close()
+        self.result = (received, int(1000*(end - start)))
+
+    def lwip_tcp_tx(self, server, port, duration):
+        """
+        Asks lwiperf for a tradeoff test, lwiperf connects back to the
+        server once the header has been sent and the connection closed.
+        """
+        s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        s.connect((self.target_ip, port))
+        s.sendall(struct.pack(IPERF_HEADER, IPERF_FLAGS_ANSWER_TEST, 1,
+            server.getsockname()[1], 0, 0, -100*duration))
+        s.close()
+        self.tcp_server(server, duration)
+
+    def udp_client(self, port, duration, rate):
+        """
+        Sends iperf2 datagrams to the target at the given rate in kbit/s,
+        followed by the final datagrams with a negative id.
+        """
+        s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        padding = '0' * (IPERF_DATAGRAM_SIZE - struct.calcsize(IPERF_DATAGRAM))
+        interval = 8.0*IPERF_DATAGRAM_SIZE / (1000*rate)
+
+        id = 0
+        start = time.time()
+        while True:
+            now = time.time()
+            if now - start >= duration:
+                break
+            s.sendto(struct.pack(IPERF_DATAGRAM, id, int(now), int(1e6*(now % 1)))
+                + padding, (self.target_ip, port))
+            id += 1
+            delay = start + id*interval - time.time()
+            if delay > 0:
+                time.sleep(delay)
+
+        for i in range(10):
+            s.sendto(struct.pack(IPERF_DATAGRAM, -id, 0, 0) + padding,
+                (self.target_ip, port))
+            time.sleep(0.01)
+        s.close()
+        self.result = (0, int(1000*(time.time() - start)))
+        self.log("HOST: iperf sent %d datagrams" % id)
+
+    def udp_server(self, server, duration):
+        """
+        Counts the target's datagrams until one with a negative id.
+        """
+        server.settimeout(duration + 10)
+        received = 0
+        start = None
+        end = None
+        try:
+            while True:
+                data = server.recv(IPERF_BUFFER_SIZE)
+                if len(data) < struct.calcsize(IPERF_DATAGRAM):
+                    continue
+                id, sec, usec = struct.unpack_from(IPERF_DATAGRAM, data)
+                if id < 0:
+                    break
+                end = time.time()
+                if start is None:
+                    start = end
+                received += len(data)
+        except socket.timeout:
+            self.log("HOST: iperf final datagram not received")
+        server.close()
+        if start is not None:
+            self.result = (received, int(1000*(end - start)))
+
+    @event_callback("target_ip")
+    def _callback_target_ip(self, key, value, timestamp):
+        """
+        Callback to handle reception of target's IP address.
+        """
+        self.target_ip = value
+        self.SERVER_IP = self.find_interface_to_target_addr(self.target_ip)
+
+    @event_callback("host_ip")
+    def _callback_host_ip(self, key, value, timestamp):
+        """
+        Callback for request for host IP Addr
+        """
+        self.send_kv("host_ip", self.SERVER_IP)
+
+    @event_callback("iperf_start")
+    def _callback_iperf_start(self, key, value, timestamp):
+        """
+        Starts the host side of a test case.
+        """
+        name, port, duration, rate = value.split()
+        port, duration, rate = int(port), int(duration), int(rate)
+        self.log("HOST: iperf %s for %d s" % (name, duration))
+        self.result = (0, 0)
+
+        server = None
+        if name == 'lwip_tcp_rx':
+            header = struct.pack(IPERF_HEADER, 0, 1, 0, 0, 0, -100*duration)
+            self.worker = Thread(target=self.tcp_client, args=(port, duration, header))
+        elif name == 'lwip_tcp_tx':
+            server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+            server.bind((self.SERVER_IP, 0))
+            server.listen(1)
+            self.worker = Thread(target=self.lwip_tcp_tx, args=(server, port, duration))
+        elif name == 'socket_tcp_rx':
+            header = struct.pack(IPERF_HEADER, 0, 1, 0, 0, 0, -100*duration)
+            self.worker = Thread(target=self.tcp_client, args=(port, duration, header))
+        elif name == 'socket_tcp_tx':
+            server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+            server.bind((self.SERVER_IP, 0))
+            server.listen(1)
+            self.worker = Thread(target=self.tcp_server, args=(server, duration))
+        elif name == 'socket_udp_rx':
+            self.worker = Thread(target=self.udp_client, args=(port, duration, rate))
+        elif name == 'socket_udp_tx':
+            server = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+            server.bind((self.SERVER_IP, 0))
+            self.worker = Thread(target=self.udp_server, args=(server, duration))
+        else:
+            self.log("HOST: unknown iperf test %s" % name)
+            self.worker = None
+
+        if self.worker:
+            self.worker.start()
+        self.send_kv("iperf_ready", server.getsockname()[1] if server else 0)
+
+    @event_callback("iperf_done")
+    def _callback_iperf_done(self, key, value, timestamp):
+        """
+        Waits for the host side of the current test case and returns its result.
+        """
+        if self.worker:
+            self.worker.join()
+            self.worker = None
+        self.send_kv("iperf_done", "%d %d" % self.result)
+
+    @event_callback("iperf_result")
+    def _callback_iperf_result(self, key, value, timestamp):
+        """
+        Logs a result line: name, kbit/s, cpu load %, max heap, max lwip heap.
+        """
+        name, kbps, load, heap, lwip_heap = value.split()
+        self.log("HOST: iperf %s %.3f Mbit/s cpu %s%% heap %s lwip heap %s"
+            % (name, int(kbps) / 1000.0, load, heap, lwip_heap))
+
+    def teardown(self):
+        if self.worker:
+            self.worker.join()
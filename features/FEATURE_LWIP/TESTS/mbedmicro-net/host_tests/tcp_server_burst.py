@@ -0,0 +1,94 @@
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+"""
+
+import socket
+from threading import Thread, Lock
+from mbed_host_tests import BaseHostTest, event_callback
+
+
+class TCPServerBurstTest(BaseHostTest):
+    """
+    Opens a burst of connections to the target's TCPServer at once. Each
+    connection sends a line and expects it echoed back. More connections
+    are opened than the target's listen backlog holds, so the later ones
+    only complete once the target has accepted the first ones.
+    """
+
+    def __init__(self):
+        BaseHostTest.__init__(self)
+        self.target_ip = None
+        self.workers = []
+        self.completed = 0
+        self.lock = Lock()
+
+    def client(self, port, index):
+        """
+        Connects to the target and checks the echo of one line.
+        """
+        line = 'hello %d\n' % index
+        s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        s.settimeout(30)
+        try:
+            s.connect((self.target_ip, port))
+            s.sendall(line)
+            data = ''
+            while not data.endswith('\n'):
+                recv = s.recv(64)
+                if not recv:
+                    break
+                data += recv
+            if data == line:
+                with self.lock:
+                    self.completed += 1
+            else:
+                self.log("HOST: connection %d received %r" % (index, data))
+        except socket.error as e:
+            self.log("HOST: connection %d failed: %s" % (index, e))
+        s.close()
+
+    @event_callback("target_ip")
+    def _callback_target_ip(self, key, value, timestamp):
+        """
+        Callback to handle reception of target's IP address.
+        """
+        self.target_ip = value
+
+    @event_callback("burst_start")
+    def _callback_burst_start(self, key, value, timestamp):
+        """
+        Opens the requested number of connections concurrently.
+        """
+        port, count = [int(x) for x in value.split()]
+        self.log("HOST: opening %d connections to %s:%d" % (count, self.target_ip, port))
+        self.completed = 0
+        self.workers = [Thread(target=self.client, args=(port, i)) for i in range(count)]
+        for worker in self.workers:
+            worker.start()
+
+    @event_callback("burst_done")
+    def _callback_burst_done(self, key, value, timestamp):
+        """
+        Waits for all connections and returns how many were echoed.
+        """
+        for worker in self.workers:
+            worker.join()
+        self.workers = []
+        self.send_kv("burst_done", self.completed)
+
+    def teardown(self):
+        for worker in self.workers:
+            worker.join()
@@ -0,0 +1,421 @@
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "TCPServer.h"
+#include "TCPSocket.h"
+#include "UDPSocket.h"
+#include "greentea-client/test_env.h"
+#include "mbed_stats.h"
+
+#include "lwip/tcpip.h"
+#include "lwip/stats.h"
+#include "lwip/apps/lwiperf.h"
+
+// length of each measurement in seconds
+#ifndef MBED_CFG_IPERF_DURATION
+#define MBED_CFG_IPERF_DURATION 5
+#endif
+
+// port of the socket based tests, the raw lwIP tests use LWIPERF_TCP_PORT_DEFAULT
+#ifndef MBED_CFG_IPERF_PORT
+#define MBED_CFG_IPERF_PORT 5002
+#endif
+
+#ifndef MBED_CFG_IPERF_TCP_BUFFER_SIZE
+#define MBED_CFG_IPERF_TCP_BUFFER_SIZE 1460
+#endif
+
+// iperf2 default datagram size
+#ifndef MBED_CFG_IPERF_UDP_BUFFER_SIZE
+#define MBED_CFG_IPERF_UDP_BUFFER_SIZE 1470
+#endif
+
+// offered udp load in kbit/s, udp has no flow control
+#ifndef MBED_CFG_IPERF_UDP_RATE
+#define MBED_CFG_IPERF_UDP_RATE 10000
+#endif
+
+namespace {
+    char buffer[MBED_CFG_IPERF_TCP_BUFFER_SIZE > MBED_CFG_IPERF_UDP_BUFFER_SIZE ?
+            MBED_CFG_IPERF_TCP_BUFFER_SIZE : MBED_CFG_IPERF_UDP_BUFFER_SIZE];
+    const int IPERF_TIMEOUT = 1000*(MBED_CFG_IPERF_DURATION + 10);
+
+    EthernetInterface eth;
+    char host_ip[60];
+
+    // the idle thread only spins on the hook when nothing else is ready,
+    // so its rate compared to an idle system is what is left of the cpu
+    volatile uint32_t idle_loops = 0;
+    uint32_t idle_calibration = 0;
+
+    struct measurement {
+        uint32_t idle;
+        Timer timer;
+
+        void start() {
+            idle = idle_loops;
+            timer.reset();
+            timer.start();
+        }
+
+        int cpu_load() {
+            timer.stop();
+            uint64_t loops = idle_loops - idle;
+            uint64_t ms = timer.read_ms();
+            if (!ms || !idle_calibration) {
+                return 0;
+            }
+
+            int load = 100 - (int)(100*loops*1000 / (ms*idle_calibration));
+            return load < 0 ? 0 : load;
+        }
+    };
+
+    // results of a raw lwIP session, written from the tcpip thread
+    Semaphore lwiperf_done(0);
+    volatile enum lwiperf_report_type lwiperf_type;
+    volatile u32_t lwiperf_bytes;
+    volatile u32_t lwiperf_ms;
+    void *lwiperf_session = NULL;
+
+    // iperf2 udp datagram header
+    struct udp_datagram {
+        int32_t id;
+        uint32_t tv_sec;
+        uint32_t tv_usec;
+    };
+}
+
+void idle_hook() {
+    idle_loops++;
+}
+
+void prep_buffer(char *buffer, size_t size) {
+    for (size_t i=0; i<size; ++i) {
+        buffer[i] = '0' + (i % 10);
+    }
+}
+
+bool report(const char *name, uint64_t bytes, int ms, int load) {
+    const int kbps = ms ? (int)(8*bytes / ms) : 0;
+
+    int heap = -1;
+    int max_heap = -1;
+#ifdef MBED_HEAP_STATS_ENABLED
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_get(&stats);
+    heap = stats.current_size;
+    max_heap = stats.max_size;
+#endif
+
+    int lwip_heap = -1;
+#if LWIP_STATS && MEM_STATS
+    lwip_heap = lwip_stats.mem.max;
+#endif
+
+    printf("MBED: iperf %s: %lu bytes in %d ms, %d.%03d Mbit/s, cpu %d%%, "
+            "heap %d max %d, lwip heap max %d\n",
+            name, (unsigned long)bytes, ms, kbps / 1000, kbps % 1000, load,
+            heap, max_heap, lwip_heap);
+
+    char result[80];
+    snprintf(result, sizeof(result), "%s %d %d %d %d",
+            name, kbps, load, max_heap, lwip_heap);
+    greentea_send_kv("iperf_result", result);
+
+    return bytes > 0;
+}
+
+// tells the host which test to run, the host answers with the port it
+// listens on for the tests where the target is the client
+int host_start(const char *name, int port) {
+    char value[60];
+    snprintf(value, sizeof(value), "%s %d %d %d",
+            name, port, MBED_CFG_IPERF_DURATION, MBED_CFG_IPERF_UDP_RATE);
+    greentea_send_kv("iperf_start", value);
+
+    char key[] = "iperf_ready";
+    char portbuf[16] = {0};
+    greentea_parse_kv(key, portbuf, sizeof(key), sizeof(portbuf));
+    return atoi(portbuf);
+}
+
+// waits for the host side of a test, returns the bytes the host received
+uint64_t host_done(int *ms) {
+    greentea_send_kv("iperf_done", " ");
+
+    char key[] = "iperf_done";
+    char value[40] = {0};
+    greentea_parse_kv(key, value, sizeof(key), sizeof(value));
+
+    unsigned long bytes = 0;
+    sscanf(value, "%lu %d", &bytes, ms);
+    return bytes;
+}
+
+
+// raw lwIP tests, lwiperf runs in the tcpip thread
+void lwiperf_report(void *arg, enum lwiperf_report_type type,
+        const ip_addr_t *local_addr, u16_t local_port,
+        const ip_addr_t *remote_addr, u16_t remote_port,
+        u32_t bytes, u32_t ms, u32_t kbps) {
+    // the header only session that starts a tradeoff test is not reported
+    if (type == LWIPERF_TCP_DONE_SERVER && arg && bytes <= 24) {
+        return;
+    }
+
+    lwiperf_type = type;
+    lwiperf_bytes = bytes;
+    lwiperf_ms = ms;
+    lwiperf_done.release();
+}
+
+void lwiperf_start(void *arg) {
+    lwiperf_session = lwiperf_start_tcp_server_default(lwiperf_report, arg);
+    lwiperf_done.release();
+}
+
+void lwiperf_stop(void *arg) {
+    lwiperf_abort(lwiperf_session);
+    lwiperf_session = NULL;
+    lwiperf_done.release();
+}
+
+bool test_lwip_tcp(const char *name, bool tx) {
+    tcpip_callback(lwiperf_start, tx ? &lwiperf_session : NULL);
+    lwiperf_done.wait();
+    if (!lwiperf_session) {
+        printf("MBED: iperf %s: failed to start lwiperf\n", name);
+        return false;
+    }
+
+    // for tx the host asks lwiperf for a tradeoff test, where lwiperf
+    // connects back once the host has sent its header
+    measurement m;
+    host_start(name, LWIPERF_TCP_PORT_DEFAULT);
+    m.start();
+
+    bool done = lwiperf_done.wait(IPERF_TIMEOUT) > 0;
+    int load = m.cpu_load();
+
+    tcpip_callback(lwiperf_stop, NULL);
+    lwiperf_done.wait();
+
+    int ms;
+    uint64_t bytes = host_done(&ms);
+
+    if (!done || lwiperf_type != (tx ? LWIPERF_TCP_DONE_CLIENT : LWIPERF_TCP_DONE_SERVER)) {
+        printf("MBED: iperf %s: lwiperf failed (%d)\n", name, done ? lwiperf_type : -1);
+        return false;
+    }
+
+    if (tx) {
+        return report(name, bytes, ms, load);
+    } else {
+        return report(name, lwiperf_bytes, lwiperf_ms, load);
+    }
+}
+
+
+// NetworkStack tests, through the same sockets applications use
+bool test_socket_tcp_rx(const char *name) {
+    TCPServer server;
+    TCPSocket sock;
+    server.open(&eth);
+    server.bind(MBED_CFG_IPERF_PORT);
+    server.listen();
+
+    measurement m;
+    host_start(name, MBED_CFG_IPERF_PORT);
+
+    uint64_t bytes = 0;
+    int err = server.accept(&sock);
+    if (!err) {
+        m.start();
+        while (true) {
+            int n = sock.recv(buffer, MBED_CFG_IPERF_TCP_BUFFER_SIZE);
+            if (n <= 0) {
+                err = n;
+                break;
+            }
+            bytes += n;
+        }
+    }
+
+    int load = m.cpu_load();
+    int ms = m.timer.read_ms();
+    sock.close();
+    server.close();
+
+    int host_ms;
+    host_done(&host_ms);
+
+    if (err < 0) {
+        printf("MBED: iperf %s: socket error %d\n", name, err);
+        return false;
+    }
+
+    return report(name, bytes, ms, load);
+}
+
+bool test_socket_tcp_tx(const char *name) {
+    int port = host_start(name, 0);
+
+    TCPSocket sock;
+    sock.open(&eth);
+    int err = sock.connect(host_ip, port);
+
+    measurement m;
+    m.start();
+    while (!err && m.timer.read_ms() < 1000*MBED_CFG_IPERF_DURATION) {
+        int n = sock.send(buffer, MBED_CFG_IPERF_TCP_BUFFER_SIZE);
+        if (n < 0) {
+            err = n;
+        }
+    }
+
+    int load = m.cpu_load();
+    sock.close();
+
+    int ms;
+    uint64_t bytes = host_done(&ms);
+
+    if (err < 0) {
+        printf("MBED: iperf %s: socket error %d\n", name, err);
+        return false;
+    }
+
+    return report(name, bytes, ms, load);
+}
+
+bool test_socket_udp_rx(const char *name) {
+    UDPSocket sock;
+    sock.open(&eth);
+    sock.bind(MBED_CFG_IPERF_PORT);
+    sock.set_timeout(1000);
+
+    measurement m;
+    host_start(name, MBED_CFG_IPERF_PORT);
+
+    // datagrams are counted until the host's final ones, which carry a
+    // negative id, or until the host goes quiet
+    uint64_t bytes = 0;
+    int received = 0;
+    int32_t last_id = -1;
+    int timeouts = 0;
+    while (timeouts < MBED_CFG_IPERF_DURATION + 5) {
+        int n = sock.recvfrom(NULL, buffer, MBED_CFG_IPERF_UDP_BUFFER_SIZE);
+        if (n == NSAPI_ERROR_WOULD_BLOCK) {
+            timeouts += 1;
+            continue;
+        } else if (n < (int)sizeof(udp_datagram)) {
+            continue;
+        }
+
+        int32_t id = ntohl(((udp_datagram*)buffer)->id);
+        if (id < 0) {
+            break;
+        }
+
+        if (!bytes) {
+            m.start();
+        }
+        bytes += n;
+        received += 1;
+        last_id = id;
+    }
+
+    int load = m.cpu_load();
+    int ms = m.timer.read_ms();
+    sock.close();
+
+    int host_ms;
+    host_done(&host_ms);
+
+    printf("MBED: iperf %s: %d of %d datagrams\n", name, received, last_id + 1);
+    return report(name, bytes, ms, load);
+}
+
+bool test_socket_udp_tx(const char *name) {
+    int port = host_start(name, 0);
+    SocketAddress addr(host_ip, port);
+
+    UDPSocket sock;
+    sock.open(&eth);
+
+    // paced to the udp rate, the stack drops what it cannot queue
+    udp_datagram *datagram = (udp_datagram*)buffer;
+    int32_t id = 0;
+    uint64_t sent = 0;
+    measurement m;
+    m.start();
+    while (true) {
+        int us = m.timer.read_us();
+        if (us >= 1000000*MBED_CFG_IPERF_DURATION) {
+            break;
+        }
+
+        if (8*sent*1000 >= (uint64_t)MBED_CFG_IPERF_UDP_RATE*us) {
+            Thread::wait(1);
+            continue;
+        }
+
+        datagram->id = htonl(id++);
+        datagram->tv_sec = htonl(us / 1000000);
+        datagram->tv_usec = htonl(us % 1000000);
+        sock.sendto(addr, buffer, MBED_CFG_IPERF_UDP_BUFFER_SIZE);
+        sent += MBED_CFG_IPERF_UDP_BUFFER_SIZE;
+    }
+
+    int load = m.cpu_load();
+
+    for (int i = 0; i < 10; i++) {
+        datagram->id = htonl(-id);
+        sock.sendto(addr, buffer, MBED_CFG_IPERF_UDP_BUFFER_SIZE);
+        Thread::wait(10);
+    }
+    sock.close();
+
+    int ms;
+    uint64_t bytes = host_done(&ms);
+
+    printf("MBED: iperf %s: %d datagrams sent\n", name, (int)id);
+    return report(name, bytes, ms, load);
+}
+
+
+int main() {
+    GREENTEA_SETUP(20*(MBED_CFG_IPERF_DURATION + 10), "iperf");
+
+    eth.connect();
+    printf("MBED: iperf IP Address is %s\n", eth.get_ip_address());
+    greentea_send_kv("target_ip", eth.get_ip_address());
+
+    char key[] = "host_ip";
+    greentea_send_kv("host_ip", " ");
+    greentea_parse_kv(key, host_ip, sizeof(key), sizeof(host_ip));
+
+    prep_buffer(buffer, sizeof(buffer));
+
+    // count how often the idle hook runs per second without any traffic
+    Thread::attach_idle_hook(idle_hook);
+    uint32_t idle = idle_loops;
+    Thread::wait(1000);
+    idle_calibration = idle_loops - idle;
+
+    bool result = true;
+    result = test_lwip_tcp("lwip_tcp_rx", false) && result;
+    result = test_lwip_tcp("lwip_tcp_tx", true) && result;
+    result = test_socket_tcp_rx("socket_tcp_rx") && result;
+    result = test_socket_tcp_tx("socket_tcp_tx") && result;
+    result = test_socket_udp_rx("socket_udp_rx") && result;
+    result = test_socket_udp_tx("socket_udp_tx") && result;
+
+    Thread::attach_idle_hook(NULL);
+    eth.disconnect();
+
+    GREENTEA_TESTSUITE_RESULT(result);
+}
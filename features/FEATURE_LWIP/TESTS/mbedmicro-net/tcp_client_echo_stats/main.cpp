@@ -0,0 +1,108 @@
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "TCPSocket.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+
+
+#ifndef MBED_CFG_TCP_CLIENT_ECHO_BUFFER_SIZE
+#define MBED_CFG_TCP_CLIENT_ECHO_BUFFER_SIZE 256
+#endif
+
+namespace {
+    char tx_buffer[MBED_CFG_TCP_CLIENT_ECHO_BUFFER_SIZE] = {0};
+    char rx_buffer[MBED_CFG_TCP_CLIENT_ECHO_BUFFER_SIZE] = {0};
+}
+
+void prep_buffer(char *tx_buffer, size_t tx_size) {
+    for (size_t i=0; i<tx_size; ++i) {
+        tx_buffer[i] = (rand() % 10) + '0';
+    }
+}
+
+void print_stats(const nsapi_stack_stats_t &stats) {
+    printf("MBED: rx %lu packets %lu bytes %lu drops, tx %lu packets %lu bytes %lu drops\r\n",
+        (unsigned long)stats.rx_packets, (unsigned long)stats.rx_bytes, (unsigned long)stats.rx_drops,
+        (unsigned long)stats.tx_packets, (unsigned long)stats.tx_bytes, (unsigned long)stats.tx_drops);
+    printf("MBED: tcp retransmits %lu, heap %lu/%lu, pbuf pool %lu/%lu, pool errors %lu\r\n",
+        (unsigned long)stats.tcp_retransmits,
+        (unsigned long)stats.heap_max, (unsigned long)stats.heap_size,
+        (unsigned long)stats.pbuf_pool_max, (unsigned long)stats.pbuf_pool_size,
+        (unsigned long)stats.pool_errors);
+    printf("MBED: emac drops %lu, overruns %lu\r\n",
+        (unsigned long)stats.emac_drops, (unsigned long)stats.emac_overruns);
+}
+
+int main() {
+    GREENTEA_SETUP(20, "tcp_echo_client");
+
+    EthernetInterface eth;
+    eth.connect();
+
+    printf("MBED: TCPClient IP address is '%s'\n", eth.get_ip_address());
+    printf("MBED: TCPClient waiting for server IP and port...\n");
+
+    greentea_send_kv("target_ip", eth.get_ip_address());
+
+    bool result = false;
+
+    char recv_key[] = "host_port";
+    char ipbuf[60] = {0};
+    char portbuf[16] = {0};
+    unsigned int port = 0;
+
+    greentea_send_kv("host_ip", " ");
+    greentea_parse_kv(recv_key, ipbuf, sizeof(recv_key), sizeof(ipbuf));
+
+    greentea_send_kv("host_port", " ");
+    greentea_parse_kv(recv_key, portbuf, sizeof(recv_key), sizeof(ipbuf));
+    sscanf(portbuf, "%u", &port);
+
+    printf("MBED: Server IP address received: %s:%d \n", ipbuf, port);
+
+    nsapi_stack_stats_t before;
+    TEST_ASSERT_EQUAL(0, eth.get_stats(&before));
+    print_stats(before);
+
+    TCPSocket sock(&eth);
+    SocketAddress tcp_addr(ipbuf, port);
+    if (sock.connect(tcp_addr) == 0) {
+        printf("HTTP: Connected to %s:%d\r\n", ipbuf, port);
+
+        prep_buffer(tx_buffer, sizeof(tx_buffer));
+        sock.send(tx_buffer, sizeof(tx_buffer));
+
+        const int ret = sock.recv(rx_buffer, sizeof(rx_buffer));
+        TEST_ASSERT_EQUAL(ret, sizeof(rx_buffer));
+        result = !memcmp(tx_buffer, rx_buffer, sizeof(tx_buffer));
+
+        nsapi_socket_stats_t sock_stats;
+        TEST_ASSERT_EQUAL(0, sock.get_stats(&sock_stats));
+        printf("MBED: socket rx %lu bytes, tx %lu bytes, rtt %lu ms, rto %lu ms, cwnd %lu\r\n",
+            (unsigned long)sock_stats.rx_bytes, (unsigned long)sock_stats.tx_bytes,
+            (unsigned long)sock_stats.rtt_ms, (unsigned long)sock_stats.rto_ms,
+            (unsigned long)sock_stats.cwnd);
+        TEST_ASSERT_EQUAL(sizeof(tx_buffer), sock_stats.tx_bytes);
+        TEST_ASSERT_EQUAL(sizeof(rx_buffer), sock_stats.rx_bytes);
+        TEST_ASSERT(sock_stats.cwnd > 0);
+    }
+
+    sock.close();
+
+    nsapi_stack_stats_t after;
+    TEST_ASSERT_EQUAL(0, eth.get_stats(&after));
+    print_stats(after);
+
+    // at least SYN, ACK and the data out, SYN-ACK and the echo in
+    TEST_ASSERT(after.rx_packets - before.rx_packets >= 2);
+    TEST_ASSERT(after.tx_packets - before.tx_packets >= 3);
+    TEST_ASSERT(after.rx_bytes - before.rx_bytes >= sizeof(rx_buffer));
+    TEST_ASSERT(after.tx_bytes - before.tx_bytes >= sizeof(tx_buffer));
+
+    eth.disconnect();
+    GREENTEA_TESTSUITE_RESULT(result);
+}
@@ -0,0 +1,127 @@
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "TCPServer.h"
+#include "TCPSocket.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+
+
+#ifndef MBED_CFG_TCP_SERVER_BURST_PORT
+#define MBED_CFG_TCP_SERVER_BURST_PORT 7700
+#endif
+
+#ifndef MBED_CFG_TCP_SERVER_BURST_CONNECTIONS
+#define MBED_CFG_TCP_SERVER_BURST_CONNECTIONS 8
+#endif
+
+#ifndef MBED_CFG_TCP_SERVER_BURST_BACKLOG
+#define MBED_CFG_TCP_SERVER_BURST_BACKLOG 4
+#endif
+
+// Connections handled at once, the sockets share the stack's netconns
+// with the server
+#ifndef MBED_CFG_TCP_SERVER_BURST_BATCH
+#define MBED_CFG_TCP_SERVER_BURST_BATCH 2
+#endif
+
+#define TIMEOUT_MS 30000
+
+namespace {
+    Semaphore server_event(0);
+}
+
+void server_sigio() {
+    server_event.release();
+}
+
+// Echoes one line back to the client
+bool echo(TCPSocket *sock) {
+    char buffer[64];
+    int size = 0;
+
+    sock->set_timeout(5000);
+    while (size < (int)sizeof(buffer)) {
+        int ret = sock->recv(buffer + size, sizeof(buffer) - size);
+        if (ret <= 0) {
+            return false;
+        }
+
+        size += ret;
+        if (buffer[size-1] == '\n') {
+            break;
+        }
+    }
+
+    return sock->send(buffer, size) == size;
+}
+
+int main() {
+    GREENTEA_SETUP(60, "tcp_server_burst");
+
+    EthernetInterface eth;
+    TEST_ASSERT_EQUAL(0, eth.connect());
+    printf("MBED: TCPServer IP address is '%s'\n", eth.get_ip_address());
+
+    TCPServer server(&eth);
+    TEST_ASSERT_EQUAL(0, server.bind(eth.get_ip_address(), MBED_CFG_TCP_SERVER_BURST_PORT));
+    TEST_ASSERT_EQUAL(0, server.listen(MBED_CFG_TCP_SERVER_BURST_BACKLOG));
+    server.set_blocking(false);
+    server.attach(server_sigio);
+
+    greentea_send_kv("target_ip", eth.get_ip_address());
+
+    // the host opens all connections at once, more than the backlog holds
+    char value[32];
+    sprintf(value, "%d %d", MBED_CFG_TCP_SERVER_BURST_PORT, MBED_CFG_TCP_SERVER_BURST_CONNECTIONS);
+    greentea_send_kv("burst_start", value);
+
+    TCPSocket socks[MBED_CFG_TCP_SERVER_BURST_BATCH];
+    TCPSocket *conns[MBED_CFG_TCP_SERVER_BURST_BATCH];
+    for (int i = 0; i < MBED_CFG_TCP_SERVER_BURST_BATCH; i++) {
+        conns[i] = &socks[i];
+    }
+
+    Timer timer;
+    timer.start();
+
+    int accepted = 0;
+    int echoed = 0;
+    int batches = 0;
+    while (accepted < MBED_CFG_TCP_SERVER_BURST_CONNECTIONS && timer.read_ms() < TIMEOUT_MS) {
+        int ret = server.accept_pending(conns, MBED_CFG_TCP_SERVER_BURST_BATCH);
+        TEST_ASSERT(ret >= 0);
+
+        if (ret == 0) {
+            server_event.wait(100);
+            continue;
+        }
+
+        batches += 1;
+        accepted += ret;
+        for (int i = 0; i < ret; i++) {
+            echoed += echo(conns[i]);
+            conns[i]->close();
+        }
+    }
+
+    printf("MBED: accepted %d connections in %d batches, echoed %d, in %d ms\r\n",
+        accepted, batches, echoed, timer.read_ms());
+
+    char key[] = "burst_done";
+    greentea_send_kv(key, " ");
+    greentea_parse_kv(key, value, sizeof(key), sizeof(value));
+    int completed = atoi(value);
+    printf("MBED: host completed %d connections\r\n", completed);
+
+    server.close();
+    eth.disconnect();
+
+    bool result = accepted == MBED_CFG_TCP_SERVER_BURST_CONNECTIONS
+        && echoed == accepted
+        && completed == accepted;
+    GREENTEA_TESTSUITE_RESULT(result);
+}
@@ -0,0 +1,204 @@
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+#if !DEVICE_TRNG
+    #error [NOT_SUPPORTED] TLS requires an entropy source
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "TLSSocket.h"
+#include "greentea-client/test_env.h"
+#include "unity/unity.h"
+
+
+#ifndef MBED_CFG_TLS_CLIENT_ECHO_BUFFER_SIZE
+#define MBED_CFG_TLS_CLIENT_ECHO_BUFFER_SIZE 2048
+#endif
+
+// Self-signed certificate of the host test's server
+#define TLS_ECHO_HOSTNAME "mbed-tls-echo"
+
+namespace {
+    const char tls_echo_ca_pem[] =
+        "-----BEGIN CERTIFICATE-----\n"
+        "MIIBhzCCAS2gAwIBAgIUE5aJlGVSTWCwV9/blvQ8jZtNYZUwCgYIKoZIzj0EAwIw\n"
+        "GDEWMBQGA1UEAwwNbWJlZC10bHMtZWNobzAgFw0yNjEwMTQwNTQ2NDdaGA8yMDU2\n"
+        "MTAwNjA1NDY0N1owGDEWMBQGA1UEAwwNbWJlZC10bHMtZWNobzBZMBMGByqGSM49\n"
+        "AgEGCCqGSM49AwEHA0IABLn0SfLxzDhsshnWDC6hNsqYRlnRAaXjssW5BFBCGeSE\n"
+        "0Na3zPnC/JqHHTyLjZHho6nHM0ZU80Em3EdUshlE1ACjUzBRMB0GA1UdDgQWBBQ1\n"
+        "a7UGpn1JhWn71fAneRBwDihWZTAfBgNVHSMEGDAWgBQ1a7UGpn1JhWn71fAneRBw\n"
+        "DihWZTAPBgNVHRMBAf8EBTADAQH/MAoGCCqGSM49BAMCA0gAMEUCIBoOQFf62x+i\n"
+        "wSCqExvTWXh2C7nCVwDMiZq4mTKPiRQAAiEAuLVT3wtHGqkogrdOGuKhccesVcaH\n"
+        "EynXVIdeFmaPCOc=\n"
+        "-----END CERTIFICATE-----\n";
+
+    char tx_buffer[MBED_CFG_TLS_CLIENT_ECHO_BUFFER_SIZE] = {0};
+    char rx_buffer[MBED_CFG_TLS_CLIENT_ECHO_BUFFER_SIZE] = {0};
+
+    Semaphore tls_event(0);
+}
+
+// Keeps one session in RAM, and checks whether the last stored session was
+// the same as the one before
+class TestSessionCache : public TLSSessionCache {
+public:
+    TestSessionCache() : resumed(false), _buf(NULL), _size(0) {}
+    virtual ~TestSessionCache() { delete[] _buf; }
+
+    virtual int get(const char *key, mbedtls_ssl_session *session) {
+        return _buf ? load(session, _buf, _size, 0) : NSAPI_ERROR_PARAMETER;
+    }
+
+    virtual int set(const char *key, const mbedtls_ssl_session *session) {
+        unsigned size = saved_size(session);
+        uint8_t *buf = new uint8_t[size];
+        save(session, buf);
+        resumed = _buf && saved_equal(_buf, _size, buf, size);
+        delete[] _buf;
+        _buf = buf;
+        _size = size;
+        return 0;
+    }
+
+    virtual int remove(const char *key) {
+        delete[] _buf;
+        _buf = NULL;
+        return 0;
+    }
+
+    bool resumed;
+
+private:
+    uint8_t *_buf;
+    unsigned _size;
+};
+
+void prep_buffer(char *tx_buffer, size_t tx_size) {
+    for (size_t i=0; i<tx_size; ++i) {
+        tx_buffer[i] = (rand() % 10) + '0';
+    }
+}
+
+void tls_sigio() {
+    tls_event.release();
+}
+
+// Keeps calling op until it no longer would block
+template <typename F>
+int nonblocking(F op) {
+    while (true) {
+        int ret = op();
+        if (ret != NSAPI_ERROR_WOULD_BLOCK) {
+            return ret;
+        }
+        tls_event.wait(100);
+    }
+}
+
+struct tls_connect {
+    TLSSocket *tls; const SocketAddress *addr;
+    int operator()() { return tls->connect(*addr, TLS_ECHO_HOSTNAME); }
+};
+
+struct tls_send {
+    TLSSocket *tls; const char *data; unsigned size;
+    int operator()() { return tls->send(data, size); }
+};
+
+struct tls_recv {
+    TLSSocket *tls; char *data; unsigned size;
+    int operator()() { return tls->recv(data, size); }
+};
+
+bool echo(TLSSocket *tls, bool blocking) {
+    prep_buffer(tx_buffer, sizeof(tx_buffer));
+    memset(rx_buffer, 0, sizeof(rx_buffer));
+
+    unsigned sent = 0;
+    while (sent < sizeof(tx_buffer)) {
+        tls_send op = {tls, tx_buffer + sent, (unsigned)sizeof(tx_buffer) - sent};
+        int ret = blocking ? op() : nonblocking(op);
+        if (ret <= 0) {
+            printf("MBED: send failed %d, tls error -0x%04x\r\n", ret, -tls->get_tls_error());
+            return false;
+        }
+        sent += ret;
+    }
+
+    unsigned received = 0;
+    while (received < sizeof(rx_buffer)) {
+        tls_recv op = {tls, rx_buffer + received, (unsigned)sizeof(rx_buffer) - received};
+        int ret = blocking ? op() : nonblocking(op);
+        if (ret <= 0) {
+            printf("MBED: recv failed %d, tls error -0x%04x\r\n", ret, -tls->get_tls_error());
+            return false;
+        }
+        received += ret;
+    }
+
+    return !memcmp(tx_buffer, rx_buffer, sizeof(tx_buffer));
+}
+
+int main() {
+    GREENTEA_SETUP(60, "tls_echo");
+
+    EthernetInterface eth;
+    TEST_ASSERT_EQUAL(0, eth.connect());
+
+    printf("MBED: TLSClient IP address is '%s'\n", eth.get_ip_address());
+    greentea_send_kv("target_ip", eth.get_ip_address());
+
+    char recv_key[] = "host_port";
+    char ipbuf[60] = {0};
+    char portbuf[16] = {0};
+    unsigned int port = 0;
+
+    greentea_send_kv("host_ip", " ");
+    greentea_parse_kv(recv_key, ipbuf, sizeof(recv_key), sizeof(ipbuf));
+
+    greentea_send_kv("host_port", " ");
+    greentea_parse_kv(recv_key, portbuf, sizeof(recv_key), sizeof(portbuf));
+    sscanf(portbuf, "%u", &port);
+
+    printf("MBED: Server IP address received: %s:%d \n", ipbuf, port);
+    SocketAddress addr(ipbuf, port);
+
+    // a blocking and a non-blocking connection, then a blocking connection
+    // resuming the session of the second
+    TestSessionCache cache;
+    bool result = true;
+    for (int i = 0; i < 3; i++) {
+        bool blocking = (i != 1);
+
+        TLSSocket tls(&eth);
+        TEST_ASSERT_EQUAL(0, tls.set_root_ca_cert(tls_echo_ca_pem));
+        tls.set_max_fragment_length(1024);
+        tls.attach(tls_sigio);
+        tls.set_blocking(blocking);
+        if (i > 0) {
+            tls.set_session_cache(&cache);
+        }
+
+        Timer timer;
+        timer.start();
+        tls_connect op = {&tls, &addr};
+        int err = blocking ? op() : nonblocking(op);
+        printf("MBED: %s handshake %d in %d ms, tls error -0x%04x\r\n",
+            blocking ? "blocking" : "non-blocking", err, timer.read_ms(), -tls.get_tls_error());
+        TEST_ASSERT_EQUAL(0, err);
+
+        bool echoed = echo(&tls, blocking);
+        printf("MBED: %s echo of %d bytes %s\r\n",
+            blocking ? "blocking" : "non-blocking", sizeof(tx_buffer), echoed ? "passed" : "failed");
+        result = result && echoed;
+
+        tls.close();
+    }
+
+    printf("MBED: session %s\r\n", cache.resumed ? "resumed" : "not resumed");
+    result = result && cache.resumed;
+
+    eth.disconnect();
+    GREENTEA_TESTSUITE_RESULT(result);
+}
@@ -0,0 +1,111 @@
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "UDPSocket.h"
+#include "NetBuffer.h"
+#include "greentea-client/test_env.h"
+
+#ifndef MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE
+#define MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE 256
+#endif
+
+namespace {
+    const int ECHO_LOOPS = 16;
+}
+
+void prep_buffer(NetBuffer &buf) {
+    void *data;
+    for (unsigned offset = 0; offset < buf.size();) {
+        unsigned len = buf.data(offset, &data);
+        for (unsigned i = 0; i < len; ++i) {
+            ((char *)data)[i] = (rand() % 10) + '0';
+        }
+        offset += len;
+    }
+}
+
+bool compare_buffers(const NetBuffer &a, const NetBuffer &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    for (unsigned offset = 0; offset < a.size();) {
+        void *da, *db;
+        unsigned len = a.data(offset, &da);
+        unsigned lenb = b.data(offset, &db);
+        if (lenb < len) {
+            len = lenb;
+        }
+
+        if (memcmp(da, db, len)) {
+            return false;
+        }
+        offset += len;
+    }
+
+    return true;
+}
+
+int main() {
+    GREENTEA_SETUP(20, "udp_echo_client");
+
+    EthernetInterface eth;
+    eth.connect();
+    printf("UDP client IP Address is %s\n", eth.get_ip_address());
+
+    greentea_send_kv("target_ip", eth.get_ip_address());
+
+    bool result = false;
+
+    char recv_key[] = "host_port";
+    char ipbuf[60] = {0};
+    char portbuf[16] = {0};
+    unsigned int port = 0;
+
+    UDPSocket sock;
+    sock.open(&eth);
+
+    greentea_send_kv("host_ip", " ");
+    greentea_parse_kv(recv_key, ipbuf, sizeof(recv_key), sizeof(ipbuf));
+
+    greentea_send_kv("host_port", " ");
+    greentea_parse_kv(recv_key, portbuf, sizeof(recv_key), sizeof(ipbuf));
+    sscanf(portbuf, "%u", &port);
+
+    printf("MBED: UDP Server IP address received: %s:%d \n", ipbuf, port);
+
+    SocketAddress addr(ipbuf, port);
+
+    NetBuffer tx_buffer;
+    NetBuffer rx_buffer;
+
+    for (int i=0; i < ECHO_LOOPS; ++i) {
+        if (tx_buffer.alloc(&eth, MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE)) {
+            printf("[%02d] buffer allocation failed\n", i);
+            result = false;
+            break;
+        }
+
+        prep_buffer(tx_buffer);
+        const int ret = sock.sendto(addr, tx_buffer);
+        printf("[%02d] sent...%d Bytes \n", i, ret);
+
+        const int n = sock.recvfrom(&addr, &rx_buffer);
+        printf("[%02d] recv...%d Bytes \n", i, n);
+
+        if (!compare_buffers(rx_buffer, tx_buffer)) {
+            result = false;
+            break;
+        }
+
+        rx_buffer.release();
+        result = true;
+    }
+
+    sock.close();
+    eth.disconnect();
+    GREENTEA_TESTSUITE_RESULT(result);
+}
@@ -0,0 +1,119 @@
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "UDPSocket.h"
+#include "SocketPoll.h"
+#include "greentea-client/test_env.h"
+
+#ifndef MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE
+#define MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE 64
+#endif
+
+namespace {
+    // several sockets echoed at once and served by a single poll
+    const int SOCKETS = 4;
+    char tx_buffer[SOCKETS][MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE] = {{0}};
+    char rx_buffer[MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE] = {0};
+    const int ECHO_LOOPS = 8;
+    const int POLL_TIMEOUT = 5000;
+}
+
+void prep_buffer(char *tx_buffer, size_t tx_size) {
+    for (size_t i=0; i<tx_size; ++i) {
+        tx_buffer[i] = (rand() % 10) + '0';
+    }
+}
+
+int main() {
+    GREENTEA_SETUP(60, "udp_echo_client");
+
+    EthernetInterface eth;
+    eth.connect();
+    printf("UDP client IP Address is %s\n", eth.get_ip_address());
+
+    greentea_send_kv("target_ip", eth.get_ip_address());
+
+    bool result = true;
+
+    char recv_key[] = "host_port";
+    char ipbuf[60] = {0};
+    char portbuf[16] = {0};
+    unsigned int port = 0;
+
+    UDPSocket socks[SOCKETS];
+    SocketPoll poll(SOCKETS);
+    for (int i=0; i < SOCKETS; ++i) {
+        socks[i].open(&eth);
+        socks[i].set_blocking(false);
+        poll.add(&socks[i], NSAPI_POLLIN | NSAPI_POLLOUT);
+    }
+
+    greentea_send_kv("host_ip", " ");
+    greentea_parse_kv(recv_key, ipbuf, sizeof(recv_key), sizeof(ipbuf));
+
+    greentea_send_kv("host_port", " ");
+    greentea_parse_kv(recv_key, portbuf, sizeof(recv_key), sizeof(ipbuf));
+    sscanf(portbuf, "%u", &port);
+
+    printf("MBED: UDP Server IP address received: %s:%d \n", ipbuf, port);
+
+    SocketAddress addr(ipbuf, port);
+    socket_poll_event_t ready[SOCKETS];
+
+    // udp sockets can send right away
+    if (poll.wait(ready, SOCKETS, 0) != SOCKETS) {
+        result = false;
+    }
+
+    for (int i=0; i < SOCKETS; ++i) {
+        poll.add(&socks[i], NSAPI_POLLIN);
+    }
+
+    for (int i=0; i < ECHO_LOOPS && result; ++i) {
+        for (int j=0; j < SOCKETS; ++j) {
+            prep_buffer(tx_buffer[j], sizeof(tx_buffer[j]));
+            const int ret = socks[j].sendto(addr, tx_buffer[j], sizeof(tx_buffer[j]));
+            printf("[%02d:%d] sent...%d Bytes \n", i, j, ret);
+        }
+
+        int echoed = 0;
+        while (echoed < SOCKETS) {
+            const int count = poll.wait(ready, SOCKETS, POLL_TIMEOUT);
+            if (count <= 0) {
+                result = false;
+                break;
+            }
+
+            for (int k=0; k < count; ++k) {
+                int j = static_cast<UDPSocket *>(ready[k].socket) - socks;
+                const int n = socks[j].recvfrom(NULL, rx_buffer, sizeof(rx_buffer));
+                if (n == NSAPI_ERROR_WOULD_BLOCK) {
+                    continue;
+                }
+
+                printf("[%02d:%d] recv...%d Bytes \n", i, j, n);
+                if (n != sizeof(rx_buffer) || memcmp(rx_buffer, tx_buffer[j], n)) {
+                    result = false;
+                }
+
+                echoed += 1;
+            }
+        }
+    }
+
+    // a closed socket is reported as such
+    socks[0].close();
+    if (poll.wait(ready, 1, 0) != 1 || !(ready[0].revents & NSAPI_POLLNVAL)) {
+        result = false;
+    }
+
+    for (int i=0; i < SOCKETS; ++i) {
+        socks[i].close();
+    }
+
+    eth.disconnect();
+    GREENTEA_TESTSUITE_RESULT(result);
+}
@@ -0,0 +1,89 @@
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "UDPSocket.h"
+#include "greentea-client/test_env.h"
+
+#ifndef MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE
+#define MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE 16
+#endif
+
+namespace {
+    // small packets, so the cost of each socket call dominates
+    char tx_buffer[MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE] = {0};
+    char rx_buffer[MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE] = {0};
+    const int ECHO_LOOPS = 1000;
+    const int ECHO_TIMEOUT = 500;
+}
+
+void prep_buffer(char *tx_buffer, size_t tx_size) {
+    for (size_t i=0; i<tx_size; ++i) {
+        tx_buffer[i] = (rand() % 10) + '0';
+    }
+}
+
+int main() {
+    GREENTEA_SETUP(120, "udp_echo_client");
+
+    EthernetInterface eth;
+    eth.connect();
+    printf("UDP client IP Address is %s\n", eth.get_ip_address());
+
+    greentea_send_kv("target_ip", eth.get_ip_address());
+
+    char recv_key[] = "host_port";
+    char ipbuf[60] = {0};
+    char portbuf[16] = {0};
+    unsigned int port = 0;
+
+    UDPSocket sock;
+    sock.open(&eth);
+    sock.set_timeout(ECHO_TIMEOUT);
+
+    greentea_send_kv("host_ip", " ");
+    greentea_parse_kv(recv_key, ipbuf, sizeof(recv_key), sizeof(ipbuf));
+
+    greentea_send_kv("host_port", " ");
+    greentea_parse_kv(recv_key, portbuf, sizeof(recv_key), sizeof(ipbuf));
+    sscanf(portbuf, "%u", &port);
+
+    printf("MBED: UDP Server IP address received: %s:%d \n", ipbuf, port);
+
+    SocketAddress addr(ipbuf, port);
+
+    int echoed = 0;
+    Timer timer;
+    timer.start();
+
+    for (int i=0; i < ECHO_LOOPS; ++i) {
+        prep_buffer(tx_buffer, sizeof(tx_buffer));
+        sock.sendto(addr, tx_buffer, sizeof(tx_buffer));
+
+        const int n = sock.recvfrom(NULL, rx_buffer, sizeof(rx_buffer));
+        if (n == sizeof(rx_buffer) && !memcmp(rx_buffer, tx_buffer, n)) {
+            echoed += 1;
+        }
+    }
+
+    timer.stop();
+
+    // packets/s counts both directions of the echo
+    const int ms = timer.read_ms();
+    printf("MBED: %d of %d echoes in %d ms, %d packets/s\n",
+            echoed, ECHO_LOOPS, ms, ms ? (int)(2000LL*echoed / ms) : 0);
+#if MBED_CONF_LWIP_TCPIP_CORE_LOCKING
+    printf("MBED: core locking enabled, input locking %s\n",
+            MBED_CONF_LWIP_TCPIP_CORE_LOCKING_INPUT ? "enabled" : "disabled");
+#else
+    printf("MBED: core locking disabled\n");
+#endif
+
+    sock.close();
+    eth.disconnect();
+
+    // udp may drop the odd packet, the rate is what matters here
+    GREENTEA_TESTSUITE_RESULT(echoed >= ECHO_LOOPS*9/10);
+}
@@ -0,0 +1,96 @@
+#if !FEATURE_LWIP
+    #error [NOT_SUPPORTED] LWIP not supported for this target
+#endif
+
+#include "mbed.h"
+#include "EthernetInterface.h"
+#include "UDPSocket.h"
+#include "greentea-client/test_env.h"
+
+#ifndef MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE
+#define MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE 256
+#endif
+
+namespace {
+    // packet sent as a header, a payload and a trailer
+    char tx_header[8] = {0};
+    char tx_payload[MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE - 16] = {0};
+    char tx_trailer[8] = {0};
+    // echo received in two halves, the last byte is left over to
+    // check the packet is not truncated
+    char rx_buffer[MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE + 1] = {0};
+    const int ECHO_LOOPS = 16;
+}
+
+void prep_buffer(char *tx_buffer, size_t tx_size) {
+    for (size_t i=0; i<tx_size; ++i) {
+        tx_buffer[i] = (rand() % 10) + '0';
+    }
+}
+
+int main() {
+    GREENTEA_SETUP(20, "udp_echo_client");
+
+    EthernetInterface eth;
+    eth.connect();
+    printf("UDP client IP Address is %s\n", eth.get_ip_address());
+
+    greentea_send_kv("target_ip", eth.get_ip_address());
+
+    bool result = false;
+
+    char recv_key[] = "host_port";
+    char ipbuf[60] = {0};
+    char portbuf[16] = {0};
+    unsigned int port = 0;
+
+    UDPSocket sock;
+    sock.open(&eth);
+
+    greentea_send_kv("host_ip", " ");
+    greentea_parse_kv(recv_key, ipbuf, sizeof(recv_key), sizeof(ipbuf));
+
+    greentea_send_kv("host_port", " ");
+    greentea_parse_kv(recv_key, portbuf, sizeof(recv_key), sizeof(ipbuf));
+    sscanf(portbuf, "%u", &port);
+
+    printf("MBED: UDP Server IP address received: %s:%d \n", ipbuf, port);
+
+    SocketAddress addr(ipbuf, port);
+
+    const nsapi_iovec_t tx_iov[] = {
+        {tx_header, sizeof(tx_header)},
+        {tx_payload, sizeof(tx_payload)},
+        {tx_trailer, sizeof(tx_trailer)},
+    };
+    const nsapi_iovec_t rx_iov[] = {
+        {rx_buffer, sizeof(rx_buffer) / 2},
+        {rx_buffer + sizeof(rx_buffer) / 2, sizeof(rx_buffer) - sizeof(rx_buffer) / 2},
+    };
+
+    for (int i=0; i < ECHO_LOOPS; ++i) {
+        prep_buffer(tx_header, sizeof(tx_header));
+        prep_buffer(tx_payload, sizeof(tx_payload));
+        prep_buffer(tx_trailer, sizeof(tx_trailer));
+        const int ret = sock.sendmsg(addr, tx_iov, 3);
+        printf("[%02d] sent...%d Bytes \n", i, ret);
+
+        int flags = 0;
+        const int n = sock.recvmsg(&addr, rx_iov, 2, &flags);
+        printf("[%02d] recv...%d Bytes \n", i, n);
+
+        if (n != MBED_CFG_UDP_CLIENT_ECHO_BUFFER_SIZE || (flags & NSAPI_MSG_TRUNC)
+                || memcmp(rx_buffer, tx_header, sizeof(tx_header))
+                || memcmp(rx_buffer + sizeof(tx_header), tx_payload, sizeof(tx_payload))
+                || memcmp(rx_buffer + sizeof(tx_header) + sizeof(tx_payload), tx_trailer, sizeof(tx_trailer))) {
+            result = false;
+            break;
+        }
+
+        result = true;
+    }
+
+    sock.close();
+    eth.disconnect();
+    GREENTEA_TESTSUITE_RESULT(result);
+}
@@ -16,11 +16,84 @@
 
 #include "EthernetInterface.h"
 #include "lwip_stack.h"
+#include <string.h>
+
+#if FEATURE_STORAGE && MBED_CONF_LWIP_DHCP_LEASE_STORE
+#include "configuration-store/configuration_store.h"
+#define DHCP_LEASE_STORE 1
+
+#define DHCP_LEASE_KEY "lwip.dhcp.lease"
+
+// The address of the last lease, kept as a string. Only the synchronous
+// mode of the configuration store is supported
+static bool dhcp_lease_load(char *ip, unsigned size)
+{
+    ARM_CFSTORE_DRIVER *drv = &cfstore_driver;
+    ARM_CFSTORE_CAPABILITIES caps = drv->GetCapabilities();
+    if (caps.asynchronous_ops || drv->Initialize(NULL, NULL) < ARM_DRIVER_OK) {
+        return false;
+    }
+
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ARM_CFSTORE_FMODE flags;
+    memset(&flags, 0, sizeof(flags));
+    flags.read = 1;
+
+    bool ok = false;
+    if (drv->Open(DHCP_LEASE_KEY, flags, hkey) >= ARM_DRIVER_OK) {
+        ARM_CFSTORE_SIZE len = size - 1;
+        if (drv->Read(hkey, ip, &len) >= ARM_DRIVER_OK) {
+            ip[len] = '\0';
+            ok = true;
+        }
+        drv->Close(hkey);
+    }
+
+    drv->Uninitialize();
+    return ok;
+}
+
+static void dhcp_lease_store(const char *ip)
+{
+    ARM_CFSTORE_DRIVER *drv = &cfstore_driver;
+    ARM_CFSTORE_CAPABILITIES caps = drv->GetCapabilities();
+    if (caps.asynchronous_ops || drv->Initialize(NULL, NULL) < ARM_DRIVER_OK) {
+        return;
+    }
+
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ARM_CFSTORE_FMODE flags;
+    memset(&flags, 0, sizeof(flags));
+    flags.write = 1;
+
+    if (drv->Open(DHCP_LEASE_KEY, flags, hkey) >= ARM_DRIVER_OK) {
+        drv->Delete(hkey);
+        drv->Close(hkey);
+    }
+
+    ARM_CFSTORE_KEYDESC kdesc;
+    memset(&kdesc, 0, sizeof(kdesc));
+    kdesc.acl.perm_owner_read = 1;
+    kdesc.acl.perm_owner_write = 1;
+    kdesc.drl = ARM_RETENTION_NVM;
+    kdesc.flags.read = 1;
+    kdesc.flags.write = 1;
+
+    ARM_CFSTORE_SIZE len = strlen(ip);
+    if (drv->Create(DHCP_LEASE_KEY, len, &kdesc, hkey) >= ARM_DRIVER_OK) {
+        drv->Write(hkey, ip, &len);
+        drv->Close(hkey);
+    }
+
+    drv->Flush();
+    drv->Uninitialize();
+}
+#endif
 
 
 /* Interface implementation */
 EthernetInterface::EthernetInterface()
-    : _dhcp(true), _ip_address(), _netmask(), _gateway()
+    : _dhcp(true), _blocking(true), _ip_address(), _netmask(), _gateway(), _dhcp_lease()
 {
 }
 
@@ -39,8 +112,56 @@ int EthernetInterface::set_dhcp(bool dhcp)
     return 0;
 }
 
+int EthernetInterface::set_blocking(bool blocking)
+{
+    _blocking = blocking;
+    return 0;
+}
+
+void EthernetInterface::attach(nsapi_status_callback_t status_cb)
+{
+    _status_cb = status_cb;
+    mbed_lwip_attach(&EthernetInterface::status_irq, this);
+}
+
+nsapi_connection_status_t EthernetInterface::get_connection_status() const
+{
+    return mbed_lwip_get_connection_status();
+}
+
+void EthernetInterface::status_irq(void *ctx, nsapi_connection_status_t status)
+{
+    EthernetInterface *iface = static_cast<EthernetInterface *>(ctx);
+
+    // Stored only when the address changes, the store's flash writes
+    // stall the stack's thread
+    char lease[NSAPI_IPv4_SIZE];
+    if (status == NSAPI_STATUS_GLOBAL_UP && iface->_dhcp &&
+            mbed_lwip_get_dhcp_lease(lease, sizeof lease) &&
+            strcmp(lease, iface->_dhcp_lease) != 0) {
+        strcpy(iface->_dhcp_lease, lease);
+#if DHCP_LEASE_STORE
+        dhcp_lease_store(lease);
+#endif
+    }
+
+    if (iface->_status_cb) {
+        iface->_status_cb(status);
+    }
+}
+
 int EthernetInterface::connect()
 {
+    mbed_lwip_attach(&EthernetInterface::status_irq, this);
+    mbed_lwip_set_blocking(_blocking);
+
+#if DHCP_LEASE_STORE
+    if (_dhcp && !_dhcp_lease[0]) {
+        dhcp_lease_load(_dhcp_lease, sizeof _dhcp_lease);
+    }
+#endif
+    mbed_lwip_set_dhcp_lease(_dhcp ? _dhcp_lease : 0);
+
     return mbed_lwip_bringup(_dhcp,
             _ip_address[0] ? _ip_address : 0,
             _netmask[0] ? _netmask : 0,
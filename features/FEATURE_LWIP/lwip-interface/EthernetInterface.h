@@ -57,7 +57,39 @@ public:
      */
     virtual int set_dhcp(bool dhcp);
 
+    /** Set blocking or non-blocking mode of connect
+     *
+     *  Requires that the network is disconnected
+     *
+     *  @param blocking     False to return from connect at once, and
+     *                      report the result through the status callback
+     *  @return             0 on success, negative error code on failure
+     */
+    virtual int set_blocking(bool blocking);
+
+    /** Register a callback for changes of the connection status
+     *
+     *  The callback is called from the threads of the stack and the
+     *  Ethernet driver, and must not block.
+     *
+     *  @param status_cb    Callback called with the new status
+     */
+    virtual void attach(nsapi_status_callback_t status_cb);
+
+    /** Get the connection status
+     *
+     *  @return             The connection status
+     */
+    virtual nsapi_connection_status_t get_connection_status() const;
+
     /** Start the interface
+     *
+     *  With DHCP, the address of the last lease is requested again on the
+     *  next connect, which then takes a single round trip if the server
+     *  still grants it. With FEATURE_STORAGE and the lwip
+     *  dhcp-lease-store option, it is kept in the configuration store
+     *  across resets.
+     *
      *  @return             0 on success, negative on failure
      */
     virtual int connect();
@@ -106,10 +138,15 @@ protected:
      */
     virtual NetworkStack *get_stack();
 
+    static void status_irq(void *ctx, nsapi_connection_status_t status);
+
     bool _dhcp;
+    bool _blocking;
+    nsapi_status_callback_t _status_cb;
     char _ip_address[IPADDR_STRLEN_MAX];
     char _netmask[NSAPI_IPv4_SIZE];
     char _gateway[NSAPI_IPv4_SIZE];
+    char _dhcp_lease[NSAPI_IPv4_SIZE];
 };
 
 
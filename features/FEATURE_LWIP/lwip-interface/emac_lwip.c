@@ -23,8 +23,27 @@
 #include "lwip/tcpip.h"
 #include "lwip/tcp.h"
 #include "lwip/ip.h"
+#include "lwip/igmp.h"
+#include "lwip/mld6.h"
 #include "netif/etharp.h"
 
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+/* lwIP checksums the interface takes over */
+static const struct {
+    uint32_t cap;
+    u16_t flag;
+} emac_lwip_checksums[] = {
+    {EMAC_CAP_TX_CHECKSUM_IP,   NETIF_CHECKSUM_GEN_IP},
+    {EMAC_CAP_TX_CHECKSUM_UDP,  NETIF_CHECKSUM_GEN_UDP},
+    {EMAC_CAP_TX_CHECKSUM_TCP,  NETIF_CHECKSUM_GEN_TCP},
+    {EMAC_CAP_TX_CHECKSUM_ICMP, NETIF_CHECKSUM_GEN_ICMP | NETIF_CHECKSUM_GEN_ICMP6},
+    {EMAC_CAP_RX_CHECKSUM_IP,   NETIF_CHECKSUM_CHECK_IP},
+    {EMAC_CAP_RX_CHECKSUM_UDP,  NETIF_CHECKSUM_CHECK_UDP},
+    {EMAC_CAP_RX_CHECKSUM_TCP,  NETIF_CHECKSUM_CHECK_TCP},
+    {EMAC_CAP_RX_CHECKSUM_ICMP, NETIF_CHECKSUM_CHECK_ICMP | NETIF_CHECKSUM_CHECK_ICMP6},
+};
+#endif
+
 static err_t emac_lwip_low_level_output(struct netif *netif, struct pbuf *p)
 {
     emac_interface_t *mac = (emac_interface_t *)netif->state;
@@ -57,6 +76,64 @@ static void emac_lwip_state_change(void *data, bool up)
     }
 }
 
+#if LWIP_IPV4 && LWIP_IGMP
+static err_t emac_lwip_igmp_mac_filter(struct netif *netif, const ip4_addr_t *group, u8_t action)
+{
+    emac_interface_t *mac = (emac_interface_t *)netif->state;
+    uint32_t group23 = lwip_ntohl(ip4_addr_get_u32(group)) & 0x007FFFFF;
+    uint8_t addr[6];
+
+    addr[0] = LL_IP4_MULTICAST_ADDR_0;
+    addr[1] = LL_IP4_MULTICAST_ADDR_1;
+    addr[2] = LL_IP4_MULTICAST_ADDR_2;
+    addr[3] = group23 >> 16;
+    addr[4] = group23 >> 8;
+    addr[5] = group23;
+
+    switch (action) {
+        case IGMP_ADD_MAC_FILTER:
+            mac->ops.add_multicast_group(mac, addr);
+            return ERR_OK;
+        case IGMP_DEL_MAC_FILTER:
+            if (mac->ops.remove_multicast_group) {
+                mac->ops.remove_multicast_group(mac, addr);
+            }
+            return ERR_OK;
+        default:
+            return ERR_ARG;
+    }
+}
+#endif
+
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+static err_t emac_lwip_mld_mac_filter(struct netif *netif, const ip6_addr_t *group, u8_t action)
+{
+    emac_interface_t *mac = (emac_interface_t *)netif->state;
+    uint32_t group32 = lwip_ntohl(group->addr[3]);
+    uint8_t addr[6];
+
+    addr[0] = LL_IP6_MULTICAST_ADDR_0;
+    addr[1] = LL_IP6_MULTICAST_ADDR_1;
+    addr[2] = group32 >> 24;
+    addr[3] = group32 >> 16;
+    addr[4] = group32 >> 8;
+    addr[5] = group32;
+
+    switch (action) {
+        case MLD6_ADD_MAC_FILTER:
+            mac->ops.add_multicast_group(mac, addr);
+            return ERR_OK;
+        case MLD6_DEL_MAC_FILTER:
+            if (mac->ops.remove_multicast_group) {
+                mac->ops.remove_multicast_group(mac, addr);
+            }
+            return ERR_OK;
+        default:
+            return ERR_ARG;
+    }
+}
+#endif
+
 err_t emac_lwip_if_init(struct netif *netif)
 {
     int err = ERR_OK;
@@ -73,6 +150,27 @@ err_t emac_lwip_if_init(struct netif *netif)
     /* Interface capabilities */
     netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET | NETIF_FLAG_IGMP;
 
+    uint32_t caps = mac->ops.get_capabilities ? mac->ops.get_capabilities(mac) : 0;
+
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+    u16_t chksum_flags = NETIF_CHECKSUM_ENABLE_ALL;
+    for (unsigned i = 0; i < sizeof(emac_lwip_checksums)/sizeof(emac_lwip_checksums[0]); i++) {
+        if (caps & emac_lwip_checksums[i].cap) {
+            chksum_flags &= ~emac_lwip_checksums[i].flag;
+        }
+    }
+    NETIF_SET_CHECKSUM_CTRL(netif, chksum_flags);
+#endif
+
+    if ((caps & EMAC_CAP_MULTICAST_HASH) && mac->ops.add_multicast_group) {
+#if LWIP_IPV4 && LWIP_IGMP
+        netif->igmp_mac_filter = emac_lwip_igmp_mac_filter;
+#endif
+#if LWIP_IPV6 && LWIP_IPV6_MLD
+        netif->mld_mac_filter = emac_lwip_mld_mac_filter;
+#endif
+    }
+
     mac->ops.get_ifname(mac, netif->name, 2);
 
 #if LWIP_IPV4
@@ -13,6 +13,8 @@
 #include "netif/ppp/pppoe.h"
 
 #include "eth_arch.h"
+#include "eth_arch_rx.h"
+#include "eth_arch_mcast.h"
 #include "sys_arch.h"
 
 #include "fsl_phy.h"
@@ -29,8 +31,8 @@ enet_handle_t g_handle;
 uint8_t *tx_desc_start_addr;
 // RX Buffer descriptors
 uint8_t *rx_desc_start_addr;
-// RX packet buffer pointers
-struct pbuf *rx_buff[ENET_RX_RING_LEN];
+// RX buffers given to each descriptor
+struct eth_arch_rx_buf *rx_buff[ENET_RX_RING_LEN];
 // TX packet buffer pointers
 struct pbuf *tx_buff[ENET_RX_RING_LEN];
 // RX packet payload pointers
@@ -41,12 +43,17 @@ uint32_t *rx_ptr[ENET_RX_RING_LEN];
  ********************************************************************************/
 #define ENET_BuffSizeAlign(n) ENET_ALIGN(n, ENET_BUFF_ALIGNMENT)
 #define ENET_ALIGN(x,align)   ((unsigned int)((x) + ((align)-1)) & (unsigned int)(~(unsigned int)((align)- 1)))
+#define ENET_RX_BUFF_SIZE     ENET_BuffSizeAlign(ENET_ETH_MAX_FLEN)
 extern void k64f_init_eth_hardware(void);
 
 /* K64F EMAC driver data structure */
 struct k64f_enetdata {
   struct netif *netif;  /**< Reference back to LWIP parent netif */
-  sys_sem_t RxReadySem; /**< RX packet ready semaphore */
+  struct eth_arch_rx rx; /**< RX buffer pool and thread */
+  struct eth_arch_mcast mcast; /**< Groups joined on each multicast hash bit */
+  uint8_t rx_next_index; /**< Next RX descriptor to receive from */
+  uint8_t rx_fill_index; /**< Next RX descriptor to give a buffer to */
+  uint8_t rx_empty_count; /**< RX descriptors without a buffer */
   sys_sem_t TxCleanSem; /**< TX cleanup thread wakeup semaphore */
   sys_mutex_t TXLockMutex; /**< TX critical section mutex */
   sys_sem_t xTXDCountSem; /**< TX free buffer counting semaphore */
@@ -55,6 +62,9 @@ struct k64f_enetdata {
 
 static struct k64f_enetdata k64f_enetdata;
 
+static u16_t k64f_rx_poll(struct eth_arch_rx *rx, u16_t budget);
+static void k64f_rx_irq_enable(struct eth_arch_rx *rx);
+
 /** \brief  Driver transmit and receive thread priorities
  *
  * Thread priorities for receive thread and TX cleanup thread. Alter
@@ -68,32 +78,35 @@ static struct k64f_enetdata k64f_enetdata;
 /********************************************************************************
  * Buffer management
  ********************************************************************************/
-/*
- * This function will queue a new receive buffer
+/** \brief  Give free RX buffers to the descriptors that lack one
+ *
+ *  Descriptors are refilled in order, the DMA stops at the first
+ *  descriptor without a buffer until lwIP frees a received frame.
+ *
+ *  \param[in] k64f_enet  Pointer to driver data structure
  */
-static void update_read_buffer(uint8_t *buf)
+static void k64f_rx_refill(struct k64f_enetdata *k64f_enet)
 {
-    if (buf != NULL) {
-        g_handle.rxBdCurrent->buffer = buf;
-    }
-
-    /* Clears status. */
-    g_handle.rxBdCurrent->control &= ENET_BUFFDESCRIPTOR_RX_WRAP_MASK;
-
-    /* Sets the receive buffer descriptor with the empty flag. */
-    g_handle.rxBdCurrent->control |= ENET_BUFFDESCRIPTOR_RX_EMPTY_MASK;
-
-    /* Increases the buffer descriptor to the next one. */
-    if (g_handle.rxBdCurrent->control & ENET_BUFFDESCRIPTOR_RX_WRAP_MASK) {
-        g_handle.rxBdCurrent = g_handle.rxBdBase;
-        g_handle.rxBdDirty = g_handle.rxBdBase;
-    } else {
-        g_handle.rxBdCurrent++;
-        g_handle.rxBdDirty++;
-    }
+  while (k64f_enet->rx_empty_count > 0) {
+    uint8_t idx = k64f_enet->rx_fill_index;
+    volatile enet_rx_bd_struct_t *bdPtr = &g_handle.rxBdBase[idx];
+    struct eth_arch_rx_buf *buf = eth_arch_rx_alloc(&k64f_enet->rx);
+    if (buf == NULL)
+      break;
+
+    rx_buff[idx] = buf;
+    bdPtr->buffer = buf->data;
+
+    /* Clears status and sets the receive buffer descriptor with the empty flag. */
+    bdPtr->control &= ENET_BUFFDESCRIPTOR_RX_WRAP_MASK;
+    bdPtr->control |= ENET_BUFFDESCRIPTOR_RX_EMPTY_MASK;
+
+    k64f_enet->rx_fill_index = (idx + 1) % ENET_RX_RING_LEN;
+    k64f_enet->rx_empty_count--;
+  }
 
-    /* Actives the receive buffer descriptor. */
-    ENET->RDAR = ENET_RDAR_RDAR_MASK;
+  /* Actives the receive buffer descriptors. */
+  ENET->RDAR = ENET_RDAR_RDAR_MASK;
 }
 
 /** \brief  Free TX buffers that are complete
@@ -130,7 +143,9 @@ static void k64f_tx_reclaim(struct k64f_enetdata *k64f_enet)
  */
 void enet_mac_rx_isr()
 {
-  sys_sem_signal(&k64f_enetdata.RxReadySem);
+  /* Frames are received in batches, until the receive thread is done */
+  ENET_DisableInterrupts(ENET, kENET_RxFrameInterrupt);
+  eth_arch_rx_signal(&k64f_enetdata.rx);
 }
 
 void enet_mac_tx_isr()
@@ -167,33 +182,57 @@ static err_t low_level_init(struct netif *netif)
   uint32_t phyAddr = 0;
   bool link = false;
   enet_config_t config;
+  uint8_t *rx_desc, *tx_desc;
+  uint8_t *rx_pool;
+  err_t err;
 
   // Allocate RX descriptors
-  rx_desc_start_addr = (uint8_t *)calloc(1, sizeof(enet_rx_bd_struct_t) * ENET_RX_RING_LEN + ENET_BUFF_ALIGNMENT);
-  if(!rx_desc_start_addr)
+  rx_desc = (uint8_t *)calloc(1, sizeof(enet_rx_bd_struct_t) * ENET_RX_RING_LEN + ENET_BUFF_ALIGNMENT);
+  if(!rx_desc)
     return ERR_MEM;
 
   // Allocate TX descriptors
-  tx_desc_start_addr = (uint8_t *)calloc(1, sizeof(enet_tx_bd_struct_t) * ENET_TX_RING_LEN + ENET_BUFF_ALIGNMENT);
-  if(!tx_desc_start_addr)
+  tx_desc = (uint8_t *)calloc(1, sizeof(enet_tx_bd_struct_t) * ENET_TX_RING_LEN + ENET_BUFF_ALIGNMENT);
+  if(!tx_desc) {
+    free(rx_desc);
     return ERR_MEM;
+  }
+
+  rx_desc_start_addr = (uint8_t *)ENET_ALIGN(rx_desc, ENET_BUFF_ALIGNMENT);
+  tx_desc_start_addr = (uint8_t *)ENET_ALIGN(tx_desc, ENET_BUFF_ALIGNMENT);
+
+  /* Create the pool of RX buffers, aligned for the K64F RX descriptors (16 bytes alignment) */
+  rx_pool = (uint8_t *)mem_malloc(ENET_RX_POOL_LEN * ENET_RX_BUFF_SIZE + ENET_BUFF_ALIGNMENT);
+  if (!rx_pool) {
+    err = ERR_MEM;
+    goto free_desc;
+  }
 
-  rx_desc_start_addr = (uint8_t *)ENET_ALIGN(rx_desc_start_addr, ENET_BUFF_ALIGNMENT);
-  tx_desc_start_addr = (uint8_t *)ENET_ALIGN(tx_desc_start_addr, ENET_BUFF_ALIGNMENT);
+  err = eth_arch_rx_init(&k64f_enet->rx, netif,
+                         (void *)ENET_ALIGN((uint32_t)rx_pool, ENET_BUFF_ALIGNMENT),
+                         ENET_RX_POOL_LEN, ENET_RX_BUFF_SIZE,
+                         k64f_rx_poll, k64f_rx_irq_enable, k64f_enet);
+  if (err != ERR_OK)
+    goto free_pool;
 
-  /* Create buffers for each receive BD */
+  /* Give a buffer to each receive BD */
   for (i = 0; i < ENET_RX_RING_LEN; i++) {
-    rx_buff[i] = pbuf_alloc(PBUF_RAW, ENET_ETH_MAX_FLEN + ENET_BUFF_ALIGNMENT, PBUF_RAM);
-    if (NULL == rx_buff[i])
-      return ERR_MEM;
-
-    /* K64F note: the next line ensures that the RX buffer is properly aligned for the K64F
-       RX descriptors (16 bytes alignment). However, by doing so, we're effectively changing
-       a data structure which is internal to lwIP. This might not prove to be a good idea
-       in the long run, but a better fix would probably involve modifying lwIP itself */
-    rx_buff[i]->payload = (void*)ENET_ALIGN((uint32_t)rx_buff[i]->payload, ENET_BUFF_ALIGNMENT);
-    rx_ptr[i] = rx_buff[i]->payload;
+    rx_buff[i] = eth_arch_rx_alloc(&k64f_enet->rx);
+    if (!rx_buff[i]) {
+      /* Return the buffers already taken before the pool goes */
+      while (i > 0) {
+        i--;
+        eth_arch_rx_free(rx_buff[i]);
+        rx_buff[i] = NULL;
+      }
+      eth_arch_rx_deinit(&k64f_enet->rx);
+      err = ERR_MEM;
+      goto free_pool;
+    }
+    rx_ptr[i] = rx_buff[i]->data;
   }
+  k64f_enet->rx_next_index = k64f_enet->rx_fill_index = 0;
+  k64f_enet->rx_empty_count = 0;
 
   k64f_enet->tx_consume_index = k64f_enet->tx_produce_index = 0;
 
@@ -201,7 +240,7 @@ static err_t low_level_init(struct netif *netif)
   enet_buffer_config_t buffCfg = {
     ENET_RX_RING_LEN,
     ENET_TX_RING_LEN,
-    ENET_ALIGN(ENET_ETH_MAX_FLEN, ENET_BUFF_ALIGNMENT),
+    ENET_RX_BUFF_SIZE,
     0,
     (volatile enet_rx_bd_struct_t *)rx_desc_start_addr,
     (volatile enet_tx_bd_struct_t *)tx_desc_start_addr,
@@ -228,13 +267,29 @@ static err_t low_level_init(struct netif *netif)
   }
   config.rxMaxFrameLen = ENET_ETH_MAX_FLEN;
   config.macSpecialConfig = kENET_ControlFlowControlEnable;
-  config.txAccelerConfig = kENET_TxAccelIsShift16Enabled;
-  config.rxAccelerConfig = kENET_RxAccelisShift16Enabled | kENET_RxAccelMacCheckEnabled;
+  config.txAccelerConfig = kENET_TxAccelIsShift16Enabled |
+                           kENET_TxAccelIpCheckEnabled | kENET_TxAccelProtoCheckEnabled;
+  config.rxAccelerConfig = kENET_RxAccelisShift16Enabled | kENET_RxAccelMacCheckEnabled |
+                           kENET_RxAccelIpCheckEnabled | kENET_RxAccelProtoCheckEnabled;
   ENET_Init(ENET, &g_handle, &config, &buffCfg, netif->hwaddr, sysClock);
   ENET_SetCallback(&g_handle, ethernet_callback, netif);
+
+  /* Clear and enable the MIB statistic counters for the overrun count */
+  ENET->MIBC = ENET_MIBC_MIB_DIS_MASK | ENET_MIBC_MIB_CLEAR_MASK;
+  ENET->MIBC = 0;
+
   ENET_ActiveRead(ENET);
 
   return ERR_OK;
+
+free_pool:
+  mem_free(rx_pool);
+free_desc:
+  free(tx_desc);
+  free(rx_desc);
+  rx_desc_start_addr = NULL;
+  tx_desc_start_addr = NULL;
+  return err;
 }
 
 
@@ -280,6 +335,30 @@ err_t k64f_etharp_output_ipv6(struct netif *netif, struct pbuf *q, const ip6_add
 }
 #endif
 
+#if LWIP_IGMP || LWIP_IPV6_MLD
+/** \brief  Join or leave a multicast MAC address in the hash filter
+ *
+ *  The group is added to the hash table of the MAC, which accepts the
+ *  frames sent to it. Groups sharing a hash bit are counted, so leaving a
+ *  group keeps the others.
+ *
+ *  \param[in] addr  multicast MAC address
+ *  \param[in] join  1 to join the address, 0 to leave it
+ */
+static void k64f_mac_filter(uint8_t *addr, int join)
+{
+    unsigned hash = eth_arch_mcast_crc(addr) >> 26;
+
+    if (join) {
+        if (eth_arch_mcast_join(&k64f_enetdata.mcast, hash))
+            ENET_AddMulticastGroup(ENET, addr);
+    } else {
+        if (eth_arch_mcast_leave(&k64f_enetdata.mcast, hash))
+            ENET_LeaveMulticastGroup(ENET, addr);
+    }
+}
+#endif
+
 #if LWIP_IGMP
 /**
  * IPv4 address filtering setup.
@@ -291,22 +370,15 @@ err_t k64f_etharp_output_ipv6(struct netif *netif, struct pbuf *q, const ip6_add
  */
 err_t igmp_mac_filter(struct netif *netif, const ip4_addr_t *group, u8_t action)
 {
+    uint8_t addr[6];
+    eth_arch_mcast_ip4_addr(group, addr);
+
     switch (action) {
         case IGMP_ADD_MAC_FILTER:
-        {
-            uint32_t group23 = ntohl(group->addr) & 0x007FFFFF;
-            uint8_t addr[6];
-            addr[0] = LL_IP4_MULTICAST_ADDR_0;
-            addr[1] = LL_IP4_MULTICAST_ADDR_1;
-            addr[2] = LL_IP4_MULTICAST_ADDR_2;
-            addr[3] = group23 >> 16;
-            addr[4] = group23 >> 8;
-            addr[5] = group23;
-            ENET_AddMulticastGroup(ENET, addr);
+            k64f_mac_filter(addr, 1);
             return ERR_OK;
-        }
         case IGMP_DEL_MAC_FILTER:
-            /* As we don't reference count, silently ignore delete requests */
+            k64f_mac_filter(addr, 0);
             return ERR_OK;
         default:
             return ERR_ARG;
@@ -325,22 +397,15 @@ err_t igmp_mac_filter(struct netif *netif, const ip4_addr_t *group, u8_t action)
  */
 err_t mld_mac_filter(struct netif *netif, const ip6_addr_t *group, u8_t action)
 {
+    uint8_t addr[6];
+    eth_arch_mcast_ip6_addr(group, addr);
+
     switch (action) {
         case MLD6_ADD_MAC_FILTER:
-        {
-            uint32_t group32 = ntohl(group->addr[3]);
-            uint8_t addr[6];
-            addr[0] = LL_IP6_MULTICAST_ADDR_0;
-            addr[1] = LL_IP6_MULTICAST_ADDR_1;
-            addr[2] = group32 >> 24;
-            addr[3] = group32 >> 16;
-            addr[4] = group32 >> 8;
-            addr[5] = group32;
-            ENET_AddMulticastGroup(ENET, addr);
+            k64f_mac_filter(addr, 1);
             return ERR_OK;
-        }
         case MLD6_DEL_MAC_FILTER:
-            /* As we don't reference count, silently ignore delete requests */
+            k64f_mac_filter(addr, 0);
             return ERR_OK;
         default:
             return ERR_ARG;
@@ -348,132 +413,70 @@ err_t mld_mac_filter(struct netif *netif, const ip6_addr_t *group, u8_t action)
 }
 #endif
 
-/** \brief  Allocates a pbuf and returns the data from the incoming packet.
+/** \brief  Pass the received frames to lwIP and refill the descriptors
  *
- *  \param[in] netif the lwip network interface structure
- *  \param[in] idx   index of packet to be read
- *  \return a pbuf filled with the received packet (including MAC header)
+ * Called by the receive thread when woken up by the receive interrupt or
+ * by lwIP freeing a received frame, and again while frames keep coming.
+ * The frames are passed to lwIP in the buffers they were received in.
+ *
+ *  \param[in] rx      RX buffer pool of the interface
+ *  \param[in] budget  Maximum number of frames to receive
+ *  \return Number of frames received
  */
-static struct pbuf *k64f_low_level_input(struct netif *netif, int idx)
+static u16_t k64f_rx_poll(struct eth_arch_rx *rx, u16_t budget)
 {
-  volatile enet_rx_bd_struct_t *bdPtr = g_handle.rxBdCurrent;
-  struct pbuf *p = NULL;
-  struct pbuf *temp_rxbuf = NULL;
-  u32_t length = 0;
+  struct k64f_enetdata *k64f_enet = rx->arg;
   const u16_t err_mask = ENET_BUFFDESCRIPTOR_RX_TRUNC_MASK | ENET_BUFFDESCRIPTOR_RX_CRC_MASK |
                          ENET_BUFFDESCRIPTOR_RX_NOOCTET_MASK | ENET_BUFFDESCRIPTOR_RX_LENVLIOLATE_MASK;
+  u16_t received = 0;
 
+  while (received < budget && k64f_enet->rx_empty_count < ENET_RX_RING_LEN) {
+    uint8_t idx = k64f_enet->rx_next_index;
+    volatile enet_rx_bd_struct_t *bdPtr = &g_handle.rxBdBase[idx];
+    struct eth_arch_rx_buf *buf = rx_buff[idx];
 
-#ifdef LOCK_RX_THREAD
-  /* Get exclusive access */
-  sys_mutex_lock(&k64f_enet->TXLockMutex);
-#endif
+    /* Determine if a frame has been received */
+    if (bdPtr->control & ENET_BUFFDESCRIPTOR_RX_EMPTY_MASK)
+      break;
 
-  /* Determine if a frame has been received */
-  if ((bdPtr->control & err_mask) != 0) {
+    rx_buff[idx] = NULL;
+    k64f_enet->rx_next_index = (idx + 1) % ENET_RX_RING_LEN;
+    k64f_enet->rx_empty_count++;
+
+    if ((bdPtr->control & err_mask) != 0) {
 #if LINK_STATS
-    if ((bdPtr->control & ENET_BUFFDESCRIPTOR_RX_LENVLIOLATE_MASK) != 0)
-      LINK_STATS_INC(link.lenerr);
-    else
-      LINK_STATS_INC(link.chkerr);
+      if ((bdPtr->control & ENET_BUFFDESCRIPTOR_RX_LENVLIOLATE_MASK) != 0)
+        LINK_STATS_INC(link.lenerr);
+      else
+        LINK_STATS_INC(link.chkerr);
 #endif
-    LINK_STATS_INC(link.drop);
-    /* Re-use the same buffer in case of error */
-    update_read_buffer(NULL);
-  } else {
-    /* A packet is waiting, get length */
-    length = bdPtr->length;
-
-    /* Zero-copy */
-    p = rx_buff[idx];
-    p->len = length;
-
-    /* Attempt to queue new buffer */
-    temp_rxbuf = pbuf_alloc(PBUF_RAW, ENET_ETH_MAX_FLEN + ENET_BUFF_ALIGNMENT, PBUF_RAM);
-    if (NULL == temp_rxbuf) {
-      /* Drop frame (out of memory) */
-      LINK_STATS_INC(link.drop);
-
-      /* Re-queue the same buffer */
-      update_read_buffer(NULL);
-
+      /* Re-use the same buffer in case of error */
+      eth_arch_rx_drop(buf);
+    } else {
       LWIP_DEBUGF(UDP_LPC_EMAC | LWIP_DBG_TRACE,
-        ("k64f_low_level_input: Packet index %d dropped for OOM\n",
-        idx));
-#ifdef LOCK_RX_THREAD
-      sys_mutex_unlock(&k64f_enet->TXLockMutex);
-#endif
+        ("k64f_rx_poll: Packet received: %p, size %d (index=%d)\n",
+        buf->data, bdPtr->length, idx));
 
-      return NULL;
+      /* Zero-copy */
+      eth_arch_rx_input(buf, bdPtr->length);
     }
+    received++;
 
-    rx_buff[idx] = temp_rxbuf;
-    /* K64F note: the next line ensures that the RX buffer is properly aligned for the K64F
-       RX descriptors (16 bytes alignment). However, by doing so, we're effectively changing
-       a data structure which is internal to lwIP. This might not prove to be a good idea
-       in the long run, but a better fix would probably involve modifying lwIP itself */
-    rx_buff[idx]->payload = (void*)ENET_ALIGN((uint32_t)rx_buff[idx]->payload, ENET_BUFF_ALIGNMENT);
-    rx_ptr[idx] = rx_buff[idx]->payload;
-
-    update_read_buffer(rx_buff[idx]->payload);
-    LWIP_DEBUGF(UDP_LPC_EMAC | LWIP_DBG_TRACE,
-      ("k64f_low_level_input: Packet received: %p, size %"PRIu32" (index=%d)\n",
-      p, length, idx));
-
-    /* Save size */
-    p->tot_len = (u16_t) length;
-    LINK_STATS_INC(link.recv);
+    /* The descriptor goes back to the DMA right away, so reception goes
+     * on for as long as the budget lasts */
+    k64f_rx_refill(k64f_enet);
   }
 
-#ifdef LOCK_RX_THREAD
-  sys_mutex_unlock(&k64f_enet->TXLockMutex);
-#endif
+  /* Receive FIFO overflows, counted by the MIB */
+  rx->overruns = ENET->IEEE_R_MACERR;
 
-  return p;
+  k64f_rx_refill(k64f_enet);
+  return received;
 }
 
-/** \brief  Attempt to read a packet from the EMAC interface.
- *
- *  \param[in] netif the lwip network interface structure
- *  \param[in] idx   index of packet to be read
- */
-void k64f_enetif_input(struct netif *netif, int idx)
+static void k64f_rx_irq_enable(struct eth_arch_rx *rx)
 {
-  struct pbuf *p;
-
-  /* move received packet into a new pbuf */
-  p = k64f_low_level_input(netif, idx);
-  if (p == NULL)
-    return;
-
-  /* pass all packets to ethernet_input, which decides what packets it supports */
-  if (netif->input(p, netif) != ERR_OK) {
-      LWIP_DEBUGF(NETIF_DEBUG, ("k64f_enetif_input: input error\n"));
-      /* Free buffer */
-      pbuf_free(p);
-  }
-}
-
-/** \brief  Packet reception task
- *
- * This task is called when a packet is received. It will
- * pass the packet to the LWIP core.
- *
- *  \param[in] pvParameters pointer to the interface data
- */
-static void packet_rx(void* pvParameters) {
-  struct k64f_enetdata *k64f_enet = pvParameters;
-  int idx = 0;
-
-  while (1) {
-    /* Wait for receive task to wakeup */
-    sys_arch_sem_wait(&k64f_enet->RxReadySem, 0);
-
-    while ((g_handle.rxBdCurrent->control & ENET_BUFFDESCRIPTOR_RX_EMPTY_MASK) == 0) {
-      k64f_enetif_input(k64f_enet->netif, idx);
-      idx = (idx + 1) % ENET_RX_RING_LEN;
-    }
-  }
+  ENET_EnableInterrupts(ENET, kENET_RxFrameInterrupt);
 }
 
 /** \brief  Transmit cleanup task
@@ -656,6 +659,11 @@ err_t eth_arch_enetif_init(struct netif *netif)
   // TODOETH: check if the flags are correct below
   netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
 
+  /* checksums are inserted and verified by the ENET accelerator, UDP and
+     ICMP are still verified in software as it skips fragmented datagrams */
+  NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_CHECK_UDP |
+                                 NETIF_CHECKSUM_CHECK_ICMP | NETIF_CHECKSUM_CHECK_ICMP6);
+
   /* Initialize the hardware */
   netif->state = &k64f_enetdata;
   err = low_level_init(netif);
@@ -702,13 +710,10 @@ err_t eth_arch_enetif_init(struct netif *netif)
   LWIP_ASSERT("TXLockMutex creation error", (err == ERR_OK));
 
   /* Packet receive task */
-  err = sys_sem_new(&k64f_enetdata.RxReadySem, 0);
-  LWIP_ASSERT("RxReadySem creation error", (err == ERR_OK));
-
 #ifdef LWIP_DEBUG
-  sys_thread_new("receive_thread", packet_rx, netif->state, DEFAULT_THREAD_STACKSIZE*5, RX_PRIORITY);
+  eth_arch_rx_start(&k64f_enetdata.rx, "receive_thread", DEFAULT_THREAD_STACKSIZE*5, RX_PRIORITY);
 #else
-  sys_thread_new("receive_thread", packet_rx, netif->state, DEFAULT_THREAD_STACKSIZE, RX_PRIORITY);
+  eth_arch_rx_start(&k64f_enetdata.rx, "receive_thread", DEFAULT_THREAD_STACKSIZE, RX_PRIORITY);
 #endif
 
   /* Transmit cleanup task */
@@ -35,6 +35,9 @@
 #define ENET_RX_RING_LEN              (16)
 #define ENET_TX_RING_LEN              (8)
 
+// RX buffers, the ones beyond the ring hold frames not yet freed by lwIP
+#define ENET_RX_POOL_LEN              (ENET_RX_RING_LEN + ENET_RX_RING_LEN/2)
+
 #define ENET_ETH_MAX_FLEN             (1522) // recommended size for a VLAN frame
 
 #if defined(__cplusplus)
@@ -3,42 +3,54 @@
 #include "netif/etharp.h"
 #include "lwip/tcpip.h"
 #include "lwip/ethip6.h"
+#include "lwip/stats.h"
+#include "lwip/igmp.h"
+#include "lwip/mld6.h"
 #include <string.h>
 #include "cmsis_os.h"
 #include "mbed_interface.h"
+#include "mbed_cache.h"
+#include "eth_arch_rx.h"
+#include "eth_arch_mcast.h"
 
 #define RECV_TASK_PRI           (osPriorityHigh)
 #define PHY_TASK_PRI            (osPriorityLow)
 #define PHY_TASK_WAIT           (200)
 #define ETH_ARCH_PHY_ADDRESS    (0x00)
 
+/* Receive buffers, more than descriptors so descriptors can be refilled
+   while lwIP still holds received frames */
+#ifndef ETH_RX_POOL_LEN
+#define ETH_RX_POOL_LEN         (ETH_RXBUFNB * 2)
+#endif
+
+/* Receive buffers take whole cache lines, so invalidating one after the
+   DMA wrote it does not drop data of its neighbours */
+#define ETH_RX_BUF_STRIDE       MBED_CACHE_ROUND_UP(ETH_RX_BUF_SIZE)
+
 ETH_HandleTypeDef EthHandle;
 
-#if defined (__ICCARM__)   /*!< IAR Compiler */
-  #pragma data_alignment=4
-#endif
-__ALIGN_BEGIN ETH_DMADescTypeDef DMARxDscrTab[ETH_RXBUFNB] __ALIGN_END; /* Ethernet Rx DMA Descriptor */
+/* Descriptors and buffers are aligned on cache lines, a descriptor takes
+   one line on the Cortex-M7 */
+MBED_CACHE_ALIGNED ETH_DMADescTypeDef DMARxDscrTab[ETH_RXBUFNB]; /* Ethernet Rx DMA Descriptor */
 
-#if defined (__ICCARM__)   /*!< IAR Compiler */
-  #pragma data_alignment=4
-#endif
-__ALIGN_BEGIN ETH_DMADescTypeDef DMATxDscrTab[ETH_TXBUFNB] __ALIGN_END; /* Ethernet Tx DMA Descriptor */
+MBED_CACHE_ALIGNED ETH_DMADescTypeDef DMATxDscrTab[ETH_TXBUFNB]; /* Ethernet Tx DMA Descriptor */
 
-#if defined (__ICCARM__)   /*!< IAR Compiler */
-  #pragma data_alignment=4
-#endif
-__ALIGN_BEGIN uint8_t Rx_Buff[ETH_RXBUFNB][ETH_RX_BUF_SIZE] __ALIGN_END; /* Ethernet Receive Buffer */
+MBED_CACHE_ALIGNED uint8_t Rx_Buff[ETH_RX_POOL_LEN][ETH_RX_BUF_STRIDE]; /* Ethernet Receive Buffer */
 
-#if defined (__ICCARM__)   /*!< IAR Compiler */
-  #pragma data_alignment=4
-#endif
-__ALIGN_BEGIN uint8_t Tx_Buff[ETH_TXBUFNB][ETH_TX_BUF_SIZE] __ALIGN_END; /* Ethernet Transmit Buffer */
+MBED_CACHE_ALIGNED uint8_t Tx_Buff[ETH_TXBUFNB][ETH_TX_BUF_SIZE]; /* Ethernet Transmit Buffer */
 
-static sys_sem_t rx_ready_sem;    /* receive ready semaphore */
+static struct eth_arch_rx eth_rx;  /* receive buffer pool */
+static struct eth_arch_rx_buf *rx_desc_buf[ETH_RXBUFNB]; /* buffer of each Rx descriptor */
+static uint32_t rx_next_index;     /* next descriptor to receive in */
+static uint32_t rx_fill_index;     /* next descriptor to give a buffer */
+static uint32_t rx_empty_count;    /* descriptors without a buffer */
+static struct eth_arch_mcast eth_mcast; /* groups joined on each hash bit */
 static sys_mutex_t tx_lock_mutex;
 
 /* function */
-static void _eth_arch_rx_task(void *arg);
+static u16_t _eth_arch_rx_poll(struct eth_arch_rx *rx, u16_t budget);
+static void _eth_arch_rx_irq_enable(struct eth_arch_rx *rx);
 static void _eth_arch_phy_task(void *arg);
 
 #if LWIP_IPV4
@@ -49,7 +61,6 @@ static err_t _eth_arch_netif_output_ipv6(struct netif *netif, struct pbuf *q, co
 #endif
 
 static err_t _eth_arch_low_level_output(struct netif *netif, struct pbuf *p);
-static struct pbuf * _eth_arch_low_level_input(struct netif *netif);
 __weak uint8_t mbed_otp_mac_address(char *mac);
 void mbed_default_mac_address(char *mac);
 
@@ -61,7 +72,9 @@ void mbed_default_mac_address(char *mac);
  */
 void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth)
 {
-    sys_sem_signal(&rx_ready_sem);
+    /* masked until the receive thread has processed all frames */
+    __HAL_ETH_DMA_DISABLE_IT(heth, ETH_DMA_IT_R);
+    eth_arch_rx_signal(&eth_rx);
 }
 
 
@@ -88,6 +101,7 @@ void ETH_IRQHandler(void)
 static void _eth_arch_low_level_init(struct netif *netif)
 {
     uint32_t regvalue = 0;
+    uint32_t i;
     HAL_StatusTypeDef hal_eth_init_status;
 
     /* Init ETH */
@@ -113,12 +127,35 @@ static void _eth_arch_low_level_init(struct netif *netif)
     EthHandle.Init.MediaInterface = ETH_MEDIA_INTERFACE_RMII;
     hal_eth_init_status = HAL_ETH_Init(&EthHandle);
 
+    /* Multicast frames are filtered by the hash table, which the IGMP and
+       MLD filters fill with the joined groups */
+    EthHandle.Instance->MACHTHR = 0;
+    EthHandle.Instance->MACHTLR = 0;
+    regvalue = EthHandle.Instance->MACFFR | ETH_MULTICASTFRAMESFILTER_HASHTABLE;
+    EthHandle.Instance->MACFFR = regvalue;
+    /* Wait until the write operation will be taken into account */
+    HAL_Delay(ETH_REG_WRITE_DELAY);
+    EthHandle.Instance->MACFFR = regvalue;
+
     /* Initialize Tx Descriptors list: Chain Mode */
     HAL_ETH_DMATxDescListInit(&EthHandle, DMATxDscrTab, &Tx_Buff[0][0], ETH_TXBUFNB);
 
     /* Initialize Rx Descriptors list: Chain Mode  */
     HAL_ETH_DMARxDescListInit(&EthHandle, DMARxDscrTab, &Rx_Buff[0][0], ETH_RXBUFNB);
 
+    /* Give the descriptors the first ETH_RXBUFNB buffers of the pool, which
+       are further apart than the ones the HAL set up */
+    for (i = 0; i < ETH_RXBUFNB; i++) {
+        rx_desc_buf[i] = eth_arch_rx_alloc(&eth_rx);
+        DMARxDscrTab[i].Buffer1Addr = (uint32_t)rx_desc_buf[i]->data;
+    }
+    mbed_dcache_clean_invalidate(Rx_Buff, sizeof(Rx_Buff));
+    mbed_dcache_clean(DMARxDscrTab, sizeof(DMARxDscrTab));
+    mbed_dcache_clean(DMATxDscrTab, sizeof(DMATxDscrTab));
+    rx_next_index = 0;
+    rx_fill_index = 0;
+    rx_empty_count = 0;
+
  #if LWIP_ARP || LWIP_ETHERNET
     /* set MAC hardware address length */
     netif->hwaddr_len = ETH_HWADDR_LEN;
@@ -174,6 +211,9 @@ static err_t _eth_arch_low_level_output(struct netif *netif, struct pbuf *p)
 
     sys_mutex_lock(&tx_lock_mutex);
 
+    /* See the descriptors the DMA gave back, the CPU lines are all clean */
+    mbed_dcache_invalidate(DMATxDscrTab, sizeof(DMATxDscrTab));
+
     /* copy frame from pbufs to driver buffers */
     for (q = p; q != NULL; q = q->next) {
         /* Is this buffer available? If not, goto error */
@@ -190,6 +230,7 @@ static err_t _eth_arch_low_level_output(struct netif *netif, struct pbuf *p)
         while ((byteslefttocopy + bufferoffset) > ETH_TX_BUF_SIZE) {
             /* Copy data to Tx buffer*/
             memcpy((uint8_t*)((uint8_t*)buffer + bufferoffset), (uint8_t*)((uint8_t*)q->payload + payloadoffset), (ETH_TX_BUF_SIZE - bufferoffset));
+            mbed_dcache_clean(buffer, ETH_TX_BUF_SIZE);
 
             /* Point to next descriptor */
             DmaTxDesc = (ETH_DMADescTypeDef*)(DmaTxDesc->Buffer2NextDescAddr);
@@ -213,10 +254,16 @@ static err_t _eth_arch_low_level_output(struct netif *netif, struct pbuf *p)
         bufferoffset = bufferoffset + byteslefttocopy;
         framelength = framelength + byteslefttocopy;
     }
+    mbed_dcache_clean(buffer, bufferoffset);
 
     /* Prepare transmit descriptors to give to DMA */
     HAL_ETH_TransmitFrame(&EthHandle, framelength);
 
+    /* The DMA may have polled the descriptors before they reached memory,
+       so poll again once they are there */
+    mbed_dcache_clean(DMATxDscrTab, sizeof(DMATxDscrTab));
+    EthHandle.Instance->DMATPDR = 0;
+
     errval = ERR_OK;
 
 error:
@@ -237,75 +284,35 @@ error:
 
 
 /**
- * Should allocate a pbuf and transfer the bytes of the incoming
- * packet from the interface into the pbuf.
+ * Gives free buffers to the Rx descriptors that lack one, and resumes
+ * reception if the DMA ran out of descriptors.
  *
- * @param netif the lwip network interface structure for this ethernetif
- * @return a pbuf filled with the received packet (including MAC header)
- *         NULL on memory error
+ * Descriptors are refilled in order, reception stops at the first
+ * descriptor without a buffer until lwIP frees one.
+ *
+ * @param rx the receive buffer pool
  */
-static struct pbuf * _eth_arch_low_level_input(struct netif *netif)
+static void _eth_arch_rx_refill(struct eth_arch_rx *rx)
 {
-    struct pbuf *p = NULL;
-    struct pbuf *q;
-    uint16_t len = 0;
-    uint8_t *buffer;
-    __IO ETH_DMADescTypeDef *dmarxdesc;
-    uint32_t bufferoffset = 0;
-    uint32_t payloadoffset = 0;
-    uint32_t byteslefttocopy = 0;
-    uint32_t i = 0;
-
-
-    /* get received frame */
-    if (HAL_ETH_GetReceivedFrame(&EthHandle) != HAL_OK)
-        return NULL;
+    while (rx_empty_count > 0) {
+        __IO ETH_DMADescTypeDef *dmarxdesc = &DMARxDscrTab[rx_fill_index];
+        struct eth_arch_rx_buf *buf = eth_arch_rx_alloc(rx);
 
-    /* Obtain the size of the packet and put it into the "len" variable. */
-    len = EthHandle.RxFrameInfos.length;
-    buffer = (uint8_t*)EthHandle.RxFrameInfos.buffer;
-
-    if (len > 0) {
-        /* We allocate a pbuf chain of pbufs from the Lwip buffer pool */
-        p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
-    }
-
-    if (p != NULL) {
-        dmarxdesc = EthHandle.RxFrameInfos.FSRxDesc;
-        bufferoffset = 0;
-        for (q = p; q != NULL; q = q->next) {
-            byteslefttocopy = q->len;
-            payloadoffset = 0;
-
-            /* Check if the length of bytes to copy in current pbuf is bigger than Rx buffer size*/
-            while ((byteslefttocopy + bufferoffset) > ETH_RX_BUF_SIZE) {
-                /* Copy data to pbuf */
-                memcpy((uint8_t*)((uint8_t*)q->payload + payloadoffset), (uint8_t*)((uint8_t*)buffer + bufferoffset), (ETH_RX_BUF_SIZE - bufferoffset));
-
-                /* Point to next descriptor */
-                dmarxdesc = (ETH_DMADescTypeDef*)(dmarxdesc->Buffer2NextDescAddr);
-                buffer = (uint8_t*)(dmarxdesc->Buffer1Addr);
-
-                byteslefttocopy = byteslefttocopy - (ETH_RX_BUF_SIZE - bufferoffset);
-                payloadoffset = payloadoffset + (ETH_RX_BUF_SIZE - bufferoffset);
-                bufferoffset = 0;
-            }
-            /* Copy remaining data in pbuf */
-            memcpy((uint8_t*)((uint8_t*)q->payload + payloadoffset), (uint8_t*)((uint8_t*)buffer + bufferoffset), byteslefttocopy);
-            bufferoffset = bufferoffset + byteslefttocopy;
+        if (!buf) {
+            break;
         }
 
-        /* Release descriptors to DMA */
-        /* Point to first descriptor */
-        dmarxdesc = EthHandle.RxFrameInfos.FSRxDesc;
-        /* Set Own bit in Rx descriptors: gives the buffers back to DMA */
-        for (i = 0; i < EthHandle.RxFrameInfos.SegCount; i++) {
-            dmarxdesc->Status |= ETH_DMARXDESC_OWN;
-            dmarxdesc = (ETH_DMADescTypeDef*)(dmarxdesc->Buffer2NextDescAddr);
-        }
+        /* Writes lwIP left in the free buffer must not land over the frame */
+        mbed_dcache_invalidate(buf->data, ETH_RX_BUF_STRIDE);
 
-        /* Clear Segment_Count */
-        EthHandle.RxFrameInfos.SegCount = 0;
+        rx_desc_buf[rx_fill_index] = buf;
+        dmarxdesc->Buffer1Addr = (uint32_t)buf->data;
+        /* Set Own bit in Rx descriptor: gives the buffer to DMA */
+        dmarxdesc->Status = ETH_DMARXDESC_OWN;
+        mbed_dcache_clean((void *)dmarxdesc, sizeof(ETH_DMADescTypeDef));
+
+        rx_fill_index = (rx_fill_index + 1) % ETH_RXBUFNB;
+        rx_empty_count--;
     }
 
     /* When Rx Buffer unavailable flag is set: clear it and resume reception */
@@ -315,29 +322,74 @@ static struct pbuf * _eth_arch_low_level_input(struct netif *netif)
         /* Resume DMA reception */
         EthHandle.Instance->DMARPDR = 0;
     }
-    return p;
 }
 
 /**
- * This task receives input data
+ * Passes received frames to lwIP and gives free buffers to the Rx
+ * descriptors that lack one. Called from the receive thread, and again
+ * while frames keep coming.
  *
- * \param[in] netif the lwip network interface structure
+ * @param rx the receive buffer pool
+ * @param budget maximum number of frames to receive
+ * @return number of frames received
  */
-static void _eth_arch_rx_task(void *arg)
+static u16_t _eth_arch_rx_poll(struct eth_arch_rx *rx, u16_t budget)
 {
-    struct netif   *netif = (struct netif*)arg;
-    struct pbuf    *p;
+    u16_t received = 0;
 
-    while (1) {
-        sys_arch_sem_wait(&rx_ready_sem, 0);
-        p = _eth_arch_low_level_input(netif);
-        if (p != NULL) {
-            if (netif->input(p, netif) != ERR_OK) {
-                pbuf_free(p);
-                p = NULL;
-            }
+    while (received < budget && rx_empty_count < ETH_RXBUFNB) {
+        __IO ETH_DMADescTypeDef *dmarxdesc = &DMARxDscrTab[rx_next_index];
+        struct eth_arch_rx_buf *buf = rx_desc_buf[rx_next_index];
+        uint32_t status;
+
+        mbed_dcache_invalidate((void *)dmarxdesc, sizeof(ETH_DMADescTypeDef));
+        status = dmarxdesc->Status;
+
+        if ((status & ETH_DMARXDESC_OWN) != (uint32_t)RESET) {
+            break;
+        }
+
+        rx_desc_buf[rx_next_index] = NULL;
+        rx_next_index = (rx_next_index + 1) % ETH_RXBUFNB;
+        rx_empty_count++;
+
+        /* Rx buffers hold a whole frame, anything spanning descriptors is an error */
+        if ((status & (ETH_DMARXDESC_ES | ETH_DMARXDESC_FS | ETH_DMARXDESC_LS)) ==
+                (ETH_DMARXDESC_FS | ETH_DMARXDESC_LS)) {
+            /* frame length includes the CRC */
+            uint16_t len = ((status & ETH_DMARXDESC_FL) >> ETH_DMARXDESC_FRAMELENGTHSHIFT) - 4;
+            /* Drop the lines the CPU may have read ahead during reception */
+            mbed_dcache_invalidate(buf->data, ETH_RX_BUF_STRIDE);
+            eth_arch_rx_input(buf, len);
+        } else {
+            LINK_STATS_INC(link.err);
+            eth_arch_rx_drop(buf);
         }
+        received++;
+
+        /* The descriptor goes back to the DMA right away, so reception
+           goes on for as long as the budget lasts */
+        _eth_arch_rx_refill(rx);
     }
+
+    _eth_arch_rx_refill(rx);
+
+    /* Frames missed for lack of a descriptor or by a FIFO overflow, the
+       counters clear on read */
+    uint32_t missed = EthHandle.Instance->DMAMFBOCR;
+    rx->overruns += (missed & ETH_DMAMFBOCR_MFC) + ((missed & ETH_DMAMFBOCR_MFA) >> 17);
+
+    return received;
+}
+
+/**
+ * Unmasks the receive interrupt once the receive thread finds no more frames.
+ *
+ * @param rx the receive buffer pool
+ */
+static void _eth_arch_rx_irq_enable(struct eth_arch_rx *rx)
+{
+    __HAL_ETH_DMA_ENABLE_IT(&EthHandle, ETH_DMA_IT_R);
 }
 
 /**
@@ -404,6 +456,71 @@ static err_t _eth_arch_netif_output_ipv6(struct netif *netif, struct pbuf *q, co
 }
 #endif
 
+/**
+ * Join or leave a multicast MAC address in the hash table.
+ *
+ * The MAC indexes the table with the upper 6 bits of the bit reversed,
+ * complemented CRC of the address. Groups sharing a bit are counted, so
+ * leaving a group keeps the others.
+ *
+ * @param addr multicast MAC address
+ * @param join 1 to join the address, 0 to leave it
+ */
+static void _eth_arch_mac_filter(const uint8_t *addr, int join)
+{
+    unsigned hash = __RBIT(~eth_arch_mcast_crc(addr)) >> 26;
+    volatile uint32_t *table = (hash & 32) ? &EthHandle.Instance->MACHTHR : &EthHandle.Instance->MACHTLR;
+    uint32_t bit = 1UL << (hash & 31);
+
+    if (join) {
+        if (eth_arch_mcast_join(&eth_mcast, hash)) {
+            *table |= bit;
+        }
+    } else {
+        if (eth_arch_mcast_leave(&eth_mcast, hash)) {
+            *table &= ~bit;
+        }
+    }
+}
+
+#if LWIP_IGMP
+static err_t _eth_arch_igmp_mac_filter(struct netif *netif, const ip4_addr_t *group, u8_t action)
+{
+    uint8_t addr[6];
+    eth_arch_mcast_ip4_addr(group, addr);
+
+    switch (action) {
+        case IGMP_ADD_MAC_FILTER:
+            _eth_arch_mac_filter(addr, 1);
+            return ERR_OK;
+        case IGMP_DEL_MAC_FILTER:
+            _eth_arch_mac_filter(addr, 0);
+            return ERR_OK;
+        default:
+            return ERR_ARG;
+    }
+}
+#endif
+
+#if LWIP_IPV6_MLD
+static err_t _eth_arch_mld_mac_filter(struct netif *netif, const ip6_addr_t *group, u8_t action)
+{
+    uint8_t addr[6];
+    eth_arch_mcast_ip6_addr(group, addr);
+
+    switch (action) {
+        case MLD6_ADD_MAC_FILTER:
+            _eth_arch_mac_filter(addr, 1);
+            return ERR_OK;
+        case MLD6_DEL_MAC_FILTER:
+            _eth_arch_mac_filter(addr, 0);
+            return ERR_OK;
+        default:
+            return ERR_ARG;
+    }
+}
+#endif
+
 /**
  * Should be called at the beginning of the program to set up the
  * network interface.
@@ -426,6 +543,11 @@ err_t eth_arch_enetif_init(struct netif *netif)
     /* device capabilities */
     netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET;
 
+    /* checksums are inserted and verified by the MAC (ETH_CHECKSUM_BY_HARDWARE),
+       UDP and ICMP are still verified in software as it skips fragmented datagrams */
+    NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_CHECK_UDP |
+                                   NETIF_CHECKSUM_CHECK_ICMP | NETIF_CHECKSUM_CHECK_ICMP6);
+
 #if LWIP_NETIF_HOSTNAME
     /* Initialize interface hostname */
     netif->hostname = "lwipstm32";
@@ -436,27 +558,36 @@ err_t eth_arch_enetif_init(struct netif *netif)
 
 #if LWIP_IPV4
     netif->output = _eth_arch_netif_output_ipv4;
+#if LWIP_IGMP
+    netif->igmp_mac_filter = _eth_arch_igmp_mac_filter;
     netif->flags |= NETIF_FLAG_IGMP;
 #endif
+#endif
 #if LWIP_IPV6
     netif->output_ip6 = _eth_arch_netif_output_ipv6;
+#if LWIP_IPV6_MLD
+    netif->mld_mac_filter = _eth_arch_mld_mac_filter;
     netif->flags |= NETIF_FLAG_MLD6;
+#endif
 #endif
 
     netif->linkoutput = _eth_arch_low_level_output;
 
-    /* semaphore */
-    sys_sem_new(&rx_ready_sem, 0);
+    /* receive buffer pool */
+    if (eth_arch_rx_init(&eth_rx, netif, Rx_Buff, ETH_RX_POOL_LEN, ETH_RX_BUF_STRIDE,
+                         _eth_arch_rx_poll, _eth_arch_rx_irq_enable, NULL) != ERR_OK) {
+        return ERR_MEM;
+    }
 
     sys_mutex_new(&tx_lock_mutex);
 
-    /* task */
-    sys_thread_new("_eth_arch_rx_task", _eth_arch_rx_task, netif, DEFAULT_THREAD_STACKSIZE, RECV_TASK_PRI);
-    sys_thread_new("_eth_arch_phy_task", _eth_arch_phy_task, netif, DEFAULT_THREAD_STACKSIZE, PHY_TASK_PRI);
-
     /* initialize the hardware */
     _eth_arch_low_level_init(netif);
 
+    /* task */
+    eth_arch_rx_start(&eth_rx, "_eth_arch_rx_task", DEFAULT_THREAD_STACKSIZE, RECV_TASK_PRI);
+    sys_thread_new("_eth_arch_phy_task", _eth_arch_phy_task, netif, DEFAULT_THREAD_STACKSIZE, PHY_TASK_PRI);
+
     return ERR_OK;
 }
 
@@ -0,0 +1,83 @@
+/* Copyright (C) 2017 ARM Limited. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "eth_arch_mcast.h"
+
+#include "lwip/def.h"
+#include "netif/etharp.h"
+
+u32_t eth_arch_mcast_crc(const u8_t *addr)
+{
+    u32_t crc = 0xFFFFFFFF;
+
+    for (int i = 0; i < ETH_HWADDR_LEN; i++) {
+        crc ^= addr[i];
+        for (int j = 0; j < 8; j++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+        }
+    }
+
+    return crc;
+}
+
+int eth_arch_mcast_join(struct eth_arch_mcast *mcast, unsigned hash)
+{
+    /* a saturated bit stays set, accepting more than needed */
+    if (mcast->refs[hash] == 0xFF) {
+        return 0;
+    }
+
+    return mcast->refs[hash]++ == 0;
+}
+
+int eth_arch_mcast_leave(struct eth_arch_mcast *mcast, unsigned hash)
+{
+    if (mcast->refs[hash] == 0 || mcast->refs[hash] == 0xFF) {
+        return 0;
+    }
+
+    return --mcast->refs[hash] == 0;
+}
+
+#if LWIP_IPV4
+void eth_arch_mcast_ip4_addr(const ip4_addr_t *group, u8_t *addr)
+{
+    u32_t group23 = lwip_ntohl(ip4_addr_get_u32(group)) & 0x007FFFFF;
+
+    addr[0] = LL_IP4_MULTICAST_ADDR_0;
+    addr[1] = LL_IP4_MULTICAST_ADDR_1;
+    addr[2] = LL_IP4_MULTICAST_ADDR_2;
+    addr[3] = group23 >> 16;
+    addr[4] = group23 >> 8;
+    addr[5] = group23;
+}
+#endif
+
+#if LWIP_IPV6
+void eth_arch_mcast_ip6_addr(const ip6_addr_t *group, u8_t *addr)
+{
+    u32_t group32 = lwip_ntohl(group->addr[3]);
+
+    addr[0] = LL_IP6_MULTICAST_ADDR_0;
+    addr[1] = LL_IP6_MULTICAST_ADDR_1;
+    addr[2] = group32 >> 24;
+    addr[3] = group32 >> 16;
+    addr[4] = group32 >> 8;
+    addr[5] = group32;
+}
+#endif
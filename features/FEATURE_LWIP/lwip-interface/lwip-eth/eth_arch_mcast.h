@@ -0,0 +1,82 @@
+/* Copyright (C) 2017 ARM Limited. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Multicast hash filtering for Ethernet drivers
+//
+// MACs hash the destination address of multicast frames into a 64 bit
+// table, from the CRC-32 of the address, and accept the frames whose bit
+// is set. Several groups may share a bit, so the groups joined on each bit
+// are counted and a bit is only cleared when its last group is left.
+
+#ifndef ETH_ARCH_MCAST_H_
+#define ETH_ARCH_MCAST_H_
+
+#include "lwip/opt.h"
+#include "lwip/ip_addr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ETH_ARCH_MCAST_HASH_BITS 64
+
+/** Groups joined on each bit of a hash table */
+struct eth_arch_mcast {
+    u8_t refs[ETH_ARCH_MCAST_HASH_BITS];
+};
+
+/** CRC-32 of a MAC address, as MACs compute it for their hash table
+ *
+ *  The CRC is reflected, starts from 0xFFFFFFFF and is not complemented.
+ *
+ *  @param addr       The 6 bytes of the address
+ *  @return           The CRC
+ */
+u32_t eth_arch_mcast_crc(const u8_t *addr);
+
+/** Count a group joined on a bit
+ *
+ *  @param mcast      Counters of the table
+ *  @param hash       Bit of the group, below ETH_ARCH_MCAST_HASH_BITS
+ *  @return           1 if the bit has to be set in the table
+ */
+int eth_arch_mcast_join(struct eth_arch_mcast *mcast, unsigned hash);
+
+/** Count a group left on a bit
+ *
+ *  @param mcast      Counters of the table
+ *  @param hash       Bit of the group, below ETH_ARCH_MCAST_HASH_BITS
+ *  @return           1 if the bit has to be cleared in the table
+ */
+int eth_arch_mcast_leave(struct eth_arch_mcast *mcast, unsigned hash);
+
+#if LWIP_IPV4
+/** MAC address an IPv4 group is sent to */
+void eth_arch_mcast_ip4_addr(const ip4_addr_t *group, u8_t *addr);
+#endif
+
+#if LWIP_IPV6
+/** MAC address an IPv6 group is sent to */
+void eth_arch_mcast_ip6_addr(const ip6_addr_t *group, u8_t *addr);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,204 @@
+/* Copyright (C) 2017 ARM Limited. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "eth_arch_rx.h"
+
+#include "lwip/mem.h"
+#include "lwip/stats.h"
+
+/* Initialized pools, for the statistics */
+static struct eth_arch_rx *eth_arch_rx_pools;
+
+static void eth_arch_rx_pbuf_free(struct pbuf *p)
+{
+    struct eth_arch_rx_buf *buf = (struct eth_arch_rx_buf *)p;
+
+    eth_arch_rx_free(buf);
+
+    /* descriptors may be waiting for a buffer */
+    sys_sem_signal(&buf->rx->sem);
+}
+
+static void eth_arch_rx_thread(void *arg)
+{
+    struct eth_arch_rx *rx = (struct eth_arch_rx *)arg;
+
+    const u16_t budget = ETH_ARCH_RX_BUDGET ? ETH_ARCH_RX_BUDGET : 0xffff;
+
+    while (1) {
+        sys_arch_sem_wait(&rx->sem, 0);
+
+        /* poll with the interrupt masked for as long as frames keep coming */
+        while (1) {
+            u16_t received = rx->poll(rx, budget);
+
+            if (received >= budget) {
+                /* more are likely pending, let lwIP process these first */
+                osThreadYield();
+                continue;
+            }
+
+#if ETH_ARCH_RX_HOLDOFF
+            if (received > 0) {
+                osDelay(ETH_ARCH_RX_HOLDOFF);
+                continue;
+            }
+#endif
+
+            break;
+        }
+
+        if (rx->irq_enable) {
+            rx->irq_enable(rx);
+        }
+    }
+}
+
+err_t eth_arch_rx_init(struct eth_arch_rx *rx, struct netif *netif,
+                       void *buffers, u16_t count, u16_t size,
+                       eth_arch_rx_poll_fn poll, eth_arch_rx_fn irq_enable, void *arg)
+{
+    u16_t i;
+
+    rx->netif = netif;
+    rx->count = count;
+    rx->size = size;
+    rx->poll = poll;
+    rx->irq_enable = irq_enable;
+    rx->arg = arg;
+    rx->free = NULL;
+    rx->drops = 0;
+    rx->overruns = 0;
+
+    rx->bufs = (struct eth_arch_rx_buf *)mem_malloc(count * sizeof(struct eth_arch_rx_buf));
+    if (!rx->bufs) {
+        return ERR_MEM;
+    }
+
+    /* the free list hands out the buffers in order */
+    for (i = count; i > 0; i--) {
+        struct eth_arch_rx_buf *buf = &rx->bufs[i - 1];
+        buf->pc.custom_free_function = eth_arch_rx_pbuf_free;
+        buf->rx = rx;
+        buf->data = (u8_t *)buffers + (i - 1) * size;
+        buf->next = rx->free;
+        rx->free = buf;
+    }
+
+    if (sys_sem_new(&rx->sem, 0) != ERR_OK) {
+        mem_free(rx->bufs);
+        rx->bufs = NULL;
+        return ERR_MEM;
+    }
+
+    rx->next = eth_arch_rx_pools;
+    eth_arch_rx_pools = rx;
+
+    return ERR_OK;
+}
+
+void eth_arch_rx_deinit(struct eth_arch_rx *rx)
+{
+    struct eth_arch_rx **p;
+
+    for (p = &eth_arch_rx_pools; *p; p = &(*p)->next) {
+        if (*p == rx) {
+            *p = rx->next;
+            break;
+        }
+    }
+
+    sys_sem_free(&rx->sem);
+    mem_free(rx->bufs);
+    rx->bufs = NULL;
+    rx->free = NULL;
+}
+
+void eth_arch_rx_start(struct eth_arch_rx *rx, const char *name, int stacksize, int prio)
+{
+    sys_thread_new(name, eth_arch_rx_thread, rx, stacksize, prio);
+}
+
+void eth_arch_rx_signal(struct eth_arch_rx *rx)
+{
+    sys_sem_signal(&rx->sem);
+}
+
+struct eth_arch_rx_buf *eth_arch_rx_alloc(struct eth_arch_rx *rx)
+{
+    struct eth_arch_rx_buf *buf;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    buf = rx->free;
+    if (buf) {
+        rx->free = buf->next;
+    }
+    SYS_ARCH_UNPROTECT(lev);
+
+    return buf;
+}
+
+void eth_arch_rx_free(struct eth_arch_rx_buf *buf)
+{
+    struct eth_arch_rx *rx = buf->rx;
+    SYS_ARCH_DECL_PROTECT(lev);
+
+    SYS_ARCH_PROTECT(lev);
+    buf->next = rx->free;
+    rx->free = buf;
+    SYS_ARCH_UNPROTECT(lev);
+}
+
+void eth_arch_rx_drop(struct eth_arch_rx_buf *buf)
+{
+    LINK_STATS_INC(link.drop);
+    buf->rx->drops++;
+    eth_arch_rx_free(buf);
+}
+
+void eth_arch_rx_input(struct eth_arch_rx_buf *buf, u16_t len)
+{
+    struct netif *netif = buf->rx->netif;
+    struct pbuf *p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &buf->pc,
+                                         buf->data, buf->rx->size);
+    if (!p) {
+        eth_arch_rx_drop(buf);
+        return;
+    }
+
+    LINK_STATS_INC(link.recv);
+
+    /* pass all packets to ethernet_input, which decides what packets it supports */
+    if (netif->input(p, netif) != ERR_OK) {
+        LWIP_DEBUGF(NETIF_DEBUG, ("eth_arch_rx_input: input error\n"));
+        pbuf_free(p);
+    }
+}
+
+void eth_arch_rx_get_stats(struct netif *netif, u32_t *drops, u32_t *overruns)
+{
+    struct eth_arch_rx *rx;
+
+    for (rx = eth_arch_rx_pools; rx; rx = rx->next) {
+        if (rx->netif == netif) {
+            *drops += rx->drops;
+            *overruns += rx->overruns;
+        }
+    }
+}
@@ -0,0 +1,189 @@
+/* Copyright (C) 2017 ARM Limited. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Zero-copy receive for Ethernet drivers
+//
+// The driver receives into buffers of a pool which it gives to its DMA
+// descriptors. A received frame is passed to lwIP in the buffer it was
+// received in, wrapped in a pbuf_custom, and the buffer returns to the
+// pool once lwIP frees the pbuf.
+//
+// Everything touching the descriptors runs in the receive thread. The
+// interrupt handler masks the receive interrupt and calls
+// eth_arch_rx_signal, the thread then calls the driver's poll function,
+// which passes received frames to lwIP and gives free buffers to the
+// descriptors that lack one. Buffers freed by lwIP wake the thread as well,
+// so descriptors left without a buffer when the pool ran dry are refilled
+// as soon as one is available.
+//
+// The interrupt is unmasked only once the frames stop coming, so a flood
+// of frames costs a single interrupt rather than one each. A poll passes at
+// most ETH_ARCH_RX_BUDGET frames to lwIP; while polls use up the budget the
+// thread yields to the tcpip thread and polls again. With
+// ETH_ARCH_RX_HOLDOFF set, a poll that found frames is followed by another
+// one that many milliseconds later, and the interrupt waits for a poll that
+// finds none, trading latency for fewer wakeups under load.
+
+#ifndef ETH_ARCH_RX_H_
+#define ETH_ARCH_RX_H_
+
+#include "lwip/opt.h"
+#include "lwip/pbuf.h"
+#include "lwip/netif.h"
+#include "lwip/sys.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error eth_arch_rx requires LWIP_SUPPORT_CUSTOM_PBUF
+#endif
+
+/** Frames passed to lwIP per poll, 0 for all the frames received */
+#ifndef ETH_ARCH_RX_BUDGET
+#define ETH_ARCH_RX_BUDGET 16
+#endif
+
+/** Milliseconds between polls while frames keep coming, 0 to unmask the
+ *  receive interrupt as soon as no frame is left */
+#ifndef ETH_ARCH_RX_HOLDOFF
+#define ETH_ARCH_RX_HOLDOFF 0
+#endif
+
+struct eth_arch_rx;
+
+/** Receive buffer of the pool */
+struct eth_arch_rx_buf {
+    struct pbuf_custom pc;      /**< pbuf lent to lwIP, must be first */
+    struct eth_arch_rx *rx;     /**< Pool the buffer belongs to */
+    struct eth_arch_rx_buf *next;
+    void *data;                 /**< Memory given to the DMA */
+};
+
+/** Driver function called by the receive thread */
+typedef void (*eth_arch_rx_fn)(struct eth_arch_rx *rx);
+
+/** Driver function receiving frames, called by the receive thread
+ *
+ *  Passes at most budget received frames to lwIP, counting dropped ones,
+ *  giving descriptors free buffers as it goes, and returns their number.
+ */
+typedef u16_t (*eth_arch_rx_poll_fn)(struct eth_arch_rx *rx, u16_t budget);
+
+/** Receive buffer pool and thread of a driver */
+struct eth_arch_rx {
+    struct netif *netif;
+    struct eth_arch_rx_buf *bufs;
+    struct eth_arch_rx_buf *free;   /**< Buffers owned by neither DMA nor lwIP */
+    u16_t count;
+    u16_t size;
+    sys_sem_t sem;
+    eth_arch_rx_poll_fn poll;       /**< Receives frames and refills descriptors */
+    eth_arch_rx_fn irq_enable;      /**< Unmasks the receive interrupt, may be NULL */
+    void *arg;                      /**< Driver data */
+    u32_t drops;                    /**< Frames dropped for errors or lack of a pbuf */
+    u32_t overruns;                 /**< Frames lost by the MAC, kept up to date by the driver */
+    struct eth_arch_rx *next;       /**< Next initialized pool */
+};
+
+/** Initialize a receive buffer pool
+ *
+ *  @param rx         Pool to initialize
+ *  @param netif      Interface frames are passed to
+ *  @param buffers    Memory of count buffers of size bytes each, suitably
+ *                    aligned for the DMA
+ *  @param count      Number of buffers, at least the number of descriptors.
+ *                    Extra buffers let descriptors be refilled while lwIP
+ *                    still holds received frames.
+ *  @param size       Size of each buffer in bytes
+ *  @param poll       Called by the receive thread to receive frames and
+ *                    refill descriptors
+ *  @param irq_enable Called by the receive thread to unmask the receive
+ *                    interrupt once a poll finds no more frames, may be NULL
+ *  @param arg        Driver data, available as rx->arg
+ *  @return           ERR_OK on success, ERR_MEM if out of memory
+ */
+err_t eth_arch_rx_init(struct eth_arch_rx *rx, struct netif *netif,
+                       void *buffers, u16_t count, u16_t size,
+                       eth_arch_rx_poll_fn poll, eth_arch_rx_fn irq_enable, void *arg);
+
+/** Undo eth_arch_rx_init on a pool whose thread was not started
+ *
+ *  All its buffers must be back in the pool. The memory of the buffers
+ *  belongs to the driver, which frees it afterwards.
+ *
+ *  @param rx         Initialized pool
+ */
+void eth_arch_rx_deinit(struct eth_arch_rx *rx);
+
+/** Start the receive thread of a pool
+ *
+ *  @param rx         Initialized pool
+ *  @param name       Thread name
+ *  @param stacksize  Thread stack size in bytes
+ *  @param prio       Thread priority
+ */
+void eth_arch_rx_start(struct eth_arch_rx *rx, const char *name, int stacksize, int prio);
+
+/** Wake the receive thread
+ *
+ *  Safe to call from the receive interrupt.
+ */
+void eth_arch_rx_signal(struct eth_arch_rx *rx);
+
+/** Take a free buffer to give to a descriptor
+ *
+ *  @return           Buffer, NULL if all buffers are in use
+ */
+struct eth_arch_rx_buf *eth_arch_rx_alloc(struct eth_arch_rx *rx);
+
+/** Return a buffer that was not passed to lwIP to the pool
+ */
+void eth_arch_rx_free(struct eth_arch_rx_buf *buf);
+
+/** Drop a received frame and return its buffer to the pool
+ */
+void eth_arch_rx_drop(struct eth_arch_rx_buf *buf);
+
+/** Pass a frame received in a buffer to lwIP
+ *
+ *  The buffer is owned by lwIP until it frees the frame. Called from the
+ *  driver's poll function.
+ *
+ *  @param buf        Buffer the frame was received in
+ *  @param len        Length of the frame in bytes, including any ETH_PAD_SIZE
+ */
+void eth_arch_rx_input(struct eth_arch_rx_buf *buf, u16_t len);
+
+/** Get the drop counters of the pools of an interface
+ *
+ *  Adds the counters of all pools initialized for the interface to drops
+ *  and overruns.
+ *
+ *  @param netif      Interface of the pools
+ *  @param drops      Frames dropped by the drivers are added to this
+ *  @param overruns   Frames lost by the MACs are added to this
+ */
+void eth_arch_rx_get_stats(struct netif *netif, u32_t *drops, u32_t *overruns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -83,15 +83,17 @@ typedef uintptr_t          mem_ptr_t;
     #define ALIGNED(n)  __attribute__((aligned (n)))
 #endif 
 
+/* Word-wise copies of pbufs whatever the alignment, any toolchain */
+#include "platform/mbed_memcpy.h"
+#define MEMCPY(dst,src,len)         mbed_memcpy(dst,src,len)
+
 /* Provide Thumb-2 routines for GCC to improve performance */
 #if defined(TOOLCHAIN_GCC) && defined(__thumb2__)
-    #define MEMCPY(dst,src,len)     thumb2_memcpy(dst,src,len)
     #define LWIP_CHKSUM             thumb2_checksum
     /* Set algorithm to 0 so that unused lwip_standard_chksum function
        doesn't generate compiler warning */
     #define LWIP_CHKSUM_ALGORITHM   0
 
-    void* thumb2_memcpy(void* pDest, const void* pSource, size_t length);
     u16_t thumb2_checksum(void* pData, int length);
 #else
     /* Used with IP headers only */
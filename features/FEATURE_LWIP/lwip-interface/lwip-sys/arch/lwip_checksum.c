@@ -14,6 +14,7 @@
 */
 #if defined(TOOLCHAIN_GCC) && defined(__thumb2__)
 
+#include "platform/toolchain.h"
 
 /* This is a hand written Thumb-2 assembly language version of the
    algorithm 3 version of lwip_standard_chksum in lwIP's inet_chksum.c.  It
@@ -26,8 +27,10 @@
    NOTE: This function does return a uint16_t from the assembly language code
          but is marked as void so that GCC doesn't issue warning because it
          doesn't know about this low level return.
+
+   It runs from RAM on targets that place MBED_RAMFUNC functions there.
 */
-__attribute__((naked)) void /*uint16_t*/ thumb2_checksum(const void* pData, int length)
+MBED_RAMFUNC __attribute__((naked)) void /*uint16_t*/ thumb2_checksum(const void* pData, int length)
 {
     __asm (
         ".syntax unified\n"
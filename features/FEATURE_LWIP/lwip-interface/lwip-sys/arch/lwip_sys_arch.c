@@ -21,6 +21,8 @@
 #include "mbed_error.h"
 #include "mbed_interface.h"
 #include "us_ticker_api.h"
+#include "critical.h"
+#include "toolchain.h"
 
 /* lwIP includes. */
 #include "lwip/opt.h"
@@ -110,11 +112,76 @@ u32_t sys_now(void) {
 /* CMSIS-RTOS implementation of the lwip operating system abstraction */
 #include "arch/sys_arch.h"
 
+/* Mailboxes are rings of message slots, each slot's sequence tells which
+ * position may use it next: a poster may fill it when sequence == pos, a
+ * fetcher may take it when sequence == pos + 1. Slots are claimed with
+ * core_util_atomic_cas_u32, so posting and fetching never take a lock or
+ * make a kernel call unless the fetcher has to sleep.
+ *
+ * lwIP fetches from a mailbox in one thread at a time. A fetcher that finds
+ * the mailbox empty sets waiting, checks the ring again and then waits on
+ * the semaphore. A poster only releases the semaphore if it is the one to
+ * clear waiting. If the fetcher finds a message after a poster cleared
+ * waiting, the semaphore is left with a stale release, which only makes a
+ * later fetch check the ring once more. */
+static int sys_mbox_take_waiter(sys_mbox_t *mbox) {
+    uint32_t waiting = 1;
+    return core_util_atomic_cas_u32((uint32_t *)&mbox->waiting, &waiting, 0);
+}
+
+static int sys_mbox_put(sys_mbox_t *mbox, void *msg) {
+    uint32_t pos = mbox->post_pos;
+    while (1) {
+        sys_mbox_slot_t *slot = &mbox->slots[pos & mbox->mask];
+        int32_t diff = (int32_t)(slot->sequence - pos);
+        if (diff == 0) {
+            if (core_util_atomic_cas_u32((uint32_t *)&mbox->post_pos, &pos, pos + 1)) {
+                slot->msg = msg;
+                MBED_COMPILER_BARRIER();
+                slot->sequence = pos + 1;
+                break;
+            }
+            /* pos was reloaded by the failed compare-and-swap */
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = mbox->post_pos;
+        }
+    }
+
+    if (sys_mbox_take_waiter(mbox))
+        sys_sem_signal(&mbox->sem);
+    return 1;
+}
+
+static int sys_mbox_get(sys_mbox_t *mbox, void **msg) {
+    uint32_t pos = mbox->fetch_pos;
+    while (1) {
+        sys_mbox_slot_t *slot = &mbox->slots[pos & mbox->mask];
+        int32_t diff = (int32_t)(slot->sequence - (pos + 1));
+        if (diff == 0) {
+            if (core_util_atomic_cas_u32((uint32_t *)&mbox->fetch_pos, &pos, pos + 1)) {
+                MBED_COMPILER_BARRIER();
+                if (msg)
+                    *msg = slot->msg;
+                MBED_COMPILER_BARRIER();
+                slot->sequence = pos + mbox->mask + 1;
+                return 1;
+            }
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = mbox->fetch_pos;
+        }
+    }
+}
+
 /*---------------------------------------------------------------------------*
  * Routine:  sys_mbox_new
  *---------------------------------------------------------------------------*
  * Description:
- *      Creates a new mailbox
+ *      Creates a new mailbox. The ring holds queue_sz messages rounded up
+ *      to a power of two.
  * Inputs:
  *      sys_mbox_t mbox         -- Handle of mailbox
  *      int queue_sz            -- Size of elements in the mailbox
@@ -122,16 +189,24 @@ u32_t sys_now(void) {
  *      err_t                   -- ERR_OK if message posted, else ERR_MEM
  *---------------------------------------------------------------------------*/
 err_t sys_mbox_new(sys_mbox_t *mbox, int queue_sz) {
+    uint32_t size = 1;
+    uint32_t i;
+
     if (queue_sz > MB_SIZE)
         error("sys_mbox_new size error\n");
-    
-#ifdef CMSIS_OS_RTX
-    memset(mbox->queue, 0, sizeof(mbox->queue));
-    mbox->def.pool = mbox->queue;
-    mbox->def.queue_sz = queue_sz;
-#endif
-    mbox->id = osMessageCreate(&mbox->def, NULL);
-    return (mbox->id == NULL) ? (ERR_MEM) : (ERR_OK);
+
+    while (size < (uint32_t)queue_sz || size < 2)
+        size <<= 1;
+
+    for (i = 0; i < size; i++) {
+        mbox->slots[i].sequence = i;
+        mbox->slots[i].msg = NULL;
+    }
+    mbox->mask = size - 1;
+    mbox->post_pos = 0;
+    mbox->fetch_pos = 0;
+    mbox->waiting = 0;
+    return sys_sem_new(&mbox->sem, 0);
 }
 
 /*---------------------------------------------------------------------------*
@@ -145,23 +220,25 @@ err_t sys_mbox_new(sys_mbox_t *mbox, int queue_sz) {
  *      sys_mbox_t *mbox         -- Handle of mailbox
  *---------------------------------------------------------------------------*/
 void sys_mbox_free(sys_mbox_t *mbox) {
-    osEvent event = osMessageGet(mbox->id, 0);
-    if (event.status == osEventMessage)
+    if (sys_mbox_get(mbox, NULL))
         error("sys_mbox_free error\n");
+    sys_sem_free(&mbox->sem);
 }
 
 /*---------------------------------------------------------------------------*
  * Routine:  sys_mbox_post
  *---------------------------------------------------------------------------*
  * Description:
- *      Post the "msg" to the mailbox.
+ *      Post the "msg" to the mailbox. If the mailbox is full the thread
+ *      sleeps a tick at a time until there is room, full mailboxes are
+ *      rare enough that they do not justify a second semaphore.
  * Inputs:
  *      sys_mbox_t mbox        -- Handle of mailbox
  *      void *msg              -- Pointer to data to post
  *---------------------------------------------------------------------------*/
 void sys_mbox_post(sys_mbox_t *mbox, void *msg) {
-    if (osMessagePut(mbox->id, (uint32_t)msg, osWaitForever) != osOK)
-        error("sys_mbox_post error\n");
+    while (!sys_mbox_put(mbox, msg))
+        osDelay(1);
 }
 
 /*---------------------------------------------------------------------------*
@@ -169,7 +246,7 @@ void sys_mbox_post(sys_mbox_t *mbox, void *msg) {
  *---------------------------------------------------------------------------*
  * Description:
  *      Try to post the "msg" to the mailbox.  Returns immediately with
- *      error if cannot.
+ *      error if cannot. Can be called from an interrupt handler.
  * Inputs:
  *      sys_mbox_t mbox         -- Handle of mailbox
  *      void *msg               -- Pointer to data to post
@@ -178,8 +255,7 @@ void sys_mbox_post(sys_mbox_t *mbox, void *msg) {
  *                                  if not.
  *---------------------------------------------------------------------------*/
 err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
-    osStatus status = osMessagePut(mbox->id, (uint32_t)msg, 0);
-    return (status == osOK) ? (ERR_OK) : (ERR_MEM);
+    return sys_mbox_put(mbox, msg) ? (ERR_OK) : (ERR_MEM);
 }
 
 /*---------------------------------------------------------------------------*
@@ -208,14 +284,37 @@ err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
  *                                  of milliseconds until received.
  *---------------------------------------------------------------------------*/
 u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout) {
-    u32_t start = us_ticker_read();
-    
-    osEvent event = osMessageGet(mbox->id, (timeout != 0)?(timeout):(osWaitForever));
-    if (event.status != osEventMessage)
-        return SYS_ARCH_TIMEOUT;
-    
-    *msg = (void *)event.value.v;
-    
+    u32_t start;
+    u32_t elapsed;
+
+    if (sys_mbox_get(mbox, msg))
+        return 0;
+
+    start = us_ticker_read();
+    while (1) {
+        mbox->waiting = 1;
+        if (sys_mbox_get(mbox, msg))
+            break;
+
+        elapsed = (us_ticker_read() - start) / 1000;
+        if (timeout != 0 && elapsed >= timeout) {
+            mbox->waiting = 0;
+            return SYS_ARCH_TIMEOUT;
+        }
+
+        if (osSemaphoreWait(mbox->sem.id, (timeout != 0)?(timeout - elapsed):(osWaitForever)) < 1) {
+            mbox->waiting = 0;
+            /* a message may have been posted just as we timed out */
+            if (sys_mbox_get(mbox, msg))
+                break;
+            return SYS_ARCH_TIMEOUT;
+        }
+
+        if (sys_mbox_get(mbox, msg))
+            break;
+    }
+
+    mbox->waiting = 0;
     return (us_ticker_read() - start) / 1000;
 }
 
@@ -234,12 +333,9 @@ u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout) {
  *                                  return ERR_OK.
  *---------------------------------------------------------------------------*/
 u32_t sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg) {
-    osEvent event = osMessageGet(mbox->id, 0);
-    if (event.status != osEventMessage)
+    if (!sys_mbox_get(mbox, msg))
         return SYS_MBOX_EMPTY;
-    
-    *msg = (void *)event.value.v;
-    
+
     return ERR_OK;
 }
 
@@ -324,6 +420,9 @@ void sys_sem_signal(sys_sem_t *data) {
 void sys_sem_free(sys_sem_t *sem) {}
 
 /** Create a new mutex
+ *  RTX mutexes use priority inheritance, as required for the lwIP core
+ *  lock, so a low priority thread holding the core lock is not starved
+ *  by the threads waiting for it.
  * @param mutex pointer to the mutex to create
  * @return a new mutex */
 err_t sys_mutex_new(sys_mutex_t *mutex) {
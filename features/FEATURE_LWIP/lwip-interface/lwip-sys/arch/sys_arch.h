@@ -51,19 +51,36 @@ typedef struct {
 } sys_mutex_t;
 
 // === MAIL BOX ===
+// Mailboxes are lock-free rings of message slots, the ring size must be a
+// power of two
+#define MB_MAX_SIZE  ((DEFAULT_ACCEPTMBOX_SIZE) > 8 ? (DEFAULT_ACCEPTMBOX_SIZE) : 8)
+#if MB_MAX_SIZE <= 8
 #define MB_SIZE      8
+#elif MB_MAX_SIZE <= 16
+#define MB_SIZE      16
+#elif MB_MAX_SIZE <= 32
+#define MB_SIZE      32
+#else
+#define MB_SIZE      64
+#endif
 
 typedef struct {
-    osMessageQId    id;
-    osMessageQDef_t def;
-#ifdef CMSIS_OS_RTX
-    uint32_t        queue[4+MB_SIZE]; /* The +4 is required for RTX OS_MCB overhead. */
-#endif
+    volatile uint32_t sequence;     /* position the slot may be used for next */
+    void             *msg;
+} sys_mbox_slot_t;
+
+typedef struct {
+    sys_mbox_slot_t   slots[MB_SIZE];
+    uint32_t          mask;         /* ring size - 1 */
+    volatile uint32_t post_pos;
+    volatile uint32_t fetch_pos;
+    volatile uint32_t waiting;      /* fetcher is waiting on sem */
+    sys_sem_t         sem;
 } sys_mbox_t;
 
 #define SYS_MBOX_NULL               ((uint32_t) NULL)
-#define sys_mbox_valid(x)           (((*x).id == NULL) ? 0 : 1 )
-#define sys_mbox_set_invalid(x)     ( (*x).id = NULL )
+#define sys_mbox_valid(x)           sys_sem_valid(&(*x).sem)
+#define sys_mbox_set_invalid(x)     sys_sem_set_invalid(&(*x).sem)
 
 #if ((DEFAULT_RAW_RECVMBOX_SIZE) > (MB_SIZE)) || \
     ((DEFAULT_UDP_RECVMBOX_SIZE) > (MB_SIZE)) || \
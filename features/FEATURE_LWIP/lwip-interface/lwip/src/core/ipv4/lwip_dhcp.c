@@ -177,6 +177,7 @@ static err_t dhcp_decline(struct netif *netif);
 #endif /* DHCP_DOES_ARP_CHECK */
 static err_t dhcp_rebind(struct netif *netif);
 static err_t dhcp_reboot(struct netif *netif);
+static err_t dhcp_start_client(struct netif *netif);
 static void dhcp_set_state(struct dhcp *dhcp, u8_t new_state);
 
 /* receive, unfold, parse and free incoming messages */
@@ -705,10 +706,91 @@ void dhcp_cleanup(struct netif *netif)
  */
 err_t
 dhcp_start(struct netif *netif)
+{
+  err_t result;
+
+  result = dhcp_start_client(netif);
+  if (result != ERR_OK) {
+    return result;
+  }
+
+#if LWIP_DHCP_CHECK_LINK_UP
+  if (!netif_is_link_up(netif)) {
+    /* set state INIT and wait for dhcp_network_changed() to call dhcp_discover() */
+    dhcp_set_state(netif->dhcp, DHCP_STATE_INIT);
+    return ERR_OK;
+  }
+#endif /* LWIP_DHCP_CHECK_LINK_UP */
+
+
+  /* (re)start the DHCP negotiation */
+  result = dhcp_discover(netif);
+  if (result != ERR_OK) {
+    /* free resources allocated above */
+    dhcp_stop(netif);
+    return ERR_MEM;
+  }
+  return result;
+}
+
+/**
+ * @ingroup dhcp4
+ * Start DHCP negotiation for a network interface, first asking to reuse
+ * the address of an earlier lease (INIT-REBOOT, RFC 2131 section 3.2).
+ *
+ * A single REQUEST round trip binds the address if the server still
+ * grants it. If the server refuses it or doesn't answer, the client
+ * falls back to DISCOVER as dhcp_start() does.
+ *
+ * @param netif The lwIP network interface
+ * @param addr The address of the earlier lease
+ * @return lwIP error code
+ * - ERR_OK - No error
+ * - ERR_MEM - Out of memory
+ */
+err_t
+dhcp_start_reboot(struct netif *netif, const ip4_addr_t *addr)
 {
   struct dhcp *dhcp;
   err_t result;
 
+  LWIP_ERROR("addr != NULL", (addr != NULL), return ERR_ARG;);
+  result = dhcp_start_client(netif);
+  if (result != ERR_OK) {
+    return result;
+  }
+  dhcp = netif->dhcp;
+  ip4_addr_copy(dhcp->offered_ip_addr, *addr);
+
+#if LWIP_DHCP_CHECK_LINK_UP
+  if (!netif_is_link_up(netif)) {
+    /* set state REBOOTING and wait for dhcp_network_changed() to call dhcp_reboot() */
+    dhcp_set_state(dhcp, DHCP_STATE_REBOOTING);
+    return ERR_OK;
+  }
+#endif /* LWIP_DHCP_CHECK_LINK_UP */
+
+  result = dhcp_reboot(netif);
+  if (result != ERR_OK) {
+    /* free resources allocated above */
+    dhcp_stop(netif);
+    return ERR_MEM;
+  }
+  return result;
+}
+
+/**
+ * Attach a cleared DHCP client to a network interface, allocating it
+ * on first use, for dhcp_start() and dhcp_start_reboot().
+ *
+ * @param netif The lwIP network interface
+ * @return lwIP error code
+ */
+static err_t
+dhcp_start_client(struct netif *netif)
+{
+  struct dhcp *dhcp;
+
   LWIP_ERROR("netif != NULL", (netif != NULL), return ERR_ARG;);
   LWIP_ERROR("netif is not up, old style port?", netif_is_up(netif), return ERR_ARG;);
   dhcp = netif->dhcp;
@@ -754,24 +836,7 @@ dhcp_start(struct netif *netif)
     return ERR_MEM;
   }
   dhcp->pcb_allocated = 1;
-
-#if LWIP_DHCP_CHECK_LINK_UP
-  if (!netif_is_link_up(netif)) {
-    /* set state INIT and wait for dhcp_network_changed() to call dhcp_discover() */
-    dhcp_set_state(dhcp, DHCP_STATE_INIT);
-    return ERR_OK;
-  }
-#endif /* LWIP_DHCP_CHECK_LINK_UP */
-
-
-  /* (re)start the DHCP negotiation */
-  result = dhcp_discover(netif);
-  if (result != ERR_OK) {
-    /* free resources allocated above */
-    dhcp_stop(netif);
-    return ERR_MEM;
-  }
-  return result;
+  return ERR_OK;
 }
 
 /**
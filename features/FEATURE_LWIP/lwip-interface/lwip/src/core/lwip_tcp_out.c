@@ -1370,6 +1370,7 @@ tcp_rexmit_rto(struct tcp_pcb *pcb)
   pcb->rttest = 0;
 
   /* Do the actual retransmission */
+  MIB2_STATS_INC(mib2.tcpretranssegs);
   tcp_output(pcb);
 }
 
@@ -243,6 +243,9 @@ struct netconn {
 #endif /* LWIP_TCP */
   /** A callback function that is informed about events for this netconn */
   netconn_callback callback;
+  /** user argument for the callback, to find the owner of the netconn
+      without searching for it */
+  void *callback_arg;
 };
 
 /** Register an Network connection event */
@@ -325,6 +328,11 @@ err_t   netconn_gethostbyname(const char *name, ip_addr_t *addr);
 /** Get the blocking status of netconn calls (@todo: write/send is missing) */
 #define netconn_is_nonblocking(conn)        (((conn)->flags & NETCONN_FLAG_NON_BLOCKING) != 0)
 
+/** Set the user argument for the callback of a netconn */
+#define netconn_set_callback_arg(conn, arg) ((conn)->callback_arg = (arg))
+/** Get the user argument for the callback of a netconn */
+#define netconn_get_callback_arg(conn)      ((conn)->callback_arg)
+
 #if LWIP_IPV6
 /** @ingroup netconn_common
  * TCP: Set the IPv6 ONLY status of netconn calls (see NETCONN_FLAG_IPV6_V6ONLY) 
@@ -147,6 +147,8 @@ void dhcp_set_struct(struct netif *netif, struct dhcp *dhcp);
 void dhcp_cleanup(struct netif *netif);
 /** start DHCP configuration */
 err_t dhcp_start(struct netif *netif);
+/** start DHCP configuration, asking for the address of an earlier lease first */
+err_t dhcp_start_reboot(struct netif *netif, const ip4_addr_t *addr);
 /** enforce early lease renewal (not needed normally)*/
 err_t dhcp_renew(struct netif *netif);
 /** release the DHCP lease, usually called before dhcp_stop()*/
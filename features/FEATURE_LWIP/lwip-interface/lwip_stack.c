@@ -32,8 +32,14 @@
 #include "lwip/mld6.h"
 #include "lwip/dns.h"
 #include "lwip/udp.h"
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+#include "lwip/priv/tcp_priv.h"
 
 #include "emac_api.h"
+#if !DEVICE_EMAC
+#include "eth_arch_rx.h"
+#endif
 
 #if DEVICE_EMAC
     #define MBED_NETIF_INIT_FN emac_lwip_if_init
@@ -43,9 +49,21 @@
 
 #define DHCP_TIMEOUT 15000
 
-/* Static arena of sockets */
+/* A socket for every netconn, so that an accepted connection always finds one */
+#ifdef MBED_CONF_LWIP_SOCKET_MAX
+#define MBED_LWIP_SOCKET_MAX MBED_CONF_LWIP_SOCKET_MAX
+#else
+#define MBED_LWIP_SOCKET_MAX MEMP_NUM_NETCONN
+#endif
+
+#if MBED_LWIP_SOCKET_MAX < MEMP_NUM_NETCONN
+#error "lwip.socket-max must be at least lwip.netconn-max"
+#endif
+
+/* Static arena of sockets, the free ones chained through next_free */
 static struct lwip_socket {
     bool in_use;
+    struct lwip_socket *next_free;
 
     struct netconn *conn;
     struct netbuf *buf;
@@ -53,50 +71,138 @@ static struct lwip_socket {
 
     void (*cb)(void *);
     void *data;
-} lwip_arena[MEMP_NUM_NETCONN];
+
+    /* readiness tracked from the netconn events */
+    s16_t rcvevent;
+    u8_t sendevent;
+    u8_t errevent;
+
+    /* bytes passed through the socket */
+    u32_t rx_bytes;
+    u32_t tx_bytes;
+} lwip_arena[MBED_LWIP_SOCKET_MAX];
+
+/* Receive events of connections that have not been accepted yet, moved
+ * to their socket on accept */
+static struct lwip_pending_conn {
+    struct netconn *conn;
+    s16_t rcvevent;
+} lwip_pending[MEMP_NUM_NETCONN];
+
+static struct lwip_socket *lwip_arena_free;
 
 static bool lwip_connected = false;
 
 static void mbed_lwip_arena_init(void)
 {
     memset(lwip_arena, 0, sizeof lwip_arena);
+    memset(lwip_pending, 0, sizeof lwip_pending);
+
+    lwip_arena_free = NULL;
+    for (int i = MBED_LWIP_SOCKET_MAX - 1; i >= 0; i--) {
+        lwip_arena[i].next_free = lwip_arena_free;
+        lwip_arena_free = &lwip_arena[i];
+    }
 }
 
 static struct lwip_socket *mbed_lwip_arena_alloc(void)
 {
     sys_prot_t prot = sys_arch_protect();
 
-    for (int i = 0; i < MEMP_NUM_NETCONN; i++) {
-        if (!lwip_arena[i].in_use) {
-            struct lwip_socket *s = &lwip_arena[i];
-            memset(s, 0, sizeof *s);
-            s->in_use = true;
-            sys_arch_unprotect(prot);
-            return s;
-        }
+    struct lwip_socket *s = lwip_arena_free;
+    if (s) {
+        lwip_arena_free = s->next_free;
+        memset(s, 0, sizeof *s);
+        s->in_use = true;
     }
 
     sys_arch_unprotect(prot);
-    return 0;
+    return s;
 }
 
 static void mbed_lwip_arena_dealloc(struct lwip_socket *s)
 {
+    sys_prot_t prot = sys_arch_protect();
+
     s->in_use = false;
+    s->next_free = lwip_arena_free;
+    lwip_arena_free = s;
+
+    sys_arch_unprotect(prot);
 }
 
-static void mbed_lwip_socket_callback(struct netconn *nc, enum netconn_evt eh, u16_t len)
+/* Takes the receive events counted before a connection was accepted,
+ * called with the arena protected */
+static s16_t mbed_lwip_pending_take(struct netconn *nc)
 {
-    sys_prot_t prot = sys_arch_protect();
+    for (int i = 0; i < MEMP_NUM_NETCONN; i++) {
+        if (lwip_pending[i].conn == nc) {
+            s16_t rcvevent = lwip_pending[i].rcvevent;
+            lwip_pending[i].conn = NULL;
+            lwip_pending[i].rcvevent = 0;
+            return rcvevent;
+        }
+    }
 
+    return 0;
+}
+
+static void mbed_lwip_pending_event(struct netconn *nc, enum netconn_evt eh)
+{
+    if (eh != NETCONN_EVT_RCVPLUS && eh != NETCONN_EVT_RCVMINUS) {
+        return;
+    }
+
+    struct lwip_pending_conn *p = NULL;
     for (int i = 0; i < MEMP_NUM_NETCONN; i++) {
-        if (lwip_arena[i].in_use
-            && lwip_arena[i].conn == nc
-            && lwip_arena[i].cb) {
-            lwip_arena[i].cb(lwip_arena[i].data);
+        if (lwip_pending[i].conn == nc) {
+            p = &lwip_pending[i];
+            break;
+        } else if (!p && !lwip_pending[i].conn) {
+            p = &lwip_pending[i];
         }
     }
 
+    if (p) {
+        p->conn = nc;
+        p->rcvevent += (eh == NETCONN_EVT_RCVPLUS) ? 1 : -1;
+    }
+}
+
+static void mbed_lwip_socket_callback(struct netconn *nc, enum netconn_evt eh, u16_t len)
+{
+    sys_prot_t prot = sys_arch_protect();
+
+    // the socket of the netconn is kept in its callback argument
+    struct lwip_socket *s = (struct lwip_socket *)netconn_get_callback_arg(nc);
+    if (!s || !s->in_use || s->conn != nc) {
+        mbed_lwip_pending_event(nc, eh);
+        sys_arch_unprotect(prot);
+        return;
+    }
+
+    switch (eh) {
+        case NETCONN_EVT_RCVPLUS:
+            s->rcvevent += 1;
+            break;
+        case NETCONN_EVT_RCVMINUS:
+            s->rcvevent -= 1;
+            break;
+        case NETCONN_EVT_SENDPLUS:
+            s->sendevent = 1;
+            break;
+        case NETCONN_EVT_SENDMINUS:
+            s->sendevent = 0;
+            break;
+        case NETCONN_EVT_ERROR:
+            s->errevent = 1;
+            break;
+    }
+
+    if (s->cb) {
+        s->cb(s->data);
+    }
+
     sys_arch_unprotect(prot);
 }
 
@@ -105,6 +211,66 @@ static void mbed_lwip_socket_callback(struct netconn *nc, enum netconn_evt eh, u
 static struct netif lwip_netif;
 static bool lwip_dhcp = false;
 static char lwip_mac_address[NSAPI_MAC_SIZE] = "\0";
+static bool lwip_blocking = true;
+#if LWIP_IPV4
+static ip4_addr_t lwip_dhcp_lease;
+#endif
+
+/* Connection status, reported to the attached callback on change */
+static nsapi_connection_status_t lwip_connection_status = NSAPI_STATUS_DISCONNECTED;
+static void (*lwip_status_cb)(void *, nsapi_connection_status_t) = 0;
+static void *lwip_status_ctx = 0;
+
+static void mbed_lwip_set_status(nsapi_connection_status_t status)
+{
+    if (lwip_connection_status != status) {
+        lwip_connection_status = status;
+        if (lwip_status_cb) {
+            lwip_status_cb(lwip_status_ctx, status);
+        }
+    }
+}
+
+/* Interface counters, kept by wrapping the input and linkoutput
+ * functions so they do not depend on the driver or LWIP_STATS */
+static struct lwip_netif_stats {
+    u32_t rx_packets;
+    u32_t tx_packets;
+    u32_t rx_bytes;
+    u32_t tx_bytes;
+    u32_t rx_drops;
+    u32_t tx_drops;
+} lwip_netif_stats;
+
+static netif_linkoutput_fn lwip_netif_linkoutput;
+
+static err_t mbed_lwip_netif_input(struct pbuf *p, struct netif *netif)
+{
+    u16_t len = p->tot_len;
+
+    err_t err = tcpip_input(p, netif);
+    if (err != ERR_OK) {
+        lwip_netif_stats.rx_drops++;
+        return err;
+    }
+
+    lwip_netif_stats.rx_packets++;
+    lwip_netif_stats.rx_bytes += len;
+    return ERR_OK;
+}
+
+static err_t mbed_lwip_netif_linkoutput(struct netif *netif, struct pbuf *p)
+{
+    err_t err = lwip_netif_linkoutput(netif, p);
+    if (err != ERR_OK) {
+        lwip_netif_stats.tx_drops++;
+        return err;
+    }
+
+    lwip_netif_stats.tx_packets++;
+    lwip_netif_stats.tx_bytes += p->tot_len;
+    return ERR_OK;
+}
 
 #if !LWIP_IPV4 || !LWIP_IPV6
 static bool all_zeros(const uint8_t *p, int len)
@@ -272,6 +438,13 @@ static void mbed_lwip_netif_link_irq(struct netif *lwip_netif)
 {
     if (netif_is_link_up(lwip_netif)) {
         sys_sem_signal(&lwip_netif_linked);
+
+        // A kept address is usable again, DHCP confirms it in the background
+        if (lwip_connection_status == NSAPI_STATUS_CONNECTING && mbed_lwip_get_ip_addr(true, lwip_netif)) {
+            mbed_lwip_set_status(NSAPI_STATUS_GLOBAL_UP);
+        }
+    } else if (lwip_connection_status == NSAPI_STATUS_GLOBAL_UP) {
+        mbed_lwip_set_status(NSAPI_STATUS_CONNECTING);
     }
 }
 
@@ -291,6 +464,16 @@ static void mbed_lwip_netif_status_irq(struct netif *lwip_netif)
     if (mbed_lwip_get_ip_addr(false, lwip_netif)) {
         sys_sem_signal(&lwip_netif_has_addr);
     }
+
+    if (lwip_connection_status == NSAPI_STATUS_CONNECTING && netif_is_link_up(lwip_netif) &&
+            mbed_lwip_get_ip_addr(true, lwip_netif)) {
+#if LWIP_IPV6
+        add_dns_addr(lwip_netif);
+#endif
+        mbed_lwip_set_status(NSAPI_STATUS_GLOBAL_UP);
+    } else if (lwip_connection_status == NSAPI_STATUS_GLOBAL_UP && !mbed_lwip_get_ip_addr(true, lwip_netif)) {
+        mbed_lwip_set_status(NSAPI_STATUS_CONNECTING);
+    }
 }
 
 static void mbed_lwip_set_mac_address(void)
@@ -379,10 +562,13 @@ int mbed_lwip_init(emac_interface_t *emac)
 #if LWIP_IPV4
                 0, 0, 0,
 #endif
-                emac, MBED_NETIF_INIT_FN, tcpip_input)) {
+                emac, MBED_NETIF_INIT_FN, mbed_lwip_netif_input)) {
             return NSAPI_ERROR_DEVICE_ERROR;
         }
 
+        lwip_netif_linkoutput = lwip_netif.linkoutput;
+        lwip_netif.linkoutput = mbed_lwip_netif_linkoutput;
+
         netif_set_default(&lwip_netif);
 
         netif_set_link_callback(&lwip_netif, mbed_lwip_netif_link_irq);
@@ -410,6 +596,8 @@ int mbed_lwip_bringup(bool dhcp, const char *ip, const char *netmask, const char
     // Zero out socket set
     mbed_lwip_arena_init();
 
+    mbed_lwip_set_status(NSAPI_STATUS_CONNECTING);
+
 #if LWIP_IPV6
     netif_create_ip6_linklocal_address(&lwip_netif, 1/*from MAC*/);
 #if LWIP_IPV6_MLD
@@ -434,10 +622,12 @@ int mbed_lwip_bringup(bool dhcp, const char *ip, const char *netmask, const char
 
     u32_t ret;
 
-    if (!netif_is_link_up(&lwip_netif)) {
+    // Without blocking, DHCP waits for the link itself
+    if (lwip_blocking && !netif_is_link_up(&lwip_netif)) {
         ret = sys_arch_sem_wait(&lwip_netif_linked, 15000);
 
         if (ret == SYS_ARCH_TIMEOUT) {
+            mbed_lwip_set_status(NSAPI_STATUS_DISCONNECTED);
             return NSAPI_ERROR_NO_CONNECTION;
         }
     }
@@ -451,35 +641,53 @@ int mbed_lwip_bringup(bool dhcp, const char *ip, const char *netmask, const char
         if (!inet_aton(ip, &ip_addr) ||
             !inet_aton(netmask, &netmask_addr) ||
             !inet_aton(gw, &gw_addr)) {
+            mbed_lwip_set_status(NSAPI_STATUS_DISCONNECTED);
             return NSAPI_ERROR_PARAMETER;
         }
 
+        LOCK_TCPIP_CORE();
         netif_set_addr(&lwip_netif, &ip_addr, &netmask_addr, &gw_addr);
+        UNLOCK_TCPIP_CORE();
     }
 #endif
 
+    LOCK_TCPIP_CORE();
     netif_set_up(&lwip_netif);
+    UNLOCK_TCPIP_CORE();
 
 #if LWIP_IPV4
     // Connect to the network
     lwip_dhcp = dhcp;
 
     if (lwip_dhcp) {
-        err_t err = dhcp_start(&lwip_netif);
+        LOCK_TCPIP_CORE();
+        // A known lease is confirmed in a single round trip
+        err_t err = ip4_addr_isany_val(lwip_dhcp_lease)
+                ? dhcp_start(&lwip_netif)
+                : dhcp_start_reboot(&lwip_netif, &lwip_dhcp_lease);
+        UNLOCK_TCPIP_CORE();
         if (err) {
+            mbed_lwip_set_status(NSAPI_STATUS_DISCONNECTED);
             return NSAPI_ERROR_DHCP_FAILURE;
         }
     }
 #endif
 
+    if (!lwip_blocking) {
+        // Completion is reported through the status callback
+        lwip_connected = true;
+        return 0;
+    }
+
     // If doesn't have address
     if (!mbed_lwip_get_ip_addr(true, &lwip_netif)) {
         ret = sys_arch_sem_wait(&lwip_netif_has_addr, 15000);
         if (ret == SYS_ARCH_TIMEOUT) {
+            mbed_lwip_set_status(NSAPI_STATUS_DISCONNECTED);
             return NSAPI_ERROR_DHCP_FAILURE;
         }
-        lwip_connected = true;
     }
+    lwip_connected = true;
 
 #if ADDR_TIMEOUT
     // If address is not for preferred stack waits a while to see
@@ -505,6 +713,7 @@ int mbed_lwip_bringdown(void)
 
 #if LWIP_IPV4
     // Disconnect from the network
+    LOCK_TCPIP_CORE();
     if (lwip_dhcp) {
         dhcp_release(&lwip_netif);
         dhcp_stop(&lwip_netif);
@@ -512,13 +721,59 @@ int mbed_lwip_bringdown(void)
     } else {
         netif_set_down(&lwip_netif);
     }
+    UNLOCK_TCPIP_CORE();
 #endif
 
     lwip_connected = false;
+    mbed_lwip_set_status(NSAPI_STATUS_DISCONNECTED);
     // TO DO - actually remove addresses from stack, and shut down properly
     return 0;
 }
 
+void mbed_lwip_set_blocking(bool blocking)
+{
+    lwip_blocking = blocking;
+}
+
+void mbed_lwip_attach(void (*cb)(void *ctx, nsapi_connection_status_t status), void *ctx)
+{
+    lwip_status_cb = cb;
+    lwip_status_ctx = ctx;
+}
+
+nsapi_connection_status_t mbed_lwip_get_connection_status(void)
+{
+    return lwip_connection_status;
+}
+
+int mbed_lwip_set_dhcp_lease(const char *ip)
+{
+#if LWIP_IPV4
+    if (!ip || !ip[0]) {
+        ip4_addr_set_any(&lwip_dhcp_lease);
+        return 0;
+    }
+
+    if (!inet_aton(ip, &lwip_dhcp_lease)) {
+        ip4_addr_set_any(&lwip_dhcp_lease);
+        return NSAPI_ERROR_PARAMETER;
+    }
+    return 0;
+#else
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif
+}
+
+char *mbed_lwip_get_dhcp_lease(char *buf, int buflen)
+{
+#if LWIP_IPV4
+    if (lwip_dhcp && dhcp_supplied_address(&lwip_netif)) {
+        return ip4addr_ntoa_r(netif_ip4_addr(&lwip_netif), buf, buflen);
+    }
+#endif
+    return NULL;
+}
+
 /* LWIP error remapping */
 static int mbed_lwip_err_remap(err_t err) {
     switch (err) {
@@ -625,6 +880,13 @@ static int mbed_lwip_socket_open(nsapi_stack_t *stack, nsapi_socket_t *handle, n
         return NSAPI_ERROR_NO_SOCKET;
     }
 
+    // udp can always send, tcp once connected
+    sys_prot_t prot = sys_arch_protect();
+    netconn_set_callback_arg(s->conn, s);
+    mbed_lwip_pending_take(s->conn);
+    s->sendevent = (proto == NSAPI_UDP);
+    sys_arch_unprotect(prot);
+
     netconn_set_recvtimeout(s->conn, 1);
     *(struct lwip_socket **)handle = s;
     return 0;
@@ -661,6 +923,13 @@ static int mbed_lwip_socket_listen(nsapi_stack_t *stack, nsapi_socket_t handle,
 {
     struct lwip_socket *s = (struct lwip_socket *)handle;
 
+    // pending connections wait in the accept mailbox
+    if (backlog > DEFAULT_ACCEPTMBOX_SIZE) {
+        backlog = DEFAULT_ACCEPTMBOX_SIZE;
+    } else if (backlog < 1) {
+        backlog = 1;
+    }
+
     err_t err = netconn_listen_with_backlog(s->conn, backlog);
     return mbed_lwip_err_remap(err);
 }
@@ -695,6 +964,13 @@ static int mbed_lwip_socket_accept(nsapi_stack_t *stack, nsapi_socket_t server,
         return mbed_lwip_err_remap(err);
     }
 
+    // pick up the data received before the connection was accepted
+    sys_prot_t prot = sys_arch_protect();
+    netconn_set_callback_arg(ns->conn, ns);
+    ns->rcvevent += mbed_lwip_pending_take(ns->conn);
+    ns->sendevent = 1;
+    sys_arch_unprotect(prot);
+
     netconn_set_recvtimeout(ns->conn, 1);
     *(struct lwip_socket **)handle = ns;
 
@@ -714,6 +990,22 @@ static int mbed_lwip_socket_send(nsapi_stack_t *stack, nsapi_socket_t handle, co
         return mbed_lwip_err_remap(err);
     }
 
+    s->tx_bytes += bytes_written;
+    return (int)bytes_written;
+}
+
+static int mbed_lwip_socket_send_static(nsapi_stack_t *stack, nsapi_socket_t handle, const void *data, unsigned size)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    size_t bytes_written = 0;
+
+    // The segments reference the data in place until it is acknowledged
+    err_t err = netconn_write_partly(s->conn, data, size, NETCONN_NOCOPY, &bytes_written);
+    if (err != ERR_OK) {
+        return mbed_lwip_err_remap(err);
+    }
+
+    s->tx_bytes += bytes_written;
     return (int)bytes_written;
 }
 
@@ -738,6 +1030,7 @@ static int mbed_lwip_socket_recv(nsapi_stack_t *stack, nsapi_socket_t handle, vo
         s->buf = 0;
     }
 
+    s->rx_bytes += recv;
     return recv;
 }
 
@@ -763,6 +1056,7 @@ static int mbed_lwip_socket_sendto(nsapi_stack_t *stack, nsapi_socket_t handle,
         return mbed_lwip_err_remap(err);
     }
 
+    s->tx_bytes += size;
     return size;
 }
 
@@ -782,53 +1076,125 @@ static int mbed_lwip_socket_recvfrom(nsapi_stack_t *stack, nsapi_socket_t handle
     u16_t recv = netbuf_copy(buf, data, (u16_t)size);
     netbuf_delete(buf);
 
+    s->rx_bytes += recv;
     return recv;
 }
 
+#if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
+static int mbed_lwip_setsockopt_membership(struct lwip_socket *s, int optname, const void *optval, unsigned optlen)
+{
+    const nsapi_ip_mreq_t *mreq = (const nsapi_ip_mreq_t *)optval;
+    ip_addr_t multiaddr;
+    ip_addr_t ifaddr;
+
+    if (optlen != sizeof(nsapi_ip_mreq_t) || NETCONNTYPE_GROUP(s->conn->type) != NETCONN_UDP) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    if (!convert_mbed_addr_to_lwip(&multiaddr, &mreq->imr_multiaddr) || !ip_addr_ismulticast(&multiaddr)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    if (mreq->imr_interface.version == NSAPI_UNSPEC) {
+        ip_addr_set_any(IP_IS_V6(&multiaddr), &ifaddr);
+    } else if (!convert_mbed_addr_to_lwip(&ifaddr, &mreq->imr_interface)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    // the netif filters are updated through its igmp/mld mac filter, so
+    // only the joined groups get past the hardware
+    err_t err = netconn_join_leave_group(s->conn, &multiaddr, &ifaddr,
+            optname == NSAPI_ADD_MEMBERSHIP ? NETCONN_JOIN : NETCONN_LEAVE);
+    return mbed_lwip_err_remap(err);
+}
+#endif
+
 static int mbed_lwip_setsockopt(nsapi_stack_t *stack, nsapi_socket_t handle, int level, int optname, const void *optval, unsigned optlen)
 {
     struct lwip_socket *s = (struct lwip_socket *)handle;
+    int ret = 0;
+
+    if (optname == NSAPI_ADD_MEMBERSHIP || optname == NSAPI_DROP_MEMBERSHIP) {
+#if LWIP_IGMP || (LWIP_IPV6 && LWIP_IPV6_MLD)
+        // takes the tcpip core lock itself
+        return mbed_lwip_setsockopt_membership(s, optname, optval, optlen);
+#else
+        return NSAPI_ERROR_UNSUPPORTED;
+#endif
+    }
+
+    if (optlen != sizeof(int)) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    int val = *(const int *)optval;
+    bool tcp = NETCONNTYPE_GROUP(s->conn->type) == NETCONN_TCP;
+
+    // the pcb is shared with the tcpip thread
+    LOCK_TCPIP_CORE();
+
+    if (!s->conn->pcb.ip) {
+        UNLOCK_TCPIP_CORE();
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    // listening pcbs only carry the socket options, which accepted
+    // connections inherit
+    bool active = tcp && s->conn->pcb.tcp->state != LISTEN;
 
     switch (optname) {
         case NSAPI_KEEPALIVE:
-            if (optlen != sizeof(int) || s->conn->type != NETCONN_TCP) {
-                return NSAPI_ERROR_UNSUPPORTED;
+            if (!tcp) {
+                ret = NSAPI_ERROR_UNSUPPORTED;
+            } else if (val) {
+                ip_set_option(s->conn->pcb.tcp, SOF_KEEPALIVE);
+            } else {
+                ip_reset_option(s->conn->pcb.tcp, SOF_KEEPALIVE);
             }
-
-            s->conn->pcb.tcp->so_options |= SOF_KEEPALIVE;
-            return 0;
+            break;
 
         case NSAPI_KEEPIDLE:
-            if (optlen != sizeof(int) || s->conn->type != NETCONN_TCP) {
-                return NSAPI_ERROR_UNSUPPORTED;
+            if (!active) {
+                ret = NSAPI_ERROR_UNSUPPORTED;
+            } else {
+                s->conn->pcb.tcp->keep_idle = val;
             }
-
-            s->conn->pcb.tcp->keep_idle = *(int*)optval;
-            return 0;
+            break;
 
         case NSAPI_KEEPINTVL:
-            if (optlen != sizeof(int) || s->conn->type != NETCONN_TCP) {
-                return NSAPI_ERROR_UNSUPPORTED;
+            if (!active) {
+                ret = NSAPI_ERROR_UNSUPPORTED;
+            } else {
+                s->conn->pcb.tcp->keep_intvl = val;
             }
+            break;
 
-            s->conn->pcb.tcp->keep_intvl = *(int*)optval;
-            return 0;
-
-        case NSAPI_REUSEADDR:
-            if (optlen != sizeof(int)) {
-                return NSAPI_ERROR_UNSUPPORTED;
+        case NSAPI_NODELAY:
+            if (!active) {
+                ret = NSAPI_ERROR_UNSUPPORTED;
+            } else if (val) {
+                tcp_nagle_disable(s->conn->pcb.tcp);
+            } else {
+                tcp_nagle_enable(s->conn->pcb.tcp);
             }
+            break;
 
-            if (*(int *)optval) {
-                s->conn->pcb.tcp->so_options |= SOF_REUSEADDR;
+        case NSAPI_REUSEADDR:
+            // must be set before bind to take effect
+            if (val) {
+                ip_set_option(s->conn->pcb.ip, SOF_REUSEADDR);
             } else {
-                s->conn->pcb.tcp->so_options &= ~SOF_REUSEADDR;
+                ip_reset_option(s->conn->pcb.ip, SOF_REUSEADDR);
             }
-            return 0;
+            break;
 
         default:
-            return NSAPI_ERROR_UNSUPPORTED;
+            ret = NSAPI_ERROR_UNSUPPORTED;
+            break;
     }
+
+    UNLOCK_TCPIP_CORE();
+    return ret;
 }
 
 static void mbed_lwip_socket_attach(nsapi_stack_t *stack, nsapi_socket_t handle, void (*callback)(void *), void *data)
@@ -839,6 +1205,454 @@ static void mbed_lwip_socket_attach(nsapi_stack_t *stack, nsapi_socket_t handle,
     s->data = data;
 }
 
+static nsapi_buf_t mbed_lwip_buf_alloc(nsapi_stack_t *stack, unsigned size)
+{
+    if (size > 0xffff) {
+        return 0;
+    }
+
+    struct netbuf *buf = netbuf_new();
+    if (!buf) {
+        return 0;
+    }
+
+    // Allocated without header room, so that sending the buffer chains the
+    // protocol headers in front of it instead of writing them into it
+    buf->p = pbuf_alloc(PBUF_RAW, (u16_t)size, PBUF_RAM);
+    if (!buf->p) {
+        netbuf_delete(buf);
+        return 0;
+    }
+
+    buf->ptr = buf->p;
+    return buf;
+}
+
+static void mbed_lwip_buf_free(nsapi_stack_t *stack, nsapi_buf_t buf)
+{
+    netbuf_delete((struct netbuf *)buf);
+}
+
+static unsigned mbed_lwip_buf_data(nsapi_stack_t *stack, nsapi_buf_t buf, unsigned offset, void **data)
+{
+    struct pbuf *p = ((struct netbuf *)buf)->p;
+
+    while (p && offset >= p->len) {
+        offset -= p->len;
+        p = p->next;
+    }
+
+    if (!p) {
+        return 0;
+    }
+
+    *data = (u8_t *)p->payload + offset;
+    return p->len - offset;
+}
+
+static int mbed_lwip_socket_send_buf(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_buf_t buf, unsigned offset)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    unsigned sent = 0;
+    unsigned len;
+    void *data;
+
+    // TCP segments must own their payload until it is acknowledged, so the
+    // pbufs are written into the segments directly
+    while ((len = mbed_lwip_buf_data(stack, buf, offset + sent, &data)) > 0) {
+        size_t bytes_written = 0;
+        err_t err = netconn_write_partly(s->conn, data, len, NETCONN_COPY, &bytes_written);
+        if (err != ERR_OK) {
+            if (!sent) {
+                return mbed_lwip_err_remap(err);
+            }
+            break;
+        }
+
+        sent += bytes_written;
+        if (bytes_written < len) {
+            break;
+        }
+    }
+
+    s->tx_bytes += sent;
+    return (int)sent;
+}
+
+static int mbed_lwip_socket_recv_buf(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_buf_t *buf)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+
+    if (!s->buf) {
+        err_t err = netconn_recv(s->conn, &s->buf);
+        s->offset = 0;
+
+        if (err != ERR_OK) {
+            return mbed_lwip_err_remap(err);
+        }
+    }
+
+    struct netbuf *recv = s->buf;
+
+    // A previous socket_recv may have consumed part of the pending
+    // netbuf, only the remainder is handed over
+    if (s->offset) {
+        u16_t len = netbuf_len(s->buf) - s->offset;
+        recv = mbed_lwip_buf_alloc(stack, len);
+        if (!recv) {
+            return NSAPI_ERROR_NO_MEMORY;
+        }
+
+        netbuf_copy_partial(s->buf, recv->p->payload, len, s->offset);
+        netbuf_delete(s->buf);
+    }
+
+    s->buf = 0;
+    s->offset = 0;
+
+    *buf = recv;
+    s->rx_bytes += netbuf_len(recv);
+    return netbuf_len(recv);
+}
+
+static int mbed_lwip_socket_sendto_buf(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_addr_t addr, uint16_t port, nsapi_buf_t buf)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    ip_addr_t ip_addr;
+
+    if (!convert_mbed_addr_to_lwip(&ip_addr, &addr)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    err_t err = netconn_sendto(s->conn, (struct netbuf *)buf, &ip_addr, port);
+    if (err != ERR_OK) {
+        return mbed_lwip_err_remap(err);
+    }
+
+    s->tx_bytes += netbuf_len((struct netbuf *)buf);
+    return netbuf_len((struct netbuf *)buf);
+}
+
+static int mbed_lwip_socket_recvfrom_buf(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_addr_t *addr, uint16_t *port, nsapi_buf_t *buf)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    struct netbuf *recv;
+
+    err_t err = netconn_recv(s->conn, &recv);
+    if (err != ERR_OK) {
+        return mbed_lwip_err_remap(err);
+    }
+
+    convert_lwip_addr_to_mbed(addr, netbuf_fromaddr(recv));
+    *port = netbuf_fromport(recv);
+
+    *buf = recv;
+    s->rx_bytes += netbuf_len(recv);
+    return netbuf_len(recv);
+}
+
+static int mbed_lwip_socket_sendmsg(nsapi_stack_t *stack, nsapi_socket_t handle, const nsapi_addr_t *addr, uint16_t port, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+
+    if (!addr) {
+        size_t sent = 0;
+
+        for (unsigned i = 0; i < iovcnt; i++) {
+            size_t bytes_written = 0;
+            u8_t flags = NETCONN_COPY | (i + 1 < iovcnt ? NETCONN_MORE : 0);
+            err_t err = netconn_write_partly(s->conn, iov[i].data, iov[i].size, flags, &bytes_written);
+            if (err != ERR_OK) {
+                if (!sent) {
+                    return mbed_lwip_err_remap(err);
+                }
+                break;
+            }
+
+            sent += bytes_written;
+            if (bytes_written < iov[i].size) {
+                break;
+            }
+        }
+
+        s->tx_bytes += sent;
+        return (int)sent;
+    }
+
+    ip_addr_t ip_addr;
+    if (!convert_mbed_addr_to_lwip(&ip_addr, addr)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    unsigned size = 0;
+    for (unsigned i = 0; i < iovcnt; i++) {
+        size += iov[i].size;
+    }
+
+    if (size > 0xffff) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    // Chain a reference to each buffer rather than copying them together
+    struct netbuf *buf = netbuf_new();
+    if (!buf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    err_t err = netbuf_ref(buf, iovcnt ? iov[0].data : 0, iovcnt ? (u16_t)iov[0].size : 0);
+    for (unsigned i = 1; i < iovcnt && err == ERR_OK; i++) {
+        if (!iov[i].size) {
+            continue;
+        }
+
+        struct pbuf *p = pbuf_alloc(PBUF_RAW, (u16_t)iov[i].size, PBUF_REF);
+        if (!p) {
+            err = ERR_MEM;
+            break;
+        }
+
+        p->payload = iov[i].data;
+        pbuf_cat(buf->p, p);
+    }
+
+    if (err == ERR_OK) {
+        err = netconn_sendto(s->conn, buf, &ip_addr, port);
+    }
+
+    netbuf_delete(buf);
+    if (err != ERR_OK) {
+        return mbed_lwip_err_remap(err);
+    }
+
+    s->tx_bytes += size;
+    return size;
+}
+
+static unsigned mbed_lwip_copy_to_iov(struct netbuf *buf, u16_t offset, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    unsigned copied = 0;
+
+    for (unsigned i = 0; i < iovcnt; i++) {
+        u16_t size = iov[i].size > 0xffff ? 0xffff : (u16_t)iov[i].size;
+        u16_t len = netbuf_copy_partial(buf, iov[i].data, size, offset + copied);
+        copied += len;
+        if (len < size) {
+            break;
+        }
+    }
+
+    return copied;
+}
+
+static int mbed_lwip_socket_recvmsg(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_addr_t *addr, uint16_t *port, const nsapi_iovec_t *iov, unsigned iovcnt, int *flags)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+
+    if (!addr) {
+        if (!s->buf) {
+            err_t err = netconn_recv(s->conn, &s->buf);
+            s->offset = 0;
+
+            if (err != ERR_OK) {
+                return mbed_lwip_err_remap(err);
+            }
+        }
+
+        unsigned recv = mbed_lwip_copy_to_iov(s->buf, s->offset, iov, iovcnt);
+        s->offset += recv;
+
+        if (s->offset >= netbuf_len(s->buf)) {
+            netbuf_delete(s->buf);
+            s->buf = 0;
+        }
+
+        s->rx_bytes += recv;
+        return recv;
+    }
+
+    struct netbuf *buf;
+    err_t err = netconn_recv(s->conn, &buf);
+    if (err != ERR_OK) {
+        return mbed_lwip_err_remap(err);
+    }
+
+    convert_lwip_addr_to_mbed(addr, netbuf_fromaddr(buf));
+    *port = netbuf_fromport(buf);
+
+    unsigned recv = mbed_lwip_copy_to_iov(buf, 0, iov, iovcnt);
+    *flags = recv < netbuf_len(buf) ? NSAPI_MSG_TRUNC : 0;
+    netbuf_delete(buf);
+
+    s->rx_bytes += recv;
+    return recv;
+}
+
+static int mbed_lwip_socket_sendmmsg(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    int ret = NSAPI_ERROR_OK;
+    unsigned i;
+
+    // A single netbuf references each packet in turn
+    struct netbuf *buf = netbuf_new();
+    if (!buf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    for (i = 0; i < count; i++) {
+        ip_addr_t ip_addr;
+        if (!convert_mbed_addr_to_lwip(&ip_addr, &msgs[i].addr) || msgs[i].size > 0xffff) {
+            ret = NSAPI_ERROR_PARAMETER;
+            break;
+        }
+
+        err_t err = netbuf_ref(buf, msgs[i].data, (u16_t)msgs[i].size);
+        if (err == ERR_OK) {
+            err = netconn_sendto(s->conn, buf, &ip_addr, msgs[i].port);
+        }
+
+        if (err != ERR_OK) {
+            ret = mbed_lwip_err_remap(err);
+            break;
+        }
+
+        msgs[i].len = msgs[i].size;
+        s->tx_bytes += msgs[i].size;
+    }
+
+    netbuf_delete(buf);
+    return i ? (int)i : ret;
+}
+
+static int mbed_lwip_socket_recvmmsg(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    unsigned i;
+
+    for (i = 0; i < count; i++) {
+        // Past the first packet, only drain what the recvmbox holds already
+        // rather than waiting out the receive timeout once it is empty
+        if (i > 0) {
+            sys_prot_t prot = sys_arch_protect();
+            s16_t rcvevent = s->rcvevent;
+            sys_arch_unprotect(prot);
+
+            if (rcvevent <= 0) {
+                break;
+            }
+        }
+
+        struct netbuf *buf;
+        err_t err = netconn_recv(s->conn, &buf);
+        if (err != ERR_OK) {
+            if (!i) {
+                return mbed_lwip_err_remap(err);
+            }
+            break;
+        }
+
+        convert_lwip_addr_to_mbed(&msgs[i].addr, netbuf_fromaddr(buf));
+        msgs[i].port = netbuf_fromport(buf);
+
+        u16_t size = msgs[i].size > 0xffff ? 0xffff : (u16_t)msgs[i].size;
+        u16_t recv = netbuf_copy(buf, msgs[i].data, size);
+        msgs[i].len = recv;
+        msgs[i].flags = recv < netbuf_len(buf) ? NSAPI_MSG_TRUNC : 0;
+        netbuf_delete(buf);
+
+        s->rx_bytes += recv;
+    }
+
+    return i;
+}
+
+static int mbed_lwip_socket_poll(nsapi_stack_t *stack, nsapi_socket_t handle)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+    int revents = 0;
+
+    sys_prot_t prot = sys_arch_protect();
+
+    if (s->rcvevent > 0 || s->buf) {
+        revents |= NSAPI_POLLIN;
+    }
+
+    if (s->sendevent) {
+        revents |= NSAPI_POLLOUT;
+    }
+
+    if (s->errevent) {
+        revents |= NSAPI_POLLERR;
+    }
+
+    sys_arch_unprotect(prot);
+    return revents;
+}
+
+static int mbed_lwip_get_stats(nsapi_stack_t *stack, nsapi_stack_stats_t *stats)
+{
+    memset(stats, 0, sizeof *stats);
+
+    stats->rx_packets = lwip_netif_stats.rx_packets;
+    stats->tx_packets = lwip_netif_stats.tx_packets;
+    stats->rx_bytes = lwip_netif_stats.rx_bytes;
+    stats->tx_bytes = lwip_netif_stats.tx_bytes;
+    stats->rx_drops = lwip_netif_stats.rx_drops;
+    stats->tx_drops = lwip_netif_stats.tx_drops;
+
+#if MIB2_STATS
+    stats->tcp_retransmits = lwip_stats.mib2.tcpretranssegs;
+#endif
+
+#if MEM_STATS
+    stats->heap_max = lwip_stats.mem.max;
+    stats->heap_size = lwip_stats.mem.avail;
+    stats->pool_errors += lwip_stats.mem.err;
+#endif
+
+#if MEMP_STATS
+    for (int i = 0; i < MEMP_MAX; i++) {
+        stats->pool_errors += lwip_stats.memp[i]->err;
+    }
+
+    stats->pbuf_pool_max = lwip_stats.memp[MEMP_PBUF_POOL]->max;
+    stats->pbuf_pool_size = lwip_stats.memp[MEMP_PBUF_POOL]->avail;
+#endif
+
+#if !DEVICE_EMAC
+    eth_arch_rx_get_stats(&lwip_netif, &stats->emac_drops, &stats->emac_overruns);
+#endif
+
+    return 0;
+}
+
+static int mbed_lwip_socket_get_stats(nsapi_stack_t *stack, nsapi_socket_t handle, nsapi_socket_stats_t *stats)
+{
+    struct lwip_socket *s = (struct lwip_socket *)handle;
+
+    memset(stats, 0, sizeof *stats);
+    stats->rx_bytes = s->rx_bytes;
+    stats->tx_bytes = s->tx_bytes;
+
+    LOCK_TCPIP_CORE();
+    if (NETCONNTYPE_GROUP(s->conn->type) == NETCONN_TCP && s->conn->pcb.tcp) {
+        struct tcp_pcb *pcb = s->conn->pcb.tcp;
+
+        if (pcb->state != LISTEN) {
+            // sa holds 8 times and sv 4 times the estimates, in slow timer ticks
+            stats->retransmits = pcb->nrtx;
+            stats->rtt_ms = (pcb->sa >> 3) * TCP_SLOW_INTERVAL;
+            stats->rtt_var_ms = (pcb->sv >> 2) * TCP_SLOW_INTERVAL;
+            stats->rto_ms = pcb->rto * TCP_SLOW_INTERVAL;
+            stats->cwnd = pcb->cwnd;
+            stats->send_queue = pcb->snd_queuelen;
+        }
+    }
+    UNLOCK_TCPIP_CORE();
+
+    return 0;
+}
+
 /* LWIP network stack */
 const nsapi_stack_api_t lwip_stack_api = {
     .gethostbyname      = mbed_lwip_gethostbyname,
@@ -854,6 +1668,21 @@ const nsapi_stack_api_t lwip_stack_api = {
     .socket_recvfrom    = mbed_lwip_socket_recvfrom,
     .setsockopt         = mbed_lwip_setsockopt,
     .socket_attach      = mbed_lwip_socket_attach,
+    .buf_alloc          = mbed_lwip_buf_alloc,
+    .buf_free           = mbed_lwip_buf_free,
+    .buf_data           = mbed_lwip_buf_data,
+    .socket_send_buf    = mbed_lwip_socket_send_buf,
+    .socket_recv_buf    = mbed_lwip_socket_recv_buf,
+    .socket_sendto_buf  = mbed_lwip_socket_sendto_buf,
+    .socket_recvfrom_buf = mbed_lwip_socket_recvfrom_buf,
+    .socket_sendmsg     = mbed_lwip_socket_sendmsg,
+    .socket_recvmsg     = mbed_lwip_socket_recvmsg,
+    .socket_sendmmsg    = mbed_lwip_socket_sendmmsg,
+    .socket_recvmmsg    = mbed_lwip_socket_recvmmsg,
+    .socket_send_static = mbed_lwip_socket_send_static,
+    .socket_poll        = mbed_lwip_socket_poll,
+    .get_stats          = mbed_lwip_get_stats,
+    .socket_get_stats   = mbed_lwip_socket_get_stats,
 };
 
 nsapi_stack_t lwip_stack = {
@@ -29,6 +29,16 @@ int mbed_lwip_init(emac_interface_t *emac);
 int mbed_lwip_bringup(bool dhcp, const char *ip, const char *netmask, const char *gw);
 int mbed_lwip_bringdown(void);
 
+// Non-blocking bring-up, completion is reported by the status callback,
+// which is called from the stack's threads
+void mbed_lwip_set_blocking(bool blocking);
+void mbed_lwip_attach(void (*cb)(void *ctx, nsapi_connection_status_t status), void *ctx);
+nsapi_connection_status_t mbed_lwip_get_connection_status(void);
+
+// Address of an earlier DHCP lease, asked for again by the next bring-up
+int mbed_lwip_set_dhcp_lease(const char *ip);
+char *mbed_lwip_get_dhcp_lease(char *buf, int buflen);
+
 const char *mbed_lwip_get_mac_address(void);
 char *mbed_lwip_get_ip_address(char *buf, int buflen);
 char *mbed_lwip_get_netmask(char *buf, int buflen);
@@ -78,7 +78,10 @@
 #define DEFAULT_TCP_RECVMBOX_SIZE   8
 #define DEFAULT_UDP_RECVMBOX_SIZE   8
 #define DEFAULT_RAW_RECVMBOX_SIZE   8
-#define DEFAULT_ACCEPTMBOX_SIZE     8
+
+// Connections completed but not yet accepted are queued in the accept
+// mailbox, listen() clamps the backlog to its size
+#define DEFAULT_ACCEPTMBOX_SIZE     MBED_CONF_LWIP_TCP_BACKLOG_MAX
 
 #ifdef LWIP_DEBUG
 #define TCPIP_THREAD_STACKSIZE      1200*2
@@ -88,11 +91,34 @@
 
 #define TCPIP_THREAD_PRIO           (osPriorityNormal)
 
+// Socket calls run in the calling thread under the core lock instead
+// of being posted to the tcpip thread
+#define LWIP_TCPIP_CORE_LOCKING     MBED_CONF_LWIP_TCPIP_CORE_LOCKING
+
+// Received packets are processed in the driver's receive thread under
+// the core lock, so the driver threads need room for the whole input path
+#if MBED_CONF_LWIP_TCPIP_CORE_LOCKING_INPUT
+#if !MBED_CONF_LWIP_TCPIP_CORE_LOCKING
+#error "lwip.tcpip-core-locking-input requires lwip.tcpip-core-locking"
+#endif
+#define LWIP_TCPIP_CORE_LOCKING_INPUT 1
+#else
+#define LWIP_TCPIP_CORE_LOCKING_INPUT 0
+#endif
+
 #ifdef LWIP_DEBUG
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+#define DEFAULT_THREAD_STACKSIZE    TCPIP_THREAD_STACKSIZE
+#else
 #define DEFAULT_THREAD_STACKSIZE    512*2
+#endif
+#else
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+#define DEFAULT_THREAD_STACKSIZE    TCPIP_THREAD_STACKSIZE
 #else
 #define DEFAULT_THREAD_STACKSIZE    512
 #endif
+#endif
 
 #define MEMP_NUM_SYS_TIMEOUT        16
 
@@ -105,17 +131,98 @@
 
 #define LWIP_RAM_HEAP_POINTER       lwip_ram_heap
 
-#define PBUF_POOL_SIZE              5
+// Memory profiles trade RAM for TCP throughput, selected with
+// lwip.memory-profile. Approximate RAM taken by the pbuf pool, the heap
+// and the pcbs, on top of the driver buffers:
+//   0 - small:      536 byte MSS, 2 KiB window,                ~20 KiB
+//   1 - balanced:   1460 byte MSS, 5.7 KiB window,             ~33 KiB
+//   2 - throughput: 1460 byte MSS, 34 KiB window, scaling on, ~120 KiB
+// The heap only grows to the profile's minimum, a larger target heap is
+// kept. Each setting can also be overridden on its own.
+#if MBED_CONF_LWIP_MEMORY_PROFILE == 2
+#define MBED_LWIP_TCP_MSS           1460
+#define MBED_LWIP_TCP_WND           (24 * MBED_LWIP_TCP_MSS)
+#define MBED_LWIP_TCP_SND_BUF       (24 * MBED_LWIP_TCP_MSS)
+#define MBED_LWIP_TCP_RCV_SCALE     1
+#define MBED_LWIP_TCP_SEG           96
+#define MBED_LWIP_TCP_QUEUE_OOSEQ   1
+#define MBED_LWIP_PBUF_POOL_SIZE    25
+#define MBED_LWIP_TCP_PCB           8
+#define MBED_LWIP_UDP_PCB           8
+#define MBED_LWIP_MEM_SIZE_MIN      (80 * 1024)
+#elif MBED_CONF_LWIP_MEMORY_PROFILE == 1
+#define MBED_LWIP_TCP_MSS           1460
+#define MBED_LWIP_TCP_WND           (4 * MBED_LWIP_TCP_MSS)
+#define MBED_LWIP_TCP_SND_BUF       (4 * MBED_LWIP_TCP_MSS)
+#define MBED_LWIP_TCP_RCV_SCALE     0
+#define MBED_LWIP_TCP_SEG           16
+#define MBED_LWIP_TCP_QUEUE_OOSEQ   0
+#define MBED_LWIP_PBUF_POOL_SIZE    5
+#define MBED_LWIP_TCP_PCB           6
+#define MBED_LWIP_UDP_PCB           6
+#define MBED_LWIP_MEM_SIZE_MIN      (24 * 1024)
+#else
+#define MBED_LWIP_TCP_MSS           536
+#define MBED_LWIP_TCP_WND           (4 * MBED_LWIP_TCP_MSS)
+#define MBED_LWIP_TCP_SND_BUF       (2 * MBED_LWIP_TCP_MSS)
+#define MBED_LWIP_TCP_RCV_SCALE     0
+#define MBED_LWIP_TCP_SEG           16
+#define MBED_LWIP_TCP_QUEUE_OOSEQ   0
+#define MBED_LWIP_PBUF_POOL_SIZE    5
+#define MBED_LWIP_TCP_PCB           4
+#define MBED_LWIP_UDP_PCB           4
+#define MBED_LWIP_MEM_SIZE_MIN      0
+#endif
+
+#ifdef MBED_CONF_LWIP_PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE              MBED_CONF_LWIP_PBUF_POOL_SIZE
+#else
+#define PBUF_POOL_SIZE              MBED_LWIP_PBUF_POOL_SIZE
+#endif
+
+#ifdef MBED_CONF_LWIP_TCP_SOCKET_MAX
+#define MEMP_NUM_TCP_PCB            MBED_CONF_LWIP_TCP_SOCKET_MAX
+#else
+#define MEMP_NUM_TCP_PCB            MBED_LWIP_TCP_PCB
+#endif
+
+#ifdef MBED_CONF_LWIP_UDP_SOCKET_MAX
+#define MEMP_NUM_UDP_PCB            MBED_CONF_LWIP_UDP_SOCKET_MAX
+#else
+#define MEMP_NUM_UDP_PCB            MBED_LWIP_UDP_PCB
+#endif
+
+// Each netconn embeds its mailboxes, so the lwIP default of 4 is kept
+// unless set. The socket table, sized in lwip_stack.c, holds one
+// netconn per socket
+#if defined(MBED_CONF_LWIP_NETCONN_MAX)
+#define MEMP_NUM_NETCONN            MBED_CONF_LWIP_NETCONN_MAX
+#elif defined(MBED_CONF_LWIP_SOCKET_MAX)
+#define MEMP_NUM_NETCONN            MBED_CONF_LWIP_SOCKET_MAX
+#endif
+
+#ifdef MBED_CONF_LWIP_MEM_SIZE
+#undef MEM_SIZE
+#define MEM_SIZE                    MBED_CONF_LWIP_MEM_SIZE
+#elif MEM_SIZE < MBED_LWIP_MEM_SIZE_MIN
+#undef MEM_SIZE
+#define MEM_SIZE                    MBED_LWIP_MEM_SIZE_MIN
+#endif
+
 #define MEMP_NUM_TCP_PCB_LISTEN     4
-#define MEMP_NUM_TCP_PCB            4
-#define MEMP_NUM_UDP_PCB            4
+// At least one segment per pbuf of a full send buffer, which a larger
+// lwip.tcp-snd-buf than the profile's asks for
+#define MEMP_NUM_TCP_SEG            LWIP_MAX(MBED_LWIP_TCP_SEG, TCP_SND_QUEUELEN)
 #define MEMP_NUM_PBUF               8
 #define MEMP_NUM_NETBUF             8
 
-#define TCP_QUEUE_OOSEQ             0
+#define TCP_QUEUE_OOSEQ             MBED_LWIP_TCP_QUEUE_OOSEQ
 #define TCP_OVERSIZE                0
 
 #define LWIP_DHCP                   LWIP_IPV4
+// Wait for the link before the first DHCP message, so a lease reused
+// with dhcp_start_reboot isn't given up while the link comes up
+#define LWIP_DHCP_CHECK_LINK_UP     1
 #define LWIP_DNS                    1
 #define LWIP_SOCKET                 0
 
@@ -131,6 +238,10 @@
 #define LWIP_SO_RCVTIMEO            1
 #define LWIP_TCP_KEEPALIVE          1
 
+// SYNs beyond the listen backlog are dropped rather than refused, so
+// clients retry once the server has accepted the pending connections
+#define TCP_LISTEN_BACKLOG          1
+
 // Fragmentation on, as per IPv4 default
 #define LWIP_IPV6_FRAG              LWIP_IPV6
 
@@ -179,7 +290,30 @@
 #define MEMP_SANITY_CHECK           1
 #else
 #define LWIP_NOASSERT               1
-#define LWIP_STATS                  0
+#define LWIP_STATS                  MBED_CONF_LWIP_STATS_ENABLED
+#endif
+
+// Release builds only keep the counters reported by get_stats: memory
+// pool high-water marks and the MIB2 TCP retransmission count
+#if LWIP_STATS && !defined(LWIP_DEBUG)
+#define LWIP_STATS_LARGE            1
+#define LINK_STATS                  0
+#define ETHARP_STATS                0
+#define IP_STATS                    0
+#define IPFRAG_STATS                0
+#define ICMP_STATS                  0
+#define IGMP_STATS                  0
+#define UDP_STATS                   0
+#define TCP_STATS                   0
+#define SYS_STATS                   0
+#define IP6_STATS                   0
+#define ICMP6_STATS                 0
+#define IP6_FRAG_STATS              0
+#define MLD6_STATS                  0
+#define ND6_STATS                   0
+#define MEM_STATS                   1
+#define MEMP_STATS                  1
+#define MIB2_STATS                  1
 #endif
 
 #define LWIP_DBG_TYPES_ON           LWIP_DBG_ON
@@ -199,10 +333,52 @@
 
 #define LWIP_CHECKSUM_ON_COPY       1
 
+// Checksums offloaded by the MAC are skipped per netif
+#define LWIP_CHECKSUM_CTRL_PER_NETIF 1
+
+// Drivers lend their DMA buffers to lwIP, see eth_arch_rx.h
+#define LWIP_SUPPORT_CUSTOM_PBUF    1
+
+// Receive interrupt moderation of those drivers
+#define ETH_ARCH_RX_BUDGET          MBED_CONF_LWIP_EMAC_RX_BUDGET
+#define ETH_ARCH_RX_HOLDOFF         MBED_CONF_LWIP_EMAC_RX_HOLDOFF
+
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETIF_STATUS_CALLBACK  1
 #define LWIP_NETIF_LINK_CALLBACK    1
 
+#ifdef MBED_CONF_LWIP_TCP_MSS
+#define TCP_MSS                     MBED_CONF_LWIP_TCP_MSS
+#else
+#define TCP_MSS                     MBED_LWIP_TCP_MSS
+#endif
+
+#ifdef MBED_CONF_LWIP_TCP_WND
+#define TCP_WND                     MBED_CONF_LWIP_TCP_WND
+#else
+#define TCP_WND                     MBED_LWIP_TCP_WND
+#endif
+
+#ifdef MBED_CONF_LWIP_TCP_SND_BUF
+#define TCP_SND_BUF                 MBED_CONF_LWIP_TCP_SND_BUF
+#else
+#define TCP_SND_BUF                 MBED_LWIP_TCP_SND_BUF
+#endif
+
+// Window scaling is needed for windows over 64 KiB, the window is
+// advertised in units of 2^TCP_RCV_SCALE bytes
+#ifdef MBED_CONF_LWIP_TCP_WND_SCALE
+#define TCP_RCV_SCALE               MBED_CONF_LWIP_TCP_WND_SCALE
+#else
+#define TCP_RCV_SCALE               MBED_LWIP_TCP_RCV_SCALE
+#endif
+
+#if TCP_RCV_SCALE > 0
+#define LWIP_WND_SCALE              1
+#else
+#define LWIP_WND_SCALE              0
+#endif
+
 #elif LWIP_TRANSPORT_PPP
 
 #define TCP_SND_BUF                     (3 * 536)
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __SLAB_ALLOCATOR_H__
+#define __SLAB_ALLOCATOR_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Number of size classes, of 16, 32, 64, 128 and 256 bytes. */
+#define SLAB_ALLOCATOR_CLASS_COUNT 5
+/** The largest size served from pages, larger sizes go to `malloc`. */
+#define SLAB_ALLOCATOR_MAX_SIZE    256
+
+/** Contains the allocator data, its pages and its mutex. */
+typedef void * SlabAllocator;
+
+/** Statistics of a slab allocator. */
+typedef struct {
+    uint32_t page_count;        /* Pages held, including the spare one. */
+    uint32_t page_requests;     /* Pages requested from the page heap. */
+    uint32_t chunks_used;       /* Chunks allocated from the pages. */
+    uint32_t bytes_used;        /* Bytes of these chunks, by size class. */
+    uint32_t bytes_used_max;    /* Maximum of `bytes_used`. */
+    uint32_t large_allocations; /* Allocations handed to `malloc`. */
+    uint32_t failures;          /* Allocations which could not be served. */
+    uint32_t class_chunks_used[SLAB_ALLOCATOR_CLASS_COUNT]; /* Chunks used in each size class. */
+} SlabAllocatorStats;
+
+/** Create a slab allocator using pages from the page heap.
+ * Each page serves chunks of a single size class from its own free list, so
+ * small allocations neither search nor fragment the memory. A page is
+ * requested when a size class runs out of chunks, and freed back to the page
+ * heap when its chunks are all freed, one empty page being kept for the next
+ * request.
+ *
+ * Allocations larger than `SLAB_ALLOCATOR_MAX_SIZE` go to `malloc`, the heap
+ * of the box. The allocator has its own mutex, so it must be created once
+ * the kernel runs, and only serializes the threads using it.
+ *
+ * @returns the allocator or `NULL` on failure (out of memory)
+ */
+SlabAllocator slab_allocator_create(void);
+
+/** Destroy the allocator and free its pages.
+ * Chunks still used are lost, allocations handed to `malloc` are not freed.
+ *
+ * @retval 0  Allocator successfully destroyed.
+ * @retval -1 Freeing memory pages failed.
+ */
+int slab_allocator_destroy(
+    SlabAllocator allocator);
+
+/** Drop-in for `malloc`. */
+void * slab_malloc(
+    SlabAllocator allocator,
+    size_t size);
+
+/** Drop-in for `realloc`.
+ * Memory stays in place while the new size fits its size class. */
+void * slab_realloc(
+    SlabAllocator allocator,
+    void * ptr,
+    size_t size);
+
+/** Drop-in for `free`. */
+void slab_free(
+    SlabAllocator allocator,
+    void * ptr);
+
+/** Copy the statistics of the allocator. */
+void slab_allocator_get_stats(
+    SlabAllocator allocator,
+    SlabAllocatorStats * stats);
+
+#ifdef __cplusplus
+}   /* extern "C" */
+#endif
+
+#endif  /* __SLAB_ALLOCATOR_H__ */
@@ -43,5 +43,6 @@
 #include "uvisor-lib/rtx/process_malloc.h"
 #include "uvisor-lib/rtx/rtx_box_index.h"
 #include "uvisor-lib/rtx/secure_allocator.h"
+#include "uvisor-lib/rtx/slab_allocator.h"
 
 #endif /* __UVISOR_LIB_UVISOR_LIB_H__ */
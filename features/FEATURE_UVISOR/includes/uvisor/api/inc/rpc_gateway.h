@@ -19,6 +19,7 @@
 
 #include "api/inc/rpc_gateway_exports.h"
 #include "api/inc/rpc.h"
+#include "api/inc/box_id.h"
 #include "api/inc/uvisor_exports.h"
 #include <stdint.h>
 
@@ -43,6 +44,11 @@
  *                     function. Each parameter must be no more than uint32_t
  *                     in size. If the RPC target function accepts no
  *                     arguments, pass `void` here.
+ *
+ * A call made from the box of the target function, e.g. by a library linked
+ * in that box calling its own gateways, crosses no isolation boundary: it
+ * calls the target function directly instead of queueing a message for the
+ * box's RPC thread.
  */
 #define UVISOR_BOX_RPC_GATEWAY_SYNC(box_name, gw_name, fn_name, fn_ret, ...) \
     UVISOR_STATIC_ASSERT(sizeof(fn_ret) <= sizeof(uint32_t), gw_name ## _return_type_too_big); \
@@ -163,6 +169,9 @@
 #define _UVISOR_BOX_RPC_GATEWAY_SYNC_CALLER_0(fn_name, gateway, ...) \
     static uint32_t _sgw_sync_ ## fn_name(void) \
     { \
+        if (rpc_gateway_is_local(&gateway)) { \
+            return ((uint32_t (*)(void)) gateway.target)(); \
+        } \
         return rpc_fncall_sync(0, 0, 0, 0, &gateway); \
     }
 
@@ -172,6 +181,9 @@
 #define _UVISOR_BOX_RPC_GATEWAY_SYNC_CALLER_1(fn_name, gateway, ...) \
     static uint32_t _sgw_sync_ ## fn_name(uint32_t p0) \
     { \
+        if (rpc_gateway_is_local(&gateway)) { \
+            return ((uint32_t (*)(uint32_t)) gateway.target)(p0); \
+        } \
         return rpc_fncall_sync(p0, 0, 0, 0, &gateway); \
     }
 
@@ -181,6 +193,9 @@
 #define _UVISOR_BOX_RPC_GATEWAY_SYNC_CALLER_2(fn_name, gateway, ...) \
     static uint32_t _sgw_sync_ ## fn_name(uint32_t p0, uint32_t p1) \
     { \
+        if (rpc_gateway_is_local(&gateway)) { \
+            return ((uint32_t (*)(uint32_t, uint32_t)) gateway.target)(p0, p1); \
+        } \
         return rpc_fncall_sync(p0, p1, 0, 0, &gateway); \
     }
 
@@ -190,6 +205,9 @@
 #define _UVISOR_BOX_RPC_GATEWAY_SYNC_CALLER_3(fn_name, gateway, ...) \
     static uint32_t _sgw_sync_ ## fn_name(uint32_t p0, uint32_t p1, uint32_t p2) \
     { \
+        if (rpc_gateway_is_local(&gateway)) { \
+            return ((uint32_t (*)(uint32_t, uint32_t, uint32_t)) gateway.target)(p0, p1, p2); \
+        } \
         return rpc_fncall_sync(p0, p1, p2, 0, &gateway); \
     }
 
@@ -199,6 +217,9 @@
 #define _UVISOR_BOX_RPC_GATEWAY_SYNC_CALLER_4(fn_name, gateway, ...) \
     static uint32_t _sgw_sync_ ## fn_name(uint32_t p0, uint32_t p1, uint32_t p2, uint32_t p3) \
     { \
+        if (rpc_gateway_is_local(&gateway)) { \
+            return ((uint32_t (*)(uint32_t, uint32_t, uint32_t, uint32_t)) gateway.target)(p0, p1, p2, p3); \
+        } \
         return rpc_fncall_sync(p0, p1, p2, p3, &gateway); \
     }
 
@@ -261,6 +282,17 @@
         return rpc_fncall_async(p0, p1, p2, p3, &gateway); \
     }
 
+/* Start of the table of box configuration pointers, in box ID order. */
+UVISOR_EXTERN const uint32_t __uvisor_cfgtbl_ptr_start;
+
+/* Check whether the target of a gateway is in the current box, for the
+ * synchronous gateways to skip the RPC. */
+static UVISOR_FORCEINLINE int rpc_gateway_is_local(const TRPCGateway * gateway)
+{
+    int box_id = (int) ((gateway->box_ptr - (uint32_t) &__uvisor_cfgtbl_ptr_start) / sizeof(uint32_t));
+    return box_id == uvisor_box_id_self();
+}
+
 /* This function is private to uvisor-lib, but needs to be publicly visible for
  * the RPC gateway creation macros to work. */
 UVISOR_EXTERN uint32_t rpc_fncall_sync(uint32_t p0, uint32_t p1, uint32_t p2, uint32_t p3, const TRPCGateway * gateway);
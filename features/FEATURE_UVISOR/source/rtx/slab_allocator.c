@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cmsis_os.h"
+#include "uvisor-lib/uvisor-lib.h"
+#include "slab_allocator.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Use printf with caution inside malloc: printf may allocate memory itself,
+   so using printf in malloc may lead to recursive calls! */
+#define DPRINTF(...) {}
+
+/* The smallest size class, each next class being twice as large. */
+#define SLAB_MIN_SIZE 16
+/* The header at the origin of each page, keeping the chunks 8B aligned. */
+#define SLAB_PAGE_HEADER_SIZE 16
+
+typedef struct SlabPage {
+    /* The next page of the same size class. */
+    struct SlabPage * next;
+    /* The free chunks of the page, each pointing to the next one. */
+    void * free_list;
+    /* The number of chunks allocated from the page. */
+    uint16_t used;
+    /* The size class of the chunks. */
+    uint16_t size_class;
+} SlabPage;
+
+/* The header must fit in front of the chunks. */
+typedef char slab_page_header_fits[sizeof(SlabPage) <= SLAB_PAGE_HEADER_SIZE ? 1 : -1];
+
+typedef struct {
+    /* Pages serving each size class. */
+    SlabPage * pages[SLAB_ALLOCATOR_CLASS_COUNT];
+    /* An empty page, kept for the next size class running out of chunks. */
+    SlabPage * spare;
+    uint32_t page_size;
+    SlabAllocatorStats stats;
+
+    osMutexId mutex_id;
+    osMutexDef_t mutex;
+    int32_t mutex_data[4];
+} SlabAllocatorInternal;
+
+static inline size_t chunk_size(uint16_t size_class)
+{
+    return SLAB_MIN_SIZE << size_class;
+}
+
+/* @returns the size class of the size, or `SLAB_ALLOCATOR_CLASS_COUNT` if it
+ * is too large. */
+static uint16_t size_class_of(size_t size)
+{
+    uint16_t size_class = 0;
+    while ((size_class < SLAB_ALLOCATOR_CLASS_COUNT) && (size > chunk_size(size_class))) {
+        size_class++;
+    }
+    return size_class;
+}
+
+static int page_request(SlabAllocatorInternal * allocator, SlabPage ** page)
+{
+    UvisorPageTable table;
+    table.page_size = allocator->page_size;
+    table.page_count = 1;
+    table.page_origins[0] = NULL;
+
+    if (uvisor_page_malloc(&table)) {
+        return -1;
+    }
+    *page = (SlabPage *) table.page_origins[0];
+    allocator->stats.page_count++;
+    allocator->stats.page_requests++;
+    return 0;
+}
+
+static int page_release(SlabAllocatorInternal * allocator, SlabPage * page)
+{
+    UvisorPageTable table;
+    table.page_size = allocator->page_size;
+    table.page_count = 1;
+    table.page_origins[0] = page;
+
+    if (uvisor_page_free(&table)) {
+        DPRINTF("slab_allocator: Unable to free page %p!\n", page);
+        return -1;
+    }
+    allocator->stats.page_count--;
+    return 0;
+}
+
+/* Give a page to a size class, threading its free list through the chunks. */
+static void page_init(SlabAllocatorInternal * allocator, SlabPage * page, uint16_t size_class)
+{
+    const size_t size = chunk_size(size_class);
+    const uint32_t count = (allocator->page_size - SLAB_PAGE_HEADER_SIZE) / size;
+    uint8_t * chunk = (uint8_t *) page + SLAB_PAGE_HEADER_SIZE;
+
+    page->free_list = chunk;
+    for (uint32_t i = 1; i < count; i++) {
+        *((void **) chunk) = chunk + size;
+        chunk += size;
+    }
+    *((void **) chunk) = NULL;
+
+    page->used = 0;
+    page->size_class = size_class;
+    page->next = allocator->pages[size_class];
+    allocator->pages[size_class] = page;
+}
+
+/* @returns the page the memory was allocated from, or `NULL` if it does not
+ * come from a page. */
+static SlabPage * page_of(SlabAllocatorInternal * allocator, void * ptr)
+{
+    const uint32_t addr = (uint32_t) ptr;
+    for (uint16_t size_class = 0; size_class < SLAB_ALLOCATOR_CLASS_COUNT; size_class++) {
+        for (SlabPage * page = allocator->pages[size_class]; page; page = page->next) {
+            const uint32_t origin = (uint32_t) page;
+            if ((addr >= origin + SLAB_PAGE_HEADER_SIZE) && (addr < origin + allocator->page_size)) {
+                return page;
+            }
+        }
+    }
+    return NULL;
+}
+
+static void * chunk_alloc(SlabAllocatorInternal * allocator, uint16_t size_class)
+{
+    SlabPage * page = allocator->pages[size_class];
+    while (page && (page->free_list == NULL)) {
+        page = page->next;
+    }
+
+    if (page == NULL) {
+        /* The size class is out of chunks, take the spare page or a new one. */
+        if (allocator->spare) {
+            page = allocator->spare;
+            allocator->spare = NULL;
+        } else if (page_request(allocator, &page)) {
+            DPRINTF("slab_malloc: Not enough free pages available!\n");
+            return NULL;
+        }
+        page_init(allocator, page, size_class);
+    }
+
+    void * chunk = page->free_list;
+    page->free_list = *((void **) chunk);
+    page->used++;
+
+    allocator->stats.chunks_used++;
+    allocator->stats.class_chunks_used[size_class]++;
+    allocator->stats.bytes_used += chunk_size(size_class);
+    if (allocator->stats.bytes_used > allocator->stats.bytes_used_max) {
+        allocator->stats.bytes_used_max = allocator->stats.bytes_used;
+    }
+    return chunk;
+}
+
+static void chunk_free(SlabAllocatorInternal * allocator, SlabPage * page, void * chunk)
+{
+    const uint16_t size_class = page->size_class;
+
+    /* Pointers inside a chunk are not freed, as they would corrupt the page. */
+    if (((uint32_t) chunk - (uint32_t) page - SLAB_PAGE_HEADER_SIZE) % chunk_size(size_class)) {
+        DPRINTF("slab_free: %p is not a chunk of page %p!\n", chunk, page);
+        return;
+    }
+
+    *((void **) chunk) = page->free_list;
+    page->free_list = chunk;
+    page->used--;
+
+    allocator->stats.chunks_used--;
+    allocator->stats.class_chunks_used[size_class]--;
+    allocator->stats.bytes_used -= chunk_size(size_class);
+
+    if (page->used == 0) {
+        /* Take the empty page from its size class, keeping one spare. */
+        SlabPage ** link = &allocator->pages[size_class];
+        while (*link != page) {
+            link = &(*link)->next;
+        }
+        *link = page->next;
+
+        if (allocator->spare == NULL) {
+            allocator->spare = page;
+        } else {
+            page_release(allocator, page);
+        }
+    }
+}
+
+static inline SlabAllocatorInternal * lock(SlabAllocator allocator)
+{
+    SlabAllocatorInternal * alloc = (SlabAllocatorInternal *) allocator;
+    osMutexWait(alloc->mutex_id, osWaitForever);
+    return alloc;
+}
+
+static inline void unlock(SlabAllocatorInternal * allocator)
+{
+    osMutexRelease(allocator->mutex_id);
+}
+
+SlabAllocator slab_allocator_create(void)
+{
+    const uint32_t page_size = uvisor_get_page_size();
+    /* Pages must hold at least two chunks of the largest size class. */
+    if (page_size < SLAB_PAGE_HEADER_SIZE + 2 * SLAB_ALLOCATOR_MAX_SIZE) {
+        DPRINTF("slab_allocator_create: Page size %uB is too small\n\n", page_size);
+        return NULL;
+    }
+
+    SlabAllocatorInternal * const allocator = malloc(sizeof(SlabAllocatorInternal));
+    if (allocator == NULL) {
+        DPRINTF("slab_allocator_create: SlabAllocatorInternal failed to be allocated!\n\n");
+        return NULL;
+    }
+    memset(allocator, 0, sizeof(SlabAllocatorInternal));
+    allocator->page_size = page_size;
+
+    allocator->mutex.mutex = allocator->mutex_data;
+    allocator->mutex_id = osMutexCreate(&allocator->mutex);
+    if (allocator->mutex_id == NULL) {
+        free(allocator);
+        DPRINTF("slab_allocator_create: Mutex failed to be created!\n\n");
+        return NULL;
+    }
+    return (SlabAllocator) allocator;
+}
+
+int slab_allocator_destroy(
+    SlabAllocator allocator)
+{
+    SlabAllocatorInternal * alloc = (SlabAllocatorInternal *) allocator;
+    int ret = 0;
+
+    for (uint16_t size_class = 0; size_class < SLAB_ALLOCATOR_CLASS_COUNT; size_class++) {
+        SlabPage * page = alloc->pages[size_class];
+        while (page) {
+            SlabPage * next = page->next;
+            if (page_release(alloc, page)) {
+                ret = -1;
+            }
+            page = next;
+        }
+    }
+    if (alloc->spare && page_release(alloc, alloc->spare)) {
+        ret = -1;
+    }
+
+    osMutexDelete(alloc->mutex_id);
+    free(alloc);
+    return ret;
+}
+
+void * slab_malloc(
+    SlabAllocator allocator,
+    size_t size)
+{
+    const uint16_t size_class = size_class_of(size);
+    SlabAllocatorInternal * alloc = lock(allocator);
+    void * mem = NULL;
+
+    if (size_class < SLAB_ALLOCATOR_CLASS_COUNT) {
+        mem = chunk_alloc(alloc, size_class);
+        if (mem == NULL) {
+            alloc->stats.failures++;
+        }
+        unlock(alloc);
+        return mem;
+    }
+    unlock(alloc);
+
+    /* malloc serializes the box heap with its own mutex. */
+    mem = malloc(size);
+
+    alloc = lock(allocator);
+    if (mem) {
+        alloc->stats.large_allocations++;
+    } else {
+        alloc->stats.failures++;
+    }
+    unlock(alloc);
+    return mem;
+}
+
+void * slab_realloc(
+    SlabAllocator allocator,
+    void * ptr,
+    size_t size)
+{
+    /* Passing NULL as ptr is legal, realloc acts as malloc then. */
+    if (ptr == NULL) {
+        return slab_malloc(allocator, size);
+    }
+
+    SlabAllocatorInternal * alloc = lock(allocator);
+    SlabPage * page = page_of(alloc, ptr);
+    size_t old_size = page ? chunk_size(page->size_class) : 0;
+    unlock(alloc);
+
+    if (page == NULL) {
+        /* Large memory staying large is left to the box heap. */
+        if (size > SLAB_ALLOCATOR_MAX_SIZE) {
+            return realloc(ptr, size);
+        }
+        /* It shrinks into a chunk, and was larger than the new size. */
+        old_size = size;
+    } else if (size <= old_size) {
+        return ptr;
+    }
+
+    void * new_ptr = slab_malloc(allocator, size);
+    if (new_ptr == NULL) {
+        return NULL;
+    }
+    memcpy(new_ptr, ptr, size < old_size ? size : old_size);
+    slab_free(allocator, ptr);
+    return new_ptr;
+}
+
+void slab_free(
+    SlabAllocator allocator,
+    void * ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    SlabAllocatorInternal * alloc = lock(allocator);
+    SlabPage * page = page_of(alloc, ptr);
+    if (page) {
+        chunk_free(alloc, page, ptr);
+    }
+    unlock(alloc);
+
+    if (page == NULL) {
+        free(ptr);
+    }
+}
+
+void slab_allocator_get_stats(
+    SlabAllocator allocator,
+    SlabAllocatorStats * stats)
+{
+    SlabAllocatorInternal * alloc = lock(allocator);
+    memcpy(stats, &alloc->stats, sizeof(SlabAllocatorStats));
+    unlock(alloc);
+}
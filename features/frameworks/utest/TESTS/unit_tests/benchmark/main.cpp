@@ -0,0 +1,91 @@
+
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "greentea-client/test_env.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+using namespace utest::v1;
+
+static int call_counter(0);
+
+void count_iteration()
+{
+    call_counter++;
+}
+
+void wait_iteration()
+{
+    wait_us(20);
+}
+
+// Benchmark without a baseline ---------------------------------------------------------------------------------------
+static const benchmark_t count_benchmark = { count_iteration, 5, 50, BENCHMARK_CYCLES, 0, 0 };
+
+utest::v1::status_t count_case_teardown(const Case *const source, const size_t passed, const size_t failed, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(55, call_counter);
+    TEST_ASSERT_EQUAL(1, passed);
+    TEST_ASSERT_EQUAL(0, failed);
+    return greentea_case_teardown_handler(source, passed, failed, failure);
+}
+
+// Benchmark within its baseline --------------------------------------------------------------------------------------
+static const benchmark_t within_benchmark = { wait_iteration, 2, 20, BENCHMARK_US, 1000, 10 };
+
+// Benchmark above its baseline ---------------------------------------------------------------------------------------
+static const benchmark_t above_benchmark = { wait_iteration, 2, 20, BENCHMARK_US, 5, 0 };
+
+utest::v1::status_t above_failure(const Case *const source, const failure_t failure)
+{
+    TEST_ASSERT_EQUAL(REASON_ASSERTION, failure.reason);
+    TEST_ASSERT_EQUAL(LOCATION_CASE_HANDLER, failure.location);
+    verbose_case_failure_handler(source, failure.ignored());
+    return STATUS_IGNORE;
+}
+
+// Statistics ---------------------------------------------------------------------------------------------------------
+void statistics_case()
+{
+    benchmark_result_t result;
+    TEST_ASSERT_EQUAL(REASON_NONE, benchmark_run("wait 20us", within_benchmark, &result));
+    TEST_ASSERT(result.min >= 20);
+    TEST_ASSERT(result.min <= result.median);
+    TEST_ASSERT(result.median <= result.p99);
+    TEST_ASSERT(result.p99 <= result.max);
+}
+
+// Cases --------------------------------------------------------------------------------------------------------------
+Case cases[] = {
+    Case("Benchmark without baseline", greentea_case_setup_handler, count_benchmark, count_case_teardown),
+    Case("Benchmark within its baseline", within_benchmark),
+    Case("Benchmark above its baseline fails", above_benchmark, above_failure),
+    Case("Benchmark statistics", statistics_case),
+};
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(15, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    Harness::run(specification);
+}
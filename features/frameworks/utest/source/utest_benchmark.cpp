@@ -0,0 +1,112 @@
+/****************************************************************************
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#undef MBED_PROFILE_ENABLED
+#define MBED_PROFILE_ENABLED 1
+#include "platform/mbed_profile.h"
+#include "hal/us_ticker_api.h"
+#include "utest/utest_benchmark.h"
+#include "utest/utest_serial.h"
+#include "greentea-client/test_env.h"
+#include <stdlib.h>
+
+using namespace utest::v1;
+
+static int compare_samples(const void *a, const void *b)
+{
+    const uint32_t x = *static_cast<const uint32_t *>(a);
+    const uint32_t y = *static_cast<const uint32_t *>(b);
+    return (x > y) - (x < y);
+}
+
+static void empty_iteration(void)
+{
+}
+
+static uint32_t measure(const benchmark_t &benchmark)
+{
+    if (benchmark.unit == BENCHMARK_US) {
+        const uint32_t start = us_ticker_read();
+        benchmark.iteration();
+        return us_ticker_read() - start;
+    }
+    const uint32_t start = mbed_profile_start();
+    benchmark.iteration();
+    return mbed_profile_elapsed(start);
+}
+
+failure_reason_t utest::v1::benchmark_run(const char *description, const benchmark_t &benchmark, benchmark_result_t *result)
+{
+    if ((benchmark.iteration == NULL) || (benchmark.iterations == 0)) {
+        return REASON_CASE_HANDLER;
+    }
+    uint32_t *samples = static_cast<uint32_t *>(malloc(benchmark.iterations * sizeof(uint32_t)));
+    if (samples == NULL) {
+        utest_printf(">>> Benchmark '%s' could not allocate %u samples\n", description, (unsigned)benchmark.iterations);
+        return REASON_CASE_HANDLER;
+    }
+
+    for (uint32_t i = 0; i < benchmark.warmup; i++) {
+        benchmark.iteration();
+    }
+    // Offset of the measurement itself, the fastest of a few empty ones
+    uint32_t overhead = UINT32_MAX;
+    for (uint32_t i = 0; i < 8; i++) {
+        benchmark_t empty = benchmark;
+        empty.iteration = empty_iteration;
+        const uint32_t sample = measure(empty);
+        if (sample < overhead) overhead = sample;
+    }
+    for (uint32_t i = 0; i < benchmark.iterations; i++) {
+        const uint32_t sample = measure(benchmark);
+        samples[i] = (sample > overhead) ? (sample - overhead) : 0;
+    }
+
+    qsort(samples, benchmark.iterations, sizeof(uint32_t), compare_samples);
+    benchmark_result_t stats;
+    stats.min = samples[0];
+    stats.median = samples[benchmark.iterations / 2];
+    stats.p99 = samples[(uint64_t)(benchmark.iterations - 1) * 99 / 100];
+    stats.max = samples[benchmark.iterations - 1];
+    free(samples);
+
+    const char *unit = (benchmark.unit == BENCHMARK_US) ? "us" : "cycles";
+    utest_printf(">>> Benchmark '%s': min %lu, median %lu, p99 %lu, max %lu %s over %lu iterations\n", description,
+                 (unsigned long)stats.min, (unsigned long)stats.median, (unsigned long)stats.p99,
+                 (unsigned long)stats.max, unit, (unsigned long)benchmark.iterations);
+
+    char value[96];
+    snprintf(value, sizeof(value), "%s;%lu;%lu;%lu;%lu;%lu;%s", description,
+             (unsigned long)stats.min, (unsigned long)stats.median, (unsigned long)stats.p99,
+             (unsigned long)stats.max, (unsigned long)benchmark.baseline, unit);
+    greentea_send_kv("utest_benchmark", value);
+
+    if (result) {
+        *result = stats;
+    }
+
+    if (benchmark.baseline) {
+        const uint64_t limit = (uint64_t)benchmark.baseline * (100 + benchmark.tolerance) / 100;
+        if (stats.median > limit) {
+            utest_printf(">>> Benchmark '%s' regressed: median %lu above baseline %lu + %lu%%\n", description,
+                         (unsigned long)stats.median, (unsigned long)benchmark.baseline, (unsigned long)benchmark.tolerance);
+            return REASON_ASSERTION;
+        }
+    }
+    return REASON_NONE;
+}
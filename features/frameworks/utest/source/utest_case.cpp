@@ -31,6 +31,7 @@ Case::Case(const char *description,
     handler(handler),
     control_handler(ignore_handler),
     repeat_count_handler(ignore_handler),
+    benchmark(NULL),
     setup_handler(setup_handler),
     teardown_handler(teardown_handler),
     failure_handler(failure_handler)
@@ -44,6 +45,7 @@ Case::Case(const char *description,
     handler(handler),
     control_handler(ignore_handler),
     repeat_count_handler(ignore_handler),
+    benchmark(NULL),
     setup_handler(default_handler),
     teardown_handler(teardown_handler),
     failure_handler(failure_handler)
@@ -56,6 +58,7 @@ Case::Case(const char *description,
     handler(handler),
     control_handler(ignore_handler),
     repeat_count_handler(ignore_handler),
+    benchmark(NULL),
     setup_handler(default_handler),
     teardown_handler(default_handler),
     failure_handler(failure_handler)
@@ -71,6 +74,7 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(handler),
     repeat_count_handler(ignore_handler),
+    benchmark(NULL),
     setup_handler(setup_handler),
     teardown_handler(teardown_handler),
     failure_handler(failure_handler)
@@ -84,6 +88,7 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(handler),
     repeat_count_handler(ignore_handler),
+    benchmark(NULL),
     setup_handler(default_handler),
     teardown_handler(teardown_handler),
     failure_handler(failure_handler)
@@ -96,6 +101,7 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(handler),
     repeat_count_handler(ignore_handler),
+    benchmark(NULL),
     setup_handler(default_handler),
     teardown_handler(default_handler),
     failure_handler(failure_handler)
@@ -111,6 +117,7 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(ignore_handler),
     repeat_count_handler(case_repeat_count_handler),
+    benchmark(NULL),
     setup_handler(setup_handler),
     teardown_handler(teardown_handler),
     failure_handler(failure_handler)
@@ -123,6 +130,7 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(ignore_handler),
     repeat_count_handler(case_repeat_count_handler),
+    benchmark(NULL),
     setup_handler(default_handler),
     teardown_handler(default_handler),
     failure_handler(failure_handler)
@@ -136,11 +144,41 @@ Case::Case(const char *description,
     handler(ignore_handler),
     control_handler(ignore_handler),
     repeat_count_handler(case_repeat_count_handler),
+    benchmark(NULL),
     setup_handler(default_handler),
     teardown_handler(teardown_handler),
     failure_handler(failure_handler)
 {}
 
+// benchmark
+Case::Case(const char *description,
+           const benchmark_t &benchmark,
+           const case_failure_handler_t failure_handler) :
+    description(description),
+    handler(ignore_handler),
+    control_handler(ignore_handler),
+    repeat_count_handler(ignore_handler),
+    benchmark(&benchmark),
+    setup_handler(default_handler),
+    teardown_handler(default_handler),
+    failure_handler(failure_handler)
+{}
+
+Case::Case(const char *description,
+           const case_setup_handler_t setup_handler,
+           const benchmark_t &benchmark,
+           const case_teardown_handler_t teardown_handler,
+           const case_failure_handler_t failure_handler) :
+    description(description),
+    handler(ignore_handler),
+    control_handler(ignore_handler),
+    repeat_count_handler(ignore_handler),
+    benchmark(&benchmark),
+    setup_handler(setup_handler),
+    teardown_handler(teardown_handler),
+    failure_handler(failure_handler)
+{}
+
 const char*
 Case::get_description() const {
     return description;
@@ -148,5 +186,5 @@ Case::get_description() const {
 
 bool
 Case::is_empty() const {
-    return !(handler || control_handler || repeat_count_handler || setup_handler || teardown_handler);
+    return !(handler || control_handler || repeat_count_handler || benchmark || setup_handler || teardown_handler);
 }
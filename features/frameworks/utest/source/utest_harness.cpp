@@ -340,6 +340,11 @@ void Harness::run_next_case()
             case_control = case_control + case_current->control_handler();
         } else if (case_current->repeat_count_handler) {
             case_control = case_control + case_current->repeat_count_handler(case_repeat_count);
+        } else if (case_current->benchmark) {
+            failure_reason_t reason = benchmark_run(case_current->description, *case_current->benchmark);
+            if (reason != REASON_NONE) {
+                raise_failure(reason);
+            }
         }
         case_repeat_count++;
 
@@ -24,6 +24,7 @@
 
 #include "utest/utest_types.h"
 #include "utest/utest_case.h"
+#include "utest/utest_benchmark.h"
 #include "utest/utest_default_handlers.h"
 #include "utest/utest_harness.h"
 #include "utest/utest_serial.h"
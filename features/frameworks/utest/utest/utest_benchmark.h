@@ -0,0 +1,87 @@
+/****************************************************************************
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ****************************************************************************
+ */
+
+#ifndef UTEST_BENCHMARK_H
+#define UTEST_BENCHMARK_H
+
+#include <stdint.h>
+#include "utest/utest_types.h"
+
+
+namespace utest {
+/** \addtogroup frameworks */
+/** @{*/
+namespace v1 {
+
+    /// What a benchmark measures
+    enum benchmark_unit_t {
+        BENCHMARK_CYCLES = 0,   ///< CPU cycles, see `mbed_profile.h`: iterations must be shorter than an RTOS tick on Cortex-M0
+        BENCHMARK_US     = 1,   ///< Microseconds of the us ticker
+    };
+
+    /** Description of a benchmark case.
+     *
+     * The iteration handler is called `warmup` times unmeasured, then
+     * `iterations` times, each call being timed. The statistics of the times
+     * are printed and sent to the host with the `utest_benchmark` key, as
+     * `<description>;<min>;<median>;<p99>;<max>;<baseline>;<unit>`.
+     *
+     * A non-zero `baseline` is the median expected, from an earlier run: the
+     * case fails when the median exceeds it by more than `tolerance` percent.
+     *
+     * @code
+     * static const benchmark_t copy_benchmark = { copy_1k, 10, 1000, BENCHMARK_CYCLES, 1100, 5 };
+     *
+     * Case cases[] = {
+     *     Case("Copy 1kB", copy_benchmark),
+     * };
+     * @endcode
+     */
+    struct benchmark_t {
+        case_handler_t iteration;   ///< A single iteration of the benchmark
+        uint32_t warmup;            ///< Iterations run before measuring
+        uint32_t iterations;        ///< Iterations measured
+        benchmark_unit_t unit;      ///< Cycles or microseconds
+        uint32_t baseline;          ///< Median expected, 0 not to check it
+        uint32_t tolerance;         ///< Percent the median may exceed the baseline by
+    };
+
+    /// Statistics of the times of a benchmark
+    struct benchmark_result_t {
+        uint32_t min;
+        uint32_t median;
+        uint32_t p99;           ///< 99th percentile
+        uint32_t max;
+    };
+
+    /** Run a benchmark and report its statistics, as the harness does for a benchmark case.
+     *
+     * @param description the name reported
+     * @param benchmark the benchmark to run
+     * @param result receives the statistics, may be `NULL`
+     * @returns `REASON_NONE`, `REASON_CASE_HANDLER` if the samples could not be allocated or
+     *          `REASON_ASSERTION` if the median exceeds the baseline.
+     */
+    failure_reason_t benchmark_run(const char *description, const benchmark_t &benchmark, benchmark_result_t *result = NULL);
+
+}   // namespace v1
+}   // namespace utest
+
+#endif // UTEST_BENCHMARK_H
+
+/** @}*/
@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include "utest/utest_types.h"
 #include "utest/utest_default_handlers.h"
+#include "utest/utest_benchmark.h"
 
 
 namespace utest {
@@ -103,6 +104,17 @@ namespace v1 {
             const case_teardown_handler_t teardown_handler,
             const case_failure_handler_t failure_handler = default_handler);
 
+        // overloads for benchmark_t, which must outlive the case
+        Case(const char *description,
+            const benchmark_t &benchmark,
+            const case_failure_handler_t failure_handler = default_handler);
+
+        Case(const char *description,
+            const case_setup_handler_t setup_handler,
+            const benchmark_t &benchmark,
+            const case_teardown_handler_t teardown_handler = default_handler,
+            const case_failure_handler_t failure_handler = default_handler);
+
 
         /// @returns the textual description of the test case
         const char* get_description() const;
@@ -116,6 +128,7 @@ namespace v1 {
         const case_handler_t handler;
         const case_control_handler_t control_handler;
         const case_call_count_handler_t repeat_count_handler;
+        const benchmark_t *const benchmark;
 
         const case_setup_handler_t setup_handler;
         const case_teardown_handler_t teardown_handler;
@@ -0,0 +1,236 @@
+#!/usr/bin/env python
+"""
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Generates ../platform/src/mbed_ecp_tables.c, the comb tables ecp_mul_comb
+precomputes for the generator of each curve, so they can be kept in flash.
+
+The tables follow ecp_precompute_comb: with w the window size and
+d = ceil(nbits / w), T[i] = (1 + sum of 2^(d(l+1)) for each bit l set in i) G
+for i < 2^(w-1), in affine coordinates. The window size is the one
+ecp_mul_comb picks for the generator with MBEDTLS_ECP_FIXED_POINT_OPTIM
+and the default MBEDTLS_ECP_WINDOW_SIZE. Rerun after importing an mbed TLS
+release that changes the comb method.
+
+Usage: gen-ecp-tables.py > ../platform/src/mbed_ecp_tables.c
+"""
+
+import sys
+
+
+# Short Weierstrass curves with a = -3: name, p, b, Gx, Gy, bits
+CURVES = [
+    ('SECP256R1',
+     0xffffffff00000001000000000000000000000000ffffffffffffffffffffffff,
+     0x5ac635d8aa3a93e7b3ebbd55769886bc651d06b0cc53b0f63bce3c3e27d2604b,
+     0x6b17d1f2e12c4247f8bce6e563a440f277037d812deb33a0f4a13945d898c296,
+     0x4fe342e2fe1a7f9b8ee7eb4a7c0f9e162bce33576b315ececbb6406837bf51f5,
+     256),
+    ('SECP384R1',
+     0xfffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffeffffffff0000000000000000ffffffff,
+     0xb3312fa7e23ee7e4988e056be3f82d19181d9c6efe8141120314088f5013875ac656398d8a2ed19d2a85c8edd3ec2aef,
+     0xaa87ca22be8b05378eb1c71ef320ad746e1d3b628ba79b9859f741e082542a385502f25dbf55296c3a545e3872760ab7,
+     0x3617de4a96262c6f5d9e98bf9292dc29f8f41dbd289a147ce9da3113b5f0b8c00a60b1ce1d7e819d7a431d7c90ea0e5f,
+     384),
+]
+
+# MBEDTLS_ECP_WINDOW_SIZE default
+WINDOW_SIZE = 6
+
+
+def add(P, Q, p):
+    """ Affine point addition, None is the point at infinity """
+    if P is None:
+        return Q
+    if Q is None:
+        return P
+    (x1, y1), (x2, y2) = P, Q
+    if x1 == x2:
+        if (y1 + y2) % p == 0:
+            return None
+        l = (3*x1*x1 - 3) * pow(2*y1, p - 2, p) % p
+    else:
+        l = (y2 - y1) * pow(x2 - x1, p - 2, p) % p
+    x3 = (l*l - x1 - x2) % p
+    return (x3, (l*(x1 - x3) - y1) % p)
+
+
+def mul(k, P, p):
+    R = None
+    while k:
+        if k & 1:
+            R = add(R, P, p)
+        P = add(P, P, p)
+        k >>= 1
+    return R
+
+
+def window(bits):
+    """ Window size ecp_mul_comb uses for the generator """
+    w = 5 if bits >= 384 else 4
+    return min(w + 1, WINDOW_SIZE)
+
+
+def limbs(name, value, size):
+    """ Coordinate as little-endian bytes grouped by 8, like ecp_curves.c """
+    data = [(value >> (8*i)) & 0xff for i in range(size)]
+    lines = ['static const mbedtls_mpi_uint %s[] = {' % name]
+    for i in range(0, size, 8):
+        lines.append('    BYTES_TO_T_UINT_8( %s ),'
+                     % ', '.join('0x%02X' % b for b in data[i:i + 8]))
+    lines.append('};')
+    return lines
+
+
+def table(name, p, b, gx, gy, bits):
+    w = window(bits)
+    d = (bits + w - 1) // w
+    size = bits // 8
+    G = (gx, gy)
+    prefix = name.lower()
+
+    out = ['#if defined(MBEDTLS_ECP_DP_%s_ENABLED)' % name,
+           '#define %s_T_W %d' % (name, w)]
+    points = []
+    for i in range(1 << (w - 1)):
+        k = 1
+        for l in range(w - 1):
+            if i & (1 << l):
+                k += 1 << (d*(l + 1))
+        x, y = mul(k, G, p)
+        out += limbs('%s_T_%d_X' % (prefix, i), x, size)
+        out += limbs('%s_T_%d_Y' % (prefix, i), y, size)
+        points.append(i)
+
+    out.append('static const mbedtls_ecp_point %s_T[] = {' % prefix)
+    for i in points:
+        out.append('    ECP_POINT_INIT_XY( %s_T_%d_X, %s_T_%d_Y ),'
+                   % (prefix, i, prefix, i))
+    out.append('};')
+    out.append('#endif /* MBEDTLS_ECP_DP_%s_ENABLED */' % name)
+    out.append('')
+    return out
+
+
+HEADER = '''/*
+ *  Comb tables of the curve generators for ecp_mul_comb
+ *
+ *  Copyright (C) 2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+/* Generated by features/mbedtls/importer/gen-ecp-tables.py, do not edit */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_ECP_C) && defined(MBEDTLS_ECP_FIXED_POINT_TABLES)
+
+#include "mbedtls/ecp.h"
+#include "platform/inc/mbed_ecp_tables.h"
+
+#include <stddef.h>
+
+#if defined(MBEDTLS_HAVE_INT32)
+
+#define BYTES_TO_T_UINT_4( a, b, c, d )             \\
+    ( (mbedtls_mpi_uint) a <<  0 ) |                \\
+    ( (mbedtls_mpi_uint) b <<  8 ) |                \\
+    ( (mbedtls_mpi_uint) c << 16 ) |                \\
+    ( (mbedtls_mpi_uint) d << 24 )
+
+#define BYTES_TO_T_UINT_8( a, b, c, d, e, f, g, h ) \\
+    BYTES_TO_T_UINT_4( a, b, c, d ),                \\
+    BYTES_TO_T_UINT_4( e, f, g, h )
+
+#else /* 64-bits */
+
+#define BYTES_TO_T_UINT_8( a, b, c, d, e, f, g, h ) \\
+    ( (mbedtls_mpi_uint) a <<  0 ) |                \\
+    ( (mbedtls_mpi_uint) b <<  8 ) |                \\
+    ( (mbedtls_mpi_uint) c << 16 ) |                \\
+    ( (mbedtls_mpi_uint) d << 24 ) |                \\
+    ( (mbedtls_mpi_uint) e << 32 ) |                \\
+    ( (mbedtls_mpi_uint) f << 40 ) |                \\
+    ( (mbedtls_mpi_uint) g << 48 ) |                \\
+    ( (mbedtls_mpi_uint) h << 56 )
+
+#endif /* bits in mbedtls_mpi_uint */
+
+/* Affine point on constant coordinates, ecp_mul_comb only reads X and Y */
+#define ECP_MPI_INIT( limbs ) \\
+    { 1, sizeof( limbs ) / sizeof( mbedtls_mpi_uint ), (mbedtls_mpi_uint *) limbs }
+#define ECP_POINT_INIT_XY( x, y ) \\
+    { ECP_MPI_INIT( x ), ECP_MPI_INIT( y ), { 0, 0, NULL } }
+
+/*
+ * Note: the constants are in little-endian order
+ * to be directly usable in MPIs
+ */
+'''
+
+FOOTER_START = '''const mbedtls_ecp_point *mbedtls_ecp_fixed_point_table( mbedtls_ecp_group_id id,
+                                                        unsigned char w )
+{
+    switch( id )
+    {'''
+
+FOOTER_END = '''        default:
+            break;
+    }
+
+    return( NULL );
+}
+
+#endif /* MBEDTLS_ECP_C && MBEDTLS_ECP_FIXED_POINT_TABLES */
+'''
+
+
+def main():
+    out = [HEADER]
+    for curve in CURVES:
+        out += table(*curve)
+    out.append(FOOTER_START)
+    for curve in CURVES:
+        name = curve[0]
+        out += ['#if defined(MBEDTLS_ECP_DP_%s_ENABLED)' % name,
+                '        case MBEDTLS_ECP_DP_%s:' % name,
+                '            if( w == %s_T_W )' % name,
+                '                return( %s_T );' % name.lower(),
+                '            break;',
+                '#endif']
+    out.append(FOOTER_END)
+    sys.stdout.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()
@@ -629,6 +629,49 @@
            "r6", "r7", "r8", "r9", "cc"         \
          );
 
+#elif defined(__ARM_FEATURE_DSP) && ( __ARM_FEATURE_DSP == 1 ) && \
+      defined(__ARM_ARCH) && ( __ARM_ARCH >= 6 )
+
+/*
+ * mbed OS: UMAAL adds both the carry and the destination limb to the
+ * product, on ARMv6 and on ARMv7 with the DSP extension (Cortex-M4/M7)
+ */
+#define MULADDC_INIT                                    \
+    asm(                                                \
+            "ldr    r0, %3                      \n\t"   \
+            "ldr    r1, %4                      \n\t"   \
+            "ldr    r2, %5                      \n\t"   \
+            "ldr    r3, %6                      \n\t"
+
+#define MULADDC_CORE                                    \
+            "ldr    r4, [r0], #4                \n\t"   \
+            "ldr    r6, [r1]                    \n\t"   \
+            "umaal  r6, r2, r4, r3              \n\t"   \
+            "str    r6, [r1], #4                \n\t"
+
+#define MULADDC_CORE_2                                  \
+            "ldmia  r0!, {r4, r5}               \n\t"   \
+            "ldmia  r1, {r6, r7}                \n\t"   \
+            "umaal  r6, r2, r4, r3              \n\t"   \
+            "umaal  r7, r2, r5, r3              \n\t"   \
+            "stmia  r1!, {r6, r7}               \n\t"
+
+#define MULADDC_HUIT                                    \
+            MULADDC_CORE_2                              \
+            MULADDC_CORE_2                              \
+            MULADDC_CORE_2                              \
+            MULADDC_CORE_2
+
+#define MULADDC_STOP                                    \
+            "str    r2, %0                      \n\t"   \
+            "str    r1, %1                      \n\t"   \
+            "str    r0, %2                      \n\t"   \
+         : "=m" (c),  "=m" (d), "=m" (s)        \
+         : "m" (s), "m" (d), "m" (c), "m" (b)   \
+         : "r0", "r1", "r2", "r3", "r4", "r5",  \
+           "r6", "r7", "cc", "memory"           \
+         );
+
 #else
 
 #define MULADDC_INIT                                    \
@@ -42,8 +42,13 @@ extern "C" {
  */
 typedef struct {
     mbedtls_cipher_context_t cipher_ctx;/*!< cipher context used */
+#if defined(MBEDTLS_GCM_GHASH_CT)
+    uint32_t HW[18];            /*!< mbed OS: H split for the constant-time
+                                     multiplication, see gcm.c */
+#else
     uint64_t HL[16];            /*!< Precalculated HTable */
     uint64_t HH[16];            /*!< Precalculated HTable */
+#endif
     uint64_t len;               /*!< Total data length */
     uint64_t add_len;           /*!< Total add length */
     unsigned char base_ectr[16];/*!< First ECTR for tag */
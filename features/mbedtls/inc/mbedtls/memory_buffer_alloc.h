@@ -134,6 +134,32 @@ void mbedtls_memory_buffer_alloc_cur_get( size_t *cur_used, size_t *cur_blocks )
  */
 int mbedtls_memory_buffer_alloc_verify( void );
 
+#if defined(MBEDTLS_MEMORY_ARENA)
+/**
+ * \brief   Initialize an independent heap in a buffer, for mbed_arena.c
+ *
+ * \note    The heap state is kept at the start of the buffer. The
+ *          functions on the heap are not thread-safe and do not change
+ *          the allocator set with mbedtls_platform_set_calloc_free().
+ *
+ * \param buf   buffer to use as heap, aligned on a pointer
+ * \param len   size of the buffer
+ *
+ * \return      0 if successful, -1 if the buffer is too small or misaligned
+ */
+int mbedtls_memory_buffer_arena_init( unsigned char *buf, size_t len );
+
+/**
+ * \brief   Allocate from a heap set up by mbedtls_memory_buffer_arena_init()
+ */
+void *mbedtls_memory_buffer_arena_calloc( unsigned char *buf, size_t n, size_t size );
+
+/**
+ * \brief   Free a block of a heap set up by mbedtls_memory_buffer_arena_init()
+ */
+void mbedtls_memory_buffer_arena_free( unsigned char *buf, void *ptr );
+#endif /* MBEDTLS_MEMORY_ARENA */
+
 #if defined(MBEDTLS_SELF_TEST)
 /**
  * \brief          Checkup routine
@@ -0,0 +1,126 @@
+/*
+ *  Allocation arenas for mbed TLS contexts
+ *
+ *  Copyright (C) 2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#ifndef MBED_ARENA_H
+#define MBED_ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief           Buffer the mbed TLS allocations of one context come from
+ *
+ *                  While a thread has entered an arena, mbedtls_calloc
+ *                  allocates from the arena's buffer with the
+ *                  memory_buffer_alloc allocator. mbedtls_free returns
+ *                  blocks to the arena they come from, whichever thread
+ *                  frees them, and other blocks to the heap. An arena
+ *                  can only be released once all its blocks are freed.
+ *
+ *                  The fields are private.
+ */
+typedef struct mbedtls_arena
+{
+    struct mbedtls_arena *next;
+    unsigned char *buf;
+    size_t len;
+    void *owner;
+    size_t blocks;
+    size_t peak;
+}
+mbedtls_arena;
+
+/**
+ * \brief           Set up an arena in a buffer
+ *
+ *                  The first call installs the arena allocator with
+ *                  mbedtls_platform_set_calloc_free().
+ *
+ * \param arena     Arena to set up
+ * \param buf       Buffer of the arena, aligned on a pointer
+ * \param len       Size of the buffer, which also holds the allocator
+ *                  state and a header for each block
+ *
+ * \return          0 if successful, -1 if the buffer is too small or
+ *                  misaligned
+ */
+int mbedtls_arena_init( mbedtls_arena *arena, void *buf, size_t len );
+
+/**
+ * \brief           Release an arena
+ *
+ *                  No thread may be in the arena. The buffer can be freed
+ *                  once the function returns 0. While blocks of the arena
+ *                  are still allocated, the arena is left as it is, so
+ *                  that they can still be used and freed.
+ *
+ * \param arena     Arena to release
+ *
+ * \return          0 if successful, -1 if blocks are still allocated
+ */
+int mbedtls_arena_free( mbedtls_arena *arena );
+
+/**
+ * \brief           Allocate from an arena in the calling thread
+ *
+ *                  Until mbedtls_arena_leave(), mbedtls_calloc in the
+ *                  calling thread allocates from the arena and fails when
+ *                  the arena is full. An arena is entered by one thread at
+ *                  a time, a thread is in one arena at a time.
+ *
+ * \param arena     Arena to allocate from
+ */
+void mbedtls_arena_enter( mbedtls_arena *arena );
+
+/**
+ * \brief           Go back to allocating from the heap in the calling thread
+ *
+ * \param arena     Arena entered with mbedtls_arena_enter()
+ */
+void mbedtls_arena_leave( mbedtls_arena *arena );
+
+/**
+ * \brief           Get the peak usage of an arena
+ *
+ * \param arena     Arena
+ *
+ * \return          Largest number of bytes of the buffer in use so far,
+ *                  including the allocator state and block headers, which
+ *                  is the smallest buffer the allocations would have fit
+ */
+size_t mbedtls_arena_peak( const mbedtls_arena *arena );
+
+/**
+ * \brief           Get the number of blocks allocated in an arena
+ *
+ * \param arena     Arena
+ *
+ * \return          Number of blocks not freed yet
+ */
+size_t mbedtls_arena_blocks( const mbedtls_arena *arena );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBED_ARENA_H */
@@ -0,0 +1,47 @@
+/*
+ *  Comb tables of the curve generators for ecp_mul_comb
+ *
+ *  Copyright (C) 2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#ifndef MBED_ECP_TABLES_H
+#define MBED_ECP_TABLES_H
+
+#include "mbedtls/ecp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief           Get the comb table of a curve's generator kept in flash
+ *
+ * \param id        Curve of the generator
+ * \param w         Window size of the comb
+ *
+ * \return          Table of 2^(w-1) affine points as ecp_precompute_comb
+ *                  computes them, or NULL if there is no table for the
+ *                  curve and window size
+ */
+const mbedtls_ecp_point *mbedtls_ecp_fixed_point_table( mbedtls_ecp_group_id id,
+                                                        unsigned char w );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBED_ECP_TABLES_H */
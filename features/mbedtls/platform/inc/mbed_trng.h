@@ -0,0 +1,50 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_TRNG_H
+#define MBED_TRNG_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Start filling the entropy pool of mbedtls_hardware_poll
+ *
+ *  With the mbedtls.trng-pool-size option, a low priority thread keeps a
+ *  pool of TRNG output that passed the repetition count and adaptive
+ *  proportion health tests of NIST SP 800-90B. mbedtls_hardware_poll
+ *  takes from the pool and wakes the thread once the pool is below
+ *  mbedtls.trng-pool-threshold, it only reads the TRNG itself when the
+ *  pool runs dry. Bytes that fail a health test are discarded.
+ *
+ *  The pool is started by the first entropy request. Calling this function
+ *  at boot has the pool full by the first handshake.
+ */
+void mbed_trng_pool_start(void);
+
+/** Get the number of bytes in the entropy pool
+ *
+ *  @return Bytes mbedtls_hardware_poll can serve without reading the TRNG
+ */
+size_t mbed_trng_pool_level(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
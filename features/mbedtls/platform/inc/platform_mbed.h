@@ -20,3 +20,54 @@
 #if defined(DEVICE_TRNG)
 #define MBEDTLS_ENTROPY_HARDWARE_ALT
 #endif
+
+/* Targets with their own implementation of whole modules define the
+ * MBEDTLS_*_ALT options in mbedtls_device.h */
+#if defined(MBEDTLS_CONFIG_HW_SUPPORT)
+#include "mbedtls_device.h"
+#endif
+
+/* Block functions on the crypto accelerator HAL, see mbed_crypto_alt.c */
+#if defined(DEVICE_CRYPTO_AES) && !defined(MBEDTLS_AES_ALT)
+#define MBEDTLS_AES_SETKEY_ENC_ALT
+#define MBEDTLS_AES_SETKEY_DEC_ALT
+#define MBEDTLS_AES_ENCRYPT_ALT
+#define MBEDTLS_AES_DECRYPT_ALT
+#endif
+
+/* Constant-time block functions without tables, see mbed_aes_bitsliced.c.
+ * The accelerator takes precedence. */
+#if defined(MBED_CONF_MBEDTLS_AES_BITSLICED) && MBED_CONF_MBEDTLS_AES_BITSLICED && \
+    !defined(DEVICE_CRYPTO_AES) && !defined(MBEDTLS_AES_ALT)
+#define MBEDTLS_AES_BITSLICED
+#define MBEDTLS_AES_SETKEY_ENC_ALT
+#define MBEDTLS_AES_SETKEY_DEC_ALT
+#define MBEDTLS_AES_ENCRYPT_ALT
+#define MBEDTLS_AES_DECRYPT_ALT
+#endif
+
+#if defined(DEVICE_CRYPTO_SHA1) && !defined(MBEDTLS_SHA1_ALT)
+#define MBEDTLS_SHA1_PROCESS_ALT
+#endif
+
+#if defined(DEVICE_CRYPTO_SHA256) && !defined(MBEDTLS_SHA256_ALT)
+#define MBEDTLS_SHA256_PROCESS_ALT
+#endif
+
+#if defined(MBED_CONF_MBEDTLS_SSL_MAX_CONTENT_LEN)
+#define MBEDTLS_SSL_MAX_CONTENT_LEN MBED_CONF_MBEDTLS_SSL_MAX_CONTENT_LEN
+#endif
+
+#if defined(MBED_CONF_MBEDTLS_ECP_FIXED_POINT_TABLES) && MBED_CONF_MBEDTLS_ECP_FIXED_POINT_TABLES
+#define MBEDTLS_ECP_FIXED_POINT_TABLES
+#endif
+
+#if defined(MBED_CONF_MBEDTLS_ARENA) && MBED_CONF_MBEDTLS_ARENA
+#define MBEDTLS_PLATFORM_MEMORY
+#define MBEDTLS_MEMORY_BUFFER_ALLOC_C
+#define MBEDTLS_MEMORY_ARENA
+#endif
+
+#if defined(MBED_CONF_MBEDTLS_GCM_GHASH_CT) && MBED_CONF_MBEDTLS_GCM_GHASH_CT
+#define MBEDTLS_GCM_GHASH_CT
+#endif
@@ -0,0 +1,546 @@
+/*
+ *  Bitsliced AES block functions for mbed TLS
+ *
+ *  Copyright (C) 2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_AES_C) && defined(MBEDTLS_AES_BITSLICED)
+
+#include <string.h>
+#include "mbedtls/aes.h"
+
+/* A block is held in eight words, word i holding bit i of each byte, as in
+ * the constant-time AES of BearSSL. The words have room for two blocks,
+ * mbed TLS passes one at a time so the second is left unused. SubBytes is
+ * then a boolean circuit on the words, ShiftRows and MixColumns are shifts
+ * and rotations of them: no index or branch depends on the data or key, and
+ * no table is needed.
+ *
+ * Round keys stay in the layout of aes.c, so the context can be used by any
+ * code that reads them, and are transposed at each round. */
+
+#define GET_UINT32_LE(n, b, i)                  \
+    (n) = ((uint32_t)(b)[(i)]            )      \
+        | ((uint32_t)(b)[(i) + 1] <<  8)        \
+        | ((uint32_t)(b)[(i) + 2] << 16)        \
+        | ((uint32_t)(b)[(i) + 3] << 24)
+
+#define PUT_UINT32_LE(n, b, i)                  \
+    do {                                        \
+        (b)[(i)    ] = (unsigned char)((n)      ); \
+        (b)[(i) + 1] = (unsigned char)((n) >>  8); \
+        (b)[(i) + 2] = (unsigned char)((n) >> 16); \
+        (b)[(i) + 3] = (unsigned char)((n) >> 24); \
+    } while (0)
+
+#define ROTR16(x) (((x) << 16) | ((x) >> 16))
+
+#define SWAPN(cl, ch, s, x, y)                  \
+    do {                                        \
+        uint32_t a = (x), b = (y);              \
+        (x) = (a & (cl)) | ((b & (cl)) << (s)); \
+        (y) = ((a & (ch)) >> (s)) | (b & (ch)); \
+    } while (0)
+
+#define SWAP2(x, y) SWAPN(0x55555555, 0xAAAAAAAA, 1, x, y)
+#define SWAP4(x, y) SWAPN(0x33333333, 0xCCCCCCCC, 2, x, y)
+#define SWAP8(x, y) SWAPN(0x0F0F0F0F, 0xF0F0F0F0, 4, x, y)
+
+/* Transpose between words of the block and bit planes, its own inverse */
+static void aes_bs_ortho(uint32_t *q)
+{
+    SWAP2(q[0], q[1]);
+    SWAP2(q[2], q[3]);
+    SWAP2(q[4], q[5]);
+    SWAP2(q[6], q[7]);
+
+    SWAP4(q[0], q[2]);
+    SWAP4(q[1], q[3]);
+    SWAP4(q[4], q[6]);
+    SWAP4(q[5], q[7]);
+
+    SWAP8(q[0], q[4]);
+    SWAP8(q[1], q[5]);
+    SWAP8(q[2], q[6]);
+    SWAP8(q[3], q[7]);
+}
+
+static void aes_bs_load(uint32_t *q, const uint32_t w[4])
+{
+    q[0] = w[0];
+    q[2] = w[1];
+    q[4] = w[2];
+    q[6] = w[3];
+    q[1] = q[3] = q[5] = q[7] = 0;
+    aes_bs_ortho(q);
+}
+
+static void aes_bs_store(uint32_t *q, uint32_t w[4])
+{
+    aes_bs_ortho(q);
+    w[0] = q[0];
+    w[1] = q[2];
+    w[2] = q[4];
+    w[3] = q[6];
+}
+
+/* The S-box circuit of Boyar and Peralta: 113 gates in three layers, the
+ * middle one computing the inversion in GF(2^8) */
+static void aes_bs_sbox(uint32_t *q)
+{
+    uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+    uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+    uint32_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+    uint32_t y20, y21;
+    uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+    uint32_t z10, z11, z12, z13, z14, z15, z16, z17;
+    uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+    uint32_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+    uint32_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+    uint32_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+    uint32_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+    uint32_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+    uint32_t t60, t61, t62, t63, t64, t65, t66, t67;
+    uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+    x0 = q[7];
+    x1 = q[6];
+    x2 = q[5];
+    x3 = q[4];
+    x4 = q[3];
+    x5 = q[2];
+    x6 = q[1];
+    x7 = q[0];
+
+    /* Top linear transformation */
+    y14 = x3 ^ x5;
+    y13 = x0 ^ x6;
+    y9 = x0 ^ x3;
+    y8 = x0 ^ x5;
+    t0 = x1 ^ x2;
+    y1 = t0 ^ x7;
+    y4 = y1 ^ x3;
+    y12 = y13 ^ y14;
+    y2 = y1 ^ x0;
+    y5 = y1 ^ x6;
+    y3 = y5 ^ y8;
+    t1 = x4 ^ y12;
+    y15 = t1 ^ x5;
+    y20 = t1 ^ x1;
+    y6 = y15 ^ x7;
+    y10 = y15 ^ t0;
+    y11 = y20 ^ y9;
+    y7 = x7 ^ y11;
+    y17 = y10 ^ y11;
+    y19 = y10 ^ y8;
+    y16 = t0 ^ y11;
+    y21 = y13 ^ y16;
+    y18 = x0 ^ y16;
+
+    /* Non-linear section */
+    t2 = y12 & y15;
+    t3 = y3 & y6;
+    t4 = t3 ^ t2;
+    t5 = y4 & x7;
+    t6 = t5 ^ t2;
+    t7 = y13 & y16;
+    t8 = y5 & y1;
+    t9 = t8 ^ t7;
+    t10 = y2 & y7;
+    t11 = t10 ^ t7;
+    t12 = y9 & y11;
+    t13 = y14 & y17;
+    t14 = t13 ^ t12;
+    t15 = y8 & y10;
+    t16 = t15 ^ t12;
+    t17 = t4 ^ t14;
+    t18 = t6 ^ t16;
+    t19 = t9 ^ t14;
+    t20 = t11 ^ t16;
+    t21 = t17 ^ y20;
+    t22 = t18 ^ y19;
+    t23 = t19 ^ y21;
+    t24 = t20 ^ y18;
+
+    t25 = t21 ^ t22;
+    t26 = t21 & t23;
+    t27 = t24 ^ t26;
+    t28 = t25 & t27;
+    t29 = t28 ^ t22;
+    t30 = t23 ^ t24;
+    t31 = t22 ^ t26;
+    t32 = t31 & t30;
+    t33 = t32 ^ t24;
+    t34 = t23 ^ t33;
+    t35 = t27 ^ t33;
+    t36 = t24 & t35;
+    t37 = t36 ^ t34;
+    t38 = t27 ^ t36;
+    t39 = t29 & t38;
+    t40 = t25 ^ t39;
+
+    t41 = t40 ^ t37;
+    t42 = t29 ^ t33;
+    t43 = t29 ^ t40;
+    t44 = t33 ^ t37;
+    t45 = t42 ^ t41;
+    z0 = t44 & y15;
+    z1 = t37 & y6;
+    z2 = t33 & x7;
+    z3 = t43 & y16;
+    z4 = t40 & y1;
+    z5 = t29 & y7;
+    z6 = t42 & y11;
+    z7 = t45 & y17;
+    z8 = t41 & y10;
+    z9 = t44 & y12;
+    z10 = t37 & y3;
+    z11 = t33 & y4;
+    z12 = t43 & y13;
+    z13 = t40 & y5;
+    z14 = t29 & y2;
+    z15 = t42 & y9;
+    z16 = t45 & y14;
+    z17 = t41 & y8;
+
+    /* Bottom linear transformation */
+    t46 = z15 ^ z16;
+    t47 = z10 ^ z11;
+    t48 = z5 ^ z13;
+    t49 = z9 ^ z10;
+    t50 = z2 ^ z12;
+    t51 = z2 ^ z5;
+    t52 = z7 ^ z8;
+    t53 = z0 ^ z3;
+    t54 = z6 ^ z7;
+    t55 = z16 ^ z17;
+    t56 = z12 ^ t48;
+    t57 = t50 ^ t53;
+    t58 = z4 ^ t46;
+    t59 = z3 ^ t54;
+    t60 = t46 ^ t57;
+    t61 = z14 ^ t57;
+    t62 = t52 ^ t58;
+    t63 = t49 ^ t58;
+    t64 = z4 ^ t59;
+    t65 = t61 ^ t62;
+    t66 = z1 ^ t63;
+    s0 = t59 ^ t63;
+    s6 = t56 ^ ~t62;
+    s7 = t48 ^ ~t60;
+    t67 = t64 ^ t65;
+    s3 = t53 ^ t66;
+    s4 = t51 ^ t66;
+    s5 = t47 ^ t65;
+    s1 = t64 ^ ~s3;
+    s2 = t55 ^ ~t67;
+
+    q[7] = s0;
+    q[6] = s1;
+    q[5] = s2;
+    q[4] = s3;
+    q[3] = s4;
+    q[2] = s5;
+    q[1] = s6;
+    q[0] = s7;
+}
+
+/* B(x ^ 0x63), B being the inverse of the affine map of the S-box */
+static void aes_bs_inv_affine(uint32_t *q)
+{
+    uint32_t q0, q1, q2, q3, q4, q5, q6, q7;
+
+    q0 = ~q[0];
+    q1 = ~q[1];
+    q2 = q[2];
+    q3 = q[3];
+    q4 = q[4];
+    q5 = ~q[5];
+    q6 = ~q[6];
+    q7 = q[7];
+
+    q[7] = q1 ^ q4 ^ q6;
+    q[6] = q0 ^ q3 ^ q5;
+    q[5] = q7 ^ q2 ^ q4;
+    q[4] = q6 ^ q1 ^ q3;
+    q[3] = q5 ^ q0 ^ q2;
+    q[2] = q4 ^ q7 ^ q1;
+    q[1] = q3 ^ q6 ^ q0;
+    q[0] = q2 ^ q5 ^ q7;
+}
+
+/* The S-box is S(x) = A(I(x)) ^ 0x63 with I the inversion, an involution,
+ * so its inverse is B(S(B(x ^ 0x63)) ^ 0x63) */
+static void aes_bs_inv_sbox(uint32_t *q)
+{
+    aes_bs_inv_affine(q);
+    aes_bs_sbox(q);
+    aes_bs_inv_affine(q);
+}
+
+static void aes_bs_shift_rows(uint32_t *q)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        uint32_t x = q[i];
+
+        q[i] = (x & 0x000000FF)
+             | ((x & 0x0000FC00) >> 2) | ((x & 0x00000300) << 6)
+             | ((x & 0x00F00000) >> 4) | ((x & 0x000F0000) << 4)
+             | ((x & 0xC0000000) >> 6) | ((x & 0x3F000000) << 2);
+    }
+}
+
+static void aes_bs_inv_shift_rows(uint32_t *q)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        uint32_t x = q[i];
+
+        q[i] = (x & 0x000000FF)
+             | ((x & 0x00003F00) << 2) | ((x & 0x0000C000) >> 6)
+             | ((x & 0x000F0000) << 4) | ((x & 0x00F00000) >> 4)
+             | ((x & 0x03000000) << 6) | ((x & 0xFC000000) >> 2);
+    }
+}
+
+/* Rotating a word by 8 bits moves each byte to the next row of its column */
+static void aes_bs_mix_columns(uint32_t *q)
+{
+    uint32_t q0, q1, q2, q3, q4, q5, q6, q7;
+    uint32_t r0, r1, r2, r3, r4, r5, r6, r7;
+
+    q0 = q[0];
+    q1 = q[1];
+    q2 = q[2];
+    q3 = q[3];
+    q4 = q[4];
+    q5 = q[5];
+    q6 = q[6];
+    q7 = q[7];
+    r0 = (q0 >> 8) | (q0 << 24);
+    r1 = (q1 >> 8) | (q1 << 24);
+    r2 = (q2 >> 8) | (q2 << 24);
+    r3 = (q3 >> 8) | (q3 << 24);
+    r4 = (q4 >> 8) | (q4 << 24);
+    r5 = (q5 >> 8) | (q5 << 24);
+    r6 = (q6 >> 8) | (q6 << 24);
+    r7 = (q7 >> 8) | (q7 << 24);
+
+    q[0] = q7 ^ r7 ^ r0 ^ ROTR16(q0 ^ r0);
+    q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ ROTR16(q1 ^ r1);
+    q[2] = q1 ^ r1 ^ r2 ^ ROTR16(q2 ^ r2);
+    q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ ROTR16(q3 ^ r3);
+    q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ ROTR16(q4 ^ r4);
+    q[5] = q4 ^ r4 ^ r5 ^ ROTR16(q5 ^ r5);
+    q[6] = q5 ^ r5 ^ r6 ^ ROTR16(q6 ^ r6);
+    q[7] = q6 ^ r6 ^ r7 ^ ROTR16(q7 ^ r7);
+}
+
+/* Multiply each byte by x */
+static void aes_bs_xtime(const uint32_t *a, uint32_t *b)
+{
+    b[0] = a[7];
+    b[1] = a[0] ^ a[7];
+    b[2] = a[1];
+    b[3] = a[2] ^ a[7];
+    b[4] = a[3] ^ a[7];
+    b[5] = a[4];
+    b[6] = a[5];
+    b[7] = a[6];
+}
+
+/* InvMixColumns multiplies the columns by 0b.x^3 + 0d.x^2 + 09.x + 0e, that
+ * is by 04.x^2 + 05 then by the polynomial of MixColumns. The first product
+ * gives 05.a(i) + 04.a(i+2) = a(i) + 04.(a(i) + a(i+2)) in each row i. */
+static void aes_bs_inv_mix_columns(uint32_t *q)
+{
+    uint32_t u[8], v[8];
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        u[i] = q[i] ^ ROTR16(q[i]);
+    }
+    aes_bs_xtime(u, v);
+    aes_bs_xtime(v, u);
+    for (i = 0; i < 8; i++) {
+        q[i] ^= u[i];
+    }
+
+    aes_bs_mix_columns(q);
+}
+
+static void aes_bs_add_round_key(uint32_t *q, const uint32_t *rk)
+{
+    uint32_t k[8];
+    int i;
+
+    aes_bs_load(k, rk);
+    for (i = 0; i < 8; i++) {
+        q[i] ^= k[i];
+    }
+}
+
+static uint32_t aes_bs_sub_word(uint32_t x)
+{
+    uint32_t q[8];
+
+    memset(q, 0, sizeof(q));
+    q[0] = x;
+    aes_bs_ortho(q);
+    aes_bs_sbox(q);
+    aes_bs_ortho(q);
+    return q[0];
+}
+
+/* The key expansion of FIPS-197 5.2, on little-endian words as in aes.c */
+int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key,
+                           unsigned int keybits)
+{
+    unsigned int i, nk;
+    uint32_t rcon = 0x01;
+    uint32_t *rk;
+
+    switch (keybits) {
+        case 128: ctx->nr = 10; break;
+        case 192: ctx->nr = 12; break;
+        case 256: ctx->nr = 14; break;
+        default: return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+    }
+
+    ctx->rk = rk = ctx->buf;
+    nk = keybits / 32;
+
+    for (i = 0; i < nk; i++) {
+        GET_UINT32_LE(rk[i], key, 4 * i);
+    }
+
+    for (i = nk; i < 4 * (unsigned int)(ctx->nr + 1); i++) {
+        uint32_t t = rk[i - 1];
+
+        if (i % nk == 0) {
+            t = aes_bs_sub_word((t >> 8) | (t << 24)) ^ rcon;
+            rcon = (rcon << 1) ^ ((rcon & 0x80) ? 0x11B : 0);
+        } else if (nk > 6 && i % nk == 4) {
+            t = aes_bs_sub_word(t);
+        }
+
+        rk[i] = rk[i - nk] ^ t;
+    }
+
+    return 0;
+}
+
+/* Round keys of the equivalent inverse cipher of FIPS-197 5.3.5, which
+ * aes.c uses too: the encryption keys in reverse order, those of the inner
+ * rounds through InvMixColumns */
+int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx, const unsigned char *key,
+                           unsigned int keybits)
+{
+    mbedtls_aes_context cty;
+    uint32_t q[8];
+    int i, ret;
+
+    mbedtls_aes_init(&cty);
+
+    ret = mbedtls_aes_setkey_enc(&cty, key, keybits);
+    if (ret == 0) {
+        ctx->nr = cty.nr;
+        ctx->rk = ctx->buf;
+
+        memcpy(ctx->rk, cty.rk + 4 * cty.nr, 16);
+        for (i = 1; i < cty.nr; i++) {
+            aes_bs_load(q, cty.rk + 4 * (cty.nr - i));
+            aes_bs_inv_mix_columns(q);
+            aes_bs_store(q, ctx->rk + 4 * i);
+        }
+        memcpy(ctx->rk + 4 * cty.nr, cty.rk, 16);
+    }
+
+    mbedtls_aes_free(&cty);
+    memset(q, 0, sizeof(q));
+
+    return ret;
+}
+
+void mbedtls_aes_encrypt(mbedtls_aes_context *ctx, const unsigned char input[16],
+                         unsigned char output[16])
+{
+    const uint32_t *rk = ctx->rk;
+    uint32_t w[4], q[8];
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        GET_UINT32_LE(w[i], input, 4 * i);
+    }
+
+    aes_bs_load(q, w);
+    aes_bs_add_round_key(q, rk);
+    for (i = 1; i < ctx->nr; i++) {
+        aes_bs_sbox(q);
+        aes_bs_shift_rows(q);
+        aes_bs_mix_columns(q);
+        aes_bs_add_round_key(q, rk + 4 * i);
+    }
+    aes_bs_sbox(q);
+    aes_bs_shift_rows(q);
+    aes_bs_add_round_key(q, rk + 4 * ctx->nr);
+    aes_bs_store(q, w);
+
+    for (i = 0; i < 4; i++) {
+        PUT_UINT32_LE(w[i], output, 4 * i);
+    }
+}
+
+void mbedtls_aes_decrypt(mbedtls_aes_context *ctx, const unsigned char input[16],
+                         unsigned char output[16])
+{
+    const uint32_t *rk = ctx->rk;
+    uint32_t w[4], q[8];
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        GET_UINT32_LE(w[i], input, 4 * i);
+    }
+
+    aes_bs_load(q, w);
+    aes_bs_add_round_key(q, rk);
+    for (i = 1; i < ctx->nr; i++) {
+        aes_bs_inv_sbox(q);
+        aes_bs_inv_shift_rows(q);
+        aes_bs_inv_mix_columns(q);
+        aes_bs_add_round_key(q, rk + 4 * i);
+    }
+    aes_bs_inv_sbox(q);
+    aes_bs_inv_shift_rows(q);
+    aes_bs_add_round_key(q, rk + 4 * ctx->nr);
+    aes_bs_store(q, w);
+
+    for (i = 0; i < 4; i++) {
+        PUT_UINT32_LE(w[i], output, 4 * i);
+    }
+}
+
+#endif
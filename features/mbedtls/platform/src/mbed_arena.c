@@ -0,0 +1,195 @@
+/*
+ *  Allocation arenas for mbed TLS contexts
+ *
+ *  Copyright (C) 2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_MEMORY_ARENA)
+
+#include "mbedtls/memory_buffer_alloc.h"
+#include "mbedtls/platform.h"
+#include "platform/inc/mbed_arena.h"
+
+#include <stdlib.h>
+#include "critical.h"
+#include "cmsis_os.h"
+
+/* Arenas in use, the lock also serializes the memory_buffer_alloc calls,
+ * which swap the state of the arena in */
+static mbedtls_arena *arena_list;
+
+static osMutexId arena_mutex_id;
+osMutexDef(arena_mutex);
+
+/* 0 before the first arena, 1 while it sets up the lock, 2 afterwards */
+static uint32_t arena_ready;
+
+static void arena_lock(void)
+{
+    osMutexWait(arena_mutex_id, osWaitForever);
+}
+
+static void arena_unlock(void)
+{
+    osMutexRelease(arena_mutex_id);
+}
+
+static void *arena_calloc(size_t n, size_t size)
+{
+    void *owner = osThreadGetId();
+    mbedtls_arena *arena;
+    void *ptr;
+
+    arena_lock();
+    for (arena = arena_list; arena; arena = arena->next) {
+        if (arena->owner == owner) {
+            break;
+        }
+    }
+
+    if (!arena) {
+        arena_unlock();
+        return calloc(n, size);
+    }
+
+    ptr = mbedtls_memory_buffer_arena_calloc(arena->buf, n, size);
+    if (ptr) {
+        size_t used = (unsigned char *)ptr + n * size - arena->buf;
+        if (used > arena->peak) {
+            arena->peak = used;
+        }
+        arena->blocks++;
+    }
+
+    arena_unlock();
+    return ptr;
+}
+
+static void arena_free(void *ptr)
+{
+    mbedtls_arena *arena;
+
+    if (!ptr) {
+        return;
+    }
+
+    arena_lock();
+    for (arena = arena_list; arena; arena = arena->next) {
+        if ((unsigned char *)ptr >= arena->buf &&
+            (unsigned char *)ptr < arena->buf + arena->len) {
+            break;
+        }
+    }
+
+    if (arena) {
+        mbedtls_memory_buffer_arena_free(arena->buf, ptr);
+        arena->blocks--;
+    }
+
+    arena_unlock();
+
+    if (!arena) {
+        free(ptr);
+    }
+}
+
+int mbedtls_arena_init(mbedtls_arena *arena, void *buf, size_t len)
+{
+    uint32_t expected = 0;
+
+    if (core_util_atomic_cas_u32(&arena_ready, &expected, 1)) {
+        arena_mutex_id = osMutexCreate(osMutex(arena_mutex));
+        mbedtls_platform_set_calloc_free(arena_calloc, arena_free);
+        arena_ready = 2;
+    }
+
+    while (arena_ready != 2) {
+        osDelay(1);
+    }
+
+    if (mbedtls_memory_buffer_arena_init(buf, len) != 0) {
+        return -1;
+    }
+
+    arena->buf = buf;
+    arena->len = len;
+    arena->owner = NULL;
+    arena->blocks = 0;
+    arena->peak = 0;
+
+    arena_lock();
+    arena->next = arena_list;
+    arena_list = arena;
+    arena_unlock();
+    return 0;
+}
+
+int mbedtls_arena_free(mbedtls_arena *arena)
+{
+    mbedtls_arena **p;
+
+    arena_lock();
+    if (arena->blocks != 0) {
+        /* the buffer still holds blocks that will be freed into it */
+        arena_unlock();
+        return -1;
+    }
+
+    for (p = &arena_list; *p; p = &(*p)->next) {
+        if (*p == arena) {
+            *p = arena->next;
+            break;
+        }
+    }
+    arena_unlock();
+
+    arena->buf = NULL;
+    arena->len = 0;
+    return 0;
+}
+
+void mbedtls_arena_enter(mbedtls_arena *arena)
+{
+    arena_lock();
+    arena->owner = osThreadGetId();
+    arena_unlock();
+}
+
+void mbedtls_arena_leave(mbedtls_arena *arena)
+{
+    arena_lock();
+    arena->owner = NULL;
+    arena_unlock();
+}
+
+size_t mbedtls_arena_peak(const mbedtls_arena *arena)
+{
+    return arena->peak;
+}
+
+size_t mbedtls_arena_blocks(const mbedtls_arena *arena)
+{
+    return arena->blocks;
+}
+
+#endif
@@ -0,0 +1,160 @@
+/*
+ *  mbed TLS block functions on the crypto accelerator
+ *
+ *  Copyright (C) 2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#include "hal/crypto_api.h"
+
+#if DEVICE_CRYPTO_AES || DEVICE_CRYPTO_SHA1 || DEVICE_CRYPTO_SHA256
+
+#include <string.h>
+#include "critical.h"
+#include "cmsis_os.h"
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+/* The engine is shared by all threads. It is held for a single block at a
+ * time, the state of an operation stays in its mbed TLS context between
+ * blocks. Waiting threads sleep, which lets a lower priority holder finish
+ * its block. */
+static uint32_t crypto_engine_busy;
+
+static void crypto_engine_lock(void)
+{
+    uint32_t expected = 0;
+
+    while (!core_util_atomic_cas_u32(&crypto_engine_busy, &expected, 1)) {
+        expected = 0;
+        osDelay(1);
+    }
+}
+
+static void crypto_engine_unlock(void)
+{
+    crypto_engine_busy = 0;
+}
+
+#if defined(MBEDTLS_AES_C) && DEVICE_CRYPTO_AES && \
+    defined(MBEDTLS_AES_SETKEY_ENC_ALT) && defined(MBEDTLS_AES_SETKEY_DEC_ALT) && \
+    defined(MBEDTLS_AES_ENCRYPT_ALT) && defined(MBEDTLS_AES_DECRYPT_ALT)
+
+#include "mbedtls/aes.h"
+
+/* The context keeps the prepared key in buf and the number of rounds in nr,
+ * mbed TLS only uses them through the functions below */
+static int crypto_aes_setkey_alt(mbedtls_aes_context *ctx, const unsigned char *key,
+                                 unsigned int keybits, int decrypt)
+{
+    int ret;
+
+    switch (keybits) {
+        case 128: ctx->nr = 10; break;
+        case 192: ctx->nr = 12; break;
+        case 256: ctx->nr = 14; break;
+        default: return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
+    }
+
+    /* buf has room for 68 words, CRYPTO_AES_KEY_WORDS fit */
+    ctx->rk = ctx->buf;
+
+    crypto_engine_lock();
+    ret = crypto_aes_setkey(ctx->rk, key, keybits, decrypt);
+    crypto_engine_unlock();
+
+    return ret ? MBEDTLS_ERR_AES_INVALID_KEY_LENGTH : 0;
+}
+
+static void crypto_aes_crypt_alt(mbedtls_aes_context *ctx, const unsigned char input[16],
+                                 unsigned char output[16], int decrypt)
+{
+    uint32_t block[4];
+
+    memcpy(block, input, sizeof(block));
+
+    crypto_engine_lock();
+    crypto_aes_crypt(ctx->rk, 32 * (ctx->nr - 6), decrypt, block);
+    crypto_engine_unlock();
+
+    memcpy(output, block, sizeof(block));
+}
+
+int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key,
+                           unsigned int keybits)
+{
+    return crypto_aes_setkey_alt(ctx, key, keybits, 0);
+}
+
+int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx, const unsigned char *key,
+                           unsigned int keybits)
+{
+    return crypto_aes_setkey_alt(ctx, key, keybits, 1);
+}
+
+void mbedtls_aes_encrypt(mbedtls_aes_context *ctx, const unsigned char input[16],
+                         unsigned char output[16])
+{
+    crypto_aes_crypt_alt(ctx, input, output, 0);
+}
+
+void mbedtls_aes_decrypt(mbedtls_aes_context *ctx, const unsigned char input[16],
+                         unsigned char output[16])
+{
+    crypto_aes_crypt_alt(ctx, input, output, 1);
+}
+
+#endif
+
+#if defined(MBEDTLS_SHA1_C) && DEVICE_CRYPTO_SHA1 && defined(MBEDTLS_SHA1_PROCESS_ALT)
+
+#include "mbedtls/sha1.h"
+
+void mbedtls_sha1_process(mbedtls_sha1_context *ctx, const unsigned char data[64])
+{
+    uint32_t block[16];
+
+    memcpy(block, data, sizeof(block));
+
+    crypto_engine_lock();
+    crypto_sha1_process(ctx->state, block);
+    crypto_engine_unlock();
+}
+
+#endif
+
+#if defined(MBEDTLS_SHA256_C) && DEVICE_CRYPTO_SHA256 && defined(MBEDTLS_SHA256_PROCESS_ALT)
+
+#include "mbedtls/sha256.h"
+
+void mbedtls_sha256_process(mbedtls_sha256_context *ctx, const unsigned char data[64])
+{
+    uint32_t block[16];
+
+    memcpy(block, data, sizeof(block));
+
+    crypto_engine_lock();
+    crypto_sha256_process(ctx->state, block);
+    crypto_engine_unlock();
+}
+
+#endif
+
+#endif
@@ -18,6 +18,191 @@
 
 #include "hal/trng_api.h"
 
+#if defined(MBED_CONF_MBEDTLS_TRNG_POOL_SIZE) && defined(MBED_CONF_RTOS_PRESENT)
+
+#include <string.h>
+#include "critical.h"
+#include "cmsis_os.h"
+#include "platform/inc/mbed_trng.h"
+
+#define TRNG_POOL_SIZE          MBED_CONF_MBEDTLS_TRNG_POOL_SIZE
+
+#if defined(MBED_CONF_MBEDTLS_TRNG_POOL_THRESHOLD)
+#define TRNG_POOL_THRESHOLD     MBED_CONF_MBEDTLS_TRNG_POOL_THRESHOLD
+#else
+#define TRNG_POOL_THRESHOLD     (TRNG_POOL_SIZE / 2)
+#endif
+
+// Bytes the pool thread reads at a time, on its stack
+#define TRNG_POOL_CHUNK         32
+#define TRNG_POOL_STACK_SIZE    512
+#define TRNG_POOL_RETRY_MS      100
+#define TRNG_POOL_SIGNAL        0x1
+
+/* Health tests of NIST SP 800-90B 4.4, for at least 2 bits of
+ * min-entropy per byte and a false alarm probability of 2^-20.
+ * The repetition count cutoff is 1 + 20 / 2 equal bytes in a row, the
+ * adaptive proportion cutoff the 1 - 2^-20 quantile of the binomial
+ * distribution of 512 bytes with a probability of 1/4, plus 1. */
+#define TRNG_RCT_CUTOFF         11
+#define TRNG_APT_WINDOW         512
+#define TRNG_APT_CUTOFF         177
+
+// The device and the health tests, taken while reading the TRNG
+static trng_t trng_obj;
+static osMutexId trng_mutex_id;
+osMutexDef(trng_mutex);
+
+static unsigned rct_count;
+static unsigned char rct_byte;
+static unsigned apt_count;
+static unsigned apt_index;
+static unsigned char apt_byte;
+
+// Tested bytes not handed out yet, taken from the end
+static unsigned char pool[TRNG_POOL_SIZE];
+static size_t pool_len;
+static osMutexId pool_mutex_id;
+osMutexDef(trng_pool_mutex);
+
+static void trng_pool_thread(void const *arg);
+static osThreadDef(trng_pool_thread, osPriorityLow, /*1,*/ TRNG_POOL_STACK_SIZE);
+static osThreadId pool_thread_id;
+
+// 0 before the first use, 1 while the pool is set up, 2 afterwards
+static uint32_t pool_state;
+
+static int trng_health_test(const unsigned char *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (rct_count > 0 && buf[i] == rct_byte) {
+            rct_count++;
+        } else {
+            rct_byte = buf[i];
+            rct_count = 1;
+        }
+
+        if (apt_index == 0) {
+            apt_byte = buf[i];
+            apt_count = 1;
+        } else if (buf[i] == apt_byte) {
+            apt_count++;
+        }
+
+        if (++apt_index == TRNG_APT_WINDOW) {
+            apt_index = 0;
+        }
+
+        if (rct_count >= TRNG_RCT_CUTOFF || apt_count >= TRNG_APT_CUTOFF) {
+            // start over, without trusting the bytes before the failure
+            rct_count = 0;
+            apt_index = 0;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Fills buf with len tested bytes, the whole buffer is discarded on failure
+static int trng_read(unsigned char *buf, size_t len)
+{
+    int ret = 0;
+
+    osMutexWait(trng_mutex_id, osWaitForever);
+    while (len > 0) {
+        size_t olen = 0;
+        if (trng_get_bytes(&trng_obj, buf, len, &olen) != 0 || olen == 0 ||
+            trng_health_test(buf, olen) != 0) {
+            ret = -1;
+            break;
+        }
+        buf += olen;
+        len -= olen;
+    }
+    osMutexRelease(trng_mutex_id);
+
+    return ret;
+}
+
+static void trng_pool_thread(void const *arg)
+{
+    unsigned char chunk[TRNG_POOL_CHUNK];
+
+    for (;;) {
+        osMutexWait(pool_mutex_id, osWaitForever);
+        size_t len = TRNG_POOL_SIZE - pool_len;
+        osMutexRelease(pool_mutex_id);
+
+        if (len == 0) {
+            osSignalWait(TRNG_POOL_SIGNAL, osWaitForever);
+            continue;
+        }
+
+        if (len > sizeof(chunk)) {
+            len = sizeof(chunk);
+        }
+
+        if (trng_read(chunk, len) != 0) {
+            osDelay(TRNG_POOL_RETRY_MS);
+            continue;
+        }
+
+        // only this thread adds to the pool
+        osMutexWait(pool_mutex_id, osWaitForever);
+        memcpy(pool + pool_len, chunk, len);
+        pool_len += len;
+        osMutexRelease(pool_mutex_id);
+        memset(chunk, 0, len);
+    }
+}
+
+void mbed_trng_pool_start(void)
+{
+    uint32_t expected = 0;
+
+    if (core_util_atomic_cas_u32(&pool_state, &expected, 1)) {
+        trng_init(&trng_obj);
+        trng_mutex_id = osMutexCreate(osMutex(trng_mutex));
+        pool_mutex_id = osMutexCreate(osMutex(trng_pool_mutex));
+        pool_thread_id = osThreadCreate(osThread(trng_pool_thread), NULL);
+        pool_state = 2;
+    }
+
+    while (pool_state != 2) {
+        osDelay(1);
+    }
+}
+
+size_t mbed_trng_pool_level(void)
+{
+    return pool_len;
+}
+
+int mbedtls_hardware_poll( void *data, unsigned char *output, size_t len, size_t *olen ) {
+    mbed_trng_pool_start();
+
+    osMutexWait(pool_mutex_id, osWaitForever);
+    size_t n = len < pool_len ? len : pool_len;
+    pool_len -= n;
+    memcpy(output, pool + pool_len, n);
+    memset(pool + pool_len, 0, n);
+    if (pool_len < TRNG_POOL_THRESHOLD) {
+        osSignalSet(pool_thread_id, TRNG_POOL_SIGNAL);
+    }
+    osMutexRelease(pool_mutex_id);
+
+    // read the rest directly if the pool ran dry
+    if (n < len && trng_read(output + n, len - n) == 0) {
+        n = len;
+    }
+
+    *olen = n;
+    return n > 0 ? 0 : -1;
+}
+
+#else
+
 int mbedtls_hardware_poll( void *data, unsigned char *output, size_t len, size_t *olen ) {
     trng_t trng_obj;
     trng_init(&trng_obj);
@@ -27,3 +212,5 @@ int mbedtls_hardware_poll( void *data, unsigned char *output, size_t len, size_t
 }
 
 #endif
+
+#endif
@@ -50,6 +50,10 @@
 
 #include "mbedtls/ecp.h"
 
+#if defined(MBEDTLS_ECP_FIXED_POINT_TABLES)
+#include "platform/inc/mbed_ecp_tables.h"
+#endif
+
 #include <string.h>
 
 #if defined(MBEDTLS_PLATFORM_C)
@@ -1365,6 +1369,13 @@ static int ecp_mul_comb( mbedtls_ecp_group *grp, mbedtls_ecp_point *R,
      */
     T = p_eq_g ? grp->T : NULL;
 
+#if defined(MBEDTLS_ECP_FIXED_POINT_TABLES)
+    /* mbed OS: tables of the generators are kept in flash, see
+     * platform/src/mbed_ecp_tables.c. They are only read. */
+    if( T == NULL && p_eq_g )
+        T = (mbedtls_ecp_point *) mbedtls_ecp_fixed_point_table( grp->id, w );
+#endif
+
     if( T == NULL )
     {
         T = mbedtls_calloc( pre_len, sizeof( mbedtls_ecp_point ) );
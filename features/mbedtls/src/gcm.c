@@ -90,6 +90,107 @@ void mbedtls_gcm_init( mbedtls_gcm_context *ctx )
     memset( ctx, 0, sizeof( mbedtls_gcm_context ) );
 }
 
+#if defined(MBEDTLS_GCM_GHASH_CT)
+/*
+ * mbed OS: constant-time multiplication in GF(2^128), for cores where the
+ * 4-bit tables below would be indexed by secret data through a cache, and
+ * to keep 72 bytes of H in the context instead of 256 bytes of tables.
+ *
+ * Elements are polynomials in four 32-bit words, the word of index i
+ * holding the coefficients of x^(32i) to x^(32i+31) from bit 0 up: the
+ * big-endian words of [MGV] with their bits reversed. The 256-bit product
+ * is made by Karatsuba from nine 32-bit carry-less products, of which
+ * gcm_bmul32() gives the low half with integer multiplications of the
+ * operands split into bits spaced by holes that absorb the carries. The
+ * high half is the low half of the product of the reversed operands,
+ * reversed again. This is constant-time where 32x32->32 multiplications
+ * are, which includes all Cortex-M cores.
+ */
+static uint32_t gcm_rev32( uint32_t x )
+{
+#if defined(__GNUC__) && defined(__arm__) && defined(__ARM_ARCH) && \
+    ( __ARM_ARCH >= 7 ) && !defined(__ARM_ARCH_8M_BASE__)
+    __asm__( "rbit %0, %1" : "=r" (x) : "r" (x) );
+    return( x );
+#else
+    x = ( ( x & 0x55555555 ) << 1 ) | ( ( x >> 1 ) & 0x55555555 );
+    x = ( ( x & 0x33333333 ) << 2 ) | ( ( x >> 2 ) & 0x33333333 );
+    x = ( ( x & 0x0F0F0F0F ) << 4 ) | ( ( x >> 4 ) & 0x0F0F0F0F );
+    x = ( ( x & 0x00FF00FF ) << 8 ) | ( ( x >> 8 ) & 0x00FF00FF );
+    return( ( x << 16 ) | ( x >> 16 ) );
+#endif
+}
+
+static uint32_t gcm_bmul32( uint32_t x, uint32_t y )
+{
+    uint32_t x0, x1, x2, x3, y0, y1, y2, y3, z0, z1, z2, z3;
+
+    x0 = x & 0x11111111;
+    x1 = x & 0x22222222;
+    x2 = x & 0x44444444;
+    x3 = x & 0x88888888;
+    y0 = y & 0x11111111;
+    y1 = y & 0x22222222;
+    y2 = y & 0x44444444;
+    y3 = y & 0x88888888;
+
+    z0 = ( x0 * y0 ) ^ ( x1 * y3 ) ^ ( x2 * y2 ) ^ ( x3 * y1 );
+    z1 = ( x0 * y1 ) ^ ( x1 * y0 ) ^ ( x2 * y3 ) ^ ( x3 * y2 );
+    z2 = ( x0 * y2 ) ^ ( x1 * y1 ) ^ ( x2 * y0 ) ^ ( x3 * y3 );
+    z3 = ( x0 * y3 ) ^ ( x1 * y2 ) ^ ( x2 * y1 ) ^ ( x3 * y0 );
+
+    return( ( z0 & 0x11111111 ) | ( z1 & 0x22222222 ) |
+            ( z2 & 0x44444444 ) | ( z3 & 0x88888888 ) );
+}
+
+/*
+ * Split the big-endian words w of an element into the three operands of
+ * each 64-bit Karatsuba product: r gets (w0, w1, w0^w1), (w2, w3, w2^w3)
+ * and (w0^w2, w1^w3, w0^w1^w2^w3), n the same words reversed.
+ */
+static void gcm_ct_split( const uint32_t w[4], uint32_t r[9], uint32_t n[9] )
+{
+    int i;
+
+    r[0] = w[0];
+    r[1] = w[1];
+    r[2] = w[0] ^ w[1];
+    r[3] = w[2];
+    r[4] = w[3];
+    r[5] = w[2] ^ w[3];
+    r[6] = w[0] ^ w[2];
+    r[7] = w[1] ^ w[3];
+    r[8] = r[6] ^ r[7];
+
+    for( i = 0; i < 9; i++ )
+        n[i] = gcm_rev32( r[i] );
+}
+
+/*
+ * Keep H as split by gcm_ct_split(), polynomial words in HW[0..8] and
+ * reversed ones in HW[9..17]
+ */
+static int gcm_gen_table( mbedtls_gcm_context *ctx )
+{
+    int ret;
+    uint32_t w[4];
+    unsigned char h[16];
+    size_t olen = 0;
+
+    memset( h, 0, 16 );
+    if( ( ret = mbedtls_cipher_update( &ctx->cipher_ctx, h, 16, h, &olen ) ) != 0 )
+        return( ret );
+
+    GET_UINT32_BE( w[0], h,  0 );
+    GET_UINT32_BE( w[1], h,  4 );
+    GET_UINT32_BE( w[2], h,  8 );
+    GET_UINT32_BE( w[3], h, 12 );
+
+    gcm_ct_split( w, ctx->HW + 9, ctx->HW );
+
+    return( 0 );
+}
+#else /* MBEDTLS_GCM_GHASH_CT */
 /*
  * Precompute small multiples of H, that is set
  *      HH[i] || HL[i] = H times i,
@@ -157,6 +258,7 @@ static int gcm_gen_table( mbedtls_gcm_context *ctx )
 
     return( 0 );
 }
+#endif /* MBEDTLS_GCM_GHASH_CT */
 
 int mbedtls_gcm_setkey( mbedtls_gcm_context *ctx,
                         mbedtls_cipher_id_t cipher,
@@ -190,6 +292,94 @@ int mbedtls_gcm_setkey( mbedtls_gcm_context *ctx,
     return( 0 );
 }
 
+#if defined(MBEDTLS_GCM_GHASH_CT)
+/*
+ * One 64-bit Karatsuba product z of operands split by gcm_ct_split()
+ */
+static void gcm_ct_mul64( const uint32_t *an, const uint32_t *ar,
+                          const uint32_t *bn, const uint32_t *br,
+                          uint32_t z[4] )
+{
+    int i;
+    uint32_t lo[3], hi[3];
+
+    for( i = 0; i < 3; i++ )
+    {
+        lo[i] = gcm_bmul32( an[i], bn[i] );
+        hi[i] = gcm_rev32( gcm_bmul32( ar[i], br[i] ) ) >> 1;
+    }
+
+    lo[2] ^= lo[0] ^ lo[1];
+    hi[2] ^= hi[0] ^ hi[1];
+
+    z[0] = lo[0];
+    z[1] = hi[0] ^ lo[2];
+    z[2] = lo[1] ^ hi[2];
+    z[3] = hi[1];
+}
+
+/*
+ * Sets output to x times H in constant time.
+ * x and output are seen as elements of GF(2^128) as in [MGV].
+ */
+static void gcm_mult( mbedtls_gcm_context *ctx, const unsigned char x[16],
+                      unsigned char output[16] )
+{
+    int i;
+    uint32_t w[4], xr[9], xn[9], zl[4], zh[4], zm[4], z[8];
+
+#if defined(MBEDTLS_AESNI_C) && defined(MBEDTLS_HAVE_X86_64)
+    if( mbedtls_aesni_has_support( MBEDTLS_AESNI_CLMUL ) ) {
+        unsigned char h[16];
+
+        PUT_UINT32_BE( ctx->HW[ 9], h,  0 );
+        PUT_UINT32_BE( ctx->HW[10], h,  4 );
+        PUT_UINT32_BE( ctx->HW[12], h,  8 );
+        PUT_UINT32_BE( ctx->HW[13], h, 12 );
+
+        mbedtls_aesni_gcm_mult( output, x, h );
+        return;
+    }
+#endif /* MBEDTLS_AESNI_C && MBEDTLS_HAVE_X86_64 */
+
+    GET_UINT32_BE( w[0], x,  0 );
+    GET_UINT32_BE( w[1], x,  4 );
+    GET_UINT32_BE( w[2], x,  8 );
+    GET_UINT32_BE( w[3], x, 12 );
+
+    gcm_ct_split( w, xr, xn );
+
+    gcm_ct_mul64( xn,     xr,     ctx->HW,     ctx->HW +  9, zl );
+    gcm_ct_mul64( xn + 3, xr + 3, ctx->HW + 3, ctx->HW + 12, zh );
+    gcm_ct_mul64( xn + 6, xr + 6, ctx->HW + 6, ctx->HW + 15, zm );
+
+    for( i = 0; i < 4; i++ )
+        zm[i] ^= zl[i] ^ zh[i];
+
+    z[0] = zl[0];
+    z[1] = zl[1];
+    z[2] = zl[2] ^ zm[0];
+    z[3] = zl[3] ^ zm[1];
+    z[4] = zh[0] ^ zm[2];
+    z[5] = zh[1] ^ zm[3];
+    z[6] = zh[2];
+    z[7] = zh[3];
+
+    /* Reduce modulo x^128 + x^7 + x^2 + x + 1, from the top word down so
+     * that the bits folded back into z[4] are folded again */
+    for( i = 7; i >= 4; i-- )
+    {
+        z[i - 4] ^= z[i] ^ ( z[i] << 1 ) ^ ( z[i] << 2 ) ^ ( z[i] << 7 );
+        z[i - 3] ^= ( z[i] >> 31 ) ^ ( z[i] >> 30 ) ^ ( z[i] >> 25 );
+    }
+
+    for( i = 0; i < 4; i++ )
+    {
+        w[i] = gcm_rev32( z[i] );
+        PUT_UINT32_BE( w[i], output, 4 * i );
+    }
+}
+#else /* MBEDTLS_GCM_GHASH_CT */
 /*
  * Shoup's method for multiplication use this table with
  *      last4[x] = x times P^128
@@ -262,6 +452,7 @@ static void gcm_mult( mbedtls_gcm_context *ctx, const unsigned char x[16],
     PUT_UINT32_BE( zl >> 32, output, 8 );
     PUT_UINT32_BE( zl, output, 12 );
 }
+#endif /* MBEDTLS_GCM_GHASH_CT */
 
 int mbedtls_gcm_starts( mbedtls_gcm_context *ctx,
                 int mode,
@@ -568,19 +568,10 @@ static void buffer_alloc_free_mutexed( void *ptr )
 }
 #endif /* MBEDTLS_THREADING_C */
 
-void mbedtls_memory_buffer_alloc_init( unsigned char *buf, size_t len )
+static void buffer_alloc_setup( unsigned char *buf, size_t len )
 {
-    memset( &heap, 0, sizeof(buffer_alloc_ctx) );
     memset( buf, 0, len );
 
-#if defined(MBEDTLS_THREADING_C)
-    mbedtls_mutex_init( &heap.mutex );
-    mbedtls_platform_set_calloc_free( buffer_alloc_calloc_mutexed,
-                              buffer_alloc_free_mutexed );
-#else
-    mbedtls_platform_set_calloc_free( buffer_alloc_calloc, buffer_alloc_free );
-#endif
-
     if( (size_t) buf % MBEDTLS_MEMORY_ALIGN_MULTIPLE )
     {
         /* Adjust len first since buf is used in the computation */
@@ -600,6 +591,21 @@ void mbedtls_memory_buffer_alloc_init( unsigned char *buf, size_t len )
     heap.first_free = heap.first;
 }
 
+void mbedtls_memory_buffer_alloc_init( unsigned char *buf, size_t len )
+{
+    memset( &heap, 0, sizeof(buffer_alloc_ctx) );
+
+#if defined(MBEDTLS_THREADING_C)
+    mbedtls_mutex_init( &heap.mutex );
+    mbedtls_platform_set_calloc_free( buffer_alloc_calloc_mutexed,
+                              buffer_alloc_free_mutexed );
+#else
+    mbedtls_platform_set_calloc_free( buffer_alloc_calloc, buffer_alloc_free );
+#endif
+
+    buffer_alloc_setup( buf, len );
+}
+
 void mbedtls_memory_buffer_alloc_free()
 {
 #if defined(MBEDTLS_THREADING_C)
@@ -608,6 +614,54 @@ void mbedtls_memory_buffer_alloc_free()
     mbedtls_zeroize( &heap, sizeof(buffer_alloc_ctx) );
 }
 
+#if defined(MBEDTLS_MEMORY_ARENA)
+/*
+ * mbed OS: independent heaps, see platform/src/mbed_arena.c. Each keeps its
+ * state at the start of its buffer and is swapped in for a single call.
+ */
+int mbedtls_memory_buffer_arena_init( unsigned char *buf, size_t len )
+{
+    buffer_alloc_ctx saved = heap;
+
+    if( (size_t) buf % sizeof( void * ) != 0 ||
+        len < sizeof( buffer_alloc_ctx ) + sizeof( memory_header ) +
+              MBEDTLS_MEMORY_ALIGN_MULTIPLE )
+        return( -1 );
+
+    memset( &heap, 0, sizeof(buffer_alloc_ctx) );
+    buffer_alloc_setup( buf + sizeof( buffer_alloc_ctx ),
+                        len - sizeof( buffer_alloc_ctx ) );
+
+    memcpy( buf, &heap, sizeof( buffer_alloc_ctx ) );
+    heap = saved;
+    return( 0 );
+}
+
+void *mbedtls_memory_buffer_arena_calloc( unsigned char *buf, size_t n, size_t size )
+{
+    buffer_alloc_ctx saved = heap;
+    void *ret;
+
+    memcpy( &heap, buf, sizeof( buffer_alloc_ctx ) );
+    ret = buffer_alloc_calloc( n, size );
+    memcpy( buf, &heap, sizeof( buffer_alloc_ctx ) );
+
+    heap = saved;
+    return( ret );
+}
+
+void mbedtls_memory_buffer_arena_free( unsigned char *buf, void *ptr )
+{
+    buffer_alloc_ctx saved = heap;
+
+    memcpy( &heap, buf, sizeof( buffer_alloc_ctx ) );
+    buffer_alloc_free( ptr );
+    memcpy( buf, &heap, sizeof( buffer_alloc_ctx ) );
+
+    heap = saved;
+}
+#endif /* MBEDTLS_MEMORY_ARENA */
+
 #if defined(MBEDTLS_SELF_TEST)
 static int check_pointer( void *p )
 {
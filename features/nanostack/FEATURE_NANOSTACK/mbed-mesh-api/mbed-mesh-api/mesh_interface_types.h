@@ -17,6 +17,8 @@
 #ifndef __MESH_INTERFACE_TYPES_H__
 #define __MESH_INTERFACE_TYPES_H__
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -58,6 +60,41 @@ typedef enum {
     MESH_DEVICE_TYPE_THREAD_SLEEPY_END_DEVICE  /*<! Thread Sleepy end device */
 } mesh_device_type_t;
 
+/*
+ * Mesh network statistics, counted since the mesh system was initialized.
+ */
+typedef struct {
+    /* MAC */
+    uint32_t mac_rx_count;          /*<! frames received */
+    uint32_t mac_tx_count;          /*<! frames transmitted */
+    uint32_t mac_rx_drop;           /*<! received frames dropped */
+    uint32_t mac_tx_retry;          /*<! transmission retries */
+    uint32_t mac_tx_failed;         /*<! frames not acknowledged after all retries */
+    uint32_t mac_tx_cca_cnt;        /*<! clear channel assessments */
+    uint32_t mac_tx_failed_cca;     /*<! transmissions abandoned after CSMA-CA backoffs */
+    uint32_t mac_tx_queue_overflow; /*<! frames dropped as the MAC TX queue was full */
+    /* IP and 6LoWPAN */
+    uint32_t ip_rx_count;           /*<! packets received */
+    uint32_t ip_tx_count;           /*<! packets transmitted */
+    uint32_t ip_rx_drop;            /*<! received packets dropped */
+    uint32_t ip_no_route;           /*<! packets dropped for lack of a route */
+    uint32_t ip_routeloop_detect;   /*<! routing loops detected */
+    uint32_t frag_rx_errors;        /*<! fragment reassembly errors */
+    uint32_t frag_tx_errors;        /*<! fragmentation errors */
+    /* RPL */
+    uint32_t rpl_parent_change;     /*<! changes to a better parent */
+    uint32_t rpl_parent_tx_fail;    /*<! transmission failures to DODAG parents */
+    uint32_t rpl_local_repair;      /*<! local repairs */
+    uint32_t rpl_global_repair;     /*<! global repairs */
+    uint32_t rpl_time_no_next_hop;  /*<! seconds without a next hop */
+    uint16_t rpl_rank;              /*<! current rank in the first DODAG, 0xFFFF if none */
+    /* Heap */
+    uint32_t heap_size;             /*<! size of the stack heap in bytes */
+    uint32_t heap_allocated;        /*<! bytes allocated from the stack heap */
+    uint32_t heap_allocated_max;    /*<! high-water mark of the allocated bytes */
+    uint32_t heap_alloc_fail;       /*<! failed allocations */
+} mesh_stats_t;
+
 #ifdef __cplusplus
 }
 #endif
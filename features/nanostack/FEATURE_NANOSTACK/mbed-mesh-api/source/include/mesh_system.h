@@ -17,6 +17,7 @@
 #ifndef __INCLUDE_MESH_SYSTEM__
 #define __INCLUDE_MESH_SYSTEM__
 #include "ns_types.h"
+#include "mbed-mesh-api/mesh_interface_types.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +40,15 @@ void mesh_system_send_connect_event(uint8_t receiver);
  */
 void mesh_system_init(void);
 
+/*
+ * \brief Read mesh network statistics.
+ * Statistics are collected from mesh_system_init() onwards, for all
+ * interfaces of the stack.
+ *
+ * \param stats where the statistics will be written
+ */
+void mesh_system_get_stats(mesh_stats_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
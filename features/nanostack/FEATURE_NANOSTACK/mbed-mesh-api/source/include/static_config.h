@@ -177,6 +177,15 @@ extern "C" {
 #define MBED_MESH_API_THREAD_CONFIG_PSKC {0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff}
 #endif
 
+// Store the link configuration of the network joined to NVM and re-attach with it after a reset
+#ifdef YOTTA_CFG_MBED_MESH_API_THREAD_CONFIG_PERSIST
+#define MBED_MESH_API_THREAD_CONFIG_PERSIST YOTTA_CFG_MBED_MESH_API_THREAD_CONFIG_PERSIST
+#elif defined MBED_CONF_MBED_MESH_API_THREAD_CONFIG_PERSIST
+#define MBED_MESH_API_THREAD_CONFIG_PERSIST MBED_CONF_MBED_MESH_API_THREAD_CONFIG_PERSIST
+#else
+#define MBED_MESH_API_THREAD_CONFIG_PERSIST 0
+#endif
+
 #ifdef __cplusplus
 }
 #endif
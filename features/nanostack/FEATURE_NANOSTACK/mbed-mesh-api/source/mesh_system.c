@@ -17,6 +17,8 @@
 #include "eventOS_scheduler.h"
 #include "eventOS_event.h"
 #include "net_interface.h"
+#include "nwk_stats_api.h"
+#include "net_rpl.h"
 #include "nsdynmemLIB.h"
 #include "randLIB.h"
 #include "platform/arm_hal_timer.h"
@@ -35,6 +37,9 @@
 /* Heap for NanoStack */
 static uint8_t app_stack_heap[MBED_MESH_API_HEAP_SIZE + 1];
 static bool mesh_initialized = false;
+/* Counters updated by the stack */
+static nwk_stats_t mesh_nwk_stats;
+static mem_stat_t mesh_heap_stats;
 
 /*
  * Heap error handler, called when heap problem is detected.
@@ -62,18 +67,20 @@ void mesh_system_init(void)
     if (mesh_initialized == false) {
 #ifndef YOTTA_CFG
         ns_hal_init(app_stack_heap, MBED_MESH_API_HEAP_SIZE,
-                    mesh_system_heap_error_handler, NULL);
+                    mesh_system_heap_error_handler, &mesh_heap_stats);
         eventOS_scheduler_mutex_wait();
         net_init_core();
+        protocol_stats_start(&mesh_nwk_stats);
         eventOS_scheduler_mutex_release();
 #else
         ns_dyn_mem_init(app_stack_heap, MBED_MESH_API_HEAP_SIZE,
-                        mesh_system_heap_error_handler, NULL);
+                        mesh_system_heap_error_handler, &mesh_heap_stats);
         randLIB_seed_random();
         platform_timer_enable();
         eventOS_scheduler_init();
         trace_init(); // trace system needs to be initialized right after eventOS_scheduler_init
         net_init_core();
+        protocol_stats_start(&mesh_nwk_stats);
         /* initialize 6LoWPAN socket adaptation layer */
         ns_sal_init_stack();
 #endif
@@ -92,3 +99,52 @@ void mesh_system_send_connect_event(uint8_t receiver)
     };
     eventOS_event_send(&event);
 }
+
+/*
+ * Current rank in the first global RPL instance, 0xFFFF if there is none.
+ */
+static uint16_t mesh_system_rpl_rank(void)
+{
+    uint8_t instances[1 + 16];
+    rpl_dodag_info_t dodag_info;
+
+    if (rpl_instance_list_read(instances, sizeof instances) == 0 ||
+            (instances[0] & RPL_INSTANCE_LOCAL)) {
+        return 0xFFFF;
+    }
+    if (!rpl_read_dodag_info(&dodag_info, instances[0])) {
+        return 0xFFFF;
+    }
+    return dodag_info.curent_rank;
+}
+
+void mesh_system_get_stats(mesh_stats_t *stats)
+{
+    const nwk_stats_t *nwk = &mesh_nwk_stats;
+
+    stats->mac_rx_count = nwk->mac_rx_count;
+    stats->mac_tx_count = nwk->mac_tx_count;
+    stats->mac_rx_drop = nwk->mac_rx_drop;
+    stats->mac_tx_retry = nwk->mac_tx_retry;
+    stats->mac_tx_failed = nwk->mac_tx_failed;
+    stats->mac_tx_cca_cnt = nwk->mac_tx_cca_cnt;
+    stats->mac_tx_failed_cca = nwk->mac_tx_failed_cca;
+    stats->mac_tx_queue_overflow = nwk->mac_tx_buffer_overflow;
+    stats->ip_rx_count = nwk->ip_rx_count;
+    stats->ip_tx_count = nwk->ip_tx_count;
+    stats->ip_rx_drop = nwk->ip_rx_drop;
+    stats->ip_no_route = nwk->ip_no_route;
+    stats->ip_routeloop_detect = nwk->ip_routeloop_detect;
+    stats->frag_rx_errors = nwk->frag_rx_errors;
+    stats->frag_tx_errors = nwk->frag_tx_errors;
+    stats->rpl_parent_change = nwk->rpl_route_routecost_better_change;
+    stats->rpl_parent_tx_fail = nwk->rpl_parent_tx_fail;
+    stats->rpl_local_repair = nwk->rpl_local_repair;
+    stats->rpl_global_repair = nwk->rpl_global_repair;
+    stats->rpl_time_no_next_hop = nwk->rpl_time_no_next_hop;
+    stats->rpl_rank = mesh_initialized ? mesh_system_rpl_rank() : 0xFFFF;
+    stats->heap_size = (uint16_t) mesh_heap_stats.heap_sector_size;
+    stats->heap_allocated = (uint16_t) mesh_heap_stats.heap_sector_allocated_bytes;
+    stats->heap_allocated_max = (uint16_t) mesh_heap_stats.heap_sector_allocated_bytes_max;
+    stats->heap_alloc_fail = mesh_heap_stats.heap_alloc_fail_cnt;
+}
@@ -25,6 +25,9 @@
 #include "include/thread_tasklet.h"
 #include "include/static_config.h"
 #include "include/mesh_system.h"
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+#include "platform/arm_hal_nvm.h"
+#endif
 #ifndef YOTTA_CFG
 #include "ns_event_loop.h"
 #endif
@@ -50,6 +53,11 @@
 
 #define INVALID_INTERFACE_ID        (-1)
 
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+#define THREAD_NVM_KEY_LINK_CONFIG  "com.arm.mbed.mesh.thread.link_config"
+#define THREAD_NVM_VERSION          1
+#endif
+
 /*
  * Thread tasklet states.
  */
@@ -81,18 +89,61 @@ typedef struct {
     uint32_t rfChannel;
     uint8_t scan_time;
     net_6lowpan_gp_address_mode_e address_mode;
+    bool link_config_restored;
 } thread_tasklet_data_str_t;
 
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+/*
+ * Thread NVM states.
+ */
+typedef enum {
+    THREAD_NVM_STATE_IDLE = 0,
+    THREAD_NVM_STATE_INITIALIZING,
+    THREAD_NVM_STATE_READING,
+    THREAD_NVM_STATE_CREATING,
+    THREAD_NVM_STATE_WRITING,
+    THREAD_NVM_STATE_FLUSHING
+} thread_nvm_state_t;
+
+/*
+ * Link configuration as stored to NVM, PSKc_ptr is not stored.
+ */
+typedef struct {
+    uint32_t version;
+    link_configuration_s link_config;
+} thread_nvm_data_t;
+
+/*
+ * NVM data structure. data holds the stored link configuration once valid is set,
+ * or the one being stored.
+ */
+typedef struct {
+    thread_nvm_state_t state;
+    bool loaded;
+    bool valid;
+    bool fallback;
+    uint16_t data_len;
+    thread_nvm_data_t data;
+} thread_nvm_str_t;
+#endif
+
 
 /* Tasklet data */
 static thread_tasklet_data_str_t *thread_tasklet_data_ptr = NULL;
 static device_configuration_s device_configuration;
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+static thread_nvm_str_t thread_nvm;
+#endif
 
 /* private function prototypes */
 void thread_tasklet_main(arm_event_s *event);
 void thread_tasklet_network_state_changed(mesh_connection_status_t status);
 void thread_tasklet_parse_network_event(arm_event_s *event);
 void thread_tasklet_configure_and_connect_to_network(void);
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+void thread_tasklet_nvm_load(void);
+void thread_tasklet_nvm_store(void);
+#endif
 #define TRACE_THREAD_TASKLET
 #ifndef TRACE_THREAD_TASKLET
 #define thread_tasklet_trace_bootstrap_info() ((void) 0)
@@ -132,6 +183,16 @@ void thread_tasklet_main(arm_event_s *event)
                                        thread_tasklet_data_ptr->tasklet);
 
             if (event->event_id == TIMER_EVENT_START_BOOTSTRAP) {
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+                if (thread_tasklet_data_ptr->link_config_restored) {
+                    // The stored network wasn't found, join with the application configuration
+                    tr_info("Restart bootstrap without the stored link configuration");
+                    thread_nvm.fallback = true;
+                    arm_nwk_interface_down(thread_tasklet_data_ptr->nwk_if_id);
+                    thread_tasklet_configure_and_connect_to_network();
+                    break;
+                }
+#endif
                 tr_debug("Restart bootstrap");
                 arm_nwk_interface_up(thread_tasklet_data_ptr->nwk_if_id);
             }
@@ -139,7 +200,11 @@ void thread_tasklet_main(arm_event_s *event)
 
         case APPLICATION_EVENT:
             if (event->event_id == APPL_EVENT_CONNECT) {
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+                thread_tasklet_nvm_load();
+#else
                 thread_tasklet_configure_and_connect_to_network();
+#endif
             }
             break;
 
@@ -170,6 +235,10 @@ void thread_tasklet_parse_network_event(arm_event_s *event)
                 tr_info("Thread bootstrap ready");
                 thread_tasklet_data_ptr->tasklet_state = TASKLET_STATE_BOOTSTRAP_READY;
                 thread_tasklet_trace_bootstrap_info();
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+                thread_tasklet_data_ptr->link_config_restored = false;
+                thread_tasklet_nvm_store();
+#endif
                 thread_tasklet_network_state_changed(MESH_CONNECTED);
             }
             break;
@@ -301,6 +370,19 @@ void thread_tasklet_configure_and_connect_to_network(void)
     thread_tasklet_data_ptr->link_config.key_rotation = 3600;
     thread_tasklet_data_ptr->link_config.key_sequence = 0;
 
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+    // Re-attach to the network joined before the reset
+    thread_tasklet_data_ptr->link_config_restored = false;
+    if (thread_nvm.valid && !thread_nvm.fallback) {
+        thread_tasklet_data_ptr->link_config = thread_nvm.data.link_config;
+        thread_tasklet_data_ptr->link_config_restored = true;
+        tr_info("Restored link configuration, PANID %x channel %d key sequence %d",
+                thread_tasklet_data_ptr->link_config.panId,
+                thread_tasklet_data_ptr->link_config.rfChannel,
+                (int)thread_tasklet_data_ptr->link_config.key_sequence);
+    }
+#endif
+
     thread_management_node_init(thread_tasklet_data_ptr->nwk_if_id,
                                &thread_tasklet_data_ptr->channel_list,
                                &device_configuration,
@@ -318,6 +400,123 @@ void thread_tasklet_configure_and_connect_to_network(void)
     }
 }
 
+#if MBED_MESH_API_THREAD_CONFIG_PERSIST
+/*
+ * \brief Completion of the NVM operations, progresses loading or storing the link configuration.
+ *
+ * Called from the event loop like the tasklet.
+ */
+static void thread_tasklet_nvm_cb(platform_nvm_status status, void *context)
+{
+    (void) context;
+    switch (thread_nvm.state) {
+        case THREAD_NVM_STATE_INITIALIZING:
+            if (status == PLATFORM_NVM_OK) {
+                thread_nvm.state = THREAD_NVM_STATE_READING;
+                thread_nvm.data_len = sizeof(thread_nvm_data_t);
+                if (platform_nvm_read(thread_tasklet_nvm_cb, THREAD_NVM_KEY_LINK_CONFIG,
+                                      &thread_nvm.data, &thread_nvm.data_len, NULL) == PLATFORM_NVM_OK) {
+                    return;
+                }
+            }
+            tr_warn("NVM init failed");
+            break;
+        case THREAD_NVM_STATE_READING:
+            thread_nvm.valid = status == PLATFORM_NVM_OK &&
+                               thread_nvm.data_len == sizeof(thread_nvm_data_t) &&
+                               thread_nvm.data.version == THREAD_NVM_VERSION;
+            TRACE_DETAIL("Link configuration %s in NVM", thread_nvm.valid ? "found" : "not found");
+            break;
+        case THREAD_NVM_STATE_CREATING:
+            if (status == PLATFORM_NVM_OK) {
+                thread_nvm.state = THREAD_NVM_STATE_WRITING;
+                thread_nvm.data_len = sizeof(thread_nvm_data_t);
+                if (platform_nvm_write(thread_tasklet_nvm_cb, THREAD_NVM_KEY_LINK_CONFIG,
+                                       &thread_nvm.data, &thread_nvm.data_len, NULL) == PLATFORM_NVM_OK) {
+                    return;
+                }
+            }
+            tr_warn("Link configuration store failed");
+            break;
+        case THREAD_NVM_STATE_WRITING:
+            if (status == PLATFORM_NVM_OK && thread_nvm.data_len == sizeof(thread_nvm_data_t)) {
+                thread_nvm.state = THREAD_NVM_STATE_FLUSHING;
+                if (platform_nvm_flush(thread_tasklet_nvm_cb, NULL) == PLATFORM_NVM_OK) {
+                    return;
+                }
+            }
+            tr_warn("Link configuration store failed");
+            break;
+        case THREAD_NVM_STATE_FLUSHING:
+            thread_nvm.valid = status == PLATFORM_NVM_OK;
+            if (thread_nvm.valid) {
+                tr_info("Link configuration stored");
+            } else {
+                tr_warn("Link configuration store failed");
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (thread_nvm.state == THREAD_NVM_STATE_INITIALIZING || thread_nvm.state == THREAD_NVM_STATE_READING) {
+        // Connect whether or not a link configuration could be read
+        thread_nvm.state = THREAD_NVM_STATE_IDLE;
+        thread_nvm.loaded = true;
+        thread_tasklet_configure_and_connect_to_network();
+        return;
+    }
+    thread_nvm.state = THREAD_NVM_STATE_IDLE;
+}
+
+/*
+ * \brief Read the link configuration stored before the reset, then connect.
+ */
+void thread_tasklet_nvm_load(void)
+{
+    if (thread_nvm.loaded || thread_nvm.state != THREAD_NVM_STATE_IDLE) {
+        thread_tasklet_configure_and_connect_to_network();
+        return;
+    }
+
+    thread_nvm.state = THREAD_NVM_STATE_INITIALIZING;
+    if (platform_nvm_init(thread_tasklet_nvm_cb, NULL) != PLATFORM_NVM_OK) {
+        // Another user of the NVM has initialized it already
+        thread_tasklet_nvm_cb(PLATFORM_NVM_OK, NULL);
+    }
+}
+
+/*
+ * \brief Store the link configuration of the network joined, once it differs from the stored one.
+ */
+void thread_tasklet_nvm_store(void)
+{
+    link_configuration_s link_config;
+    link_configuration_s *link_config_ptr = thread_management_configuration_get(thread_tasklet_data_ptr->nwk_if_id);
+
+    if (link_config_ptr == NULL || !thread_nvm.loaded || thread_nvm.state != THREAD_NVM_STATE_IDLE) {
+        return;
+    }
+
+    link_config = *link_config_ptr;
+    link_config.PSKc_ptr = NULL;
+    link_config.PSKc_len = 0;
+    if (thread_nvm.valid && memcmp(&link_config, &thread_nvm.data.link_config, sizeof(link_configuration_s)) == 0) {
+        return;
+    }
+
+    thread_nvm.valid = false;
+    thread_nvm.data.version = THREAD_NVM_VERSION;
+    thread_nvm.data.link_config = link_config;
+    thread_nvm.state = THREAD_NVM_STATE_CREATING;
+    if (platform_nvm_key_create(thread_tasklet_nvm_cb, THREAD_NVM_KEY_LINK_CONFIG,
+                                sizeof(thread_nvm_data_t), 0, NULL) != PLATFORM_NVM_OK) {
+        tr_warn("Link configuration store failed");
+        thread_nvm.state = THREAD_NVM_STATE_IDLE;
+    }
+}
+#endif /* MBED_MESH_API_THREAD_CONFIG_PERSIST */
+
 /*
  * Inform application about network state change
  */
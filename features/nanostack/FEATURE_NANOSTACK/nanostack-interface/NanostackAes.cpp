@@ -0,0 +1,94 @@
+/* Nanostack implementation of NetworkSocketAPI
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* AES block cipher of Nanostack's MAC security, taking the place of the
+ * software-only adapter of the library. Nanostack calls it from its event
+ * thread, one series arm_aes_start(), arm_aes_encrypt()..., arm_aes_finish()
+ * at a time.
+ */
+
+#include <string.h>
+#include "mbed.h"
+#include "NanostackRfPhy.h"
+#include "platform/arm_hal_aes.h"
+#include "mbedtls/aes.h"
+
+static NanostackRfPhy *aes_phy;
+static bool aes_hw;                 // The current series runs on aes_phy
+static mbedtls_aes_context aes_ctx;
+static uint32_t aes_start_us;
+static nanostack_aes_stats_t aes_stats;
+
+void nanostack_aes_set_phy(NanostackRfPhy *phy)
+{
+    aes_phy = phy;
+}
+
+void nanostack_aes_get_stats(nanostack_aes_stats_t *stats)
+{
+    core_util_critical_section_enter();
+    *stats = aes_stats;
+    core_util_critical_section_exit();
+}
+
+void nanostack_aes_reset_stats()
+{
+    core_util_critical_section_enter();
+    memset(&aes_stats, 0, sizeof aes_stats);
+    core_util_critical_section_exit();
+}
+
+void arm_aes_start(const uint8_t key[16])
+{
+    aes_start_us = us_ticker_read();
+    aes_hw = aes_phy != NULL && aes_phy->aes_start(key);
+    if (!aes_hw) {
+        mbedtls_aes_init(&aes_ctx);
+        mbedtls_aes_setkey_enc(&aes_ctx, key, 128);
+    }
+}
+
+void arm_aes_encrypt(const uint8_t src[16], uint8_t dst[16])
+{
+    if (aes_hw) {
+        aes_phy->aes_encrypt(src, dst);
+    } else {
+        mbedtls_aes_crypt_ecb(&aes_ctx, MBEDTLS_AES_ENCRYPT, src, dst);
+    }
+    aes_stats.blocks++;
+}
+
+void arm_aes_finish(void)
+{
+    if (aes_hw) {
+        aes_phy->aes_finish();
+    } else {
+        mbedtls_aes_free(&aes_ctx);
+    }
+
+    uint32_t elapsed = us_ticker_read() - aes_start_us;
+    core_util_critical_section_enter();
+    if (aes_hw) {
+        aes_stats.hw_frames++;
+    } else {
+        aes_stats.sw_frames++;
+    }
+    aes_stats.total_us += elapsed;
+    if (elapsed > aes_stats.max_us) {
+        aes_stats.max_us = elapsed;
+    }
+    core_util_critical_section_exit();
+}
@@ -28,7 +28,6 @@
 #include "mesh_system.h" // from inside mbed-mesh-api
 #include "socket_api.h"
 #include "net_interface.h"
-#include "ip6string.h"
 // Uncomment to enable trace
 //#define HAVE_DEBUG
 #include "ns_trace.h"
@@ -58,7 +57,8 @@ class NanostackBuffer {
 public:
     NanostackBuffer *next;      /*<! next buffer */
     ns_address_t ns_address;    /*<! address where data is received */
-    uint16_t length;            /*<! data length in this buffer */
+    uint16_t offset;            /*<! start of the unread data in payload */
+    uint16_t length;            /*<! unread data length in this buffer */
     uint8_t payload[1];          /*<! Trailing buffer data */
 };
 
@@ -94,6 +94,7 @@ public:
 
     bool data_available(void);
     size_t data_copy_and_free(void *dest, size_t len, SocketAddress *address, bool stream);
+    NanostackBuffer *data_detach(SocketAddress *address);
     void data_free_all(void);
     void data_attach(NanostackBuffer *data_buf);
 
@@ -126,16 +127,17 @@ static void convert_mbed_addr_to_ns(ns_address_t *ns_addr,
 {
     ns_addr->type = ADDRESS_IPV6;
     ns_addr->identifier = s_addr->get_port();
-    const char *str = s_addr->get_ip_address();
-    stoip6(str, strlen(str), ns_addr->address);
+    nsapi_addr_t addr = s_addr->get_addr();
+    memcpy(ns_addr->address, addr.bytes, sizeof ns_addr->address);
 }
 
 static void convert_ns_addr_to_mbed(SocketAddress *s_addr, const ns_address_t *ns_addr)
 {
-    char str[40];
-    ip6tos(ns_addr->address, str);
+    nsapi_addr_t addr;
+    addr.version = NSAPI_IPv6;
+    memcpy(addr.bytes, ns_addr->address, sizeof addr.bytes);
+    s_addr->set_addr(addr);
     s_addr->set_port(ns_addr->identifier);
-    s_addr->set_ip_address(str);
 }
 
 void* NanostackSocket::operator new(std::size_t sz) {
@@ -346,13 +348,12 @@ size_t NanostackSocket::data_copy_and_free(void *dest, size_t len,
     }
 
     size_t copy_size = (len > data_buf->length) ? data_buf->length : len;
-    memcpy(dest, data_buf->payload, copy_size);
+    memcpy(dest, data_buf->payload + data_buf->offset, copy_size);
 
     if (stream && (copy_size < data_buf->length)) {
-        // Update the size in the buffer
-        size_t new_buf_size = data_buf->length - copy_size;
-        memmove(data_buf->payload, data_buf->payload + copy_size, new_buf_size);
-        data_buf->length = new_buf_size;
+        // Skip the data read, the rest stays in place
+        data_buf->offset += copy_size;
+        data_buf->length -= copy_size;
     } else {
         // Entire packet used so free it
         rxBufChain = data_buf->next;
@@ -362,6 +363,28 @@ size_t NanostackSocket::data_copy_and_free(void *dest, size_t len,
     return copy_size;
 }
 
+NanostackBuffer *NanostackSocket::data_detach(SocketAddress *address)
+{
+    nanostack_assert_locked();
+    MBED_ASSERT((SOCKET_MODE_DATAGRAM == mode) ||
+                (mode == SOCKET_MODE_STREAM));
+
+    NanostackBuffer *data_buf = rxBufChain;
+    if (NULL == data_buf) {
+        // No data
+        return NULL;
+    }
+
+    if (address) {
+        convert_ns_addr_to_mbed(address, &data_buf->ns_address);
+    }
+
+    // The whole buffer, with any unread stream data, is handed over
+    rxBufChain = data_buf->next;
+    data_buf->next = NULL;
+    return data_buf;
+}
+
 void NanostackSocket::data_free_all(void)
 {
     nanostack_assert_locked();
@@ -410,6 +433,7 @@ void NanostackSocket::event_data(socket_callback_t *sock_cb)
         return;
     }
     recv_buff->next = NULL;
+    recv_buff->offset = 0;
 
     // Write data to buffer
     int16_t length = socket_read(sock_cb->socket_id,
@@ -495,6 +519,8 @@ int MeshInterfaceNanostack::register_rf()
         nanostack_unlock();
         return -1;
     }
+    // MAC security encrypts with the radio's AES engine, if it has one.
+    nanostack_aes_set_phy(phy);
     // Read mac address after registering the device.
     phy->get_mac_address(eui64);
     sprintf(mac_addr_str, "%02x:%02x:%02x:%02x:%02x:%02x:%02x:%02x", eui64[0], eui64[1], eui64[2], eui64[3], eui64[4], eui64[5], eui64[6], eui64[7]);
@@ -562,6 +588,21 @@ const char *MeshInterfaceNanostack::get_mac_address()
     return mac_addr_str;
 }
 
+int MeshInterfaceNanostack::get_stats(mesh_stats_t *stats)
+{
+    if (NULL == stats) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    nanostack_lock();
+
+    mesh_system_get_stats(stats);
+
+    nanostack_unlock();
+
+    return 0;
+}
+
 int ThreadInterface::connect()
 {
     // initialize mesh networking resources, memory, timers, etc...
@@ -963,3 +1004,124 @@ void NanostackInterface::socket_attach(void *handle, void (*callback)(void *), v
 
     tr_debug("socket_attach(socket=%p) sock_id=%d", socket, socket->socket_id);
 }
+
+nsapi_buf_t NanostackInterface::buf_alloc(unsigned size)
+{
+    if (size > 0xFFFF) {
+        return NULL;
+    }
+
+    nanostack_lock();
+
+    NanostackBuffer *buf = (NanostackBuffer *) MALLOC(sizeof(NanostackBuffer) + size);
+    if (buf != NULL) {
+        buf->next = NULL;
+        buf->offset = 0;
+        buf->length = size;
+    }
+
+    nanostack_unlock();
+
+    return buf;
+}
+
+void NanostackInterface::buf_free(nsapi_buf_t buf)
+{
+    nanostack_lock();
+
+    FREE(buf);
+
+    nanostack_unlock();
+}
+
+unsigned NanostackInterface::buf_data(nsapi_buf_t buf, unsigned offset, void **data)
+{
+    NanostackBuffer *data_buf = static_cast<NanostackBuffer *>(buf);
+    if (offset >= data_buf->length) {
+        return 0;
+    }
+
+    *data = data_buf->payload + data_buf->offset + offset;
+    return data_buf->length - offset;
+}
+
+int NanostackInterface::socket_send_buf(void *handle, nsapi_buf_t buf, unsigned offset)
+{
+    NanostackBuffer *data_buf = static_cast<NanostackBuffer *>(buf);
+    if (offset >= data_buf->length) {
+        return 0;
+    }
+
+    // Nanostack copies the data into its own buffer, so it can be sent
+    // straight from the payload
+    return socket_send(handle, data_buf->payload + data_buf->offset + offset,
+                       data_buf->length - offset);
+}
+
+int NanostackInterface::socket_recv_buf(void *handle, nsapi_buf_t *buf)
+{
+    // Validate parameters
+    NanostackSocket * socket = static_cast<NanostackSocket *>(handle);
+    if (NULL == handle) {
+        MBED_ASSERT(false);
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    nanostack_lock();
+
+    int ret;
+    if (socket->closed()) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+    } else if (socket->data_available()) {
+        NanostackBuffer *data_buf = socket->data_detach(NULL);
+        *buf = data_buf;
+        ret = data_buf->length;
+    } else {
+        ret = NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    nanostack_unlock();
+
+    tr_debug("socket_recv_buf(socket=%p) sock_id=%d, ret=%i", socket, socket->socket_id, ret);
+
+    return ret;
+}
+
+int NanostackInterface::socket_sendto_buf(void *handle, const SocketAddress &address, nsapi_buf_t buf)
+{
+    NanostackBuffer *data_buf = static_cast<NanostackBuffer *>(buf);
+
+    return socket_sendto(handle, address, data_buf->payload + data_buf->offset, data_buf->length);
+}
+
+int NanostackInterface::socket_recvfrom_buf(void *handle, SocketAddress *address, nsapi_buf_t *buf)
+{
+    // Validate parameters
+    NanostackSocket * socket = static_cast<NanostackSocket *>(handle);
+    if (NULL == handle) {
+        MBED_ASSERT(false);
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    nanostack_lock();
+
+    int ret;
+    if (socket->closed()) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+    } else if (NANOSTACK_SOCKET_TCP == socket->proto) {
+        tr_error("recv_from() not supported with SOCKET_STREAM!");
+        ret = NSAPI_ERROR_UNSUPPORTED;
+    } else if (!socket->data_available()) {
+        ret = NSAPI_ERROR_WOULD_BLOCK;
+    } else {
+        NanostackBuffer *data_buf = socket->data_detach(address);
+        *buf = data_buf;
+        ret = data_buf->length;
+    }
+
+    nanostack_unlock();
+
+    tr_debug("socket_recvfrom_buf(socket=%p) sock_id=%d, ret=%i", socket, socket->socket_id, ret);
+
+    return ret;
+}
@@ -214,6 +214,80 @@ protected:
      */
     virtual int getsockopt(void *handle, int level, int optname, void *optval, unsigned *optlen);
 
+    /** Allocate a network buffer
+     *
+     *  The buffer is allocated from the nanostack heap.
+     *
+     *  @param size     Size of the buffer in bytes
+     *  @return         Handle to the buffer, or null on failure
+     */
+    virtual nsapi_buf_t buf_alloc(unsigned size);
+
+    /** Free a network buffer
+     *
+     *  @param buf      Buffer handle
+     */
+    virtual void buf_free(nsapi_buf_t buf);
+
+    /** Get the contiguous data of a network buffer at an offset
+     *
+     *  Nanostack buffers are always a single segment.
+     *
+     *  @param buf      Buffer handle
+     *  @param offset   Offset in bytes from the start of the buffer
+     *  @param data     Destination for a pointer to the data at offset
+     *  @return         Number of contiguous bytes at offset, 0 past the end
+     *                  of the buffer
+     */
+    virtual unsigned buf_data(nsapi_buf_t buf, unsigned offset, void **data);
+
+    /** Send a network buffer over a TCP socket
+     *
+     *  @param handle   Socket handle
+     *  @param buf      Buffer handle, still owned by the caller afterwards
+     *  @param offset   Offset in bytes of the first byte to send
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_send_buf(void *handle, nsapi_buf_t buf, unsigned offset);
+
+    /** Receive a network buffer over a TCP socket
+     *
+     *  Hands over the buffer the data was read into from nanostack, with
+     *  no copy out.
+     *
+     *  @param handle   Socket handle
+     *  @param buf      Destination for the received buffer, owned by the
+     *                  caller on success
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_recv_buf(void *handle, nsapi_buf_t *buf);
+
+    /** Send a network buffer as a packet over a UDP socket
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host
+     *  @param buf      Buffer handle, still owned by the caller afterwards
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_sendto_buf(void *handle, const SocketAddress &address, nsapi_buf_t buf);
+
+    /** Receive a packet as a network buffer over a UDP socket
+     *
+     *  Hands over the buffer the packet was read into from nanostack, with
+     *  no copy out.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address or NULL
+     *  @param buf      Destination for the received buffer, owned by the
+     *                  caller on success
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_recvfrom_buf(void *handle, SocketAddress *address, nsapi_buf_t *buf);
+
 private:
     static NanostackInterface * _ns_interface;
 };
@@ -252,6 +326,17 @@ public:
     */
     virtual const char *get_mac_address();
 
+    /** Get the mesh network statistics
+     *
+     *  The counters cover MAC retries and CSMA-CA failures, MAC queue
+     *  overflows, routing failures and RPL parent changes, and the stack
+     *  heap, for all mesh interfaces since the first one was connected.
+     *
+     *  @param stats    Destination for the statistics
+     *  @return         0 on success, negative on failure
+     */
+    int get_stats(mesh_stats_t *stats);
+
 protected:
     MeshInterfaceNanostack();
     MeshInterfaceNanostack(NanostackRfPhy *phy);
@@ -5,6 +5,32 @@
 #ifndef NANOSTACK_RF_PHY_H_
 #define NANOSTACK_RF_PHY_H_
 
+#include <stdint.h>
+
+/** Cost of the AES Nanostack's MAC security runs
+ *
+ *  A frame is one series of block encryptions Nanostack runs with a key,
+ *  for the CCM* of one secured frame.
+ */
+typedef struct nanostack_aes_stats {
+    uint32_t hw_frames;     /**< Frames the radio's AES engine encrypted */
+    uint32_t sw_frames;     /**< Frames encrypted in software */
+    uint32_t blocks;        /**< AES blocks encrypted, all frames together */
+    uint32_t total_us;      /**< Time spent in AES, all frames together */
+    uint32_t max_us;        /**< Longest frame */
+} nanostack_aes_stats_t;
+
+/** Radio driver for Nanostack
+ *
+ *  A driver registers a phy_device_driver_s with arm_net_phy_register()
+ *  from rf_register(). Received frames are passed to the driver's
+ *  phy_rx_cb, which copies the frame into a Nanostack buffer before it
+ *  returns. That copy is the only one a frame needs: a driver can pass
+ *  phy_rx_cb a buffer it reads the radio FIFO into, reusing it for every
+ *  frame, or the FIFO memory itself if it is memory mapped and stays
+ *  unchanged until phy_rx_cb returns. Reading the FIFO in a single burst
+ *  transfer into such a buffer is up to the driver.
+ */
 class NanostackRfPhy {
 public:
 
@@ -32,9 +58,53 @@ public:
      */
     virtual void set_mac_address(uint8_t *mac) = 0;
 
+    /** Start a series of AES-128 block encryptions in hardware
+     *
+     *  Nanostack runs the CCM* of MAC security itself, encrypting the
+     *  blocks of a frame between aes_start() and aes_finish(). A driver
+     *  whose radio has an AES engine overrides these three to encrypt
+     *  the blocks with it: software is used otherwise, or for a series
+     *  aes_start() refuses, e.g. while the engine is busy.
+     *
+     *  @param key      128-bit key, to be copied
+     *  @return         True if the series runs in hardware
+     */
+    virtual bool aes_start(const uint8_t key[16]) { return false; }
+
+    /** Encrypt a block with the key of aes_start(), dst = E(key, src)
+     *
+     *  @param src      128-bit plaintext
+     *  @param dst      128-bit ciphertext, may equal src
+     */
+    virtual void aes_encrypt(const uint8_t src[16], uint8_t dst[16]) {}
+
+    /** End a series of encryptions aes_start() accepted
+     *
+     */
+    virtual void aes_finish() {}
+
 protected:
     NanostackRfPhy() {}
     virtual ~NanostackRfPhy() {}
 };
 
+/** Have Nanostack's MAC security encrypt with a phy's AES engine
+ *
+ *  Called by the mesh interfaces when they register their phy.
+ *
+ *  @param phy      The phy, or NULL to use software only
+ */
+void nanostack_aes_set_phy(NanostackRfPhy *phy);
+
+/** Read the cost of MAC security's AES since boot or the last reset
+ *
+ *  @param stats    Filled with the statistics
+ */
+void nanostack_aes_get_stats(nanostack_aes_stats_t *stats);
+
+/** Reset the cost of MAC security's AES
+ *
+ */
+void nanostack_aes_reset_stats();
+
 #endif /* NANOSTACK_INTERFACE_H_ */
@@ -0,0 +1,217 @@
+/* CFStoreTLSSessionCache
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CFStoreTLSSessionCache.h"
+
+#if defined(MBEDTLS_SSL_CLI_C) && FEATURE_STORAGE
+
+#include <string.h>
+#include <new>
+#include "nsapi_types.h"
+
+#define TLS_SESSION_KEY_PREFIX "tls.session."
+
+CFStoreTLSSessionCache::CFStoreTLSSessionCache(uint32_t max_age)
+    : _drv(&cfstore_driver), _init(false), _max_age(max_age)
+{
+    // sessions are stored and read inline, which needs synchronous mode
+    ARM_CFSTORE_CAPABILITIES caps = _drv->GetCapabilities();
+    if (!caps.asynchronous_ops && _drv->Initialize(NULL, NULL) >= ARM_DRIVER_OK) {
+        _init = true;
+    }
+}
+
+CFStoreTLSSessionCache::~CFStoreTLSSessionCache()
+{
+    if (_init) {
+        _drv->Uninitialize();
+    }
+}
+
+void CFStoreTLSSessionCache::key_name(const char *key, char *name)
+{
+    static const char acceptable[] =
+        "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ.-_";
+
+    // hostnames are mostly made of characters acceptable in key names,
+    // others such as the colons of IPv6 addresses are replaced
+    size_t len = strlen(TLS_SESSION_KEY_PREFIX);
+    memcpy(name, TLS_SESSION_KEY_PREFIX, len);
+    for (; *key && len < CFSTORE_KEY_NAME_MAX_LENGTH - 1; key++, len++) {
+        name[len] = strchr(acceptable, *key) ? *key : '_';
+    }
+    name[len] = '\0';
+}
+
+int CFStoreTLSSessionCache::read(const char *name, uint8_t **buf, unsigned *size)
+{
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ARM_CFSTORE_FMODE flags;
+    memset(&flags, 0, sizeof(flags));
+    flags.read = 1;
+
+    if (_drv->Open(name, flags, hkey) < ARM_DRIVER_OK) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    int ret = 0;
+    ARM_CFSTORE_SIZE len = 0;
+    if (_drv->GetValueLen(hkey, &len) < ARM_DRIVER_OK || len == 0) {
+        ret = NSAPI_ERROR_DEVICE_ERROR;
+    } else {
+        *buf = new (std::nothrow) uint8_t[len];
+        if (!*buf) {
+            ret = NSAPI_ERROR_NO_MEMORY;
+        } else if (_drv->Read(hkey, *buf, &len) < ARM_DRIVER_OK) {
+            delete[] *buf;
+            *buf = NULL;
+            ret = NSAPI_ERROR_DEVICE_ERROR;
+        } else {
+            *size = len;
+        }
+    }
+
+    _drv->Close(hkey);
+    return ret;
+}
+
+int CFStoreTLSSessionCache::erase(const char *name)
+{
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ARM_CFSTORE_FMODE flags;
+    memset(&flags, 0, sizeof(flags));
+    flags.write = 1;
+
+    if (_drv->Open(name, flags, hkey) < ARM_DRIVER_OK) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    int ret = _drv->Delete(hkey);
+    _drv->Close(hkey);
+    return ret < ARM_DRIVER_OK ? NSAPI_ERROR_DEVICE_ERROR : 0;
+}
+
+int CFStoreTLSSessionCache::get(const char *key, mbedtls_ssl_session *session)
+{
+    if (!_init) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    char name[CFSTORE_KEY_NAME_MAX_LENGTH];
+    key_name(key, name);
+
+    _lock.lock();
+    uint8_t *buf = NULL;
+    unsigned size = 0;
+    int ret = read(name, &buf, &size);
+    if (ret == 0) {
+        ret = load(session, buf, size, _max_age);
+        delete[] buf;
+
+        // expired and corrupt sessions are not worth keeping
+        if (ret == NSAPI_ERROR_PARAMETER && erase(name) == 0) {
+            _drv->Flush();
+        }
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+int CFStoreTLSSessionCache::set(const char *key, const mbedtls_ssl_session *session)
+{
+    if (!_init) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    char name[CFSTORE_KEY_NAME_MAX_LENGTH];
+    key_name(key, name);
+
+    unsigned size = saved_size(session);
+    uint8_t *buf = new (std::nothrow) uint8_t[size];
+    if (!buf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+    save(session, buf);
+
+    _lock.lock();
+
+    // a resumed session that kept its id and ticket is already stored
+    uint8_t *stored = NULL;
+    unsigned stored_size = 0;
+    if (read(name, &stored, &stored_size) == 0) {
+        bool same = saved_equal(stored, stored_size, buf, size);
+        delete[] stored;
+        if (same) {
+            _lock.unlock();
+            delete[] buf;
+            return 0;
+        }
+
+        erase(name);
+    }
+
+    ARM_CFSTORE_KEYDESC kdesc;
+    memset(&kdesc, 0, sizeof(kdesc));
+    kdesc.acl.perm_owner_read = 1;
+    kdesc.acl.perm_owner_write = 1;
+    kdesc.drl = ARM_RETENTION_NVM;
+    kdesc.flags.read = 1;
+    kdesc.flags.write = 1;
+
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    int ret = NSAPI_ERROR_DEVICE_ERROR;
+    if (_drv->Create(name, size, &kdesc, hkey) >= ARM_DRIVER_OK) {
+        ARM_CFSTORE_SIZE len = size;
+        if (_drv->Write(hkey, (const char *)buf, &len) >= ARM_DRIVER_OK && len == size) {
+            ret = 0;
+        }
+        _drv->Close(hkey);
+
+        if (ret != 0) {
+            erase(name);
+        }
+    }
+
+    if (_drv->Flush() < ARM_DRIVER_OK) {
+        ret = NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    _lock.unlock();
+    delete[] buf;
+    return ret;
+}
+
+int CFStoreTLSSessionCache::remove(const char *key)
+{
+    if (!_init) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    char name[CFSTORE_KEY_NAME_MAX_LENGTH];
+    key_name(key, name);
+
+    _lock.lock();
+    int ret = erase(name);
+    if (ret == 0 && _drv->Flush() < ARM_DRIVER_OK) {
+        ret = NSAPI_ERROR_DEVICE_ERROR;
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+#endif
@@ -0,0 +1,80 @@
+/** \addtogroup netsocket */
+/** @{*/
+/* CFStoreTLSSessionCache
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CFSTORETLSSESSIONCACHE_H
+#define CFSTORETLSSESSIONCACHE_H
+
+#include "netsocket/TLSSessionCache.h"
+
+#if defined(MBEDTLS_SSL_CLI_C) && FEATURE_STORAGE
+
+#include "rtos/Mutex.h"
+#include "configuration-store/configuration_store.h"
+
+#ifndef MBED_CONF_NSAPI_TLS_SESSION_MAX_AGE
+#define MBED_CONF_NSAPI_TLS_SESSION_MAX_AGE 86400
+#endif
+
+
+/** TLS session cache in the configuration store
+ *
+ *  Sessions are kept in non-volatile storage, so devices resume their
+ *  sessions after a reset. Each server has one key, named tls.session.
+ *  followed by the server's hostname and port. The store is flushed
+ *  whenever a different session is stored, resumed sessions whose
+ *  session id and ticket are unchanged do not cause any writes.
+ *
+ *  Only the synchronous mode of the configuration store is supported.
+ */
+class CFStoreTLSSessionCache : public TLSSessionCache {
+public:
+    /** Create a session cache
+     *
+     *  Initializes the configuration store, which may already be
+     *  initialized by the application.
+     *
+     *  @param max_age  Maximum age of a stored session in seconds,
+     *                  0 for no limit
+     */
+    CFStoreTLSSessionCache(uint32_t max_age = MBED_CONF_NSAPI_TLS_SESSION_MAX_AGE);
+
+    /** Destroy a session cache
+     */
+    virtual ~CFStoreTLSSessionCache();
+
+    virtual int get(const char *key, mbedtls_ssl_session *session);
+    virtual int set(const char *key, const mbedtls_ssl_session *session);
+    virtual int remove(const char *key);
+
+protected:
+    void key_name(const char *key, char *name);
+    int read(const char *name, uint8_t **buf, unsigned *size);
+    int erase(const char *name);
+
+    ARM_CFSTORE_DRIVER *_drv;
+    bool _init;
+    uint32_t _max_age;
+    rtos::Mutex _lock;
+};
+
+
+#endif
+
+#endif
+
+/** @}*/
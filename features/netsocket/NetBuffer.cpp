@@ -0,0 +1,69 @@
+/* NetBuffer
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NetBuffer.h"
+
+NetBuffer::NetBuffer()
+    : _stack(0), _buf(0), _size(0)
+{
+}
+
+NetBuffer::~NetBuffer()
+{
+    release();
+}
+
+int NetBuffer::alloc(NetworkStack *stack, unsigned size)
+{
+    release();
+
+    nsapi_buf_t buf = stack->buf_alloc(size);
+    if (!buf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    attach(stack, buf, size);
+    return 0;
+}
+
+void NetBuffer::release()
+{
+    if (_buf) {
+        _stack->buf_free(_buf);
+    }
+
+    _stack = 0;
+    _buf = 0;
+    _size = 0;
+}
+
+unsigned NetBuffer::data(unsigned offset, void **data) const
+{
+    if (!_buf) {
+        return 0;
+    }
+
+    return _stack->buf_data(_buf, offset, data);
+}
+
+void NetBuffer::attach(NetworkStack *stack, nsapi_buf_t buf, unsigned size)
+{
+    release();
+
+    _stack = stack;
+    _buf = buf;
+    _size = size;
+}
@@ -0,0 +1,131 @@
+/** \addtogroup netsocket */
+/** @{*/
+/* NetBuffer
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef NETBUFFER_H
+#define NETBUFFER_H
+
+#include "netsocket/nsapi_types.h"
+#include "netsocket/NetworkStack.h"
+
+
+/** Network buffer
+ *
+ *  Memory owned by a network stack that can be sent and received on
+ *  sockets without copying it in and out of the stack. A NetBuffer
+ *  holds at most one stack buffer, which is released when the NetBuffer
+ *  is destroyed or reused.
+ *
+ *  The contents may be split into several contiguous segments, data()
+ *  returns them one at a time. The stack may still reference a buffer
+ *  after it has been sent, so its contents should not be modified once
+ *  it has been passed to a send call.
+ *
+ *  Example:
+ *  @code
+ *  NetBuffer buf;
+ *  if (buf.alloc(&eth, size) == 0) {
+ *      void *data;
+ *      buf.data(0, &data);
+ *      fill_log(data, size);
+ *      socket.send(buf);
+ *  }
+ *  @endcode
+ */
+class NetBuffer {
+public:
+    /** Create an empty network buffer
+     */
+    NetBuffer();
+
+    /** Destroy a network buffer
+     *
+     *  Releases the stack buffer if one is held
+     */
+    ~NetBuffer();
+
+    /** Allocate a stack buffer
+     *
+     *  Any stack buffer already held is released first. A buffer allocated
+     *  on a stack can only be used with sockets of the same stack.
+     *
+     *  @param stack    Network stack as target for the buffer
+     *  @param size     Size of the buffer in bytes
+     *  @return         0 on success, negative error code on failure
+     */
+    int alloc(NetworkStack *stack, unsigned size);
+
+    template <typename S>
+    int alloc(S *stack, unsigned size)
+    {
+        return alloc(nsapi_create_stack(stack), size);
+    }
+
+    /** Release the stack buffer
+     *
+     *  The NetBuffer is left empty. Releasing an empty NetBuffer does
+     *  nothing.
+     */
+    void release();
+
+    /** Get the contiguous data at an offset
+     *
+     *  @param offset   Offset in bytes from the start of the buffer
+     *  @param data     Destination for a pointer to the data at offset
+     *  @return         Number of contiguous bytes at offset, 0 past the end
+     *                  of the buffer or if the NetBuffer is empty
+     */
+    unsigned data(unsigned offset, void **data) const;
+
+    /** Size of the buffer in bytes
+     *
+     *  @return         Size of the buffer, 0 if the NetBuffer is empty
+     */
+    unsigned size() const
+    {
+        return _size;
+    }
+
+    /** Check if the NetBuffer holds a stack buffer
+     *
+     *  @return         True if the NetBuffer is empty
+     */
+    bool empty() const
+    {
+        return !_buf;
+    }
+
+protected:
+    friend class TCPSocket;
+    friend class UDPSocket;
+
+    void attach(NetworkStack *stack, nsapi_buf_t buf, unsigned size);
+
+    NetworkStack *_stack;
+    nsapi_buf_t _buf;
+    unsigned _size;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    NetBuffer(const NetBuffer &);
+    NetBuffer &operator=(const NetBuffer &);
+};
+
+
+#endif
+
+/** @}*/
@@ -54,6 +54,24 @@ int NetworkInterface::set_dhcp(bool dhcp)
     }
 }
 
+int NetworkInterface::set_blocking(bool blocking)
+{
+    if (!blocking) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    } else {
+        return 0;
+    }
+}
+
+void NetworkInterface::attach(nsapi_status_callback_t status_cb)
+{
+}
+
+nsapi_connection_status_t NetworkInterface::get_connection_status() const
+{
+    return NSAPI_STATUS_ERROR_UNSUPPORTED;
+}
+
 // DNS operations go through the underlying stack by default
 int NetworkInterface::gethostbyname(const char *name, SocketAddress *address)
 {
@@ -65,8 +83,18 @@ int NetworkInterface::gethostbyname(const char *name, SocketAddress *address, ns
     return get_stack()->gethostbyname(name, address, version);
 }
 
+int NetworkInterface::gethostbyname_async(const char *name, nsapi_dns_callback_t callback, nsapi_version_t version)
+{
+    return get_stack()->gethostbyname_async(name, callback, version);
+}
+
 int NetworkInterface::add_dns_server(const SocketAddress &address)
 {
     return get_stack()->add_dns_server(address);
 }
 
+int NetworkInterface::get_stats(nsapi_stack_stats_t *stats)
+{
+    return get_stack()->get_stats(stats);
+}
+
@@ -22,10 +22,24 @@
 
 #include "netsocket/nsapi_types.h"
 #include "netsocket/SocketAddress.h"
+#include "platform/Callback.h"
 
 // Predeclared class
 class NetworkStack;
 
+/** Callback for the result of an asynchronous hostname translation
+ *
+ *  @param result   0 on success, negative error code on failure
+ *  @param address  Resolved address on success, NULL on failure
+ */
+typedef mbed::Callback<void (nsapi_error_t result, SocketAddress *address)> nsapi_dns_callback_t;
+
+/** Callback for changes of the connection status of an interface
+ *
+ *  @param status   The new connection status
+ */
+typedef mbed::Callback<void (nsapi_connection_status_t status)> nsapi_status_callback_t;
+
 
 /** NetworkInterface class
  *
@@ -91,6 +105,34 @@ public:
      */
     virtual int set_dhcp(bool dhcp);
 
+    /** Set blocking or non-blocking mode of connect
+     *
+     *  In non-blocking mode, connect starts bringing up the interface
+     *  and returns at once, the result is reported through the status
+     *  callback. Defaults to blocking.
+     *
+     *  @param blocking True for blocking mode, false for non-blocking mode
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int set_blocking(bool blocking);
+
+    /** Register a callback for changes of the connection status
+     *
+     *  The callback may be called from the interrupt or the thread of the
+     *  underlying stack, and must not block.
+     *
+     *  @param status_cb    Callback called with the new status, or null
+     *                      to remove the callback
+     */
+    virtual void attach(nsapi_status_callback_t status_cb);
+
+    /** Get the connection status
+     *
+     *  @return     The connection status, NSAPI_STATUS_ERROR_UNSUPPORTED
+     *              if the interface does not track it
+     */
+    virtual nsapi_connection_status_t get_connection_status() const;
+
     /** Start the interface
      *
      *  @return     0 on success, negative error code on failure
@@ -132,6 +174,21 @@ public:
      */
     virtual int gethostbyname(const char *host, SocketAddress *address, nsapi_version_t version);
 
+    /** Translates a hostname to an IP address without blocking
+     *
+     *  The translation runs in the background and the callback is called
+     *  from the resolver's thread once it completes.
+     *
+     *  @param host     Hostname to resolve
+     *  @param callback Callback called with the result of the translation
+     *  @param version  IP version of address to resolve, NSAPI_UNSPEC
+     *                  accepts any version (defaults to NSAPI_UNSPEC)
+     *  @return         0 if the translation was started, negative error
+     *                  code on failure
+     */
+    virtual int gethostbyname_async(const char *host, nsapi_dns_callback_t callback,
+            nsapi_version_t version = NSAPI_UNSPEC);
+
     /** Add a domain name server to list of servers to query
      *
      *  @param addr     Destination for the host address
@@ -139,6 +196,15 @@ public:
      */
     virtual int add_dns_server(const SocketAddress &address);
 
+    /** Get the traffic and memory counters of the interface
+     *
+     *  Counters the underlying stack does not keep are left as zero.
+     *
+     *  @param stats    Destination for the counters
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int get_stats(nsapi_stack_stats_t *stats);
+
 protected:
     friend class Socket;
     friend class UDPSocket;
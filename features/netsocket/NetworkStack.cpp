@@ -46,6 +46,11 @@ int NetworkStack::gethostbyname(const char *name, SocketAddress *address, nsapi_
     return nsapi_dns_query(this, name, address, version);
 }
 
+int NetworkStack::gethostbyname_async(const char *name, nsapi_dns_callback_t callback, nsapi_version_t version)
+{
+    return nsapi_dns_query_async(this, name, callback, version);
+}
+
 int NetworkStack::add_dns_server(const SocketAddress &address)
 {
     return nsapi_dns_add_server(address);
@@ -61,6 +66,11 @@ int NetworkStack::getstackopt(int level, int optname, void *optval, unsigned *op
     return NSAPI_ERROR_UNSUPPORTED;
 }
 
+int NetworkStack::get_stats(nsapi_stack_stats_t *stats)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
 int NetworkStack::setsockopt(void *handle, int level, int optname, const void *optval, unsigned optlen)
 {
     return NSAPI_ERROR_UNSUPPORTED;
@@ -71,6 +81,196 @@ int NetworkStack::getsockopt(void *handle, int level, int optname, void *optval,
     return NSAPI_ERROR_UNSUPPORTED;
 }
 
+nsapi_buf_t NetworkStack::buf_alloc(unsigned size)
+{
+    return 0;
+}
+
+void NetworkStack::buf_free(nsapi_buf_t buf)
+{
+}
+
+unsigned NetworkStack::buf_data(nsapi_buf_t buf, unsigned offset, void **data)
+{
+    return 0;
+}
+
+int NetworkStack::socket_send_buf(nsapi_socket_t handle, nsapi_buf_t buf, unsigned offset)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+int NetworkStack::socket_recv_buf(nsapi_socket_t handle, nsapi_buf_t *buf)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+int NetworkStack::socket_sendto_buf(nsapi_socket_t handle, const SocketAddress &address, nsapi_buf_t buf)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+int NetworkStack::socket_recvfrom_buf(nsapi_socket_t handle, SocketAddress *address, nsapi_buf_t *buf)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+static unsigned nsapi_iov_size(const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    unsigned size = 0;
+    for (unsigned i = 0; i < iovcnt; i++) {
+        size += iov[i].size;
+    }
+
+    return size;
+}
+
+int NetworkStack::socket_sendmsg(nsapi_socket_t handle, const SocketAddress *address,
+        const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    if (!address) {
+        // a stream can be sent one buffer at a time
+        int sent = 0;
+        for (unsigned i = 0; i < iovcnt; i++) {
+            int ret = socket_send(handle, iov[i].data, iov[i].size);
+            if (ret < 0) {
+                return sent ? sent : ret;
+            }
+
+            sent += ret;
+            if ((unsigned)ret < iov[i].size) {
+                break;
+            }
+        }
+
+        return sent;
+    }
+
+    // a packet has to be gathered into a single buffer
+    unsigned size = nsapi_iov_size(iov, iovcnt);
+    uint8_t *buffer = (uint8_t*)malloc(size ? size : 1);
+    if (!buffer) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    unsigned offset = 0;
+    for (unsigned i = 0; i < iovcnt; i++) {
+        memcpy(&buffer[offset], iov[i].data, iov[i].size);
+        offset += iov[i].size;
+    }
+
+    int ret = socket_sendto(handle, *address, buffer, size);
+    free(buffer);
+    return ret;
+}
+
+int NetworkStack::socket_recvmsg(nsapi_socket_t handle, SocketAddress *address,
+        const nsapi_iovec_t *iov, unsigned iovcnt, int *flags)
+{
+    if (!address) {
+        // a stream can be received one buffer at a time
+        int recv = 0;
+        for (unsigned i = 0; i < iovcnt; i++) {
+            int ret = socket_recv(handle, iov[i].data, iov[i].size);
+            if (ret < 0) {
+                return recv ? recv : ret;
+            }
+
+            recv += ret;
+            if ((unsigned)ret < iov[i].size) {
+                break;
+            }
+        }
+
+        return recv;
+    }
+
+    // a packet has to be received into a single buffer, one byte larger
+    // than the destination buffers so truncation can be detected
+    unsigned size = nsapi_iov_size(iov, iovcnt);
+    uint8_t *buffer = (uint8_t*)malloc(size + 1);
+    if (!buffer) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    int ret = socket_recvfrom(handle, address, buffer, size + 1);
+    if (ret < 0) {
+        free(buffer);
+        return ret;
+    }
+
+    *flags = 0;
+    if ((unsigned)ret > size) {
+        *flags |= NSAPI_MSG_TRUNC;
+        ret = size;
+    }
+
+    unsigned offset = 0;
+    for (unsigned i = 0; i < iovcnt && offset < (unsigned)ret; i++) {
+        unsigned len = iov[i].size;
+        if (len > (unsigned)ret - offset) {
+            len = (unsigned)ret - offset;
+        }
+
+        memcpy(iov[i].data, &buffer[offset], len);
+        offset += len;
+    }
+
+    free(buffer);
+    return ret;
+}
+
+int NetworkStack::socket_sendmmsg(nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count)
+{
+    for (unsigned i = 0; i < count; i++) {
+        int ret = socket_sendto(handle, SocketAddress(msgs[i].addr, msgs[i].port),
+                msgs[i].data, msgs[i].size);
+        if (ret < 0) {
+            return i ? (int)i : ret;
+        }
+
+        msgs[i].len = ret;
+    }
+
+    return count;
+}
+
+int NetworkStack::socket_recvmmsg(nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count)
+{
+    for (unsigned i = 0; i < count; i++) {
+        SocketAddress address;
+        nsapi_iovec_t iov = {msgs[i].data, msgs[i].size};
+        int flags = 0;
+
+        int ret = socket_recvmsg(handle, &address, &iov, 1, &flags);
+        if (ret < 0) {
+            return i ? (int)i : ret;
+        }
+
+        msgs[i].addr = address.get_addr();
+        msgs[i].port = address.get_port();
+        msgs[i].len = ret;
+        msgs[i].flags = flags;
+    }
+
+    return count;
+}
+
+int NetworkStack::socket_send_static(nsapi_socket_t handle, const void *data, unsigned size)
+{
+    return socket_send(handle, data, size);
+}
+
+int NetworkStack::socket_poll(nsapi_socket_t handle)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
+int NetworkStack::socket_get_stats(nsapi_socket_t handle, nsapi_socket_stats_t *stats)
+{
+    return NSAPI_ERROR_UNSUPPORTED;
+}
+
 
 // NetworkStackWrapper class for encapsulating the raw nsapi_stack structure
 class NetworkStackWrapper : public NetworkStack
@@ -151,6 +351,15 @@ public:
         return _stack_api()->getstackopt(_stack(), level, optname, optval, optlen);
     }
 
+    virtual int get_stats(nsapi_stack_stats_t *stats)
+    {
+        if (!_stack_api()->get_stats) {
+            return NSAPI_ERROR_UNSUPPORTED;
+        }
+
+        return _stack_api()->get_stats(_stack(), stats);
+    }
+
 protected:
     virtual int socket_open(nsapi_socket_t *socket, nsapi_protocol_t proto)
     {
@@ -288,6 +497,161 @@ protected:
 
         return _stack_api()->getsockopt(_stack(), socket, level, optname, optval, optlen);
     }
+
+    virtual nsapi_buf_t buf_alloc(unsigned size)
+    {
+        if (!_stack_api()->buf_alloc) {
+            return 0;
+        }
+
+        return _stack_api()->buf_alloc(_stack(), size);
+    }
+
+    virtual void buf_free(nsapi_buf_t buf)
+    {
+        if (!_stack_api()->buf_free) {
+            return;
+        }
+
+        return _stack_api()->buf_free(_stack(), buf);
+    }
+
+    virtual unsigned buf_data(nsapi_buf_t buf, unsigned offset, void **data)
+    {
+        if (!_stack_api()->buf_data) {
+            return 0;
+        }
+
+        return _stack_api()->buf_data(_stack(), buf, offset, data);
+    }
+
+    virtual int socket_send_buf(nsapi_socket_t socket, nsapi_buf_t buf, unsigned offset)
+    {
+        if (!_stack_api()->socket_send_buf) {
+            return NSAPI_ERROR_UNSUPPORTED;
+        }
+
+        return _stack_api()->socket_send_buf(_stack(), socket, buf, offset);
+    }
+
+    virtual int socket_recv_buf(nsapi_socket_t socket, nsapi_buf_t *buf)
+    {
+        if (!_stack_api()->socket_recv_buf) {
+            return NSAPI_ERROR_UNSUPPORTED;
+        }
+
+        return _stack_api()->socket_recv_buf(_stack(), socket, buf);
+    }
+
+    virtual int socket_sendto_buf(nsapi_socket_t socket, const SocketAddress &address, nsapi_buf_t buf)
+    {
+        if (!_stack_api()->socket_sendto_buf) {
+            return NSAPI_ERROR_UNSUPPORTED;
+        }
+
+        return _stack_api()->socket_sendto_buf(_stack(), socket, address.get_addr(), address.get_port(), buf);
+    }
+
+    virtual int socket_recvfrom_buf(nsapi_socket_t socket, SocketAddress *address, nsapi_buf_t *buf)
+    {
+        if (!_stack_api()->socket_recvfrom_buf) {
+            return NSAPI_ERROR_UNSUPPORTED;
+        }
+
+        nsapi_addr_t addr = {NSAPI_IPv4, 0};
+        uint16_t port = 0;
+
+        int err = _stack_api()->socket_recvfrom_buf(_stack(), socket, &addr, &port, buf);
+
+        if (address) {
+            address->set_addr(addr);
+            address->set_port(port);
+        }
+
+        return err;
+    }
+
+    virtual int socket_sendmsg(nsapi_socket_t socket, const SocketAddress *address,
+            const nsapi_iovec_t *iov, unsigned iovcnt)
+    {
+        if (!_stack_api()->socket_sendmsg) {
+            return NetworkStack::socket_sendmsg(socket, address, iov, iovcnt);
+        }
+
+        if (!address) {
+            return _stack_api()->socket_sendmsg(_stack(), socket, 0, 0, iov, iovcnt);
+        }
+
+        nsapi_addr_t addr = address->get_addr();
+        return _stack_api()->socket_sendmsg(_stack(), socket, &addr, address->get_port(), iov, iovcnt);
+    }
+
+    virtual int socket_recvmsg(nsapi_socket_t socket, SocketAddress *address,
+            const nsapi_iovec_t *iov, unsigned iovcnt, int *flags)
+    {
+        if (!_stack_api()->socket_recvmsg) {
+            return NetworkStack::socket_recvmsg(socket, address, iov, iovcnt, flags);
+        }
+
+        if (!address) {
+            return _stack_api()->socket_recvmsg(_stack(), socket, 0, 0, iov, iovcnt, flags);
+        }
+
+        nsapi_addr_t addr = {NSAPI_IPv4, 0};
+        uint16_t port = 0;
+
+        int err = _stack_api()->socket_recvmsg(_stack(), socket, &addr, &port, iov, iovcnt, flags);
+
+        address->set_addr(addr);
+        address->set_port(port);
+
+        return err;
+    }
+
+    virtual int socket_sendmmsg(nsapi_socket_t socket, nsapi_mmsg_t *msgs, unsigned count)
+    {
+        if (!_stack_api()->socket_sendmmsg) {
+            return NetworkStack::socket_sendmmsg(socket, msgs, count);
+        }
+
+        return _stack_api()->socket_sendmmsg(_stack(), socket, msgs, count);
+    }
+
+    virtual int socket_recvmmsg(nsapi_socket_t socket, nsapi_mmsg_t *msgs, unsigned count)
+    {
+        if (!_stack_api()->socket_recvmmsg) {
+            return NetworkStack::socket_recvmmsg(socket, msgs, count);
+        }
+
+        return _stack_api()->socket_recvmmsg(_stack(), socket, msgs, count);
+    }
+
+    virtual int socket_send_static(nsapi_socket_t socket, const void *data, unsigned size)
+    {
+        if (!_stack_api()->socket_send_static) {
+            return NetworkStack::socket_send_static(socket, data, size);
+        }
+
+        return _stack_api()->socket_send_static(_stack(), socket, data, size);
+    }
+
+    virtual int socket_poll(nsapi_socket_t socket)
+    {
+        if (!_stack_api()->socket_poll) {
+            return NSAPI_ERROR_UNSUPPORTED;
+        }
+
+        return _stack_api()->socket_poll(_stack(), socket);
+    }
+
+    virtual int socket_get_stats(nsapi_socket_t socket, nsapi_socket_stats_t *stats)
+    {
+        if (!_stack_api()->socket_get_stats) {
+            return NSAPI_ERROR_UNSUPPORTED;
+        }
+
+        return _stack_api()->socket_get_stats(_stack(), socket, stats);
+    }
 };
 
 
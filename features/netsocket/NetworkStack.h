@@ -73,6 +73,22 @@ public:
      */
     virtual int gethostbyname(const char *host, SocketAddress *address, nsapi_version_t version);
 
+    /** Translates a hostname to an IP address without blocking
+     *
+     *  The translation runs in the background and the callback is called
+     *  from the resolver's thread once it completes. By default the
+     *  translation uses gethostbyname on a shared resolver thread.
+     *
+     *  @param host     Hostname to resolve
+     *  @param callback Callback called with the result of the translation
+     *  @param version  IP version of address to resolve, NSAPI_UNSPEC
+     *                  accepts any version (defaults to NSAPI_UNSPEC)
+     *  @return         0 if the translation was started, negative error
+     *                  code on failure
+     */
+    virtual int gethostbyname_async(const char *host, nsapi_dns_callback_t callback,
+            nsapi_version_t version = NSAPI_UNSPEC);
+
     /** Add a domain name server to list of servers to query
      *
      *  @param addr     Destination for the host address
@@ -108,11 +124,25 @@ public:
      */
     virtual int getstackopt(int level, int optname, void *optval, unsigned *optlen);
 
+    /** Get the counters of the stack
+     *
+     *  Reports traffic, drop and memory counters since the stack was
+     *  started. Counters the stack does not keep are left as zero.
+     *
+     *  By default NSAPI_ERROR_UNSUPPORTED is returned.
+     *
+     *  @param stats    Destination for the counters
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int get_stats(nsapi_stack_stats_t *stats);
+
 protected:
     friend class Socket;
     friend class UDPSocket;
     friend class TCPSocket;
     friend class TCPServer;
+    friend class NetBuffer;
+    friend class SocketPoll;
 
     /** Opens a socket
      *
@@ -302,6 +332,218 @@ protected:
      *  @return         0 on success, negative error code on failure
      */
     virtual int getsockopt(nsapi_socket_t handle, int level, int optname, void *optval, unsigned *optlen);
+
+    /** Allocate a network buffer
+     *
+     *  Stacks that do not support network buffers return null.
+     *
+     *  @param size     Size of the buffer in bytes
+     *  @return         Handle to the buffer, or null on failure
+     */
+    virtual nsapi_buf_t buf_alloc(unsigned size);
+
+    /** Free a network buffer
+     *
+     *  @param buf      Buffer handle
+     */
+    virtual void buf_free(nsapi_buf_t buf);
+
+    /** Get the contiguous data of a network buffer at an offset
+     *
+     *  @param buf      Buffer handle
+     *  @param offset   Offset in bytes from the start of the buffer
+     *  @param data     Destination for a pointer to the data at offset
+     *  @return         Number of contiguous bytes at offset, 0 past the end
+     *                  of the buffer
+     */
+    virtual unsigned buf_data(nsapi_buf_t buf, unsigned offset, void **data);
+
+    /** Send a network buffer over a TCP socket
+     *
+     *  Sends the buffer contents starting at offset without copying them
+     *  into an intermediate buffer.
+     *
+     *  This call is non-blocking. If send would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param buf      Buffer handle, still owned by the caller afterwards
+     *  @param offset   Offset in bytes of the first byte to send
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_send_buf(nsapi_socket_t handle, nsapi_buf_t buf, unsigned offset);
+
+    /** Receive a network buffer over a TCP socket
+     *
+     *  Hands over the stack's own receive buffer instead of copying it.
+     *
+     *  This call is non-blocking. If recv would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param buf      Destination for the received buffer, owned by the
+     *                  caller on success
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_recv_buf(nsapi_socket_t handle, nsapi_buf_t *buf);
+
+    /** Send a network buffer as a packet over a UDP socket
+     *
+     *  This call is non-blocking. If sendto would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host
+     *  @param buf      Buffer handle, still owned by the caller afterwards
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_sendto_buf(nsapi_socket_t handle, const SocketAddress &address, nsapi_buf_t buf);
+
+    /** Receive a packet as a network buffer over a UDP socket
+     *
+     *  This call is non-blocking. If recvfrom would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address or NULL
+     *  @param buf      Destination for the received buffer, owned by the
+     *                  caller on success
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_recvfrom_buf(nsapi_socket_t handle, SocketAddress *address, nsapi_buf_t *buf);
+
+    /** Send data gathered from several buffers over a socket
+     *
+     *  With a null address the buffers are sent in order over a connected
+     *  TCP socket. Otherwise they are sent as a single packet over a UDP
+     *  socket to the specified address.
+     *
+     *  By default the buffers are sent one at a time over TCP, and copied
+     *  into a temporary buffer for UDP.
+     *
+     *  This call is non-blocking. If sendmsg would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  The SocketAddress of the remote host, null for TCP
+     *  @param iov      Array of buffers to send
+     *  @param iovcnt   Number of buffers in the array
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_sendmsg(nsapi_socket_t handle, const SocketAddress *address,
+            const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive data scattered into several buffers over a socket
+     *
+     *  With a null address data is received over a connected TCP socket and
+     *  flags is left untouched. Otherwise a single packet is received over
+     *  a UDP socket, its source is stored in address, and NSAPI_MSG_TRUNC
+     *  is set in flags if it did not fit in the buffers.
+     *
+     *  By default the buffers are filled one at a time over TCP, and UDP
+     *  packets are received into a temporary buffer.
+     *
+     *  This call is non-blocking. If recvmsg would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param address  Destination for the source address, null for TCP
+     *  @param iov      Array of buffers to receive into
+     *  @param iovcnt   Number of buffers in the array
+     *  @param flags    Destination for the message flags
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_recvmsg(nsapi_socket_t handle, SocketAddress *address,
+            const nsapi_iovec_t *iov, unsigned iovcnt, int *flags);
+
+    /** Send several packets over a UDP socket
+     *
+     *  The packets are sent in order, each to its own address, until one
+     *  would block or fails. The len of each packet sent is set.
+     *
+     *  By default the packets are sent one at a time with socket_sendto.
+     *
+     *  This call is non-blocking. If no packet can be sent,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param msgs     Array of packets to send
+     *  @param count    Number of packets in the array
+     *  @return         Number of sent packets on success, negative error
+     *                  code if none was sent
+     */
+    virtual int socket_sendmmsg(nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count);
+
+    /** Receive several packets over a UDP socket
+     *
+     *  The packets already queued on the socket are received into the
+     *  buffers in order, storing the source, len and flags of each, until
+     *  none is left or the array is full.
+     *
+     *  By default the packets are received one at a time with
+     *  socket_recvmsg.
+     *
+     *  This call is non-blocking. If no packet is queued,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param msgs     Array of packets to receive into
+     *  @param count    Number of packets in the array
+     *  @return         Number of received packets on success, negative
+     *                  error code if none was received
+     */
+    virtual int socket_recvmmsg(nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count);
+
+    /** Send data that never changes over a TCP socket
+     *
+     *  The data must stay valid and unchanged for as long as the stack
+     *  runs, such as constant data in flash, so that the stack can send
+     *  it from where it is instead of copying it.
+     *
+     *  By default the data is sent with socket_send.
+     *
+     *  This call is non-blocking. If send would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param handle   Socket handle
+     *  @param data     Buffer of data to send
+     *  @param size     Size of the buffer in bytes
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    virtual int socket_send_static(nsapi_socket_t handle, const void *data, unsigned size);
+
+    /** Check the readiness of a socket
+     *
+     *  Reports which operations can currently complete without blocking.
+     *  Changes in readiness are signalled through the callback registered
+     *  with socket_attach. A readiness may be reported spuriously, but a
+     *  ready socket must not be reported as not ready.
+     *
+     *  By default NSAPI_ERROR_UNSUPPORTED is returned, and the socket is
+     *  treated as ready whenever its callback fires.
+     *
+     *  @param handle   Socket handle
+     *  @return         Mask of nsapi_poll_event_t flags on success, negative
+     *                  error code on failure
+     */
+    virtual int socket_poll(nsapi_socket_t handle);
+
+    /** Get the counters and transport state of a socket
+     *
+     *  By default NSAPI_ERROR_UNSUPPORTED is returned.
+     *
+     *  @param handle   Socket handle
+     *  @param stats    Destination for the counters
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int socket_get_stats(nsapi_socket_t handle, nsapi_socket_stats_t *stats);
 };
 
 
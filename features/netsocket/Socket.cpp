@@ -15,15 +15,27 @@
  */
 
 #include "Socket.h"
+#include "SocketPoll.h"
+#include "platform/mbed_poll.h"
 #include "mbed.h"
 
 Socket::Socket()
     : _stack(0)
     , _socket(0)
     , _timeout(osWaitForever)
+    , _poll(0)
+    , _poll_events(0)
+    , _poll_signalled(false)
 {
 }
 
+Socket::~Socket()
+{
+    if (_poll) {
+        _poll->remove(this);
+    }
+}
+
 int Socket::open(NetworkStack *stack)
 {
     _lock.lock();
@@ -42,7 +54,7 @@ int Socket::open(NetworkStack *stack)
     }
 
     _socket = socket;
-    _event.attach(this, &Socket::event);
+    _event.attach(this, &Socket::wakeup);
     _stack->socket_attach(_socket, Callback<void()>::thunk, &_event);
 
     _lock.unlock();
@@ -63,7 +75,7 @@ int Socket::close()
 
     // Wakeup anything in a blocking operation
     // on this socket
-    event();
+    wakeup();
 
     _lock.unlock();
     return ret;
@@ -148,6 +160,21 @@ int Socket::getsockopt(int level, int optname, void *optval, unsigned *optlen)
 
 }
 
+int Socket::get_stats(nsapi_socket_stats_t *stats)
+{
+    _lock.lock();
+    int ret;
+
+    if (!_socket) {
+        ret = NSAPI_ERROR_NO_SOCKET;
+    } else {
+        ret = _stack->socket_get_stats(_socket, stats);
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
 void Socket::attach(Callback<void()> callback)
 {
     _lock.lock();
@@ -156,3 +183,21 @@ void Socket::attach(Callback<void()> callback)
 
     _lock.unlock();
 }
+
+void Socket::wakeup()
+{
+    event();
+
+    // let a poll waiting on this socket recheck it, signalled within the
+    // critical section so that the poll cannot be removed or destroyed
+    // in between
+    core_util_critical_section_enter();
+    _poll_signalled = true;
+    if (_poll) {
+        _poll->signal();
+    }
+    core_util_critical_section_exit();
+
+    // and threads in mbed::poll() servicing sockets along with devices
+    mbed::poll_wake();
+}
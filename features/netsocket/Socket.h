@@ -26,6 +26,9 @@
 #include "Callback.h"
 #include "toolchain.h"
 
+// Predeclared class
+class SocketPoll;
+
 
 /** Abstract socket class
  */
@@ -35,7 +38,7 @@ public:
      *
      *  Closes socket if the socket is still open
      */
-    virtual ~Socket() {}
+    virtual ~Socket();
 
     /** Opens a socket
      *
@@ -148,6 +151,17 @@ public:
      */    
     int getsockopt(int level, int optname, void *optval, unsigned *optlen);
 
+    /** Get the counters and transport state of the socket
+     *
+     *  Reports the bytes passed through the socket and, for TCP, the
+     *  stack's round trip and congestion estimates. Values the stack does
+     *  not keep are left as zero.
+     *
+     *  @param stats    Destination for the counters
+     *  @return         0 on success, negative error code on failure
+     */
+    int get_stats(nsapi_socket_stats_t *stats);
+
     /** Register a callback on state change of the socket
      *
      *  The specified callback will be called on state changes such as when
@@ -186,9 +200,12 @@ public:
     }
 
 protected:
+    friend class SocketPoll;
+
     Socket();
     virtual nsapi_protocol_t get_proto() = 0;
     virtual void event() = 0;
+    void wakeup();
 
     NetworkStack *_stack;
     nsapi_socket_t _socket;
@@ -196,6 +213,9 @@ protected:
     mbed::Callback<void()> _event;
     mbed::Callback<void()> _callback;
     rtos::Mutex _lock;
+    SocketPoll *_poll;
+    int _poll_events;
+    volatile bool _poll_signalled;
 };
 
 
@@ -0,0 +1,190 @@
+/* SocketPoll
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SocketPoll.h"
+#include "Timer.h"
+#include "critical.h"
+
+SocketPoll::SocketPoll(unsigned size)
+    : _sockets(new Socket*[size]), _size(size), _count(0), _next(0), _sem(0)
+{
+}
+
+SocketPoll::~SocketPoll()
+{
+    _lock.lock();
+
+    for (unsigned i = 0; i < _count; i++) {
+        core_util_critical_section_enter();
+        _sockets[i]->_poll = 0;
+        core_util_critical_section_exit();
+    }
+
+    _count = 0;
+    _lock.unlock();
+
+    delete[] _sockets;
+}
+
+int SocketPoll::add(Socket *socket, int events)
+{
+    _lock.lock();
+
+    if (socket->_poll == this) {
+        socket->_poll_events = events;
+        _lock.unlock();
+        _sem.release();
+        return 0;
+    }
+
+    if (socket->_poll) {
+        _lock.unlock();
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    if (_count >= _size) {
+        _lock.unlock();
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    _sockets[_count] = socket;
+    _count += 1;
+
+    // start out signalled so stacks without socket_poll get a first look
+    socket->_poll_events = events;
+    core_util_critical_section_enter();
+    socket->_poll_signalled = true;
+    socket->_poll = this;
+    core_util_critical_section_exit();
+
+    _lock.unlock();
+    _sem.release();
+    return 0;
+}
+
+int SocketPoll::remove(Socket *socket)
+{
+    _lock.lock();
+
+    for (unsigned i = 0; i < _count; i++) {
+        if (_sockets[i] == socket) {
+            core_util_critical_section_enter();
+            socket->_poll = 0;
+            core_util_critical_section_exit();
+
+            _count -= 1;
+            _sockets[i] = _sockets[_count];
+            if (_next >= _count) {
+                _next = 0;
+            }
+
+            _lock.unlock();
+            return 0;
+        }
+    }
+
+    _lock.unlock();
+    return NSAPI_ERROR_PARAMETER;
+}
+
+int SocketPoll::wait(socket_poll_event_t *ready, unsigned count, int timeout)
+{
+    mbed::Timer timer;
+    timer.start();
+
+    _lock.lock();
+
+    while (true) {
+        // consume pending wakeups first, the checks below see every
+        // change they announced
+        while (_sem.wait(0) > 0);
+
+        unsigned found = 0;
+        unsigned last = 0;
+        for (unsigned i = 0; i < _count && found < count; i++) {
+            unsigned j = (_next + i) % _count;
+            int revents = check(_sockets[j]);
+            if (revents) {
+                ready[found].socket = _sockets[j];
+                ready[found].revents = revents;
+                found += 1;
+                last = j;
+            }
+        }
+
+        if (found) {
+            _next = (last + 1) % _count;
+            _lock.unlock();
+            return found;
+        }
+
+        uint32_t wait = osWaitForever;
+        if (timeout >= 0) {
+            int remaining = timeout - timer.read_ms();
+            if (remaining <= 0) {
+                break;
+            }
+
+            wait = remaining;
+        }
+
+        // Release lock before blocking so sockets can be added and
+        // removed while waiting
+        _lock.unlock();
+        int32_t tokens = _sem.wait(wait);
+        _lock.lock();
+
+        if (tokens < 1) {
+            break;
+        }
+    }
+
+    _lock.unlock();
+    return 0;
+}
+
+void SocketPoll::signal()
+{
+    _sem.release();
+}
+
+int SocketPoll::check(Socket *socket)
+{
+    socket->_lock.lock();
+
+    int revents;
+    if (!socket->_socket) {
+        revents = NSAPI_POLLNVAL;
+    } else {
+        revents = socket->_stack->socket_poll(socket->_socket);
+
+        core_util_critical_section_enter();
+        bool signalled = socket->_poll_signalled;
+        socket->_poll_signalled = false;
+        core_util_critical_section_exit();
+
+        if (revents == NSAPI_ERROR_UNSUPPORTED) {
+            revents = signalled ? socket->_poll_events : 0;
+        } else if (revents < 0) {
+            revents = NSAPI_POLLERR;
+        }
+    }
+
+    revents &= socket->_poll_events | NSAPI_POLLERR | NSAPI_POLLNVAL;
+
+    socket->_lock.unlock();
+    return revents;
+}
@@ -0,0 +1,129 @@
+/** \addtogroup netsocket */
+/** @{*/
+/* SocketPoll
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOCKET_POLL_H
+#define SOCKET_POLL_H
+
+#include "netsocket/Socket.h"
+#include "rtos/Mutex.h"
+#include "rtos/Semaphore.h"
+
+
+/** Socket reported ready by SocketPoll::wait
+ */
+struct socket_poll_event_t {
+    Socket *socket; /**< Ready socket */
+    int revents;    /**< Mask of nsapi_poll_event_t flags the socket is ready for */
+};
+
+/** Socket event multiplexer
+ *
+ *  Lets a single thread wait until any of a set of sockets can send,
+ *  receive or accept without blocking, instead of dedicating a thread to
+ *  each socket.
+ *
+ *  A socket can belong to only one SocketPoll at a time, and leaves it
+ *  when it is destroyed. Sockets are open and operated as usual, polling
+ *  does not change their blocking mode.
+ *
+ *  On stacks that can not report the readiness of their sockets, a socket
+ *  is reported ready for all its events once each time the stack signals
+ *  a change on it.
+ *
+ *  Example:
+ *  @code
+ *  SocketPoll poll(4);
+ *  poll.add(&server, NSAPI_POLLIN);
+ *
+ *  socket_poll_event_t ready[4];
+ *  int count = poll.wait(ready, 4);
+ *  for (int i = 0; i < count; i++) {
+ *      handle(ready[i].socket, ready[i].revents);
+ *  }
+ *  @endcode
+ */
+class SocketPoll {
+public:
+    /** Create a SocketPoll
+     *
+     *  @param size     Maximum number of sockets in the poll
+     */
+    SocketPoll(unsigned size);
+
+    /** Destroy a SocketPoll
+     *
+     *  Removes all the sockets from the poll
+     */
+    ~SocketPoll();
+
+    /** Add a socket to the poll
+     *
+     *  If the socket is already in the poll its events are replaced.
+     *
+     *  @param socket   Socket to poll
+     *  @param events   Mask of nsapi_poll_event_t flags to wait for,
+     *                  NSAPI_POLLERR and NSAPI_POLLNVAL are always reported
+     *  @return         0 on success, negative error code on failure
+     */
+    int add(Socket *socket, int events);
+
+    /** Remove a socket from the poll
+     *
+     *  @param socket   Socket to remove
+     *  @return         0 on success, negative error code on failure
+     */
+    int remove(Socket *socket);
+
+    /** Wait for sockets to become ready
+     *
+     *  Blocks until at least one socket is ready or the timeout expires.
+     *  When more sockets are ready than fit in the array, the following
+     *  wait starts after the last socket reported, so every ready socket
+     *  gets its turn.
+     *
+     *  @param ready    Destination for the ready sockets
+     *  @param count    Number of entries in the array
+     *  @param timeout  Timeout in milliseconds, 0 checks the sockets without
+     *                  blocking and a negative value waits forever
+     *                  (defaults to -1)
+     *  @return         Number of ready sockets stored, 0 on timeout
+     */
+    int wait(socket_poll_event_t *ready, unsigned count, int timeout = -1);
+
+private:
+    friend class Socket;
+
+    void signal();
+    int check(Socket *socket);
+
+    Socket **_sockets;
+    unsigned _size;
+    unsigned _count;
+    unsigned _next;
+    rtos::Semaphore _sem;
+    rtos::Mutex _lock;
+
+    /* disallow copy constructor and assignment operators */
+    SocketPoll(const SocketPoll &);
+    SocketPoll &operator=(const SocketPoll &);
+};
+
+
+#endif
+
+/** @}*/
@@ -63,18 +63,7 @@ int TCPServer::accept(TCPSocket *connection, SocketAddress *address)
         ret = _stack->socket_accept(_socket, &socket, address);
 
         if (0 == ret) {
-            connection->_lock.lock();
-
-            if (connection->_socket) {
-                connection->close();
-            }
-
-            connection->_stack = _stack;
-            connection->_socket = socket;
-            connection->_event = Callback<void()>(connection, &TCPSocket::event);
-            _stack->socket_attach(socket, &Callback<void()>::thunk, &connection->_event);
-
-            connection->_lock.unlock();
+            attach_connection(connection, socket);
             break;
         } else if (NSAPI_ERROR_WOULD_BLOCK != ret) {
             break;
@@ -99,6 +88,58 @@ int TCPServer::accept(TCPSocket *connection, SocketAddress *address)
     return ret;
 }
 
+int TCPServer::accept_pending(TCPSocket *const *connections, unsigned count, SocketAddress *addresses)
+{
+    _lock.lock();
+    int ret = 0;
+
+    if (!_socket) {
+        ret = NSAPI_ERROR_NO_SOCKET;
+    } else {
+        _pending = 0;
+
+        unsigned accepted = 0;
+        while (accepted < count) {
+            void *socket;
+            int err = _stack->socket_accept(_socket, &socket,
+                    addresses ? &addresses[accepted] : NULL);
+            if (err < 0) {
+                // the first failure is only reported if nothing was accepted
+                if (!accepted && err != NSAPI_ERROR_WOULD_BLOCK) {
+                    ret = err;
+                }
+                break;
+            }
+
+            attach_connection(connections[accepted], socket);
+            accepted++;
+        }
+
+        if (ret == 0) {
+            ret = accepted;
+        }
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+void TCPServer::attach_connection(TCPSocket *connection, void *socket)
+{
+    connection->_lock.lock();
+
+    if (connection->_socket) {
+        connection->close();
+    }
+
+    connection->_stack = _stack;
+    connection->_socket = socket;
+    connection->_event = Callback<void()>(static_cast<Socket *>(connection), &TCPSocket::wakeup);
+    _stack->socket_attach(socket, &Callback<void()>::thunk, &connection->_event);
+
+    connection->_lock.unlock();
+}
+
 void TCPServer::event()
 {
     int32_t acount = _accept_sem.wait(0);
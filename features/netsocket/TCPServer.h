@@ -63,7 +63,9 @@ public:
      *  incoming connections.
      *
      *  @param backlog  Number of pending connections that can be queued
-     *                  simultaneously, defaults to 1
+     *                  simultaneously, defaults to 1. Stacks may limit
+     *                  the backlog, further connection requests are
+     *                  delayed or refused until a connection is accepted.
      *  @return         0 on success, negative error code on failure
      */
     int listen(int backlog = 1);
@@ -84,9 +86,27 @@ public:
      */
     int accept(TCPSocket *connection, SocketAddress *address = NULL);
 
+    /** Accepts all pending connections on a TCP socket
+     *
+     *  Accepts up to count connections that are already pending, without
+     *  blocking, into the given socket instances. Combined with sigio or a
+     *  SocketPoll this lets one thread drain a burst of connections on
+     *  several servers.
+     *
+     *  @param connections  Array of count TCPSocket instances that will
+     *                      handle the incoming connections, used in order
+     *  @param count        Number of instances in the array
+     *  @param addresses    Array of count destinations for the remote
+     *                      addresses or NULL
+     *  @return             Number of accepted connections, 0 if none are
+     *                      pending, negative error code on failure
+     */
+    int accept_pending(TCPSocket *const *connections, unsigned count, SocketAddress *addresses = NULL);
+
 protected:
     virtual nsapi_protocol_t get_proto();
     virtual void event();
+    void attach_connection(TCPSocket *connection, void *socket);
 
     volatile unsigned _pending;
     rtos::Semaphore _accept_sem;
@@ -18,6 +18,10 @@
 #include "Timer.h"
 #include "mbed_assert.h"
 
+#ifndef MBED_CONF_NSAPI_SENDFILE_BUFFER_SIZE
+#define MBED_CONF_NSAPI_SENDFILE_BUFFER_SIZE 512
+#endif
+
 TCPSocket::TCPSocket()
     : _pending(0), _read_sem(0), _write_sem(0),
       _read_in_progress(false), _write_in_progress(false)
@@ -64,6 +68,17 @@ int TCPSocket::connect(const char *host, uint16_t port)
 }
 
 int TCPSocket::send(const void *data, unsigned size)
+{
+    return send_data(data, size, false);
+}
+
+int TCPSocket::send_static(const void *data, unsigned size)
+{
+    return send_data(data, size, true);
+}
+
+// The stack keeps no copy of static data, which stays valid
+int TCPSocket::send_data(const void *data, unsigned size, bool is_static)
 {
     _lock.lock();
     int ret;
@@ -81,7 +96,8 @@ int TCPSocket::send(const void *data, unsigned size)
         }
 
         _pending = 0;
-        int sent = _stack->socket_send(_socket, data, size);
+        int sent = is_static ? _stack->socket_send_static(_socket, data, size)
+                             : _stack->socket_send(_socket, data, size);
         if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != sent)) {
             ret = sent;
             break;
@@ -107,6 +123,41 @@ int TCPSocket::send(const void *data, unsigned size)
     return ret;
 }
 
+int TCPSocket::sendfile(std::FILE *file, unsigned size)
+{
+    char buffer[MBED_CONF_NSAPI_SENDFILE_BUFFER_SIZE];
+    unsigned sent = 0;
+
+    while (sent < size) {
+        unsigned len = size - sent;
+        if (len > sizeof(buffer)) {
+            len = sizeof(buffer);
+        }
+
+        len = std::fread(buffer, 1, len, file);
+        if (len == 0) {
+            break;
+        }
+
+        unsigned offset = 0;
+        while (offset < len) {
+            int ret = send(buffer + offset, len - offset);
+            if (ret <= 0) {
+                // leave what wasn't sent to be read again
+                std::fseek(file, (long)offset - (long)len, SEEK_CUR);
+                sent += offset;
+                return sent ? (int)sent : ret;
+            }
+
+            offset += ret;
+        }
+
+        sent += len;
+    }
+
+    return (int)sent;
+}
+
 int TCPSocket::recv(void *data, unsigned size)
 {
     _lock.lock();
@@ -151,6 +202,192 @@ int TCPSocket::recv(void *data, unsigned size)
     return ret;
 }
 
+int TCPSocket::send(const NetBuffer &buf, unsigned offset)
+{
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a send at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_write_in_progress);
+    _write_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        if (buf.empty() || buf._stack != _stack) {
+            ret = NSAPI_ERROR_PARAMETER;
+            break;
+        }
+
+        _pending = 0;
+        int sent = _stack->socket_send_buf(_socket, buf._buf, offset);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != sent)) {
+            ret = sent;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _write_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _write_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
+int TCPSocket::recv(NetBuffer *buf)
+{
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a recv at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_read_in_progress);
+    _read_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        nsapi_buf_t handle = 0;
+        int recv = _stack->socket_recv_buf(_socket, &handle);
+        if (recv >= 0 && handle) {
+            buf->attach(_stack, handle, recv);
+        }
+
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != recv)) {
+            ret = recv;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _read_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _read_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
+int TCPSocket::sendmsg(const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a send at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_write_in_progress);
+    _write_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        int sent = _stack->socket_sendmsg(_socket, 0, iov, iovcnt);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != sent)) {
+            ret = sent;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _write_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _write_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
+int TCPSocket::recvmsg(const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a recv at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_read_in_progress);
+    _read_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        int recv = _stack->socket_recvmsg(_socket, 0, iov, iovcnt, 0);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != recv)) {
+            ret = recv;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _read_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _read_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
 void TCPSocket::event()
 {
     int32_t wcount = _write_sem.wait(0);
@@ -23,7 +23,9 @@
 #include "netsocket/Socket.h"
 #include "netsocket/NetworkStack.h"
 #include "netsocket/NetworkInterface.h"
+#include "netsocket/NetBuffer.h"
 #include "rtos/Semaphore.h"
+#include <cstdio>
 
 
 /** TCP socket connection
@@ -110,11 +112,115 @@ public:
      */
     int recv(void *data, unsigned size);
 
+    /** Send a network buffer over a TCP socket
+     *
+     *  Sends the contents of the buffer starting at offset, without first
+     *  copying them into an intermediate buffer. The buffer must have been
+     *  allocated on the socket's stack, and is left untouched so that any
+     *  unsent remainder can be sent with a larger offset.
+     *
+     *  By default, send blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param buf      Network buffer to send to the host
+     *  @param offset   Offset in bytes of the first byte to send
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int send(const NetBuffer &buf, unsigned offset = 0);
+
+    /** Receive a network buffer over a TCP socket
+     *
+     *  Hands over the stack's receive buffer instead of copying from it.
+     *  Any buffer previously held by buf is released.
+     *
+     *  By default, recv blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param buf      Destination for the network buffer received from
+     *                  the host
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    int recv(NetBuffer *buf);
+
+    /** Send data gathered from several buffers over a TCP socket
+     *
+     *  The buffers are sent in order as if they were a single buffer,
+     *  without first copying them together. Returns the number of bytes
+     *  sent, which may end in the middle of any of the buffers.
+     *
+     *  By default, sendmsg blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param iov      Array of buffers to send to the host
+     *  @param iovcnt   Number of buffers in the array
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int sendmsg(const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive data scattered into several buffers over a TCP socket
+     *
+     *  The buffers are filled in order as if they were a single buffer.
+     *
+     *  By default, recvmsg blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param iov      Array of destination buffers for data received
+     *                  from the host
+     *  @param iovcnt   Number of buffers in the array
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    int recvmsg(const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Send data that never changes over a TCP socket
+     *
+     *  The data must stay valid and unchanged for as long as the stack
+     *  runs, such as a constant web page in flash. Stacks which support
+     *  it then send the data from where it is, keeping no copy of it in
+     *  their send buffers.
+     *
+     *  By default, send blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param data     Buffer of data to send to the host
+     *  @param size     Size of the buffer in bytes
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int send_static(const void *data, unsigned size);
+
+    /** Send the contents of a file over a TCP socket
+     *
+     *  Reads the file from its current position a piece at a time into a
+     *  buffer of nsapi.sendfile-buffer-size bytes on the stack, so files
+     *  of any size can be sent, e.g. from a FATFileSystem. The file is
+     *  left positioned after the last byte sent.
+     *
+     *  By default, sendfile blocks until data is sent. If socket is set to
+     *  non-blocking or times out, the bytes sent so far are returned, or
+     *  NSAPI_ERROR_WOULD_BLOCK if there are none.
+     *
+     *  @param file     File to send, opened for reading
+     *  @param size     Number of bytes to send, less at the end of the file
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int sendfile(std::FILE *file, unsigned size);
+
 protected:
     friend class TCPServer;
 
     virtual nsapi_protocol_t get_proto();
     virtual void event();
+    int send_data(const void *data, unsigned size, bool is_static);
 
     volatile unsigned _pending;
     rtos::Semaphore _read_sem;
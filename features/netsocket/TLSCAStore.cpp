@@ -0,0 +1,116 @@
+/* TLSCAStore
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TLSCAStore.h"
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+
+#include <string.h>
+#include "nsapi_types.h"
+#include "platform/mbed_assert.h"
+#include "mbedtls/asn1.h"
+
+TLSCAStore::TLSCAStore()
+    : _users(0), _tls_error(0)
+{
+    mbedtls_x509_crt_init(&_chain);
+}
+
+TLSCAStore::~TLSCAStore()
+{
+    MBED_ASSERT(_users == 0);
+    mbedtls_x509_crt_free(&_chain);
+}
+
+int TLSCAStore::add(const void *cert, size_t len)
+{
+    _lock.lock();
+
+    // parsing links certificates into the chain before they are complete
+    if (_users) {
+        _lock.unlock();
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    int ret = mbedtls_x509_crt_parse(&_chain, (const unsigned char *)cert, len);
+    if (ret < 0) {
+        _tls_error = ret;
+        ret = NSAPI_ERROR_PARAMETER;
+    } else {
+        ret = 0;
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+int TLSCAStore::add(const char *pem)
+{
+    return add(pem, strlen(pem) + 1);
+}
+
+int TLSCAStore::add_der_bundle(const void *buf, size_t len)
+{
+    _lock.lock();
+
+    if (_users) {
+        _lock.unlock();
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    // each certificate is a SEQUENCE, its header gives where the next starts
+    const unsigned char *p = (const unsigned char *)buf;
+    const unsigned char *end = p + len;
+    int ret = 0;
+    while (p < end) {
+        unsigned char *q = (unsigned char *)p;
+        size_t seq_len;
+        ret = mbedtls_asn1_get_tag(&q, end, &seq_len,
+                MBEDTLS_ASN1_CONSTRUCTED | MBEDTLS_ASN1_SEQUENCE);
+        if (ret == 0) {
+            size_t cert_len = (q - p) + seq_len;
+            ret = mbedtls_x509_crt_parse_der(&_chain, p, cert_len);
+            p += cert_len;
+        }
+
+        if (ret != 0) {
+            _tls_error = ret;
+            ret = NSAPI_ERROR_PARAMETER;
+            break;
+        }
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+mbedtls_x509_crt *TLSCAStore::acquire()
+{
+    _lock.lock();
+    _users++;
+    _lock.unlock();
+    return &_chain;
+}
+
+void TLSCAStore::release()
+{
+    _lock.lock();
+    MBED_ASSERT(_users > 0);
+    _users--;
+    _lock.unlock();
+}
+
+#endif
@@ -0,0 +1,140 @@
+/** \addtogroup netsocket */
+/** @{*/
+/* TLSCAStore
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TLSCASTORE_H
+#define TLSCASTORE_H
+
+#include "mbedtls/config.h"
+
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+
+#include <stddef.h>
+#include "rtos/Mutex.h"
+#include "mbedtls/x509_crt.h"
+
+
+/** CA certificates parsed once and shared by TLS configurations
+ *
+ *  Parsing a CA bundle for every connection takes time and a copy of
+ *  the parsed chain per connection. A store is filled once, then any
+ *  number of TLSSockets, or other mbedtls_ssl_config instances through
+ *  acquire and release, verify servers against the same chain
+ *  concurrently, verification only reading it.
+ *
+ *  Each user holds a reference. The chain can only be added to while
+ *  there are none, and the store must outlive its users.
+ *
+ *  A CA bundle can be converted to DER at build time, for instance with
+ *  openssl x509 -outform der on each certificate, and the concatenated
+ *  certificates placed in flash for add_der_bundle, to skip the base64
+ *  decoding of PEM. The parsed certificates still take heap, mbedtls
+ *  keeping its own copy of each certificate.
+ *
+ *  Example:
+ *  @code
+ *  TLSCAStore cas;
+ *  cas.add(ca_bundle_pem);
+ *
+ *  TLSSocket tls(&eth);
+ *  tls.set_root_ca_store(&cas);
+ *  @endcode
+ */
+class TLSCAStore {
+public:
+    /** Create an empty store
+     */
+    TLSCAStore();
+
+    /** Destroy a store, which must no longer be in use
+     */
+    ~TLSCAStore();
+
+    /** Add CA certificates
+     *
+     *  @param cert     Certificate in DER format, or certificates in PEM
+     *                  format including the terminating null character
+     *  @param len      Length of cert in bytes
+     *  @return         0 on success, NSAPI_ERROR_PARAMETER if a
+     *                  certificate does not parse or the store is in use
+     */
+    int add(const void *cert, size_t len);
+
+    /** Add CA certificates from a null-terminated PEM string
+     *
+     *  @param pem      Certificates in PEM format
+     *  @return         0 on success, negative error code on failure
+     */
+    int add(const char *pem);
+
+    /** Add concatenated DER certificates
+     *
+     *  @param buf      Certificates in DER format, one after the other
+     *  @param len      Length of buf in bytes
+     *  @return         0 on success, NSAPI_ERROR_PARAMETER if a
+     *                  certificate does not parse or the store is in use,
+     *                  the certificates before it are kept
+     */
+    int add_der_bundle(const void *buf, size_t len);
+
+    /** Take a reference to the chain
+     *
+     *  @return         Chain for mbedtls_ssl_conf_ca_chain, valid until
+     *                  release
+     */
+    mbedtls_x509_crt *acquire();
+
+    /** Drop a reference taken with acquire
+     */
+    void release();
+
+    /** Get the number of references
+     *
+     *  @return         References taken and not released
+     */
+    unsigned get_users() const
+    {
+        return _users;
+    }
+
+    /** Get the mbedtls error of the last failed add
+     *
+     *  @return         Negative mbedtls error code, 0 if none
+     */
+    int get_tls_error() const
+    {
+        return _tls_error;
+    }
+
+protected:
+    rtos::Mutex _lock;
+    mbedtls_x509_crt _chain;
+    unsigned _users;
+    int _tls_error;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    TLSCAStore(const TLSCAStore &);
+    TLSCAStore &operator=(const TLSCAStore &);
+};
+
+
+#endif
+
+#endif
+
+/** @}*/
@@ -0,0 +1,188 @@
+/* TLSSessionCache
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TLSSessionCache.h"
+
+#if defined(MBEDTLS_SSL_CLI_C)
+
+#include <string.h>
+#include <time.h>
+#include "nsapi_types.h"
+#include "mbedtls/platform.h"
+
+// Stored form, all values little endian:
+//   version, saved time, ciphersuite, compression, id length, id, master,
+//   verify result, mfl code, truncated hmac, encrypt then mac,
+//   ticket lifetime, ticket length, ticket
+#define TLS_SESSION_VERSION     1
+#define TLS_SESSION_HEADER_SIZE (1 + 4 + 4 + 1 + 1 + 32 + 48 + 4 + 1 + 1 + 1 + 4 + 2)
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = v;
+    p[1] = v >> 8;
+    p[2] = v >> 16;
+    p[3] = v >> 24;
+    return p + 4;
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static size_t session_ticket_len(const mbedtls_ssl_session *session)
+{
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    // tickets too long for the stored form are left out
+    if (!session->ticket || session->ticket_len > 0xffff) {
+        return 0;
+    }
+    return session->ticket_len;
+#else
+    return 0;
+#endif
+}
+
+unsigned TLSSessionCache::saved_size(const mbedtls_ssl_session *session)
+{
+    return TLS_SESSION_HEADER_SIZE + session_ticket_len(session);
+}
+
+void TLSSessionCache::save(const mbedtls_ssl_session *session, uint8_t *buf)
+{
+    uint8_t *p = buf;
+    size_t ticket_len = session_ticket_len(session);
+
+    memset(buf, 0, TLS_SESSION_HEADER_SIZE);
+    *p++ = TLS_SESSION_VERSION;
+    p = put_u32(p, time(NULL));
+    p = put_u32(p, session->ciphersuite);
+    *p++ = session->compression;
+    *p++ = session->id_len;
+    memcpy(p, session->id, session->id_len);
+    p += sizeof(session->id);
+    memcpy(p, session->master, sizeof(session->master));
+    p += sizeof(session->master);
+    p = put_u32(p, session->verify_result);
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    p[0] = session->mfl_code;
+#endif
+#if defined(MBEDTLS_SSL_TRUNCATED_HMAC)
+    p[1] = session->trunc_hmac;
+#endif
+#if defined(MBEDTLS_SSL_ENCRYPT_THEN_MAC)
+    p[2] = session->encrypt_then_mac;
+#endif
+    p += 3;
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    p = put_u32(p, session->ticket_lifetime);
+#else
+    p += 4;
+#endif
+    *p++ = ticket_len;
+    *p++ = ticket_len >> 8;
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    if (ticket_len) {
+        memcpy(p, session->ticket, ticket_len);
+    }
+#endif
+}
+
+bool TLSSessionCache::saved_equal(const uint8_t *a, unsigned a_size,
+                                  const uint8_t *b, unsigned b_size)
+{
+    // skips the version and the saved time
+    const unsigned skip = 1 + 4;
+    return a_size == b_size && a_size >= TLS_SESSION_HEADER_SIZE &&
+           memcmp(a + skip, b + skip, a_size - skip) == 0;
+}
+
+int TLSSessionCache::load(mbedtls_ssl_session *session, const uint8_t *buf,
+                          unsigned size, uint32_t max_age)
+{
+    const uint8_t *p = buf;
+    if (size < TLS_SESSION_HEADER_SIZE || p[0] != TLS_SESSION_VERSION) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+    p += 1;
+
+    uint32_t saved = get_u32(p);
+    p += 4;
+
+    size_t ticket_len = buf[TLS_SESSION_HEADER_SIZE - 2] | (buf[TLS_SESSION_HEADER_SIZE - 1] << 8);
+    uint32_t ticket_lifetime = get_u32(&buf[TLS_SESSION_HEADER_SIZE - 6]);
+    if (size != TLS_SESSION_HEADER_SIZE + ticket_len) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    // a clock behind the saved time has been reset, the age is unknown
+    uint32_t now = time(NULL);
+    if (now >= saved) {
+        uint32_t age = now - saved;
+        if ((max_age && age > max_age) ||
+            (ticket_len && ticket_lifetime && age > ticket_lifetime)) {
+            return NSAPI_ERROR_PARAMETER;
+        }
+    }
+
+#if defined(MBEDTLS_HAVE_TIME)
+    session->start = saved;
+#endif
+    session->ciphersuite = get_u32(p);
+    p += 4;
+    session->compression = *p++;
+    session->id_len = *p++;
+    if (session->id_len > sizeof(session->id)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+    memcpy(session->id, p, sizeof(session->id));
+    p += sizeof(session->id);
+    memcpy(session->master, p, sizeof(session->master));
+    p += sizeof(session->master);
+    session->verify_result = get_u32(p);
+    p += 4;
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    session->mfl_code = p[0];
+#endif
+#if defined(MBEDTLS_SSL_TRUNCATED_HMAC)
+    session->trunc_hmac = p[1];
+#endif
+#if defined(MBEDTLS_SSL_ENCRYPT_THEN_MAC)
+    session->encrypt_then_mac = p[2];
+#endif
+    p += 3 + 4 + 2;
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+    if (ticket_len) {
+        session->ticket = (unsigned char *)mbedtls_calloc(1, ticket_len);
+        if (!session->ticket) {
+            return NSAPI_ERROR_NO_MEMORY;
+        }
+        memcpy(session->ticket, p, ticket_len);
+        session->ticket_len = ticket_len;
+        session->ticket_lifetime = ticket_lifetime;
+    }
+#else
+    if (ticket_len) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+#endif
+
+    return 0;
+}
+
+#endif
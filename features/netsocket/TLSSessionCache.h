@@ -0,0 +1,117 @@
+/** \addtogroup netsocket */
+/** @{*/
+/* TLSSessionCache
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TLSSESSIONCACHE_H
+#define TLSSESSIONCACHE_H
+
+#include "mbedtls/config.h"
+
+#if defined(MBEDTLS_SSL_CLI_C)
+
+#include <stdint.h>
+#include "mbedtls/ssl.h"
+
+
+/** Client-side cache of TLS sessions
+ *
+ *  A TLSSocket with a session cache offers the session it last
+ *  established with the same server, identified by hostname and port,
+ *  so the server can resume it in an abbreviated handshake without any
+ *  public key operations. Both session ids and session tickets are kept.
+ *
+ *  Implementations store sessions in the form produced by save, which
+ *  records when the session was stored so load can drop it once it is
+ *  older than the cache's maximum age.
+ */
+class TLSSessionCache {
+public:
+    virtual ~TLSSessionCache() {}
+
+    /** Get the session stored for a server
+     *
+     *  @param key      Server the session was established with
+     *  @param session  Initialized session to load into
+     *  @return         0 on success, negative error code if no unexpired
+     *                  session is stored
+     */
+    virtual int get(const char *key, mbedtls_ssl_session *session) = 0;
+
+    /** Store the session established with a server
+     *
+     *  Replaces any session stored for the server. Storing the session
+     *  that is already stored does nothing.
+     *
+     *  @param key      Server the session was established with
+     *  @param session  Session to store
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int set(const char *key, const mbedtls_ssl_session *session) = 0;
+
+    /** Remove the session stored for a server
+     *
+     *  @param key      Server the session was established with
+     *  @return         0 on success, negative error code on failure
+     */
+    virtual int remove(const char *key) = 0;
+
+protected:
+    /** Size of a session in the stored form
+     */
+    static unsigned saved_size(const mbedtls_ssl_session *session);
+
+    /** Convert a session to the stored form
+     *
+     *  The peer certificate is not kept, the server has already been
+     *  verified when the session was established.
+     *
+     *  @param session  Session to store
+     *  @param buf      Destination of saved_size(session) bytes
+     */
+    static void save(const mbedtls_ssl_session *session, uint8_t *buf);
+
+    /** Check if two stored sessions are the same session
+     *
+     *  Ignores when the sessions were stored.
+     */
+    static bool saved_equal(const uint8_t *a, unsigned a_size,
+                            const uint8_t *b, unsigned b_size);
+
+    /** Convert a session from the stored form
+     *
+     *  Sessions older than max_age seconds, or older than the lifetime
+     *  of their ticket, are rejected. Without a real-time clock the age is
+     *  unknown after a reset, such sessions are offered anyway and the
+     *  server decides whether they are still valid.
+     *
+     *  @param session  Initialized session to load into
+     *  @param buf      Stored session
+     *  @param size     Size of the stored session in bytes
+     *  @param max_age  Maximum age in seconds, 0 for no limit
+     *  @return         0 on success, NSAPI_ERROR_PARAMETER if the stored
+     *                  session is invalid or expired
+     */
+    static int load(mbedtls_ssl_session *session, const uint8_t *buf,
+                    unsigned size, uint32_t max_age);
+};
+
+
+#endif
+
+#endif
+
+/** @}*/
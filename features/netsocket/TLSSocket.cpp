@@ -0,0 +1,757 @@
+/* TLSSocket
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TLSSocket.h"
+
+#if defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_X509_CRT_PARSE_C) && \
+    defined(MBEDTLS_ENTROPY_C) && defined(MBEDTLS_CTR_DRBG_C)
+
+#include "events/EventQueue.h"
+#include "rtos/Thread.h"
+#include "platform/PlatformMutex.h"
+#include "platform/SingletonPtr.h"
+#include "platform/critical.h"
+#include "platform/mbed_error.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef MBED_CONF_NSAPI_TLS_HANDSHAKE_THREAD_STACK_SIZE
+#define MBED_CONF_NSAPI_TLS_HANDSHAKE_THREAD_STACK_SIZE 4096
+#endif
+
+#define TLS_HANDSHAKE_QUEUE_SIZE 8
+
+enum {
+    HANDSHAKE_IDLE,
+    HANDSHAKE_RUNNING,
+    HANDSHAKE_DONE,
+};
+
+static const char tls_drbg_personalization[] = "TLSSocket";
+
+// asynchronous handshakes run on a shared worker thread, below the
+// priority of the threads serving the network
+static SingletonPtr<PlatformMutex> tls_handshake_mutex;
+static events::EventQueue *tls_handshake_queue = 0;
+static rtos::Thread *tls_handshake_thread = 0;
+// the worker, and the socket whose job is calling its callback there
+static osThreadId tls_handshake_tid = 0;
+static TLSSocket *tls_handshake_current = 0;
+
+TLSSocket::TLSSocket()
+{
+    init();
+}
+
+TLSSocket::~TLSSocket()
+{
+    close();
+    set_root_ca_store(NULL);
+
+    mbedtls_ssl_config_free(&_conf);
+    mbedtls_x509_crt_free(&_cacert);
+    mbedtls_x509_crt_free(&_own_cert);
+    mbedtls_pk_free(&_own_key);
+    mbedtls_ctr_drbg_free(&_drbg);
+    mbedtls_entropy_free(&_entropy);
+
+    // the arena is in the list of arenas until released, it must not
+    // outlive the socket
+    if (arena_release() != 0) {
+        ::error("TLSSocket destroyed with blocks still allocated from its arena\r\n");
+    }
+}
+
+void TLSSocket::init()
+{
+    _seeded = false;
+    _setup = false;
+    _tcp_connected = false;
+    _connected = false;
+    _blocking = true;
+    _tls_error = 0;
+    _async_handshake = false;
+    _handshake_state = HANDSHAKE_IDLE;
+    _handshake_waiting = 0;
+    _handshake_jobs = 0;
+    _handshake_queued = 0;
+    _handshake_ret = 0;
+    _ca_store = NULL;
+    _session_cache = NULL;
+    _session_key[0] = '\0';
+    _arena_buf = NULL;
+    _arena_size = 0;
+    memset(&_arena, 0, sizeof(_arena));
+
+    mbedtls_ssl_init(&_ssl);
+    mbedtls_ssl_config_init(&_conf);
+    mbedtls_x509_crt_init(&_cacert);
+    mbedtls_x509_crt_init(&_own_cert);
+    mbedtls_pk_init(&_own_key);
+    mbedtls_entropy_init(&_entropy);
+    mbedtls_ctr_drbg_init(&_drbg);
+
+    mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_CLIENT,
+            MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT);
+    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_drbg);
+    mbedtls_ssl_conf_ca_chain(&_conf, &_cacert, NULL);
+    set_max_fragment_length(MBEDTLS_SSL_MAX_CONTENT_LEN);
+
+    _transport.attach(mbed::callback(this, &TLSSocket::event));
+}
+
+int TLSSocket::open(NetworkStack *stack)
+{
+    return _transport.open(stack);
+}
+
+int TLSSocket::close()
+{
+    if (_connected) {
+        _lock.lock();
+        arena_enter();
+        mbedtls_ssl_close_notify(&_ssl);
+        arena_leave();
+        _lock.unlock();
+    }
+
+    // The lock is only taken again once the transport is closed, which
+    // wakes up any blocking operation holding it
+
+    int ret = _transport.close();
+
+    _lock.lock();
+    if (_setup) {
+        arena_enter();
+        mbedtls_ssl_free(&_ssl);
+        mbedtls_ssl_init(&_ssl);
+        arena_leave();
+        _setup = false;
+    }
+
+    int err = arena_release();
+    if (ret == 0) {
+        ret = err;
+    }
+
+    _tcp_connected = false;
+    _connected = false;
+    _handshake_state = HANDSHAKE_IDLE;
+    _handshake_waiting = 0;
+    _lock.unlock();
+
+    // jobs still queued find the handshake over, and must be gone before
+    // the socket can be destroyed. On the worker they cannot run until
+    // the callback closing the socket returns
+    if (tls_handshake_tid && rtos::Thread::gettid() == tls_handshake_tid) {
+        handshake_cancel();
+    }
+    while (_handshake_jobs) {
+        rtos::Thread::wait(1);
+    }
+
+    return ret;
+}
+
+int TLSSocket::set_root_ca_cert(const void *cert, size_t len)
+{
+    _lock.lock();
+    int ret = mbedtls_x509_crt_parse(&_cacert, (const unsigned char *)cert, len);
+    if (ret < 0) {
+        _tls_error = ret;
+        ret = NSAPI_ERROR_PARAMETER;
+    } else {
+        ret = 0;
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+int TLSSocket::set_root_ca_cert(const char *pem)
+{
+    return set_root_ca_cert(pem, strlen(pem) + 1);
+}
+
+void TLSSocket::set_root_ca_store(TLSCAStore *store)
+{
+    _lock.lock();
+    if (_ca_store) {
+        _ca_store->release();
+    }
+
+    _ca_store = store;
+    if (_ca_store) {
+        mbedtls_ssl_conf_ca_chain(&_conf, _ca_store->acquire(), NULL);
+    } else {
+        mbedtls_ssl_conf_ca_chain(&_conf, &_cacert, NULL);
+    }
+    _lock.unlock();
+}
+
+int TLSSocket::set_client_cert_key(const void *cert, size_t cert_len,
+                                   const void *key, size_t key_len)
+{
+    _lock.lock();
+    int ret = mbedtls_x509_crt_parse(&_own_cert, (const unsigned char *)cert, cert_len);
+    if (ret == 0) {
+        ret = mbedtls_pk_parse_key(&_own_key, (const unsigned char *)key, key_len, NULL, 0);
+    }
+
+    if (ret == 0) {
+        ret = mbedtls_ssl_conf_own_cert(&_conf, &_own_cert, &_own_key);
+    }
+
+    if (ret != 0) {
+        _tls_error = ret;
+        ret = NSAPI_ERROR_PARAMETER;
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+int TLSSocket::set_max_fragment_length(unsigned len)
+{
+    if (len == 0 || len >= 16384) {
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+        mbedtls_ssl_conf_max_frag_len(&_conf, MBEDTLS_SSL_MAX_FRAG_LEN_NONE);
+#endif
+        return 0;
+    }
+
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    unsigned char code;
+    if (len >= 4096) {
+        code = MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+    } else if (len >= 2048) {
+        code = MBEDTLS_SSL_MAX_FRAG_LEN_2048;
+    } else if (len >= 1024) {
+        code = MBEDTLS_SSL_MAX_FRAG_LEN_1024;
+    } else if (len >= 512) {
+        code = MBEDTLS_SSL_MAX_FRAG_LEN_512;
+    } else {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    _lock.lock();
+    int ret = mbedtls_ssl_conf_max_frag_len(&_conf, code);
+    _lock.unlock();
+    return ret ? NSAPI_ERROR_PARAMETER : 0;
+#else
+    return NSAPI_ERROR_UNSUPPORTED;
+#endif
+}
+
+int TLSSocket::set_arena_size(size_t size)
+{
+#if defined(MBEDTLS_MEMORY_ARENA)
+    _lock.lock();
+    _arena_size = size;
+    _lock.unlock();
+    return 0;
+#else
+    return size ? NSAPI_ERROR_UNSUPPORTED : 0;
+#endif
+}
+
+size_t TLSSocket::get_arena_peak() const
+{
+#if defined(MBEDTLS_MEMORY_ARENA)
+    return mbedtls_arena_peak(&_arena);
+#else
+    return 0;
+#endif
+}
+
+int TLSSocket::arena_setup()
+{
+#if defined(MBEDTLS_MEMORY_ARENA)
+    if (_arena_buf || !_arena_size) {
+        return 0;
+    }
+
+    _arena_buf = malloc(_arena_size);
+    if (!_arena_buf) {
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    if (mbedtls_arena_init(&_arena, _arena_buf, _arena_size) != 0) {
+        free(_arena_buf);
+        _arena_buf = NULL;
+        return NSAPI_ERROR_PARAMETER;
+    }
+#endif
+    return 0;
+}
+
+int TLSSocket::arena_release()
+{
+#if defined(MBEDTLS_MEMORY_ARENA)
+    if (_arena_buf) {
+        // blocks still allocated keep the buffer, which is reused
+        if (mbedtls_arena_free(&_arena) != 0) {
+            return NSAPI_ERROR_DEVICE_ERROR;
+        }
+        free(_arena_buf);
+        _arena_buf = NULL;
+    }
+#endif
+    return 0;
+}
+
+void TLSSocket::arena_enter()
+{
+#if defined(MBEDTLS_MEMORY_ARENA)
+    if (_arena_buf) {
+        mbedtls_arena_enter(&_arena);
+    }
+#endif
+}
+
+void TLSSocket::arena_leave()
+{
+#if defined(MBEDTLS_MEMORY_ARENA)
+    if (_arena_buf) {
+        mbedtls_arena_leave(&_arena);
+    }
+#endif
+}
+
+void TLSSocket::set_session_cache(TLSSessionCache *cache)
+{
+    _lock.lock();
+    _session_cache = cache;
+    _lock.unlock();
+}
+
+int TLSSocket::set_async_handshake(bool enabled)
+{
+    if (enabled) {
+        tls_handshake_mutex->lock();
+        if (!tls_handshake_queue) {
+            tls_handshake_queue = new events::EventQueue(TLS_HANDSHAKE_QUEUE_SIZE*EVENTS_EVENT_SIZE);
+            tls_handshake_thread = new rtos::Thread(osPriorityLow,
+                    MBED_CONF_NSAPI_TLS_HANDSHAKE_THREAD_STACK_SIZE);
+            tls_handshake_thread->start(mbed::callback(tls_handshake_queue,
+                    &events::EventQueue::dispatch_forever));
+        }
+        tls_handshake_mutex->unlock();
+    }
+
+    _lock.lock();
+    _async_handshake = enabled;
+    _lock.unlock();
+    return 0;
+}
+
+void TLSSocket::set_session_key(const char *name, uint16_t port)
+{
+    // the key of a connection in progress stays the same
+    if (!_setup) {
+        snprintf(_session_key, sizeof(_session_key), "%s:%u", name, port);
+    }
+}
+
+int TLSSocket::setup(const char *hostname)
+{
+    // The SSL context, with its record buffers, only exists while
+    // connecting or connected
+    if (_setup) {
+        return 0;
+    }
+
+    int ret = 0;
+    if (!_seeded) {
+        ret = mbedtls_ctr_drbg_seed(&_drbg, mbedtls_entropy_func, &_entropy,
+                (const unsigned char *)tls_drbg_personalization,
+                sizeof(tls_drbg_personalization) - 1);
+        if (ret != 0) {
+            return error(ret);
+        }
+        _seeded = true;
+    }
+
+    ret = arena_setup();
+    if (ret != 0) {
+        return ret;
+    }
+
+    // connect could not enter the arena before it existed
+    arena_enter();
+
+    ret = mbedtls_ssl_setup(&_ssl, &_conf);
+    if (ret == 0) {
+        ret = mbedtls_ssl_set_hostname(&_ssl, hostname);
+    }
+
+    if (ret != 0) {
+        mbedtls_ssl_free(&_ssl);
+        mbedtls_ssl_init(&_ssl);
+        arena_leave();
+        arena_release();
+        return error(ret);
+    }
+
+    mbedtls_ssl_set_bio(&_ssl, this, &TLSSocket::bio_send, &TLSSocket::bio_recv, NULL);
+
+    if (_session_cache) {
+        mbedtls_ssl_session session;
+        mbedtls_ssl_session_init(&session);
+        if (_session_cache->get(_session_key, &session) == 0) {
+            mbedtls_ssl_set_session(&_ssl, &session);
+        }
+        mbedtls_ssl_session_free(&session);
+    }
+
+    _setup = true;
+    return 0;
+}
+
+int TLSSocket::handshake()
+{
+    if (_connected) {
+        return 0;
+    }
+
+    if (_async_handshake && !_blocking) {
+        return handshake_async();
+    }
+
+    return handshake_result(mbedtls_ssl_handshake(&_ssl));
+}
+
+int TLSSocket::handshake_result(int ret)
+{
+    if (ret != 0) {
+        ret = error(ret);
+        if (ret == NSAPI_ERROR_AUTH_FAILURE && _session_cache) {
+            _session_cache->remove(_session_key);
+        }
+        return ret;
+    }
+
+    _connected = true;
+
+    if (_session_cache) {
+        mbedtls_ssl_session session;
+        mbedtls_ssl_session_init(&session);
+        if (mbedtls_ssl_get_session(&_ssl, &session) == 0) {
+            _session_cache->set(_session_key, &session);
+        }
+        mbedtls_ssl_session_free(&session);
+    }
+
+    return 0;
+}
+
+int TLSSocket::handshake_async()
+{
+    if (_handshake_state == HANDSHAKE_RUNNING) {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    if (_handshake_state == HANDSHAKE_DONE) {
+        _handshake_state = HANDSHAKE_IDLE;
+        return _handshake_ret;
+    }
+
+    _handshake_state = HANDSHAKE_RUNNING;
+    if (!handshake_post()) {
+        _handshake_state = HANDSHAKE_IDLE;
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    return NSAPI_ERROR_WOULD_BLOCK;
+}
+
+bool TLSSocket::handshake_post()
+{
+    bool posted = true;
+
+    // a job already queued runs the next step, so at most one is queued
+    // behind the running one
+    core_util_critical_section_enter();
+    if (!_handshake_queued) {
+        _handshake_queued = tls_handshake_queue->call(this, &TLSSocket::handshake_job);
+        if (_handshake_queued) {
+            _handshake_jobs += 1;
+        } else {
+            posted = false;
+        }
+    }
+    core_util_critical_section_exit();
+
+    return posted;
+}
+
+// Called on the worker, by close from the callback of a job
+void TLSSocket::handshake_cancel()
+{
+    core_util_critical_section_enter();
+    if (_handshake_queued) {
+        tls_handshake_queue->cancel(_handshake_queued);
+        _handshake_queued = 0;
+        _handshake_jobs -= 1;
+    }
+    core_util_critical_section_exit();
+
+    // the running job leaves the socket alone once the callback returns
+    if (tls_handshake_current == this) {
+        tls_handshake_current = 0;
+        core_util_atomic_decr_u32(&_handshake_jobs, 1);
+    }
+}
+
+void TLSSocket::handshake_job()
+{
+    bool over = false;
+
+    tls_handshake_tid = rtos::Thread::gettid();
+    core_util_critical_section_enter();
+    _handshake_queued = 0;
+    core_util_critical_section_exit();
+
+    _lock.lock();
+    if (_handshake_state == HANDSHAKE_RUNNING) {
+        arena_enter();
+
+        // records arriving during the step post another job, which then
+        // only finds out the step needs more of them
+        _handshake_waiting = 1;
+        int ret = mbedtls_ssl_handshake_step(&_ssl);
+        if (ret == 0 && _ssl.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+            uint8_t waiting = 1;
+            if (core_util_atomic_cas_u8(&_handshake_waiting, &waiting, 0) && !handshake_post()) {
+                ret = MBEDTLS_ERR_SSL_ALLOC_FAILED;
+            }
+        }
+
+        if (ret == 0 ? _ssl.state == MBEDTLS_SSL_HANDSHAKE_OVER
+                     : ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+            _handshake_waiting = 0;
+            _handshake_ret = handshake_result(ret);
+            _handshake_state = HANDSHAKE_DONE;
+            over = true;
+        }
+
+        arena_leave();
+    }
+    _lock.unlock();
+
+    if (over) {
+        tls_handshake_current = this;
+        event();
+        if (tls_handshake_current != this) {
+            // closed by the callback, the socket may be gone
+            return;
+        }
+        tls_handshake_current = 0;
+    }
+
+    // the socket may be destroyed from here on
+    core_util_atomic_decr_u32(&_handshake_jobs, 1);
+}
+
+bool TLSSocket::lock_io()
+{
+    // a handshake step on the worker may hold the lock for seconds
+    if (_async_handshake && !_blocking) {
+        return _lock.trylock();
+    }
+
+    _lock.lock();
+    return true;
+}
+
+int TLSSocket::error(int ret)
+{
+    if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    // errors of the transport are passed through by mbedtls
+    if (ret <= NSAPI_ERROR_WOULD_BLOCK && ret >= NSAPI_ERROR_DEVICE_ERROR) {
+        return ret;
+    }
+
+    _tls_error = ret;
+    if (ret == MBEDTLS_ERR_SSL_ALLOC_FAILED) {
+        return NSAPI_ERROR_NO_MEMORY;
+    } else if (!_connected) {
+        return NSAPI_ERROR_AUTH_FAILURE;
+    } else {
+        return NSAPI_ERROR_DEVICE_ERROR;
+    }
+}
+
+int TLSSocket::connect(const char *host, uint16_t port)
+{
+    if (!lock_io()) {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    arena_enter();
+    set_session_key(host, port);
+    int ret = setup(host);
+    if (ret == 0 && !_tcp_connected) {
+        ret = _transport.connect(host, port);
+        _tcp_connected = (ret == 0);
+    }
+
+    if (ret == 0) {
+        ret = handshake();
+    }
+
+    arena_leave();
+    _lock.unlock();
+    return ret;
+}
+
+int TLSSocket::connect(const SocketAddress &address, const char *hostname)
+{
+    if (!lock_io()) {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    arena_enter();
+    set_session_key(hostname ? hostname : address.get_ip_address(), address.get_port());
+    int ret = setup(hostname);
+    if (ret == 0 && !_tcp_connected) {
+        ret = _transport.connect(address);
+        _tcp_connected = (ret == 0);
+    }
+
+    if (ret == 0) {
+        ret = handshake();
+    }
+
+    arena_leave();
+    _lock.unlock();
+    return ret;
+}
+
+int TLSSocket::send(const void *data, unsigned size)
+{
+    if (!lock_io()) {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+    int ret = 0;
+
+    if (!_connected) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+    } else {
+        arena_enter();
+        // mbedtls_ssl_write sends at most one record per call
+        unsigned sent = 0;
+        while (sent < size) {
+            ret = mbedtls_ssl_write(&_ssl, (const unsigned char *)data + sent, size - sent);
+            if (ret < 0) {
+                break;
+            }
+            sent += ret;
+        }
+
+        if (sent > 0) {
+            ret = sent;
+        } else if (ret < 0) {
+            ret = error(ret);
+        }
+        arena_leave();
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+int TLSSocket::recv(void *data, unsigned size)
+{
+    if (!lock_io()) {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+    int ret;
+
+    if (!_connected) {
+        ret = NSAPI_ERROR_NO_CONNECTION;
+    } else {
+        arena_enter();
+        ret = mbedtls_ssl_read(&_ssl, (unsigned char *)data, size);
+        if (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY || ret == MBEDTLS_ERR_SSL_CONN_EOF) {
+            ret = 0;
+        } else if (ret < 0) {
+            ret = error(ret);
+        }
+        arena_leave();
+    }
+
+    _lock.unlock();
+    return ret;
+}
+
+void TLSSocket::set_blocking(bool blocking)
+{
+    _blocking = blocking;
+    _transport.set_blocking(blocking);
+}
+
+void TLSSocket::set_timeout(int timeout)
+{
+    _blocking = (timeout != 0);
+    _transport.set_timeout(timeout);
+}
+
+void TLSSocket::attach(mbed::Callback<void()> func)
+{
+    _callback = func;
+}
+
+void TLSSocket::event()
+{
+    uint8_t waiting = 1;
+    if (core_util_atomic_cas_u8(&_handshake_waiting, &waiting, 0) && !handshake_post()) {
+        // retried on the next event
+        _handshake_waiting = 1;
+    }
+
+    if (_callback) {
+        _callback();
+    }
+}
+
+int TLSSocket::bio_send(void *ctx, const unsigned char *buf, size_t len)
+{
+    TLSSocket *tls = static_cast<TLSSocket *>(ctx);
+    int ret = tls->_transport.send(buf, len);
+    if (ret == NSAPI_ERROR_WOULD_BLOCK) {
+        return MBEDTLS_ERR_SSL_WANT_WRITE;
+    }
+
+    return ret;
+}
+
+int TLSSocket::bio_recv(void *ctx, unsigned char *buf, size_t len)
+{
+    TLSSocket *tls = static_cast<TLSSocket *>(ctx);
+    int ret = tls->_transport.recv(buf, len);
+    if (ret == NSAPI_ERROR_WOULD_BLOCK) {
+        return MBEDTLS_ERR_SSL_WANT_READ;
+    }
+
+    return ret;
+}
+
+#endif
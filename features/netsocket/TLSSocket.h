@@ -0,0 +1,408 @@
+/** \addtogroup netsocket */
+/** @{*/
+/* TLSSocket
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TLSSOCKET_H
+#define TLSSOCKET_H
+
+#include "mbedtls/config.h"
+
+#if defined(MBEDTLS_SSL_CLI_C) && defined(MBEDTLS_X509_CRT_PARSE_C) && \
+    defined(MBEDTLS_ENTROPY_C) && defined(MBEDTLS_CTR_DRBG_C)
+
+#include "netsocket/TCPSocket.h"
+#include "netsocket/TLSSessionCache.h"
+#include "netsocket/TLSCAStore.h"
+#include "rtos/Mutex.h"
+#include "Callback.h"
+
+#include "mbedtls/ssl.h"
+#include "mbedtls/x509_crt.h"
+#include "mbedtls/pk.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+#include "platform/inc/mbed_arena.h"
+
+// Size of the server name sessions are cached under, longer names are cut
+#define NSAPI_TLS_SESSION_KEY_SIZE 80
+
+
+/** TLS client connection over a TCP socket
+ *
+ *  Records are encrypted and decrypted in the SSL context's own buffers
+ *  and passed straight to and from the TCP socket, without any buffering
+ *  in between. Each of the two record buffers takes
+ *  MBEDTLS_SSL_MAX_CONTENT_LEN bytes, plus some overhead, while the socket
+ *  is connected. When the mbedtls.ssl-max-content-len option makes the
+ *  buffers smaller than a full record, the socket asks the server for
+ *  records that fit with the max fragment length extension.
+ *
+ *  The buffers and the SSL context are set up by connect and released by
+ *  close, so a closed TLSSocket only keeps its certificates.
+ *
+ *  send and recv must not be called concurrently from different threads.
+ *
+ *  Example:
+ *  @code
+ *  TLSSocket tls(&eth);
+ *  tls.set_root_ca_cert(ca_pem);
+ *  if (tls.connect("os.mbed.com", 443) == 0) {
+ *      tls.send(request, sizeof request);
+ *  }
+ *  @endcode
+ */
+class TLSSocket {
+public:
+    /** Create an uninitialized socket
+     *
+     *  Must call open to initialize the socket on a network stack.
+     */
+    TLSSocket();
+
+    /** Create a socket on a network interface
+     *
+     *  Creates and opens a socket on the network stack of the given
+     *  network interface.
+     *
+     *  @param stack    Network stack as target for socket
+     */
+    template <typename S>
+    TLSSocket(S *stack)
+    {
+        init();
+        open(stack);
+    }
+
+    /** Destroy a socket
+     *
+     *  Closes socket if the socket is still open
+     */
+    virtual ~TLSSocket();
+
+    /** Opens a socket
+     *
+     *  @param stack    Network stack as target for socket
+     *  @return         0 on success, negative error code on failure
+     */
+    int open(NetworkStack *stack);
+
+    template <typename S>
+    int open(S *stack) {
+        return open(nsapi_create_stack(stack));
+    }
+
+    /** Close the socket
+     *
+     *  Sends a close notification to the server if the connection is
+     *  established, closes the TCP socket and releases the SSL context.
+     *
+     *  @return         0 on success, negative error code on failure
+     */
+    int close();
+
+    /** Set the CA certificates the server certificate is verified against
+     *
+     *  Can be called several times to add certificates. Server
+     *  certificates are verified by default, so at least one CA
+     *  certificate is needed before connecting.
+     *
+     *  @param cert     Certificate in DER format, or in PEM format
+     *                  including the terminating null character
+     *  @param len      Length of cert in bytes
+     *  @return         0 on success, negative error code on failure
+     */
+    int set_root_ca_cert(const void *cert, size_t len);
+
+    /** Set the CA certificates from a null-terminated PEM string
+     *
+     *  @param pem      Certificates in PEM format
+     *  @return         0 on success, negative error code on failure
+     */
+    int set_root_ca_cert(const char *pem);
+
+    /** Verify the server certificate against a shared store of CA
+     *  certificates
+     *
+     *  The socket holds a reference to the store until it is replaced or
+     *  the socket destroyed. Certificates set with set_root_ca_cert are
+     *  not used while a store is set, and come back into use once it is
+     *  removed.
+     *
+     *  @param store    CA store, NULL to use the socket's own certificates
+     */
+    void set_root_ca_store(TLSCAStore *store);
+
+    /** Set the certificate and key the client authenticates with
+     *
+     *  @param cert     Certificate in DER format, or in PEM format
+     *                  including the terminating null character
+     *  @param cert_len Length of cert in bytes
+     *  @param key      Private key in DER format, or in PEM format
+     *                  including the terminating null character
+     *  @param key_len  Length of key in bytes
+     *  @return         0 on success, negative error code on failure
+     */
+    int set_client_cert_key(const void *cert, size_t cert_len,
+                            const void *key, size_t key_len);
+
+    /** Set the largest record the server is asked to send
+     *
+     *  Uses the max fragment length extension, the length is rounded down
+     *  to 512, 1024, 2048 or 4096 bytes. A length of 0 or 16384 and above
+     *  does not use the extension. By default the records are limited to
+     *  MBEDTLS_SSL_MAX_CONTENT_LEN. Servers that do not support the
+     *  extension may still send larger records, which fail the connection
+     *  if they do not fit the buffers.
+     *
+     *  @param len      Largest record payload in bytes
+     *  @return         0 on success, negative error code on failure
+     */
+    int set_max_fragment_length(unsigned len);
+
+    /** Let the SSL context allocate from a buffer of its own
+     *
+     *  connect allocates a buffer of the given size from the heap, and the
+     *  SSL context and the handshake allocate all their memory from it
+     *  until close releases it at once, so sessions do not fragment the
+     *  heap. close fails with NSAPI_ERROR_DEVICE_ERROR, and keeps the
+     *  buffer for the next connection, if blocks are still allocated from
+     *  it, destroying the socket in that state is a fatal error.
+     *  Operations fail with NSAPI_ERROR_NO_MEMORY once the buffer is full,
+     *  get_arena_peak tells the size a session needed. Certificates and
+     *  keys set on the socket stay on the heap. Needs the mbedtls.arena
+     *  option.
+     *
+     *  @param size     Size of the buffer in bytes, 0 to allocate from the
+     *                  heap, takes effect with the next connection
+     *  @return         0 on success, negative error code on failure
+     */
+    int set_arena_size(size_t size);
+
+    /** Get the peak use of the buffer set with set_arena_size
+     *
+     *  @return         Largest number of bytes of the buffer used by the
+     *                  current or last connection, 0 without a buffer
+     */
+    size_t get_arena_peak() const;
+
+    /** Set the cache sessions are resumed from
+     *
+     *  Before connecting, the session stored for the same hostname, or
+     *  address if connecting without a hostname, and port is offered to
+     *  the server. Established sessions are stored in the cache, sessions
+     *  the server fails to authenticate are removed.
+     *
+     *  @param cache    Session cache, NULL to not resume sessions
+     */
+    void set_session_cache(TLSSessionCache *cache);
+
+    /** Run the handshake of non-blocking connects on a worker thread
+     *
+     *  The public key operations of a handshake can take seconds, during
+     *  which a non-blocking connect would hold up its calling thread. With
+     *  the asynchronous handshake, connect returns
+     *  NSAPI_ERROR_WOULD_BLOCK at once and the handshake runs on a low
+     *  priority thread shared by all TLSSockets, a message at a time as
+     *  the server's records arrive. The callback set with attach is called
+     *  from the worker once it is over, and the next connect returns its
+     *  result. Like the other calls of the callback, it must not call the
+     *  socket itself, close aside, but signal the thread using it. Blocking
+     *  sockets always run the handshake on the calling thread.
+     *
+     *  While the handshake runs, send and recv return
+     *  NSAPI_ERROR_WOULD_BLOCK. close waits for the current message of
+     *  the handshake to be processed. Called by the callback at the end
+     *  of the handshake, close drops the job queued on the worker instead,
+     *  and the socket may be destroyed there too.
+     *
+     *  @param enabled  true to run handshakes on the worker thread
+     *  @return         0 on success, negative error code on failure
+     */
+    int set_async_handshake(bool enabled);
+
+    /** Connects to a remote host and performs the TLS handshake
+     *
+     *  The hostname is also used to verify the server certificate and as
+     *  the server name indication.
+     *
+     *  In non-blocking mode connect returns NSAPI_ERROR_WOULD_BLOCK while
+     *  the handshake is in progress, and is called again to continue it.
+     *
+     *  @param host     Hostname of the remote host
+     *  @param port     Port of the remote host
+     *  @return         0 on success, negative error code on failure
+     */
+    int connect(const char *host, uint16_t port);
+
+    /** Connects to a remote address and performs the TLS handshake
+     *
+     *  @param address  The SocketAddress of the remote host
+     *  @param hostname Name the server certificate is verified against,
+     *                  NULL to skip the name check
+     *  @return         0 on success, negative error code on failure
+     */
+    int connect(const SocketAddress &address, const char *hostname = NULL);
+
+    /** Send data over the TLS connection
+     *
+     *  Data is split into records of at most the negotiated fragment
+     *  length. In blocking mode send returns once all data is sent.
+     *
+     *  If send returns NSAPI_ERROR_WOULD_BLOCK while a record is partly
+     *  written to the TCP socket, it must be called again with the same
+     *  data to finish the record.
+     *
+     *  @param data     Buffer of data to send to the host
+     *  @param size     Size of the buffer in bytes
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int send(const void *data, unsigned size);
+
+    /** Receive data over the TLS connection
+     *
+     *  Returns data from at most one record at a time.
+     *
+     *  @param data     Destination buffer for data received from the host
+     *  @param size     Size of the buffer in bytes
+     *  @return         Number of received bytes on success, 0 if the
+     *                  server closed the connection, negative error code
+     *                  on failure
+     */
+    int recv(void *data, unsigned size);
+
+    /** Set blocking or non-blocking mode of the socket
+     *
+     *  @param blocking true for blocking mode, false for non-blocking mode.
+     */
+    void set_blocking(bool blocking);
+
+    /** Set timeout on blocking socket operations
+     *
+     *  The timeout applies to every read and write of the TCP socket, a
+     *  handshake may take several of them.
+     *
+     *  @param timeout  Timeout in milliseconds
+     */
+    void set_timeout(int timeout);
+
+    /** Register a callback on state change of the socket
+     *
+     *  Called on state changes of the TCP socket. Not every call means
+     *  that a whole record can be received.
+     *
+     *  @param func     Function to call on state change
+     */
+    void attach(mbed::Callback<void()> func);
+
+    /** Get the mbedtls error of the last failed operation
+     *
+     *  @return         Negative mbedtls error code, 0 if none
+     */
+    int get_tls_error() const
+    {
+        return _tls_error;
+    }
+
+    /** Get the SSL configuration
+     *
+     *  Allows settings without a TLSSocket method, such as the cipher
+     *  suites or the verification mode, to be changed before connecting.
+     *
+     *  @return         SSL configuration of the socket
+     */
+    mbedtls_ssl_config *get_ssl_config()
+    {
+        return &_conf;
+    }
+
+    /** Get the underlying TCP socket
+     *
+     *  @return         TCP socket carrying the records
+     */
+    TCPSocket *get_transport()
+    {
+        return &_transport;
+    }
+
+protected:
+    void init();
+    void set_session_key(const char *name, uint16_t port);
+    int setup(const char *hostname);
+    int handshake();
+    int handshake_result(int ret);
+    int handshake_async();
+    bool handshake_post();
+    void handshake_job();
+    void handshake_cancel();
+    bool lock_io();
+    int error(int ret);
+    void event();
+    int arena_setup();
+    int arena_release();
+    void arena_enter();
+    void arena_leave();
+
+    static int bio_send(void *ctx, const unsigned char *buf, size_t len);
+    static int bio_recv(void *ctx, unsigned char *buf, size_t len);
+
+    TCPSocket _transport;
+    rtos::Mutex _lock;
+    mbed::Callback<void()> _callback;
+
+    mbedtls_ssl_context _ssl;
+    mbedtls_ssl_config _conf;
+    mbedtls_x509_crt _cacert;
+    mbedtls_x509_crt _own_cert;
+    mbedtls_pk_context _own_key;
+    mbedtls_entropy_context _entropy;
+    mbedtls_ctr_drbg_context _drbg;
+
+    mbedtls_arena _arena;
+    void *_arena_buf;
+    size_t _arena_size;
+
+    TLSCAStore *_ca_store;
+    TLSSessionCache *_session_cache;
+    char _session_key[NSAPI_TLS_SESSION_KEY_SIZE];
+
+    bool _seeded;
+    bool _setup;
+    bool _tcp_connected;
+    bool _connected;
+    bool _blocking;
+    int _tls_error;
+
+    bool _async_handshake;
+    uint8_t _handshake_state;
+    uint8_t _handshake_waiting;     // A record is awaited, the next event posts a job
+    uint32_t _handshake_jobs;       // Jobs posted to the worker and not over
+    int _handshake_queued;          // Id of the job queued behind the running one
+    int _handshake_ret;
+
+private:
+    /* disallow copy constructor and assignment operators */
+    TLSSocket(const TLSSocket &);
+    TLSSocket &operator=(const TLSSocket &);
+};
+
+
+#endif
+
+#endif
+
+/** @}*/
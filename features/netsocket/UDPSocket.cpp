@@ -17,6 +17,7 @@
 #include "UDPSocket.h"
 #include "Timer.h"
 #include "mbed_assert.h"
+#include <string.h>
 
 UDPSocket::UDPSocket()
     : _pending(0), _read_sem(0), _write_sem(0),
@@ -29,6 +30,26 @@ UDPSocket::~UDPSocket()
     close();
 }
 
+int UDPSocket::join_multicast_group(const SocketAddress &address)
+{
+    nsapi_ip_mreq_t mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.imr_multiaddr = address.get_addr();
+    mreq.imr_interface.version = NSAPI_UNSPEC;
+
+    return setsockopt(NSAPI_SOCKET, NSAPI_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
+}
+
+int UDPSocket::leave_multicast_group(const SocketAddress &address)
+{
+    nsapi_ip_mreq_t mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.imr_multiaddr = address.get_addr();
+    mreq.imr_interface.version = NSAPI_UNSPEC;
+
+    return setsockopt(NSAPI_SOCKET, NSAPI_DROP_MEMBERSHIP, &mreq, sizeof(mreq));
+}
+
 nsapi_protocol_t UDPSocket::get_proto()
 {
     return NSAPI_UDP;
@@ -136,6 +157,291 @@ int UDPSocket::recvfrom(SocketAddress *address, void *buffer, unsigned size)
     return ret;
 }
 
+int UDPSocket::sendto(const SocketAddress &address, const NetBuffer &buf)
+{
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a send at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_write_in_progress);
+    _write_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        if (buf.empty() || buf._stack != _stack) {
+            ret = NSAPI_ERROR_PARAMETER;
+            break;
+        }
+
+        _pending = 0;
+        int sent = _stack->socket_sendto_buf(_socket, address, buf._buf);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != sent)) {
+            ret = sent;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _write_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _write_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
+int UDPSocket::recvfrom(SocketAddress *address, NetBuffer *buf)
+{
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a recv at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_read_in_progress);
+    _read_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        nsapi_buf_t handle = 0;
+        int recv = _stack->socket_recvfrom_buf(_socket, address, &handle);
+        if (recv >= 0 && handle) {
+            buf->attach(_stack, handle, recv);
+        }
+
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != recv)) {
+            ret = recv;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _read_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _read_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
+int UDPSocket::sendmsg(const SocketAddress &address, const nsapi_iovec_t *iov, unsigned iovcnt)
+{
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a send at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_write_in_progress);
+    _write_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        int sent = _stack->socket_sendmsg(_socket, &address, iov, iovcnt);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != sent)) {
+            ret = sent;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _write_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _write_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
+int UDPSocket::recvmsg(SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt, int *flags)
+{
+    // a source address tells the stack that a packet is to be received
+    SocketAddress source;
+    if (!address) {
+        address = &source;
+    }
+
+    int no_flags;
+    if (!flags) {
+        flags = &no_flags;
+    }
+
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a recv at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_read_in_progress);
+    _read_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        int recv = _stack->socket_recvmsg(_socket, address, iov, iovcnt, flags);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != recv)) {
+            ret = recv;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _read_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _read_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
+int UDPSocket::sendmmsg(nsapi_mmsg_t *msgs, unsigned msgcnt)
+{
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a send at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_write_in_progress);
+    _write_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        int sent = _stack->socket_sendmmsg(_socket, msgs, msgcnt);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != sent)) {
+            ret = sent;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _write_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _write_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
+int UDPSocket::recvmmsg(nsapi_mmsg_t *msgs, unsigned msgcnt)
+{
+    _lock.lock();
+    int ret;
+
+    // If this assert is hit then there are two threads
+    // performing a recv at the same time which is undefined
+    // behavior
+    MBED_ASSERT(!_read_in_progress);
+    _read_in_progress = true;
+
+    while (true) {
+        if (!_socket) {
+            ret = NSAPI_ERROR_NO_SOCKET;
+            break;
+        }
+
+        _pending = 0;
+        int recv = _stack->socket_recvmmsg(_socket, msgs, msgcnt);
+        if ((0 == _timeout) || (NSAPI_ERROR_WOULD_BLOCK != recv)) {
+            ret = recv;
+            break;
+        } else {
+            int32_t count;
+
+            // Release lock before blocking so other threads
+            // accessing this object aren't blocked
+            _lock.unlock();
+            count = _read_sem.wait(_timeout);
+            _lock.lock();
+
+            if (count < 1) {
+                // Semaphore wait timed out so break out and return
+                ret = NSAPI_ERROR_WOULD_BLOCK;
+                break;
+            }
+        }
+    }
+
+    _read_in_progress = false;
+    _lock.unlock();
+    return ret;
+}
+
 void UDPSocket::event()
 {
     int32_t wcount = _write_sem.wait(0);
@@ -23,6 +23,7 @@
 #include "netsocket/Socket.h"
 #include "netsocket/NetworkStack.h"
 #include "netsocket/NetworkInterface.h"
+#include "netsocket/NetBuffer.h"
 #include "rtos/Semaphore.h"
 
 
@@ -110,6 +111,131 @@ public:
      */
     int recvfrom(SocketAddress *address, void *data, unsigned size);
 
+    /** Send a network buffer as a packet over a UDP socket
+     *
+     *  Sends the buffer to the specified address without copying its
+     *  contents. The buffer must have been allocated on the socket's stack
+     *  and can be sent again or released afterwards.
+     *
+     *  By default, sendto blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param address  The SocketAddress of the remote host
+     *  @param buf      Network buffer to send to the host
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int sendto(const SocketAddress &address, const NetBuffer &buf);
+
+    /** Receive a packet as a network buffer over a UDP socket
+     *
+     *  Receives a packet and stores the source address in address if
+     *  address is not NULL. The stack's receive buffer is handed over
+     *  instead of being copied, any buffer previously held by buf is
+     *  released.
+     *
+     *  By default, recvfrom blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param address  Destination for the source address or NULL
+     *  @param buf      Destination for the network buffer received from
+     *                  the host
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    int recvfrom(SocketAddress *address, NetBuffer *buf);
+
+    /** Send a packet gathered from several buffers over a UDP socket
+     *
+     *  The buffers are sent to the specified address as a single packet,
+     *  without first copying them together, so that for example a header,
+     *  a payload and a trailer can stay in separate buffers.
+     *
+     *  By default, sendmsg blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param address  The SocketAddress of the remote host
+     *  @param iov      Array of buffers making up the packet
+     *  @param iovcnt   Number of buffers in the array
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int sendmsg(const SocketAddress &address, const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive a packet scattered into several buffers over a UDP socket
+     *
+     *  The buffers are filled in order with a single packet. The source
+     *  address is stored in address and NSAPI_MSG_TRUNC is set in flags if
+     *  the packet was larger than the buffers and was truncated.
+     *
+     *  By default, recvmsg blocks until data is sent. If socket is set to
+     *  non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK is returned
+     *  immediately.
+     *
+     *  @param address  Destination for the source address or NULL
+     *  @param iov      Array of destination buffers for the packet
+     *  @param iovcnt   Number of buffers in the array
+     *  @param flags    Destination for the message flags or NULL
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    int recvmsg(SocketAddress *address, const nsapi_iovec_t *iov, unsigned iovcnt, int *flags = 0);
+
+    /** Send several packets over a UDP socket
+     *
+     *  The packets are handed to the stack in a single call and sent in
+     *  order, each to its own address. The len of each packet sent is set.
+     *
+     *  By default, sendmmsg blocks until at least one packet is sent. If
+     *  socket is set to non-blocking or times out, NSAPI_ERROR_WOULD_BLOCK
+     *  is returned immediately.
+     *
+     *  @param msgs     Array of packets to send
+     *  @param msgcnt   Number of packets in the array
+     *  @return         Number of sent packets on success, negative error
+     *                  code on failure
+     */
+    int sendmmsg(nsapi_mmsg_t *msgs, unsigned msgcnt);
+
+    /** Receive several packets over a UDP socket
+     *
+     *  All the packets queued on the socket are received in a single call
+     *  to the stack, up to the number of buffers. The source, len and
+     *  flags of each packet received are set; NSAPI_MSG_TRUNC is set in
+     *  flags if the packet was larger than its buffer.
+     *
+     *  By default, recvmmsg blocks until at least one packet is received.
+     *  If socket is set to non-blocking or times out,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param msgs     Array of buffers for the packets
+     *  @param msgcnt   Number of buffers in the array
+     *  @return         Number of received packets on success, negative
+     *                  error code on failure
+     */
+    int recvmmsg(nsapi_mmsg_t *msgs, unsigned msgcnt);
+
+    /** Join a multicast group
+     *
+     *  Packets sent to the group are received by the socket, on every
+     *  interface of the stack. Stacks ask the interface to let the group
+     *  through its hardware filter, instead of receiving all multicast.
+     *
+     *  @param address  IP address of the group, the port is ignored
+     *  @return         0 on success, negative error code on failure
+     */
+    int join_multicast_group(const SocketAddress &address);
+
+    /** Leave a multicast group
+     *
+     *  @param address  IP address of the group, the port is ignored
+     *  @return         0 on success, negative error code on failure
+     */
+    int leave_multicast_group(const SocketAddress &address);
+
 protected:
     virtual nsapi_protocol_t get_proto();
     virtual void event();
@@ -40,6 +40,9 @@
 #include "netsocket/UDPSocket.h"
 #include "netsocket/TCPSocket.h"
 #include "netsocket/TCPServer.h"
+#include "netsocket/TLSSocket.h"
+#include "netsocket/NetBuffer.h"
+#include "netsocket/SocketPoll.h"
 
 #endif
 
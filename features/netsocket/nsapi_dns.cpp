@@ -16,6 +16,12 @@
  */
 #include "nsapi_dns.h"
 #include "netsocket/UDPSocket.h"
+#include "drivers/Timer.h"
+#include "events/EventQueue.h"
+#include "rtos/Thread.h"
+#include "rtos/Semaphore.h"
+#include "platform/PlatformMutex.h"
+#include "platform/SingletonPtr.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -25,10 +31,33 @@
 #define RR_A 1
 #define RR_AAAA 28
 
+#ifndef MBED_CONF_NSAPI_DNS_CACHE_SIZE
+#define MBED_CONF_NSAPI_DNS_CACHE_SIZE 4
+#endif
+
+#ifndef MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES
+#define MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES 2
+#endif
+
+#ifndef MBED_CONF_NSAPI_DNS_CACHE_MAX_TTL
+#define MBED_CONF_NSAPI_DNS_CACHE_MAX_TTL 3600
+#endif
+
+#ifndef MBED_CONF_NSAPI_DNS_THREAD_STACK_SIZE
+#define MBED_CONF_NSAPI_DNS_THREAD_STACK_SIZE 2048
+#endif
+
 // DNS options
 #define DNS_BUFFER_SIZE 512
 #define DNS_TIMEOUT 5000
 #define DNS_SERVERS_SIZE 5
+#define DNS_HOST_NAME_MAX_LEN 128
+#define DNS_CACHE_SIZE MBED_CONF_NSAPI_DNS_CACHE_SIZE
+#define DNS_CACHE_ADDRESSES MBED_CONF_NSAPI_DNS_CACHE_ADDRESSES
+#define DNS_CACHE_MAX_TTL MBED_CONF_NSAPI_DNS_CACHE_MAX_TTL
+#define DNS_QUERIES_SIZE 4
+#define DNS_ASYNC_QUEUE_SIZE 4
+#define DNS_THREAD_STACK_SIZE MBED_CONF_NSAPI_DNS_THREAD_STACK_SIZE
 
 nsapi_addr_t dns_servers[DNS_SERVERS_SIZE] = {
     {NSAPI_IPv4, {8, 8, 8, 8}},
@@ -48,6 +77,10 @@ extern "C" int nsapi_dns_add_server(nsapi_addr_t addr)
     return 0;
 }
 
+// protects the cache and the in-flight queries
+static SingletonPtr<PlatformMutex> dns_mutex;
+static uint16_t dns_id = 0;
+
 
 // DNS packet parsing
 static void dns_append_byte(uint8_t **p, uint8_t byte)
@@ -82,10 +115,10 @@ static uint16_t dns_scan_word(const uint8_t **p)
 }
 
 
-static void dns_append_question(uint8_t **p, const char *host, nsapi_version_t version)
+static void dns_append_question(uint8_t **p, uint16_t id, const char *host, nsapi_version_t version)
 {
     // fill the header
-    dns_append_word(p, 1);      // id      = 1
+    dns_append_word(p, id);     // id
     dns_append_word(p, 0x0100); // flags   = recursion required
     dns_append_word(p, 1);      // qdcount = 1
     dns_append_word(p, 0);      // ancount = 0
@@ -110,7 +143,17 @@ static void dns_append_question(uint8_t **p, const char *host, nsapi_version_t v
     dns_append_word(p, CLASS_IN);
 }
 
-static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned addr_count)
+static uint32_t dns_scan_dword(const uint8_t **p)
+{
+    uint32_t a = dns_scan_word(p);
+    uint32_t b = dns_scan_word(p);
+    return (a << 16) | b;
+}
+
+// returns the number of addresses found, 0 if the query failed, or -1 if
+// the packet is not a response to the query with the given id
+static int dns_scan_response(const uint8_t **p, uint16_t query_id,
+        nsapi_addr_t *addr, unsigned addr_count, uint32_t *ttl)
 {
     // scan header
     uint16_t id    = dns_scan_word(p);
@@ -125,7 +168,11 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
     dns_scan_word(p);                    // arcount
 
     // verify header is response to query
-    if (!(id == 1 && qr && opcode == 0 && rcode == 0)) {
+    if (!(id == query_id && qr && opcode == 0)) {
+        return -1;
+    }
+
+    if (rcode != 0) {
         return 0;
     }
 
@@ -146,6 +193,7 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
 
     // scan each response
     unsigned count = 0;
+    *ttl = 0xffffffff;
 
     for (int i = 0; i < ancount && count < addr_count; i++) {
         while (true) {
@@ -162,7 +210,7 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
 
         uint16_t rtype    = dns_scan_word(p); // rtype
         uint16_t rclass   = dns_scan_word(p); // rclass
-        *p += 4;                              // ttl
+        uint32_t rttl     = dns_scan_dword(p); // ttl
         uint16_t rdlength = dns_scan_word(p); // rdlength
 
         if (rtype == RR_A && rclass == CLASS_IN && rdlength == NSAPI_IPv4_BYTES) {
@@ -174,6 +222,7 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
 
             addr += 1;
             count += 1;
+            *ttl = rttl < *ttl ? rttl : *ttl;
         } else if (rtype == RR_AAAA && rclass == CLASS_IN && rdlength == NSAPI_IPv6_BYTES) {
             // accept AAAA record
             addr->version = NSAPI_IPv6;
@@ -183,6 +232,7 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
 
             addr += 1;
             count += 1;
+            *ttl = rttl < *ttl ? rttl : *ttl;
         } else {
             // skip unrecognized records
             *p += rdlength;
@@ -192,16 +242,164 @@ static int dns_scan_response(const uint8_t **p, nsapi_addr_t *addr, unsigned add
     return count;
 }
 
-// core query function
-static int nsapi_dns_query_multiple(NetworkStack *stack, const char *host,
-        nsapi_addr_t *addr, unsigned addr_count, nsapi_version_t version)
+#if DNS_CACHE_SIZE > 0
+// DNS cache, entries expire after the smallest TTL of their records
+static struct dns_cache_entry {
+    char *host;
+    nsapi_version_t version;
+    nsapi_addr_t addr[DNS_CACHE_ADDRESSES];
+    unsigned count;
+    unsigned stamp;
+    unsigned ttl;
+} dns_cache[DNS_CACHE_SIZE];
+
+static bool dns_cache_expired(const dns_cache_entry *entry, unsigned now)
 {
-    // check for valid host name
-    int host_len = host ? strlen(host) : 0;
-    if (host_len > 128 || host_len == 0) {
-        return NSAPI_ERROR_PARAMETER;
+    return !entry->host || now - entry->stamp >= entry->ttl;
+}
+
+static int dns_cache_find(const char *host, nsapi_version_t version,
+        nsapi_addr_t *addr, unsigned addr_count)
+{
+    unsigned now = equeue_tick();
+
+    for (unsigned i = 0; i < DNS_CACHE_SIZE; i++) {
+        dns_cache_entry *entry = &dns_cache[i];
+        if (dns_cache_expired(entry, now)
+                || entry->version != version
+                || strcmp(entry->host, host) != 0) {
+            continue;
+        }
+
+        // a full entry may have been cut short, only trust it for
+        // requests it can answer completely
+        if (entry->count == DNS_CACHE_ADDRESSES && addr_count > DNS_CACHE_ADDRESSES) {
+            return 0;
+        }
+
+        unsigned count = entry->count < addr_count ? entry->count : addr_count;
+        memcpy(addr, entry->addr, count*sizeof(nsapi_addr_t));
+        return count;
+    }
+
+    return 0;
+}
+
+static void dns_cache_add(const char *host, nsapi_version_t version,
+        const nsapi_addr_t *addr, unsigned count, uint32_t ttl)
+{
+    if (ttl > DNS_CACHE_MAX_TTL) {
+        ttl = DNS_CACHE_MAX_TTL;
     }
 
+    if (ttl == 0) {
+        return;
+    }
+
+    // reuse an entry for the same host, an expired entry, or the entry
+    // closest to expiring
+    unsigned now = equeue_tick();
+    dns_cache_entry *entry = &dns_cache[0];
+
+    for (unsigned i = 0; i < DNS_CACHE_SIZE; i++) {
+        dns_cache_entry *e = &dns_cache[i];
+        if (e->host && e->version == version && strcmp(e->host, host) == 0) {
+            entry = e;
+            break;
+        }
+
+        if (dns_cache_expired(e, now)) {
+            entry = e;
+        } else if (!dns_cache_expired(entry, now)
+                && e->ttl - (now - e->stamp) < entry->ttl - (now - entry->stamp)) {
+            entry = e;
+        }
+    }
+
+    if (!entry->host || strcmp(entry->host, host) != 0) {
+        free(entry->host);
+        entry->host = (char *)malloc(strlen(host) + 1);
+        if (!entry->host) {
+            return;
+        }
+
+        strcpy(entry->host, host);
+    }
+
+    entry->version = version;
+    entry->count = count < DNS_CACHE_ADDRESSES ? count : DNS_CACHE_ADDRESSES;
+    memcpy(entry->addr, addr, entry->count*sizeof(nsapi_addr_t));
+    entry->stamp = now;
+    entry->ttl = ttl*1000;
+}
+#else
+static int dns_cache_find(const char *host, nsapi_version_t version,
+        nsapi_addr_t *addr, unsigned addr_count)
+{
+    return 0;
+}
+
+static void dns_cache_add(const char *host, nsapi_version_t version,
+        const nsapi_addr_t *addr, unsigned count, uint32_t ttl)
+{
+}
+#endif
+
+// Queries in flight, so concurrent requests for the same host wait for
+// the first one instead of sending their own queries
+struct dns_query {
+    const char *host;
+    nsapi_version_t version;
+    bool in_use;
+    bool done;
+    unsigned waiters;
+    int result;
+    nsapi_addr_t addr[DNS_CACHE_ADDRESSES];
+    rtos::Semaphore finished;
+};
+
+struct dns_query_pool {
+    dns_query queries[DNS_QUERIES_SIZE];
+};
+
+static SingletonPtr<dns_query_pool> dns_queries;
+
+static dns_query *dns_query_find(const char *host, nsapi_version_t version)
+{
+    for (unsigned i = 0; i < DNS_QUERIES_SIZE; i++) {
+        dns_query *query = &dns_queries->queries[i];
+        if (query->in_use && !query->done
+                && query->version == version
+                && strcmp(query->host, host) == 0) {
+            return query;
+        }
+    }
+
+    return 0;
+}
+
+static dns_query *dns_query_alloc(const char *host, nsapi_version_t version)
+{
+    for (unsigned i = 0; i < DNS_QUERIES_SIZE; i++) {
+        dns_query *query = &dns_queries->queries[i];
+        if (!query->in_use) {
+            query->host = host;
+            query->version = version;
+            query->in_use = true;
+            query->done = false;
+            query->waiters = 0;
+            return query;
+        }
+    }
+
+    return 0;
+}
+
+// sends the question to every dns server at once and takes the first
+// answer that resolves the host
+static int nsapi_dns_query_servers(NetworkStack *stack, const char *host,
+        nsapi_addr_t *addr, unsigned addr_count, nsapi_version_t version, uint32_t *ttl)
+{
     // create a udp socket
     UDPSocket socket;
     int err = socket.open(stack);
@@ -217,37 +415,60 @@ static int nsapi_dns_query_multiple(NetworkStack *stack, const char *host,
         return NSAPI_ERROR_NO_MEMORY;
     }
 
-    int result = NSAPI_ERROR_OK;
+    dns_mutex->lock();
+    uint16_t id = ++dns_id;
+    dns_mutex->unlock();
 
-    // check against each dns server
-    for (unsigned i = 0; i < DNS_SERVERS_SIZE; i++) {
-        // send the question
-        uint8_t *question = packet;
-        dns_append_question(&question, host, version);
+    uint8_t *question = packet;
+    dns_append_question(&question, id, host, version);
 
-        err = socket.sendto(SocketAddress(dns_servers[i], 53), packet, DNS_BUFFER_SIZE);
-        if (err == NSAPI_ERROR_WOULD_BLOCK) {
-            continue;
-        } else if (err < 0) {
+    int result = NSAPI_ERROR_DNS_FAILURE;
+    unsigned sent = 0;
+
+    // send the question to each dns server
+    for (unsigned i = 0; i < DNS_SERVERS_SIZE; i++) {
+        err = socket.sendto(SocketAddress(dns_servers[i], 53), packet, question - packet);
+        if (err >= 0) {
+            sent += 1;
+        } else if (err != NSAPI_ERROR_WOULD_BLOCK) {
             result = err;
+        }
+    }
+
+    // recv responses until one resolves the host, every server has
+    // answered, or the timeout expires
+    mbed::Timer timer;
+    timer.start();
+
+    for (unsigned answered = 0; answered < sent;) {
+        int remaining = DNS_TIMEOUT - timer.read_ms();
+        if (remaining <= 0) {
             break;
         }
 
-        // recv the response
+        socket.set_timeout(remaining);
         err = socket.recvfrom(NULL, packet, DNS_BUFFER_SIZE);
         if (err == NSAPI_ERROR_WOULD_BLOCK) {
-            continue;
+            break;
         } else if (err < 0) {
             result = err;
             break;
         }
 
         const uint8_t *response = packet;
-        if (!dns_scan_response(&response, addr, addr_count)) {
-            result = NSAPI_ERROR_DNS_FAILURE;
-        } else {
+        int count = dns_scan_response(&response, id, addr, addr_count, ttl);
+        if (count < 0) {
+            // stale response to an earlier query
+            continue;
+        }
+
+        answered += 1;
+        if (count > 0) {
+            result = count;
             break;
         }
+
+        result = NSAPI_ERROR_DNS_FAILURE;
     }
 
     // clean up packet
@@ -263,6 +484,105 @@ static int nsapi_dns_query_multiple(NetworkStack *stack, const char *host,
     return result;
 }
 
+// core query function
+static int nsapi_dns_query_multiple(NetworkStack *stack, const char *host,
+        nsapi_addr_t *addr, unsigned addr_count, nsapi_version_t version)
+{
+    // check for valid host name
+    int host_len = host ? strlen(host) : 0;
+    if (host_len > DNS_HOST_NAME_MAX_LEN || host_len == 0) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    dns_mutex->lock();
+
+    int result = dns_cache_find(host, version, addr, addr_count);
+    if (result > 0) {
+        dns_mutex->unlock();
+        return result;
+    }
+
+    // join a query for the same host if its answer is large enough
+    dns_query *query = 0;
+    if (addr_count <= DNS_CACHE_ADDRESSES) {
+        query = dns_query_find(host, version);
+    }
+
+    if (query) {
+        query->waiters += 1;
+        dns_mutex->unlock();
+        query->finished.wait();
+        dns_mutex->lock();
+
+        result = query->result;
+        if (result > (int)addr_count) {
+            result = addr_count;
+        }
+
+        if (result > 0) {
+            memcpy(addr, query->addr, result*sizeof(nsapi_addr_t));
+        }
+
+        // the last one out releases the query
+        query->waiters -= 1;
+        if (query->waiters == 0) {
+            query->in_use = false;
+        }
+
+        dns_mutex->unlock();
+        return result;
+    }
+
+    query = dns_query_alloc(host, version);
+    dns_mutex->unlock();
+
+    // ask for enough addresses to fill the cache and any joined requests
+    nsapi_addr_t cache_addr[DNS_CACHE_ADDRESSES];
+    nsapi_addr_t *query_addr = addr;
+    unsigned query_count = addr_count;
+    if (addr_count < DNS_CACHE_ADDRESSES) {
+        query_addr = cache_addr;
+        query_count = DNS_CACHE_ADDRESSES;
+    }
+
+    uint32_t ttl = 0;
+    result = nsapi_dns_query_servers(stack, host, query_addr, query_count, version, &ttl);
+
+    dns_mutex->lock();
+
+    if (result > 0) {
+        dns_cache_add(host, version, query_addr, result, ttl);
+    }
+
+    if (query) {
+        query->result = result < DNS_CACHE_ADDRESSES ? result : DNS_CACHE_ADDRESSES;
+        if (result > 0) {
+            memcpy(query->addr, query_addr, query->result*sizeof(nsapi_addr_t));
+        }
+
+        query->done = true;
+        if (query->waiters == 0) {
+            query->in_use = false;
+        }
+
+        for (unsigned i = 0; i < query->waiters; i++) {
+            query->finished.release();
+        }
+    }
+
+    dns_mutex->unlock();
+
+    if (result > (int)addr_count) {
+        result = addr_count;
+    }
+
+    if (result > 0 && query_addr != addr) {
+        memcpy(addr, query_addr, result*sizeof(nsapi_addr_t));
+    }
+
+    return result;
+}
+
 // convenience functions for other forms of queries
 extern "C" int nsapi_dns_query_multiple(nsapi_stack_t *stack, const char *host,
         nsapi_addr_t *addr, unsigned addr_count, nsapi_version_t version)
@@ -303,3 +623,68 @@ int nsapi_dns_query(NetworkStack *stack, const char *host,
     address->set_addr(addr);
     return (result > 0) ? 0 : result;
 }
+
+// asynchronous queries run one at a time on a shared resolver thread
+struct dns_async_job {
+    NetworkStack *stack;
+    char *host;
+    nsapi_version_t version;
+    nsapi_dns_callback_t callback;
+};
+
+static events::EventQueue *dns_async_queue = 0;
+static rtos::Thread *dns_async_thread = 0;
+
+static void nsapi_dns_query_job(dns_async_job *job)
+{
+    SocketAddress address;
+    int err;
+    if (job->version == NSAPI_UNSPEC) {
+        err = job->stack->gethostbyname(job->host, &address);
+    } else {
+        err = job->stack->gethostbyname(job->host, &address, job->version);
+    }
+
+    job->callback((nsapi_error_t)err, err ? NULL : &address);
+
+    free(job->host);
+    delete job;
+}
+
+int nsapi_dns_query_async(NetworkStack *stack, const char *host,
+        nsapi_dns_callback_t callback, nsapi_version_t version)
+{
+    int host_len = host ? strlen(host) : 0;
+    if (host_len > DNS_HOST_NAME_MAX_LEN || host_len == 0 || !callback) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    dns_mutex->lock();
+    if (!dns_async_queue) {
+        dns_async_queue = new events::EventQueue(DNS_ASYNC_QUEUE_SIZE*EVENTS_EVENT_SIZE);
+        dns_async_thread = new rtos::Thread(osPriorityNormal, DNS_THREAD_STACK_SIZE);
+        dns_async_thread->start(mbed::callback(dns_async_queue,
+                &events::EventQueue::dispatch_forever));
+    }
+    dns_mutex->unlock();
+
+    dns_async_job *job = new dns_async_job;
+    job->host = (char *)malloc(host_len + 1);
+    if (!job->host) {
+        delete job;
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    strcpy(job->host, host);
+    job->stack = stack;
+    job->version = version;
+    job->callback = callback;
+
+    if (!dns_async_queue->call(nsapi_dns_query_job, job)) {
+        free(job->host);
+        delete job;
+        return NSAPI_ERROR_NO_MEMORY;
+    }
+
+    return 0;
+}
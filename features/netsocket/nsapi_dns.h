@@ -148,6 +148,38 @@ int nsapi_dns_query_multiple(S *stack, const char *host,
                 host, addr, addr_count, version);
 }
 
+/** Query for an IP address of a given hostname without blocking
+ *
+ *  The query runs on a shared resolver thread using the stack's
+ *  gethostbyname, and the callback is called from that thread with the
+ *  result.
+ *
+ *  @param stack    Network stack as target for DNS query
+ *  @param host     Hostname to resolve
+ *  @param callback Callback called with the result of the query
+ *  @param version  IP version to resolve, NSAPI_UNSPEC accepts any
+ *                  version (defaults to NSAPI_UNSPEC)
+ *  @return         0 if the query was started, negative error code on failure
+ */
+int nsapi_dns_query_async(NetworkStack *stack, const char *host,
+        nsapi_dns_callback_t callback, nsapi_version_t version = NSAPI_UNSPEC);
+
+/** Query for an IP address of a given hostname without blocking
+ *
+ *  @param stack    Network stack as target for DNS query
+ *  @param host     Hostname to resolve
+ *  @param callback Callback called with the result of the query
+ *  @param version  IP version to resolve, NSAPI_UNSPEC accepts any
+ *                  version (defaults to NSAPI_UNSPEC)
+ *  @return         0 if the query was started, negative error code on failure
+ */
+template <typename S>
+int nsapi_dns_query_async(S *stack, const char *host,
+        nsapi_dns_callback_t callback, nsapi_version_t version = NSAPI_UNSPEC)
+{
+    return nsapi_dns_query_async(nsapi_create_stack(stack), host, callback, version);
+}
+
 /** Add a domain name server to list of servers to query
  *
  *  @param addr     Destination for the host address
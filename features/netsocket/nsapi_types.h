@@ -50,6 +50,21 @@ typedef enum nsapi_error {
     NSAPI_ERROR_DEVICE_ERROR  = -3012,     /*!< failure interfacing with the network processor */
 } nsapi_error_t;
 
+/** Enum of connection states
+ *
+ *  The connection status of a network interface, as reported by
+ *  get_connection_status and the status callback.
+ *
+ *  @enum nsapi_connection_status_t
+ */
+typedef enum nsapi_connection_status {
+    NSAPI_STATUS_LOCAL_UP          = 0,     /*!< local IP address set */
+    NSAPI_STATUS_GLOBAL_UP         = 1,     /*!< global IP address set */
+    NSAPI_STATUS_DISCONNECTED      = 2,     /*!< no connection to network */
+    NSAPI_STATUS_CONNECTING        = 3,     /*!< connecting to network */
+    NSAPI_STATUS_ERROR_UNSUPPORTED = NSAPI_ERROR_UNSUPPORTED
+} nsapi_connection_status_t;
+
 /** Enum of encryption types
  *
  *  The security type specifies a particular security to use when
@@ -127,6 +142,13 @@ typedef struct nsapi_addr {
  */
 typedef void *nsapi_socket_t;
 
+/** Opaque handle for network buffers
+ *
+ *  A network buffer is memory owned by the network stack that can be
+ *  passed to and from sockets without copying its contents.
+ */
+typedef void *nsapi_buf_t;
+
 
 /** Enum of socket protocols
  *
@@ -164,8 +186,103 @@ typedef enum nsapi_option {
     NSAPI_LINGER,    /*!< Keeps close from returning until queues empty */
     NSAPI_SNDBUF,    /*!< Sets send buffer size */
     NSAPI_RCVBUF,    /*!< Sets recv buffer size */
+    NSAPI_NODELAY,   /*!< Disables Nagle's algorithm so small segments are sent immediately */
+    NSAPI_ADD_MEMBERSHIP,  /*!< Joins a multicast group, the value is a nsapi_ip_mreq_t */
+    NSAPI_DROP_MEMBERSHIP, /*!< Leaves a multicast group, the value is a nsapi_ip_mreq_t */
 } nsapi_option_t;
 
+/** nsapi_ip_mreq structure
+ *
+ *  Multicast group of NSAPI_ADD_MEMBERSHIP and NSAPI_DROP_MEMBERSHIP
+ */
+typedef struct nsapi_ip_mreq {
+    nsapi_addr_t imr_multiaddr; /*!< IP address of the group */
+    nsapi_addr_t imr_interface; /*!< IP address of the interface, or unspecified for any */
+} nsapi_ip_mreq_t;
+
+/** nsapi_iovec structure
+ *
+ *  Describes one buffer of a vectored send or receive
+ */
+typedef struct nsapi_iovec {
+    void *data;    /*!< Start of the buffer */
+    unsigned size; /*!< Size of the buffer in bytes */
+} nsapi_iovec_t;
+
+/** Enum of message flags
+ *
+ *  Flags reported by a vectored receive
+ *
+ *  @enum nsapi_msg_flag_t
+ */
+typedef enum nsapi_msg_flag {
+    NSAPI_MSG_TRUNC = 0x1, /*!< Datagram did not fit and was truncated */
+} nsapi_msg_flag_t;
+
+/** nsapi_mmsg structure
+ *
+ *  Describes one packet of a batched send or receive over a UDP socket
+ */
+typedef struct nsapi_mmsg {
+    void *data;        /*!< Buffer of the packet */
+    unsigned size;     /*!< Size of the buffer in bytes */
+    nsapi_addr_t addr; /*!< Address of the remote host, the source on receive */
+    uint16_t port;     /*!< Port of the remote host, the source on receive */
+    unsigned len;      /*!< Number of bytes sent or received, set by the call */
+    int flags;         /*!< Mask of nsapi_msg_flag_t flags, set by a receive */
+} nsapi_mmsg_t;
+
+/** Enum of poll events
+ *
+ *  Readiness of a socket as reported by a stack's socket_poll
+ *
+ *  @enum nsapi_poll_event_t
+ */
+typedef enum nsapi_poll_event {
+    NSAPI_POLLIN   = 0x1, /*!< Data or a connection can be received without blocking */
+    NSAPI_POLLOUT  = 0x2, /*!< Data can be sent without blocking */
+    NSAPI_POLLERR  = 0x4, /*!< An error is pending on the socket */
+    NSAPI_POLLNVAL = 0x8, /*!< The socket is not open */
+} nsapi_poll_event_t;
+
+/** nsapi_stack_stats structure
+ *
+ *  Counters of a network stack since it was started. Counters a stack
+ *  does not keep are left as zero.
+ */
+typedef struct nsapi_stack_stats {
+    uint32_t rx_packets;        /*!< Packets received from the interface */
+    uint32_t tx_packets;        /*!< Packets passed to the interface */
+    uint32_t rx_bytes;          /*!< Bytes received from the interface */
+    uint32_t tx_bytes;          /*!< Bytes passed to the interface */
+    uint32_t rx_drops;          /*!< Received packets the stack could not queue */
+    uint32_t tx_drops;          /*!< Packets the interface failed to send */
+    uint32_t tcp_retransmits;   /*!< Retransmitted TCP segments */
+    uint32_t heap_max;          /*!< High-water mark of the stack heap in bytes */
+    uint32_t heap_size;         /*!< Size of the stack heap in bytes */
+    uint32_t pbuf_pool_max;     /*!< High-water mark of the packet buffer pool */
+    uint32_t pbuf_pool_size;    /*!< Number of buffers in the packet buffer pool */
+    uint32_t pool_errors;       /*!< Failed allocations from the stack's memory pools */
+    uint32_t emac_drops;        /*!< Frames dropped by the Ethernet driver */
+    uint32_t emac_overruns;     /*!< Frames lost to receive FIFO or descriptor overruns */
+} nsapi_stack_stats_t;
+
+/** nsapi_socket_stats structure
+ *
+ *  Counters and transport state of a socket. Values a stack does not
+ *  keep, or that do not apply to the socket's protocol, are left as zero.
+ */
+typedef struct nsapi_socket_stats {
+    uint32_t rx_bytes;          /*!< Bytes received by the application */
+    uint32_t tx_bytes;          /*!< Bytes accepted for sending */
+    uint32_t retransmits;       /*!< Retransmissions of the oldest unacknowledged segment */
+    uint32_t rtt_ms;            /*!< Smoothed round trip time estimate in ms */
+    uint32_t rtt_var_ms;        /*!< Round trip time variance in ms */
+    uint32_t rto_ms;            /*!< Current retransmission timeout in ms */
+    uint32_t cwnd;              /*!< Congestion window in bytes */
+    uint32_t send_queue;        /*!< Segments queued and not yet acknowledged */
+} nsapi_socket_stats_t;
+
 /** nsapi_wifi_ap structure
  *
  *  Structure representing a WiFi Access Point
@@ -476,6 +593,230 @@ typedef struct nsapi_stack_api
      *  @return         0 on success, negative error code on failure
      */    
     int (*getsockopt)(nsapi_stack_t *stack, nsapi_socket_t socket, int level, int optname, void *optval, unsigned *optlen);
+
+    /** Allocate a network buffer
+     *
+     *  The buffer is owned by the caller until it is freed with buf_free.
+     *
+     *  @param stack    Stack handle
+     *  @param size     Size of the buffer in bytes
+     *  @return         Handle to the buffer, or null if out of memory
+     */
+    nsapi_buf_t (*buf_alloc)(nsapi_stack_t *stack, unsigned size);
+
+    /** Free a network buffer
+     *
+     *  @param stack    Stack handle
+     *  @param buf      Buffer handle
+     */
+    void (*buf_free)(nsapi_stack_t *stack, nsapi_buf_t buf);
+
+    /** Get the contiguous data of a network buffer at an offset
+     *
+     *  A buffer may be made of several segments, the remaining segments
+     *  are found by calling buf_data again with the offset moved past the
+     *  returned span.
+     *
+     *  @param stack    Stack handle
+     *  @param buf      Buffer handle
+     *  @param offset   Offset in bytes from the start of the buffer
+     *  @param data     Destination for a pointer to the data at offset
+     *  @return         Number of contiguous bytes at offset, 0 past the end
+     *                  of the buffer
+     */
+    unsigned (*buf_data)(nsapi_stack_t *stack, nsapi_buf_t buf, unsigned offset, void **data);
+
+    /** Send a network buffer over a TCP socket
+     *
+     *  Sends the buffer contents starting at offset. The buffer stays
+     *  owned by the caller.
+     *
+     *  This call is non-blocking. If send would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param buf      Buffer handle
+     *  @param offset   Offset in bytes of the first byte to send
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int (*socket_send_buf)(nsapi_stack_t *stack, nsapi_socket_t socket, nsapi_buf_t buf, unsigned offset);
+
+    /** Receive a network buffer over a TCP socket
+     *
+     *  On success the received buffer is owned by the caller.
+     *
+     *  This call is non-blocking. If recv would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param buf      Destination for the received buffer handle
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    int (*socket_recv_buf)(nsapi_stack_t *stack, nsapi_socket_t socket, nsapi_buf_t *buf);
+
+    /** Send a network buffer as a packet over a UDP socket
+     *
+     *  The buffer stays owned by the caller.
+     *
+     *  This call is non-blocking. If sendto would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param addr     The address of the remote host
+     *  @param port     The port of the remote host
+     *  @param buf      Buffer handle
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int (*socket_sendto_buf)(nsapi_stack_t *stack, nsapi_socket_t socket, nsapi_addr_t addr, uint16_t port, nsapi_buf_t buf);
+
+    /** Receive a packet as a network buffer over a UDP socket
+     *
+     *  On success the received buffer is owned by the caller.
+     *
+     *  This call is non-blocking. If recvfrom would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param addr     Destination for the address of the remote host
+     *  @param port     Destination for the port of the remote host
+     *  @param buf      Destination for the received buffer handle
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    int (*socket_recvfrom_buf)(nsapi_stack_t *stack, nsapi_socket_t socket, nsapi_addr_t *addr, uint16_t *port, nsapi_buf_t *buf);
+
+    /** Send data gathered from several buffers over a socket
+     *
+     *  With a null addr the data is sent over a connected TCP socket,
+     *  otherwise the buffers are sent as a single packet over a UDP socket
+     *  to the specified address.
+     *
+     *  This call is non-blocking. If sendmsg would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param addr     The address of the remote host, or null
+     *  @param port     The port of the remote host
+     *  @param iov      Array of buffers to send
+     *  @param iovcnt   Number of buffers in the array
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int (*socket_sendmsg)(nsapi_stack_t *stack, nsapi_socket_t socket, const nsapi_addr_t *addr, uint16_t port, const nsapi_iovec_t *iov, unsigned iovcnt);
+
+    /** Receive data scattered into several buffers over a socket
+     *
+     *  With a null addr the data is received over a connected TCP socket,
+     *  otherwise a single packet is received over a UDP socket and its
+     *  source address is stored in addr and port. NSAPI_MSG_TRUNC is set
+     *  in flags if the packet did not fit in the buffers.
+     *
+     *  This call is non-blocking. If recvmsg would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param addr     Destination for the address of the remote host, or null
+     *  @param port     Destination for the port of the remote host
+     *  @param iov      Array of buffers to receive into
+     *  @param iovcnt   Number of buffers in the array
+     *  @param flags    Destination for the message flags
+     *  @return         Number of received bytes on success, negative error
+     *                  code on failure
+     */
+    int (*socket_recvmsg)(nsapi_stack_t *stack, nsapi_socket_t socket, nsapi_addr_t *addr, uint16_t *port, const nsapi_iovec_t *iov, unsigned iovcnt, int *flags);
+
+    /** Send several packets over a UDP socket
+     *
+     *  The packets are sent in order, each to its own address, until one
+     *  would block or fails. The len of each packet sent is set.
+     *
+     *  This call is non-blocking. If no packet can be sent,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param msgs     Array of packets to send
+     *  @param count    Number of packets in the array
+     *  @return         Number of sent packets on success, negative error
+     *                  code if none was sent
+     */
+    int (*socket_sendmmsg)(nsapi_stack_t *stack, nsapi_socket_t socket, nsapi_mmsg_t *msgs, unsigned count);
+
+    /** Receive several packets over a UDP socket
+     *
+     *  The packets already queued on the socket are received into the
+     *  buffers in order, storing the source, len and flags of each, until
+     *  none is left or the array is full.
+     *
+     *  This call is non-blocking. If no packet is queued,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param msgs     Array of packets to receive into
+     *  @param count    Number of packets in the array
+     *  @return         Number of received packets on success, negative
+     *                  error code if none was received
+     */
+    int (*socket_recvmmsg)(nsapi_stack_t *stack, nsapi_socket_t socket, nsapi_mmsg_t *msgs, unsigned count);
+
+    /** Send data that never changes over a TCP socket
+     *
+     *  The data must stay valid and unchanged for as long as the stack
+     *  runs, such as constant data in flash, so that the stack can send
+     *  it from where it is instead of copying it.
+     *
+     *  This call is non-blocking. If send would block,
+     *  NSAPI_ERROR_WOULD_BLOCK is returned immediately.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param data     Buffer of data to send
+     *  @param size     Size of the buffer in bytes
+     *  @return         Number of sent bytes on success, negative error
+     *                  code on failure
+     */
+    int (*socket_send_static)(nsapi_stack_t *stack, nsapi_socket_t socket, const void *data, unsigned size);
+
+    /** Check the readiness of a socket
+     *
+     *  Reports which operations can currently complete without blocking.
+     *  Changes in readiness are signalled through the callback registered
+     *  with socket_attach. A readiness may be reported spuriously, but a
+     *  ready socket must not be reported as not ready.
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @return         Mask of nsapi_poll_event_t flags on success, negative
+     *                  error code on failure
+     */
+    int (*socket_poll)(nsapi_stack_t *stack, nsapi_socket_t socket);
+
+    /** Get the counters of the stack
+     *
+     *  @param stack    Stack handle
+     *  @param stats    Destination for the counters
+     *  @return         0 on success, negative error code on failure
+     */
+    int (*get_stats)(nsapi_stack_t *stack, nsapi_stack_stats_t *stats);
+
+    /** Get the counters and transport state of a socket
+     *
+     *  @param stack    Stack handle
+     *  @param socket   Socket handle
+     *  @param stats    Destination for the counters
+     *  @return         0 on success, negative error code on failure
+     */
+    int (*socket_get_stats)(nsapi_stack_t *stack, nsapi_socket_t socket, nsapi_socket_stats_t *stats);
 } nsapi_stack_api_t;
 
 
@@ -0,0 +1,316 @@
+/*
+ * mbed Microcontroller Library
+ * Copyright (c) 2006-2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file benchmark.cpp Benchmarks of creating, reading and committing KVs in the CFSTORE.
+ *
+ * The test cases time the drv->Initialize(), Create(), Read(), Flush() and
+ * Uninitialize() calls for KVs of a few value sizes, and print the min,
+ * average and max microseconds a call took. They only fail when CFSTORE does
+ * not work, the numbers are meant to be compared across configurations.
+ *
+ * The cases are built for the flash journal sync mode only, where each call
+ * has completed when it returns.
+ */
+
+#include "mbed.h"
+#include "cfstore_config.h"
+#include "cfstore_test.h"
+#include "cfstore_debug.h"
+#include "Driver_Common.h"
+#include "configuration_store.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#ifdef YOTTA_CFG_CFSTORE_UVISOR
+#include "uvisor-lib/uvisor-lib.h"
+#endif /* YOTTA_CFG_CFSTORE_UVISOR */
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+using namespace utest::v1;
+
+static char cfstore_benchmark_utest_msg_g[CFSTORE_UTEST_MSG_BUF_SIZE];
+
+/* Configure secure box. */
+#ifdef YOTTA_CFG_CFSTORE_UVISOR
+UVISOR_BOX_NAMESPACE("com.arm.mbed.cfstore.test.benchmark.box1");
+UVISOR_BOX_CONFIG(cfstore_benchmark_box1, UVISOR_BOX_STACK_SIZE);
+#endif /* YOTTA_CFG_CFSTORE_UVISOR */
+
+/// @cond CFSTORE_DOXYGEN_DISABLE
+#define CFSTORE_BENCHMARK_KV_COUNT          8
+#define CFSTORE_BENCHMARK_VALUE_MAX_LEN     1024
+#define CFSTORE_BENCHMARK_ROUNDS            8
+/// @endcond
+
+/* used for sync mode build only */
+#if defined STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS && STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS==0
+
+static char cfstore_benchmark_value_g[CFSTORE_BENCHMARK_VALUE_MAX_LEN];
+
+/* the min, max and total microseconds taken by a call */
+typedef struct cfstore_benchmark_latency_t {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+} cfstore_benchmark_latency_t;
+
+static void cfstore_benchmark_latency_reset(cfstore_benchmark_latency_t* l)
+{
+    l->min = UINT32_MAX;
+    l->max = 0;
+    l->sum = 0;
+    l->count = 0;
+}
+
+static void cfstore_benchmark_latency_add(cfstore_benchmark_latency_t* l, uint32_t us)
+{
+    if(us < l->min) {
+        l->min = us;
+    }
+    if(us > l->max) {
+        l->max = us;
+    }
+    l->sum += us;
+    l->count++;
+}
+
+static void cfstore_benchmark_latency_print(const char* name, uint32_t size, const cfstore_benchmark_latency_t* l)
+{
+    printf("MBED: benchmark %-18s %5lu B min %7lu avg %7lu max %7lu us\r\n", name, (unsigned long) size,
+           (unsigned long) l->min, (unsigned long) (l->count ? l->sum / l->count : 0), (unsigned long) l->max);
+}
+
+static void cfstore_benchmark_kv_name(char* name, uint32_t i)
+{
+    snprintf(name, CFSTORE_KEY_NAME_MAX_LENGTH+1, "com.arm.mbed.benchmark.kv%02lu", (unsigned long) i);
+}
+
+/** @brief  time the Initialize() and Uninitialize() calls with an empty store
+ *          and with CFSTORE_BENCHMARK_KV_COUNT 1 KiB KVs committed to flash
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+static control_t cfstore_benchmark_test_01(const size_t call_count)
+{
+    char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    uint32_t i = 0;
+    uint32_t pass = 0;
+    uint32_t start = 0;
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_SIZE len = 0;
+    ARM_CFSTORE_KEYDESC kdesc;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    cfstore_benchmark_latency_t init;
+    cfstore_benchmark_latency_t uninit;
+    Timer timer;
+
+    CFSTORE_DBGLOG("%s:entered\n", __func__);
+    (void) call_count;
+    memset(cfstore_benchmark_value_g, 'A', sizeof(cfstore_benchmark_value_g));
+    timer.start();
+
+    for(pass = 0; pass < 2; pass++)
+    {
+        cfstore_benchmark_latency_reset(&init);
+        cfstore_benchmark_latency_reset(&uninit);
+        for(i = 0; i < CFSTORE_BENCHMARK_ROUNDS; i++)
+        {
+            start = timer.read_us();
+            ret = drv->Initialize(NULL, NULL);
+            cfstore_benchmark_latency_add(&init, timer.read_us() - start);
+            CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Initialize() call failed (ret=%d).\n", __func__, (int) ret);
+            TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+
+            start = timer.read_us();
+            ret = drv->Uninitialize();
+            cfstore_benchmark_latency_add(&uninit, timer.read_us() - start);
+            CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed (ret=%d).\n", __func__, (int) ret);
+            TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+        }
+        cfstore_benchmark_latency_print("cfstore init", pass * CFSTORE_BENCHMARK_KV_COUNT * CFSTORE_BENCHMARK_VALUE_MAX_LEN, &init);
+        cfstore_benchmark_latency_print("cfstore uninit", pass * CFSTORE_BENCHMARK_KV_COUNT * CFSTORE_BENCHMARK_VALUE_MAX_LEN, &uninit);
+        if(pass > 0) {
+            break;
+        }
+
+        /* commit the KVs the second pass initializes from */
+        ret = drv->Initialize(NULL, NULL);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Initialize() call failed (ret=%d).\n", __func__, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+        for(i = 0; i < CFSTORE_BENCHMARK_KV_COUNT; i++)
+        {
+            memset(&kdesc, 0, sizeof(kdesc));
+            cfstore_benchmark_kv_name(key_name, i);
+            len = CFSTORE_BENCHMARK_VALUE_MAX_LEN;
+            ret = cfstore_test_create(key_name, cfstore_benchmark_value_g, &len, &kdesc);
+            CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+            TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+        }
+        ret = drv->Flush();
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Flush() call failed (ret=%d).\n", __func__, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+        ret = drv->Uninitialize();
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed (ret=%d).\n", __func__, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+    }
+
+    /* leave the store empty */
+    ret = drv->Initialize(NULL, NULL);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+    cfstore_test_delete_all();
+    ret = drv->Flush();
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+    ret = drv->Uninitialize();
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+    return CaseNext;
+}
+
+/** @brief  time creating (Create(), Write() and Close()) and reading
+ *          CFSTORE_BENCHMARK_KV_COUNT KVs of SIZE bytes, and the Flush() call
+ *          committing them to flash, then the one committing their deletion
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+template <uint32_t SIZE>
+static control_t cfstore_benchmark_test_02(const size_t call_count)
+{
+    char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    char read_buf[SIZE];
+    uint32_t i = 0;
+    uint32_t start = 0;
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_SIZE len = 0;
+    ARM_CFSTORE_KEYDESC kdesc;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    cfstore_benchmark_latency_t result;
+    Timer timer;
+
+    CFSTORE_DBGLOG("%s:entered\n", __func__);
+    (void) call_count;
+    memset(cfstore_benchmark_value_g, 'A', sizeof(cfstore_benchmark_value_g));
+    timer.start();
+
+    ret = drv->Initialize(NULL, NULL);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Initialize() call failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+
+    cfstore_benchmark_latency_reset(&result);
+    for(i = 0; i < CFSTORE_BENCHMARK_KV_COUNT; i++)
+    {
+        memset(&kdesc, 0, sizeof(kdesc));
+        cfstore_benchmark_kv_name(key_name, i);
+        len = SIZE;
+        start = timer.read_us();
+        ret = cfstore_test_create(key_name, cfstore_benchmark_value_g, &len, &kdesc);
+        cfstore_benchmark_latency_add(&result, timer.read_us() - start);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+    }
+    cfstore_benchmark_latency_print("cfstore create", SIZE, &result);
+
+    cfstore_benchmark_latency_reset(&result);
+    start = timer.read_us();
+    ret = drv->Flush();
+    cfstore_benchmark_latency_add(&result, timer.read_us() - start);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Flush() call failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+    cfstore_benchmark_latency_print("cfstore commit", SIZE * CFSTORE_BENCHMARK_KV_COUNT, &result);
+
+    cfstore_benchmark_latency_reset(&result);
+    for(i = 0; i < CFSTORE_BENCHMARK_KV_COUNT; i++)
+    {
+        cfstore_benchmark_kv_name(key_name, i);
+        len = SIZE;
+        start = timer.read_us();
+        ret = cfstore_test_read(key_name, read_buf, &len);
+        cfstore_benchmark_latency_add(&result, timer.read_us() - start);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to read KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK && len == SIZE, cfstore_benchmark_utest_msg_g);
+    }
+    cfstore_benchmark_latency_print("cfstore read", SIZE, &result);
+
+    cfstore_test_delete_all();
+    cfstore_benchmark_latency_reset(&result);
+    start = timer.read_us();
+    ret = drv->Flush();
+    cfstore_benchmark_latency_add(&result, timer.read_us() - start);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Flush() call failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+    cfstore_benchmark_latency_print("cfstore commit del", 0, &result);
+
+    ret = drv->Uninitialize();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+    return CaseNext;
+}
+
+#endif /* STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS && STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS==0 */
+
+
+/* report whether built/configured for flash sync or async mode */
+static control_t cfstore_benchmark_test_00(const size_t call_count)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_CAPABILITIES caps;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+
+    (void) call_count;
+    caps = drv->GetCapabilities();
+    if(caps.asynchronous_ops == 1){
+        /* the benchmarks time the calls as completed on return, so are only run in sync mode */
+        CFSTORE_LOG("*** Skipping test as binary built for flash journal async mode, and this test is sync-only%s", "\n");
+        return CaseNext;
+    }
+    ret = cfstore_test_startup();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_benchmark_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to perform test startup (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_benchmark_utest_msg_g);
+    return CaseNext;
+}
+
+
+/// @cond CFSTORE_DOXYGEN_DISABLE
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(300, "default_auto");
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+Case cases[] = {
+           /*          1         2         3         4         5         6        7  */
+           /* 1234567890123456789012345678901234567890123456789012345678901234567890 */
+        Case("BENCHMARK_test_00", cfstore_benchmark_test_00),
+#if defined STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS && STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS==0
+        Case("BENCHMARK_test_01", cfstore_benchmark_test_01),
+        Case("BENCHMARK_test_02_16", cfstore_benchmark_test_02<16>),
+        Case("BENCHMARK_test_02_256", cfstore_benchmark_test_02<256>),
+        Case("BENCHMARK_test_02_1024", cfstore_benchmark_test_02<1024>),
+#endif // STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS
+};
+
+
+/* Declare your test specification with a custom setup handler */
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
+/// @endcond
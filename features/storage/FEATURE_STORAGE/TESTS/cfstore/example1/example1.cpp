@@ -189,6 +189,8 @@ const char* cfstore_ex_opcode_str[] =
     "CFSTORE_OPCODE_RSEEK",
     "CFSTORE_OPCODE_UNINITIALIZE",
     "CFSTORE_OPCODE_WRITE",
+    "CFSTORE_OPCODE_MAP",
+    "CFSTORE_OPCODE_FIND_ITER",
     "CFSTORE_OPCODE_MAX"
 };
 
@@ -509,6 +509,192 @@ control_t cfstore_find_test_07_end(const size_t call_count)
 }
 
 
+/// @cond CFSTORE_DOXYGEN_DISABLE
+#define CFSTORE_FIND_TEST_08_KV_COUNT       64
+#define CFSTORE_FIND_TEST_08_KEY_NAME_FMT   "com.arm.cfstore.test.find{%d}.value"
+/// @endcond
+
+/* @brief   helper to count the KVs matching a query with Find() */
+static int32_t cfstore_find_test_08_count(const char* key_name_query)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    int32_t count = 0;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    ARM_CFSTORE_HANDLE_INIT(next);
+    ARM_CFSTORE_HANDLE_INIT(prev);
+
+    while((ret = drv->Find(key_name_query, prev, next)) == ARM_DRIVER_OK)
+    {
+        count++;
+        CFSTORE_HANDLE_SWAP(prev, next);
+    }
+    return ret == ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND ? count : ret;
+}
+
+/**
+ * @brief   test case to check exact and prefix Find() queries remain correct
+ *          while KVs are created, deleted and resized, which shifts the
+ *          following KVs in the store.
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+control_t cfstore_find_test_08_end(const size_t call_count)
+{
+    char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    char value[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    bool bfound = false;
+    int32_t i = 0;
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_SIZE len = 0;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    ARM_CFSTORE_KEYDESC kdesc;
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+
+    (void) call_count;
+    memset(&kdesc, 0, sizeof(kdesc));
+    memset(value, 0, sizeof(value));
+    for(i = 0; i < CFSTORE_FIND_TEST_08_KV_COUNT; i++){
+        snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, CFSTORE_FIND_TEST_08_KEY_NAME_FMT, (int) i);
+        len = strlen(key_name);
+        ret = cfstore_test_create(key_name, key_name, &len, &kdesc);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+    }
+
+    /* delete every third KV and grow the value of the KV following it */
+    for(i = 0; i < CFSTORE_FIND_TEST_08_KV_COUNT; i += 3){
+        snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, CFSTORE_FIND_TEST_08_KEY_NAME_FMT, (int) i);
+        ret = cfstore_test_delete(key_name);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to delete KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+
+        if(i + 1 < CFSTORE_FIND_TEST_08_KV_COUNT){
+            snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, CFSTORE_FIND_TEST_08_KEY_NAME_FMT, (int) i + 1);
+            ret = drv->Create(key_name, CFSTORE_KEY_NAME_MAX_LENGTH, NULL, hkey);
+            CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to grow KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+            TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+            drv->Close(hkey);
+        }
+    }
+
+    /* each remaining KV is found by name and holds its own name */
+    for(i = 0; i < CFSTORE_FIND_TEST_08_KV_COUNT; i++){
+        snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, CFSTORE_FIND_TEST_08_KEY_NAME_FMT, (int) i);
+        ret = cfstore_test_kv_is_found(key_name, &bfound);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: KV %s (key_name=%s, ret=%d).\n", __func__, bfound ? "found after delete" : "not found", key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(bfound == (i % 3 != 0), cfstore_find_utest_msg_g);
+        if(bfound){
+            len = strlen(key_name);
+            ret = cfstore_test_read(key_name, value, &len);
+            CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: KV has the wrong value (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+            TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK && strncmp(value, key_name, strlen(key_name)) == 0, cfstore_find_utest_msg_g);
+        }
+    }
+
+    ret = cfstore_find_test_08_count("com.arm.cfstore.test.find*");
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: prefix query found %d KVs, expected %d.\n", __func__, (int) ret, (int) (CFSTORE_FIND_TEST_08_KV_COUNT - (CFSTORE_FIND_TEST_08_KV_COUNT + 2) / 3));
+    TEST_ASSERT_MESSAGE(ret == CFSTORE_FIND_TEST_08_KV_COUNT - (CFSTORE_FIND_TEST_08_KV_COUNT + 2) / 3, cfstore_find_utest_msg_g);
+
+    ret = cfstore_find_test_08_count("com.arm.cfstore.test.find{1*}.value");
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: query found %d KVs, expected 8.\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret == 8, cfstore_find_utest_msg_g);
+
+    ret = drv->Uninitialize();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed.\n", __func__);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+    return CaseNext;
+}
+
+
+/// @cond CFSTORE_DOXYGEN_DISABLE
+#define CFSTORE_FIND_TEST_09_NEW_KEY_NAME_FMT   "com.arm.cfstore.test.new{%d}.value"
+/// @endcond
+
+/**
+ * @brief   test case to check a FindIter() iteration returns each KV matching
+ *          the query once, while the KVs returned are deleted and new KVs are
+ *          created during the iteration.
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+control_t cfstore_find_test_09_end(const size_t call_count)
+{
+    const char* key_name_query = "com.arm.cfstore.test.find{*}.value";
+    char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    char prev_key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    uint8_t key_name_len = 0;
+    uint8_t seen[CFSTORE_FIND_TEST_08_KV_COUNT];
+    int32_t i = 0;
+    int32_t count = 0;
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_SIZE len = 0;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    ARM_CFSTORE_KEYDESC kdesc;
+    ARM_CFSTORE_HANDLE_INIT(next);
+    ARM_CFSTORE_HANDLE_INIT(prev);
+    ARM_CFSTORE_FIND_ITER_INIT(iter);
+
+    (void) call_count;
+    memset(&kdesc, 0, sizeof(kdesc));
+    memset(seen, 0, sizeof(seen));
+    memset(prev_key_name, 0, sizeof(prev_key_name));
+    for(i = 0; i < CFSTORE_FIND_TEST_08_KV_COUNT; i++){
+        snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, CFSTORE_FIND_TEST_08_KEY_NAME_FMT, (int) i);
+        len = strlen(key_name);
+        ret = cfstore_test_create(key_name, key_name, &len, &kdesc);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+    }
+
+    while((ret = drv->FindIter(iter, key_name_query, prev, next)) == ARM_DRIVER_OK)
+    {
+        key_name_len = CFSTORE_KEY_NAME_MAX_LENGTH+1;
+        ret = drv->GetKeyName(next, key_name, &key_name_len);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to get key name (ret=%d).\n", __func__, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+
+        i = atoi(key_name + strlen("com.arm.cfstore.test.find{"));
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: KV returned more than once (key_name=%s).\n", __func__, key_name);
+        TEST_ASSERT_MESSAGE(i >= 0 && i < CFSTORE_FIND_TEST_08_KV_COUNT && seen[i] == 0, cfstore_find_utest_msg_g);
+        seen[i] = 1;
+#ifdef CFSTORE_CONFIG_KEY_INDEX_ENABLED
+        /* queries with a literal prefix are iterated from the index in key name order */
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: KV returned out of order (key_name=%s, previous=%s).\n", __func__, key_name, prev_key_name);
+        TEST_ASSERT_MESSAGE(strcmp(prev_key_name, key_name) < 0, cfstore_find_utest_msg_g);
+#endif /* CFSTORE_CONFIG_KEY_INDEX_ENABLED */
+        strncpy(prev_key_name, key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1);
+
+        if(count % 3 == 0){
+            ret = drv->Delete(next);
+            CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to delete KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+            TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+        } else {
+            snprintf(key_name, CFSTORE_KEY_NAME_MAX_LENGTH+1, CFSTORE_FIND_TEST_09_NEW_KEY_NAME_FMT, (int) count);
+            len = strlen(key_name);
+            ret = cfstore_test_create(key_name, key_name, &len, &kdesc);
+            CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV (key_name=%s, ret=%d).\n", __func__, key_name, (int) ret);
+            TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+        }
+        count++;
+        CFSTORE_HANDLE_SWAP(prev, next);
+    }
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: expected ret == ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND, but ret = %d.\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret == ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND, cfstore_find_utest_msg_g);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: iteration returned %d KVs, expected %d.\n", __func__, (int) count, (int) CFSTORE_FIND_TEST_08_KV_COUNT);
+    TEST_ASSERT_MESSAGE(count == CFSTORE_FIND_TEST_08_KV_COUNT, cfstore_find_utest_msg_g);
+
+    /* the KVs deleted during the iteration are gone */
+    ret = cfstore_find_test_08_count(key_name_query);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: query found %d KVs, expected %d.\n", __func__, (int) ret, (int) (CFSTORE_FIND_TEST_08_KV_COUNT - (CFSTORE_FIND_TEST_08_KV_COUNT + 2) / 3));
+    TEST_ASSERT_MESSAGE(ret == CFSTORE_FIND_TEST_08_KV_COUNT - (CFSTORE_FIND_TEST_08_KV_COUNT + 2) / 3, cfstore_find_utest_msg_g);
+
+    ret = drv->Uninitialize();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_find_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed.\n", __func__);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_find_utest_msg_g);
+    return CaseNext;
+}
+
+
 /// @cond CFSTORE_DOXYGEN_DISABLE
 utest::v1::status_t greentea_setup(const size_t number_of_cases)
 {
@@ -531,6 +717,10 @@ Case cases[] = {
         Case("FIND_test_06_end", cfstore_find_test_06_end),
         Case("FIND_test_07_start", cfstore_utest_default_start),
         Case("FIND_test_07_end", cfstore_find_test_07_end),
+        Case("FIND_test_08_start", cfstore_utest_default_start),
+        Case("FIND_test_08_end", cfstore_find_test_08_end),
+        Case("FIND_test_09_start", cfstore_utest_default_start),
+        Case("FIND_test_09_end", cfstore_find_test_09_end),
 };
 
 
@@ -291,6 +291,8 @@ void cfstore_flush_test_01_callback(int32_t status, ARM_CFSTORE_OPCODE cmd_code,
     case CFSTORE_OPCODE_READ:
     case CFSTORE_OPCODE_RSEEK:
     case CFSTORE_OPCODE_WRITE:
+    case CFSTORE_OPCODE_MAP:
+    case CFSTORE_OPCODE_FIND_ITER:
     default:
         CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush_utest_msg_g, CFSTORE_FLUSH_UTEST_MSG_BUF_SIZE, "%s:WARN: received asynchronous notification for opcode=%d (%s) when api call should have been synchronous", __func__, cmd_code, cmd_code < CFSTORE_OPCODE_MAX ? cfstore_test_opcode_str[cmd_code] : "unknown");
         CFSTORE_DBGLOG("%s:WARN: received asynchronous notification for opcode=%d (%s) when api call should have been synchronous", __func__, cmd_code, cmd_code < CFSTORE_OPCODE_MAX ? cfstore_test_opcode_str[cmd_code] : "unknown");
@@ -830,6 +830,127 @@ static control_t cfstore_flush3_test_02(const size_t call_count)
     return CaseNext;
 }
 
+/// @cond CFSTORE_DOXYGEN_DISABLE
+#define CFSTORE_FLUSH3_TEST_03_FLUSH_COUNT  200
+#define CFSTORE_FLUSH3_TEST_03_COUNTER      "com.arm.mbed.flush3.counter"
+#define CFSTORE_FLUSH3_TEST_03_OTHER        "com.arm.mbed.flush3.other"
+/// @endcond
+
+/* @brief   helper to read back the 4 byte counter written by cfstore_flush3_test_03 */
+static int32_t cfstore_flush3_test_03_read_counter(uint32_t* counter)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_SIZE len = sizeof(uint32_t);
+    ARM_CFSTORE_FMODE flags;
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+
+    memset(&flags, 0, sizeof(flags));
+    flags.read = true;
+    ret = drv->Open(CFSTORE_FLUSH3_TEST_03_COUNTER, flags, hkey);
+    if(ret < ARM_DRIVER_OK){
+        return ret;
+    }
+    ret = drv->Read(hkey, counter, &len);
+    drv->Close(hkey);
+    return ret;
+}
+
+/**
+ * @brief   test case to flush many small changes to one KV.
+ *
+ * With the delta log enabled each flush appends the changed KV to the log,
+ * and the log is compacted into the flash journal once full. The test
+ * flushes enough changes to fill the log several times, deletes a KV with
+ * a delta flush and checks the store is restored after re-initialisation.
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+static control_t cfstore_flush3_test_03(const size_t call_count)
+{
+    bool bfound = false;
+    int32_t ret = ARM_DRIVER_ERROR;
+    uint32_t i = 0;
+    uint32_t counter = 0;
+    ARM_CFSTORE_SIZE len = 0;
+    ARM_CFSTORE_KEYDESC kdesc;
+    ARM_CFSTORE_FMODE flags;
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+
+    (void) call_count;
+    memset(&kdesc, 0, sizeof(kdesc));
+    memset(&flags, 0, sizeof(flags));
+    flags.write = true;
+
+    ret = drv->Initialize(NULL, NULL);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Initialize() failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+
+    len = sizeof(counter);
+    ret = cfstore_test_create(CFSTORE_FLUSH3_TEST_03_COUNTER, (const char*) &counter, &len, &kdesc);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV (key_name=%s, ret=%d).\n", __func__, CFSTORE_FLUSH3_TEST_03_COUNTER, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+
+    len = strlen(CFSTORE_FLUSH3_TEST_03_OTHER);
+    ret = cfstore_test_create(CFSTORE_FLUSH3_TEST_03_OTHER, CFSTORE_FLUSH3_TEST_03_OTHER, &len, &kdesc);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV (key_name=%s, ret=%d).\n", __func__, CFSTORE_FLUSH3_TEST_03_OTHER, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+
+    for(i = 1; i <= CFSTORE_FLUSH3_TEST_03_FLUSH_COUNT; i++){
+        ret = drv->Open(CFSTORE_FLUSH3_TEST_03_COUNTER, flags, hkey);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Open() failed (i=%d, ret=%d).\n", __func__, (int) i, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+        len = sizeof(i);
+        ret = drv->Write(hkey, (const char*) &i, &len);
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Write() failed (i=%d, ret=%d).\n", __func__, (int) i, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+        drv->Close(hkey);
+
+        ret = drv->Flush();
+        CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Flush() failed (i=%d, ret=%d).\n", __func__, (int) i, (int) ret);
+        TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+    }
+
+    ret = cfstore_test_delete(CFSTORE_FLUSH3_TEST_03_OTHER);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to delete KV (key_name=%s, ret=%d).\n", __func__, CFSTORE_FLUSH3_TEST_03_OTHER, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+
+    ret = drv->Flush();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Flush() failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+
+    /* the store read back from flash holds the last counter value and not the deleted KV */
+    ret = drv->Uninitialize();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+
+    ret = drv->Initialize(NULL, NULL);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Initialize() failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+
+    ret = cfstore_flush3_test_03_read_counter(&counter);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: counter is %d, expected %d (ret=%d).\n", __func__, (int) counter, (int) CFSTORE_FLUSH3_TEST_03_FLUSH_COUNT, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK && counter == CFSTORE_FLUSH3_TEST_03_FLUSH_COUNT, cfstore_flush3_utest_msg_g);
+
+    ret = cfstore_test_kv_is_found(CFSTORE_FLUSH3_TEST_03_OTHER, &bfound);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: deleted KV found after re-initialisation (key_name=%s).\n", __func__, CFSTORE_FLUSH3_TEST_03_OTHER);
+    TEST_ASSERT_MESSAGE(bfound == false, cfstore_flush3_utest_msg_g);
+
+    ret = cfstore_test_delete(CFSTORE_FLUSH3_TEST_03_COUNTER);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to delete KV (key_name=%s, ret=%d).\n", __func__, CFSTORE_FLUSH3_TEST_03_COUNTER, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+
+    ret = drv->Flush();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Flush() failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+
+    ret = drv->Uninitialize();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_flush3_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() failed (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_flush3_utest_msg_g);
+    return CaseNext;
+}
+
 #endif /* STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS && STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS==0 */
 
 
@@ -870,6 +991,7 @@ Case cases[] = {
 #if defined STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS && STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS==0
         Case("FLUSH3_test_01", cfstore_flush3_test_01),
         Case("FLUSH3_test_02", cfstore_flush3_test_02),
+        Case("FLUSH3_test_03", cfstore_flush3_test_03),
 #endif // STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS
 };
 
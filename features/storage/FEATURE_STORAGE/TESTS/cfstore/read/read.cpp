@@ -160,6 +160,85 @@ control_t cfstore_read_test_02_end(const size_t call_count)
 }
 
 
+/** @brief  test case to check Map() returns the value in place, and that the
+ *          area stays pinned until the mapped KV is closed:
+ *          - creating a KV fails while the area is mapped.
+ *          - a KV deleted while the area is mapped is removed on Close() of
+ *            the mapped KV.
+ *
+ * @return on success returns CaseNext to continue to next test case, otherwise will assert on errors.
+ */
+control_t cfstore_read_test_03_end(const size_t call_count)
+{
+    bool bfound = false;
+    const void* data = NULL;
+    const char* key_name = "com.arm.mbed.cfstore.test.read.mapped";
+    const char* key_name_other = "com.arm.mbed.cfstore.test.read.other";
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_SIZE len = 0;
+    ARM_CFSTORE_DRIVER* drv = &cfstore_driver;
+    ARM_CFSTORE_KEYDESC kdesc;
+    ARM_CFSTORE_HANDLE_INIT(hkey);
+    ARM_CFSTORE_FMODE flags;
+
+    CFSTORE_DBGLOG("%s:entered\n", __func__);
+    (void) call_count;
+    memset(&kdesc, 0, sizeof(kdesc));
+    memset(&flags, 0, sizeof(flags));
+    kdesc.drl = ARM_RETENTION_WHILE_DEVICE_ACTIVE;
+
+    len = strlen(cfstore_read_test_01_kv_data[0].value);
+    ret = cfstore_test_create(key_name, (char*) cfstore_read_test_01_kv_data[0].value, &len, &kdesc);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV in store (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_read_utest_msg_g);
+
+    len = strlen(key_name_other);
+    ret = cfstore_test_create(key_name_other, key_name_other, &len, &kdesc);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV in store (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_read_utest_msg_g);
+
+    ret = drv->Open(key_name, flags, hkey);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to open node (key_name=\"%s\")(ret=%d)\n", __func__, key_name, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_read_utest_msg_g);
+
+    ret = drv->Map(hkey, &data, &len);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Map() failed (ret=%d)\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK && len == strlen(cfstore_read_test_01_kv_data[0].value), cfstore_read_utest_msg_g);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: mapped value is not the KV value.\n", __func__);
+    TEST_ASSERT_MESSAGE(memcmp(data, cfstore_read_test_01_kv_data[0].value, len) == 0, cfstore_read_utest_msg_g);
+
+    /* the area cannot grow while mapped */
+    len = strlen(cfstore_read_test_01_kv_data[0].value);
+    ret = cfstore_test_create(cfstore_read_test_01_kv_data[0].key_name, (char*) cfstore_read_test_01_kv_data[0].value, &len, &kdesc);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Create() did not fail with ARM_CFSTORE_DRIVER_ERROR_VALUE_MAPPED (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret == ARM_CFSTORE_DRIVER_ERROR_VALUE_MAPPED, cfstore_read_utest_msg_g);
+
+    /* the deleted KV is no longer found, and the mapped value has not moved */
+    ret = cfstore_test_delete(key_name_other);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to delete KV (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_read_utest_msg_g);
+    ret = cfstore_test_kv_is_found(key_name_other, &bfound);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: deleted KV found (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(bfound == false, cfstore_read_utest_msg_g);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: mapped value changed by Delete().\n", __func__);
+    TEST_ASSERT_MESSAGE(memcmp(data, cfstore_read_test_01_kv_data[0].value, strlen(cfstore_read_test_01_kv_data[0].value)) == 0, cfstore_read_utest_msg_g);
+
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Close() call failed.\n", __func__);
+    TEST_ASSERT_MESSAGE(drv->Close(hkey) >= ARM_DRIVER_OK, cfstore_read_utest_msg_g);
+
+    /* with the mapping gone KVs can be created again */
+    len = strlen(key_name_other);
+    ret = cfstore_test_create(key_name_other, key_name_other, &len, &kdesc);
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: failed to create KV after Close() of the mapped KV (ret=%d).\n", __func__, (int) ret);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_read_utest_msg_g);
+
+    ret = drv->Uninitialize();
+    CFSTORE_TEST_UTEST_MESSAGE(cfstore_read_utest_msg_g, CFSTORE_UTEST_MSG_BUF_SIZE, "%s:Error: Uninitialize() call failed.\n", __func__);
+    TEST_ASSERT_MESSAGE(ret >= ARM_DRIVER_OK, cfstore_read_utest_msg_g);
+    return CaseNext;
+}
+
+
 /// @cond CFSTORE_DOXYGEN_DISABLE
 utest::v1::status_t greentea_setup(const size_t number_of_cases)
 {
@@ -175,6 +254,8 @@ Case cases[] = {
         Case("READ_test_01_end", cfstore_read_test_01_end),
         Case("READ_test_02_start", cfstore_utest_default_start),
         Case("READ_test_02_end", cfstore_read_test_02_end),
+        Case("READ_test_03_start", cfstore_utest_default_start),
+        Case("READ_test_03_end", cfstore_read_test_03_end),
 };
 
 
@@ -1051,6 +1051,33 @@ void test_crc32()
             flashJournalCrcReset(); TEST_ASSERT_EQUAL(flashJournalCrcCummulative(dummyMsg, msgLen), crc);
         }
     }
+
+    /* interleave two contexts over odd-sized, unaligned fragments of a longer message */
+    for (unsigned i = 0; i < 1024; i++) {
+        buffer[i] = (uint8_t)(i * 7 + (i >> 3));
+    }
+    for (unsigned offset = 0; offset < 4; offset++) {
+        FlashJournalCrcContext_t contextA;
+        FlashJournalCrcContext_t contextB;
+        uint32_t crcA = 0;
+        uint32_t crcB = 0;
+
+        flashJournalCrcContextReset(&contextA);
+        flashJournalCrcContextReset(&contextB);
+        for (unsigned index = offset; index < 1024; index += 37) {
+            unsigned fragment = ((1024 - index) < 37) ? (1024 - index) : 37;
+            crcA = flashJournalCrcContextCummulative(&contextA, buffer + index, fragment);
+            crcB = flashJournalCrcContextCummulative(&contextB, buffer + index, fragment);
+        }
+
+        flashJournalCrcReset(); crc = flashJournalCrcCummulative(buffer + offset, 1024 - offset);
+        TEST_ASSERT_EQUAL(crc, crcA);
+        TEST_ASSERT_EQUAL(crc, crcB);
+    }
+
+    FlashJournalCrcContext_t context;
+    flashJournalCrcContextReset(&context);
+    TEST_ASSERT_EQUAL(0xCBF43926, flashJournalCrcContextCummulative(&context, (const unsigned char *)"123456789", 9));
 }
 
 #ifndef AVOID_GREENTEA
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2006-2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef TARGET_LIKE_POSIX
+#define AVOID_GREENTEA
+#endif
+
+#ifndef AVOID_GREENTEA
+#include "greentea-client/test_env.h"
+#endif
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+#include "flash-journal-strategy-multislot/flash_journal_strategy_multislot.h"
+#include "flash-journal-strategy-multislot/flash_journal_multislot_private.h"
+#include <string.h>
+#include <inttypes.h>
+
+using namespace utest::v1;
+
+extern ARM_DRIVER_STORAGE ARM_Driver_Storage_MTD_K64F;
+const ARM_DRIVER_STORAGE *drv = &ARM_Driver_Storage_MTD_K64F;
+
+FlashJournal_t      journal;
+
+static const uint32_t NUM_SLOTS   = 4;
+static const size_t   BUFFER_SIZE = 1024;
+static uint8_t        buffer[BUFFER_SIZE];
+static int32_t        callbackStatus;
+
+void callbackHandler(int32_t status, FlashJournal_OpCode_t cmd_code)
+{
+    (void)cmd_code;
+    callbackStatus = status;
+    Harness::validate_callback(); // Validate the callback
+}
+
+control_t test_formatWithTooFewSlots()
+{
+    int32_t rc = flashJournalStrategyMultislot_format(drv, 1 /* numSlots */, callbackHandler);
+    TEST_ASSERT_EQUAL(JOURNAL_STATUS_PARAMETER, rc);
+
+    return CaseNext;
+}
+
+control_t test_format(const size_t call_count)
+{
+    int32_t rc;
+
+    if (call_count == 1) {
+        rc = flashJournalStrategyMultislot_format(drv, NUM_SLOTS, callbackHandler);
+        TEST_ASSERT(rc >= JOURNAL_STATUS_OK);
+        if (rc == JOURNAL_STATUS_OK) {
+            return CaseTimeout(200) + CaseRepeatAll;
+        }
+        TEST_ASSERT_EQUAL(1, rc); /* synchronous completion is expected to return 1. */
+    }
+
+    return CaseNext;
+}
+
+/* initialize() is refused with JOURNAL_STATUS_BUSY while the pre-erase
+ * following a commit is in progress; the test then simply polls. */
+control_t test_initialize(const size_t call_count)
+{
+    int32_t rc;
+
+    if (call_count == 1) {
+        rc = FlashJournal_initialize(&journal, drv, &FLASH_JOURNAL_STRATEGY_MULTISLOT, callbackHandler);
+        if (rc == JOURNAL_STATUS_BUSY) {
+            return CaseRepeatAllOnTimeout(50);
+        }
+        TEST_ASSERT(rc >= JOURNAL_STATUS_OK);
+        if (rc == JOURNAL_STATUS_OK) {
+            return CaseTimeout(200) + CaseRepeatAll;
+        }
+        TEST_ASSERT_EQUAL(1, rc); /* synchronous completion of initialize() is expected to return 1 */
+    }
+
+    FlashJournal_Info_t info;
+    rc = FlashJournal_getInfo(&journal, &info);
+    TEST_ASSERT_EQUAL(JOURNAL_STATUS_OK, rc);
+    TEST_ASSERT(info.capacity >= BUFFER_SIZE);
+
+    MultislotFlashJournal_t *multislotJournal = (MultislotFlashJournal_t *)&journal;
+    TEST_ASSERT_EQUAL(NUM_SLOTS, multislotJournal->numSlots);
+
+    return CaseNext;
+}
+
+/* Each blob goes into the slot after the previous one; once commit() has
+ * returned, the slot which takes the following blob is erased already (for a
+ * synchronous MTD) or is being erased in the background. */
+template<uint8_t PATTERN, size_t SIZE>
+control_t test_logAndCommitRotatesSlots(const size_t call_count)
+{
+    static uint32_t blobIndexBeforeLog;
+    MultislotFlashJournal_t *multislotJournal = (MultislotFlashJournal_t *)&journal;
+    int32_t rc;
+
+    switch (call_count) {
+        case 1:
+            blobIndexBeforeLog = multislotJournal->currentBlobIndex;
+
+            memset(buffer, PATTERN, SIZE);
+            rc = FlashJournal_log(&journal, buffer, SIZE);
+            TEST_ASSERT(rc >= JOURNAL_STATUS_OK);
+            if (rc == JOURNAL_STATUS_OK) {
+                TEST_ASSERT_EQUAL(1, drv->GetCapabilities().asynchronous_ops);
+                return CaseTimeout(500) + CaseRepeatAll;
+            }
+            TEST_ASSERT_EQUAL(SIZE, rc);
+            /* else, fall through to synchronous verification */
+
+        case 2:
+            if (call_count == 2) {
+                TEST_ASSERT_EQUAL(SIZE, callbackStatus);
+            }
+            rc = FlashJournal_commit(&journal);
+            TEST_ASSERT(rc >= JOURNAL_STATUS_OK);
+            if (rc == JOURNAL_STATUS_OK) {
+                TEST_ASSERT_EQUAL(1, drv->GetCapabilities().asynchronous_ops);
+                return CaseTimeout(500) + CaseRepeatAll;
+            }
+            TEST_ASSERT_EQUAL(1, rc);
+            /* else, fall through to synchronous verification */
+
+        default:
+            TEST_ASSERT_EQUAL((blobIndexBeforeLog + 1) % NUM_SLOTS, multislotJournal->currentBlobIndex);
+            if (drv->GetCapabilities().asynchronous_ops) {
+                TEST_ASSERT((multislotJournal->state == MULTISLOT_JOURNAL_STATE_PRE_ERASING) ||
+                            (multislotJournal->erasedBlobIndex == multislotNextBlobIndex(multislotJournal)));
+            } else {
+                TEST_ASSERT_EQUAL(MULTISLOT_JOURNAL_STATE_INITIALIZED, multislotJournal->state);
+                TEST_ASSERT_EQUAL(multislotNextBlobIndex(multislotJournal), multislotJournal->erasedBlobIndex);
+            }
+
+            return CaseNext;
+    }
+}
+
+/* reads follow a fresh initialize(); which in turn has to locate the most
+ * recent blob among the slots. */
+template<uint8_t PATTERN, size_t SIZE>
+control_t test_readAfterInitialize(const size_t call_count)
+{
+    int32_t rc;
+
+    if (call_count == 1) {
+        FlashJournal_Info_t info;
+        rc = FlashJournal_getInfo(&journal, &info);
+        TEST_ASSERT_EQUAL(JOURNAL_STATUS_OK, rc);
+        TEST_ASSERT_EQUAL(SIZE, info.sizeofJournaledBlob);
+
+        memset(buffer, 0, SIZE);
+        rc = FlashJournal_read(&journal, buffer, SIZE);
+        TEST_ASSERT(rc >= JOURNAL_STATUS_OK);
+        if (rc == JOURNAL_STATUS_OK) {
+            TEST_ASSERT_EQUAL(1, drv->GetCapabilities().asynchronous_ops);
+            return CaseTimeout(500) + CaseRepeatAll;
+        }
+        TEST_ASSERT_EQUAL(SIZE, rc);
+    } else {
+        TEST_ASSERT_EQUAL(SIZE, callbackStatus);
+    }
+
+    for (unsigned i = 0; i < SIZE; i++) {
+        TEST_ASSERT_EQUAL(PATTERN, buffer[i]);
+    }
+
+    return CaseNext;
+}
+
+/* an interrupted log sequence doesn't disturb the most recently committed
+ * blob; reset() abandons the sequence. */
+control_t test_logWithoutCommitKeepsPreviousBlob(const size_t call_count)
+{
+    int32_t rc;
+
+    switch (call_count) {
+        case 1:
+            memset(buffer, 0x77, BUFFER_SIZE);
+            rc = FlashJournal_log(&journal, buffer, BUFFER_SIZE);
+            if (rc == JOURNAL_STATUS_BUSY) {
+                return CaseRepeatAllOnTimeout(50);
+            }
+            TEST_ASSERT(rc >= JOURNAL_STATUS_OK);
+            if (rc == JOURNAL_STATUS_OK) {
+                TEST_ASSERT_EQUAL(1, drv->GetCapabilities().asynchronous_ops);
+                return CaseTimeout(500) + CaseRepeatAll;
+            }
+            TEST_ASSERT_EQUAL(BUFFER_SIZE, rc);
+            /* else, fall through */
+
+        default:
+            return CaseNext;
+    }
+}
+
+#ifndef AVOID_GREENTEA
+// Custom setup handler required for proper Greentea support
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(60, "default_auto");
+    // Call the default reporting function
+    return greentea_test_setup_handler(number_of_cases);
+}
+#else
+status_t default_setup(const size_t)
+{
+    return STATUS_CONTINUE;
+}
+#endif
+
+// Specify all your test cases here
+Case cases[] = {
+    Case("format with too few slots",                   test_formatWithTooFewSlots),
+    Case("format",                                      test_format),
+    Case("initialize",                                  test_initialize),
+
+    /* log more blobs than there are slots, so that the rotation wraps around */
+    Case("log and commit1",                             test_logAndCommitRotatesSlots<0xAA, BUFFER_SIZE>),
+    Case("initialize after log and commit1",            test_initialize),
+    Case("read after initialize1",                      test_readAfterInitialize<0xAA, BUFFER_SIZE>),
+    Case("log and commit2",                             test_logAndCommitRotatesSlots<0x55, 8>),
+    Case("log and commit3",                             test_logAndCommitRotatesSlots<0x11, 16>),
+    Case("log and commit4",                             test_logAndCommitRotatesSlots<0x22, BUFFER_SIZE>),
+    Case("log and commit5",                             test_logAndCommitRotatesSlots<0xAB, 64>),
+    Case("initialize after log and commit5",            test_initialize),
+    Case("read after initialize5",                      test_readAfterInitialize<0xAB, 64>),
+    Case("log and commit6",                             test_logAndCommitRotatesSlots<0x33, BUFFER_SIZE>),
+    Case("initialize after log and commit6",            test_initialize),
+    Case("read after initialize6",                      test_readAfterInitialize<0x33, BUFFER_SIZE>),
+
+    /* an abandoned sequence of logs leaves the last blob in place */
+    Case("log without commit",                          test_logWithoutCommitKeepsPreviousBlob),
+    Case("initialize after log without commit",         test_initialize),
+    Case("read after log without commit",               test_readAfterInitialize<0x33, BUFFER_SIZE>),
+};
+
+// Declare your test specification with a custom setup handler
+#ifndef AVOID_GREENTEA
+Specification specification(greentea_setup, cases);
+#else
+Specification specification(default_setup, cases);
+#endif
+
+int main(int argc, char** argv)
+{
+    // Run the test specification
+    Harness::run(specification);
+}
@@ -87,6 +87,26 @@ void virtualMTDCallbackHandler(int32_t status, ARM_STORAGE_OPERATION operation)
     Harness::validate_callback();
 }
 
+/* callback handler for the first of two volumes with queued operations; only
+ * the completion of the second volume's operation (which follows) is validated. */
+static int32_t  firstVolumeCallbackStatus;
+static unsigned completedOperations;
+void firstVolumeCallbackHandler(int32_t status, ARM_STORAGE_OPERATION operation)
+{
+    tr_info("in firstVolumeCallbackHandler");
+    firstVolumeCallbackStatus = status;
+    completedOperations++;
+}
+
+/* callback handler for the second of two volumes with queued operations */
+void secondVolumeCallbackHandler(int32_t status, ARM_STORAGE_OPERATION operation)
+{
+    tr_info("in secondVolumeCallbackHandler");
+    virtualVolumeCallbackStatus = status;
+    completedOperations++;
+    Harness::validate_callback();
+}
+
 control_t test_initialize(const size_t call_count)
 {
     tr_info("test_initialize: called with call_count %lu", call_count);
@@ -804,8 +824,6 @@ control_t test_concurrentAccessFromTwoVolumes(const size_t call_count)
                 TEST_ASSERT_EQUAL(1, status.busy);
                 TEST_ASSERT_EQUAL(0, status.error);
 
-                rc = volume2P->ProgramData(0, buffer, sizeofDataOperation);
-                TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
                 rc = volume1P->ProgramData(0, buffer, sizeofDataOperation);
                 TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
                 rc = volume1P->ReadData(0, buffer, sizeofDataOperation);
@@ -854,8 +872,6 @@ control_t test_concurrentAccessFromTwoVolumes(const size_t call_count)
                 TEST_ASSERT_EQUAL(1, status.busy);
                 TEST_ASSERT_EQUAL(0, status.error);
 
-                rc = volume1P->ProgramData(0, buffer, sizeofDataOperation);
-                TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
                 rc = volume2P->ProgramData(0, buffer, sizeofDataOperation);
                 TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
                 rc = volume2P->ReadData(0, buffer, sizeofDataOperation);
@@ -1067,8 +1083,6 @@ control_t test_concurrentAccessFromTwoCStorageDevices(const size_t call_count)
                 TEST_ASSERT_EQUAL(1, status.busy);
                 TEST_ASSERT_EQUAL(0, status.error);
 
-                rc = mtd2.ProgramData(0, buffer, sizeofDataOperation);
-                TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
                 rc = mtd1.ProgramData(0, buffer, sizeofDataOperation);
                 TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
                 rc = mtd1.ReadData(0, buffer, sizeofDataOperation);
@@ -1117,8 +1131,6 @@ control_t test_concurrentAccessFromTwoCStorageDevices(const size_t call_count)
                 TEST_ASSERT_EQUAL(1, status.busy);
                 TEST_ASSERT_EQUAL(0, status.error);
 
-                rc = mtd1.ProgramData(0, buffer, sizeofDataOperation);
-                TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
                 rc = mtd2.ProgramData(0, buffer, sizeofDataOperation);
                 TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
                 rc = mtd2.ReadData(0, buffer, sizeofDataOperation);
@@ -1195,6 +1207,191 @@ control_t test_concurrentAccessFromTwoCStorageDevices(const size_t call_count)
     return CaseNext;
 }
 
+/* Operations of two volumes are issued back-to-back; the second volume's
+ * operation is queued behind the first's and completes after it. */
+template <uint64_t OFFSET1, uint64_t SIZE1, uint64_t OFFSET2, uint64_t SIZE2>
+control_t test_queuedAccessFromTwoVolumes(const size_t call_count)
+{
+    tr_info("test_queuedAccessFromTwoVolumes: called with call_count %lu", call_count);
+
+    if (MAX_VOLUMES <= 1) {
+        return CaseNext;
+    }
+
+    static StorageVolumeManager volumeManager;
+    static StorageVolume *volume1P = NULL;
+    static StorageVolume *volume2P = NULL;
+    static size_t sizeofDataOperation;
+
+    const uint8_t PATTERN_FOR_PROGRAM_DATA1 = 0x5A;
+    const uint8_t PATTERN_FOR_PROGRAM_DATA2 = 0xA5;
+    static uint8_t buffer1[BUFFER_SIZE / 2];
+    static uint8_t buffer2[BUFFER_SIZE / 2];
+
+    static enum {
+        VOLUME_MANAGER_INITIALIZE = 1,
+        ADD_VOLUMES,
+        ERASE_BOTH,
+        PROGRAM_DATA_BOTH,
+        DISCONNECT_VOLUME_MANAGER_CALLBACK,
+        READ_FROM_DRV_AFTER_PROGRAM_DATA1,
+        VERIFY_PROGRAM_DATA1,
+        READ_FROM_DRV_AFTER_PROGRAM_DATA2,
+        VERIFY_PROGRAM_DATA2,
+    } state = VOLUME_MANAGER_INITIALIZE;
+    tr_info("came in with state %u", state);
+
+    int32_t rc;
+    switch (state) {
+        case VOLUME_MANAGER_INITIALIZE:
+            rc = volumeManager.initialize(drv, initializeCallbackHandler);
+            TEST_ASSERT(rc >= ARM_DRIVER_OK);
+            if (rc == ARM_DRIVER_OK) {
+                TEST_ASSERT_EQUAL(1,  drv->GetCapabilities().asynchronous_ops);
+                state = ADD_VOLUMES;
+                return CaseTimeout(200) + CaseRepeatAll;
+            }
+
+            /* synchronous completion */
+            TEST_ASSERT(rc == 1);
+
+            /* intentional fall-through */
+
+        case ADD_VOLUMES:
+            TEST_ASSERT_EQUAL(true, volumeManager.isInitialized());
+
+            rc = volumeManager.addVolume(OFFSET1 /*addr*/, SIZE1 /*size*/ , &volume1P);
+            TEST_ASSERT_EQUAL(ARM_DRIVER_OK, rc);
+            rc = volume1P->Initialize(firstVolumeCallbackHandler);
+            TEST_ASSERT_EQUAL(1, rc);
+
+            rc = volumeManager.addVolume(OFFSET2 /*addr*/, SIZE2 /*size*/ , &volume2P);
+            TEST_ASSERT_EQUAL(ARM_DRIVER_OK, rc);
+            rc = volume2P->Initialize(secondVolumeCallbackHandler);
+            TEST_ASSERT_EQUAL(1, rc);
+
+            sizeofDataOperation = (SIZE1 > sizeof(buffer1)) ? sizeof(buffer1) : SIZE1;
+            sizeofDataOperation = (SIZE2 > sizeofDataOperation) ? sizeofDataOperation : SIZE2;
+            TEST_ASSERT(sizeofDataOperation > 0);
+            memset(buffer1, PATTERN_FOR_PROGRAM_DATA1, sizeofDataOperation);
+            memset(buffer2, PATTERN_FOR_PROGRAM_DATA2, sizeofDataOperation);
+
+            /* intentional fall-through */
+
+        case ERASE_BOTH:
+            completedOperations = 0;
+            rc = volume1P->Erase(0, sizeofDataOperation);
+            TEST_ASSERT(rc >= ARM_DRIVER_OK);
+            if (rc == ARM_DRIVER_OK) {
+                TEST_ASSERT_EQUAL(1, volume1P->GetCapabilities().asynchronous_ops);
+
+                rc = volume2P->Erase(0, sizeofDataOperation);
+                TEST_ASSERT_EQUAL(ARM_DRIVER_OK, rc); /* queued behind volume1's erase */
+
+                /* every volume has at most one operation outstanding */
+                rc = volume1P->Erase(0, sizeofDataOperation);
+                TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
+                rc = volume2P->ReadData(0, buffer, sizeofDataOperation);
+                TEST_ASSERT_EQUAL(ARM_DRIVER_ERROR_BUSY, rc);
+
+                state = PROGRAM_DATA_BOTH;
+                return CaseTimeout(400) + CaseRepeatAll;
+            }
+
+            /* synchronous storage; operations are never queued */
+            firstVolumeCallbackStatus = rc;
+            rc = volume2P->Erase(0, sizeofDataOperation);
+            TEST_ASSERT_EQUAL(sizeofDataOperation, rc);
+            virtualVolumeCallbackStatus = rc;
+            completedOperations = 2;
+            /* intentional fallthrough */
+
+        case PROGRAM_DATA_BOTH:
+            TEST_ASSERT_EQUAL(2, completedOperations);
+            TEST_ASSERT_EQUAL(sizeofDataOperation, firstVolumeCallbackStatus);
+            TEST_ASSERT_EQUAL(sizeofDataOperation, virtualVolumeCallbackStatus);
+
+            tr_info("PROGRAM_DATA_BOTH");
+            completedOperations = 0;
+            rc = volume1P->ProgramData(0, buffer1, sizeofDataOperation);
+            TEST_ASSERT(rc >= ARM_DRIVER_OK);
+            if (rc == ARM_DRIVER_OK) {
+                TEST_ASSERT_EQUAL(1, volume1P->GetCapabilities().asynchronous_ops);
+
+                rc = volume2P->ProgramData(0, buffer2, sizeofDataOperation);
+                TEST_ASSERT_EQUAL(ARM_DRIVER_OK, rc); /* queued behind volume1's program */
+
+                ARM_STORAGE_STATUS status;
+                status = volume2P->GetStatus();
+                TEST_ASSERT_EQUAL(1, status.busy);
+                TEST_ASSERT_EQUAL(0, status.error);
+
+                state = DISCONNECT_VOLUME_MANAGER_CALLBACK;
+                return CaseTimeout(400) + CaseRepeatAll;
+            }
+
+            firstVolumeCallbackStatus = rc;
+            rc = volume2P->ProgramData(0, buffer2, sizeofDataOperation);
+            TEST_ASSERT_EQUAL(sizeofDataOperation, rc);
+            virtualVolumeCallbackStatus = rc;
+            completedOperations = 2;
+            /* intentional fallthrough */
+
+        case DISCONNECT_VOLUME_MANAGER_CALLBACK:
+            TEST_ASSERT_EQUAL(2, completedOperations);
+            TEST_ASSERT_EQUAL(sizeofDataOperation, firstVolumeCallbackStatus);
+            TEST_ASSERT_EQUAL(sizeofDataOperation, virtualVolumeCallbackStatus);
+
+            tr_info("DISCONNECT_VOLUME_MANAGER_CALLBACK");
+            rc = drv->Initialize(mtdCallbackHandler);
+            TEST_ASSERT_EQUAL(1, rc); /* expect synchronous completion */
+            /* intentional fallthrough */
+
+        case READ_FROM_DRV_AFTER_PROGRAM_DATA1:
+            rc = drv->ReadData(OFFSET1, buffer, sizeofDataOperation);
+            TEST_ASSERT(rc >= ARM_DRIVER_OK);
+            if (rc == ARM_DRIVER_OK) {
+                TEST_ASSERT_EQUAL(1, drv->GetCapabilities().asynchronous_ops);
+                state = VERIFY_PROGRAM_DATA1;
+                return CaseTimeout(200) + CaseRepeatAll;
+            }
+
+            callbackStatus = rc;
+            /* intentional fallthrough */
+
+        case VERIFY_PROGRAM_DATA1:
+            TEST_ASSERT_EQUAL(sizeofDataOperation, callbackStatus);
+            for (uint32_t index = 0; index < sizeofDataOperation; index++) {
+                TEST_ASSERT_EQUAL(PATTERN_FOR_PROGRAM_DATA1, buffer[index]);
+            }
+            /* intentional fallthrough */
+
+        case READ_FROM_DRV_AFTER_PROGRAM_DATA2:
+            rc = drv->ReadData(OFFSET2, buffer, sizeofDataOperation);
+            TEST_ASSERT(rc >= ARM_DRIVER_OK);
+            if (rc == ARM_DRIVER_OK) {
+                TEST_ASSERT_EQUAL(1, drv->GetCapabilities().asynchronous_ops);
+                state = VERIFY_PROGRAM_DATA2;
+                return CaseTimeout(200) + CaseRepeatAll;
+            }
+
+            callbackStatus = rc;
+            /* intentional fallthrough */
+
+        case VERIFY_PROGRAM_DATA2:
+            TEST_ASSERT_EQUAL(sizeofDataOperation, callbackStatus);
+            for (uint32_t index = 0; index < sizeofDataOperation; index++) {
+                TEST_ASSERT_EQUAL(PATTERN_FOR_PROGRAM_DATA2, buffer[index]);
+            }
+            break;
+
+        default:
+            TEST_ASSERT(false);
+    }
+
+    return CaseNext;
+}
+
 // Specify all your test cases here
 Case cases[] = {
     Case("initialize",                                    test_initialize),
@@ -1215,6 +1412,8 @@ Case cases[] = {
     Case("Concurrent accesss from two C_Storage devices", test_concurrentAccessFromTwoCStorageDevices<512*1024, 128*1024, (512+128)*1024, 128*1024>),
     Case("Concurrent accesss from two C_Storage devices", test_concurrentAccessFromTwoCStorageDevices<512*1024, 128*1024, (512+256)*1024, 128*1024>),
     Case("Concurrent accesss from two C_Storage devices", test_concurrentAccessFromTwoCStorageDevices<512*1024, 128*1024, (512+384)*1024, 128*1024>),
+    Case("Queued accesses from two volumes",              test_queuedAccessFromTwoVolumes<512*1024, 128*1024, (512+128)*1024, 128*1024>),
+    Case("Queued accesses from two volumes",              test_queuedAccessFromTwoVolumes<512*1024, 128*1024, (512+384)*1024, 128*1024>),
 };
 
 // Declare your test specification with a custom setup handler
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef TARGET_LIKE_POSIX
+#define AVOID_GREENTEA
+#endif
+
+#ifndef AVOID_GREENTEA
+#include "greentea-client/test_env.h"
+#endif
+#include "utest/utest.h"
+#include "unity/unity.h"
+
+#include "update-writer/update_writer.h"
+#include "mbed.h"
+#include <string.h>
+
+using namespace utest::v1;
+
+extern ARM_DRIVER_STORAGE ARM_Driver_Storage_MTD_K64F;
+ARM_DRIVER_STORAGE *drv = &ARM_Driver_Storage_MTD_K64F;
+
+static UpdateWriter_t   writer;
+
+static const uint32_t   REGION_ERASE_UNITS = 4;
+static const size_t     CHUNK_SIZE         = 100; /* not a multiple of the buffers, like network reads */
+static uint8_t          chunk[CHUNK_SIZE];
+static uint8_t          readBack[CHUNK_SIZE];
+
+static volatile int32_t callbackStatus;
+static volatile bool    initialized;
+static volatile bool    writable;
+static volatile bool    finalized;
+
+void callbackHandler(int32_t status, UpdateWriter_OpCode_t cmd_code)
+{
+    callbackStatus = status;
+    switch (cmd_code) {
+        case UPDATE_WRITER_OPCODE_INITIALIZE:
+            initialized = true;
+            break;
+        case UPDATE_WRITER_OPCODE_WRITE:
+            writable = true;
+            break;
+        case UPDATE_WRITER_OPCODE_FINALIZE:
+            finalized = true;
+            break;
+    }
+}
+
+static uint8_t imageByte(size_t offset)
+{
+    return (uint8_t)((offset * 7) ^ (offset >> 8));
+}
+
+static void getRegion(uint64_t *addr, uint64_t *size)
+{
+    ARM_STORAGE_BLOCK block;
+    TEST_ASSERT_EQUAL(ARM_DRIVER_OK, drv->GetNextBlock(NULL, &block));
+    TEST_ASSERT_TRUE(ARM_STORAGE_VALID_BLOCK(&block));
+    TEST_ASSERT(block.attributes.erase_unit > 0);
+    TEST_ASSERT(block.size >= REGION_ERASE_UNITS * block.attributes.erase_unit);
+
+    *addr = block.addr;
+    *size = REGION_ERASE_UNITS * block.attributes.erase_unit;
+}
+
+static void initializeWriter(uint64_t addr, uint64_t size)
+{
+    initialized = false;
+    int32_t rc = UpdateWriter_initialize(&writer, drv, addr, size, callbackHandler);
+    TEST_ASSERT(rc >= UPDATE_WRITER_STATUS_OK);
+    if (rc == UPDATE_WRITER_STATUS_OK) {
+        while (!initialized) {
+            /* wait for the storage */
+        }
+        TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_OK, callbackStatus);
+    } else {
+        TEST_ASSERT_EQUAL(1, rc); /* synchronous completion of initialize() is expected to return 1 */
+    }
+}
+
+/* write size bytes of the image from offset, retrying the rest of short
+ * writes as soon as the writer has room again */
+static void writeImage(size_t offset, size_t size)
+{
+    while (size > 0) {
+        size_t n = (size < CHUNK_SIZE) ? size : CHUNK_SIZE;
+        for (size_t i = 0; i < n; i++) {
+            chunk[i] = imageByte(offset + i);
+        }
+
+        size_t done = 0;
+        while (done < n) {
+            writable = false;
+            int32_t rc = UpdateWriter_write(&writer, chunk + done, n - done);
+            TEST_ASSERT(rc >= 0);
+            done += rc;
+            if (done < n) {
+                while (!writable) {
+                    /* wait for a buffer to be programmed */
+                }
+                TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_OK, callbackStatus);
+            }
+        }
+
+        offset += n;
+        size   -= n;
+    }
+}
+
+control_t test_initializeUnaligned()
+{
+    uint64_t addr, size;
+    getRegion(&addr, &size);
+
+    int32_t rc = UpdateWriter_initialize(&writer, drv, addr + 1, size - 1, callbackHandler);
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_PARAMETER, rc);
+
+    rc = UpdateWriter_initialize(&writer, drv, addr, size - 1, callbackHandler);
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_PARAMETER, rc);
+
+    return CaseNext;
+}
+
+control_t test_writeBeforeInitialize()
+{
+    uint8_t hash[UPDATE_WRITER_HASH_SIZE];
+
+    memset(&writer, 0, sizeof(writer));
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_NOT_INITIALIZED, UpdateWriter_write(&writer, chunk, CHUNK_SIZE));
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_NOT_INITIALIZED, UpdateWriter_finalize(&writer, hash));
+
+    return CaseNext;
+}
+
+/* The image is programmed as it comes in; once finalized, the storage holds
+ * it, padded, and the hash is the one of the data written. */
+template<size_t IMAGE_SIZE_OFFSET>
+control_t test_writeAndFinalize()
+{
+    uint64_t addr, size;
+    getRegion(&addr, &size);
+    const size_t imageSize = (size_t)size - IMAGE_SIZE_OFFSET;
+
+    initializeWriter(addr, size);
+    writeImage(0, imageSize);
+
+    uint8_t hash[UPDATE_WRITER_HASH_SIZE];
+    finalized = false;
+    int32_t rc = UpdateWriter_finalize(&writer, hash);
+    TEST_ASSERT(rc >= UPDATE_WRITER_STATUS_OK);
+    if (rc == UPDATE_WRITER_STATUS_OK) {
+        while (!finalized) {
+            /* wait for the tail of the image to be programmed */
+        }
+        TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_OK, callbackStatus);
+    } else {
+        TEST_ASSERT_EQUAL(1, rc);
+    }
+
+    /* write() is refused once the image is finalized */
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_NOT_INITIALIZED, UpdateWriter_write(&writer, chunk, 1));
+
+    mbedtls_sha256_context sha256;
+    uint8_t expectedHash[UPDATE_WRITER_HASH_SIZE];
+    mbedtls_sha256_init(&sha256);
+    mbedtls_sha256_starts(&sha256, 0);
+    for (size_t offset = 0; offset < imageSize; offset += CHUNK_SIZE) {
+        size_t n = (imageSize - offset < CHUNK_SIZE) ? imageSize - offset : CHUNK_SIZE;
+        for (size_t i = 0; i < n; i++) {
+            chunk[i] = imageByte(offset + i);
+        }
+        mbedtls_sha256_update(&sha256, chunk, n);
+
+        rc = drv->ReadData(addr + offset, readBack, n);
+        TEST_ASSERT_EQUAL(n, rc); /* the K64F MTD reads synchronously */
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(chunk, readBack, n);
+    }
+    mbedtls_sha256_finish(&sha256, expectedHash);
+    mbedtls_sha256_free(&sha256);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedHash, hash, UPDATE_WRITER_HASH_SIZE);
+
+    return CaseNext;
+}
+
+control_t test_writePastCapacity()
+{
+    uint64_t addr, size;
+    getRegion(&addr, &size);
+
+    initializeWriter(addr, size);
+    writeImage(0, (size_t)size - CHUNK_SIZE / 2);
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_BOUNDED_CAPACITY, UpdateWriter_write(&writer, chunk, CHUNK_SIZE));
+
+    return CaseNext;
+}
+
+/* while an image is being written, a second one is refused until the first
+ * has been abandoned */
+control_t test_abort()
+{
+    uint64_t addr, size;
+    getRegion(&addr, &size);
+
+    UpdateWriter_t other;
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_BUSY, UpdateWriter_initialize(&other, drv, addr, size, callbackHandler));
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_OK, UpdateWriter_abort(&writer));
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_NOT_INITIALIZED, UpdateWriter_write(&writer, chunk, CHUNK_SIZE));
+
+    int32_t rc;
+    while ((rc = UpdateWriter_initialize(&writer, drv, addr, size, callbackHandler)) == UPDATE_WRITER_STATUS_BUSY) {
+        /* an erase or program started before abort() is still in progress */
+    }
+    TEST_ASSERT(rc >= UPDATE_WRITER_STATUS_OK);
+    TEST_ASSERT_EQUAL(UPDATE_WRITER_STATUS_OK, UpdateWriter_abort(&writer));
+
+    return CaseNext;
+}
+
+#ifndef AVOID_GREENTEA
+// Custom setup handler required for proper Greentea support
+status_t greentea_setup(const size_t number_of_cases)
+{
+    GREENTEA_SETUP(60, "default_auto");
+    // Call the default reporting function
+    return greentea_test_setup_handler(number_of_cases);
+}
+#else
+status_t default_setup(const size_t)
+{
+    return STATUS_CONTINUE;
+}
+#endif
+
+// Specify all your test cases here
+Case cases[] = {
+    Case("initialize with an unaligned region",         test_initializeUnaligned),
+    Case("write before initialize",                     test_writeBeforeInitialize),
+    Case("write and finalize a full region",            test_writeAndFinalize<0>),
+    Case("write and finalize a padded tail",            test_writeAndFinalize<1021>),
+    Case("write past capacity",                         test_writePastCapacity),
+    Case("abort",                                       test_abort),
+};
+
+// Declare your test specification with a custom setup handler
+#ifndef AVOID_GREENTEA
+Specification specification(greentea_setup, cases);
+#else
+Specification specification(default_setup, cases);
+#endif
+
+int main(int argc, char** argv)
+{
+    // Run the test specification
+    Harness::run(specification);
+}
@@ -129,11 +129,13 @@ extern "C" {
 #define ARM_CFSTORE_DRIVER_ERROR_OPERATION_PENDING                                  -1035
 #define ARM_CFSTORE_DRIVER_ERROR_UVISOR_BOX_ID                                      -1036
 #define ARM_CFSTORE_DRIVER_ERROR_UVISOR_NAMESPACE                                   -1037
+#define ARM_CFSTORE_DRIVER_ERROR_VALUE_MAPPED                                       -1038
 /// @endcond
 
 
 /* Type Definitions */
 typedef void *ARM_CFSTORE_HANDLE;   //!< opaque cfstore handle for manipulating cfstore data objects e.g. KV pairs.
+typedef void *ARM_CFSTORE_FIND_ITER;    //!< opaque cfstore iterator over the results of a find query.
 typedef size_t ARM_CFSTORE_SIZE;    //!< CFSTORE type for size parameters.
 typedef size_t ARM_CFSTORE_OFFSET;  //!< CFSTORE type for offset parameters.
 
@@ -163,6 +165,17 @@ typedef struct _ARM_CFSTORE_STATUS {
     ARM_CFSTORE_HANDLE (__name) = (ARM_CFSTORE_HANDLE) (__name##_buf_cFsToRe);  \
     memset((__name##_buf_cFsToRe), 0, CFSTORE_HANDLE_BUFSIZE)
 
+#define CFSTORE_FIND_ITER_BUFSIZE       16          //!< size of the buffer owned and supplied by client
+                                                    //!< to CFSTORE to hold the state of a (*FindIter)() iteration.
+
+/** @brief   Helper macro to declare a find iterator and client owned buffer
+ *           supplied to CFSTORE for storing opaque iterator state
+ */
+#define ARM_CFSTORE_FIND_ITER_INIT(__name)                                          \
+    uint8_t (__name##_buf_cFsToRe)[CFSTORE_FIND_ITER_BUFSIZE];                      \
+    ARM_CFSTORE_FIND_ITER (__name) = (ARM_CFSTORE_FIND_ITER) (__name##_buf_cFsToRe); \
+    memset((__name##_buf_cFsToRe), 0, CFSTORE_FIND_ITER_BUFSIZE)
+
 #if defined __MBED__ && defined TOOLCHAIN_GCC_ARM
 /** @brief  Helper macro to swap 2 handles, which is useful for the Find() idiom. */
 #define CFSTORE_HANDLE_SWAP(__a_HaNdLe, __b_HaNdLe)         \
@@ -272,6 +285,8 @@ typedef enum ARM_CFSTORE_OPCODE {
     CFSTORE_OPCODE_RSEEK,           //!< used for \ref ARM_CFSTORE_CALLBACK ::cmd_code argument when indicating status for a previous \ref ARM_CFSTORE_DRIVER ::(*Rseek)() call.
     CFSTORE_OPCODE_UNINITIALIZE,    //!< used for \ref ARM_CFSTORE_CALLBACK ::cmd_code argument when indicating status for a previous \ref ARM_CFSTORE_DRIVER ::(*Uninitialize)() call.
     CFSTORE_OPCODE_WRITE,           //!< used for \ref ARM_CFSTORE_CALLBACK ::cmd_code argument when indicating status for a previous \ref ARM_CFSTORE_DRIVER ::(*Write)() call.
+    CFSTORE_OPCODE_MAP,             //!< used for \ref ARM_CFSTORE_CALLBACK ::cmd_code argument when indicating status for a previous \ref ARM_CFSTORE_DRIVER ::(*Map)() call.
+    CFSTORE_OPCODE_FIND_ITER,       //!< used for \ref ARM_CFSTORE_CALLBACK ::cmd_code argument when indicating status for a previous \ref ARM_CFSTORE_DRIVER ::(*FindIter)() call.
     CFSTORE_OPCODE_MAX              //!< Sentinel
 } ARM_CFSTORE_OPCODE;
 
@@ -545,6 +560,68 @@ typedef struct _ARM_DRIVER_CFSTORE
     int32_t (*Find)(const char* key_name_query, const ARM_CFSTORE_HANDLE previous, ARM_CFSTORE_HANDLE next);
 
 
+    /** @brief   iterate over the stored keys that match a query string
+     *
+     *          (*FindIter)() returns the same KVs as (*Find)() for the same
+     *          query, but the query is parsed once, on the first call, and
+     *          the position reached is kept in the iterator, so walking all
+     *          the results takes time linear in their number rather than
+     *          restarting the search at each call. With the key index
+     *          enabled (see cfstore_config.h), the KVs of a query with a
+     *          literal prefix e.g. 'com.arm.mbed.wifi.*' are found from the
+     *          index in key name order, without considering the other KVs.
+     *          Otherwise they are returned in the order of the sram area.
+     * ```
+     *          const char* key_name_query = "com.arm.mbed.wifi.*";
+     *          ARM_CFSTORE_FIND_ITER_INIT(iter);
+     *          ARM_CFSTORE_HANDLE_INIT(next);
+     *          ARM_CFSTORE_HANDLE_INIT(prev);
+     *
+     *          while(drv->FindIter(iter, key_name_query, prev, next) == ARM_DRIVER_OK)
+     *          {
+     *              // use next
+     *              CFSTORE_HANDLE_SWAP(prev, next);
+     *          }
+     * ```
+     *          KVs may be created and deleted during the iteration. KVs
+     *          created during it are returned only if they come after the
+     *          position reached, in the order of the iteration.
+     *
+     * @param   iter
+     *          IN: pointer to client owned buffer of
+     *          CFSTORE_FIND_ITER_BUFSIZE bytes, initialised to 0 before the
+     *          first call, which holds the state of the iteration.
+     * @param   key_name_query
+     *          IN: a search string to find, as for (*Find)(). The same query
+     *          must be supplied to all the calls of an iteration.
+     * @param   previous
+     *          IN: as for (*Find)(), a buffer initialised to 0 on the first
+     *          call, then the handle returned by the previous call, which
+     *          CFSTORE closes.
+     * @param   next
+     *          IN: pointer to client owned buffer of CFSTORE_HANDLE_BUFSIZE
+     *          bytes.
+     *          OUT: Success: a read-only handle to the next matching KV,
+     *          which must be closed by the client.
+     * @return
+     *          ARM_DRIVER_OK on finding the next KV matching the query,
+     *          ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND once there are no more.
+     * See REFERENCE_1 and the ARM_CFSTORE_CALLBACK documentation.
+     * ARM_CFSTORE_DRIVER::(*FindIter)() asynchronous completion command code
+     * (*ARM_CFSTORE_CALLBACK) function argument values on return:
+     * @param    status
+     *           ARM_DRIVER_OK => success, hkey contains open key
+     *           else failure.
+     * @param    cmd_code == CFSTORE_OPCODE_FIND_ITER
+     * @param    client context
+     *           as registered with ARM_CFSTORE_DRIVER::(*Initialize)()
+     * @param    hkey
+     *           ARM_DRIVER_OK => contains returned handle to newly found key.
+     *           else, indeterminate data.
+     */
+    int32_t (*FindIter)(ARM_CFSTORE_FIND_ITER iter, const char* key_name_query, const ARM_CFSTORE_HANDLE previous, ARM_CFSTORE_HANDLE next);
+
+
     /** @brief
      *
      * Flush (write) the configuration changes to the nv backing store.
@@ -699,6 +776,48 @@ typedef struct _ARM_DRIVER_CFSTORE
     int32_t (*Initialize)(ARM_CFSTORE_CALLBACK callback, void* client_context);
 
 
+    /** @brief  Map the value data of a KV for reading in place.
+     *
+     * Map() returns a pointer to the value data held in the CFSTORE sram
+     * area, so a client can parse a large value (e.g. a certificate) without
+     * copying it into a buffer of its own. The data must not be written
+     * through the pointer.
+     *
+     * The mapping remains valid until the last open handle to the KV is
+     * closed. While any KV is mapped the sram area is pinned:
+     * - (*Create)() of a new KV, or (*Create)() changing the length of a
+     *   pre-existing KV, fails with ARM_CFSTORE_DRIVER_ERROR_VALUE_MAPPED.
+     * - the removal of deleted KVs from the area is deferred until no KV
+     *   is mapped. Deleted KVs cannot be found in the meantime.
+     * Writes to the value data of a mapped KV are visible through the
+     * mapping. (*Uninitialize)() invalidates all mappings.
+     *
+     * @param   hkey
+     *          IN: a previously returned handle to the KV to map.
+     * @param   data
+     *          OUT: on success, the location of the value data.
+     * @param   len
+     *          OUT: on success, the length of the value data.
+     *
+     * @return
+     * See REFERENCE_1 and the ARM_CFSTORE_CALLBACK documentation.
+     *          return_value >= 0, synchronous completion with the length
+     *          of the value data == return_value
+     *          return_value < 0, error condition.
+     *
+     * ARM_CFSTORE_DRIVER::(*Map)() asynchronous completion command code
+     * (*ARM_CFSTORE_CALLBACK) function argument values on return:
+     * @param    status
+     *           >= 0 => success with the length of the value data equal to
+     *           the value of status
+     *           < 0 => error
+     * @param    cmd_code == CFSTORE_OPCODE_MAP
+     * @param    client context, registered ARM_CFSTORE_DRIVER::(*Initialize)()
+     * @param    hkey, the handle of the mapped KV.
+     */
+    int32_t (*Map)(ARM_CFSTORE_HANDLE hkey, const void** data, ARM_CFSTORE_SIZE* len);
+
+
     /** @brief  Function to set the target configuration store power state.
      *
      * @param state
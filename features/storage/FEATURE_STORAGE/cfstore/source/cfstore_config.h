@@ -56,6 +56,41 @@
 #define CFSTORE_CONFIG_BACKEND_FLASH_ENABLED
 #endif
 
+/* CFSTORE_KEY_INDEX_DISABLE
+ *   Disable the in-memory index of the key names used to find KVs without
+ *   walking the whole sram area. The index is allocated from the heap
+ *   (up to 24 bytes per KV) so it is not used when the client supplies the
+ *   sram area with CFSTORE_YOTTA_CFG_CFSTORE_SRAM_ADDR.
+ */
+#if CFSTORE_KEY_INDEX_DISABLE==0 && !defined CFSTORE_YOTTA_CFG_CFSTORE_SRAM_ADDR
+#define CFSTORE_CONFIG_KEY_INDEX_ENABLED
+#endif
+
+/* CFSTORE_DELTA_LOG_SIZE
+ *   Size of the flash log taken from the end of the cfstore flash area. A
+ *   flush appends the KVs changed since the last flush to the log, and the
+ *   whole store is only committed to the flash journal when the log is full.
+ *   The log needs a synchronous storage driver.
+ */
+#if defined CFSTORE_CONFIG_BACKEND_FLASH_ENABLED && defined CFSTORE_DELTA_LOG_SIZE
+#if CFSTORE_DELTA_LOG_SIZE > 0
+#define CFSTORE_CONFIG_DELTA_LOG_ENABLED
+#endif
+#endif
+
+/* CFSTORE_FLASH_JOURNAL_MULTISLOT
+ *   Use the multi-slot flash journal strategy rather than the sequential one.
+ *   The slot which takes the next flush is erased once a flush has been
+ *   committed (in the background with an asynchronous storage driver). The
+ *   journal formats differ, so the flash area is reformatted when the
+ *   strategy is changed.
+ */
+#if defined CFSTORE_CONFIG_BACKEND_FLASH_ENABLED && defined CFSTORE_FLASH_JOURNAL_MULTISLOT
+#if CFSTORE_FLASH_JOURNAL_MULTISLOT > 0
+#define CFSTORE_CONFIG_JOURNAL_MULTISLOT_ENABLED
+#endif
+#endif
+
 #if defined STORAGE_CONFIG_HARDWARE_MTD_K64F_ASYNC_OPS
 #define CFSTORE_STORAGE_DRIVER_CONFIG_HARDWARE_MTD_ASYNC_OPS STORAGE_CONFIG_HARDWARE_MTD_K64F_ASYNC_OPS
 #endif
@@ -30,7 +30,14 @@
  */
 
 #define CFSTORE_SVM_VOL_01_START_OFFSET       0x80000UL
+#ifdef CFSTORE_CONFIG_DELTA_LOG_ENABLED
+/* the delta log volume is taken from the end of the cfstore area */
+#define CFSTORE_SVM_VOL_01_SIZE               (0x80000UL - CFSTORE_SVM_VOL_02_SIZE)
+#define CFSTORE_SVM_VOL_02_START_OFFSET       (CFSTORE_SVM_VOL_01_START_OFFSET + CFSTORE_SVM_VOL_01_SIZE)
+#define CFSTORE_SVM_VOL_02_SIZE               ((unsigned long) CFSTORE_DELTA_LOG_SIZE)
+#else
 #define CFSTORE_SVM_VOL_01_SIZE               0x80000UL
+#endif /* CFSTORE_CONFIG_DELTA_LOG_ENABLED */
 
 #ifdef CFSTORE_CONFIG_BACKEND_FLASH_ENABLED
 extern ARM_DRIVER_STORAGE ARM_Driver_Storage_MTD_K64F;
@@ -74,3 +81,24 @@ int32_t cfstore_svm_init(struct _ARM_DRIVER_STORAGE *storage_mtd)
     }
     return ret;
 }
+
+#ifdef CFSTORE_CONFIG_DELTA_LOG_ENABLED
+int32_t cfstore_svm_delta_init(struct _ARM_DRIVER_STORAGE *delta_mtd)
+{
+    int32_t ret = ARM_DRIVER_OK;
+
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+    /* cfstore_svm_init() has initialised the volume manager */
+    ret = volumeManager.addVolume_C(CFSTORE_SVM_VOL_02_START_OFFSET, CFSTORE_SVM_VOL_02_SIZE, delta_mtd);
+    if(ret < ARM_DRIVER_OK) {
+        CFSTORE_ERRLOG("%s:debug: volume-manager::addVolume_C() failed for delta_mtd=%p (ret=%d)", __func__, delta_mtd, (int) ret);
+        return ret;
+    }
+    ret = delta_mtd->Initialize(cfstore_svm_journal_mtc_callback);
+    if(ret < ARM_DRIVER_OK) {
+        CFSTORE_ERRLOG("%s:debug: delta_mtd->initialize() failed for delta_mtd=%p (ret=%d)", __func__, delta_mtd, (int) ret);
+        return ret;
+    }
+    return ret;
+}
+#endif /* CFSTORE_CONFIG_DELTA_LOG_ENABLED */
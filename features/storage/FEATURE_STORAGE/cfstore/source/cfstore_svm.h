@@ -32,6 +32,7 @@ extern "C" {
 
 
 int32_t cfstore_svm_init(struct _ARM_DRIVER_STORAGE *mtd);
+int32_t cfstore_svm_delta_init(struct _ARM_DRIVER_STORAGE *mtd);
 
 
 #ifdef __cplusplus
@@ -24,7 +24,13 @@
 #include "configuration_store.h"
 
 #ifdef CFSTORE_CONFIG_BACKEND_FLASH_ENABLED
+#ifdef CFSTORE_CONFIG_JOURNAL_MULTISLOT_ENABLED
+#include "flash_journal_strategy_multislot.h"
+#define CFSTORE_TEST_FLASH_JOURNAL_STRATEGY     FLASH_JOURNAL_STRATEGY_MULTISLOT
+#else
 #include "flash_journal_strategy_sequential.h"
+#define CFSTORE_TEST_FLASH_JOURNAL_STRATEGY     FLASH_JOURNAL_STRATEGY_SEQUENTIAL
+#endif /* CFSTORE_CONFIG_JOURNAL_MULTISLOT_ENABLED */
 #include "flash_journal.h"
 #include "Driver_Common.h"
 #endif /* CFSTORE_CONFIG_BACKEND_FLASH_ENABLED */
@@ -112,6 +118,8 @@ const char* cfstore_test_opcode_str[] =
     "CFSTORE_OPCODE_RSEEK",
     "CFSTORE_OPCODE_UNINITIALIZE",
     "CFSTORE_OPCODE_WRITE",
+    "CFSTORE_OPCODE_MAP",
+    "CFSTORE_OPCODE_FIND_ITER",
     "CFSTORE_OPCODE_MAX"
 };
 
@@ -260,7 +268,7 @@ int32_t cfstore_test_startup(void)
     extern ARM_DRIVER_STORAGE ARM_Driver_Storage_MTD_K64F;
     const ARM_DRIVER_STORAGE *drv = &ARM_Driver_Storage_MTD_K64F;
 
-    ret = FlashJournal_initialize(&jrnl, drv, &FLASH_JOURNAL_STRATEGY_SEQUENTIAL, NULL);
+    ret = FlashJournal_initialize(&jrnl, drv, &CFSTORE_TEST_FLASH_JOURNAL_STRATEGY, NULL);
     if(ret < JOURNAL_STATUS_OK){
         CFSTORE_ERRLOG("%s:Error: failed to initialize flash journaling layer (ret=%d)\n", __func__, (int) ret);
         return ARM_DRIVER_ERROR;
@@ -50,6 +50,8 @@ void cfstore_utest_default_callback(int32_t status, ARM_CFSTORE_OPCODE cmd_code,
     case CFSTORE_OPCODE_READ:
     case CFSTORE_OPCODE_RSEEK:
     case CFSTORE_OPCODE_WRITE:
+    case CFSTORE_OPCODE_MAP:
+    case CFSTORE_OPCODE_FIND_ITER:
     default:
         CFSTORE_DBGLOG("%s:debug: received asynchronous notification for opcode=%d (%s)", __func__, cmd_code, cmd_code < CFSTORE_OPCODE_MAX ? cfstore_test_opcode_str[cmd_code] : "unknown");
     }
@@ -32,11 +32,19 @@
 
 #ifdef CFSTORE_CONFIG_BACKEND_FLASH_ENABLED
 #include "cfstore_svm.h"
+#ifdef CFSTORE_CONFIG_JOURNAL_MULTISLOT_ENABLED
+#include "flash_journal_strategy_multislot.h"
+#else
 #include "flash_journal_strategy_sequential.h"
+#endif /* CFSTORE_CONFIG_JOURNAL_MULTISLOT_ENABLED */
 #include "flash_journal.h"
 #include "Driver_Common.h"
 #endif /* CFSTORE_CONFIG_BACKEND_FLASH_ENABLED */
 
+#ifdef CFSTORE_CONFIG_DELTA_LOG_ENABLED
+#include "flash_journal_crc.h"
+#endif /* CFSTORE_CONFIG_DELTA_LOG_ENABLED */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -62,6 +70,9 @@ ARM_DRIVER_STORAGE *cfstore_storage_drv = &ARM_Driver_Storage_MTD_K64F;
 #endif /* CFSTORE_CONFIG_BACKEND_FLASH_ENABLED */
 
 struct _ARM_DRIVER_STORAGE cfstore_journal_mtd;
+#ifdef CFSTORE_CONFIG_DELTA_LOG_ENABLED
+struct _ARM_DRIVER_STORAGE cfstore_delta_mtd;
+#endif /* CFSTORE_CONFIG_DELTA_LOG_ENABLED */
 
 /*
  * Defines
@@ -77,6 +88,10 @@ struct _ARM_DRIVER_STORAGE cfstore_journal_mtd;
  * CFSTORE_FLASH_NUMSLOTS
  *  number of flash journal slots
  *
+ * CFSTORE_FLASH_JOURNAL_STRATEGY
+ *  the flash journal strategy, with cfstore_flash_journal_format() the function
+ *  formatting the flash for it
+ *
  * ARM_DRIVER_OK_DONE
  *   value that indicates an operation has been done i.e. a value > 0
  */
@@ -88,6 +103,13 @@ struct _ARM_DRIVER_STORAGE cfstore_journal_mtd;
 #define CFSTORE_FLASH_STACK_BUF_SIZE 	            64
 #define CFSTORE_FLASH_AREA_SIZE_MIN                 (sizeof(cfstore_area_header_t) - 1)
 #define CFSTORE_FLASH_NUMSLOTS                      4
+#ifdef CFSTORE_CONFIG_JOURNAL_MULTISLOT_ENABLED
+#define CFSTORE_FLASH_JOURNAL_STRATEGY              FLASH_JOURNAL_STRATEGY_MULTISLOT
+#define cfstore_flash_journal_format                flashJournalStrategyMultislot_format
+#else
+#define CFSTORE_FLASH_JOURNAL_STRATEGY              FLASH_JOURNAL_STRATEGY_SEQUENTIAL
+#define cfstore_flash_journal_format                flashJournalStrategySequential_format
+#endif /* CFSTORE_CONFIG_JOURNAL_MULTISLOT_ENABLED */
 #define cfstore_fsm_null                            NULL
 #define CFSTORE_SENTINEL                            0x7fffffff
 #define CFSTORE_CALLBACK_RET_CODE_DEFAULT           0x1
@@ -131,6 +153,14 @@ struct _ARM_DRIVER_STORAGE cfstore_journal_mtd;
  *
  * @param   delete
  *          indicates this KV is being deleted
+ *
+ * @param   dirty
+ *          indicates this KV has changed since the last flush to the
+ *          delta log
+ *
+ * @param   mapped
+ *          indicates a client holds a pointer to the value returned by
+ *          Map(), until the last handle to this KV is closed
  */
 typedef struct cfstore_area_header_t
 {
@@ -146,7 +176,9 @@ typedef struct cfstore_area_header_t
     uint8_t refcount;
     struct flags_t {
         uint8_t delete : 1;
-        uint8_t reserved : 7;
+        uint8_t dirty : 1;
+        uint8_t mapped : 1;
+        uint8_t reserved : 5;
     } flags ;
 } cfstore_area_header_t;
 
@@ -254,6 +286,9 @@ static int32_t cfstore_fsm_state_handle_event(cfstore_fsm_t* fsm, cfstore_fsm_ev
 static int32_t cfstore_fsm_state_set(cfstore_fsm_t* fsm, cfstore_fsm_state_t new_state, void* ctx);
 #endif  /* CFSTORE_CONFIG_BACKEND_FLASH_ENABLED */
 static int32_t cfstore_get_key_name_ex(cfstore_area_hkvt_t *hkvt, char* key_name, uint8_t *key_name_len);
+#ifdef CFSTORE_CONFIG_DELTA_LOG_ENABLED
+static int32_t cfstore_delete_ex(cfstore_area_hkvt_t* hkvt);
+#endif /* CFSTORE_CONFIG_DELTA_LOG_ENABLED */
 
 
 /* Walking Area HKVT's While Inserting   a New HKVT:
@@ -326,6 +361,150 @@ static int32_t cfstore_get_key_name_ex(cfstore_area_hkvt_t *hkvt, char* key_name
  *
  */
 
+#ifdef CFSTORE_CONFIG_KEY_INDEX_ENABLED
+/*
+ * @brief   slot of the key name hash table
+ *
+ * @param   hash
+ *          hash of the KV key name
+ *
+ * @param   offset
+ *          offset of the KV head from area_0_head plus 1. 0 marks an
+ *          empty slot.
+ */
+typedef struct cfstore_index_slot_t
+{
+    uint32_t hash;
+    uint32_t offset;
+} cfstore_index_slot_t;
+
+/*
+ * @brief   in-memory index of the KVs in the sram area.
+ *
+ * The index holds offsets from area_0_head rather than pointers so
+ * realloc() moving the area leaves it unchanged. KVs flagged for deletion
+ * remain in the index until they are removed from the area.
+ *
+ * @param   slots
+ *          open addressing hash table of the key names, with (slots_mask + 1)
+ *          slots, used for exact key name lookups.
+ *
+ * @param   sorted
+ *          KV offsets sorted by key name (and by offset for equal names)
+ *          used to find the KVs matching a query with a literal prefix.
+ *
+ * @param   sorted_size
+ *          number of entries allocated for sorted
+ *
+ * @param   count
+ *          number of KVs in the index
+ *
+ * @param   valid
+ *          set when the index reflects the sram area. On allocation failure
+ *          the index is dropped and the find operations walk the area.
+ *
+ * @param   generation
+ *          incremented whenever KVs are added to or removed from sorted, so
+ *          a FindIter() iteration knows whether the position it holds in
+ *          sorted is still current.
+ */
+typedef struct cfstore_index_t
+{
+    cfstore_index_slot_t* slots;
+    uint32_t slots_mask;
+    uint32_t* sorted;
+    uint32_t sorted_size;
+    uint32_t count;
+    uint32_t generation;
+    bool valid;
+} cfstore_index_t;
+#endif /* CFSTORE_CONFIG_KEY_INDEX_ENABLED */
+
+#ifdef CFSTORE_CONFIG_DELTA_LOG_ENABLED
+/*
+ * @brief   header at the start of the delta log
+ *
+ * @param   magic
+ *          CFSTORE_DELTA_MAGIC_HEADER
+ *
+ * @param   version
+ *          CFSTORE_DELTA_VERSION
+ *
+ * @param   base_size
+ *          size of the flash journal blob the changes in the log apply to
+ *
+ * @param   base_crc
+ *          CRC32 of the flash journal blob the changes in the log apply to
+ */
+typedef struct cfstore_delta_header_t
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t base_size;
+    uint32_t base_crc;
+} cfstore_delta_header_t;
+
+/*
+ * @brief   header of the batch of changes appended to the delta log by one
+ *          flush. The entries follow the header.
+ *
+ * @param   magic
+ *          CFSTORE_DELTA_MAGIC_BATCH
+ *
+ * @param   size
+ *          size of the entries, not including the padding to the next
+ *          program unit boundary
+ *
+ * @param   crc
+ *          CRC32 of the entries
+ */
+typedef struct cfstore_delta_record_t
+{
+    uint32_t magic;
+    uint32_t size;
+    uint32_t crc;
+} cfstore_delta_record_t;
+
+/*
+ * @brief   delta log state
+ *
+ * @param   size
+ *          size of the delta log volume, 0 if the delta log is not in use
+ *
+ * @param   program_unit
+ *          program unit of the delta log volume
+ *
+ * @param   offset
+ *          offset in the delta log volume at which the next batch is appended
+ *
+ * @param   base_size, base_crc
+ *          size and CRC32 of the blob being committed to the flash journal,
+ *          written to the delta log header once the commit has completed
+ *
+ * @param   deleted
+ *          key names of the KVs removed from the sram area since the last
+ *          flush, each preceded by its length
+ *
+ * @param   deleted_len
+ *          length of deleted in bytes
+ *
+ * @param   compact
+ *          set when the next flush has to commit the whole sram area to the
+ *          flash journal and restart the delta log
+ */
+typedef struct cfstore_delta_t
+{
+    uint32_t size;
+    uint32_t program_unit;
+    uint32_t offset;
+    uint32_t base_size;
+    uint32_t base_crc;
+    uint8_t* deleted;
+    uint32_t deleted_len;
+    bool compact;
+} cfstore_delta_t;
+#endif /* CFSTORE_CONFIG_DELTA_LOG_ENABLED */
+
 /*
  * @brief   CS global context that maintains state
  *
@@ -365,6 +544,17 @@ static int32_t cfstore_get_key_name_ex(cfstore_area_hkvt_t *hkvt, char* key_name
  *          flag indicating that the area has been written and therefore is
  *          dirty with respect to the data persisted to flash.
  *
+ * @param   index
+ *          hash and prefix index of the key names in the sram area
+ *
+ * @param   delta
+ *          state of the delta log the changes are flushed to
+ *
+ * @param   map_count
+ *          number of KVs mapped with Map(). While non-zero the sram area
+ *          must not move or be compacted, so Create() cannot grow it and
+ *          the removal of deleted KVs is deferred.
+ *
  * @expected_blob_size  expected_blob_size = area_0_tail - area_0_head + pad
  *          In the case of reading from flash into sram, this will be be size
  *          of the flash blob (rounded to a multiple program_unit if not
@@ -403,6 +593,15 @@ typedef struct cfstore_ctx_t
     FlashJournal_OpCode_t cmd_code;
     uint64_t expected_blob_size;
 #endif /* CFSTORE_CONFIG_BACKEND_FLASH_ENABLED */
+
+#ifdef CFSTORE_CONFIG_KEY_INDEX_ENABLED
+    cfstore_index_t index;
+#endif /* CFSTORE_CONFIG_KEY_INDEX_ENABLED */
+
+#ifdef CFSTORE_CONFIG_DELTA_LOG_ENABLED
+    cfstore_delta_t delta;
+#endif /* CFSTORE_CONFIG_DELTA_LOG_ENABLED */
+    uint32_t map_count;
 } cfstore_ctx_t;
 
 
@@ -440,6 +639,48 @@ typedef struct cfstore_file_t
 
 } cfstore_file_t;
 
+/*
+ * @brief   state of a FindIter() iteration, held in the client buffer.
+ *
+ * The query is parsed on the first call. '*' is the only wildcard so the
+ * query is a literal prefix, literal segments and a literal suffix, which
+ * are compared in place rather than running cfstore_fnmatch() on each KV.
+ *
+ * @param   pos
+ *          with the key index, the position in the sorted array of the
+ *          KV last returned.
+ *
+ * @param   generation
+ *          the index generation pos is valid for.
+ *
+ * @param   mode
+ *          CFSTORE_FIND_ITER_MODE_XXX. 0 in a zeroed buffer, before the
+ *          first call.
+ *
+ * @param   query_len
+ *          length of the query.
+ *
+ * @param   prefix_len
+ *          length of the literal prefix, before the first '*'.
+ *
+ * @param   suffix_start
+ *          start of the literal suffix, after the last '*'.
+ */
+typedef struct cfstore_find_iter_t
+{
+    uint32_t pos;
+    uint32_t generation;
+    uint8_t mode;
+    uint8_t query_len;
+    uint8_t prefix_len;
+    uint8_t suffix_start;
+} cfstore_find_iter_t;
+
+#define CFSTORE_FIND_ITER_MODE_START                0   /* not started */
+#define CFSTORE_FIND_ITER_MODE_EXACT                1   /* query without wildcard, a single KV */
+#define CFSTORE_FIND_ITER_MODE_INDEX                2   /* the KVs with the literal prefix in the sorted index */
+#define CFSTORE_FIND_ITER_MODE_WALK                 3   /* all the KVs, in the order of the area */
+
 /* @brief   structure used to compose table for mapping flash journal error codes to cfstore error codes */
 typedef struct cfstore_flash_journal_error_code_node
 {
@@ -1169,6 +1410,17 @@ static CFSTORE_INLINE void cfstore_hkvt_set_flags_delete(cfstore_area_hkvt_t *hk
     ((cfstore_area_header_t*) hkvt->head)->flags.delete = flag;
 }
 
+static CFSTORE_INLINE bool cfstore_hkvt_get_flags_mapped(cfstore_area_hkvt_t *hkvt)
+{
+    return ((cfstore_area_header_t*) hkvt->head)->flags.mapped;
+}
+
+static CFSTORE_INLINE void cfstore_hkvt_set_flags_mapped(cfstore_area_hkvt_t *hkvt, bool flag)
+{
+    CFSTORE_ASSERT(hkvt != NULL);
+    ((cfstore_area_header_t*) hkvt->head)->flags.mapped = flag;
+}
+
 
 /*
  * struct cfstore_area_hkvt_t helper operations
@@ -1306,11 +1558,381 @@ static int32_t cfstore_get_next_hkvt(cfstore_area_hkvt_t* prev, cfstore_area_hkv
 }
 
 
+/* @brief   clear the mapped flags read back from flash, as no client holds
+ *          a mapping of an area that has just been loaded. */
+static void cfstore_map_clear_flags(cfstore_ctx_t* ctx)
+{
+    cfstore_area_hkvt_t hkvt;
+
+    ctx->map_count = 0;
+    if(cfstore_get_head_hkvt(&hkvt) < ARM_DRIVER_OK){
+        return;
+    }
+    do {
+        cfstore_hkvt_set_flags_mapped(&hkvt, false);
+    } while(cfstore_get_next_hkvt(&hkvt, &hkvt) == ARM_DRIVER_OK);
+}
+
+
+static CFSTORE_INLINE void cfstore_hkvt_dump(cfstore_area_hkvt_t* hkvt, const char* tag);
+
+#ifdef CFSTORE_CONFIG_KEY_INDEX_ENABLED
 /*
- * Flash support functions
+ * Key index support functions
+ *
+ * CFSTORE_INDEX_SLOTS_MIN
+ *  number of hash table slots first allocated. The table doubles when it becomes
+ *  3/4 full.
+ *
+ * CFSTORE_INDEX_SORTED_MIN
+ *  number of sorted offsets first allocated.
  */
+#define CFSTORE_INDEX_SLOTS_MIN                     16
+#define CFSTORE_INDEX_SORTED_MIN                    8
 
-static CFSTORE_INLINE void cfstore_hkvt_dump(cfstore_area_hkvt_t* hkvt, const char* tag);
+/* the index is always allocated from the heap (see cfstore_config.h) */
+#define CFSTORE_INDEX_CALLOC                        calloc
+#define CFSTORE_INDEX_REALLOC                       realloc
+#define CFSTORE_INDEX_FREE                          free
+
+/* @brief   helper function to get the hkvt of the KV at offset in the sram area */
+static CFSTORE_INLINE cfstore_area_hkvt_t cfstore_index_get_hkvt(cfstore_ctx_t* ctx, uint32_t offset)
+{
+    return cfstore_get_hkvt_from_head_ptr(ctx->area_0_head + offset);
+}
+
+/* @brief   FNV-1a hash of a key name */
+static uint32_t cfstore_index_hash(const uint8_t* key, size_t len)
+{
+    uint32_t hash = 2166136261UL;
+
+    while(len--){
+        hash ^= *key++;
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+/* @brief   compare the key name of a KV with the first len characters of name.
+ *
+ * @return  < 0, 0 or > 0 as for memcmp(). When prefix is set, 0 is returned
+ *          if the KV key name starts with name. */
+static int cfstore_index_key_cmp(cfstore_area_hkvt_t* hkvt, const char* name, size_t len, bool prefix)
+{
+    int ret;
+    size_t klen = cfstore_hkvt_get_key_len(hkvt);
+
+    ret = memcmp(hkvt->key, name, klen < len ? klen : len);
+    if(ret != 0){
+        return ret;
+    }
+    if(klen < len){
+        return -1;
+    }
+    if(klen > len && !prefix){
+        return 1;
+    }
+    return 0;
+}
+
+/* @brief   find the position in the sorted array of the first KV ordered at or
+ *          after (name, offset), or of the first KV starting with name when
+ *          offset is 0 and prefix is set */
+static uint32_t cfstore_index_sorted_find(cfstore_ctx_t* ctx, const char* name, size_t len, uint32_t offset, bool prefix)
+{
+    int cmp;
+    uint32_t lo = 0;
+    uint32_t hi = ctx->index.count;
+    uint32_t mid;
+    cfstore_area_hkvt_t hkvt;
+
+    while(lo < hi){
+        mid = lo + (hi - lo) / 2;
+        hkvt = cfstore_index_get_hkvt(ctx, ctx->index.sorted[mid]);
+        cmp = cfstore_index_key_cmp(&hkvt, name, len, prefix);
+        if(cmp < 0 || (cmp == 0 && ctx->index.sorted[mid] < offset)){
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/* @brief   free the index memory. valid sets whether the (empty) index
+ *          is used by subsequent find operations. */
+static void cfstore_index_reset(cfstore_ctx_t* ctx, bool valid)
+{
+    uint32_t generation = ctx->index.generation;
+
+    CFSTORE_INDEX_FREE(ctx->index.slots);
+    CFSTORE_INDEX_FREE(ctx->index.sorted);
+    memset(&ctx->index, 0, sizeof(ctx->index));
+    ctx->index.valid = valid;
+    ctx->index.generation = generation + 1;
+}
+
+/* @brief   place a slot in the hash table, which must have a free slot */
+static void cfstore_index_slot_put(cfstore_index_slot_t* slots, uint32_t mask, uint32_t hash, uint32_t offset)
+{
+    uint32_t i = hash & mask;
+
+    while(slots[i].offset != 0){
+        i = (i + 1) & mask;
+    }
+    slots[i].hash = hash;
+    slots[i].offset = offset + 1;
+}
+
+/* @brief   make room in the index for one more KV */
+static int32_t cfstore_index_reserve(cfstore_ctx_t* ctx)
+{
+    uint32_t i;
+    uint32_t size;
+    uint32_t* sorted;
+    cfstore_index_slot_t* slots;
+    cfstore_index_t* index = &ctx->index;
+
+    if(index->count + 1 > index->sorted_size){
+        size = index->sorted_size ? 2 * index->sorted_size : CFSTORE_INDEX_SORTED_MIN;
+        sorted = (uint32_t*) CFSTORE_INDEX_REALLOC(index->sorted, size * sizeof(uint32_t));
+        if(sorted == NULL){
+            return ARM_CFSTORE_DRIVER_ERROR_OUT_OF_MEMORY;
+        }
+        index->sorted = sorted;
+        index->sorted_size = size;
+    }
+    size = index->slots ? index->slots_mask + 1 : 0;
+    if(4 * (index->count + 1) > 3 * size){
+        size = size ? 2 * size : CFSTORE_INDEX_SLOTS_MIN;
+        slots = (cfstore_index_slot_t*) CFSTORE_INDEX_CALLOC(size, sizeof(cfstore_index_slot_t));
+        if(slots == NULL){
+            return ARM_CFSTORE_DRIVER_ERROR_OUT_OF_MEMORY;
+        }
+        for(i = 0; index->slots && i <= index->slots_mask; i++){
+            if(index->slots[i].offset != 0){
+                cfstore_index_slot_put(slots, size - 1, index->slots[i].hash, index->slots[i].offset - 1);
+            }
+        }
+        CFSTORE_INDEX_FREE(index->slots);
+        index->slots = slots;
+        index->slots_mask = size - 1;
+    }
+    return ARM_DRIVER_OK;
+}
+
+/* @brief   add the KV at offset in the sram area to the index */
+static void cfstore_index_insert(cfstore_ctx_t* ctx, uint32_t offset)
+{
+    uint32_t pos;
+    cfstore_area_hkvt_t hkvt;
+    cfstore_index_t* index = &ctx->index;
+
+    if(!index->valid){
+        return;
+    }
+    if(cfstore_index_reserve(ctx) < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: unable to allocate memory for the key index, falling back to searching the area\n", __func__);
+        cfstore_index_reset(ctx, false);
+        return;
+    }
+    hkvt = cfstore_index_get_hkvt(ctx, offset);
+    cfstore_index_slot_put(index->slots, index->slots_mask, cfstore_index_hash(hkvt.key, cfstore_hkvt_get_key_len(&hkvt)), offset);
+    pos = cfstore_index_sorted_find(ctx, (const char*) hkvt.key, cfstore_hkvt_get_key_len(&hkvt), offset, false);
+    memmove(&index->sorted[pos + 1], &index->sorted[pos], (index->count - pos) * sizeof(uint32_t));
+    index->sorted[pos] = offset;
+    index->count++;
+    index->generation++;
+}
+
+/* @brief   remove the KV at offset in the sram area from the index. The KV
+ *          must still be in the area. */
+static void cfstore_index_remove(cfstore_ctx_t* ctx, uint32_t offset)
+{
+    uint32_t i;
+    uint32_t j;
+    uint32_t k;
+    uint32_t pos;
+    cfstore_area_hkvt_t hkvt;
+    cfstore_index_t* index = &ctx->index;
+
+    if(!index->valid || index->count == 0){
+        return;
+    }
+    hkvt = cfstore_index_get_hkvt(ctx, offset);
+    i = cfstore_index_hash(hkvt.key, cfstore_hkvt_get_key_len(&hkvt)) & index->slots_mask;
+    while(index->slots[i].offset != offset + 1){
+        if(index->slots[i].offset == 0){
+            CFSTORE_ERRLOG("%s:Error: KV not in the key index\n", __func__);
+            cfstore_index_reset(ctx, false);
+            return;
+        }
+        i = (i + 1) & index->slots_mask;
+    }
+    /* close the gap by moving back the following slots which would not be
+     * reached from their home slot with slot i empty */
+    j = i;
+    while(true){
+        j = (j + 1) & index->slots_mask;
+        if(index->slots[j].offset == 0){
+            break;
+        }
+        k = index->slots[j].hash & index->slots_mask;
+        if((i <= j) ? (i < k && k <= j) : (i < k || k <= j)){
+            continue;
+        }
+        index->slots[i] = index->slots[j];
+        i = j;
+    }
+    index->slots[i].offset = 0;
+
+    pos = cfstore_index_sorted_find(ctx, (const char*) hkvt.key, cfstore_hkvt_get_key_len(&hkvt), offset, false);
+    CFSTORE_ASSERT(pos < index->count && index->sorted[pos] == offset);
+    memmove(&index->sorted[pos], &index->sorted[pos + 1], (index->count - pos - 1) * sizeof(uint32_t));
+    index->count--;
+    index->generation++;
+}
+
+/* @brief   update the index after the KVs following the KV at offset have been
+ *          moved by size_diff bytes in the sram area (see cfstore_file_update()) */
+static void cfstore_index_shift(cfstore_ctx_t* ctx, uint32_t offset, int32_t size_diff)
+{
+    uint32_t i;
+    cfstore_index_t* index = &ctx->index;
+
+    if(!index->valid){
+        return;
+    }
+    for(i = 0; i < index->count; i++){
+        if(index->sorted[i] > offset){
+            index->sorted[i] += size_diff;
+        }
+    }
+    for(i = 0; index->slots && i <= index->slots_mask; i++){
+        if(index->slots[i].offset > offset + 1){
+            index->slots[i].offset += size_diff;
+        }
+    }
+}
+
+/* @brief   rebuild the index from the KVs in the sram area e.g. after the area
+ *          has been loaded from flash */
+static void cfstore_index_rebuild(cfstore_ctx_t* ctx)
+{
+    cfstore_area_hkvt_t hkvt;
+
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+    cfstore_index_reset(ctx, true);
+    if(cfstore_get_head_hkvt(&hkvt) < ARM_DRIVER_OK){
+        return;
+    }
+    while(ctx->index.valid && cfstore_hkvt_is_valid(&hkvt, ctx->area_0_tail)){
+        cfstore_index_insert(ctx, (uint32_t) (hkvt.head - ctx->area_0_head));
+        if(cfstore_get_next_hkvt(&hkvt, &hkvt) < ARM_DRIVER_OK){
+            break;
+        }
+    }
+}
+
+/* @brief   find the first KV after prev matching key_name_query using the index.
+ *
+ * The KV returned is the one cfstore_find_ex() would find by walking the area
+ * i.e. the matching KV with the lowest offset after prev. The candidates are
+ * the KVs with the query name for an exact query, and the KVs with key names
+ * starting with the literal prefix (prefix_len characters) of a wildcard query
+ * otherwise.
+ */
+static int32_t cfstore_index_find(cfstore_ctx_t* ctx, const char* key_name_query, size_t prefix_len, cfstore_area_hkvt_t *prev, cfstore_area_hkvt_t *next)
+{
+    int32_t ret;
+    uint32_t i;
+    uint32_t end;
+    uint32_t hash;
+    uint32_t offset;
+    uint32_t from = 0;
+    uint32_t best = CFSTORE_SENTINEL;
+    uint8_t key_len;
+    bool exact = key_name_query[prefix_len] == '\0';
+    /* a query like "com.arm.*" matches every key name with the prefix */
+    bool prefix_only = key_name_query[prefix_len] == '*' && key_name_query[prefix_len + 1] == '\0';
+    char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
+    cfstore_area_hkvt_t hkvt;
+    cfstore_index_t* index = &ctx->index;
+
+    CFSTORE_TP(CFSTORE_TP_FIND, "%s:entered: key_name_query=\"%s\", prefix_len=%d\n", __func__, key_name_query, (int) prefix_len);
+    if(prev != NULL){
+        from = (uint32_t) (prev->head - ctx->area_0_head) + 1;
+    }
+    if(exact){
+        hash = cfstore_index_hash((const uint8_t*) key_name_query, prefix_len);
+        for(i = hash & index->slots_mask; index->slots && index->slots[i].offset != 0; i = (i + 1) & index->slots_mask){
+            offset = index->slots[i].offset - 1;
+            if(index->slots[i].hash != hash || offset < from || offset >= best){
+                continue;
+            }
+            hkvt = cfstore_index_get_hkvt(ctx, offset);
+            if(cfstore_index_key_cmp(&hkvt, key_name_query, prefix_len, false) != 0){
+                continue;
+            }
+            if(cfstore_hkvt_get_flags_delete(&hkvt) || !cfstore_is_kv_client_readable(&hkvt)){
+                continue;
+            }
+            best = offset;
+        }
+    } else {
+        i = cfstore_index_sorted_find(ctx, key_name_query, prefix_len, 0, true);
+        end = i;
+        while(end < index->count){
+            hkvt = cfstore_index_get_hkvt(ctx, index->sorted[end]);
+            if(cfstore_index_key_cmp(&hkvt, key_name_query, prefix_len, true) != 0){
+                break;
+            }
+            end++;
+        }
+        for(; i < end; i++){
+            offset = index->sorted[i];
+            if(offset < from || offset >= best){
+                continue;
+            }
+            hkvt = cfstore_index_get_hkvt(ctx, offset);
+            if(cfstore_hkvt_get_flags_delete(&hkvt) || !cfstore_is_kv_client_readable(&hkvt)){
+                continue;
+            }
+            if(!prefix_only){
+                key_len = CFSTORE_KEY_NAME_MAX_LENGTH+1;
+                cfstore_get_key_name_ex(&hkvt, key_name, &key_len);
+                ret = cfstore_fnmatch(key_name_query, key_name, 0);
+                if(ret == CFSTORE_FNM_NOMATCH){
+                    continue;
+                } else if(ret != 0){
+                    CFSTORE_ERRLOG("%s:Error: cfstore_fnmatch() error (ret=%d).\n", __func__, (int) ret);
+                    return ARM_DRIVER_ERROR;
+                }
+            }
+            best = offset;
+        }
+    }
+    if(best == CFSTORE_SENTINEL){
+        CFSTORE_TP(CFSTORE_TP_FIND, "%s:No more KVs found\n", __func__);
+        memset((void*) next, 0, sizeof(cfstore_area_hkvt_t));
+        return ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND;
+    }
+    *next = cfstore_index_get_hkvt(ctx, best);
+    cfstore_hkvt_dump(next, __func__);
+    return ARM_DRIVER_OK;
+}
+#else
+static CFSTORE_INLINE void cfstore_index_reset(cfstore_ctx_t* ctx, bool valid){ (void) ctx; (void) valid; return; }
+static CFSTORE_INLINE void cfstore_index_insert(cfstore_ctx_t* ctx, uint32_t offset){ (void) ctx; (void) offset; return; }
+static CFSTORE_INLINE void cfstore_index_remove(cfstore_ctx_t* ctx, uint32_t offset){ (void) ctx; (void) offset; return; }
+static CFSTORE_INLINE void cfstore_index_shift(cfstore_ctx_t* ctx, uint32_t offset, int32_t size_diff){ (void) ctx; (void) offset; (void) size_diff; return; }
+static CFSTORE_INLINE void cfstore_index_rebuild(cfstore_ctx_t* ctx){ (void) ctx; return; }
+#endif /* CFSTORE_CONFIG_KEY_INDEX_ENABLED */
+
+
+/*
+ * Flash support functions
+ */
 
 /** @brief  Set the context tail pointer area_0_tail to point to the end of the
  *          last KV in the memory area.
@@ -1459,35 +2081,629 @@ static int32_t cfstore_realloc_ex(ARM_CFSTORE_SIZE size, uint64_t *allocated_siz
             ctx->area_0_head = ptr;
         }
 
-        /* If the area is growing then zero the new space at the end of the area */
-        len_diff = size - (int32_t) ctx->area_0_len;
-        if(len_diff > 0) {
-            memset(ptr + ctx->area_0_len, 0, len_diff);
-        }
-        /* Set area_0_tail to be the memory address after the end of the last KV in the memory area.
-         * This is the only place that area_0_tail should be changed, apart from cfstore_flash_set_tail()
-         * which is only called when attributes are loaded from flash.
-         */
-        ctx->area_0_len = size;
-        ctx->area_0_tail = ptr + total_kv_size;
-        if(allocated_size != NULL) {
-            *allocated_size = size;
-        }
+        /* If the area is growing then zero the new space at the end of the area */
+        len_diff = size - (int32_t) ctx->area_0_len;
+        if(len_diff > 0) {
+            memset(ptr + ctx->area_0_len, 0, len_diff);
+        }
+        /* Set area_0_tail to be the memory address after the end of the last KV in the memory area.
+         * This is the only place that area_0_tail should be changed, apart from cfstore_flash_set_tail()
+         * which is only called when attributes are loaded from flash.
+         */
+        ctx->area_0_len = size;
+        ctx->area_0_tail = ptr + total_kv_size;
+        if(allocated_size != NULL) {
+            *allocated_size = size;
+        }
+    }
+    else
+    {
+        /* size = 0 so delete the memory */
+        CFSTORE_FREE((void*) ctx->area_0_head);
+        ctx->area_0_head = NULL;
+        ctx->area_0_tail = NULL;
+        ctx->area_0_len = 0;
+    }
+    CFSTORE_TP(CFSTORE_TP_MEM, "%s:cfstore_ctx_g.area_0_head=%p, cfstore_ctx_g.area_0_tail=%p\n", __func__, ctx->area_0_head, ctx->area_0_tail);
+    ret = ARM_DRIVER_OK;
+    return ret;
+
+}
+
+
+/*
+ * Delta log support functions
+ *
+ * When the delta log is enabled a flush appends the KVs changed since the
+ * previous flush to the delta log volume rather than committing the whole
+ * sram area to the flash journal. The log layout is:
+ * - a cfstore_delta_header_t recording the size and CRC32 of the journal
+ *   blob the changes apply to, so a log left from an older blob is ignored.
+ * - one batch per flush, which is a cfstore_delta_record_t followed by the
+ *   entries. An entry is a type octet followed by the KV (header, key name
+ *   and value) for a CFSTORE_DELTA_ENTRY_PUT, or by the key name length and
+ *   key name for a CFSTORE_DELTA_ENTRY_DEL.
+ * The header and each batch are padded to a program unit boundary. When a
+ * batch doesn't fit in the log the flush commits the whole area to the flash
+ * journal as before, then the log is erased and restarted (compaction).
+ * When the area is loaded from the flash journal, the batches in the log are
+ * replayed over it up to the first batch which fails the CRC check.
+ */
+#ifdef CFSTORE_CONFIG_DELTA_LOG_ENABLED
+
+/*
+ * CFSTORE_DELTA_BUF_SIZE
+ *  size of the stack buffer used to assemble program units for the delta log
+ */
+#define CFSTORE_DELTA_MAGIC_HEADER                  0x4c444643  /* "CFDL" */
+#define CFSTORE_DELTA_MAGIC_BATCH                   0x42444643  /* "CFDB" */
+#define CFSTORE_DELTA_MAGIC_ERASED                  0xffffffff
+#define CFSTORE_DELTA_VERSION                       1
+#define CFSTORE_DELTA_ENTRY_PUT                     1
+#define CFSTORE_DELTA_ENTRY_DEL                     2
+#define CFSTORE_DELTA_BUF_SIZE                      CFSTORE_FLASH_STACK_BUF_SIZE
+
+/* the deleted key names are always allocated from the heap (see cfstore_config.h) */
+#define CFSTORE_DELTA_REALLOC                       realloc
+#define CFSTORE_DELTA_FREE                          free
+
+/*
+ * @brief   helper structure to write to the delta log through the stack buffer.
+ *
+ * @param   program
+ *          false to only compute the size and CRC32 of the data put
+ *
+ * @param   offset
+ *          offset in the delta log volume at which buf is programmed
+ *
+ * @param   len
+ *          number of octets in buf
+ *
+ * @param   size
+ *          number of octets put
+ *
+ * @param   crc
+ *          CRC32 of the octets put, when program is false
+ *
+ * @param   crc_ctx
+ *          running state of crc
+ *
+ * @param   status
+ *          set to the first error returned by the storage driver
+ */
+typedef struct cfstore_delta_writer_t
+{
+    bool program;
+    uint32_t offset;
+    uint32_t len;
+    uint32_t size;
+    uint32_t crc;
+    FlashJournalCrcContext_t crc_ctx;
+    int32_t status;
+    uint8_t buf[CFSTORE_DELTA_BUF_SIZE];
+} cfstore_delta_writer_t;
+
+/* @brief   round size up to the delta log program unit */
+static CFSTORE_INLINE uint32_t cfstore_delta_align(cfstore_ctx_t* ctx, uint32_t size)
+{
+    return (size + ctx->delta.program_unit - 1) / ctx->delta.program_unit * ctx->delta.program_unit;
+}
+
+/* @brief   compute the CRC32 of a buffer */
+static uint32_t cfstore_delta_crc(const uint8_t* data, uint32_t len)
+{
+    FlashJournalCrcContext_t crc_ctx;
+
+    flashJournalCrcContextReset(&crc_ctx);
+    return flashJournalCrcContextCummulative(&crc_ctx, data, (int) len);
+}
+
+/* @brief   read from the delta log volume, which completes synchronously */
+static int32_t cfstore_delta_read(uint32_t offset, void* data, uint32_t len)
+{
+    int32_t ret = cfstore_delta_mtd.ReadData(offset, data, len);
+
+    if(ret != (int32_t) len){
+        CFSTORE_ERRLOG("%s:Error: ReadData() failed (offset=%d, len=%d, ret=%d)\n", __func__, (int) offset, (int) len, (int) ret);
+        return ret < ARM_DRIVER_OK ? ret : ARM_DRIVER_ERROR;
+    }
+    return ARM_DRIVER_OK;
+}
+
+/* @brief   program the delta log volume, which completes synchronously */
+static int32_t cfstore_delta_program(uint32_t offset, const void* data, uint32_t len)
+{
+    int32_t ret = cfstore_delta_mtd.ProgramData(offset, data, len);
+
+    if(ret != (int32_t) len){
+        CFSTORE_ERRLOG("%s:Error: ProgramData() failed (offset=%d, len=%d, ret=%d)\n", __func__, (int) offset, (int) len, (int) ret);
+        return ret < ARM_DRIVER_OK ? ret : ARM_DRIVER_ERROR;
+    }
+    return ARM_DRIVER_OK;
+}
+
+/* @brief   put data into the delta log writer */
+static void cfstore_delta_put(cfstore_delta_writer_t* w, const void* data, uint32_t len)
+{
+    uint32_t n = 0;
+    const uint8_t* ptr = (const uint8_t*) data;
+
+    w->size += len;
+    if(!w->program){
+        w->crc = flashJournalCrcContextCummulative(&w->crc_ctx, ptr, (int) len);
+        return;
+    }
+    while(len > 0 && w->status >= ARM_DRIVER_OK){
+        n = CFSTORE_DELTA_BUF_SIZE - w->len;
+        n = n < len ? n : len;
+        memcpy(w->buf + w->len, ptr, n);
+        w->len += n;
+        ptr += n;
+        len -= n;
+        if(w->len == CFSTORE_DELTA_BUF_SIZE){
+            w->status = cfstore_delta_program(w->offset, w->buf, w->len);
+            w->offset += w->len;
+            w->len = 0;
+        }
+    }
+}
+
+/* @brief   program the data left in the delta log writer, padded to a program unit boundary */
+static int32_t cfstore_delta_put_done(cfstore_ctx_t* ctx, cfstore_delta_writer_t* w)
+{
+    uint32_t len = 0;
+
+    if(w->status >= ARM_DRIVER_OK && w->len > 0){
+        len = cfstore_delta_align(ctx, w->len);
+        memset(w->buf + w->len, 0, len - w->len);
+        w->status = cfstore_delta_program(w->offset, w->buf, len);
+        w->offset += len;
+        w->len = 0;
+    }
+    return w->status;
+}
+
+/* @brief   find the KV with the key name in the sram area, including KVs
+ *          flagged for deletion and KVs the client cannot read */
+static int32_t cfstore_delta_find(cfstore_ctx_t* ctx, const uint8_t* key, uint8_t key_len, cfstore_area_hkvt_t* hkvt)
+{
+    int32_t ret = cfstore_get_head_hkvt(hkvt);
+
+    while(ret >= ARM_DRIVER_OK && cfstore_hkvt_is_valid(hkvt, ctx->area_0_tail)){
+        if(cfstore_hkvt_get_key_len(hkvt) == key_len && memcmp(hkvt->key, key, key_len) == 0){
+            return ARM_DRIVER_OK;
+        }
+        ret = cfstore_get_next_hkvt(hkvt, hkvt);
+    }
+    return ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND;
+}
+
+/* @brief   free the deleted key names and clear the dirty flags of the KVs
+ *          e.g. once the changes have been flushed. */
+static void cfstore_delta_clean(cfstore_ctx_t* ctx)
+{
+    cfstore_area_hkvt_t hkvt;
+
+    CFSTORE_DELTA_FREE(ctx->delta.deleted);
+    ctx->delta.deleted = NULL;
+    ctx->delta.deleted_len = 0;
+    if(cfstore_get_head_hkvt(&hkvt) < ARM_DRIVER_OK){
+        return;
+    }
+    while(cfstore_hkvt_is_valid(&hkvt, ctx->area_0_tail)){
+        ((cfstore_area_header_t*) hkvt.head)->flags.dirty = false;
+        if(cfstore_get_next_hkvt(&hkvt, &hkvt) < ARM_DRIVER_OK){
+            break;
+        }
+    }
+}
+
+/* @brief   put the entries for the changes since the last flush into the writer.
+ *          The removed KVs go first so a KV deleted and created again is
+ *          replayed in order. */
+static void cfstore_delta_put_entries(cfstore_ctx_t* ctx, cfstore_delta_writer_t* w)
+{
+    uint8_t type = 0;
+    uint32_t pos = 0;
+    cfstore_area_hkvt_t hkvt;
+    cfstore_area_header_t hdr;
+
+    type = CFSTORE_DELTA_ENTRY_DEL;
+    while(pos < ctx->delta.deleted_len){
+        cfstore_delta_put(w, &type, sizeof(type));
+        cfstore_delta_put(w, &ctx->delta.deleted[pos], ctx->delta.deleted[pos] + 1);
+        pos += ctx->delta.deleted[pos] + 1;
+    }
+    if(cfstore_get_head_hkvt(&hkvt) < ARM_DRIVER_OK){
+        return;
+    }
+    while(cfstore_hkvt_is_valid(&hkvt, ctx->area_0_tail)){
+        memcpy(&hdr, hkvt.head, sizeof(hdr));
+        if(hdr.flags.dirty){
+            if(hdr.flags.delete){
+                type = CFSTORE_DELTA_ENTRY_DEL;
+                cfstore_delta_put(w, &type, sizeof(type));
+                cfstore_delta_put(w, &hdr.klength, sizeof(hdr.klength));
+                cfstore_delta_put(w, hkvt.key, hdr.klength);
+            } else {
+                /* the handles and flags are not persisted */
+                type = CFSTORE_DELTA_ENTRY_PUT;
+                hdr.refcount = 0;
+                memset(&hdr.flags, 0, sizeof(hdr.flags));
+                cfstore_delta_put(w, &type, sizeof(type));
+                cfstore_delta_put(w, &hdr, sizeof(hdr));
+                cfstore_delta_put(w, hkvt.key, (uint32_t) (hkvt.tail - hkvt.key));
+            }
+        }
+        if(cfstore_get_next_hkvt(&hkvt, &hkvt) < ARM_DRIVER_OK){
+            break;
+        }
+    }
+}
+
+/* @brief   replay a CFSTORE_DELTA_ENTRY_PUT at offset in the delta log
+ *          volume, replacing the KV with the same key name */
+static int32_t cfstore_delta_replay_put(cfstore_ctx_t* ctx, uint32_t offset, uint32_t end, uint32_t* size)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    uint8_t key[CFSTORE_KEY_NAME_MAX_LENGTH];
+    uint32_t kv_size = 0;
+    ARM_CFSTORE_SIZE area_size = 0;
+    cfstore_area_header_t hdr;
+    cfstore_area_hkvt_t hkvt;
+
+    if(offset + sizeof(hdr) > end){
+        return ARM_DRIVER_ERROR;
+    }
+    ret = cfstore_delta_read(offset, &hdr, sizeof(hdr));
+    if(ret < ARM_DRIVER_OK){
+        return ret;
+    }
+    kv_size = sizeof(hdr) + hdr.klength + hdr.vlength;
+    if(hdr.klength == 0 || hdr.klength > CFSTORE_KEY_NAME_MAX_LENGTH || hdr.vlength > end - offset || offset + kv_size > end){
+        CFSTORE_ERRLOG("%s:Error: invalid KV in delta log\n", __func__);
+        return ARM_DRIVER_ERROR;
+    }
+    ret = cfstore_delta_read(offset + sizeof(hdr), key, hdr.klength);
+    if(ret < ARM_DRIVER_OK){
+        return ret;
+    }
+    if(cfstore_delta_find(ctx, key, hdr.klength, &hkvt) == ARM_DRIVER_OK){
+        ret = cfstore_delete_ex(&hkvt);
+        if(ret < ARM_DRIVER_OK){
+            return ret;
+        }
+    }
+    area_size = cfstore_ctx_get_kv_total_len();
+    ret = cfstore_realloc_ex(area_size + kv_size, NULL);
+    if(ret < ARM_DRIVER_OK){
+        return ret;
+    }
+    ret = cfstore_delta_read(offset, ctx->area_0_head + area_size, kv_size);
+    if(ret < ARM_DRIVER_OK){
+        return ret;
+    }
+    cfstore_index_insert(ctx, (uint32_t) area_size);
+    *size = kv_size;
+    return ARM_DRIVER_OK;
+}
+
+/* @brief   replay a CFSTORE_DELTA_ENTRY_DEL at offset in the delta log
+ *          volume, removing the KV with the key name */
+static int32_t cfstore_delta_replay_del(cfstore_ctx_t* ctx, uint32_t offset, uint32_t end, uint32_t* size)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    uint8_t key_len = 0;
+    uint8_t key[CFSTORE_KEY_NAME_MAX_LENGTH];
+    cfstore_area_hkvt_t hkvt;
+
+    if(offset + sizeof(key_len) > end){
+        return ARM_DRIVER_ERROR;
+    }
+    ret = cfstore_delta_read(offset, &key_len, sizeof(key_len));
+    if(ret < ARM_DRIVER_OK){
+        return ret;
+    }
+    if(key_len == 0 || key_len > CFSTORE_KEY_NAME_MAX_LENGTH || offset + sizeof(key_len) + key_len > end){
+        CFSTORE_ERRLOG("%s:Error: invalid key name in delta log\n", __func__);
+        return ARM_DRIVER_ERROR;
+    }
+    ret = cfstore_delta_read(offset + sizeof(key_len), key, key_len);
+    if(ret < ARM_DRIVER_OK){
+        return ret;
+    }
+    if(cfstore_delta_find(ctx, key, key_len, &hkvt) == ARM_DRIVER_OK){
+        ret = cfstore_delete_ex(&hkvt);
+        if(ret < ARM_DRIVER_OK){
+            return ret;
+        }
+    }
+    *size = sizeof(key_len) + key_len;
+    return ARM_DRIVER_OK;
+}
+
+/* @brief   check the CRC32 of the batch at offset then replay its entries */
+static int32_t cfstore_delta_replay_batch(cfstore_ctx_t* ctx, uint32_t offset, cfstore_delta_record_t* rec)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    uint8_t type = 0;
+    uint8_t buf[CFSTORE_DELTA_BUF_SIZE];
+    uint32_t crc = 0;
+    uint32_t len = 0;
+    uint32_t pos = offset + sizeof(cfstore_delta_record_t);
+    uint32_t end = pos + rec->size;
+    FlashJournalCrcContext_t crc_ctx;
+
+    flashJournalCrcContextReset(&crc_ctx);
+    crc = flashJournalCrcContextCummulative(&crc_ctx, buf, 0);
+    while(pos < end){
+        len = end - pos < sizeof(buf) ? end - pos : sizeof(buf);
+        ret = cfstore_delta_read(pos, buf, len);
+        if(ret < ARM_DRIVER_OK){
+            return ret;
+        }
+        crc = flashJournalCrcContextCummulative(&crc_ctx, buf, (int) len);
+        pos += len;
+    }
+    if(crc != rec->crc){
+        CFSTORE_ERRLOG("%s:Error: delta log batch CRC check failed (offset=%d)\n", __func__, (int) offset);
+        return ARM_DRIVER_ERROR;
+    }
+    pos = offset + sizeof(cfstore_delta_record_t);
+    while(pos < end){
+        ret = cfstore_delta_read(pos, &type, sizeof(type));
+        if(ret < ARM_DRIVER_OK){
+            return ret;
+        }
+        pos += sizeof(type);
+        if(type == CFSTORE_DELTA_ENTRY_PUT){
+            ret = cfstore_delta_replay_put(ctx, pos, end, &len);
+        } else if(type == CFSTORE_DELTA_ENTRY_DEL){
+            ret = cfstore_delta_replay_del(ctx, pos, end, &len);
+        } else {
+            CFSTORE_ERRLOG("%s:Error: unknown delta log entry type (%d)\n", __func__, (int) type);
+            ret = ARM_DRIVER_ERROR;
+        }
+        if(ret < ARM_DRIVER_OK){
+            return ret;
+        }
+        pos += len;
+    }
+    return ARM_DRIVER_OK;
+}
+
+/* @brief   free the delta log state */
+static void cfstore_delta_reset(cfstore_ctx_t* ctx)
+{
+    CFSTORE_DELTA_FREE(ctx->delta.deleted);
+    memset(&ctx->delta, 0, sizeof(ctx->delta));
+}
+
+/* @brief   set up the delta log volume. The delta log is not used (and flushes
+ *          commit the whole area) if the volume cannot be set up. */
+static void cfstore_delta_init(cfstore_ctx_t* ctx)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_STORAGE_INFO info;
+    ARM_STORAGE_BLOCK block;
+
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+    cfstore_delta_reset(ctx);
+    /* the delta log reads and writes complete synchronously */
+    if(cfstore_caps_g.asynchronous_ops){
+        CFSTORE_DBGLOG("%s:Error: delta log is not supported with an asynchronous storage driver\n", __func__);
+        return;
+    }
+    ret = cfstore_svm_delta_init(&cfstore_delta_mtd);
+    if(ret < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: unable to initialize delta log volume (ret=%d)\n", __func__, (int) ret);
+        return;
+    }
+    memset(&info, 0, sizeof(info));
+    memset(&block, 0, sizeof(block));
+    if(cfstore_delta_mtd.GetInfo(&info) < ARM_DRIVER_OK || cfstore_delta_mtd.GetNextBlock(NULL, &block) < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: unable to get delta log volume info\n", __func__);
+        return;
+    }
+    if(info.program_unit == 0 || CFSTORE_DELTA_BUF_SIZE % info.program_unit != 0
+        || block.attributes.erase_unit == 0 || info.total_storage % block.attributes.erase_unit != 0){
+        CFSTORE_ERRLOG("%s:Error: delta log volume geometry not supported (program_unit=%d, size=%d)\n", __func__, (int) info.program_unit, (int) info.total_storage);
+        return;
+    }
+    ctx->delta.size = (uint32_t) info.total_storage;
+    ctx->delta.program_unit = info.program_unit;
+    /* until a log for the blob read from the flash journal is found */
+    ctx->delta.compact = true;
+}
+
+/* @brief   replay the delta log over the area loaded from the flash journal */
+static void cfstore_delta_load(cfstore_ctx_t* ctx)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    uint32_t offset = 0;
+    uint32_t base_size = 0;
+    cfstore_delta_header_t hdr;
+    cfstore_delta_record_t rec;
+
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+    if(ctx->delta.size == 0){
+        return;
+    }
+    ret = cfstore_delta_read(0, &hdr, sizeof(hdr));
+    if(ret < ARM_DRIVER_OK){
+        return;
+    }
+    base_size = (uint32_t) ctx->info.sizeofJournaledBlob;
+    if(hdr.magic != CFSTORE_DELTA_MAGIC_HEADER || hdr.version != CFSTORE_DELTA_VERSION
+        || hdr.base_size != base_size || hdr.base_crc != cfstore_delta_crc(ctx->area_0_head, base_size)){
+        CFSTORE_TP(CFSTORE_TP_INIT, "%s:debug: no delta log for the flash journal blob\n", __func__);
+        return;
+    }
+    ctx->delta.compact = false;
+    offset = cfstore_delta_align(ctx, sizeof(hdr));
+    while(offset + sizeof(rec) <= ctx->delta.size){
+        ret = cfstore_delta_read(offset, &rec, sizeof(rec));
+        if(ret < ARM_DRIVER_OK){
+            ctx->delta.compact = true;
+            break;
+        }
+        if(rec.magic == CFSTORE_DELTA_MAGIC_ERASED){
+            /* end of the log */
+            break;
+        }
+        if(rec.magic != CFSTORE_DELTA_MAGIC_BATCH || rec.size > ctx->delta.size - offset - sizeof(rec)){
+            CFSTORE_ERRLOG("%s:Error: invalid delta log batch (offset=%d)\n", __func__, (int) offset);
+            ctx->delta.compact = true;
+            break;
+        }
+        ret = cfstore_delta_replay_batch(ctx, offset, &rec);
+        if(ret < ARM_DRIVER_OK){
+            /* e.g. the batch programming was interrupted. the changes after
+             * the previous batch are lost, and the next flush restarts the log */
+            ctx->delta.compact = true;
+            break;
+        }
+        offset += cfstore_delta_align(ctx, sizeof(rec) + rec.size);
+    }
+    ctx->delta.offset = offset;
+    cfstore_delta_clean(ctx);
+}
+
+/* @brief   append the changes since the last flush to the delta log.
+ *
+ * @return  true if the changes have been flushed, false when the whole area
+ *          has to be committed to the flash journal instead.
+ */
+static bool cfstore_delta_flush(cfstore_ctx_t* ctx)
+{
+    uint32_t batch_size = 0;
+    cfstore_delta_record_t rec;
+    cfstore_delta_writer_t w;
+
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+    if(ctx->delta.size == 0 || ctx->delta.compact){
+        return false;
+    }
+    if(ctx->area_dirty_flag == false){
+        return true;
+    }
+    /* first pass to size the batch and compute its CRC */
+    memset(&w, 0, sizeof(w));
+    flashJournalCrcContextReset(&w.crc_ctx);
+    w.crc = flashJournalCrcContextCummulative(&w.crc_ctx, w.buf, 0);
+    cfstore_delta_put_entries(ctx, &w);
+    batch_size = cfstore_delta_align(ctx, sizeof(rec) + w.size);
+    if(batch_size > ctx->delta.size - ctx->delta.offset){
+        CFSTORE_TP(CFSTORE_TP_FLUSH, "%s:debug: delta log full, committing the area\n", __func__);
+        ctx->delta.compact = true;
+        return false;
+    }
+    rec.magic = CFSTORE_DELTA_MAGIC_BATCH;
+    rec.size = w.size;
+    rec.crc = w.crc;
+
+    memset(&w, 0, sizeof(w));
+    w.program = true;
+    w.offset = ctx->delta.offset;
+    cfstore_delta_put(&w, &rec, sizeof(rec));
+    cfstore_delta_put_entries(ctx, &w);
+    if(cfstore_delta_put_done(ctx, &w) < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: failed to append to the delta log, committing the area\n", __func__);
+        ctx->delta.compact = true;
+        return false;
+    }
+    CFSTORE_TP(CFSTORE_TP_FLUSH, "%s:appended %d octets to the delta log at offset %d\n", __func__, (int) batch_size, (int) ctx->delta.offset);
+    ctx->delta.offset += batch_size;
+    cfstore_delta_clean(ctx);
+    return true;
+}
+
+/* @brief   prepare the area for committing to the flash journal, recording
+ *          the size and CRC32 of the blob for the new delta log header. */
+static void cfstore_delta_compact_begin(cfstore_ctx_t* ctx)
+{
+    if(ctx->delta.size == 0){
+        return;
+    }
+    /* changes made from here are flushed to the new log */
+    ctx->delta.compact = true;
+    cfstore_delta_clean(ctx);
+    ctx->delta.base_size = (uint32_t) ctx->expected_blob_size;
+    ctx->delta.base_crc = cfstore_delta_crc(ctx->area_0_head, ctx->delta.base_size);
+}
+
+/* @brief   restart the delta log once the area has been committed to the flash journal */
+static void cfstore_delta_compact_end(cfstore_ctx_t* ctx)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    cfstore_delta_header_t hdr;
+    cfstore_delta_writer_t w;
+
+    if(ctx->delta.size == 0){
+        return;
     }
-    else
-    {
-        /* size = 0 so delete the memory */
-        CFSTORE_FREE((void*) ctx->area_0_head);
-        ctx->area_0_head = NULL;
-        ctx->area_0_tail = NULL;
-        ctx->area_0_len = 0;
+    ret = cfstore_delta_mtd.Erase(0, ctx->delta.size);
+    if(ret < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: failed to erase the delta log (ret=%d)\n", __func__, (int) ret);
+        return;
     }
-    CFSTORE_TP(CFSTORE_TP_MEM, "%s:cfstore_ctx_g.area_0_head=%p, cfstore_ctx_g.area_0_tail=%p\n", __func__, ctx->area_0_head, ctx->area_0_tail);
-    ret = ARM_DRIVER_OK;
-    return ret;
+    hdr.magic = CFSTORE_DELTA_MAGIC_HEADER;
+    hdr.version = CFSTORE_DELTA_VERSION;
+    hdr.base_size = ctx->delta.base_size;
+    hdr.base_crc = ctx->delta.base_crc;
+    memset(&w, 0, sizeof(w));
+    w.program = true;
+    cfstore_delta_put(&w, &hdr, sizeof(hdr));
+    if(cfstore_delta_put_done(ctx, &w) < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: failed to write the delta log header\n", __func__);
+        return;
+    }
+    ctx->delta.offset = w.offset;
+    ctx->delta.compact = false;
+}
+
+/* @brief   mark the KV as changed since the last flush */
+static CFSTORE_INLINE void cfstore_delta_set_dirty(cfstore_area_hkvt_t* hkvt)
+{
+    ((cfstore_area_header_t*) hkvt->head)->flags.dirty = true;
+}
+
+/* @brief   record the key name of a KV being removed from the area, so the
+ *          next flush deletes it from the delta log. */
+static void cfstore_delta_note_delete(cfstore_ctx_t* ctx, cfstore_area_hkvt_t* hkvt)
+{
+    uint8_t* ptr = NULL;
+    uint8_t key_len = cfstore_hkvt_get_key_len(hkvt);
 
+    if(ctx->delta.size == 0 || ctx->delta.compact){
+        /* the next flush commits the whole area */
+        return;
+    }
+    ptr = (uint8_t*) CFSTORE_DELTA_REALLOC(ctx->delta.deleted, ctx->delta.deleted_len + key_len + 1);
+    if(ptr == NULL){
+        CFSTORE_ERRLOG("%s:Error: unable to record deleted KV, the next flush commits the whole area\n", __func__);
+        ctx->delta.compact = true;
+        return;
+    }
+    ptr[ctx->delta.deleted_len] = key_len;
+    memcpy(ptr + ctx->delta.deleted_len + 1, hkvt->key, key_len);
+    ctx->delta.deleted = ptr;
+    ctx->delta.deleted_len += key_len + 1;
 }
 
+#else
+
+static CFSTORE_INLINE void cfstore_delta_reset(cfstore_ctx_t* ctx){ (void) ctx; return; }
+static CFSTORE_INLINE void cfstore_delta_init(cfstore_ctx_t* ctx){ (void) ctx; return; }
+static CFSTORE_INLINE void cfstore_delta_load(cfstore_ctx_t* ctx){ (void) ctx; return; }
+static CFSTORE_INLINE bool cfstore_delta_flush(cfstore_ctx_t* ctx){ (void) ctx; return false; }
+static CFSTORE_INLINE void cfstore_delta_compact_begin(cfstore_ctx_t* ctx){ (void) ctx; return; }
+static CFSTORE_INLINE void cfstore_delta_compact_end(cfstore_ctx_t* ctx){ (void) ctx; return; }
+static CFSTORE_INLINE void cfstore_delta_set_dirty(cfstore_area_hkvt_t* hkvt){ (void) hkvt; return; }
+static CFSTORE_INLINE void cfstore_delta_note_delete(cfstore_ctx_t* ctx, cfstore_area_hkvt_t* hkvt){ (void) ctx; (void) hkvt; return; }
+
+#endif /* CFSTORE_CONFIG_DELTA_LOG_ENABLED */
+
 
 #ifdef CFSTORE_CONFIG_BACKEND_FLASH_ENABLED
 
@@ -1620,8 +2836,9 @@ static int32_t cfstore_fsm_init_on_entry(void* context)
         cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_formatting, ctx);
         return ARM_DRIVER_OK;
     }
+    cfstore_delta_init(ctx);
 
-    ret = FlashJournal_initialize(&ctx->jrnl, (ARM_DRIVER_STORAGE *) &cfstore_journal_mtd, &FLASH_JOURNAL_STRATEGY_SEQUENTIAL, cfstore_flash_journal_callback);
+    ret = FlashJournal_initialize(&ctx->jrnl, (ARM_DRIVER_STORAGE *) &cfstore_journal_mtd, &CFSTORE_FLASH_JOURNAL_STRATEGY, cfstore_flash_journal_callback);
     CFSTORE_TP(CFSTORE_TP_FSM, "%s:FlashJournal_initialize ret=%d\n", __func__, (int) ret);
     if(ret < ARM_DRIVER_OK){
         if(ret == JOURNAL_STATUS_NOT_FORMATTED) {
@@ -1771,6 +2988,9 @@ static int32_t cfstore_fsm_reading(void* context)
                     memset(&ctx->info, 0, sizeof(ctx->info));
                     goto out;
                 }
+                cfstore_index_rebuild(ctx);
+                cfstore_map_clear_flags(ctx);
+                cfstore_delta_load(ctx);
                 ret = cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_ready, ctx);
                 if(ret < ARM_DRIVER_OK){
                     CFSTORE_ERRLOG("%s:Error: cfstore_fsm_state_set() failed (ret=%d)\n", __func__, (int) ret);
@@ -1793,6 +3013,7 @@ static int32_t cfstore_fsm_reading(void* context)
         else
         {
             CFSTORE_TP(CFSTORE_TP_FSM, "%s:debug:ctx->status <= (int32_t) CFSTORE_FLASH_AREA_SIZE_MIN:\n", __func__);
+            cfstore_delta_load(ctx);
             ret = cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_ready, ctx);
             if(ret < ARM_DRIVER_OK){
                 /* move to ready state. cfstore client is expected to Uninitialize() before further calls */
@@ -1851,6 +3072,7 @@ int32_t cfstore_fsm_log_on_entry(void* context)
     /* log the changes to flash even when the area has shrunk to 0, as its necessary to erase the flash */
     if(ctx->area_dirty_flag == true)
     {
+        cfstore_delta_compact_begin(ctx);
         if(ctx->expected_blob_size > 0){
             CFSTORE_TP(CFSTORE_TP_FLUSH, "%s:logging: ctx->area_0_head=%p, ctx->expected_blob_size-%d\n", __func__, ctx->area_0_head, (int) ctx->expected_blob_size);
             ret = FlashJournal_log(&ctx->jrnl, (const void*) ctx->area_0_head, ctx->expected_blob_size);
@@ -1990,6 +3212,10 @@ static int32_t cfstore_fsm_committing(void* context)
     }
     else
     {   /* ctx->status > 0. for flash-journal-strategy-sequential version >0.4.0, commit() return no longer reports size of commit block */
+        if(ctx->area_dirty_flag == true){
+            /* the flash journal now holds the whole area so restart the delta log */
+            cfstore_delta_compact_end(ctx);
+        }
         ctx->status = cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_ready, ctx);
     }
     return ctx->status;
@@ -2015,7 +3241,16 @@ static int32_t cfstore_fsm_commit_on_exit(void* context)
 static int32_t cfstore_fsm_ready_on_commit_req(void* context)
 {
     cfstore_ctx_t* ctx = (cfstore_ctx_t*) context;
+    cfstore_client_notify_data_t notify_data;
+
     CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+    if(cfstore_delta_flush(ctx)){
+        /* the changes have been appended to the delta log so there is nothing to commit */
+        ctx->area_dirty_flag = false;
+        cfstore_client_notify_data_init(&notify_data, CFSTORE_OPCODE_FLUSH, ARM_DRIVER_OK, NULL);
+        cfstore_ctx_client_notify(ctx, &notify_data);
+        return ARM_DRIVER_OK;
+    }
     return cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_logging, ctx);
 }
 
@@ -2033,8 +3268,8 @@ static int32_t cfstore_fsm_format_on_entry(void* context)
 
     CFSTORE_FENTRYLOG("%s:entered\n", __func__);
 
-    ret = flashJournalStrategySequential_format((ARM_DRIVER_STORAGE *) &cfstore_journal_mtd, CFSTORE_FLASH_NUMSLOTS, cfstore_flash_journal_callback);
-    CFSTORE_TP(CFSTORE_TP_FSM, "%s:flashJournalStrategySequential_format ret=%d\n", __func__, (int) ret);
+    ret = cfstore_flash_journal_format((ARM_DRIVER_STORAGE *) &cfstore_journal_mtd, CFSTORE_FLASH_NUMSLOTS, cfstore_flash_journal_callback);
+    CFSTORE_TP(CFSTORE_TP_FSM, "%s:cfstore_flash_journal_format ret=%d\n", __func__, (int) ret);
     if(ret < ARM_DRIVER_OK){
         CFSTORE_ERRLOG("%s:Error: failed to format flash (ret=%d)\n", __func__, (int) ret);
         cfstore_fsm_state_set(&ctx->fsm, cfstore_fsm_state_stopped, ctx);
@@ -2358,11 +3593,15 @@ static int32_t cfstore_delete_ex(cfstore_area_hkvt_t* hkvt)
     ARM_CFSTORE_SIZE kv_size = 0;
     ARM_CFSTORE_SIZE kv_total_size = 0;
     ARM_CFSTORE_SIZE realloc_size = 0;      /* size aligned to flash program_unit size */
+    uint32_t offset = 0;
     cfstore_ctx_t* ctx = cfstore_ctx_get();
 
     CFSTORE_FENTRYLOG("%s:entered:(ctx->area_0_head=%p, ctx->area_0_tail=%p)\n", __func__, ctx->area_0_head, ctx->area_0_tail);
     kv_size  = cfstore_hkvt_get_size(hkvt);
     kv_total_size = cfstore_ctx_get_kv_total_len();
+    offset = (uint32_t) (hkvt->head - ctx->area_0_head);
+    cfstore_index_remove(ctx, offset);
+    cfstore_delta_note_delete(ctx, hkvt);
 
     /* Note the following:
      *  1. memmove() above shifts the position of the KVs falling after the deleted KV to be at
@@ -2376,6 +3615,7 @@ static int32_t cfstore_delete_ex(cfstore_area_hkvt_t* hkvt)
     memmove(hkvt->head, hkvt->tail, ctx->area_0_tail - hkvt->tail);
     /* zero the deleted KV memory */
     memset(ctx->area_0_tail-kv_size, 0, kv_size);
+    cfstore_index_shift(ctx, offset, -1 * kv_size);
 
     /* The KV area has shrunk so a negative size_diff should be indicated to cfstore_file_update(). */
     ret = cfstore_file_update(hkvt->head, -1 * kv_size);
@@ -2396,6 +3636,32 @@ out0:
 }
 
 
+/* @brief   remove the deleted KVs left in the area while it was pinned by
+ *          Map(), once the last mapping has gone. */
+static int32_t cfstore_map_delete_deferred(cfstore_ctx_t* ctx)
+{
+    int32_t ret = ARM_DRIVER_OK;
+    uint32_t offset = 0;
+    cfstore_area_hkvt_t hkvt;
+
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+    while(ctx->area_0_head + offset < ctx->area_0_tail){
+        hkvt = cfstore_get_hkvt_from_head_ptr(ctx->area_0_head + offset);
+        if(cfstore_hkvt_get_flags_delete(&hkvt) && ((cfstore_area_header_t*) hkvt.head)->refcount == 0){
+            /* the following KVs move down to this offset */
+            ret = cfstore_delete_ex(&hkvt);
+            if(ret < ARM_DRIVER_OK){
+                CFSTORE_ERRLOG("%s:Error: failed to delete KV (ret=%d)\n", __func__, (int) ret);
+                break;
+            }
+            continue;
+        }
+        offset += (uint32_t) (hkvt.tail - hkvt.head);
+    }
+    return ret;
+}
+
+
 /*
  * File operations
  */
@@ -2423,7 +3689,7 @@ static cfstore_file_t* cfstore_file_create(cfstore_area_hkvt_t* hkvt, ARM_CFSTOR
         file->flags.read = flags.read;
         file->flags.write = flags.write;
         if(list_head != NULL){
-            cfstore_listAdd(list_head, &file->node, list_head);
+            cfstore_listAdd(list_head, &file->node, list_head->next);
         }
     }
     return file;
@@ -2432,9 +3698,11 @@ static cfstore_file_t* cfstore_file_create(cfstore_area_hkvt_t* hkvt, ARM_CFSTOR
 /* @brief   required to be in critical section when called. */
 static int32_t cfstore_file_destroy(cfstore_file_t* file)
 {
+    bool b_unpinned = false;
     int32_t ret = ARM_DRIVER_ERROR;
     cfstore_area_hkvt_t hkvt;
     uint8_t refcount = 0;
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
 
     CFSTORE_FENTRYLOG("%s:entered\n", __func__);
     if(file) {
@@ -2444,15 +3712,24 @@ static int32_t cfstore_file_destroy(cfstore_file_t* file)
         cfstore_hkvt_refcount_dec(&hkvt, &refcount);
         CFSTORE_TP(CFSTORE_TP_FILE, "%s:refcount =%d file->head=%p\n", __func__, (int)refcount, file->head);
         if(refcount == 0){
-            /* check for delete */
+            /* closing the last handle ends the mapping of the KV */
+            if(cfstore_hkvt_get_flags_mapped(&hkvt)){
+                cfstore_hkvt_set_flags_mapped(&hkvt, false);
+                ctx->map_count--;
+                b_unpinned = ctx->map_count == 0;
+            }
+            /* check for delete. The area cannot be compacted while KVs are mapped */
             CFSTORE_TP(CFSTORE_TP_FILE, "%s:checking delete flag\n", __func__);
-            if(cfstore_hkvt_get_flags_delete(&hkvt)){
+            if(cfstore_hkvt_get_flags_delete(&hkvt) && ctx->map_count == 0){
                 ret = cfstore_delete_ex(&hkvt);
             }
-            /* reset client buffer to empty ready for reuse */
-            /* delete the file even if not deleting the KV*/
-            cfstore_listDel(&file->node);
-            memset(file, 0, sizeof(cfstore_file_t));
+        }
+        /* reset client buffer to empty ready for reuse */
+        /* delete the file even if not deleting the KV, or other handles to the KV remain open */
+        cfstore_listDel(&file->node);
+        memset(file, 0, sizeof(cfstore_file_t));
+        if(b_unpinned && ret >= ARM_DRIVER_OK){
+            ret = cfstore_map_delete_deferred(ctx);
         }
     }
     return ret;
@@ -3096,6 +4373,7 @@ static int32_t cfstore_delete(ARM_CFSTORE_HANDLE hkey)
     /* set the delete flag so the delete occurs when the file is closed
      * no further handles will be returned to this key */
     cfstore_hkvt_set_flags_delete(&hkvt, true);
+    cfstore_delta_set_dirty(&hkvt);
 
     /* set the dirty flag so the changes are persisted to backing store when flushed */
     ctx->area_dirty_flag = true;
@@ -3126,10 +4404,20 @@ static int32_t cfstore_find_ex(const char* key_name_query, cfstore_area_hkvt_t *
 {
     int32_t ret = ARM_DRIVER_ERROR;
     uint8_t next_key_len;
+#ifdef CFSTORE_CONFIG_KEY_INDEX_ENABLED
+    size_t prefix_len;
+#endif /* CFSTORE_CONFIG_KEY_INDEX_ENABLED */
     char key_name[CFSTORE_KEY_NAME_MAX_LENGTH+1];
     cfstore_ctx_t* ctx = cfstore_ctx_get();
 
     CFSTORE_TP((CFSTORE_TP_FIND|CFSTORE_TP_FENTRY), "%s:entered: key_name_query=\"%s\", prev=%p, next=%p\n", __func__, key_name_query, prev, next);
+#ifdef CFSTORE_CONFIG_KEY_INDEX_ENABLED
+    /* queries starting with a wildcard have no prefix to narrow the search so walk the area */
+    prefix_len = strcspn(key_name_query, "*");
+    if(ctx->index.valid && prefix_len > 0){
+        return cfstore_index_find(ctx, key_name_query, prefix_len, prev, next);
+    }
+#endif /* CFSTORE_CONFIG_KEY_INDEX_ENABLED */
     if(prev == NULL){
         ret = cfstore_get_head_hkvt(next);
         /* CFSTORE_TP(CFSTORE_TP_FIND, "%s:next->head=%p, next->key=%p, next->value=%p, next->tail=%p, \n", __func__, next->head, next->key, next->value, next->tail); */
@@ -3324,6 +4612,243 @@ out1:
 }
 
 
+/* @brief   parse the query of a FindIter() iteration */
+static void cfstore_find_iter_compile(cfstore_find_iter_t* iter, const char* key_name_query)
+{
+    const char* last = strrchr(key_name_query, '*');
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+
+    memset(iter, 0, sizeof(cfstore_find_iter_t));
+    iter->query_len = (uint8_t) strlen(key_name_query);
+    iter->prefix_len = (uint8_t) strcspn(key_name_query, "*");
+    iter->suffix_start = last ? (uint8_t) (last - key_name_query + 1) : iter->query_len;
+    if(last == NULL){
+        iter->mode = CFSTORE_FIND_ITER_MODE_EXACT;
+        return;
+    }
+    iter->mode = CFSTORE_FIND_ITER_MODE_WALK;
+#ifdef CFSTORE_CONFIG_KEY_INDEX_ENABLED
+    /* queries starting with a wildcard have no prefix to narrow the search so walk the area */
+    if(ctx->index.valid && iter->prefix_len > 0){
+        iter->mode = CFSTORE_FIND_ITER_MODE_INDEX;
+        iter->generation = ctx->index.generation;
+    }
+#else
+    (void) ctx;
+#endif /* CFSTORE_CONFIG_KEY_INDEX_ENABLED */
+}
+
+/* @brief   check the key name of a KV against the parsed wildcard query.
+ *
+ * The prefix and suffix are compared in place, then the segments between
+ * the wildcards are searched for in order, each at its leftmost position,
+ * which finds a match whenever there is one for '*' wildcards. */
+static bool cfstore_find_iter_match(const cfstore_find_iter_t* iter, const char* key_name_query, cfstore_area_hkvt_t* hkvt)
+{
+    const uint8_t* key = hkvt->key;
+    size_t key_len = cfstore_hkvt_get_key_len(hkvt);
+    size_t suffix_len = iter->query_len - iter->suffix_start;
+    size_t pos = iter->prefix_len;
+    size_t seg = iter->prefix_len + 1;
+    size_t seg_len;
+    size_t end;
+
+    if(key_len < iter->prefix_len + suffix_len){
+        return false;
+    }
+    end = key_len - suffix_len;
+    if(memcmp(key, key_name_query, iter->prefix_len) != 0 || memcmp(key + end, key_name_query + iter->suffix_start, suffix_len) != 0){
+        return false;
+    }
+    while(seg < iter->suffix_start){
+        seg_len = strcspn(key_name_query + seg, "*");
+        while(pos + seg_len <= end && memcmp(key + pos, key_name_query + seg, seg_len) != 0){
+            pos++;
+        }
+        if(pos + seg_len > end){
+            return false;
+        }
+        pos += seg_len;
+        seg += seg_len + 1;
+    }
+    return true;
+}
+
+/* @brief   check whether FindIter() returns the KV, given it matches the query */
+static CFSTORE_INLINE bool cfstore_find_iter_is_findable(cfstore_area_hkvt_t* hkvt)
+{
+    return !cfstore_hkvt_get_flags_delete(hkvt) && cfstore_is_kv_client_readable(hkvt);
+}
+
+/* @brief   find the next KV of a FindIter() iteration after prev, which is
+ *          NULL on the first call */
+static int32_t cfstore_find_iter_next(cfstore_find_iter_t* iter, const char* key_name_query, cfstore_area_hkvt_t *prev, cfstore_area_hkvt_t *next)
+{
+    int32_t ret;
+#ifdef CFSTORE_CONFIG_KEY_INDEX_ENABLED
+    uint32_t i;
+    uint32_t offset;
+    cfstore_index_t* index;
+#endif /* CFSTORE_CONFIG_KEY_INDEX_ENABLED */
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+
+    CFSTORE_TP(CFSTORE_TP_FIND, "%s:entered: key_name_query=\"%s\", mode=%d\n", __func__, key_name_query, (int) iter->mode);
+    memset((void*) next, 0, sizeof(cfstore_area_hkvt_t));
+    switch(iter->mode){
+    case CFSTORE_FIND_ITER_MODE_EXACT:
+        /* a single KV has the name */
+        if(prev != NULL){
+            return ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND;
+        }
+        return cfstore_find_ex(key_name_query, NULL, next);
+
+#ifdef CFSTORE_CONFIG_KEY_INDEX_ENABLED
+    case CFSTORE_FIND_ITER_MODE_INDEX:
+        index = &ctx->index;
+        if(!index->valid){
+            CFSTORE_ERRLOG("%s:Error: the key index was dropped during the iteration\n", __func__);
+            return ARM_DRIVER_ERROR;
+        }
+        if(prev == NULL){
+            i = cfstore_index_sorted_find(ctx, key_name_query, iter->prefix_len, 0, true);
+        } else if(iter->generation == index->generation){
+            i = iter->pos + 1;
+        } else {
+            /* KVs were added or removed since, the open prev is still in the index */
+            offset = (uint32_t) (prev->head - ctx->area_0_head);
+            i = cfstore_index_sorted_find(ctx, (const char*) prev->key, cfstore_hkvt_get_key_len(prev), offset, false);
+            if(i < index->count && index->sorted[i] == offset){
+                i++;
+            }
+        }
+        for(; i < index->count; i++){
+            *next = cfstore_index_get_hkvt(ctx, index->sorted[i]);
+            if(cfstore_index_key_cmp(next, key_name_query, iter->prefix_len, true) != 0){
+                break;
+            }
+            if(cfstore_find_iter_is_findable(next) && cfstore_find_iter_match(iter, key_name_query, next)){
+                iter->pos = i;
+                iter->generation = index->generation;
+                cfstore_hkvt_dump(next, __func__);
+                return ARM_DRIVER_OK;
+            }
+        }
+        break;
+#endif /* CFSTORE_CONFIG_KEY_INDEX_ENABLED */
+
+    case CFSTORE_FIND_ITER_MODE_WALK:
+        ret = prev == NULL ? cfstore_get_head_hkvt(next) : cfstore_get_next_hkvt(prev, next);
+        while(ret >= ARM_DRIVER_OK && next->head != NULL && cfstore_hkvt_is_valid(next, ctx->area_0_tail)){
+            if(cfstore_find_iter_is_findable(next) && cfstore_find_iter_match(iter, key_name_query, next)){
+                cfstore_hkvt_dump(next, __func__);
+                return ARM_DRIVER_OK;
+            }
+            ret = cfstore_get_next_hkvt(next, next);
+        }
+        if(ret < ARM_DRIVER_OK && ret != ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND){
+            return ret;
+        }
+        break;
+
+    default:
+        CFSTORE_ERRLOG("%s:Error: invalid iterator mode (%d)\n", __func__, (int) iter->mode);
+        return ARM_DRIVER_ERROR;
+    }
+    CFSTORE_TP(CFSTORE_TP_FIND, "%s:No more KVs found\n", __func__);
+    memset((void*) next, 0, sizeof(cfstore_area_hkvt_t));
+    return ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND;
+}
+
+
+/* @brief  See definition in configuration_store.h for description. */
+static int32_t cfstore_find_iter(ARM_CFSTORE_FIND_ITER iter, const char* key_name_query, const ARM_CFSTORE_HANDLE previous, ARM_CFSTORE_HANDLE next)
+{
+    cfstore_area_hkvt_t hkvt_next;
+    cfstore_area_hkvt_t hkvt_previous;
+    cfstore_area_hkvt_t *phkvt_previous = NULL;
+    cfstore_find_iter_t* find_iter = (cfstore_find_iter_t*) iter;
+    int32_t ret = ARM_DRIVER_ERROR;
+    ARM_CFSTORE_FMODE fmode;
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+    cfstore_client_notify_data_t notify_data;
+
+    CFSTORE_ASSERT(next != NULL);
+    CFSTORE_ASSERT(sizeof(cfstore_find_iter_t) <= CFSTORE_FIND_ITER_BUFSIZE);
+    CFSTORE_FENTRYLOG("%s:entered: key_name_query=\"%s\", previous=%p, next=%p\n", __func__, key_name_query, previous, next);
+    if(!cfstore_ctx_is_initialised(ctx)) {
+        CFSTORE_ERRLOG("%s:Error: CFSTORE is not initialised.\n", __func__);
+        ret = ARM_CFSTORE_DRIVER_ERROR_UNINITIALISED;
+        goto out1;
+    }
+    if(iter == NULL){
+        CFSTORE_ERRLOG("%s:Error: invalid iterator buffer.\n", __func__);
+        ret = ARM_CFSTORE_DRIVER_ERROR_INVALID_HANDLE_BUF;
+        goto out1;
+    }
+    ret = cfstore_validate_key_name_query(key_name_query);
+    if(ret < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: invalid key_name.\n", __func__);
+        goto out1;
+    }
+    ret = cfstore_validate_handle(next);
+    if(ret < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: invalid next argument.\n", __func__);
+        goto out1;
+    }
+    memset(&hkvt_next, 0, sizeof(hkvt_next));
+    memset(&fmode, 0, sizeof(fmode));
+    if(previous != NULL && cfstore_file_is_valid(previous, ctx)){
+        ret = cfstore_validate_handle(previous);
+        if(ret < ARM_DRIVER_OK){
+            CFSTORE_ERRLOG("%s:Error: invalid handle.\n", __func__);
+            goto out1;
+        }
+        /* the iteration must have been started with the same query */
+        if(find_iter->mode == CFSTORE_FIND_ITER_MODE_START || find_iter->query_len != strlen(key_name_query)){
+            CFSTORE_ERRLOG("%s:Error: iterator not started for this query.\n", __func__);
+            ret = ARM_CFSTORE_DRIVER_ERROR_INVALID_HANDLE_BUF;
+            goto out1;
+        }
+        phkvt_previous = &hkvt_previous;
+        hkvt_previous = cfstore_get_hkvt(previous);
+        if(!cfstore_hkvt_is_valid(phkvt_previous, ctx->area_0_tail)){
+            ret = ARM_CFSTORE_DRIVER_ERROR_INVALID_HANDLE;
+            goto out1;
+        }
+    } else if(previous != NULL && !cfstore_file_is_empty(previous)){
+        CFSTORE_TP(CFSTORE_TP_FIND, "%s:Invalid previous hkey buffer.\n", __func__);
+        ret = ARM_CFSTORE_DRIVER_ERROR_INVALID_HANDLE_BUF;
+        goto out1;
+    } else {
+        cfstore_find_iter_compile(find_iter, key_name_query);
+    }
+    ret = cfstore_find_iter_next(find_iter, key_name_query, phkvt_previous, &hkvt_next);
+    if(ret < ARM_DRIVER_OK){
+        CFSTORE_TP(CFSTORE_TP_FIND, "%s:No more KVs found.\n", __func__);
+        goto out2;
+    }
+    if(!cfstore_hkvt_is_valid(&hkvt_next, ctx->area_0_tail)){
+        CFSTORE_TP(CFSTORE_TP_FIND, "%s:Did not find any matching KVs.\n", __func__);
+        ret = ARM_CFSTORE_DRIVER_ERROR_KEY_NOT_FOUND;
+        goto out2;
+    }
+    cfstore_file_create(&hkvt_next, fmode, next, &ctx->file_list);
+    ret = ARM_DRIVER_OK;
+out2:
+    /* previous handle is being returned to CFSTORE with this call so destroy file struct.
+     * Should this remove a deleted KV from the area, the next handle on the
+     * file list follows the move, unlike Find() there's no need to find it again. */
+    if(phkvt_previous != NULL){
+        cfstore_file_destroy(cfstore_file_get(previous));
+    }
+out1:
+    /* FindIter() always completes synchronously irrespective of flash mode, so indicate to caller */
+    cfstore_client_notify_data_init(&notify_data, CFSTORE_OPCODE_FIND_ITER, ret, next);
+    cfstore_ctx_client_notify(ctx, &notify_data);
+    return ret;
+}
+
+
 /* @brief  grow/shrink pre-existing KV.
  *
  * @note rw_lock must be held by the caller of this function rw_area0_lock */
@@ -3348,6 +4873,10 @@ static int32_t cfstore_recreate(const char* key_name, ARM_CFSTORE_SIZE value_len
         CFSTORE_TP(CFSTORE_TP_CREATE, "%s:new value length the same as the old\n", __func__);
         return ARM_DRIVER_OK;
     }
+    if(ctx->map_count > 0){
+        CFSTORE_ERRLOG("%s:Error: cannot resize a KV while the area is mapped\n", __func__);
+        return ARM_CFSTORE_DRIVER_ERROR_VALUE_MAPPED;
+    }
 
     /* grow the area by the size of the new KV */
     area_size = cfstore_ctx_get_kv_total_len();
@@ -3360,6 +4889,7 @@ static int32_t cfstore_recreate(const char* key_name, ARM_CFSTORE_SIZE value_len
     if (kv_size_diff < 0){
         /* value blob size shrinking => do memmove() before realloc() which will free memory */
         memmove(hkvt->tail + kv_size_diff, hkvt->tail, memmove_len);
+        cfstore_index_shift(ctx, (uint32_t) (hkvt->head - ctx->area_0_head), kv_size_diff);
         ret = cfstore_file_update(hkvt->head, kv_size_diff);
         if(ret < ARM_DRIVER_OK){
             CFSTORE_ERRLOG("%s:Error:file update failed\n", __func__);
@@ -3383,6 +4913,7 @@ static int32_t cfstore_recreate(const char* key_name, ARM_CFSTORE_SIZE value_len
     if(kv_size_diff > 0) {
         /* value blob size growing requires memmove() after realloc() */
         memmove(hkvt->tail+kv_size_diff, hkvt->tail, memmove_len);
+        cfstore_index_shift(ctx, (uint32_t) (hkvt->head - ctx->area_0_head), kv_size_diff);
         ret = cfstore_file_update(hkvt->head, kv_size_diff);
         if(ret < ARM_DRIVER_OK){
             CFSTORE_ERRLOG("%s:Error:file update failed\n", __func__);
@@ -3394,6 +4925,7 @@ static int32_t cfstore_recreate(const char* key_name, ARM_CFSTORE_SIZE value_len
 
     /* set the new value length in the header */
     cfstore_hkvt_set_value_len(hkvt, value_len);
+    cfstore_delta_set_dirty(hkvt);
     cfstore_file_create(hkvt, flags, hkey, &ctx->file_list);
     ctx->area_dirty_flag = true;
 
@@ -3491,6 +5023,12 @@ static int32_t cfstore_create(const char* key_name, ARM_CFSTORE_SIZE value_len,
         CFSTORE_ERRLOG("%s:Error: invalid key descriptor.\n", __func__);
         goto out1;
     }
+    /* growing the area can move it in memory, which would invalidate the mappings */
+    if(ctx->map_count > 0){
+        CFSTORE_ERRLOG("%s:Error: cannot create a KV while the area is mapped\n", __func__);
+        ret = ARM_CFSTORE_DRIVER_ERROR_VALUE_MAPPED;
+        goto out1;
+    }
     /* insert the KV into the area */
     kv_size = strlen(key_name);
     kv_size += value_len;
@@ -3518,6 +5056,8 @@ static int32_t cfstore_create(const char* key_name, ARM_CFSTORE_SIZE value_len,
     /* set the header up, then copy key_name into header */
     hdr = (cfstore_area_header_t*) (ctx->area_0_head + area_size);
     CFSTORE_FENTRYLOG("%s:hdr=%p\n", __func__, hdr);
+    /* the area beyond the old tail may hold padding read from flash, so clear the refcount and flags */
+    memset(hdr, 0, sizeof(cfstore_area_header_t));
     hdr->klength = (uint8_t) strlen(key_name);
     hdr->vlength = value_len;
     hdr->perm_owner_read = b_acl_default ? true : kdesc->acl.perm_owner_read;
@@ -3528,6 +5068,8 @@ static int32_t cfstore_create(const char* key_name, ARM_CFSTORE_SIZE value_len,
     hdr->perm_other_execute = kdesc->acl.perm_other_execute;
     strncpy((char*)hdr + sizeof(cfstore_area_header_t), key_name, strlen(key_name));
     hkvt = cfstore_get_hkvt_from_head_ptr((uint8_t*) hdr);
+    cfstore_index_insert(ctx, (uint32_t) area_size);
+    cfstore_delta_set_dirty(&hkvt);
     if(cfstore_flags_is_default(kdesc->flags)){
         /* set as read-only by default default */
         flags.read = true;
@@ -3759,6 +5301,66 @@ out0:
 }
 
 
+/* @brief  See definition in configuration_store.h for description. */
+static int32_t cfstore_map(ARM_CFSTORE_HANDLE hkey, const void** data, ARM_CFSTORE_SIZE* len)
+{
+    int32_t ret = ARM_DRIVER_ERROR;
+    cfstore_area_hkvt_t hkvt;
+    cfstore_ctx_t* ctx = cfstore_ctx_get();
+    cfstore_client_notify_data_t notify_data;
+
+    CFSTORE_ASSERT(data);
+    CFSTORE_ASSERT(len);
+    CFSTORE_FENTRYLOG("%s:entered, hkey=%p\n", __func__, hkey);
+    if(!cfstore_ctx_is_initialised(ctx)) {
+        CFSTORE_ERRLOG("%s:Error: CFSTORE is not initialised.\n", __func__);
+        ret = ARM_CFSTORE_DRIVER_ERROR_UNINITIALISED;
+        goto out0;
+    }
+    /* mapping a KV doesnt change the sram area so this can happen independently of
+     * an oustanding async operation. its unnecessary to check the fsm state */
+    ret = cfstore_validate_handle(hkey);
+    if(ret < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: invalid handle.\n", __func__);
+        goto out0;
+    }
+    if(data == NULL){
+        CFSTORE_ERRLOG("%s:Error: invalid data pointer.\n", __func__);
+        ret = ARM_CFSTORE_DRIVER_ERROR_INVALID_READ_BUFFER;
+        goto out0;
+    }
+    ret = cfstore_validate_len_ptr(len);
+    if(ret < ARM_DRIVER_OK){
+        CFSTORE_ERRLOG("%s:Error: invalid len argument.\n", __func__);
+        goto out0;
+    }
+    hkvt = cfstore_get_hkvt(hkey);
+    if(!cfstore_hkvt_is_valid(&hkvt, ctx->area_0_tail)){
+        CFSTORE_ERRLOG("%s:ARM_CFSTORE_DRIVER_ERROR_INVALID_HANDLE\n", __func__);
+        ret = ARM_CFSTORE_DRIVER_ERROR_INVALID_HANDLE;
+        goto out0;
+    }
+    if(!cfstore_is_kv_client_readable(&hkvt)){
+        CFSTORE_ERRLOG("%s:Error: client does not have permission to read KV.\n", __func__);
+        ret = ARM_CFSTORE_DRIVER_ERROR_PERM_NO_READ_ACCESS;
+        goto out0;
+    }
+    /* pin the area until the last handle to the KV is closed */
+    if(!cfstore_hkvt_get_flags_mapped(&hkvt)){
+        cfstore_hkvt_set_flags_mapped(&hkvt, true);
+        ctx->map_count++;
+    }
+    *data = hkvt.value;
+    *len = cfstore_hkvt_get_value_len(&hkvt);
+    ret = (int32_t) *len;
+out0:
+    /* Map() always completes synchronously irrespective of flash mode, so indicate to caller */
+    cfstore_client_notify_data_init(&notify_data, CFSTORE_OPCODE_MAP, ret, hkey);
+    cfstore_ctx_client_notify(ctx, &notify_data);
+    return ret;
+}
+
+
 /* @brief  See definition in configuration_store.h for description. */
 static int32_t cfstore_write(ARM_CFSTORE_HANDLE hkey, const char* data, ARM_CFSTORE_SIZE* len)
 {
@@ -3826,6 +5428,7 @@ static int32_t cfstore_write(ARM_CFSTORE_HANDLE hkey, const char* data, ARM_CFST
     memcpy(hkvt.value + file->wlocation, data, *len);
     file->wlocation += *len;
     cfstore_hkvt_dump(&hkvt, __func__);
+    cfstore_delta_set_dirty(&hkvt);
     ctx->area_dirty_flag = true;
     ret = *len;
 out0:
@@ -3948,6 +5551,9 @@ static int32_t cfstore_initialise(ARM_CFSTORE_CALLBACK callback, void* client_co
         /* ctx->rw_area0_lock initialisation is not required here as the lock is statically initialised to 0 */
         ctx->area_0_head = NULL;
         ctx->area_0_tail = NULL;
+        cfstore_index_reset(ctx, true);
+        cfstore_delta_reset(ctx);
+        ctx->map_count = 0;
 
         CFSTORE_ASSERT(sizeof(cfstore_file_t) == CFSTORE_HANDLE_BUFSIZE);
         if(sizeof(cfstore_file_t) != CFSTORE_HANDLE_BUFSIZE){
@@ -4046,6 +5652,8 @@ static int32_t cfstore_uninitialise(void)
             ctx->area_0_head = NULL;
             ctx->area_0_tail = NULL;
         }
+        cfstore_index_reset(ctx, false);
+        cfstore_delta_reset(ctx);
     }
 out:
     /* notify client */
@@ -4137,6 +5745,18 @@ static int32_t cfstore_uvisor_find(const char* key_name_query, const ARM_CFSTORE
 	return secure_gateway(configuration_store, __cfstore_uvisor_find, key_name_query, previous, next);
 }
 
+UVISOR_EXTERN int32_t __cfstore_uvisor_find_iter(ARM_CFSTORE_FIND_ITER iter, const char* key_name_query, const ARM_CFSTORE_HANDLE previous, ARM_CFSTORE_HANDLE next)
+{
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+	return cfstore_find_iter(iter, key_name_query, previous, next);
+}
+
+static int32_t cfstore_uvisor_find_iter(ARM_CFSTORE_FIND_ITER iter, const char* key_name_query, const ARM_CFSTORE_HANDLE previous, ARM_CFSTORE_HANDLE next)
+{
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+	return secure_gateway(configuration_store, __cfstore_uvisor_find_iter, iter, key_name_query, previous, next);
+}
+
 UVISOR_EXTERN int32_t __cfstore_uvisor_flush(int dummy)
 {
     CFSTORE_FENTRYLOG("%s:entered\n", __func__);
@@ -4225,6 +5845,16 @@ static int32_t cfstore_uvisor_read(ARM_CFSTORE_HANDLE hkey, void* data, ARM_CFST
 	return secure_gateway(configuration_store, __cfstore_uvisor_read, hkey, data, len);
 }
 
+/* the sram area is private to the cfstore box, so it cannot be mapped into the client */
+static int32_t cfstore_uvisor_map(ARM_CFSTORE_HANDLE hkey, const void** data, ARM_CFSTORE_SIZE* len)
+{
+    CFSTORE_FENTRYLOG("%s:entered\n", __func__);
+    (void) hkey;
+    (void) data;
+    (void) len;
+    return ARM_CFSTORE_DRIVER_ERROR_NOT_SUPPORTED;
+}
+
 UVISOR_EXTERN int32_t __cfstore_uvisor_rseek(ARM_CFSTORE_HANDLE hkey, ARM_CFSTORE_OFFSET offset)
 {
     CFSTORE_FENTRYLOG("%s:entered\n", __func__);
@@ -4271,6 +5901,7 @@ ARM_CFSTORE_DRIVER cfstore_driver =
         .Create = cfstore_uvisor_create,
         .Delete= cfstore_uvisor_delete,
         .Find = cfstore_uvisor_find,
+        .FindIter = cfstore_uvisor_find_iter,
         .Flush = cfstore_uvisor_flush,
         .GetCapabilities = cfstore_get_capabilities,
         .GetKeyName = cfstore_uvisor_get_key_name,
@@ -4278,6 +5909,7 @@ ARM_CFSTORE_DRIVER cfstore_driver =
         .GetValueLen = cfstore_uvisor_get_value_len,
         .GetVersion = cfstore_get_version,
         .Initialize = cfstore_uvisor_initialise,
+        .Map = cfstore_uvisor_map,
         .Open = cfstore_uvisor_open,
         .PowerControl = cfstore_power_control,
         .Read = cfstore_uvisor_read,
@@ -4295,6 +5927,7 @@ ARM_CFSTORE_DRIVER cfstore_driver =
         .Create = cfstore_create,
         .Delete= cfstore_delete,
         .Find = cfstore_find,
+        .FindIter = cfstore_find_iter,
         .Flush = cfstore_flush,
         .GetCapabilities = cfstore_get_capabilities,
         .GetKeyName = cfstore_get_key_name,
@@ -4302,6 +5935,7 @@ ARM_CFSTORE_DRIVER cfstore_driver =
         .GetValueLen = cfstore_get_value_len,
         .GetVersion = cfstore_get_version,
         .Initialize = cfstore_initialise,
+        .Map = cfstore_map,
         .Open = cfstore_open,
         .PowerControl = cfstore_power_control,
         .Read = cfstore_read,
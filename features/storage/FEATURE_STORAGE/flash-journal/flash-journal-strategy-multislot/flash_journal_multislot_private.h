@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2006-2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FLASH_JOURNAL_MULTISLOT_PRIVATE_H__
+#define __FLASH_JOURNAL_MULTISLOT_PRIVATE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "flash-journal/flash_journal.h"
+#include "flash-journal-strategy-sequential/flash_journal_private.h"
+
+static const uint32_t MULTISLOT_FLASH_JOURNAL_INVALD_NEXT_SEQUENCE_NUMBER = 0xFFFFFFFFUL;
+static const uint32_t MULTISLOT_FLASH_JOURNAL_MAGIC                       = 0xCE03102AUL;
+static const uint32_t MULTISLOT_FLASH_JOURNAL_VERSION                     = 1;
+static const uint32_t MULTISLOT_FLASH_JOURNAL_HEADER_MAGIC                = 0xCEA10AEEUL;
+static const uint32_t MULTISLOT_FLASH_JOURNAL_HEADER_VERSION              = 1;
+static const uint32_t MULTISLOT_FLASH_JOURNAL_MIN_SLOTS                   = 2;
+
+
+typedef enum {
+    MULTISLOT_JOURNAL_STATE_NOT_INITIALIZED,
+    MULTISLOT_JOURNAL_STATE_INIT_SCANNING_LOG_HEADERS,
+    MULTISLOT_JOURNAL_STATE_INITIALIZED,
+    MULTISLOT_JOURNAL_STATE_RESETING,
+    MULTISLOT_JOURNAL_STATE_PRE_ERASING,
+    MULTISLOT_JOURNAL_STATE_LOGGING_ERASE,
+    MULTISLOT_JOURNAL_STATE_LOGGING_HEAD,
+    MULTISLOT_JOURNAL_STATE_LOGGING_BODY,
+    MULTISLOT_JOURNAL_STATE_LOGGING_TAIL,
+    MULTISLOT_JOURNAL_STATE_READING,
+} MultislotFlashJournalState_t;
+
+/**
+ * The multi-slot journal keeps the on-storage layout of the sequential
+ * journal: the journal header, and the head and tail of each slot. Only the
+ * magic numbers differ, so that either strategy rejects the other's journal.
+ */
+typedef SequentialFlashJournalHeader_t  MultislotFlashJournalHeader_t;
+typedef SequentialFlashJournalLogHead_t MultislotFlashJournalLogHead_t;
+typedef SequentialFlashJournalLogTail_t MultislotFlashJournalLogTail_t;
+
+typedef struct _MultislotFlashJournal_t {
+    FlashJournal_Ops_t             ops;                /**< the mandatory OPS table defining the strategy. */
+    FlashJournal_Callback_t        callback;           /**< command completion callback. */
+    FlashJournal_Info_t            info;               /**< the info structure returned from GetInfo(). */
+    ARM_DRIVER_STORAGE            *mtd;                /**< The underlying Memory-Technology-Device. */
+    ARM_STORAGE_CAPABILITIES       mtdCapabilities;    /**< the return from mtd->GetCapabilities(); held for quick reference. */
+    uint64_t                       mtdStartOffset;     /**< the start of the address range maintained by the underlying MTD. */
+    uint32_t                       firstSlotOffset;    /** Offset from the start of the journal header to the first slot. */
+    uint32_t                       numSlots;           /** Number of slots the blobs are rotated through. */
+    uint32_t                       sizeofSlot;         /**< size of the log stride. */
+    uint32_t                       nextSequenceNumber; /**< the next valid sequence number to be used when logging the next blob. */
+    uint32_t                       currentBlobIndex;   /**< index of the most recently written blob. */
+    uint32_t                       erasedBlobIndex;    /**< index of the slot known to be erased, or numSlots if none is. */
+    MultislotFlashJournalState_t   state;              /**< state of the journal. MULTISLOT_JOURNAL_STATE_INITIALIZED being the default. */
+    FlashJournal_OpCode_t          prevCommand;        /**< the last command issued to the journal. */
+    bool                           logPending;         /**< a log() issued during the pre-erase; it is resumed once the erase completes. */
+    FlashJournalCrcContext_t       crcContext;         /**< CRC32 of the slot being logged, accumulated across the steps of log() and commit(). */
+
+    /**
+     * The following is a union of sub-structures meant to keep state relevant
+     * to the commands during their execution.
+     */
+    union {
+        /** state relevant to initialization. */
+        struct {
+            uint64_t currentOffset;
+            struct {
+                uint32_t                       headSequenceNumber;
+                MultislotFlashJournalLogTail_t tail;
+            };
+        } initScan;
+
+        /** state relevant to logging of data, and to the pre-erase following a commit. */
+        struct {
+            const uint8_t *blob;           /**< the original buffer holding source data. */
+            size_t         sizeofBlob;
+            union {
+                struct {
+                    uint64_t mtdEraseOffset;
+                };
+                struct {
+                    uint64_t       mtdOffset;       /**< the current Storage offset at which data will be written. */
+                    uint64_t       mtdTailOffset;   /**< Storage offset at which the MultislotFlashJournalLogTail_t will be logged for this slot. */
+                    const uint8_t *dataBeingLogged; /**< temporary pointer aimed at the next data to be logged. */
+                    size_t         amountLeftToLog;
+                    union {
+                        MultislotFlashJournalLogHead_t head;
+                        MultislotFlashJournalLogTail_t tail;
+                    };
+                };
+            };
+        } log;
+
+        /** state relevant to read-back of data. */
+        SequentialFlashJournalReadState_t read;
+    };
+} MultislotFlashJournal_t;
+
+/**<
+ * A static assert to ensure that the size of MultislotFlashJournal_t is
+ * smaller than FlashJournal_t, whose space the strategy reuses.
+ */
+typedef char AssertMultislotJournalSizeLessThanOrEqualToGenericJournal[sizeof(MultislotFlashJournal_t)<=sizeof(FlashJournal_t)?1:-1];
+
+#define MULTISLOT_SLOT_ADDRESS(JOURNAL, INDEX) ((JOURNAL)->mtdStartOffset + (JOURNAL)->firstSlotOffset + ((INDEX) * (JOURNAL)->sizeofSlot))
+
+/** index of the slot following the most recent blob; i.e. the one the next blob is logged into. */
+static inline uint32_t multislotNextBlobIndex(const MultislotFlashJournal_t *journal)
+{
+    uint32_t index = journal->currentBlobIndex + 1;
+    return (index == journal->numSlots) ? 0 : index;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* __FLASH_JOURNAL_MULTISLOT_PRIVATE_H__ */
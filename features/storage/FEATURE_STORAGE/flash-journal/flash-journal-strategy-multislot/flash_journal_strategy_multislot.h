@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2006-2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FLASH_JOURNAL_STRATEGY_MULTISLOT_H__
+#define __FLASH_JOURNAL_STRATEGY_MULTISLOT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "flash-journal/flash_journal.h"
+
+/**
+ * Create/format a multi-slot flash journal at a given offset within a storage
+ * device and with a given slot-cardinality.
+ *
+ * The multi-slot journal logs each blob into the slot following the one
+ * holding the most recent blob, so that program/erase cycles are spread
+ * evenly over all the slots. As soon as a commit() has sealed a blob, the
+ * slot after it is erased in the background (by an asynchronous MTD) so that
+ * the next sequence of log()s can start programming without first waiting
+ * for an erase. An error during a sequence of log()s leaves the sequence in
+ * place; retrying the failed log() or commit() resumes at the point where the
+ * underlying storage gave up.
+ *
+ * This function must be called *once* for each incarnation of a multi-slot
+ * journal.
+ *
+ * @param[in] mtd
+ *              The underlying Storage driver.
+ *
+ * @param[in] numSlots
+ *              Number of slots in the journal; at least 2, as the slot
+ *              following the most recent blob is kept erased. Each slot holds
+ *              a header, blob-payload, and a tail.
+ *
+ * @param[in] callback
+ *                Caller-defined callback to be invoked upon command completion
+ *                in case the storage device executes operations asynchronously.
+ *                Use a NULL pointer when no callback signals are required.
+ *
+ * @note: this is an asynchronous operation, but it can finish
+ * synchronously if the underlying MTD supports that.
+ *
+ * @return
+ *   The function executes in the same ways as
+ *   flashJournalStrategySequential_format(): JOURNAL_STATUS_OK when an
+ *   asynchronous operation has been started and the callback will follow, 1
+ *   upon synchronous completion, or an appropriate error code.
+ *
+ * The layout on the storage is the one of the sequential journal: a journal
+ * header padded to an erase boundary, followed by 'numSlots' slots each
+ * aligned with the LCM of all erase boundaries, each holding a slot header,
+ * the blob and a slot tail.
+ */
+int32_t               flashJournalStrategyMultislot_format(ARM_DRIVER_STORAGE      *mtd,
+                                                           uint32_t                 numSlots,
+                                                           FlashJournal_Callback_t  callback);
+
+int32_t               flashJournalStrategyMultislot_initialize(FlashJournal_t           *journal,
+                                                               ARM_DRIVER_STORAGE       *mtd,
+                                                               const FlashJournal_Ops_t *ops,
+                                                               FlashJournal_Callback_t   callback);
+FlashJournal_Status_t flashJournalStrategyMultislot_getInfo(FlashJournal_t *journal, FlashJournal_Info_t *info);
+int32_t               flashJournalStrategyMultislot_read(FlashJournal_t *journal, void *blob, size_t n);
+int32_t               flashJournalStrategyMultislot_readFrom(FlashJournal_t *journal, size_t offset, void *blob, size_t n);
+int32_t               flashJournalStrategyMultislot_log(FlashJournal_t *journal, const void *blob, size_t n);
+int32_t               flashJournalStrategyMultislot_commit(FlashJournal_t *journal);
+int32_t               flashJournalStrategyMultislot_reset(FlashJournal_t *journal);
+
+static const FlashJournal_Ops_t FLASH_JOURNAL_STRATEGY_MULTISLOT = {
+    flashJournalStrategyMultislot_initialize,
+    flashJournalStrategyMultislot_getInfo,
+    flashJournalStrategyMultislot_read,
+    flashJournalStrategyMultislot_readFrom,
+    flashJournalStrategyMultislot_log,
+    flashJournalStrategyMultislot_commit,
+    flashJournalStrategyMultislot_reset
+};
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* __FLASH_JOURNAL_STRATEGY_MULTISLOT_H__ */
@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) 2006-2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flash-journal-strategy-sequential/flash_journal_crc.h"
+#include "flash-journal-strategy-multislot/flash_journal_multislot_private.h"
+#include "flash-journal-strategy-multislot/flash_journal_strategy_multislot.h"
+#include "support_funcs.h"
+#include <string.h>
+#include <stdio.h>
+
+MultislotFlashJournal_t *multislotActiveJournal;
+
+/*
+ * forward declarations of static-inline helper functions.
+ */
+static inline int32_t flashJournalStrategyMultislot_format_sanityChecks(ARM_DRIVER_STORAGE *mtd, uint32_t numSlots);
+static inline int32_t flashJournalStrategyMultislot_read_sanityChecks(MultislotFlashJournal_t *journal, const void *blob, size_t sizeofBlob);
+static inline int32_t flashJournalStrategyMultislot_log_sanityChecks(MultislotFlashJournal_t *journal, const void *blob, size_t sizeofBlob);
+static inline int32_t flashJournalStrategyMultislot_commit_sanityChecks(MultislotFlashJournal_t *journal);
+
+
+int32_t flashJournalStrategyMultislot_format(ARM_DRIVER_STORAGE      *mtd,
+                                             uint32_t                 numSlots,
+                                             FlashJournal_Callback_t  callback)
+{
+    int32_t rc;
+    if ((rc = flashJournalStrategyMultislot_format_sanityChecks(mtd, numSlots)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    ARM_STORAGE_INFO mtdInfo;
+    if (mtd->GetInfo(&mtdInfo) < ARM_DRIVER_OK) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR;
+    }
+    uint64_t mtdAddr;
+    if (mtdGetStartAddr(mtd, &mtdAddr) < JOURNAL_STATUS_OK) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR;
+    }
+
+    formatInfoSingleton.mtd            = mtd;
+    formatInfoSingleton.mtdAddr        = mtdAddr;
+    formatInfoSingleton.callback       = callback;
+    formatInfoSingleton.mtdProgramUnit = mtdInfo.program_unit;
+
+    if ((rc = setupMultislotJournalHeader(&formatInfoSingleton.header, mtd, mtdInfo.total_storage, numSlots)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    /* initialize MTD */
+    rc = mtd->Initialize(formatHandler);
+    if (rc < ARM_DRIVER_OK) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR;
+    } else if (rc == ARM_DRIVER_OK) {
+        return JOURNAL_STATUS_OK; /* An asynchronous operation is pending; it will result in a completion callback
+                                   * where the rest of processing will take place. */
+    }
+    if (rc != 1) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR; /* synchronous completion is expected to return 1 */
+    }
+
+    /* progress the rest of the create state-machine */
+    return flashJournalStrategySequential_format_progress(ARM_DRIVER_OK, ARM_STORAGE_OPERATION_INITIALIZE);
+}
+
+/**
+ * Validate a header at the start of the MTD.
+ *
+ * @param [in/out] headerP
+ *                     Caller-allocated header which gets filled in during validation.
+
+ * @return JOURNAL_STATUS_OK if the header is sane. As a side-effect, the memory
+ *         pointed to by 'headerP' is initialized with the header.
+ */
+static int32_t readAndVerifyMultislotJournalHeader(MultislotFlashJournal_t *journal, MultislotFlashJournalHeader_t *headerP)
+{
+    int32_t rc;
+    if ((rc = readSlotJournalHeader(journal->mtd, journal->mtdStartOffset,
+                                    MULTISLOT_FLASH_JOURNAL_HEADER_MAGIC, MULTISLOT_FLASH_JOURNAL_HEADER_VERSION,
+                                    headerP)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    uint32_t expectedCRC = headerP->genericHeader.checksum;
+    headerP->genericHeader.checksum = 0;
+    FlashJournalCrcContext_t crcContext;
+    flashJournalCrcContextReset(&crcContext);
+    uint32_t computedCRC = flashJournalCrcContextCummulative(&crcContext, (const unsigned char *)headerP, sizeof(MultislotFlashJournalHeader_t));
+    if (computedCRC != expectedCRC) {
+        return JOURNAL_STATUS_METADATA_ERROR;
+    }
+    if ((headerP->numSlots < MULTISLOT_FLASH_JOURNAL_MIN_SLOTS) || (headerP->sizeofSlot == 0)) {
+        return JOURNAL_STATUS_METADATA_ERROR;
+    }
+
+    return JOURNAL_STATUS_OK;
+}
+
+int32_t flashJournalStrategyMultislot_initialize(FlashJournal_t           *_journal,
+                                                 ARM_DRIVER_STORAGE       *mtd,
+                                                 const FlashJournal_Ops_t *ops,
+                                                 FlashJournal_Callback_t   callback)
+{
+    int32_t rc;
+    MultislotFlashJournal_t *journal = (MultislotFlashJournal_t *)_journal;
+
+    if ((journal == multislotActiveJournal) && (journal->state == MULTISLOT_JOURNAL_STATE_PRE_ERASING)) {
+        return JOURNAL_STATUS_BUSY; /* the background erase started by the last commit hasn't completed yet. */
+    }
+
+    /* initialize MTD */
+    if ((rc = mtdInitialize(mtd, multislotMtdHandler)) != JOURNAL_STATUS_OK) {
+        if (rc == JOURNAL_STATUS_STORAGE_API_ERROR) {
+            memset(_journal, 0, sizeof(FlashJournal_t));
+        }
+        return rc;
+    }
+
+    multislotActiveJournal = journal;
+    journal->state         = MULTISLOT_JOURNAL_STATE_NOT_INITIALIZED;
+    journal->mtd           = mtd;
+    journal->logPending    = false;
+
+    /* Setup start address within MTD. */
+    if ((rc = mtdGetStartAddr(journal->mtd, &journal->mtdStartOffset)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    ARM_STORAGE_INFO mtdInfo;
+    if ((rc = mtd->GetInfo(&mtdInfo)) != ARM_DRIVER_OK) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR;
+    }
+
+    MultislotFlashJournalHeader_t journalHeader;
+    if ((rc = readAndVerifyMultislotJournalHeader(journal, &journalHeader)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    /* initialize the journal structure */
+    memcpy(&journal->ops, ops, sizeof(FlashJournal_Ops_t));
+    journal->mtdCapabilities   = mtd->GetCapabilities(); /* fetch MTD's capabilities */
+
+    journal->firstSlotOffset   = journalHeader.genericHeader.journalOffset;
+    journal->numSlots          = journalHeader.numSlots;
+    journal->sizeofSlot        = journalHeader.sizeofSlot;
+
+    /* effective capacity */
+    journal->info.capacity     = journal->sizeofSlot
+                                 - roundUp_uint32(sizeof(MultislotFlashJournalLogHead_t), mtdInfo.program_unit)
+                                 - roundUp_uint32(sizeof(MultislotFlashJournalLogTail_t), mtdInfo.program_unit);
+    journal->info.program_unit = mtdInfo.program_unit;
+    journal->callback          = callback;
+    journal->prevCommand       = FLASH_JOURNAL_OPCODE_INITIALIZE;
+
+    if ((rc = multislotDiscoverLatestLoggedBlob(journal)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    return 1; /* synchronous completion */
+}
+
+FlashJournal_Status_t flashJournalStrategyMultislot_getInfo(FlashJournal_t *_journal, FlashJournal_Info_t *infoP)
+{
+    MultislotFlashJournal_t *journal;
+    multislotActiveJournal = journal = (MultislotFlashJournal_t *)_journal;
+
+    memcpy(infoP, &journal->info, sizeof(FlashJournal_Info_t));
+    return JOURNAL_STATUS_OK;
+}
+
+int32_t flashJournalStrategyMultislot_read(FlashJournal_t *_journal, void *blob, size_t sizeofBlob)
+{
+    MultislotFlashJournal_t *journal;
+    multislotActiveJournal = journal = (MultislotFlashJournal_t *)_journal;
+
+    if (journal->prevCommand != FLASH_JOURNAL_OPCODE_READ_BLOB) {
+        journal->read.logicalOffset = 0;
+    }
+
+    int32_t rc;
+    if ((rc = flashJournalStrategyMultislot_read_sanityChecks(journal, blob, sizeofBlob)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    journal->read.blob       = blob;
+    journal->read.sizeofBlob = sizeofBlob;
+
+    if (journal->read.logicalOffset == 0) {
+        { /* Establish the sanity of this slot before proceeding with the read. */
+            uint32_t headSequenceNumber;
+            MultislotFlashJournalLogTail_t tail;
+            if (multislotSlotIsSane(journal,
+                                    MULTISLOT_SLOT_ADDRESS(journal, journal->currentBlobIndex),
+                                    &headSequenceNumber,
+                                    &tail) != 1) {
+                return JOURNAL_STATUS_STORAGE_IO_ERROR;
+            }
+        }
+
+        journal->read.mtdOffset = MULTISLOT_SLOT_ADDRESS(journal, journal->currentBlobIndex) + sizeof(MultislotFlashJournalLogHead_t);
+    } else {
+        /* journal->read.offset is already set from the previous read execution */
+    }
+    journal->read.dataBeingRead    = blob;
+    journal->read.amountLeftToRead = ((journal->info.sizeofJournaledBlob - journal->read.logicalOffset) < sizeofBlob) ?
+                                        (journal->info.sizeofJournaledBlob - journal->read.logicalOffset) : sizeofBlob;
+
+    journal->state       = MULTISLOT_JOURNAL_STATE_READING;
+    journal->prevCommand = FLASH_JOURNAL_OPCODE_READ_BLOB;
+    return flashJournalStrategyMultislot_read_progress();
+}
+
+int32_t flashJournalStrategyMultislot_readFrom(FlashJournal_t *_journal, size_t offset, void *blob, size_t sizeofBlob)
+{
+    MultislotFlashJournal_t *journal;
+    multislotActiveJournal = journal = (MultislotFlashJournal_t *)_journal;
+
+    journal->read.logicalOffset = offset;
+    int32_t rc;
+    if ((rc = flashJournalStrategyMultislot_read_sanityChecks(journal, blob, sizeofBlob)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    journal->read.blob             = blob;
+    journal->read.sizeofBlob       = sizeofBlob;
+
+    journal->read.mtdOffset        = MULTISLOT_SLOT_ADDRESS(journal, journal->currentBlobIndex) + sizeof(MultislotFlashJournalLogHead_t) + offset;
+
+    journal->read.dataBeingRead    = blob;
+    journal->read.amountLeftToRead = ((journal->info.sizeofJournaledBlob - journal->read.logicalOffset) < sizeofBlob) ?
+                                        (journal->info.sizeofJournaledBlob - journal->read.logicalOffset) : sizeofBlob;
+
+    journal->state       = MULTISLOT_JOURNAL_STATE_READING;
+    journal->prevCommand = FLASH_JOURNAL_OPCODE_READ_BLOB;
+    return flashJournalStrategyMultislot_read_progress();
+}
+
+int32_t flashJournalStrategyMultislot_log(FlashJournal_t *_journal, const void *blob, size_t size)
+{
+    MultislotFlashJournal_t *journal;
+    multislotActiveJournal = journal = (MultislotFlashJournal_t *)_journal;
+
+    int32_t rc;
+    if ((rc = flashJournalStrategyMultislot_log_sanityChecks(journal, blob, size)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    journal->log.blob       = blob;
+    journal->log.sizeofBlob = size;
+
+    switch (journal->state) {
+        case MULTISLOT_JOURNAL_STATE_PRE_ERASING:
+            /* The slot is still being erased in the background. Logging starts
+             * from the completion of the erase, and is reported through the
+             * callback. */
+            journal->logPending  = true;
+            journal->prevCommand = FLASH_JOURNAL_OPCODE_LOG_BLOB;
+            return JOURNAL_STATUS_OK;
+
+        case MULTISLOT_JOURNAL_STATE_INITIALIZED:
+            /* This is the first log in the sequence. It goes into the slot
+             * following the most recent blob, which is only erased if the
+             * pre-erase hasn't already done so. */
+            journal->log.mtdEraseOffset = MULTISLOT_SLOT_ADDRESS(journal, multislotNextBlobIndex(journal));
+            journal->state              = MULTISLOT_JOURNAL_STATE_LOGGING_ERASE;
+            break;
+
+        case MULTISLOT_JOURNAL_STATE_LOGGING_BODY:
+            /* This is a continuation of an ongoing logging sequence. */
+            journal->log.dataBeingLogged = blob;
+            journal->log.amountLeftToLog = size;
+            break;
+
+        default:
+            /* The erase or the head of the slot was interrupted by an earlier
+             * failure; resume where it stopped. */
+            break;
+    }
+    journal->prevCommand = FLASH_JOURNAL_OPCODE_LOG_BLOB;
+
+    /* progress the state machine for log() */
+    return flashJournalStrategyMultislot_log_progress();
+}
+
+int32_t flashJournalStrategyMultislot_commit(FlashJournal_t *_journal)
+{
+    MultislotFlashJournal_t *journal;
+    multislotActiveJournal = journal = (MultislotFlashJournal_t *)_journal;
+
+    int32_t rc;
+    if ((rc = flashJournalStrategyMultislot_commit_sanityChecks(journal)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    switch (journal->state) {
+        case MULTISLOT_JOURNAL_STATE_LOGGING_BODY:
+            /* the tail has already been setup during previous calls to log(); we can now include it in the crc32. */
+            journal->log.tail.crc32 = flashJournalCrcContextCummulative(&journal->crcContext, (const unsigned char *)&journal->log.tail, sizeof(MultislotFlashJournalLogTail_t));
+
+            journal->log.mtdOffset       = journal->log.mtdTailOffset;
+            journal->log.dataBeingLogged = (const uint8_t *)&journal->log.tail;
+            journal->log.amountLeftToLog = sizeof(MultislotFlashJournalLogTail_t);
+            journal->state               = MULTISLOT_JOURNAL_STATE_LOGGING_TAIL;
+            break;
+
+        case MULTISLOT_JOURNAL_STATE_INITIALIZED:
+            /* commit without any preceding log(); this seals an empty blob. */
+            journal->log.mtdEraseOffset = MULTISLOT_SLOT_ADDRESS(journal, multislotNextBlobIndex(journal));
+            journal->state              = MULTISLOT_JOURNAL_STATE_LOGGING_ERASE;
+            break;
+
+        default:
+            /* The erase, the head or the tail of the slot was interrupted by
+             * an earlier failure; resume where it stopped. */
+            break;
+    }
+
+    journal->prevCommand = FLASH_JOURNAL_OPCODE_COMMIT;
+    return flashJournalStrategyMultislot_log_progress();
+}
+
+int32_t flashJournalStrategyMultislot_reset(FlashJournal_t *_journal)
+{
+    MultislotFlashJournal_t *journal;
+    multislotActiveJournal = journal = (MultislotFlashJournal_t *)_journal;
+
+    if (journal->state == MULTISLOT_JOURNAL_STATE_PRE_ERASING) {
+        return JOURNAL_STATUS_BUSY;
+    }
+
+    /* a reset also abandons a sequence of log()s interrupted by a failure. */
+    journal->state       = MULTISLOT_JOURNAL_STATE_RESETING;
+    journal->logPending  = false;
+
+    journal->prevCommand = FLASH_JOURNAL_OPCODE_RESET;
+    return flashJournalStrategyMultislot_reset_progress();
+}
+
+int32_t flashJournalStrategyMultislot_format_sanityChecks(ARM_DRIVER_STORAGE *mtd, uint32_t numSlots)
+{
+    /*
+     * basic parameter checking
+     */
+    if ((mtd == NULL) || (numSlots < MULTISLOT_FLASH_JOURNAL_MIN_SLOTS)) {
+        return JOURNAL_STATUS_PARAMETER;
+    }
+
+    return mtdFormatSanityChecks(mtd);
+}
+
+int32_t flashJournalStrategyMultislot_read_sanityChecks(MultislotFlashJournal_t *journal, const void *blob, size_t sizeofBlob)
+{
+    if ((journal == NULL) || (blob == NULL) || (sizeofBlob == 0)) {
+        return JOURNAL_STATUS_PARAMETER;
+    }
+    if ((journal->state == MULTISLOT_JOURNAL_STATE_NOT_INITIALIZED) || (journal->state == MULTISLOT_JOURNAL_STATE_INIT_SCANNING_LOG_HEADERS)) {
+        return JOURNAL_STATUS_NOT_INITIALIZED;
+    }
+    if (journal->state == MULTISLOT_JOURNAL_STATE_PRE_ERASING) {
+        return JOURNAL_STATUS_BUSY; /* the MTD is erasing the next slot. */
+    }
+    if (journal->state != MULTISLOT_JOURNAL_STATE_INITIALIZED) {
+        return JOURNAL_STATUS_ERROR; /* journal is in an un-expected state. */
+    }
+    if ((journal->info.sizeofJournaledBlob == 0) || (journal->read.logicalOffset >= journal->info.sizeofJournaledBlob)) {
+        journal->read.logicalOffset = 0;
+        return JOURNAL_STATUS_EMPTY;
+    }
+
+    return JOURNAL_STATUS_OK;
+}
+
+int32_t flashJournalStrategyMultislot_log_sanityChecks(MultislotFlashJournal_t *journal, const void *blob, size_t sizeofBlob)
+{
+    if ((journal == NULL) || (blob == NULL) || (sizeofBlob == 0)) {
+        return JOURNAL_STATUS_PARAMETER;
+    }
+    if ((journal->state == MULTISLOT_JOURNAL_STATE_NOT_INITIALIZED) || (journal->state == MULTISLOT_JOURNAL_STATE_INIT_SCANNING_LOG_HEADERS)) {
+        return JOURNAL_STATUS_NOT_INITIALIZED;
+    }
+    switch (journal->state) {
+        case MULTISLOT_JOURNAL_STATE_PRE_ERASING:
+            if (journal->logPending) {
+                return JOURNAL_STATUS_BUSY; /* a log() is already waiting for the erase. */
+            }
+
+            /* intentional fall-through */
+
+        case MULTISLOT_JOURNAL_STATE_INITIALIZED:
+        case MULTISLOT_JOURNAL_STATE_LOGGING_ERASE:
+        case MULTISLOT_JOURNAL_STATE_LOGGING_HEAD:
+            if (sizeofBlob > journal->info.capacity) {
+                return JOURNAL_STATUS_BOUNDED_CAPACITY; /* adding this log chunk would cause us to exceed capacity (write past the tail). */
+            }
+            break;
+
+        case MULTISLOT_JOURNAL_STATE_LOGGING_BODY:
+            if (journal->log.mtdOffset + sizeofBlob > journal->log.mtdTailOffset) {
+                return JOURNAL_STATUS_BOUNDED_CAPACITY; /* adding this log chunk would cause us to exceed capacity (write past the tail). */
+            }
+            break;
+
+        default:
+            return JOURNAL_STATUS_ERROR; /* journal is in an un-expected state. */
+    }
+
+    /* ensure that the request is at least as large as the minimum program unit */
+    if (sizeofBlob < journal->info.program_unit) {
+        return JOURNAL_STATUS_SMALL_LOG_REQUEST;
+    }
+
+    return JOURNAL_STATUS_OK;
+}
+
+int32_t flashJournalStrategyMultislot_commit_sanityChecks(MultislotFlashJournal_t *journal)
+{
+    if (journal == NULL) {
+        return JOURNAL_STATUS_PARAMETER;
+    }
+    switch (journal->state) {
+        case MULTISLOT_JOURNAL_STATE_NOT_INITIALIZED:
+        case MULTISLOT_JOURNAL_STATE_INIT_SCANNING_LOG_HEADERS:
+            return JOURNAL_STATUS_NOT_INITIALIZED;
+
+        case MULTISLOT_JOURNAL_STATE_PRE_ERASING:
+            return JOURNAL_STATUS_BUSY;
+
+        case MULTISLOT_JOURNAL_STATE_LOGGING_BODY:
+            if (journal->prevCommand != FLASH_JOURNAL_OPCODE_LOG_BLOB) {
+                return JOURNAL_STATUS_ERROR;
+            }
+            if ((journal->log.mtdOffset       == ARM_STORAGE_INVALID_OFFSET) ||
+                (journal->log.mtdTailOffset   == ARM_STORAGE_INVALID_OFFSET) ||
+                (journal->log.mtdTailOffset    < journal->log.mtdOffset)     ||
+                (journal->log.tail.sizeofBlob == 0)                          ||
+                (journal->log.tail.sizeofBlob  > journal->info.capacity)) {
+                return JOURNAL_STATUS_ERROR; /* journal is in an un-expected state. */
+            }
+            break;
+
+        case MULTISLOT_JOURNAL_STATE_RESETING:
+        case MULTISLOT_JOURNAL_STATE_READING:
+            return JOURNAL_STATUS_ERROR; /* journal is in an un-expected state. */
+
+        default:
+            break;
+    }
+
+    return JOURNAL_STATUS_OK;
+}
@@ -0,0 +1,550 @@
+/*
+ * Copyright (c) 2006-2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "flash-journal-strategy-sequential/flash_journal_crc.h"
+#include "support_funcs.h"
+#include <string.h>
+#include <stdio.h>
+#include <inttypes.h>
+
+#define MULTISLOT_ERASE_CHECK_CHUNK_SIZE 64
+
+int32_t multislotSlotIsSane(MultislotFlashJournal_t        *journal,
+                            uint64_t                        slotOffset,
+                            uint32_t                       *headSequenceNumberP,
+                            MultislotFlashJournalLogTail_t *tailP)
+{
+    return checkSlot(journal->mtd,
+                     journal->mtdCapabilities.asynchronous_ops,
+                     slotOffset,
+                     journal->sizeofSlot,
+                     MULTISLOT_FLASH_JOURNAL_MAGIC,
+                     MULTISLOT_FLASH_JOURNAL_VERSION,
+                     headSequenceNumberP,
+                     tailP);
+}
+
+int32_t setupMultislotJournalHeader(MultislotFlashJournalHeader_t *headerP, ARM_DRIVER_STORAGE *mtd, uint64_t totalSize, uint32_t numSlots)
+{
+    int32_t rc;
+    if ((rc = setupSlotJournalHeader(headerP, mtd, totalSize, numSlots,
+                                     MULTISLOT_FLASH_JOURNAL_HEADER_MAGIC, MULTISLOT_FLASH_JOURNAL_HEADER_VERSION)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
+
+    /* compute checksum over the entire header */
+    headerP->genericHeader.checksum = 0;
+    FlashJournalCrcContext_t crcContext;
+    flashJournalCrcContextReset(&crcContext);
+    headerP->genericHeader.checksum = flashJournalCrcContextCummulative(&crcContext, (const unsigned char *)headerP, sizeof(MultislotFlashJournalHeader_t));
+
+    return JOURNAL_STATUS_OK;
+}
+
+/**
+ * Check whether a slot reads back as erased. The slot is read synchronously;
+ * this is only used with an MTD which doesn't have asynchronous_ops.
+ * @return 1 if every byte of the slot holds the erased value of the MTD.
+ */
+static int32_t multislotSlotIsErased(MultislotFlashJournal_t *journal, uint32_t blobIndex)
+{
+    ARM_STORAGE_INFO mtdInfo;
+    if (journal->mtd->GetInfo(&mtdInfo) < ARM_DRIVER_OK) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR;
+    }
+    const uint32_t erasedWord = mtdInfo.erased_value ? 0xFFFFFFFFUL : 0;
+
+    uint32_t buffer[MULTISLOT_ERASE_CHECK_CHUNK_SIZE / sizeof(uint32_t)];
+    uint64_t offset = MULTISLOT_SLOT_ADDRESS(journal, blobIndex);
+    for (uint32_t index = 0; index < journal->sizeofSlot; index += sizeof(buffer), offset += sizeof(buffer)) {
+        if (journal->mtd->ReadData(offset, buffer, sizeof(buffer)) != (int32_t)sizeof(buffer)) {
+            return JOURNAL_STATUS_STORAGE_IO_ERROR;
+        }
+        for (unsigned word = 0; word < sizeof(buffer) / sizeof(uint32_t); word++) {
+            if (buffer[word] != erasedWord) {
+                return JOURNAL_STATUS_ERROR;
+            }
+        }
+    }
+
+    return 1;
+}
+
+int32_t multislotDiscoverLatestLoggedBlob(MultislotFlashJournal_t *journal)
+{
+    /* reset top level journal metadata prior to scanning headers. */
+    journal->nextSequenceNumber       = MULTISLOT_FLASH_JOURNAL_INVALD_NEXT_SEQUENCE_NUMBER; /* we are currently unaware of previously written blobs */
+    journal->currentBlobIndex         = journal->numSlots;
+    journal->erasedBlobIndex          = journal->numSlots;
+    journal->info.sizeofJournaledBlob = 0;
+
+    /* begin header-scan from the first block of the MTD */
+    journal->initScan.currentOffset   = MULTISLOT_SLOT_ADDRESS(journal, 0);
+    journal->state                    = MULTISLOT_JOURNAL_STATE_INIT_SCANNING_LOG_HEADERS;
+
+    for (unsigned blobIndex = 0;
+         blobIndex < journal->numSlots;
+         blobIndex++, journal->initScan.currentOffset += journal->sizeofSlot) {
+        if (multislotSlotIsSane(journal,
+                                journal->initScan.currentOffset,
+                                &journal->initScan.headSequenceNumber,
+                                &journal->initScan.tail) == 1) {
+            uint32_t nextSequenceNumber = journal->initScan.headSequenceNumber + 1;
+            if (nextSequenceNumber == MULTISLOT_FLASH_JOURNAL_INVALD_NEXT_SEQUENCE_NUMBER) {
+                nextSequenceNumber = 0;
+            }
+
+            /* Have we found the best of the slots seen so far? As for the
+             * sequential journal, wraparounds of the sequence number are
+             * taken into account by comparing the signed difference. */
+            if ((journal->nextSequenceNumber == MULTISLOT_FLASH_JOURNAL_INVALD_NEXT_SEQUENCE_NUMBER) ||
+                ((int32_t)(nextSequenceNumber - journal->nextSequenceNumber) > 0)) {
+                journal->currentBlobIndex         = blobIndex;
+                journal->nextSequenceNumber       = nextSequenceNumber;
+                journal->info.sizeofJournaledBlob = journal->initScan.tail.sizeofBlob;
+            }
+        }
+    }
+
+    /* Handle the case where our scan hasn't yielded any results. */
+    if (journal->nextSequenceNumber == MULTISLOT_FLASH_JOURNAL_INVALD_NEXT_SEQUENCE_NUMBER) {
+        journal->currentBlobIndex   = (uint32_t)-1; /* to be incremented to 0 during the first attempt to log(). */
+        journal->nextSequenceNumber = 0;
+    }
+
+    /* A slot pre-erased before the reset needn't be erased again by the first log(). */
+    if (!journal->mtdCapabilities.asynchronous_ops &&
+        (multislotSlotIsErased(journal, multislotNextBlobIndex(journal)) == 1)) {
+        journal->erasedBlobIndex = multislotNextBlobIndex(journal);
+    }
+
+    journal->state = MULTISLOT_JOURNAL_STATE_INITIALIZED;
+    return JOURNAL_STATUS_OK;
+}
+
+static void multislotResetDone(MultislotFlashJournal_t *journal)
+{
+    journal->nextSequenceNumber       = 0;
+    journal->currentBlobIndex         = (uint32_t)-1;
+    journal->erasedBlobIndex          = 0; /* every slot has been erased; slot 0 takes the next blob */
+    journal->info.sizeofJournaledBlob = 0;
+    journal->state                    = MULTISLOT_JOURNAL_STATE_INITIALIZED;
+}
+
+int32_t flashJournalStrategyMultislot_reset_progress(void)
+{
+    int32_t rc;
+    MultislotFlashJournal_t *journal = multislotActiveJournal;
+
+    if ((rc = journal->mtd->Erase(MULTISLOT_SLOT_ADDRESS(journal, 0), journal->numSlots * journal->sizeofSlot)) < ARM_DRIVER_OK) {
+        journal->state = MULTISLOT_JOURNAL_STATE_INITIALIZED; /* reset state */
+        journal->erasedBlobIndex = journal->numSlots;
+        return mapStorageError(rc);
+    }
+    if ((journal->mtdCapabilities.asynchronous_ops) && (rc == ARM_DRIVER_OK)) {
+        return JOURNAL_STATUS_OK; /* we've got pending asynchronous activity. */
+    }
+    /* else we fall through to handle synchronous completion */
+
+    multislotResetDone(journal);
+    return 1;
+}
+
+int32_t flashJournalStrategyMultislot_read_progress(void)
+{
+    MultislotFlashJournal_t *journal = multislotActiveJournal;
+
+    if (journal->state != MULTISLOT_JOURNAL_STATE_READING) {
+        return JOURNAL_STATUS_ERROR; /* journal is in an un-expected state. */
+    }
+
+    int32_t rc = readProgress(journal->mtd, journal->mtdCapabilities.asynchronous_ops, &journal->read);
+    if (rc != JOURNAL_STATUS_OK) {
+        journal->state = MULTISLOT_JOURNAL_STATE_INITIALIZED; /* reset state */
+    }
+    return rc;
+}
+
+/**
+ * Erase from journal->log.mtdEraseOffset up to 'endOffset'. The erase offset
+ * is advanced as the erase proceeds, so that an erase which has failed can be
+ * resumed.
+ *
+ * @return 1 once erased, JOURNAL_STATUS_OK if an asynchronous erase is pending, or an error code.
+ */
+static int32_t multislotEraseUpTo(MultislotFlashJournal_t *journal, uint64_t endOffset)
+{
+    int32_t rc;
+
+    while (journal->log.mtdEraseOffset < endOffset) {
+        if ((rc = journal->mtd->Erase(journal->log.mtdEraseOffset, endOffset - journal->log.mtdEraseOffset)) < ARM_DRIVER_OK) {
+            return mapStorageError(rc);
+        }
+        if (rc == ARM_DRIVER_OK) {
+            if (journal->mtdCapabilities.asynchronous_ops) {
+                return JOURNAL_STATUS_OK; /* we've got pending asynchronous activity. */
+            }
+            return JOURNAL_STATUS_STORAGE_API_ERROR; /* a synchronous erase is expected to report the amount erased. */
+        }
+
+        /* synchronous completion. */
+        journal->log.mtdEraseOffset += rc;
+    }
+
+    return 1;
+}
+
+/**
+ * Account for data programmed while logging; the body is added to the CRC32
+ * as it is programmed so that a sequence of log()s can be resumed after a
+ * failure.
+ */
+static void multislotProgramDone(MultislotFlashJournal_t *journal, uint32_t amount)
+{
+    if (journal->state == MULTISLOT_JOURNAL_STATE_LOGGING_BODY) {
+        flashJournalCrcContextCummulative(&journal->crcContext, journal->log.dataBeingLogged, amount); /* compute CRC32 on logged data */
+        journal->log.tail.sizeofBlob += amount;
+    }
+    journal->log.mtdOffset       += amount;
+    journal->log.amountLeftToLog -= amount;
+    journal->log.dataBeingLogged += amount;
+}
+
+/**
+ * Finish the pre-erase and start a log() which was issued during it.
+ *
+ * @return the status of the pending log(), or the status of the erase if
+ *         there is no pending log().
+ */
+static int32_t multislotPreEraseDone(MultislotFlashJournal_t *journal, int32_t status)
+{
+    uint32_t blobIndex = multislotNextBlobIndex(journal);
+
+    journal->state = MULTISLOT_JOURNAL_STATE_INITIALIZED;
+    if (status > JOURNAL_STATUS_OK) {
+        journal->erasedBlobIndex = blobIndex;
+    }
+    if (!journal->logPending) {
+        return status;
+    }
+
+    /* the erase is only redone if it has failed. */
+    journal->logPending         = false;
+    journal->log.mtdEraseOffset = MULTISLOT_SLOT_ADDRESS(journal, blobIndex);
+    journal->state              = MULTISLOT_JOURNAL_STATE_LOGGING_ERASE;
+    return flashJournalStrategyMultislot_log_progress();
+}
+
+int32_t flashJournalStrategyMultislot_preErase_progress(void)
+{
+    MultislotFlashJournal_t *journal = multislotActiveJournal;
+
+    if (journal->state != MULTISLOT_JOURNAL_STATE_PRE_ERASING) {
+        return JOURNAL_STATUS_ERROR; /* journal is in an un-expected state. */
+    }
+
+    int32_t rc = multislotEraseUpTo(journal, MULTISLOT_SLOT_ADDRESS(journal, multislotNextBlobIndex(journal) + 1));
+    if (rc == JOURNAL_STATUS_OK) {
+        return JOURNAL_STATUS_OK; /* we've got pending asynchronous activity. */
+    }
+
+    return multislotPreEraseDone(journal, rc);
+}
+
+int32_t flashJournalStrategyMultislot_log_progress(void)
+{
+    MultislotFlashJournal_t *journal = multislotActiveJournal;
+
+    if ((journal->state != MULTISLOT_JOURNAL_STATE_LOGGING_ERASE) &&
+        (journal->state != MULTISLOT_JOURNAL_STATE_LOGGING_HEAD)  &&
+        (journal->state != MULTISLOT_JOURNAL_STATE_LOGGING_BODY)  &&
+        (journal->state != MULTISLOT_JOURNAL_STATE_LOGGING_TAIL)) {
+        return JOURNAL_STATUS_ERROR; /* journal is in an un-expected state. */
+    }
+
+    uint32_t blobIndexBeingLogged = multislotNextBlobIndex(journal);
+
+    while (true) {
+        int32_t rc;
+
+        if (journal->state == MULTISLOT_JOURNAL_STATE_LOGGING_ERASE) {
+            if (journal->erasedBlobIndex != blobIndexBeingLogged) {
+                rc = multislotEraseUpTo(journal, MULTISLOT_SLOT_ADDRESS(journal, blobIndexBeingLogged + 1));
+                if (rc <= JOURNAL_STATUS_OK) {
+                    return rc; /* an error (to be resumed by the next log() or commit()), or pending asynchronous activity. */
+                }
+            }
+        } else {
+            ARM_STORAGE_BLOCK storageBlock;
+
+            while (journal->log.amountLeftToLog) {
+                if (journal->log.amountLeftToLog < journal->info.program_unit) {
+                    /* We cannot log any smaller than info.program_unit. 'xfer'
+                     * amount of data would remain unlogged. We'll break out of this loop and report
+                     * the amount actually logged. */
+                    break;
+                }
+
+                /* check for alignment of next log offset with program_unit */
+                if ((rc = journal->mtd->GetBlock(journal->log.mtdOffset, &storageBlock)) != ARM_DRIVER_OK) {
+                    return JOURNAL_STATUS_STORAGE_API_ERROR;
+                }
+                if ((journal->log.mtdOffset - storageBlock.addr) % journal->info.program_unit) {
+                    return JOURNAL_STATUS_ERROR; /* Program offset doesn't align with info.program_unit. This would result in an IO error if attempted. */
+                }
+
+                uint32_t xfer = journal->log.amountLeftToLog;
+                xfer -= xfer % journal->info.program_unit; /* align transfer-size with program_unit. */
+
+                /* perform the IO */
+                rc = journal->mtd->ProgramData(journal->log.mtdOffset, journal->log.dataBeingLogged, xfer);
+                if (rc < ARM_DRIVER_OK) {
+                    if ((journal->state == MULTISLOT_JOURNAL_STATE_LOGGING_BODY) && (journal->log.dataBeingLogged != journal->log.blob)) {
+                        /* report the data logged before the failure; the
+                         * remainder is resubmitted by the next log(). */
+                        return (journal->log.dataBeingLogged - journal->log.blob);
+                    }
+                    return mapStorageError(rc);
+                }
+                if ((journal->mtdCapabilities.asynchronous_ops) && (rc == ARM_DRIVER_OK)) {
+                    return JOURNAL_STATUS_OK; /* we've got pending asynchronous activity. */
+                }
+
+                /* synchronous completion. 'rc' contains the actual number of bytes transferred. */
+                multislotProgramDone(journal, rc);
+            } /* while (journal->log.amountLeftToLog) */
+        }
+
+        /* state transition */
+        switch (journal->state) {
+            case MULTISLOT_JOURNAL_STATE_LOGGING_ERASE:
+                journal->erasedBlobIndex         = journal->numSlots; /* the slot is about to be programmed. */
+                journal->state                   = MULTISLOT_JOURNAL_STATE_LOGGING_HEAD;
+                journal->log.mtdOffset           = MULTISLOT_SLOT_ADDRESS(journal, blobIndexBeingLogged);
+                journal->log.head.version        = MULTISLOT_FLASH_JOURNAL_VERSION;
+                journal->log.head.magic          = MULTISLOT_FLASH_JOURNAL_MAGIC;
+                journal->log.head.sequenceNumber = journal->nextSequenceNumber;
+                journal->log.head.reserved       = 0;
+                journal->log.dataBeingLogged     = (const uint8_t *)&journal->log.head;
+                journal->log.amountLeftToLog     = sizeof(MultislotFlashJournalLogHead_t);
+                break;
+
+            case MULTISLOT_JOURNAL_STATE_LOGGING_HEAD: /* we've finished writing the head */
+                /* compute CRC32 on the header */
+                flashJournalCrcContextReset(&journal->crcContext);
+                flashJournalCrcContextCummulative(&journal->crcContext, (const unsigned char *)&journal->log.head, sizeof(MultislotFlashJournalLogHead_t));
+
+                /* Prepare for the tail to be written out at a later time.
+                 * This will only be done once Commit() is called. */
+                journal->log.mtdTailOffset       = MULTISLOT_SLOT_ADDRESS(journal, blobIndexBeingLogged + 1) - sizeof(MultislotFlashJournalLogTail_t);
+
+                journal->log.tail.magic          = MULTISLOT_FLASH_JOURNAL_MAGIC;
+                journal->log.tail.sequenceNumber = journal->nextSequenceNumber;
+                journal->log.tail.sizeofBlob     = 0; /* we'll update this as we complete our writes. */
+                journal->log.tail.crc32          = 0;
+
+                if (journal->prevCommand == FLASH_JOURNAL_OPCODE_COMMIT) {
+                    /* This branch is taken only when commit() is called without any preceding log() operations. */
+                    journal->log.tail.crc32      = flashJournalCrcContextCummulative(&journal->crcContext, (const unsigned char *)&journal->log.tail, sizeof(MultislotFlashJournalLogTail_t));
+
+                    journal->state               = MULTISLOT_JOURNAL_STATE_LOGGING_TAIL;
+                    journal->log.dataBeingLogged = (const uint8_t *)&journal->log.tail;
+                    journal->log.amountLeftToLog = sizeof(MultislotFlashJournalLogTail_t);
+                    journal->log.mtdOffset       = journal->log.mtdTailOffset;
+                } else {
+                    journal->state               = MULTISLOT_JOURNAL_STATE_LOGGING_BODY;
+                    journal->log.dataBeingLogged = journal->log.blob;
+                    journal->log.amountLeftToLog = journal->log.sizeofBlob;
+                }
+                break;
+
+            case MULTISLOT_JOURNAL_STATE_LOGGING_BODY:
+                if (journal->log.dataBeingLogged == journal->log.blob) {
+                    return JOURNAL_STATUS_SMALL_LOG_REQUEST;
+                }
+                return (journal->log.dataBeingLogged - journal->log.blob);
+
+            case MULTISLOT_JOURNAL_STATE_LOGGING_TAIL:
+                journal->info.sizeofJournaledBlob = journal->log.tail.sizeofBlob;
+                journal->currentBlobIndex         = blobIndexBeingLogged;
+
+                /* increment next sequence number */
+                ++journal->nextSequenceNumber;
+                if (journal->nextSequenceNumber == MULTISLOT_FLASH_JOURNAL_INVALD_NEXT_SEQUENCE_NUMBER) {
+                    ++journal->nextSequenceNumber;
+                }
+
+                /* The blob is sealed; start erasing the slot which takes the
+                 * next blob. An asynchronous MTD erases it in the background. A
+                 * failed erase is simply redone by the next log(). */
+                journal->state              = MULTISLOT_JOURNAL_STATE_PRE_ERASING;
+                journal->log.mtdEraseOffset = MULTISLOT_SLOT_ADDRESS(journal, multislotNextBlobIndex(journal));
+                (void)flashJournalStrategyMultislot_preErase_progress();
+
+                return 1; /* commit returns 1 upon completion. */
+
+            default:
+                journal->state = MULTISLOT_JOURNAL_STATE_INITIALIZED;
+                return JOURNAL_STATUS_ERROR;
+        }
+    }
+}
+
+void multislotMtdHandler(int32_t status, ARM_STORAGE_OPERATION operation)
+{
+    int32_t rc;
+    MultislotFlashJournal_t *journal = multislotActiveJournal;
+    FlashJournal_OpCode_t logOpCode  = (journal->prevCommand == FLASH_JOURNAL_OPCODE_COMMIT) ?
+                                           FLASH_JOURNAL_OPCODE_COMMIT : FLASH_JOURNAL_OPCODE_LOG_BLOB;
+
+    if (status < ARM_DRIVER_OK) {
+        /* Map integrity failures reported by the Storage driver appropriately. */
+        status = mapStorageError(status);
+
+        switch (journal->state) {
+            case MULTISLOT_JOURNAL_STATE_NOT_INITIALIZED:
+            case MULTISLOT_JOURNAL_STATE_INIT_SCANNING_LOG_HEADERS:
+                if (journal->callback) {
+                    journal->callback(status, FLASH_JOURNAL_OPCODE_INITIALIZE);
+                }
+                break;
+
+            case MULTISLOT_JOURNAL_STATE_RESETING:
+                journal->state           = MULTISLOT_JOURNAL_STATE_INITIALIZED; /* reset state */
+                journal->erasedBlobIndex = journal->numSlots;
+                if (journal->callback) {
+                    journal->callback(status, FLASH_JOURNAL_OPCODE_RESET);
+                }
+                break;
+
+            case MULTISLOT_JOURNAL_STATE_PRE_ERASING: {
+                /* the commit has already been reported; only a pending log() is told about the outcome. */
+                bool logPending = journal->logPending;
+                if (((rc = multislotPreEraseDone(journal, status)) != JOURNAL_STATUS_OK) && logPending && journal->callback) {
+                    journal->callback(rc, FLASH_JOURNAL_OPCODE_LOG_BLOB);
+                }
+                break;
+            }
+
+            case MULTISLOT_JOURNAL_STATE_INITIALIZED:
+            case MULTISLOT_JOURNAL_STATE_LOGGING_ERASE:
+            case MULTISLOT_JOURNAL_STATE_LOGGING_HEAD:
+            case MULTISLOT_JOURNAL_STATE_LOGGING_BODY:
+            case MULTISLOT_JOURNAL_STATE_LOGGING_TAIL:
+                /* the state is kept so that the next log() or commit() resumes the failed step. */
+                if (journal->callback) {
+                    journal->callback(status, logOpCode);
+                }
+                break;
+
+            case MULTISLOT_JOURNAL_STATE_READING:
+                /* reset journal state to allow further operation. */
+                journal->state = MULTISLOT_JOURNAL_STATE_INITIALIZED;
+
+                if (journal->callback) {
+                    journal->callback(status, FLASH_JOURNAL_OPCODE_READ_BLOB);
+                }
+                break;
+        }
+
+        return;
+    }
+
+    switch (operation) {
+        case ARM_STORAGE_OPERATION_INITIALIZE:
+            if (journal->callback) {
+                journal->callback(JOURNAL_STATUS_OK, FLASH_JOURNAL_OPCODE_INITIALIZE);
+            }
+            break;
+
+        case ARM_STORAGE_OPERATION_ERASE_ALL:
+            if (journal->state == MULTISLOT_JOURNAL_STATE_RESETING) {
+                multislotResetDone(journal);
+                if (journal->callback) {
+                    journal->callback(JOURNAL_STATUS_OK, FLASH_JOURNAL_OPCODE_RESET);
+                }
+            }
+            break;
+
+        case ARM_STORAGE_OPERATION_ERASE:
+            if (journal->state == MULTISLOT_JOURNAL_STATE_LOGGING_ERASE) {
+                if (status <= ARM_DRIVER_OK) {
+                    if (journal->callback) {
+                        journal->callback(JOURNAL_STATUS_STORAGE_API_ERROR, logOpCode);
+                    }
+                    return;
+                }
+
+                journal->log.mtdEraseOffset += status;
+
+                if ((rc = flashJournalStrategyMultislot_log_progress()) != JOURNAL_STATUS_OK) {
+                    if (journal->callback) {
+                        journal->callback(rc, logOpCode);
+                    }
+                    return;
+                }
+            } else if (journal->state == MULTISLOT_JOURNAL_STATE_PRE_ERASING) {
+                bool logPending = journal->logPending;
+
+                if (status <= ARM_DRIVER_OK) {
+                    rc = multislotPreEraseDone(journal, JOURNAL_STATUS_STORAGE_API_ERROR);
+                } else {
+                    journal->log.mtdEraseOffset += status;
+                    rc = flashJournalStrategyMultislot_preErase_progress();
+                }
+                if (logPending && (rc != JOURNAL_STATUS_OK) && journal->callback) {
+                    journal->callback(rc, FLASH_JOURNAL_OPCODE_LOG_BLOB);
+                }
+            } else if (journal->state == MULTISLOT_JOURNAL_STATE_RESETING) {
+                multislotResetDone(journal);
+                if (journal->callback) {
+                    journal->callback(JOURNAL_STATUS_OK, FLASH_JOURNAL_OPCODE_RESET);
+                }
+            }
+            break;
+
+        case ARM_STORAGE_OPERATION_PROGRAM_DATA:
+            multislotProgramDone(journal, status);
+
+            if ((rc = flashJournalStrategyMultislot_log_progress()) == JOURNAL_STATUS_OK) {
+                return; /* we've got pending asynchronous activity */
+            }
+            if (journal->callback) {
+                journal->callback(rc, logOpCode);
+            }
+            break;
+
+        case ARM_STORAGE_OPERATION_READ_DATA:
+            if (journal->state == MULTISLOT_JOURNAL_STATE_READING) {
+                journal->read.mtdOffset        += status;
+                journal->read.amountLeftToRead -= status;
+                journal->read.dataBeingRead    += status;
+                journal->read.logicalOffset    += status;
+
+                if ((rc = flashJournalStrategyMultislot_read_progress()) == JOURNAL_STATUS_OK) {
+                    return; /* we've got pending asynchronous activity */
+                }
+                if (journal->callback) {
+                    journal->callback(rc, FLASH_JOURNAL_OPCODE_READ_BLOB);
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2006-2016, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __FLASH_JOURNAL_MULTISLOT_STRATEGY_SUPPORT_FUNCTIONS_H__
+#define __FLASH_JOURNAL_MULTISLOT_STRATEGY_SUPPORT_FUNCTIONS_H__
+
+#include "flash-journal-strategy-multislot/flash_journal_multislot_private.h"
+#include "flash-journal-strategy-multislot/flash_journal_strategy_multislot.h"
+#include "flash-journal-strategy-sequential/support_funcs.h" /* the format machine and the slot helpers */
+
+extern MultislotFlashJournal_t *multislotActiveJournal;
+
+/**
+ * Check the sanity of a given slot
+ * @param       journal
+ * @param       slotOffset
+ * @param [out] headSequenceNumberP
+ *                  sequence number of the slot as read from the header.
+ * @param [out] tailP
+ *                  the tail of the slot
+ * @return 1 if the slot is valid; i.e. if head and tail match, and if CRC32 agrees.
+ */
+int32_t multislotSlotIsSane(MultislotFlashJournal_t        *journal,
+                            uint64_t                        slotOffset,
+                            uint32_t                       *headSequenceNumberP,
+                            MultislotFlashJournalLogTail_t *tailP);
+
+int32_t setupMultislotJournalHeader(MultislotFlashJournalHeader_t *headerP, ARM_DRIVER_STORAGE *mtd, uint64_t totalSize, uint32_t numSlots);
+int32_t multislotDiscoverLatestLoggedBlob(MultislotFlashJournal_t *journal);
+
+/**
+ * Progress the state machine for the 'log' and 'commit' operations. This
+ * method can also be called from an interrupt handler. A failure leaves the
+ * state in place, so that the next log() or commit() resumes the step which
+ * failed. The completion of a commit starts the pre-erase of the next slot.
+ * @return  < JOURNAL_STATUS_OK for error
+ *          = JOURNAL_STATUS_OK to signal pending asynchronous activity
+ *          > JOURNAL_STATUS_OK for completion
+ */
+int32_t flashJournalStrategyMultislot_log_progress(void);
+
+/**
+ * Progress the erase of the slot following the most recent blob. This method
+ * can also be called from an interrupt handler.
+ * @return  < JOURNAL_STATUS_OK for error; the slot is then erased by the next log()
+ *          = JOURNAL_STATUS_OK to signal pending asynchronous activity
+ *          > JOURNAL_STATUS_OK for completion
+ */
+int32_t flashJournalStrategyMultislot_preErase_progress(void);
+
+int32_t flashJournalStrategyMultislot_reset_progress(void);
+int32_t flashJournalStrategyMultislot_read_progress(void);
+
+void    multislotMtdHandler(int32_t status, ARM_STORAGE_OPERATION operation);
+
+#endif /*__FLASH_JOURNAL_MULTISLOT_STRATEGY_SUPPORT_FUNCTIONS_H__*/
@@ -24,6 +24,22 @@ extern "C" {
 
 typedef uint32_t  flash_journal_crc32_t;
 
+/*
+ * The running state of one CRC computation. Computations which keep their
+ * own context can be interleaved, e.g. between a journal's completion
+ * callbacks and a caller in thread context.
+ */
+typedef struct FlashJournalCrcContext_t {
+    flash_journal_crc32_t remainder;
+} FlashJournalCrcContext_t;
+
+void flashJournalCrcContextReset(FlashJournalCrcContext_t *context);
+flash_journal_crc32_t flashJournalCrcContextCummulative(FlashJournalCrcContext_t *context, unsigned char const message[], int nBytes);
+
+/*
+ * The same computation on a single context shared by all callers; not
+ * reentrant.
+ */
 void flashJournalCrcReset(void);
 flash_journal_crc32_t flashJournalCrcCummulative(unsigned char const message[], int nBytes);
 
@@ -23,6 +23,7 @@ extern "C" {
 #endif // __cplusplus
 
 #include "flash-journal/flash_journal.h"
+#include "flash-journal-strategy-sequential/flash_journal_crc.h"
 
 static inline uint32_t roundUp_uint32(uint32_t N, uint32_t BOUNDARY) {
     return ((((N) + (BOUNDARY) - 1) / (BOUNDARY)) * (BOUNDARY));
@@ -97,6 +98,18 @@ typedef struct _SequentialFlashJournalLogTail {
 
 #define SEQUENTIAL_JOURNAL_VALID_TAIL(TAIL_PTR) ((TAIL_PTR)->magic == SEQUENTIAL_FLASH_JOURNAL_MAGIC)
 
+/**
+ * State relevant to the read-back of data from a slot.
+ */
+typedef struct _SequentialFlashJournalReadState {
+    const uint8_t *blob;               /**< the original buffer holding source data. */
+    size_t         sizeofBlob;
+    uint64_t       mtdOffset;          /**< the current Storage offset from which data is being read. */
+    uint8_t       *dataBeingRead;      /**< temporary pointer aimed at the next data to be read-into. */
+    size_t         amountLeftToRead;
+    size_t         logicalOffset;      /**< the logical offset within the blob at which the next read will occur. */
+} SequentialFlashJournalReadState_t;
+
 typedef struct _SequentialFlashJournal_t {
     FlashJournal_Ops_t             ops;                /**< the mandatory OPS table defining the strategy. */
     FlashJournal_Callback_t        callback;           /**< command completion callback. */
@@ -111,6 +124,7 @@ typedef struct _SequentialFlashJournal_t {
     uint32_t                       currentBlobIndex;   /**< index of the most recently written blob. */
     SequentialFlashJournalState_t  state;              /**< state of the journal. SEQUENTIAL_JOURNAL_STATE_INITIALIZED being the default. */
     FlashJournal_OpCode_t          prevCommand;        /**< the last command issued to the journal. */
+    FlashJournalCrcContext_t       crcContext;         /**< CRC32 of the slot being logged, accumulated across the steps of log() and commit(). */
 
     /**
      * The following is a union of sub-structures meant to keep state relevant
@@ -148,14 +162,7 @@ typedef struct _SequentialFlashJournal_t {
         } log;
 
         /** state relevant to read-back of data. */
-        struct {
-            const uint8_t *blob;               /**< the original buffer holding source data. */
-            size_t         sizeofBlob;
-            uint64_t       mtdOffset;          /**< the current Storage offset from which data is being read. */
-            uint8_t       *dataBeingRead;      /**< temporary pointer aimed at the next data to be read-into. */
-            size_t         amountLeftToRead;
-            size_t         logicalOffset;      /**< the logical offset within the blob at which the next read will occur. */
-        } read;
+        SequentialFlashJournalReadState_t read;
     };
 } SequentialFlashJournal_t;
 
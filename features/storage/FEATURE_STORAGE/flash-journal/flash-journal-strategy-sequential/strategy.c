@@ -88,34 +88,18 @@ int32_t flashJournalStrategySequential_format(ARM_DRIVER_STORAGE      *mtd,
  */
 int32_t readAndVerifyJournalHeader(SequentialFlashJournal_t *journal, SequentialFlashJournalHeader_t *headerP)
 {
-    if (headerP == NULL) {
-        return JOURNAL_STATUS_PARAMETER;
-    }
-
-    int32_t rc = journal->mtd->ReadData(journal->mtdStartOffset, headerP, sizeof(SequentialFlashJournalHeader_t));
-    if (rc < ARM_DRIVER_OK) {
-        return JOURNAL_STATUS_STORAGE_IO_ERROR;
-    } else if (rc == ARM_DRIVER_OK) {
-        ARM_STORAGE_CAPABILITIES mtdCaps = journal->mtd->GetCapabilities();
-        if (!mtdCaps.asynchronous_ops) {
-            return JOURNAL_STATUS_ERROR; /* asynchronous_ops must be set if MTD returns ARM_DRIVER_OK. */
-        }
-
-        return JOURNAL_STATUS_ERROR; /* TODO: handle init with pending asynchronous activity. */
-    }
-
-    if ((headerP->genericHeader.magic        != FLASH_JOURNAL_HEADER_MAGIC)             ||
-        (headerP->genericHeader.version      != FLASH_JOURNAL_HEADER_VERSION)           ||
-        (headerP->genericHeader.sizeofHeader != sizeof(SequentialFlashJournalHeader_t)) ||
-        (headerP->magic                      != SEQUENTIAL_FLASH_JOURNAL_HEADER_MAGIC)  ||
-        (headerP->version                    != SEQUENTIAL_FLASH_JOURNAL_HEADER_VERSION)) {
-        return JOURNAL_STATUS_NOT_FORMATTED;
+    int32_t rc;
+    if ((rc = readSlotJournalHeader(journal->mtd, journal->mtdStartOffset,
+                                    SEQUENTIAL_FLASH_JOURNAL_HEADER_MAGIC, SEQUENTIAL_FLASH_JOURNAL_HEADER_VERSION,
+                                    headerP)) != JOURNAL_STATUS_OK) {
+        return rc;
     }
 
     uint32_t expectedCRC = headerP->genericHeader.checksum;
     headerP->genericHeader.checksum = 0;
-    flashJournalCrcReset();
-    uint32_t computedCRC = flashJournalCrcCummulative((const unsigned char *)&headerP->genericHeader, sizeof(SequentialFlashJournalLogHead_t));
+    FlashJournalCrcContext_t crcContext;
+    flashJournalCrcContextReset(&crcContext);
+    uint32_t computedCRC = flashJournalCrcContextCummulative(&crcContext, (const unsigned char *)&headerP->genericHeader, sizeof(SequentialFlashJournalLogHead_t));
     if (computedCRC != expectedCRC) {
         //printf("readAndVerifyJournalHeader: checksum mismatch during header verification: expected = %u, computed = %u\n", (unsigned int) expectedCRC, (unsigned int) computedCRC);
         return JOURNAL_STATUS_METADATA_ERROR;
@@ -132,18 +116,11 @@ int32_t flashJournalStrategySequential_initialize(FlashJournal_t           *_jou
     int32_t rc;
 
     /* initialize MTD */
-    rc = mtd->Initialize(mtdHandler);
-    if (rc < ARM_DRIVER_OK) {
-        memset(_journal, 0, sizeof(FlashJournal_t));
-        return JOURNAL_STATUS_STORAGE_API_ERROR;
-    }
-    if (rc == ARM_DRIVER_OK) {
-        ARM_STORAGE_CAPABILITIES mtdCaps = mtd->GetCapabilities();
-        if (!mtdCaps.asynchronous_ops) {
-            return JOURNAL_STATUS_ERROR; /* asynchronous_ops must be set if MTD returns ARM_DRIVER_OK. */
+    if ((rc = mtdInitialize(mtd, mtdHandler)) != JOURNAL_STATUS_OK) {
+        if (rc == JOURNAL_STATUS_STORAGE_API_ERROR) {
+            memset(_journal, 0, sizeof(FlashJournal_t));
         }
-
-        return JOURNAL_STATUS_ERROR; /* TODO: handle init with pending asynchronous activity. */
+        return rc;
     }
 
     SequentialFlashJournal_t *journal;
@@ -324,8 +301,7 @@ int32_t flashJournalStrategySequential_commit(FlashJournal_t *_journal)
 
     if (journal->prevCommand == FLASH_JOURNAL_OPCODE_LOG_BLOB) {
         /* the tail has already been setup during previous calls to log(); we can now include it in the crc32. */
-        journal->log.tail.crc32 = flashJournalCrcCummulative((const unsigned char *)&journal->log.tail, sizeof(SequentialFlashJournalLogTail_t));
-        flashJournalCrcReset();
+        journal->log.tail.crc32 = flashJournalCrcContextCummulative(&journal->crcContext, (const unsigned char *)&journal->log.tail, sizeof(SequentialFlashJournalLogTail_t));
 
         journal->log.mtdOffset       = journal->log.mtdTailOffset;
         journal->log.dataBeingLogged = (const uint8_t *)&journal->log.tail;
@@ -377,33 +353,7 @@ int32_t flashJournalStrategySequential_format_sanityChecks(ARM_DRIVER_STORAGE *m
         return JOURNAL_STATUS_PARAMETER;
     }
 
-    ARM_STORAGE_INFO mtdInfo;
-    if (mtd->GetInfo(&mtdInfo) < ARM_DRIVER_OK) {
-        return JOURNAL_STATUS_STORAGE_API_ERROR;
-    }
-    if (mtdInfo.total_storage == 0) {
-        return JOURNAL_STATUS_STORAGE_API_ERROR;
-    }
-
-    uint64_t mtdAddr;
-    if (mtdGetStartAddr(mtd, &mtdAddr) < JOURNAL_STATUS_OK) {
-        return JOURNAL_STATUS_STORAGE_API_ERROR;
-    }
-    if (mtd->GetBlock(mtdAddr, NULL) < ARM_DRIVER_OK) { /* check validity of journal's start address */
-        return JOURNAL_STATUS_PARAMETER;
-    }
-    if (mtd->GetBlock(mtdAddr + mtdInfo.total_storage - 1, NULL) < ARM_DRIVER_OK) { /* check validity of the journal's end address */
-        return JOURNAL_STATUS_PARAMETER;
-    }
-
-    if ((mtdAddr % mtdInfo.program_unit) != 0) { /* ensure that the journal starts at a programmable unit */
-        return JOURNAL_STATUS_PARAMETER;
-    }
-    if ((mtdAddr % LCM_OF_ALL_ERASE_UNITS) != 0) { /* ensure that the journal starts and ends at an erase-boundary */
-        return JOURNAL_STATUS_PARAMETER;
-    }
-
-    return JOURNAL_STATUS_OK;
+    return mtdFormatSanityChecks(mtd);
 }
 
 int32_t flashJournalStrategySequential_read_sanityChecks(SequentialFlashJournal_t *journal, const void *blob, size_t sizeofBlob)
@@ -21,6 +21,8 @@
 #include <stdio.h>
 #include <inttypes.h>
 
+#define CRC_CHUNK_SIZE 64
+
 struct FormatInfo_t formatInfoSingleton;
 
 int32_t mtdGetStartAddr(ARM_DRIVER_STORAGE *mtd, uint64_t *startAddrP)
@@ -37,110 +39,172 @@ int32_t mtdGetStartAddr(ARM_DRIVER_STORAGE *mtd, uint64_t *startAddrP)
     return JOURNAL_STATUS_OK;
 }
 
-/**
- * Check the sanity of a given slot
- * @param       journal
- * @param       slotOffset
- * @param [out] headSequenceNumberP
- *                  sequence number of the slot as read from the header.
- * @param [out] tailP
- *                  the tail of the slot
- * @return 1 if the slot is valid; i.e. if head and tail match, and if CRC32 agrees.
- */
-int32_t slotIsSane(SequentialFlashJournal_t        *journal,
-                   uint64_t                         slotOffset,
-                   uint32_t                        *headSequenceNumberP,
-                   SequentialFlashJournalLogTail_t *tailP)
+int32_t mtdInitialize(ARM_DRIVER_STORAGE *mtd, ARM_Storage_Callback_t handler)
+{
+    int32_t rc = mtd->Initialize(handler);
+    if (rc < ARM_DRIVER_OK) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR;
+    }
+    if (rc == ARM_DRIVER_OK) {
+        ARM_STORAGE_CAPABILITIES mtdCaps = mtd->GetCapabilities();
+        if (!mtdCaps.asynchronous_ops) {
+            return JOURNAL_STATUS_ERROR; /* asynchronous_ops must be set if MTD returns ARM_DRIVER_OK. */
+        }
+
+        return JOURNAL_STATUS_ERROR; /* TODO: handle init with pending asynchronous activity. */
+    }
+
+    return JOURNAL_STATUS_OK;
+}
+
+int32_t mtdFormatSanityChecks(ARM_DRIVER_STORAGE *mtd)
+{
+    ARM_STORAGE_INFO mtdInfo;
+    if (mtd->GetInfo(&mtdInfo) < ARM_DRIVER_OK) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR;
+    }
+    if (mtdInfo.total_storage == 0) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR;
+    }
+
+    uint64_t mtdAddr;
+    if (mtdGetStartAddr(mtd, &mtdAddr) < JOURNAL_STATUS_OK) {
+        return JOURNAL_STATUS_STORAGE_API_ERROR;
+    }
+    if (mtd->GetBlock(mtdAddr, NULL) < ARM_DRIVER_OK) { /* check validity of journal's start address */
+        return JOURNAL_STATUS_PARAMETER;
+    }
+    if (mtd->GetBlock(mtdAddr + mtdInfo.total_storage - 1, NULL) < ARM_DRIVER_OK) { /* check validity of the journal's end address */
+        return JOURNAL_STATUS_PARAMETER;
+    }
+
+    if ((mtdAddr % mtdInfo.program_unit) != 0) { /* ensure that the journal starts at a programmable unit */
+        return JOURNAL_STATUS_PARAMETER;
+    }
+    if ((mtdAddr % LCM_OF_ALL_ERASE_UNITS) != 0) { /* ensure that the journal starts and ends at an erase-boundary */
+        return JOURNAL_STATUS_PARAMETER;
+    }
+
+    return JOURNAL_STATUS_OK;
+}
+
+int32_t checkSlot(ARM_DRIVER_STORAGE              *mtd,
+                  bool                             asynchronousOps,
+                  uint64_t                         slotOffset,
+                  uint32_t                         sizeofSlot,
+                  uint32_t                         magic,
+                  uint32_t                         version,
+                  uint32_t                        *headSequenceNumberP,
+                  SequentialFlashJournalLogTail_t *tailP)
 {
     int32_t rc;
-    ARM_DRIVER_STORAGE *mtd = journal->mtd;
 
     SequentialFlashJournalLogHead_t head;
     /* TODO: add support for asynchronous read */
     if (((rc = mtd->ReadData(slotOffset, &head, sizeof(SequentialFlashJournalLogHead_t))) < ARM_DRIVER_OK) ||
         (rc != sizeof(SequentialFlashJournalLogHead_t))) {
-        if ((rc == ARM_DRIVER_OK) && (journal->mtdCapabilities.asynchronous_ops)) {
+        if ((rc == ARM_DRIVER_OK) && asynchronousOps) {
             return JOURNAL_STATUS_UNSUPPORTED;
         }
 
         return JOURNAL_STATUS_STORAGE_IO_ERROR;
     }
 
-    /* compute the CRC32 of the header */
-    flashJournalCrcReset();
-    flashJournalCrcCummulative((const unsigned char *)&head, sizeof(SequentialFlashJournalLogHead_t));
-
-    // printf("head->version: %lu\n", journal->initScan.head.version);
-    // printf("head->magic: %lx\n", journal->initScan.head.magic);
-    // printf("head->sequenceNumber: %lu\n", journal->initScan.head.sequenceNumber);
-    // printf("head->reserved: %lu\n", journal->initScan.head.reserved);
-
-    if (SEQUENTIAL_JOURNAL_VALID_HEAD(&head)) {
-        *headSequenceNumberP = head.sequenceNumber;
-        // printf("found valid header with sequenceNumber %" PRIu32 "\n", *headSequenceNumberP);
-
-        uint64_t tailoffset = slotOffset
-                              - ((slotOffset - SLOT_ADDRESS(journal, 0)) % journal->sizeofSlot)
-                              + journal->sizeofSlot
-                              - sizeof(SequentialFlashJournalLogTail_t);
-        // printf("hoping to read a tail at offset %lu\n", (uint32_t)tailoffset);
-
-        /* TODO: add support for asynchronous read */
-        if (((rc = mtd->ReadData(tailoffset, tailP, sizeof(SequentialFlashJournalLogTail_t))) < ARM_DRIVER_OK) ||
-            (rc != sizeof(SequentialFlashJournalLogTail_t))) {
-            return JOURNAL_STATUS_STORAGE_IO_ERROR;
-        }
+    // printf("head->version: %lu\n", head.version);
+    // printf("head->magic: %lx\n", head.magic);
+    // printf("head->sequenceNumber: %lu\n", head.sequenceNumber);
+    // printf("head->reserved: %lu\n", head.reserved);
 
-        if (SEQUENTIAL_JOURNAL_VALID_TAIL(tailP) && (tailP->sequenceNumber == *headSequenceNumberP)) {
-            // printf("found valid tail\n");
-
-            /* iterate over the body of the slot computing CRC */
-            #define CRC_CHUNK_SIZE 64
-            uint8_t crcBuffer[CRC_CHUNK_SIZE];
-            uint64_t bodyIndex = 0;
-            uint64_t bodyOffset = slotOffset + sizeof(SequentialFlashJournalLogHead_t);
-            while (bodyIndex < tailP->sizeofBlob) {
-                size_t sizeofReadOperation;
-                if ((tailP->sizeofBlob - bodyIndex) > CRC_CHUNK_SIZE) {
-                    sizeofReadOperation = CRC_CHUNK_SIZE;
-                } else {
-                    sizeofReadOperation = (tailP->sizeofBlob - bodyIndex);
-                }
+    if ((head.version != version) || (head.magic != magic)) {
+        return JOURNAL_STATUS_ERROR;
+    }
+    *headSequenceNumberP = head.sequenceNumber;
+    // printf("found valid header with sequenceNumber %" PRIu32 "\n", *headSequenceNumberP);
 
-                /* TODO: add support for asynchronous read */
-                rc = mtd->ReadData(bodyOffset + bodyIndex, crcBuffer, sizeofReadOperation);
-                if (rc != (int32_t)sizeofReadOperation) {
-                    return JOURNAL_STATUS_STORAGE_IO_ERROR;
-                }
+    /* compute the CRC32 of the header */
+    FlashJournalCrcContext_t crcContext;
+    flashJournalCrcContextReset(&crcContext);
+    flashJournalCrcContextCummulative(&crcContext, (const unsigned char *)&head, sizeof(SequentialFlashJournalLogHead_t));
 
-                bodyIndex += sizeofReadOperation;
-                flashJournalCrcCummulative(crcBuffer, sizeofReadOperation);
-            }
+    uint64_t tailoffset = slotOffset + sizeofSlot - sizeof(SequentialFlashJournalLogTail_t);
+    // printf("hoping to read a tail at offset %lu\n", (uint32_t)tailoffset);
 
-            /* compute CRC32 over the tail */
-            /* extract existing CRC32 from the tail. The CRC32 field in the tail needs to contain 0 before CRC32 can be computed over it. */
-            uint32_t expectedCRC32 = tailP->crc32;
-            tailP->crc32 = 0;
+    if (((rc = mtd->ReadData(tailoffset, tailP, sizeof(SequentialFlashJournalLogTail_t))) < ARM_DRIVER_OK) ||
+        (rc != sizeof(SequentialFlashJournalLogTail_t))) {
+        return JOURNAL_STATUS_STORAGE_IO_ERROR;
+    }
 
-            uint32_t crc32 = flashJournalCrcCummulative((const unsigned char *)tailP, sizeof(SequentialFlashJournalLogTail_t));
-            flashJournalCrcReset();
-            // printf("expectedCRC32: 0x%x, computedCRC32: 0x%x\n", expectedCRC32, crc32);
-            if (crc32 == expectedCRC32) {
-                return 1;
-            }
+    /* a blob which doesn't fit between the head and the tail can't be valid. */
+    if ((tailP->magic != magic) ||
+        (tailP->sequenceNumber != *headSequenceNumberP) ||
+        (tailP->sizeofBlob > (sizeofSlot - sizeof(SequentialFlashJournalLogHead_t) - sizeof(SequentialFlashJournalLogTail_t)))) {
+        return JOURNAL_STATUS_ERROR;
+    }
+    // printf("found valid tail\n");
+
+    /* iterate over the body of the slot computing CRC */
+    uint8_t crcBuffer[CRC_CHUNK_SIZE];
+    uint64_t bodyIndex = 0;
+    uint64_t bodyOffset = slotOffset + sizeof(SequentialFlashJournalLogHead_t);
+    while (bodyIndex < tailP->sizeofBlob) {
+        size_t sizeofReadOperation;
+        if ((tailP->sizeofBlob - bodyIndex) > CRC_CHUNK_SIZE) {
+            sizeofReadOperation = CRC_CHUNK_SIZE;
+        } else {
+            sizeofReadOperation = (tailP->sizeofBlob - bodyIndex);
         }
+
+        rc = mtd->ReadData(bodyOffset + bodyIndex, crcBuffer, sizeofReadOperation);
+        if (rc != (int32_t)sizeofReadOperation) {
+            return JOURNAL_STATUS_STORAGE_IO_ERROR;
+        }
+
+        bodyIndex += sizeofReadOperation;
+        flashJournalCrcContextCummulative(&crcContext, crcBuffer, sizeofReadOperation);
     }
 
-    return JOURNAL_STATUS_ERROR;
+    /* compute CRC32 over the tail */
+    /* extract existing CRC32 from the tail. The CRC32 field in the tail needs to contain 0 before CRC32 can be computed over it. */
+    uint32_t expectedCRC32 = tailP->crc32;
+    tailP->crc32 = 0;
+
+    uint32_t crc32 = flashJournalCrcContextCummulative(&crcContext, (const unsigned char *)tailP, sizeof(SequentialFlashJournalLogTail_t));
+    // printf("expectedCRC32: 0x%x, computedCRC32: 0x%x\n", expectedCRC32, crc32);
+    if (crc32 != expectedCRC32) {
+        return JOURNAL_STATUS_ERROR;
+    }
+
+    return 1;
 }
 
-int32_t setupSequentialJournalHeader(SequentialFlashJournalHeader_t *headerP, ARM_DRIVER_STORAGE *mtd, uint64_t totalSize, uint32_t numSlots)
+int32_t slotIsSane(SequentialFlashJournal_t        *journal,
+                   uint64_t                         slotOffset,
+                   uint32_t                        *headSequenceNumberP,
+                   SequentialFlashJournalLogTail_t *tailP)
+{
+    return checkSlot(journal->mtd,
+                     journal->mtdCapabilities.asynchronous_ops,
+                     slotOffset,
+                     journal->sizeofSlot,
+                     SEQUENTIAL_FLASH_JOURNAL_MAGIC,
+                     SEQUENTIAL_FLASH_JOURNAL_VERSION,
+                     headSequenceNumberP,
+                     tailP);
+}
+
+int32_t setupSlotJournalHeader(SequentialFlashJournalHeader_t *headerP,
+                               ARM_DRIVER_STORAGE             *mtd,
+                               uint64_t                        totalSize,
+                               uint32_t                        numSlots,
+                               uint32_t                        magic,
+                               uint32_t                        version)
 {
     ARM_STORAGE_INFO mtdInfo;
     if (mtd->GetInfo(&mtdInfo) < ARM_DRIVER_OK) {
         return JOURNAL_STATUS_STORAGE_API_ERROR;
     }
 
+    memset(headerP, 0, sizeof(SequentialFlashJournalHeader_t));
     headerP->genericHeader.magic        = FLASH_JOURNAL_HEADER_MAGIC;
     headerP->genericHeader.version      = FLASH_JOURNAL_HEADER_VERSION;
     headerP->genericHeader.sizeofHeader = sizeof(SequentialFlashJournalHeader_t);
@@ -151,12 +215,12 @@ int32_t setupSequentialJournalHeader(SequentialFlashJournalHeader_t *headerP, AR
      */
     headerP->genericHeader.journalOffset = roundUp_uint32(headerP->genericHeader.sizeofHeader, LCM_OF_ALL_ERASE_UNITS);
     if ((headerP->genericHeader.journalOffset % mtdInfo.program_unit) != 0) {
-        //printf("setupSequentialJournalHeader: journalOffset is not a multiple of MTD's program_unit\r\n");
+        //printf("setupSlotJournalHeader: journalOffset is not a multiple of MTD's program_unit\r\n");
         return JOURNAL_STATUS_PARAMETER;
     }
 
-    headerP->magic    = SEQUENTIAL_FLASH_JOURNAL_HEADER_MAGIC;
-    headerP->version  = SEQUENTIAL_FLASH_JOURNAL_HEADER_VERSION;
+    headerP->magic    = magic;
+    headerP->version  = version;
     headerP->numSlots = numSlots;
 
     /* Determine 'sizeofSlot'.
@@ -165,21 +229,114 @@ int32_t setupSequentialJournalHeader(SequentialFlashJournalHeader_t *headerP, AR
     uint64_t spaceAvailableForSlots = totalSize - headerP->genericHeader.journalOffset;
     headerP->sizeofSlot = roundDown_uint32(spaceAvailableForSlots / numSlots, LCM_OF_ALL_ERASE_UNITS);
     if (headerP->sizeofSlot == 0) {
-        //printf("setupSequentialJournalHeader: not enough space to create %" PRIu32 " slots\r\n", numSlots);
+        //printf("setupSlotJournalHeader: not enough space to create %" PRIu32 " slots\r\n", numSlots);
         return JOURNAL_STATUS_PARAMETER;
     }
 
     headerP->genericHeader.totalSize = headerP->genericHeader.journalOffset + (headerP->sizeofSlot * numSlots);
-    //printf("setupSequentialJournalHeader: header size = %" PRIu32 ", journalOffset = %" PRIu32 ", sizeofSlot = %" PRIu32 ", totalSize = %lu\n", headerP->genericHeader.sizeofHeader, headerP->genericHeader.journalOffset, headerP->sizeofSlot, (uint32_t)headerP->genericHeader.totalSize);
+    //printf("setupSlotJournalHeader: header size = %" PRIu32 ", journalOffset = %" PRIu32 ", sizeofSlot = %" PRIu32 ", totalSize = %lu\n", headerP->genericHeader.sizeofHeader, headerP->genericHeader.journalOffset, headerP->sizeofSlot, (uint32_t)headerP->genericHeader.totalSize);
+
+    return JOURNAL_STATUS_OK;
+}
+
+int32_t setupSequentialJournalHeader(SequentialFlashJournalHeader_t *headerP, ARM_DRIVER_STORAGE *mtd, uint64_t totalSize, uint32_t numSlots)
+{
+    int32_t rc;
+    if ((rc = setupSlotJournalHeader(headerP, mtd, totalSize, numSlots,
+                                     SEQUENTIAL_FLASH_JOURNAL_HEADER_MAGIC, SEQUENTIAL_FLASH_JOURNAL_HEADER_VERSION)) != JOURNAL_STATUS_OK) {
+        return rc;
+    }
 
     /* compute checksum over the entire header */
     headerP->genericHeader.checksum = 0;
-    flashJournalCrcReset();
-    headerP->genericHeader.checksum = flashJournalCrcCummulative((const unsigned char *)&headerP->genericHeader, sizeof(SequentialFlashJournalLogHead_t));
+    FlashJournalCrcContext_t crcContext;
+    flashJournalCrcContextReset(&crcContext);
+    headerP->genericHeader.checksum = flashJournalCrcContextCummulative(&crcContext, (const unsigned char *)&headerP->genericHeader, sizeof(SequentialFlashJournalLogHead_t));
+
+    return JOURNAL_STATUS_OK;
+}
+
+int32_t readSlotJournalHeader(ARM_DRIVER_STORAGE             *mtd,
+                              uint64_t                        mtdStartOffset,
+                              uint32_t                        magic,
+                              uint32_t                        version,
+                              SequentialFlashJournalHeader_t *headerP)
+{
+    if (headerP == NULL) {
+        return JOURNAL_STATUS_PARAMETER;
+    }
+
+    int32_t rc = mtd->ReadData(mtdStartOffset, headerP, sizeof(SequentialFlashJournalHeader_t));
+    if (rc < ARM_DRIVER_OK) {
+        return JOURNAL_STATUS_STORAGE_IO_ERROR;
+    } else if (rc == ARM_DRIVER_OK) {
+        ARM_STORAGE_CAPABILITIES mtdCaps = mtd->GetCapabilities();
+        if (!mtdCaps.asynchronous_ops) {
+            return JOURNAL_STATUS_ERROR; /* asynchronous_ops must be set if MTD returns ARM_DRIVER_OK. */
+        }
+
+        return JOURNAL_STATUS_ERROR; /* TODO: handle init with pending asynchronous activity. */
+    }
+
+    if ((headerP->genericHeader.magic        != FLASH_JOURNAL_HEADER_MAGIC)             ||
+        (headerP->genericHeader.version      != FLASH_JOURNAL_HEADER_VERSION)           ||
+        (headerP->genericHeader.sizeofHeader != sizeof(SequentialFlashJournalHeader_t)) ||
+        (headerP->magic                      != magic)                                  ||
+        (headerP->version                    != version)) {
+        return JOURNAL_STATUS_NOT_FORMATTED;
+    }
 
     return JOURNAL_STATUS_OK;
 }
 
+int32_t readProgress(ARM_DRIVER_STORAGE *mtd, bool asynchronousOps, SequentialFlashJournalReadState_t *read)
+{
+    int32_t rc;
+    ARM_STORAGE_BLOCK storageBlock;
+    uint64_t storageBlockAvailableCapacity = 0;
+
+    if (read->amountLeftToRead) {
+        if ((rc = mtd->GetBlock(read->mtdOffset, &storageBlock)) != ARM_DRIVER_OK) {
+            return JOURNAL_STATUS_STORAGE_API_ERROR;
+        }
+        storageBlockAvailableCapacity = storageBlock.size - (read->mtdOffset - storageBlock.addr);
+    }
+
+    while (read->amountLeftToRead) {
+        while (!storageBlockAvailableCapacity) {
+            if ((rc = mtd->GetNextBlock(&storageBlock, &storageBlock)) < ARM_DRIVER_OK) {
+                return JOURNAL_STATUS_ERROR; /* We ran out of storage blocks. Journal is in an un-expected state. */
+            }
+            read->mtdOffset               = storageBlock.addr; /* This should not be necessary since we assume
+                                                                * storage map manages a contiguous address space. */
+            storageBlockAvailableCapacity = storageBlock.size;
+        }
+
+        /* compute the transfer size for this iteration. */
+        uint32_t xfer = (read->amountLeftToRead < storageBlockAvailableCapacity) ?
+                            read->amountLeftToRead : storageBlockAvailableCapacity;
+
+        /* perform the IO */
+        //printf("reading %lu bytes at offset %lu\n", xfer, (uint32_t)read->mtdOffset);
+        rc = mtd->ReadData(read->mtdOffset, read->dataBeingRead, xfer);
+        if (rc < ARM_DRIVER_OK) {
+            return JOURNAL_STATUS_STORAGE_IO_ERROR;
+        }
+        if (asynchronousOps && (rc == ARM_DRIVER_OK)) {
+            return JOURNAL_STATUS_OK; /* we've got pending asynchronous activity. */
+        } else {
+            /* synchronous completion. 'rc' contains the actual number of bytes transferred. */
+            read->mtdOffset               += rc;
+            read->amountLeftToRead        -= rc;
+            read->dataBeingRead           += rc;
+            read->logicalOffset           += rc;
+            storageBlockAvailableCapacity -= rc;
+        }
+    }
+
+    return (read->dataBeingRead - read->blob);
+}
+
 int32_t discoverLatestLoggedBlob(SequentialFlashJournal_t *journal)
 {
     /* reset top level journal metadata prior to scanning headers. */
@@ -259,11 +416,7 @@ int32_t flashJournalStrategySequential_format_progress(int32_t status, ARM_STORA
             // printf("erasing %u bytes from offset %u\n", roundUp_uint32(header.genericHeader.sizeofHeader, mtdInfo.program_unit), mtdAddr);
             rc = (formatInfoSingleton.mtd)->Erase(formatInfoSingleton.mtdAddr, sizeofErase);
             if (rc < ARM_DRIVER_OK) {
-                if (rc == ARM_STORAGE_ERROR_RUNTIME_OR_INTEGRITY_FAILURE) {
-                    return JOURNAL_STATUS_STORAGE_RUNTIME_OR_INTEGRITY_FAILURE;
-                } else {
-                    return JOURNAL_STATUS_STORAGE_IO_ERROR;
-                }
+                return mapStorageError(rc);
             } else if (rc == ARM_DRIVER_OK) {
                 return JOURNAL_STATUS_OK; /* An asynchronous operation is pending; it will result in a completion callback
                                            * where the rest of processing will take place. */
@@ -282,11 +435,7 @@ int32_t flashJournalStrategySequential_format_progress(int32_t status, ARM_STORA
             //        formatInfoSingleton.mtdAddr, roundUp_uint32(formatInfoSingleton.header.genericHeader.sizeofHeader, formatInfoSingleton.mtdProgramUnit));
             rc = (formatInfoSingleton.mtd)->ProgramData(formatInfoSingleton.mtdAddr, &(formatInfoSingleton.header), sizeofWrite);
             if (rc < ARM_DRIVER_OK) {
-                if (rc == ARM_STORAGE_ERROR_RUNTIME_OR_INTEGRITY_FAILURE) {
-                    return JOURNAL_STATUS_STORAGE_RUNTIME_OR_INTEGRITY_FAILURE;
-                } else {
-                    return JOURNAL_STATUS_STORAGE_IO_ERROR;
-                }
+                return mapStorageError(rc);
             } else if (rc == ARM_DRIVER_OK) {
                 return JOURNAL_STATUS_OK; /* An asynchronous operation is pending; it will result in a completion callback
                                            * where the rest of processing will take place. */
@@ -315,11 +464,7 @@ int32_t flashJournalStrategySequential_reset_progress(void)
 
     if ((rc = journal->mtd->Erase(SLOT_ADDRESS(journal, 0), journal->numSlots * journal->sizeofSlot)) < ARM_DRIVER_OK) {
         journal->state = SEQUENTIAL_JOURNAL_STATE_INITIALIZED; /* reset state */
-        if (rc == ARM_STORAGE_ERROR_RUNTIME_OR_INTEGRITY_FAILURE) {
-            return JOURNAL_STATUS_STORAGE_RUNTIME_OR_INTEGRITY_FAILURE;
-        } else {
-            return JOURNAL_STATUS_STORAGE_IO_ERROR;
-        }
+        return mapStorageError(rc);
     }
     if ((journal->mtdCapabilities.asynchronous_ops) && (rc == ARM_DRIVER_OK)) {
         //printf("eturning JOURNAL_STATUS_OK\n");
@@ -343,51 +488,11 @@ int32_t flashJournalStrategySequential_read_progress(void)
         return JOURNAL_STATUS_ERROR; /* journal is in an un-expected state. */
     }
 
-    int32_t rc;
-    ARM_STORAGE_BLOCK storageBlock;
-
-    if ((journal->read.amountLeftToRead) &&
-        ((rc = journal->mtd->GetBlock(journal->read.mtdOffset, &storageBlock)) != ARM_DRIVER_OK)) {
+    int32_t rc = readProgress(journal->mtd, journal->mtdCapabilities.asynchronous_ops, &journal->read);
+    if (rc != JOURNAL_STATUS_OK) {
         journal->state = SEQUENTIAL_JOURNAL_STATE_INITIALIZED; /* reset state */
-        return JOURNAL_STATUS_STORAGE_API_ERROR;
-    }
-    uint64_t storageBlockAvailableCapacity = storageBlock.size - (journal->read.mtdOffset - storageBlock.addr);
-
-    while (journal->read.amountLeftToRead) {
-        while (!storageBlockAvailableCapacity) {
-            if ((rc = journal->mtd->GetNextBlock(&storageBlock, &storageBlock)) < ARM_DRIVER_OK) {
-                journal->state = SEQUENTIAL_JOURNAL_STATE_INITIALIZED; /* reset state */
-                return JOURNAL_STATUS_ERROR; /* We ran out of storage blocks. Journal is in an un-expected state. */
-            }
-            journal->read.mtdOffset       =  storageBlock.addr; /* This should not be necessary since we assume
-                                                                 * storage map manages a contiguous address space. */
-            storageBlockAvailableCapacity = storageBlock.size;
-        }
-
-        /* compute the transfer size for this iteration. */
-        uint32_t xfer = (journal->read.amountLeftToRead < storageBlockAvailableCapacity) ?
-                            journal->read.amountLeftToRead : storageBlockAvailableCapacity;
-
-        /* perform the IO */
-        //printf("reading %lu bytes at offset %lu\n", xfer, (uint32_t)journal->read.mtdOffset);
-        rc = journal->mtd->ReadData(journal->read.mtdOffset, journal->read.dataBeingRead, xfer);
-        if (rc < ARM_DRIVER_OK) {
-            journal->state = SEQUENTIAL_JOURNAL_STATE_INITIALIZED; /* reset state */
-            return JOURNAL_STATUS_STORAGE_IO_ERROR;
-        }
-        if ((journal->mtdCapabilities.asynchronous_ops) && (rc == ARM_DRIVER_OK)) {
-            return JOURNAL_STATUS_OK; /* we've got pending asynchronous activity. */
-        } else {
-            /* synchronous completion. 'rc' contains the actual number of bytes transferred. */
-            journal->read.mtdOffset        += rc;
-            journal->read.amountLeftToRead -= rc;
-            journal->read.dataBeingRead    += rc;
-            journal->read.logicalOffset    += rc;
-        }
     }
-
-    journal->state = SEQUENTIAL_JOURNAL_STATE_INITIALIZED;
-    return (journal->read.dataBeingRead - journal->read.blob);
+    return rc;
 }
 
 /**
@@ -466,11 +571,7 @@ int32_t flashJournalStrategySequential_log_progress(void)
                 rc = journal->mtd->ProgramData(journal->log.mtdOffset, journal->log.dataBeingLogged, xfer);
                 if (rc < ARM_DRIVER_OK) {
                     journal->state = SEQUENTIAL_JOURNAL_STATE_INITIALIZED; /* reset state */
-                    if (rc == ARM_STORAGE_ERROR_RUNTIME_OR_INTEGRITY_FAILURE) {
-                        return JOURNAL_STATUS_STORAGE_RUNTIME_OR_INTEGRITY_FAILURE;
-                    } else {
-                        return JOURNAL_STATUS_STORAGE_IO_ERROR;
-                    }
+                    return mapStorageError(rc);
                 }
                 if ((journal->mtdCapabilities.asynchronous_ops) && (rc == ARM_DRIVER_OK)) {
                     return JOURNAL_STATUS_OK; /* we've got pending asynchronous activity. */
@@ -504,8 +605,8 @@ int32_t flashJournalStrategySequential_log_progress(void)
 
             case SEQUENTIAL_JOURNAL_STATE_LOGGING_HEAD: /* we've finished writing the head */
                 /* compute CRC32 on the header */
-                flashJournalCrcReset();
-                flashJournalCrcCummulative((const unsigned char *)&journal->log.head, sizeof(SequentialFlashJournalLogHead_t));
+                flashJournalCrcContextReset(&journal->crcContext);
+                flashJournalCrcContextCummulative(&journal->crcContext, (const unsigned char *)&journal->log.head, sizeof(SequentialFlashJournalLogHead_t));
 
                 /* switch to writing the body */
 
@@ -520,8 +621,7 @@ int32_t flashJournalStrategySequential_log_progress(void)
 
                 if (journal->prevCommand == FLASH_JOURNAL_OPCODE_COMMIT) {
                     /* This branch is taken only when commit() is called without any preceding log() operations. */
-                    journal->log.tail.crc32      = flashJournalCrcCummulative((const unsigned char *)&journal->log.tail, sizeof(SequentialFlashJournalLogTail_t));
-                    flashJournalCrcReset();
+                    journal->log.tail.crc32      = flashJournalCrcContextCummulative(&journal->crcContext, (const unsigned char *)&journal->log.tail, sizeof(SequentialFlashJournalLogTail_t));
 
                     journal->state               = SEQUENTIAL_JOURNAL_STATE_LOGGING_TAIL;
                     journal->log.dataBeingLogged = (const uint8_t *)&journal->log.tail;
@@ -542,7 +642,7 @@ int32_t flashJournalStrategySequential_log_progress(void)
                     return JOURNAL_STATUS_SMALL_LOG_REQUEST;
                 } else {
                     uint32_t amountOfDataLogged = (journal->log.dataBeingLogged - journal->log.blob);
-                    flashJournalCrcCummulative(journal->log.blob, amountOfDataLogged); /* compute CRC32 on logged data */
+                    flashJournalCrcContextCummulative(&journal->crcContext, journal->log.blob, amountOfDataLogged); /* compute CRC32 on logged data */
                     return amountOfDataLogged;
                 }
 
@@ -597,11 +697,7 @@ void mtdHandler(int32_t status, ARM_STORAGE_OPERATION operation)
 
     if (status < ARM_DRIVER_OK) {
         /* Map integrity failures reported by the Storage driver appropriately. */
-        if (status == ARM_STORAGE_ERROR_RUNTIME_OR_INTEGRITY_FAILURE) {
-            status = JOURNAL_STATUS_STORAGE_RUNTIME_OR_INTEGRITY_FAILURE;
-        } else {
-            status = JOURNAL_STATUS_STORAGE_IO_ERROR;
-        }
+        status = mapStorageError(status);
 
         // printf("journal mtdHandler: received error status %ld\n", status);
         switch (activeJournal->state) {
@@ -34,8 +34,86 @@ extern struct FormatInfo_t {
 
 extern SequentialFlashJournal_t *activeJournal;
 
+/*
+ * The following are shared with the multi-slot strategy, which keeps the
+ * on-storage layout of the sequential journal and differs only in the magic
+ * numbers. So are the format machine: formatInfoSingleton,
+ * flashJournalStrategySequential_format_progress() and formatHandler().
+ */
+
+/* Map an error reported by the Storage driver to the corresponding journal status. */
+static inline int32_t mapStorageError(int32_t rc)
+{
+    if (rc == ARM_STORAGE_ERROR_RUNTIME_OR_INTEGRITY_FAILURE) {
+        return JOURNAL_STATUS_STORAGE_RUNTIME_OR_INTEGRITY_FAILURE;
+    }
+    return JOURNAL_STATUS_STORAGE_IO_ERROR;
+}
+
+int32_t mtdGetStartAddr(ARM_DRIVER_STORAGE *mtd, uint64_t *startAddrP);
+
+/**
+ * Initialize the MTD for a journal.
+ * @return JOURNAL_STATUS_OK upon synchronous completion, or an error code.
+ */
+int32_t mtdInitialize(ARM_DRIVER_STORAGE *mtd, ARM_Storage_Callback_t handler);
+
+/**
+ * Check that the MTD can hold a journal; i.e. that it is addressable from
+ * start to end, and that it starts at a program-unit and an erase boundary.
+ */
+int32_t mtdFormatSanityChecks(ARM_DRIVER_STORAGE *mtd);
+
+/**
+ * Fill in a journal header for the given geometry. The checksum is left for
+ * the caller to compute.
+ */
+int32_t setupSlotJournalHeader(SequentialFlashJournalHeader_t *headerP,
+                               ARM_DRIVER_STORAGE             *mtd,
+                               uint64_t                        totalSize,
+                               uint32_t                        numSlots,
+                               uint32_t                        magic,
+                               uint32_t                        version);
+
+/**
+ * Read the journal header at the start of the MTD and check that it carries
+ * the given magic and version. The checksum is left for the caller to verify.
+ */
+int32_t readSlotJournalHeader(ARM_DRIVER_STORAGE             *mtd,
+                              uint64_t                        mtdStartOffset,
+                              uint32_t                        magic,
+                              uint32_t                        version,
+                              SequentialFlashJournalHeader_t *headerP);
+
+/**
+ * Check the sanity of the slot starting at 'slotOffset'
+ * @param       magic, version
+ *                  expected in the head and the tail of the slot.
+ * @param [out] headSequenceNumberP
+ *                  sequence number of the slot as read from the header.
+ * @param [out] tailP
+ *                  the tail of the slot
+ * @return 1 if the slot is valid; i.e. if head and tail match, and if CRC32 agrees.
+ */
+int32_t checkSlot(ARM_DRIVER_STORAGE              *mtd,
+                  bool                             asynchronousOps,
+                  uint64_t                         slotOffset,
+                  uint32_t                         sizeofSlot,
+                  uint32_t                         magic,
+                  uint32_t                         version,
+                  uint32_t                        *headSequenceNumberP,
+                  SequentialFlashJournalLogTail_t *tailP);
+
+/**
+ * Progress a read-back of data.
+ * @return  < JOURNAL_STATUS_OK for error
+ *          = JOURNAL_STATUS_OK to signal pending asynchronous activity
+ *          > JOURNAL_STATUS_OK for completion; the amount read
+ */
+int32_t readProgress(ARM_DRIVER_STORAGE *mtd, bool asynchronousOps, SequentialFlashJournalReadState_t *read);
+
 /**
- * Check the sanity of a given slot
+ * Check the sanity of a given slot of the sequential journal
  * @param       journal
  * @param       slotOffset
  * @param [out] headSequenceNumberP
@@ -49,7 +127,6 @@ int32_t slotIsSane(SequentialFlashJournal_t        *journal,
                    uint32_t                        *headSequenceNumberP,
                    SequentialFlashJournalLogTail_t *tailP);
 
-int32_t mtdGetStartAddr(ARM_DRIVER_STORAGE *mtd, uint64_t *startAddrP);
 int32_t setupSequentialJournalHeader(SequentialFlashJournalHeader_t *headerP, ARM_DRIVER_STORAGE *mtd, uint64_t totalSize, uint32_t numSlots);
 int32_t discoverLatestLoggedBlob(SequentialFlashJournal_t *journal);
 
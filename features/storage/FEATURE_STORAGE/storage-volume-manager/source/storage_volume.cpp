@@ -77,16 +77,11 @@ int32_t StorageVolume::PowerControl(ARM_POWER_STATE state)
     if (!allocated) {
         return STORAGE_VOLUME_MANAGER_STATUS_ERROR_VOLUME_NOT_ALLOCATED;
     }
-    if (volumeManager->activeVolume != NULL) {
-        return ARM_DRIVER_ERROR_BUSY;
-    }
 
-    volumeManager->activeVolume = this;
-    int32_t rc = volumeManager->getStorage()->PowerControl(state);
-    if (rc != ARM_DRIVER_OK) {
-        volumeManager->activeVolume = NULL; /* we're certain that there is no more pending asynch. activity */
-    }
-    return rc;
+    StorageVolumeRequest request;
+    setupRequest(&request, ARM_STORAGE_OPERATION_POWER_CONTROL, 0, NULL, 0);
+    request.state = state;
+    return volumeManager->submit(request);
 }
 
 int32_t StorageVolume::ReadData(uint64_t addr, void *data, uint32_t size)
@@ -95,19 +90,13 @@ int32_t StorageVolume::ReadData(uint64_t addr, void *data, uint32_t size)
     if (!allocated) {
         return STORAGE_VOLUME_MANAGER_STATUS_ERROR_VOLUME_NOT_ALLOCATED;
     }
-    if (volumeManager->activeVolume != NULL) {
-        return ARM_DRIVER_ERROR_BUSY;
-    }
     if ((size > volumeSize) || ((addr + size) > volumeSize)) {
         return ARM_DRIVER_ERROR_PARAMETER;
     }
 
-    volumeManager->activeVolume = this;
-    int32_t rc = volumeManager->getStorage()->ReadData(volumeOffset + addr, data, size);
-    if (rc != ARM_DRIVER_OK) {
-        volumeManager->activeVolume = NULL; /* we're certain that there is no more pending asynch. activity */
-    }
-    return rc;
+    StorageVolumeRequest request;
+    setupRequest(&request, ARM_STORAGE_OPERATION_READ_DATA, addr, data, size);
+    return volumeManager->submit(request);
 }
 
 int32_t StorageVolume::ProgramData(uint64_t addr, const void *data, uint32_t size)
@@ -116,19 +105,13 @@ int32_t StorageVolume::ProgramData(uint64_t addr, const void *data, uint32_t siz
     if (!allocated) {
         return STORAGE_VOLUME_MANAGER_STATUS_ERROR_VOLUME_NOT_ALLOCATED;
     }
-    if (volumeManager->activeVolume != NULL) {
-        return ARM_DRIVER_ERROR_BUSY;
-    }
     if ((size > volumeSize) || ((addr + size) > volumeSize)) {
         return ARM_DRIVER_ERROR_PARAMETER;
     }
 
-    volumeManager->activeVolume = this;
-    int32_t rc = volumeManager->getStorage()->ProgramData(volumeOffset + addr, data, size);
-    if (rc != ARM_DRIVER_OK) {
-        volumeManager->activeVolume = NULL; /* we're certain that there is no more pending asynch. activity */
-    }
-    return rc;
+    StorageVolumeRequest request;
+    setupRequest(&request, ARM_STORAGE_OPERATION_PROGRAM_DATA, addr, data, size);
+    return volumeManager->submit(request);
 }
 
 int32_t StorageVolume::Erase(uint64_t addr, uint32_t size)
@@ -137,19 +120,13 @@ int32_t StorageVolume::Erase(uint64_t addr, uint32_t size)
     if (!allocated) {
         return STORAGE_VOLUME_MANAGER_STATUS_ERROR_VOLUME_NOT_ALLOCATED;
     }
-    if (volumeManager->activeVolume != NULL) {
-        return ARM_DRIVER_ERROR_BUSY;
-    }
     if ((size > volumeSize) || ((addr + size) > volumeSize)) {
         return ARM_DRIVER_ERROR_PARAMETER;
     }
 
-    volumeManager->activeVolume = this;
-    int32_t rc = volumeManager->getStorage()->Erase(volumeOffset + addr, size);
-    if (rc != ARM_DRIVER_OK) {
-        volumeManager->activeVolume = NULL; /* we're certain that there is no more pending asynch. activity */
-    }
-    return rc;
+    StorageVolumeRequest request;
+    setupRequest(&request, ARM_STORAGE_OPERATION_ERASE, addr, NULL, size);
+    return volumeManager->submit(request);
 }
 
 int32_t StorageVolume::EraseAll(void)
@@ -158,10 +135,6 @@ int32_t StorageVolume::EraseAll(void)
     if (!allocated) {
         return STORAGE_VOLUME_MANAGER_STATUS_ERROR_VOLUME_NOT_ALLOCATED;
     }
-    if (volumeManager->activeVolume != NULL) {
-        return ARM_DRIVER_ERROR_BUSY;
-    }
-
     int32_t rc;
 
     /* Allow EraseAll() only if the volume spans the entire storage. */
@@ -177,12 +150,9 @@ int32_t StorageVolume::EraseAll(void)
         }
     }
 
-    volumeManager->activeVolume = this;
-    rc = volumeManager->getStorage()->EraseAll();
-    if (rc != ARM_DRIVER_OK) {
-        volumeManager->activeVolume = NULL; /* we're certain that there is no more pending asynch. activity */
-    }
-    return rc;
+    StorageVolumeRequest request;
+    setupRequest(&request, ARM_STORAGE_OPERATION_ERASE_ALL, 0, NULL, 0);
+    return volumeManager->submit(request);
 }
 
 ARM_STORAGE_STATUS StorageVolume::GetStatus(void)
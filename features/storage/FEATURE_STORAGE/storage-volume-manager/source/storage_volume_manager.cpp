@@ -16,6 +16,7 @@
  */
 
 #include "storage-volume-manager/storage_volume_manager.h"
+#include "critical.h"
 #include <string.h>
 #include <inttypes.h>
 
@@ -106,6 +107,8 @@ STORAGE_API_DEFINITIONS_FOR_VOLUMES(MAX_VOLUMES);
 int32_t StorageVolumeManager::initialize(ARM_DRIVER_STORAGE *mtd, InitializeCallback_t callback)
 {
     activeVolume        = NULL;
+    queueHead           = 0;
+    queueCount          = 0;
     initializeCallback  = callback;
 
     storage             = mtd;
@@ -259,9 +262,13 @@ void StorageVolumeManager::storageCallback(int32_t status, ARM_STORAGE_OPERATION
             if (volumeManager->activeVolume != NULL) {
                 /* Reset activeVolume and invoke callback. We reset activeVolume before the
                  * callback because the callback may attempt to launch another asynchronous
-                 * operation, which requires 'activeVolume' to be NULL. */
+                 * operation, which requires 'activeVolume' to be NULL. A request queued by
+                 * another volume is started first, so that the storage doesn't idle while
+                 * the callback runs; an operation launched from the callback then queues
+                 * behind it. */
                 StorageVolume *callbackVolume = volumeManager->activeVolume; /* remember the volume which will receive the callback. */
                 volumeManager->activeVolume   = NULL;
+                volumeManager->launchQueued();
 
                 if (callbackVolume->isAllocated() && callbackVolume->getCallback()) {
                     (callbackVolume->getCallback())(status, operation);
@@ -284,3 +291,91 @@ size_t StorageVolumeManager::findIndexOfUnusedVolume(void) const {
     }
     return index;
 }
+
+int32_t StorageVolumeManager::submit(const StorageVolumeRequest &request)
+{
+    core_util_critical_section_enter();
+    if ((activeVolume == request.volume) || isQueued(request.volume)) {
+        core_util_critical_section_exit();
+        return ARM_DRIVER_ERROR_BUSY;
+    }
+    if (activeVolume != NULL) {
+        /* Only an asynchronous storage can be busy with another volume's
+         * operation and later report the queued one through a callback. */
+        if (!storageCapabilities.asynchronous_ops) {
+            core_util_critical_section_exit();
+            return ARM_DRIVER_ERROR_BUSY;
+        }
+
+        queue[(queueHead + queueCount) % MAX_VOLUMES] = request;
+        queueCount++;
+        core_util_critical_section_exit();
+        tr_debug("StorageVolumeManager::submit: queued operation %u behind %" PRIu32 " others", request.operation, (uint32_t)(queueCount - 1));
+        return ARM_DRIVER_OK;
+    }
+    activeVolume = request.volume;
+    core_util_critical_section_exit();
+
+    int32_t rc = launch(request);
+    if (rc != ARM_DRIVER_OK) {
+        activeVolume = NULL; /* we're certain that there is no more pending asynch. activity */
+        launchQueued();      /* requests may have been queued meanwhile (from interrupt context) */
+    }
+    return rc;
+}
+
+int32_t StorageVolumeManager::launch(const StorageVolumeRequest &request)
+{
+    switch (request.operation) {
+        case ARM_STORAGE_OPERATION_POWER_CONTROL:
+            return storage->PowerControl(request.state);
+        case ARM_STORAGE_OPERATION_READ_DATA:
+            return storage->ReadData(request.addr, request.data, request.size);
+        case ARM_STORAGE_OPERATION_PROGRAM_DATA:
+            return storage->ProgramData(request.addr, request.data, request.size);
+        case ARM_STORAGE_OPERATION_ERASE:
+            return storage->Erase(request.addr, request.size);
+        case ARM_STORAGE_OPERATION_ERASE_ALL:
+            return storage->EraseAll();
+        default:
+            return ARM_DRIVER_ERROR;
+    }
+}
+
+bool StorageVolumeManager::isQueued(const StorageVolume *volume) const
+{
+    for (size_t i = 0; i < queueCount; i++) {
+        if (queue[(queueHead + i) % MAX_VOLUMES].volume == volume) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void StorageVolumeManager::launchQueued(void)
+{
+    while (true) {
+        core_util_critical_section_enter();
+        if ((activeVolume != NULL) || (queueCount == 0)) {
+            core_util_critical_section_exit();
+            return;
+        }
+        StorageVolumeRequest request = queue[queueHead];
+        queueHead = (queueHead + 1) % MAX_VOLUMES;
+        queueCount--;
+        activeVolume = request.volume;
+        core_util_critical_section_exit();
+
+        int32_t rc = launch(request);
+        if (rc == ARM_DRIVER_OK) {
+            return; /* the completion callback will launch the remaining requests. */
+        }
+
+        /* The submitter was told to expect a callback; deliver the synchronous
+         * completion (or the error) through it. */
+        activeVolume = NULL;
+        if (request.volume->isAllocated() && request.volume->getCallback()) {
+            (request.volume->getCallback())(rc, request.operation);
+        }
+    }
+}
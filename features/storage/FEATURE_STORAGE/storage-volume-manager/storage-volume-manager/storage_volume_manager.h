@@ -85,6 +85,21 @@ typedef enum _StorageVolumeManager_Status
 
 typedef void (*InitializeCallback_t)(int32_t status);
 class StorageVolumeManager; /* forward declaration */
+class StorageVolume;        /* forward declaration */
+
+/**
+ * An operation issued through a volume while the underlying storage is busy
+ * with the operation of another volume. The volume-manager holds it until the
+ * storage becomes available; see StorageVolumeManager::submit().
+ */
+struct StorageVolumeRequest {
+    StorageVolume         *volume;
+    ARM_STORAGE_OPERATION  operation;
+    uint64_t               addr;  /**< address on the underlying storage. */
+    void                  *data;
+    uint32_t               size;
+    ARM_POWER_STATE        state; /**< for ARM_STORAGE_OPERATION_POWER_CONTROL. */
+};
 
 class StorageVolume {
 public:
@@ -136,6 +151,15 @@ public:
     }
 
 private:
+    void setupRequest(StorageVolumeRequest *requestP, ARM_STORAGE_OPERATION operation, uint64_t addr, const void *data, uint32_t size) {
+        requestP->volume    = this;
+        requestP->operation = operation;
+        requestP->addr      = volumeOffset + addr;
+        requestP->data      = const_cast<void *>(data);
+        requestP->size      = size;
+        requestP->state     = ARM_POWER_FULL;
+    }
+
     bool overlapsWithBlock(const ARM_STORAGE_BLOCK* blockP) const {
         return (((blockP->addr + blockP->size) <= volumeOffset) || ((volumeOffset + volumeSize) <= blockP->addr)) ? false : true;
     }
@@ -253,12 +277,39 @@ private:
 private:
     size_t findIndexOfUnusedVolume(void) const;
 
+    /**
+     * Issue an operation of a volume to the underlying storage. A volume may
+     * have a single operation outstanding; further ones fail with
+     * ARM_DRIVER_ERROR_BUSY. If the asynchronous storage is busy with the
+     * operation of another volume, the request is queued and ARM_DRIVER_OK is
+     * returned; the volume's callback then follows its completion as usual.
+     * Queued requests are started in the order of submission, each as soon as
+     * the previous operation completes.
+     *
+     * @return the return value of the storage operation, ARM_DRIVER_OK for a
+     *     queued request, or ARM_DRIVER_ERROR_BUSY.
+     */
+    int32_t submit(const StorageVolumeRequest &request);
+    int32_t launch(const StorageVolumeRequest &request);
+    bool    isQueued(const StorageVolume *volume) const;
+
+    /**
+     * Start the queued requests, until one of them leaves the storage busy.
+     * Requests which complete (or fail) without asynchronous activity are
+     * reported through the callbacks of their volumes.
+     */
+    void    launchQueued(void);
+
 private:
     bool                      initialized;
     ARM_DRIVER_STORAGE       *storage;
     ARM_STORAGE_INFO          storageInfo;
     ARM_STORAGE_CAPABILITIES  storageCapabilities;
     StorageVolume             volumes[MAX_VOLUMES];
+
+    StorageVolumeRequest      queue[MAX_VOLUMES];   /**< FIFO of requests waiting for the storage; at most one per volume. */
+    size_t                    queueHead;
+    size_t                    queueCount;
 };
 
 #endif /* __STORAGE_VOLUME_MANAGER_H__ */
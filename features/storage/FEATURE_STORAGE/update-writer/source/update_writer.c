@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "update-writer/update_writer.h"
+#include "critical.h"
+#include <string.h>
+
+/**
+ * The writer completions of the MTD are for; the Storage callback carries no
+ * context of its own.
+ */
+static UpdateWriter_t *activeWriter;
+
+static void updateWriterMtdHandler(int32_t status, ARM_STORAGE_OPERATION operation);
+
+static inline int32_t mapStorageError(int32_t rc)
+{
+    if (rc == ARM_STORAGE_ERROR_RUNTIME_OR_INTEGRITY_FAILURE) {
+        return UPDATE_WRITER_STATUS_STORAGE_RUNTIME_OR_INTEGRITY_FAILURE;
+    }
+    return UPDATE_WRITER_STATUS_STORAGE_IO_ERROR;
+}
+
+static inline uint8_t *fillBuffer(UpdateWriter_t *writer)
+{
+    return (uint8_t *)writer->buffers[writer->fillIndex];
+}
+
+static inline uint8_t *programBuffer(UpdateWriter_t *writer)
+{
+    return (uint8_t *)writer->buffers[writer->fillIndex ^ 1];
+}
+
+/**
+ * Become the context progressing the state machine. When some other context
+ * is at it already (an interrupted thread, or the caller of a callback
+ * which calls back into the writer), that context is asked to go round once
+ * more instead.
+ *
+ * @return 1 if the caller is to progress the state machine, through
+ *     updateWriterLeave().
+ */
+static int updateWriterEnter(UpdateWriter_t *writer)
+{
+    int entered;
+
+    core_util_critical_section_enter();
+    entered = !writer->running;
+    if (entered) {
+        writer->running = 1;
+    } else {
+        writer->runAgain = 1;
+    }
+    core_util_critical_section_exit();
+
+    return entered;
+}
+
+static void updateWriterNotify(UpdateWriter_t *writer, int32_t status, UpdateWriter_OpCode_t opcode)
+{
+    if (writer->callback) {
+        writer->callback(status, opcode);
+    }
+}
+
+static void updateWriterFail(UpdateWriter_t *writer, int32_t status)
+{
+    int notify;
+
+    writer->status  = status;
+    writer->blocked = 0;
+
+    if (writer->mtdOperation == ARM_STORAGE_OPERATION_INITIALIZE) {
+        notify = writer->notifyInitialize;
+        writer->notifyInitialize = 0;
+        if (notify) {
+            updateWriterNotify(writer, status, UPDATE_WRITER_OPCODE_INITIALIZE);
+        }
+    } else if (writer->state == UPDATE_WRITER_STATE_FINALIZING) {
+        /* until finalize() has returned, it reports the error itself */
+        core_util_critical_section_enter();
+        notify = writer->notifyFinalize;
+        core_util_critical_section_exit();
+        if (notify) {
+            updateWriterNotify(writer, status, UPDATE_WRITER_OPCODE_FINALIZE);
+        }
+    } else if (writer->state == UPDATE_WRITER_STATE_WRITING) {
+        updateWriterNotify(writer, status, UPDATE_WRITER_OPCODE_WRITE);
+    }
+}
+
+/**
+ * Account for the completion of the last operation started on the MTD.
+ */
+static void updateWriterCompleted(UpdateWriter_t *writer, int32_t rc)
+{
+    if (rc < ARM_DRIVER_OK) {
+        updateWriterFail(writer, mapStorageError(rc));
+        return;
+    }
+
+    switch (writer->mtdOperation) {
+        case ARM_STORAGE_OPERATION_INITIALIZE:
+            if (writer->notifyInitialize) {
+                writer->notifyInitialize = 0;
+                updateWriterNotify(writer, UPDATE_WRITER_STATUS_OK, UPDATE_WRITER_OPCODE_INITIALIZE);
+            }
+            break;
+
+        case ARM_STORAGE_OPERATION_ERASE:
+            writer->erasedAddr += writer->mtdSize;
+            break;
+
+        case ARM_STORAGE_OPERATION_PROGRAM_DATA:
+            writer->programAddr += writer->programSize;
+            writer->programSize  = 0;
+            if (writer->blocked) {
+                /* the buffer just programmed takes the rest of the data */
+                writer->blocked = 0;
+                updateWriterNotify(writer, UPDATE_WRITER_STATUS_OK, UPDATE_WRITER_OPCODE_WRITE);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * Start the next operation the image needs. Programming the buffer waiting
+ * goes first; otherwise the storage erases ahead of the programming position
+ * while the caller is filling the other buffer.
+ *
+ * @return 1 if an operation has been started, 0 if there is nothing to do.
+ */
+static int updateWriterStartNext(UpdateWriter_t *writer)
+{
+    ARM_STORAGE_BLOCK block;
+    int32_t rc;
+
+    if (writer->programSize == 0 &&
+        ((writer->fillSize == UPDATE_WRITER_BUFFER_SIZE) ||
+         (writer->state == UPDATE_WRITER_STATE_FINALIZING && writer->fillSize != 0))) {
+        writer->programSize = writer->fillSize;
+        writer->fillIndex  ^= 1;
+        writer->fillSize    = 0;
+    }
+
+    if ((writer->programSize != 0) && (writer->programAddr + writer->programSize <= writer->erasedAddr)) {
+        writer->mtdOperation = ARM_STORAGE_OPERATION_PROGRAM_DATA;
+        writer->mtdSize      = writer->programSize;
+        writer->mtdBusy      = 1; /* before starting, the completion might come in before the return */
+        rc = writer->mtd->ProgramData(writer->programAddr, programBuffer(writer), writer->programSize);
+    } else if ((writer->erasedAddr < writer->endAddr) &&
+               ((writer->programSize != 0) ||
+                ((writer->state == UPDATE_WRITER_STATE_WRITING) &&
+                 (writer->erasedAddr < writer->programAddr + UPDATE_WRITER_ERASE_AHEAD)))) {
+        if ((writer->mtd->GetBlock(writer->erasedAddr, &block) != ARM_DRIVER_OK) ||
+            !ARM_STORAGE_VALID_BLOCK(&block) ||
+            (block.attributes.erase_unit == 0)) {
+            updateWriterFail(writer, UPDATE_WRITER_STATUS_STORAGE_API_ERROR);
+            return 0;
+        }
+
+        writer->mtdOperation = ARM_STORAGE_OPERATION_ERASE;
+        writer->mtdSize      = block.attributes.erase_unit;
+        writer->mtdBusy      = 1;
+        rc = writer->mtd->Erase(writer->erasedAddr, writer->mtdSize);
+    } else {
+        return 0;
+    }
+
+    if (rc == ARM_DRIVER_OK) {
+        return 1; /* An asynchronous operation is pending; it will result in a completion callback. */
+    }
+    writer->mtdBusy = 0;
+    updateWriterCompleted(writer, rc);
+    return 1;
+}
+
+static void updateWriterProgress(UpdateWriter_t *writer)
+{
+    int notify;
+
+    for (;;) {
+        if (writer->mtdDone) {
+            writer->mtdDone = 0;
+            updateWriterCompleted(writer, writer->mtdStatus);
+        }
+        if ((writer->state == UPDATE_WRITER_STATE_NOT_INITIALIZED) ||
+            (writer->state == UPDATE_WRITER_STATE_FINALIZED)       ||
+            (writer->status < UPDATE_WRITER_STATUS_OK)             ||
+            writer->mtdBusy) {
+            return;
+        }
+
+        if ((writer->state == UPDATE_WRITER_STATE_FINALIZING) &&
+            (writer->programSize == 0) && (writer->fillSize == 0)) {
+            core_util_critical_section_enter();
+            writer->state = UPDATE_WRITER_STATE_FINALIZED;
+            notify = writer->notifyFinalize;
+            core_util_critical_section_exit();
+
+            if (notify) {
+                updateWriterNotify(writer, UPDATE_WRITER_STATUS_OK, UPDATE_WRITER_OPCODE_FINALIZE);
+            }
+            return;
+        }
+
+        if (!updateWriterStartNext(writer)) {
+            return;
+        }
+    }
+}
+
+/**
+ * Progress the state machine until nothing is left to do for now, then let
+ * go of it.
+ */
+static void updateWriterLeave(UpdateWriter_t *writer)
+{
+    for (;;) {
+        updateWriterProgress(writer);
+
+        core_util_critical_section_enter();
+        if (!writer->runAgain) {
+            writer->running = 0;
+            core_util_critical_section_exit();
+            return;
+        }
+        writer->runAgain = 0;
+        core_util_critical_section_exit();
+    }
+}
+
+static void updateWriterMtdHandler(int32_t status, ARM_STORAGE_OPERATION operation)
+{
+    UpdateWriter_t *writer = activeWriter;
+    (void)operation;
+
+    if ((writer == NULL) || !writer->mtdBusy) {
+        return;
+    }
+
+    writer->mtdStatus = status;
+    writer->mtdDone   = 1;
+    writer->mtdBusy   = 0;
+    if (updateWriterEnter(writer)) {
+        updateWriterLeave(writer);
+    }
+}
+
+int32_t UpdateWriter_initialize(UpdateWriter_t          *writer,
+                                ARM_DRIVER_STORAGE      *mtd,
+                                uint64_t                 addr,
+                                uint64_t                 size,
+                                UpdateWriter_Callback_t  callback)
+{
+    ARM_STORAGE_INFO  info;
+    ARM_STORAGE_BLOCK block;
+    int               erasable;
+    int32_t           rc;
+
+    if ((writer == NULL) || (mtd == NULL) || (size == 0)) {
+        return UPDATE_WRITER_STATUS_PARAMETER;
+    }
+    if ((activeWriter != NULL) &&
+        (activeWriter->mtdBusy ||
+         ((activeWriter->status >= UPDATE_WRITER_STATUS_OK) &&
+          (activeWriter->state != UPDATE_WRITER_STATE_NOT_INITIALIZED) &&
+          (activeWriter->state != UPDATE_WRITER_STATE_FINALIZED)))) {
+        return UPDATE_WRITER_STATUS_BUSY;
+    }
+
+    if (mtd->GetInfo(&info) < ARM_DRIVER_OK) {
+        return UPDATE_WRITER_STATUS_STORAGE_API_ERROR;
+    }
+    if ((info.program_unit > 1) && ((UPDATE_WRITER_BUFFER_SIZE % info.program_unit) != 0)) {
+        return UPDATE_WRITER_STATUS_PARAMETER;
+    }
+
+    /* the region must start and end on erase boundaries */
+    if ((mtd->GetBlock(addr, &block) != ARM_DRIVER_OK) || !ARM_STORAGE_VALID_BLOCK(&block)) {
+        return UPDATE_WRITER_STATUS_PARAMETER;
+    }
+    erasable = block.attributes.erasable;
+    if (erasable && ((block.attributes.erase_unit == 0) || (((addr - block.addr) % block.attributes.erase_unit) != 0))) {
+        return UPDATE_WRITER_STATUS_PARAMETER;
+    }
+    if ((mtd->GetBlock(addr + size - 1, &block) != ARM_DRIVER_OK) || !ARM_STORAGE_VALID_BLOCK(&block)) {
+        return UPDATE_WRITER_STATUS_PARAMETER;
+    }
+    if (block.attributes.erasable &&
+        ((block.attributes.erase_unit == 0) || (((addr + size - block.addr) % block.attributes.erase_unit) != 0))) {
+        return UPDATE_WRITER_STATUS_PARAMETER;
+    }
+
+    memset(writer, 0, sizeof(UpdateWriter_t));
+    writer->mtd         = mtd;
+    writer->callback    = callback;
+    writer->capacity    = size;
+    writer->endAddr     = addr + size;
+    writer->programAddr = addr;
+    writer->erasedAddr  = erasable ? addr : writer->endAddr;
+    writer->programUnit = (info.program_unit > 1) ? info.program_unit : 1;
+    writer->erasedValue = info.erased_value ? 0xFF : 0x00;
+    mbedtls_sha256_init(&writer->sha256);
+    mbedtls_sha256_starts(&writer->sha256, 0 /* SHA-256, not SHA-224 */);
+
+    writer->state            = UPDATE_WRITER_STATE_WRITING;
+    writer->mtdOperation     = ARM_STORAGE_OPERATION_INITIALIZE;
+    writer->notifyInitialize = 1;
+    writer->mtdBusy          = 1;
+    activeWriter = writer;
+
+    rc = mtd->Initialize(updateWriterMtdHandler);
+    if (rc == ARM_DRIVER_OK) {
+        return UPDATE_WRITER_STATUS_OK; /* An asynchronous operation is pending; it will result in a completion callback
+                                         * where the pre-erase starts. */
+    }
+    writer->mtdBusy          = 0;
+    writer->notifyInitialize = 0;
+    if (rc != 1) { /* synchronous completion is expected to return 1 */
+        writer->state = UPDATE_WRITER_STATE_NOT_INITIALIZED;
+        mbedtls_sha256_free(&writer->sha256);
+        activeWriter = NULL;
+        return UPDATE_WRITER_STATUS_STORAGE_API_ERROR;
+    }
+
+    /* start erasing ahead of the data */
+    if (updateWriterEnter(writer)) {
+        updateWriterLeave(writer);
+    }
+    return (writer->status < UPDATE_WRITER_STATUS_OK) ? writer->status : 1;
+}
+
+int32_t UpdateWriter_write(UpdateWriter_t *writer, const void *data, size_t size)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    size_t         accepted = 0;
+    uint32_t       chunk;
+    int            entered;
+
+    if ((writer == NULL) || ((data == NULL) && (size != 0))) {
+        return UPDATE_WRITER_STATUS_PARAMETER;
+    }
+    if (writer->state != UPDATE_WRITER_STATE_WRITING) {
+        return UPDATE_WRITER_STATUS_NOT_INITIALIZED;
+    }
+    if (writer->status < UPDATE_WRITER_STATUS_OK) {
+        return writer->status;
+    }
+    if (size > writer->capacity - writer->accepted) {
+        return UPDATE_WRITER_STATUS_BOUNDED_CAPACITY;
+    }
+    if (size > INT32_MAX) {
+        size = INT32_MAX;
+    }
+
+    /* hold the state machine while copying, so that the buffers aren't
+     * swapped under the copy by a completion */
+    entered = updateWriterEnter(writer);
+    while (accepted < size) {
+        if (writer->fillSize == UPDATE_WRITER_BUFFER_SIZE) {
+            if (writer->programSize != 0) {
+                break; /* both buffers are waiting on the storage */
+            }
+            writer->programSize = writer->fillSize;
+            writer->fillIndex  ^= 1;
+            writer->fillSize    = 0;
+        }
+
+        chunk = UPDATE_WRITER_BUFFER_SIZE - writer->fillSize;
+        if (chunk > size - accepted) {
+            chunk = size - accepted;
+        }
+        memcpy(fillBuffer(writer) + writer->fillSize, src + accepted, chunk);
+        writer->fillSize += chunk;
+        accepted         += chunk;
+    }
+
+    mbedtls_sha256_update(&writer->sha256, src, accepted);
+    writer->accepted += accepted;
+    if (accepted < size) {
+        writer->blocked = 1;
+    }
+
+    if (entered) {
+        updateWriterLeave(writer);
+    }
+    return (int32_t)accepted;
+}
+
+int32_t UpdateWriter_finalize(UpdateWriter_t *writer, uint8_t hash[UPDATE_WRITER_HASH_SIZE])
+{
+    uint32_t padding;
+    int32_t  rc;
+    int      entered;
+
+    if ((writer == NULL) || (hash == NULL)) {
+        return UPDATE_WRITER_STATUS_PARAMETER;
+    }
+    if (writer->state != UPDATE_WRITER_STATE_WRITING) {
+        return UPDATE_WRITER_STATUS_NOT_INITIALIZED;
+    }
+    if (writer->status < UPDATE_WRITER_STATUS_OK) {
+        return writer->status;
+    }
+
+    /* the data has been hashed as it came in */
+    mbedtls_sha256_finish(&writer->sha256, hash);
+    mbedtls_sha256_free(&writer->sha256);
+
+    entered = updateWriterEnter(writer);
+    padding = writer->fillSize % writer->programUnit;
+    if (padding != 0) {
+        padding = writer->programUnit - padding;
+        memset(fillBuffer(writer) + writer->fillSize, writer->erasedValue, padding);
+        writer->fillSize += padding;
+    }
+    writer->blocked = 0;
+    writer->state   = UPDATE_WRITER_STATE_FINALIZING;
+    if (entered) {
+        updateWriterLeave(writer);
+    }
+
+    /* from now on, the end of programming is reported through the callback */
+    core_util_critical_section_enter();
+    if (writer->status < UPDATE_WRITER_STATUS_OK) {
+        rc = writer->status;
+    } else if (writer->state == UPDATE_WRITER_STATE_FINALIZED) {
+        rc = 1;
+    } else {
+        writer->notifyFinalize = 1;
+        rc = UPDATE_WRITER_STATUS_OK;
+    }
+    core_util_critical_section_exit();
+
+    return rc;
+}
+
+int32_t UpdateWriter_abort(UpdateWriter_t *writer)
+{
+    int entered;
+
+    if (writer == NULL) {
+        return UPDATE_WRITER_STATUS_PARAMETER;
+    }
+    if (writer->state == UPDATE_WRITER_STATE_NOT_INITIALIZED) {
+        return UPDATE_WRITER_STATUS_NOT_INITIALIZED;
+    }
+
+    entered = updateWriterEnter(writer);
+    if (writer->state == UPDATE_WRITER_STATE_WRITING) {
+        mbedtls_sha256_free(&writer->sha256);
+    }
+    writer->state            = UPDATE_WRITER_STATE_NOT_INITIALIZED;
+    writer->blocked          = 0;
+    writer->notifyInitialize = 0;
+    writer->notifyFinalize   = 0;
+    if (entered) {
+        updateWriterLeave(writer);
+    }
+
+    return UPDATE_WRITER_STATUS_OK;
+}
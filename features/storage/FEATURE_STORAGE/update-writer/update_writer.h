@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2017, ARM Limited, All Rights Reserved
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __UPDATE_WRITER_H__
+#define __UPDATE_WRITER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "storage_abstraction/Driver_Storage.h"
+#include "mbedtls/sha256.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Size in bytes of each of the two buffers the incoming data is gathered in.
+ * It must be a multiple of the program_unit of the storage.
+ */
+#ifndef UPDATE_WRITER_BUFFER_SIZE
+#define UPDATE_WRITER_BUFFER_SIZE 1024
+#endif
+
+/**
+ * Number of bytes past the programming position kept erased ahead of the
+ * incoming data.
+ */
+#ifndef UPDATE_WRITER_ERASE_AHEAD
+#define UPDATE_WRITER_ERASE_AHEAD 8192
+#endif
+
+#define UPDATE_WRITER_HASH_SIZE 32 /**< Size of the SHA-256 digest of the image. */
+
+/**
+ * Return codes of the update-writer APIs. Positive values are returned upon
+ * synchronous completion, or by write() as the number of bytes accepted.
+ */
+typedef enum _UpdateWriter_Status
+{
+    UPDATE_WRITER_STATUS_OK                =  0,
+    UPDATE_WRITER_STATUS_ERROR             = -1, ///< Unspecified error
+    UPDATE_WRITER_STATUS_BUSY              = -2, ///< An image is being written already
+    UPDATE_WRITER_STATUS_PARAMETER         = -3, ///< Parameter error
+    UPDATE_WRITER_STATUS_NOT_INITIALIZED   = -4, ///< API call made before initialize(), or after finalize()
+    UPDATE_WRITER_STATUS_BOUNDED_CAPACITY  = -5, ///< Attempt to write past the end of the image region
+    UPDATE_WRITER_STATUS_STORAGE_API_ERROR = -6, ///< Failure from some Storage API
+    UPDATE_WRITER_STATUS_STORAGE_IO_ERROR  = -7, ///< Failure from underlying storage during an IO operation.
+    UPDATE_WRITER_STATUS_STORAGE_RUNTIME_OR_INTEGRITY_FAILURE = -8, ///< Runtime or integrity failure from underlying storage.
+} UpdateWriter_Status_t;
+
+/**
+ * Command opcodes for the update-writer. Completion callbacks use these
+ * codes to refer to the operation they report on.
+ */
+typedef enum _UpdateWriter_OpCode {
+    UPDATE_WRITER_OPCODE_INITIALIZE,
+    UPDATE_WRITER_OPCODE_WRITE,
+    UPDATE_WRITER_OPCODE_FINALIZE,
+} UpdateWriter_OpCode_t;
+
+/**
+ * Completion callback.
+ *
+ * @param status
+ *          UPDATE_WRITER_STATUS_OK, or the error which stopped the writer.
+ * @param cmd_code
+ *          The operation completing: INITIALIZE once the storage is ready,
+ *          WRITE once a write() which accepted less than it was given can be
+ *          retried, FINALIZE once the whole image is programmed. Errors of
+ *          the storage while the writer programs in the background are
+ *          reported as WRITE, or FINALIZE after finalize().
+ */
+typedef void (*UpdateWriter_Callback_t)(int32_t status, UpdateWriter_OpCode_t cmd_code);
+
+typedef enum {
+    UPDATE_WRITER_STATE_NOT_INITIALIZED,
+    UPDATE_WRITER_STATE_WRITING,
+    UPDATE_WRITER_STATE_FINALIZING,
+    UPDATE_WRITER_STATE_FINALIZED,
+} UpdateWriterState_t;
+
+/**
+ * An image being written. Callers allocate it and treat it as opaque.
+ *
+ * The incoming data is copied into one buffer while the other one is being
+ * programmed; the region ahead of the programming position is erased
+ * whenever the storage would otherwise be idle.
+ */
+typedef struct _UpdateWriter
+{
+    ARM_DRIVER_STORAGE       *mtd;
+    UpdateWriter_Callback_t   callback;
+    volatile UpdateWriterState_t state;
+    volatile int32_t          status;         /** The first error, returned by all later calls. */
+
+    uint64_t                  capacity;       /** Size of the image region. */
+    uint64_t                  endAddr;        /** End of the image region. */
+    uint64_t                  programAddr;    /** Next address to program. */
+    uint64_t                  erasedAddr;     /** End of the erased range. */
+    uint64_t                  accepted;       /** Bytes accepted by write(). */
+    uint32_t                  programUnit;
+    uint8_t                   erasedValue;
+
+    uint32_t                  buffers[2][UPDATE_WRITER_BUFFER_SIZE / sizeof(uint32_t)];
+    uint32_t                  fillIndex;      /** Buffer write() copies into. */
+    uint32_t                  fillSize;
+    uint32_t                  programSize;    /** Bytes of the other buffer left to program, 0 if it is free. */
+
+    ARM_STORAGE_OPERATION     mtdOperation;   /** The last operation started on the MTD. */
+    uint32_t                  mtdSize;
+    volatile int32_t          mtdStatus;
+    volatile uint8_t          mtdBusy;        /** An asynchronous operation is in progress. */
+    volatile uint8_t          mtdDone;        /** Its completion is yet to be accounted. */
+
+    volatile uint8_t          running;        /** The state machine is being progressed. */
+    volatile uint8_t          runAgain;       /** A completion came in while it was. */
+    uint8_t                   blocked;        /** A write() accepted less than it was given. */
+    uint8_t                   notifyInitialize;
+    uint8_t                   notifyFinalize;
+
+    mbedtls_sha256_context    sha256;
+} UpdateWriter_t;
+
+/**
+ * Start writing an image to a region of a storage device, which may be a
+ * volume of the StorageVolumeManager.
+ *
+ * The region needn't be erased beforehand: it is erased as the image comes
+ * in, ahead of the data, while the caller is still receiving it. A single
+ * image can be written at a time.
+ *
+ * @param[out] writer
+ *              A caller-supplied buffer large enough to hold the writer.
+ * @param[in] mtd
+ *              The underlying Storage driver.
+ * @param[in] addr
+ *              Start of the region, aligned to an erase unit.
+ * @param[in] size
+ *              Size of the region, ending at an erase unit boundary.
+ * @param[in] callback
+ *              Caller-defined callback invoked upon completion of operations
+ *              which the storage executes asynchronously.
+ *
+ * @return UPDATE_WRITER_STATUS_OK if the storage is initializing in the
+ *         background; the callback follows with INITIALIZE, although write()
+ *         may be called right away. 1 upon synchronous completion, or an
+ *         error code.
+ */
+int32_t UpdateWriter_initialize(UpdateWriter_t          *writer,
+                                ARM_DRIVER_STORAGE      *mtd,
+                                uint64_t                 addr,
+                                uint64_t                 size,
+                                UpdateWriter_Callback_t  callback);
+
+/**
+ * Hand the next chunk of the image to the writer.
+ *
+ * The data is copied and added to the hash of the image, so the caller's
+ * buffer may be reused as soon as the call returns. While both buffers wait
+ * on the storage only part of the chunk, or none of it, is accepted; the
+ * callback follows with WRITE once the rest can be retried.
+ *
+ * @param[in] writer
+ *              The writer.
+ * @param[in] data
+ *              The chunk.
+ * @param[in] size
+ *              Size of the chunk.
+ *
+ * @return The number of bytes accepted, from 0 to size, or an error code.
+ *         Once the storage has failed, the error is returned by every call.
+ */
+int32_t UpdateWriter_write(UpdateWriter_t *writer, const void *data, size_t size);
+
+/**
+ * Program what is left of the image.
+ *
+ * The last program unit is padded with the erased value of the storage.
+ *
+ * @param[in] writer
+ *              The writer.
+ * @param[out] hash
+ *              The SHA-256 digest of all the data accepted by write(), to
+ *              check against the one of the image.
+ *
+ * @return UPDATE_WRITER_STATUS_OK if programming continues in the
+ *         background; the callback follows with FINALIZE. 1 if the image is
+ *         programmed already, or an error code.
+ */
+int32_t UpdateWriter_finalize(UpdateWriter_t *writer, uint8_t hash[UPDATE_WRITER_HASH_SIZE]);
+
+/**
+ * Abandon the image, e.g. when its download has failed.
+ *
+ * Whatever was programmed already is left in place. The writer may be
+ * initialized again, for the same or another region; initialize() returns
+ * UPDATE_WRITER_STATUS_BUSY until an operation the storage had in progress
+ * has completed.
+ *
+ * @param[in] writer
+ *              The writer.
+ *
+ * @return UPDATE_WRITER_STATUS_OK, or an error code.
+ */
+int32_t UpdateWriter_abort(UpdateWriter_t *writer);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* __UPDATE_WRITER_H__ */
@@ -17,9 +17,15 @@
 */
 
 #include "stdint.h"
+#include "string.h"
 #include "USBAudio.h"
 #include "USBAudio_Types.h"
 
+// The fill level of the ring is averaged over about 2^RING_AVERAGE_SHIFT packets
+#define RING_AVERAGE_SHIFT 6
+
+// Packets between two corrections of the rate, a sample each
+#define RING_CORRECT_INTERVAL 8
 
 
 USBAudio::USBAudio(uint32_t frequency_in, uint8_t channel_nb_in, uint32_t frequency_out, uint8_t channel_nb_out, uint16_t vendor_id, uint16_t product_id, uint16_t product_release): USBDevice(vendor_id, product_id, product_release) {
@@ -56,6 +62,20 @@ USBAudio::USBAudio(uint32_t frequency_in, uint8_t channel_nb_in, uint32_t freque
 
     volume = 0;
 
+    ring = NULL;
+    ringPacket = NULL;
+    ringBlockSize = 0;
+    ringBlockCount = 0;
+    ringWriteBlock = 0;
+    ringWriteFill = 0;
+    ringWritten = 0;
+    ringReadBlock = 0;
+    ringReleased = 0;
+    ringPrimed = false;
+    ringAverage = 0;
+    ringCorrectIn = RING_CORRECT_INTERVAL;
+    drift = 0;
+
     // connect the device
     USBDevice::connect();
 }
@@ -114,6 +134,126 @@ bool USBAudio::write(uint8_t * buf) {
 }
 
 
+bool USBAudio::startReceiving(uint8_t * ring, uint32_t block_size, uint32_t block_count) {
+    uint32_t frame = 2 * channel_nb_in;
+
+    if (ring == NULL || block_count < 2 || block_size == 0 || (block_size % frame) != 0) {
+        return false;
+    }
+    if (ringPacket == NULL) {
+        ringPacket = new uint8_t[PACKET_SIZE_ISO_IN + frame];
+    }
+
+    // stop the producer while the ring is reset
+    this->ring = NULL;
+    ringBlockSize = block_size;
+    ringBlockCount = block_count;
+    ringWriteBlock = 0;
+    ringWriteFill = 0;
+    ringWritten = 0;
+    ringReadBlock = 0;
+    ringReleased = 0;
+    ringPrimed = false;
+    ringAverage = 0;
+    ringCorrectIn = RING_CORRECT_INTERVAL;
+    drift = 0;
+    this->ring = ring;
+    return true;
+}
+
+uint8_t * USBAudio::getBlock() {
+    uint32_t ready = ringWritten - ringReleased;
+
+    if (ring == NULL) {
+        return NULL;
+    }
+    if (!ringPrimed) {
+        if (ready < (ringBlockCount + 1) / 2) {
+            return NULL;
+        }
+        ringPrimed = true;
+    }
+    if (ready == 0) {
+        // underrun: wait for the ring to fill up again
+        ringPrimed = false;
+        return NULL;
+    }
+    return ring + ringReadBlock * ringBlockSize;
+}
+
+void USBAudio::releaseBlock() {
+    if (ring == NULL || ringWritten == ringReleased) {
+        return;
+    }
+    ringReadBlock = (ringReadBlock + 1 == ringBlockCount) ? 0 : ringReadBlock + 1;
+    ringReleased++;
+}
+
+int32_t USBAudio::getDrift() {
+    return drift;
+}
+
+// Called in ISR context with a packet in ringPacket
+void USBAudio::ringReceive(uint32_t size) {
+    uint32_t frame = 2 * channel_nb_in;
+    uint32_t target = (ringBlockCount * ringBlockSize) / 2;
+    uint32_t fill = (ringWritten - ringReleased) * ringBlockSize + ringWriteFill;
+    const uint8_t * data = ringPacket;
+
+    if (size < frame) {
+        return;
+    }
+
+    // Follow the fill level only while the blocks are consumed
+    if (!ringPrimed) {
+        ringAverage = target << RING_AVERAGE_SHIFT;
+    } else {
+        ringAverage += fill - (ringAverage >> RING_AVERAGE_SHIFT);
+        if (--ringCorrectIn == 0) {
+            uint32_t average = ringAverage >> RING_AVERAGE_SHIFT;
+            ringCorrectIn = RING_CORRECT_INTERVAL;
+            // a packet of deadband either way
+            if (average > target + PACKET_SIZE_ISO_IN) {
+                // the DAC is slower than the host: drop the last sample
+                size -= frame;
+                drift--;
+            } else if (average + PACKET_SIZE_ISO_IN < target) {
+                // the DAC is faster than the host: repeat the last sample
+                memcpy(ringPacket + size, ringPacket + size - frame, frame);
+                size += frame;
+                drift++;
+            }
+        }
+    }
+
+    if (fill + size > ringBlockCount * ringBlockSize) {
+        // overrun: the packet is lost
+        return;
+    }
+
+    while (size > 0) {
+        uint32_t n = ringBlockSize - ringWriteFill;
+        if (n > size) {
+            n = size;
+        }
+        memcpy(ring + ringWriteBlock * ringBlockSize + ringWriteFill, data, n);
+        ringWriteFill += n;
+        data += n;
+        size -= n;
+
+        if (ringWriteFill == ringBlockSize) {
+            uint8_t * block = ring + ringWriteBlock * ringBlockSize;
+            ringWriteFill = 0;
+            ringWriteBlock = (ringWriteBlock + 1 == ringBlockCount) ? 0 : ringWriteBlock + 1;
+            ringWritten++;
+            if (blockReady) {
+                blockReady.call(block);
+            }
+        }
+    }
+}
+
+
 float USBAudio::getVolume() {
     return (mute) ? 0.0 : volume;
 }
@@ -122,7 +262,10 @@ float USBAudio::getVolume() {
 bool USBAudio::EPISO_OUT_callback() {
     uint32_t size = 0;
     interruptOUT = true;
-    if (buf_stream_in != NULL) {
+    if (ring != NULL) {
+        readEP(EP3OUT, ringPacket, &size, PACKET_SIZE_ISO_IN);
+        ringReceive(size);
+    } else if (buf_stream_in != NULL) {
         readEP(EP3OUT, (uint8_t *)buf_stream_in, &size, PACKET_SIZE_ISO_IN);
         available = true;
         buf_stream_in = NULL;
@@ -146,7 +289,14 @@ void USBAudio::SOF(int frameNumber) {
 
     if (!interruptOUT) {
         // read the isochronous endpoint
-        if (buf_stream_in != NULL) {
+        if (ring != NULL) {
+            if (USBDevice::readEP_NB(EP3OUT, ringPacket, &size, PACKET_SIZE_ISO_IN)) {
+                if (size) {
+                    ringReceive(size);
+                    readStart(EP3OUT, PACKET_SIZE_ISO_IN);
+                }
+            }
+        } else if (buf_stream_in != NULL) {
             if (USBDevice::readEP_NB(EP3OUT, (uint8_t *)buf_stream_in, &size, PACKET_SIZE_ISO_IN)) {
                 if (size) {
                     available = true;
@@ -124,6 +124,51 @@ public:
     */
     bool readWrite(uint8_t * buf_read, uint8_t * buf_write);
 
+    /**
+    * Stream the received audio through a ring of blocks instead of reading it packet by packet.
+    * A block is passed to the block handler once filled, and is not touched again until
+    * released, so that a DMA can play it in place.
+    *
+    * The ring is kept half full to absorb the drift between the clocks of the host and of the DAC:
+    * when its average fill level moves away, a sample is dropped from or repeated in the next packets.
+    * Blocks are handed out once the ring is half full, and again after it has run empty.
+    *
+    * @param ring buffer of block_count * block_size bytes
+    * @param block_size size of a block in bytes, a multiple of a sample on all the channels (2 * channel_nb_in)
+    * @param block_count number of blocks, at least 2
+    * @returns true if successful
+    */
+    bool startReceiving(uint8_t * ring, uint32_t block_size, uint32_t block_count);
+
+    /**
+    * Get the oldest filled block of the ring, without releasing it. Warning: Non Blocking
+    *
+    * @returns pointer on the block, or NULL if no block is available
+    */
+    uint8_t * getBlock();
+
+    /**
+    * Give the block returned by getBlock back to the ring, once it has been played
+    */
+    void releaseBlock();
+
+    /**
+    * Get the number of samples repeated minus the number dropped to match the rate of the DAC.
+    * A DAC with an adjustable clock can use its variation to follow the host.
+    *
+    * @returns net number of samples inserted in the stream since startReceiving
+    */
+    int32_t getDrift();
+
+    /** Attach a handler called with each block of the ring once filled. Warning: Called in ISR context
+     *
+     * @param cb Callback taking the pointer on the block
+     *
+     */
+    void attachBlock(Callback<void(uint8_t *)> cb) {
+        blockReady = cb;
+    }
+
 
     /** attach a handler to update the volume
      *
@@ -225,6 +270,9 @@ protected:
 
 private:
 
+    // push a packet from the scratch buffer into the ring, correcting the rate
+    void ringReceive(uint32_t size);
+
     // stream available ?
     volatile bool available;
 
@@ -282,6 +330,36 @@ private:
 
     volatile float volume;
 
+    // Ring of blocks (startReceiving), NULL when packets are read one by one
+    uint8_t * volatile ring;
+    uint32_t ringBlockSize;
+    uint32_t ringBlockCount;
+
+    // Packet read from the endpoint, with room for a repeated sample
+    uint8_t * ringPacket;
+
+    // Producer (ISR): block being filled and bytes in it, blocks filled so far
+    uint32_t ringWriteBlock;
+    uint32_t ringWriteFill;
+    volatile uint32_t ringWritten;
+
+    // Consumer: oldest block not released, blocks released so far
+    uint32_t ringReadBlock;
+    volatile uint32_t ringReleased;
+
+    // the ring has been filled to half since it last ran empty
+    volatile bool ringPrimed;
+
+    // average fill level in bytes (fixed point), and packets until the next correction
+    uint32_t ringAverage;
+    uint8_t ringCorrectIn;
+
+    // samples repeated minus samples dropped
+    volatile int32_t drift;
+
+    // callback for each filled block
+    Callback<void(uint8_t *)> blockReady;
+
 };
 
 #endif
@@ -65,6 +65,10 @@ typedef struct BDT {
 // there are:
 //    * 16 bidirectionnal endpt -> 32 physical endpt
 //    * as there are ODD and EVEN buffer -> 32*2 bdt
+// Only the first BD of each pair is armed: endpoints, bulk ones included,
+// are single buffered and the controller NAKs until a packet is handled.
+// USBSerial overlaps packet transfers with the application through its
+// ring buffers instead.
 __attribute__((__aligned__(512))) BDT bdt[NUMBER_OF_PHYSICAL_ENDPOINTS * 2];
 uint8_t * endpoint_buffer[(NUMBER_OF_PHYSICAL_ENDPOINTS - 2) * 2];
 uint8_t * endpoint_buffer_iso[2*2];
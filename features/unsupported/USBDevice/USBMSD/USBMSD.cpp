@@ -41,6 +41,7 @@
 #define READ10                     0x28
 #define WRITE10                    0x2A
 #define VERIFY10                   0x2F
+#define SYNCHRONIZE_CACHE10        0x35
 #define READ12                     0xA8
 #define WRITE12                    0xAA
 #define MODE_SELECT10              0x55
@@ -67,11 +68,26 @@ USBMSD::USBMSD(uint16_t vendor_id, uint16_t product_id, uint16_t product_release
     stage = READ_CBW;
     memset((void *)&cbw, 0, sizeof(CBW));
     memset((void *)&csw, 0, sizeof(CSW));
+    memset((void *)buffers, 0, sizeof(buffers));
     page = NULL;
+    bufferBlocks = 0;
+#ifdef MBED_CONF_RTOS_PRESENT
+    diskThread = NULL;
+    jobHead = 0;
+    jobCount = 0;
+    completing = false;
+#endif
+    startTransfer();
 }
 
 USBMSD::~USBMSD() {
     disconnect();
+#ifdef MBED_CONF_RTOS_PRESENT
+    if (diskThread != NULL) {
+        diskThread->terminate();
+        delete diskThread;
+    }
+#endif
 }
 
 
@@ -120,15 +136,29 @@ bool USBMSD::connect(bool blocking) {
     if (BlockCount > 0) {
         BlockSize = MemorySize / BlockCount;
         if (BlockSize != 0) {
+            // whole blocks, as many as disk_read() and disk_write() take
+            bufferBlocks = USBMSD_BUFFER_SIZE / BlockSize;
+            bufferBlocks = (bufferBlocks < 1) ? 1 : (bufferBlocks > 255) ? 255 : bufferBlocks;
             free(page);
-            page = (uint8_t *)malloc(BlockSize * sizeof(uint8_t));
+            page = (uint8_t *)malloc(2 * bufferBlocks * BlockSize * sizeof(uint8_t));
             if (page == NULL)
                 return false;
+            buffers[0].data = page;
+            buffers[1].data = page + bufferBlocks * BlockSize;
+            buffers[0].state = BUFFER_FREE;
+            buffers[1].state = BUFFER_FREE;
         }
     } else {
         return false;
     }
 
+#ifdef MBED_CONF_RTOS_PRESENT
+    if (diskThread == NULL) {
+        diskThread = new rtos::Thread(osPriorityAboveNormal, USBMSD_THREAD_STACK_SIZE);
+        diskThread->start(callback(this, &USBMSD::diskLoop));
+    }
+#endif
+
     //connect the device
     USBDevice::connect(blocking);
     return true;
@@ -136,13 +166,152 @@ bool USBMSD::connect(bool blocking) {
 
 void USBMSD::disconnect() {
     USBDevice::disconnect();
-    //De-allocate MSD page size:
+#ifdef MBED_CONF_RTOS_PRESENT
+    // the thread may still be writing a buffer
+    while (jobCount) {
+        rtos::Thread::wait(1);
+    }
+#endif
+    //De-allocate MSD buffers:
     free(page);
     page = NULL;
 }
 
 void USBMSD::reset() {
+    bool paused = outPaused;
     stage = READ_CBW;
+    startTransfer();
+    if (paused) {
+        readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+    }
+}
+
+void USBMSD::startTransfer() {
+    usbBuffer = 0;
+    usbOffset = 0;
+    diskCount = 0;
+    outPaused = false;
+    inPaused = false;
+    cswPending = false;
+    diskError = false;
+    for (int i = 0; i < 2; i++) {
+        if (buffers[i].state == BUFFER_READY) {
+            buffers[i].state = BUFFER_FREE;
+        }
+    }
+}
+
+// Queues a buffer for the disk, done right away without the RTOS
+void USBMSD::submit(uint8_t index) {
+    buffers[index].state = BUFFER_QUEUED;
+#ifdef MBED_CONF_RTOS_PRESENT
+    jobs[(jobHead + jobCount) % 2] = index;
+    jobCount++;
+    // the thread checks for more buffers after completing one
+    if (!completing) {
+        diskThread->signal_set(1);
+    }
+#else
+    transfer(index);
+#endif
+}
+
+#ifdef MBED_CONF_RTOS_PRESENT
+void USBMSD::diskLoop() {
+    while (true) {
+        rtos::Thread::signal_wait(1);
+        while (jobCount) {
+            transfer(jobs[jobHead]);
+        }
+    }
+}
+#endif
+
+// Reads or writes the blocks of a buffer, then carries on with the USB side
+void USBMSD::transfer(uint8_t index) {
+    Buffer &b = buffers[index];
+    int ret = 0;
+
+    if (b.count) {
+        if (!b.write) {
+            ret = disk_read(b.data, b.block, b.count);
+        } else if (!(disk_status() & WRITE_PROTECT)) {
+            ret = disk_write(b.data, b.block, b.count);
+        }
+    }
+
+#ifdef MBED_CONF_RTOS_PRESENT
+    // the rest runs as if from the USB interrupt
+    core_util_critical_section_enter();
+    jobHead = (jobHead + 1) % 2;
+    jobCount--;
+    completing = true;
+#endif
+    if (ret) {
+        diskError = true;
+    }
+    transferDone(index);
+#ifdef MBED_CONF_RTOS_PRESENT
+    completing = false;
+    core_util_critical_section_exit();
+#endif
+}
+
+void USBMSD::transferDone(uint8_t index) {
+    Buffer &b = buffers[index];
+
+    if (b.write) {
+        b.state = BUFFER_FREE;
+        if (outPaused && buffers[usbBuffer].state == BUFFER_FREE) {
+            outPaused = false;
+            readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+        }
+        if (cswPending && buffers[0].state == BUFFER_FREE && buffers[1].state == BUFFER_FREE) {
+            cswPending = false;
+            if (diskError) {
+                csw.Status = CSW_FAILED;
+            }
+            sendCSW();
+        }
+    } else {
+        b.state = BUFFER_READY;
+        if (inPaused && index == usbBuffer) {
+            inPaused = false;
+            memoryRead();
+        }
+    }
+}
+
+// Reads the next blocks of a read into a free buffer
+void USBMSD::prefetch(uint8_t index) {
+    Buffer &b = buffers[index];
+
+    if (!diskCount || b.state != BUFFER_FREE) {
+        return;
+    }
+    b.block = diskBlock;
+    b.count = (diskCount < bufferBlocks) ? diskCount : bufferBlocks;
+    b.write = false;
+    diskBlock += b.count;
+    diskCount -= b.count;
+    submit(index);
+}
+
+void USBMSD::startRead() {
+    startTransfer();
+    diskBlock = addr / BlockSize;
+    diskCount = length / BlockSize;
+
+    if ((uint64_t)diskBlock + diskCount > BlockCount) {
+        stallEndpoint(EPBULK_IN);
+        csw.Status = CSW_FAILED;
+        sendCSW();
+        return;
+    }
+
+    prefetch(0);
+    prefetch(1);
+    memoryRead();
 }
 
 
@@ -178,8 +347,10 @@ bool USBMSD::EPBULK_OUT_callback() {
             break;
     }
 
-    //reactivate readings on the OUT bulk endpoint
-    readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+    //reactivate readings on the OUT bulk endpoint, once there is a buffer for them
+    if (!outPaused) {
+        readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+    }
     return true;
 }
 
@@ -225,24 +396,36 @@ void USBMSD::memoryWrite (uint8_t * buf, uint16_t size) {
         stallEndpoint(EPBULK_OUT);
     }
 
-    // we fill an array in RAM of 1 block before writing it in memory
-    for (int i = 0; i < size; i++)
-        page[addr%BlockSize + i] = buf[i];
-
-    // if the array is filled, write it in memory
-    if (!((addr + size)%BlockSize)) {
-        if (!(disk_status() & WRITE_PROTECT)) {
-            disk_write(page, addr/BlockSize, 1);
-        }
+    // we fill a buffer of blocks in RAM before writing them in memory
+    Buffer &b = buffers[usbBuffer];
+    if (!usbOffset) {
+        b.block = addr/BlockSize;
     }
+    memcpy(b.data + usbOffset, buf, size);
+    usbOffset += size;
 
     addr += size;
     length -= size;
     csw.DataResidue -= size;
 
-    if ((!length) || (stage != PROCESS_CBW)) {
+    // the CSW is sent once the blocks are written
+    bool last = (!length) || (stage != PROCESS_CBW);
+    if (last) {
         csw.Status = (stage == ERROR) ? CSW_FAILED : CSW_PASSED;
-        sendCSW();
+        cswPending = true;
+    }
+
+    // if the buffer is filled, write it while filling the other one
+    if ((usbOffset == bufferBlocks * BlockSize) || last) {
+        uint8_t index = usbBuffer;
+        b.count = usbOffset / BlockSize;
+        b.write = true;
+        usbBuffer ^= 1;
+        usbOffset = 0;
+        submit(index);
+        if (buffers[usbBuffer].state != BUFFER_FREE) {
+            outPaused = true;
+        }
     }
 }
 
@@ -428,7 +611,7 @@ void USBMSD::CBWDecode(uint8_t * buf, uint16_t size) {
                         if (infoTransfer()) {
                             if ((cbw.Flags & 0x80)) {
                                 stage = PROCESS_CBW;
-                                memoryRead();
+                                startRead();
                             } else {
                                 stallEndpoint(EPBULK_OUT);
                                 csw.Status = CSW_ERROR;
@@ -441,6 +624,7 @@ void USBMSD::CBWDecode(uint8_t * buf, uint16_t size) {
                         if (infoTransfer()) {
                             if (!(cbw.Flags & 0x80)) {
                                 stage = PROCESS_CBW;
+                                startTransfer();
                             } else {
                                 stallEndpoint(EPBULK_IN);
                                 csw.Status = CSW_ERROR;
@@ -466,7 +650,9 @@ void USBMSD::CBWDecode(uint8_t * buf, uint16_t size) {
                         }
                         break;
                     case MEDIA_REMOVAL:
-                        csw.Status = CSW_PASSED;
+                    case SYNCHRONIZE_CACHE10:
+                        // hosts sync and unlock the medium before ejecting it
+                        csw.Status = disk_sync() ? CSW_FAILED : CSW_PASSED;
                         sendCSW();
                         break;
                     default:
@@ -495,28 +681,39 @@ void USBMSD::testUnitReady (void) {
 
 void USBMSD::memoryRead (void) {
     uint32_t n;
+    Buffer *b = &buffers[usbBuffer];
+
+    // the packets of a buffer sent, it reads the next blocks while the other one is sent
+    if ((b->state == BUFFER_READY) && (usbOffset == b->count * BlockSize)) {
+        b->state = BUFFER_FREE;
+        prefetch(usbBuffer);
+        usbBuffer ^= 1;
+        usbOffset = 0;
+        b = &buffers[usbBuffer];
+    }
 
-    n = (length > MAX_PACKET) ? MAX_PACKET : length;
-
-    if ((addr + n) > MemorySize) {
-        n = MemorySize - addr;
-        stage = ERROR;
+    // sent once read
+    if (b->state != BUFFER_READY) {
+        inPaused = true;
+        return;
     }
 
-    // we read an entire block
-    if (!(addr%BlockSize))
-        disk_read(page, addr/BlockSize, 1);
+    n = (length > MAX_PACKET) ? MAX_PACKET : length;
+    if (n > b->count * BlockSize - usbOffset) {
+        n = b->count * BlockSize - usbOffset;
+    }
 
     // write data which are in RAM
-    writeNB(EPBULK_IN, &page[addr%BlockSize], n, MAX_PACKET_SIZE_EPBULK);
+    writeNB(EPBULK_IN, b->data + usbOffset, n, MAX_PACKET_SIZE_EPBULK);
 
+    usbOffset += n;
     addr += n;
     length -= n;
 
     csw.DataResidue -= n;
 
     if ( !length || (stage != PROCESS_CBW)) {
-        csw.Status = (stage == PROCESS_CBW) ? CSW_PASSED : CSW_FAILED;
+        csw.Status = ((stage == PROCESS_CBW) && !diskError) ? CSW_PASSED : CSW_FAILED;
         stage = (stage == PROCESS_CBW) ? SEND_CSW : stage;
     }
 }
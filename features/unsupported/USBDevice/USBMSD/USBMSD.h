@@ -27,6 +27,20 @@
 
 #include "USBDevice.h"
 
+#ifdef MBED_CONF_RTOS_PRESENT
+#include "rtos/Thread.h"
+#endif
+
+// Bytes of each of the two transfer buffers, in whole blocks
+#ifndef USBMSD_BUFFER_SIZE
+#define USBMSD_BUFFER_SIZE          4096
+#endif
+
+// Stack of the thread transferring the blocks, with the RTOS
+#ifndef USBMSD_THREAD_STACK_SIZE
+#define USBMSD_THREAD_STACK_SIZE    1024
+#endif
+
 /**
  * USBMSD class: generic class in order to use all kinds of blocks storage chip
  *
@@ -54,6 +68,10 @@
  * of USBMSD to connect your mass storage device. connect() will first call disk_status() to test the status of the disk.
  * If disk_status() returns 1 (disk not initialized), then disk_initialize() is called. After this step, connect() will collect information
  * such as the number of blocks and the memory size.
+ *
+ * Blocks are read and written up to USBMSD_BUFFER_SIZE bytes at a time with one call to disk_read() or
+ * disk_write(), through two buffers. With the RTOS, a thread does these calls while the packets of the
+ * other buffer go over USB, so they are not made from the USB interrupt; without, they are made from it.
  */
 class USBMSD: public USBDevice {
 public:
@@ -134,6 +152,14 @@ protected:
     */
     virtual int disk_status() = 0;
 
+    /*
+    * Write the data held by the storage chip, when the host syncs or
+    * ejects the medium
+    *
+    * @returns 0 if successful
+    */
+    virtual int disk_sync() { return 0; }
+
     /*
     * Get string product descriptor
     *
@@ -224,13 +250,65 @@ private:
     // memory OK (after a memoryVerify)
     bool memOK;
 
-    // cache in RAM before writing in memory. Useful also to read a block.
+    // blocks in transfer between USB and the memory
+    enum BufferState {
+        BUFFER_FREE,
+        BUFFER_QUEUED,  // to be written or read by the disk
+        BUFFER_READY,   // read, to be sent
+    };
+
+    struct Buffer {
+        uint8_t * data;
+        uint32_t block;
+        uint32_t count;
+        bool write;
+        volatile uint8_t state;
+    };
+
+    Buffer buffers[2];
+
+    // the buffer and offset of the USB side of the transfer
+    uint8_t usbBuffer;
+    uint32_t usbOffset;
+
+    // the blocks left to read ahead
+    uint32_t diskBlock;
+    uint32_t diskCount;
+
+    // waiting for a buffer before reading the next OUT packet or sending the next IN one
+    bool outPaused;
+    bool inPaused;
+
+    // the CSW of a write, once its buffers are written
+    bool cswPending;
+    bool diskError;
+
+    // the whole buffers, and the first one to verify a block
     uint8_t * page;
+    uint32_t bufferBlocks;
 
     int BlockSize;
     uint64_t MemorySize;
     uint64_t BlockCount;
 
+#ifdef MBED_CONF_RTOS_PRESENT
+    // buffers queued for the thread, in order
+    rtos::Thread * diskThread;
+    uint8_t jobs[2];
+    volatile uint8_t jobHead;
+    volatile uint8_t jobCount;
+    bool completing;
+
+    void diskLoop();
+#endif
+
+    void submit(uint8_t index);
+    void transfer(uint8_t index);
+    void transferDone(uint8_t index);
+    void prefetch(uint8_t index);
+    void startRead();
+    void startTransfer();
+
     void CBWDecode(uint8_t * buf, uint16_t size);
     void sendCSW (void);
     bool inquiryRequest (void);
@@ -0,0 +1,53 @@
+/* Copyright (c) 2017 mbed.org, MIT License
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+* and associated documentation files (the "Software"), to deal in the Software without
+* restriction, including without limitation the rights to use, copy, modify, merge, publish,
+* distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the
+* Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or
+* substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+* BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+* NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+* DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "USBMSDBlockDevice.h"
+
+USBMSDBlockDevice::USBMSDBlockDevice(BlockDevice *bd, uint16_t vendor_id, uint16_t product_id, uint16_t product_release):
+    USBMSD(vendor_id, product_id, product_release), _bd(bd), _initialized(false) {
+}
+
+int USBMSDBlockDevice::disk_read(uint8_t* data, uint64_t block, uint8_t count) {
+    return _bd->read(data, (uint32_t)block, count) ? 1 : 0;
+}
+
+int USBMSDBlockDevice::disk_write(const uint8_t* data, uint64_t block, uint8_t count) {
+    return _bd->write(data, (uint32_t)block, count) ? 1 : 0;
+}
+
+int USBMSDBlockDevice::disk_initialize() {
+    _initialized = (_bd->init() == 0);
+    return _initialized ? 0 : 1;
+}
+
+uint64_t USBMSDBlockDevice::disk_sectors() {
+    return _bd->block_count();
+}
+
+uint64_t USBMSDBlockDevice::disk_size() {
+    return (uint64_t)_bd->block_count() * _bd->block_size();
+}
+
+int USBMSDBlockDevice::disk_status() {
+    // 1: not initialized
+    return _initialized ? 0 : 1;
+}
+
+int USBMSDBlockDevice::disk_sync() {
+    return _bd->sync() ? 1 : 0;
+}
@@ -19,6 +19,8 @@
 #ifndef CIRCBUFFER_H
 #define CIRCBUFFER_H
 
+#include <string.h>
+
 template <class T, int Size>
 class CircBuffer {
 public:
@@ -44,6 +46,36 @@ public:
         return (write >= read) ? write - read : size - read + write;
     };
 
+    uint16_t free() {
+        return Size - available();
+    };
+
+    // Queues as many of the n elements as fit, returns the number queued
+    uint16_t queue(const T * k, uint16_t n) {
+        uint16_t w = write;
+        if (n > free()) {
+            n = free();
+        }
+        uint16_t first = (n < size - w) ? n : size - w;
+        memcpy(&buf[w], k, first * sizeof(T));
+        memcpy(&buf[0], k + first, (n - first) * sizeof(T));
+        write = (w + n) % size;
+        return n;
+    }
+
+    // Dequeues up to n elements, returns the number dequeued
+    uint16_t dequeue(T * k, uint16_t n) {
+        uint16_t r = read;
+        if (n > available()) {
+            n = available();
+        }
+        uint16_t first = (n < size - r) ? n : size - r;
+        memcpy(k, &buf[r], first * sizeof(T));
+        memcpy(k + first, &buf[0], (n - first) * sizeof(T));
+        read = (r + n) % size;
+        return n;
+    }
+
     bool dequeue(T * c) {
         bool empty = isEmpty();
         if (!empty) {
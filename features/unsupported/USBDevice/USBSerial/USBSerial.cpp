@@ -18,50 +18,162 @@
 
 #include "stdint.h"
 #include "USBSerial.h"
+#include "platform/mbed_poll.h"
 
 int USBSerial::_putc(int c) {
     if (!terminal_connected)
         return 0;
-    send((uint8_t *)&c, 1);
-    return 1;
+    uint8_t b = c;
+    return writeBlock(&b, 1) ? 1 : 0;
 }
 
 int USBSerial::_getc() {
     uint8_t c = 0;
     while (buf.isEmpty());
     buf.dequeue(&c);
+    resumeRead();
     return c;
 }
 
 
 bool USBSerial::writeBlock(uint8_t * buf, uint16_t size) {
-    if(size > MAX_PACKET_SIZE_EPBULK) {
-        return false;
-    }
-    if(!send(buf, size)) {
-        return false;
+    uint16_t queued = 0;
+    while (queued < size) {
+        if (!configured()) {
+            return false;
+        }
+        queued += txbuf.queue(buf + queued, size - queued);
+
+        // start sending if the endpoint is idle, the IN callback sends the rest
+        core_util_critical_section_enter();
+        if (!txBusy) {
+            sendPacket();
+        }
+        core_util_critical_section_exit();
     }
     return true;
 }
 
+uint16_t USBSerial::readBlock(uint8_t * buf, uint16_t size) {
+    uint16_t n = this->buf.dequeue(buf, size);
+    resumeRead();
+    return n;
+}
+
+ssize_t USBSerial::write(const void* buffer, size_t length) {
+    const uint8_t* ptr = (const uint8_t*)buffer;
+    size_t written = 0;
+
+    // dropped without a terminal, as by _putc
+    if (!terminal_connected)
+        return length;
+
+    lock();
+    while (written < length) {
+        uint16_t n = (length - written > 0xFFFF) ? 0xFFFF : length - written;
+        if (!writeBlock((uint8_t *)ptr + written, n)) {
+            break;
+        }
+        written += n;
+    }
+    unlock();
+
+    return written;
+}
+
+ssize_t USBSerial::read(void* buffer, size_t length) {
+    uint8_t* ptr = (uint8_t*)buffer;
+    size_t done = 0;
+
+    // waits for the whole length, as by _getc
+    lock();
+    while (done < length) {
+        uint16_t n = (length - done > 0xFFFF) ? 0xFFFF : length - done;
+        done += readBlock(ptr + done, n);
+    }
+    unlock();
+
+    return done;
+}
+
+int USBSerial::fsync() {
+    while ((txBusy || !txbuf.isEmpty()) && configured());
+    return configured() ? 0 : -1;
+}
 
+// Sends the next packet from txbuf, with the endpoint idle
+void USBSerial::sendPacket() {
+    uint8_t packet[MAX_PACKET_SIZE_EPBULK];
+    uint16_t n = txbuf.dequeue(packet, sizeof(packet));
+
+    // a full packet is followed by a short one, so that the host hands the data over
+    if (!n && !txZlp) {
+        return;
+    }
+    txZlp = (n == MAX_PACKET_SIZE_EPBULK);
+    txBusy = writeNB(EPBULK_IN, packet, n, MAX_PACKET_SIZE_EPBULK);
+}
+
+bool USBSerial::EPBULK_IN_callback() {
+    txBusy = false;
+    sendPacket();
+    mbed::poll_wake();
+    return true;
+}
+
+// Reads the next packet once there is room for it
+void USBSerial::resumeRead() {
+    core_util_critical_section_enter();
+    if (rxPaused && (buf.free() >= MAX_PACKET_SIZE_EPBULK)) {
+        rxPaused = false;
+        readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+    }
+    core_util_critical_section_exit();
+}
 
 bool USBSerial::EPBULK_OUT_callback() {
     uint8_t c[65];
     uint32_t size = 0;
 
     //we read the packet received and put it on the circular buffer
-    readEP(c, &size);
-    for (uint32_t i = 0; i < size; i++) {
-        buf.queue(c[i]);
+    USBDevice::readEP(EPBULK_OUT, c, &size, MAX_PACKET_SIZE_EPBULK);
+    buf.queue(c, size);
+
+    //reactivate readings on the OUT bulk endpoint, once there is room for a packet
+    if (buf.free() >= MAX_PACKET_SIZE_EPBULK) {
+        readStart(EPBULK_OUT, MAX_PACKET_SIZE_EPBULK);
+    } else {
+        rxPaused = true;
     }
 
     //call a potential handler
     rx.call();
+    mbed::poll_wake();
 
     return true;
 }
 
-uint8_t USBSerial::available() {
+bool USBSerial::USBCallback_setConfiguration(uint8_t configuration) {
+    // nothing is in flight on the endpoints of a new configuration
+    rxPaused = false;
+    txBusy = false;
+    txZlp = false;
+    return USBCDC::USBCallback_setConfiguration(configuration);
+}
+
+uint16_t USBSerial::available() {
     return buf.available();
 }
+
+short USBSerial::poll(short events) const {
+    // the buffers are only read
+    USBSerial *self = const_cast<USBSerial *>(this);
+    short revents = 0;
+    if (!self->buf.isEmpty()) {
+        revents |= POLLIN;
+    }
+    if (!self->txbuf.isFull()) {
+        revents |= POLLOUT;
+    }
+    return revents & events;
+}
@@ -24,7 +24,24 @@
 #include "CircBuffer.h"
 #include "Callback.h"
 
+// Bytes received from the host and not read yet, at least a packet; the host waits when it is full
+#ifndef USBSERIAL_RX_BUFFER_SIZE
+#define USBSERIAL_RX_BUFFER_SIZE    128
+#endif
+
+// Bytes to send to the host, gathered into packets while one is sent
+#ifndef USBSERIAL_TX_BUFFER_SIZE
+#define USBSERIAL_TX_BUFFER_SIZE    128
+#endif
+
 /**
+* Virtual serial port over USB
+*
+* Received packets are copied into a ring of USBSERIAL_RX_BUFFER_SIZE bytes
+* and written data is sent from a ring of USBSERIAL_TX_BUFFER_SIZE bytes,
+* one packet on the wire at a time. The bulk endpoints themselves are single
+* buffered: the USB HALs don't provide double buffered endpoints or DMA.
+*
 * USBSerial example
 *
 * @code
@@ -58,6 +75,9 @@ public:
     */
     USBSerial(uint16_t vendor_id = 0x1f00, uint16_t product_id = 0x2012, uint16_t product_release = 0x0001, bool connect_blocking = true): USBCDC(vendor_id, product_id, product_release, connect_blocking){
         settingsChangedCallback = 0;
+        rxPaused = false;
+        txBusy = false;
+        txZlp = false;
     };
 
 
@@ -81,7 +101,7 @@ public:
     *
     * @returns the number of bytes available
     */
-    uint8_t available();
+    uint16_t available();
 
     /** Determine if there is a character available to read
      *
@@ -99,18 +119,39 @@ public:
      */
     int writeable() { return 1; } // always return 1, for write operation is blocking
 
+    /** Check the events the port is ready for
+     *
+     *  POLLIN once bytes were received, POLLOUT while the transmit buffer
+     *  has room. mbed::poll() is woken as packets are received and sent.
+     *
+     *  @param events Mask of POLLIN and POLLOUT to check
+     *  @returns Mask of the events ready
+     */
+    virtual short poll(short events) const;
+
     /**
     * Write a block of data.
     *
-    * For more efficiency, a block of size 64 (maximum size of a bulk endpoint) has to be written.
+    * The data is queued for sending, waiting for room in the transmit buffer, and sent in
+    * packets of 64 bytes (maximum size of a bulk endpoint) while the next ones are queued.
     *
     * @param buf pointer on data which will be written
-    * @param size size of the buffer. The maximum size of a block is limited by the size of the endpoint (64 bytes)
+    * @param size size of the buffer
     *
     * @returns true if successfull
     */
     bool writeBlock(uint8_t * buf, uint16_t size);
 
+    /**
+    * Read the bytes received, without waiting.
+    *
+    * @param buf pointer where the data will be stored
+    * @param size maximum number of bytes to read
+    *
+    * @returns the number of bytes read
+    */
+    uint16_t readBlock(uint8_t * buf, uint16_t size);
+
     /**
      *  Attach a member function to call when a packet is received.
      *
@@ -145,7 +186,15 @@ public:
     }
 
 protected:
+    /* Stream writes and reads in blocks, rather than a _putc or _getc per byte */
+    virtual ssize_t write(const void* buffer, size_t length);
+    virtual ssize_t read(void* buffer, size_t length);
+    /* Waits for the bytes queued to be sent */
+    virtual int fsync();
+
     virtual bool EPBULK_OUT_callback();
+    virtual bool EPBULK_IN_callback();
+    virtual bool USBCallback_setConfiguration(uint8_t configuration);
     virtual void lineCodingChanged(int baud, int bits, int parity, int stop){
         if (settingsChangedCallback) {
             settingsChangedCallback(baud, bits, parity, stop);
@@ -154,7 +203,17 @@ protected:
 
 private:
     Callback<void()> rx;
-    CircBuffer<uint8_t,128> buf;
+    CircBuffer<uint8_t,USBSERIAL_RX_BUFFER_SIZE> buf;
+    CircBuffer<uint8_t,USBSERIAL_TX_BUFFER_SIZE> txbuf;
+
+    // the OUT endpoint waits for room in buf
+    volatile bool rxPaused;
+    // a packet is being sent, or a zero length one is due after a full one
+    volatile bool txBusy;
+    bool txZlp;
+
+    void resumeRead();
+    void sendPacket();
     void (*settingsChangedCallback)(int baud, int bits, int parity, int stop);
 };
 
@@ -28,6 +28,9 @@ USBHost * USBHost::instHost = NULL;
 
 #define MIN(a, b) ((a > b) ? b : a)
 
+// Longest buffer a TD always covers: it can span two 4 kB pages, at any alignment
+#define MAX_TD_LENGTH               4096
+
 /**
 * How interrupts are processed:
 *    - new device connected:
@@ -1033,22 +1036,32 @@ USB_TYPE USBHost::generalTransfer(USBDeviceConnected * dev, USBEndpoint * ep, ui
         printf("\r\n\r\n");
     }
 #endif
-    addTransfer(ep, buf, len);
-
     if (blocking) {
 
-        ep->ep_queue.get();
-        res = ep->getState();
+        // Longer transfers are queued as consecutive TDs, a short packet ending them
+        uint32_t done = 0;
+        uint32_t chunk;
+        do {
+            chunk = MIN(len - done, MAX_TD_LENGTH);
+            addTransfer(ep, buf + done, chunk);
 
-        USB_DBG_TRANSFER("%s TRANSFER res: %s on ep: %p\r\n", type_str, ep->getStateString(), ep);
+            ep->ep_queue.get();
+            res = ep->getState();
 
-        if (res != USB_TYPE_IDLE) {
-            return res;
-        }
+            USB_DBG_TRANSFER("%s TRANSFER res: %s on ep: %p\r\n", type_str, ep->getStateString(), ep);
+
+            if (res != USB_TYPE_IDLE) {
+                return res;
+            }
+            done += ep->getLengthTransferred();
+        } while ((done < len) && ((uint32_t)ep->getLengthTransferred() == chunk));
 
+        ep->setLengthTransferred(done);
         return USB_TYPE_OK;
     }
 
+    addTransfer(ep, buf, len);
+
     return USB_TYPE_PROCESSING;
 
 }
@@ -73,7 +73,7 @@ public:
     * @param ep USBEndpoint which will be used to read a packet
     * @param buf pointer on a buffer where will be store the data received
     * @param len length of the transfer
-    * @param blocking if true, the read is blocking (wait for completion)
+    * @param blocking if true, the read is blocking (wait for completion), otherwise len is at most 4096 bytes
     *
     * @returns status of the bulk read
     */
@@ -86,7 +86,7 @@ public:
     * @param ep USBEndpoint which will be used to write a packet
     * @param buf pointer on a buffer which will be written
     * @param len length of the transfer
-    * @param blocking if true, the write is blocking (wait for completion)
+    * @param blocking if true, the write is blocking (wait for completion), otherwise len is at most 4096 bytes
     *
     * @returns status of the bulk write
     */
@@ -38,6 +38,16 @@
 */
 #define USBHOST_MSD                 1
 
+/*
+* Maximum number of blocks read or written by a single SCSI command
+*/
+#define USBHOST_MSD_MAX_BLOCKS      64
+
+/*
+* Number of blocks read ahead by USBHostMSD on short reads (0 to disable)
+*/
+#define USBHOST_MSD_CACHE_BLOCKS    8
+
 /*
 * Enable USBHostKeyboard
 */
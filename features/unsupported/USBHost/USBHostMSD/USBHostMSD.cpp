@@ -29,9 +29,13 @@
 #define GET_MAX_LUN             (0xFE)
 #define BO_MASS_STORAGE_RESET   (0xFF)
 
+#define MIN(a, b) ((a > b) ? b : a)
+
 USBHostMSD::USBHostMSD(const char * rootdir) : FATFileSystem(rootdir)
 {
     host = USBHost::getHostInst();
+    cache = NULL;
+    cacheSize = 0;
     init();
 }
 
@@ -48,6 +52,8 @@ void USBHostMSD::init() {
     disk_init = false;
     dev_connected = false;
     nb_ep = 0;
+    cacheBlock = 0;
+    cacheCount = 0;
 }
 
 
@@ -277,7 +283,7 @@ int USBHostMSD::SCSITransfer(uint8_t * cmd, uint8_t cmd_len, int flags, uint8_t
 }
 
 
-int USBHostMSD::dataTransfer(uint8_t * buf, uint32_t block, uint8_t nbBlock, int direction) {
+int USBHostMSD::dataTransfer(uint8_t * buf, uint32_t block, uint16_t nbBlock, int direction) {
     uint8_t cmd[10];
     memset(cmd,0,10);
     cmd[0] = (direction == DEVICE_TO_HOST) ? 0x28 : 0x2A;
@@ -330,10 +336,23 @@ int USBHostMSD::disk_write(const uint8_t* buffer, uint32_t block_number, uint32_
     }
     if (!disk_init)
         return -1;
-    for (uint32_t b = block_number; b < block_number + count; b++) {
-        if (dataTransfer((uint8_t*)buffer, b, 1, HOST_TO_DEVICE))
+
+    // keep the blocks read ahead up to date
+    if (cacheCount && (block_number < cacheBlock + cacheCount) && (cacheBlock < block_number + count)) {
+        uint32_t first = (block_number > cacheBlock) ? block_number : cacheBlock;
+        uint32_t last = MIN(block_number + count, cacheBlock + cacheCount);
+        memcpy(cache + (first - cacheBlock) * blockSize, buffer + (first - block_number) * blockSize, (last - first) * blockSize);
+    }
+
+    while (count > 0) {
+        uint32_t n = MIN(count, USBHOST_MSD_MAX_BLOCKS);
+        if (dataTransfer((uint8_t*)buffer, block_number, n, HOST_TO_DEVICE)) {
+            cacheCount = 0;
             return -1;
-        buffer += 512;
+        }
+        buffer += n * blockSize;
+        block_number += n;
+        count -= n;
     }
     return 0;
 }
@@ -345,10 +364,35 @@ int USBHostMSD::disk_read(uint8_t* buffer, uint32_t block_number, uint32_t count
     }
     if (!disk_init)
         return -1;
-    for (uint32_t b = block_number; b < block_number + count; b++) {
-        if (dataTransfer((uint8_t*)buffer, b, 1, DEVICE_TO_HOST))
-            return -1;
-        buffer += 512;
+
+    while (count > 0) {
+        uint32_t n;
+
+        if ((block_number >= cacheBlock) && (block_number < cacheBlock + cacheCount)) {
+            n = MIN(count, cacheBlock + cacheCount - block_number);
+            memcpy(buffer, cache + (block_number - cacheBlock) * blockSize, n * blockSize);
+        } else if ((count < USBHOST_MSD_CACHE_BLOCKS) && (block_number < blockCount)) {
+            // a short read is likely followed by the next blocks: read them along
+            if (cacheSize < (uint32_t)blockSize * USBHOST_MSD_CACHE_BLOCKS) {
+                delete[] cache;
+                cacheSize = blockSize * USBHOST_MSD_CACHE_BLOCKS;
+                cache = new uint8_t[cacheSize];
+            }
+            cacheCount = 0;
+            n = MIN(blockCount - block_number, USBHOST_MSD_CACHE_BLOCKS);
+            if (dataTransfer(cache, block_number, n, DEVICE_TO_HOST))
+                return -1;
+            cacheBlock = block_number;
+            cacheCount = n;
+            continue;
+        } else {
+            n = MIN(count, USBHOST_MSD_MAX_BLOCKS);
+            if (dataTransfer(buffer, block_number, n, DEVICE_TO_HOST))
+                return -1;
+        }
+        buffer += n * blockSize;
+        block_number += n;
+        count -= n;
     }
     return 0;
 }
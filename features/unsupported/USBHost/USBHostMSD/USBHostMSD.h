@@ -99,13 +99,19 @@ private:
     int readCapacity();
     int inquiry(uint8_t lun, uint8_t page_code);
     int SCSIRequestSense();
-    int dataTransfer(uint8_t * buf, uint32_t block, uint8_t nbBlock, int direction);
+    int dataTransfer(uint8_t * buf, uint32_t block, uint16_t nbBlock, int direction);
     int checkResult(uint8_t res, USBEndpoint * ep);
     int getMaxLun();
 
     int blockSize;
     uint32_t blockCount;
 
+    // blocks read ahead: cacheCount blocks from cacheBlock
+    uint8_t * cache;
+    uint32_t cacheSize;
+    uint32_t cacheBlock;
+    uint32_t cacheCount;
+
     int msd_intf;
     bool msd_device_found;
     bool disk_init;
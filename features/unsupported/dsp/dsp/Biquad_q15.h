@@ -0,0 +1,62 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef BIQUAD_Q15_H
+#define BIQUAD_Q15_H
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "platform/toolchain.h"
+
+namespace dsp {
+
+/** Cascade of num_stages biquad (second order IIR) sections on q15_t
+ *  samples, processing blocks of block_size samples.
+ *
+ *  The coefficients are 6 per stage, {b0, 0, b1, b2, a1, a2}
+ *  (the zero lets the Cortex-M4/M7 code read the coefficients in pairs), for
+ *  y[n] = (b0 * x[n] + b1 * x[n-1] + b2 * x[n-2] + a1 * y[n-1] + a2 * y[n-2]) << post_shift:
+ *  the feedback coefficients have the opposite sign of the ones given by
+ *  MATLAB, and post_shift scales coefficients beyond [-1, 1)
+ *  down into the Q1.15 format. The sections use the direct form I.
+ */
+template<uint8_t num_stages, uint32_t block_size=32>
+class Biquad_q15 {
+public:
+    Biquad_q15(const q15_t *coeff, int8_t post_shift=0) {
+        arm_biquad_cascade_df1_init_q15(&biquad, num_stages, (q15_t*)coeff, biquad_state, post_shift);
+    }
+    
+    void process(q15_t *sgn_in, q15_t *sgn_out) {
+        arm_biquad_cascade_df1_q15(&biquad, sgn_in, sgn_out, block_size);
+    }
+    
+    void reset(void) {
+        memset(biquad_state, 0, sizeof(biquad_state));
+    }
+
+private:
+    arm_biquad_casd_df1_inst_q15 biquad;
+    MBED_ALIGN(8) q15_t biquad_state[4 * num_stages];
+};
+
+}
+#endif
@@ -0,0 +1,61 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef FIRDECIMATOR_Q15_H
+#define FIRDECIMATOR_Q15_H
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "platform/toolchain.h"
+
+namespace dsp {
+
+/** FIR filter on q15_t samples decimating by M, processing blocks of
+ *  block_size input samples into blocks of block_size / M output samples.
+ *
+ *  block_size must be a multiple of M.
+ */
+template<uint16_t num_taps, uint8_t M, uint32_t block_size=32>
+class FIRDecimator_q15 {
+    typedef char block_size_must_be_a_multiple_of_M[((block_size % M) == 0) ? 1 : -1];
+
+public:
+    static const uint32_t output_block_size = block_size / M;
+
+    FIRDecimator_q15(const q15_t *coeff) {
+        arm_fir_decimate_init_q15(&decimator, num_taps, M, (q15_t*)coeff, decimator_state, block_size);
+    }
+    
+    void process(q15_t *sgn_in, q15_t *sgn_out) {
+        arm_fir_decimate_q15(&decimator, sgn_in, sgn_out, block_size);
+    }
+    
+    void reset(void) {
+        memset(decimator_state, 0, sizeof(decimator_state));
+    }
+
+private:
+    arm_fir_decimate_instance_q15 decimator;
+    MBED_ALIGN(8) q15_t decimator_state[block_size + num_taps - 1];
+};
+
+}
+#endif
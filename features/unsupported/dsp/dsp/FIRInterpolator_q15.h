@@ -0,0 +1,61 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef FIRINTERPOLATOR_Q15_H
+#define FIRINTERPOLATOR_Q15_H
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "platform/toolchain.h"
+
+namespace dsp {
+
+/** FIR filter on q15_t samples interpolating by L, processing blocks of
+ *  block_size input samples into blocks of block_size * L output samples.
+ *
+ *  num_taps must be a multiple of L.
+ */
+template<uint16_t num_taps, uint8_t L, uint32_t block_size=32>
+class FIRInterpolator_q15 {
+    typedef char num_taps_must_be_a_multiple_of_L[((num_taps % L) == 0) ? 1 : -1];
+
+public:
+    static const uint32_t output_block_size = block_size * L;
+
+    FIRInterpolator_q15(const q15_t *coeff) {
+        arm_fir_interpolate_init_q15(&interpolator, L, num_taps, (q15_t*)coeff, interpolator_state, block_size);
+    }
+    
+    void process(q15_t *sgn_in, q15_t *sgn_out) {
+        arm_fir_interpolate_q15(&interpolator, sgn_in, sgn_out, block_size);
+    }
+    
+    void reset(void) {
+        memset(interpolator_state, 0, sizeof(interpolator_state));
+    }
+
+private:
+    arm_fir_interpolate_instance_q15 interpolator;
+    MBED_ALIGN(8) q15_t interpolator_state[block_size + (num_taps / L) - 1];
+};
+
+}
+#endif
@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include "arm_math.h"
+#include "platform/toolchain.h"
 
 namespace dsp {
 
@@ -44,7 +45,7 @@ public:
 
 private:
     arm_fir_instance_f32 fir;
-    float32_t fir_state[block_size + num_taps - 1];
+    MBED_ALIGN(8) float32_t fir_state[block_size + num_taps - 1];
 };
 
 }
@@ -0,0 +1,54 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef FIR_Q31_H
+#define FIR_Q31_H
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "platform/toolchain.h"
+
+namespace dsp {
+
+/** FIR filter on q31_t samples, processing blocks of block_size samples.
+ */
+template<uint16_t num_taps, uint32_t block_size=32>
+class FIR_q31 {
+public:
+    FIR_q31(const q31_t *coeff) {
+        arm_fir_init_q31(&fir, num_taps, (q31_t*)coeff, fir_state, block_size);
+    }
+    
+    void process(q31_t *sgn_in, q31_t *sgn_out) {
+        arm_fir_q31(&fir, sgn_in, sgn_out, block_size);
+    }
+    
+    void reset(void) {
+        memset(fir_state, 0, sizeof(fir_state));
+    }
+
+private:
+    arm_fir_instance_q31 fir;
+    MBED_ALIGN(8) q31_t fir_state[block_size + num_taps - 1];
+};
+
+}
+#endif
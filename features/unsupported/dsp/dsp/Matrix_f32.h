@@ -0,0 +1,315 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MATRIX_F32_H
+#define MATRIX_F32_H
+
+#include <stdint.h>
+#include <string.h>
+#include "arm_math.h"
+
+namespace dsp {
+
+/** Product of a rows x inner and an inner x cols matrix, row-major
+ *
+ *  Products up to 4x4 are computed inline, the compiler unrolling the
+ *  constant loops, larger ones by arm_mat_mult_f32.
+ */
+template<uint16_t rows, uint16_t inner, uint16_t cols>
+struct MatrixMult_f32 {
+    static void mult(const float32_t *a, const float32_t *b, float32_t *c) {
+        if (rows > 4 || inner > 4 || cols > 4) {
+            arm_matrix_instance_f32 ma = {rows, inner, (float32_t *)a};
+            arm_matrix_instance_f32 mb = {inner, cols, (float32_t *)b};
+            arm_matrix_instance_f32 mc = {rows, cols, c};
+            arm_mat_mult_f32(&ma, &mb, &mc);
+            return;
+        }
+
+        for (uint16_t i = 0; i < rows; i++) {
+            for (uint16_t j = 0; j < cols; j++) {
+                float32_t sum = 0.0f;
+                for (uint16_t k = 0; k < inner; k++) {
+                    sum += a[i * inner + k] * b[k * cols + j];
+                }
+                c[i * cols + j] = sum;
+            }
+        }
+    }
+};
+
+/* The rotations and covariances of sensor fusion, written out */
+template<>
+struct MatrixMult_f32<3, 3, 1> {
+    static void mult(const float32_t *a, const float32_t *b, float32_t *c) {
+        c[0] = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        c[1] = a[3] * b[0] + a[4] * b[1] + a[5] * b[2];
+        c[2] = a[6] * b[0] + a[7] * b[1] + a[8] * b[2];
+    }
+};
+
+template<>
+struct MatrixMult_f32<3, 3, 3> {
+    static void mult(const float32_t *a, const float32_t *b, float32_t *c) {
+        for (uint16_t i = 0; i < 9; i += 3) {
+            c[i + 0] = a[i] * b[0] + a[i + 1] * b[3] + a[i + 2] * b[6];
+            c[i + 1] = a[i] * b[1] + a[i + 1] * b[4] + a[i + 2] * b[7];
+            c[i + 2] = a[i] * b[2] + a[i + 1] * b[5] + a[i + 2] * b[8];
+        }
+    }
+};
+
+template<>
+struct MatrixMult_f32<4, 4, 1> {
+    static void mult(const float32_t *a, const float32_t *b, float32_t *c) {
+        c[0] = a[0]  * b[0] + a[1]  * b[1] + a[2]  * b[2] + a[3]  * b[3];
+        c[1] = a[4]  * b[0] + a[5]  * b[1] + a[6]  * b[2] + a[7]  * b[3];
+        c[2] = a[8]  * b[0] + a[9]  * b[1] + a[10] * b[2] + a[11] * b[3];
+        c[3] = a[12] * b[0] + a[13] * b[1] + a[14] * b[2] + a[15] * b[3];
+    }
+};
+
+template<>
+struct MatrixMult_f32<4, 4, 4> {
+    static void mult(const float32_t *a, const float32_t *b, float32_t *c) {
+        for (uint16_t i = 0; i < 16; i += 4) {
+            c[i + 0] = a[i] * b[0] + a[i + 1] * b[4] + a[i + 2] * b[8]  + a[i + 3] * b[12];
+            c[i + 1] = a[i] * b[1] + a[i + 1] * b[5] + a[i + 2] * b[9]  + a[i + 3] * b[13];
+            c[i + 2] = a[i] * b[2] + a[i + 1] * b[6] + a[i + 2] * b[10] + a[i + 3] * b[14];
+            c[i + 3] = a[i] * b[3] + a[i + 1] * b[7] + a[i + 2] * b[11] + a[i + 3] * b[15];
+        }
+    }
+};
+
+/** Inverse of a size x size matrix, row-major
+ *
+ *  2x2 and 3x3 matrices are inverted through their adjugate, larger ones by
+ *  arm_mat_inverse_f32 on a copy, as it overwrites its source. b may be a,
+ *  to invert in place.
+ */
+template<uint16_t size>
+struct MatrixInverse_f32 {
+    static bool inverse(const float32_t *a, float32_t *b) {
+        float32_t copy[size * size];
+        memcpy(copy, a, sizeof(copy));
+        arm_matrix_instance_f32 ma = {size, size, copy};
+        arm_matrix_instance_f32 mb = {size, size, b};
+        return arm_mat_inverse_f32(&ma, &mb) == ARM_MATH_SUCCESS;
+    }
+};
+
+template<>
+struct MatrixInverse_f32<1> {
+    static bool inverse(const float32_t *a, float32_t *b) {
+        if (a[0] == 0.0f) {
+            return false;
+        }
+        b[0] = 1.0f / a[0];
+        return true;
+    }
+};
+
+template<>
+struct MatrixInverse_f32<2> {
+    static bool inverse(const float32_t *a, float32_t *b) {
+        float32_t det = a[0] * a[3] - a[1] * a[2];
+        if (det == 0.0f) {
+            return false;
+        }
+        float32_t inv = 1.0f / det;
+        float32_t r[4];
+        r[0] =  a[3] * inv;
+        r[1] = -a[1] * inv;
+        r[2] = -a[2] * inv;
+        r[3] =  a[0] * inv;
+        memcpy(b, r, sizeof(r));
+        return true;
+    }
+};
+
+template<>
+struct MatrixInverse_f32<3> {
+    static bool inverse(const float32_t *a, float32_t *b) {
+        float32_t c0 = a[4] * a[8] - a[5] * a[7];
+        float32_t c1 = a[5] * a[6] - a[3] * a[8];
+        float32_t c2 = a[3] * a[7] - a[4] * a[6];
+        float32_t det = a[0] * c0 + a[1] * c1 + a[2] * c2;
+        if (det == 0.0f) {
+            return false;
+        }
+        float32_t inv = 1.0f / det;
+        float32_t r[9];
+        r[0] = c0 * inv;
+        r[1] = (a[2] * a[7] - a[1] * a[8]) * inv;
+        r[2] = (a[1] * a[5] - a[2] * a[4]) * inv;
+        r[3] = c1 * inv;
+        r[4] = (a[0] * a[8] - a[2] * a[6]) * inv;
+        r[5] = (a[2] * a[3] - a[0] * a[5]) * inv;
+        r[6] = c2 * inv;
+        r[7] = (a[1] * a[6] - a[0] * a[7]) * inv;
+        r[8] = (a[0] * a[4] - a[1] * a[3]) * inv;
+        memcpy(b, r, sizeof(r));
+        return true;
+    }
+};
+
+/** Matrix of rows x cols float32_t, with its dimensions fixed at compile
+ *  time.
+ *
+ *  The elements are stored row-major, as in an arm_matrix_instance_f32, so
+ *  instance() lends them to the other arm_mat_ functions. Products of
+ *  matrices up to 4x4, such as the rotations and covariances of sensor
+ *  fusion, are computed inline, larger ones by CMSIS-DSP. Mismatched
+ *  dimensions do not compile:
+ *
+ *  @code
+ *  Matrix_f32<3, 3> rotation = Matrix_f32<3, 3>::identity();
+ *  Matrix_f32<3, 1> accel(sample);
+ *  Matrix_f32<3, 1> world = rotation * accel;
+ *  @endcode
+ *
+ *  The default constructor leaves the elements uninitialized.
+ */
+template<uint16_t rows, uint16_t cols>
+class Matrix_f32 {
+    typedef char dimensions_must_not_be_zero[(rows > 0) && (cols > 0) ? 1 : -1];
+
+public:
+    Matrix_f32() {
+    }
+
+    /** Copy rows * cols elements, row-major */
+    Matrix_f32(const float32_t *values) {
+        memcpy(_data, values, sizeof(_data));
+    }
+
+    static Matrix_f32 zeros() {
+        Matrix_f32 m;
+        memset(m._data, 0, sizeof(m._data));
+        return m;
+    }
+
+    static Matrix_f32 identity() {
+        typedef char identity_must_be_square[(rows == cols) ? 1 : -1];
+        (void)sizeof(identity_must_be_square);
+        Matrix_f32 m = zeros();
+        for (uint16_t i = 0; i < rows; i++) {
+            m._data[i * cols + i] = 1.0f;
+        }
+        return m;
+    }
+
+    float32_t &operator()(uint16_t row, uint16_t col) {
+        return _data[row * cols + col];
+    }
+
+    float32_t operator()(uint16_t row, uint16_t col) const {
+        return _data[row * cols + col];
+    }
+
+    float32_t *data() {
+        return _data;
+    }
+
+    const float32_t *data() const {
+        return _data;
+    }
+
+    /** The matrix as CMSIS-DSP sees it, sharing its elements */
+    arm_matrix_instance_f32 instance() {
+        arm_matrix_instance_f32 m = {rows, cols, _data};
+        return m;
+    }
+
+    Matrix_f32 &operator+=(const Matrix_f32 &b) {
+        for (uint32_t i = 0; i < rows * cols; i++) {
+            _data[i] += b._data[i];
+        }
+        return *this;
+    }
+
+    Matrix_f32 &operator-=(const Matrix_f32 &b) {
+        for (uint32_t i = 0; i < rows * cols; i++) {
+            _data[i] -= b._data[i];
+        }
+        return *this;
+    }
+
+    Matrix_f32 &operator*=(float32_t scale) {
+        for (uint32_t i = 0; i < rows * cols; i++) {
+            _data[i] *= scale;
+        }
+        return *this;
+    }
+
+    Matrix_f32 operator+(const Matrix_f32 &b) const {
+        Matrix_f32 m(*this);
+        m += b;
+        return m;
+    }
+
+    Matrix_f32 operator-(const Matrix_f32 &b) const {
+        Matrix_f32 m(*this);
+        m -= b;
+        return m;
+    }
+
+    Matrix_f32 operator*(float32_t scale) const {
+        Matrix_f32 m(*this);
+        m *= scale;
+        return m;
+    }
+
+    template<uint16_t b_cols>
+    Matrix_f32<rows, b_cols> operator*(const Matrix_f32<cols, b_cols> &b) const {
+        Matrix_f32<rows, b_cols> m;
+        MatrixMult_f32<rows, cols, b_cols>::mult(_data, b.data(), m.data());
+        return m;
+    }
+
+    Matrix_f32<cols, rows> transposed() const {
+        Matrix_f32<cols, rows> m;
+        for (uint16_t i = 0; i < rows; i++) {
+            for (uint16_t j = 0; j < cols; j++) {
+                m(j, i) = _data[i * cols + j];
+            }
+        }
+        return m;
+    }
+
+    /** Invert a square matrix
+     *
+     *  @param result   Destination for the inverse, may be this matrix
+     *  @return         false if the matrix is singular, result is then
+     *                  undefined
+     */
+    bool inverse(Matrix_f32 *result) const {
+        typedef char inverse_must_be_square[(rows == cols) ? 1 : -1];
+        (void)sizeof(inverse_must_be_square);
+        return MatrixInverse_f32<rows>::inverse(_data, result->_data);
+    }
+
+private:
+    float32_t _data[rows * cols];
+};
+
+}
+#endif
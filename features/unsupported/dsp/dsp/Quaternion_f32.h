@@ -0,0 +1,146 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef QUATERNION_F32_H
+#define QUATERNION_F32_H
+
+#include "arm_math.h"
+#include "Matrix_f32.h"
+#include "Vector_f32.h"
+
+namespace dsp {
+
+/** Quaternion w + xi + yj + zk, as an orientation for sensor fusion
+ *
+ *  A unit quaternion rotates vectors from the body to the reference
+ *  frame. integrate() advances it with the rates of a gyroscope:
+ *
+ *  @code
+ *  Quaternion_f32 attitude;
+ *
+ *  void on_gyro(const float32_t rate[3], float32_t dt) {
+ *      attitude.integrate(Vector_f32<3>(rate), dt);
+ *      Vector_f32<3> up = attitude.conjugate().rotate(gravity);
+ *  }
+ *  @endcode
+ */
+class Quaternion_f32 {
+public:
+    /** The identity rotation */
+    Quaternion_f32() : w(1.0f), x(0.0f), y(0.0f), z(0.0f) {
+    }
+
+    Quaternion_f32(float32_t w, float32_t x, float32_t y, float32_t z)
+        : w(w), x(x), y(y), z(z) {
+    }
+
+    /** Rotation by angle radians around a unit axis */
+    static Quaternion_f32 from_axis_angle(const Vector_f32<3> &axis, float32_t angle) {
+        float32_t s = arm_sin_f32(0.5f * angle);
+        return Quaternion_f32(arm_cos_f32(0.5f * angle), axis[0] * s, axis[1] * s, axis[2] * s);
+    }
+
+    /** Hamilton product, the rotation by b then by this */
+    Quaternion_f32 operator*(const Quaternion_f32 &b) const {
+        return Quaternion_f32(w * b.w - x * b.x - y * b.y - z * b.z,
+                              w * b.x + x * b.w + y * b.z - z * b.y,
+                              w * b.y - x * b.z + y * b.w + z * b.x,
+                              w * b.z + x * b.y - y * b.x + z * b.w);
+    }
+
+    /** The inverse rotation of a unit quaternion */
+    Quaternion_f32 conjugate() const {
+        return Quaternion_f32(w, -x, -y, -z);
+    }
+
+    float32_t norm() const {
+        float32_t n;
+        arm_sqrt_f32(w * w + x * x + y * y + z * z, &n);
+        return n;
+    }
+
+    /** Scale to a norm of 1, a null quaternion is left as is */
+    void normalize() {
+        float32_t n = norm();
+        if (n > 0.0f) {
+            float32_t inv = 1.0f / n;
+            w *= inv;
+            x *= inv;
+            y *= inv;
+            z *= inv;
+        }
+    }
+
+    /** Rotate a vector by a unit quaternion */
+    Vector_f32<3> rotate(const Vector_f32<3> &v) const {
+        /* v + 2w (q x v) + 2 q x (q x v), with q the vector part */
+        float32_t tx = 2.0f * (y * v[2] - z * v[1]);
+        float32_t ty = 2.0f * (z * v[0] - x * v[2]);
+        float32_t tz = 2.0f * (x * v[1] - y * v[0]);
+
+        Vector_f32<3> r;
+        r[0] = v[0] + w * tx + (y * tz - z * ty);
+        r[1] = v[1] + w * ty + (z * tx - x * tz);
+        r[2] = v[2] + w * tz + (x * ty - y * tx);
+        return r;
+    }
+
+    /** Rotation matrix of a unit quaternion */
+    Matrix_f32<3, 3> rotation_matrix() const {
+        Matrix_f32<3, 3> m;
+        m(0, 0) = 1.0f - 2.0f * (y * y + z * z);
+        m(0, 1) = 2.0f * (x * y - w * z);
+        m(0, 2) = 2.0f * (x * z + w * y);
+        m(1, 0) = 2.0f * (x * y + w * z);
+        m(1, 1) = 1.0f - 2.0f * (x * x + z * z);
+        m(1, 2) = 2.0f * (y * z - w * x);
+        m(2, 0) = 2.0f * (x * z - w * y);
+        m(2, 1) = 2.0f * (y * z + w * x);
+        m(2, 2) = 1.0f - 2.0f * (x * x + y * y);
+        return m;
+    }
+
+    /** Advance the orientation by the body rates of a gyroscope
+     *
+     *  First order integration of dq/dt = q * (0, rate) / 2, followed by a
+     *  normalization.
+     *
+     *  @param rate     Angular rates around the body x, y and z axes, in
+     *                  radians per second
+     *  @param dt       Time step in seconds
+     */
+    void integrate(const Vector_f32<3> &rate, float32_t dt) {
+        float32_t hx = 0.5f * dt * rate[0];
+        float32_t hy = 0.5f * dt * rate[1];
+        float32_t hz = 0.5f * dt * rate[2];
+
+        *this = Quaternion_f32(w - x * hx - y * hy - z * hz,
+                               x + w * hx + y * hz - z * hy,
+                               y + w * hy - x * hz + z * hx,
+                               z + w * hz + x * hy - y * hx);
+        normalize();
+    }
+
+    float32_t w, x, y, z;
+};
+
+}
+#endif
@@ -0,0 +1,212 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef SPECTRUM_F32_H
+#define SPECTRUM_F32_H
+
+#include <stdint.h>
+#include <string.h>
+#include "arm_math.h"
+#include "platform/toolchain.h"
+
+namespace dsp {
+
+/** Spectrum of a stream of samples, over frames of fft_size samples
+ *  starting every hop samples.
+ *
+ *  The samples come in blocks of any length, such as the halves of an
+ *  AnalogInStream buffer, at the uint16_t scale of AnalogIn::read_u16 or as
+ *  float32_t. Each frame is Hann windowed, transformed with
+ *  arm_rfft_fast_f32 and reduced to the amplitudes of its fft_size / 2
+ *  bins, bin k being at k * sample_rate / fft_size Hz. A sine of amplitude
+ *  A, centered on a bin, gives an amplitude of A in that bin.
+ *
+ *  process() stops consuming samples when a spectrum is ready, so the
+ *  spectrum can be read before the next one overwrites it:
+ *
+ *  @code
+ *  Spectrum_f32<1024> spectrum(10000);
+ *
+ *  void on_half(const uint16_t *half, uint32_t count) {
+ *      while (count) {
+ *          uint32_t n = spectrum.process(half, count);
+ *          half += n;
+ *          count -= n;
+ *          if (spectrum.ready()) {
+ *              float32_t hz, amplitude;
+ *              spectrum.peak(&hz, &amplitude);
+ *          }
+ *      }
+ *  }
+ *  @endcode
+ *
+ *  fft_size is a power of two from 32 to 4096, and hop at most fft_size;
+ *  frames overlap by fft_size - hop samples. The window, the frame and the
+ *  spectrum take 4 * fft_size floats.
+ */
+template<uint16_t fft_size, uint16_t hop = fft_size / 2>
+class Spectrum_f32 {
+    typedef char fft_size_must_be_a_power_of_two_from_32_to_4096[
+        (fft_size >= 32) && (fft_size <= 4096) && ((fft_size & (fft_size - 1)) == 0) ? 1 : -1];
+    typedef char hop_must_be_from_1_to_fft_size[(hop >= 1) && (hop <= fft_size) ? 1 : -1];
+
+public:
+    static const uint32_t bins = fft_size / 2;
+
+    Spectrum_f32(float32_t sample_rate) : _sample_rate(sample_rate) {
+        arm_rfft_fast_init_f32(&_fft, fft_size);
+        for (uint32_t i = 0; i < fft_size; i++) {
+            _window[i] = 0.5f - 0.5f * arm_cos_f32(2.0f * PI * i / fft_size);
+        }
+        reset();
+    }
+
+    /** Add samples at the scale of AnalogIn::read_u16
+     *
+     *  @param samples Samples, with stride between the samples of the stream,
+     *                 e.g. the number of channels of an AnalogInStream
+     *  @param count   Number of samples of the stream
+     *  @param stride  Distance between two samples in the buffer
+     *  @return Number of samples consumed, less than count if a spectrum
+     *          got ready
+     */
+    uint32_t process(const uint16_t *samples, uint32_t count, uint32_t stride = 1) {
+        uint32_t n = take(count);
+        float32_t *frame = &_frame[_filled];
+        for (uint32_t i = 0; i < n; i++) {
+            frame[i] = ((float32_t)*samples - 32768.0f) * (1.0f / 32768.0f);
+            samples += stride;
+        }
+        fill(n);
+        return n;
+    }
+
+    /** Add samples as floats
+     *
+     *  @param samples Samples
+     *  @param count   Number of samples
+     *  @return Number of samples consumed, less than count if a spectrum
+     *          got ready
+     */
+    uint32_t process(const float32_t *samples, uint32_t count) {
+        uint32_t n = take(count);
+        memcpy(&_frame[_filled], samples, n * sizeof(float32_t));
+        fill(n);
+        return n;
+    }
+
+    /** Check if a spectrum got ready during the last call to process()
+     */
+    bool ready() const {
+        return _ready;
+    }
+
+    /** Amplitudes of the latest spectrum
+     *
+     *  @return bins amplitudes, bin 0 being the DC offset
+     */
+    const float32_t *amplitudes() const {
+        return _spectrum;
+    }
+
+    /** Strongest bin of the latest spectrum, DC excluded
+     *
+     *  @param frequency Frequency of the peak in Hz, interpolated between bins
+     *  @param amplitude Amplitude of the peak bin, may be NULL
+     *  @return Index of the peak bin
+     */
+    uint32_t peak(float32_t *frequency, float32_t *amplitude = NULL) const {
+        float32_t max;
+        uint32_t index;
+        arm_max_f32((float32_t *)&_spectrum[1], bins - 1, &max, &index);
+        index += 1;
+
+        /* Parabola through the peak bin and its neighbours */
+        float32_t offset = 0.0f;
+        if (index < bins - 1) {
+            float32_t left = _spectrum[index - 1];
+            float32_t right = _spectrum[index + 1];
+            float32_t curvature = left - 2.0f * max + right;
+            if (curvature < 0.0f) {
+                offset = 0.5f * (left - right) / curvature;
+            }
+        }
+
+        if (frequency) {
+            *frequency = (index + offset) * _sample_rate / fft_size;
+        }
+        if (amplitude) {
+            *amplitude = max;
+        }
+        return index;
+    }
+
+    /** Drop the samples of the current frame and the latest spectrum
+     */
+    void reset(void) {
+        memset(_frame, 0, sizeof(_frame));
+        memset(_spectrum, 0, sizeof(_spectrum));
+        _filled = 0;
+        _ready = false;
+    }
+
+private:
+    uint32_t take(uint32_t count) {
+        _ready = false;
+        uint32_t room = fft_size - _filled;
+        return (count < room) ? count : room;
+    }
+
+    void fill(uint32_t n) {
+        _filled += n;
+        if (_filled < fft_size) {
+            return;
+        }
+
+        /* The FFT destroys its input, the frame keeps the overlap */
+        arm_mult_f32(_frame, _window, _work, fft_size);
+        arm_rfft_fast_f32(&_fft, _work, _spectrum, 0);
+
+        /* Bin 0 packs the real DC and Nyquist values; amplitudes in place */
+        float32_t dc = _spectrum[0];
+        arm_cmplx_mag_f32(_spectrum, _spectrum, bins);
+        /* Hann window coherent gain of 1/2, and the half of a real sine in each side */
+        arm_scale_f32(_spectrum, 4.0f / fft_size, _spectrum, bins);
+        _spectrum[0] = fabsf(dc) * (2.0f / fft_size);
+
+        /* Keep the overlap for the next frame */
+        memmove(_frame, &_frame[hop], (fft_size - hop) * sizeof(float32_t));
+        _filled = fft_size - hop;
+        _ready = true;
+    }
+
+    arm_rfft_fast_instance_f32 _fft;
+    float32_t _sample_rate;
+    uint32_t _filled;
+    bool _ready;
+    MBED_ALIGN(8) float32_t _window[fft_size];
+    MBED_ALIGN(8) float32_t _frame[fft_size];
+    MBED_ALIGN(8) float32_t _work[fft_size];
+    MBED_ALIGN(8) float32_t _spectrum[fft_size];
+};
+
+}
+#endif
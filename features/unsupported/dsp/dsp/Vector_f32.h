@@ -0,0 +1,102 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2006-2012 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef VECTOR_F32_H
+#define VECTOR_F32_H
+
+#include <stdint.h>
+#include "arm_math.h"
+#include "Matrix_f32.h"
+
+namespace dsp {
+
+/** Column vector of size float32_t, a size x 1 Matrix_f32
+ *
+ *  The results of the matrix operators convert back to a vector:
+ *
+ *  @code
+ *  Vector_f32<3> gyro(sample);
+ *  Vector_f32<3> rate = gyro - bias;
+ *  float32_t speed = rate.norm();
+ *  @endcode
+ *
+ *  The default constructor leaves the elements uninitialized.
+ */
+template<uint16_t size>
+class Vector_f32 : public Matrix_f32<size, 1> {
+public:
+    Vector_f32() {
+    }
+
+    /** Copy size elements */
+    Vector_f32(const float32_t *values) : Matrix_f32<size, 1>(values) {
+    }
+
+    Vector_f32(const Matrix_f32<size, 1> &m) : Matrix_f32<size, 1>(m) {
+    }
+
+    static Vector_f32 zeros() {
+        return Matrix_f32<size, 1>::zeros();
+    }
+
+    float32_t &operator[](uint16_t i) {
+        return this->data()[i];
+    }
+
+    float32_t operator[](uint16_t i) const {
+        return this->data()[i];
+    }
+
+    float32_t dot(const Vector_f32 &b) const {
+        const float32_t *a = this->data();
+        float32_t sum = 0.0f;
+        for (uint16_t i = 0; i < size; i++) {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    float32_t norm() const {
+        float32_t n;
+        arm_sqrt_f32(dot(*this), &n);
+        return n;
+    }
+
+    /** Scale to a norm of 1, a null vector is left as is */
+    void normalize() {
+        float32_t n = norm();
+        if (n > 0.0f) {
+            *this *= 1.0f / n;
+        }
+    }
+};
+
+/** Cross product of two 3 vectors */
+inline Vector_f32<3> cross(const Vector_f32<3> &a, const Vector_f32<3> &b) {
+    Vector_f32<3> c;
+    c[0] = a[1] * b[2] - a[2] * b[1];
+    c[1] = a[2] * b[0] - a[0] * b[2];
+    c[2] = a[0] * b[1] - a[1] * b[0];
+    return c;
+}
+
+}
+#endif
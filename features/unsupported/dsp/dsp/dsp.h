@@ -26,7 +26,22 @@
 #include "arm_math.h"
 
 #include "FIR_f32.h"
+#include "FIR_q15.h"
+#include "FIR_q31.h"
+#include "Biquad_f32.h"
+#include "Biquad_q15.h"
+#include "Biquad_q31.h"
+#include "FIRDecimator_f32.h"
+#include "FIRDecimator_q15.h"
+#include "FIRDecimator_q31.h"
+#include "FIRInterpolator_f32.h"
+#include "FIRInterpolator_q15.h"
+#include "FIRInterpolator_q31.h"
 #include "Sine_f32.h"
+#include "Spectrum_f32.h"
+#include "Matrix_f32.h"
+#include "Vector_f32.h"
+#include "Quaternion_f32.h"
 
 using namespace dsp;
 
@@ -0,0 +1,106 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_BLOCKDEVICE_H
+#define MBED_BLOCKDEVICE_H
+
+#include <stdint.h>
+
+/** Error codes of the block devices, 0 is success */
+enum bd_error {
+    BD_ERROR_OK           = 0,      /*!< no error */
+    BD_ERROR_DEVICE_ERROR = -4001,  /*!< the device failed or is not initialized */
+    BD_ERROR_PARAMETER    = -4002,  /*!< blocks outside the device */
+    BD_ERROR_NO_MEMORY    = -4003,  /*!< a buffer could not be allocated */
+};
+
+/** A storage addressed in fixed size blocks
+ *
+ * FATFileSystem and USBMSDBlockDevice work on a BlockDevice, and layers
+ * such as CacheBlockDevice and BufferedBlockDevice are BlockDevices on top
+ * of another one, so they stack:
+ *
+ * @code
+ * HeapBlockDevice heap(128);
+ * CacheBlockDevice cache(&heap, 8);
+ * BufferedBlockDevice buffered(&cache, 4);
+ * FATFileSystem fs("fs", &buffered);
+ * @endcode
+ *
+ * The block devices are not thread safe, their user serializes the calls
+ * (FATFileSystem holds its lock around them).
+ */
+class BlockDevice {
+public:
+    virtual ~BlockDevice() {}
+
+    /** Initialize the device, and the devices below it
+     *
+     * @return 0 on success or a bd_error
+     */
+    virtual int init() = 0;
+
+    /** Write back anything held and release the device
+     *
+     * @return 0 on success or a bd_error
+     */
+    virtual int deinit() = 0;
+
+    /** Read blocks
+     *
+     * @param buffer The blocks read, count * block_size() bytes
+     * @param block  The first block
+     * @param count  The number of blocks
+     * @return 0 on success or a bd_error
+     */
+    virtual int read(uint8_t *buffer, uint32_t block, uint32_t count) = 0;
+
+    /** Write blocks
+     *
+     * A layer may hold the data and write it to the device later, at the
+     * latest on sync().
+     *
+     * @param buffer The blocks to write, count * block_size() bytes
+     * @param block  The first block
+     * @param count  The number of blocks
+     * @return 0 on success or a bd_error
+     */
+    virtual int write(const uint8_t *buffer, uint32_t block, uint32_t count) = 0;
+
+    /** Write everything held down to the storage
+     *
+     * @return 0 on success or a bd_error
+     */
+    virtual int sync() { return BD_ERROR_OK; }
+
+    /** Size of a block in bytes, valid after init() */
+    virtual uint32_t block_size() const = 0;
+
+    /** Number of blocks of the device, valid after init() */
+    virtual uint32_t block_count() const = 0;
+
+protected:
+    bool is_valid(uint32_t block, uint32_t count) const {
+        return count && block < block_count() && count <= block_count() - block;
+    }
+};
+
+#endif
@@ -0,0 +1,163 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "BufferedBlockDevice.h"
+#include "us_ticker_api.h"
+#include <string.h>
+#include <new>
+
+BufferedBlockDevice::BufferedBlockDevice(BlockDevice *bd, uint32_t blocks, uint32_t flush_ms) :
+    _bd(bd), _capacity(blocks), _flush_us(flush_ms * 1000), _buffer(NULL),
+    _start(0), _count(0), _dirty_since(0) {
+}
+
+BufferedBlockDevice::~BufferedBlockDevice() {
+    delete[] _buffer;
+}
+
+int BufferedBlockDevice::init() {
+    int err = _bd->init();
+    if (err) {
+        return err;
+    }
+
+    // without a buffer it is a pass through
+    if (!_buffer && _capacity) {
+        _buffer = new (std::nothrow) uint8_t[_capacity * _bd->block_size()];
+        if (!_buffer) {
+            return BD_ERROR_NO_MEMORY;
+        }
+    }
+    _count = 0;
+    return BD_ERROR_OK;
+}
+
+int BufferedBlockDevice::deinit() {
+    int err = sync();
+    if (err) {
+        return err;
+    }
+    return _bd->deinit();
+}
+
+int BufferedBlockDevice::flush() {
+    if (_count == 0) {
+        return BD_ERROR_OK;
+    }
+
+    int err = _bd->write(_buffer, _start, _count);
+    if (err) {
+        return err;
+    }
+    _count = 0;
+    return BD_ERROR_OK;
+}
+
+int BufferedBlockDevice::flush_if_old() {
+    if (_count && _flush_us && us_ticker_read() - _dirty_since >= _flush_us) {
+        return flush();
+    }
+    return BD_ERROR_OK;
+}
+
+int BufferedBlockDevice::sync() {
+    int err = flush();
+    if (err) {
+        return err;
+    }
+    return _bd->sync();
+}
+
+int BufferedBlockDevice::read(uint8_t *buffer, uint32_t block, uint32_t count) {
+    if (!_buffer) {
+        return _bd->read(buffer, block, count);
+    }
+    if (!is_valid(block, count)) {
+        return BD_ERROR_PARAMETER;
+    }
+
+    int err = flush_if_old();
+    if (err) {
+        return err;
+    }
+
+    uint32_t size = _bd->block_size();
+    uint32_t end = block + count;
+    uint32_t run_end = _start + _count;
+
+    // all of it in the run
+    if (_count && block >= _start && end <= run_end) {
+        memcpy(buffer, _buffer + (block - _start) * size, count * size);
+        return BD_ERROR_OK;
+    }
+
+    err = _bd->read(buffer, block, count);
+    if (err) {
+        return err;
+    }
+
+    // the buffered blocks are newer than the device
+    if (_count && block < run_end && end > _start) {
+        uint32_t first = (block > _start) ? block : _start;
+        uint32_t last = (end < run_end) ? end : run_end;
+        memcpy(buffer + (first - block) * size, _buffer + (first - _start) * size, (last - first) * size);
+    }
+    return BD_ERROR_OK;
+}
+
+int BufferedBlockDevice::write(const uint8_t *buffer, uint32_t block, uint32_t count) {
+    if (!_buffer) {
+        return _bd->write(buffer, block, count);
+    }
+    if (!is_valid(block, count)) {
+        return BD_ERROR_PARAMETER;
+    }
+
+    int err = flush_if_old();
+    if (err) {
+        return err;
+    }
+
+    // a write that neither rewrites nor extends the run starts a new one
+    if (_count && (block < _start || block > _start + _count ||
+                   block + count > _start + _capacity)) {
+        err = flush();
+        if (err) {
+            return err;
+        }
+    }
+
+    if (count > _capacity) {
+        return _bd->write(buffer, block, count);
+    }
+
+    if (_count == 0) {
+        _start = block;
+        _dirty_since = us_ticker_read();
+    }
+
+    uint32_t size = _bd->block_size();
+    memcpy(_buffer + (block - _start) * size, buffer, count * size);
+    if (block - _start + count > _count) {
+        _count = block - _start + count;
+    }
+    return BD_ERROR_OK;
+}
@@ -0,0 +1,79 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_BUFFEREDBLOCKDEVICE_H
+#define MBED_BUFFEREDBLOCKDEVICE_H
+
+#include "BlockDevice.h"
+
+/** A write-back buffer in front of another device
+ *
+ * Writes collect in RAM as one run of consecutive blocks: rewriting a
+ * block of the run or extending it costs nothing, and the run goes to
+ * the device in a single multiple block write. The run is written when
+ * - sync() or deinit() is called (FATFileSystem syncs on fflush and fclose)
+ * - a write does not extend the run, or the run would outgrow the buffer
+ * - with a flush period, the first access after the run is that old
+ *
+ * Reads see the buffered blocks. Until the run is written a power loss
+ * loses it, as with any write-back cache.
+ */
+class BufferedBlockDevice : public BlockDevice {
+public:
+
+    /** Create a write-back buffer above a device
+     *
+     * @param bd       The device written
+     * @param blocks   The number of blocks buffered, allocated on init()
+     * @param flush_ms Age at which an access writes the run, 0 to only
+     *                 write it when needed or on sync()
+     */
+    BufferedBlockDevice(BlockDevice *bd, uint32_t blocks, uint32_t flush_ms = 0);
+    virtual ~BufferedBlockDevice();
+
+    virtual int init();
+    virtual int deinit();
+    virtual int read(uint8_t *buffer, uint32_t block, uint32_t count);
+    virtual int write(const uint8_t *buffer, uint32_t block, uint32_t count);
+    virtual int sync();
+    virtual uint32_t block_size() const { return _bd->block_size(); }
+    virtual uint32_t block_count() const { return _bd->block_count(); }
+
+    /** Write the buffered run to the device, without syncing the device
+     *
+     * @return 0 on success or the error of the device, the run is then
+     *         kept to be written again
+     */
+    int flush();
+
+private:
+    int flush_if_old();
+
+    BlockDevice *_bd;
+    uint32_t _capacity;
+    uint32_t _flush_us;
+    uint8_t *_buffer;
+    uint32_t _start;
+    uint32_t _count;
+    uint32_t _dirty_since;
+};
+
+#endif
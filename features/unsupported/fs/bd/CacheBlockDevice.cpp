@@ -0,0 +1,191 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "CacheBlockDevice.h"
+#include <string.h>
+#include <new>
+
+// tag of an empty entry, no device has that many blocks
+#define CACHE_EMPTY     0xFFFFFFFF
+
+CacheBlockDevice::CacheBlockDevice(BlockDevice *bd, uint32_t blocks) :
+    _bd(bd), _entries(blocks), _data(NULL), _tags(NULL), _used(NULL),
+    _clock(0), _hits(0), _misses(0) {
+}
+
+CacheBlockDevice::~CacheBlockDevice() {
+    delete[] _data;
+    delete[] _tags;
+    delete[] _used;
+}
+
+int CacheBlockDevice::init() {
+    int err = _bd->init();
+    if (err) {
+        return err;
+    }
+
+    // without entries it is a pass through
+    if (!_data && _entries) {
+        _data = new (std::nothrow) uint8_t[_entries * _bd->block_size()];
+        _tags = new (std::nothrow) uint32_t[_entries];
+        _used = new (std::nothrow) uint32_t[_entries];
+        if (!_data || !_tags || !_used) {
+            delete[] _data;
+            delete[] _tags;
+            delete[] _used;
+            _data = NULL;
+            _tags = NULL;
+            _used = NULL;
+            return BD_ERROR_NO_MEMORY;
+        }
+    }
+    invalidate();
+    return BD_ERROR_OK;
+}
+
+int CacheBlockDevice::deinit() {
+    invalidate();
+    return _bd->deinit();
+}
+
+void CacheBlockDevice::invalidate() {
+    if (!_tags) {
+        return;
+    }
+    for (uint32_t i = 0; i < _entries; i++) {
+        _tags[i] = CACHE_EMPTY;
+        _used[i] = 0;
+    }
+}
+
+void CacheBlockDevice::invalidate(uint32_t block, uint32_t count) {
+    if (!_tags) {
+        return;
+    }
+    for (uint32_t i = 0; i < _entries; i++) {
+        if (_tags[i] != CACHE_EMPTY && _tags[i] - block < count) {
+            _tags[i] = CACHE_EMPTY;
+            _used[i] = 0;
+        }
+    }
+}
+
+int CacheBlockDevice::find(uint32_t block) {
+    for (uint32_t i = 0; i < _entries; i++) {
+        if (_tags[i] == block) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int CacheBlockDevice::victim() {
+    uint32_t oldest = 0;
+    for (uint32_t i = 0; i < _entries; i++) {
+        if (_tags[i] == CACHE_EMPTY) {
+            return i;
+        }
+        // ages rather than stamps, so the clock may wrap
+        if (_clock - _used[i] > _clock - _used[oldest]) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+void CacheBlockDevice::store(uint32_t block, const uint8_t *data) {
+    int i = find(block);
+    if (i < 0) {
+        i = victim();
+        _tags[i] = block;
+    }
+    memcpy(_data + i * _bd->block_size(), data, _bd->block_size());
+    _used[i] = ++_clock;
+}
+
+int CacheBlockDevice::read(uint8_t *buffer, uint32_t block, uint32_t count) {
+    if (!_data) {
+        return _bd->read(buffer, block, count);
+    }
+    if (!is_valid(block, count)) {
+        return BD_ERROR_PARAMETER;
+    }
+
+    uint32_t size = _bd->block_size();
+    uint32_t b = 0;
+    while (b < count) {
+        int i = find(block + b);
+        if (i >= 0) {
+            memcpy(buffer + b * size, _data + i * size, size);
+            _used[i] = ++_clock;
+            _hits++;
+            b++;
+            continue;
+        }
+
+        // one device read for the run of misses
+        uint32_t run = 1;
+        while (b + run < count && find(block + b + run) < 0) {
+            run++;
+        }
+        int err = _bd->read(buffer + b * size, block + b, run);
+        if (err) {
+            return err;
+        }
+        _misses += run;
+
+        // a run larger than the cache keeps its last blocks
+        uint32_t first = (run > _entries) ? run - _entries : 0;
+        for (uint32_t r = first; r < run; r++) {
+            store(block + b + r, buffer + (b + r) * size);
+        }
+        b += run;
+    }
+    return BD_ERROR_OK;
+}
+
+int CacheBlockDevice::write(const uint8_t *buffer, uint32_t block, uint32_t count) {
+    if (!_data) {
+        return _bd->write(buffer, block, count);
+    }
+
+    int err = _bd->write(buffer, block, count);
+    if (err) {
+        // the device may hold either version now
+        invalidate(block, count);
+        return err;
+    }
+
+    // blocks just written are the likely next reads (FAT and directory
+    // sectors), except for large transfers that would flush the cache
+    uint32_t size = _bd->block_size();
+    for (uint32_t b = 0; b < count; b++) {
+        if (count <= _entries / 2 || find(block + b) >= 0) {
+            store(block + b, buffer + b * size);
+        }
+    }
+    return BD_ERROR_OK;
+}
+
+int CacheBlockDevice::sync() {
+    return _bd->sync();
+}
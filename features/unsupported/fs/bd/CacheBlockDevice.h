@@ -0,0 +1,87 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_CACHEBLOCKDEVICE_H
+#define MBED_CACHEBLOCKDEVICE_H
+
+#include "BlockDevice.h"
+
+/** A least recently used cache of the blocks of another device
+ *
+ * Reads of cached blocks are served from RAM, the misses of a read are
+ * fetched in runs of consecutive blocks and replace the least recently
+ * used entries. Writes go straight through and update the cache, so
+ * nothing is ever lost; put a BufferedBlockDevice above it to hold writes.
+ *
+ * Lookups walk the entries, a cache of a few tens of blocks (the FAT and
+ * directory sectors being used) is what it is for.
+ */
+class CacheBlockDevice : public BlockDevice {
+public:
+
+    /** Create a cache above a device
+     *
+     * @param bd     The device cached
+     * @param blocks The number of blocks cached, allocated on init()
+     */
+    CacheBlockDevice(BlockDevice *bd, uint32_t blocks);
+    virtual ~CacheBlockDevice();
+
+    virtual int init();
+    virtual int deinit();
+    virtual int read(uint8_t *buffer, uint32_t block, uint32_t count);
+    virtual int write(const uint8_t *buffer, uint32_t block, uint32_t count);
+    virtual int sync();
+    virtual uint32_t block_size() const { return _bd->block_size(); }
+    virtual uint32_t block_count() const { return _bd->block_count(); }
+
+    /** Drop all the cached blocks, when the device changed underneath */
+    void invalidate();
+
+    /** Drop the cached copies of blocks written to the device directly
+     *
+     * @param block The first block
+     * @param count The number of blocks
+     */
+    void invalidate(uint32_t block, uint32_t count);
+
+    /** Number of blocks read from the cache */
+    uint32_t hits() const { return _hits; }
+
+    /** Number of blocks read from the device */
+    uint32_t misses() const { return _misses; }
+
+private:
+    int find(uint32_t block);
+    int victim();
+    void store(uint32_t block, const uint8_t *data);
+
+    BlockDevice *_bd;
+    uint32_t _entries;
+    uint8_t *_data;
+    uint32_t *_tags;
+    uint32_t *_used;
+    uint32_t _clock;
+    uint32_t _hits;
+    uint32_t _misses;
+};
+
+#endif
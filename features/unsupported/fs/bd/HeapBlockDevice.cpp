@@ -0,0 +1,70 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "HeapBlockDevice.h"
+#include <string.h>
+#include <new>
+
+HeapBlockDevice::HeapBlockDevice(uint32_t count, uint32_t size) :
+    _count(count), _size(size), _data(NULL) {
+}
+
+HeapBlockDevice::~HeapBlockDevice() {
+    delete[] _data;
+}
+
+int HeapBlockDevice::init() {
+    if (!_data) {
+        _data = new (std::nothrow) uint8_t[_count * _size];
+        if (!_data) {
+            return BD_ERROR_NO_MEMORY;
+        }
+        memset(_data, 0, _count * _size);
+    }
+    return BD_ERROR_OK;
+}
+
+int HeapBlockDevice::deinit() {
+    // the content is kept until the object goes, like on a real device
+    return BD_ERROR_OK;
+}
+
+int HeapBlockDevice::read(uint8_t *buffer, uint32_t block, uint32_t count) {
+    if (!_data) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+    if (!is_valid(block, count)) {
+        return BD_ERROR_PARAMETER;
+    }
+    memcpy(buffer, _data + block * _size, count * _size);
+    return BD_ERROR_OK;
+}
+
+int HeapBlockDevice::write(const uint8_t *buffer, uint32_t block, uint32_t count) {
+    if (!_data) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+    if (!is_valid(block, count)) {
+        return BD_ERROR_PARAMETER;
+    }
+    memcpy(_data + block * _size, buffer, count * _size);
+    return BD_ERROR_OK;
+}
@@ -0,0 +1,55 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_HEAPBLOCKDEVICE_H
+#define MBED_HEAPBLOCKDEVICE_H
+
+#include "BlockDevice.h"
+
+/** A block device in RAM, allocated from the heap on init()
+ *
+ * Blocks never written read as zeros.
+ */
+class HeapBlockDevice : public BlockDevice {
+public:
+
+    /** Create a block device in RAM
+     *
+     * @param count The number of blocks
+     * @param size  The size of a block in bytes
+     */
+    HeapBlockDevice(uint32_t count, uint32_t size = 512);
+    virtual ~HeapBlockDevice();
+
+    virtual int init();
+    virtual int deinit();
+    virtual int read(uint8_t *buffer, uint32_t block, uint32_t count);
+    virtual int write(const uint8_t *buffer, uint32_t block, uint32_t count);
+    virtual uint32_t block_size() const { return _size; }
+    virtual uint32_t block_count() const { return _count; }
+
+private:
+    uint32_t _count;
+    uint32_t _size;
+    uint8_t *_data;
+};
+
+#endif
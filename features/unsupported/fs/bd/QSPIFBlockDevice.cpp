@@ -0,0 +1,245 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "QSPIFBlockDevice.h"
+
+#if DEVICE_QSPI
+
+#include <string.h>
+#include "us_ticker_api.h"
+
+// JEDEC commands
+#define QSPIF_READ_ID       0x9F
+#define QSPIF_READ_STATUS   0x05
+#define QSPIF_WRITE_ENABLE  0x06
+#define QSPIF_ERASE_4K      0x20
+#define QSPIF_PROGRAM       0x02
+#define QSPIF_FAST_READ     0x0B
+#define QSPIF_QUAD_READ     0x6B
+
+#define QSPIF_STATUS_WIP    0x01
+
+#define QSPIF_SUBSECTOR     4096
+#define QSPIF_PAGE          256
+#define QSPIF_READ_DUMMY    8
+// the most 3 byte addresses reach
+#define QSPIF_MAX_SIZE      (16UL * 1024 * 1024)
+
+// worst cases of the datasheets
+#define QSPIF_PROGRAM_TIMEOUT_US    5000
+#define QSPIF_ERASE_TIMEOUT_US      800000
+
+QSPIFBlockDevice::QSPIFBlockDevice(PinName io0, PinName io1, PinName io2, PinName io3, PinName sclk, PinName csel,
+                                   uint32_t freq) :
+    _freq(freq), _size(0), _mapped(NULL) {
+    _pins[0] = io0;
+    _pins[1] = io1;
+    _pins[2] = io2;
+    _pins[3] = io3;
+    _pins[4] = sclk;
+    _pins[5] = csel;
+}
+
+QSPIFBlockDevice::~QSPIFBlockDevice() {
+    deinit();
+}
+
+int QSPIFBlockDevice::init() {
+    if (_size) {
+        return BD_ERROR_OK;
+    }
+
+    // the size isn't known before asking the flash, any will do for that
+    if (qspi_init(&_qspi, _pins[0], _pins[1], _pins[2], _pins[3], _pins[4], _pins[5],
+                  _freq, QSPIF_MAX_SIZE) != 0) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+
+    // manufacturer, memory type, capacity as a power of two
+    uint8_t id[3];
+    if (_command(QSPIF_READ_ID, NULL, id, sizeof(id)) != 0 ||
+            id[2] < 16 || id[2] > 31) {
+        qspi_free(&_qspi);
+        return BD_ERROR_DEVICE_ERROR;
+    }
+
+    uint32_t size = 1UL << id[2];
+    if (size > QSPIF_MAX_SIZE) {
+        size = QSPIF_MAX_SIZE;
+    } else if (size < QSPIF_MAX_SIZE) {
+        qspi_free(&_qspi);
+        if (qspi_init(&_qspi, _pins[0], _pins[1], _pins[2], _pins[3], _pins[4], _pins[5],
+                      _freq, size) != 0) {
+            return BD_ERROR_DEVICE_ERROR;
+        }
+    }
+
+    _size = size;
+    _mapped = NULL;
+    return BD_ERROR_OK;
+}
+
+int QSPIFBlockDevice::deinit() {
+    if (_size) {
+        qspi_free(&_qspi);
+        _size = 0;
+        _mapped = NULL;
+    }
+    return BD_ERROR_OK;
+}
+
+uint32_t QSPIFBlockDevice::block_size() const {
+    return QSPIF_SUBSECTOR;
+}
+
+int QSPIFBlockDevice::read(uint8_t *buffer, uint32_t block, uint32_t count) {
+    if (!_size) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+    if (!is_valid(block, count)) {
+        return BD_ERROR_PARAMETER;
+    }
+
+    if (_mapped) {
+        memcpy(buffer, _mapped + block * QSPIF_SUBSECTOR, count * QSPIF_SUBSECTOR);
+        return BD_ERROR_OK;
+    }
+    return _read(buffer, block * QSPIF_SUBSECTOR, count * QSPIF_SUBSECTOR);
+}
+
+int QSPIFBlockDevice::write(const uint8_t *buffer, uint32_t block, uint32_t count) {
+    if (!_size) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+    if (!is_valid(block, count)) {
+        return BD_ERROR_PARAMETER;
+    }
+
+    // the commands leave memory-mapped mode
+    bool mapped = (_mapped != NULL);
+    _mapped = NULL;
+
+    int err = BD_ERROR_OK;
+    for (uint32_t addr = block * QSPIF_SUBSECTOR; !err && count; count--) {
+        err = _erase(addr);
+        for (uint32_t page = 0; !err && page < QSPIF_SUBSECTOR; page += QSPIF_PAGE) {
+            err = _program(buffer, addr, QSPIF_PAGE);
+            buffer += QSPIF_PAGE;
+            addr += QSPIF_PAGE;
+        }
+    }
+
+    if (mapped && !map() && !err) {
+        err = BD_ERROR_DEVICE_ERROR;
+    }
+    return err;
+}
+
+const uint8_t *QSPIFBlockDevice::map() {
+    if (!_size) {
+        return NULL;
+    }
+    if (!_mapped) {
+        qspi_command_t command;
+        const void *base;
+        _read_command(&command);
+        if (qspi_memory_map(&_qspi, &command, &base) != 0) {
+            return NULL;
+        }
+        _mapped = static_cast<const uint8_t *>(base);
+    }
+    return _mapped;
+}
+
+void QSPIFBlockDevice::_read_command(qspi_command_t *command) const {
+    bool quad = (_pins[2] != NC) && (_pins[3] != NC);
+
+    memset(command, 0, sizeof(*command));
+    command->instruction       = quad ? QSPIF_QUAD_READ : QSPIF_FAST_READ;
+    command->instruction_lines = QSPI_LINES_1;
+    command->address_lines     = QSPI_LINES_1;
+    command->address_size      = 3;
+    command->dummy_cycles      = QSPIF_READ_DUMMY;
+    command->data_lines        = quad ? QSPI_LINES_4 : QSPI_LINES_1;
+}
+
+int QSPIFBlockDevice::_command(uint8_t instruction, const void *tx, void *rx, uint32_t length) {
+    qspi_command_t command;
+    memset(&command, 0, sizeof(command));
+    command.instruction       = instruction;
+    command.instruction_lines = QSPI_LINES_1;
+    command.data_lines        = length ? QSPI_LINES_1 : QSPI_LINES_NONE;
+    return qspi_command(&_qspi, &command, tx, rx, length);
+}
+
+int QSPIFBlockDevice::_command_at(uint8_t instruction, uint32_t addr, const void *tx, uint32_t length) {
+    qspi_command_t command;
+    memset(&command, 0, sizeof(command));
+    command.instruction       = instruction;
+    command.instruction_lines = QSPI_LINES_1;
+    command.address           = addr;
+    command.address_lines     = QSPI_LINES_1;
+    command.address_size      = 3;
+    command.data_lines        = length ? QSPI_LINES_1 : QSPI_LINES_NONE;
+    return qspi_command(&_qspi, &command, tx, NULL, length);
+}
+
+int QSPIFBlockDevice::_read(uint8_t *buffer, uint32_t addr, uint32_t size) {
+    qspi_command_t command;
+    _read_command(&command);
+    command.address = addr;
+    if (qspi_command(&_qspi, &command, NULL, buffer, size) != 0) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+    return BD_ERROR_OK;
+}
+
+int QSPIFBlockDevice::_wait(uint32_t timeout_us) {
+    uint32_t start = us_ticker_read();
+    uint8_t status;
+    do {
+        if (_command(QSPIF_READ_STATUS, NULL, &status, 1) != 0) {
+            return BD_ERROR_DEVICE_ERROR;
+        }
+        if (!(status & QSPIF_STATUS_WIP)) {
+            return BD_ERROR_OK;
+        }
+    } while (us_ticker_read() - start < timeout_us);
+    return BD_ERROR_DEVICE_ERROR;
+}
+
+int QSPIFBlockDevice::_erase(uint32_t addr) {
+    if (_command(QSPIF_WRITE_ENABLE, NULL, NULL, 0) != 0 ||
+            _command_at(QSPIF_ERASE_4K, addr, NULL, 0) != 0) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+    return _wait(QSPIF_ERASE_TIMEOUT_US);
+}
+
+int QSPIFBlockDevice::_program(const uint8_t *buffer, uint32_t addr, uint32_t size) {
+    if (_command(QSPIF_WRITE_ENABLE, NULL, NULL, 0) != 0 ||
+            _command_at(QSPIF_PROGRAM, addr, buffer, size) != 0) {
+        return BD_ERROR_DEVICE_ERROR;
+    }
+    return _wait(QSPIF_PROGRAM_TIMEOUT_US);
+}
+
+#endif
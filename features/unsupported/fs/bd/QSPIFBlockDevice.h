@@ -0,0 +1,100 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_QSPIFBLOCKDEVICE_H
+#define MBED_QSPIFBLOCKDEVICE_H
+
+#include "BlockDevice.h"
+#include "qspi_api.h"
+
+#if DEVICE_QSPI
+
+/** A serial NOR flash on the quad SPI controller
+ *
+ * A block is a 4KB subsector, erased before it is written. With io2 and
+ * io3 the reads are quad output reads (0x6B), answered without setup by
+ * flashes like the N25Q128A of the DISCO_F746NG; flashes with a Quad
+ * Enable bit need it set beforehand. Flashes above 16MB are used up to
+ * 16MB, with 3 byte addresses.
+ *
+ * map() puts the flash in the address space, to read it like memory or
+ * execute code from it in place:
+ *
+ * @code
+ * QSPIFBlockDevice flash(QSPI_FLASH_IO0, QSPI_FLASH_IO1, QSPI_FLASH_IO2, QSPI_FLASH_IO3,
+ *                        QSPI_FLASH_SCK, QSPI_FLASH_CSN);
+ * flash.init();
+ * const uint8_t *image = flash.map();
+ * @endcode
+ */
+class QSPIFBlockDevice : public BlockDevice {
+public:
+
+    /** Create a block device on a QSPI flash
+     *
+     * @param io0  The first data pin
+     * @param io1  The second data pin
+     * @param io2  The third data pin, or NC for single line reads
+     * @param io3  The fourth data pin, or NC for single line reads
+     * @param sclk The clock pin
+     * @param csel The chip select pin
+     * @param freq The highest clock of the flash
+     */
+    QSPIFBlockDevice(PinName io0, PinName io1, PinName io2, PinName io3, PinName sclk, PinName csel,
+                     uint32_t freq = 40000000);
+    virtual ~QSPIFBlockDevice();
+
+    virtual int init();
+    virtual int deinit();
+    virtual int read(uint8_t *buffer, uint32_t block, uint32_t count);
+    virtual int write(const uint8_t *buffer, uint32_t block, uint32_t count);
+    virtual uint32_t block_size() const;
+    virtual uint32_t block_count() const { return _size / block_size(); }
+
+    /** Map the flash in the address space
+     *
+     * The flash stays mapped across later calls, writes map it again once
+     * done. Reads of a mapped flash are copies from the window.
+     *
+     * @return The start of the window, block_count() * block_size() bytes,
+     *         or NULL on error
+     */
+    const uint8_t *map();
+
+private:
+    int _command(uint8_t instruction, const void *tx, void *rx, uint32_t length);
+    int _command_at(uint8_t instruction, uint32_t addr, const void *tx, uint32_t length);
+    int _read(uint8_t *buffer, uint32_t addr, uint32_t size);
+    int _wait(uint32_t timeout_us);
+    int _erase(uint32_t addr);
+    int _program(const uint8_t *buffer, uint32_t addr, uint32_t size);
+    void _read_command(qspi_command_t *command) const;
+
+    PinName _pins[6];
+    uint32_t _freq;
+    qspi_t _qspi;
+    uint32_t _size;
+    const uint8_t *_mapped;
+};
+
+#endif
+
+#endif
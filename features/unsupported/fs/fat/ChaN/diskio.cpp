@@ -68,6 +68,7 @@ DRESULT disk_write (
 )
 {
     debug_if(FFS_DBG, "disk_write(sector %d, count %d) on pdrv [%d]\n", sector, count, pdrv);
+    FATFileSystem::_ffs[pdrv]->cache_drop(sector, count);
     if (FATFileSystem::_ffs[pdrv]->disk_write((uint8_t*)buff, sector, count))
         return RES_PARERR;
     else
@@ -75,6 +76,38 @@ DRESULT disk_write (
 }
 #endif
 
+/*-----------------------------------------------------------------------*/
+/* Read/Write the Sector of the Window                                   */
+/*-----------------------------------------------------------------------*/
+
+DRESULT disk_read_window (
+    BYTE pdrv,       /* Physical drive nmuber to identify the drive */
+    BYTE* buff,      /* Data buffer to store read data */
+    DWORD sector     /* Sector address in LBA */
+)
+{
+    debug_if(FFS_DBG, "disk_read_window(sector %d) on pdrv [%d]\n", sector, pdrv);
+    if (FATFileSystem::_ffs[pdrv]->cache_read((uint8_t*)buff, sector))
+        return RES_PARERR;
+    else
+        return RES_OK;
+}
+
+#if _USE_WRITE
+DRESULT disk_write_window (
+    BYTE pdrv,           /* Physical drive nmuber to identify the drive */
+    const BYTE* buff,    /* Data to be written */
+    DWORD sector         /* Sector address in LBA */
+)
+{
+    debug_if(FFS_DBG, "disk_write_window(sector %d) on pdrv [%d]\n", sector, pdrv);
+    if (FATFileSystem::_ffs[pdrv]->cache_write((uint8_t*)buff, sector))
+        return RES_PARERR;
+    else
+        return RES_OK;
+}
+#endif
+
 /*-----------------------------------------------------------------------*/
 /* Miscellaneous Functions                                               */
 /*-----------------------------------------------------------------------*/
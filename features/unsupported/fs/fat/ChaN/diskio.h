@@ -37,6 +37,9 @@ DSTATUS disk_status (BYTE pdrv);
 DRESULT disk_read (BYTE pdrv, BYTE* buff, DWORD sector, UINT count);
 DRESULT disk_write (BYTE pdrv, const BYTE* buff, DWORD sector, UINT count);
 DRESULT disk_ioctl (BYTE pdrv, BYTE cmd, void* buff);
+/* The sectors of the window (FAT and directory), through the sector cache */
+DRESULT disk_read_window (BYTE pdrv, BYTE* buff, DWORD sector);
+DRESULT disk_write_window (BYTE pdrv, const BYTE* buff, DWORD sector);
 
 
 /* Disk Status Bits (DSTATUS) */
@@ -24,17 +24,20 @@
 #include "mbed_debug.h"
 
 #include "FATFileHandle.h"
+#include <new>
 
-FATFileHandle::FATFileHandle(FIL fh, PlatformMutex * mutex): _mutex(mutex) {
+FATFileHandle::FATFileHandle(FIL fh, PlatformMutex * mutex): _mutex(mutex), _linkmap(NULL) {
     _fh = fh;
 }
 
 int FATFileHandle::close() {
+    int drained = drain_buffer();
     lock();
     int retval = f_close(&_fh);
+    delete[] _linkmap;
     unlock();
     delete this;
-    return retval;
+    return drained ? drained : retval;
 }
 
 ssize_t FATFileHandle::write(const void* buffer, size_t length) {
@@ -106,6 +109,62 @@ off_t FATFileHandle::flen() {
     return size;
 }
 
+int FATFileHandle::expand(off_t size, bool allocate) {
+    lock();
+    FRESULT res = f_expand(&_fh, size, allocate ? 1 : 0);
+    if (res) {
+        debug_if(FFS_DBG, "f_expand() failed: %d\n", res);
+        unlock();
+        return -1;
+    }
+    unlock();
+    return 0;
+}
+
+int FATFileHandle::truncate() {
+    lock();
+    FRESULT res = f_truncate(&_fh);
+    if (res) {
+        debug_if(FFS_DBG, "f_truncate() failed: %d\n", res);
+        unlock();
+        return -1;
+    }
+    unlock();
+    return 0;
+}
+
+int FATFileHandle::create_linkmap(uint32_t entries) {
+    lock();
+    _fh.cltbl = NULL;
+    delete[] _linkmap;
+    _linkmap = NULL;
+    if (entries == 0) {
+        unlock();
+        return 0;
+    }
+
+    _linkmap = new (std::nothrow) DWORD[entries];
+    if (!_linkmap) {
+        unlock();
+        return -1;
+    }
+    _linkmap[0] = entries;
+    _fh.cltbl = _linkmap;
+    FRESULT res = f_lseek(&_fh, CREATE_LINKMAP);
+    if (res) {
+        // the size needed is left in the first entry
+        int needed = (res == FR_NOT_ENOUGH_CORE) ? (int)_linkmap[0] : -1;
+        debug_if(FFS_DBG, "create linkmap failed: %d\n", res);
+        _fh.cltbl = NULL;
+        delete[] _linkmap;
+        _linkmap = NULL;
+        unlock();
+        return needed;
+    }
+    unlock();
+    return 0;
+}
+
 void FATFileHandle::lock() {
     _mutex->lock();
 }
@@ -39,6 +39,39 @@ public:
     virtual int fsync();
     virtual off_t flen();
 
+    /** Allocate a contiguous area to the empty file
+     *
+     * The file becomes size bytes long, of undefined content, on
+     * consecutive clusters: writing it from the start updates no FAT
+     * sector, and a link map of it has a single entry. Write it from the
+     * start and truncate() it where the data ends.
+     *
+     * @param size     The size of the file
+     * @param allocate false to only start the next new cluster chain of
+     *                 the volume on a free area that large
+     * @return 0 on success, -1 if the file is not empty or no contiguous
+     *         area is free
+     */
+    int expand(off_t size, bool allocate = true);
+
+    /** Cut the file at the current position
+     *
+     * @return 0 on success, -1 on error
+     */
+    int truncate();
+
+    /** Map the cluster chain of the file in RAM for fast seeks
+     *
+     * Seeks then follow the map instead of the FAT. The file cannot grow
+     * while it is mapped, writes end at its size.
+     *
+     * @param entries The size of the map, 2 entries per fragment of the
+     *                file plus 1, or 0 to drop the map
+     * @return 0 on success, the number of entries needed if that is more,
+     *         -1 on error
+     */
+    int create_linkmap(uint32_t entries);
+
 protected:
 
     virtual void lock();
@@ -46,6 +79,7 @@ protected:
 
     FIL _fh;
     PlatformMutex * _mutex;
+    DWORD *_linkmap;
 
 };
 
@@ -28,6 +28,8 @@
 #include "FATFileHandle.h"
 #include "FATDirHandle.h"
 #include "critical.h"
+#include "CacheBlockDevice.h"
+#include <new>
 
 DWORD get_fattime(void) {
     time_t rawtime;
@@ -41,6 +43,33 @@ DWORD get_fattime(void) {
          | (DWORD)(ptm->tm_sec/2    );
 }
 
+/* The disk_ functions of a FATFileSystem as a block device, for the
+ * sector cache */
+class FATDiskBlockDevice : public BlockDevice {
+public:
+    FATDiskBlockDevice(FATFileSystem *fs) : _fs(fs) {}
+
+    // FatFs initializes the disk itself
+    virtual int init() { return BD_ERROR_OK; }
+    virtual int deinit() { return BD_ERROR_OK; }
+
+    virtual int read(uint8_t *buffer, uint32_t block, uint32_t count) {
+        return _fs->disk_read(buffer, block, count) ? BD_ERROR_DEVICE_ERROR : BD_ERROR_OK;
+    }
+
+    virtual int write(const uint8_t *buffer, uint32_t block, uint32_t count) {
+        return _fs->disk_write(buffer, block, count) ? BD_ERROR_DEVICE_ERROR : BD_ERROR_OK;
+    }
+
+    virtual uint32_t block_size() const { return _MAX_SS; }
+
+    // FatFs keeps to the volume, the last block is left for the empty tag
+    virtual uint32_t block_count() const { return 0xFFFFFFFF; }
+
+private:
+    FATFileSystem *_fs;
+};
+
 FATFileSystem *FATFileSystem::_ffs[_VOLUMES] = {0};
 static PlatformMutex * mutex = NULL;
 
@@ -59,7 +88,9 @@ PlatformMutex * get_fat_mutex() {
     return mutex;
 }
 
-FATFileSystem::FATFileSystem(const char* n) : FileSystemLike(n), _mutex(get_fat_mutex()) {
+FATFileSystem::FATFileSystem(const char* n, BlockDevice *bd) :
+    FileSystemLike(n), _mutex(get_fat_mutex()), _bd(bd), _bd_initialized(false),
+    _disk(NULL), _cache(NULL) {
     lock();
     debug_if(FFS_DBG, "FATFileSystem(%s)\n", n);
     for(int i=0; i<_VOLUMES; i++) {
@@ -85,6 +116,8 @@ FATFileSystem::~FATFileSystem() {
             f_mount(NULL, _fsid, 0);
         }
     }
+    delete _cache;
+    delete _disk;
     unlock();
 }
 
@@ -152,6 +185,7 @@ int FATFileSystem::rename(const char *oldname, const char *newname) {
 
 int FATFileSystem::format() {
     lock();
+    cache_drop(0, 0xFFFFFFFF);
     FRESULT res = f_mkfs(_fsid, 0, 512); // Logical drive number, Partitioning rule, Allocation unit size (bytes per cluster)
     if (res) {
         debug_if(FFS_DBG, "f_mkfs() failed: %d\n", res);
@@ -184,6 +218,8 @@ int FATFileSystem::mkdir(const char *name, mode_t mode) {
 
 int FATFileSystem::mount() {
     lock();
+    // the medium may have changed since
+    cache_drop(0, 0xFFFFFFFF);
     FRESULT res = f_mount(&_fs, _fsid, 1);
     unlock();
     return res == 0 ? 0 : -1;
@@ -200,6 +236,98 @@ int FATFileSystem::unmount() {
     return res == 0 ? 0 : -1;
 }
 
+int FATFileSystem::set_sector_cache(uint32_t sectors) {
+    lock();
+    delete _cache;
+    _cache = NULL;
+    if (sectors == 0) {
+        unlock();
+        return 0;
+    }
+
+    if (!_disk) {
+        _disk = new (std::nothrow) FATDiskBlockDevice(this);
+    }
+    if (_disk) {
+        _cache = new (std::nothrow) CacheBlockDevice(_disk, sectors);
+    }
+    if (!_cache || _cache->init() != 0) {
+        delete _cache;
+        _cache = NULL;
+        unlock();
+        return -1;
+    }
+    unlock();
+    return 0;
+}
+
+int FATFileSystem::cache_read(uint8_t *buffer, uint32_t sector) {
+    if (!_cache) {
+        return disk_read(buffer, sector, 1);
+    }
+    return _cache->read(buffer, sector, 1) == 0 ? 0 : 1;
+}
+
+int FATFileSystem::cache_write(const uint8_t *buffer, uint32_t sector) {
+    if (!_cache) {
+        return disk_write(buffer, sector, 1);
+    }
+    return _cache->write(buffer, sector, 1) == 0 ? 0 : 1;
+}
+
+void FATFileSystem::cache_drop(uint32_t sector, uint32_t count) {
+    if (_cache) {
+        _cache->invalidate(sector, count);
+    }
+}
+
+int FATFileSystem::disk_initialize() {
+    if (!_bd) {
+        return 0;
+    }
+    // FatFs is built for 512 byte sectors only (_MAX_SS)
+    if (_bd->init() != 0 || _bd->block_size() != _MAX_SS) {
+        debug_if(FFS_DBG, "Block device of %s failed to initialize\n", getName());
+        _bd_initialized = false;
+        return 1;
+    }
+    _bd_initialized = true;
+    return 0;
+}
+
+int FATFileSystem::disk_status() {
+    // STA_NOINIT until the block device is initialized
+    return (_bd && !_bd_initialized) ? 1 : 0;
+}
+
+int FATFileSystem::disk_read(uint8_t *buffer, uint32_t sector, uint32_t count) {
+    if (!_bd_initialized) {
+        return -1;
+    }
+    return _bd->read(buffer, sector, count) == 0 ? 0 : 1;
+}
+
+int FATFileSystem::disk_write(const uint8_t *buffer, uint32_t sector, uint32_t count) {
+    if (!_bd_initialized) {
+        return -1;
+    }
+    return _bd->write(buffer, sector, count) == 0 ? 0 : 1;
+}
+
+int FATFileSystem::disk_sync() {
+    if (!_bd_initialized) {
+        return 0;
+    }
+    return _bd->sync() == 0 ? 0 : 1;
+}
+
+uint32_t FATFileSystem::disk_sectors() {
+    if (!_bd_initialized) {
+        return 0;
+    }
+    return _bd->block_count();
+}
+
 void FATFileSystem::lock() {
     _mutex->lock();
 }
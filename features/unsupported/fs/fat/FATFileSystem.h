@@ -27,16 +27,25 @@
 #include "ff.h"
 #include <stdint.h>
 #include "PlatformMutex.h"
+#include "BlockDevice.h"
 
 using namespace mbed;
 
+class CacheBlockDevice;
+
 /**
  * FATFileSystem based on ChaN's Fat Filesystem library v0.8 
  */
 class FATFileSystem : public FileSystemLike {
 public:
 
-    FATFileSystem(const char* n);
+    /** Create a FAT filesystem
+     *
+     * @param n  The name used to access the virtual filesystem
+     * @param bd The device holding the filesystem, with 512 byte blocks,
+     *           or NULL for a subclass providing the disk_ functions
+     */
+    FATFileSystem(const char* n, BlockDevice *bd = NULL);
     virtual ~FATFileSystem();
 
     static FATFileSystem * _ffs[_VOLUMES];   // FATFileSystem objects, as parallel to FatFs drives array
@@ -83,12 +92,29 @@ public:
      */
     virtual int unmount();
 
-    virtual int disk_initialize() { return 0; }
-    virtual int disk_status() { return 0; }
-    virtual int disk_read(uint8_t *buffer, uint32_t sector, uint32_t count) = 0;
-    virtual int disk_write(const uint8_t *buffer, uint32_t sector, uint32_t count) = 0;
-    virtual int disk_sync() { return 0; }
-    virtual uint32_t disk_sectors() = 0;
+    /**
+     * Caches the sectors FatFs reads and writes through its window,
+     * which are the FAT and directory sectors. Without a cache every
+     * cluster allocated on a fragmented volume rereads a FAT sector the
+     * directory update of the last sync took the window from.
+     *
+     * @param sectors The number of sectors cached, 0 for none
+     * @return 0 on success, -1 if out of memory
+     */
+    int set_sector_cache(uint32_t sectors);
+
+    /* The sector accesses of diskio, through the sector cache */
+    int cache_read(uint8_t *buffer, uint32_t sector);
+    int cache_write(const uint8_t *buffer, uint32_t sector);
+    void cache_drop(uint32_t sector, uint32_t count);
+
+    /* Without a subclass overriding them, these are the block device's */
+    virtual int disk_initialize();
+    virtual int disk_status();
+    virtual int disk_read(uint8_t *buffer, uint32_t sector, uint32_t count);
+    virtual int disk_write(const uint8_t *buffer, uint32_t sector, uint32_t count);
+    virtual int disk_sync();
+    virtual uint32_t disk_sectors();
 
 protected:
 
@@ -98,6 +124,10 @@ protected:
 private:
 
     PlatformMutex *_mutex;
+    BlockDevice *_bd;
+    bool _bd_initialized;
+    BlockDevice *_disk;
+    CacheBlockDevice *_cache;
 
 };
 
@@ -0,0 +1,89 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <string.h>
+#include "LogDirHandle.h"
+
+using namespace mbed;
+
+LogDirHandle::LogDirHandle(LogFileSystem *fs, const char *path): _fs(fs), _index(0) {
+    strcpy(_path, path);
+}
+
+int LogDirHandle::closedir() {
+    delete this;
+    return 0;
+}
+
+struct dirent *LogDirHandle::readdir() {
+    lock();
+    size_t length = strlen(_path);
+    for (; _fs->_mounted && _index < _fs->_max_files; _index++) {
+        const LogFileSystem::File &file = _fs->_files[_index];
+        if (!file.id) {
+            continue;
+        }
+        // the files in the directory, not those below
+        const char *name = file.name;
+        if (length) {
+            if (strncmp(name, _path, length) != 0 || name[length] != '/') {
+                continue;
+            }
+            name += length + 1;
+        }
+        if (strchr(name, '/')) {
+            continue;
+        }
+        strcpy(_entry.d_name, name);
+        _index++;
+        unlock();
+        return &_entry;
+    }
+    unlock();
+    return NULL;
+}
+
+void LogDirHandle::rewinddir() {
+    lock();
+    _index = 0;
+    unlock();
+}
+
+off_t LogDirHandle::telldir() {
+    lock();
+    off_t offset = _index;
+    unlock();
+    return offset;
+}
+
+void LogDirHandle::seekdir(off_t location) {
+    lock();
+    _index = location;
+    unlock();
+}
+
+void LogDirHandle::lock() {
+    _fs->lock();
+}
+
+void LogDirHandle::unlock() {
+    _fs->unlock();
+}
@@ -0,0 +1,271 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "mbed.h"
+
+#include "mbed_debug.h"
+
+#include "LogFileHandle.h"
+#include "LogFileSystem.h"
+#include <string.h>
+
+#define LFS_DBG 0
+
+static const uint32_t NO_CHUNK = 0xFFFFFFFF;
+
+LogFileHandle::LogFileHandle(LogFileSystem *fs, int slot, int flags, uint8_t *buffer) :
+    _fs(fs), _slot(slot), _id(fs->_files[slot].id), _flags(flags), _position(0),
+    _buffer(buffer), _chunk(NO_CHUNK), _chunk_length(0), _chunk_version(0), _dirty(false) {
+}
+
+int LogFileHandle::close() {
+    int drained = drain_buffer();
+    lock();
+    int retval = valid() ? flush() : -1;
+    if (_fs->_mounted) {
+        _fs->_files[_slot].opened--;
+    }
+    _fs->_open_handles--;
+    delete[] _buffer;
+    unlock();
+    delete this;
+    return drained ? drained : retval;
+}
+
+bool LogFileHandle::valid() const {
+    return _fs->_mounted && _fs->_files[_slot].id == _id;
+}
+
+bool LogFileHandle::buffered(uint32_t chunk) const {
+    // a clean chunk is out of date once the file has been written elsewhere
+    return (chunk == _chunk) && (_dirty || _chunk_version == _fs->_files[_slot].version);
+}
+
+int LogFileHandle::load(uint32_t chunk) {
+    const LogFileSystem::File &file = _fs->_files[_slot];
+    uint32_t start = chunk * _fs->_chunk_size;
+    uint32_t length = (start < file.size) ? file.size - start : 0;
+    if (length > _fs->_chunk_size) {
+        length = _fs->_chunk_size;
+    }
+    _chunk = NO_CHUNK;
+    _dirty = false;
+    if (length && _fs->read_chunks(_slot, chunk, 1, _buffer, 0, length)) {
+        return -1;
+    }
+    _chunk = chunk;
+    _chunk_length = length;
+    _chunk_version = file.version;
+    return 0;
+}
+
+int LogFileHandle::flush() {
+    if (!_dirty) {
+        return 0;
+    }
+    if (_fs->write_chunk(_slot, _chunk, _buffer, _chunk_length)) {
+        debug_if(LFS_DBG, "write of chunk %lu failed\n", (unsigned long)_chunk);
+        return -1;
+    }
+    _dirty = false;
+    _chunk_version = _fs->_files[_slot].version;
+    return 0;
+}
+
+/* Writes through the buffer, data NULL for zeros: a chunk is written out
+ * once written up to its end, or when writing moves on to another one */
+ssize_t LogFileHandle::put(uint32_t position, const uint8_t *data, uint32_t length) {
+    LogFileSystem::File &file = _fs->_files[_slot];
+    uint32_t chunk_size = _fs->_chunk_size;
+    uint32_t done = 0;
+    while (done < length) {
+        uint32_t chunk = (position + done) / chunk_size;
+        uint32_t offset = (position + done) % chunk_size;
+        uint32_t n = chunk_size - offset;
+        if (n > length - done) {
+            n = length - done;
+        }
+
+        if (!buffered(chunk)) {
+            if (flush()) {
+                break;
+            }
+            if (offset == 0 && n == chunk_size) {
+                // replaced as a whole
+                _chunk = chunk;
+                _chunk_length = 0;
+            } else if (load(chunk)) {
+                break;
+            }
+        }
+
+        if (offset > _chunk_length) {
+            memset(_buffer + _chunk_length, 0, offset - _chunk_length);
+        }
+        if (data) {
+            memcpy(_buffer + offset, data + done, n);
+        } else {
+            memset(_buffer + offset, 0, n);
+        }
+        if (offset + n > _chunk_length) {
+            _chunk_length = offset + n;
+        }
+        _dirty = true;
+        done += n;
+        if (position + done > file.size) {
+            file.size = position + done;
+        }
+
+        if (offset + n == chunk_size && flush()) {
+            break;
+        }
+    }
+    return (done || !length) ? (ssize_t)done : -1;
+}
+
+ssize_t LogFileHandle::write(const void* buffer, size_t length) {
+    lock();
+    if (!valid() || !(_flags & (O_WRONLY | O_RDWR))) {
+        unlock();
+        return -1;
+    }
+    LogFileSystem::File &file = _fs->_files[_slot];
+    if (_flags & O_APPEND) {
+        _position = file.size;
+    }
+    if (length > 0xFFFFFFFF - _position) {
+        length = 0xFFFFFFFF - _position;
+    }
+
+    // a write past the end fills the gap with zeros
+    if (_position > file.size && put(file.size, NULL, _position - file.size) < 0) {
+        unlock();
+        return -1;
+    }
+    ssize_t n = put(_position, (const uint8_t *)buffer, length);
+    if (n > 0) {
+        _position += n;
+    }
+    unlock();
+    return n;
+}
+
+ssize_t LogFileHandle::read(void* buffer, size_t length) {
+    lock();
+    debug_if(LFS_DBG, "read(%d)\n", length);
+    if (!valid() || (_flags & O_WRONLY)) {
+        unlock();
+        return -1;
+    }
+    const LogFileSystem::File &file = _fs->_files[_slot];
+    uint32_t chunk_size = _fs->_chunk_size;
+    if (_position >= file.size) {
+        unlock();
+        return 0;
+    }
+    if (length > file.size - _position) {
+        length = file.size - _position;
+    }
+
+    uint8_t *data = (uint8_t *)buffer;
+    uint32_t done = 0;
+    while (done < length) {
+        uint32_t chunk = (_position + done) / chunk_size;
+        uint32_t offset = (_position + done) % chunk_size;
+        uint32_t n;
+        if (buffered(chunk)) {
+            n = chunk_size - offset;
+            if (n > length - done) {
+                n = length - done;
+            }
+            for (uint32_t k = 0; k < n; k++) {
+                data[done + k] = (offset + k < _chunk_length) ? _buffer[offset + k] : 0;
+            }
+        } else {
+            // the chunks from the log, up to the one buffered
+            uint32_t count = (offset + (length - done) + chunk_size - 1) / chunk_size;
+            if (count > LogFileSystem::READ_BATCH) {
+                count = LogFileSystem::READ_BATCH;
+            }
+            if (_chunk != NO_CHUNK && _chunk > chunk && _chunk - chunk < count) {
+                count = _chunk - chunk;
+            }
+            n = count * chunk_size - offset;
+            if (n > length - done) {
+                n = length - done;
+            }
+            if (_fs->read_chunks(_slot, chunk, count, data + done, offset, n)) {
+                debug_if(LFS_DBG, "read of chunk %lu failed\n", (unsigned long)chunk);
+                break;
+            }
+        }
+        done += n;
+    }
+    _position += done;
+    unlock();
+    return (done || !length) ? (ssize_t)done : -1;
+}
+
+int LogFileHandle::isatty() {
+    return 0;
+}
+
+off_t LogFileHandle::lseek(off_t position, int whence) {
+    lock();
+    if (!valid()) {
+        unlock();
+        return -1;
+    }
+    if (whence == SEEK_END) {
+        position += _fs->_files[_slot].size;
+    } else if (whence == SEEK_CUR) {
+        position += _position;
+    }
+    if (position < 0 || (uint64_t)position > 0xFFFFFFFF) {
+        unlock();
+        return -1;
+    }
+    _position = position;
+    unlock();
+    return position;
+}
+
+int LogFileHandle::fsync() {
+    lock();
+    int retval = valid() ? flush() : -1;
+    unlock();
+    return retval;
+}
+
+off_t LogFileHandle::flen() {
+    lock();
+    off_t size = valid() ? (off_t)_fs->_files[_slot].size : -1;
+    unlock();
+    return size;
+}
+
+void LogFileHandle::lock() {
+    _fs->lock();
+}
+
+void LogFileHandle::unlock() {
+    _fs->unlock();
+}
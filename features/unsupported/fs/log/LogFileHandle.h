@@ -0,0 +1,70 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_LOGFILEHANDLE_H
+#define MBED_LOGFILEHANDLE_H
+
+#include "FileHandle.h"
+#include <stdint.h>
+
+using namespace mbed;
+
+class LogFileSystem;
+
+/* An open file of a LogFileSystem, holding the chunk being written */
+class LogFileHandle : public FileHandle {
+public:
+
+    LogFileHandle(LogFileSystem *fs, int slot, int flags, uint8_t *buffer);
+    virtual int close();
+    virtual ssize_t write(const void* buffer, size_t length);
+    virtual ssize_t read(void* buffer, size_t length);
+    virtual int isatty();
+    virtual off_t lseek(off_t position, int whence);
+    virtual int fsync();
+    virtual off_t flen();
+
+protected:
+
+    virtual void lock();
+    virtual void unlock();
+
+private:
+    bool valid() const;
+    bool buffered(uint32_t chunk) const;
+    int load(uint32_t chunk);
+    int flush();
+    ssize_t put(uint32_t position, const uint8_t *data, uint32_t length);
+
+    LogFileSystem *_fs;
+    int _slot;
+    uint32_t _id;
+    int _flags;
+    uint32_t _position;
+
+    uint8_t *_buffer;         // a chunk of the file
+    uint32_t _chunk;          // the chunk in the buffer, or NO_CHUNK
+    uint32_t _chunk_length;
+    uint32_t _chunk_version;  // of the file, when the buffer was last in sync
+    bool _dirty;
+};
+
+#endif
@@ -0,0 +1,1120 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "mbed.h"
+
+#include "mbed_debug.h"
+
+#include "LogFileSystem.h"
+#include "LogFileHandle.h"
+#include "LogDirHandle.h"
+#include "critical.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+#define LFS_DBG 0
+
+/*
+ * Layout
+ *
+ * Each sector in the log starts with a SectorHeader, followed by records
+ * aligned to the program unit: a Record header, its payload and a Commit,
+ * programmed in that order. A record exists once its commit is complete.
+ * One left without, by a reset, is skipped over with the length in its
+ * header, and a header left incomplete is skipped as nothing was programmed
+ * after it: the log carries on in the sector, with no space but the record
+ * lost. The first erased header ends the log of a sector.
+ *
+ * Every record has a version, counting up across the filesystem, and the
+ * latest version of a record wins: the latest RECORD_NAME of a file holds its
+ * name, the latest RECORD_DATA of a chunk its content, and the latest record
+ * of any kind its size. Collecting copies records unchanged, versions
+ * included, so the order of the records in the log is immaterial but for
+ * RECORD_DELETE (see collect()).
+ */
+
+enum {
+    SECTOR_FREE   = 0,  // anything but a valid header, erased before use
+    SECTOR_ERASED = 1,
+    SECTOR_USED   = 2,
+};
+
+enum {
+    RECORD_NAME   = 1,  // payload: the path of the file
+    RECORD_DATA   = 2,  // payload: the content of a chunk, up to the size of the file
+    RECORD_SIZE   = 3,
+    RECORD_DELETE = 4,
+};
+
+enum {
+    FILE_DIRECTORY = 0x01,
+};
+
+struct SectorHeader {
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t erase_count;
+    uint32_t chunk_size;
+    uint32_t crc;
+};
+
+static const uint32_t SECTOR_MAGIC     = 0x31474F4C; // "LOG1"
+static const uint32_t NO_SECTOR        = 0xFFFFFFFF;
+static const uint32_t RESERVED_SECTORS = 2;          // kept free to collect into
+static const uint32_t CRC_INITIAL      = 0xFFFFFFFF;
+
+/* The chunks of a candidate key held by the other kinds of record */
+static const uint32_t KEY_NAME   = 0xFFFFFF;
+static const uint32_t KEY_SIZE   = 0xFFFFFE;
+static const uint32_t MAX_CHUNKS = 0xFFFFFE;
+
+static uint32_t crc32(uint32_t crc, const void *data, uint32_t size) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t *p = (const uint8_t *)data;
+    while (size--) {
+        crc = (crc >> 4) ^ table[(crc ^ *p) & 0x0F];
+        crc = (crc >> 4) ^ table[(crc ^ (*p >> 4)) & 0x0F];
+        p++;
+    }
+    return crc;
+}
+
+static bool is_erased(const void *data, uint32_t size, uint8_t erased) {
+    const uint8_t *p = (const uint8_t *)data;
+    while (size--) {
+        if (*p++ != erased) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int compare_candidates(const void *a, const void *b) {
+    uint32_t ka = *(const uint32_t *)a;
+    uint32_t kb = *(const uint32_t *)b;
+    return (ka > kb) - (ka < kb);
+}
+
+static PlatformMutex * mutex = NULL;
+
+PlatformMutex * get_log_mutex() {
+    PlatformMutex * new_mutex = new PlatformMutex;
+
+    core_util_critical_section_enter();
+    if (NULL == mutex) {
+        mutex = new_mutex;
+    }
+    core_util_critical_section_exit();
+
+    if (mutex != new_mutex) {
+        delete new_mutex;
+    }
+    return mutex;
+}
+
+/* The filesystems take turns on their storage under the mutex, so there is
+ * one operation outstanding at a time */
+static volatile bool storage_done;
+static volatile int32_t storage_status;
+
+void LogFileSystem::storage_callback(int32_t status, ARM_STORAGE_OPERATION operation) {
+    (void)operation;
+    storage_status = status;
+    storage_done = true;
+}
+
+LogFileSystem::LogFileSystem(const char *n, ARM_DRIVER_STORAGE *mtd, uint64_t start, uint64_t size,
+                             uint32_t max_files, uint32_t chunk_size) :
+    FileSystemLike(n), _mutex(get_log_mutex()), _mtd(mtd), _start(start), _size(size),
+    _max_files(max_files), _chunk_size(chunk_size), _mounted(false), _program_unit(0),
+    _sector_size(0), _sector_count(0), _erased(0xFF), _presence_words(0),
+    _sectors(NULL), _presence(NULL), _files(NULL), _candidates(NULL), _candidate_count(0),
+    _staging(NULL), _staging_size(0), _head(NO_SECTOR), _head_offset(0), _free_count(0),
+    _sequence(1), _version(1), _next_id(1), _open_handles(0), _collecting(false) {
+}
+
+LogFileSystem::~LogFileSystem() {
+    lock();
+    release();
+    unlock();
+}
+
+int LogFileSystem::storage_wait(int32_t status) {
+    if (status == ARM_DRIVER_OK) {
+        // asynchronous, completing with the callback
+        while (!storage_done);
+        status = storage_status;
+    }
+    return (status < ARM_DRIVER_OK) ? -1 : 0;
+}
+
+int LogFileSystem::storage_read(uint32_t addr, void *buffer, uint32_t size) {
+    storage_done = false;
+    return storage_wait(_mtd->ReadData(_start + addr, buffer, size));
+}
+
+int LogFileSystem::storage_program(uint32_t addr, const void *buffer, uint32_t size) {
+    storage_done = false;
+    return storage_wait(_mtd->ProgramData(_start + addr, buffer, size));
+}
+
+int LogFileSystem::storage_erase(uint32_t sector) {
+    storage_done = false;
+    int err = storage_wait(_mtd->Erase(_start + (uint64_t)sector * _sector_size, _sector_size));
+    if (err) {
+        debug_if(LFS_DBG, "erase of sector %lu failed\n", (unsigned long)sector);
+        return err;
+    }
+    _sectors[sector].state = SECTOR_ERASED;
+    _sectors[sector].erase_count++;
+    return 0;
+}
+
+uint32_t LogFileSystem::align(uint32_t size) const {
+    return (size + _program_unit - 1) / _program_unit * _program_unit;
+}
+
+uint32_t LogFileSystem::record_footprint(uint32_t length) const {
+    return align(sizeof(Record)) + align(length) + align(sizeof(Commit));
+}
+
+uint32_t LogFileSystem::sector_header_size() const {
+    return align(sizeof(SectorHeader));
+}
+
+bool LogFileSystem::record_first(uint32_t sector, Cursor *cursor) {
+    cursor->sector = sector;
+    cursor->next = sector_header_size();
+    return record_next(cursor);
+}
+
+bool LogFileSystem::record_next(Cursor *cursor) {
+    Record &record = cursor->record;
+    for (cursor->offset = cursor->next; cursor->offset + record_footprint(0) <= _sector_size; cursor->offset = cursor->next) {
+        uint32_t addr = cursor->sector * _sector_size + cursor->offset;
+        if (storage_read(addr, &record, sizeof(Record))) {
+            return false;
+        }
+        if (record.crc != crc32(CRC_INITIAL, &record, offsetof(Record, crc))) {
+            if (is_erased(&record, sizeof(Record), _erased)) {
+                return false;
+            }
+            // interrupted in the header
+            cursor->next = cursor->offset + align(sizeof(Record));
+            continue;
+        }
+        if (cursor->offset + record_footprint(record.length) > _sector_size) {
+            return false;
+        }
+        cursor->next = cursor->offset + record_footprint(record.length);
+
+        Commit commit;
+        if (storage_read(addr + align(sizeof(Record)) + align(record.length), &commit, sizeof(Commit))) {
+            return false;
+        }
+        if (commit.crc == crc32(record.crc, &commit, offsetof(Commit, crc))) {
+            cursor->data_crc = commit.data_crc;
+            return true;
+        }
+    }
+    return false;
+}
+
+int LogFileSystem::record_payload(const Cursor &cursor, void *buffer) {
+    uint32_t addr = cursor.sector * _sector_size + cursor.offset + align(sizeof(Record));
+    if (storage_read(addr, buffer, cursor.record.length)) {
+        return -1;
+    }
+    if (crc32(CRC_INITIAL, buffer, cursor.record.length) != cursor.data_crc) {
+        debug_if(LFS_DBG, "corrupt record at %lu:%lu\n", (unsigned long)cursor.sector, (unsigned long)cursor.offset);
+        return -1;
+    }
+    return 0;
+}
+
+int LogFileSystem::program_staged(uint32_t footprint) {
+    uint32_t header_size = align(sizeof(Record));
+    uint32_t commit_size = align(sizeof(Commit));
+    uint32_t addr = _head * _sector_size + _head_offset;
+
+    int err = storage_program(addr, _staging, header_size);
+    if (!err && footprint > header_size + commit_size) {
+        err = storage_program(addr + header_size, _staging + header_size, footprint - header_size - commit_size);
+    }
+    if (!err) {
+        err = storage_program(addr + footprint - commit_size, _staging + footprint - commit_size, commit_size);
+    }
+    if (err) {
+        // no further programs over the failure
+        _head_offset = _sector_size;
+        return -1;
+    }
+    _head_offset += footprint;
+    return 0;
+}
+
+int LogFileSystem::append(int slot, Record *record, const void *payload) {
+    uint32_t footprint = record_footprint(record->length);
+    if (ensure_room(footprint)) {
+        return -1;
+    }
+
+    uint8_t *data = _staging + align(sizeof(Record));
+    memset(_staging, _erased, footprint);
+    if (record->length) {
+        memcpy(data, payload, record->length);
+    }
+    record->crc = crc32(CRC_INITIAL, record, offsetof(Record, crc));
+    memcpy(_staging, record, sizeof(Record));
+    Commit commit;
+    commit.data_crc = crc32(CRC_INITIAL, data, record->length);
+    commit.crc = crc32(record->crc, &commit, offsetof(Commit, crc));
+    memcpy(_staging + footprint - align(sizeof(Commit)), &commit, sizeof(Commit));
+
+    if (program_staged(footprint)) {
+        return -1;
+    }
+    mark(_head, slot);
+    return 0;
+}
+
+int LogFileSystem::configure() {
+    if (_sectors) {
+        return 0;
+    }
+
+    storage_done = false;
+    if (storage_wait(_mtd->Initialize(storage_callback))) {
+        return -1;
+    }
+
+    ARM_STORAGE_INFO info;
+    ARM_STORAGE_BLOCK block;
+    if (_mtd->GetInfo(&info) != ARM_DRIVER_OK || _mtd->GetBlock(_start, &block) != ARM_DRIVER_OK) {
+        return -1;
+    }
+    if (!block.attributes.erasable || !block.attributes.programmable || block.attributes.erase_unit == 0) {
+        return -1;
+    }
+
+    _program_unit = info.program_unit ? info.program_unit : 1;
+    _sector_size = block.attributes.erase_unit;
+    _erased = info.erased_value ? 0xFF : 0x00;
+    _sector_count = (uint32_t)(_size / _sector_size);
+    _presence_words = (_max_files + 31) / 32;
+    _staging_size = record_footprint((_chunk_size > NAME_MAX_LENGTH) ? _chunk_size : NAME_MAX_LENGTH);
+
+    if ((_start % _sector_size) || (_size % _sector_size) || (_start + _size > block.addr + block.size) ||
+        (_sector_count < RESERVED_SECTORS + 2) || (_max_files == 0) || (_max_files > 255) ||
+        (_chunk_size == 0) || (_chunk_size % _program_unit) || (_chunk_size > 0xFFFF) ||
+        (sector_header_size() + _staging_size > _sector_size)) {
+        debug_if(LFS_DBG, "geometry not supported\n");
+        return -1;
+    }
+
+    // every record of a sector is a candidate for collecting
+    _candidate_count = (_sector_size - sector_header_size()) / record_footprint(0);
+
+    _sectors = new (std::nothrow) Sector[_sector_count];
+    _presence = new (std::nothrow) uint32_t[_sector_count * _presence_words];
+    _files = new (std::nothrow) File[_max_files];
+    _candidates = new (std::nothrow) Candidate[_candidate_count];
+    // the records, followed by room for a sector header
+    _staging = new (std::nothrow) uint8_t[_staging_size + sector_header_size()];
+    if (!_sectors || !_presence || !_files || !_candidates || !_staging) {
+        release();
+        return -1;
+    }
+    memset(_sectors, 0, _sector_count * sizeof(Sector));
+    return 0;
+}
+
+void LogFileSystem::release() {
+    delete[] _sectors;
+    delete[] _presence;
+    delete[] _files;
+    delete[] _candidates;
+    delete[] _staging;
+    _sectors = NULL;
+    _presence = NULL;
+    _files = NULL;
+    _candidates = NULL;
+    _staging = NULL;
+    _mounted = false;
+}
+
+int LogFileSystem::ensure_mounted() {
+    return _mounted ? 0 : scan();
+}
+
+int LogFileSystem::scan() {
+    if (configure()) {
+        return -1;
+    }
+
+    _head = NO_SECTOR;
+    _free_count = 0;
+    _sequence = 1;
+    _version = 1;
+    _next_id = 1;
+    memset(_files, 0, _max_files * sizeof(File));
+    memset(_presence, 0, _sector_count * _presence_words * sizeof(uint32_t));
+
+    uint32_t used = 0;
+    uint32_t erase_total = 0;
+    for (uint32_t s = 0; s < _sector_count; s++) {
+        SectorHeader header;
+        Sector &sector = _sectors[s];
+        if (storage_read(s * _sector_size, &header, sizeof(header)) ||
+            header.magic != SECTOR_MAGIC || header.crc != crc32(CRC_INITIAL, &header, offsetof(SectorHeader, crc))) {
+            sector.state = SECTOR_FREE;
+            _free_count++;
+            continue;
+        }
+        if (header.chunk_size != _chunk_size) {
+            debug_if(LFS_DBG, "formatted with chunks of %lu bytes\n", (unsigned long)header.chunk_size);
+            return -1;
+        }
+        sector.state = SECTOR_USED;
+        sector.sequence = header.sequence;
+        sector.erase_count = header.erase_count;
+        erase_total += header.erase_count;
+        used++;
+        if (header.sequence >= _sequence) {
+            _sequence = header.sequence + 1;
+            _head = s;
+        }
+    }
+    if (used == 0) {
+        debug_if(LFS_DBG, "not formatted\n");
+        return -1;
+    }
+    for (uint32_t s = 0; s < _sector_count; s++) {
+        if (_sectors[s].state != SECTOR_USED) {
+            _sectors[s].erase_count = erase_total / used; // lost with the header
+        }
+    }
+
+    // The names, in the order the sectors were written: the removal of a
+    // file follows all its names, and the files named at any point fit
+    // the table.
+    Cursor cursor;
+    uint32_t previous = 0;
+    for (uint32_t n = 0; n < used; n++) {
+        uint32_t sector = NO_SECTOR;
+        for (uint32_t s = 0; s < _sector_count; s++) {
+            if (_sectors[s].state == SECTOR_USED && _sectors[s].sequence > previous &&
+                (sector == NO_SECTOR || _sectors[s].sequence < _sectors[sector].sequence)) {
+                sector = s;
+            }
+        }
+        previous = _sectors[sector].sequence;
+
+        for (bool valid = record_first(sector, &cursor); valid; valid = record_next(&cursor)) {
+            const Record &record = cursor.record;
+            if (record.version >= _version) {
+                _version = record.version + 1;
+            }
+            if (record.id >= _next_id) {
+                _next_id = record.id + 1;
+            }
+
+            int slot = find_id(record.id);
+            if (record.type == RECORD_DELETE) {
+                if (slot >= 0) {
+                    memset(&_files[slot], 0, sizeof(File));
+                }
+                continue;
+            }
+            if (record.type != RECORD_NAME || record.length > NAME_MAX_LENGTH) {
+                continue;
+            }
+            if (slot < 0) {
+                slot = find_free();
+                if (slot < 0) {
+                    debug_if(LFS_DBG, "more files than %lu\n", (unsigned long)_max_files);
+                    return -1;
+                }
+                _files[slot].id = record.id;
+            }
+            File &file = _files[slot];
+            if (record.version >= file.name_version) {
+                char name[NAME_MAX_LENGTH + 1];
+                if (record_payload(cursor, name)) {
+                    continue;
+                }
+                name[record.length] = '\0';
+                strcpy(file.name, name);
+                file.flags = record.flags;
+                file.name_version = record.version;
+            }
+        }
+    }
+
+    // the sizes, and the sectors holding the files
+    for (uint32_t s = 0; s < _sector_count; s++) {
+        if (_sectors[s].state != SECTOR_USED) {
+            continue;
+        }
+        for (bool valid = record_first(s, &cursor); valid; valid = record_next(&cursor)) {
+            int slot = find_id(cursor.record.id);
+            if (slot < 0) {
+                continue;
+            }
+            mark(s, slot);
+            if (cursor.record.version > _files[slot].version) {
+                _files[slot].version = cursor.record.version;
+                _files[slot].size = cursor.record.size;
+            }
+        }
+    }
+
+    // The log continues in the head sector where it ends, on erased storage
+    bool valid = record_first(_head, &cursor);
+    while (valid) {
+        valid = record_next(&cursor);
+    }
+    _head_offset = cursor.offset;
+    for (uint32_t offset = _head_offset; offset < _sector_size; offset += _staging_size) {
+        uint32_t size = (_sector_size - offset < _staging_size) ? _sector_size - offset : _staging_size;
+        if (storage_read(_head * _sector_size + offset, _staging, size) || !is_erased(_staging, size, _erased)) {
+            _head_offset = _sector_size;
+            break;
+        }
+    }
+
+    _mounted = true;
+    return 0;
+}
+
+int LogFileSystem::ensure_room(uint32_t footprint) {
+    // a reset while collecting leaves the reserve short, collecting once
+    // per record restores it unless the files fill the log
+    if (!_collecting && _free_count < RESERVED_SECTORS) {
+        collect();
+    }
+
+    uint32_t attempts = 0;
+    while (_head == NO_SECTOR || _head_offset + footprint > _sector_size) {
+        if (!_collecting && _free_count <= RESERVED_SECTORS) {
+            // each collection frees a sector, and takes at most one of
+            // those reserved; once all went round, the files fill the log
+            if (attempts++ == _sector_count || collect()) {
+                debug_if(LFS_DBG, "no space left\n");
+                return -1;
+            }
+            continue;
+        }
+        if (open_sector()) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int LogFileSystem::open_sector() {
+    // the least worn of the free sectors
+    uint32_t sector = NO_SECTOR;
+    for (uint32_t s = 0; s < _sector_count; s++) {
+        if (_sectors[s].state != SECTOR_USED &&
+            (sector == NO_SECTOR || _sectors[s].erase_count < _sectors[sector].erase_count)) {
+            sector = s;
+        }
+    }
+    if (sector == NO_SECTOR) {
+        return -1;
+    }
+    if (_sectors[sector].state == SECTOR_FREE && storage_erase(sector)) {
+        return -1;
+    }
+
+    SectorHeader header;
+    header.magic = SECTOR_MAGIC;
+    header.sequence = _sequence;
+    header.erase_count = _sectors[sector].erase_count;
+    header.chunk_size = _chunk_size;
+    header.crc = crc32(CRC_INITIAL, &header, offsetof(SectorHeader, crc));
+
+    // past the staging area, which holds a record being collected
+    uint8_t *buffer = _staging + _staging_size;
+    memset(buffer, _erased, sector_header_size());
+    memcpy(buffer, &header, sizeof(header));
+    if (storage_program(sector * _sector_size, buffer, sector_header_size())) {
+        _sectors[sector].state = SECTOR_FREE;
+        return -1;
+    }
+
+    _sectors[sector].state = SECTOR_USED;
+    _sectors[sector].sequence = _sequence++;
+    unmark_all(sector);
+    _free_count--;
+    _head = sector;
+    _head_offset = sector_header_size();
+    return 0;
+}
+
+uint32_t LogFileSystem::candidate_key(int slot, const Record &record) const {
+    uint32_t chunk = (record.type == RECORD_NAME) ? KEY_NAME :
+                     (record.type == RECORD_SIZE) ? KEY_SIZE : record.chunk;
+    return ((uint32_t)slot << 24) | chunk;
+}
+
+/*
+ * Collecting copies the live records of the oldest sector to the head of
+ * the log, and erases it. A record is live if it holds the name of a file,
+ * its size, or the content of a chunk within its size, and no later
+ * record or earlier copy does.
+ *
+ * A RECORD_DELETE is never copied: with the oldest sector collected first,
+ * the records of the file it removed, written before it, are in the
+ * sector being collected or in erased ones.
+ */
+int LogFileSystem::collect() {
+    uint32_t victim = NO_SECTOR;
+    for (uint32_t s = 0; s < _sector_count; s++) {
+        if (_sectors[s].state == SECTOR_USED && s != _head &&
+            (victim == NO_SECTOR || _sectors[s].sequence < _sectors[victim].sequence)) {
+            victim = s;
+        }
+    }
+    if (victim == NO_SECTOR) {
+        return -1;
+    }
+    debug_if(LFS_DBG, "collecting sector %lu\n", (unsigned long)victim);
+
+    uint32_t count = 0;
+    uint32_t slots[8] = {0};
+    Cursor cursor;
+    for (bool valid = record_first(victim, &cursor); valid && count < _candidate_count; valid = record_next(&cursor)) {
+        const Record &record = cursor.record;
+        int slot = find_id(record.id);
+        if (slot < 0) {
+            continue;
+        }
+        const File &file = _files[slot];
+        bool live;
+        switch (record.type) {
+            case RECORD_NAME:
+                live = (record.version == file.name_version);
+                break;
+            case RECORD_SIZE:
+                live = (record.version == file.version);
+                break;
+            case RECORD_DATA:
+                live = (record.chunk < MAX_CHUNKS) && ((uint64_t)record.chunk * _chunk_size < file.size);
+                break;
+            default:
+                live = false;
+                break;
+        }
+        if (!live) {
+            continue;
+        }
+        Candidate &candidate = _candidates[count++];
+        candidate.key = candidate_key(slot, record);
+        candidate.version = record.version;
+        candidate.offset = cursor.offset;
+        candidate.superseded = false;
+        slots[slot / 32] |= 1UL << (slot % 32);
+    }
+    qsort(_candidates, count, sizeof(Candidate), compare_candidates);
+
+    // superseded by a later version, or copied already (by a collection
+    // which was interrupted before the erase)
+    for (uint32_t s = 0; count && s < _sector_count; s++) {
+        if (_sectors[s].state != SECTOR_USED) {
+            continue;
+        }
+        bool holds = false;
+        for (uint32_t w = 0; w < _presence_words; w++) {
+            holds = holds || (_presence[s * _presence_words + w] & slots[w]);
+        }
+        if (!holds) {
+            continue;
+        }
+        for (bool valid = record_first(s, &cursor); valid; valid = record_next(&cursor)) {
+            const Record &record = cursor.record;
+            int slot = find_id(record.id);
+            if (slot < 0 || record.type == RECORD_DELETE) {
+                continue;
+            }
+            uint32_t key = candidate_key(slot, record);
+
+            // the first candidate of the key
+            uint32_t low = 0, high = count;
+            while (low < high) {
+                uint32_t middle = (low + high) / 2;
+                if (_candidates[middle].key < key) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            for (uint32_t i = low; i < count && _candidates[i].key == key; i++) {
+                Candidate &candidate = _candidates[i];
+                if (s == victim && cursor.offset == candidate.offset) {
+                    continue;
+                }
+                if (record.version > candidate.version ||
+                    (record.version == candidate.version && (s != victim || cursor.offset < candidate.offset))) {
+                    candidate.superseded = true;
+                }
+            }
+        }
+    }
+
+    _collecting = true;
+    for (uint32_t i = 0; i < count; i++) {
+        const Candidate &candidate = _candidates[i];
+        if (candidate.superseded) {
+            continue;
+        }
+
+        cursor.sector = victim;
+        cursor.next = candidate.offset;
+        if (!record_next(&cursor)) {
+            continue;
+        }
+        uint32_t footprint = record_footprint(cursor.record.length);
+        // a corrupt payload isn't carried on
+        if (ensure_room(footprint) ||
+            storage_read(victim * _sector_size + candidate.offset, _staging, footprint)) {
+            _collecting = false;
+            return -1;
+        }
+        if (crc32(CRC_INITIAL, _staging + align(sizeof(Record)), cursor.record.length) != cursor.data_crc) {
+            continue;
+        }
+        if (program_staged(footprint)) {
+            _collecting = false;
+            return -1;
+        }
+        mark(_head, candidate.key >> 24);
+    }
+    _collecting = false;
+
+    _sectors[victim].state = SECTOR_FREE;
+    _free_count++;
+    unmark_all(victim);
+    storage_erase(victim);
+    return 0;
+}
+
+void LogFileSystem::mark(uint32_t sector, int slot) {
+    _presence[sector * _presence_words + slot / 32] |= 1UL << (slot % 32);
+}
+
+bool LogFileSystem::marked(uint32_t sector, int slot) const {
+    return (_presence[sector * _presence_words + slot / 32] & (1UL << (slot % 32))) != 0;
+}
+
+void LogFileSystem::unmark_all(uint32_t sector) {
+    memset(&_presence[sector * _presence_words], 0, _presence_words * sizeof(uint32_t));
+}
+
+int LogFileSystem::find(const char *name) const {
+    for (uint32_t slot = 0; slot < _max_files; slot++) {
+        if (_files[slot].id && strcmp(_files[slot].name, name) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+int LogFileSystem::find_id(uint32_t id) const {
+    for (uint32_t slot = 0; slot < _max_files; slot++) {
+        if (_files[slot].id == id) {
+            return id ? (int)slot : -1;
+        }
+    }
+    return -1;
+}
+
+int LogFileSystem::find_free() const {
+    for (uint32_t slot = 0; slot < _max_files; slot++) {
+        if (!_files[slot].id) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+bool LogFileSystem::parent_exists(const char *name) const {
+    const char *separator = strrchr(name, '/');
+    if (!separator) {
+        return true;
+    }
+    size_t length = separator - name;
+    for (uint32_t slot = 0; slot < _max_files; slot++) {
+        const File &file = _files[slot];
+        if (file.id && (file.flags & FILE_DIRECTORY) &&
+            strncmp(file.name, name, length) == 0 && file.name[length] == '\0') {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LogFileSystem::directory_empty(int slot) const {
+    size_t length = strlen(_files[slot].name);
+    for (uint32_t s = 0; s < _max_files; s++) {
+        const File &file = _files[s];
+        if (file.id && strncmp(file.name, _files[slot].name, length) == 0 && file.name[length] == '/') {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LogFileSystem::normalize(const char *name, char *path) {
+    while (*name == '/') {
+        name++;
+    }
+    size_t length = strlen(name);
+    while (length && name[length - 1] == '/') {
+        length--;
+    }
+    if (length > NAME_MAX_LENGTH) {
+        return false;
+    }
+    for (size_t i = 1; i < length; i++) {
+        if (name[i] == '/' && name[i - 1] == '/') {
+            return false;
+        }
+    }
+    memcpy(path, name, length);
+    path[length] = '\0';
+    return true;
+}
+
+int LogFileSystem::write_name(int slot, const char *name) {
+    File &file = _files[slot];
+    Record record;
+    memset(&record, 0, sizeof(record));
+    record.type = RECORD_NAME;
+    record.flags = file.flags;
+    record.length = strlen(name);
+    record.id = file.id;
+    record.version = _version++;
+    record.size = file.size;
+    if (append(slot, &record, name)) {
+        return -1;
+    }
+    strcpy(file.name, name);
+    file.name_version = file.version = record.version;
+    return 0;
+}
+
+int LogFileSystem::write_size(int slot, uint32_t size) {
+    File &file = _files[slot];
+    Record record;
+    memset(&record, 0, sizeof(record));
+    record.type = RECORD_SIZE;
+    record.id = file.id;
+    record.version = _version++;
+    record.size = size;
+    if (append(slot, &record, NULL)) {
+        return -1;
+    }
+    file.size = size;
+    file.version = record.version;
+    return 0;
+}
+
+int LogFileSystem::write_delete(int slot) {
+    File &file = _files[slot];
+    Record record;
+    memset(&record, 0, sizeof(record));
+    record.type = RECORD_DELETE;
+    record.id = file.id;
+    record.version = _version++;
+    if (append(slot, &record, NULL)) {
+        return -1;
+    }
+    memset(&file, 0, sizeof(File));
+    return 0;
+}
+
+int LogFileSystem::write_chunk(int slot, uint32_t chunk, const uint8_t *data, uint32_t length) {
+    File &file = _files[slot];
+    if (chunk >= MAX_CHUNKS) {
+        return -1;
+    }
+    Record record;
+    memset(&record, 0, sizeof(record));
+    record.type = RECORD_DATA;
+    record.length = length;
+    record.id = file.id;
+    record.version = _version++;
+    record.chunk = chunk;
+    record.size = file.size;
+    if (append(slot, &record, data)) {
+        return -1;
+    }
+    file.version = record.version;
+    return 0;
+}
+
+int LogFileSystem::read_chunks(int slot, uint32_t chunk, uint32_t count, uint8_t *buffer, uint32_t skip, uint32_t length) {
+    const File &file = _files[slot];
+    Cursor latest[READ_BATCH];
+    bool found[READ_BATCH] = {false};
+    if (count > READ_BATCH) {
+        return -1;
+    }
+
+    Cursor cursor;
+    for (uint32_t s = 0; s < _sector_count; s++) {
+        if (_sectors[s].state != SECTOR_USED || !marked(s, slot)) {
+            continue;
+        }
+        for (bool valid = record_first(s, &cursor); valid; valid = record_next(&cursor)) {
+            const Record &record = cursor.record;
+            uint32_t i = record.chunk - chunk;
+            if (record.type == RECORD_DATA && record.id == file.id && i < count &&
+                (!found[i] || record.version > latest[i].record.version)) {
+                latest[i] = cursor;
+                found[i] = true;
+            }
+        }
+    }
+
+    // the chunks read through the staging area, which is free here
+    for (uint32_t i = 0; i < count && length; i++) {
+        uint32_t n = _chunk_size - skip;
+        if (n > length) {
+            n = length;
+        }
+        uint32_t stored = found[i] ? latest[i].record.length : 0;
+        if (found[i] && record_payload(latest[i], _staging)) {
+            return -1;
+        }
+        for (uint32_t k = 0; k < n; k++) {
+            buffer[k] = (skip + k < stored) ? _staging[skip + k] : 0;
+        }
+        buffer += n;
+        length -= n;
+        skip = 0;
+    }
+    return 0;
+}
+
+FileHandle *LogFileSystem::open(const char *name, int flags) {
+    lock();
+    debug_if(LFS_DBG, "open(%s) on filesystem [%s]\n", name, getName());
+    char path[NAME_MAX_LENGTH + 1];
+    if (ensure_mounted() || !normalize(name, path) || !path[0]) {
+        unlock();
+        return NULL;
+    }
+
+    uint8_t *buffer = new (std::nothrow) uint8_t[_chunk_size];
+    if (!buffer) {
+        unlock();
+        return NULL;
+    }
+
+    int slot = find(path);
+    if (slot >= 0 && (_files[slot].flags & FILE_DIRECTORY)) {
+        slot = -1;
+    } else if (slot < 0) {
+        if ((flags & O_CREAT) && parent_exists(path) && (slot = find_free()) >= 0) {
+            File &file = _files[slot];
+            memset(&file, 0, sizeof(File));
+            file.id = _next_id++;
+            if (write_name(slot, path)) {
+                file.id = 0;
+                slot = -1;
+            }
+        }
+    } else if ((flags & O_TRUNC) && (flags & (O_WRONLY | O_RDWR)) && _files[slot].size) {
+        if (write_size(slot, 0)) {
+            slot = -1;
+        }
+    }
+
+    LogFileHandle *handle = (slot >= 0) ? new (std::nothrow) LogFileHandle(this, slot, flags, buffer) : NULL;
+    if (!handle) {
+        delete[] buffer;
+        unlock();
+        return NULL;
+    }
+    _files[slot].opened++;
+    _open_handles++;
+    unlock();
+    return handle;
+}
+
+int LogFileSystem::remove(const char *filename) {
+    lock();
+    char path[NAME_MAX_LENGTH + 1];
+    int slot = -1;
+    if (ensure_mounted() == 0 && normalize(filename, path)) {
+        slot = find(path);
+    }
+    if (slot < 0 || _files[slot].opened ||
+        ((_files[slot].flags & FILE_DIRECTORY) && !directory_empty(slot)) ||
+        write_delete(slot)) {
+        debug_if(LFS_DBG, "remove(%s) failed\n", filename);
+        unlock();
+        return -1;
+    }
+    unlock();
+    return 0;
+}
+
+int LogFileSystem::rename(const char *oldname, const char *newname) {
+    lock();
+    char oldpath[NAME_MAX_LENGTH + 1];
+    char newpath[NAME_MAX_LENGTH + 1];
+    int slot = -1;
+    if (ensure_mounted() == 0 && normalize(oldname, oldpath) && normalize(newname, newpath) && newpath[0]) {
+        slot = find(oldpath);
+    }
+    // the children of a directory would keep the old name
+    if (slot < 0 || find(newpath) >= 0 || !parent_exists(newpath) ||
+        ((_files[slot].flags & FILE_DIRECTORY) && !directory_empty(slot)) ||
+        write_name(slot, newpath)) {
+        debug_if(LFS_DBG, "rename(%s, %s) failed\n", oldname, newname);
+        unlock();
+        return -1;
+    }
+    unlock();
+    return 0;
+}
+
+DirHandle *LogFileSystem::opendir(const char *name) {
+    lock();
+    char path[NAME_MAX_LENGTH + 1];
+    if (ensure_mounted() || !normalize(name, path)) {
+        unlock();
+        return NULL;
+    }
+    int slot = path[0] ? find(path) : -1;
+    if (path[0] && (slot < 0 || !(_files[slot].flags & FILE_DIRECTORY))) {
+        unlock();
+        return NULL;
+    }
+    LogDirHandle *handle = new (std::nothrow) LogDirHandle(this, path);
+    unlock();
+    return handle;
+}
+
+int LogFileSystem::mkdir(const char *name, mode_t mode) {
+    (void)mode;
+    lock();
+    char path[NAME_MAX_LENGTH + 1];
+    int slot = -1;
+    if (ensure_mounted() == 0 && normalize(name, path) && path[0] && find(path) < 0 && parent_exists(path)) {
+        slot = find_free();
+    }
+    if (slot < 0) {
+        unlock();
+        return -1;
+    }
+    File &file = _files[slot];
+    memset(&file, 0, sizeof(File));
+    file.id = _next_id++;
+    file.flags = FILE_DIRECTORY;
+    if (write_name(slot, path)) {
+        file.id = 0;
+        unlock();
+        return -1;
+    }
+    unlock();
+    return 0;
+}
+
+int LogFileSystem::format() {
+    lock();
+    if (_open_handles || configure()) {
+        unlock();
+        return -1;
+    }
+    _mounted = false;
+
+    // the erase counts in the headers carry over
+    uint32_t used = 0;
+    uint32_t erase_total = 0;
+    for (uint32_t s = 0; s < _sector_count; s++) {
+        SectorHeader header;
+        _sectors[s].state = SECTOR_FREE;
+        if (storage_read(s * _sector_size, &header, sizeof(header)) == 0 &&
+            header.magic == SECTOR_MAGIC && header.crc == crc32(CRC_INITIAL, &header, offsetof(SectorHeader, crc))) {
+            _sectors[s].erase_count = header.erase_count;
+            erase_total += header.erase_count;
+            used++;
+        } else {
+            _sectors[s].erase_count = NO_SECTOR;
+        }
+    }
+    for (uint32_t s = 0; s < _sector_count; s++) {
+        if (_sectors[s].erase_count == NO_SECTOR) {
+            _sectors[s].erase_count = used ? erase_total / used : 0;
+        }
+        if (storage_erase(s)) {
+            unlock();
+            return -1;
+        }
+    }
+
+    _head = NO_SECTOR;
+    _free_count = _sector_count;
+    _sequence = 1;
+    if (open_sector()) {
+        unlock();
+        return -1;
+    }
+    int err = scan();
+    unlock();
+    return err;
+}
+
+int LogFileSystem::mount() {
+    lock();
+    int err = ensure_mounted();
+    unlock();
+    return err;
+}
+
+int LogFileSystem::unmount() {
+    lock();
+    if (_open_handles) {
+        unlock();
+        return -1;
+    }
+    release();
+    unlock();
+    return 0;
+}
+
+void LogFileSystem::lock() {
+    _mutex->lock();
+}
+
+void LogFileSystem::unlock() {
+    _mutex->unlock();
+}
@@ -0,0 +1,275 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_LOGFILESYSTEM_H
+#define MBED_LOGFILESYSTEM_H
+
+#include "FileSystemLike.h"
+#include "FileHandle.h"
+#include "PlatformMutex.h"
+#include "Driver_Storage.h"
+#include <stdint.h>
+
+using namespace mbed;
+
+/**
+ * A power-fail safe filesystem for NOR flash, on a Driver_Storage MTD
+ *
+ * The filesystem is a log of records appended to the erase sectors of the
+ * flash, each record protected by a CRC: a file is written in chunks, and
+ * every write of a chunk, like every create, rename, truncate and remove,
+ * appends a record superseding the earlier ones. Nothing is programmed twice
+ * or erased in place, so an interrupted write leaves the files as they were
+ * before the record it was writing.
+ *
+ * The log runs around the sectors: to free a sector, the oldest one has its
+ * live records copied to the head of the log and is erased, which wears all
+ * sectors evenly, static data included. A new sector is taken from the
+ * least worn free ones.
+ *
+ * Mounting reads the record headers, not the data. The memory used is fixed
+ * with the geometry: a few bytes per sector, about 80 bytes per file and 16
+ * per record a sector can hold for the filesystem, and a chunk for each open
+ * file.
+ *
+ * @code
+ * extern ARM_DRIVER_STORAGE ARM_Driver_Storage_MTD_K64F;
+ * LogFileSystem fs("log", &ARM_Driver_Storage_MTD_K64F, 0x80000, 0x80000);
+ *
+ * int main() {
+ *     if (fs.mount() != 0) {
+ *         fs.format();
+ *     }
+ *     FILE *f = fopen("/log/events.txt", "a");
+ *     ...
+ * }
+ * @endcode
+ *
+ * The filesystem owns the MTD: it initializes it with its own callback
+ * and waits for asynchronous operations to complete. The MTD can also be a
+ * storage volume (see StorageVolumeManager), sharing a flash with others.
+ *
+ * A file takes one writer at a time.
+ */
+class LogFileSystem : public FileSystemLike {
+public:
+
+    /** Create a log filesystem
+     *
+     * @param n          The name used to access the virtual filesystem
+     * @param mtd        The storage holding the filesystem
+     * @param start      The address of the first sector on the storage
+     * @param size       The size of the filesystem, at least 4 sectors
+     * @param max_files  The number of files and directories it can hold
+     * @param chunk_size The unit in which files are written, a multiple of
+     *                   the program unit of the storage
+     */
+    LogFileSystem(const char *n, ARM_DRIVER_STORAGE *mtd, uint64_t start, uint64_t size,
+                  uint32_t max_files = 32, uint32_t chunk_size = 256);
+    virtual ~LogFileSystem();
+
+    /**
+     * Opens a file on the filesystem
+     */
+    virtual FileHandle *open(const char *name, int flags);
+
+    /**
+     * Removes a file, or an empty directory
+     */
+    virtual int remove(const char *filename);
+
+    /**
+     * Renames a file, or an empty directory
+     */
+    virtual int rename(const char *oldname, const char *newname);
+
+    /**
+     * Opens a directory on the filesystem
+     */
+    virtual DirHandle *opendir(const char *name);
+
+    /**
+     * Creates a directory
+     */
+    virtual int mkdir(const char *name, mode_t mode);
+
+    /**
+     * Erases the storage for an empty filesystem, keeping the erase counts
+     */
+    virtual int format();
+
+    /**
+     * Mounts the filesystem, done on first use otherwise
+     */
+    virtual int mount();
+
+    /**
+     * Unmounts the filesystem, once its files are closed
+     */
+    virtual int unmount();
+
+    /** The longest path of a file, in bytes */
+    static const uint32_t NAME_MAX_LENGTH = 63;
+
+protected:
+
+    virtual void lock();
+    virtual void unlock();
+
+private:
+    friend class LogFileHandle;
+    friend class LogDirHandle;
+
+    /* The state of a sector */
+    struct Sector {
+        uint32_t sequence;    // order in which the sectors were taken for the log
+        uint32_t erase_count;
+        uint8_t  state;       // SECTOR_FREE, SECTOR_ERASED or SECTOR_USED
+    };
+
+    /* A file or directory */
+    struct File {
+        uint32_t id;          // 0 for an unused slot
+        uint32_t size;
+        uint32_t version;     // of the latest record of the file, holding its size
+        uint32_t name_version;
+        uint8_t  flags;       // FILE_DIRECTORY
+        uint8_t  opened;      // number of open handles
+        char     name[NAME_MAX_LENGTH + 1];
+    };
+
+    /* The header of a record, followed by length bytes of payload and a
+     * Commit */
+    struct Record {
+        uint8_t  type;        // RECORD_NAME, RECORD_DATA, RECORD_SIZE or RECORD_DELETE
+        uint8_t  flags;       // of the file, for RECORD_NAME
+        uint16_t length;
+        uint32_t id;
+        uint32_t version;
+        uint32_t chunk;       // the chunk of the file a RECORD_DATA holds
+        uint32_t size;        // of the file following the record
+        uint32_t crc;         // of the header up to here
+    };
+
+    /* Programmed last, completing a record */
+    struct Commit {
+        uint32_t data_crc;
+        uint32_t crc;         // of data_crc, following the CRC of the header
+    };
+
+    /* The location of a record while walking the log */
+    struct Cursor {
+        uint32_t sector;
+        uint32_t offset;
+        uint32_t next;        // offset of the following record
+        Record   record;
+        uint32_t data_crc;
+    };
+
+    /* A record of the sector being collected, which may be live */
+    struct Candidate {
+        uint32_t key;         // slot and chunk, see candidate_key()
+        uint32_t version;
+        uint32_t offset;
+        bool     superseded;
+    };
+
+    /* Storage access, waiting for asynchronous completion */
+    int storage_wait(int32_t status);
+    int storage_read(uint32_t addr, void *buffer, uint32_t size);
+    int storage_program(uint32_t addr, const void *buffer, uint32_t size);
+    int storage_erase(uint32_t sector);
+    static void storage_callback(int32_t status, ARM_STORAGE_OPERATION operation);
+
+    /* Geometry and records */
+    uint32_t align(uint32_t size) const;
+    uint32_t record_footprint(uint32_t length) const;
+    uint32_t sector_header_size() const;
+    bool record_first(uint32_t sector, Cursor *cursor);
+    bool record_next(Cursor *cursor);
+    int record_payload(const Cursor &cursor, void *buffer);
+    int program_staged(uint32_t footprint);
+    int append(int slot, Record *record, const void *payload);
+
+    /* The log */
+    int configure();
+    void release();
+    int ensure_mounted();
+    int scan();
+    int ensure_room(uint32_t footprint);
+    int open_sector();
+    int collect();
+    uint32_t candidate_key(int slot, const Record &record) const;
+
+    /* Presence of the files in the sectors */
+    void mark(uint32_t sector, int slot);
+    bool marked(uint32_t sector, int slot) const;
+    void unmark_all(uint32_t sector);
+
+    /* Files */
+    int find(const char *name) const;
+    int find_id(uint32_t id) const;
+    int find_free() const;
+    bool parent_exists(const char *name) const;
+    bool directory_empty(int slot) const;
+    static bool normalize(const char *name, char *path);
+    int write_name(int slot, const char *name);
+    int write_size(int slot, uint32_t size);
+    int write_delete(int slot);
+
+    /* Chunks, for the file handles */
+    static const uint32_t READ_BATCH = 8; // chunks looked up in one pass over the log
+    int write_chunk(int slot, uint32_t chunk, const uint8_t *data, uint32_t length);
+    int read_chunks(int slot, uint32_t chunk, uint32_t count, uint8_t *buffer, uint32_t skip, uint32_t length);
+
+    PlatformMutex *_mutex;
+    ARM_DRIVER_STORAGE *_mtd;
+    uint64_t _start;
+    uint64_t _size;
+    uint32_t _max_files;
+    uint32_t _chunk_size;
+
+    bool _mounted;
+    uint32_t _program_unit;
+    uint32_t _sector_size;
+    uint32_t _sector_count;
+    uint8_t _erased;
+    uint32_t _presence_words;
+
+    Sector *_sectors;
+    uint32_t *_presence;
+    File *_files;
+    Candidate *_candidates;
+    uint32_t _candidate_count;
+    uint8_t *_staging;
+    uint32_t _staging_size;
+
+    uint32_t _head;
+    uint32_t _head_offset;
+    uint32_t _free_count;
+    uint32_t _sequence;
+    uint32_t _version;
+    uint32_t _next_id;
+    uint32_t _open_handles;
+    bool _collecting;
+};
+
+#endif
@@ -60,10 +60,11 @@
  * just always use the Standard Capacity cards with a block size of 512 bytes.
  * This is set with CMD16.
  *
- * You can read and write single blocks (CMD17, CMD25) or multiple blocks
- * (CMD18, CMD25). For simplicity, I'll just use single block accesses. When
- * the card gets a read command, it responds with a response token, and then
- * a data token or an error.
+ * You can read and write single blocks (CMD17, CMD24) or multiple blocks
+ * (CMD18, CMD25). Single blocks are used for single block accesses, and
+ * multiple blocks for the rest, which saves a command and the card's
+ * programming latency per block. When the card gets a read command, it
+ * responds with a response token, and then a data token or an error.
  *
  * SPI Command Format
  * ------------------
@@ -111,11 +112,38 @@
  * +------+---------+---------+- -  - -+---------+-----------+----------+
  * | 0xFE | data[0] | data[1] |        | data[n] | crc[15:8] | crc[7:0] |
  * +------+---------+---------+- -  - -+---------+-----------+----------+
+ *
+ * The data is clocked with SPI block writes rather than a call per byte.
+ *
+ * Multiple Block Read and Write
+ * -----------------------------
+ *
+ * After CMD18 the card sends data blocks until it gets STOP_TRANSMISSION
+ * (CMD12), whose R1b response follows a stuff byte. Before CMD25 the
+ * number of blocks is given with SET_WR_BLK_ERASE_COUNT (ACMD23) so the
+ * card can pre-erase them. Each block written starts with 0xFC instead of
+ * 0xFE and is acknowledged like a single block, and the stop token 0xFD
+ * ends the transfer.
+ *
+ * Clock
+ * -----
+ *
+ * Cards initialise at 100-400kHz. Once initialised, data moves at the
+ * transfer clock, lowered to the TRAN_SPEED of the CSD if the card is
+ * slower.
  */
 #include "SDFileSystem.h"
 #include "mbed_debug.h"
 
 #define SD_COMMAND_TIMEOUT 5000
+#define SD_READ_TIMEOUT_MS  100
+#define SD_WRITE_TIMEOUT_MS 500
+
+#define SD_BLOCK_SIZE       512
+
+#define SD_TOKEN_BLOCK      0xFE
+#define SD_TOKEN_MULTI      0xFC
+#define SD_TOKEN_STOP       0xFD
 
 #define SD_DBG             0
 
@@ -123,9 +151,11 @@ SDFileSystem::SDFileSystem(PinName mosi, PinName miso, PinName sclk, PinName cs,
     FATFileSystem(name), _spi(mosi, miso, sclk), _cs(cs), _is_initialized(0) {
     _cs = 1;
 
-    // Set default to 100kHz for initialisation and 1MHz for data transfer
+    // Set default to 100kHz for initialisation and 25MHz for data transfer,
+    // lowered to what the card supports once its CSD is read
     _init_sck = 100000;
-    _transfer_sck = 1000000;
+    _transfer_sck = 25000000;
+    _card_sck = _transfer_sck;
 }
 
 #define R1_IDLE_STATE           (1 << 0)
@@ -224,7 +254,7 @@ int SDFileSystem::disk_initialize() {
     }
 
     // Set SCK for data transfer
-    _spi.frequency(_transfer_sck);
+    _spi.frequency(_transfer_sck < _card_sck ? _transfer_sck : _card_sck);
     unlock();
     return 0;
 }
@@ -235,21 +265,50 @@ int SDFileSystem::disk_write(const uint8_t* buffer, uint32_t block_number, uint3
         unlock();
         return -1;
     }
-    
-    for (uint32_t b = block_number; b < block_number + count; b++) {
+
+    if (count == 1) {
         // set write address for single block (CMD24)
-        if (_cmd(24, b * cdv) != 0) {
+        if (_cmd(24, block_number * cdv) != 0) {
             unlock();
             return 1;
         }
-        
+
         // send the data block
-        _write(buffer, 512);
-        buffer += 512;
+        int ret = _write(buffer, SD_BLOCK_SIZE);
+        unlock();
+        return ret;
     }
-    
+
+    // let the card pre-erase the blocks (ACMD23), it is only a hint
+    _cmd(55, 0);
+    _cmd(23, count);
+
+    _spi.lock();
+    _cs = 0;
+
+    // set write address for multiple blocks (CMD25)
+    int ret = (_command(25, block_number * cdv) != 0);
+    if (ret == 0) {
+        for (uint32_t b = 0; b < count && !ret; b++) {
+            ret = _write_data(SD_TOKEN_MULTI, buffer, SD_BLOCK_SIZE);
+            buffer += SD_BLOCK_SIZE;
+        }
+
+        // end the transfer, also after an error, and wait for the last
+        // block to be programmed
+        _spi.write(SD_TOKEN_STOP);
+        _spi.write(0xFF);
+        if (_wait_ready(SD_WRITE_TIMEOUT_MS) != 0) {
+            ret = 1;
+        }
+    }
+
+    _cs = 1;
+    _spi.write(0xFF);
+    _spi.unlock();
+
     unlock();
-    return 0;
+    return ret;
 }
 
 int SDFileSystem::disk_read(uint8_t* buffer, uint32_t block_number, uint32_t count) {
@@ -258,21 +317,50 @@ int SDFileSystem::disk_read(uint8_t* buffer, uint32_t block_number, uint32_t cou
         unlock();
         return -1;
     }
-    
-    for (uint32_t b = block_number; b < block_number + count; b++) {
+
+    if (count == 1) {
         // set read address for single block (CMD17)
-        if (_cmd(17, b * cdv) != 0) {
+        if (_cmd(17, block_number * cdv) != 0) {
             unlock();
             return 1;
         }
-        
+
         // receive the data
-        _read(buffer, 512);
-        buffer += 512;
+        int ret = _read(buffer, SD_BLOCK_SIZE);
+        unlock();
+        return ret;
+    }
+
+    _spi.lock();
+    _cs = 0;
+
+    // set read address for multiple blocks (CMD18)
+    int ret = (_command(18, block_number * cdv) != 0);
+    if (ret == 0) {
+        for (uint32_t b = 0; b < count && !ret; b++) {
+            ret = _read_data(buffer, SD_BLOCK_SIZE);
+            buffer += SD_BLOCK_SIZE;
+        }
+
+        // stop the transmission (CMD12), its response follows a stuff byte
+        _spi.write(0x40 | 12);
+        _spi.write(0x00);
+        _spi.write(0x00);
+        _spi.write(0x00);
+        _spi.write(0x00);
+        _spi.write(0x95);
+        _spi.write(0xFF);
+        if (_response() < 0 || _wait_ready(SD_READ_TIMEOUT_MS) != 0) {
+            ret = 1;
+        }
     }
 
+    _cs = 1;
+    _spi.write(0xFF);
+    _spi.unlock();
+
     unlock();
-    return 0;
+    return ret;
 }
 
 int SDFileSystem::disk_status() {
@@ -297,29 +385,52 @@ int SDFileSystem::_cmd(int cmd, int arg) {
     _spi.lock();
     _cs = 0;
 
+    int response = _command(cmd, arg);
+
+    _cs = 1;
+    _spi.write(0xFF);
+    _spi.unlock();
+    return response;
+}
+
+// with the card selected and the SPI locked
+int SDFileSystem::_command(int cmd, int arg) {
+    char frame[6] = {
+        (char)(0x40 | cmd),
+        (char)(arg >> 24),
+        (char)(arg >> 16),
+        (char)(arg >> 8),
+        (char)(arg >> 0),
+        (char)0x95
+    };
+
     // send a command
-    _spi.write(0x40 | cmd);
-    _spi.write(arg >> 24);
-    _spi.write(arg >> 16);
-    _spi.write(arg >> 8);
-    _spi.write(arg >> 0);
-    _spi.write(0x95);
+    _spi.write(frame, sizeof(frame), NULL, 0);
+    return _response();
+}
 
+int SDFileSystem::_response() {
     // wait for the repsonse (response[7] == 0)
     for (int i = 0; i < SD_COMMAND_TIMEOUT; i++) {
         int response = _spi.write(0xFF);
         if (!(response & 0x80)) {
-            _cs = 1;
-            _spi.write(0xFF);
-            _spi.unlock();
             return response;
         }
     }
-    _cs = 1;
-    _spi.write(0xFF);
-    _spi.unlock();
     return -1; // timeout
 }
+
+int SDFileSystem::_wait_ready(int timeout_ms) {
+    // the card holds the data line low while it is busy
+    Timer timer;
+    timer.start();
+    while (_spi.write(0xFF) != 0xFF) {
+        if (timer.read_ms() > timeout_ms) {
+            return 1;
+        }
+    }
+    return 0;
+}
 int SDFileSystem::_cmdx(int cmd, int arg) {
     _spi.lock();
     _cs = 0;
@@ -417,33 +528,55 @@ int SDFileSystem::_read(uint8_t *buffer, uint32_t length) {
     _spi.lock();
     _cs = 0;
 
-    // read until start byte (0xFF)
-    while (_spi.write(0xFF) != 0xFE);
-
-    // read data
-    for (uint32_t i = 0; i < length; i++) {
-        buffer[i] = _spi.write(0xFF);
-    }
-    _spi.write(0xFF); // checksum
-    _spi.write(0xFF);
+    int ret = _read_data(buffer, length);
 
     _cs = 1;
     _spi.write(0xFF);
     _spi.unlock();
-    return 0;
+    return ret;
 }
 
 int SDFileSystem::_write(const uint8_t*buffer, uint32_t length) {
     _spi.lock();
     _cs = 0;
 
+    int ret = _write_data(SD_TOKEN_BLOCK, buffer, length);
+
+    _cs = 1;
+    _spi.write(0xFF);
+    _spi.unlock();
+    return ret;
+}
+
+// with the card selected and the SPI locked
+int SDFileSystem::_read_data(uint8_t *buffer, uint32_t length) {
+    // read until start byte (0xFE)
+    Timer timer;
+    timer.start();
+    int token;
+    while ((token = _spi.write(0xFF)) == 0xFF) {
+        if (timer.read_ms() > SD_READ_TIMEOUT_MS) {
+            return 1;
+        }
+    }
+    if (token != SD_TOKEN_BLOCK) {
+        // data error token
+        return 1;
+    }
+
+    // read data, the checksum is ignored
+    _spi.write(NULL, 0, (char *)buffer, length);
+    _spi.write(0xFF);
+    _spi.write(0xFF);
+    return 0;
+}
+
+int SDFileSystem::_write_data(int token, const uint8_t *buffer, uint32_t length) {
     // indicate start of block
-    _spi.write(0xFE);
+    _spi.write(token);
 
     // write the data
-    for (uint32_t i = 0; i < length; i++) {
-        _spi.write(buffer[i]);
-    }
+    _spi.write((const char *)buffer, length, NULL, 0);
 
     // write the checksum
     _spi.write(0xFF);
@@ -451,19 +584,11 @@ int SDFileSystem::_write(const uint8_t*buffer, uint32_t length) {
 
     // check the response token
     if ((_spi.write(0xFF) & 0x1F) != 0x05) {
-        _cs = 1;
-        _spi.write(0xFF);
-        _spi.unlock();
         return 1;
     }
 
     // wait for write to finish
-    while (_spi.write(0xFF) == 0);
-
-    _cs = 1;
-    _spi.write(0xFF);
-    _spi.unlock();
-    return 0;
+    return _wait_ready(SD_WRITE_TIMEOUT_MS);
 }
 
 static uint32_t ext_bits(unsigned char *data, int msb, int lsb) {
@@ -479,6 +604,20 @@ static uint32_t ext_bits(unsigned char *data, int msb, int lsb) {
     return bits;
 }
 
+// TRAN_SPEED is a time value times a rate unit, both in tenths
+static uint32_t tran_speed_hz(uint32_t tran_speed) {
+    static const uint8_t values[16] = { 0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80 };
+    static const uint32_t units[4] = { 10000, 100000, 1000000, 10000000 };
+
+    uint32_t unit = tran_speed & 0x7;
+    uint32_t value = values[(tran_speed >> 3) & 0xF];
+    if (unit > 3 || value == 0) {
+        // reserved, keep to the default speed
+        return 25000000;
+    }
+    return units[unit] * value;
+}
+
 uint32_t SDFileSystem::_sd_sectors() {
     uint32_t c_size, c_size_mult, read_bl_len;
     uint32_t block_len, mult, blocknr, capacity;
@@ -498,12 +637,19 @@ uint32_t SDFileSystem::_sd_sectors() {
     }
 
     // csd_structure : csd[127:126]
+    // tran_speed    : csd[103:96]
     // c_size        : csd[73:62]
     // c_size_mult   : csd[49:47]
     // read_bl_len   : csd[83:80] - the *maximum* read block length
 
     int csd_structure = ext_bits(csd, 127, 126);
 
+    // SPI mode stays at the default speed, 25MHz at most
+    _card_sck = tran_speed_hz(ext_bits(csd, 103, 96));
+    if (_card_sck > 25000000) {
+        _card_sck = 25000000;
+    }
+
     switch (csd_structure) {
         case 0:
             cdv = 512;
@@ -63,6 +63,9 @@ protected:
 
     int _cmd(int cmd, int arg);
     int _cmdx(int cmd, int arg);
+    int _command(int cmd, int arg);
+    int _response();
+    int _wait_ready(int timeout_ms);
     int _cmd8();
     int _cmd58();
     int initialise_card();
@@ -71,6 +74,8 @@ protected:
 
     int _read(uint8_t * buffer, uint32_t length);
     int _write(const uint8_t *buffer, uint32_t length);
+    int _read_data(uint8_t *buffer, uint32_t length);
+    int _write_data(int token, const uint8_t *buffer, uint32_t length);
     uint32_t _sd_sectors();
     uint32_t _sectors;
 
@@ -79,6 +84,8 @@ protected:
     void set_transfer_sck(uint32_t sck) { _transfer_sck = sck; }
     uint32_t _init_sck;
     uint32_t _transfer_sck;
+    // highest clock in the card CSD
+    uint32_t _card_sck;
 
     SPI _spi;
     DigitalOut _cs;
@@ -0,0 +1,113 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+/* The SD bus of the host controller carries the commands on CMD and the
+ * blocks on 1 or 4 data lines, with a CRC on both. The host HAL identifies
+ * the card, sets the bus width and moves the blocks by DMA, using the
+ * multiple block commands (CMD18, CMD25) for more than one block. Blocks
+ * are always 512 bytes.
+ */
+#include "SDIOFileSystem.h"
+
+#if DEVICE_SDIO
+
+#include "mbed_debug.h"
+
+#define SDIO_DBG             0
+
+SDIOFileSystem::SDIOFileSystem(PinName clk, PinName cmd, PinName d0, PinName d1, PinName d2, PinName d3,
+                               const char* name, uint32_t hz) :
+    FATFileSystem(name), _clk(clk), _cmd(cmd), _d0(d0), _d1(d1), _d2(d2), _d3(d3),
+    _hz(hz), _sectors(0), _is_initialized(0) {
+}
+
+SDIOFileSystem::~SDIOFileSystem() {
+    if (_is_initialized) {
+        sdio_free(&_sdio);
+    }
+}
+
+int SDIOFileSystem::disk_initialize() {
+    lock();
+    if (_is_initialized) {
+        sdio_free(&_sdio);
+        _is_initialized = 0;
+    }
+
+    if (sdio_init(&_sdio, _clk, _cmd, _d0, _d1, _d2, _d3, _hz) != 0) {
+        debug("Fail to initialize card\n");
+        unlock();
+        return 1;
+    }
+
+    sdio_card_info_t info;
+    sdio_card_info(&_sdio, &info);
+    _sectors = info.block_count;
+    _is_initialized = 1;
+    debug_if(SDIO_DBG, "init card: %lu sectors, %lu Hz, %d-bit\n",
+             _sectors, info.clock_hz, info.bus_width);
+    unlock();
+    return 0;
+}
+
+int SDIOFileSystem::disk_write(const uint8_t* buffer, uint32_t block_number, uint32_t count) {
+    lock();
+    if (!_is_initialized) {
+        unlock();
+        return -1;
+    }
+
+    int ret = (sdio_write_blocks(&_sdio, buffer, block_number, count) != 0);
+    unlock();
+    return ret;
+}
+
+int SDIOFileSystem::disk_read(uint8_t* buffer, uint32_t block_number, uint32_t count) {
+    lock();
+    if (!_is_initialized) {
+        unlock();
+        return -1;
+    }
+
+    int ret = (sdio_read_blocks(&_sdio, buffer, block_number, count) != 0);
+    unlock();
+    return ret;
+}
+
+int SDIOFileSystem::disk_status() {
+    lock();
+    // FATFileSystem::disk_status() returns 0 when initialized
+    int ret = _is_initialized ? 0 : 1;
+    unlock();
+    return ret;
+}
+
+// sdio_write_blocks returns once the card has programmed the blocks
+int SDIOFileSystem::disk_sync() { return 0; }
+
+uint32_t SDIOFileSystem::disk_sectors() {
+    lock();
+    uint32_t sectors = _sectors;
+    unlock();
+    return sectors;
+}
+
+#endif
@@ -0,0 +1,90 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef MBED_SDIOFILESYSTEM_H
+#define MBED_SDIOFILESYSTEM_H
+
+#include "mbed.h"
+
+#if DEVICE_SDIO
+
+#include "FATFileSystem.h"
+#include "sdio_api.h"
+#include <stdint.h>
+
+/** Access the filesystem on an SD Card using the SD bus of an SDIO host
+ *
+ * The blocks move by DMA over 4 data lines, several blocks per command,
+ * which is many times faster than an SDFileSystem on SPI.
+ *
+ * @code
+ * #include "mbed.h"
+ * #include "SDIOFileSystem.h"
+ *
+ * SDIOFileSystem sd(PC_12, PD_2, PC_8, PC_9, PC_10, PC_11, "sd"); // clk, cmd, d0-d3
+ *
+ * int main() {
+ *     FILE *fp = fopen("/sd/myfile.txt", "w");
+ *     fprintf(fp, "Hello World!\n");
+ *     fclose(fp);
+ * }
+ */
+class SDIOFileSystem : public FATFileSystem {
+public:
+
+    /** Create the File System for accessing an SD Card using SDIO
+     *
+     * @param clk  SDIO clock pin connected to SD Card
+     * @param cmd  SDIO command pin connected to SD Card
+     * @param d0   First data pin connected to SD Card
+     * @param d1   Second data pin, NC for a 1-bit bus
+     * @param d2   Third data pin, NC for a 1-bit bus
+     * @param d3   Fourth data pin, NC for a 1-bit bus
+     * @param name The name used to access the virtual filesystem
+     * @param hz   The highest data clock, at most 25 MHz in default speed
+     */
+    SDIOFileSystem(PinName clk, PinName cmd, PinName d0, PinName d1, PinName d2, PinName d3,
+                   const char* name, uint32_t hz = 24000000);
+    virtual ~SDIOFileSystem();
+    virtual int disk_initialize();
+    virtual int disk_status();
+    virtual int disk_read(uint8_t* buffer, uint32_t block_number, uint32_t count);
+    virtual int disk_write(const uint8_t* buffer, uint32_t block_number, uint32_t count);
+    virtual int disk_sync();
+    virtual uint32_t disk_sectors();
+
+protected:
+
+    sdio_t _sdio;
+    PinName _clk;
+    PinName _cmd;
+    PinName _d0;
+    PinName _d1;
+    PinName _d2;
+    PinName _d3;
+    uint32_t _hz;
+    uint32_t _sectors;
+    int _is_initialized;
+};
+
+#endif
+
+#endif
@@ -32,7 +32,7 @@ using std::memmove;
 #include "ATCommandsInterface.h"
 
 ATCommandsInterface::ATCommandsInterface(IOStream* pStream) :
-   m_pStream(pStream), m_open(false), m_transactionState(IDLE), m_env2AT(), m_AT2Env(), m_processingMtx(),
+   m_pStream(pStream), m_open(false), m_transactionState(IDLE), m_inputStart(0), m_inputPos(0), m_env2AT(), m_AT2Env(), m_processingMtx(),
    m_processingThread(&ATCommandsInterface::staticCallback, this, (osPriority)AT_THREAD_PRIORITY, 4*192),
    m_eventsMgmtMtx(), m_eventsProcessingMtx()
 {
@@ -298,6 +298,14 @@ int ATCommandsInterface::tryReadLine()
 {
   static bool lineDetected = false;
 
+  //Lines are parsed in place from m_inputStart; shift what is left of the last read once, before reading more
+  if(m_inputStart > 0)
+  {
+    memmove(m_inputBuf, m_inputBuf + m_inputStart, (m_inputPos + 1) - m_inputStart); //Move null-terminating char as well
+    m_inputPos = m_inputPos - m_inputStart; //Adjust m_inputPos
+    m_inputStart = 0;
+  }
+
   //Block on serial read or incoming command
   DBG("Trying to read a new line from stream");
   int ret = m_pStream->waitAvailable(); //This can be aborted
@@ -337,8 +345,10 @@ int ATCommandsInterface::tryReadLine()
     if(!lineDetected)
     {
       DBG("No line detected yet");
+      char* buf = m_inputBuf + m_inputStart; //Unprocessed data
+      int len = m_inputPos - m_inputStart;
       //Try to look for a starting CRLF
-      char* crPtr = strchr(m_inputBuf, CR);
+      char* crPtr = strchr(buf, CR);
       /*
       Different cases at this point:
       - CRLF%c sequence: this is the start of a line
@@ -348,29 +358,23 @@ int ATCommandsInterface::tryReadLine()
       - %c ... CR sequence: this should be the echo of the previous sequence
       - %c sequence: This might be the echo of the previous command; more data is needed to determine which action to take
 
-      In every case, move mem at the beginning
+      In every case, consume the processed chars
       */
       if(crPtr != NULL)
       {
         DBG("CR char found");
 
-#if 0
-        //Discard all preceding characters (can do nothing if m_inputBuf == crPtr)
-        memmove(m_inputBuf, crPtr, (m_inputPos + 1) - (crPtr-m_inputBuf)); //Move null-terminating char as well
-        m_inputPos = m_inputPos - (crPtr-m_inputBuf); //Adjust m_inputPos
-#endif
-
         //If the line starts with CR, this should be a result code
-        if( crPtr == m_inputBuf )
+        if( crPtr == buf )
         {
           //To determine the sequence we need at least 3 chars
-          if(m_inputPos >= 3)
+          if(len >= 3)
           {
             //Look for a LF char next to the CR char
-            if(m_inputBuf[1] == LF)
+            if(buf[1] == LF)
             {
               //At this point we can check whether this is the end of a preceding line or the beginning of a new one
-              if(m_inputBuf[2] != CR)
+              if(buf[2] != CR)
               {
                 DBG("Beginning of new line found");
                 //Beginning of a line
@@ -383,61 +387,55 @@ int ATCommandsInterface::tryReadLine()
               }
               //In both cases discard CRLF
               DBG("Discarding CRLF");
-              memmove(m_inputBuf, m_inputBuf + 2, (m_inputPos + 1) - 2); //Move null-terminating char as well
-              m_inputPos = m_inputPos - 2; //Adjust m_inputPos
+              m_inputStart += 2;
             }
             else
             {
               //This is completely unexpected, discard the CR char to try to recover good state
-              WARN("Unexpected %c char (%02d code) found after CR char", m_inputBuf[1]);
-              memmove(m_inputBuf, m_inputBuf + 1, (m_inputPos + 1) - 1); //Move null-terminating char as well
-              m_inputPos = m_inputPos - 1; //Adjust m_inputPos
+              WARN("Unexpected %c char (%02d code) found after CR char", buf[1]);
+              m_inputStart += 1;
             }
           }
         }
         //if the line does NOT begin with CR, this can be an echo of the previous command, process it
         else
         {
-          int crPos = crPtr - m_inputBuf;
+          int crPos = crPtr - buf;
           int lfOff = 0; //Offset for LF if present
           DBG("New line found (possible echo of command)");
           //This is the end of line
-          //Replace m_inputBuf[crPos] with null-terminating char
-          m_inputBuf[crPos] = '\0';
+          //Replace buf[crPos] with null-terminating char
+          buf[crPos] = '\0';
           //Check if there is a LF char afterwards
-          if(m_inputPos - crPos >= 1)
+          if(len - crPos > 1)
           {
-            if(m_inputBuf[crPos+1] == LF)
+            if(buf[crPos+1] == LF)
             {
               lfOff++; //We will discard LF char as well
             }
           }
+          //Consume the line before processing it, the processor may read the data following it
+          m_inputStart += crPos + lfOff + 1;
           //Process line
-          int ret = processReadLine();
+          int ret = processReadLine(buf);
           if(ret)
           {
+            m_inputStart = 0;
             m_inputPos = 0;
             m_inputBuf[0] = '\0'; //Always have a null-terminating char at start of buffer
             lineDetected = false;
             return ret;
           }
 
-          //If sendData has been called, all incoming data has been discarded
-          if(m_inputPos > 0)
-          {
-            memmove(m_inputBuf, m_inputBuf + crPos + lfOff + 1, (m_inputPos + 1) - (crPos + lfOff + 1)); //Move null-terminating char as well
-            m_inputPos = m_inputPos - (crPos + lfOff + 1); //Adjust m_inputPos
-          }
           DBG("One line was successfully processed");
           lineProcessed = true; //Line was processed with success
           lineDetected = false; //Search now for a new line
         }
       }
-      else if(m_inputBuf[0] == LF) //If there is a remaining LF char from the previous line, discard it
+      else if(buf[0] == LF) //If there is a remaining LF char from the previous line, discard it
       {
         DBG("Discarding single LF char");
-        memmove(m_inputBuf, m_inputBuf + 1, (m_inputPos + 1) - 1); //Move null-terminating char as well
-        m_inputPos = m_inputPos - 1; //Adjust m_inputPos
+        m_inputStart += 1;
       }
     }
 
@@ -445,8 +443,10 @@ int ATCommandsInterface::tryReadLine()
     if(lineDetected)
     {
       DBG("Looking for end of line");
+      char* buf = m_inputBuf + m_inputStart; //Unprocessed data
+      int len = m_inputPos - m_inputStart;
       //Try to look for a terminating CRLF
-      char* crPtr = strchr(m_inputBuf, CR);
+      char* crPtr = strchr(buf, CR);
       /*
       Different cases at this point:
       - CRLF sequence: this is the end of the line
@@ -455,7 +455,7 @@ int ATCommandsInterface::tryReadLine()
       */
 
       //Try to look for a '>' (greater than character) that marks an entry prompt
-      char* greaterThanPtr = strchr(m_inputBuf, GD);
+      char* greaterThanPtr = strchr(buf, GD);
       /*
       This character must be detected as there is no CRLF sequence at the end of an entry prompt
        */
@@ -463,44 +463,38 @@ int ATCommandsInterface::tryReadLine()
       if(crPtr != NULL)
       {
         DBG("CR char found");
-        int crPos = crPtr - m_inputBuf;
+        int crPos = crPtr - buf;
         //To determine the sequence we need at least 2 chars
-        if(m_inputPos - crPos >= 2)
+        if(len - crPos >= 2)
         {
           //Look for a LF char next to the CR char
-          if(m_inputBuf[crPos + 1] == LF)
+          if(buf[crPos + 1] == LF)
           {
             DBG("End of new line found");
             //This is the end of line
-            //Replace m_inputBuf[crPos] with null-terminating char
-            m_inputBuf[crPos] = '\0';
+            //Replace buf[crPos] with null-terminating char
+            buf[crPos] = '\0';
+            //Consume the line before processing it, the processor may read the data following it
+            m_inputStart += crPos + 2;
             //Process line
-            int ret = processReadLine();
+            int ret = processReadLine(buf);
             if(ret)
             {
+              m_inputStart = 0;
               m_inputPos = 0;
               m_inputBuf[0] = '\0'; //Always have a null-terminating char at start of buffer
               lineDetected = false;
               return ret;
             }
 
-            //If sendData has been called, all incoming data has been discarded
-            if(m_inputPos > 0)
-            {
-              //Shift remaining data to beginning of buffer
-              memmove(m_inputBuf, m_inputBuf + crPos + 2, (m_inputPos + 1) - (crPos + 2)); //Move null-terminating char as well
-              m_inputPos = m_inputPos - (crPos + 2); //Adjust m_inputPos
-            }
-
             DBG("One line was successfully processed");
             lineProcessed = true; //Line was processed with success
           }
           else
           {
             //This is completely unexpected, discard all chars till the CR char to try to recover good state
-            WARN("Unexpected %c char (%02d code) found in incoming line", m_inputBuf[crPos + 1]);
-            memmove(m_inputBuf, m_inputBuf + crPos + 1, (m_inputPos + 1) - (crPos + 1)); //Move null-terminating char as well
-            m_inputPos = m_inputPos - (crPos + 1); //Adjust m_inputPos
+            WARN("Unexpected %c char (%02d code) found in incoming line", buf[crPos + 1]);
+            m_inputStart += crPos + 1;
           }
           lineDetected = false; //In both case search now for a new line
         }
@@ -508,25 +502,21 @@ int ATCommandsInterface::tryReadLine()
       else if(greaterThanPtr != NULL)
       {
         DBG("> char found");
-        int gdPos = greaterThanPtr - m_inputBuf;
+        int gdPos = greaterThanPtr - buf;
         //To determine the sequence we need at least 2 chars
-        if(m_inputPos - gdPos >= 2)
+        if(len - gdPos >= 2)
         {
           //Look for a space char next to the GD char
-          if(m_inputBuf[gdPos + 1] == ' ')
+          if(buf[gdPos + 1] == ' ')
           {
             //This is an entry prompt
-            //Replace m_inputBuf[gdPos] with null-terminating char
-            m_inputBuf[gdPos] = '\0';
-
-            //Shift remaining data to beginning of buffer
-            memmove(m_inputBuf, m_inputBuf + gdPos + 1, (m_inputPos + 1) - (gdPos + 1)); //Move null-terminating char as well
-            m_inputPos = m_inputPos - (gdPos + 1); //Adjust m_inputPos
+            m_inputStart += gdPos + 1;
 
             //Process prompt
             ret = processEntryPrompt();
             if(ret)
             {
+              m_inputStart = 0;
               m_inputPos = 0;
               m_inputBuf[0] = '\0'; //Always have a null-terminating char at start of buffer
               lineDetected = false;
@@ -539,9 +529,8 @@ int ATCommandsInterface::tryReadLine()
           else
           {
             //This is completely unexpected, discard all chars till the GD char to try to recover good state
-            WARN("Unexpected %c char (%02d code) found in incoming line", m_inputBuf[gdPos + 1]);
-            memmove(m_inputBuf, m_inputBuf + gdPos + 1, (m_inputPos + 1) - (gdPos + 1)); //Move null-terminating char as well
-            m_inputPos = m_inputPos - (gdPos + 1); //Adjust m_inputPos
+            WARN("Unexpected %c char (%02d code) found in incoming line", buf[gdPos + 1]);
+            m_inputStart += gdPos + 1;
           }
           lineDetected = false; //In both case search now for a new line
         }
@@ -550,7 +539,7 @@ int ATCommandsInterface::tryReadLine()
   } while(lineProcessed); //If one complete line was processed there might be other incoming lines that can also be processed without reading the buffer again
 
   //If the line could not be processed AND buffer is full, it means that we won't ever be able to process it (buffer too short)
-  if(m_inputPos == AT_INPUT_BUF_SIZE - 1)
+  if((m_inputStart == 0) && (m_inputPos == AT_INPUT_BUF_SIZE - 1))
   {
     //Discard everything
     m_inputPos = 0;
@@ -597,14 +586,13 @@ int ATCommandsInterface::trySendCommand()
   return OK;
 }
 
-int ATCommandsInterface::processReadLine()
+int ATCommandsInterface::processReadLine(char* line)
 {
-  DBG("Processing read line [%s]", m_inputBuf);
-  //The line is stored in m_inputBuf
+  DBG("Processing read line [%s]", line);
   if(m_transactionState == COMMAND_SENT)
   {
     //If the command has been sent, checks echo to see if it has been received properly
-    if( strcmp(m_transactionCommand, m_inputBuf) == 0 )
+    if( strcmp(m_transactionCommand, line) == 0 )
     {
       DBG("Command echo received");
       //If so, it means that the following lines will only be solicited results
@@ -615,7 +603,7 @@ int ATCommandsInterface::processReadLine()
   if(m_transactionState == IDLE || m_transactionState == COMMAND_SENT)
   {
     bool found = false;
-    char* pSemicol = strchr(m_inputBuf, ':');
+    char* pSemicol = strchr(line, ':');
     char* pData = NULL;
     if( pSemicol != NULL ) //Split the identifier & the result code (if it exists)
     {
@@ -633,9 +621,9 @@ int ATCommandsInterface::processReadLine()
     {
       if( m_eventsHandlers[i] != NULL )
       {
-        if( m_eventsHandlers[i]->isATCodeHandled(m_inputBuf) )
+        if( m_eventsHandlers[i]->isATCodeHandled(line) )
         {
-          m_eventsHandlers[i]->onEvent(m_inputBuf, pData);
+          m_eventsHandlers[i]->onEvent(line, pData);
           found = true; //Do not break here as there might be multiple handlers for one event type
         }
       }
@@ -649,7 +637,7 @@ int ATCommandsInterface::processReadLine()
   if(m_transactionState == READING_RESULT)
   {
     //The following lines can either be a command response or a result code (OK / ERROR / CONNECT / +CME ERROR: %s / +CMS ERROR: %s)
-    if(strcmp("OK", m_inputBuf) == 0)
+    if(strcmp("OK", line) == 0)
     {
       DBG("OK result received");
       m_transactionResult.code = 0;
@@ -660,7 +648,7 @@ int ATCommandsInterface::processReadLine()
       m_AT2Env.put(msg); //Command has been processed
       return OK;
     }
-    else if(strcmp("ERROR", m_inputBuf) == 0)
+    else if(strcmp("ERROR", line) == 0)
     {
       DBG("ERROR result received");
       m_transactionResult.code = 0;
@@ -671,7 +659,7 @@ int ATCommandsInterface::processReadLine()
       m_AT2Env.put(msg); //Command has been processed
       return OK;
     }
-    else if(strncmp("CONNECT", m_inputBuf, 7 /*=strlen("CONNECT")*/) == 0) //Result can be "CONNECT" or "CONNECT %d", indicating baudrate
+    else if(strncmp("CONNECT", line, 7 /*=strlen("CONNECT")*/) == 0) //Result can be "CONNECT" or "CONNECT %d", indicating baudrate
     {
       DBG("CONNECT result received");
       m_transactionResult.code = 0;
@@ -682,7 +670,7 @@ int ATCommandsInterface::processReadLine()
       m_AT2Env.put(msg); //Command has been processed
       return OK;
     }
-    else if(strcmp("COMMAND NOT SUPPORT", m_inputBuf) == 0) //Huawei-specific, not normalized
+    else if(strcmp("COMMAND NOT SUPPORT", line) == 0) //Huawei-specific, not normalized
     {
       DBG("COMMAND NOT SUPPORT result received");
       m_transactionResult.code = 0;
@@ -693,9 +681,9 @@ int ATCommandsInterface::processReadLine()
       m_AT2Env.put(msg); //Command has been processed
       return OK;
     }
-    else if(strstr(m_inputBuf, "+CME ERROR:") == m_inputBuf) //Mobile Equipment Error
+    else if(strstr(line, "+CME ERROR:") == line) //Mobile Equipment Error
     {
-      std::sscanf(m_inputBuf + 12 /* =strlen("+CME ERROR: ") */, "%d", &m_transactionResult.code);
+      std::sscanf(line + 12 /* =strlen("+CME ERROR: ") */, "%d", &m_transactionResult.code);
       DBG("+CME ERROR: %d result received", m_transactionResult.code);
       m_transactionResult.result = ATResult::AT_CME_ERROR;
       m_transactionState = IDLE;
@@ -704,9 +692,9 @@ int ATCommandsInterface::processReadLine()
       m_AT2Env.put(msg); //Command has been processed
       return OK;
     }
-    else if(strstr(m_inputBuf, "+CMS ERROR:") == m_inputBuf) //SIM Error
+    else if(strstr(line, "+CMS ERROR:") == line) //SIM Error
     {
-      std::sscanf(m_inputBuf + 13 /* =strlen("+CME ERROR: ") */, "%d", &m_transactionResult.code);
+      std::sscanf(line + 13 /* =strlen("+CME ERROR: ") */, "%d", &m_transactionResult.code);
       DBG("+CMS ERROR: %d result received", m_transactionResult.code);
       m_transactionResult.result = ATResult::AT_CMS_ERROR;
       m_transactionState = IDLE;
@@ -717,9 +705,9 @@ int ATCommandsInterface::processReadLine()
     }
     else
     {
-      DBG("Unprocessed result received: '%s'", m_inputBuf);
+      DBG("Unprocessed result received: '%s'", line);
       //Must call transaction processor to complete line processing
-      int ret = m_pTransactionProcessor->onNewATResponseLine(this, m_inputBuf); //Here sendData can be called
+      int ret = m_pTransactionProcessor->onNewATResponseLine(this, line); //Here sendData can be called
       return ret;
     }
   }
@@ -815,7 +803,8 @@ int ATCommandsInterface::sendData(const char* data)
     if(ret)
     {
       WARN("Could not read from stream (returned %d)", ret);
-      m_inputPos = 0; //Reset input buffer state
+      m_inputStart = 0;
+  m_inputPos = 0; //Reset input buffer state
       m_inputBuf[0] = '\0'; //Always have a null-terminating char at start of buffer
       return ret;
     }
@@ -825,7 +814,8 @@ int ATCommandsInterface::sendData(const char* data)
       //Echo does not match output
       m_inputBuf[readLen] = '\0';
       WARN("Echo does not match output, got '%s' instead", m_inputBuf);
-      m_inputPos = 0; //Reset input buffer state
+      m_inputStart = 0;
+  m_inputPos = 0; //Reset input buffer state
       m_inputBuf[0] = '\0'; //Always have a null-terminating char at start of buffer
       return NET_DIFF;
     }
@@ -837,12 +827,39 @@ int ATCommandsInterface::sendData(const char* data)
 
   DBG("String sent successfully");
 
+  m_inputStart = 0;
   m_inputPos = 0; //Reset input buffer state
   m_inputBuf[0] = '\0'; //Always have a null-terminating char at start of buffer
 
   return OK;
 }
 
+//Commands that can be called during onNewATResponseLine callback, additionally to close()
+//Access to this method is protected (can ONLY be called on processing thread during IATCommandsProcessor::onNewATResponseLine execution)
+int ATCommandsInterface::readData(uint8_t* buf, size_t length, uint32_t timeout/*=1000*/)
+{
+  //Data received along with the line comes first
+  size_t dataPos = MIN((size_t)(m_inputPos - m_inputStart), length);
+  memcpy(buf, m_inputBuf + m_inputStart, dataPos);
+  m_inputStart += dataPos;
+  DBG("Reading raw data of length %d, %d already buffered", length, dataPos);
+
+  //The rest is read from the stream directly
+  while(dataPos < length)
+  {
+    size_t readLen;
+    int ret = m_pStream->read(buf + dataPos, &readLen, length - dataPos, timeout);
+    if(ret)
+    {
+      WARN("Could not read from stream (returned %d)", ret);
+      return ret;
+    }
+    dataPos += readLen;
+  }
+
+  return OK;
+}
+
 /*static*/ void ATCommandsInterface::staticCallback(void const* p)
 {
   ((ATCommandsInterface*)p)->process();
@@ -887,6 +904,7 @@ void ATCommandsInterface::process() //Processing thread
     {
       ret = m_pStream->read((uint8_t*)m_inputBuf, &readLen, AT_INPUT_BUF_SIZE - 1, 0); //Do NOT wait at this point
     } while(ret == OK);
+    m_inputStart = 0;
     m_inputPos = 0; //Clear input buffer
     do
     {
@@ -101,13 +101,17 @@ public:
   //Access to this method is protected (can ONLY be called on processing thread during IATCommandsProcessor::onNewATResponseLine execution)
   int sendData(const char* data);
 
+  //Read raw data following the current response line (e.g. a binary payload whose length the line announced) straight into buf
+  //Same restrictions as sendData
+  int readData(uint8_t* buf, size_t length, uint32_t timeout=1000);
+
   static void staticCallback(void const* p);
 private:
   int executeInternal(const char* command, IATCommandsProcessor* pProcessor, ATResult* pResult, uint32_t timeout=1000);
   
   int tryReadLine();
   int trySendCommand();
-  int processReadLine();
+  int processReadLine(char* line);
   int processEntryPrompt();
   
   void enableEvents();
@@ -133,6 +137,7 @@ private:
   enum { IDLE, COMMAND_SENT, READING_RESULT, ABORTED } m_transactionState;
 
   char m_inputBuf[AT_INPUT_BUF_SIZE]; // Stores characters received from the modem.
+  int m_inputStart; // Position of the first unprocessed character in the input buffer.
   int m_inputPos; // Current position of fill pointer in the input buffer.
 
   Mutex m_transactionMtx;
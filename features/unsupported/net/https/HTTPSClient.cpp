@@ -15,6 +15,11 @@ char buf[256];
 
 HTTPSClient::HTTPSClient() :
         _is_connected(false),
+        _keep_alive(false),
+        _pending(0),
+        _in_body(false),
+        _chunked(false),
+        _body_remaining(0),
         _ssl_ctx(),
         _ssl(),
         _host() {
@@ -52,7 +57,14 @@ int HTTPSClient::connect(const char* host) {
         return -1;
     }
     
+    // Application data starts at the beginning of the buffers
+    _ssl.bm_read_index = 0;
+    _ssl.bm_index = 0;
+
     _is_connected = true;
+    _keep_alive = true;
+    _pending = 0;
+    _in_body = false;
     _host = host;
     return 0;
 }
@@ -70,24 +82,77 @@ int HTTPSClient::send(char* data, int length) {
 
 
 
-HTTPHeader HTTPSClient::get(char *request)
+HTTPHeader HTTPSClient::get(char *path)
 {
-    if((_sock_fd < 0) || !_is_connected)
+    if(request(path) < 0)
         return HTTPHeader();
-        
-    sprintf(buf, "GET %s HTTP/1.1\r\nHost: %s\r\n\r\n", request, _host.c_str());
+    return response();
+}
+
+int HTTPSClient::request(const char *path)
+{
+    // The server closed the connection after its last response
+    if(_is_connected && !_keep_alive && !_pending && !_in_body)
+    {
+        string host = _host;
+        close();
+        if(connect(host.c_str()) < 0)
+            return -1;
+    }
+    if((_sock_fd < 0) || !_is_connected || !_keep_alive)
+        return -1;
+
+    int len = snprintf(buf, sizeof(buf), "GET %s HTTP/1.1\r\nHost: %s\r\n\r\n", path, _host.c_str());
+    if((len < 0) || (len >= (int)sizeof(buf)))
+        return -1;
     printf("buf=%s\n", buf);
-    if(send(buf, strlen(buf)) != strlen(buf))
-        return HTTPHeader();
+    if(send(buf, len) != len)
+        return -1;
     printf("Finished sending request\n");
-    return read_header();
+    _pending++;
+    return 0;
+}
+
+HTTPHeader HTTPSClient::response()
+{
+    // Skip the rest of the previous body, the next response follows it
+    while(_in_body)
+    {
+        if(read(buf, sizeof(buf)) < 0)
+            return HTTPHeader();
+    }
+    if((_sock_fd < 0) || !_is_connected || !_pending)
+        return HTTPHeader();
+
+    _pending--;
+    HTTPHeader hdr = read_header();
+    if(hdr._status != HTTP_OK)
+    {
+        _keep_alive = false;
+        return hdr;
+    }
+
+    if(hdr.getField("Connection") == "close")
+        _keep_alive = false;
+
+    _chunked = (hdr.getField("Transfer-Encoding") == "chunked");
+    if(_chunked)
+        _body_remaining = 0;
+    else if(!hdr.getField("Content-Length").empty())
+        _body_remaining = hdr.getBodyLength();
+    else
+    {
+        // The body ends when the server closes the connection
+        _body_remaining = -1;
+        _keep_alive = false;
+    }
+    _in_body = _chunked || (_body_remaining != 0);
+    return hdr;
 }
 
 
 HTTPHeader HTTPSClient::read_header()
 {
-    _ssl.bm_read_index = 0;
-    _ssl.bm_index = 0;
     HTTPHeader hdr;
     if(read_line())
         return hdr;
@@ -132,11 +197,83 @@ uint8_t HTTPSClient::read_line()
     return 0;
 }
 
+// Read the size line of the next chunk, and the trailer after the last one
+int HTTPSClient::next_chunk()
+{
+    if(read_line())
+        return -1;
+    _body_remaining = strtol(buf, NULL, 16);
+    if(_body_remaining > 0)
+        return 0;
+
+    do
+    {
+        if(read_line())
+            return -1;
+    }while(strlen(buf));
+    _in_body = false;
+    return 0;
+}
+
 // -1:error
+// 0:end of the body
 // otherwise return nb of characters read. Cannot be > than len
 int HTTPSClient::read(char *data, int len)
 {
-    return ssl_read(&_ssl, (uint8_t*)data, len);
+    if(!_in_body)
+        return 0;
+
+    if(_chunked && (_body_remaining == 0))
+    {
+        if(next_chunk() < 0)
+        {
+            _in_body = false;
+            _keep_alive = false;
+            return -1;
+        }
+        if(!_in_body)
+            return 0;
+    }
+
+    if((_body_remaining >= 0) && (len > _body_remaining))
+        len = _body_remaining;
+    int ret = ssl_read(&_ssl, (uint8_t*)data, len);
+    if(ret <= 0)
+    {
+        _in_body = false;
+        _keep_alive = false;
+        return (_body_remaining < 0) ? 0 : -1;
+    }
+
+    if(_body_remaining > 0)
+    {
+        _body_remaining -= ret;
+        if(_body_remaining == 0)
+        {
+            // A chunk is followed by CRLF
+            if(_chunked && read_line())
+            {
+                _in_body = false;
+                _keep_alive = false;
+                return -1;
+            }
+            _in_body = _chunked;
+        }
+    }
+    return ret;
+}
+
+int HTTPSClient::stream(mbed::Callback<void(const char*, int)> sink)
+{
+    char data[128];
+    int total = 0;
+    int ret;
+    while((ret = read(data, sizeof(data))) > 0)
+    {
+        sink(data, ret);
+        total += ret;
+    }
+    return (ret < 0) ? -1 : total;
 }
 /*
     0    : must close connection
@@ -159,5 +296,8 @@ void HTTPSClient::close()
     ssl_ctx_free(_ssl.ssl_ctx);
     Socket::close();
     _is_connected = false;
+    _keep_alive = false;
+    _pending = 0;
+    _in_body = false;
     _host.clear();
 }
@@ -5,6 +5,7 @@
 #include "Socket/Endpoint.h"
 #include "axTLS/ssl/ssl.h"
 #include "HTTPHeader.h"
+#include "platform/Callback.h"
 
 /**
 TCP socket connection
@@ -33,9 +34,29 @@ public:
     
     // Returns the size of the body
     HTTPHeader get(char *path);
-    
+
+    /** Send a GET request without waiting for the response
+    Requests can be pipelined: each response() returns the header of the oldest request not answered yet.
+    The connection is kept open between requests unless the server closes it, in which case it is reopened.
+    \param path The path requested.
+    \return 0 on success, -1 on failure.
+    */
+    int request(const char *path);
+
+    /** Read the header of the response to the oldest pending request
+    What is left unread of the previous body is skipped.
+    */
+    HTTPHeader response();
+
+    // -1:error, 0:end of the body
+    // otherwise return nb of characters of the body read, with chunked transfer encoding removed. Cannot be > than len
     int read(char *data, int len);
 
+    /** Pass the rest of the body to a callback, piece by piece, so it never has to fit in memory
+    \return The number of characters of the body passed, -1 on failure.
+    */
+    int stream(mbed::Callback<void(const char*, int)> sink);
+
 
     void close();
     
@@ -46,8 +67,14 @@ private:
     
     uint8_t read_line();
     HTTPHeader read_header();
+    int next_chunk();
 
     bool _is_connected;
+    bool _keep_alive;       // The server will take another request on the connection
+    int _pending;           // Requests sent without their response read yet
+    bool _in_body;          // The body of the last response isn't read entirely
+    bool _chunked;
+    int _body_remaining;    // Characters left in the body or the current chunk, -1 for a body ending with the connection
     SSL_CTX _ssl_ctx;
     SSL _ssl;
     std::string _host;
@@ -752,6 +752,55 @@ pppAppend(u_char c, struct pbuf *nb, ext_accm *outACCM)
 
   return tb;
 }
+
+/*
+ * pppAppendData - append n characters to end of given pbuf, escaping them
+ * and updating the FCS like as many pppAppend() calls, with one room check
+ * per pbuf instead of one per character.
+ * Return the current pbuf.
+ */
+static struct pbuf *
+pppAppendData(const u_char *s, int n, u_int *fcsOut, struct pbuf *nb, ext_accm *outACCM)
+{
+  u_int fcs = *fcsOut;
+
+  while (nb && n > 0) {
+    u_char *d;
+    u16_t len;
+
+    /* Same room for an escape code as pppAppend(). */
+    if ((PBUF_POOL_BUFSIZE - nb->len) < 2) {
+      struct pbuf *tb = pbuf_alloc(PBUF_RAW, 0, PBUF_POOL);
+      if (tb) {
+        nb->next = tb;
+      } else {
+        LINK_STATS_INC(link.memerr);
+      }
+      nb = tb;
+      continue;
+    }
+
+    d = (u_char*)nb->payload;
+    len = nb->len;
+    while (n > 0 && len <= PBUF_POOL_BUFSIZE - 2) {
+      u_char c = *s++;
+      n--;
+
+      /* Update FCS before checking for special characters. */
+      fcs = PPP_FCS(fcs, c);
+      if (ESCAPE_P(*outACCM, c)) {
+        d[len++] = PPP_ESCAPE;
+        d[len++] = c ^ PPP_TRANS;
+      } else {
+        d[len++] = c;
+      }
+    }
+    nb->len = len;
+  }
+
+  *fcsOut = fcs;
+  return nb;
+}
 #endif /* PPPOS_SUPPORT */
 
 #if PPPOE_SUPPORT
@@ -904,20 +953,8 @@ pppifOutput(struct netif *netif, struct pbuf *pb, ip_addr_t *ipaddr)
 
   /* Load packet. */
   for(p = pb; p; p = p->next) {
-    int n;
-    u_char *sPtr;
-
-    sPtr = (u_char*)p->payload;
-    n = p->len;
-    while (n-- > 0) {
-      c = *sPtr++;
-
-      /* Update FCS before checking for special characters. */
-      fcsOut = PPP_FCS(fcsOut, c);
-      
-      /* Copy to output buffer escaping special characters. */
-      tailMB = pppAppend(c, tailMB, &pc->outACCM);
-    }
+    /* Copy to output buffer escaping special characters. */
+    tailMB = pppAppendData((u_char*)p->payload, p->len, &fcsOut, tailMB, &pc->outACCM);
   }
 
   /* Add FCS and trailing flag. */
@@ -1098,15 +1135,8 @@ pppWrite(int pd, const u_char *s, int n)
 
   fcsOut = PPP_INITFCS;
   /* Load output buffer. */
-  while (n-- > 0) {
-    c = *s++;
-
-    /* Update FCS before checking for special characters. */
-    fcsOut = PPP_FCS(fcsOut, c);
-
-    /* Copy to output buffer escaping special characters. */
-    tailMB = pppAppend(c, tailMB, &pc->outACCM);
-  }
+  /* Copy to output buffer escaping special characters. */
+  tailMB = pppAppendData(s, n, &fcsOut, tailMB, &pc->outACCM);
     
   /* Add FCS and trailing flag. */
   c = ~fcsOut & 0xFF;
@@ -1768,15 +1798,40 @@ pppInProc(PPPControlRx *pcrx, u_char *s, int l)
   struct pbuf *nextNBuf;
   u_char curChar;
   u_char escaped;
+  ext_accm inACCM;
   SYS_ARCH_DECL_PROTECT(lev);
 
   PPPDEBUG(LOG_DEBUG, ("pppInProc[%d]: got %d bytes\n", pcrx->pd, l));
-  while (l-- > 0) {
+
+  /* The map is set from the PPP thread; take it once for the whole string. */
+  SYS_ARCH_PROTECT(lev);
+  SMEMCPY(inACCM, pcrx->inACCM, sizeof(ext_accm));
+  SYS_ARCH_UNPROTECT(lev);
+
+  while (l > 0) {
+    /* Copy runs of plain data bytes into the current pbuf in one go. */
+    if (pcrx->inState == PDDATA && !pcrx->inEscaped && pcrx->inTail != NULL) {
+      u_char *d = (u_char*)pcrx->inTail->payload;
+      u16_t len = pcrx->inTail->len;
+      u16_t fcs = pcrx->inFCS;
+
+      while (l > 0 && len < PBUF_POOL_BUFSIZE && !ESCAPE_P(inACCM, *s)) {
+        curChar = *s++;
+        l--;
+        d[len++] = curChar;
+        fcs = PPP_FCS(fcs, curChar);
+      }
+      pcrx->inTail->len = len;
+      pcrx->inFCS = fcs;
+      if (l == 0) {
+        break;
+      }
+    }
+
     curChar = *s++;
+    l--;
 
-    SYS_ARCH_PROTECT(lev);
-    escaped = ESCAPE_P(pcrx->inACCM, curChar);
-    SYS_ARCH_UNPROTECT(lev);
+    escaped = ESCAPE_P(inACCM, curChar);
     /* Handle special characters. */
     if (escaped) {
       /* Check for escape sequences. */
@@ -25,6 +25,7 @@ Arguments::Arguments(const char* rqs) {
     obj_name = NULL;
     method_name = NULL;
     argc = 0;
+    binary = false;
 
     // This copy can be removed if we can assume the request string is
     // persistent and writable for the duration of the call
@@ -54,6 +55,33 @@ Arguments::Arguments(const char* rqs) {
     index = -1;
 }
 
+Arguments::Arguments(const char* args, int length) {
+    obj_name = NULL;
+    method_name = NULL;
+    argc = 0;
+    binary = true;
+    index = -1;
+
+    if (length > RPC_MAX_STRING - 1) length = RPC_MAX_STRING - 1;
+    memcpy(request, args, length);
+    // Terminates the last string argument
+    request[length] = '\0';
+    this->length = length;
+    offset = 0;
+}
+
+// Takes the next binary argument, zero if the request is too short
+bool Arguments::take(void *value, int size) {
+    if (offset + size > length) {
+        memset(value, 0, size);
+        offset = length;
+        return false;
+    }
+    memcpy(value, request + offset, size);
+    offset += size;
+    return true;
+}
+
 char* Arguments::search_arg(char **arg, char *p, char next_sep) {
     char *s = p;
     while (true) {
@@ -68,43 +96,86 @@ char* Arguments::search_arg(char **arg, char *p, char next_sep) {
     return (separator == next_sep) ? (p) : (NULL);
 }
 
+// Binary values are little endian, as are the targets
 template<> PinName Arguments::getArg<PinName>(void) {
     index++;
+    if (binary) {
+        int32_t pin;
+        take(&pin, sizeof(pin));
+        return (PinName)pin;
+    }
     return parse_pins(argv[index]);
 }
 
 template<> int Arguments::getArg<int>(void) {
     index++;
+    if (binary) {
+        int32_t v;
+        take(&v, sizeof(v));
+        return v;
+    }
     char *pEnd;
     return strtol(argv[index], &pEnd, 10);
 }
 
 template<> const char* Arguments::getArg<const char*>(void) {
     index++;
+    if (binary) {
+        const char *s = request + offset;
+        offset += strlen(s);
+        if (offset < length) offset++;
+        return s;
+    }
     return argv[index];
 }
 
 template<> char Arguments::getArg<char>(void) {
     index++;
+    if (binary) {
+        char c;
+        take(&c, sizeof(c));
+        return c;
+    }
     return *argv[index];
 }
 
 template<> double Arguments::getArg<double>(void) {
     index++;
+    if (binary) {
+        double d;
+        take(&d, sizeof(d));
+        return d;
+    }
     return atof(argv[index]);
 }
 
 template<> float Arguments::getArg<float>(void) {
     index++;
+    if (binary) {
+        float f;
+        take(&f, sizeof(f));
+        return f;
+    }
     return atof(argv[index]);
 }
 
-Reply::Reply(char* r) {
+Reply::Reply(char* r, bool binary) {
     first = true;
+    this->binary = binary;
     *r = '\0';
+    start = r;
     reply = r;
 }
 
+int Reply::length(void) const {
+    return reply - start;
+}
+
+void Reply::put(const void *value, int size) {
+    memcpy(reply, value, size);
+    reply += size;
+}
+
 void Reply::separator(void) {
     if (first) {
         first = false;
@@ -114,26 +185,42 @@ void Reply::separator(void) {
 }
 
 template<> void Reply::putData<const char*>(const char* s) {
+    if (binary) {
+        put(s, strlen(s) + 1);
+        return;
+    }
     separator();
     reply += sprintf(reply, "%s", s);
 }
 
 template<> void Reply::putData<char*>(char* s) {
-    separator();
-    reply += sprintf(reply, "%s", s);
+    putData<const char*>(s);
 }
 
 template<> void Reply::putData<char>(char c) {
+    if (binary) {
+        put(&c, sizeof(c));
+        return;
+    }
     separator();
     reply += sprintf(reply, "%c", c);
 }
 
 template<> void Reply::putData<int>(int v) {
+    if (binary) {
+        int32_t i = v;
+        put(&i, sizeof(i));
+        return;
+    }
     separator();
     reply += sprintf(reply, "%d", v);
 }
 
 template<> void Reply::putData<float>(float f) {
+    if (binary) {
+        put(&f, sizeof(f));
+        return;
+    }
     separator();
     reply += sprintf(reply, "%.17g", f);
 }
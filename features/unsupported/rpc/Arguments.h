@@ -28,6 +28,10 @@ class Arguments {
 public:
     Arguments(const char* rqs);
 
+    // Arguments in binary, as described by RPC::call_binary(), of at most
+    // RPC_MAX_STRING - 1 bytes
+    Arguments(const char* args, int length);
+
     template<typename Arg>
     Arg   getArg(void);
 
@@ -43,18 +47,29 @@ private:
     char  request[RPC_MAX_STRING];
     int index;
     char* search_arg(char **arg, char *p, char next_sep);
+
+    bool binary;
+    int length;
+    int offset;
+    bool take(void *value, int size);
 };
 
 class Reply {
 public:
-    Reply(char* r);
+    Reply(char* r, bool binary = false);
 
     template<typename Data>
     void putData(Data d);
 
+    // The length of the reply, without the terminating null byte of text
+    int length(void) const;
+
 private:
     void separator(void);
+    void put(const void *value, int size);
     bool first;
+    bool binary;
+    char* start;
     char* reply;
 };
 
@@ -19,6 +19,12 @@ using namespace std;
 
 namespace mbed {
 
+struct RPC::handle {
+    RPC *obj;
+    rpc_method::method_caller_t method_caller;
+    void (*function_caller)(Arguments*, Reply*);
+};
+
 RPC::RPC(const char *name) {
     _from_construct = false;
     if (name != NULL) {
@@ -31,6 +37,11 @@ RPC::RPC(const char *name) {
     // put this object at head of the list
     _next = _head;
     _head = this;
+
+    // and of the list of its bucket
+    _hash = hash(_name);
+    _bucket_next = _buckets[_hash % RPC_HASH_BUCKETS];
+    _buckets[_hash % RPC_HASH_BUCKETS] = this;
 }
 
 RPC::~RPC() {
@@ -44,6 +55,20 @@ RPC::~RPC() {
         }
         p->_next = _next;
     }
+
+    RPC **b = &_buckets[_hash % RPC_HASH_BUCKETS];
+    while (*b != this) {
+        b = &(*b)->_bucket_next;
+    }
+    *b = _bucket_next;
+
+    // the methods resolved can't be called anymore
+    for (int i = 0; i < RPC_MAX_HANDLES; i++) {
+        if (_handles[i].obj == this) {
+            _handles[i].obj = NULL;
+            _handles[i].method_caller = NULL;
+        }
+    }
 }
 
 const rpc_method *RPC::get_rpc_methods() {
@@ -54,17 +79,76 @@ const rpc_method *RPC::get_rpc_methods() {
     return methods;
 }
 
+/* FNV-1a */
+uint32_t RPC::hash(const char *name) {
+    uint32_t h = 2166136261UL;
+    for (; *name != '\0'; name++) {
+        h = (h ^ (uint8_t)*name) * 16777619UL;
+    }
+    return h;
+}
+
 RPC *RPC::lookup(const char *name) {
-    size_t len = strlen(name);
-    for (RPC *p = _head; p != NULL; p = p->_next) {
-        /* Check that p->_name matches name and is the correct length */
-        if (strncmp(p->_name, name, len) == 0 && (strlen(p->_name) == len)) {
+    uint32_t h = hash(name);
+    for (RPC *p = _buckets[h % RPC_HASH_BUCKETS]; p != NULL; p = p->_bucket_next) {
+        if ((p->_hash == h) && (strcmp(p->_name, name) == 0)) {
             return p;
         }
     }
     return NULL;
 }
 
+int RPC::resolve(const char *obj_name, const char *method_name) {
+    if ((obj_name == NULL) || (method_name == NULL)) return -1;
+
+    handle h = { NULL, NULL, NULL };
+
+    RPC *p = lookup(obj_name);
+    if (p != NULL) {
+        /* Look through the methods and those of the superclasses */
+        const rpc_method *cur_method = p->get_rpc_methods();
+        while (true) {
+            while ((cur_method->name != NULL) && (strcmp(cur_method->name, method_name) != 0)) {
+                cur_method++;
+            }
+            if (cur_method->name != NULL) break;
+            if (cur_method->super == 0) return -1;
+            cur_method = cur_method->super(p);
+        }
+        h.obj = p;
+        h.method_caller = cur_method->method_caller;
+    } else {
+        const rpc_class *q = _classes;
+        while ((q != NULL) && (strcmp(q->name, obj_name) != 0)) {
+            q = q->next;
+        }
+        if (q == NULL) return -1;
+
+        const rpc_function *cur_func = q->static_functions;
+        while ((cur_func->name != NULL) && (strcmp(cur_func->name, method_name) != 0)) {
+            cur_func++;
+        }
+        if (cur_func->name == NULL) return -1;
+        h.function_caller = cur_func->function_caller;
+    }
+
+    /* Give the same handle for the same method, or take a free one */
+    int free_handle = -1;
+    for (int i = 0; i < RPC_MAX_HANDLES; i++) {
+        if ((_handles[i].obj == h.obj) && (_handles[i].method_caller == h.method_caller) &&
+            (_handles[i].function_caller == h.function_caller)) {
+            return i;
+        }
+        if ((free_handle < 0) && (_handles[i].method_caller == NULL) && (_handles[i].function_caller == NULL)) {
+            free_handle = i;
+        }
+    }
+    if (free_handle >= 0) {
+        _handles[free_handle] = h;
+    }
+    return free_handle;
+}
+
 void RPC::delete_self() {
     delete[] _name;
     if (_from_construct) {
@@ -92,9 +176,20 @@ void RPC::clear(Arguments*, Reply*) {
     }
 }
 
+void RPC::resolve_handle(Arguments *args, Reply *result) {
+    int h = -1;
+    if (args->argc == 2) {
+        const char *obj_name = args->getArg<const char*>();
+        const char *method_name = args->getArg<const char*>();
+        h = resolve(obj_name, method_name);
+    }
+    result->putData<int>(h);
+}
+
 const rpc_function RPC::_RPC_funcs[] = {
     {"clear", &RPC::clear },
     { "objects", &RPC::list_objs },
+    { "resolve", &RPC::resolve_handle },
     RPC_METHOD_END
 };
 
@@ -102,6 +197,10 @@ rpc_class RPC::_RPC_class = { "RPC", _RPC_funcs, NULL };
 
 RPC *RPC::_head = NULL;
 
+RPC *RPC::_buckets[RPC_HASH_BUCKETS] = { NULL };
+
+RPC::handle RPC::_handles[RPC_MAX_HANDLES] = { { NULL, NULL, NULL } };
+
 rpc_class *RPC::_classes = &_RPC_class;
 
 bool RPC::call(const char *request, char *reply) {
@@ -188,4 +287,24 @@ bool RPC::call(const char *request, char *reply) {
     return false;
 }
 
+int RPC::call_binary(const char *request, int length, char *reply) {
+    if ((request == NULL) || (length < 2) || (length - 2 >= RPC_MAX_STRING)) return -1;
+
+    unsigned id = (uint8_t)request[0] | ((uint8_t)request[1] << 8);
+    if (id >= RPC_MAX_HANDLES) return -1;
+
+    /* Copied, as the call may delete the object and its handles */
+    handle h = _handles[id];
+    if ((h.method_caller == NULL) && (h.function_caller == NULL)) return -1;
+
+    Arguments args(request + 2, length - 2);
+    Reply r(reply, true);
+    if (h.obj != NULL) {
+        (h.method_caller)(h.obj, &args, &r);
+    } else {
+        (h.function_caller)(&args, &r);
+    }
+    return r.length();
+}
+
 } // namespace mbed
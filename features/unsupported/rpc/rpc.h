@@ -23,6 +23,18 @@ namespace mbed {
 
 #define RPC_MAX_STRING      128
 
+/* Macro RPC_HASH_BUCKETS
+ *  The number of lists the objects are spread in by the hash of their
+ *  name, to look them up.
+ */
+#define RPC_HASH_BUCKETS    16
+
+/* Macro RPC_MAX_HANDLES
+ *  The number of methods and functions which can be resolved at the same
+ *  time for RPC::call_binary().
+ */
+#define RPC_MAX_HANDLES     32
+
 struct rpc_function {
     const char *name;
     void (*function_caller)(Arguments*, Reply*);
@@ -66,6 +78,37 @@ public:
 
     static bool call(const char *buf, char *result);
 
+    /* Function resolve
+     *  Resolve a method of an object, or a function of a class, to the
+     *  handle calling it with call_binary(). Tools can get it over RPC
+     *  with "/RPC/resolve <object> <method>". The handle is valid until
+     *  the object is deleted.
+     *
+     * Variables
+     *  obj_name - the name of the object or class.
+     *  method_name - the name of the method or function.
+     *  returns - the handle, or -1 if there is no such method or no free
+     *            handle.
+     */
+    static int resolve(const char *obj_name, const char *method_name);
+
+    /* Function call_binary
+     *  Call a resolved method, skipping the lookup and the parsing of
+     *  call(). The request is the handle, 2 bytes little endian, then the
+     *  arguments in binary: int and PinName as 4 bytes little endian,
+     *  float as 4 bytes and double as 8 bytes in IEEE 754, char as a byte
+     *  and strings terminated by a null byte. The reply holds the values
+     *  returned in the same encoding.
+     *
+     * Variables
+     *  request - the request.
+     *  length - the length of the request, at most RPC_MAX_STRING + 1.
+     *  reply - the buffer for the reply.
+     *  returns - the length of the reply, or -1 if the handle is not valid
+     *            or the request is too long.
+     */
+    static int call_binary(const char *request, int length, char *reply);
+
     /* Function lookup
      *  Lookup and return the object that has the given name.
      *
@@ -81,6 +124,13 @@ protected:
     bool _from_construct;
 
 private:
+    static RPC *_buckets[RPC_HASH_BUCKETS];
+    RPC *_bucket_next;
+    uint32_t _hash;
+
+    struct handle;
+    static handle _handles[RPC_MAX_HANDLES];
+
     static rpc_class *_classes;
 
     static const rpc_function _RPC_funcs[];
@@ -89,6 +139,8 @@ private:
     void delete_self();
     static void list_objs(Arguments *args, Reply *result);
     static void clear(Arguments *args, Reply *result);
+    static void resolve_handle(Arguments *args, Reply *result);
+    static uint32_t hash(const char *name);
 
 public:
     /* Function add_rpc_class
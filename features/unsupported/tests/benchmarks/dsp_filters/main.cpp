@@ -0,0 +1,104 @@
+#define MBED_PROFILE_ENABLED 1
+
+#include "mbed.h"
+#include "dsp.h"
+#include "platform/mbed_profile.h"
+
+/* Cycles per sample of the dsp filter classes, on blocks of BLOCK_SIZE
+ * samples. Meant for Cortex-M4 and M7, where the CMSIS code uses the SIMD
+ * and FPU instructions: the cycles come from the DWT cycle counter. */
+#define BLOCK_SIZE      (64)
+#define NUM_BLOCKS      (32)
+
+#define NUM_TAPS        (32)
+#define NUM_STAGES      (4)
+#define FACTOR          (4)
+
+static float32_t coeff_f32[NUM_TAPS];
+static q15_t     coeff_q15[NUM_TAPS];
+static q31_t     coeff_q31[NUM_TAPS];
+
+/* Stable low pass sections, {b0, b1, b2, a1, a2} and {b0, 0, b1, b2, a1, a2} for q15 */
+static float32_t biquad_f32[5 * NUM_STAGES];
+static q15_t     biquad_q15[6 * NUM_STAGES];
+static q31_t     biquad_q31[5 * NUM_STAGES];
+
+static float32_t in_f32[BLOCK_SIZE], out_f32[BLOCK_SIZE * FACTOR];
+static q15_t     in_q15[BLOCK_SIZE], out_q15[BLOCK_SIZE * FACTOR];
+static q31_t     in_q31[BLOCK_SIZE], out_q31[BLOCK_SIZE * FACTOR];
+
+static void init(void) {
+    for (int i = 0; i < NUM_TAPS; i++) {
+        coeff_f32[i] = 1.0f / NUM_TAPS;
+    }
+    arm_float_to_q15(coeff_f32, coeff_q15, NUM_TAPS);
+    arm_float_to_q31(coeff_f32, coeff_q31, NUM_TAPS);
+
+    const float32_t section[5] = { 0.0625f, 0.125f, 0.0625f, 0.5f, -0.25f };
+    for (int i = 0; i < NUM_STAGES; i++) {
+        memcpy(&biquad_f32[5 * i], section, sizeof(section));
+        arm_float_to_q31((float32_t *)section, &biquad_q31[5 * i], 5);
+        q15_t q15[5];
+        arm_float_to_q15((float32_t *)section, q15, 5);
+        biquad_q15[6 * i + 0] = q15[0];
+        biquad_q15[6 * i + 1] = 0;
+        biquad_q15[6 * i + 2] = q15[1];
+        biquad_q15[6 * i + 3] = q15[2];
+        biquad_q15[6 * i + 4] = q15[3];
+        biquad_q15[6 * i + 5] = q15[4];
+    }
+
+    Sine_f32 sine(1000, 48000, 0.5f, 0.0f, BLOCK_SIZE);
+    sine.generate(in_f32);
+    arm_float_to_q15(in_f32, in_q15, BLOCK_SIZE);
+    arm_float_to_q31(in_f32, in_q31, BLOCK_SIZE);
+}
+
+template<typename Filter, typename T>
+static void benchmark(const char *name, Filter &filter, T *in, T *out) {
+    uint32_t cycles = 0;
+    for (int i = 0; i < NUM_BLOCKS; i++) {
+        uint32_t start = mbed_profile_start();
+        filter.process(in, out);
+        cycles += mbed_profile_elapsed(start);
+    }
+    uint32_t samples = BLOCK_SIZE * NUM_BLOCKS;
+    printf("%-20s %4lu.%02lu cycles/sample\r\n", name,
+           (unsigned long)(cycles / samples), (unsigned long)((cycles % samples) * 100 / samples));
+}
+
+int main() {
+    init();
+
+    printf("dsp filters, %d samples per block, %lu Hz core\r\n", BLOCK_SIZE, (unsigned long)SystemCoreClock);
+
+    FIR_f32<NUM_TAPS, BLOCK_SIZE> fir_f32(coeff_f32);
+    FIR_q15<NUM_TAPS, BLOCK_SIZE> fir_q15(coeff_q15);
+    FIR_q31<NUM_TAPS, BLOCK_SIZE> fir_q31(coeff_q31);
+    benchmark("FIR_f32", fir_f32, in_f32, out_f32);
+    benchmark("FIR_q15", fir_q15, in_q15, out_q15);
+    benchmark("FIR_q31", fir_q31, in_q31, out_q31);
+
+    Biquad_f32<NUM_STAGES, BLOCK_SIZE> biquad_f32_filter(biquad_f32);
+    Biquad_q15<NUM_STAGES, BLOCK_SIZE> biquad_q15_filter(biquad_q15);
+    Biquad_q31<NUM_STAGES, BLOCK_SIZE> biquad_q31_filter(biquad_q31);
+    benchmark("Biquad_f32", biquad_f32_filter, in_f32, out_f32);
+    benchmark("Biquad_q15", biquad_q15_filter, in_q15, out_q15);
+    benchmark("Biquad_q31", biquad_q31_filter, in_q31, out_q31);
+
+    FIRDecimator_f32<NUM_TAPS, FACTOR, BLOCK_SIZE> decimator_f32(coeff_f32);
+    FIRDecimator_q15<NUM_TAPS, FACTOR, BLOCK_SIZE> decimator_q15(coeff_q15);
+    FIRDecimator_q31<NUM_TAPS, FACTOR, BLOCK_SIZE> decimator_q31(coeff_q31);
+    benchmark("FIRDecimator_f32", decimator_f32, in_f32, out_f32);
+    benchmark("FIRDecimator_q15", decimator_q15, in_q15, out_q15);
+    benchmark("FIRDecimator_q31", decimator_q31, in_q31, out_q31);
+
+    FIRInterpolator_f32<NUM_TAPS, FACTOR, BLOCK_SIZE> interpolator_f32(coeff_f32);
+    FIRInterpolator_q15<NUM_TAPS, FACTOR, BLOCK_SIZE> interpolator_q15(coeff_q15);
+    FIRInterpolator_q31<NUM_TAPS, FACTOR, BLOCK_SIZE> interpolator_q31(coeff_q31);
+    benchmark("FIRInterpolator_f32", interpolator_f32, in_f32, out_f32);
+    benchmark("FIRInterpolator_q15", interpolator_q15, in_q15, out_q15);
+    benchmark("FIRInterpolator_q31", interpolator_q31, in_q31, out_q31);
+
+    printf("Success\r\n");
+}
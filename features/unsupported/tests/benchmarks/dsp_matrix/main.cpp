@@ -0,0 +1,110 @@
+#define MBED_PROFILE_ENABLED 1
+
+#include "mbed.h"
+#include "dsp.h"
+#include "platform/mbed_profile.h"
+
+/* Cycles per operation of the fixed-size matrix templates, against the same
+ * operations through arm_matrix_instance_f32 and arm_mat_ functions. Meant
+ * for Cortex-M4F and M7, the cycles come from the DWT cycle counter. */
+#define NUM_RUNS        (64)
+
+template<uint16_t size>
+static void fill(Matrix_f32<size, size> &m, float32_t offset) {
+    for (uint16_t i = 0; i < size; i++) {
+        for (uint16_t j = 0; j < size; j++) {
+            m(i, j) = (i == j) ? 4.0f : offset / (1 + i + j);
+        }
+    }
+}
+
+static void report(const char *name, uint32_t cycles) {
+    printf("%-24s %6lu cycles\r\n", name, (unsigned long)(cycles / NUM_RUNS));
+}
+
+template<uint16_t size>
+static void benchmark_mult(const char *name, const char *cmsis_name) {
+    static Matrix_f32<size, size> a, b, c;
+    fill(a, 1.0f);
+    fill(b, 0.5f);
+
+    uint32_t cycles = 0;
+    for (int i = 0; i < NUM_RUNS; i++) {
+        uint32_t start = mbed_profile_start();
+        c = a * b;
+        cycles += mbed_profile_elapsed(start);
+    }
+    report(name, cycles);
+
+    cycles = 0;
+    for (int i = 0; i < NUM_RUNS; i++) {
+        uint32_t start = mbed_profile_start();
+        arm_matrix_instance_f32 ma, mb, mc;
+        arm_mat_init_f32(&ma, size, size, a.data());
+        arm_mat_init_f32(&mb, size, size, b.data());
+        arm_mat_init_f32(&mc, size, size, c.data());
+        arm_mat_mult_f32(&ma, &mb, &mc);
+        cycles += mbed_profile_elapsed(start);
+    }
+    report(cmsis_name, cycles);
+}
+
+static void benchmark_inverse(void) {
+    static Matrix_f32<3, 3> a, b, copy;
+    fill(a, 1.0f);
+
+    uint32_t cycles = 0;
+    for (int i = 0; i < NUM_RUNS; i++) {
+        uint32_t start = mbed_profile_start();
+        a.inverse(&b);
+        cycles += mbed_profile_elapsed(start);
+    }
+    report("Matrix_f32<3,3> inverse", cycles);
+
+    cycles = 0;
+    for (int i = 0; i < NUM_RUNS; i++) {
+        copy = a;
+        uint32_t start = mbed_profile_start();
+        arm_matrix_instance_f32 ma, mb;
+        arm_mat_init_f32(&ma, 3, 3, copy.data());
+        arm_mat_init_f32(&mb, 3, 3, b.data());
+        arm_mat_inverse_f32(&ma, &mb);
+        cycles += mbed_profile_elapsed(start);
+    }
+    report("arm_mat_inverse_f32 3x3", cycles);
+}
+
+static void benchmark_quaternion(void) {
+    const float32_t rate_values[3] = { 0.1f, -0.2f, 0.3f };
+    Vector_f32<3> rate(rate_values);
+    Quaternion_f32 q;
+
+    uint32_t cycles = 0;
+    for (int i = 0; i < NUM_RUNS; i++) {
+        uint32_t start = mbed_profile_start();
+        q.integrate(rate, 0.01f);
+        cycles += mbed_profile_elapsed(start);
+    }
+    report("Quaternion_f32 integrate", cycles);
+
+    static Vector_f32<3> v;
+    cycles = 0;
+    for (int i = 0; i < NUM_RUNS; i++) {
+        uint32_t start = mbed_profile_start();
+        v = q.rotate(rate);
+        cycles += mbed_profile_elapsed(start);
+    }
+    report("Quaternion_f32 rotate", cycles);
+}
+
+int main() {
+    printf("dsp matrices, %lu Hz core\r\n", (unsigned long)SystemCoreClock);
+
+    benchmark_mult<3>("Matrix_f32<3,3> *", "arm_mat_mult_f32 3x3");
+    benchmark_mult<4>("Matrix_f32<4,4> *", "arm_mat_mult_f32 4x4");
+    benchmark_mult<8>("Matrix_f32<8,8> *", "arm_mat_mult_f32 8x8");
+    benchmark_inverse();
+    benchmark_quaternion();
+
+    printf("Success\r\n");
+}
@@ -0,0 +1,106 @@
+#include "mbed.h"
+#include "dsp.h"
+
+#define TOLERANCE   (1e-4f)
+
+static bool close(float32_t a, float32_t b) {
+    return fabsf(a - b) <= TOLERANCE * (1.0f + fabsf(b));
+}
+
+template<uint16_t rows, uint16_t cols>
+static bool equal(const Matrix_f32<rows, cols> &a, const Matrix_f32<rows, cols> &b) {
+    for (uint16_t i = 0; i < rows; i++) {
+        for (uint16_t j = 0; j < cols; j++) {
+            if (!close(a(i, j), b(i, j))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* Products and inverses, the unrolled ones against CMSIS-DSP */
+template<uint16_t size>
+static bool check_square(void) {
+    Matrix_f32<size, size> a, b;
+    for (uint16_t i = 0; i < size; i++) {
+        for (uint16_t j = 0; j < size; j++) {
+            a(i, j) = (i == j) ? 4.0f : 1.0f / (1 + i + 2 * j);
+            b(i, j) = 0.5f * i - 0.25f * j;
+        }
+    }
+
+    Matrix_f32<size, size> expected;
+    arm_matrix_instance_f32 ma = a.instance();
+    arm_matrix_instance_f32 mb = b.instance();
+    arm_matrix_instance_f32 mc = expected.instance();
+    arm_mat_mult_f32(&ma, &mb, &mc);
+    if (!equal(a * b, expected)) {
+        printf("%ux%u product\n\r", size, size);
+        return false;
+    }
+
+    Matrix_f32<size, size> inverse;
+    if (!a.inverse(&inverse) || !equal(a * inverse, Matrix_f32<size, size>::identity())) {
+        printf("%ux%u inverse\n\r", size, size);
+        return false;
+    }
+
+    return true;
+}
+
+int main() {
+    bool success = check_square<2>() && check_square<3>() && check_square<4>() &&
+                   check_square<6>();
+
+    /* Rectangular product and transpose */
+    const float32_t a_values[6] = { 1, 2, 3, 4, 5, 6 };
+    const float32_t p_values[4] = { 14, 32, 32, 77 };
+    Matrix_f32<2, 3> a(a_values);
+    if (!equal(a * a.transposed(), Matrix_f32<2, 2>(p_values)) ||
+        a.transposed()(2, 1) != 6.0f) {
+        printf("rectangular product\n\r");
+        success = false;
+    }
+
+    Matrix_f32<3, 3> singular = Matrix_f32<3, 3>::zeros();
+    if (singular.inverse(&singular)) {
+        printf("singular inverse\n\r");
+        success = false;
+    }
+
+    /* Vectors */
+    const float32_t x_values[3] = { 1, 0, 0 };
+    const float32_t y_values[3] = { 0, 1, 0 };
+    Vector_f32<3> vx(x_values), vy(y_values);
+    Vector_f32<3> vz = cross(vx, vy);
+    Vector_f32<3> sum = vx + vy;
+    if (!close(vz[2], 1.0f) || !close(vx.dot(vy), 0.0f) || !close(sum.norm(), sqrtf(2.0f))) {
+        printf("vectors\n\r");
+        success = false;
+    }
+
+    /* A quarter turn around z takes x to y, as a rotation, a matrix and
+     * as 100 steps of a 90 deg/s rate over 1 s */
+    Quaternion_f32 q = Quaternion_f32::from_axis_angle(vz, PI / 2);
+    Quaternion_f32 integrated;
+    const float32_t rate_values[3] = { 0, 0, PI / 2 };
+    for (int i = 0; i < 100; i++) {
+        integrated.integrate(Vector_f32<3>(rate_values), 0.01f);
+    }
+    Vector_f32<3> by_q = q.rotate(vx);
+    Vector_f32<3> by_matrix = q.rotation_matrix() * vx;
+    Vector_f32<3> by_integration = integrated.rotate(vx);
+    Vector_f32<3> back = (q.conjugate() * q).rotate(vx);
+    if (!equal(by_q, vy) || !equal(by_matrix, vy) || !equal(back, vx) ||
+        fabsf(by_integration[1] - 1.0f) > 1e-3f || fabsf(by_integration[0]) > 1e-3f) {
+        printf("quaternions\n\r");
+        success = false;
+    }
+
+    if (!success) {
+        printf("Failed\n\r");
+    } else {
+        printf("Success\n\r");
+    }
+}
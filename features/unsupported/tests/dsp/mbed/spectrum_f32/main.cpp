@@ -0,0 +1,60 @@
+#include "mbed.h"
+#include "dsp.h"
+
+#define BLOCK_SIZE              (100)
+#define NUM_BLOCKS              (40)
+
+#define SAMPLE_RATE             (10000)
+#define FFT_SIZE                (1024)
+#define SINE_FREQUENCY          (1234)
+#define SINE_AMPLITUDE          (0.25f)
+
+/* Interleaved like the samples of a two channel AnalogInStream */
+uint16_t samples[2 * BLOCK_SIZE];
+
+int main() {
+    Sine_f32 sine(SINE_FREQUENCY, SAMPLE_RATE, SINE_AMPLITUDE, 0.0f, BLOCK_SIZE);
+    Spectrum_f32<FFT_SIZE> spectrum(SAMPLE_RATE);
+
+    float32_t block[BLOCK_SIZE];
+    int spectra = 0;
+    bool success = true;
+    for (int b = 0; b < NUM_BLOCKS; b++) {
+        sine.generate(block);
+        for (int i = 0; i < BLOCK_SIZE; i++) {
+            samples[2 * i] = (uint16_t)(32768.0f + block[i] * 32768.0f);
+            samples[2 * i + 1] = 0;
+        }
+
+        const uint16_t *half = samples;
+        uint32_t count = BLOCK_SIZE;
+        while (count) {
+            uint32_t n = spectrum.process(half, count, 2);
+            half += 2 * n;
+            count -= n;
+            if (spectrum.ready()) {
+                float32_t hz, amplitude;
+                spectrum.peak(&hz, &amplitude);
+                printf("peak: %f Hz, %f\n\r", hz, amplitude);
+                /* Within a bin, and the Hann window loses at most 1.5dB between bins */
+                if ((fabsf(hz - SINE_FREQUENCY) > (float32_t)SAMPLE_RATE / FFT_SIZE) ||
+                    (amplitude < SINE_AMPLITUDE * 0.84f) || (amplitude > SINE_AMPLITUDE * 1.01f)) {
+                    success = false;
+                }
+                spectra++;
+            }
+        }
+    }
+
+    /* A first frame, then one every half frame */
+    if (spectra != 1 + (NUM_BLOCKS * BLOCK_SIZE - FFT_SIZE) / (FFT_SIZE / 2)) {
+        success = false;
+    }
+
+    printf("spectra: %d\n\r", spectra);
+    if (!success) {
+        printf("Failed\n\r");
+    } else {
+        printf("Success\n\r");
+    }
+}
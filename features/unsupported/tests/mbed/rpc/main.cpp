@@ -22,8 +22,30 @@ bool rpc_test(const char *input, const char *expected) {
     return result;
 }
 
+bool rpc_binary_test(int handle, const void *args, int args_length, const void *expected, int expected_length) {
+    char request[RPC_MAX_STRING + 1];
+    char outbuf[RPC_MAX_STRING] = {0};
+    request[0] = handle & 0xFF;
+    request[1] = handle >> 8;
+    memcpy(request + 2, args, args_length);
+    int length = RPC::call_binary(request, args_length + 2, outbuf);
+    printf("RPC: binary call %d -> ", handle);
+
+    if (length != expected_length) {
+        printf("%d bytes != %d bytes ... [FAIL]\r\n", length, expected_length);
+        return false;
+    } else if ((length > 0) && (memcmp(outbuf, expected, length) != 0)) {
+        printf("wrong reply ... [FAIL]\r\n");
+        return false;
+    }
+    printf("%d bytes ... [OK]\r\n", length);
+    return true;
+}
+
 #define RPC_TEST(INPUT,EXPECTED) result = result && rpc_test(INPUT,EXPECTED); if (result == false) { notify_completion(result); exit(1); }
 
+#define RPC_BINARY_TEST(HANDLE,ARGS,ARGS_LENGTH,EXPECTED,EXPECTED_LENGTH) result = result && rpc_binary_test(HANDLE,ARGS,ARGS_LENGTH,EXPECTED,EXPECTED_LENGTH); if (result == false) { notify_completion(result); exit(1); }
+
 int main() {
     float f = 0;
     bool result = true;
@@ -51,6 +73,20 @@ int main() {
     RPC_TEST("/led1/write 1", "");
     RPC_TEST("/led1/read", "1");
 
+    // Binary calls, resolved once
+    int one = 1;
+    float f_foo = 1.0f * 3.3;
+    char handle[8];
+    int h_write = RPC::resolve("led1", "write");
+    int h_read = RPC::resolve("led2", "read");
+    int h_foo = RPC::resolve("foo", "run");
+    result = (h_write >= 0) && (h_read >= 0) && (h_foo >= 0) && (RPC::resolve("led1", "nothing") == -1);
+    sprintf(handle, "%d", h_write);
+    RPC_TEST("/RPC/resolve led1 write", handle);
+    RPC_BINARY_TEST(h_write, &one, sizeof(one), NULL, 0);
+    RPC_BINARY_TEST(h_read, NULL, 0, &one, sizeof(one));
+    RPC_BINARY_TEST(h_foo, "\x00\x00\x80\x3f", 4, &f_foo, sizeof(f_foo));
+
     // Introspection
     RPC_TEST("/", "led1 led2 foo f DigitalOut RPC");
     RPC_TEST("/f", "read write delete");
@@ -61,6 +97,7 @@ int main() {
     // Delete instance
     RPC_TEST("/led2/delete", "");
     RPC_TEST("/", "led1 foo f DigitalOut RPC");
+    RPC_BINARY_TEST(h_read, NULL, 0, NULL, -1);
 
     notify_completion(result);
     return 0;
@@ -0,0 +1,219 @@
+#include "mbed.h"
+#include "SDFileSystem.h"
+#include "test_env.h"
+#include <algorithm>
+#include <stdlib.h>
+#include <limits.h>
+
+#if defined(TARGET_KL25Z)
+SDFileSystem sd(PTD2, PTD3, PTD1, PTD0, "sd");
+
+#elif defined(TARGET_KL46Z)
+SDFileSystem sd(PTD6, PTD7, PTD5, PTD4, "sd");
+
+#elif defined(TARGET_K64F) || defined(TARGET_K66F)
+SDFileSystem sd(PTE3, PTE1, PTE2, PTE4, "sd");
+
+#elif defined(TARGET_K22F)
+SDFileSystem sd(PTD6, PTD7, PTD5, PTD4, "sd");
+
+#elif defined(TARGET_K20D50M)
+SDFileSystem sd(PTD2, PTD3, PTD1, PTC2, "sd");
+
+#elif defined(TARGET_nRF51822)
+SDFileSystem sd(p12, p13, p15, p14, "sd");
+
+#elif defined(TARGET_NUCLEO_F030R8) || \
+      defined(TARGET_NUCLEO_F070RB) || \
+      defined(TARGET_NUCLEO_F072RB) || \
+      defined(TARGET_NUCLEO_F091RC) || \
+      defined(TARGET_NUCLEO_F103RB) || \
+      defined(TARGET_NUCLEO_F302R8) || \
+      defined(TARGET_NUCLEO_F303RE) || \
+      defined(TARGET_NUCLEO_F334R8) || \
+      defined(TARGET_NUCLEO_F401RE) || \
+      defined(TARGET_NUCLEO_F410RB) || \
+      defined(TARGET_NUCLEO_F411RE) || \
+      defined(TARGET_NUCLEO_L053R8) || \
+      defined(TARGET_NUCLEO_L073RZ) || \
+      defined(TARGET_NUCLEO_L152RE)
+SDFileSystem sd(D11, D12, D13, D10, "sd");
+
+#elif defined(TARGET_DISCO_F051R8)
+SDFileSystem sd(SPI_MOSI, SPI_MISO, SPI_SCK, SPI_CS, "sd");
+
+#elif defined(TARGET_LPC2368)
+SDFileSystem sd(p11, p12, p13, p14, "sd");
+
+#elif defined(TARGET_LPC11U68)
+SDFileSystem sd(D11, D12, D13, D10, "sd");
+
+#elif defined(TARGET_LPC1549)
+SDFileSystem sd(D11, D12, D13, D10, "sd");
+
+#elif defined(TARGET_LPC11U37H_401)
+SDFileSystem sd(SDMOSI, SDMISO, SDSCLK, SDSSEL, "sd");
+
+#else
+SDFileSystem sd(p11, p12, p13, p14, "sd");
+#endif
+
+namespace {
+const int FILE_SIZE = 128 * 1024;
+const int RANDOM_ROUNDS = 64;
+const int BLOCK_SIZE = 512;
+char buffer[8 * 1024];
+Timer timer;
+const char *bin_filename = "blocks.bin";
+}
+
+struct latency {
+    int min;
+    int max;
+    int sum;
+    int count;
+};
+
+void latency_reset(latency *l) {
+    l->min = INT_MAX;
+    l->max = 0;
+    l->sum = 0;
+    l->count = 0;
+}
+
+void latency_add(latency *l, int us) {
+    l->min = std::min(l->min, us);
+    l->max = std::max(l->max, us);
+    l->sum += us;
+    l->count++;
+}
+
+void latency_print(const char *name, int size, const latency *l) {
+    double speed = (double)size * l->count / 1024 / (l->sum / 1000000.0);
+    printf("MBED: benchmark %-13s %5d B min %7d avg %7d max %7d us %9.2f KiB/s\r\n",
+           name, size, l->min, l->sum / l->count, l->max, speed);
+}
+
+// Buffers of size bytes written one after the other, creating the file
+bool test_write(int size) {
+    FileHandle* file = sd.open(bin_filename, O_WRONLY | O_CREAT | O_TRUNC);
+    if (file == NULL) {
+        printf("File '%s' not opened\r\n", bin_filename);
+        return false;
+    }
+    latency l;
+    latency_reset(&l);
+    timer.reset();
+    timer.start();
+    for (int i = 0; i < FILE_SIZE / size; i++) {
+        int start = timer.read_us();
+        if (file->write(buffer, size) != size) {
+            printf("Write error!\r\n");
+            file->close();
+            return false;
+        }
+        latency_add(&l, timer.read_us() - start);
+    }
+    int start = timer.read_us();
+    file->close();
+    int close_us = timer.read_us() - start;
+    timer.stop();
+    latency_print("write", size, &l);
+    printf("MBED: benchmark close after write %d us\r\n", close_us);
+    return true;
+}
+
+// Buffers of size bytes read one after the other, or at random offsets
+bool test_read(int size, bool random) {
+    FileHandle* file = sd.open(bin_filename, O_RDONLY);
+    if (file == NULL) {
+        printf("File '%s' not opened\r\n", bin_filename);
+        return false;
+    }
+    int rounds = FILE_SIZE / size;
+    if (random) {
+        rounds = std::min(rounds, RANDOM_ROUNDS);
+    }
+    latency l;
+    latency_reset(&l);
+    timer.reset();
+    timer.start();
+    for (int i = 0; i < rounds; i++) {
+        int start = timer.read_us();
+        if (random && file->lseek((rand() % (FILE_SIZE / size)) * size, SEEK_SET) < 0) {
+            printf("Seek error!\r\n");
+            file->close();
+            return false;
+        }
+        if (file->read(buffer, size) != size) {
+            printf("Read error!\r\n");
+            file->close();
+            return false;
+        }
+        latency_add(&l, timer.read_us() - start);
+    }
+    timer.stop();
+    file->close();
+    latency_print(random ? "random read" : "read", size, &l);
+    return true;
+}
+
+// Random blocks read straight from the card, count at a time, below the
+// filesystem. Blocks are not written to keep the filesystem of the card.
+bool test_disk_read(int count) {
+    uint32_t sectors = sd.disk_sectors();
+    if (sectors < (uint32_t)count) {
+        printf("Card not initialized\r\n");
+        return false;
+    }
+    latency l;
+    latency_reset(&l);
+    timer.reset();
+    timer.start();
+    for (int i = 0; i < RANDOM_ROUNDS; i++) {
+        uint32_t block = rand() % (sectors - count + 1);
+        int start = timer.read_us();
+        if (sd.disk_read((uint8_t *)buffer, block, count) != 0) {
+            printf("Disk read error!\r\n");
+            return false;
+        }
+        latency_add(&l, timer.read_us() - start);
+    }
+    timer.stop();
+    latency_print("disk read", count * BLOCK_SIZE, &l);
+    return true;
+}
+
+char RandomChar() {
+    return rand() % 100;
+}
+
+int main() {
+    MBED_HOSTTEST_TIMEOUT(60);
+    MBED_HOSTTEST_SELECT(default_auto);
+    MBED_HOSTTEST_DESCRIPTION(SD Block Size Speed);
+    MBED_HOSTTEST_START("PERF_4");
+
+    // Test header
+    printf("\r\n");
+    printf("SD Card Block Size Performance Test\r\n");
+    printf("File name: %s\r\n", bin_filename);
+    printf("File size: %d KiB\r\n", FILE_SIZE / 1024);
+
+    // Initialize buffer
+    srand(testenv_randseed());
+    char *buffer_end = buffer + sizeof(buffer);
+    std::generate (buffer, buffer_end, RandomChar);
+
+    const int sizes[] = {64, 512, 4096, 8192};
+    bool result = true;
+    for (unsigned i = 0; result && i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        result = test_write(sizes[i]) && test_read(sizes[i], false) && test_read(sizes[i], true);
+    }
+    const int counts[] = {1, 2, 8, 16};
+    for (unsigned i = 0; result && i < sizeof(counts) / sizeof(counts[0]); i++) {
+        result = test_disk_read(counts[i]);
+    }
+    sd.remove(bin_filename);
+    MBED_HOSTTEST_RESULT(result);
+}
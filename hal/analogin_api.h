@@ -60,6 +60,64 @@ uint16_t analogin_read_u16(analogin_t *obj);
 
 /**@}*/
 
+#if DEVICE_ANALOGIN_ASYNCH
+
+#define ANALOGIN_EVENT_HALF_COMPLETE (1 << 0)
+#define ANALOGIN_EVENT_COMPLETE      (1 << 1)
+#define ANALOGIN_EVENT_ERROR         (1 << 2)
+#define ANALOGIN_EVENT_ALL           (ANALOGIN_EVENT_HALF_COMPLETE | ANALOGIN_EVENT_COMPLETE | ANALOGIN_EVENT_ERROR)
+
+/**
+ * \defgroup hal_analogin_asynch Analogin streaming hal functions
+ *
+ * A timer triggers the conversion of all the channels, and DMA writes the
+ * samples into a circular buffer, channel after channel. The handler is
+ * called when each half of the buffer is full, so one half can be
+ * processed while the other one fills. The samples are 16-bit, at the
+ * scale of analogin_read_u16.
+ *
+ * analogin_read must not be used on the ADC of a running stream.
+ * @{
+ */
+
+/** Start sampling channels into a circular buffer
+ *
+ * @param channels The analogin objects to sample, all on the same ADC
+ * @param count    The number of channels
+ * @param buffer   The buffer of samples
+ * @param length   The number of samples in the buffer, a multiple of 2 * count
+ * @param hz       The sampling rate of each channel
+ * @param handler  The interrupt handler address
+ * @param event    The logical OR of the events that call the handler
+ * @return 0 if the stream started, -1 if the ADC cannot stream these
+ *         channels at this rate
+ */
+int analogin_stream_start(analogin_t *const *channels, int count, uint16_t *buffer, size_t length, uint32_t hz, uint32_t handler, uint32_t event);
+
+/** The stream interrupt handler, to be called from the handler given to analogin_stream_start
+ *
+ * @param obj The first channel of the stream
+ * @return The events that occurred, ANALOGIN_EVENT_ERROR stops the stream
+ */
+int analogin_stream_irq_handler(analogin_t *obj);
+
+/** Stop a stream
+ *
+ * @param obj The first channel of the stream
+ */
+void analogin_stream_stop(analogin_t *obj);
+
+/** Check if a stream is running
+ *
+ * @param obj The first channel of the stream
+ * @return Non-zero if the stream is running
+ */
+uint8_t analogin_stream_active(analogin_t *obj);
+
+/**@}*/
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -82,6 +82,60 @@ uint16_t analogout_read_u16(dac_t *obj);
 
 /**@}*/
 
+#if DEVICE_ANALOGOUT_ASYNCH
+
+/**
+ * \defgroup AsynchAnalogOut Asynchronous analogout hal functions
+ * @{
+ */
+
+#define ANALOGOUT_EVENT_HALF_COMPLETE (1 << 0) /**< The first half of the buffer was output */
+#define ANALOGOUT_EVENT_COMPLETE      (1 << 1) /**< The whole buffer was output */
+#define ANALOGOUT_EVENT_ERROR         (1 << 2) /**< The DAC missed a sample, the playback stopped */
+#define ANALOGOUT_EVENT_ALL           (ANALOGOUT_EVENT_HALF_COMPLETE | ANALOGOUT_EVENT_COMPLETE | ANALOGOUT_EVENT_ERROR)
+
+/** Start outputting a buffer of samples at a fixed rate
+ *
+ * A hardware timer triggers the conversions and DMA feeds them from the
+ * buffer, which stays in use until the playback stops. Samples are at the
+ * scale of analogout_write_u16. Once the buffer is output, a one-shot
+ * playback stops on the last sample and a circular one starts over.
+ * @param obj      The analogout object
+ * @param buffer   The samples to output
+ * @param length   The number of samples in the buffer
+ * @param hz       The output rate in samples per second
+ * @param circular Nonzero to restart from the beginning of the buffer at its end
+ * @param handler  The interrupt handler, calling analogout_stream_irq_handler
+ * @param event    The logical OR of the events to report
+ * @return 0 if the playback started, -1 if one is already running or the
+ *         target cannot output at this rate
+ */
+int analogout_stream_start(dac_t *obj, const uint16_t *buffer, size_t length, uint32_t hz, uint8_t circular, uint32_t handler, uint32_t event);
+
+/** Handle the playback interrupt
+ *
+ * @param obj The analogout object
+ * @return The events that occurred, limited to the ones requested
+ */
+int analogout_stream_irq_handler(dac_t *obj);
+
+/** Stop the playback, the output keeps its last value
+ *
+ * @param obj The analogout object
+ */
+void analogout_stream_stop(dac_t *obj);
+
+/** Check if a playback is running
+ *
+ * @param obj The analogout object
+ * @return Nonzero until the playback stops
+ */
+uint8_t analogout_stream_active(dac_t *obj);
+
+/**@}*/
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +53,12 @@ typedef enum {
     MODE_TEST_SILENT
 } CanMode;
 
+typedef enum {
+    CAN_FILTER_OFF,             /**< The bank accepts nothing */
+    CAN_FILTER_MASK,            /**< Accept the ids matching id on the bits of mask */
+    CAN_FILTER_LIST             /**< Accept the two ids id and mask */
+} CanFilterMode;
+
 typedef void (*can_irq_handler)(uint32_t id, CanIrqType type);
 
 typedef struct can_s can_t;
@@ -74,6 +80,27 @@ unsigned char can_rderror  (can_t *obj);
 unsigned char can_tderror  (can_t *obj);
 void          can_monitor  (can_t *obj, int silent);
 
+/** Number of hardware filter banks of the CAN peripheral
+ *
+ * A message is received when a bank in use accepts it. The weak default
+ * for targets without filter banks returns 0.
+ */
+int           can_filter_banks(can_t *obj);
+
+/** Set a hardware filter bank, so the peripheral drops the messages no bank accepts
+ *
+ * @param obj    The CAN object
+ * @param bank   Bank from 0 to can_filter_banks() - 1
+ * @param mode   CAN_FILTER_MASK matches id on the bits set in mask,
+ *               CAN_FILTER_LIST accepts exactly id and mask,
+ *               CAN_FILTER_OFF turns the bank off
+ * @param id     First identifier
+ * @param mask   Mask or second identifier
+ * @param format Format of the identifiers, CANAny matches both in mask mode
+ * @return 1 if the bank was set, 0 if the bank or the mode is not supported
+ */
+int           can_filter_bank(can_t *obj, int bank, CanFilterMode mode, uint32_t id, uint32_t mask, CANFormat format);
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,64 @@
+/** \addtogroup hal */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CLOCK_API_H
+#define MBED_CLOCK_API_H
+
+#include "device.h"
+
+/** Clock profiles a target runs its core and buses at
+ */
+typedef enum {
+    CLOCK_PROFILE_LOW = 0,  /**< Lowest clock keeping the peripherals usable, to save power */
+    CLOCK_PROFILE_HIGH = 1, /**< Highest clock, the one the target boots with */
+} clock_profile_t;
+
+#if DEVICE_CLOCK_SCALING
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \defgroup hal_clock Clock scaling hal functions
+ * @{
+ */
+
+/** Switch the core and bus clocks to a profile
+ *
+ * Called in a critical section, the target chooses the frequencies of
+ * each profile. It updates SystemCoreClock and the flash wait states, and
+ * keeps the us ticker and lp ticker counting at their nominal rate, which
+ * may mean recomputing the ticker prescaler. Other peripherals are
+ * reconfigured by their drivers once the switch is done.
+ *
+ * @param profile The profile to switch to
+ * @return 0 on success, -1 if the switch failed and the clocks are unchanged
+ */
+int clock_set_profile(clock_profile_t profile);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
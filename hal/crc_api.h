@@ -0,0 +1,63 @@
+/** \addtogroup hal */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CRC_API_H
+#define MBED_CRC_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "device.h"
+
+#if DEVICE_CRC
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \defgroup hal_crc CRC unit hal functions
+ *
+ * The unit computes CRC-32 as in IEEE 802.3 (polynomial 0x04C11DB7, data and
+ * remainder reflected). It keeps no state between calls: the running
+ * remainder is passed in and returned, so computations of several callers can
+ * be interleaved on one unit.
+ *
+ * A call holds the unit for its duration and may be made from interrupts.
+ * @{
+ */
+
+/** Continue a CRC-32 over whole words
+ *
+ * @param remainder Running remainder, reflected and without the final xor;
+ *                  0xFFFFFFFF for a new computation
+ * @param data      Word aligned data, processed in memory order
+ * @param words     Number of words
+ * @return The remainder following the data
+ */
+uint32_t crc32_hw_update(uint32_t remainder, const uint32_t *data, size_t words);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
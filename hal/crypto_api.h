@@ -0,0 +1,103 @@
+/** \addtogroup hal */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CRYPTO_API_H
+#define MBED_CRYPTO_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "device.h"
+
+#if DEVICE_CRYPTO_AES || DEVICE_CRYPTO_SHA1 || DEVICE_CRYPTO_SHA256
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \defgroup hal_crypto Crypto accelerator hal functions
+ *
+ * The engine keeps no state between calls. Every call loads the key or the
+ * running hash state it is given, and the hash functions write the state
+ * back, so the state of an operation lives in the caller's context and
+ * operations of several threads can be interleaved on one engine.
+ *
+ * The caller makes sure that the functions are not called concurrently,
+ * and not from interrupts. All buffers are word aligned.
+ * @{
+ */
+
+/** Size in words of the key storage given to crypto_aes_setkey */
+#define CRYPTO_AES_KEY_WORDS    64
+
+#if DEVICE_CRYPTO_AES
+
+/** Prepare an AES key for the engine
+ *
+ * @param rk      Key storage of CRYPTO_AES_KEY_WORDS words, passed to
+ *                crypto_aes_crypt
+ * @param key     Key
+ * @param keybits Key length in bits, 128, 192 or 256
+ * @param decrypt 0 to prepare the key for encryption, 1 for decryption
+ * @return 0 success, -1 if the engine does not support the key length
+ */
+int crypto_aes_setkey(uint32_t *rk, const uint8_t *key, unsigned keybits, int decrypt);
+
+/** Encrypt or decrypt one block
+ *
+ * @param rk      Key prepared by crypto_aes_setkey
+ * @param keybits Key length in bits
+ * @param decrypt 0 to encrypt, 1 to decrypt, as the key was prepared
+ * @param block   Block of 16 bytes, replaced by the result
+ */
+void crypto_aes_crypt(const uint32_t *rk, unsigned keybits, int decrypt, uint32_t block[4]);
+
+#endif
+
+#if DEVICE_CRYPTO_SHA1
+
+/** Process one SHA-1 block
+ *
+ * @param state   Hash state h0 to h4, updated with the block
+ * @param block   Block of 64 bytes in message order
+ */
+void crypto_sha1_process(uint32_t state[5], const uint32_t block[16]);
+
+#endif
+
+#if DEVICE_CRYPTO_SHA256
+
+/** Process one SHA-256 block
+ *
+ * @param state   Hash state h0 to h7, updated with the block
+ * @param block   Block of 64 bytes in message order
+ */
+void crypto_sha256_process(uint32_t state[8], const uint32_t block[16]);
+
+#endif
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
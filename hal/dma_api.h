@@ -19,10 +19,20 @@
 #ifndef MBED_DMA_API_H
 #define MBED_DMA_API_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #define DMA_ERROR_OUT_OF_CHANNELS (-1)
 
+/** Capability of channels that can copy memory to memory
+ *
+ * Bits below 16 are left to the target capabilities.
+ */
+#define DMA_CAP_MEM_TO_MEM          (1 << 16)
+
+#define DMA_MEMCPY_EVENT_COMPLETE   (1 << 0)
+#define DMA_MEMCPY_EVENT_ERROR      (1 << 1)
+
 typedef enum {
     DMA_USAGE_NEVER,
     DMA_USAGE_OPPORTUNISTIC,
@@ -35,12 +45,81 @@ typedef enum {
 extern "C" {
 #endif
 
+/** Called from interrupt context when a memory copy ends
+ *
+ * @param id    The id given to dma_memcpy_start
+ * @param event DMA_MEMCPY_EVENT_COMPLETE or DMA_MEMCPY_EVENT_ERROR
+ */
+typedef void (*dma_memcpy_handler)(uint32_t id, int event);
+
+/**
+ * \defgroup hal_dma DMA hal functions
+ * @{
+ */
+
+/** Initialize the DMA controllers, called by dma_channel_allocate
+ */
 void dma_init(void);
 
+/** Allocate a free channel
+ *
+ * @param capabilities The logical OR of the capabilities the channel needs
+ * @return The channel, or DMA_ERROR_OUT_OF_CHANNELS if none is free
+ */
 int dma_channel_allocate(uint32_t capabilities);
 
+/** Release a channel
+ *
+ * @param channelid The channel from dma_channel_allocate
+ * @return 0
+ */
 int dma_channel_free(int channelid);
 
+/** Start copying memory to memory
+ *
+ * The source and destination must not overlap, and must be memory the DMA
+ * can reach. Targets without memory copies keep the default, which always
+ * fails.
+ *
+ * @param channelid A channel allocated with DMA_CAP_MEM_TO_MEM
+ * @param dst       The destination buffer
+ * @param src       The source buffer
+ * @param size      The number of bytes to copy
+ * @param handler   Called when the copy ends, or NULL
+ * @param id        Passed to the handler
+ * @return 0 if the copy started, -1 if the channel or buffers cannot be used
+ */
+int dma_memcpy_start(int channelid, void *dst, const void *src, size_t size, dma_memcpy_handler handler, uint32_t id);
+
+/** Check if a copy is running on a channel
+ *
+ * @param channelid The channel of the copy
+ * @return Non-zero until the copy ends
+ */
+int dma_memcpy_active(int channelid);
+
+/** Stop a copy, the handler is not called
+ *
+ * @param channelid The channel of the copy
+ */
+void dma_memcpy_abort(int channelid);
+
+/** Copy memory, by DMA when it is worth it
+ *
+ * Copies of at least hal.dma-memcpy-threshold bytes go through a free
+ * memory to memory channel while interrupts are enabled, the others and
+ * those no channel can take are done by the CPU. Returns once the copy is
+ * done, in either case.
+ *
+ * @param dst  The destination buffer
+ * @param src  The source buffer, not overlapping the destination
+ * @param size The number of bytes to copy
+ * @return dst
+ */
+void *dma_memcpy(void *dst, const void *src, size_t size);
+
+/**@}*/
+
 #ifdef __cplusplus
 }
 #endif
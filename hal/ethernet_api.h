@@ -56,6 +56,26 @@ int ethernet_link(void);
 // force link settings
 void ethernet_set_link(int speed, int duplex);
 
+// Zero-copy frame access, handing out the driver DMA buffers. At most one
+// transmit and one receive buffer are held at a time, and they must not be
+// mixed with ethernet_write/send or ethernet_receive/read. The weak
+// defaults for targets without it copy through those functions once.
+
+// get the buffer of the next outgoing frame, setting size to its capacity
+// return NULL if no buffer is free
+void *ethernet_tx_acquire(int *size);
+
+// send size bytes of the buffer from ethernet_tx_acquire
+// return the frame size sent, or 0 if the send failed
+int ethernet_tx_send(void *buffer, int size);
+
+// get the next received frame in place, setting size to its length
+// return NULL if no frame is pending
+void *ethernet_rx_acquire(int *size);
+
+// give the buffer from ethernet_rx_acquire back to the driver
+void ethernet_rx_release(void *buffer);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,188 @@
+/** \addtogroup hal */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_FLASH_API_H
+#define MBED_FLASH_API_H
+
+#include <stdint.h>
+#include "device.h"
+
+#if DEVICE_FLASH
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Flash HAL structure. flash_s is declared in the target's HAL
+ */
+typedef struct flash_s flash_t;
+
+/** Returned by flash_get_sector_size for addresses outside the flash */
+#define MBED_FLASH_INVALID_SIZE     0xFFFFFFFF
+
+#if DEVICE_FLASH_ASYNCH
+#define FLASH_EVENT_COMPLETE    (1 << 0)    /**< The operation succeeded */
+#define FLASH_EVENT_ERROR       (1 << 1)    /**< The controller reported an error */
+#define FLASH_EVENT_ALL         (FLASH_EVENT_COMPLETE | FLASH_EVENT_ERROR)
+#endif
+
+/**
+ * \defgroup hal_flash Flash hal functions
+ *
+ * The internal flash, read like memory, erased in sectors and programmed
+ * in pages. Sectors may differ in size across the flash; the page size is
+ * the same everywhere.
+ *
+ * The blocking calls keep the CPU off the flash while they run, with the
+ * interrupts masked. On DEVICE_FLASH_ASYNCH targets, sectors of a bank
+ * the program doesn't run from can be erased and programmed in the
+ * background, the asynchronous calls return once the operation started.
+ * @{
+ */
+
+/** Initialize the flash controller
+ *
+ * @param obj The flash object
+ * @return 0 on success, -1 on error
+ */
+int32_t flash_init(flash_t *obj);
+
+/** Release the flash controller
+ *
+ * @param obj The flash object
+ * @return 0 on success, -1 on error
+ */
+int32_t flash_free(flash_t *obj);
+
+/** Erase a sector
+ *
+ * @param obj     The flash object
+ * @param address The start of the sector
+ * @return 0 on success, -1 on error
+ */
+int32_t flash_erase_sector(flash_t *obj, uint32_t address);
+
+/** Program pages
+ *
+ * The pages must be erased.
+ *
+ * @param obj     The flash object
+ * @param address The start of the first page
+ * @param data    The data, which may not be in the flash itself
+ * @param size    The size of the data, a multiple of the page size
+ * @return 0 on success, -1 on error
+ */
+int32_t flash_program_page(flash_t *obj, uint32_t address, const uint8_t *data, uint32_t size);
+
+/** Size of a sector
+ *
+ * @param obj     The flash object
+ * @param address An address in the sector
+ * @return The size of the sector in bytes, or MBED_FLASH_INVALID_SIZE
+ *         outside the flash
+ */
+uint32_t flash_get_sector_size(const flash_t *obj, uint32_t address);
+
+/** Size of a page, the unit programmed at once
+ *
+ * @param obj The flash object
+ * @return The size of a page in bytes
+ */
+uint32_t flash_get_page_size(const flash_t *obj);
+
+/** Address of the start of the flash
+ *
+ * @param obj The flash object
+ * @return The address of the first byte of the flash
+ */
+uint32_t flash_get_start_address(const flash_t *obj);
+
+/** Size of the flash
+ *
+ * @param obj The flash object
+ * @return The size of the flash in bytes
+ */
+uint32_t flash_get_size(const flash_t *obj);
+
+/**@}*/
+
+#if DEVICE_FLASH_ASYNCH
+
+/**
+ * \defgroup hal_flash_asynch Asynchronous flash hal functions
+ *
+ * Only one operation runs at a time. The bank being erased or programmed
+ * mustn't be read or executed from until the operation ends.
+ * @{
+ */
+
+/** Whether a sector can be erased or programmed in the background
+ *
+ * @param obj     The flash object
+ * @param address An address in the sector
+ * @return Non-zero if the sector is in a bank the program doesn't run from
+ */
+uint8_t flash_is_rww(const flash_t *obj, uint32_t address);
+
+/** Start erasing a sector
+ *
+ * @param obj     The flash object
+ * @param address The start of the sector, which flash_is_rww accepts
+ * @param handler The interrupt handler, which calls flash_irq_handler_asynch
+ * @return 0 if the operation started, -1 on error
+ */
+int32_t flash_erase_sector_asynch(flash_t *obj, uint32_t address, uint32_t handler);
+
+/** Start programming pages
+ *
+ * @param obj     The flash object
+ * @param address The start of the first page, in sectors flash_is_rww accepts
+ * @param data    The data, valid until the operation ends
+ * @param size    The size of the data, a multiple of the page size
+ * @param handler The interrupt handler, which calls flash_irq_handler_asynch
+ * @return 0 if the operation started, -1 on error
+ */
+int32_t flash_program_page_asynch(flash_t *obj, uint32_t address, const uint8_t *data, uint32_t size,
+                                  uint32_t handler);
+
+/** Advance the operation, from the interrupt handler
+ *
+ * @param obj The flash object
+ * @return The FLASH_EVENT_* that ended the operation, 0 while it goes on
+ */
+uint32_t flash_irq_handler_asynch(flash_t *obj);
+
+/** Whether an asynchronous operation is running
+ *
+ * @param obj The flash object
+ * @return Non-zero while an operation runs
+ */
+uint8_t flash_active(flash_t *obj);
+
+/**@}*/
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
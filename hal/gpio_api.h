@@ -78,6 +78,20 @@ void gpio_write(gpio_t *obj, int value);
  */
 int gpio_read(gpio_t *obj);
 
+/* Pin-bound access
+ *
+ * Targets which define GPIO_FAST in their gpio_object.h also provide, as
+ * static inline functions taking the pin in place of a gpio_t:
+ *
+ *     void gpio_fast_write(PinName pin, int value);
+ *     int  gpio_fast_read(PinName pin);
+ *     void gpio_fast_toggle(PinName pin);
+ *
+ * The pin must have been initialized with one of the gpio_init functions
+ * beforehand. Called with a pin constant at compile time, as FastDigitalOut
+ * and FastDigitalIn do, they reduce to the access of the port register.
+ */
+
 // the following functions are generic and implemented in the common gpio.c file
 // TODO: fix, will be moved to the common gpio header file
 
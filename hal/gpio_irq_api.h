@@ -84,6 +84,17 @@ void gpio_irq_enable(gpio_irq_t *obj);
  */
 void gpio_irq_disable(gpio_irq_t *obj);
 
+/** Filter out pulses shorter than a given width before they reach the IRQ
+ *
+ * The filter delays each edge by its width. On some targets the width is
+ * shared by all the filtered pins of a port. Targets without a glitch
+ * filter keep the default, which applies none.
+ * @param obj The GPIO object
+ * @param us  The width of the shortest pulse to keep, 0 to disable the filter
+ * @return The width applied in microseconds, rounded up, or 0 if none
+ */
+uint32_t gpio_irq_filter(gpio_irq_t *obj, uint32_t us);
+
 /**@}*/
 
 #ifdef __cplusplus
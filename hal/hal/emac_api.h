@@ -27,6 +27,27 @@
 
 typedef struct emac_interface emac_interface_t;
 
+/**
+ * Capabilities an Emac interface can report, see @a get_capabilities
+ *
+ * A checksum is left to the hardware only if the interface reports it, the
+ * IP stack computes and verifies the others in software. Received frames
+ * are expected to be dropped by the hardware if a checksum it verifies is
+ * wrong.
+ */
+typedef enum emac_capability {
+    EMAC_CAP_TX_CHECKSUM_IP     = 0x00000001, /**< Inserts IPv4 header checksums */
+    EMAC_CAP_TX_CHECKSUM_UDP    = 0x00000002, /**< Inserts UDP checksums */
+    EMAC_CAP_TX_CHECKSUM_TCP    = 0x00000004, /**< Inserts TCP checksums */
+    EMAC_CAP_TX_CHECKSUM_ICMP   = 0x00000008, /**< Inserts ICMP checksums */
+    EMAC_CAP_RX_CHECKSUM_IP     = 0x00000100, /**< Verifies IPv4 header checksums */
+    EMAC_CAP_RX_CHECKSUM_UDP    = 0x00000200, /**< Verifies UDP checksums */
+    EMAC_CAP_RX_CHECKSUM_TCP    = 0x00000400, /**< Verifies TCP checksums */
+    EMAC_CAP_RX_CHECKSUM_ICMP   = 0x00000800, /**< Verifies ICMP checksums */
+    EMAC_CAP_VLAN               = 0x00010000, /**< Passes 802.1Q tagged frames */
+    EMAC_CAP_MULTICAST_HASH     = 0x00020000, /**< Filters multicast in hardware, see @a add_multicast_group */
+} emac_capability_t;
+
 /**
  * EmacInterface
  *
@@ -137,6 +158,37 @@ typedef void (*emac_set_link_input_cb_fn)(emac_interface_t *emac, emac_link_inpu
  */
 typedef void (*emac_set_link_state_cb_fn)(emac_interface_t *emac, emac_link_state_change_fn state_cb, void *data);
 
+/**
+ * Return the capabilities of the interface
+ *
+ * Optional, an interface without it has no capabilities.
+ *
+ * @param emac Emac interface
+ * @return     Logical OR of emac_capability_t
+ */
+typedef uint32_t (*emac_get_capabilities_fn)(emac_interface_t *emac);
+
+/**
+ * Accept frames sent to a multicast HW address
+ *
+ * Only used if the interface reports EMAC_CAP_MULTICAST_HASH.
+ *
+ * @param emac Emac interface
+ * @param addr Multicast HW address, see @a get_hwaddr_size
+ */
+typedef void (*emac_add_multicast_group_fn)(emac_interface_t *emac, const uint8_t *addr);
+
+/**
+ * Stop accepting frames sent to a multicast HW address
+ *
+ * Optional, hash filters that cannot tell addresses apart may keep
+ * accepting the address.
+ *
+ * @param emac Emac interface
+ * @param addr Multicast HW address, see @a get_hwaddr_size
+ */
+typedef void (*emac_remove_multicast_group_fn)(emac_interface_t *emac, const uint8_t *addr);
+
 typedef struct emac_interface_ops {
     emac_get_mtu_size_fn        get_mtu_size;
     emac_get_ifname_fn          get_ifname;
@@ -148,6 +200,9 @@ typedef struct emac_interface_ops {
     emac_power_down_fn          power_down;
     emac_set_link_input_cb_fn   set_link_input_cb;
     emac_set_link_state_cb_fn   set_link_state_cb;
+    emac_get_capabilities_fn    get_capabilities;
+    emac_add_multicast_group_fn add_multicast_group;
+    emac_remove_multicast_group_fn remove_multicast_group;
 } emac_interface_ops_t;
 
 typedef struct emac_interface {
@@ -39,6 +39,11 @@
 #define I2C_EVENT_TRANSFER_EARLY_NACK (1 << 4)
 #define I2C_EVENT_ALL                 (I2C_EVENT_ERROR |  I2C_EVENT_TRANSFER_COMPLETE | I2C_EVENT_ERROR_NO_SLAVE | I2C_EVENT_TRANSFER_EARLY_NACK)
 
+#define I2C_EVENT_SLAVE_RECEIVED      (1 << 5) /**< A write of the master to the slave ended */
+#define I2C_EVENT_SLAVE_TRANSMITTED   (1 << 6) /**< A read of the master from the slave ended */
+#define I2C_EVENT_SLAVE_RX_OVERFLOW   (1 << 7) /**< Bytes of the ring were overwritten before being read */
+#define I2C_EVENT_SLAVE_ALL           (I2C_EVENT_SLAVE_RECEIVED | I2C_EVENT_SLAVE_TRANSMITTED | I2C_EVENT_SLAVE_RX_OVERFLOW)
+
 /**@}*/
 
 #if DEVICE_I2C_ASYNCH
@@ -233,6 +238,72 @@ void i2c_abort_asynch(i2c_t *obj);
 
 #endif
 
+#if DEVICE_I2CSLAVE_ASYNCH
+
+/**
+ * \defgroup hal_AsynchI2CSlave Asynchronous I2C slave Hardware Abstraction Layer
+ *
+ * In slave mode, the bytes the master writes are stored in a ring buffer and
+ * its reads are answered from a reply, in the background. The end of each
+ * transfer, at a STOP or repeated start, is reported as an event.
+ * @{
+ */
+
+/** Start receiving and replying in the background
+ *
+ *  The peripheral must be in slave mode, with its address set. The ring
+ *  wraps over the oldest bytes.
+ *  @param obj       The I2C object
+ *  @param rx        The ring buffer, in use until i2c_slave_abort_asynch
+ *  @param rx_length The size of the ring in bytes
+ *  @param handler   The I2C IRQ handler to be set
+ *  @param event     The logical OR of events to be registered
+ *  @return 0 on success, -1 if the peripheral can't do it
+ */
+int i2c_slave_start_asynch(i2c_t *obj, void *rx, size_t rx_length, uint32_t handler, uint32_t event);
+
+/** Set the bytes sent when the master reads
+ *
+ *  Each read of the master gets the bytes from their start, then 0xFF once
+ *  they run out. Takes effect from the next read.
+ *  @param obj       The I2C object
+ *  @param tx        The bytes, in use until replaced or the peripheral is stopped
+ *  @param tx_length The number of bytes
+ */
+void i2c_slave_reply_asynch(i2c_t *obj, const void *tx, size_t tx_length);
+
+/** Get the number of bytes received into the ring
+ *
+ *  @param obj The I2C object
+ *  @return The bytes received since i2c_slave_start_asynch, wrapping at 2^32
+ */
+uint32_t i2c_slave_received(i2c_t *obj);
+
+/** The asynchronous IRQ handler of slave mode
+ *
+ *  Moves the bytes of the transfer in progress.
+ *  @param obj The I2C object
+ *  @return The registered events which occurred, I2C_EVENT_SLAVE_RECEIVED or I2C_EVENT_SLAVE_TRANSMITTED
+ */
+uint32_t i2c_slave_irq_handler_asynch(i2c_t *obj);
+
+/** Check if the peripheral receives in the background
+ *
+ *  @param obj The I2C object
+ *  @return Non-zero between i2c_slave_start_asynch and i2c_slave_abort_asynch
+ */
+uint8_t i2c_slave_active(i2c_t *obj);
+
+/** Stop receiving and replying in the background
+ *
+ *  @param obj The I2C object
+ */
+void i2c_slave_abort_asynch(i2c_t *obj);
+
+/**@}*/
+
+#endif
+
 /**@}*/
 
 #ifdef __cplusplus
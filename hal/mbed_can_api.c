@@ -0,0 +1,39 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hal/can_api.h"
+#include "platform/toolchain.h"
+
+#if DEVICE_CAN
+
+/* Targets with hardware filter banks override these */
+MBED_WEAK int can_filter_banks(can_t *obj)
+{
+    (void)obj;
+    return 0;
+}
+
+MBED_WEAK int can_filter_bank(can_t *obj, int bank, CanFilterMode mode, uint32_t id, uint32_t mask, CANFormat format)
+{
+    (void)obj;
+    (void)bank;
+    (void)mode;
+    (void)id;
+    (void)mask;
+    (void)format;
+    return 0;
+}
+
+#endif
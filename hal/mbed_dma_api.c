@@ -0,0 +1,87 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "hal/dma_api.h"
+#include "platform/critical.h"
+#include "platform/toolchain.h"
+
+/* Targets with a DMA controller override these */
+MBED_WEAK void dma_init(void)
+{
+}
+
+MBED_WEAK int dma_channel_allocate(uint32_t capabilities)
+{
+    (void)capabilities;
+    return DMA_ERROR_OUT_OF_CHANNELS;
+}
+
+MBED_WEAK int dma_channel_free(int channelid)
+{
+    (void)channelid;
+    return 0;
+}
+
+MBED_WEAK int dma_memcpy_start(int channelid, void *dst, const void *src, size_t size, dma_memcpy_handler handler, uint32_t id)
+{
+    (void)channelid;
+    (void)dst;
+    (void)src;
+    (void)size;
+    (void)handler;
+    (void)id;
+    return -1;
+}
+
+MBED_WEAK int dma_memcpy_active(int channelid)
+{
+    (void)channelid;
+    return 0;
+}
+
+MBED_WEAK void dma_memcpy_abort(int channelid)
+{
+    (void)channelid;
+}
+
+static void dma_memcpy_done(uint32_t id, int event)
+{
+    *(volatile int *)id = event;
+}
+
+void *dma_memcpy(void *dst, const void *src, size_t size)
+{
+    // the end of the copy is seen through its interrupt
+    if (size < MBED_CONF_HAL_DMA_MEMCPY_THRESHOLD || !core_util_are_interrupts_enabled()) {
+        return memcpy(dst, src, size);
+    }
+
+    int channel = dma_channel_allocate(DMA_CAP_MEM_TO_MEM);
+    if (channel == DMA_ERROR_OUT_OF_CHANNELS) {
+        return memcpy(dst, src, size);
+    }
+
+    volatile int event = 0;
+    if (dma_memcpy_start(channel, dst, src, size, dma_memcpy_done, (uint32_t)&event) == 0) {
+        while (!event);
+    }
+    dma_channel_free(channel);
+
+    if (event != DMA_MEMCPY_EVENT_COMPLETE) {
+        return memcpy(dst, src, size);
+    }
+    return dst;
+}
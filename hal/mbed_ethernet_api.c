@@ -0,0 +1,64 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hal/ethernet_api.h"
+#include "platform/toolchain.h"
+
+#if DEVICE_ETHERNET
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Targets handing out their DMA buffers override these, the defaults copy
+ * the frames once through the byte buffer functions */
+#define ETHERNET_FRAME_SIZE 1536
+
+static uint32_t ethernet_tx_frame[ETHERNET_FRAME_SIZE / 4];
+static uint32_t ethernet_rx_frame[ETHERNET_FRAME_SIZE / 4];
+
+MBED_WEAK void *ethernet_tx_acquire(int *size)
+{
+    *size = ETHERNET_FRAME_SIZE;
+    return ethernet_tx_frame;
+}
+
+MBED_WEAK int ethernet_tx_send(void *buffer, int size)
+{
+    if (ethernet_write((const char *)buffer, size) != size) {
+        return 0;
+    }
+    return ethernet_send();
+}
+
+MBED_WEAK void *ethernet_rx_acquire(int *size)
+{
+    int len = ethernet_receive();
+    if (len <= 0) {
+        return NULL;
+    }
+    if (len > ETHERNET_FRAME_SIZE) {
+        len = ETHERNET_FRAME_SIZE;
+    }
+
+    *size = ethernet_read((char *)ethernet_rx_frame, len);
+    return ethernet_rx_frame;
+}
+
+MBED_WEAK void ethernet_rx_release(void *buffer)
+{
+    (void)buffer;
+}
+
+#endif
@@ -0,0 +1,29 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hal/gpio_irq_api.h"
+#include "platform/toolchain.h"
+
+#if DEVICE_INTERRUPTIN
+
+/* Targets with a glitch filter on their pins override this */
+MBED_WEAK uint32_t gpio_irq_filter(gpio_irq_t *obj, uint32_t us)
+{
+    (void)obj;
+    (void)us;
+    return 0;
+}
+
+#endif
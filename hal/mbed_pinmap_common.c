@@ -13,22 +13,83 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <stddef.h>
+#include <stdint.h>
 #include "hal/pinmap.h"
+#include "platform/critical.h"
 #include "platform/mbed_error.h"
 
-void pinmap_pinout(PinName pin, const PinMap *map) {
+#if MBED_CONF_HAL_PINMAP_CACHE_SIZE
+
+#if MBED_CONF_HAL_PINMAP_CACHE_SIZE & (MBED_CONF_HAL_PINMAP_CACHE_SIZE - 1)
+#error "hal.pinmap-cache-size must be a power of two"
+#endif
+
+// Entries found recently, so drivers created again and again do not scan
+// their maps each time. A slot only ever holds the first entry of its map
+// for the pin, so the result is the same as the scan.
+typedef struct {
+    const PinMap *map;
+    const PinMap *entry;
+} pinmap_cache_slot_t;
+
+static pinmap_cache_slot_t pinmap_cache[MBED_CONF_HAL_PINMAP_CACHE_SIZE];
+
+// Fibonacci hashing of the map and the pin together: the top bits of the
+// product depend on every bit of both, and are the ones kept
+static unsigned pinmap_cache_index(PinName pin, const PinMap *map) {
+    uint32_t key = ((uint32_t)(uintptr_t)map ^ ((uint32_t)pin << 16)) * 0x9E3779B1u;
+    return (unsigned)(((uint64_t)key * MBED_CONF_HAL_PINMAP_CACHE_SIZE) >> 32);
+}
+
+#endif
+
+static const PinMap *pinmap_find(PinName pin, const PinMap *map) {
     if (pin == NC)
-        return;
+        return NULL;
+
+#if MBED_CONF_HAL_PINMAP_CACHE_SIZE
+    pinmap_cache_slot_t *slot = &pinmap_cache[pinmap_cache_index(pin, map)];
+    const PinMap *entry = NULL;
+
+    core_util_critical_section_enter();
+    if (slot->map == map && slot->entry->pin == pin) {
+        entry = slot->entry;
+    }
+    core_util_critical_section_exit();
+    if (entry != NULL)
+        return entry;
+#endif
 
+    const PinMap *start = map;
     while (map->pin != NC) {
         if (map->pin == pin) {
-            pin_function(pin, map->function);
-
-            pin_mode(pin, PullNone);
-            return;
+#if MBED_CONF_HAL_PINMAP_CACHE_SIZE
+            core_util_critical_section_enter();
+            slot->map = start;
+            slot->entry = map;
+            core_util_critical_section_exit();
+#else
+            (void)start;
+#endif
+            return map;
         }
         map++;
     }
+    return NULL;
+}
+
+void pinmap_pinout(PinName pin, const PinMap *map) {
+    if (pin == NC)
+        return;
+
+    const PinMap *entry = pinmap_find(pin, map);
+    if (entry != NULL) {
+        pin_function(pin, entry->function);
+
+        pin_mode(pin, PullNone);
+        return;
+    }
     error("could not pinout");
 }
 
@@ -49,12 +110,10 @@ uint32_t pinmap_merge(uint32_t a, uint32_t b) {
 }
 
 uint32_t pinmap_find_peripheral(PinName pin, const PinMap* map) {
-    while (map->pin != NC) {
-        if (map->pin == pin)
-            return map->peripheral;
-        map++;
-    }
-    return (uint32_t)NC;
+    const PinMap *entry = pinmap_find(pin, map);
+    if (entry == NULL)
+        return (uint32_t)NC;
+    return entry->peripheral;
 }
 
 uint32_t pinmap_peripheral(PinName pin, const PinMap* map) {
@@ -69,12 +128,10 @@ uint32_t pinmap_peripheral(PinName pin, const PinMap* map) {
 }
 
 uint32_t pinmap_find_function(PinName pin, const PinMap* map) {
-    while (map->pin != NC) {
-        if (map->pin == pin)
-            return map->function;
-        map++;
-    }
-    return (uint32_t)NC;
+    const PinMap *entry = pinmap_find(pin, map);
+    if (entry == NULL)
+        return (uint32_t)NC;
+    return entry->function;
 }
 
 uint32_t pinmap_function(PinName pin, const PinMap* map) {
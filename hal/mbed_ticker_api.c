@@ -16,6 +16,226 @@
 #include <stddef.h>
 #include "hal/ticker_api.h"
 #include "platform/critical.h"
+#include "platform/toolchain.h"
+
+#if MBED_CONF_HAL_TICKER_HEAP_QUEUE
+/* Pending events are kept in a leftist heap ordered by timestamp. The
+ * queue head is the heap root, next is reused as the right child and rank
+ * is the null path length, which is at most log2(n + 1). Insert and remove
+ * only walk right spines and a single parent path, so their time is
+ * bounded by O(log n) rather than by the number of pending events. */
+
+static uint32_t ticker_heap_rank(const ticker_event_t *node) {
+    return node ? node->rank : 0;
+}
+
+static ticker_event_t *ticker_heap_merge(ticker_event_t *a, ticker_event_t *b) {
+    if (a == NULL) {
+        return b;
+    }
+    if (b == NULL) {
+        return a;
+    }
+    if ((int)(b->timestamp - a->timestamp) < 0) {
+        ticker_event_t *t = a;
+        a = b;
+        b = t;
+    }
+
+    // merge down the right spine, keeping the shorter path on the right
+    ticker_event_t *right = ticker_heap_merge(a->next, b);
+    right->parent = a;
+    if (ticker_heap_rank(a->left) < right->rank) {
+        a->next = a->left;
+        a->left = right;
+    } else {
+        a->next = right;
+    }
+    a->rank = ticker_heap_rank(a->next) + 1;
+    return a;
+}
+
+static void ticker_queue_insert(ticker_event_queue_t *queue, ticker_event_t *obj) {
+    obj->left = NULL;
+    obj->next = NULL;
+    obj->parent = NULL;
+    obj->rank = 1;
+    queue->head = ticker_heap_merge(queue->head, obj);
+    queue->head->parent = NULL;
+}
+
+static void ticker_queue_remove(ticker_event_queue_t *queue, ticker_event_t *obj) {
+    if (obj != queue->head && obj->parent == NULL) {
+        // not in the heap
+        return;
+    }
+
+    if (obj->left) {
+        obj->left->parent = NULL;
+    }
+    if (obj->next) {
+        obj->next->parent = NULL;
+    }
+    ticker_event_t *sub = ticker_heap_merge(obj->left, obj->next);
+    ticker_event_t *p = obj->parent;
+    if (sub) {
+        sub->parent = p;
+    }
+
+    if (p == NULL) {
+        queue->head = sub;
+    } else {
+        if (p->left == obj) {
+            p->left = sub;
+        } else {
+            p->next = sub;
+        }
+
+        // restore the leftist property up the path until ranks settle
+        while (p != NULL) {
+            if (ticker_heap_rank(p->left) < ticker_heap_rank(p->next)) {
+                ticker_event_t *t = p->left;
+                p->left = p->next;
+                p->next = t;
+            }
+            uint32_t rank = ticker_heap_rank(p->next) + 1;
+            if (rank == p->rank) {
+                break;
+            }
+            p->rank = rank;
+            p = p->parent;
+        }
+    }
+
+    obj->left = NULL;
+    obj->next = NULL;
+    obj->parent = NULL;
+    obj->rank = 0;
+}
+
+#else
+static void ticker_queue_insert(ticker_event_queue_t *queue, ticker_event_t *obj) {
+    /* Go through the list until we either reach the end, or find
+       an element this should come before (which is possibly the
+       head). */
+    ticker_event_t *prev = NULL, *p = queue->head;
+    while (p != NULL) {
+        /* check if we come before p */
+        if ((int)(obj->timestamp - p->timestamp) < 0) {
+            break;
+        }
+        /* go to the next element */
+        prev = p;
+        p = p->next;
+    }
+    /* if prev is NULL we're at the head */
+    if (prev == NULL) {
+        queue->head = obj;
+    } else {
+        prev->next = obj;
+    }
+    /* if we're at the end p will be NULL, which is correct */
+    obj->next = p;
+}
+
+static void ticker_queue_remove(ticker_event_queue_t *queue, ticker_event_t *obj) {
+    // remove this object from the list
+    if (queue->head == obj) {
+        // first in the list, so just drop me
+        queue->head = obj->next;
+    } else {
+        // find the object before me, then drop me
+        ticker_event_t* p = queue->head;
+        while (p != NULL) {
+            if (p->next == obj) {
+                p->next = obj->next;
+                break;
+            }
+            p = p->next;
+        }
+    }
+}
+#endif
+
+#if MBED_CONF_HAL_TICKER_SLACK
+#if MBED_CONF_HAL_TICKER_HEAP_QUEUE
+static void ticker_heap_wake(const ticker_event_t *node, timestamp_t *wake) {
+    // the events below start even later
+    if (node == NULL || (int)(node->timestamp - *wake) >= 0) {
+        return;
+    }
+    timestamp_t end = node->timestamp + node->slack;
+    if ((int)(end - *wake) < 0) {
+        *wake = end;
+    }
+    ticker_heap_wake(node->left, wake);
+    ticker_heap_wake(node->next, wake);
+}
+#endif
+
+/* The earliest end of the event windows. Only events that start before it
+ * can end sooner, so the search stops at the first later start. */
+static timestamp_t ticker_wake_time(const ticker_event_t *head) {
+    timestamp_t wake = head->timestamp + head->slack;
+#if MBED_CONF_HAL_TICKER_HEAP_QUEUE
+    ticker_heap_wake(head->left, &wake);
+    ticker_heap_wake(head->next, &wake);
+#else
+    for (const ticker_event_t *p = head->next; p != NULL && (int)(p->timestamp - wake) < 0; p = p->next) {
+        timestamp_t end = p->timestamp + p->slack;
+        if ((int)(end - wake) < 0) {
+            wake = end;
+        }
+    }
+#endif
+    return wake;
+}
+#else
+static timestamp_t ticker_wake_time(const ticker_event_t *head) {
+    return head->timestamp;
+}
+#endif
+
+/* The 64-bit time is present_time plus the ticks since tick_last. It is
+ * right as long as it is updated at least once per counter wrap: once a
+ * ticker is tracking, its interrupt is never left off for longer than
+ * TICKER_UPDATE_INTERVAL ticks, even with no event pending. */
+#define TICKER_UPDATE_INTERVAL  0x40000000
+
+// Called with interrupts disabled
+static void ticker_update_present_time(const ticker_data_t *const data) {
+    ticker_event_queue_t *queue = data->queue;
+    timestamp_t now = data->interface->read();
+
+    queue->present_time_seq++;
+    queue->present_time += (uint32_t)(now - queue->tick_last);
+    queue->tick_last = now;
+    queue->present_time_seq++;
+}
+
+// Called with interrupts disabled
+static void ticker_schedule(const ticker_data_t *const data) {
+    ticker_event_t *head = data->queue->head;
+
+    if (!data->queue->tracking) {
+        if (head == NULL) {
+            data->interface->disable_interrupt();
+        } else {
+            data->interface->set_interrupt(ticker_wake_time(head));
+        }
+        return;
+    }
+
+    ticker_update_present_time(data);
+    timestamp_t wake = data->queue->tick_last + TICKER_UPDATE_INTERVAL;
+    if (head != NULL) {
+        timestamp_t event_wake = ticker_wake_time(head);
+        if ((int)(event_wake - wake) < 0) {
+            wake = event_wake;
+        }
+    }
+    data->interface->set_interrupt(wake);
+}
 
 void ticker_set_handler(const ticker_data_t *const data, ticker_event_handler handler) {
     data->interface->init();
@@ -23,14 +243,15 @@ void ticker_set_handler(const ticker_data_t *const data, ticker_event_handler ha
     data->queue->event_handler = handler;
 }
 
-void ticker_irq_handler(const ticker_data_t *const data) {
+MBED_RAMFUNC void ticker_irq_handler(const ticker_data_t *const data) {
     data->interface->clear_interrupt();
 
     /* Go through all the pending TimerEvents */
     while (1) {
         if (data->queue->head == NULL) {
-            // There are no more TimerEvents left, so disable matches.
-            data->interface->disable_interrupt();
+            // There are no more TimerEvents left, so disable matches
+            // (or only wake up to keep the 64-bit time).
+            ticker_schedule(data);
             return;
         }
 
@@ -38,7 +259,7 @@ void ticker_irq_handler(const ticker_data_t *const data) {
             // This event was in the past:
             //      point to the following one and execute its handler
             ticker_event_t *p = data->queue->head;
-            data->queue->head = data->queue->head->next;
+            ticker_queue_remove(data->queue, p);
             if (data->queue->event_handler != NULL) {
                 (*data->queue->event_handler)(p->id); // NOTE: the handler can set new events
             }
@@ -47,42 +268,39 @@ void ticker_irq_handler(const ticker_data_t *const data) {
         } else {
             // This event and the following ones in the list are in the future:
             //      set it as next interrupt and return
-            data->interface->set_interrupt(data->queue->head->timestamp);
+            ticker_schedule(data);
             return;
         }
     }
 }
 
 void ticker_insert_event(const ticker_data_t *const data, ticker_event_t *obj, timestamp_t timestamp, uint32_t id) {
+    ticker_insert_event_slack(data, obj, timestamp, 0, id);
+}
+
+void ticker_insert_event_slack(const ticker_data_t *const data, ticker_event_t *obj, timestamp_t timestamp,
+                               uint32_t slack, uint32_t id) {
     /* disable interrupts for the duration of the function */
     core_util_critical_section_enter();
 
     // initialise our data
     obj->timestamp = timestamp;
     obj->id = id;
+#if MBED_CONF_HAL_TICKER_SLACK
+    obj->slack = slack;
+#else
+    (void)slack;
+#endif
 
-    /* Go through the list until we either reach the end, or find
-       an element this should come before (which is possibly the
-       head). */
-    ticker_event_t *prev = NULL, *p = data->queue->head;
-    while (p != NULL) {
-        /* check if we come before p */
-        if ((int)(timestamp - p->timestamp) < 0) {
-            break;
-        }
-        /* go to the next element */
-        prev = p;
-        p = p->next;
-    }
-    /* if prev is NULL we're at the head */
-    if (prev == NULL) {
-        data->queue->head = obj;
-        data->interface->set_interrupt(timestamp);
-    } else {
-        prev->next = obj;
+    ticker_queue_insert(data->queue, obj);
+#if MBED_CONF_HAL_TICKER_SLACK
+    // a later event can still end its window first
+    ticker_schedule(data);
+#else
+    if (data->queue->head == obj) {
+        ticker_schedule(data);
     }
-    /* if we're at the end p will be NULL, which is correct */
-    obj->next = p;
+#endif
 
     core_util_critical_section_exit();
 }
@@ -90,25 +308,10 @@ void ticker_insert_event(const ticker_data_t *const data, ticker_event_t *obj, t
 void ticker_remove_event(const ticker_data_t *const data, ticker_event_t *obj) {
     core_util_critical_section_enter();
 
-    // remove this object from the list
-    if (data->queue->head == obj) {
-        // first in the list, so just drop me
-        data->queue->head = obj->next;
-        if (data->queue->head == NULL) {
-            data->interface->disable_interrupt();
-        } else {
-            data->interface->set_interrupt(data->queue->head->timestamp);
-        }
-    } else {
-        // find the object before me, then drop me
-        ticker_event_t* p = data->queue->head;
-        while (p != NULL) {
-            if (p->next == obj) {
-                p->next = obj->next;
-                break;
-            }
-            p = p->next;
-        }
+    ticker_event_t *head = data->queue->head;
+    ticker_queue_remove(data->queue, obj);
+    if (head == obj) {
+        ticker_schedule(data);
     }
 
     core_util_critical_section_exit();
@@ -119,6 +322,34 @@ timestamp_t ticker_read(const ticker_data_t *const data)
     return data->interface->read();
 }
 
+us_timestamp_t ticker_read_us64(const ticker_data_t *const data)
+{
+    ticker_event_queue_t *queue = data->queue;
+
+    if (!queue->tracking) {
+        core_util_critical_section_enter();
+        if (!queue->tracking) {
+            data->interface->init();
+            queue->tracking = 1;
+            ticker_schedule(data);
+        }
+        core_util_critical_section_exit();
+    }
+
+    // retry if the interrupt updated the time meanwhile
+    uint32_t seq;
+    us_timestamp_t base;
+    timestamp_t last, now;
+    do {
+        seq = queue->present_time_seq;
+        base = queue->present_time;
+        last = queue->tick_last;
+        now = data->interface->read();
+    } while ((seq & 1) || seq != queue->present_time_seq);
+
+    return base + (uint32_t)(now - last);
+}
+
 int ticker_get_next_timestamp(const ticker_data_t *const data, timestamp_t *timestamp)
 {
     int ret = 0;
@@ -126,7 +357,7 @@ int ticker_get_next_timestamp(const ticker_data_t *const data, timestamp_t *time
     /* if head is NULL, there are no pending events */
     core_util_critical_section_enter();
     if (data->queue->head != NULL) {
-        *timestamp = data->queue->head->timestamp;
+        *timestamp = ticker_wake_time(data->queue->head);
         ret = 1;
     }
     core_util_critical_section_exit();
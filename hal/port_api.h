@@ -44,6 +44,16 @@ typedef struct port_s port_t;
  */
 PinName port_pin(PortName port, int pin_n);
 
+/** Get the port and the pin number of a pin name
+ *
+ * The reverse of port_pin. The default implementation knows no port, so
+ * callers fall back to per-pin access.
+ * @param pin  The pin name
+ * @param port Receives the port of the pin
+ * @return The pin number within the port, -1 if the pin is on no port
+ */
+int port_pin_bit(PinName pin, PortName *port);
+
 /** Initilize the port
  *
  * @param obj  The port object to initialize
@@ -69,6 +79,9 @@ void port_dir(port_t *obj, PinDirection dir);
 
 /** Write value to the port
  *
+ * Only the pins of the mask change. Targets should update them with one
+ * register write, so they change together and other pins of the port are
+ * not disturbed.
  * @param obj   The port object
  * @param value The value to be set
  */
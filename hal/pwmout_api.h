@@ -20,6 +20,7 @@
 #define MBED_PWMOUT_API_H
 
 #include "device.h"
+#include <stddef.h>
 
 #if DEVICE_PWMOUT
 
@@ -109,6 +110,72 @@ void pwmout_pulsewidth_us(pwmout_t *obj, int us);
 
 /**@}*/
 
+#if DEVICE_PWMOUT_ASYNCH
+
+/**
+ * \defgroup AsynchPwmOut Asynchronous pwmout hal functions
+ * @{
+ */
+
+#define PWMOUT_EVENT_HALF_COMPLETE (1 << 0) /**< The first half of the sequence was loaded */
+#define PWMOUT_EVENT_COMPLETE      (1 << 1) /**< The whole sequence was loaded */
+#define PWMOUT_EVENT_ALL           (PWMOUT_EVENT_HALF_COMPLETE | PWMOUT_EVENT_COMPLETE)
+
+/** Get the sequence entry for a duty cycle
+ *
+ * Sequence entries are in the units of the target timer, this converts a
+ * duty cycle at the given sequence rate.
+ * @param obj     The pwmout object
+ * @param hz      The sequence rate, in PWM periods per second
+ * @param percent The duty cycle, from 0.0f to 1.0f
+ * @return The entry to put in the sequence
+ */
+uint16_t pwmout_sequence_pulse(pwmout_t *obj, uint32_t hz, float percent);
+
+/** Start outputting a sequence of pulse widths, one per PWM period
+ *
+ * The period is set to 1 / hz at the finest resolution of the timer, and DMA
+ * loads the next entry of the sequence at each period. The sequence stays in
+ * use until it completes or is stopped. A one-shot sequence holds its last
+ * pulse width once done, a circular one starts over at its end.
+ * @param obj      The pwmout object
+ * @param pulses   The sequence, built with pwmout_sequence_pulse
+ * @param length   The number of entries in the sequence
+ * @param hz       The sequence rate, in PWM periods per second
+ * @param circular Nonzero to restart from the beginning of the sequence at its end
+ * @param handler  The interrupt handler, calling pwmout_sequence_irq_handler
+ * @param event    The logical OR of the events to report
+ * @return 0 if the sequence started, -1 if one is already running or the
+ *         target cannot output this pin or rate
+ */
+int pwmout_sequence_start(pwmout_t *obj, const uint16_t *pulses, size_t length, uint32_t hz, uint8_t circular, uint32_t handler, uint32_t event);
+
+/** Handle the sequence interrupt
+ *
+ * @param obj The pwmout object
+ * @return The events that occurred, limited to the ones requested
+ */
+int pwmout_sequence_irq_handler(pwmout_t *obj);
+
+/** Stop the sequence, the output holds its current pulse width
+ *
+ * Targets which stop the PWM generation leave the pin at its idle level
+ * instead. The regular output comes back with the next pwmout_period_us.
+ * @param obj The pwmout object
+ */
+void pwmout_sequence_stop(pwmout_t *obj);
+
+/** Check if a sequence is running
+ *
+ * @param obj The pwmout object
+ * @return Nonzero until the sequence completes or is stopped
+ */
+uint8_t pwmout_sequence_active(pwmout_t *obj);
+
+/**@}*/
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
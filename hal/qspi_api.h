@@ -0,0 +1,129 @@
+/** \addtogroup hal */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_QSPI_API_H
+#define MBED_QSPI_API_H
+
+#include <stdint.h>
+#include "device.h"
+
+#if DEVICE_QSPI
+
+#include "PinNames.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** QSPI HAL structure. qspi_s is declared in the target's HAL
+ */
+typedef struct qspi_s qspi_t;
+
+/** Number of lines a phase of a command is transferred on
+ */
+typedef enum {
+    QSPI_LINES_NONE = 0,    /**< The phase is skipped */
+    QSPI_LINES_1    = 1,
+    QSPI_LINES_2    = 2,
+    QSPI_LINES_4    = 4
+} qspi_lines_t;
+
+/** A command to the flash
+ *
+ * Its phases are sent in order: the instruction, the address, the dummy
+ * cycles, then the data.
+ */
+typedef struct {
+    uint8_t instruction;
+    qspi_lines_t instruction_lines;
+    uint32_t address;
+    qspi_lines_t address_lines;
+    uint8_t address_size;   /**< Size of the address in bytes, 1 to 4 */
+    uint8_t dummy_cycles;   /**< Clock cycles between the address and the data read */
+    qspi_lines_t data_lines;
+} qspi_command_t;
+
+/**
+ * \defgroup hal_qspi QSPI hal functions
+ *
+ * A serial flash on a quad SPI controller. Commands are sent in indirect
+ * mode, each with its data; in memory-mapped mode the controller turns
+ * reads of a window of the address space into read commands, so the flash
+ * reads like memory and code in it can execute in place.
+ * @{
+ */
+
+/** Initialize the controller
+ *
+ * @param obj  The QSPI object
+ * @param io0  The first data pin, the MOSI line of single line phases
+ * @param io1  The second data pin, the MISO line of single line phases
+ * @param io2  The third data pin, or NC without quad phases
+ * @param io3  The fourth data pin, or NC without quad phases
+ * @param sclk The clock pin
+ * @param ssel The chip select pin
+ * @param hz   The highest clock, the controller may round it down
+ * @param size The size of the flash in bytes, a power of two
+ * @return 0 on success, -1 for pins or a size the controller can't use
+ */
+int qspi_init(qspi_t *obj, PinName io0, PinName io1, PinName io2, PinName io3, PinName sclk, PinName ssel,
+              uint32_t hz, uint32_t size);
+
+/** Release the controller
+ *
+ * @param obj The QSPI object
+ */
+void qspi_free(qspi_t *obj);
+
+/** Send a command in indirect mode
+ *
+ * Leaves memory-mapped mode first. With data_lines set, length bytes are
+ * written from tx, or read into rx when tx is NULL.
+ *
+ * @param obj     The QSPI object
+ * @param command The command
+ * @param tx      The data written, or NULL
+ * @param rx      The data read, or NULL
+ * @param length  The number of bytes of data
+ * @return 0 on success, -1 on error
+ */
+int qspi_command(qspi_t *obj, const qspi_command_t *command, const void *tx, void *rx, uint32_t length);
+
+/** Enter memory-mapped mode
+ *
+ * Reads of the window returned in base are read commands like command,
+ * its address being the offset in the window. The window reads the flash
+ * as it is when entering the mode; the next qspi_command leaves it.
+ *
+ * @param obj     The QSPI object
+ * @param command The read command, its address is ignored
+ * @param base    Set to the start of the window, size bytes long
+ * @return 0 on success, -1 on error
+ */
+int qspi_memory_map(qspi_t *obj, const qspi_command_t *command, const void **base);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
@@ -0,0 +1,66 @@
+/** \addtogroup hal */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_SAMPLE_TIMER_API_H
+#define MBED_SAMPLE_TIMER_API_H
+
+#include <stdint.h>
+#include "device.h"
+
+#if DEVICE_SAMPLE_TIMER
+
+#include "cmsis.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \defgroup hal_sample_timer Sample timer hal functions
+ *
+ * A periodic interrupt on a timer that nothing else uses, for the sampling
+ * profiler. The caller installs its own handler on the interrupt vector,
+ * so the handler sees the exception frame of the interrupted code.
+ * @{
+ */
+
+/** Start the periodic interrupt
+ *
+ * The interrupt is left disabled in the NVIC.
+ *
+ * @param hz Interrupts per second, the timer may round it
+ * @return Interrupt of the timer
+ */
+IRQn_Type sample_timer_init(uint32_t hz);
+
+/** Acknowledge the interrupt, called by the handler */
+void sample_timer_clear(void);
+
+/** Stop the timer and its clock */
+void sample_timer_free(void);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
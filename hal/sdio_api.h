@@ -0,0 +1,117 @@
+/** \addtogroup hal */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_SDIO_API_H
+#define MBED_SDIO_API_H
+
+#include <stdint.h>
+#include "device.h"
+
+#if DEVICE_SDIO
+
+#include "PinNames.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Size of the blocks read and written, in bytes */
+#define SDIO_BLOCK_SIZE     512
+
+/** SDIO HAL structure. sdio_s is declared in the target's HAL
+ */
+typedef struct sdio_s sdio_t;
+
+/** The card found by sdio_init
+ */
+typedef struct {
+    uint32_t block_count;   /**< Number of SDIO_BLOCK_SIZE blocks of the card */
+    uint32_t clock_hz;      /**< Clock of the data transfers */
+    uint8_t bus_width;      /**< Number of data lines in use, 1 or 4 */
+} sdio_card_info_t;
+
+/**
+ * \defgroup hal_sdio SDIO hal functions
+ *
+ * An SD card on the SD bus of a host controller, in 1 or 4-bit mode. Block
+ * transfers move the data by DMA and use the multiple block commands for
+ * more than one block; the calls return once the card has the data.
+ * @{
+ */
+
+/** Initialize the host and the card in its slot
+ *
+ * The card is identified with the slow identification clock, then the
+ * host switches to the data clock and to 4 data lines when d1 to d3 are
+ * connected.
+ *
+ * @param obj The SDIO object
+ * @param clk The clock pin
+ * @param cmd The command pin
+ * @param d0  The first data pin
+ * @param d1  The second data pin, or NC for a 1-bit bus
+ * @param d2  The third data pin, or NC for a 1-bit bus
+ * @param d3  The fourth data pin, or NC for a 1-bit bus
+ * @param hz  The highest data clock, the host may round it down
+ * @return 0 if a card is ready, -1 otherwise
+ */
+int sdio_init(sdio_t *obj, PinName clk, PinName cmd, PinName d0, PinName d1, PinName d2, PinName d3, uint32_t hz);
+
+/** Release the host
+ *
+ * @param obj The SDIO object
+ */
+void sdio_free(sdio_t *obj);
+
+/** Get the card found by sdio_init
+ *
+ * @param obj  The SDIO object
+ * @param info Filled with the card and bus parameters
+ */
+void sdio_card_info(sdio_t *obj, sdio_card_info_t *info);
+
+/** Read blocks
+ *
+ * @param obj    The SDIO object
+ * @param buffer The blocks read, any alignment
+ * @param block  The first block
+ * @param count  The number of blocks
+ * @return 0 on success, -1 on error
+ */
+int sdio_read_blocks(sdio_t *obj, uint8_t *buffer, uint32_t block, uint32_t count);
+
+/** Write blocks
+ *
+ * @param obj    The SDIO object
+ * @param buffer The blocks to write, any alignment
+ * @param block  The first block
+ * @param count  The number of blocks
+ * @return 0 once the card has programmed them, -1 on error
+ */
+int sdio_write_blocks(sdio_t *obj, const uint8_t *buffer, uint32_t block, uint32_t count);
+
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
@@ -29,7 +29,7 @@
 #define SERIAL_EVENT_RX_SHIFT (8)
 
 #define SERIAL_EVENT_TX_MASK (0x00FC)
-#define SERIAL_EVENT_RX_MASK (0x3F00)
+#define SERIAL_EVENT_RX_MASK (0x7F00)
 
 #define SERIAL_EVENT_ERROR (1 << 1)
 
@@ -53,9 +53,11 @@
 #define SERIAL_EVENT_RX_PARITY_ERROR    (1 << (SERIAL_EVENT_RX_SHIFT + 3))
 #define SERIAL_EVENT_RX_OVERFLOW        (1 << (SERIAL_EVENT_RX_SHIFT + 4))
 #define SERIAL_EVENT_RX_CHARACTER_MATCH (1 << (SERIAL_EVENT_RX_SHIFT + 5))
+#define SERIAL_EVENT_RX_IDLE            (1 << (SERIAL_EVENT_RX_SHIFT + 6)) /**< The line went idle after a frame, STM32F4 only */
 #define SERIAL_EVENT_RX_ALL             (SERIAL_EVENT_RX_OVERFLOW | SERIAL_EVENT_RX_PARITY_ERROR | \
                                          SERIAL_EVENT_RX_FRAMING_ERROR | SERIAL_EVENT_RX_OVERRUN_ERROR | \
-                                         SERIAL_EVENT_RX_COMPLETE | SERIAL_EVENT_RX_CHARACTER_MATCH)
+                                         SERIAL_EVENT_RX_COMPLETE | SERIAL_EVENT_RX_CHARACTER_MATCH | \
+                                         SERIAL_EVENT_RX_IDLE)
 /**@}*/
 
 #define SERIAL_RESERVED_CHAR_MATCH (255)
@@ -88,7 +90,7 @@ typedef void (*uart_irq_handler)(uint32_t id, SerialIrq event);
 typedef struct {
     struct serial_s serial;  /**< Target specific serial structure */
     struct buffer_s tx_buff; /**< TX buffer */
-    struct buffer_s rx_buff; /**< RX buffer */
+    struct buffer_s rx_buff; /**< RX buffer, pos is the number of words received */
     uint8_t char_match;      /**< Character to be matched */
     uint8_t char_found;      /**< State of the matched character */
 } serial_t;
@@ -245,6 +247,16 @@ int serial_tx_asynch(serial_t *obj, const void *tx, size_t tx_length, uint8_t tx
 /** Begin asynchronous RX transfer (enable interrupt for data collecting)
  *  The used buffer is specified in the serial object - rx_buff
  *
+ *  The transfer ends when the buffer is full, on SERIAL_EVENT_RX_CHARACTER_MATCH
+ *  once the matching character is stored, or on SERIAL_EVENT_RX_IDLE when the
+ *  line stays idle for a character time after at least one character. rx_buff.pos
+ *  then tells how many words the buffer holds; STM32 targets count the matching
+ *  character, other targets may not.
+ *
+ *  SERIAL_EVENT_RX_IDLE is only implemented on STM32F4, with the UART idle-line
+ *  interrupt. It does not use DMA, the F4 asynchronous transfers being
+ *  interrupt-driven.
+ *
  * @param obj        The serial object
  * @param rx         The receive buffer
  * @param rx_length  The number of bytes to receive
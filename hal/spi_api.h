@@ -33,6 +33,7 @@
 #define SPI_EVENT_INTERNAL_TRANSFER_COMPLETE (1 << 30) // Internal flag to report that an event occurred
 
 #define SPI_FILL_WORD         (0xFFFF)
+#define SPI_FILL_CHAR         (0xFF)
 
 #if DEVICE_SPI_ASYNCH
 /** Asynch SPI HAL structure
@@ -116,6 +117,27 @@ void spi_frequency(spi_t *obj, int hz);
  */
 int  spi_master_write(spi_t *obj, int value);
 
+/** Write a block out in master mode and receive a value
+ *
+ *  The total number of bytes sent and received will be the maximum of
+ *  tx_length and rx_length. The bytes written will be padded with the
+ *  value 0xff.
+ *
+ *  Targets with a FIFO keep it filled for the duration of the block, the
+ *  default implementation calls spi_master_write for each frame.
+ *
+ * @param[in] obj        The SPI peripheral to use for sending
+ * @param[in] tx_buffer  Pointer to the byte-array of data to write to the device
+ * @param[in] tx_length  Number of bytes to write, may be zero
+ * @param[in] rx_buffer  Pointer to the byte-array of data to read from the device
+ * @param[in] rx_length  Number of bytes to read, may be zero
+ * @param[in] write_fill Default data transmitted while performing a read
+ * @returns
+ *      The number of bytes written and read from the device. This is
+ *      maximum of tx_length and rx_length.
+ */
+int  spi_master_block_write(spi_t *obj, const char *tx_buffer, int tx_length, char *rx_buffer, int rx_length, char write_fill);
+
 /** Check if a value is available to read
  *
  * @param[in] obj The SPI peripheral to check
@@ -204,6 +226,73 @@ uint8_t spi_active(spi_t *obj);
 void spi_abort_asynch(spi_t *obj);
 
 
+#endif
+
+#if DEVICE_SPISLAVE_ASYNCH
+/**
+ * \defgroup AsynchSPISlave Asynchronous SPI slave Hardware Abstraction Layer
+ *
+ * In slave mode, the frames received are stored in a ring buffer and the
+ * reply is sent in the background, without the CPU handling each frame. The
+ * end of a transaction, when the master deselects the slave, is reported as
+ * SPI_EVENT_COMPLETE.
+ * @{
+ */
+
+/** Start receiving and replying in the background
+ *
+ * The peripheral must be in slave mode, with frames of 8 bits at most and a
+ * select pin. Each frame takes a byte of the ring, which wraps over the
+ * oldest frames.
+ * @param[in] obj       The SPI object
+ * @param[in] rx        The ring buffer, in use until spi_slave_abort_asynch
+ * @param[in] rx_length The size of the ring in bytes
+ * @param[in] handler   SPI interrupt handler
+ * @param[in] event     The logical OR of events to be registered
+ * @return 0 on success, -1 if the peripheral can't do it in this configuration
+ */
+int spi_slave_start_asynch(spi_t *obj, void *rx, size_t rx_length, uint32_t handler, uint32_t event);
+
+/** Set the frames sent to the master
+ *
+ * Takes effect at once. Every transaction sends the frames from their start,
+ * then SPI_FILL_CHAR once they run out; set it between transactions, e.g.
+ * from the handler on SPI_EVENT_COMPLETE.
+ * @param[in] obj       The SPI object
+ * @param[in] tx        The frames, in use until replaced or the peripheral is stopped
+ * @param[in] tx_length The number of frames, 0 to send SPI_FILL_CHAR only
+ */
+void spi_slave_reply_asynch(spi_t *obj, const void *tx, size_t tx_length);
+
+/** Get the number of frames received into the ring
+ *
+ * @param[in] obj The SPI object
+ * @return The frames received since spi_slave_start_asynch, wrapping at 2^32
+ */
+uint32_t spi_slave_received(spi_t *obj);
+
+/** The asynchronous IRQ handler of slave mode
+ *
+ * @param[in] obj The SPI object
+ * @return The registered events which occurred, SPI_EVENT_COMPLETE at the end of a transaction
+ */
+uint32_t spi_slave_irq_handler_asynch(spi_t *obj);
+
+/** Check if the peripheral receives in the background
+ *
+ * @param[in] obj The SPI object
+ * @return Non-zero between spi_slave_start_asynch and spi_slave_abort_asynch
+ */
+uint8_t spi_slave_active(spi_t *obj);
+
+/** Stop receiving and replying in the background
+ *
+ * @param[in] obj The SPI object
+ */
+void spi_slave_abort_asynch(spi_t *obj);
+
+/**@}*/
+
 #endif
 
 /**@}*/
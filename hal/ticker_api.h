@@ -23,13 +23,25 @@
 #include "device.h"
 
 typedef uint32_t timestamp_t;
+typedef uint64_t us_timestamp_t;
 
 /** Ticker's event structure
+ *
+ * With the heap queue backend (hal.ticker-heap-queue) an event must be
+ * zero-initialised before it is first passed to ticker_remove_event.
  */
 typedef struct ticker_event_s {
     timestamp_t            timestamp; /**< Event's timestamp */
     uint32_t               id;        /**< TimerEvent object */
     struct ticker_event_s *next;      /**< Next event in the queue */
+#if MBED_CONF_HAL_TICKER_SLACK
+    uint32_t               slack;     /**< Ticks the event may fire late */
+#endif
+#if MBED_CONF_HAL_TICKER_HEAP_QUEUE
+    struct ticker_event_s *left;      /**< Left child in the heap */
+    struct ticker_event_s *parent;    /**< Parent in the heap, NULL for the head */
+    uint32_t               rank;      /**< Null path length of the heap node */
+#endif
 } ticker_event_t;
 
 typedef void (*ticker_event_handler)(uint32_t id);
@@ -48,7 +60,11 @@ typedef struct {
  */
 typedef struct {
     ticker_event_handler event_handler; /**< Event handler */
-    ticker_event_t *head;               /**< A pointer to head */
+    ticker_event_t *head;               /**< A pointer to head (the earliest event) */
+    volatile us_timestamp_t present_time; /**< 64-bit time at tick_last */
+    volatile timestamp_t tick_last;       /**< Counter value of the last update of present_time */
+    volatile uint32_t present_time_seq;   /**< Odd while present_time and tick_last are updated */
+    uint8_t tracking;                     /**< Whether the interrupt keeps present_time up to date */
 } ticker_event_queue_t;
 
 /** Ticker's data structure
@@ -96,6 +112,22 @@ void ticker_remove_event(const ticker_data_t *const data, ticker_event_t *obj);
  */
 void ticker_insert_event(const ticker_data_t *const data, ticker_event_t *obj, timestamp_t timestamp, uint32_t id);
 
+/** Insert an event to the queue, which may fire late to share an interrupt
+ *
+ * With hal.ticker-slack the interrupt is set to the earliest end of the
+ * windows [timestamp, timestamp + slack] of the events, and each event
+ * whose window has started fires in it, so events with overlapping windows
+ * take one interrupt. Without it, the slack is ignored.
+ *
+ * @param data      The ticker's data
+ * @param obj       The event object to be inserted to the queue
+ * @param timestamp The event's timestamp
+ * @param slack     Ticks the event may fire after timestamp, less than 2^30
+ * @param id        The event object
+ */
+void ticker_insert_event_slack(const ticker_data_t *const data, ticker_event_t *obj, timestamp_t timestamp,
+                               uint32_t slack, uint32_t id);
+
 /** Read the current ticker's timestamp
  *
  * @param data The ticker's data
@@ -103,7 +135,21 @@ void ticker_insert_event(const ticker_data_t *const data, ticker_event_t *obj, t
  */
 timestamp_t ticker_read(const ticker_data_t *const data);
 
+/** Read the current ticker's timestamp, extended to 64 bits
+ *
+ * The time does not wrap. It is extended in the ticker interrupt, which
+ * fires at least every 2^30 ticks once this is first called, so reads only
+ * sample the counter and do not lock.
+ *
+ * @param data The ticker's data
+ * @return The current timestamp
+ */
+us_timestamp_t ticker_read_us64(const ticker_data_t *const data);
+
 /** Read the next event's timestamp
+ *
+ * With hal.ticker-slack this is when the next interrupt is due, which can
+ * be after the earliest event's timestamp.
  *
  * @param data The ticker's data
  * @return 1 if timestamp is pending event, 0 if there's no event pending
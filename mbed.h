@@ -46,6 +46,8 @@
 #include "drivers/DigitalIn.h"
 #include "drivers/DigitalOut.h"
 #include "drivers/DigitalInOut.h"
+#include "drivers/FastDigitalIn.h"
+#include "drivers/FastDigitalOut.h"
 #include "drivers/BusIn.h"
 #include "drivers/BusOut.h"
 #include "drivers/BusInOut.h"
@@ -53,16 +55,20 @@
 #include "drivers/PortInOut.h"
 #include "drivers/PortOut.h"
 #include "drivers/AnalogIn.h"
+#include "drivers/AnalogInStream.h"
 #include "drivers/AnalogOut.h"
 #include "drivers/PwmOut.h"
 #include "drivers/Serial.h"
 #include "drivers/SPI.h"
 #include "drivers/SPISlave.h"
+#include "drivers/SPIBus.h"
+#include "drivers/FlashIAP.h"
 #include "drivers/I2C.h"
 #include "drivers/I2CSlave.h"
 #include "drivers/Ethernet.h"
 #include "drivers/CAN.h"
 #include "drivers/RawSerial.h"
+#include "drivers/BufferedSerial.h"
 
 // mbed Internal components
 #include "drivers/Timer.h"
@@ -76,6 +82,10 @@
 #include "platform/wait_api.h"
 #include "hal/sleep_api.h"
 #include "platform/rtc_time.h"
+#include "platform/mbed_sleep.h"
+#include "platform/DeepSleepLock.h"
+#include "platform/mbed_poll.h"
+#include "platform/mbed_clock.h"
 
 // mbed Non-hardware components
 #include "platform/Callback.h"
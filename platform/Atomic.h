@@ -0,0 +1,303 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_ATOMIC_H
+#define MBED_ATOMIC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "platform/critical.h"
+
+namespace mbed {
+/** \addtogroup platform */
+/** @{*/
+
+namespace internal {
+
+/* The core_util_atomic functions of each size */
+template <size_t Size>
+struct AtomicOps;
+
+#define MBED_ATOMIC_OPS(size, bits)                                                         \
+template <>                                                                             \
+struct AtomicOps<size> {                                                                \
+    typedef uint##bits##_t type;                                                        \
+    static type load(const type *p) { return core_util_atomic_load_u##bits(p); }        \
+    static void store(type *p, type v) { core_util_atomic_store_u##bits(p, v); }        \
+    static type exchange(type *p, type v) { return core_util_atomic_exchange_u##bits(p, v); } \
+    static bool cas(type *p, type *e, type v) { return core_util_atomic_cas_u##bits(p, e, v); } \
+    static type fetch_add(type *p, type v) { return core_util_atomic_fetch_add_u##bits(p, v); } \
+    static type fetch_sub(type *p, type v) { return core_util_atomic_fetch_sub_u##bits(p, v); } \
+    static type fetch_and(type *p, type v) { return core_util_atomic_fetch_and_u##bits(p, v); } \
+    static type fetch_or(type *p, type v) { return core_util_atomic_fetch_or_u##bits(p, v); } \
+    static type fetch_xor(type *p, type v) { return core_util_atomic_fetch_xor_u##bits(p, v); } \
+};
+
+MBED_ATOMIC_OPS(1, 8)
+MBED_ATOMIC_OPS(2, 16)
+MBED_ATOMIC_OPS(4, 32)
+MBED_ATOMIC_OPS(8, 64)
+
+#undef MBED_ATOMIC_OPS
+
+}
+
+/** Atomic integer of 8, 16, 32 or 64 bits, or atomic pointer
+ *
+ *  The operations follow std::atomic with sequentially consistent ordering,
+ *  except that load is an acquire and store a release. They build on the
+ *  core_util_atomic functions: exclusive access where the core has it, a
+ *  critical section on the Cortex-M0 and M0+ and for 64 bits.
+ *
+ *  @Note Synchronization level: Interrupt safe
+ *
+ *  Example:
+ *  @code
+ *  Atomic<uint32_t> events;
+ *
+ *  void irq() {
+ *      events |= EVENT_RX;
+ *  }
+ *
+ *  uint32_t take_events() {
+ *      return events.exchange(0);
+ *  }
+ *  @endcode
+ */
+template <typename T>
+class Atomic {
+    typedef internal::AtomicOps<sizeof(T)> Ops;
+    typedef typename Ops::type U;
+
+public:
+    /** Create an atomic with an initial value, not atomically
+     *
+     *  @param value    Initial value
+     */
+    Atomic(T value = T()) : _value((U)value) {
+    }
+
+    /** Read the value
+     *
+     *  @return         Current value
+     */
+    T load() const {
+        return (T)Ops::load(&_value);
+    }
+
+    /** Write the value
+     *
+     *  @param value    New value
+     */
+    void store(T value) {
+        Ops::store(&_value, (U)value);
+    }
+
+    /** Write the value and return the previous one
+     *
+     *  @param value    New value
+     *  @return         Previous value
+     */
+    T exchange(T value) {
+        return (T)Ops::exchange(&_value, (U)value);
+    }
+
+    /** Write the value if it is the expected one
+     *
+     *  @param expected Expected value, updated to the current value on
+     *                  failure
+     *  @param desired  New value
+     *  @return         true if the value was written
+     */
+    bool compare_exchange(T &expected, T desired) {
+        U current = (U)expected;
+        bool success = Ops::cas(&_value, &current, (U)desired);
+        expected = (T)current;
+        return success;
+    }
+
+    /** Add to the value
+     *
+     *  @return         Previous value
+     */
+    T fetch_add(T arg) {
+        return (T)Ops::fetch_add(&_value, (U)arg);
+    }
+
+    /** Subtract from the value
+     *
+     *  @return         Previous value
+     */
+    T fetch_sub(T arg) {
+        return (T)Ops::fetch_sub(&_value, (U)arg);
+    }
+
+    /** Bitwise and the value
+     *
+     *  @return         Previous value
+     */
+    T fetch_and(T arg) {
+        return (T)Ops::fetch_and(&_value, (U)arg);
+    }
+
+    /** Bitwise or the value
+     *
+     *  @return         Previous value
+     */
+    T fetch_or(T arg) {
+        return (T)Ops::fetch_or(&_value, (U)arg);
+    }
+
+    /** Bitwise exclusive or the value
+     *
+     *  @return         Previous value
+     */
+    T fetch_xor(T arg) {
+        return (T)Ops::fetch_xor(&_value, (U)arg);
+    }
+
+    operator T() const {
+        return load();
+    }
+
+    T operator=(T value) {
+        store(value);
+        return value;
+    }
+
+    T operator++() {
+        return fetch_add(1) + 1;
+    }
+
+    T operator++(int) {
+        return fetch_add(1);
+    }
+
+    T operator--() {
+        return fetch_sub(1) - 1;
+    }
+
+    T operator--(int) {
+        return fetch_sub(1);
+    }
+
+    T operator+=(T arg) {
+        return fetch_add(arg) + arg;
+    }
+
+    T operator-=(T arg) {
+        return fetch_sub(arg) - arg;
+    }
+
+    T operator&=(T arg) {
+        return fetch_and(arg) & arg;
+    }
+
+    T operator|=(T arg) {
+        return fetch_or(arg) | arg;
+    }
+
+    T operator^=(T arg) {
+        return fetch_xor(arg) ^ arg;
+    }
+
+private:
+    /* disallow copy constructor and assignment operators */
+    Atomic(const Atomic &);
+    Atomic &operator=(const Atomic &);
+
+    U _value;
+};
+
+/** Atomic pointer, arithmetic is in elements like for plain pointers
+ */
+template <typename T>
+class Atomic<T *> {
+public:
+    Atomic(T *value = NULL) : _value(value) {
+    }
+
+    T *load() const {
+        return (T *)core_util_atomic_load_ptr(&_value);
+    }
+
+    void store(T *value) {
+        core_util_atomic_store_ptr(&_value, value);
+    }
+
+    T *exchange(T *value) {
+        return (T *)core_util_atomic_exchange_ptr(&_value, value);
+    }
+
+    bool compare_exchange(T *&expected, T *desired) {
+        void *current = expected;
+        bool success = core_util_atomic_cas_ptr(&_value, &current, desired);
+        expected = (T *)current;
+        return success;
+    }
+
+    T *fetch_add(ptrdiff_t arg) {
+        return (T *)core_util_atomic_incr_ptr(&_value, arg * sizeof(T)) - arg;
+    }
+
+    T *fetch_sub(ptrdiff_t arg) {
+        return (T *)core_util_atomic_decr_ptr(&_value, arg * sizeof(T)) + arg;
+    }
+
+    operator T *() const {
+        return load();
+    }
+
+    T *operator=(T *value) {
+        store(value);
+        return value;
+    }
+
+    T *operator++() {
+        return fetch_add(1) + 1;
+    }
+
+    T *operator++(int) {
+        return fetch_add(1);
+    }
+
+    T *operator--() {
+        return fetch_sub(1) - 1;
+    }
+
+    T *operator--(int) {
+        return fetch_sub(1);
+    }
+
+    T *operator+=(ptrdiff_t arg) {
+        return fetch_add(arg) + arg;
+    }
+
+    T *operator-=(ptrdiff_t arg) {
+        return fetch_sub(arg) - arg;
+    }
+
+private:
+    /* disallow copy constructor and assignment operators */
+    Atomic(const Atomic &);
+    Atomic &operator=(const Atomic &);
+
+    void *_value;
+};
+
+/** @}*/
+}
+
+#endif
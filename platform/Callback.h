@@ -17,6 +17,7 @@
 #define MBED_CALLBACK_H
 
 #include <string.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <new>
 #include "platform/mbed_assert.h"
@@ -28,10 +29,27 @@ namespace mbed {
 
 
 /** Callback class based on template specialization
+ *
+ * Function objects of up to one word are stored in the Callback itself.
+ * Callback<Sig, Size> stores function objects of up to Size bytes more,
+ * such as functors with state, without storing them anywhere else. It
+ * is larger by Size rounded up to words. With a Size of at least
+ * sizeof(Callback<Sig>), a Callback<Sig> fits in it as a function object.
+ *
+ * @code
+ * struct Blink {
+ *     DigitalOut *led;
+ *     int count;
+ *     void operator()() { for (int i = 0; i < count; i++) *led = !*led; }
+ * };
+ *
+ * Blink blink = { &led, 4 };
+ * Callback<void(), sizeof(Blink)> cb(blink);
+ * @endcode
  *
  * @Note Synchronization level: Not protected
  */
-template <typename F>
+template <typename F, size_t Size = 0>
 class Callback;
 
 // Internal sfinae declarations
@@ -56,14 +74,27 @@ namespace detail {
     struct is_type {
         static const bool value = true;
     };
+
+    // Storage for the function objects of Callback<F, Size>, in front of
+    // the storage of Callback<F>
+    template <size_t Size>
+    struct callback_storage {
+        static const size_t size = Size;
+        uintptr_t _storage[(Size + sizeof(uintptr_t) - 1) / sizeof(uintptr_t)];
+    };
+
+    template <>
+    struct callback_storage<0> {
+        static const size_t size = 0;
+    };
 }
 
 /** Callback class based on template specialization
  *
  * @Note Synchronization level: Not protected
  */
-template <typename R>
-class Callback<R()> {
+template <typename R, size_t Size>
+class Callback<R(), Size> : private detail::callback_storage<Size> {
 public:
     /** Create a Callback with a static function
      *  @param func     Static function to attach
@@ -79,7 +110,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    Callback(const Callback<R()> &func) {
+    Callback(const Callback &func) {
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -192,48 +223,52 @@ public:
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)() const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)() volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)() const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
@@ -357,7 +392,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    void attach(const Callback<R()> &func) {
+    void attach(const Callback &func) {
         this->~Callback();
         new (this) Callback(func);
     }
@@ -480,12 +515,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -493,12 +529,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)() const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -506,12 +543,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)() volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -519,12 +557,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)() const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -768,8 +807,8 @@ private:
  *
  * @Note Synchronization level: Not protected
  */
-template <typename R, typename A0>
-class Callback<R(A0)> {
+template <typename R, typename A0, size_t Size>
+class Callback<R(A0), Size> : private detail::callback_storage<Size> {
 public:
     /** Create a Callback with a static function
      *  @param func     Static function to attach
@@ -785,7 +824,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    Callback(const Callback<R(A0)> &func) {
+    Callback(const Callback &func) {
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -898,48 +937,52 @@ public:
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
@@ -1063,7 +1106,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    void attach(const Callback<R(A0)> &func) {
+    void attach(const Callback &func) {
         this->~Callback();
         new (this) Callback(func);
     }
@@ -1186,12 +1229,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -1199,12 +1243,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -1212,12 +1257,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -1225,12 +1271,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -1474,8 +1521,8 @@ private:
  *
  * @Note Synchronization level: Not protected
  */
-template <typename R, typename A0, typename A1>
-class Callback<R(A0, A1)> {
+template <typename R, typename A0, typename A1, size_t Size>
+class Callback<R(A0, A1), Size> : private detail::callback_storage<Size> {
 public:
     /** Create a Callback with a static function
      *  @param func     Static function to attach
@@ -1491,7 +1538,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    Callback(const Callback<R(A0, A1)> &func) {
+    Callback(const Callback &func) {
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -1604,48 +1651,52 @@ public:
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
@@ -1769,7 +1820,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    void attach(const Callback<R(A0, A1)> &func) {
+    void attach(const Callback &func) {
         this->~Callback();
         new (this) Callback(func);
     }
@@ -1892,12 +1943,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -1905,12 +1957,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -1918,12 +1971,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -1931,12 +1985,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -2180,8 +2235,8 @@ private:
  *
  * @Note Synchronization level: Not protected
  */
-template <typename R, typename A0, typename A1, typename A2>
-class Callback<R(A0, A1, A2)> {
+template <typename R, typename A0, typename A1, typename A2, size_t Size>
+class Callback<R(A0, A1, A2), Size> : private detail::callback_storage<Size> {
 public:
     /** Create a Callback with a static function
      *  @param func     Static function to attach
@@ -2197,7 +2252,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    Callback(const Callback<R(A0, A1, A2)> &func) {
+    Callback(const Callback &func) {
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -2310,48 +2365,52 @@ public:
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
@@ -2475,7 +2534,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    void attach(const Callback<R(A0, A1, A2)> &func) {
+    void attach(const Callback &func) {
         this->~Callback();
         new (this) Callback(func);
     }
@@ -2598,12 +2657,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -2611,12 +2671,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -2624,12 +2685,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -2637,12 +2699,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -2886,8 +2949,8 @@ private:
  *
  * @Note Synchronization level: Not protected
  */
-template <typename R, typename A0, typename A1, typename A2, typename A3>
-class Callback<R(A0, A1, A2, A3)> {
+template <typename R, typename A0, typename A1, typename A2, typename A3, size_t Size>
+class Callback<R(A0, A1, A2, A3), Size> : private detail::callback_storage<Size> {
 public:
     /** Create a Callback with a static function
      *  @param func     Static function to attach
@@ -2903,7 +2966,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    Callback(const Callback<R(A0, A1, A2, A3)> &func) {
+    Callback(const Callback &func) {
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -3016,48 +3079,52 @@ public:
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
@@ -3181,7 +3248,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    void attach(const Callback<R(A0, A1, A2, A3)> &func) {
+    void attach(const Callback &func) {
         this->~Callback();
         new (this) Callback(func);
     }
@@ -3304,12 +3371,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -3317,12 +3385,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -3330,12 +3399,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -3343,12 +3413,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -3592,8 +3663,8 @@ private:
  *
  * @Note Synchronization level: Not protected
  */
-template <typename R, typename A0, typename A1, typename A2, typename A3, typename A4>
-class Callback<R(A0, A1, A2, A3, A4)> {
+template <typename R, typename A0, typename A1, typename A2, typename A3, typename A4, size_t Size>
+class Callback<R(A0, A1, A2, A3, A4), Size> : private detail::callback_storage<Size> {
 public:
     /** Create a Callback with a static function
      *  @param func     Static function to attach
@@ -3609,7 +3680,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    Callback(const Callback<R(A0, A1, A2, A3, A4)> &func) {
+    Callback(const Callback &func) {
         if (func._ops) {
             func._ops->move(this, &func);
         }
@@ -3722,48 +3793,52 @@ public:
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3, A4), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3, A4) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3, A4) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
 
     /** Create a Callback with a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     Callback(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3, A4) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         generate(f);
     }
@@ -3887,7 +3962,7 @@ public:
     /** Attach a Callback
      *  @param func     The Callback to attach
      */
-    void attach(const Callback<R(A0, A1, A2, A3, A4)> &func) {
+    void attach(const Callback &func) {
         this->~Callback();
         new (this) Callback(func);
     }
@@ -4010,12 +4085,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3, A4), &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -4023,12 +4099,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3, A4) const, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -4036,12 +4113,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3, A4) volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
@@ -4049,12 +4127,13 @@ public:
 
     /** Attach a function object
      *  @param func     Function object to attach
-     *  @note The function object is limited to a single word of storage
+     *  @note The function object is limited to a single word of storage,
+     *        plus Size bytes
      */
     template <typename F>
     void attach(const volatile F f, typename detail::enable_if<
                 detail::is_type<R (F::*)(A0, A1, A2, A3, A4) const volatile, &F::operator()>::value &&
-                sizeof(F) <= sizeof(uintptr_t)
+                sizeof(F) <= sizeof(uintptr_t) + detail::callback_storage<Size>::size
             >::type = detail::nil()) {
         this->~Callback();
         new (this) Callback(f);
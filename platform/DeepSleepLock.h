@@ -0,0 +1,96 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_DEEPSLEEPLOCK_H
+#define MBED_DEEPSLEEPLOCK_H
+
+#include <stdint.h>
+#include "platform/mbed_sleep.h"
+#include "platform/critical.h"
+#include "platform/mbed_error.h"
+
+namespace mbed {
+/** \addtogroup platform */
+/** @{*/
+
+/** The deep sleep lock of a driver
+ *
+ * Each lock() takes the sleep manager lock the first time and counts the
+ * nested ones, so a driver can lock from several places, interrupts
+ * included, and the lock it still holds is released when it is destroyed.
+ * Does nothing on targets without DEVICE_SLEEP.
+ *
+ * @Note Synchronization level: Interrupt safe
+ */
+class DeepSleepLock {
+public:
+    DeepSleepLock() : _count(0) {
+    }
+
+    ~DeepSleepLock() {
+#if DEVICE_SLEEP
+        if (_count) {
+            sleep_manager_unlock_deep_sleep();
+        }
+#endif
+    }
+
+    /** Lock deep sleep, nested locks are counted
+     */
+    void lock() {
+        uint16_t count = core_util_atomic_incr_u16(&_count, 1);
+        if (count == 0) {
+            error("DeepSleepLock overflow");
+        }
+#if DEVICE_SLEEP
+        if (count == 1) {
+            sleep_manager_lock_deep_sleep();
+        }
+#endif
+    }
+
+    /** Unlock deep sleep, once each lock() is undone
+     */
+    void unlock() {
+        uint16_t count = core_util_atomic_decr_u16(&_count, 1);
+        if (count == 0xFFFF) {
+            error("DeepSleepLock underflow");
+        }
+#if DEVICE_SLEEP
+        if (count == 0) {
+            sleep_manager_unlock_deep_sleep();
+        }
+#endif
+    }
+
+    /** Check if the lock is held
+     */
+    bool locked() const {
+        return _count != 0;
+    }
+
+private:
+    uint16_t _count;
+
+    /* disallow copy constructor and assignment operators */
+    DeepSleepLock(const DeepSleepLock&);
+    DeepSleepLock & operator = (const DeepSleepLock&);
+};
+
+/** @}*/
+
+} // namespace mbed
+
+#endif
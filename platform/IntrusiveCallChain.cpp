@@ -0,0 +1,143 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/IntrusiveCallChain.h"
+#include "platform/critical.h"
+#include "platform/mbed_assert.h"
+
+namespace mbed {
+
+void IntrusiveCallChain::add(CallChainEntry *entry) {
+    core_util_critical_section_enter();
+    MBED_ASSERT(entry->_chain == NULL);
+    entry->_next = NULL;
+    entry->_prev = _tail;
+    entry->_chain = this;
+    if (_tail) {
+        _tail->_next = entry;
+    } else {
+        _head = entry;
+    }
+    _tail = entry;
+    core_util_critical_section_exit();
+}
+
+void IntrusiveCallChain::add_front(CallChainEntry *entry) {
+    core_util_critical_section_enter();
+    MBED_ASSERT(entry->_chain == NULL);
+    entry->_next = _head;
+    entry->_prev = NULL;
+    entry->_chain = this;
+    if (_head) {
+        _head->_prev = entry;
+    } else {
+        _tail = entry;
+    }
+    _head = entry;
+    core_util_critical_section_exit();
+}
+
+bool IntrusiveCallChain::remove(CallChainEntry *entry) {
+    core_util_critical_section_enter();
+    if (entry->_chain != this) {
+        core_util_critical_section_exit();
+        return false;
+    }
+    if (entry->_prev) {
+        entry->_prev->_next = entry->_next;
+    } else {
+        _head = entry->_next;
+    }
+    if (entry->_next) {
+        entry->_next->_prev = entry->_prev;
+    } else {
+        _tail = entry->_prev;
+    }
+    for (Cursor *cursor = _cursors; cursor; cursor = cursor->link) {
+        if (cursor->next == entry) {
+            // A call in progress goes on with the rest of the chain
+            cursor->next = entry->_next;
+        }
+    }
+    entry->_next = NULL;
+    entry->_prev = NULL;
+    entry->_chain = NULL;
+    core_util_critical_section_exit();
+    return true;
+}
+
+CallChainEntry *IntrusiveCallChain::find(const Callback<void()> *func) const {
+    core_util_critical_section_enter();
+    CallChainEntry *entry = _head;
+    while (entry && &entry->_func != func) {
+        entry = entry->_next;
+    }
+    core_util_critical_section_exit();
+    return entry;
+}
+
+void IntrusiveCallChain::clear() {
+    core_util_critical_section_enter();
+    CallChainEntry *entry = _head;
+    while (entry) {
+        CallChainEntry *next = entry->_next;
+        entry->_next = NULL;
+        entry->_prev = NULL;
+        entry->_chain = NULL;
+        entry = next;
+    }
+    _head = NULL;
+    _tail = NULL;
+    for (Cursor *cursor = _cursors; cursor; cursor = cursor->link) {
+        cursor->next = NULL;
+    }
+    core_util_critical_section_exit();
+}
+
+void IntrusiveCallChain::call() {
+    Cursor cursor;
+
+    core_util_critical_section_enter();
+    CallChainEntry *entry = _head;
+    cursor.link = _cursors;
+    _cursors = &cursor;
+    core_util_critical_section_exit();
+
+    while (entry) {
+        // The next entry is followed by remove while the function runs
+        core_util_critical_section_enter();
+        cursor.next = entry->_next;
+        core_util_critical_section_exit();
+
+        if (entry->_func) {
+            entry->_func.call();
+        }
+
+        core_util_critical_section_enter();
+        entry = cursor.next;
+        core_util_critical_section_exit();
+    }
+
+    // Calls from other threads may end in any order
+    core_util_critical_section_enter();
+    Cursor **p = &_cursors;
+    while (*p != &cursor) {
+        p = &(*p)->link;
+    }
+    *p = cursor.link;
+    core_util_critical_section_exit();
+}
+
+} // namespace mbed
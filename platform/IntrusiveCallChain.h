@@ -0,0 +1,197 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_INTRUSIVECALLCHAIN_H
+#define MBED_INTRUSIVECALLCHAIN_H
+
+#include "platform/Callback.h"
+#include <stddef.h>
+
+namespace mbed {
+/** \addtogroup platform */
+/** @{*/
+
+class IntrusiveCallChain;
+
+/** Function of an IntrusiveCallChain
+ *
+ * The entry is the link of the chain, kept by the caller as a member of
+ * its own object or as a static, so the chain never allocates. An entry is
+ * in at most one chain at a time, and must be removed before it is
+ * destroyed.
+ *
+ * @Note Synchronization level: Interrupt safe
+ */
+class CallChainEntry {
+public:
+    /** Create an entry
+     *
+     *  @param func Function called by the chain
+     */
+    CallChainEntry(Callback<void()> func = 0) : _func(func), _next(NULL), _prev(NULL), _chain(NULL) {
+    }
+
+    /** Set the function, while the entry is not in a chain
+     *
+     *  @param func Function called by the chain
+     */
+    void attach(Callback<void()> func) {
+        _func = func;
+    }
+
+    /** Get the function
+     *
+     *  @return Function called by the chain
+     */
+    Callback<void()> *get_callback() {
+        return &_func;
+    }
+
+    /** Get the chain the entry is in
+     *
+     *  @return Chain, NULL if none
+     */
+    IntrusiveCallChain *get_chain() const {
+        return _chain;
+    }
+
+private:
+    friend class IntrusiveCallChain;
+
+    Callback<void()> _func;
+    CallChainEntry *volatile _next;
+    CallChainEntry *_prev;
+    IntrusiveCallChain *volatile _chain;
+
+    /* disallow copy constructor and assignment operators */
+    CallChainEntry(const CallChainEntry&);
+    CallChainEntry & operator = (const CallChainEntry&);
+};
+
+/** Chain of functions linked through entries the caller provides
+ *
+ * Unlike CallChain, adding and removing never allocate and take constant
+ * time, and the functions can be added, removed and called from threads
+ * and interrupts alike. A function may remove itself or any other entry
+ * while the chain is being called; an entry added meanwhile may or may not
+ * be called this time. The chain is called from one context at a time,
+ * such as the handler of one interrupt.
+ *
+ * The chain is zero initialized, so it can be a static without a
+ * constructor call.
+ *
+ * @Note Synchronization level: Interrupt safe
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ * #include "IntrusiveCallChain.h"
+ *
+ * class Led {
+ * public:
+ *     Led(PinName pin, IntrusiveCallChain *chain)
+ *         : _out(pin), _toggle(callback(this, &Led::toggle)) {
+ *         chain->add(&_toggle);
+ *     }
+ *
+ * private:
+ *     void toggle() { _out = !_out; }
+ *
+ *     DigitalOut _out;
+ *     CallChainEntry _toggle;
+ * };
+ *
+ * IntrusiveCallChain chain;
+ * Led led1(LED1, &chain);
+ * Led led2(LED2, &chain);
+ *
+ * int main() {
+ *     chain.call();
+ * }
+ * @endcode
+ */
+class IntrusiveCallChain {
+public:
+    /** Create an empty chain
+     */
+    IntrusiveCallChain() : _head(NULL), _tail(NULL), _cursors(NULL) {
+    }
+
+    /** Add an entry at the end of the chain
+     *
+     *  @param entry Entry not in a chain
+     */
+    void add(CallChainEntry *entry);
+
+    /** Add an entry at the beginning of the chain
+     *
+     *  @param entry Entry not in a chain
+     */
+    void add_front(CallChainEntry *entry);
+
+    /** Remove an entry from the chain
+     *
+     *  @param entry Entry to remove
+     *  @return true if the entry was in the chain
+     */
+    bool remove(CallChainEntry *entry);
+
+    /** Find the entry of a function
+     *
+     *  @param func Function as returned by CallChainEntry::get_callback
+     *  @return Entry of the function, NULL if it is not in the chain
+     */
+    CallChainEntry *find(const Callback<void()> *func) const;
+
+    /** Remove all entries from the chain
+     */
+    void clear();
+
+    /** Test if the chain has no entries
+     */
+    bool empty() const {
+        return _head == NULL;
+    }
+
+    /** Call the functions of the chain in order
+     */
+    void call();
+
+    void operator ()(void) {
+        call();
+    }
+
+private:
+    // A call in progress, each call has its own so that calls made from
+    // the functions or from interrupts do not disturb each other
+    struct Cursor {
+        CallChainEntry *volatile next;
+        Cursor *link;
+    };
+
+    CallChainEntry *volatile _head;
+    CallChainEntry *_tail;
+    // Calls in progress, whose next entry remove and clear update
+    Cursor *_cursors;
+
+    /* disallow copy constructor and assignment operators */
+    IntrusiveCallChain(const IntrusiveCallChain&);
+    IntrusiveCallChain & operator = (const IntrusiveCallChain&);
+};
+
+/** @}*/
+} // namespace mbed
+
+#endif
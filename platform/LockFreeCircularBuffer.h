@@ -0,0 +1,320 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_LOCKFREECIRCULARBUFFER_H
+#define MBED_LOCKFREECIRCULARBUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "platform/critical.h"
+#include "platform/toolchain.h"
+
+namespace mbed {
+/** \addtogroup platform */
+/** @{*/
+
+/** Templated single-producer, single-consumer circular buffer
+ *
+ *  Unlike CircularBuffer, push and pop never disable interrupts. Exactly
+ *  one context (a thread or an interrupt handler) may push and exactly one
+ *  context may pop. Since the producer never touches the read position,
+ *  push fails when the buffer is full instead of overwriting the oldest
+ *  element.
+ *
+ *  @Note Synchronization level: Interrupt safe for one producer and one consumer
+ */
+template<typename T, uint32_t BufferSize>
+class SPSCCircularBuffer {
+public:
+    SPSCCircularBuffer() : _head(0), _tail(0) {
+    }
+
+    ~SPSCCircularBuffer() {
+    }
+
+    /** Push an element to the buffer
+     *
+     * @param data Data to be pushed to the buffer
+     * @return True if the data was pushed, false if the buffer is full
+     */
+    bool push(const T& data) {
+        return push(&data, 1) == 1;
+    }
+
+    /** Push several elements to the buffer
+     *
+     * @param data  Array of elements to be pushed to the buffer
+     * @param count Number of elements in the array
+     * @return Number of elements pushed, which is less than count when the buffer fills
+     */
+    size_t push(const T *data, size_t count) {
+        uint32_t head = _head;
+        size_t space = BufferSize - used(head, _tail);
+        if (count > space) {
+            count = space;
+        }
+        for (size_t i = 0; i < count; i++) {
+            _pool[index(head)] = data[i];
+            head = advance(head);
+        }
+
+        // publish the elements only after they have been written
+        MBED_COMPILER_BARRIER();
+        _head = head;
+        return count;
+    }
+
+    /** Pop an element from the buffer
+     *
+     * @param data Data popped from the buffer
+     * @return True if the buffer is not empty and data contains an element, false otherwise
+     */
+    bool pop(T& data) {
+        return pop(&data, 1) == 1;
+    }
+
+    /** Pop several elements from the buffer
+     *
+     * @param data  Array the elements are popped into
+     * @param count Maximum number of elements to pop
+     * @return Number of elements popped
+     */
+    size_t pop(T *data, size_t count) {
+        uint32_t tail = _tail;
+        size_t available = used(_head, tail);
+        if (count > available) {
+            count = available;
+        }
+
+        // do not read elements before we have seen them published
+        MBED_COMPILER_BARRIER();
+        for (size_t i = 0; i < count; i++) {
+            data[i] = _pool[index(tail)];
+            tail = advance(tail);
+        }
+
+        // release the slots only after the elements have been copied out
+        MBED_COMPILER_BARRIER();
+        _tail = tail;
+        return count;
+    }
+
+    /** Check if the buffer is empty
+     *
+     * @return True if the buffer is empty, false if not
+     */
+    bool empty() const {
+        return _head == _tail;
+    }
+
+    /** Check if the buffer is full
+     *
+     * @return True if the buffer is full, false if not
+     */
+    bool full() const {
+        return used(_head, _tail) == BufferSize;
+    }
+
+    /** Number of elements in the buffer
+     *
+     * @return Number of elements that can currently be popped
+     */
+    size_t size() const {
+        return used(_head, _tail);
+    }
+
+    /** Reset the buffer
+     *
+     *  @note Must not be called while the producer or consumer are active
+     */
+    void reset() {
+        _head = 0;
+        _tail = 0;
+    }
+
+private:
+    /* Positions run over [0, 2 * BufferSize) so a full buffer can be told
+     * apart from an empty one without a separate flag, and the buffer size
+     * does not need to be a power of two. */
+    static uint32_t index(uint32_t pos) {
+        return pos < BufferSize ? pos : pos - BufferSize;
+    }
+
+    static uint32_t advance(uint32_t pos) {
+        return pos + 1 < 2 * BufferSize ? pos + 1 : 0;
+    }
+
+    static uint32_t used(uint32_t head, uint32_t tail) {
+        return head >= tail ? head - tail : head + 2 * BufferSize - tail;
+    }
+
+    T _pool[BufferSize];
+    volatile uint32_t _head;
+    volatile uint32_t _tail;
+};
+
+/** Templated multi-producer, single-consumer circular buffer
+ *
+ *  Producers in any number of threads and interrupt handlers may push
+ *  concurrently; slots are claimed with core_util_atomic_cas_u32, so
+ *  interrupts are only masked on cores without LDREX/STREX. A single
+ *  context may pop. A producer that is preempted between claiming and
+ *  filling a slot makes the buffer appear empty to the consumer from that
+ *  slot on until the producer resumes; nothing ever spins waiting for it.
+ *
+ *  BufferSize must be a power of two, and at least 2.
+ *
+ *  @Note Synchronization level: Interrupt safe for any producers and one consumer
+ */
+template<typename T, uint32_t BufferSize>
+class MPSCCircularBuffer {
+public:
+    MPSCCircularBuffer() {
+        reset();
+    }
+
+    ~MPSCCircularBuffer() {
+    }
+
+    /** Push an element to the buffer
+     *
+     * @param data Data to be pushed to the buffer
+     * @return True if the data was pushed, false if the buffer is full
+     */
+    bool push(const T& data) {
+        uint32_t pos = _enqueue_pos;
+        while (true) {
+            Cell &cell = _pool[pos & (BufferSize - 1)];
+            int32_t diff = (int32_t)(cell.sequence - pos);
+            if (diff == 0) {
+                if (core_util_atomic_cas_u32((uint32_t *)&_enqueue_pos, &pos, pos + 1)) {
+                    cell.data = data;
+                    MBED_COMPILER_BARRIER();
+                    cell.sequence = pos + 1;
+                    return true;
+                }
+                // pos was reloaded by the failed compare-and-swap
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueue_pos;
+            }
+        }
+    }
+
+    /** Push several elements to the buffer
+     *
+     *  Elements are claimed one at a time, so pushes from other producers
+     *  may be interleaved with them.
+     *
+     * @param data  Array of elements to be pushed to the buffer
+     * @param count Number of elements in the array
+     * @return Number of elements pushed, which is less than count when the buffer fills
+     */
+    size_t push(const T *data, size_t count) {
+        size_t pushed = 0;
+        while (pushed < count && push(data[pushed])) {
+            pushed++;
+        }
+        return pushed;
+    }
+
+    /** Pop an element from the buffer
+     *
+     * @param data Data popped from the buffer
+     * @return True if the buffer is not empty and data contains an element, false otherwise
+     */
+    bool pop(T& data) {
+        uint32_t pos = _dequeue_pos;
+        Cell &cell = _pool[pos & (BufferSize - 1)];
+        if (cell.sequence != pos + 1) {
+            return false;
+        }
+
+        MBED_COMPILER_BARRIER();
+        data = cell.data;
+        MBED_COMPILER_BARRIER();
+        cell.sequence = pos + BufferSize;
+        _dequeue_pos = pos + 1;
+        return true;
+    }
+
+    /** Pop several elements from the buffer
+     *
+     * @param data  Array the elements are popped into
+     * @param count Maximum number of elements to pop
+     * @return Number of elements popped
+     */
+    size_t pop(T *data, size_t count) {
+        size_t popped = 0;
+        while (popped < count && pop(data[popped])) {
+            popped++;
+        }
+        return popped;
+    }
+
+    /** Check if the buffer is empty
+     *
+     * @return True if there is no element ready to be popped, false if not
+     */
+    bool empty() const {
+        uint32_t pos = _dequeue_pos;
+        return _pool[pos & (BufferSize - 1)].sequence != pos + 1;
+    }
+
+    /** Check if the buffer is full
+     *
+     * @return True if the buffer is full, false if not
+     */
+    bool full() const {
+        uint32_t pos = _enqueue_pos;
+        return (int32_t)(_pool[pos & (BufferSize - 1)].sequence - pos) < 0;
+    }
+
+    /** Reset the buffer
+     *
+     *  @note Must not be called while any producer or the consumer are active
+     */
+    void reset() {
+        for (uint32_t i = 0; i < BufferSize; i++) {
+            _pool[i].sequence = i;
+        }
+        _enqueue_pos = 0;
+        _dequeue_pos = 0;
+    }
+
+private:
+    // fails to compile unless BufferSize is a power of two of at least 2
+    typedef char buffer_size_must_be_power_of_two[
+            (BufferSize >= 2 && (BufferSize & (BufferSize - 1)) == 0) ? 1 : -1];
+
+    /* Each cell's sequence tells which position may use it next: a producer
+     * may fill it when sequence == pos, the consumer may read it when
+     * sequence == pos + 1. */
+    struct Cell {
+        volatile uint32_t sequence;
+        T data;
+    };
+
+    Cell _pool[BufferSize];
+    volatile uint32_t _enqueue_pos;
+    volatile uint32_t _dequeue_pos;
+};
+
+}
+
+#endif
+
+/** @}*/
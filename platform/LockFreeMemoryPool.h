@@ -0,0 +1,189 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_LOCKFREEMEMORYPOOL_H
+#define MBED_LOCKFREEMEMORYPOOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "cmsis.h"
+#include "platform/critical.h"
+
+namespace mbed {
+/** \addtogroup platform */
+/** @{*/
+
+/** Templated pool of fixed-size blocks with lock-free allocation
+ *
+ *  Unlike rtos::MemoryPool, alloc and free do not enter the kernel. The
+ *  free blocks form a stack that is popped and pushed with LDREX/STREX.
+ *  Every exception entry and every other STREX to the stack clears the
+ *  exclusive monitor, so a pop that was interrupted retries instead of
+ *  linking a block that was taken in the meantime. On cores without
+ *  LDREX/STREX interrupts are masked for the few instructions instead.
+ *
+ *  Blocks are 8 byte aligned raw memory, no constructors or destructors
+ *  are run, as with rtos::MemoryPool.
+ *
+ *  @Note Synchronization level: Interrupt safe
+ */
+template<typename T, uint32_t pool_sz>
+class LockFreeMemoryPool {
+public:
+    LockFreeMemoryPool() : _in_use(0), _peak(0), _failures(0) {
+        for (uint32_t i = 0; i + 1 < pool_sz; i++) {
+            _pool[i].next = &_pool[i + 1];
+        }
+        _pool[pool_sz - 1].next = NULL;
+        _free = &_pool[0];
+    }
+
+    ~LockFreeMemoryPool() {
+    }
+
+    /** Allocate a block
+     *
+     * @return Address of the block, NULL if the pool is exhausted
+     */
+    T *alloc() {
+        Block *block = pop();
+        if (block == NULL) {
+            core_util_atomic_incr_u32(&_failures, 1);
+            return NULL;
+        }
+
+        uint32_t in_use = core_util_atomic_incr_u32(&_in_use, 1);
+        uint32_t peak = _peak;
+        while (in_use > peak && !core_util_atomic_cas_u32(&_peak, &peak, in_use)) {
+        }
+
+        return reinterpret_cast<T*>(block->data);
+    }
+
+    /** Allocate a block and set it to zero
+     *
+     * @return Address of the block, NULL if the pool is exhausted
+     */
+    T *calloc() {
+        T *item = alloc();
+        if (item != NULL) {
+            memset(item, 0, sizeof(T));
+        }
+        return item;
+    }
+
+    /** Free a block
+     *
+     * @param item Block returned by alloc or calloc of this pool
+     * @return True if the block was freed, false if it is not a block of this pool
+     */
+    bool free(T *item) {
+        uintptr_t offset = (uintptr_t)item - (uintptr_t)_pool;
+        if ((uintptr_t)item < (uintptr_t)_pool || offset >= sizeof(_pool) ||
+                offset % sizeof(Block) != 0) {
+            return false;
+        }
+
+        push(reinterpret_cast<Block*>(item));
+        core_util_atomic_decr_u32(&_in_use, 1);
+        return true;
+    }
+
+    /** Number of blocks allocated
+     *
+     * @return Blocks currently allocated
+     */
+    uint32_t in_use() const {
+        return _in_use;
+    }
+
+    /** Largest number of blocks allocated at a time
+     *
+     * @return Peak of in_use since the pool was created
+     */
+    uint32_t peak() const {
+        return _peak;
+    }
+
+    /** Number of failed allocations
+     *
+     * @return Allocations that found the pool exhausted
+     */
+    uint32_t failures() const {
+        return _failures;
+    }
+
+private:
+    union Block {
+        Block *next;
+        uint64_t align;
+        unsigned char data[sizeof(T)];
+    };
+
+#if !defined(__CORTEX_M0) && !defined(__CORTEX_M0PLUS)
+    Block *pop() {
+        Block *block;
+        do {
+            block = (Block*)__LDREXW((volatile uint32_t*)&_free);
+            if (block == NULL) {
+                __CLREX();
+                return NULL;
+            }
+            // a stale next is never stored, the STREX fails
+        } while (__STREXW((uint32_t)block->next, (volatile uint32_t*)&_free));
+        return block;
+    }
+
+    void push(Block *block) {
+        do {
+            block->next = (Block*)__LDREXW((volatile uint32_t*)&_free);
+        } while (__STREXW((uint32_t)block, (volatile uint32_t*)&_free));
+    }
+#else
+    Block *pop() {
+        core_util_critical_section_enter();
+        Block *block = _free;
+        if (block != NULL) {
+            _free = block->next;
+        }
+        core_util_critical_section_exit();
+        return block;
+    }
+
+    void push(Block *block) {
+        core_util_critical_section_enter();
+        block->next = _free;
+        _free = block;
+        core_util_critical_section_exit();
+    }
+#endif
+
+    Block _pool[pool_sz];
+    Block *volatile _free;
+    uint32_t _in_use;
+    uint32_t _peak;
+    uint32_t _failures;
+
+    /* disallow copy constructor and assignment operators */
+    LockFreeMemoryPool(const LockFreeMemoryPool &);
+    LockFreeMemoryPool &operator=(const LockFreeMemoryPool &);
+};
+
+}
+
+#endif
+
+/** @}*/
@@ -36,13 +36,16 @@ typedef struct {
 } transaction_t;
 
 /** Transaction class defines a transaction.
+ *
+ * The transaction data defaults to transaction_t, peripherals needing more
+ * fields per transaction give their own type.
  *
  * @Note Synchronization level: Not protected
  */
-template<typename Class>
+template<typename Class, typename Data = transaction_t>
 class Transaction {
 public:
-    Transaction(Class *tpointer, const transaction_t& transaction) : _obj(tpointer), _data(transaction) {
+    Transaction(Class *tpointer, const Data& transaction) : _obj(tpointer), _data(transaction) {
     }
 
     Transaction() : _obj(), _data() {
@@ -63,13 +66,13 @@ public:
      *
      * @return The transaction which was stored
      */
-    transaction_t* get_transaction() {
+    Data* get_transaction() {
         return &_data;
     }
 
 private:
     Class* _obj;
-    transaction_t _data;
+    Data _data;
 };
 
 }
@@ -67,6 +67,38 @@ void core_util_critical_section_enter(void);
   */
 void core_util_critical_section_exit(void);
 
+/** Mark the start of a section masked against normal priority interrupts
+  *
+  * This function should be called to mark the start of a section of code that only needs
+  * protection from the interrupts of the drivers and the RTOS, not from time-critical interrupts.
+  * \note
+  * NOTES:
+  * 1) With the platform.irq-mask-priority option on Cortex-M3, M4 and M7, the interrupts of
+  *    that priority and below are masked with BASEPRI. The interrupts of higher priority (lower
+  *    number) keep running and must not use mbed APIs.
+  * 2) Before main, the device interrupts still at priority 0 are moved to the option's priority,
+  *    enabled or not, so time-critical interrupts are set with NVIC_SetPriority in main. Interrupts
+  *    that a target driver sets to a higher priority itself, such as the STM asynchronous serial
+  *    and DMA interrupts, are not masked, so the drivers sharing data with them keep using
+  *    critical sections.
+  * 3) Without the option or BASEPRI, it is core_util_critical_section_enter.
+  * 4) These sections can be nested, with each other and with critical sections.
+  * @return State to pass to core_util_irq_mask_exit
+  */
+uint32_t core_util_irq_mask_enter(void);
+
+/** Mark the end of a section masked against normal priority interrupts
+  *
+  * @param state Value returned by the matching core_util_irq_mask_enter
+  */
+void core_util_irq_mask_exit(uint32_t state);
+
+/** Move the device interrupts still at priority 0 to the platform.irq-mask-priority option
+  *
+  * Called before main, does nothing without the option.
+  */
+void core_util_irq_mask_init(void);
+
 /**
  * Atomic compare and set. It compares the contents of a memory location to a
  * given value and, only if they are the same, modifies the contents of that
@@ -349,6 +381,303 @@ uint32_t core_util_atomic_decr_u32(uint32_t *valuePtr, uint32_t delta);
  */
 void *core_util_atomic_decr_ptr(void **valuePtr, ptrdiff_t delta);
 
+/* The functions below are full barriers, except that a load is an acquire
+ * and a store a release. On cores without exclusive access, such as the
+ * Cortex-M0 and M0+, the 8, 16 and 32 bit read-modify-write functions use a
+ * critical section, their loads and stores do not. The 64 bit functions use
+ * a critical section on every core. */
+
+/**
+ * Atomic compare and set, see core_util_atomic_cas_u32.
+ */
+bool core_util_atomic_cas_u64(uint64_t *ptr, uint64_t *expectedCurrentValue, uint64_t desiredValue);
+
+/**
+ * Atomic increment.
+ * @param  valuePtr Target memory location being incremented.
+ * @param  delta    The amount being incremented.
+ * @return          The new incremented value.
+ */
+uint64_t core_util_atomic_incr_u64(uint64_t *valuePtr, uint64_t delta);
+
+/**
+ * Atomic decrement.
+ * @param  valuePtr Target memory location being decremented.
+ * @param  delta    The amount being decremented.
+ * @return          The new decremented value.
+ */
+uint64_t core_util_atomic_decr_u64(uint64_t *valuePtr, uint64_t delta);
+
+/**
+ * Atomic load with acquire ordering.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded value.
+ */
+uint8_t core_util_atomic_load_u8(const uint8_t *valuePtr);
+
+/**
+ * Atomic load with acquire ordering.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded value.
+ */
+uint16_t core_util_atomic_load_u16(const uint16_t *valuePtr);
+
+/**
+ * Atomic load with acquire ordering.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded value.
+ */
+uint32_t core_util_atomic_load_u32(const uint32_t *valuePtr);
+
+/**
+ * Atomic load with acquire ordering.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded value.
+ */
+uint64_t core_util_atomic_load_u64(const uint64_t *valuePtr);
+
+/**
+ * Atomic store with release ordering.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ */
+void core_util_atomic_store_u8(uint8_t *valuePtr, uint8_t desiredValue);
+
+/**
+ * Atomic store with release ordering.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ */
+void core_util_atomic_store_u16(uint16_t *valuePtr, uint16_t desiredValue);
+
+/**
+ * Atomic store with release ordering.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ */
+void core_util_atomic_store_u32(uint32_t *valuePtr, uint32_t desiredValue);
+
+/**
+ * Atomic store with release ordering.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ */
+void core_util_atomic_store_u64(uint64_t *valuePtr, uint64_t desiredValue);
+
+/**
+ * Atomic exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ * @return              The previous value.
+ */
+uint8_t core_util_atomic_exchange_u8(uint8_t *valuePtr, uint8_t desiredValue);
+
+/**
+ * Atomic exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ * @return              The previous value.
+ */
+uint16_t core_util_atomic_exchange_u16(uint16_t *valuePtr, uint16_t desiredValue);
+
+/**
+ * Atomic exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ * @return              The previous value.
+ */
+uint32_t core_util_atomic_exchange_u32(uint32_t *valuePtr, uint32_t desiredValue);
+
+/**
+ * Atomic exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The value to store.
+ * @return              The previous value.
+ */
+uint64_t core_util_atomic_exchange_u64(uint64_t *valuePtr, uint64_t desiredValue);
+
+/**
+ * Atomic add.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The amount being added.
+ * @return          The previous value.
+ */
+uint8_t core_util_atomic_fetch_add_u8(uint8_t *valuePtr, uint8_t arg);
+
+/**
+ * Atomic add.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The amount being added.
+ * @return          The previous value.
+ */
+uint16_t core_util_atomic_fetch_add_u16(uint16_t *valuePtr, uint16_t arg);
+
+/**
+ * Atomic add.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The amount being added.
+ * @return          The previous value.
+ */
+uint32_t core_util_atomic_fetch_add_u32(uint32_t *valuePtr, uint32_t arg);
+
+/**
+ * Atomic add.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The amount being added.
+ * @return          The previous value.
+ */
+uint64_t core_util_atomic_fetch_add_u64(uint64_t *valuePtr, uint64_t arg);
+
+/**
+ * Atomic subtract.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The amount being subtracted.
+ * @return          The previous value.
+ */
+uint8_t core_util_atomic_fetch_sub_u8(uint8_t *valuePtr, uint8_t arg);
+
+/**
+ * Atomic subtract.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The amount being subtracted.
+ * @return          The previous value.
+ */
+uint16_t core_util_atomic_fetch_sub_u16(uint16_t *valuePtr, uint16_t arg);
+
+/**
+ * Atomic subtract.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The amount being subtracted.
+ * @return          The previous value.
+ */
+uint32_t core_util_atomic_fetch_sub_u32(uint32_t *valuePtr, uint32_t arg);
+
+/**
+ * Atomic subtract.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The amount being subtracted.
+ * @return          The previous value.
+ */
+uint64_t core_util_atomic_fetch_sub_u64(uint64_t *valuePtr, uint64_t arg);
+
+/**
+ * Atomic bitwise and.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being kept.
+ * @return          The previous value.
+ */
+uint8_t core_util_atomic_fetch_and_u8(uint8_t *valuePtr, uint8_t arg);
+
+/**
+ * Atomic bitwise and.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being kept.
+ * @return          The previous value.
+ */
+uint16_t core_util_atomic_fetch_and_u16(uint16_t *valuePtr, uint16_t arg);
+
+/**
+ * Atomic bitwise and.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being kept.
+ * @return          The previous value.
+ */
+uint32_t core_util_atomic_fetch_and_u32(uint32_t *valuePtr, uint32_t arg);
+
+/**
+ * Atomic bitwise and.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being kept.
+ * @return          The previous value.
+ */
+uint64_t core_util_atomic_fetch_and_u64(uint64_t *valuePtr, uint64_t arg);
+
+/**
+ * Atomic bitwise or.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being set.
+ * @return          The previous value.
+ */
+uint8_t core_util_atomic_fetch_or_u8(uint8_t *valuePtr, uint8_t arg);
+
+/**
+ * Atomic bitwise or.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being set.
+ * @return          The previous value.
+ */
+uint16_t core_util_atomic_fetch_or_u16(uint16_t *valuePtr, uint16_t arg);
+
+/**
+ * Atomic bitwise or.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being set.
+ * @return          The previous value.
+ */
+uint32_t core_util_atomic_fetch_or_u32(uint32_t *valuePtr, uint32_t arg);
+
+/**
+ * Atomic bitwise or.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being set.
+ * @return          The previous value.
+ */
+uint64_t core_util_atomic_fetch_or_u64(uint64_t *valuePtr, uint64_t arg);
+
+/**
+ * Atomic bitwise exclusive or.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being toggled.
+ * @return          The previous value.
+ */
+uint8_t core_util_atomic_fetch_xor_u8(uint8_t *valuePtr, uint8_t arg);
+
+/**
+ * Atomic bitwise exclusive or.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being toggled.
+ * @return          The previous value.
+ */
+uint16_t core_util_atomic_fetch_xor_u16(uint16_t *valuePtr, uint16_t arg);
+
+/**
+ * Atomic bitwise exclusive or.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being toggled.
+ * @return          The previous value.
+ */
+uint32_t core_util_atomic_fetch_xor_u32(uint32_t *valuePtr, uint32_t arg);
+
+/**
+ * Atomic bitwise exclusive or.
+ * @param  valuePtr Target memory location.
+ * @param  arg      The bits being toggled.
+ * @return          The previous value.
+ */
+uint64_t core_util_atomic_fetch_xor_u64(uint64_t *valuePtr, uint64_t arg);
+
+/**
+ * Atomic pointer load with acquire ordering.
+ * @param  valuePtr Target memory location.
+ * @return          The loaded pointer.
+ */
+void *core_util_atomic_load_ptr(void *const *valuePtr);
+
+/**
+ * Atomic pointer store with release ordering.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The pointer to store.
+ */
+void core_util_atomic_store_ptr(void **valuePtr, void *desiredValue);
+
+/**
+ * Atomic pointer exchange.
+ * @param  valuePtr     Target memory location.
+ * @param  desiredValue The pointer to store.
+ * @return              The previous pointer.
+ */
+void *core_util_atomic_exchange_ptr(void **valuePtr, void *desiredValue);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
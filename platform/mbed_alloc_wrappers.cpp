@@ -16,6 +16,7 @@
 
 #include "platform/mbed_mem_trace.h"
 #include "platform/mbed_stats.h"
+#include "platform/mbed_tlsf.h"
 #include "platform/toolchain.h"
 #include "platform/SingletonPtr.h"
 #include "platform/PlatformMutex.h"
@@ -52,6 +53,73 @@ static SingletonPtr<PlatformMutex> mem_trace_mutex;
 #ifdef MBED_HEAP_STATS_ENABLED
 static SingletonPtr<PlatformMutex> malloc_stats_mutex;
 static mbed_stats_heap_t heap_stats = {0, 0, 0, 0, 0};
+static mbed_stats_heap_hist_t heap_hist;
+#if MBED_HEAP_STATS_CALLERS
+/* The last entry takes the callers that found the table full */
+static mbed_stats_heap_caller_t heap_callers[MBED_HEAP_STATS_CALLERS + 1];
+#endif
+
+static uint32_t heap_hist_bin(uint32_t size)
+{
+    uint32_t bin = 0;
+    while (bin < MBED_STATS_HEAP_HIST_BINS - 1 && size > (8UL << bin)) {
+        bin++;
+    }
+    return bin;
+}
+
+/* Account a new allocation, with malloc_stats_mutex held */
+static void heap_stats_add(alloc_info_t *alloc_info, uint32_t size, void *caller)
+{
+    alloc_info->size = size;
+    heap_stats.current_size += size;
+    heap_stats.total_size += size;
+    heap_stats.alloc_cnt += 1;
+    if (heap_stats.current_size > heap_stats.max_size) {
+        heap_stats.max_size = heap_stats.current_size;
+    }
+
+    uint32_t bin = heap_hist_bin(size);
+    heap_hist.alloc_cnt[bin] += 1;
+    heap_hist.current_cnt[bin] += 1;
+
+#if MBED_HEAP_STATS_CALLERS
+    uint32_t i = 0;
+    while (i < MBED_HEAP_STATS_CALLERS && heap_callers[i].caller != 0 &&
+            heap_callers[i].caller != (uint32_t)(uintptr_t)caller) {
+        i++;
+    }
+    mbed_stats_heap_caller_t *entry = &heap_callers[i];
+    if (i < MBED_HEAP_STATS_CALLERS) {
+        entry->caller = (uint32_t)(uintptr_t)caller;
+    }
+    entry->alloc_cnt += 1;
+    entry->current_cnt += 1;
+    entry->current_size += size;
+    entry->total_size += size;
+    if (entry->current_size > entry->max_size) {
+        entry->max_size = entry->current_size;
+    }
+    alloc_info->pad = i;
+#else
+    (void)caller;
+#endif
+}
+
+/* Account a freed allocation, with malloc_stats_mutex held */
+static void heap_stats_remove(alloc_info_t *alloc_info)
+{
+    uint32_t size = alloc_info->size;
+    heap_stats.current_size -= size;
+    heap_stats.alloc_cnt -= 1;
+    heap_hist.current_cnt[heap_hist_bin(size)] -= 1;
+
+#if MBED_HEAP_STATS_CALLERS
+    mbed_stats_heap_caller_t *entry = &heap_callers[alloc_info->pad];
+    entry->current_cnt -= 1;
+    entry->current_size -= size;
+#endif
+}
 #endif
 
 void mbed_stats_heap_get(mbed_stats_heap_t *stats)
@@ -65,6 +133,75 @@ void mbed_stats_heap_get(mbed_stats_heap_t *stats)
 #endif
 }
 
+void mbed_stats_heap_hist_get(mbed_stats_heap_hist_t *hist)
+{
+#ifdef MBED_HEAP_STATS_ENABLED
+    malloc_stats_mutex->lock();
+    memcpy(hist, &heap_hist, sizeof(mbed_stats_heap_hist_t));
+    malloc_stats_mutex->unlock();
+#else
+    memset(hist, 0, sizeof(mbed_stats_heap_hist_t));
+#endif
+}
+
+size_t mbed_stats_heap_caller_get(mbed_stats_heap_caller_t *stats, size_t count)
+{
+    size_t n = 0;
+#if defined(MBED_HEAP_STATS_ENABLED) && MBED_HEAP_STATS_CALLERS
+    malloc_stats_mutex->lock();
+    for (uint32_t i = 0; i <= MBED_HEAP_STATS_CALLERS && n < count; i++) {
+        if (heap_callers[i].alloc_cnt != 0) {
+            stats[n++] = heap_callers[i];
+        }
+    }
+    malloc_stats_mutex->unlock();
+#endif
+    return n;
+}
+
+void mbed_stats_heap_dump(void)
+{
+    mbed_stats_heap_t stats;
+    mbed_stats_heap_hist_t hist;
+
+    mbed_stats_heap_get(&stats);
+    mbed_stats_heap_hist_get(&hist);
+
+    printf("heap: current %lu max %lu total %lu allocs %lu failed %lu\r\n",
+           (unsigned long)stats.current_size, (unsigned long)stats.max_size,
+           (unsigned long)stats.total_size, (unsigned long)stats.alloc_cnt,
+           (unsigned long)stats.alloc_fail_cnt);
+
+    for (uint32_t bin = 0; bin < MBED_STATS_HEAP_HIST_BINS; bin++) {
+        if (hist.alloc_cnt[bin] == 0) {
+            continue;
+        }
+        if (bin < MBED_STATS_HEAP_HIST_BINS - 1) {
+            printf("heap: size <= %lu", 8UL << bin);
+        } else {
+            printf("heap: size >  %lu", 8UL << (bin - 1));
+        }
+        printf(" allocs %lu current %lu\r\n",
+               (unsigned long)hist.alloc_cnt[bin], (unsigned long)hist.current_cnt[bin]);
+    }
+
+#if defined(MBED_HEAP_STATS_ENABLED) && MBED_HEAP_STATS_CALLERS
+    // One at a time, printf may allocate
+    for (uint32_t i = 0; i <= MBED_HEAP_STATS_CALLERS; i++) {
+        malloc_stats_mutex->lock();
+        mbed_stats_heap_caller_t entry = heap_callers[i];
+        malloc_stats_mutex->unlock();
+        if (entry.alloc_cnt == 0) {
+            continue;
+        }
+        printf("heap: caller 0x%08lx allocs %lu current %lu/%lu max %lu total %lu\r\n",
+               (unsigned long)entry.caller, (unsigned long)entry.alloc_cnt,
+               (unsigned long)entry.current_cnt, (unsigned long)entry.current_size,
+               (unsigned long)entry.max_size, (unsigned long)entry.total_size);
+    }
+#endif
+}
+
 /******************************************************************************/
 /* GCC memory allocation wrappers                                             */
 /******************************************************************************/
@@ -80,31 +217,89 @@ extern "C" {
     void * __real__realloc_r(struct _reent * r, void * ptr, size_t size);
     void __real__free_r(struct _reent * r, void * ptr);
     void* __real__calloc_r(struct _reent * r, size_t nmemb, size_t size);
+    void* __real__memalign_r(struct _reent * r, size_t alignment, size_t bytes);
 }
 
-// TODO: memory tracing doesn't work with uVisor enabled.
-#if !defined(FEATURE_UVISOR)
+/* The allocator below the heap stats and memory tracing, the C library one
+   unless the platform.heap-tlsf option selects the TLSF heap */
+#if MBED_CONF_PLATFORM_HEAP_TLSF
+static inline void * heap_malloc(struct _reent * r, size_t size) {
+    return mbed_tlsf_malloc(size);
+}
+
+static inline void * heap_realloc(struct _reent * r, void * ptr, size_t size) {
+    return mbed_tlsf_realloc(ptr, size);
+}
+
+static inline void heap_free(struct _reent * r, void * ptr) {
+    mbed_tlsf_free(ptr);
+}
+
+static inline void * heap_calloc(struct _reent * r, size_t nmemb, size_t size) {
+    return mbed_tlsf_calloc(nmemb, size);
+}
+
+static inline void * heap_memalign(struct _reent * r, size_t alignment, size_t bytes) {
+    return mbed_tlsf_memalign(alignment, bytes);
+}
+#else
+static inline void * heap_malloc(struct _reent * r, size_t size) {
+    return __real__malloc_r(r, size);
+}
+
+static inline void * heap_realloc(struct _reent * r, void * ptr, size_t size) {
+    return __real__realloc_r(r, ptr, size);
+}
+
+static inline void heap_free(struct _reent * r, void * ptr) {
+    __real__free_r(r, ptr);
+}
+
+static inline void * heap_calloc(struct _reent * r, size_t nmemb, size_t size) {
+    return __real__calloc_r(r, nmemb, size);
+}
+
+static inline void * heap_memalign(struct _reent * r, size_t alignment, size_t bytes) {
+    return __real__memalign_r(r, alignment, bytes);
+}
+#endif
 
-extern "C" void * __wrap__malloc_r(struct _reent * r, size_t size) {
-    void *ptr = NULL;
 #ifdef MBED_HEAP_STATS_ENABLED
+static void * stats_malloc(struct _reent * r, size_t size, void * caller) {
+    void *ptr = NULL;
     malloc_stats_mutex->lock();
-    alloc_info_t *alloc_info = (alloc_info_t*)__real__malloc_r(r, size + sizeof(alloc_info_t));
+    alloc_info_t *alloc_info = (alloc_info_t*)heap_malloc(r, size + sizeof(alloc_info_t));
     if (alloc_info != NULL) {
-        alloc_info->size = size;
+        heap_stats_add(alloc_info, size, caller);
         ptr = (void*)(alloc_info + 1);
-        heap_stats.current_size += size;
-        heap_stats.total_size += size;
-        heap_stats.alloc_cnt += 1;
-        if (heap_stats.current_size > heap_stats.max_size) {
-            heap_stats.max_size = heap_stats.current_size;
-        }
     } else {
         heap_stats.alloc_fail_cnt += 1;
     }
     malloc_stats_mutex->unlock();
+    return ptr;
+}
+
+static void stats_free(struct _reent * r, void * ptr) {
+    malloc_stats_mutex->lock();
+    alloc_info_t *alloc_info = NULL;
+    if (ptr != NULL) {
+        alloc_info = ((alloc_info_t*)ptr) - 1;
+        heap_stats_remove(alloc_info);
+    }
+    heap_free(r, (void*)alloc_info);
+    malloc_stats_mutex->unlock();
+}
+#endif
+
+// TODO: memory tracing doesn't work with uVisor enabled.
+#if !defined(FEATURE_UVISOR)
+
+extern "C" void * __wrap__malloc_r(struct _reent * r, size_t size) {
+    void *ptr = NULL;
+#ifdef MBED_HEAP_STATS_ENABLED
+    ptr = stats_malloc(r, size, MBED_CALLER_ADDR());
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    ptr = __real__malloc_r(r, size);
+    ptr = heap_malloc(r, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
@@ -133,7 +328,7 @@ extern "C" void * __wrap__realloc_r(struct _reent * r, void * ptr, size_t size)
 
     // Allocate space
     if (size != 0) {
-        new_ptr = malloc(size);
+        new_ptr = stats_malloc(r, size, MBED_CALLER_ADDR());
     }
 
     // If the new buffer has been allocated copy the data to it
@@ -141,10 +336,10 @@ extern "C" void * __wrap__realloc_r(struct _reent * r, void * ptr, size_t size)
     if (new_ptr != NULL) {
         uint32_t copy_size = (old_size < size) ? old_size : size;
         memcpy(new_ptr, (void*)ptr, copy_size);
-        free(ptr);
+        stats_free(r, ptr);
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    new_ptr = __real__realloc_r(r, ptr, size);
+    new_ptr = heap_realloc(r, ptr, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
@@ -156,17 +351,9 @@ extern "C" void * __wrap__realloc_r(struct _reent * r, void * ptr, size_t size)
 
 extern "C" void __wrap__free_r(struct _reent * r, void * ptr) {
 #ifdef MBED_HEAP_STATS_ENABLED
-    malloc_stats_mutex->lock();
-    alloc_info_t *alloc_info = NULL;
-    if (ptr != NULL) {
-        alloc_info = ((alloc_info_t*)ptr) - 1;
-        heap_stats.current_size -= alloc_info->size;
-        heap_stats.alloc_cnt -= 1;
-    }
-    __real__free_r(r, (void*)alloc_info);
-    malloc_stats_mutex->unlock();
+    stats_free(r, ptr);
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    __real__free_r(r, ptr);
+    heap_free(r, ptr);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
@@ -180,14 +367,12 @@ extern "C" void __wrap__free_r(struct _reent * r, void * ptr) {
 extern "C" void * __wrap__calloc_r(struct _reent * r, size_t nmemb, size_t size) {
     void *ptr = NULL;
 #ifdef MBED_HEAP_STATS_ENABLED
-    // Note - no lock needed since malloc is thread safe
-
-    ptr = malloc(nmemb * size);
+    ptr = stats_malloc(r, nmemb * size, MBED_CALLER_ADDR());
     if (ptr != NULL) {
         memset(ptr, 0, nmemb * size);
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
-    ptr = __real__calloc_r(r, nmemb, size);
+    ptr = heap_calloc(r, nmemb, size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
 #ifdef MBED_MEM_TRACING_ENABLED
     mem_trace_mutex->lock();
@@ -197,6 +382,25 @@ extern "C" void * __wrap__calloc_r(struct _reent * r, size_t nmemb, size_t size)
     return ptr;
 }
 
+extern "C" void * __wrap__memalign_r(struct _reent * r, size_t alignment, size_t bytes) {
+    void *ptr = NULL;
+#ifdef MBED_HEAP_STATS_ENABLED
+    // The stats header keeps blocks aligned to its own size only, freeing
+    // memory aligned further would not find the start of the block
+    if (alignment <= sizeof(alloc_info_t)) {
+        ptr = stats_malloc(r, bytes, MBED_CALLER_ADDR());
+    }
+#else // #ifdef MBED_HEAP_STATS_ENABLED
+    ptr = heap_memalign(r, alignment, bytes);
+#endif // #ifdef MBED_HEAP_STATS_ENABLED
+#ifdef MBED_MEM_TRACING_ENABLED
+    mem_trace_mutex->lock();
+    mbed_mem_trace_malloc(ptr, bytes, MBED_CALLER_ADDR());
+    mem_trace_mutex->unlock();
+#endif // #ifdef MBED_MEM_TRACING_ENABLED
+    return ptr;
+}
+
 
 /******************************************************************************/
 /* ARMCC memory allocation wrappers                                           */
@@ -214,24 +418,37 @@ extern "C" {
     void $Super$$free(void *ptr);
 }
 
-extern "C" void* $Sub$$malloc(size_t size) {
-    void *ptr = NULL;
 #ifdef MBED_HEAP_STATS_ENABLED
+static void *stats_malloc(size_t size, void *caller) {
+    void *ptr = NULL;
     malloc_stats_mutex->lock();
     alloc_info_t *alloc_info = (alloc_info_t*)$Super$$malloc(size + sizeof(alloc_info_t));
     if (alloc_info != NULL) {
-        alloc_info->size = size;
+        heap_stats_add(alloc_info, size, caller);
         ptr = (void*)(alloc_info + 1);
-        heap_stats.current_size += size;
-        heap_stats.total_size += size;
-        heap_stats.alloc_cnt += 1;
-        if (heap_stats.current_size > heap_stats.max_size) {
-            heap_stats.max_size = heap_stats.current_size;
-        }
     } else {
         heap_stats.alloc_fail_cnt += 1;
     }
     malloc_stats_mutex->unlock();
+    return ptr;
+}
+
+static void stats_free(void *ptr) {
+    malloc_stats_mutex->lock();
+    alloc_info_t *alloc_info = NULL;
+    if (ptr != NULL) {
+        alloc_info = ((alloc_info_t*)ptr) - 1;
+        heap_stats_remove(alloc_info);
+    }
+    $Super$$free((void*)alloc_info);
+    malloc_stats_mutex->unlock();
+}
+#endif
+
+extern "C" void* $Sub$$malloc(size_t size) {
+    void *ptr = NULL;
+#ifdef MBED_HEAP_STATS_ENABLED
+    ptr = stats_malloc(size, MBED_CALLER_ADDR());
 #else // #ifdef MBED_HEAP_STATS_ENABLED
     ptr = $Super$$malloc(size);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
@@ -257,7 +474,7 @@ extern "C" void* $Sub$$realloc(void *ptr, size_t size) {
 
     // Allocate space
     if (size != 0) {
-        new_ptr = malloc(size);
+        new_ptr = stats_malloc(size, MBED_CALLER_ADDR());
     }
 
     // If the new buffer has been allocated copy the data to it
@@ -265,7 +482,7 @@ extern "C" void* $Sub$$realloc(void *ptr, size_t size) {
     if (new_ptr != NULL) {
         uint32_t copy_size = (old_size < size) ? old_size : size;
         memcpy(new_ptr, (void*)ptr, copy_size);
-        free(ptr);
+        stats_free(ptr);
     }
 #else // #ifdef MBED_HEAP_STATS_ENABLED
     new_ptr = $Super$$realloc(ptr, size);
@@ -281,8 +498,7 @@ extern "C" void* $Sub$$realloc(void *ptr, size_t size) {
 extern "C" void *$Sub$$calloc(size_t nmemb, size_t size) {
     void *ptr = NULL;
 #ifdef MBED_HEAP_STATS_ENABLED
-    // Note - no lock needed since malloc is thread safe
-    ptr = malloc(nmemb * size);
+    ptr = stats_malloc(nmemb * size, MBED_CALLER_ADDR());
     if (ptr != NULL) {
         memset(ptr, 0, nmemb * size);
     }
@@ -299,15 +515,7 @@ extern "C" void *$Sub$$calloc(size_t nmemb, size_t size) {
 
 extern "C" void $Sub$$free(void *ptr) {
 #ifdef MBED_HEAP_STATS_ENABLED
-    malloc_stats_mutex->lock();
-    alloc_info_t *alloc_info = NULL;
-    if (ptr != NULL) {
-        alloc_info = ((alloc_info_t*)ptr) - 1;
-        heap_stats.current_size -= alloc_info->size;
-        heap_stats.alloc_cnt -= 1;
-    }
-    $Super$$free((void*)alloc_info);
-    malloc_stats_mutex->unlock();
+    stats_free(ptr);
 #else // #ifdef MBED_HEAP_STATS_ENABLED
     $Super$$free(ptr);
 #endif // #ifdef MBED_HEAP_STATS_ENABLED
@@ -336,3 +544,7 @@ extern "C" void $Sub$$free(void *ptr) {
 
 #endif // #if defined(TOOLCHAIN_GCC)
 
+
+#if MBED_CONF_PLATFORM_HEAP_TLSF && (!defined(TOOLCHAIN_GCC) || defined(FEATURE_UVISOR))
+#warning The TLSF heap is only supported with GCC without uVisor, the C library heap is used.
+#endif
@@ -0,0 +1,371 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform/mbed_binlog.h"
+#include "platform/SingletonPtr.h"
+#include "platform/PlatformMutex.h"
+#include "platform/critical.h"
+#include "hal/us_ticker_api.h"
+#include "cmsis.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef MBED_CONF_RTOS_PRESENT
+#include "rtos/Thread.h"
+#endif
+
+#ifndef MBED_CONF_PLATFORM_BINLOG_SIZE
+#define MBED_CONF_PLATFORM_BINLOG_SIZE          1024
+#endif
+#ifndef MBED_CONF_PLATFORM_BINLOG_RECORD_MAX
+#define MBED_CONF_PLATFORM_BINLOG_RECORD_MAX    128
+#endif
+#ifndef MBED_CONF_PLATFORM_BINLOG_STRING_MAX
+#define MBED_CONF_PLATFORM_BINLOG_STRING_MAX    32
+#endif
+#ifndef MBED_CONF_PLATFORM_BINLOG_PERIOD
+#define MBED_CONF_PLATFORM_BINLOG_PERIOD        100
+#endif
+#ifndef MBED_CONF_PLATFORM_BINLOG_STACK_SIZE
+#define MBED_CONF_PLATFORM_BINLOG_STACK_SIZE    1024
+#endif
+
+#define BINLOG_MASK             (MBED_CONF_PLATFORM_BINLOG_SIZE - 1)
+#define BINLOG_PACKET_SIZE      512
+
+#if MBED_CONF_PLATFORM_BINLOG_SIZE & BINLOG_MASK
+#error "platform.binlog-size must be a power of two"
+#endif
+
+#if MBED_CONF_PLATFORM_BINLOG_RECORD_MAX > BINLOG_PACKET_SIZE
+#error "platform.binlog-record-max must be at most 512"
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint16_t size;
+    uint16_t dropped;
+    uint8_t records[BINLOG_PACKET_SIZE];
+} binlog_packet_t;
+
+/* Record being built */
+typedef struct {
+    mbed_binlog_header_t header;
+    uint8_t args[MBED_CONF_PLATFORM_BINLOG_RECORD_MAX - sizeof(mbed_binlog_header_t)];
+    size_t used;
+} binlog_record_t;
+
+static uint8_t binlog_ring[MBED_CONF_PLATFORM_BINLOG_SIZE];
+/* Free running positions, changed in critical sections */
+static uint32_t binlog_head;
+static uint32_t binlog_tail;
+static uint32_t binlog_dropped;
+/* Serializes the consumers of the ring */
+static SingletonPtr<PlatformMutex> binlog_flush_mutex;
+static mbed_binlog_write_t binlog_write;
+
+static void binlog_begin(binlog_record_t *record, uint8_t type, uint8_t level, const char *fmt)
+{
+    record->header.type = type;
+    record->header.level = level;
+    record->header.format = (uint32_t)fmt;
+    record->used = 0;
+}
+
+static bool binlog_put(binlog_record_t *record, const void *data, size_t size)
+{
+    if (record->used + size > sizeof(record->args)) {
+        record->header.type |= MBED_BINLOG_TRUNCATED;
+        return false;
+    }
+    memcpy(record->args + record->used, data, size);
+    record->used += size;
+    return true;
+}
+
+static bool binlog_put_word(binlog_record_t *record, uint32_t word)
+{
+    return binlog_put(record, &word, sizeof(word));
+}
+
+static bool binlog_put_string(binlog_record_t *record, const char *str)
+{
+    size_t len = 0;
+    if (str == NULL) {
+        str = "(null)";
+    }
+    while (len < MBED_CONF_PLATFORM_BINLOG_STRING_MAX && str[len]) {
+        len++;
+    }
+
+    uint8_t len8 = len;
+    if (record->used + 1 + len > sizeof(record->args)) {
+        record->header.type |= MBED_BINLOG_TRUNCATED;
+        return false;
+    }
+    binlog_put(record, &len8, 1);
+    return binlog_put(record, str, len);
+}
+
+static void binlog_commit(binlog_record_t *record)
+{
+    uint32_t size = sizeof(record->header) + record->used;
+    record->header.size = size;
+
+    core_util_critical_section_enter();
+    record->header.time = us_ticker_read();
+    if (MBED_CONF_PLATFORM_BINLOG_SIZE - (binlog_head - binlog_tail) < size) {
+        binlog_dropped++;
+    } else {
+        const uint8_t *bytes = (const uint8_t *)record;
+        uint32_t start = binlog_head & BINLOG_MASK;
+        uint32_t first = MBED_CONF_PLATFORM_BINLOG_SIZE - start;
+        if (first > size) {
+            first = size;
+        }
+        // The arguments follow the header in the record
+        memcpy(&binlog_ring[start], bytes, first);
+        memcpy(&binlog_ring[0], bytes + first, size - first);
+        binlog_head += size;
+    }
+    core_util_critical_section_exit();
+}
+
+/* Stores the arguments as the conversions of fmt take them */
+static void binlog_put_args(binlog_record_t *record, const char *fmt, va_list args)
+{
+    for (const char *p = fmt; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        p++;
+        while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+            p++;
+        }
+        if (*p == '*') {
+            binlog_put_word(record, va_arg(args, int));
+            p++;
+        } else {
+            while (*p >= '0' && *p <= '9') {
+                p++;
+            }
+        }
+        if (*p == '.') {
+            p++;
+            if (*p == '*') {
+                binlog_put_word(record, va_arg(args, int));
+                p++;
+            } else {
+                while (*p >= '0' && *p <= '9') {
+                    p++;
+                }
+            }
+        }
+
+        bool wide = false;
+        if (*p == 'h') {
+            p++;
+            if (*p == 'h') {
+                p++;
+            }
+        } else if (*p == 'l') {
+            p++;
+            if (*p == 'l') {
+                wide = true;
+                p++;
+            }
+        } else if (*p == 'j' || *p == 'q') {
+            wide = true;
+            p++;
+        } else if (*p == 'z' || *p == 't' || *p == 'L') {
+            p++;
+        }
+
+        bool room = true;
+        switch (*p) {
+            case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+                if (wide) {
+                    uint64_t value = va_arg(args, uint64_t);
+                    room = binlog_put(record, &value, sizeof(value));
+                } else {
+                    room = binlog_put_word(record, va_arg(args, unsigned));
+                }
+                break;
+            case 'p':
+                room = binlog_put_word(record, (uint32_t)va_arg(args, void *));
+                break;
+            case 's':
+                room = binlog_put_string(record, va_arg(args, const char *));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': {
+                double value = va_arg(args, double);
+                room = binlog_put(record, &value, sizeof(value));
+                break;
+            }
+            case 'n':
+                (void)va_arg(args, void *);
+                break;
+            case 0:
+                return;
+            default:
+                break;
+        }
+        if (!room) {
+            return;
+        }
+    }
+}
+
+extern "C" void mbed_binlog_words(uint8_t type, const char *fmt, int count, ...)
+{
+    binlog_record_t record;
+    va_list args;
+
+    binlog_begin(&record, type, 0, fmt);
+    va_start(args, count);
+    for (int i = 0; i < count; i++) {
+        binlog_put_word(&record, va_arg(args, uint32_t));
+    }
+    va_end(args);
+    binlog_commit(&record);
+}
+
+extern "C" void mbed_binlog_vprintf(const char *fmt, va_list args)
+{
+    binlog_record_t record;
+
+    binlog_begin(&record, MBED_BINLOG_TYPE_PRINTF, 0, fmt);
+    binlog_put_args(&record, fmt, args);
+    binlog_commit(&record);
+}
+
+extern "C" void mbed_binlog_printf(const char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    mbed_binlog_vprintf(fmt, args);
+    va_end(args);
+}
+
+extern "C" void mbed_binlog_vtrace(uint8_t level, const char *group, const char *fmt, va_list args)
+{
+    binlog_record_t record;
+
+    binlog_begin(&record, MBED_BINLOG_TYPE_TRACE, level, fmt);
+    binlog_put_word(&record, (uint32_t)group);
+    binlog_put_args(&record, fmt, args);
+    binlog_commit(&record);
+}
+
+/* Moves whole records from the ring to the packet */
+static uint16_t binlog_pop(uint8_t *out, size_t room)
+{
+    size_t used = 0;
+
+    core_util_critical_section_enter();
+    while (binlog_tail != binlog_head) {
+        mbed_binlog_header_t header;
+        uint8_t *bytes = (uint8_t *)&header;
+        for (size_t i = 0; i < sizeof(header); i++) {
+            bytes[i] = binlog_ring[(binlog_tail + i) & BINLOG_MASK];
+        }
+        if (used + header.size > room) {
+            break;
+        }
+        for (size_t i = 0; i < header.size; i++) {
+            out[used + i] = binlog_ring[(binlog_tail + i) & BINLOG_MASK];
+        }
+        used += header.size;
+        binlog_tail += header.size;
+    }
+    core_util_critical_section_exit();
+
+    return used;
+}
+
+extern "C" size_t mbed_binlog_flush(mbed_binlog_write_t write)
+{
+    binlog_packet_t packet;
+    size_t total = 0;
+
+    binlog_flush_mutex->lock();
+    while (true) {
+        uint16_t size = binlog_pop(packet.records, sizeof(packet.records));
+        uint32_t dropped = binlog_dropped;
+        if (size == 0 && dropped == 0) {
+            break;
+        }
+
+        // The drops still counted after a packet go in the next one
+        if (dropped > 0xffff) {
+            dropped = 0xffff;
+        }
+        core_util_atomic_decr_u32(&binlog_dropped, dropped);
+
+        packet.magic = MBED_BINLOG_MAGIC;
+        packet.size = size;
+        packet.dropped = dropped;
+        write(&packet, offsetof(binlog_packet_t, records) + size);
+        total += size;
+
+        if (size == 0) {
+            break;
+        }
+    }
+    binlog_flush_mutex->unlock();
+
+    return total;
+}
+
+extern "C" void mbed_binlog_write_stdout(const void *data, size_t size)
+{
+    fwrite(data, 1, size, stdout);
+    fflush(stdout);
+}
+
+extern "C" void mbed_binlog_write_swo(const void *data, size_t size)
+{
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++) {
+        ITM_SendChar(bytes[i]);
+    }
+#endif
+}
+
+#ifdef MBED_CONF_RTOS_PRESENT
+static void binlog_drain()
+{
+    while (true) {
+        mbed_binlog_flush(binlog_write);
+        rtos::Thread::wait(MBED_CONF_PLATFORM_BINLOG_PERIOD);
+    }
+}
+#endif
+
+extern "C" void mbed_binlog_start(mbed_binlog_write_t write)
+{
+    binlog_write = write ? write : mbed_binlog_write_stdout;
+
+#ifdef MBED_CONF_RTOS_PRESENT
+    static rtos::Thread *drain_thread;
+    if (!drain_thread) {
+        drain_thread = new rtos::Thread(osPriorityLow, MBED_CONF_PLATFORM_BINLOG_STACK_SIZE);
+        drain_thread->start(binlog_drain);
+    }
+#endif
+}
@@ -0,0 +1,184 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_BINLOG_H
+#define MBED_BINLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+/* Deferred binary logging
+ *
+ * Messages are not formatted on the target. A record of the format string
+ * and the raw arguments goes into a ring buffer of
+ * MBED_CONF_PLATFORM_BINLOG_SIZE bytes, which is written out later in
+ * packets, and tools/binlog.py formats the messages on the host with the
+ * strings of the ELF file.
+ *
+ * MBED_BINLOG keeps its format string in the .mbed_binlog_fmt section,
+ * which GCC builds do not load into flash, and takes up to 8 integer or
+ * pointer arguments of at most 32 bits. %s arguments are printed by the
+ * decoder if they point to constant strings of the image.
+ *
+ * mbed_binlog_printf takes any format, the arguments are stored by their
+ * conversions, with the strings copied. It backs debug() with the
+ * platform.binlog-debug option, and mbed_trace with platform.binlog-trace.
+ *
+ * Example:
+ * @code
+ * mbed_binlog_start(NULL);
+ * MBED_BINLOG("rx frame %u bytes, status %x", len, status);
+ * @endcode
+ *
+ * Decoded with:
+ * @code
+ * python tools/binlog.py capture.bin --elf BUILD/app.elf
+ * @endcode
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Magic of the packets, "MBLG" in little endian */
+#define MBED_BINLOG_MAGIC       0x474C424D
+
+/** Record of MBED_BINLOG, format is the offset in .mbed_binlog_fmt, the arguments are words */
+#define MBED_BINLOG_TYPE_ID     1
+/** Record of MBED_BINLOG without the section, format is the address of the string */
+#define MBED_BINLOG_TYPE_WORDS  2
+/** Record of mbed_binlog_printf, the arguments are stored by conversion */
+#define MBED_BINLOG_TYPE_PRINTF 3
+/** Record of mbed_binlog_vtrace, a mbed_binlog_printf record with the trace group address first */
+#define MBED_BINLOG_TYPE_TRACE  4
+/** Flag of the type of records with arguments cut off */
+#define MBED_BINLOG_TRUNCATED   0x80
+
+/**
+ * Header of a record, in little endian order on the wire
+ *
+ * The arguments follow the header. Words and doubles are 4 and 8 bytes in
+ * native order without padding. Copied strings are a length byte followed
+ * by the characters.
+ */
+typedef struct {
+    uint8_t type;       /**< MBED_BINLOG_TYPE_*, with MBED_BINLOG_TRUNCATED */
+    uint8_t level;      /**< Trace level, 0 for other records */
+    uint16_t size;      /**< Size of the record including the header */
+    uint32_t time;      /**< us_ticker_read() when the record was written */
+    uint32_t format;    /**< Format string, see the types */
+} mbed_binlog_header_t;
+
+/**
+ * Type of the function packets are written with
+ *
+ * @param data packet, a header of MBED_BINLOG_MAGIC, the 16 bit size of
+ *             the records and the 16 bit number of records dropped since
+ *             the previous packet, followed by the records.
+ * @param size size of the packet in bytes.
+ */
+typedef void (*mbed_binlog_write_t)(const void *data, size_t size);
+
+#if defined(__GNUC__) && defined(__arm__) && !defined(__CC_ARM)
+/* The flags of the section are commented out for the assembler, which
+ * makes it a section without the alloc flag that takes no flash */
+#define MBED_BINLOG_SECTION     __attribute__((section(".mbed_binlog_fmt,\"\",%progbits @"), used))
+#define MBED_BINLOG_SECTION_TYPE MBED_BINLOG_TYPE_ID
+#else
+#define MBED_BINLOG_SECTION
+#define MBED_BINLOG_SECTION_TYPE MBED_BINLOG_TYPE_WORDS
+#endif
+
+#define MBED_BINLOG_COUNT_(a0, a1, a2, a3, a4, a5, a6, a7, a8, n, ...) n
+
+/** Log a message with up to 8 integer or pointer arguments
+ *
+ * @param fmt String literal, printf format
+ */
+#define MBED_BINLOG(fmt, ...)                                                       \
+    do {                                                                            \
+        static const char mbed_binlog_fmt[] MBED_BINLOG_SECTION = fmt;              \
+        mbed_binlog_words(MBED_BINLOG_SECTION_TYPE, mbed_binlog_fmt,                \
+                          MBED_BINLOG_COUNT_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0), \
+                          ##__VA_ARGS__);                                           \
+    } while (0)
+
+/** Record of MBED_BINLOG, use the macro instead
+ *
+ * @param type  MBED_BINLOG_TYPE_ID or MBED_BINLOG_TYPE_WORDS
+ * @param fmt   Format string
+ * @param count Number of 32 bit arguments
+ */
+void mbed_binlog_words(uint8_t type, const char *fmt, int count, ...);
+
+/** Log a message with any printf format
+ *
+ * Interrupt safe. The format string must stay in the image, the decoder
+ * finds it by its address.
+ *
+ * @param fmt printf format
+ */
+void mbed_binlog_printf(const char *fmt, ...);
+
+/** Log a message with any printf format and a list of arguments
+ *
+ * @param fmt  printf format
+ * @param args Arguments
+ */
+void mbed_binlog_vprintf(const char *fmt, va_list args);
+
+/** Log a trace message of mbed_trace
+ *
+ * @param level Trace level
+ * @param group Trace group, a string of the image
+ * @param fmt   printf format
+ * @param args  Arguments
+ */
+void mbed_binlog_vtrace(uint8_t level, const char *group, const char *fmt, va_list args);
+
+/** Write the records in packets
+ *
+ * @param write Function to write the packets with
+ * @return Number of bytes of records written
+ */
+size_t mbed_binlog_flush(mbed_binlog_write_t write);
+
+/** Start writing the records
+ *
+ * With the RTOS a low priority thread flushes the records every
+ * MBED_CONF_PLATFORM_BINLOG_PERIOD milliseconds. Without the RTOS the
+ * application calls mbed_binlog_flush itself.
+ *
+ * @param write Function to write the packets with, mbed_binlog_write_stdout
+ *              if NULL
+ */
+void mbed_binlog_start(mbed_binlog_write_t write);
+
+/** Write packets to stdout, which must not convert newlines */
+void mbed_binlog_write_stdout(const void *data, size_t size);
+
+/** Write packets to ITM stimulus port 0, for SWO capture. Cortex-M3 and above. */
+void mbed_binlog_write_swo(const void *data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
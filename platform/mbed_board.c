@@ -19,6 +19,8 @@
 #include "platform/toolchain.h"
 #include "platform/mbed_interface.h"
 #include "platform/critical.h"
+#include "platform/mbed_stdio_buffer.h"
+#include "platform/mbed_printf.h"
 #include "hal/serial_api.h"
 
 #if DEVICE_SERIAL
@@ -77,11 +79,20 @@ void mbed_error_vfprintf(const char * format, va_list arg) {
 #if DEVICE_SERIAL
     core_util_critical_section_enter();
     char buffer[128];
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF
+    int size = mbed_vsnprintf(buffer, sizeof(buffer), format, arg);
+    if (size >= (int)sizeof(buffer)) {
+        size = sizeof(buffer) - 1;
+    }
+#else
     int size = vsprintf(buffer, format, arg);
+#endif
     if (size > 0) {
         if (!stdio_uart_inited) {
         serial_init(&stdio_uart, STDIO_UART_TX, STDIO_UART_RX);
         }
+        // Keep the order of the buffered output
+        mbed_stdio_buffer_flush();
         for (int i = 0; i < size; i++) {
             serial_putc(&stdio_uart, buffer[i]);
         }
@@ -0,0 +1,104 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform/mbed_boot_time.h"
+#include "platform/mbed_profile.h"
+#include "hal/us_ticker_api.h"
+#include "cmsis.h"
+#include <stdio.h>
+
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+#define BOOT_TIME_CYCLES    1
+#else
+#define BOOT_TIME_CYCLES    0
+#endif
+
+static const char *const boot_phase_names[MBED_BOOT_PHASES] = {
+    "start",
+    "sdk_init",
+    "rtos_init",
+    "constructors",
+    "main",
+};
+
+static uint32_t boot_times[MBED_BOOT_PHASES];
+/* Bit of each marked phase */
+static uint8_t boot_marked;
+/* Time of the latest mark, and the counter value it was computed at */
+static uint32_t boot_now;
+static uint32_t boot_last;
+static uint8_t boot_counting;
+
+void mbed_boot_time_mark(mbed_boot_phase_t phase)
+{
+    if (phase >= MBED_BOOT_PHASES || (boot_marked & (1 << phase))) {
+        return;
+    }
+
+#if BOOT_TIME_CYCLES
+    if (!boot_counting) {
+        mbed_profile_init();
+        boot_last = DWT->CYCCNT;
+        boot_counting = 1;
+    }
+    uint32_t mhz = SystemCoreClock / 1000000;
+    if (mhz == 0) {
+        mhz = 1;
+    }
+    uint32_t cycles = DWT->CYCCNT - boot_last;
+    boot_now += cycles / mhz;
+    // Keep the remainder for the next phase
+    boot_last += cycles - cycles % mhz;
+#else
+    if (phase != MBED_BOOT_START) {
+        uint32_t now = us_ticker_read();
+        if (!boot_counting) {
+            boot_last = now;
+            boot_counting = 1;
+        }
+        boot_now += now - boot_last;
+        boot_last = now;
+    }
+#endif
+
+    boot_times[phase] = boot_now;
+    boot_marked |= 1 << phase;
+}
+
+uint32_t mbed_boot_time_get(mbed_boot_phase_t phase)
+{
+    if (phase >= MBED_BOOT_PHASES || !(boot_marked & (1 << phase))) {
+        return MBED_BOOT_TIME_NONE;
+    }
+    return boot_times[phase];
+}
+
+void mbed_boot_time_dump(void)
+{
+    uint32_t previous = 0;
+
+    printf("boot: %-14s %10s %10s\r\n", "phase", "end us", "us");
+    for (int i = 0; i < MBED_BOOT_PHASES; i++) {
+        uint32_t time = mbed_boot_time_get((mbed_boot_phase_t)i);
+        if (time == MBED_BOOT_TIME_NONE) {
+            printf("boot: %-14s %10s %10s\r\n", boot_phase_names[i], "-", "-");
+            continue;
+        }
+        printf("boot: %-14s %10lu %10lu\r\n", boot_phase_names[i],
+               (unsigned long)time, (unsigned long)(time - previous));
+        previous = time;
+    }
+}
@@ -0,0 +1,92 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_BOOT_TIME_H
+#define MBED_BOOT_TIME_H
+
+#include <stdint.h>
+
+/* Timestamps of the startup phases
+ *
+ * The startup code of each toolchain marks the end of every phase, with
+ * the platform.boot-time option. Times are in microseconds from
+ * MBED_BOOT_START, when the C runtime has initialized the RAM, so the reset
+ * handler and SystemInit before it are not included.
+ *
+ * Times come from the DWT cycle counter on Cortex-M3 and above, converted
+ * with SystemCoreClock at the end of each phase, so a phase that changes
+ * the core clock, usually MBED_BOOT_SDK_INIT, is approximate. Cortex-M0
+ * uses the us ticker, which may need the clocks set up by mbed_sdk_init,
+ * so the times start at MBED_BOOT_SDK_INIT there.
+ *
+ * Example:
+ * @code
+ * int main() {
+ *     mbed_boot_time_dump();
+ * }
+ * @endcode
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    MBED_BOOT_START = 0,        /**< RAM initialized, time origin */
+    MBED_BOOT_SDK_INIT,         /**< mbed_sdk_init done */
+    MBED_BOOT_RTOS_INIT,        /**< RTOS started, main thread running */
+    MBED_BOOT_CONSTRUCTORS,     /**< C++ static constructors done */
+    MBED_BOOT_MAIN,             /**< mbed_main done, main called */
+    MBED_BOOT_PHASES
+} mbed_boot_phase_t;
+
+/** Time of a phase that was not marked */
+#define MBED_BOOT_TIME_NONE     UINT32_MAX
+
+/** Mark the end of a phase, only the first mark of each phase counts
+ *
+ * @param phase Phase that ended
+ */
+void mbed_boot_time_mark(mbed_boot_phase_t phase);
+
+/** Get the time a phase ended
+ *
+ * @param phase Phase
+ * @return      Microseconds from MBED_BOOT_START, MBED_BOOT_TIME_NONE if
+ *              the phase was not marked
+ */
+uint32_t mbed_boot_time_get(mbed_boot_phase_t phase);
+
+/** Print the table of phases with printf
+ *
+ * Each phase is printed with its end time and its duration.
+ */
+void mbed_boot_time_dump(void);
+
+#if defined(MBED_CONF_PLATFORM_BOOT_TIME) && MBED_CONF_PLATFORM_BOOT_TIME
+#define MBED_BOOT_TIME_MARK(phase) mbed_boot_time_mark(phase)
+#else
+#define MBED_BOOT_TIME_MARK(phase)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
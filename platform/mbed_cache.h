@@ -0,0 +1,156 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CACHE_H
+#define MBED_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cmsis.h"
+#include "platform/toolchain.h"
+
+/* Data cache maintenance for DMA buffers
+ *
+ * With the data cache of the Cortex-M7 enabled, the CPU and the DMA see
+ * different contents for a buffer until the cache lines are cleaned or
+ * invalidated:
+ * - before the DMA reads a buffer, mbed_dcache_clean writes the CPU's data
+ *   to memory
+ * - before the DMA writes a buffer, mbed_dcache_clean_invalidate makes
+ *   sure no dirty line is written back over its data later
+ * - after the DMA wrote a buffer, mbed_dcache_invalidate drops the stale
+ *   lines the CPU may have read meanwhile
+ *
+ * Invalidating also drops the CPU's writes to the rest of the lines, so
+ * buffers the DMA writes must not share a line with other data: align them
+ * with MBED_CACHE_ALIGNED and round their size with MBED_CACHE_ROUND_UP.
+ *
+ * The functions do nothing without a data cache, or while it is disabled,
+ * and are interrupt safe.
+ *
+ * Example:
+ * @code
+ * MBED_CACHE_ALIGNED static uint8_t rx[MBED_CACHE_ROUND_UP(100)];
+ *
+ * mbed_dcache_clean_invalidate(rx, sizeof(rx));
+ * start_dma_read(rx, 100);
+ * // once complete
+ * mbed_dcache_invalidate(rx, sizeof(rx));
+ * @endcode
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+/** Size of a data cache line */
+#define MBED_CACHE_LINE_SIZE    32
+#else
+#define MBED_CACHE_LINE_SIZE    4
+#endif
+
+/** Align a buffer on a cache line */
+#define MBED_CACHE_ALIGNED      MBED_ALIGN(MBED_CACHE_LINE_SIZE)
+
+/** Round a size up to whole cache lines */
+#define MBED_CACHE_ROUND_UP(size) \
+    (((size) + MBED_CACHE_LINE_SIZE - 1) & ~(MBED_CACHE_LINE_SIZE - 1))
+
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+
+/* Whole lines covering the range, NULL if the cache is disabled */
+static inline uint32_t *mbed_dcache_lines(const void *addr, size_t size, int32_t *lines_size)
+{
+    if (!(SCB->CCR & SCB_CCR_DC_Msk) || size == 0) {
+        return NULL;
+    }
+    uint32_t start = (uint32_t)addr & ~(uint32_t)(MBED_CACHE_LINE_SIZE - 1);
+    uint32_t end = MBED_CACHE_ROUND_UP((uint32_t)addr + size);
+    *lines_size = (int32_t)(end - start);
+    return (uint32_t *)start;
+}
+
+#endif
+
+/** Write the cached data of a range to memory, before the DMA reads it
+ *
+ * @param addr  Start of the range
+ * @param size  Size of the range in bytes
+ */
+static inline void mbed_dcache_clean(const void *addr, size_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+    int32_t lines_size;
+    uint32_t *lines = mbed_dcache_lines(addr, size, &lines_size);
+    if (lines) {
+        SCB_CleanDCache_by_Addr(lines, lines_size);
+    }
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/** Drop the cached data of a range, after the DMA wrote it
+ *
+ * The lines partly covered by the range are dropped as a whole.
+ *
+ * @param addr  Start of the range
+ * @param size  Size of the range in bytes
+ */
+static inline void mbed_dcache_invalidate(void *addr, size_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+    int32_t lines_size;
+    uint32_t *lines = mbed_dcache_lines(addr, size, &lines_size);
+    if (lines) {
+        SCB_InvalidateDCache_by_Addr(lines, lines_size);
+    }
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+/** Write the cached data of a range to memory and drop it, before the DMA
+ * writes the range
+ *
+ * @param addr  Start of the range
+ * @param size  Size of the range in bytes
+ */
+static inline void mbed_dcache_clean_invalidate(void *addr, size_t size)
+{
+#if defined(__DCACHE_PRESENT) && (__DCACHE_PRESENT == 1)
+    int32_t lines_size;
+    uint32_t *lines = mbed_dcache_lines(addr, size, &lines_size);
+    if (lines) {
+        SCB_CleanInvalidateDCache_by_Addr(lines, lines_size);
+    }
+#else
+    (void)addr;
+    (void)size;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
@@ -0,0 +1,155 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_clock.h"
+#include "platform/mbed_stats.h"
+#include "platform/critical.h"
+#include "platform/PlatformMutex.h"
+#include "platform/SingletonPtr.h"
+
+#ifndef MBED_CONF_PLATFORM_CLOCK_GOVERNOR_UP
+#define MBED_CONF_PLATFORM_CLOCK_GOVERNOR_UP    80
+#endif
+
+#ifndef MBED_CONF_PLATFORM_CLOCK_GOVERNOR_DOWN
+#define MBED_CONF_PLATFORM_CLOCK_GOVERNOR_DOWN  30
+#endif
+
+#if DEVICE_CLOCK_SCALING
+
+static SingletonPtr<PlatformMutex> clock_mutex;
+static SingletonPtr<mbed::IntrusiveCallChain> clock_listeners;
+static clock_profile_t clock_profile = CLOCK_PROFILE_HIGH;
+static uint32_t clock_high_locks;
+
+// With the mutex held
+static int clock_switch(clock_profile_t profile)
+{
+    if (profile == clock_profile) {
+        return 0;
+    }
+
+    core_util_critical_section_enter();
+    int ret = clock_set_profile(profile);
+    core_util_critical_section_exit();
+    if (ret != 0) {
+        return -1;
+    }
+
+    clock_profile = profile;
+    clock_listeners->call();
+    return 0;
+}
+
+int mbed_clock_set_profile(clock_profile_t profile)
+{
+    clock_mutex->lock();
+    int ret = clock_switch(profile);
+    clock_mutex->unlock();
+    return ret;
+}
+
+clock_profile_t mbed_clock_get_profile(void)
+{
+    return clock_profile;
+}
+
+void mbed_clock_lock_high(void)
+{
+    clock_mutex->lock();
+    clock_high_locks++;
+    clock_switch(CLOCK_PROFILE_HIGH);
+    clock_mutex->unlock();
+}
+
+void mbed_clock_unlock_high(void)
+{
+    clock_mutex->lock();
+    if (clock_high_locks > 0) {
+        clock_high_locks--;
+    }
+    clock_mutex->unlock();
+}
+
+void mbed_clock_governor(void)
+{
+#if defined(MBED_THREAD_CPU_STATS_ENABLED) && MBED_THREAD_CPU_STATS_ENABLED
+    static uint64_t last_total;
+    static uint64_t last_idle;
+
+    mbed_stats_cpu_t stats;
+    mbed_stats_cpu_get(&stats);
+
+    clock_mutex->lock();
+    uint64_t total = stats.total_time - last_total;
+    uint64_t busy = total - (stats.idle_time - last_idle);
+    last_total = stats.total_time;
+    last_idle = stats.idle_time;
+
+    if (total > 0) {
+        uint32_t load = (uint32_t)(busy * 100 / total);
+        if (load >= MBED_CONF_PLATFORM_CLOCK_GOVERNOR_UP) {
+            clock_switch(CLOCK_PROFILE_HIGH);
+        } else if (load <= MBED_CONF_PLATFORM_CLOCK_GOVERNOR_DOWN && clock_high_locks == 0) {
+            clock_switch(CLOCK_PROFILE_LOW);
+        }
+    }
+    clock_mutex->unlock();
+#endif
+}
+
+void mbed_clock_attach(mbed::CallChainEntry *entry)
+{
+    clock_listeners->add(entry);
+}
+
+void mbed_clock_detach(mbed::CallChainEntry *entry)
+{
+    clock_listeners->remove(entry);
+}
+
+#else
+
+int mbed_clock_set_profile(clock_profile_t profile)
+{
+    return profile == CLOCK_PROFILE_HIGH ? 0 : -1;
+}
+
+clock_profile_t mbed_clock_get_profile(void)
+{
+    return CLOCK_PROFILE_HIGH;
+}
+
+void mbed_clock_lock_high(void)
+{
+}
+
+void mbed_clock_unlock_high(void)
+{
+}
+
+void mbed_clock_governor(void)
+{
+}
+
+void mbed_clock_attach(mbed::CallChainEntry *entry)
+{
+}
+
+void mbed_clock_detach(mbed::CallChainEntry *entry)
+{
+}
+
+#endif
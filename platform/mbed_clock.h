@@ -0,0 +1,109 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CLOCK_H
+#define MBED_CLOCK_H
+
+#include "hal/clock_api.h"
+
+/* Clock scaling
+ *
+ * On targets with DEVICE_CLOCK_SCALING, the core and bus clocks switch at
+ * runtime between a low and a high profile. Drivers whose dividers depend
+ * on the bus clock, such as Serial and SPI, are told by a CallChainEntry
+ * added with mbed_clock_attach and reconfigure their peripheral.
+ *
+ * The profile is set by the application, or by the governor: called
+ * periodically, mbed_clock_governor switches to the high profile when the
+ * CPU load since its last call goes over platform.clock-governor-up
+ * percent, and back to the low one under platform.clock-governor-down.
+ * A section needing the full speed, such as a TLS handshake, holds the
+ * high profile with mbed_clock_lock_high.
+ *
+ * Example:
+ * @code
+ * EventQueue queue;
+ *
+ * int main() {
+ *     queue.call_every(100, mbed_clock_governor);
+ *     queue.dispatch_forever();
+ * }
+ * @endcode
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Switch the core and bus clocks to a profile
+ *
+ * Not from interrupts, the drivers reconfiguring their peripheral after
+ * the switch.
+ *
+ * @param profile The profile to switch to
+ * @return 0 on success, -1 if the target cannot switch
+ */
+int mbed_clock_set_profile(clock_profile_t profile);
+
+/** Get the current clock profile
+ *
+ * @return The profile, CLOCK_PROFILE_HIGH on targets without clock scaling
+ */
+clock_profile_t mbed_clock_get_profile(void);
+
+/** Switch to the high profile until mbed_clock_unlock_high
+ *
+ * Locks nest, the governor may lower the clock once each lock is unlocked.
+ */
+void mbed_clock_lock_high(void);
+
+/** Undo one mbed_clock_lock_high
+ */
+void mbed_clock_unlock_high(void);
+
+/** Choose the profile from the CPU load since the last call
+ *
+ * Requires the MBED_THREAD_CPU_STATS_ENABLED macro, does nothing
+ * otherwise. To be called periodically from a thread.
+ */
+void mbed_clock_governor(void);
+
+#ifdef __cplusplus
+}
+
+#include "platform/IntrusiveCallChain.h"
+
+/** Call an entry after each clock switch
+ *
+ * The entry is called from the thread switching, after SystemCoreClock
+ * is updated.
+ *
+ * @param entry Entry not in a chain
+ */
+void mbed_clock_attach(mbed::CallChainEntry *entry);
+
+/** Stop calling an entry after clock switches
+ *
+ * @param entry Entry added with mbed_clock_attach
+ */
+void mbed_clock_detach(mbed::CallChainEntry *entry);
+
+#endif
+
+#endif
+
+/** @}*/
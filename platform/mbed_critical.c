@@ -21,7 +21,7 @@
 #include "platform/mbed_assert.h"
 #include "platform/toolchain.h"
 
-#define EXCLUSIVE_ACCESS (!defined (__CORTEX_M0) && !defined (__CORTEX_M0PLUS))
+#define EXCLUSIVE_ACCESS (!defined (__CORTEX_M0) && !defined (__CORTEX_M0PLUS) && !defined (TARGET_LIKE_POSIX))
 
 static volatile uint32_t interrupt_enable_counter = 0;
 static volatile bool critical_interrupts_disabled = false;
@@ -85,6 +85,62 @@ MBED_WEAK void core_util_critical_section_exit(void)
     }
 }
 
+#if defined(MBED_CONF_PLATFORM_IRQ_MASK_PRIORITY) && defined(__CORTEX_M) && (__CORTEX_M >= 3)
+#define IRQ_MASK_BASEPRI    ((MBED_CONF_PLATFORM_IRQ_MASK_PRIORITY << (8 - __NVIC_PRIO_BITS)) & 0xFF)
+
+#if MBED_CONF_PLATFORM_IRQ_MASK_PRIORITY <= 0 || MBED_CONF_PLATFORM_IRQ_MASK_PRIORITY >= (1 << __NVIC_PRIO_BITS)
+#error "platform.irq-mask-priority must be between 1 and the lowest interrupt priority"
+#endif
+
+uint32_t core_util_irq_mask_enter(void)
+{
+    uint32_t state = __get_BASEPRI();
+#if (__CORTEX_M == 0x07)
+    /* Erratum 837070 of the r0p1 core: an interrupt can be taken right after
+     * BASEPRI is raised, unless interrupts are disabled around the write */
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    __set_BASEPRI_MAX(IRQ_MASK_BASEPRI);
+    __set_PRIMASK(primask);
+#else
+    __set_BASEPRI_MAX(IRQ_MASK_BASEPRI);
+#endif
+    return state;
+}
+
+void core_util_irq_mask_exit(uint32_t state)
+{
+    __set_BASEPRI(state);
+}
+
+void core_util_irq_mask_init(void)
+{
+    uint32_t irqs = ((SCnSCB->ICTR & SCnSCB_ICTR_INTLINESNUM_Msk) + 1) * 32;
+
+    for (uint32_t i = 0; i < irqs; i++) {
+        if (NVIC_GetPriority((IRQn_Type)i) == 0) {
+            NVIC_SetPriority((IRQn_Type)i, MBED_CONF_PLATFORM_IRQ_MASK_PRIORITY);
+        }
+    }
+}
+#else
+uint32_t core_util_irq_mask_enter(void)
+{
+    core_util_critical_section_enter();
+    return 0;
+}
+
+void core_util_irq_mask_exit(uint32_t state)
+{
+    (void)state;
+    core_util_critical_section_exit();
+}
+
+void core_util_irq_mask_init(void)
+{
+}
+#endif
+
 #if EXCLUSIVE_ACCESS
 
 /* Supress __ldrex and __strex deprecated warnings - "#3731-D: intrinsic is deprecated" */
@@ -303,18 +359,154 @@ uint32_t core_util_atomic_decr_u32(uint32_t *valuePtr, uint32_t delta)
 #endif
 
 
+/* Pointers are 32 bits on the targets, but 64 bits on most hosts */
+#if UINTPTR_MAX > UINT32_MAX
+typedef uint64_t atomic_ptr_t;
+#define ATOMIC_PTR(op) core_util_atomic_##op##_u64
+#else
+typedef uint32_t atomic_ptr_t;
+#define ATOMIC_PTR(op) core_util_atomic_##op##_u32
+#endif
+
 bool core_util_atomic_cas_ptr(void **ptr, void **expectedCurrentValue, void *desiredValue) {
-    return core_util_atomic_cas_u32(
-            (uint32_t *)ptr,
-            (uint32_t *)expectedCurrentValue,
-            (uint32_t)desiredValue);
+    return ATOMIC_PTR(cas)(
+            (atomic_ptr_t *)ptr,
+            (atomic_ptr_t *)expectedCurrentValue,
+            (atomic_ptr_t)(uintptr_t)desiredValue);
 }
 
 void *core_util_atomic_incr_ptr(void **valuePtr, ptrdiff_t delta) {
-    return (void *)core_util_atomic_incr_u32((uint32_t *)valuePtr, (uint32_t)delta);
+    return (void *)(uintptr_t)ATOMIC_PTR(incr)((atomic_ptr_t *)valuePtr, (atomic_ptr_t)delta);
 }
 
 void *core_util_atomic_decr_ptr(void **valuePtr, ptrdiff_t delta) {
-    return (void *)core_util_atomic_decr_u32((uint32_t *)valuePtr, (uint32_t)delta);
+    return (void *)(uintptr_t)ATOMIC_PTR(decr)((atomic_ptr_t *)valuePtr, (atomic_ptr_t)delta);
+}
+
+
+/* Aligned loads and stores of up to 32 bits are single accesses on every core */
+#define ATOMIC_LOAD_STORE(bits)                                                             \
+uint##bits##_t core_util_atomic_load_u##bits(const uint##bits##_t *valuePtr)                \
+{                                                                                           \
+    uint##bits##_t value = *(const volatile uint##bits##_t *)valuePtr;                      \
+    __DMB();                                                                                \
+    return value;                                                                           \
+}                                                                                           \
+                                                                                            \
+void core_util_atomic_store_u##bits(uint##bits##_t *valuePtr, uint##bits##_t desiredValue) \
+{                                                                                           \
+    __DMB();                                                                                \
+    *(volatile uint##bits##_t *)valuePtr = desiredValue;                                    \
+    __DMB();                                                                                \
+}
+
+ATOMIC_LOAD_STORE(8)
+ATOMIC_LOAD_STORE(16)
+ATOMIC_LOAD_STORE(32)
+
+#define ATOMIC_FETCH_OP_CRITICAL(name, bits, arg, newValue)                                 \
+uint##bits##_t core_util_atomic_##name##_u##bits(uint##bits##_t *valuePtr, uint##bits##_t arg) \
+{                                                                                           \
+    uint##bits##_t oldValue;                                                                \
+    core_util_critical_section_enter();                                                     \
+    oldValue = *valuePtr;                                                                   \
+    *valuePtr = (uint##bits##_t)(newValue);                                                 \
+    core_util_critical_section_exit();                                                      \
+    return oldValue;                                                                        \
+}
+
+#define ATOMIC_FETCH_OPS(op, bits)                      \
+    op(exchange, bits, desiredValue, desiredValue)      \
+    op(fetch_add, bits, arg, oldValue + arg)            \
+    op(fetch_sub, bits, arg, oldValue - arg)            \
+    op(fetch_and, bits, arg, oldValue & arg)            \
+    op(fetch_or, bits, arg, oldValue | arg)             \
+    op(fetch_xor, bits, arg, oldValue ^ arg)
+
+#if EXCLUSIVE_ACCESS
+
+/* The exclusive access intrinsics by width */
+#define __LDREX8    __LDREXB
+#define __LDREX16   __LDREXH
+#define __LDREX32   __LDREXW
+#define __STREX8    __STREXB
+#define __STREX16   __STREXH
+#define __STREX32   __STREXW
+
+#define ATOMIC_FETCH_OP(name, bits, arg, newValue)                                          \
+uint##bits##_t core_util_atomic_##name##_u##bits(uint##bits##_t *valuePtr, uint##bits##_t arg) \
+{                                                                                           \
+    uint##bits##_t oldValue;                                                                \
+    __DMB();                                                                                \
+    do {                                                                                    \
+        oldValue = __LDREX##bits((volatile uint##bits##_t *)valuePtr);                      \
+    } while (__STREX##bits((uint##bits##_t)(newValue), (volatile uint##bits##_t *)valuePtr)); \
+    __DMB();                                                                                \
+    return oldValue;                                                                        \
+}
+
+#else
+#define ATOMIC_FETCH_OP ATOMIC_FETCH_OP_CRITICAL
+#endif
+
+ATOMIC_FETCH_OPS(ATOMIC_FETCH_OP, 8)
+ATOMIC_FETCH_OPS(ATOMIC_FETCH_OP, 16)
+ATOMIC_FETCH_OPS(ATOMIC_FETCH_OP, 32)
+
+/* No exclusive access of 64 bits on the Cortex-M */
+ATOMIC_FETCH_OPS(ATOMIC_FETCH_OP_CRITICAL, 64)
+
+uint64_t core_util_atomic_load_u64(const uint64_t *valuePtr)
+{
+    uint64_t value;
+    core_util_critical_section_enter();
+    value = *valuePtr;
+    core_util_critical_section_exit();
+    return value;
+}
+
+void core_util_atomic_store_u64(uint64_t *valuePtr, uint64_t desiredValue)
+{
+    core_util_critical_section_enter();
+    *valuePtr = desiredValue;
+    core_util_critical_section_exit();
+}
+
+bool core_util_atomic_cas_u64(uint64_t *ptr, uint64_t *expectedCurrentValue, uint64_t desiredValue)
+{
+    bool success;
+    uint64_t currentValue;
+    core_util_critical_section_enter();
+    currentValue = *ptr;
+    if (currentValue == *expectedCurrentValue) {
+        *ptr = desiredValue;
+        success = true;
+    } else {
+        *expectedCurrentValue = currentValue;
+        success = false;
+    }
+    core_util_critical_section_exit();
+    return success;
 }
 
+uint64_t core_util_atomic_incr_u64(uint64_t *valuePtr, uint64_t delta)
+{
+    return core_util_atomic_fetch_add_u64(valuePtr, delta) + delta;
+}
+
+uint64_t core_util_atomic_decr_u64(uint64_t *valuePtr, uint64_t delta)
+{
+    return core_util_atomic_fetch_sub_u64(valuePtr, delta) - delta;
+}
+
+void *core_util_atomic_load_ptr(void *const *valuePtr) {
+    return (void *)(uintptr_t)ATOMIC_PTR(load)((const atomic_ptr_t *)valuePtr);
+}
+
+void core_util_atomic_store_ptr(void **valuePtr, void *desiredValue) {
+    ATOMIC_PTR(store)((atomic_ptr_t *)valuePtr, (atomic_ptr_t)(uintptr_t)desiredValue);
+}
+
+void *core_util_atomic_exchange_ptr(void **valuePtr, void *desiredValue) {
+    return (void *)(uintptr_t)ATOMIC_PTR(exchange)((atomic_ptr_t *)valuePtr, (atomic_ptr_t)(uintptr_t)desiredValue);
+}
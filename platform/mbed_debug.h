@@ -28,14 +28,24 @@ extern "C" {
 #include <stdio.h>
 #include <stdarg.h>
 
+#if defined(MBED_CONF_PLATFORM_BINLOG_DEBUG) && MBED_CONF_PLATFORM_BINLOG_DEBUG
+#include "platform/mbed_binlog.h"
+#define MBED_DEBUG_VPRINTF(format, args)    mbed_binlog_vprintf(format, args)
+#else
+#define MBED_DEBUG_VPRINTF(format, args)    vfprintf(stderr, format, args)
+#endif
+
 /** Output a debug message
+ *
+ * With the platform.binlog-debug option, the message goes to the deferred
+ * binary log of mbed_binlog.h instead of stderr.
  *
  * @param format printf-style format string, followed by variables
  */
 static inline void debug(const char *format, ...) {
     va_list args;
     va_start(args, format);
-    vfprintf(stderr, format, args);
+    MBED_DEBUG_VPRINTF(format, args);
     va_end(args);
 }
 
@@ -51,7 +61,7 @@ static inline void debug_if(int condition, const char *format, ...) {
     if (condition == 1) {
         va_list args;
         va_start(args, format);
-        vfprintf(stderr, format, args);
+        MBED_DEBUG_VPRINTF(format, args);
         va_end(args);
     }
 }
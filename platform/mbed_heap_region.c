@@ -0,0 +1,129 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform/mbed_heap_region.h"
+#include "platform/toolchain.h"
+#include <stdlib.h>
+
+#ifndef MBED_CONF_PLATFORM_HEAP_REGION_FALLBACK
+#define MBED_CONF_PLATFORM_HEAP_REGION_FALLBACK 1
+#endif
+
+#if defined(TOOLCHAIN_GCC) && !defined(FEATURE_UVISOR)
+
+/* Undefined in linker scripts without the region, their address is then 0 */
+extern char __mbed_heap_fast_start[] MBED_WEAK;
+extern char __mbed_heap_fast_end[] MBED_WEAK;
+extern char __mbed_heap_external_start[] MBED_WEAK;
+extern char __mbed_heap_external_end[] MBED_WEAK;
+
+struct _reent;
+extern void __malloc_lock(struct _reent *r);
+extern void __malloc_unlock(struct _reent *r);
+
+typedef struct {
+    char *start;
+    char *end;
+    mbed_tlsf_t *heap;
+    int created;
+} heap_region_t;
+
+static heap_region_t heap_regions[MBED_HEAP_REGION_COUNT] = {
+    { NULL, NULL, NULL, 1 },
+    { __mbed_heap_fast_start, __mbed_heap_fast_end, NULL, 0 },
+    { __mbed_heap_external_start, __mbed_heap_external_end, NULL, 0 },
+};
+
+static mbed_tlsf_t *heap_region_get(mbed_heap_region_t region)
+{
+    if ((unsigned)region >= MBED_HEAP_REGION_COUNT) {
+        return NULL;
+    }
+
+    heap_region_t *r = &heap_regions[region];
+    if (!r->created) {
+        __malloc_lock(NULL);
+        if (!r->created) {
+            if (r->start && r->end > r->start) {
+                r->heap = mbed_tlsf_create(r->start, r->end - r->start);
+            }
+            r->created = 1;
+        }
+        __malloc_unlock(NULL);
+    }
+    return r->heap;
+}
+
+void *mbed_malloc_region(mbed_heap_region_t region, size_t size)
+{
+    mbed_tlsf_t *heap = heap_region_get(region);
+    if (heap) {
+        void *ptr = mbed_tlsf_heap_malloc(heap, size);
+        if (ptr || !MBED_CONF_PLATFORM_HEAP_REGION_FALLBACK) {
+            return ptr;
+        }
+    } else if (region != MBED_HEAP_REGION_DEFAULT && !MBED_CONF_PLATFORM_HEAP_REGION_FALLBACK) {
+        return NULL;
+    }
+
+    return malloc(size);
+}
+
+void mbed_free_region(void *ptr)
+{
+    for (int i = 0; i < MBED_HEAP_REGION_COUNT; i++) {
+        heap_region_t *r = &heap_regions[i];
+        if (r->heap && (char *)ptr >= r->start && (char *)ptr < r->end) {
+            mbed_tlsf_heap_free(r->heap, ptr);
+            return;
+        }
+    }
+
+    free(ptr);
+}
+
+int mbed_heap_region_get_info(mbed_heap_region_t region, mbed_tlsf_info_t *info)
+{
+    mbed_tlsf_t *heap = heap_region_get(region);
+    if (!heap) {
+        return -1;
+    }
+
+    mbed_tlsf_heap_get_info(heap, info);
+    return 0;
+}
+
+#else
+
+void *mbed_malloc_region(mbed_heap_region_t region, size_t size)
+{
+    if (region != MBED_HEAP_REGION_DEFAULT && !MBED_CONF_PLATFORM_HEAP_REGION_FALLBACK) {
+        return NULL;
+    }
+    return malloc(size);
+}
+
+void mbed_free_region(void *ptr)
+{
+    free(ptr);
+}
+
+int mbed_heap_region_get_info(mbed_heap_region_t region, mbed_tlsf_info_t *info)
+{
+    return -1;
+}
+
+#endif
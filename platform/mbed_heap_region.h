@@ -0,0 +1,93 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_HEAP_REGION_H
+#define MBED_HEAP_REGION_H
+
+#include <stddef.h>
+#include "platform/mbed_tlsf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Heaps in memory regions other than the malloc heap
+ *
+ * A target makes a region available by defining the symbols
+ * __mbed_heap_<region>_start and __mbed_heap_<region>_end in its linker
+ * script, around memory that nothing else uses. The heap of a region is
+ * created by its first allocation, memory that needs to be set up, such as
+ * external SDRAM, must be ready by then.
+ *
+ * By default, allocations from a region the target does not have, or that
+ * is full, come from the malloc heap instead, so code can ask for the
+ * memory it prefers on any target. The platform.heap-region-fallback
+ * option turns this off. All regions are GCC only, other toolchains always
+ * allocate from the malloc heap.
+ *
+ * Example:
+ * @code
+ * // Network buffers in fast internal memory, frame buffers in SDRAM
+ * uint8_t *rx = (uint8_t *)mbed_malloc_region(MBED_HEAP_REGION_FAST, 1536);
+ * uint16_t *fb = (uint16_t *)mbed_malloc_region(MBED_HEAP_REGION_EXTERNAL, 480 * 272 * 2);
+ * ...
+ * mbed_free_region(fb);
+ * mbed_free_region(rx);
+ * @endcode
+ */
+
+typedef enum {
+    MBED_HEAP_REGION_DEFAULT,   /**< The malloc heap */
+    MBED_HEAP_REGION_FAST,      /**< Fast internal memory, such as DTCM, __mbed_heap_fast_start */
+    MBED_HEAP_REGION_EXTERNAL,  /**< Large external memory, such as SDRAM, __mbed_heap_external_start */
+    MBED_HEAP_REGION_COUNT
+} mbed_heap_region_t;
+
+/** Allocate memory from a region, aligned to 8 bytes
+ *
+ * @param region Region to allocate from
+ * @param size   Size in bytes
+ * @return Allocated memory, NULL if neither the region nor the fallback
+ *         has enough memory
+ */
+void *mbed_malloc_region(mbed_heap_region_t region, size_t size);
+
+/** Free memory from mbed_malloc_region
+ *
+ * The region is found from the address, so memory that came from the
+ * malloc heap is freed there.
+ *
+ * @param ptr Memory from mbed_malloc_region, or NULL
+ */
+void mbed_free_region(void *ptr);
+
+/** Get the state of the heap of a region
+ *
+ * @param region Region other than MBED_HEAP_REGION_DEFAULT
+ * @param info   Filled with the state of the heap
+ * @return 0 on success, -1 if the target does not have the region
+ */
+int mbed_heap_region_get_info(mbed_heap_region_t region, mbed_tlsf_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
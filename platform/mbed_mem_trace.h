@@ -133,6 +133,76 @@ void mbed_mem_trace_free(void *ptr, void *caller);
  */
 void mbed_mem_trace_default_callback(uint8_t op, void *res, void *caller, ...);
 
+/** First word of each packet of the binary tracer, "MTRK" on the wire */
+#define MBED_MEM_TRACE_BINARY_MAGIC     0x4B52544D
+
+/**
+ * Record of the binary tracer, 16 bytes in little endian order on the wire.
+ *
+ * A successful realloc is a free record of the old pointer followed by a
+ * realloc record of the new one.
+ */
+typedef struct {
+    uint32_t time;          /**< us_ticker_read() when the operation was traced. */
+    uint32_t ptr;           /**< Result of the operation, the freed pointer for 'free'. */
+    uint32_t caller;        /**< Caller of the operation. */
+    uint32_t size_op;       /**< Requested size shifted left by 3, or'ed with the operation ID. */
+} mbed_mem_trace_record_t;
+
+/**
+ * Type of the function the binary tracer writes its packets with.
+ *
+ * @param data packet, a header of MBED_MEM_TRACE_BINARY_MAGIC, the 16 bit
+ *             number of records and the 16 bit number of records dropped
+ *             since the previous packet, followed by the records.
+ * @param size size of the packet in bytes.
+ */
+typedef void (*mbed_mem_trace_write_t)(const void *data, size_t size);
+
+/**
+ * Binary memory trace callback. DO NOT CALL DIRECTLY. It is meant to be used
+ * with 'mbed_mem_trace_set_callback', or set by 'mbed_mem_trace_binary_start'.
+ *
+ * Unlike the default callback, it only stores a fixed-size record in a
+ * lock-free ring of MBED_CONF_PLATFORM_MEM_TRACE_BINARY_RECORDS entries,
+ * which 'mbed_mem_trace_binary_flush' writes out later. Records that find
+ * the ring full are dropped and counted. tools/mem_trace.py decodes the
+ * packets into leak reports and allocation timelines.
+ */
+void mbed_mem_trace_binary_callback(uint8_t op, void *res, void *caller, ...);
+
+/**
+ * Write the records stored by the binary tracer.
+ *
+ * @param write the function to write the packets with.
+ * @return the number of records written.
+ */
+size_t mbed_mem_trace_binary_flush(mbed_mem_trace_write_t write);
+
+/**
+ * Start the binary tracer.
+ *
+ * Sets the binary callback as the memory trace callback. With the RTOS, a
+ * low priority thread then flushes the records every
+ * MBED_CONF_PLATFORM_MEM_TRACE_BINARY_PERIOD milliseconds, without the RTOS
+ * the application calls 'mbed_mem_trace_binary_flush' itself.
+ *
+ * @param write the function to write the packets with,
+ *              'mbed_mem_trace_binary_write_stdout' if NULL.
+ */
+void mbed_mem_trace_binary_start(mbed_mem_trace_write_t write);
+
+/**
+ * Write binary trace packets to stdout, which must not convert newlines.
+ */
+void mbed_mem_trace_binary_write_stdout(const void *data, size_t size);
+
+/**
+ * Write binary trace packets to ITM stimulus port 0, for SWO capture. The
+ * data is discarded unless a debugger enables the ITM. Cortex-M3 and above.
+ */
+void mbed_mem_trace_binary_write_swo(const void *data, size_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,179 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform/mbed_mem_trace.h"
+#include "platform/LockFreeCircularBuffer.h"
+#include "platform/SingletonPtr.h"
+#include "platform/PlatformMutex.h"
+#include "platform/critical.h"
+#include "hal/us_ticker_api.h"
+#include "cmsis.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef MBED_CONF_RTOS_PRESENT
+#include "rtos/Thread.h"
+#endif
+
+#ifndef MBED_CONF_PLATFORM_MEM_TRACE_BINARY_RECORDS
+#define MBED_CONF_PLATFORM_MEM_TRACE_BINARY_RECORDS     128
+#endif
+#ifndef MBED_CONF_PLATFORM_MEM_TRACE_BINARY_PERIOD
+#define MBED_CONF_PLATFORM_MEM_TRACE_BINARY_PERIOD      100
+#endif
+#ifndef MBED_CONF_PLATFORM_MEM_TRACE_BINARY_STACK_SIZE
+#define MBED_CONF_PLATFORM_MEM_TRACE_BINARY_STACK_SIZE  1024
+#endif
+
+/* Records written per packet */
+#define TRACE_PACKET_RECORDS    16
+
+typedef struct {
+    uint32_t magic;
+    uint16_t count;
+    uint16_t dropped;
+    mbed_mem_trace_record_t records[TRACE_PACKET_RECORDS];
+} trace_packet_t;
+
+static mbed::MPSCCircularBuffer<mbed_mem_trace_record_t, MBED_CONF_PLATFORM_MEM_TRACE_BINARY_RECORDS> trace_ring;
+static uint32_t trace_dropped;
+/* Serializes the consumers of the ring */
+static SingletonPtr<PlatformMutex> trace_flush_mutex;
+static mbed_mem_trace_write_t trace_write;
+
+static void trace_push(uint8_t op, void *ptr, void *caller, size_t size)
+{
+    mbed_mem_trace_record_t record;
+    record.time = us_ticker_read();
+    record.ptr = (uint32_t)ptr;
+    record.caller = (uint32_t)caller;
+    record.size_op = ((uint32_t)size << 3) | op;
+
+    if (!trace_ring.push(record)) {
+        core_util_atomic_incr_u32(&trace_dropped, 1);
+    }
+}
+
+extern "C" void mbed_mem_trace_binary_callback(uint8_t op, void *res, void *caller, ...)
+{
+    va_list va;
+    size_t size;
+    void *ptr;
+
+    va_start(va, caller);
+    switch (op) {
+        case MBED_MEM_TRACE_MALLOC:
+            trace_push(op, res, caller, va_arg(va, size_t));
+            break;
+
+        case MBED_MEM_TRACE_REALLOC:
+            ptr = va_arg(va, void*);
+            size = va_arg(va, size_t);
+            // The old block is freed unless realloc failed
+            if (ptr != NULL && (res != NULL || size == 0)) {
+                trace_push(MBED_MEM_TRACE_FREE, ptr, caller, 0);
+            }
+            trace_push(op, res, caller, size);
+            break;
+
+        case MBED_MEM_TRACE_CALLOC:
+            size = va_arg(va, size_t);
+            size *= va_arg(va, size_t);
+            trace_push(op, res, caller, size);
+            break;
+
+        case MBED_MEM_TRACE_FREE:
+            trace_push(op, va_arg(va, void*), caller, 0);
+            break;
+    }
+    va_end(va);
+}
+
+extern "C" size_t mbed_mem_trace_binary_flush(mbed_mem_trace_write_t write)
+{
+    trace_packet_t packet;
+    size_t total = 0;
+
+    trace_flush_mutex->lock();
+    while (true) {
+        size_t count = trace_ring.pop(packet.records, TRACE_PACKET_RECORDS);
+        uint32_t dropped = trace_dropped;
+        if (count == 0 && dropped == 0) {
+            break;
+        }
+
+        // The drops still counted after a packet go in the next one
+        if (dropped > 0xffff) {
+            dropped = 0xffff;
+        }
+        core_util_atomic_decr_u32(&trace_dropped, dropped);
+
+        packet.magic = MBED_MEM_TRACE_BINARY_MAGIC;
+        packet.count = count;
+        packet.dropped = dropped;
+        write(&packet, offsetof(trace_packet_t, records) + count * sizeof(mbed_mem_trace_record_t));
+        total += count;
+
+        if (count < TRACE_PACKET_RECORDS) {
+            break;
+        }
+    }
+    trace_flush_mutex->unlock();
+
+    return total;
+}
+
+extern "C" void mbed_mem_trace_binary_write_stdout(const void *data, size_t size)
+{
+    fwrite(data, 1, size, stdout);
+    fflush(stdout);
+}
+
+extern "C" void mbed_mem_trace_binary_write_swo(const void *data, size_t size)
+{
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++) {
+        ITM_SendChar(bytes[i]);
+    }
+#endif
+}
+
+#ifdef MBED_CONF_RTOS_PRESENT
+static void trace_drain()
+{
+    while (true) {
+        mbed_mem_trace_binary_flush(trace_write);
+        rtos::Thread::wait(MBED_CONF_PLATFORM_MEM_TRACE_BINARY_PERIOD);
+    }
+}
+#endif
+
+extern "C" void mbed_mem_trace_binary_start(mbed_mem_trace_write_t write)
+{
+    trace_write = write ? write : mbed_mem_trace_binary_write_stdout;
+
+#ifdef MBED_CONF_RTOS_PRESENT
+    static rtos::Thread *drain_thread;
+    if (!drain_thread) {
+        drain_thread = new rtos::Thread(osPriorityLow, MBED_CONF_PLATFORM_MEM_TRACE_BINARY_STACK_SIZE);
+        drain_thread->start(trace_drain);
+    }
+#endif
+
+    mbed_mem_trace_set_callback(mbed_mem_trace_binary_callback);
+}
@@ -0,0 +1,239 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if defined(__GNUC__) && !defined(__CC_ARM) && !defined(__clang__)
+// Keep GCC from turning the byte loops back into calls to memcpy and memset
+#pragma GCC optimize ("no-tree-loop-distribute-patterns")
+#endif
+
+#include "platform/mbed_memcpy.h"
+#include "platform/toolchain.h"
+#include "cmsis.h"
+#include <stdint.h>
+
+#ifndef MBED_CONF_PLATFORM_FAST_MEMCPY
+#define MBED_CONF_PLATFORM_FAST_MEMCPY  0
+#endif
+
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+// LDR and STR take unaligned addresses, LDM and STM do not
+#define MEMCPY_UNALIGNED    1
+#else
+#define MEMCPY_UNALIGNED    0
+#endif
+
+/* Below this, aligning the destination costs more than it saves */
+#define MEMCPY_WORD_MIN     16
+
+#if MEMCPY_UNALIGNED
+typedef MBED_PACKED(struct) {
+    uint32_t value;
+} memcpy_unaligned_t;
+
+#define LOAD_UNALIGNED(p)   (((const memcpy_unaligned_t *)(p))->value)
+#endif
+
+/* Copy 16 bytes between word aligned addresses */
+MBED_FORCEINLINE void copy_block(uint32_t **dst, const uint32_t **src)
+{
+#if defined(__GNUC__) && !defined(__CC_ARM) && defined(__arm__)
+    uint32_t *d = *dst;
+    const uint32_t *s = *src;
+    __asm volatile (
+        "ldmia %1!, {r3, r4, r5, r6}\n"
+        "stmia %0!, {r3, r4, r5, r6}\n"
+        : "+l" (d), "+l" (s)
+        :
+        : "r3", "r4", "r5", "r6", "memory");
+    *dst = d;
+    *src = s;
+#else
+    // The ARM and IAR compilers pair these into LDM and STM
+    uint32_t *d = *dst;
+    const uint32_t *s = *src;
+    uint32_t a = s[0], b = s[1], c = s[2], e = s[3];
+    d[0] = a;
+    d[1] = b;
+    d[2] = c;
+    d[3] = e;
+    *dst = d + 4;
+    *src = s + 4;
+#endif
+}
+
+void *mbed_memcpy(void *dst, const void *src, size_t n)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    if (n >= MEMCPY_WORD_MIN) {
+        while ((uintptr_t)d & 3) {
+            *d++ = *s++;
+            n--;
+        }
+
+        uint32_t *dw = (uint32_t *)d;
+        if (((uintptr_t)s & 3) == 0) {
+            const uint32_t *sw = (const uint32_t *)s;
+            for (; n >= 16; n -= 16) {
+                copy_block(&dw, &sw);
+            }
+            for (; n >= 4; n -= 4) {
+                *dw++ = *sw++;
+            }
+            s = (const uint8_t *)sw;
+        } else {
+#if MEMCPY_UNALIGNED
+            for (; n >= 16; n -= 16) {
+                uint32_t a = LOAD_UNALIGNED(s);
+                uint32_t b = LOAD_UNALIGNED(s + 4);
+                uint32_t c = LOAD_UNALIGNED(s + 8);
+                uint32_t e = LOAD_UNALIGNED(s + 12);
+                dw[0] = a;
+                dw[1] = b;
+                dw[2] = c;
+                dw[3] = e;
+                dw += 4;
+                s += 16;
+            }
+            for (; n >= 4; n -= 4) {
+                *dw++ = LOAD_UNALIGNED(s);
+                s += 4;
+            }
+#else
+            // Little endian: the low bytes of a destination word come from
+            // the high bytes of the aligned source word before them. Every
+            // word read holds bytes of the source, so nothing past it is read.
+            unsigned shift = ((uintptr_t)s & 3) * 8;
+            const uint32_t *sw = (const uint32_t *)((uintptr_t)s & ~(uintptr_t)3);
+            uint32_t w = *sw++;
+            for (; n >= 4; n -= 4) {
+                uint32_t next = *sw++;
+                *dw++ = (w >> shift) | (next << (32 - shift));
+                w = next;
+                s += 4;
+            }
+#endif
+        }
+        d = (uint8_t *)dw;
+    }
+
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+void *mbed_memmove(void *dst, const void *src, size_t n)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+
+    // A forward copy reads each block before writing below it
+    if (d <= s || d >= s + n) {
+        return mbed_memcpy(dst, src, n);
+    }
+
+    d += n;
+    s += n;
+    if (n >= MEMCPY_WORD_MIN) {
+        while ((uintptr_t)d & 3) {
+            *--d = *--s;
+            n--;
+        }
+
+        uint32_t *dw = (uint32_t *)d;
+        if (((uintptr_t)s & 3) == 0) {
+            const uint32_t *sw = (const uint32_t *)s;
+            for (; n >= 16; n -= 16) {
+                uint32_t a = sw[-1], b = sw[-2], c = sw[-3], e = sw[-4];
+                dw[-1] = a;
+                dw[-2] = b;
+                dw[-3] = c;
+                dw[-4] = e;
+                dw -= 4;
+                sw -= 4;
+            }
+            for (; n >= 4; n -= 4) {
+                *--dw = *--sw;
+            }
+            s = (const uint8_t *)sw;
+#if MEMCPY_UNALIGNED
+        } else {
+            for (; n >= 4; n -= 4) {
+                s -= 4;
+                *--dw = LOAD_UNALIGNED(s);
+            }
+#endif
+        }
+        // On Cortex-M0, misaligned overlapping moves finish byte-wise
+        d = (uint8_t *)dw;
+    }
+
+    while (n--) {
+        *--d = *--s;
+    }
+    return dst;
+}
+
+void *mbed_memset(void *dst, int c, size_t n)
+{
+    uint8_t *d = (uint8_t *)dst;
+
+    if (n >= MEMCPY_WORD_MIN) {
+        while ((uintptr_t)d & 3) {
+            *d++ = (uint8_t)c;
+            n--;
+        }
+
+        uint32_t w = (uint8_t)c * 0x01010101UL;
+        uint32_t *dw = (uint32_t *)d;
+        for (; n >= 16; n -= 16) {
+            dw[0] = w;
+            dw[1] = w;
+            dw[2] = w;
+            dw[3] = w;
+            dw += 4;
+        }
+        for (; n >= 4; n -= 4) {
+            *dw++ = w;
+        }
+        d = (uint8_t *)dw;
+    }
+
+    while (n--) {
+        *d++ = (uint8_t)c;
+    }
+    return dst;
+}
+
+#if MBED_CONF_PLATFORM_FAST_MEMCPY && defined(TOOLCHAIN_GCC)
+/* In place of the byte-wise functions of newlib-nano */
+void *memcpy(void *dst, const void *src, size_t n)
+{
+    return mbed_memcpy(dst, src, n);
+}
+
+void *memmove(void *dst, const void *src, size_t n)
+{
+    return mbed_memmove(dst, src, n);
+}
+
+void *memset(void *dst, int c, size_t n)
+{
+    return mbed_memset(dst, c, n);
+}
+#endif
@@ -0,0 +1,73 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_MEMCPY_H
+#define MBED_MEMCPY_H
+
+#include <stddef.h>
+
+/* Word-wise memory copy and fill
+ *
+ * Small sizes are handled a byte at a time. Beyond that, the destination
+ * is aligned on a word, then 16 bytes are moved per iteration: with LDM
+ * and STM when the source is aligned as well, with unaligned LDR on
+ * Cortex-M3 and above otherwise, and by merging aligned words with shifts
+ * on Cortex-M0, which faults on unaligned accesses.
+ *
+ * The platform.fast-memcpy option makes memcpy, memset and memmove of the
+ * C library call these on GCC, newlib-nano having byte-wise ones. The ARM
+ * and IAR libraries already move words.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Copy memory, the areas must not overlap
+ *
+ * @param dst Destination
+ * @param src Source
+ * @param n   Number of bytes
+ * @return dst
+ */
+void *mbed_memcpy(void *dst, const void *src, size_t n);
+
+/** Copy memory, the areas may overlap
+ *
+ * @param dst Destination
+ * @param src Source
+ * @param n   Number of bytes
+ * @return dst
+ */
+void *mbed_memmove(void *dst, const void *src, size_t n);
+
+/** Fill memory
+ *
+ * @param dst Destination
+ * @param c   Value of the bytes, converted to unsigned char
+ * @param n   Number of bytes
+ * @return dst
+ */
+void *mbed_memset(void *dst, int c, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
@@ -0,0 +1,150 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_poll.h"
+#include "platform/critical.h"
+#include "drivers/Timer.h"
+#ifdef MBED_CONF_RTOS_PRESENT
+#include "rtos/Semaphore.h"
+#else
+#include "drivers/Timeout.h"
+#include "platform/mbed_sleep.h"
+#endif
+
+namespace mbed {
+
+// A thread blocked in poll(), linked for the time of the call from its stack
+struct poll_waiter {
+    poll_waiter *next;
+#ifdef MBED_CONF_RTOS_PRESENT
+    rtos::Semaphore sem;
+
+    poll_waiter() : next(NULL), sem(0) {}
+#else
+    volatile bool woken;
+
+    poll_waiter() : next(NULL), woken(false) {}
+
+    void timeout() {
+        woken = true;
+    }
+#endif
+};
+
+static poll_waiter *poll_waiters;
+
+static int poll_check(pollfh fhs[], unsigned nfhs)
+{
+    int count = 0;
+    for (unsigned i = 0; i < nfhs; i++) {
+        short revents = 0;
+        if (fhs[i].fh) {
+            short events = fhs[i].events | POLLERR | POLLHUP | POLLNVAL;
+            revents = fhs[i].fh->poll(events) & events;
+        }
+
+        fhs[i].revents = revents;
+        if (revents) {
+            count += 1;
+        }
+    }
+
+    return count;
+}
+
+int poll(pollfh fhs[], unsigned nfhs, int timeout)
+{
+    int count = poll_check(fhs, nfhs);
+    if (count || timeout == 0) {
+        return count;
+    }
+
+    Timer timer;
+    timer.start();
+
+    poll_waiter waiter;
+    core_util_critical_section_enter();
+    waiter.next = poll_waiters;
+    poll_waiters = &waiter;
+    core_util_critical_section_exit();
+
+    while (true) {
+        // clear the wakeups first, the checks below see every change
+        // they announced
+#ifdef MBED_CONF_RTOS_PRESENT
+        while (waiter.sem.wait(0) > 0);
+#else
+        waiter.woken = false;
+#endif
+
+        count = poll_check(fhs, nfhs);
+        if (count) {
+            break;
+        }
+
+        int remaining = -1;
+        if (timeout > 0) {
+            remaining = timeout - timer.read_ms();
+            if (remaining <= 0) {
+                break;
+            }
+        }
+
+#ifdef MBED_CONF_RTOS_PRESENT
+        waiter.sem.wait(remaining < 0 ? osWaitForever : (uint32_t)remaining);
+#else
+        Timeout wake;
+        if (remaining > 0) {
+            wake.attach_us(callback(&waiter, &poll_waiter::timeout), remaining * 1000);
+        }
+
+        // the running timer keeps the us ticker out of deep sleep
+        core_util_critical_section_enter();
+        while (!waiter.woken) {
+#if DEVICE_SLEEP
+            sleep_manager_sleep_auto();
+#endif
+            core_util_critical_section_exit();
+            core_util_critical_section_enter();
+        }
+        core_util_critical_section_exit();
+#endif
+    }
+
+    core_util_critical_section_enter();
+    poll_waiter **p = &poll_waiters;
+    while (*p != &waiter) {
+        p = &(*p)->next;
+    }
+    *p = waiter.next;
+    core_util_critical_section_exit();
+
+    return count;
+}
+
+void poll_wake()
+{
+    core_util_critical_section_enter();
+    for (poll_waiter *w = poll_waiters; w; w = w->next) {
+#ifdef MBED_CONF_RTOS_PRESENT
+        w->sem.release();
+#else
+        w->woken = true;
+#endif
+    }
+    core_util_critical_section_exit();
+}
+
+} // namespace mbed
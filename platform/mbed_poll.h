@@ -0,0 +1,76 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_POLL_H
+#define MBED_POLL_H
+
+#include "drivers/FileHandle.h"
+
+namespace mbed {
+/** \addtogroup platform */
+/** @{*/
+
+/** A FileHandle polled by mbed::poll()
+ */
+struct pollfh {
+    FileHandle *fh; /**< Handle to poll, NULL entries are ignored */
+    short events;   /**< Mask of POLLIN and POLLOUT to wait for */
+    short revents;  /**< Set by poll() to the events the handle is ready for */
+};
+
+/** Wait for FileHandles to become ready
+ *
+ *  Lets a single thread wait until any of a set of devices can be read or
+ *  written without blocking, instead of dedicating a thread to each, the
+ *  handles being put in non-blocking mode with FileHandle::set_blocking().
+ *  POLLERR, POLLHUP and POLLNVAL are reported whatever was asked.
+ *
+ *  The handles are checked again each time poll_wake() is called, which
+ *  devices do whenever their state changes. Sockets call it too on their
+ *  events, so a thread can service serial ports and sockets together:
+ *  wait with poll(), then collect the sockets ready with a SocketPoll and
+ *  a timeout of 0.
+ *
+ *  Example:
+ *  @code
+ *  BufferedSerial modem(PTC17, PTC16, 921600);
+ *  modem.set_blocking(false);
+ *
+ *  pollfh fhs[1] = {{&modem, POLLIN}};
+ *  while (poll(fhs, 1, -1) > 0) {
+ *      ssize_t size = modem.read(buffer, sizeof buffer);
+ *      ...
+ *  }
+ *  @endcode
+ *
+ *  @param fhs      The handles to poll, revents is set on return
+ *  @param nfhs     Number of entries in the array
+ *  @param timeout  Timeout in milliseconds, 0 checks the handles without
+ *                  blocking and a negative value waits forever
+ *  @return         Number of handles with revents set, 0 on timeout
+ */
+int poll(pollfh fhs[], unsigned nfhs, int timeout);
+
+/** Let the threads blocked in poll() check their handles again
+ *
+ *  Called by devices when they become readable or writable, or hit an
+ *  error. Safe to call from interrupt context.
+ */
+void poll_wake();
+
+/** @}*/
+} // namespace mbed
+
+#endif
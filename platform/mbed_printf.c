@@ -0,0 +1,606 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform/mbed_printf.h"
+#include <stdint.h>
+#include <string.h>
+
+#ifndef MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOAT
+#define MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOAT     0
+#endif
+#ifndef MBED_CONF_PLATFORM_MINIMAL_PRINTF_64BIT
+#define MBED_CONF_PLATFORM_MINIMAL_PRINTF_64BIT     1
+#endif
+
+#define FLAG_LEFT       0x01
+#define FLAG_PLUS       0x02
+#define FLAG_SPACE      0x04
+#define FLAG_ALT        0x08
+#define FLAG_ZERO       0x10
+#define FLAG_UPPER      0x20
+#define FLAG_POINTER    0x40
+
+enum {
+    LENGTH_INT,
+    LENGTH_CHAR,
+    LENGTH_SHORT,
+    LENGTH_LONG,
+    LENGTH_LONG_LONG,
+    LENGTH_SIZE,
+};
+
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF_64BIT
+typedef unsigned long long printf_uint_t;
+#else
+typedef unsigned long printf_uint_t;
+#endif
+
+/* Digits of the largest integer, in octal */
+#define PRINTF_DIGITS           23
+/* Fraction digits computed, more are printed as zeros */
+#define PRINTF_FRACTION_DIGITS  9
+/* Characters of a floating point number before its trailing zeros */
+#define PRINTF_FLOAT_SIZE       40
+
+/* Characters written to a stream between writes to the console */
+#define PRINTF_CHUNK_SIZE       32
+
+typedef struct {
+    mbed_printf_out_t out;
+    void *ctx;
+    int count;
+} printf_state_t;
+
+static void printf_put(printf_state_t *state, char c)
+{
+    state->out(c, state->ctx);
+    state->count++;
+}
+
+static void printf_repeat(printf_state_t *state, char c, int n)
+{
+    while (n-- > 0) {
+        printf_put(state, c);
+    }
+}
+
+/* Writes the prefix, leading zeros, body and trailing zeros padded to width */
+static void printf_field(printf_state_t *state, int flags, int width, const char *prefix,
+                         int zeros, const char *body, int length, int trailing)
+{
+    int pad = width - (int)strlen(prefix) - zeros - length - trailing;
+
+    if (!(flags & (FLAG_LEFT | FLAG_ZERO))) {
+        printf_repeat(state, ' ', pad);
+    }
+    while (*prefix) {
+        printf_put(state, *prefix++);
+    }
+    if ((flags & (FLAG_LEFT | FLAG_ZERO)) == FLAG_ZERO) {
+        printf_repeat(state, '0', pad);
+    }
+    printf_repeat(state, '0', zeros);
+    for (int i = 0; i < length; i++) {
+        printf_put(state, body[i]);
+    }
+    printf_repeat(state, '0', trailing);
+    if (flags & FLAG_LEFT) {
+        printf_repeat(state, ' ', pad);
+    }
+}
+
+static void printf_integer(printf_state_t *state, printf_uint_t value, int negative, unsigned base,
+                           int flags, int width, int precision)
+{
+    const char *digits = (flags & FLAG_UPPER) ? "0123456789ABCDEF" : "0123456789abcdef";
+    char buffer[PRINTF_DIGITS];
+    const char *prefix = "";
+    int length = 0;
+    int zeros;
+
+    while (value) {
+        buffer[PRINTF_DIGITS - 1 - length++] = digits[value % base];
+        value /= base;
+    }
+
+    if (precision < 0) {
+        precision = 1;
+    } else {
+        flags &= ~FLAG_ZERO;
+    }
+    zeros = precision > length ? precision - length : 0;
+
+    if (negative) {
+        prefix = "-";
+    } else if (flags & FLAG_PLUS) {
+        prefix = "+";
+    } else if (flags & FLAG_SPACE) {
+        prefix = " ";
+    } else if (flags & FLAG_POINTER) {
+        prefix = "0x";
+    } else if ((flags & FLAG_ALT) && base == 16 && length) {
+        prefix = (flags & FLAG_UPPER) ? "0X" : "0x";
+    } else if ((flags & FLAG_ALT) && base == 8 && zeros == 0) {
+        zeros = 1;
+    }
+
+    printf_field(state, flags, width, prefix, zeros, buffer + PRINTF_DIGITS - length, length, 0);
+}
+
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOAT
+static const uint32_t printf_pow10[PRINTF_FRACTION_DIGITS + 1] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/* Formats a value below 2^64 with a number of decimals into out, returns
+ * its length. The decimals past PRINTF_FRACTION_DIGITS are left to the
+ * caller as trailing zeros. */
+static int printf_fixed(char *out, double value, int precision, int alt)
+{
+    int digits = precision > PRINTF_FRACTION_DIGITS ? PRINTF_FRACTION_DIGITS : precision;
+    uint64_t integer = (uint64_t)value;
+    double scaled = (value - (double)integer) * printf_pow10[digits];
+    uint32_t fraction = (uint32_t)scaled;
+    double rest = scaled - fraction;
+    char buffer[20];
+    int length = 0;
+    int n = 0;
+
+    // Round half to even
+    if (rest > 0.5 || (rest == 0.5 && ((digits ? fraction : (uint32_t)integer) & 1))) {
+        fraction++;
+        if (fraction >= printf_pow10[digits]) {
+            fraction = 0;
+            integer++;
+        }
+    }
+
+    do {
+        buffer[n++] = '0' + integer % 10;
+        integer /= 10;
+    } while (integer);
+    while (n) {
+        out[length++] = buffer[--n];
+    }
+
+    if (precision || alt) {
+        out[length++] = '.';
+    }
+    for (int i = digits - 1; i >= 0; i--) {
+        out[length + i] = '0' + fraction % 10;
+        fraction /= 10;
+    }
+    return length + digits;
+}
+
+/* Formats the mantissa and the exponent of a value, returns the length */
+static int printf_exponent(char *out, double value, int precision, int alt, int upper)
+{
+    int exponent = 0;
+    int length;
+
+    if (value != 0) {
+        while (value >= 10) {
+            value /= 10;
+            exponent++;
+        }
+        while (value < 1) {
+            value *= 10;
+            exponent--;
+        }
+    }
+    length = printf_fixed(out, value, precision, alt);
+    if (length > 1 && out[1] != '.') {
+        // Rounded up to 10, the only value with two integer digits
+        length = printf_fixed(out, value / 10, precision, alt);
+        exponent++;
+    }
+
+    out[length++] = upper ? 'E' : 'e';
+    out[length++] = exponent < 0 ? '-' : '+';
+    if (exponent < 0) {
+        exponent = -exponent;
+    }
+    if (exponent >= 100) {
+        out[length++] = '0' + exponent / 100;
+    }
+    out[length++] = '0' + exponent / 10 % 10;
+    out[length++] = '0' + exponent % 10;
+    return length;
+}
+
+static void printf_float(printf_state_t *state, double value, char conversion, int flags,
+                         int width, int precision)
+{
+    char buffer[PRINTF_FLOAT_SIZE + 8];
+    const char *prefix = "";
+    int upper = conversion == 'F' || conversion == 'E' || conversion == 'G';
+    int alt = flags & FLAG_ALT;
+    int length;
+    int trailing = 0;
+
+    if (value < 0) {
+        prefix = "-";
+        value = -value;
+    } else if (flags & FLAG_PLUS) {
+        prefix = "+";
+    } else if (flags & FLAG_SPACE) {
+        prefix = " ";
+    }
+
+    if (value != value || value > 1.7976931348623157e308) {
+        flags &= ~FLAG_ZERO;
+        printf_field(state, flags, width, prefix, 0,
+                     value != value ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf"), 3, 0);
+        return;
+    }
+
+    if (precision < 0) {
+        precision = 6;
+    }
+    if (precision > PRINTF_FLOAT_SIZE - 24) {
+        precision = PRINTF_FLOAT_SIZE - 24;
+    }
+
+    if (conversion == 'g' || conversion == 'G') {
+        int exponent = 0;
+        double scaled = value;
+        if (precision == 0) {
+            precision = 1;
+        }
+        if (scaled != 0) {
+            while (scaled >= 10) {
+                scaled /= 10;
+                exponent++;
+            }
+            while (scaled < 1) {
+                scaled *= 10;
+                exponent--;
+            }
+            // Exponent after the rounding to the precision
+            length = printf_fixed(buffer, scaled, precision - 1, 0);
+            if (length > 1 && buffer[1] != '.') {
+                exponent++;
+            }
+        }
+        if (exponent < -4 || exponent >= precision) {
+            length = printf_exponent(buffer, value, precision - 1, alt, upper);
+        } else {
+            length = printf_fixed(buffer, value, precision - 1 - exponent, alt);
+            if (precision - 1 - exponent > PRINTF_FRACTION_DIGITS) {
+                trailing = precision - 1 - exponent - PRINTF_FRACTION_DIGITS;
+            }
+        }
+        if (!alt) {
+            // Without the trailing zeros of the fraction
+            char *e = memchr(buffer, upper ? 'E' : 'e', length);
+            int end = e ? e - buffer : length;
+            int cut = end;
+            if (memchr(buffer, '.', end)) {
+                trailing = 0;
+                while (buffer[cut - 1] == '0') {
+                    cut--;
+                }
+                if (buffer[cut - 1] == '.') {
+                    cut--;
+                }
+            }
+            memmove(buffer + cut, buffer + end, length - end);
+            length -= end - cut;
+        }
+    } else if (conversion == 'e' || conversion == 'E' || value >= 1.8e19) {
+        length = printf_exponent(buffer, value, precision, alt, upper);
+    } else {
+        length = printf_fixed(buffer, value, precision, alt);
+        if (precision > PRINTF_FRACTION_DIGITS) {
+            trailing = precision - PRINTF_FRACTION_DIGITS;
+        }
+    }
+
+    printf_field(state, flags, width, prefix, 0, buffer, length, trailing);
+}
+#endif
+
+int mbed_vxprintf(mbed_printf_out_t out, void *ctx, const char *fmt, va_list args)
+{
+    printf_state_t state = { out, ctx, 0 };
+
+    for (; *fmt; fmt++) {
+        int flags = 0;
+        int width = 0;
+        int precision = -1;
+        int length = LENGTH_INT;
+
+        if (*fmt != '%') {
+            printf_put(&state, *fmt);
+            continue;
+        }
+        fmt++;
+
+        for (;; fmt++) {
+            if (*fmt == '-') {
+                flags |= FLAG_LEFT;
+            } else if (*fmt == '+') {
+                flags |= FLAG_PLUS;
+            } else if (*fmt == ' ') {
+                flags |= FLAG_SPACE;
+            } else if (*fmt == '#') {
+                flags |= FLAG_ALT;
+            } else if (*fmt == '0') {
+                flags |= FLAG_ZERO;
+            } else {
+                break;
+            }
+        }
+
+        if (*fmt == '*') {
+            width = va_arg(args, int);
+            if (width < 0) {
+                flags |= FLAG_LEFT;
+                width = -width;
+            }
+            fmt++;
+        } else {
+            while (*fmt >= '0' && *fmt <= '9') {
+                width = width * 10 + *fmt++ - '0';
+            }
+        }
+
+        if (*fmt == '.') {
+            fmt++;
+            precision = 0;
+            if (*fmt == '*') {
+                precision = va_arg(args, int);
+                if (precision < 0) {
+                    precision = -1;
+                }
+                fmt++;
+            } else {
+                while (*fmt >= '0' && *fmt <= '9') {
+                    precision = precision * 10 + *fmt++ - '0';
+                }
+            }
+        }
+
+        if (*fmt == 'h') {
+            fmt++;
+            length = LENGTH_SHORT;
+            if (*fmt == 'h') {
+                fmt++;
+                length = LENGTH_CHAR;
+            }
+        } else if (*fmt == 'l') {
+            fmt++;
+            length = LENGTH_LONG;
+            if (*fmt == 'l') {
+                fmt++;
+                length = LENGTH_LONG_LONG;
+            }
+        } else if (*fmt == 'j') {
+            fmt++;
+            length = LENGTH_LONG_LONG;
+        } else if (*fmt == 'z' || *fmt == 't') {
+            fmt++;
+            length = LENGTH_SIZE;
+        } else if (*fmt == 'L') {
+            fmt++;
+        }
+
+        switch (*fmt) {
+            case 'd':
+            case 'i': {
+                long long value;
+                if (length == LENGTH_LONG_LONG) {
+                    value = va_arg(args, long long);
+                } else if (length == LENGTH_LONG) {
+                    value = va_arg(args, long);
+                } else if (length == LENGTH_SIZE) {
+                    value = va_arg(args, ptrdiff_t);
+                } else {
+                    value = va_arg(args, int);
+                    if (length == LENGTH_CHAR) {
+                        value = (signed char)value;
+                    } else if (length == LENGTH_SHORT) {
+                        value = (short)value;
+                    }
+                }
+                printf_integer(&state, value < 0 ? -(printf_uint_t)value : (printf_uint_t)value,
+                               value < 0, 10, flags, width, precision);
+                break;
+            }
+
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X': {
+                unsigned long long value;
+                if (length == LENGTH_LONG_LONG) {
+                    value = va_arg(args, unsigned long long);
+                } else if (length == LENGTH_LONG) {
+                    value = va_arg(args, unsigned long);
+                } else if (length == LENGTH_SIZE) {
+                    value = va_arg(args, size_t);
+                } else {
+                    value = va_arg(args, unsigned);
+                    if (length == LENGTH_CHAR) {
+                        value = (unsigned char)value;
+                    } else if (length == LENGTH_SHORT) {
+                        value = (unsigned short)value;
+                    }
+                }
+                if (*fmt == 'X') {
+                    flags |= FLAG_UPPER;
+                }
+                flags &= ~(FLAG_PLUS | FLAG_SPACE);
+                printf_integer(&state, (printf_uint_t)value, 0,
+                               *fmt == 'u' ? 10 : *fmt == 'o' ? 8 : 16, flags, width, precision);
+                break;
+            }
+
+            case 'p':
+                flags &= ~(FLAG_PLUS | FLAG_SPACE);
+                printf_integer(&state, (uintptr_t)va_arg(args, void *), 0, 16,
+                               flags | FLAG_POINTER, width, precision);
+                break;
+
+            case 'c': {
+                char c = (char)va_arg(args, int);
+                printf_field(&state, flags & FLAG_LEFT, width, "", 0, &c, 1, 0);
+                break;
+            }
+
+            case 's': {
+                const char *s = va_arg(args, const char *);
+                int n = 0;
+                if (s == NULL) {
+                    s = "(null)";
+                }
+                while (s[n] && (precision < 0 || n < precision)) {
+                    n++;
+                }
+                printf_field(&state, flags & FLAG_LEFT, width, "", 0, s, n, 0);
+                break;
+            }
+
+            case 'n':
+                *va_arg(args, int *) = state.count;
+                break;
+
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF_FLOAT
+                printf_float(&state, va_arg(args, double), *fmt, flags, width, precision);
+#else
+                (void)va_arg(args, double);
+                printf_put(&state, '?');
+#endif
+                break;
+
+            case '%':
+                printf_put(&state, '%');
+                break;
+
+            case 0:
+                return state.count;
+
+            default:
+                printf_put(&state, '%');
+                printf_put(&state, *fmt);
+                break;
+        }
+    }
+
+    return state.count;
+}
+
+typedef struct {
+    char *buffer;
+    size_t size;
+    size_t length;
+} printf_buffer_t;
+
+static void printf_buffer_out(char c, void *ctx)
+{
+    printf_buffer_t *buffer = (printf_buffer_t *)ctx;
+    if (buffer->length + 1 < buffer->size) {
+        buffer->buffer[buffer->length] = c;
+    }
+    buffer->length++;
+}
+
+int mbed_vsnprintf(char *buffer, size_t size, const char *fmt, va_list args)
+{
+    printf_buffer_t ctx = { buffer, size, 0 };
+    int count = mbed_vxprintf(printf_buffer_out, &ctx, fmt, args);
+    if (size) {
+        buffer[ctx.length < size ? ctx.length : size - 1] = 0;
+    }
+    return count;
+}
+
+int mbed_snprintf(char *buffer, size_t size, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int count = mbed_vsnprintf(buffer, size, fmt, args);
+    va_end(args);
+    return count;
+}
+
+typedef struct {
+    int fh;
+    size_t length;
+    char chunk[PRINTF_CHUNK_SIZE];
+} printf_console_t;
+
+static void printf_console_out(char c, void *ctx)
+{
+    printf_console_t *console = (printf_console_t *)ctx;
+    console->chunk[console->length++] = c;
+    if (console->length == sizeof(console->chunk)) {
+        mbed_printf_console_write(console->fh, console->chunk, console->length);
+        console->length = 0;
+    }
+}
+
+static void printf_file_out(char c, void *ctx)
+{
+    fputc(c, (FILE *)ctx);
+}
+
+int mbed_vfprintf(FILE *stream, const char *fmt, va_list args)
+{
+    if (stream == stdout || stream == stderr) {
+        printf_console_t console;
+        // Output of the C library still in the stream goes first
+        fflush(stream);
+        console.fh = stream == stdout ? 1 : 2;
+        console.length = 0;
+        int count = mbed_vxprintf(printf_console_out, &console, fmt, args);
+        if (console.length) {
+            mbed_printf_console_write(console.fh, console.chunk, console.length);
+        }
+        return count;
+    }
+    return mbed_vxprintf(printf_file_out, stream, fmt, args);
+}
+
+int mbed_fprintf(FILE *stream, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int count = mbed_vfprintf(stream, fmt, args);
+    va_end(args);
+    return count;
+}
+
+int mbed_vprintf(const char *fmt, va_list args)
+{
+    return mbed_vfprintf(stdout, fmt, args);
+}
+
+int mbed_printf(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int count = mbed_vfprintf(stdout, fmt, args);
+    va_end(args);
+    return count;
+}
@@ -0,0 +1,99 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_PRINTF_H
+#define MBED_PRINTF_H
+
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+/* Compact printf
+ *
+ * Formats without heap and with a stack of a few dozen bytes. It supports
+ * the flags, width, precision and length modifiers of C99 for the d, i,
+ * u, o, x, X, c, s, p, n and % conversions. Floating point conversions
+ * need the platform.minimal-printf-float option, without it they print
+ * '?'; they compute 9 decimals and print the further ones as zeros, and
+ * values of 2^64 and above in exponent form. 64 bit integers need platform.minimal-printf-64bit, without it
+ * they are cut to 32 bits.
+ *
+ * With the platform.minimal-printf option, Stream::printf and the error
+ * messages use it, and on GCC it replaces printf, fprintf, sprintf,
+ * snprintf and their v variants of the C library. Output to stdout and
+ * stderr then goes straight to the console, after flushing the FILE
+ * buffers of the C library so that it stays in order with fputs or putchar.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Function the characters are written with
+ *
+ * @param c   Character
+ * @param ctx Context given to mbed_vxprintf
+ */
+typedef void (*mbed_printf_out_t)(char c, void *ctx);
+
+/** Format to a function
+ *
+ * @param out  Function called for each character
+ * @param ctx  Context passed to out
+ * @param fmt  printf format
+ * @param args Arguments
+ * @return Number of characters written
+ */
+int mbed_vxprintf(mbed_printf_out_t out, void *ctx, const char *fmt, va_list args);
+
+/** Format to a buffer, like vsnprintf */
+int mbed_vsnprintf(char *buffer, size_t size, const char *fmt, va_list args);
+
+/** Format to a buffer, like snprintf */
+int mbed_snprintf(char *buffer, size_t size, const char *fmt, ...);
+
+/** Format to a stream, like vfprintf
+ *
+ * stdout and stderr are flushed then written to the console in chunks,
+ * other streams are written a character at a time with fputc.
+ */
+int mbed_vfprintf(FILE *stream, const char *fmt, va_list args);
+
+/** Format to a stream, like fprintf */
+int mbed_fprintf(FILE *stream, const char *fmt, ...);
+
+/** Format to stdout, like vprintf */
+int mbed_vprintf(const char *fmt, va_list args);
+
+/** Format to stdout, like printf */
+int mbed_printf(const char *fmt, ...);
+
+/** Write to the console, provided by retarget.cpp
+ *
+ * @param fh     1 for stdout, 2 for stderr
+ * @param buffer Characters
+ * @param length Number of characters
+ */
+void mbed_printf_console_write(int fh, const char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
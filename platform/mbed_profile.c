@@ -0,0 +1,115 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform/mbed_profile.h"
+#include "platform/critical.h"
+#include "cmsis.h"
+#include <stdio.h>
+
+uint8_t mbed_profile_ready;
+
+/* Regions in the order they first completed */
+static mbed_profile_region_t *profile_regions;
+
+void mbed_profile_init(void)
+{
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#if defined(__CORTEX_M) && (__CORTEX_M == 7)
+    // The DWT of the Cortex-M7 is locked after reset
+    DWT->LAR = 0xC5ACCE55;
+#endif
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#else
+    // Free running without interrupt unless the RTOS or the target uses it
+    if (!(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk)) {
+        SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+        SysTick->VAL = 0;
+        SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    }
+#endif
+    mbed_profile_ready = 1;
+}
+
+void mbed_profile_add(mbed_profile_region_t *region, uint32_t value)
+{
+    core_util_critical_section_enter();
+    if (!region->linked) {
+        region->linked = 1;
+        region->next = profile_regions;
+        profile_regions = region;
+    }
+    region->count += 1;
+    region->total += value;
+    if (value < region->min) {
+        region->min = value;
+    }
+    if (value > region->max) {
+        region->max = value;
+    }
+    core_util_critical_section_exit();
+}
+
+void mbed_profile_dump(void)
+{
+    uint32_t mhz = SystemCoreClock / 1000000;
+    if (mhz == 0) {
+        mhz = 1;
+    }
+
+    printf("profile: %-24s %10s %10s %10s %10s\r\n", "name", "count", "min", "avg", "max");
+
+    core_util_critical_section_enter();
+    mbed_profile_region_t *region = profile_regions;
+    core_util_critical_section_exit();
+
+    while (region) {
+        mbed_profile_region_t sample;
+
+        // Regions are only ever added at the head, so the list can be walked
+        // without holding the critical section during printf
+        core_util_critical_section_enter();
+        sample = *region;
+        core_util_critical_section_exit();
+
+        uint32_t avg = sample.count ? (uint32_t)(sample.total / sample.count) : 0;
+        uint32_t min = sample.count ? sample.min : 0;
+        if (sample.counter) {
+            printf("profile: %-24s %10lu %10lu %10lu %10lu\r\n", sample.name,
+                   (unsigned long)sample.count, (unsigned long)min,
+                   (unsigned long)avg, (unsigned long)sample.max);
+        } else {
+            printf("profile: %-24s %10lu %10lu %10lu %10lu cycles, %lu/%lu/%lu us\r\n", sample.name,
+                   (unsigned long)sample.count, (unsigned long)min,
+                   (unsigned long)avg, (unsigned long)sample.max,
+                   (unsigned long)(min / mhz), (unsigned long)(avg / mhz),
+                   (unsigned long)(sample.max / mhz));
+        }
+        region = sample.next;
+    }
+}
+
+void mbed_profile_reset(void)
+{
+    core_util_critical_section_enter();
+    for (mbed_profile_region_t *region = profile_regions; region; region = region->next) {
+        region->count = 0;
+        region->min = UINT32_MAX;
+        region->max = 0;
+        region->total = 0;
+    }
+    core_util_critical_section_exit();
+}
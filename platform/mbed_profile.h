@@ -0,0 +1,209 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_PROFILE_H
+#define MBED_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Cycle counting of code regions
+ *
+ * A region accumulates the number of times it ran and the min, max and
+ * total cycles it took. Regions are static, they join the table printed by
+ * mbed_profile_dump the first time they complete. A counter accumulates
+ * values the same way, such as the number of bytes handled per call.
+ *
+ * Cycles come from the DWT cycle counter on Cortex-M3 and above, and from
+ * SysTick on Cortex-M0. SysTick wraps every 2^24 cycles, or every RTOS tick
+ * when it drives the RTOS, so regions must be shorter than that on M0.
+ *
+ * The macros are compiled out unless MBED_PROFILE_ENABLED is defined, to
+ * any value or none, their arguments are not evaluated then.
+ *
+ * Example:
+ * @code
+ * void ethernet_input(void)
+ * {
+ *     MBED_PROFILE_SCOPE(eth_input);
+ *     ...
+ * }
+ *
+ * MBED_PROFILE_COUNTER(eth_bytes);
+ *
+ * void frame_received(size_t len)
+ * {
+ *     MBED_PROFILE_REGION(crc);
+ *     MBED_PROFILE_BEGIN(crc);
+ *     check_crc();
+ *     MBED_PROFILE_END(crc);
+ *     MBED_PROFILE_ADD(eth_bytes, len);
+ * }
+ *
+ * // Later, from a thread
+ * mbed_profile_dump();
+ * @endcode
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct mbed_profile_region {
+    const char *name;                   /**< Name in the table */
+    uint8_t counter;                    /**< 1 for counters, 0 for regions of cycles */
+    uint8_t linked;                     /**< In the table */
+    uint32_t count;                     /**< Number of samples */
+    uint32_t min;                       /**< Smallest sample */
+    uint32_t max;                       /**< Largest sample */
+    uint64_t total;                     /**< Sum of the samples */
+    struct mbed_profile_region *next;   /**< Next region of the table */
+} mbed_profile_region_t;
+
+/** Initializer of a region */
+#define MBED_PROFILE_REGION_INIT(name)  { name, 0, 0, 0, UINT32_MAX, 0, 0, NULL }
+/** Initializer of a counter */
+#define MBED_PROFILE_COUNTER_INIT(name) { name, 1, 0, 0, UINT32_MAX, 0, 0, NULL }
+
+/** Start the cycle counter, done by the first mbed_profile_start */
+void mbed_profile_init(void);
+
+/** Add a sample to a region or counter
+ *
+ * Interrupt safe.
+ *
+ * @param region Region or counter
+ * @param value  Cycles of the region, or value of the counter
+ */
+void mbed_profile_add(mbed_profile_region_t *region, uint32_t value);
+
+/** Print the table of regions and counters with printf
+ *
+ * Regions are printed in cycles and microseconds.
+ */
+void mbed_profile_dump(void);
+
+/** Clear the samples of all regions and counters */
+void mbed_profile_reset(void);
+
+extern uint8_t mbed_profile_ready;
+
+#ifdef MBED_PROFILE_ENABLED
+
+#include "cmsis.h"
+
+/** Read the cycle counter
+ *
+ * @return Cycles, to be passed to mbed_profile_elapsed
+ */
+static inline uint32_t mbed_profile_start(void)
+{
+    if (!mbed_profile_ready) {
+        mbed_profile_init();
+    }
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+    return DWT->CYCCNT;
+#else
+    return SysTick->LOAD - SysTick->VAL;
+#endif
+}
+
+/** Cycles since mbed_profile_start
+ *
+ * @param start Value returned by mbed_profile_start
+ * @return Cycles elapsed
+ */
+static inline uint32_t mbed_profile_elapsed(uint32_t start)
+{
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+    return DWT->CYCCNT - start;
+#else
+    uint32_t load = SysTick->LOAD;
+    uint32_t now = load - SysTick->VAL;
+    return now >= start ? now - start : now + load + 1 - start;
+#endif
+}
+
+/** Declare a static region */
+#define MBED_PROFILE_REGION(name) \
+    static mbed_profile_region_t name = MBED_PROFILE_REGION_INIT(#name)
+/** Declare a static counter */
+#define MBED_PROFILE_COUNTER(name) \
+    static mbed_profile_region_t name = MBED_PROFILE_COUNTER_INIT(#name)
+/** Start a region declared with MBED_PROFILE_REGION, in the same scope as its end */
+#define MBED_PROFILE_BEGIN(name) \
+    uint32_t name##_profile_start = mbed_profile_start()
+/** End a region */
+#define MBED_PROFILE_END(name) \
+    mbed_profile_add(&name, mbed_profile_elapsed(name##_profile_start))
+/** Add a value to a counter */
+#define MBED_PROFILE_ADD(name, value) \
+    mbed_profile_add(&name, (value))
+
+#else
+
+#define MBED_PROFILE_REGION(name)
+#define MBED_PROFILE_COUNTER(name)
+#define MBED_PROFILE_BEGIN(name)
+#define MBED_PROFILE_END(name)
+#define MBED_PROFILE_ADD(name, value)
+
+#endif
+
+#ifdef __cplusplus
+}
+
+#ifdef MBED_PROFILE_ENABLED
+
+namespace mbed {
+
+/** Times its own lifetime into a region */
+class ProfileScope {
+public:
+    ProfileScope(mbed_profile_region_t *region)
+        : _region(region), _start(mbed_profile_start())
+    {
+    }
+
+    ~ProfileScope()
+    {
+        mbed_profile_add(_region, mbed_profile_elapsed(_start));
+    }
+
+private:
+    mbed_profile_region_t *_region;
+    uint32_t _start;
+};
+
+}
+
+/** Time the rest of the enclosing scope as a static region */
+#define MBED_PROFILE_SCOPE(name) \
+    MBED_PROFILE_REGION(name); \
+    mbed::ProfileScope name##_profile_scope(&name)
+
+#else
+
+#define MBED_PROFILE_SCOPE(name)
+
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
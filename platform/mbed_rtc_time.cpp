@@ -19,9 +19,14 @@
 #include "platform/critical.h"
 #include "platform/rtc_time.h"
 #include "hal/us_ticker_api.h"
+#include "hal/lp_ticker_api.h"
 #include "platform/SingletonPtr.h"
 #include "platform/PlatformMutex.h"
 
+#ifndef MBED_CONF_PLATFORM_TIME_CACHE_RESYNC
+#define MBED_CONF_PLATFORM_TIME_CACHE_RESYNC 0
+#endif
+
 static SingletonPtr<PlatformMutex> _mutex;
 
 #if DEVICE_RTC
@@ -36,27 +41,87 @@ static time_t (*_rtc_read)(void) = NULL;
 static void (*_rtc_write)(time_t t) = NULL;
 #endif
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-#if defined (__ICCARM__)
-time_t __time32(time_t *timer)
+/* Time derived from the ticker, counting from an RTC read. The low power
+ * ticker keeps running in deep sleep, the microsecond ticker may not. */
+static bool _anchored = false;
+static us_timestamp_t _anchor_ticks;   // ticker time of the anchor
+static us_timestamp_t _anchor_time;    // microseconds since the epoch at the anchor
+
+static us_timestamp_t ticker_now(void)
+{
+#if DEVICE_LOWPOWERTIMER
+    return ticker_read_us64(get_lp_ticker_data());
 #else
-time_t time(time_t *timer)
+    return ticker_read_us64(get_us_ticker_data());
 #endif
+}
 
+static time_t rtc_now(void)
 {
-    _mutex->lock();
     if (_rtc_isenabled != NULL) {
         if (!(_rtc_isenabled())) {
             set_time(0);
         }
     }
-    
+
     time_t t = 0;
     if (_rtc_read != NULL) {
         t = _rtc_read();
     }
+    return t;
+}
+
+/* Gets the time in microseconds, rereading the RTC when the anchor is
+ * older than resync seconds, or on each call for 0. Called with the
+ * mutex held.
+ *
+ * An RTC read only tells the time is within that second. The derived
+ * time is moved only when it falls out of it, so it keeps the sub-second
+ * phase found so far, and gets closer to the RTC's second boundaries as
+ * they are crossed, without going back. */
+static us_timestamp_t derived_now(uint32_t resync)
+{
+    us_timestamp_t ticks = ticker_now();
+
+    if (!_anchored || ticks - _anchor_ticks >= (us_timestamp_t)resync * 1000000) {
+        us_timestamp_t rtc = (us_timestamp_t)rtc_now() * 1000000;
+
+        if (!_anchored) {
+            _anchor_time = rtc;
+        } else {
+            us_timestamp_t derived = _anchor_time + (ticks - _anchor_ticks);
+            if (derived < rtc) {
+                _anchor_time = rtc;
+            } else if (derived >= rtc + 1000000) {
+                // ticker fast against the RTC, step back into its second
+                _anchor_time = rtc + 999999;
+            } else {
+                _anchor_time = derived;
+            }
+        }
+        _anchor_ticks = ticks;
+        _anchored = true;
+    }
+
+    return _anchor_time + (ticks - _anchor_ticks);
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if defined (__ICCARM__)
+time_t __time32(time_t *timer)
+#else
+time_t time(time_t *timer)
+#endif
+
+{
+    _mutex->lock();
+#if MBED_CONF_PLATFORM_TIME_CACHE_RESYNC
+    time_t t = (time_t)(derived_now(MBED_CONF_PLATFORM_TIME_CACHE_RESYNC) / 1000000);
+#else
+    time_t t = rtc_now();
+#endif
 
     if (timer != NULL) {
         *timer = t;
@@ -73,9 +138,22 @@ void set_time(time_t t) {
     if (_rtc_write != NULL) {
         _rtc_write(t);
     }
+    _anchored = false;
     _mutex->unlock();
 }
 
+int mbed_gettimeofday(struct mbed_timeval *tv)
+{
+    _mutex->lock();
+    // without the cache, the RTC is reread on each call as by time()
+    us_timestamp_t now = derived_now(MBED_CONF_PLATFORM_TIME_CACHE_RESYNC);
+    _mutex->unlock();
+
+    tv->tv_sec = (time_t)(now / 1000000);
+    tv->tv_usec = (uint32_t)(now % 1000000);
+    return 0;
+}
+
 clock_t clock() {
     _mutex->lock();
     clock_t t = us_ticker_read();
@@ -90,6 +168,7 @@ void attach_rtc(time_t (*read_rtc)(void), void (*write_rtc)(time_t), void (*init
     _rtc_write = write_rtc;
     _rtc_init = init_rtc;
     _rtc_isenabled = isenabled_rtc;
+    _anchored = false;
     _mutex->unlock();
 }
 
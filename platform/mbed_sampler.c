@@ -0,0 +1,231 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "platform/mbed_sampler.h"
+#include "platform/critical.h"
+#include "hal/sample_timer_api.h"
+
+#if DEVICE_SAMPLE_TIMER && defined(MBED_CONF_PLATFORM_SAMPLER) && MBED_CONF_PLATFORM_SAMPLER && \
+    (defined(__GNUC__) || defined(__CC_ARM))
+
+#if MBED_CONF_RTOS_PRESENT
+#undef NULL  //Workaround for conflicting macros in rt_TypeDef.h and stdio.h
+#include "rt_TypeDef.h"
+extern struct OS_TSK os_tsk;
+#endif
+
+#define SAMPLER_SLOTS   MBED_CONF_PLATFORM_SAMPLER_SLOTS
+#define SAMPLER_PROBES  8
+
+#if SAMPLER_SLOTS & (SAMPLER_SLOTS - 1)
+#error "platform.sampler-slots must be a power of two"
+#endif
+
+static mbed_sampler_entry_t sampler_table[SAMPLER_SLOTS];
+static mbed_sampler_info_t sampler_info;
+static IRQn_Type sampler_irqn;
+static uint8_t sampler_running;
+
+void mbed_sampler_sample(const uint32_t *frame, uint32_t exc_return);
+
+/* The timer interrupt vector. Finds the exception frame on the stack the
+ * interrupted code used and tail calls mbed_sampler_sample with it, which
+ * then returns from the exception. */
+#if defined(__CC_ARM)
+__asm static void sampler_irq(void)
+{
+    IMPORT  mbed_sampler_sample
+    MOVS    r0, #4
+    MOV     r1, lr
+    TST     r0, r1
+    BEQ     sampler_msp
+    MRS     r0, PSP
+    LDR     r2, =mbed_sampler_sample
+    BX      r2
+sampler_msp
+    MRS     r0, MSP
+    LDR     r2, =mbed_sampler_sample
+    BX      r2
+}
+#else
+__attribute__((naked)) static void sampler_irq(void)
+{
+    __asm volatile (
+        "movs   r0, #4                  \n"
+        "mov    r1, lr                  \n"
+        "tst    r0, r1                  \n"
+        "beq    1f                      \n"
+        "mrs    r0, psp                 \n"
+        "b      2f                      \n"
+        "1:                             \n"
+        "mrs    r0, msp                 \n"
+        "2:                             \n"
+        "ldr    r2, =mbed_sampler_sample\n"
+        "bx     r2                      \n"
+        ".ltorg                         \n"
+    );
+}
+#endif
+
+void mbed_sampler_sample(const uint32_t *frame, uint32_t exc_return)
+{
+    uint32_t pc = frame[6];
+    uint32_t thread;
+
+    sample_timer_clear();
+
+    if (!(exc_return & 8)) {
+        thread = MBED_SAMPLER_INTERRUPT;
+    } else {
+#if MBED_CONF_RTOS_PRESENT
+        thread = (uint32_t)os_tsk.run;
+#else
+        thread = 0;
+#endif
+    }
+
+    sampler_info.samples++;
+
+    uint32_t hash = (pc >> 1) ^ (thread >> 3);
+    hash ^= hash >> 16;
+    for (int probe = 0; probe < SAMPLER_PROBES; probe++) {
+        mbed_sampler_entry_t *entry = &sampler_table[(hash + probe) & (SAMPLER_SLOTS - 1)];
+        if (entry->count == 0) {
+            entry->pc = pc;
+            entry->thread = thread;
+            entry->count = 1;
+            sampler_info.entries++;
+            return;
+        }
+        if (entry->pc == pc && entry->thread == thread) {
+            entry->count++;
+            return;
+        }
+    }
+    sampler_info.dropped++;
+}
+
+int mbed_sampler_start(uint32_t hz)
+{
+    mbed_sampler_stop();
+
+    sampler_irqn = sample_timer_init(hz);
+    sampler_info.hz = hz;
+    sampler_running = 1;
+
+    NVIC_SetVector(sampler_irqn, (uint32_t)sampler_irq);
+    NVIC_SetPriority(sampler_irqn, 0);
+    NVIC_ClearPendingIRQ(sampler_irqn);
+    NVIC_EnableIRQ(sampler_irqn);
+    return 0;
+}
+
+void mbed_sampler_stop(void)
+{
+    if (!sampler_running) {
+        return;
+    }
+    NVIC_DisableIRQ(sampler_irqn);
+    sample_timer_free();
+    NVIC_ClearPendingIRQ(sampler_irqn);
+    sampler_running = 0;
+}
+
+void mbed_sampler_reset(void)
+{
+    core_util_critical_section_enter();
+    memset(sampler_table, 0, sizeof(sampler_table));
+    sampler_info.samples = 0;
+    sampler_info.dropped = 0;
+    sampler_info.entries = 0;
+    core_util_critical_section_exit();
+}
+
+void mbed_sampler_get_info(mbed_sampler_info_t *info)
+{
+    core_util_critical_section_enter();
+    *info = sampler_info;
+    core_util_critical_section_exit();
+}
+
+size_t mbed_sampler_get_entries(mbed_sampler_entry_t *entries, size_t count)
+{
+    size_t copied = 0;
+
+    for (int i = 0; i < SAMPLER_SLOTS && copied < count; i++) {
+        core_util_critical_section_enter();
+        entries[copied] = sampler_table[i];
+        core_util_critical_section_exit();
+        if (entries[copied].count) {
+            copied++;
+        }
+    }
+    return copied;
+}
+
+void mbed_sampler_dump(void)
+{
+    mbed_sampler_info_t info;
+
+    mbed_sampler_get_info(&info);
+    printf("sampler: begin hz=%lu samples=%lu dropped=%lu\r\n", (unsigned long)info.hz,
+           (unsigned long)info.samples, (unsigned long)info.dropped);
+    for (int i = 0; i < SAMPLER_SLOTS; i++) {
+        mbed_sampler_entry_t entry;
+
+        core_util_critical_section_enter();
+        entry = sampler_table[i];
+        core_util_critical_section_exit();
+        if (entry.count) {
+            printf("sampler: %08lx %08lx %lu\r\n", (unsigned long)entry.pc,
+                   (unsigned long)entry.thread, (unsigned long)entry.count);
+        }
+    }
+    printf("sampler: end\r\n");
+}
+
+#else
+
+int mbed_sampler_start(uint32_t hz)
+{
+    return -1;
+}
+
+void mbed_sampler_stop(void)
+{
+}
+
+void mbed_sampler_reset(void)
+{
+}
+
+void mbed_sampler_get_info(mbed_sampler_info_t *info)
+{
+    memset(info, 0, sizeof(*info));
+}
+
+size_t mbed_sampler_get_entries(mbed_sampler_entry_t *entries, size_t count)
+{
+    return 0;
+}
+
+void mbed_sampler_dump(void)
+{
+}
+
+#endif
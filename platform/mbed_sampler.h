@@ -0,0 +1,101 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_SAMPLER_H
+#define MBED_SAMPLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Statistical profiler
+ *
+ * A timer interrupt of the highest priority samples the program counter
+ * the interrupt returns to, and the thread it belongs to, into a table in
+ * RAM counting the samples of each pair. The table has
+ * MBED_CONF_PLATFORM_SAMPLER_SLOTS entries, samples that find it full are
+ * counted as dropped. Code running with interrupts disabled is sampled
+ * when it enables them again, at the instruction that did.
+ *
+ * Needs the platform.sampler option and a target with the SAMPLE_TIMER
+ * device, GCC or ARM toolchain. mbed_sampler_dump prints the table for
+ * tools/sampler.py, which turns it into a flat profile of the functions:
+ *
+ * @code
+ * mbed_sampler_start(1000);
+ * ...
+ * mbed_sampler_stop();
+ * mbed_sampler_dump();
+ * @endcode
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Thread of the samples taken in interrupt handlers */
+#define MBED_SAMPLER_INTERRUPT  0xFFFFFFFFUL
+
+typedef struct {
+    uint32_t pc;        /**< Interrupted instruction */
+    uint32_t thread;    /**< osThreadId of the interrupted thread, NULL without RTOS, or MBED_SAMPLER_INTERRUPT */
+    uint32_t count;     /**< Samples of pc in thread */
+} mbed_sampler_entry_t;
+
+typedef struct {
+    uint32_t hz;        /**< Rate of the last start */
+    uint32_t samples;   /**< Samples taken since the last reset */
+    uint32_t dropped;   /**< Samples not counted as the table was full */
+    uint32_t entries;   /**< Entries in use */
+} mbed_sampler_info_t;
+
+/** Start sampling, adding to the samples already taken
+ *
+ * @param hz Samples per second
+ * @return 0 on success, -1 if the sampler is not available
+ */
+int mbed_sampler_start(uint32_t hz);
+
+/** Stop sampling, the samples are kept */
+void mbed_sampler_stop(void);
+
+/** Clear the samples */
+void mbed_sampler_reset(void);
+
+/** Get the sample counts
+ *
+ * @param info Destination
+ */
+void mbed_sampler_get_info(mbed_sampler_info_t *info);
+
+/** Copy the entries of the table
+ *
+ * @param entries Destination
+ * @param count   Entries that fit in the destination
+ * @return Entries copied
+ */
+size_t mbed_sampler_get_entries(mbed_sampler_entry_t *entries, size_t count);
+
+/** Print the table with printf, for tools/sampler.py */
+void mbed_sampler_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
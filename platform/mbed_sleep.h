@@ -0,0 +1,97 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_SLEEP_H
+#define MBED_SLEEP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "device.h"
+
+#if DEVICE_SLEEP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Sleep manager
+ *
+ * Deep sleep stops the clocks of most peripherals and the us ticker, so
+ * it breaks running transfers and timers. Drivers lock deep sleep while
+ * they need their clocks, usually through a DeepSleepLock, and the idle
+ * loop calls sleep_manager_sleep_auto, which enters deep sleep only while
+ * no lock is held.
+ *
+ * Example:
+ * @code
+ * void start_transfer() {
+ *     sleep_manager_lock_deep_sleep();
+ *     // ... start the transfer, which ends with transfer_done
+ * }
+ *
+ * void transfer_done() {
+ *     sleep_manager_unlock_deep_sleep();
+ * }
+ * @endcode
+ */
+
+/** Lock deep sleep
+ *
+ * Locks nest, deep sleep is allowed again when each lock has been
+ * unlocked. Safe to call from interrupts.
+ */
+void sleep_manager_lock_deep_sleep(void);
+
+/** Unlock deep sleep, undoing one sleep_manager_lock_deep_sleep
+ */
+void sleep_manager_unlock_deep_sleep(void);
+
+/** Check if deep sleep is allowed
+ *
+ * @return true if no lock is held and no us ticker event is pending
+ */
+bool sleep_manager_can_deep_sleep(void);
+
+/** Sleep as deep as allowed until an interrupt
+ *
+ * Enters deep sleep when sleep_manager_can_deep_sleep, sleep otherwise,
+ * and counts the time spent in each mode. Call it with interrupts
+ * disabled, they stay pending until it returns.
+ */
+void sleep_manager_sleep_auto(void);
+
+#if DEVICE_LOWPOWERTIMER
+/** Set when the next sleep is due to end, to measure the wake-up latency
+ *
+ * An idle loop that woke up the low power ticker at wake_time calls this
+ * before sleep_manager_sleep_auto. Sleeps that end after wake_time count
+ * the difference as their wake-up latency.
+ *
+ * @param wake_time lp ticker time the interrupt that ends the sleep is set to
+ */
+void sleep_manager_set_wake_time(uint32_t wake_time);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif
+
+/** @}*/
@@ -0,0 +1,139 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include "platform/mbed_sleep.h"
+#include "platform/mbed_stats.h"
+#include "platform/critical.h"
+#include "platform/mbed_error.h"
+
+#if DEVICE_SLEEP
+
+#include "hal/sleep_api.h"
+#include "hal/ticker_api.h"
+#include "hal/us_ticker_api.h"
+#if DEVICE_LOWPOWERTIMER
+#include "hal/lp_ticker_api.h"
+#endif
+
+static uint16_t deep_sleep_lock;
+static mbed_stats_sleep_t sleep_stats;
+
+#if DEVICE_LOWPOWERTIMER
+static uint8_t sleep_lp_ticker_init;
+static uint8_t sleep_wake_time_set;
+static uint32_t sleep_wake_time;
+#endif
+
+void sleep_manager_lock_deep_sleep(void)
+{
+    if (core_util_atomic_incr_u16(&deep_sleep_lock, 1) == 0) {
+        error("Deep sleep lock would overflow (> 0xFFFF)");
+    }
+}
+
+void sleep_manager_unlock_deep_sleep(void)
+{
+    if (core_util_atomic_decr_u16(&deep_sleep_lock, 1) == 0xFFFF) {
+        error("Deep sleep lock would underflow (< 0)");
+    }
+}
+
+bool sleep_manager_can_deep_sleep(void)
+{
+    timestamp_t next;
+
+    if (deep_sleep_lock != 0) {
+        return false;
+    }
+    // the us ticker stops in deep sleep
+    return !ticker_get_next_timestamp(get_us_ticker_data(), &next);
+}
+
+#if DEVICE_LOWPOWERTIMER
+void sleep_manager_set_wake_time(uint32_t wake_time)
+{
+    core_util_critical_section_enter();
+    sleep_wake_time = wake_time;
+    sleep_wake_time_set = 1;
+    core_util_critical_section_exit();
+}
+#endif
+
+void sleep_manager_sleep_auto(void)
+{
+    core_util_critical_section_enter();
+
+    bool deep = sleep_manager_can_deep_sleep();
+#if DEVICE_LOWPOWERTIMER
+    if (!sleep_lp_ticker_init) {
+        lp_ticker_init();
+        sleep_lp_ticker_init = 1;
+    }
+    uint32_t start = lp_ticker_read();
+#endif
+
+    if (deep) {
+        deepsleep();
+    } else {
+        sleep();
+    }
+
+#if DEVICE_LOWPOWERTIMER
+    uint32_t end = lp_ticker_read();
+    uint32_t slept = end - start;
+    if (deep) {
+        sleep_stats.deep_sleep_time += slept;
+    } else {
+        sleep_stats.sleep_time += slept;
+    }
+    if (sleep_wake_time_set) {
+        int32_t late = (int32_t)(end - sleep_wake_time);
+        // woken by something else before the wake time otherwise
+        if (late >= 0) {
+            sleep_stats.wakeup_cnt++;
+            sleep_stats.total_wakeup_latency += (uint32_t)late;
+            if ((uint32_t)late > sleep_stats.max_wakeup_latency) {
+                sleep_stats.max_wakeup_latency = (uint32_t)late;
+            }
+        }
+        sleep_wake_time_set = 0;
+    }
+#endif
+    if (deep) {
+        sleep_stats.deep_sleep_cnt++;
+    } else {
+        sleep_stats.sleep_cnt++;
+    }
+
+    core_util_critical_section_exit();
+}
+
+void mbed_stats_sleep_get(mbed_stats_sleep_t *stats)
+{
+    core_util_critical_section_enter();
+    *stats = sleep_stats;
+    stats->lock_cnt = deep_sleep_lock;
+    core_util_critical_section_exit();
+}
+
+#else
+
+void mbed_stats_sleep_get(mbed_stats_sleep_t *stats)
+{
+    memset(stats, 0, sizeof(mbed_stats_sleep_t));
+}
+
+#endif
@@ -0,0 +1,87 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/mbed_stats.h"
+#include <string.h>
+
+#if MBED_CONF_RTOS_PRESENT
+#include "cmsis_os.h"
+
+static uint32_t thread_info(osThreadId id, osThreadInfo info)
+{
+    osEvent event = _osThreadGetInfo(id, info);
+    if (event.status != osOK) {
+        return 0;
+    }
+
+    return event.value.v;
+}
+#endif
+
+size_t mbed_stats_thread_get(mbed_stats_thread_t *stats, size_t count)
+{
+    size_t n = 0;
+
+#if MBED_CONF_RTOS_PRESENT
+    // The enumeration holds the lock threads are created and terminated under
+    osThreadEnumId enum_id = _osThreadsEnumStart();
+    osThreadId id;
+
+    while (n < count && (id = _osThreadEnumNext(enum_id)) != NULL) {
+        memset(&stats[n], 0, sizeof(stats[n]));
+        stats[n].id = (uint32_t)id;
+        stats[n].entry = thread_info(id, osThreadInfoEntry);
+        stats[n].arg = thread_info(id, osThreadInfoArg);
+        stats[n].state = osThreadGetState(id);
+        stats[n].priority = osThreadGetPriority(id);
+        stats[n].stack_size = thread_info(id, osThreadInfoStackSize);
+        // fails unless the stacks are filled with the pattern
+        stats[n].max_stack = thread_info(id, osThreadInfoStackMax);
+        n++;
+    }
+
+    _osThreadEnumFree(enum_id);
+#endif
+
+    return n;
+}
+
+void mbed_stats_stack_get(mbed_stats_stack_t *stats)
+{
+    memset(stats, 0, sizeof(mbed_stats_stack_t));
+
+#if MBED_CONF_RTOS_PRESENT
+    osThreadEnumId enum_id = _osThreadsEnumStart();
+    osThreadId id;
+
+    while ((id = _osThreadEnumNext(enum_id)) != NULL) {
+        stats->max_size += thread_info(id, osThreadInfoStackMax);
+        stats->reserved_size += thread_info(id, osThreadInfoStackSize);
+        stats->stack_cnt++;
+    }
+
+    _osThreadEnumFree(enum_id);
+#endif
+}
+
+#if !MBED_CONF_RTOS_PRESENT || !(defined(MBED_MUTEX_STATS_ENABLED) && MBED_MUTEX_STATS_ENABLED)
+// Implemented by rtos::Mutex when the stats are enabled
+size_t mbed_stats_mutex_get(mbed_stats_mutex_t *stats, size_t count)
+{
+    (void)stats;
+    (void)count;
+    return 0;
+}
+#endif
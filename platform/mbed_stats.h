@@ -19,6 +19,9 @@
 #ifndef MBED_STATS_H
 #define MBED_STATS_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -36,6 +39,167 @@ typedef struct {
  */
 void mbed_stats_heap_get(mbed_stats_heap_t *stats);
 
+/** Number of size classes of mbed_stats_heap_hist_t */
+#define MBED_STATS_HEAP_HIST_BINS   16
+
+typedef struct {
+    uint32_t alloc_cnt[MBED_STATS_HEAP_HIST_BINS];      /**< Cumulative number of allocations per size class. */
+    uint32_t current_cnt[MBED_STATS_HEAP_HIST_BINS];    /**< Current number of allocations per size class. */
+} mbed_stats_heap_hist_t;
+
+typedef struct {
+    uint32_t caller;            /**< Return address of the allocation call, 0 for the callers that found the table full. */
+    uint32_t alloc_cnt;         /**< Cumulative number of allocations. */
+    uint32_t current_cnt;       /**< Current number of allocations. */
+    uint32_t current_size;      /**< Bytes allocated currently. */
+    uint32_t max_size;          /**< Max bytes allocated at a given time. */
+    uint32_t total_size;        /**< Cumulative sum of bytes ever allocated. */
+} mbed_stats_heap_caller_t;
+
+/**
+ * Fill the passed in structure with the heap allocations by size class.
+ *
+ * Requires the MBED_HEAP_STATS_ENABLED macro. Size class i holds the
+ * requests of up to 8 << i bytes that do not fit class i - 1, the last
+ * class all larger ones.
+ */
+void mbed_stats_heap_hist_get(mbed_stats_heap_hist_t *hist);
+
+/**
+ * Fill the passed in array with the heap allocations by call site.
+ *
+ * Requires the MBED_HEAP_STATS_ENABLED macro, and MBED_HEAP_STATS_CALLERS
+ * defined to the number of call sites to keep. Each allocation is looked
+ * up by caller in the table, so keep the table small. Allocations of
+ * callers that find the table full are summed in an entry with caller 0.
+ *
+ * @param stats Array of count entries
+ * @param count Number of entries in stats
+ * @return Number of call sites filled in
+ */
+size_t mbed_stats_heap_caller_get(mbed_stats_heap_caller_t *stats, size_t count);
+
+/**
+ * Print the heap stats, the size classes and the call sites with printf.
+ */
+void mbed_stats_heap_dump(void);
+
+typedef struct {
+    uint32_t id;                /**< Thread ID, as osThreadId. */
+    uint32_t entry;             /**< Entry function of the thread, which identifies it. */
+    uint32_t arg;               /**< Argument of the entry function. */
+    uint32_t state;             /**< State of the thread, as rtos::Thread::State. */
+    int32_t  priority;          /**< Priority of the thread, as osPriority. */
+    uint32_t stack_size;        /**< Bytes of stack reserved for the thread. */
+    uint32_t max_stack;         /**< Max bytes of stack the thread used, 0 unless MBED_STACK_STATS_ENABLED. */
+} mbed_stats_thread_t;
+
+typedef struct {
+    uint32_t max_size;          /**< Sum of the max stack bytes used by each thread. */
+    uint32_t reserved_size;     /**< Sum of the stack bytes reserved for each thread. */
+    uint32_t stack_cnt;         /**< Number of stacks. */
+} mbed_stats_stack_t;
+
+/**
+ * Fill the passed in array with the stats of the running threads, main,
+ * the system threads and the idle thread included.
+ *
+ * The max stack usage is the part of a stack that is no longer filled with
+ * the pattern written when the thread started, which needs the
+ * MBED_STACK_STATS_ENABLED macro.
+ *
+ * @param stats Array of count entries
+ * @param count Number of entries in stats
+ * @return Number of threads filled in
+ */
+size_t mbed_stats_thread_get(mbed_stats_thread_t *stats, size_t count);
+
+/**
+ * Fill the passed in structure with the stack stats of all running threads.
+ */
+void mbed_stats_stack_get(mbed_stats_stack_t *stats);
+
+typedef struct {
+    uint64_t total_time;        /**< Time since the scheduler started. */
+    uint64_t idle_time;         /**< Time the idle thread ran. */
+    uint32_t clock;             /**< Units of the times per second. */
+    uint32_t switches;          /**< Number of context switches. */
+} mbed_stats_cpu_t;
+
+typedef struct {
+    uint32_t id;                /**< Thread ID, as osThreadId. */
+    uint64_t cpu_time;          /**< Time the thread ran, in mbed_stats_cpu_t clock units. */
+    uint32_t switches;          /**< Times the thread was switched to. */
+    uint32_t preemptions;       /**< Times the thread was switched from while ready to run. */
+} mbed_stats_thread_cpu_t;
+
+/**
+ * Fill the passed in structure with CPU usage stats.
+ *
+ * Requires the MBED_THREAD_CPU_STATS_ENABLED macro. Times include the
+ * interrupts taken while a thread runs. The CPU usage of a thread between
+ * two snapshots is the difference of its cpu_time over the difference of
+ * total_time.
+ */
+void mbed_stats_cpu_get(mbed_stats_cpu_t *stats);
+
+/**
+ * Fill the passed in array with the CPU usage stats of the running threads,
+ * the idle thread excluded.
+ *
+ * Requires the MBED_THREAD_CPU_STATS_ENABLED macro.
+ *
+ * @param stats Array of count entries
+ * @param count Number of entries in stats
+ * @return Number of threads filled in
+ */
+size_t mbed_stats_thread_cpu_get(mbed_stats_thread_cpu_t *stats, size_t count);
+
+typedef struct {
+    uint32_t id;                /**< Address of the rtos::Mutex. */
+    uint32_t holder;            /**< Thread holding the mutex, as osThreadId, 0 if free. */
+    uint32_t acquire_cnt;       /**< Number of times the mutex was acquired. */
+    uint32_t contended_cnt;     /**< Number of locks that found the mutex held by another thread. */
+    uint32_t max_wait;          /**< Longest wait for the mutex, in us. */
+    uint64_t total_wait;        /**< Cumulative time threads waited for the mutex, in us. */
+} mbed_stats_mutex_t;
+
+/**
+ * Fill the passed in array with the lock stats of the existing rtos::Mutex
+ * objects, PlatformMutex included.
+ *
+ * Requires the MBED_MUTEX_STATS_ENABLED macro. A lock is contended when the
+ * mutex cannot be taken at once, failed trylock calls and timed out locks
+ * count as contended but not as acquired. Mutexes used through the CMSIS
+ * API directly are not included.
+ *
+ * @param stats Array of count entries
+ * @param count Number of entries in stats
+ * @return Number of mutexes filled in
+ */
+size_t mbed_stats_mutex_get(mbed_stats_mutex_t *stats, size_t count);
+
+typedef struct {
+    uint64_t sleep_time;            /**< Time spent in sleep, in us. */
+    uint64_t deep_sleep_time;       /**< Time spent in deep sleep, in us. */
+    uint32_t sleep_cnt;             /**< Number of sleeps. */
+    uint32_t deep_sleep_cnt;        /**< Number of deep sleeps. */
+    uint32_t wakeup_cnt;            /**< Number of sleeps that ended at or after their wake time. */
+    uint32_t max_wakeup_latency;    /**< Longest time from a wake time to the end of its sleep, in us. */
+    uint64_t total_wakeup_latency;  /**< Cumulative time from the wake times to the end of their sleeps, in us. */
+    uint32_t lock_cnt;              /**< Number of deep sleep locks held currently. */
+} mbed_stats_sleep_t;
+
+/**
+ * Fill the passed in structure with the stats of sleep_manager_sleep_auto.
+ *
+ * Times are measured with the low power ticker, they stay 0 without
+ * DEVICE_LOWPOWERTIMER. Wake-up latencies are counted for the sleeps whose
+ * wake time was given with sleep_manager_set_wake_time, as the tickless
+ * idle loop does.
+ */
+void mbed_stats_sleep_get(mbed_stats_sleep_t *stats);
+
 #ifdef __cplusplus
 }
 #endif
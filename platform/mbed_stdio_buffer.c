@@ -0,0 +1,147 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform/mbed_stdio_buffer.h"
+#include "platform/critical.h"
+#include "hal/serial_api.h"
+#include "cmsis.h"
+
+#if DEVICE_SERIAL && defined(MBED_CONF_PLATFORM_STDIO_BUFFER_SIZE) && MBED_CONF_PLATFORM_STDIO_BUFFER_SIZE
+
+#define STDIO_BUFFER_SIZE       MBED_CONF_PLATFORM_STDIO_BUFFER_SIZE
+#define STDIO_BUFFER_MASK       (STDIO_BUFFER_SIZE - 1)
+
+#if STDIO_BUFFER_SIZE & STDIO_BUFFER_MASK
+#error "platform.stdio-buffer-size must be a power of two"
+#endif
+
+#define STDIO_BUFFER_BLOCK      1
+#define STDIO_BUFFER_DROP       2
+#define STDIO_BUFFER_OVERWRITE  3
+
+#define STDIO_BUFFER_POLICY__(policy)   STDIO_BUFFER_##policy
+#define STDIO_BUFFER_POLICY_(policy)    STDIO_BUFFER_POLICY__(policy)
+#define STDIO_BUFFER_POLICY             STDIO_BUFFER_POLICY_(MBED_CONF_PLATFORM_STDIO_BUFFER_OVERFLOW)
+
+extern serial_t stdio_uart;
+
+static uint8_t stdio_buffer[STDIO_BUFFER_SIZE];
+/* Free running positions, written with interrupts disabled */
+static volatile uint32_t stdio_head;
+static volatile uint32_t stdio_tail;
+static uint32_t stdio_dropped;
+static uint8_t stdio_tx_active;
+static uint8_t stdio_irq_attached;
+
+static void stdio_buffer_irq(uint32_t id, SerialIrq event)
+{
+    if (event != TxIrq) {
+        return;
+    }
+
+    while (stdio_tail != stdio_head && serial_writable(&stdio_uart)) {
+        serial_putc(&stdio_uart, stdio_buffer[stdio_tail & STDIO_BUFFER_MASK]);
+        stdio_tail++;
+    }
+    if (stdio_tail == stdio_head) {
+        serial_irq_set(&stdio_uart, TxIrq, 0);
+        stdio_tx_active = 0;
+    }
+}
+
+void mbed_stdio_buffer_write(const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    core_util_critical_section_enter();
+    if (!stdio_irq_attached) {
+        serial_irq_handler(&stdio_uart, stdio_buffer_irq, 0);
+        stdio_irq_attached = 1;
+    }
+
+    for (size_t i = 0; i < length; i++) {
+        if (stdio_head - stdio_tail == STDIO_BUFFER_SIZE) {
+#if STDIO_BUFFER_POLICY == STDIO_BUFFER_BLOCK
+            if (__get_IPSR() == 0 && core_util_are_interrupts_enabled()) {
+                // Let the TX interrupt make room
+                if (!stdio_tx_active) {
+                    stdio_tx_active = 1;
+                    serial_irq_set(&stdio_uart, TxIrq, 1);
+                }
+                core_util_critical_section_exit();
+                while (stdio_head - stdio_tail == STDIO_BUFFER_SIZE) {
+                }
+                core_util_critical_section_enter();
+            } else {
+                serial_putc(&stdio_uart, stdio_buffer[stdio_tail & STDIO_BUFFER_MASK]);
+                stdio_tail++;
+            }
+#elif STDIO_BUFFER_POLICY == STDIO_BUFFER_DROP
+            stdio_dropped += length - i;
+            break;
+#elif STDIO_BUFFER_POLICY == STDIO_BUFFER_OVERWRITE
+            stdio_tail++;
+            stdio_dropped++;
+#else
+#error "platform.stdio-buffer-overflow must be BLOCK, DROP or OVERWRITE"
+#endif
+        }
+        stdio_buffer[stdio_head & STDIO_BUFFER_MASK] = bytes[i];
+        stdio_head++;
+    }
+
+    if (!stdio_tx_active && stdio_tail != stdio_head) {
+        stdio_tx_active = 1;
+        serial_irq_set(&stdio_uart, TxIrq, 1);
+    }
+    core_util_critical_section_exit();
+}
+
+void mbed_stdio_buffer_flush(void)
+{
+    core_util_critical_section_enter();
+    if (stdio_tx_active) {
+        serial_irq_set(&stdio_uart, TxIrq, 0);
+        stdio_tx_active = 0;
+    }
+    while (stdio_tail != stdio_head) {
+        serial_putc(&stdio_uart, stdio_buffer[stdio_tail & STDIO_BUFFER_MASK]);
+        stdio_tail++;
+    }
+    core_util_critical_section_exit();
+}
+
+uint32_t mbed_stdio_buffer_get_dropped(void)
+{
+    return stdio_dropped;
+}
+
+#else
+
+void mbed_stdio_buffer_write(const void *data, size_t length)
+{
+}
+
+void mbed_stdio_buffer_flush(void)
+{
+}
+
+uint32_t mbed_stdio_buffer_get_dropped(void)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,69 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_STDIO_BUFFER_H
+#define MBED_STDIO_BUFFER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Buffered stdio output
+ *
+ * With the platform.stdio-buffer-size option, writes to stdout and stderr
+ * are copied to a ring buffer that the TX interrupt of the stdio UART
+ * drains, instead of waiting for each character to be sent. When the
+ * buffer is full, platform.stdio-buffer-overflow decides:
+ * - BLOCK: the writer waits for room, or sends the oldest bytes itself
+ *   from interrupts and critical sections
+ * - DROP: the bytes that do not fit are dropped
+ * - OVERWRITE: the oldest bytes are dropped
+ *
+ * The buffer is flushed by exit and before error messages. The TX
+ * interrupt of the stdio UART belongs to the buffer, so no Serial may be
+ * opened on the stdio pins.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Add bytes to the buffer
+ *
+ * @param data   Bytes to send
+ * @param length Number of bytes
+ */
+void mbed_stdio_buffer_write(const void *data, size_t length);
+
+/** Send the buffered bytes, waiting for them with interrupts disabled
+ *
+ * Can be called from fault handlers.
+ */
+void mbed_stdio_buffer_flush(void);
+
+/** Get the number of bytes dropped as the buffer was full
+ *
+ * @return Bytes dropped since boot
+ */
+uint32_t mbed_stdio_buffer_get_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
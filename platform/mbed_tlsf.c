@@ -0,0 +1,679 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "platform/mbed_tlsf.h"
+
+#if defined(TOOLCHAIN_GCC) && !defined(FEATURE_UVISOR)
+
+#include <string.h>
+#include "platform/mbed_error.h"
+
+#ifndef MBED_CONF_PLATFORM_HEAP_TLSF_GROW
+#define MBED_CONF_PLATFORM_HEAP_TLSF_GROW   4096
+#endif
+
+/* Blocks are aligned to 8 bytes, every power of two above TLSF_SMALL_BLOCK
+ * is split in TLSF_SL_COUNT size classes, and all sizes below it share the
+ * first level 0 with classes 8 bytes apart */
+#define TLSF_ALIGN_LOG2     3
+#define TLSF_ALIGN          (1 << TLSF_ALIGN_LOG2)
+#define TLSF_SL_LOG2        4
+#define TLSF_SL_COUNT       (1 << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT       (TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_FL_MAX         30
+#define TLSF_FL_COUNT       (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_SMALL_BLOCK    (1 << TLSF_FL_SHIFT)
+
+/* Flags in the low bits of the size */
+#define TLSF_FREE           0x1
+#define TLSF_PREV_FREE      0x2
+#define TLSF_FLAGS          (TLSF_FREE | TLSF_PREV_FREE)
+
+/* The size is the size of the payload, which follows the size field.
+ * prev_phys is only valid while the previous block is free, next_free and
+ * prev_free are in the payload and only used while the block is free. */
+typedef struct tlsf_block {
+    struct tlsf_block *prev_phys;
+    uint32_t size;
+    struct tlsf_block *next_free;
+    struct tlsf_block *prev_free;
+} tlsf_block_t;
+
+#define TLSF_HEADER         offsetof(tlsf_block_t, next_free)
+#define TLSF_BLOCK_MIN      (sizeof(tlsf_block_t) - TLSF_HEADER)
+#define TLSF_BLOCK_MAX      ((uint32_t)1 << TLSF_FL_MAX)
+
+/* Pools are the chunks of memory of a heap that are not contiguous with the
+ * previous one. Each ends with a sentinel block of size 0 that is in use. */
+typedef struct tlsf_pool {
+    struct tlsf_pool *next;
+    uint32_t size;
+} tlsf_pool_t;
+
+typedef struct mbed_tlsf {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[TLSF_FL_COUNT];
+    tlsf_block_t *blocks[TLSF_FL_COUNT][TLSF_SL_COUNT];
+    tlsf_pool_t *pools;
+    tlsf_block_t *sentinel;         /* End of the last pool */
+    uint32_t pool_size;
+} tlsf_control_t;
+
+/* The heap behind mbed_tlsf_malloc, the only one that grows with _sbrk */
+static tlsf_control_t tlsf_sbrk;
+
+struct _reent;
+extern void __malloc_lock(struct _reent *r);
+extern void __malloc_unlock(struct _reent *r);
+extern void *_sbrk(int incr);
+
+static inline int tlsf_fls(uint32_t word)
+{
+    return 31 - __builtin_clz(word);
+}
+
+static inline int tlsf_ffs(uint32_t word)
+{
+    return __builtin_ctz(word);
+}
+
+static inline uint32_t block_size(const tlsf_block_t *block)
+{
+    return block->size & ~TLSF_FLAGS;
+}
+
+static inline void block_set_size(tlsf_block_t *block, uint32_t size)
+{
+    block->size = size | (block->size & TLSF_FLAGS);
+}
+
+static inline int block_is_free(const tlsf_block_t *block)
+{
+    return block->size & TLSF_FREE;
+}
+
+static inline int block_is_prev_free(const tlsf_block_t *block)
+{
+    return block->size & TLSF_PREV_FREE;
+}
+
+static inline void *block_to_ptr(const tlsf_block_t *block)
+{
+    return (char *)block + TLSF_HEADER;
+}
+
+static inline tlsf_block_t *block_from_ptr(const void *ptr)
+{
+    return (tlsf_block_t *)((char *)ptr - TLSF_HEADER);
+}
+
+static inline tlsf_block_t *block_next(const tlsf_block_t *block)
+{
+    return (tlsf_block_t *)((char *)block_to_ptr(block) + block_size(block));
+}
+
+/* Link the next block back to this one and tell it whether this one is free */
+static inline void block_mark_free(tlsf_block_t *block)
+{
+    tlsf_block_t *next = block_next(block);
+    next->prev_phys = block;
+    next->size |= TLSF_PREV_FREE;
+    block->size |= TLSF_FREE;
+}
+
+static inline void block_mark_used(tlsf_block_t *block)
+{
+    tlsf_block_t *next = block_next(block);
+    next->size &= ~TLSF_PREV_FREE;
+    block->size &= ~TLSF_FREE;
+}
+
+static inline void mapping_insert(uint32_t size, int *fli, int *sli)
+{
+    int fl, sl;
+    if (size < TLSF_SMALL_BLOCK) {
+        fl = 0;
+        sl = size / (TLSF_SMALL_BLOCK / TLSF_SL_COUNT);
+    } else {
+        fl = tlsf_fls(size);
+        sl = (size >> (fl - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        fl -= TLSF_FL_SHIFT - 1;
+    }
+    *fli = fl;
+    *sli = sl;
+}
+
+/* Round up to the next size class, so that any block of the class fits */
+static inline void mapping_search(uint32_t size, int *fli, int *sli)
+{
+    if (size >= TLSF_SMALL_BLOCK) {
+        size += (1 << (tlsf_fls(size) - TLSF_SL_LOG2)) - 1;
+    }
+    mapping_insert(size, fli, sli);
+}
+
+static tlsf_block_t *search_suitable(tlsf_control_t *t, int *fli, int *sli)
+{
+    int fl = *fli;
+    int sl;
+    uint32_t sl_map;
+
+    if (fl >= TLSF_FL_COUNT) {
+        return NULL;
+    }
+
+    sl_map = t->sl_bitmap[fl] & (~0UL << *sli);
+    if (!sl_map) {
+        uint32_t fl_map = (fl + 1 < 32) ? t->fl_bitmap & (~0UL << (fl + 1)) : 0;
+        if (!fl_map) {
+            return NULL;
+        }
+        fl = tlsf_ffs(fl_map);
+        sl_map = t->sl_bitmap[fl];
+    }
+    sl = tlsf_ffs(sl_map);
+
+    *fli = fl;
+    *sli = sl;
+    return t->blocks[fl][sl];
+}
+
+static void remove_free(tlsf_control_t *t, tlsf_block_t *block, int fl, int sl)
+{
+    tlsf_block_t *prev = block->prev_free;
+    tlsf_block_t *next = block->next_free;
+
+    if (next) {
+        next->prev_free = prev;
+    }
+    if (prev) {
+        prev->next_free = next;
+    } else {
+        t->blocks[fl][sl] = next;
+        if (!next) {
+            t->sl_bitmap[fl] &= ~(1UL << sl);
+            if (!t->sl_bitmap[fl]) {
+                t->fl_bitmap &= ~(1UL << fl);
+            }
+        }
+    }
+}
+
+static void insert_free(tlsf_control_t *t, tlsf_block_t *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+
+    tlsf_block_t *head = t->blocks[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head) {
+        head->prev_free = block;
+    }
+    t->blocks[fl][sl] = block;
+    t->fl_bitmap |= 1UL << fl;
+    t->sl_bitmap[fl] |= 1UL << sl;
+}
+
+static void remove_block(tlsf_control_t *t, tlsf_block_t *block)
+{
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    remove_free(t, block, fl, sl);
+}
+
+/* Merge a free block with its free neighbours, which are taken out of their
+ * lists, and return the merged block, which is not in any list */
+static tlsf_block_t *merge_free(tlsf_control_t *t, tlsf_block_t *block)
+{
+    if (block_is_prev_free(block)) {
+        tlsf_block_t *prev = block->prev_phys;
+        remove_block(t, prev);
+        block_set_size(prev, block_size(prev) + TLSF_HEADER + block_size(block));
+        block = prev;
+    }
+
+    tlsf_block_t *next = block_next(block);
+    if (block_is_free(next)) {
+        remove_block(t, next);
+        block_set_size(block, block_size(block) + TLSF_HEADER + block_size(next));
+    }
+
+    block_mark_free(block);
+    return block;
+}
+
+/* Give the end of a block beyond size back to the free lists, if it is large
+ * enough for a block of its own */
+static void trim(tlsf_control_t *t, tlsf_block_t *block, uint32_t size)
+{
+    uint32_t rest = block_size(block) - size;
+    if (rest < sizeof(tlsf_block_t)) {
+        return;
+    }
+
+    block_set_size(block, size);
+    tlsf_block_t *remaining = block_next(block);
+    remaining->size = rest - TLSF_HEADER;
+    insert_free(t, merge_free(t, remaining));
+}
+
+/* Add memory to a heap, extending the last pool when it is contiguous */
+static int add_pool(tlsf_control_t *t, char *mem, uint32_t size)
+{
+    tlsf_block_t *block;
+
+    if (t->sentinel && mem == (char *)block_to_ptr(t->sentinel)) {
+        /* The old sentinel becomes the header of the new memory */
+        block = t->sentinel;
+        t->pools->size += size;
+        block_set_size(block, size - TLSF_HEADER);
+    } else {
+        char *start = (char *)(((uintptr_t)mem + TLSF_ALIGN - 1) & ~(uintptr_t)(TLSF_ALIGN - 1));
+        uint32_t avail = (size - (start - mem)) & ~(TLSF_ALIGN - 1);
+        if (size < (uint32_t)(start - mem) ||
+                avail < sizeof(tlsf_pool_t) + 2 * TLSF_HEADER + TLSF_BLOCK_MIN) {
+            return -1;
+        }
+
+        tlsf_pool_t *pool = (tlsf_pool_t *)start;
+        pool->next = t->pools;
+        pool->size = avail;
+        t->pools = pool;
+
+        block = (tlsf_block_t *)(pool + 1);
+        block->size = avail - sizeof(tlsf_pool_t) - 2 * TLSF_HEADER;
+        size = avail;
+    }
+
+    t->pool_size += size;
+    t->sentinel = block_next(block);
+    t->sentinel->size = 0;
+    insert_free(t, merge_free(t, block));
+    return 0;
+}
+
+/* Add memory from _sbrk to the default heap */
+static int grow(tlsf_control_t *t, uint32_t size)
+{
+    if (t != &tlsf_sbrk) {
+        return -1;
+    }
+
+    /* The block has to be in the size class searched for, or a larger one */
+    if (size >= TLSF_SMALL_BLOCK) {
+        size += (1 << (tlsf_fls(size) - TLSF_SL_LOG2)) - 1;
+    }
+
+    uint32_t incr = size + sizeof(tlsf_pool_t) + 2 * TLSF_HEADER;
+    if (incr < MBED_CONF_PLATFORM_HEAP_TLSF_GROW) {
+        incr = MBED_CONF_PLATFORM_HEAP_TLSF_GROW;
+    }
+    incr = (incr + TLSF_ALIGN - 1) & ~(TLSF_ALIGN - 1);
+
+    char *mem = (char *)_sbrk(incr);
+    if (mem == (char *)-1) {
+        incr = (size + sizeof(tlsf_pool_t) + 2 * TLSF_HEADER + TLSF_ALIGN - 1) & ~(TLSF_ALIGN - 1);
+        mem = (char *)_sbrk(incr);
+        if (mem == (char *)-1) {
+            return -1;
+        }
+    }
+
+    /* _sbrk is only ever moved by multiples of 8, so contiguous memory
+     * extends the last pool exactly */
+    return add_pool(t, mem, incr);
+}
+
+static uint32_t adjust_size(size_t size)
+{
+    if (size > TLSF_BLOCK_MAX - TLSF_ALIGN) {
+        return 0;
+    }
+    uint32_t adjusted = (size + TLSF_ALIGN - 1) & ~(TLSF_ALIGN - 1);
+    return adjusted < TLSF_BLOCK_MIN ? TLSF_BLOCK_MIN : adjusted;
+}
+
+/* Take a free block of at least size bytes out of its list, growing the heap
+ * if there is none */
+static tlsf_block_t *locate_free(tlsf_control_t *t, uint32_t size)
+{
+    int fl, sl;
+
+    mapping_search(size, &fl, &sl);
+    tlsf_block_t *block = search_suitable(t, &fl, &sl);
+    if (!block) {
+        if (grow(t, size) < 0) {
+            return NULL;
+        }
+        mapping_search(size, &fl, &sl);
+        block = search_suitable(t, &fl, &sl);
+        if (!block) {
+            return NULL;
+        }
+    }
+
+    remove_free(t, block, fl, sl);
+    return block;
+}
+
+static void *tlsf_malloc(tlsf_control_t *t, size_t size)
+{
+    uint32_t adjusted = adjust_size(size);
+    if (!adjusted) {
+        return NULL;
+    }
+
+    tlsf_block_t *block = locate_free(t, adjusted);
+    if (!block) {
+        return NULL;
+    }
+
+    block_mark_used(block);
+    trim(t, block, adjusted);
+    return block_to_ptr(block);
+}
+
+static void *tlsf_memalign(tlsf_control_t *t, size_t align, size_t size)
+{
+    if (align & (align - 1)) {
+        return NULL;
+    }
+    if (align <= TLSF_ALIGN) {
+        return tlsf_malloc(t, size);
+    }
+
+    /* Room to move the payload up to the alignment, leaving a free block of
+     * its own in front of it */
+    uint32_t adjusted = adjust_size(size);
+    if (!adjusted || align > TLSF_BLOCK_MAX / 2 ||
+            adjusted > TLSF_BLOCK_MAX - align - sizeof(tlsf_block_t)) {
+        return NULL;
+    }
+
+    tlsf_block_t *block = locate_free(t, adjusted + align + sizeof(tlsf_block_t));
+    if (!block) {
+        return NULL;
+    }
+
+    uintptr_t ptr = (uintptr_t)block_to_ptr(block);
+    uintptr_t aligned = (ptr + align - 1) & ~(uintptr_t)(align - 1);
+    if (aligned != ptr && aligned - ptr < sizeof(tlsf_block_t)) {
+        aligned = (ptr + sizeof(tlsf_block_t) + align - 1) & ~(uintptr_t)(align - 1);
+    }
+
+    if (aligned != ptr) {
+        /* The start of the block goes back to the free lists, its previous
+         * block is in use as it was free itself */
+        uint32_t gap = aligned - ptr;
+        tlsf_block_t *aligned_block = block_from_ptr((void *)aligned);
+        aligned_block->size = block_size(block) - gap;
+        block_set_size(block, gap - TLSF_HEADER);
+        block_mark_free(block);
+        insert_free(t, block);
+        block = aligned_block;
+    }
+
+    block_mark_used(block);
+    trim(t, block, adjusted);
+    return block_to_ptr(block);
+}
+
+/* Checks a block handed to free or realloc in constant time */
+static tlsf_block_t *block_check_used(tlsf_control_t *t, void *ptr)
+{
+    tlsf_block_t *block = block_from_ptr(ptr);
+    uint32_t size = block_size(block);
+
+    if (((uintptr_t)ptr & (TLSF_ALIGN - 1)) || block_is_free(block) ||
+            size < TLSF_BLOCK_MIN || size > t->pool_size ||
+            block_is_prev_free(block_next(block))) {
+        error("TLSF heap: invalid free of %p\r\n", ptr);
+    }
+    return block;
+}
+
+static void tlsf_free(tlsf_control_t *t, void *ptr)
+{
+    tlsf_block_t *block = block_check_used(t, ptr);
+    insert_free(t, merge_free(t, block));
+}
+
+static void *tlsf_realloc(tlsf_control_t *t, void *ptr, size_t size)
+{
+    uint32_t adjusted = adjust_size(size);
+    if (!adjusted) {
+        return NULL;
+    }
+
+    tlsf_block_t *block = block_check_used(t, ptr);
+    uint32_t current = block_size(block);
+
+    if (adjusted > current) {
+        tlsf_block_t *next = block_next(block);
+        if (!block_is_free(next) || current + TLSF_HEADER + block_size(next) < adjusted) {
+            void *new_ptr = tlsf_malloc(t, size);
+            if (new_ptr) {
+                memcpy(new_ptr, ptr, current);
+                tlsf_free(t, ptr);
+            }
+            return new_ptr;
+        }
+
+        remove_block(t, next);
+        block_set_size(block, current + TLSF_HEADER + block_size(next));
+        block_mark_used(block);
+    }
+
+    trim(t, block, adjusted);
+    return ptr;
+}
+
+mbed_tlsf_t *mbed_tlsf_create(void *mem, size_t size)
+{
+    char *start = (char *)(((uintptr_t)mem + TLSF_ALIGN - 1) & ~(uintptr_t)(TLSF_ALIGN - 1));
+    size_t skip = (start - (char *)mem) + ((sizeof(tlsf_control_t) + TLSF_ALIGN - 1) & ~(TLSF_ALIGN - 1));
+
+    if (size <= skip || size - skip > TLSF_BLOCK_MAX) {
+        return NULL;
+    }
+
+    tlsf_control_t *t = (tlsf_control_t *)start;
+    memset(t, 0, sizeof(*t));
+    if (add_pool(t, (char *)mem + skip, size - skip) < 0) {
+        return NULL;
+    }
+    return t;
+}
+
+void *mbed_tlsf_heap_malloc(mbed_tlsf_t *heap, size_t size)
+{
+    __malloc_lock(NULL);
+    void *ptr = tlsf_malloc(heap, size);
+    __malloc_unlock(NULL);
+    return ptr;
+}
+
+void *mbed_tlsf_heap_memalign(mbed_tlsf_t *heap, size_t align, size_t size)
+{
+    __malloc_lock(NULL);
+    void *ptr = tlsf_memalign(heap, align, size);
+    __malloc_unlock(NULL);
+    return ptr;
+}
+
+void mbed_tlsf_heap_free(mbed_tlsf_t *heap, void *ptr)
+{
+    if (!ptr) {
+        return;
+    }
+
+    __malloc_lock(NULL);
+    tlsf_free(heap, ptr);
+    __malloc_unlock(NULL);
+}
+
+void *mbed_tlsf_malloc(size_t size)
+{
+    return mbed_tlsf_heap_malloc(&tlsf_sbrk, size);
+}
+
+void *mbed_tlsf_memalign(size_t align, size_t size)
+{
+    return mbed_tlsf_heap_memalign(&tlsf_sbrk, align, size);
+}
+
+void *mbed_tlsf_calloc(size_t nmemb, size_t size)
+{
+    if (size && nmemb > (size_t)-1 / size) {
+        return NULL;
+    }
+
+    void *ptr = mbed_tlsf_malloc(nmemb * size);
+    if (ptr) {
+        memset(ptr, 0, nmemb * size);
+    }
+    return ptr;
+}
+
+void *mbed_tlsf_realloc(void *ptr, size_t size)
+{
+    if (!ptr) {
+        return mbed_tlsf_malloc(size);
+    }
+    if (!size) {
+        mbed_tlsf_free(ptr);
+        return NULL;
+    }
+
+    __malloc_lock(NULL);
+    void *new_ptr = tlsf_realloc(&tlsf_sbrk, ptr, size);
+    __malloc_unlock(NULL);
+    return new_ptr;
+}
+
+void mbed_tlsf_free(void *ptr)
+{
+    mbed_tlsf_heap_free(&tlsf_sbrk, ptr);
+}
+
+/* Walk all blocks and count the free ones, which must all be found in the
+ * list of their size class */
+static int tlsf_walk(tlsf_control_t *t, mbed_tlsf_info_t *info)
+{
+    uint32_t free_cnt = 0;
+
+    memset(info, 0, sizeof(*info));
+    info->pool_size = t->pool_size;
+
+    for (tlsf_pool_t *pool = t->pools; pool; pool = pool->next) {
+        char *end = (char *)pool + pool->size;
+        tlsf_block_t *block = (tlsf_block_t *)(pool + 1);
+        int prev_free = 0;
+
+        while (block_size(block)) {
+            uint32_t size = block_size(block);
+            tlsf_block_t *next;
+
+            if ((size & (TLSF_ALIGN - 1)) || size < TLSF_BLOCK_MIN ||
+                    (char *)block_to_ptr(block) + size + TLSF_HEADER > end) {
+                return -1;
+            }
+            if (!!block_is_prev_free(block) != prev_free) {
+                return -1;
+            }
+
+            next = block_next(block);
+            if (block_is_free(block)) {
+                /* Free neighbours are always merged */
+                if (prev_free || next->prev_phys != block) {
+                    return -1;
+                }
+                info->free_cnt += 1;
+                info->free_size += size;
+                if (size > info->largest_free) {
+                    info->largest_free = size;
+                }
+            } else {
+                info->used_cnt += 1;
+            }
+
+            prev_free = block_is_free(block);
+            block = next;
+        }
+
+        if (!!block_is_prev_free(block) != prev_free || block_is_free(block) ||
+                (char *)block + TLSF_HEADER != end) {
+            return -1;
+        }
+    }
+
+    for (int fl = 0; fl < TLSF_FL_COUNT; fl++) {
+        if (!!(t->fl_bitmap & (1UL << fl)) != !!t->sl_bitmap[fl]) {
+            return -1;
+        }
+
+        for (int sl = 0; sl < TLSF_SL_COUNT; sl++) {
+            tlsf_block_t *block = t->blocks[fl][sl];
+            tlsf_block_t *prev = NULL;
+
+            if (!!(t->sl_bitmap[fl] & (1UL << sl)) != !!block) {
+                return -1;
+            }
+
+            for (; block; prev = block, block = block->next_free) {
+                int block_fl, block_sl;
+                mapping_insert(block_size(block), &block_fl, &block_sl);
+                if (!block_is_free(block) || block->prev_free != prev ||
+                        block_fl != fl || block_sl != sl ||
+                        ++free_cnt > info->free_cnt) {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return free_cnt == info->free_cnt ? 0 : -1;
+}
+
+int mbed_tlsf_heap_check(mbed_tlsf_t *heap)
+{
+    mbed_tlsf_info_t info;
+
+    __malloc_lock(NULL);
+    int ret = tlsf_walk(heap, &info);
+    __malloc_unlock(NULL);
+    return ret;
+}
+
+void mbed_tlsf_heap_get_info(mbed_tlsf_t *heap, mbed_tlsf_info_t *info)
+{
+    __malloc_lock(NULL);
+    tlsf_walk(heap, info);
+    __malloc_unlock(NULL);
+}
+
+int mbed_tlsf_check(void)
+{
+    return mbed_tlsf_heap_check(&tlsf_sbrk);
+}
+
+void mbed_tlsf_get_info(mbed_tlsf_info_t *info)
+{
+    mbed_tlsf_heap_get_info(&tlsf_sbrk, info);
+}
+
+#endif
@@ -0,0 +1,171 @@
+/** \addtogroup platform */
+/** @{*/
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef MBED_TLSF_H
+#define MBED_TLSF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Two-level segregated fit heap
+ *
+ * Free blocks are kept in lists by size class, 16 classes per power of two,
+ * and two levels of bitmaps tell which lists are not empty. malloc and free
+ * take a fixed number of steps whatever the state of the heap, and a block
+ * is merged with its free neighbours as soon as it is freed, which keeps
+ * the heap from fragmenting over long uptimes.
+ *
+ * The default heap grows through _sbrk in chunks of the
+ * platform.heap-tlsf-grow option. The platform.heap-tlsf option makes the
+ * GCC malloc wrappers use it instead of the C library allocator, the heap
+ * stats and memory tracing of the wrappers work on top of it. Further heaps
+ * of fixed memory ranges can be created with mbed_tlsf_create. All heaps
+ * are locked with the C library malloc lock. GCC only. */
+
+/** A heap on a fixed memory range */
+typedef struct mbed_tlsf mbed_tlsf_t;
+
+typedef struct {
+    uint32_t pool_size;         /**< Bytes taken from _sbrk by the heap. */
+    uint32_t free_size;         /**< Bytes in free blocks. */
+    uint32_t largest_free;      /**< Size of the largest free block. */
+    uint32_t free_cnt;          /**< Number of free blocks. */
+    uint32_t used_cnt;          /**< Number of allocated blocks. */
+} mbed_tlsf_info_t;
+
+/** Allocate memory, aligned to 8 bytes
+ *
+ * @param size Size in bytes
+ * @return Allocated memory, NULL if the heap is full
+ */
+void *mbed_tlsf_malloc(size_t size);
+
+/** Allocate memory aligned to a power of two
+ *
+ * @param align Alignment in bytes, a power of two
+ * @param size  Size in bytes
+ * @return Allocated memory, to be freed with mbed_tlsf_free, NULL if the
+ *         heap is full or align is not a power of two
+ */
+void *mbed_tlsf_memalign(size_t align, size_t size);
+
+/** Allocate zeroed memory for an array
+ *
+ * @param nmemb Number of elements
+ * @param size  Size of an element in bytes
+ * @return Allocated memory, NULL if the heap is full or the size overflows
+ */
+void *mbed_tlsf_calloc(size_t nmemb, size_t size);
+
+/** Resize memory, in place when the block or its next neighbour allows it
+ *
+ * @param ptr  Memory from mbed_tlsf_malloc, or NULL to allocate
+ * @param size New size in bytes, 0 to free
+ * @return Resized memory, NULL if the heap is full, in which case ptr
+ *         is left allocated
+ */
+void *mbed_tlsf_realloc(void *ptr, size_t size);
+
+/** Free memory
+ *
+ * Freeing a pointer that was not allocated, or twice, is a fatal error.
+ *
+ * @param ptr Memory from mbed_tlsf_malloc, or NULL
+ */
+void mbed_tlsf_free(void *ptr);
+
+/** Check the integrity of the whole heap
+ *
+ * Walks all blocks and free lists, in time proportional to the number of
+ * blocks, with the heap locked.
+ *
+ * @return 0 if the heap is consistent, -1 if it is corrupted
+ */
+int mbed_tlsf_check(void);
+
+/** Get the state of the heap
+ *
+ * Walks the heap like mbed_tlsf_check.
+ *
+ * @param info Filled with the state of the heap
+ */
+void mbed_tlsf_get_info(mbed_tlsf_info_t *info);
+
+/** Create a heap on a memory range
+ *
+ * The heap keeps its state at the start of the range, which takes about
+ * 1.7kB. The range is used as it is, memory that needs to be set up, such
+ * as external SDRAM, must be ready before the heap is created.
+ *
+ * @param mem  Start of the range
+ * @param size Size of the range in bytes
+ * @return Heap, NULL if the range is too small
+ */
+mbed_tlsf_t *mbed_tlsf_create(void *mem, size_t size);
+
+/** Allocate memory from a heap, aligned to 8 bytes
+ *
+ * @param heap Heap from mbed_tlsf_create
+ * @param size Size in bytes
+ * @return Allocated memory, NULL if the heap is full
+ */
+void *mbed_tlsf_heap_malloc(mbed_tlsf_t *heap, size_t size);
+
+/** Allocate memory from a heap, aligned to a power of two
+ *
+ * @param heap  Heap from mbed_tlsf_create
+ * @param align Alignment in bytes, a power of two
+ * @param size  Size in bytes
+ * @return Allocated memory, NULL if the heap is full or align is not a
+ *         power of two
+ */
+void *mbed_tlsf_heap_memalign(mbed_tlsf_t *heap, size_t align, size_t size);
+
+/** Free memory to the heap it was allocated from
+ *
+ * @param heap Heap the memory was allocated from
+ * @param ptr  Memory from mbed_tlsf_heap_malloc or
+ *             mbed_tlsf_heap_memalign, or NULL
+ */
+void mbed_tlsf_heap_free(mbed_tlsf_t *heap, void *ptr);
+
+/** Check the integrity of a heap, like mbed_tlsf_check
+ *
+ * @param heap Heap from mbed_tlsf_create
+ * @return 0 if the heap is consistent, -1 if it is corrupted
+ */
+int mbed_tlsf_heap_check(mbed_tlsf_t *heap);
+
+/** Get the state of a heap, like mbed_tlsf_get_info
+ *
+ * @param heap Heap from mbed_tlsf_create
+ * @param info Filled with the state of the heap
+ */
+void mbed_tlsf_heap_get_info(mbed_tlsf_t *heap, mbed_tlsf_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/** @}*/
@@ -30,6 +30,11 @@ void wait_ms(int ms) {
 }
 
 void wait_us(int us) {
+    // Count cycles for short delays, reading the ticker may take a microsecond
+    if (us < 1000) {
+        wait_ns(us * 1000);
+        return;
+    }
     uint32_t start = us_ticker_read();
     while ((us_ticker_read() - start) < (uint32_t)us);
 }
@@ -32,17 +32,26 @@ void wait_ms(int ms) {
 }
 
 void wait_us(int us) {
+    // Count cycles for short delays, reading the ticker may take a microsecond
+    if (us < 1000) {
+        wait_ns(us * 1000);
+        return;
+    }
     uint32_t start = us_ticker_read();
     // Use the RTOS to wait for millisecond delays if possible
     int ms = us / 1000;
     if ((ms > 0) && core_util_are_interrupts_enabled()) {
         Thread::wait((uint32_t)ms);
-        us -= ms * 1000;
     }
     // Use busy waiting for sub-millisecond delays, or for the whole
     // interval if interrupts are not enabled
-    if (us > 0) {
-        while((us_ticker_read() - start) < (uint32_t)us);
+    uint32_t left = (uint32_t)us - (us_ticker_read() - start);
+    if ((int32_t)left > 0) {
+        if (left < 1000) {
+            wait_ns(left * 1000);
+        } else {
+            while((us_ticker_read() - start) < (uint32_t)us);
+        }
     }
 }
 
@@ -0,0 +1,103 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "platform/wait_api.h"
+#include "cmsis.h"
+
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+#define WAIT_NS_CYCCNT  1
+#else
+#define WAIT_NS_CYCCNT  0
+#include "hal/us_ticker_api.h"
+#include "platform/critical.h"
+#endif
+
+/* Core clock cycles in ns, the split keeps it in 32 bits below 2^31 ns */
+static uint32_t wait_ns_to_cycles(uint32_t ns, uint32_t hz) {
+    uint32_t mhz = hz / 1000000;
+    return (ns / 1000) * mhz + ((ns % 1000) * mhz) / 1000;
+}
+
+#if WAIT_NS_CYCCNT
+
+static uint8_t wait_ns_ready;
+
+void wait_ns(int ns) {
+    if (ns <= 0) {
+        return;
+    }
+    if (!wait_ns_ready) {
+        // as mbed_profile_init, the M7 DWT is locked after reset
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+#if (__CORTEX_M == 7)
+        DWT->LAR = 0xC5ACCE55;
+#endif
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        wait_ns_ready = 1;
+    }
+
+    // the counter keeps running through interrupts, they are part of the wait
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles = wait_ns_to_cycles((uint32_t)ns, SystemCoreClock);
+    while ((DWT->CYCCNT - start) < cycles);
+}
+
+#else
+
+/* Cortex-M0 has no cycle counter: a loop timed once against the us ticker,
+ * and again when the core clock changes. Interrupts taken meanwhile make
+ * the wait longer. */
+#define WAIT_NS_CALIBRATION_LOOPS   1024
+
+static uint32_t wait_ns_clock;
+/* Loops per cycle, in 1/65536, below 65536 as a loop takes cycles */
+static uint32_t wait_ns_loops_q16;
+
+static void wait_ns_loop(uint32_t loops) {
+    volatile uint32_t n = loops;
+    while (n) {
+        n = n - 1;
+    }
+}
+
+static void wait_ns_calibrate(void) {
+    core_util_critical_section_enter();
+    uint32_t start = us_ticker_read();
+    wait_ns_loop(WAIT_NS_CALIBRATION_LOOPS);
+    uint32_t us = us_ticker_read() - start;
+    core_util_critical_section_exit();
+
+    uint32_t cycles = wait_ns_to_cycles(us * 1000, SystemCoreClock);
+    if (cycles < WAIT_NS_CALIBRATION_LOOPS) {
+        cycles = WAIT_NS_CALIBRATION_LOOPS;
+    }
+    wait_ns_loops_q16 = (WAIT_NS_CALIBRATION_LOOPS << 16) / cycles;
+    wait_ns_clock = SystemCoreClock;
+}
+
+void wait_ns(int ns) {
+    if (ns <= 0) {
+        return;
+    }
+    if (wait_ns_clock != SystemCoreClock) {
+        wait_ns_calibrate();
+    }
+    // no 64-bit division, a library call takes microseconds on M0
+    uint32_t cycles = wait_ns_to_cycles((uint32_t)ns, SystemCoreClock);
+    uint32_t loops = (cycles >> 16) * wait_ns_loops_q16 + (((cycles & 0xFFFF) * wait_ns_loops_q16) >> 16);
+    wait_ns_loop(loops);
+}
+
+#endif
@@ -25,6 +25,10 @@
 #include "platform/PlatformMutex.h"
 #include "platform/mbed_error.h"
 #include "platform/mbed_stats.h"
+#include "platform/mbed_stdio_buffer.h"
+#include "platform/mbed_printf.h"
+#include "platform/critical.h"
+#include "platform/mbed_boot_time.h"
 #include <stdlib.h>
 #include <string.h>
 #if DEVICE_STDIO_MESSAGES
@@ -84,12 +88,97 @@ uint32_t mbed_heap_size = 0;
 static FileHandle *filehandles[OPEN_MAX];
 static SingletonPtr<PlatformMutex> filehandle_mutex;
 
+#if MBED_CONF_PLATFORM_FILE_BUFFER_SIZE
+/* The write-back buffer of a file opened for writing on a filesystem,
+ * gathering the small writes of the C library into ones of the buffer size
+ * aligned on the file offset. It is written on a read, seek, fsync and close
+ * of the file, or when full. */
+struct file_buffer_t {
+    unsigned int length;
+    unsigned int capacity;  // up to the next multiple of the buffer size in the file
+    unsigned char data[MBED_CONF_PLATFORM_FILE_BUFFER_SIZE];
+};
+static file_buffer_t *filebuffers[OPEN_MAX];
+
+/* Writes the buffered bytes of a file, 0 on success */
+static int file_buffer_drain(FILEHANDLE fh) {
+    file_buffer_t *fb = filebuffers[fh-3];
+    if (fb == NULL || fb->length == 0) return 0;
+
+    unsigned int length = fb->length;
+    fb->length = 0;
+    fb->capacity = 0;
+    return (filehandles[fh-3]->write(fb->data, length) == (ssize_t)length) ? 0 : -1;
+}
+
+static int file_buffer_write(FILEHANDLE fh, const unsigned char *buffer, unsigned int length) {
+    file_buffer_t *fb = filebuffers[fh-3];
+    FileHandle *fhc = filehandles[fh-3];
+    unsigned int done = 0;
+
+    while (done < length) {
+        if (fb->length == 0) {
+            off_t position = fhc->lseek(0, SEEK_CUR);
+            fb->capacity = MBED_CONF_PLATFORM_FILE_BUFFER_SIZE;
+            if (position > 0) {
+                fb->capacity -= position % MBED_CONF_PLATFORM_FILE_BUFFER_SIZE;
+            }
+            /* whole buffers, as from a stream given a large one with
+             * setvbuf, are not copied */
+            if (length - done >= fb->capacity) {
+                unsigned int n = length - done;
+                n -= (n - fb->capacity) % MBED_CONF_PLATFORM_FILE_BUFFER_SIZE;
+                ssize_t written = fhc->write(buffer + done, n);
+                if (written < 0) return done ? (int)done : (int)written;
+                done += written;
+                if ((unsigned int)written < n) break;
+                continue;
+            }
+        }
+        unsigned int n = fb->capacity - fb->length;
+        if (n > length - done) {
+            n = length - done;
+        }
+        memcpy(fb->data + fb->length, buffer + done, n);
+        fb->length += n;
+        done += n;
+        if (fb->length == fb->capacity && file_buffer_drain(fh) != 0) {
+            return -1;
+        }
+    }
+    return done;
+}
+#else
+static inline int file_buffer_drain(FILEHANDLE fh) {
+    (void)fh;
+    return 0;
+}
+#endif
+
+int FileHandle::drain_buffer() {
+    int ret = 0;
+    filehandle_mutex->lock();
+    for (unsigned int fh_i = 0; fh_i < sizeof(filehandles)/sizeof(*filehandles); fh_i++) {
+        if (filehandles[fh_i] == this && file_buffer_drain(fh_i + 3) != 0) {
+            ret = -1;
+        }
+    }
+    filehandle_mutex->unlock();
+    return ret;
+}
+
 FileHandle::~FileHandle() {
     filehandle_mutex->lock();
-    /* Remove all open filehandles for this */
+    /* Remove all open filehandles for this. The derived object is gone, so
+     * the write-back buffer can no longer be written: handles closing
+     * themselves drain it first with drain_buffer() */
     for (unsigned int fh_i = 0; fh_i < sizeof(filehandles)/sizeof(*filehandles); fh_i++) {
         if (filehandles[fh_i] == this) {
             filehandles[fh_i] = NULL;
+#if MBED_CONF_PLATFORM_FILE_BUFFER_SIZE
+            free(filebuffers[fh_i]);
+            filebuffers[fh_i] = NULL;
+#endif
         }
     }
     filehandle_mutex->unlock();
@@ -114,6 +203,26 @@ static void init_serial() {
 #endif
 }
 
+/* Reads and writes initialize the UART themselves, fast boot leaves it
+ * to them instead of the standard streams opened at startup */
+static inline void open_serial() {
+#if !MBED_CONF_PLATFORM_FAST_BOOT
+    init_serial();
+#endif
+}
+
+#if DEVICE_SERIAL
+static void stdio_write(const unsigned char *buffer, unsigned int length) {
+#if MBED_CONF_PLATFORM_STDIO_BUFFER_SIZE
+    mbed_stdio_buffer_write(buffer, length);
+#else
+    for (unsigned int i = 0; i < length; i++) {
+        serial_putc(&stdio_uart, buffer[i]);
+    }
+#endif
+}
+#endif
+
 static inline int openmode_to_posix(int openmode) {
     int posix = openmode;
 #ifdef __ARMCC_VERSION
@@ -161,20 +270,22 @@ extern "C" FILEHANDLE PREFIX(_open)(const char* name, int openmode) {
     static int mbed_sdk_inited = 0;
     if (!mbed_sdk_inited) {
         mbed_sdk_inited = 1;
+        MBED_BOOT_TIME_MARK(MBED_BOOT_START);
         mbed_sdk_init();
+        MBED_BOOT_TIME_MARK(MBED_BOOT_SDK_INIT);
     }
     if (!std::strcmp(name, ":tt")) return n++;
     #else
     /* Use the posix convention that stdin,out,err are filehandles 0,1,2.
      */
     if (std::strcmp(name, __stdin_name) == 0) {
-        init_serial();
+        open_serial();
         return 0;
     } else if (std::strcmp(name, __stdout_name) == 0) {
-        init_serial();
+        open_serial();
         return 1;
     } else if (std::strcmp(name, __stderr_name) == 0) {
-        init_serial();
+        open_serial();
         return 2;
     }
     #endif
@@ -219,6 +330,15 @@ extern "C" FILEHANDLE PREFIX(_open)(const char* name, int openmode) {
             }
             int posix_mode = openmode_to_posix(openmode);
             res = fs->open(path.fileName(), posix_mode); /* NULL if fails */
+#if MBED_CONF_PLATFORM_FILE_BUFFER_SIZE
+            /* written straight through when there is no memory for the buffer */
+            if (res != NULL && (posix_mode & (O_WRONLY | O_RDWR))) {
+                filebuffers[fh_i] = (file_buffer_t *)malloc(sizeof(file_buffer_t));
+                if (filebuffers[fh_i] != NULL) {
+                    filebuffers[fh_i]->length = 0;
+                }
+            }
+#endif
         }
     }
 
@@ -236,10 +356,17 @@ extern "C" int PREFIX(_close)(FILEHANDLE fh) {
     if (fh < 3) return 0;
 
     FileHandle* fhc = filehandles[fh-3];
-    filehandles[fh-3] = NULL;
     if (fhc == NULL) return -1;
 
-    return fhc->close();
+    int drained = file_buffer_drain(fh);
+#if MBED_CONF_PLATFORM_FILE_BUFFER_SIZE
+    free(filebuffers[fh-3]);
+    filebuffers[fh-3] = NULL;
+#endif
+    filehandles[fh-3] = NULL;
+
+    int closed = fhc->close();
+    return drained ? drained : closed;
 }
 
 #if defined(__ICCARM__)
@@ -252,17 +379,19 @@ extern "C" int PREFIX(_write)(FILEHANDLE fh, const unsigned char *buffer, unsign
 #if DEVICE_SERIAL
         if (!stdio_uart_inited) init_serial();
 #if MBED_CONF_PLATFORM_STDIO_CONVERT_NEWLINES
+        // Written in runs up to each newline that needs a '\r'
+        unsigned int start = 0;
         for (unsigned int i = 0; i < length; i++) {
             if (buffer[i] == '\n' && stdio_out_prev != '\r') {
-                 serial_putc(&stdio_uart, '\r');
+                stdio_write(buffer + start, i - start);
+                stdio_write((const unsigned char *)"\r", 1);
+                start = i;
             }
-            serial_putc(&stdio_uart, buffer[i]);
             stdio_out_prev = buffer[i];
         }
+        stdio_write(buffer + start, length - start);
 #else
-        for (unsigned int i = 0; i < length; i++) {
-            serial_putc(&stdio_uart, buffer[i]);
-        }
+        stdio_write(buffer, length);
 #endif
 #endif
         n = length;
@@ -270,6 +399,11 @@ extern "C" int PREFIX(_write)(FILEHANDLE fh, const unsigned char *buffer, unsign
         FileHandle* fhc = filehandles[fh-3];
         if (fhc == NULL) return -1;
 
+#if MBED_CONF_PLATFORM_FILE_BUFFER_SIZE
+        if (filebuffers[fh-3] != NULL) {
+            n = file_buffer_write(fh, buffer, length);
+        } else
+#endif
         n = fhc->write(buffer, length);
     }
 #ifdef __ARMCC_VERSION
@@ -279,6 +413,66 @@ extern "C" int PREFIX(_write)(FILEHANDLE fh, const unsigned char *buffer, unsign
 #endif
 }
 
+extern "C" void mbed_printf_console_write(int fh, const char *buffer, size_t length) {
+#if defined(__ICCARM__)
+    __write(fh, (const unsigned char *)buffer, length);
+#else
+    PREFIX(_write)(fh, (const unsigned char *)buffer, length, 0);
+#endif
+}
+
+#if MBED_CONF_PLATFORM_MINIMAL_PRINTF && defined(TOOLCHAIN_GCC)
+/* The compact printf of mbed_printf.h in place of the C library's, which
+ * allocates the buffers of its streams and pulls in the floating point code */
+extern "C" int vprintf(const char *fmt, va_list args) {
+    return mbed_vfprintf(stdout, fmt, args);
+}
+
+extern "C" int printf(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = mbed_vfprintf(stdout, fmt, args);
+    va_end(args);
+    return n;
+}
+
+extern "C" int vfprintf(FILE *stream, const char *fmt, va_list args) {
+    return mbed_vfprintf(stream, fmt, args);
+}
+
+extern "C" int fprintf(FILE *stream, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = mbed_vfprintf(stream, fmt, args);
+    va_end(args);
+    return n;
+}
+
+extern "C" int vsnprintf(char *buffer, size_t size, const char *fmt, va_list args) {
+    return mbed_vsnprintf(buffer, size, fmt, args);
+}
+
+extern "C" int snprintf(char *buffer, size_t size, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = mbed_vsnprintf(buffer, size, fmt, args);
+    va_end(args);
+    return n;
+}
+
+extern "C" int vsprintf(char *buffer, const char *fmt, va_list args) {
+    return mbed_vsnprintf(buffer, (size_t)-1, fmt, args);
+}
+
+extern "C" int sprintf(char *buffer, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = mbed_vsnprintf(buffer, (size_t)-1, fmt, args);
+    va_end(args);
+    return n;
+}
+#endif
+
 #if defined(__ICCARM__)
 extern "C" size_t    __read (int        fh, unsigned char *buffer, size_t       length) {
 #else
@@ -316,6 +510,7 @@ extern "C" int PREFIX(_read)(FILEHANDLE fh, unsigned char *buffer, unsigned int
     } else {
         FileHandle* fhc = filehandles[fh-3];
         if (fhc == NULL) return -1;
+        if (file_buffer_drain(fh) != 0) return -1;
 
         n = fhc->read(buffer, length);
     }
@@ -354,6 +549,7 @@ int _lseek(FILEHANDLE fh, int offset, int whence)
 
     FileHandle* fhc = filehandles[fh-3];
     if (fhc == NULL) return -1;
+    if (file_buffer_drain(fh) != 0) return -1;
 
 #if defined(__ARMCC_VERSION)
     return fhc->lseek(position, SEEK_SET);
@@ -368,6 +564,7 @@ extern "C" int PREFIX(_ensure)(FILEHANDLE fh) {
 
     FileHandle* fhc = filehandles[fh-3];
     if (fhc == NULL) return -1;
+    if (file_buffer_drain(fh) != 0) return -1;
 
     return fhc->fsync();
 }
@@ -377,9 +574,25 @@ extern "C" long PREFIX(_flen)(FILEHANDLE fh) {
 
     FileHandle* fhc = filehandles[fh-3];
     if (fhc == NULL) return -1;
+    if (file_buffer_drain(fh) != 0) return -1;
 
     return fhc->flen();
 }
+#else
+/* fflush() hands the stream buffer to _write, which may keep it in the
+ * write-back buffer of the file: fsync() has it written to the storage */
+extern "C" int fsync(int fh) {
+    if (fh < 3) return 0;
+
+    FileHandle* fhc = filehandles[fh-3];
+    if (fhc == NULL) {
+        errno = EBADF;
+        return -1;
+    }
+    if (file_buffer_drain(fh) != 0) return -1;
+
+    return fhc->fsync();
+}
 #endif
 
 
@@ -509,7 +722,9 @@ extern "C" void software_init_hook(void)
         mbed_die();
     }
 #endif/* FEATURE_UVISOR */
+    MBED_BOOT_TIME_MARK(MBED_BOOT_START);
     mbed_sdk_init();
+    MBED_BOOT_TIME_MARK(MBED_BOOT_SDK_INIT);
     software_init_hook_rtos();
 }
 #endif
@@ -528,19 +743,27 @@ extern "C" WEAK void mbed_main(void) {
 extern "C" int $Super$$main(void);
 
 extern "C" int $Sub$$main(void) {
+    MBED_BOOT_TIME_MARK(MBED_BOOT_CONSTRUCTORS);
+    core_util_irq_mask_init();
     mbed_main();
+    MBED_BOOT_TIME_MARK(MBED_BOOT_MAIN);
     return $Super$$main();
 }
 
 extern "C" void _platform_post_stackheap_init (void) {
+    MBED_BOOT_TIME_MARK(MBED_BOOT_START);
     mbed_sdk_init();
+    MBED_BOOT_TIME_MARK(MBED_BOOT_SDK_INIT);
 }
 
 #elif defined(TOOLCHAIN_GCC)
 extern "C" int __real_main(void);
 
 extern "C" int __wrap_main(void) {
+    MBED_BOOT_TIME_MARK(MBED_BOOT_CONSTRUCTORS);
+    core_util_irq_mask_init();
     mbed_main();
+    MBED_BOOT_TIME_MARK(MBED_BOOT_MAIN);
     return __real_main();
 }
 #elif defined(TOOLCHAIN_IAR)
@@ -550,7 +773,10 @@ extern "C" int __wrap_main(void) {
 // code will call a function to setup argc and argv (__iar_argc_argv) if it is defined.
 // Since mbed doesn't use argc/argv, we use this function to call our mbed_main.
 extern "C" void __iar_argc_argv() {
+    MBED_BOOT_TIME_MARK(MBED_BOOT_CONSTRUCTORS);
+    core_util_irq_mask_init();
     mbed_main();
+    MBED_BOOT_TIME_MARK(MBED_BOOT_MAIN);
 }
 #endif
 
@@ -624,6 +850,7 @@ extern "C" void exit(int return_code) {
     fflush(stderr);
 #endif
 #endif
+    mbed_stdio_buffer_flush();
 
 #if DEVICE_SEMIHOST
     if (mbed_interface_connected()) {
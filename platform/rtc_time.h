@@ -18,6 +18,7 @@
  */
 
 #include <time.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -74,6 +75,42 @@ extern "C" {
  */
 void set_time(time_t t);
 
+/** Time with microseconds, as set by mbed_gettimeofday
+ */
+struct mbed_timeval {
+    time_t tv_sec;      /**< Seconds since January 1, 1970 */
+    uint32_t tv_usec;   /**< Microseconds, from 0 to 999999 */
+};
+
+/** Get the current time with microsecond resolution
+ *
+ * The time counts from an RTC read with the low power ticker, or the
+ * microsecond ticker on targets without one. With the platform
+ * time-cache-resync option, time() counts the same way, and the RTC is
+ * only reread after that many seconds to follow its drift, instead of
+ * at each call.
+ *
+ * An RTC read only gives the second, the microseconds get closer to the
+ * RTC's second boundaries as they are crossed between reads.
+ *
+ * @param tv Destination for the time
+ * @return 0
+ *
+ * @Note Synchronization level: Thread safe, not from interrupts
+ *
+ * Example:
+ * @code
+ * #include "mbed.h"
+ *
+ * int main() {
+ *     struct mbed_timeval tv;
+ *     mbed_gettimeofday(&tv);
+ *     printf("[%ld.%06lu] started\r\n", (long)tv.tv_sec, (unsigned long)tv.tv_usec);
+ * }
+ * @endcode
+ */
+int mbed_gettimeofday(struct mbed_timeval *tv);
+
 /** Attach an external RTC to be used for the C time functions
  *
  * @Note Synchronization level: Thread safe
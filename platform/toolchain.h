@@ -267,6 +267,84 @@
 #endif
 #endif
 
+/** MBED_COMPILER_BARRIER()
+ * Stop the compiler from reordering memory accesses across this point.
+ *
+ * @note
+ * This does not emit a hardware memory barrier. It is enough to order
+ * accesses between thread and interrupt context on a single core.
+ *
+ * @code
+ * #include "toolchain.h"
+ *
+ * buffer[index] = value;
+ * MBED_COMPILER_BARRIER();
+ * ready = true;
+ * @endcode
+ */
+#ifndef MBED_COMPILER_BARRIER
+#if defined(__CC_ARM)
+#define MBED_COMPILER_BARRIER() __memory_changed()
+#elif defined(__GNUC__) || defined(__clang__) || defined(__ICCARM__)
+#define MBED_COMPILER_BARRIER() __asm volatile("" : : : "memory")
+#else
+#define MBED_COMPILER_BARRIER() ((void)0)
+#endif
+#endif
+
+/** MBED_RAMFUNC
+ * Run a function from RAM instead of flash, avoiding the flash wait
+ * states. The function is copied at startup to the RAM the target places
+ * the .ramfunc section in, such as the ITCM of Cortex-M7 parts or the
+ * SRAM on the code bus of Kinetis parts. On targets whose linker script
+ * has no .ramfunc section, the function stays in flash.
+ *
+ * @note
+ * The functions it calls stay in flash unless they are also declared
+ * MBED_RAMFUNC or inlined.
+ *
+ * @code
+ * #include "toolchain.h"
+ *
+ * MBED_RAMFUNC void handler(void) {
+ *     // ...
+ * }
+ * @endcode
+ */
+#ifndef MBED_RAMFUNC
+#if defined(__ICCARM__)
+#define MBED_RAMFUNC _Pragma("location=\".ramfunc\"") _Pragma("inline=never")
+#elif defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM)
+#define MBED_RAMFUNC __attribute__((section(".ramfunc"), noinline))
+#else
+#define MBED_RAMFUNC
+#endif
+#endif
+
+/** MBED_FAST_DATA
+ * Place a variable in the fastest RAM for data of the target, such as the
+ * DTCM of Cortex-M7 parts, or with the other data elsewhere.
+ *
+ * @note
+ * The variable is initialized data, zero initial values also take their
+ * size in flash.
+ *
+ * @code
+ * #include "toolchain.h"
+ *
+ * MBED_FAST_DATA static uint8_t buffer[256] = { 0 };
+ * @endcode
+ */
+#ifndef MBED_FAST_DATA
+#if defined(__ICCARM__)
+#define MBED_FAST_DATA _Pragma("location=\".data.fast\"")
+#elif defined(__GNUC__) || defined(__clang__) || defined(__CC_ARM)
+#define MBED_FAST_DATA __attribute__((section(".data.fast")))
+#else
+#define MBED_FAST_DATA
+#endif
+#endif
+
 // FILEHANDLE declaration
 #if defined(TOOLCHAIN_ARM)
 #include <rt_sys.h>
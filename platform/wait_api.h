@@ -62,6 +62,18 @@ void wait_ms(int ms);
  */
 void wait_us(int us);
 
+/** Waits a number of nanoseconds, busy waiting
+ *
+ *  Counts core clock cycles, with the DWT cycle counter on Cortex-M3 and
+ *  above, and with a loop timed against the us ticker on Cortex-M0, where
+ *  interrupts make the wait longer. The resolution is the cycle of the
+ *  core clock, and the call itself takes some cycles. wait_us uses it for
+ *  delays below a millisecond.
+ *
+ *  @param ns the whole number of nanoseconds to wait, up to 2^31 - 1
+ */
+void wait_ns(int ns);
+
 #ifdef __cplusplus
 }
 #endif
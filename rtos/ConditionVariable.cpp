@@ -0,0 +1,92 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "rtos/ConditionVariable.h"
+#include "rtos/Thread.h"
+
+namespace rtos {
+
+// Lives on the stack of the waiting thread while it waits, the list is
+// protected by the mutex
+struct ConditionVariable::Waiter {
+    Waiter *next;
+    osThreadId tid;
+};
+
+ConditionVariable::ConditionVariable(Mutex &mutex) : _mutex(mutex), _waiters(NULL) {
+}
+
+void ConditionVariable::wait() {
+    wait_for(osWaitForever);
+}
+
+bool ConditionVariable::wait_for(uint32_t millisec) {
+    Waiter waiter;
+    waiter.next = NULL;
+    waiter.tid = osThreadGetId();
+
+    Waiter **p = &_waiters;
+    while (*p != NULL) {
+        p = &(*p)->next;
+    }
+    *p = &waiter;
+
+    _mutex.unlock();
+    osEvent event = osSignalWait(RTOS_SIGNAL_WAKEUP, millisec);
+    _mutex.lock();
+
+    if (waiter.tid != NULL) {
+        // Timed out, still queued
+        for (p = &_waiters; *p != NULL; p = &(*p)->next) {
+            if (*p == &waiter) {
+                *p = waiter.next;
+                break;
+            }
+        }
+        return true;
+    }
+
+    if (event.status != osEventSignal) {
+        // Notified right after the timeout, drop the signal set for it
+        osSignalClear(osThreadGetId(), RTOS_SIGNAL_WAKEUP);
+    }
+    return false;
+}
+
+void ConditionVariable::notify_one() {
+    Waiter *waiter = _waiters;
+    if (waiter != NULL) {
+        _waiters = waiter->next;
+        osSignalSet(waiter->tid, RTOS_SIGNAL_WAKEUP);
+        waiter->tid = NULL;
+    }
+}
+
+void ConditionVariable::notify_all() {
+    while (_waiters != NULL) {
+        notify_one();
+    }
+}
+
+ConditionVariable::~ConditionVariable() {
+}
+
+}
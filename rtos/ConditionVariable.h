@@ -0,0 +1,96 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef CONDITIONVARIABLE_H
+#define CONDITIONVARIABLE_H
+
+#include <stdint.h>
+#include "cmsis_os.h"
+#include "rtos/Mutex.h"
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** The ConditionVariable class lets threads wait, with a Mutex unlocked,
+ until another thread notifies them that the state the Mutex protects has
+ changed.
+
+ The Mutex must be locked once by the calling thread for every call. A
+ notification only wakes the threads that are waiting at the time, so the
+ condition is checked again in a loop:
+ @code
+ mutex.lock();
+ while (items == 0) {
+     cond.wait();
+ }
+ items--;
+ mutex.unlock();
+ @endcode
+
+ A waiting thread takes the RTOS_SIGNAL_WAKEUP signal of a Thread.
+*/
+class ConditionVariable {
+public:
+    /** Create and Initialize a ConditionVariable object
+      @param   mutex  the Mutex that protects the condition.
+     */
+    ConditionVariable(Mutex &mutex);
+
+    /** Wait for a notification, with the mutex unlocked while waiting.
+      @note not callable from interrupt
+     */
+    void wait();
+
+    /** Wait for a notification or a timeout, with the mutex unlocked while waiting.
+      @param   millisec  timeout value.
+      @return  true if the wait timed out, false if the thread was notified.
+      @note not callable from interrupt
+     */
+    bool wait_for(uint32_t millisec);
+
+    /** Wake the thread that has waited the longest, if any.
+      @note not callable from interrupt
+     */
+    void notify_one();
+
+    /** Wake all waiting threads.
+      @note not callable from interrupt
+     */
+    void notify_all();
+
+    ~ConditionVariable();
+
+private:
+    struct Waiter;
+
+    Mutex &_mutex;
+    Waiter *_waiters;
+
+    /* disallow copy constructor and assignment operators */
+    ConditionVariable(const ConditionVariable &);
+    ConditionVariable &operator=(const ConditionVariable &);
+};
+
+}
+#endif
+
+/** @}*/
@@ -0,0 +1,155 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "rtos/EventFlags.h"
+#include "rtos/Thread.h"
+
+#include "platform/critical.h"
+
+namespace rtos {
+
+// Lives on the stack of the waiting thread while it waits
+struct EventFlags::Waiter {
+    Waiter *next;
+    osThreadId tid;
+    uint32_t flags;
+    uint32_t result;
+    bool all;
+    bool clear;
+};
+
+EventFlags::EventFlags() : _flags(0), _waiters(NULL) {
+}
+
+// Called in a critical section, consumes the flags if the waiter is satisfied
+bool EventFlags::satisfy(Waiter *waiter) {
+    uint32_t match = _flags & waiter->flags;
+    if (waiter->all ? match != waiter->flags : match == 0) {
+        return false;
+    }
+
+    waiter->result = _flags;
+    if (waiter->clear) {
+        _flags &= ~match;
+    }
+    return true;
+}
+
+uint32_t EventFlags::set(uint32_t flags) {
+    core_util_critical_section_enter();
+    _flags |= flags;
+    uint32_t result = _flags;
+
+    // Wake the waiters in the order they started waiting, each with a
+    // single kernel call
+    Waiter **p = &_waiters;
+    while (*p != NULL) {
+        Waiter *waiter = *p;
+        if (satisfy(waiter)) {
+            *p = waiter->next;
+            waiter->next = NULL;
+            osSignalSet(waiter->tid, RTOS_SIGNAL_WAKEUP);
+            waiter->tid = NULL;
+        } else {
+            p = &waiter->next;
+        }
+    }
+    core_util_critical_section_exit();
+
+    return result;
+}
+
+uint32_t EventFlags::clear(uint32_t flags) {
+    core_util_critical_section_enter();
+    uint32_t result = _flags;
+    _flags &= ~flags;
+    core_util_critical_section_exit();
+
+    return result;
+}
+
+uint32_t EventFlags::get() const {
+    return _flags;
+}
+
+uint32_t EventFlags::wait_all(uint32_t flags, uint32_t millisec, bool clear) {
+    return wait(flags, millisec, true, clear);
+}
+
+uint32_t EventFlags::wait_any(uint32_t flags, uint32_t millisec, bool clear) {
+    return wait(flags, millisec, false, clear);
+}
+
+uint32_t EventFlags::wait(uint32_t flags, uint32_t millisec, bool all, bool clear) {
+    if (flags == 0) {
+        return 0;
+    }
+
+    Waiter waiter;
+    waiter.next = NULL;
+    waiter.tid = osThreadGetId();
+    waiter.flags = flags;
+    waiter.result = 0;
+    waiter.all = all;
+    waiter.clear = clear;
+
+    core_util_critical_section_enter();
+    if (satisfy(&waiter) || millisec == 0) {
+        core_util_critical_section_exit();
+        return waiter.result;
+    }
+
+    // Waiters are woken in FIFO order
+    Waiter **p = &_waiters;
+    while (*p != NULL) {
+        p = &(*p)->next;
+    }
+    *p = &waiter;
+    core_util_critical_section_exit();
+
+    osEvent event = osSignalWait(RTOS_SIGNAL_WAKEUP, millisec);
+
+    core_util_critical_section_enter();
+    if (waiter.tid != NULL) {
+        // Timed out, still queued
+        for (p = &_waiters; *p != NULL; p = &(*p)->next) {
+            if (*p == &waiter) {
+                *p = waiter.next;
+                break;
+            }
+        }
+        core_util_critical_section_exit();
+        return 0;
+    }
+    core_util_critical_section_exit();
+
+    if (event.status != osEventSignal) {
+        // Satisfied right after the timeout, drop the signal set for it
+        osSignalClear(osThreadGetId(), RTOS_SIGNAL_WAKEUP);
+    }
+
+    return waiter.result;
+}
+
+EventFlags::~EventFlags() {
+}
+
+}
@@ -0,0 +1,102 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef EVENT_FLAGS_H
+#define EVENT_FLAGS_H
+
+#include <stdint.h>
+#include "cmsis_os.h"
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** The EventFlags class is used to signal or wait for an arbitrary event or events.
+
+ Unlike the signals of a Thread, any number of threads can wait for the flags
+ of an EventFlags, for any or all of a set of flags. Each waiting thread is
+ woken once, by the set call that satisfies it.
+
+ A waiting thread takes the RTOS_SIGNAL_WAKEUP signal of a Thread.
+*/
+class EventFlags {
+public:
+    /** Create and Initialize an EventFlags object with all flags cleared */
+    EventFlags();
+
+    /** Set the specified Event Flags.
+      @param   flags  specifies the flags that shall be set.
+      @return  event flags after setting.
+      @note callable from interrupt
+     */
+    uint32_t set(uint32_t flags);
+
+    /** Clear the specified Event Flags.
+      @param   flags  specifies the flags that shall be cleared. (default: all flags)
+      @return  event flags before clearing.
+      @note callable from interrupt
+     */
+    uint32_t clear(uint32_t flags = 0xFFFFFFFF);
+
+    /** Get the currently set Event Flags.
+      @return  set event flags.
+      @note callable from interrupt
+     */
+    uint32_t get() const;
+
+    /** Wait for all of the specified event flags to become signaled.
+      @param   flags     the flags to wait for, not 0.
+      @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever)
+      @param   clear     clear the flags waited for once they are all set. (default: true)
+      @return  event flags when the wait ended, 0 on timeout.
+      @note not callable from interrupt
+     */
+    uint32_t wait_all(uint32_t flags, uint32_t millisec = osWaitForever, bool clear = true);
+
+    /** Wait for any of the specified event flags to become signaled.
+      @param   flags     the flags to wait for, not 0.
+      @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever)
+      @param   clear     clear the flags that ended the wait. (default: true)
+      @return  event flags when the wait ended, 0 on timeout.
+      @note not callable from interrupt
+     */
+    uint32_t wait_any(uint32_t flags, uint32_t millisec = osWaitForever, bool clear = true);
+
+    ~EventFlags();
+
+private:
+    struct Waiter;
+
+    uint32_t wait(uint32_t flags, uint32_t millisec, bool all, bool clear);
+    bool satisfy(Waiter *waiter);
+
+    volatile uint32_t _flags;
+    Waiter *_waiters;
+
+    /* disallow copy constructor and assignment operators */
+    EventFlags(const EventFlags &);
+    EventFlags &operator=(const EventFlags &);
+};
+
+}
+#endif
+
+/** @}*/
@@ -49,9 +49,9 @@ public:
         _mail_p[1] = _mail_m;
 
         _mail_def.pool = _mail_p;
+    #endif
         _mail_def.queue_sz = queue_sz;
         _mail_def.item_sz = sizeof(T);
-    #endif
         _mail_id = osMailCreate(&_mail_def, NULL);
     }
 
@@ -95,7 +95,90 @@ public:
         return osMailFree(_mail_id, (void*)mptr);
     }
 
+    /** Put several mails in the queue, with one kernel call per batch rather than per mail.
+      A block is filled in place between Mail::alloc and the put, and is not copied.
+      @param   mptr   array of memory blocks previously allocated with Mail::alloc or Mail::calloc.
+      @param   count  number of memory blocks in mptr.
+      @return  number of mails put, in the order of mptr.
+    */
+    uint32_t put_n(T **mptr, uint32_t count) {
+        uint32_t n = 0;
+        while (n < count) {
+            uint32_t put = put_batch(mptr + n, count - n);
+            if (put == 0) {
+                break;
+            }
+            n += put;
+        }
+        return n;
+    }
+
+    /** Get several mails from a queue.
+      Waits for a first mail, then takes all mails that are queued, up to
+      count, with one kernel call per batch rather than per mail.
+      @param   mptr      array the memory blocks are stored to.
+      @param   count     size of the mptr array.
+      @param   millisec  timeout value for the first mail or 0 in case of no time-out. (default: osWaitForever).
+      @return  number of mails got, 0 on timeout.
+    */
+    uint32_t get_n(T **mptr, uint32_t count, uint32_t millisec=osWaitForever) {
+        if (count == 0) {
+            return 0;
+        }
+
+        uint32_t n = get_batch(mptr, count);
+        if (n == 0) {
+            if (millisec == 0) {
+                return 0;
+            }
+            osEvent evt = osMailGet(_mail_id, millisec);
+            if (evt.status != osEventMail) {
+                return 0;
+            }
+            mptr[0] = (T*)evt.value.p;
+            n = 1;
+        }
+
+        // drain what else is queued, a batch may stop short on a preemption
+        while (n < count) {
+            uint32_t got = get_batch(mptr + n, count - n);
+            if (got == 0) {
+                break;
+            }
+            n += got;
+        }
+        return n;
+    }
+
 private:
+    uint32_t put_batch(T **mptr, uint32_t count) {
+#if defined(__MBED_CMSIS_RTOS_CM)
+        return _osMailPutN(_mail_id, (void *const *)mptr, count);
+#else
+        uint32_t n = 0;
+        while (n < count && osMailPut(_mail_id, (void*)mptr[n]) == osOK) {
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    uint32_t get_batch(T **mptr, uint32_t count) {
+#if defined(__MBED_CMSIS_RTOS_CM)
+        return _osMailGetN(_mail_id, (void **)mptr, count);
+#else
+        uint32_t n = 0;
+        while (n < count) {
+            osEvent evt = osMailGet(_mail_id, 0);
+            if (evt.status != osEventMail) {
+                break;
+            }
+            mptr[n++] = (T*)evt.value.p;
+        }
+        return n;
+#endif
+    }
+
     osMailQId    _mail_id;
     osMailQDef_t _mail_def;
 #ifdef CMSIS_OS_RTX
@@ -43,10 +43,9 @@ public:
     #ifdef CMSIS_OS_RTX
         memset(_pool_m, 0, sizeof(_pool_m));
         _pool_def.pool = _pool_m;
-
+    #endif
         _pool_def.pool_sz = pool_sz;
         _pool_def.item_sz =  sizeof(T);
-    #endif
         _pool_id = osPoolCreate(&_pool_def);
     }
 
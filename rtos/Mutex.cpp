@@ -24,6 +24,14 @@
 #include <string.h>
 #include "platform/mbed_error.h"
 
+#if defined(MBED_MUTEX_STATS_ENABLED) && MBED_MUTEX_STATS_ENABLED
+#include "platform/critical.h"
+#include "hal/us_ticker_api.h"
+
+// All existing mutexes, for mbed_stats_mutex_get
+static rtos::Mutex *mutex_stats_list;
+#endif
+
 namespace rtos {
 
 Mutex::Mutex() {
@@ -35,8 +43,67 @@ Mutex::Mutex() {
     if (_osMutexId == NULL) {
         error("Error initializing the mutex object\n");
     }
+
+#if defined(MBED_MUTEX_STATS_ENABLED) && MBED_MUTEX_STATS_ENABLED
+    _holder = NULL;
+    _depth = 0;
+    _acquire_cnt = 0;
+    _contended_cnt = 0;
+    _max_wait = 0;
+    _total_wait = 0;
+
+    core_util_critical_section_enter();
+    _stats_next = mutex_stats_list;
+    mutex_stats_list = this;
+    core_util_critical_section_exit();
+#endif
 }
 
+#if defined(MBED_MUTEX_STATS_ENABLED) && MBED_MUTEX_STATS_ENABLED
+osStatus Mutex::lock(uint32_t millisec) {
+    // Try first, so that only contended locks read the ticker
+    osStatus status = osMutexWait(_osMutexId, 0);
+    if (status == osOK) {
+        stats_acquired(0);
+        return status;
+    }
+
+    core_util_atomic_incr_u32(&_contended_cnt, 1);
+    if (millisec == 0) {
+        return status;
+    }
+
+    uint32_t start = us_ticker_read();
+    status = osMutexWait(_osMutexId, millisec);
+    if (status == osOK) {
+        stats_acquired(us_ticker_read() - start);
+    }
+    return status;
+}
+
+bool Mutex::trylock() {
+    return (lock(0) == osOK);
+}
+
+osStatus Mutex::unlock() {
+    // Still held, the mutex is recursive
+    if (_holder == osThreadGetId() && --_depth == 0) {
+        _holder = NULL;
+    }
+    return osMutexRelease(_osMutexId);
+}
+
+void Mutex::stats_acquired(uint32_t wait) {
+    // Called with the mutex held, which protects the counters
+    _acquire_cnt++;
+    _holder = osThreadGetId();
+    _depth++;
+    _total_wait += wait;
+    if (wait > _max_wait) {
+        _max_wait = wait;
+    }
+}
+#else
 osStatus Mutex::lock(uint32_t millisec) {
     return osMutexWait(_osMutexId, millisec);
 }
@@ -48,9 +115,45 @@ bool Mutex::trylock() {
 osStatus Mutex::unlock() {
     return osMutexRelease(_osMutexId);
 }
+#endif
 
 Mutex::~Mutex() {
+#if defined(MBED_MUTEX_STATS_ENABLED) && MBED_MUTEX_STATS_ENABLED
+    core_util_critical_section_enter();
+    Mutex **p = &mutex_stats_list;
+    while (*p != NULL && *p != this) {
+        p = &(*p)->_stats_next;
+    }
+    if (*p != NULL) {
+        *p = _stats_next;
+    }
+    core_util_critical_section_exit();
+#endif
+
     osMutexDelete(_osMutexId);
 }
 
 }
+
+#if defined(MBED_MUTEX_STATS_ENABLED) && MBED_MUTEX_STATS_ENABLED
+size_t mbed_stats_mutex_get(mbed_stats_mutex_t *stats, size_t count)
+{
+    size_t n = 0;
+
+    // A thread preempted while updating the counters of the mutex it holds
+    // may leave them off by one lock until it runs again
+    core_util_critical_section_enter();
+    for (rtos::Mutex *m = mutex_stats_list; m != NULL && n < count; m = m->_stats_next) {
+        stats[n].id = (uint32_t)m;
+        stats[n].holder = (uint32_t)m->_holder;
+        stats[n].acquire_cnt = m->_acquire_cnt;
+        stats[n].contended_cnt = m->_contended_cnt;
+        stats[n].max_wait = m->_max_wait;
+        stats[n].total_wait = m->_total_wait;
+        n++;
+    }
+    core_util_critical_section_exit();
+
+    return n;
+}
+#endif
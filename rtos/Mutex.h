@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include "cmsis_os.h"
+#include "platform/mbed_stats.h"
 
 namespace rtos {
 /** \addtogroup rtos */
@@ -56,6 +57,20 @@ public:
     ~Mutex();
 
 private:
+#if defined(MBED_MUTEX_STATS_ENABLED) && MBED_MUTEX_STATS_ENABLED
+    friend size_t ::mbed_stats_mutex_get(mbed_stats_mutex_t *stats, size_t count);
+
+    void stats_acquired(uint32_t wait);
+
+    Mutex *_stats_next;
+    osThreadId _holder;
+    uint32_t _depth;
+    uint32_t _acquire_cnt;
+    uint32_t _contended_cnt;
+    uint32_t _max_wait;
+    uint64_t _total_wait;
+#endif
+
     osMutexId _osMutexId;
     osMutexDef_t _osMutexDef;
 #ifdef CMSIS_OS_RTX
@@ -46,8 +46,8 @@ public:
     #ifdef CMSIS_OS_RTX
         memset(_queue_q, 0, sizeof(_queue_q));
         _queue_def.pool = _queue_q;
-        _queue_def.queue_sz = queue_sz;
     #endif
+        _queue_def.queue_sz = queue_sz;
         _queue_id = osMessageCreate(&_queue_def, NULL);
         if (_queue_id == NULL) {
             error("Error initialising the queue object\n");
@@ -71,7 +71,96 @@ public:
         return osMessageGet(_queue_id, millisec);
     }
 
+    /** Put several messages in a Queue.
+      Fills the queue with as many messages as fit, with one kernel call per
+      batch rather than per message. Waits for room only while none of the
+      messages fit.
+      @param   data      array of message pointers.
+      @param   count     number of messages in data.
+      @param   millisec  timeout value or 0 in case of no time-out. (default: 0)
+      @return  number of messages put, in the order of data.
+    */
+    uint32_t put_n(T **data, uint32_t count, uint32_t millisec=0) {
+        uint32_t n = 0;
+        while (n < count) {
+            uint32_t put = put_batch(data + n, count - n);
+            if (put == 0) {
+                if (millisec == 0 || osMessagePut(_queue_id, (uint32_t)data[n], millisec) != osOK) {
+                    break;
+                }
+                put = 1;
+            }
+            n += put;
+        }
+        return n;
+    }
+
+    /** Get several messages from a Queue.
+      Waits for a first message, then takes all messages that are queued, up
+      to count, with one kernel call per batch rather than per message.
+      @param   data      array the message pointers are stored to.
+      @param   count     size of the data array.
+      @param   millisec  timeout value for the first message or 0 in case of no time-out. (default: osWaitForever).
+      @return  number of messages got, 0 on timeout.
+    */
+    uint32_t get_n(T **data, uint32_t count, uint32_t millisec=osWaitForever) {
+        if (count == 0) {
+            return 0;
+        }
+
+        uint32_t n = get_batch(data, count);
+        if (n == 0) {
+            if (millisec == 0) {
+                return 0;
+            }
+            osEvent evt = osMessageGet(_queue_id, millisec);
+            if (evt.status != osEventMessage) {
+                return 0;
+            }
+            data[0] = (T*)evt.value.p;
+            n = 1;
+        }
+
+        // drain what else is queued, a batch may stop short on a preemption
+        while (n < count) {
+            uint32_t got = get_batch(data + n, count - n);
+            if (got == 0) {
+                break;
+            }
+            n += got;
+        }
+        return n;
+    }
+
 private:
+    uint32_t put_batch(T **data, uint32_t count) {
+#if defined(__MBED_CMSIS_RTOS_CM)
+        return _osMessagePutN(_queue_id, (const uint32_t*)data, count);
+#else
+        uint32_t n = 0;
+        while (n < count && osMessagePut(_queue_id, (uint32_t)data[n], 0) == osOK) {
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    uint32_t get_batch(T **data, uint32_t count) {
+#if defined(__MBED_CMSIS_RTOS_CM)
+        return _osMessageGetN(_queue_id, (uint32_t*)data, count);
+#else
+        uint32_t n = 0;
+        while (n < count) {
+            osEvent evt = osMessageGet(_queue_id, 0);
+            if (evt.status != osEventMessage) {
+                break;
+            }
+            data[n++] = (T*)evt.value.p;
+        }
+        return n;
+#endif
+    }
+
     osMessageQId    _queue_id;
     osMessageQDef_t _queue_def;
 #ifdef CMSIS_OS_RTX
@@ -0,0 +1,108 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "rtos/RWLock.h"
+
+#include "hal/us_ticker_api.h"
+
+namespace rtos {
+
+// Time left of a timeout started at start, 0 once it passed
+static uint32_t remaining(uint32_t millisec, uint32_t start) {
+    if (millisec == osWaitForever) {
+        return osWaitForever;
+    }
+    uint32_t elapsed = (us_ticker_read() - start) / 1000;
+    return (elapsed < millisec) ? millisec - elapsed : 0;
+}
+
+RWLock::RWLock(uint16_t max_readers)
+    : _readable(_mutex), _drained(_mutex), _max_readers(max_readers),
+      _readers(0), _writers_waiting(0) {
+}
+
+osStatus RWLock::read_lock(uint32_t millisec) {
+    uint32_t start = us_ticker_read();
+    if (_mutex.lock(millisec) != osOK) {
+        return osErrorTimeoutResource;
+    }
+
+    while (_writers_waiting > 0 || _readers == _max_readers) {
+        uint32_t left = remaining(millisec, start);
+        if (left == 0 || _readable.wait_for(left)) {
+            _mutex.unlock();
+            return osErrorTimeoutResource;
+        }
+    }
+    _readers++;
+
+    _mutex.unlock();
+    return osOK;
+}
+
+void RWLock::read_unlock() {
+    _mutex.lock();
+    _readers--;
+    if (_writers_waiting > 0) {
+        if (_readers == 0) {
+            _drained.notify_all();
+        }
+    } else if (_readers == _max_readers - 1) {
+        _readable.notify_one();
+    }
+    _mutex.unlock();
+}
+
+osStatus RWLock::write_lock(uint32_t millisec) {
+    uint32_t start = us_ticker_read();
+    if (_mutex.lock(millisec) != osOK) {
+        return osErrorTimeoutResource;
+    }
+
+    _writers_waiting++;
+    while (_readers > 0) {
+        uint32_t left = remaining(millisec, start);
+        if (left == 0 || _drained.wait_for(left)) {
+            _writers_waiting--;
+            if (_writers_waiting == 0) {
+                _readable.notify_all();
+            }
+            _mutex.unlock();
+            return osErrorTimeoutResource;
+        }
+    }
+    _writers_waiting--;
+
+    // Written with the mutex held, until write_unlock
+    return osOK;
+}
+
+void RWLock::write_unlock() {
+    if (_writers_waiting == 0) {
+        _readable.notify_all();
+    }
+    _mutex.unlock();
+}
+
+RWLock::~RWLock() {
+}
+
+}
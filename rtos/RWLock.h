@@ -0,0 +1,101 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#include <stdint.h>
+#include "cmsis_os.h"
+#include "rtos/Mutex.h"
+#include "rtos/ConditionVariable.h"
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** The RWLock class lets many threads read a shared resource at once,
+ while a thread writing it has it to itself.
+
+ Writers are preferred: once a writer waits, new readers wait for it, so a
+ steady flow of readers can't starve writers. A writer holds the RWLock's
+ Mutex while writing, so a thread waiting for the lock raises the writer's
+ priority, as it would with a Mutex. Readers hold nothing while reading,
+ so a writer waiting for them to finish can't raise theirs.
+
+ @code
+ lock.read_lock();
+ route = table.find(destination);
+ lock.read_unlock();
+ @endcode
+
+ A thread can't take the lock again while holding it, for reading or for
+ writing.
+*/
+class RWLock {
+public:
+    /** Create and Initialize a RWLock object
+      @param   max_readers  number of threads which can read at once, others wait. (default: 0xFFFF)
+     */
+    RWLock(uint16_t max_readers=0xFFFF);
+
+    /** Wait until the lock can be read.
+      @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever)
+      @return  osOK if the lock was taken, osErrorTimeoutResource otherwise.
+      @note not callable from interrupt
+     */
+    osStatus read_lock(uint32_t millisec=osWaitForever);
+
+    /** Release a lock previously taken with read_lock.
+      @note not callable from interrupt
+     */
+    void read_unlock();
+
+    /** Wait until the lock can be written, with no reader and no other writer.
+      @param   millisec  timeout value or 0 in case of no time-out. (default: osWaitForever)
+      @return  osOK if the lock was taken, osErrorTimeoutResource otherwise.
+      @note not callable from interrupt
+     */
+    osStatus write_lock(uint32_t millisec=osWaitForever);
+
+    /** Release a lock previously taken with write_lock.
+      @note not callable from interrupt
+     */
+    void write_unlock();
+
+    ~RWLock();
+
+private:
+    Mutex _mutex;
+    ConditionVariable _readable;
+    ConditionVariable _drained;
+    uint16_t _max_readers;
+    uint16_t _readers;
+    uint16_t _writers_waiting;
+
+    /* disallow copy constructor and assignment operators */
+    RWLock(const RWLock &);
+    RWLock &operator=(const RWLock &);
+};
+
+}
+#endif
+
+/** @}*/
@@ -30,9 +30,8 @@
 namespace rtos {
 
 void RtosTimer::constructor(mbed::Callback<void()> func, os_timer_type type) {
-#ifdef CMSIS_OS_RTX
     _timer.ptimer = (void (*)(const void *))Callback<void()>::thunk;
-
+#ifdef CMSIS_OS_RTX
     memset(_timer_data, 0, sizeof(_timer_data));
     _timer.timer = _timer_data;
 #endif
@@ -0,0 +1,69 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef STATICTHREAD_H
+#define STATICTHREAD_H
+
+#include <stdint.h>
+#include "rtos/Thread.h"
+
+namespace rtos {
+/** \addtogroup rtos */
+/** @{*/
+
+/** A Thread with its stack inside the object
+
+ The stack size is a template parameter, so a StaticThread defined at file
+ scope keeps its stack in .bss and starting it never allocates from the
+ heap. The stack is 8 byte aligned as the ABI requires, and the size is
+ rounded up to a multiple of 8 bytes. The thread control block comes from
+ the pool RTX reserves for OS_TASKCNT threads, as for any Thread.
+
+ Queue, Mail and MemoryPool already keep their storage inside the object.
+
+ Example:
+ @code
+ StaticThread<1024> thread(osPriorityHigh);
+
+ int main() {
+     thread.start(worker);
+ }
+ @endcode
+*/
+template <uint32_t StackSize = DEFAULT_STACK_SIZE>
+class StaticThread : public Thread {
+public:
+    /** Allocate a new thread without starting execution
+      @param   priority       initial priority of the thread function. (default: osPriorityNormal).
+    */
+    StaticThread(osPriority priority=osPriorityNormal)
+        : Thread(priority, sizeof(_stack), reinterpret_cast<unsigned char *>(_stack)) {
+    }
+
+private:
+    // Only the address is taken before the members are constructed
+    uint64_t _stack[(StackSize + 7) / 8];
+};
+
+}
+#endif
+
+/** @}*/
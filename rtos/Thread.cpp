@@ -24,11 +24,13 @@
 #include "mbed.h"
 #include "rtos/rtos_idle.h"
 
+#ifdef CMSIS_OS_RTX
 // rt_tid2ptcb is an internal function which we exposed to get TCB for thread id
 #undef NULL  //Workaround for conflicting macros in rt_TypeDef.h and stdio.h
 #include "rt_TypeDef.h"
 
 extern "C" P_TCB rt_tid2ptcb(osThreadId thread_id);
+#endif
 
 
 static void (*terminate_hook)(osThreadId id) = 0;
@@ -46,7 +48,7 @@ void Thread::constructor(osPriority priority,
     _tid = 0;
     _dynamic_stack = (stack_pointer == NULL);
 
-#if defined(__MBED_CMSIS_RTOS_CA9) || defined(__MBED_CMSIS_RTOS_CM)
+#if defined(__MBED_CMSIS_RTOS_CA9) || defined(__MBED_CMSIS_RTOS_CM) || !defined(CMSIS_OS_RTX)
     _thread_def.tpriority = priority;
     _thread_def.stacksize = stack_size;
     _thread_def.stack_pointer = (uint32_t*)stack_pointer;
@@ -90,6 +92,9 @@ osStatus Thread::start(Callback<void()> task) {
     for (uint32_t i = 0; i < (_thread_def.stacksize / sizeof(uint32_t)); i++) {
         _thread_def.stack_pointer[i] = 0xE25A2EA5;
     }
+#elif !defined(CMSIS_OS_RTX)
+    // other CMSIS-RTOS implementations allocate the stacks themselves
+    _thread_def.pthread = Thread::_thunk;
 #endif
     _task = task;
     _tid = osThreadCreate(&_thread_def, this);
@@ -175,8 +180,7 @@ int32_t Thread::signal_clr(int32_t signals) {
 }
 
 Thread::State Thread::get_state() {
-#if !defined(__MBED_CMSIS_RTOS_CA9) && !defined(__MBED_CMSIS_RTOS_CM)
-#ifdef CMSIS_OS_RTX
+#if !defined(__MBED_CMSIS_RTOS_CA9) && !defined(__MBED_CMSIS_RTOS_CM) && defined(CMSIS_OS_RTX)
     State status = Deleted;
     _mutex.lock();
 
@@ -186,7 +190,6 @@ Thread::State Thread::get_state() {
 
     _mutex.unlock();
     return status;
-#endif
 #else
     State status = Deleted;
     _mutex.lock();
@@ -201,8 +204,8 @@ Thread::State Thread::get_state() {
 }
 
 uint32_t Thread::stack_size() {
-#ifndef __MBED_CMSIS_RTOS_CA9
-#if defined(CMSIS_OS_RTX) && !defined(__MBED_CMSIS_RTOS_CM)
+#if !defined(__MBED_CMSIS_RTOS_CA9) && defined(CMSIS_OS_RTX)
+#if !defined(__MBED_CMSIS_RTOS_CM)
     uint32_t size = 0;
     _mutex.lock();
 
@@ -230,8 +233,8 @@ uint32_t Thread::stack_size() {
 }
 
 uint32_t Thread::free_stack() {
-#ifndef __MBED_CMSIS_RTOS_CA9
-#if defined(CMSIS_OS_RTX) && !defined(__MBED_CMSIS_RTOS_CM)
+#if !defined(__MBED_CMSIS_RTOS_CA9) && defined(CMSIS_OS_RTX)
+#if !defined(__MBED_CMSIS_RTOS_CM)
     uint32_t size = 0;
     _mutex.lock();
 
@@ -261,8 +264,8 @@ uint32_t Thread::free_stack() {
 }
 
 uint32_t Thread::used_stack() {
-#ifndef __MBED_CMSIS_RTOS_CA9
-#if defined(CMSIS_OS_RTX) && !defined(__MBED_CMSIS_RTOS_CM)
+#if !defined(__MBED_CMSIS_RTOS_CA9) && defined(CMSIS_OS_RTX)
+#if !defined(__MBED_CMSIS_RTOS_CM)
     uint32_t size = 0;
     _mutex.lock();
 
@@ -292,8 +295,8 @@ uint32_t Thread::used_stack() {
 }
 
 uint32_t Thread::max_stack() {
-#ifndef __MBED_CMSIS_RTOS_CA9
-#if defined(CMSIS_OS_RTX) && !defined(__MBED_CMSIS_RTOS_CM)
+#if !defined(__MBED_CMSIS_RTOS_CA9) && defined(CMSIS_OS_RTX)
+#if !defined(__MBED_CMSIS_RTOS_CM)
     uint32_t size = 0;
     _mutex.lock();
 
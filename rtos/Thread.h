@@ -29,6 +29,10 @@
 #include "rtos/Semaphore.h"
 #include "rtos/Mutex.h"
 
+/** Signal flag EventFlags and ConditionVariable wake waiting threads with,
+ *  not to be used by applications */
+#define RTOS_SIGNAL_WAKEUP 0x8000
+
 namespace rtos {
 /** \addtogroup rtos */
 /** @{*/
@@ -26,9 +26,13 @@
 #define RTOS_H
 
 #include "rtos/Thread.h"
+#include "rtos/StaticThread.h"
 #include "rtos/Mutex.h"
 #include "rtos/RtosTimer.h"
 #include "rtos/Semaphore.h"
+#include "rtos/EventFlags.h"
+#include "rtos/ConditionVariable.h"
+#include "rtos/RWLock.h"
 #include "rtos/Mail.h"
 #include "rtos/MemoryPool.h"
 #include "rtos/Queue.h"
@@ -22,13 +22,113 @@
 
 #include "rtos/rtos_idle.h"
 
+#if MBED_CONF_RTOS_TICKLESS && DEVICE_LOWPOWERTIMER && DEVICE_SLEEP && defined(__MBED_CMSIS_RTOS_CM)
+#define RTOS_IDLE_TICKLESS 1
+#endif
+
+#if RTOS_IDLE_TICKLESS
+#include "cmsis.h"
+#include "cmsis_os.h"
+#include "platform/critical.h"
+#include "hal/lp_ticker_api.h"
+#include "hal/us_ticker_api.h"
+#include "hal/sleep_api.h"
+#include "platform/mbed_sleep.h"
+
+/* Both in RTX, os_tick_irqn is negative when SysTick drives the kernel tick */
+extern const unsigned int os_clockrate;
+extern int os_tick_irqn;
+
+/* Time in us that passed but is not counted in the kernel ticks yet. With
+ * the SysTick phase reset on wakeup, the kernel time plus this plus the
+ * SysTick count always make the real time, so wakeups do not add up to a
+ * drift. */
+static uint32_t tickless_residue;
+static uint8_t tickless_init;
+
+/* Don't stop the tick for less than this, suspending is not free */
+#define TICKLESS_MIN_TICKS  2
+
+static void tickless_idle_hook(void)
+{
+    const ticker_data_t *lp_ticker = get_lp_ticker_data();
+    timestamp_t start, deadline, next;
+    uint32_t ticks, pending, sleep_us, total;
+
+    if (os_tick_irqn >= 0) {
+        /* the target's own timer drives the tick, its phase can't be
+         * read, so just sleep until the next tick */
+        sleep();
+        return;
+    }
+
+    if (!tickless_init) {
+        lp_ticker_init();
+#if !MBED_CONF_RTOS_TICKLESS_DEEP_SLEEP
+        /* Held for good, the idle loop only sleeps */
+        sleep_manager_lock_deep_sleep();
+#endif
+        tickless_init = 1;
+    }
+
+    ticks = os_suspend();
+    core_util_critical_section_enter();
+
+    /* Time since the last tick that was counted */
+    pending = tickless_residue + (uint32_t)(((uint64_t)(SysTick->LOAD - SysTick->VAL) * os_clockrate) /
+                                            (SysTick->LOAD + 1));
+
+    if (ticks < TICKLESS_MIN_TICKS || ticks * os_clockrate <= pending) {
+        core_util_critical_section_exit();
+        os_resume(0);
+        sleep();
+        return;
+    }
+    sleep_us = ticks * os_clockrate - pending;
+
+    /* Wake with the next lp ticker event if it comes first, interrupts
+     * stay pending until the critical section ends */
+    start = lp_ticker_read();
+    deadline = start + sleep_us;
+    if (!ticker_get_next_timestamp(lp_ticker, &next) || (int)(next - deadline) > 0) {
+        lp_ticker_set_interrupt(deadline);
+        next = deadline;
+    }
+
+    /* Deep sleep unless a driver or a pending us ticker event needs the
+     * clocks */
+    sleep_manager_set_wake_time(next);
+    sleep_manager_sleep_auto();
+
+    total = pending + (lp_ticker_read() - start);
+    tickless_residue = total % os_clockrate;
+
+    /* Restart the tick period, the residue keeps the part of it that
+     * already passed */
+    SysTick->VAL = 0;
+
+    if (ticker_get_next_timestamp(lp_ticker, &next)) {
+        lp_ticker_set_interrupt(next);
+    } else {
+        lp_ticker_disable_interrupt();
+    }
+
+    core_util_critical_section_exit();
+    os_resume(total / os_clockrate);
+}
+#endif
+
 static void default_idle_hook(void)
 {
+#if RTOS_IDLE_TICKLESS
+    tickless_idle_hook();
+#else
     /* Sleep: ideally, we should put the chip to sleep.
      Unfortunately, this usually requires disconnecting the interface chip (debugger).
      This can be done, but it would break the local file system.
     */
     // sleep();
+#endif
 }
 static void (*idle_hook_fptr)(void) = &default_idle_hook;
 
@@ -35,6 +35,9 @@
  * POSSIBILITY OF SUCH DAMAGE.
  *---------------------------------------------------------------------------*/
 #include "mbed_error.h"
+#include "mbed_interface.h"
+#include "critical.h"
+#include "mbed_boot_time.h"
 
 #if   defined (__CC_ARM)
 #include <rt_misc.h>
@@ -55,7 +58,11 @@
 #define _declare_box(pool,size,cnt)  uint32_t pool[(((size)+3)/4)*(cnt) + 3]
 #define _declare_box8(pool,size,cnt) uint64_t pool[(((size)+7)/8)*(cnt) + 2]
 
+#if defined(MBED_THREAD_CPU_STATS_ENABLED) && MBED_THREAD_CPU_STATS_ENABLED
+#define OS_TCB_SIZE     80
+#else
 #define OS_TCB_SIZE     64
+#endif
 #define OS_TMR_SIZE     8
 
 typedef void    *OS_ID;
@@ -195,8 +202,21 @@ osMutexId singleton_mutex_id;
 osMutexDef(singleton_mutex);
 
 #if defined (__CC_ARM) && !defined (__MICROLIB)
- /* A memory space for arm standard library. */
- static uint32_t std_libspace[OS_TASK_CNT][96/4];
+ /* Number of threads which can use the standard library */
+ #if defined(MBED_CONF_RTOS_LIBSPACE_COUNT)
+  #define OS_LIBSPACE_CNT  MBED_CONF_RTOS_LIBSPACE_COUNT
+ #else
+  #define OS_LIBSPACE_CNT  OS_TASK_CNT
+ #endif
+ /* Slots are numbered from 1 in a uint8_t, 0 meaning none yet */
+ #if (OS_LIBSPACE_CNT > 255)
+  #error "rtos.libspace-count must not exceed 255"
+ #endif
+ /* A memory space for arm standard library, given to a thread on its first
+  * use of the library, and kept by its thread id. */
+ static uint32_t std_libspace[OS_LIBSPACE_CNT][96/4];
+ static uint8_t  std_libspace_idx[OS_TASK_CNT];
+ static uint32_t nr_libspace;
  static OS_MUT   std_libmutex[OS_MUTEXCNT];
  static uint32_t nr_mutex;
  extern void  *__libspace_start;
@@ -298,14 +318,31 @@ void __iar_file_Mtxunlock(__iar_Rmtx *mutex) /* Unlock a file lock */
 
 void *__user_perthread_libspace (void) {
   /* Provide a separate libspace for each task. */
-  uint32_t idx;
+  uint32_t idx, slot;
 
   idx = (os_running != 0U) ? runtask_id () : 0U;
   if (idx == 0U) {
     /* RTX not running yet. */
     return (&__libspace_start);
   }
-  return ((void *)&std_libspace[idx-1]);
+
+  slot = std_libspace_idx[idx-1];
+  if (slot == 0U) {
+    /* First use by a thread with this id. */
+    core_util_critical_section_enter();
+    slot = std_libspace_idx[idx-1];
+    if (slot == 0U && nr_libspace < OS_LIBSPACE_CNT) {
+      slot = ++nr_libspace;
+      std_libspace_idx[idx-1] = (uint8_t)slot;
+    }
+    core_util_critical_section_exit();
+    if (slot == 0U) {
+      /* More threads use the library than rtos.libspace-count allows, */
+      /* reporting it with printf would need a libspace as well.      */
+      mbed_die();
+    }
+  }
+  return ((void *)&std_libspace[slot-1]);
 }
 
 /*--------------------------- _mutex_initialize -----------------------------*/
@@ -514,8 +551,10 @@ void $Sub$$__cpp_initialize__aeabi_(void)
 
 void pre_main()
 {
+  MBED_BOOT_TIME_MARK(MBED_BOOT_RTOS_INIT);
   singleton_mutex_id = osMutexCreate(osMutex(singleton_mutex));
   $Super$$__cpp_initialize__aeabi_();
+  MBED_BOOT_TIME_MARK(MBED_BOOT_CONSTRUCTORS);
   main();
 }
 
@@ -525,8 +564,10 @@ int main(void);
 
 void pre_main (void)
 {
+    MBED_BOOT_TIME_MARK(MBED_BOOT_RTOS_INIT);
     singleton_mutex_id = osMutexCreate(osMutex(singleton_mutex));
     __rt_lib_init((unsigned)mbed_heap_start, (unsigned)(mbed_heap_start + mbed_heap_size));
+    MBED_BOOT_TIME_MARK(MBED_BOOT_CONSTRUCTORS);
     main();
 }
 
@@ -592,10 +633,12 @@ extern void __libc_init_array (void);
 extern int main(int argc, char **argv);
 
 void pre_main(void) {
+    MBED_BOOT_TIME_MARK(MBED_BOOT_RTOS_INIT);
     singleton_mutex_id = osMutexCreate(osMutex(singleton_mutex));
     malloc_mutex_id = osMutexCreate(osMutex(malloc_mutex));
     env_mutex_id = osMutexCreate(osMutex(env_mutex));
     __libc_init_array();
+    MBED_BOOT_TIME_MARK(MBED_BOOT_CONSTRUCTORS);
     main(0, NULL);
 }
 
@@ -647,17 +690,22 @@ extern __weak void __iar_init_vfp( void );
 extern void __iar_dynamic_initialization(void);
 extern void mbed_sdk_init(void);
 extern void mbed_main(void);
+extern void core_util_irq_mask_init(void);
 extern int main(void);
 extern void exit(int arg);
 
 static uint8_t low_level_init_needed;
 
 void pre_main(void) {
+    MBED_BOOT_TIME_MARK(MBED_BOOT_RTOS_INIT);
     singleton_mutex_id = osMutexCreate(osMutex(singleton_mutex));
     if (low_level_init_needed) {
         __iar_dynamic_initialization();
     }
+    MBED_BOOT_TIME_MARK(MBED_BOOT_CONSTRUCTORS);
+    core_util_irq_mask_init();
     mbed_main();
+    MBED_BOOT_TIME_MARK(MBED_BOOT_MAIN);
     main();
 }
 
@@ -673,7 +721,9 @@ void __iar_program_start( void )
   low_level_init_needed_local = __low_level_init();
   if (low_level_init_needed_local) {
     __iar_data_init3();
+    MBED_BOOT_TIME_MARK(MBED_BOOT_START);
     mbed_sdk_init();
+    MBED_BOOT_TIME_MARK(MBED_BOOT_SDK_INIT);
   }
   /* Store in a global variable after RAM has been initialized */
   low_level_init_needed = low_level_init_needed_local;
@@ -93,8 +93,13 @@
 //   <q>Stack overflow checking
 //   <i> Enable stack overflow checks at thread switch.
 //   <i> Enabling this option increases slightly the execution time of a thread switch.
+//   <i> Off by default with MBED_STACK_GUARD_ENABLED, the MPU faults on overflow.
 #ifndef OS_STKCHECK
- #define OS_STKCHECK    1
+  #if (defined(MBED_STACK_GUARD_ENABLED) && MBED_STACK_GUARD_ENABLED)
+   #define OS_STKCHECK  0
+  #else
+   #define OS_STKCHECK  1
+  #endif
 #endif
 
 //   <q>Stack usage watermark
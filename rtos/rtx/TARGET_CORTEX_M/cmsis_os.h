@@ -727,6 +727,47 @@ osStatus _osThreadEnumFree(osThreadEnumId enum_id);
 #endif  // Thread Enumeration available
 
 
+//  ==== Message Queue Bulk Functions ====
+
+#if (defined (osFeature_MessageQ)  &&  (osFeature_MessageQ != 0))     // Message Queues available
+
+/// Put several Messages to a Queue without waiting.
+/// \param[in]     queue_id      message queue ID obtained with \ref osMessageCreate.
+/// \param[in]     info          array of message information.
+/// \param[in]     count         number of messages in info.
+/// \return number of messages put, less than count when the queue is full or a thread that
+///         received one preempts the caller.
+uint32_t _osMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count);
+
+/// Get several Messages from a Queue without waiting.
+/// \param[in]     queue_id      message queue ID obtained with \ref osMessageCreate.
+/// \param[out]    info          array the message information is stored to.
+/// \param[in]     count         size of the info array.
+/// \return number of messages got, less than count when the queue runs empty or a thread
+///         waiting to put one preempts the caller.
+uint32_t _osMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count);
+
+#endif  // Message Queues available
+
+#if (defined (osFeature_MailQ)  &&  (osFeature_MailQ != 0))     // Mail Queues available
+
+/// Put several mails to a Mail Queue.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[in]     mail          array of memory blocks obtained with \ref osMailAlloc or \ref osMailCAlloc.
+/// \param[in]     count         number of memory blocks in mail.
+/// \return number of mails put, as \ref _osMessagePutN.
+uint32_t _osMailPutN (osMailQId queue_id, void *const *mail, uint32_t count);
+
+/// Get several mails from a Mail Queue without waiting.
+/// \param[in]     queue_id      mail queue ID obtained with \ref osMailCreate.
+/// \param[out]    mail          array the memory blocks are stored to.
+/// \param[in]     count         size of the mail array.
+/// \return number of mails got, as \ref _osMessageGetN.
+uint32_t _osMailGetN (osMailQId queue_id, void **mail, uint32_t count);
+
+#endif  // Mail Queues available
+
+
 //  ==== RTX Extensions ====
 
 /// Suspend the RTX task scheduler.
@@ -2121,6 +2121,108 @@ os_InRegs osEvent osMessageGet (osMessageQId queue_id, uint32_t millisec) {
 }
 
 
+// Message Queue Bulk Service Calls declarations
+SVC_3_1(svcMessagePutN, uint32_t, osMessageQId, const uint32_t *, uint32_t, RET_uint32_t)
+SVC_3_1(svcMessageGetN, uint32_t, osMessageQId,       uint32_t *, uint32_t, RET_uint32_t)
+
+// Message Queue Bulk Service Calls
+
+/// Put several Messages to a Queue without waiting
+uint32_t svcMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count) {
+  uint32_t n;
+
+  if ((queue_id == NULL) || (((P_MCB)queue_id)->cb_type != MCB)) {
+    return 0U;
+  }
+
+  for (n = 0U; n < count; n++) {
+    if (rt_mbx_send(queue_id, (void *)info[n], 0U) != OS_R_OK) {
+      break;
+    }
+    if (os_tsk.new_tsk != os_tsk.run) {
+      // A receiver preempts, the running task must not be dispatched again
+      n++;
+      break;
+    }
+  }
+
+  return n;
+}
+
+/// Get several Messages from a Queue without waiting
+uint32_t svcMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count) {
+  uint32_t n;
+
+  if ((queue_id == NULL) || (((P_MCB)queue_id)->cb_type != MCB)) {
+    return 0U;
+  }
+
+  for (n = 0U; n < count; n++) {
+    if (rt_mbx_wait(queue_id, (void **)&info[n], 0U) != OS_R_OK) {
+      break;
+    }
+    if (os_tsk.new_tsk != os_tsk.run) {
+      // A sender preempts, the running task must not be dispatched again
+      n++;
+      break;
+    }
+  }
+
+  return n;
+}
+
+// Message Queue Bulk ISR Calls
+
+/// Put several Messages to a Queue
+static uint32_t isrMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count) {
+  uint32_t n;
+
+  for (n = 0U; n < count; n++) {
+    if (isrMessagePut(queue_id, info[n], 0U) != osOK) {
+      break;
+    }
+  }
+
+  return n;
+}
+
+/// Get several Messages from a Queue
+static uint32_t isrMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count) {
+  osEvent  evt;
+  uint32_t n;
+
+  for (n = 0U; n < count; n++) {
+    evt = isrMessageGet(queue_id, 0U);
+    if (evt.status != osEventMessage) {
+      break;
+    }
+    info[n] = evt.value.v;
+  }
+
+  return n;
+}
+
+// Message Queue Bulk Public API
+
+/// Put several Messages to a Queue without waiting
+uint32_t _osMessagePutN (osMessageQId queue_id, const uint32_t *info, uint32_t count) {
+  if (__get_PRIMASK() != 0U || __get_IPSR() != 0U) {                     // in ISR
+    return   isrMessagePutN(queue_id, info, count);
+  } else {                                      // in Thread
+    return __svcMessagePutN(queue_id, info, count);
+  }
+}
+
+/// Get several Messages from a Queue without waiting
+uint32_t _osMessageGetN (osMessageQId queue_id, uint32_t *info, uint32_t count) {
+  if (__get_PRIMASK() != 0U || __get_IPSR() != 0U) {                     // in ISR
+    return   isrMessageGetN(queue_id, info, count);
+  } else {                                      // in Thread
+    return __svcMessageGetN(queue_id, info, count);
+  }
+}
+
+
 // ==== Mail Queue Management Functions ====
 
 // Mail Queue Management Service Calls declarations
@@ -2323,6 +2425,22 @@ os_InRegs osEvent osMailGet (osMailQId queue_id, uint32_t millisec) {
   return ret;
 }
 
+/// Put several mails to a queue
+uint32_t _osMailPutN (osMailQId queue_id, void *const *mail, uint32_t count) {
+  if (queue_id == NULL) {
+    return 0U;
+  }
+  return _osMessagePutN(*((void **)queue_id), (const uint32_t *)mail, count);
+}
+
+/// Get several mails from a queue without waiting
+uint32_t _osMailGetN (osMailQId queue_id, void **mail, uint32_t count) {
+  if (queue_id == NULL) {
+    return 0U;
+  }
+  return _osMessageGetN(*((void **)queue_id), (uint32_t *)mail, count);
+}
+
 
 //  ==== RTX Extensions ====
 
@@ -0,0 +1,164 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    rt_CpuStats.c
+ *      Purpose: Per thread CPU usage accounting
+ *      Rev.:    VX.XX
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 2017 ARM Limited
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+
+#if defined(MBED_THREAD_CPU_STATS_ENABLED) && MBED_THREAD_CPU_STATS_ENABLED
+
+#define __CMSIS_GENERIC
+
+#if defined (__CORTEX_M4) || defined (__CORTEX_M4F)
+  #include "core_cm4.h"
+#elif defined (__CORTEX_M7) || defined (__CORTEX_M7F)
+  #include "core_cm7.h"
+#elif defined (__CORTEX_M3)
+  #include "core_cm3.h"
+#elif defined (__CORTEX_M0)
+  #include "core_cm0.h"
+#elif defined (__CORTEX_M0PLUS)
+  #include "core_cm0plus.h"
+#else
+  #error "Missing __CORTEX_Mx definition"
+#endif
+
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_Task.h"
+#include "rt_CpuStats.h"
+#include "critical.h"
+#include "mbed_stats.h"
+
+/* The run time of a task is measured from the switch to it until the next
+ * switch, which includes the interrupts taken meanwhile. The system tick
+ * requests a switch to the running task on every tick, which accounts the
+ * time before the 32-bit clock wraps. */
+#if defined (DWT_CTRL_CYCCNTENA_Msk)
+  /* Cycle counter of the DWT unit, at the core clock */
+  #define rt_cpu_stats_clock()  (DWT->CYCCNT)
+  #define RT_CPU_STATS_FREQ     (SystemCoreClock)
+#else
+  /* No cycle counter on ARMv6-M, microseconds of the us ticker */
+  #include "us_ticker_api.h"
+  #define rt_cpu_stats_clock()  (us_ticker_read())
+  #define RT_CPU_STATS_FREQ     (1000000U)
+#endif
+
+extern uint32_t SystemCoreClock;
+
+static U32 cpu_mark;
+static U32 cpu_total_lo;
+static U32 cpu_total_hi;
+static U32 cpu_switches;
+
+
+/*--------------------------- rt_cpu_stats_init ----------------------------*/
+
+void rt_cpu_stats_init (void) {
+  /* Start the clock the run times are measured with. */
+#if defined (DWT_CTRL_CYCCNTENA_Msk)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT       = 0U;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+  cpu_mark = rt_cpu_stats_clock();
+}
+
+
+/*--------------------------- rt_cpu_stats_switch --------------------------*/
+
+void rt_cpu_stats_switch (P_TCB p_new) {
+  /* Account the time since the last switch to the running task. Called  */
+  /* with the task "p_new" that runs next, before its state is changed.   */
+  P_TCB run = os_tsk.run;
+  U32 now   = rt_cpu_stats_clock();
+  U32 delta = now - cpu_mark;
+
+  cpu_mark = now;
+  cpu_total_lo += delta;
+  if (cpu_total_lo < delta) {
+    cpu_total_hi++;
+  }
+
+  if (run != NULL) {
+    /* NULL when the running task deleted itself */
+    run->cpu_time_lo += delta;
+    if (run->cpu_time_lo < delta) {
+      run->cpu_time_hi++;
+    }
+  }
+
+  if (p_new != run) {
+    cpu_switches++;
+    p_new->switches++;
+    if (run != NULL && run->state == READY) {
+      run->preemptions++;
+    }
+  }
+}
+
+
+/*--------------------------- mbed_stats -----------------------------------*/
+
+void mbed_stats_cpu_get (mbed_stats_cpu_t *stats) {
+  core_util_critical_section_enter();
+  rt_cpu_stats_switch(os_tsk.run);
+  stats->total_time = ((uint64_t)cpu_total_hi << 32) | cpu_total_lo;
+  stats->idle_time  = ((uint64_t)os_idle_TCB.cpu_time_hi << 32) | os_idle_TCB.cpu_time_lo;
+  stats->clock      = RT_CPU_STATS_FREQ;
+  stats->switches   = cpu_switches;
+  core_util_critical_section_exit();
+}
+
+size_t mbed_stats_thread_cpu_get (mbed_stats_thread_cpu_t *stats, size_t count) {
+  size_t n = 0U;
+  U32 i;
+
+  core_util_critical_section_enter();
+  rt_cpu_stats_switch(os_tsk.run);
+  for (i = 0U; i < os_maxtaskrun && n < count; i++) {
+    P_TCB p_TCB = (P_TCB)os_active_TCB[i];
+    if (p_TCB == NULL) {
+      continue;
+    }
+    stats[n].id          = (uint32_t)p_TCB;
+    stats[n].cpu_time    = ((uint64_t)p_TCB->cpu_time_hi << 32) | p_TCB->cpu_time_lo;
+    stats[n].switches    = p_TCB->switches;
+    stats[n].preemptions = p_TCB->preemptions;
+    n++;
+  }
+  core_util_critical_section_exit();
+
+  return n;
+}
+
+#endif
@@ -0,0 +1,124 @@
+/*----------------------------------------------------------------------------
+ *      CMSIS-RTOS  -  RTX
+ *----------------------------------------------------------------------------
+ *      Name:    rt_StkGuard.c
+ *      Purpose: MPU guard regions of thread stacks
+ *      Rev.:    VX.XX
+ *----------------------------------------------------------------------------
+ *
+ * Copyright (c) 2017 ARM Limited
+ * All rights reserved.
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *  - Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  - Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  - Neither the name of ARM  nor the names of its contributors may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS AND CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *---------------------------------------------------------------------------*/
+
+
+
+#if defined(MBED_STACK_GUARD_ENABLED) && MBED_STACK_GUARD_ENABLED
+
+#include "cmsis.h"
+#include "rt_TypeDef.h"
+#include "RTX_Config.h"
+#include "rt_Task.h"
+#include "rt_StkGuard.h"
+
+/* The lowest 32 bytes of the running task's stack, aligned to 32 bytes as
+ * regions of the ARMv7-M MPU must be, are read-only to privileged code and
+ * inaccessible to unprivileged code. A push past the end of the stack then
+ * faults at once, instead of being found by rt_stk_check on the next
+ * switch. Reads stay allowed for the stack usage statistics. The guard
+ * takes the highest MPU region, which has precedence over the ones a
+ * target may have set up, and everything else keeps the default memory
+ * map. Cores without an MPU keep the check of the magic word only. */
+#if defined (__MPU_PRESENT) && (__MPU_PRESENT == 1U) && defined (MPU_RASR_ENABLE_Msk)
+
+#define STK_GUARD_SIZE   32U
+
+/* Size 2^(4+1), privileged read-only, no execution, normal memory */
+#define STK_GUARD_RASR   ((1U << MPU_RASR_XN_Pos)   | \
+                          (5U << MPU_RASR_AP_Pos)   | \
+                          (1U << MPU_RASR_TEX_Pos)  | \
+                          (1U << MPU_RASR_C_Pos)    | \
+                          (1U << MPU_RASR_B_Pos)    | \
+                          (4U << MPU_RASR_SIZE_Pos) | \
+                          MPU_RASR_ENABLE_Msk)
+
+static U32 guard_region;
+
+
+/*--------------------------- rt_stk_guard_init ----------------------------*/
+
+void rt_stk_guard_init (void) {
+  /* Enable the MPU, with the default memory map for privileged code. */
+  U32 regions = (MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos;
+
+  if (regions == 0U) {
+    return;
+  }
+  guard_region = regions;
+  MPU->RNR  = regions - 1U;
+  MPU->RASR = 0U;
+  MPU->CTRL |= MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+  __DSB();
+  __ISB();
+}
+
+
+/*--------------------------- rt_stk_guard_switch --------------------------*/
+
+void rt_stk_guard_switch (P_TCB p_new) {
+  /* Move the guard to the stack of "p_new", before it is switched to. The */
+  /* task switched from runs no more code until then, saving its context  */
+  /* on its own stack is not affected.                                    */
+  U32 size, base;
+
+  if (guard_region == 0U) {
+    return;
+  }
+
+  size = p_new->priv_stack;
+  if (size == 0U) {
+    size = (U16)os_stackinfo;
+  }
+  base = ((U32)p_new->stack + (STK_GUARD_SIZE - 1U)) & ~(STK_GUARD_SIZE - 1U);
+
+  MPU->RNR = guard_region - 1U;
+  if (base + STK_GUARD_SIZE * 2U > (U32)p_new->stack + size) {
+    /* Too small to spare a guard */
+    MPU->RASR = 0U;
+  } else {
+    MPU->RBAR = base;
+    MPU->RASR = STK_GUARD_RASR;
+  }
+  __DSB();
+  __ISB();
+}
+
+#else
+
+void rt_stk_guard_init   (void) {;}
+void rt_stk_guard_switch (P_TCB p_new) {;}
+
+#endif
+
+#endif
@@ -41,6 +41,8 @@
 #include "rt_Robin.h"
 #include "rt_HAL_CM.h"
 #include "rt_OsEventObserver.h"
+#include "rt_CpuStats.h"
+#include "rt_StkGuard.h"
 
 /*----------------------------------------------------------------------------
  *      Global Variables
@@ -87,6 +89,12 @@ static void rt_init_context (P_TCB p_TCB, U8 priority, FUNCP task_body) {
   p_TCB->events  = 0U;
   p_TCB->waits   = 0U;
   p_TCB->stack_frame = 0U;
+#if defined(MBED_THREAD_CPU_STATS_ENABLED) && MBED_THREAD_CPU_STATS_ENABLED
+  p_TCB->cpu_time_lo = 0U;
+  p_TCB->cpu_time_hi = 0U;
+  p_TCB->switches    = 0U;
+  p_TCB->preemptions = 0U;
+#endif
 
   if (p_TCB->priv_stack == 0U) {
     /* Allocate the memory space for the stack. */
@@ -100,6 +108,12 @@ static void rt_init_context (P_TCB p_TCB, U8 priority, FUNCP task_body) {
 
 void rt_switch_req (P_TCB p_new) {
   /* Switch to next task (identified by "p_new"). */
+#if defined(MBED_THREAD_CPU_STATS_ENABLED) && MBED_THREAD_CPU_STATS_ENABLED
+  rt_cpu_stats_switch (p_new);
+#endif
+#if defined(MBED_STACK_GUARD_ENABLED) && MBED_STACK_GUARD_ENABLED
+  rt_stk_guard_switch (p_new);
+#endif
   os_tsk.new_tsk   = p_new;
   p_new->state = RUNNING;
   if (osEventObs && osEventObs->thread_switch) {
@@ -407,6 +421,14 @@ void rt_sys_init (FUNCP first_task, U32 prio_stksz, void *stk) {
   os_tsk.run = &os_idle_TCB;
   os_tsk.run->state = RUNNING;
 
+#if defined(MBED_THREAD_CPU_STATS_ENABLED) && MBED_THREAD_CPU_STATS_ENABLED
+  rt_cpu_stats_init ();
+#endif
+
+#if defined(MBED_STACK_GUARD_ENABLED) && MBED_STACK_GUARD_ENABLED
+  rt_stk_guard_init ();
+#endif
+
   /* Set the current thread to idle, so that on exit from this SVCall we do not
    * de-reference a NULL TCB. */
   rt_switch_req(&os_idle_TCB);
@@ -84,6 +84,14 @@ typedef struct OS_TCB {
   FUNCP  ptask;                   /* Task entry address                      */
   void   *argv;                   /* Task argument                           */
   void   *context;                /* Pointer to thread context               */
+
+#if defined(MBED_THREAD_CPU_STATS_ENABLED) && MBED_THREAD_CPU_STATS_ENABLED
+  /* CPU usage accounting, see rt_CpuStats.c                                 */
+  U32    cpu_time_lo;             /* Run time, in rt_cpu_stats_clock units   */
+  U32    cpu_time_hi;
+  U32    switches;                /* Times the task was switched to          */
+  U32    preemptions;             /* Times switched from while ready         */
+#endif
 } *P_TCB;
 #define TCB_STACKF      37        /* 'stack_frame' offset                    */
 #define TCB_TSTACK      44        /* 'tsk_stack' offset                      */
@@ -0,0 +1,233 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "flash_api.h"
+
+#if DEVICE_FLASH
+
+#include <string.h>
+#include "critical.h"
+
+/* Two 512KB program flash blocks: the controller runs a command on one
+ * while the CPU reads the other. Images below 512KB leave block 1 free
+ * for read-while-write. */
+#define FLASH_SECTOR_SIZE   FSL_FEATURE_FLASH_PFLASH_BLOCK_SECTOR_SIZE
+#define FLASH_PAGE_SIZE     FSL_FEATURE_FLASH_PFLASH_BLOCK_WRITE_UNIT_SIZE
+#define FLASH_BLOCK_SIZE    FSL_FEATURE_FLASH_PFLASH_BLOCK_SIZE
+#define FLASH_START         FSL_FEATURE_FLASH_PFLASH_START_ADDRESS
+#define FLASH_SIZE          (FSL_FEATURE_FLASH_PFLASH_BLOCK_COUNT * FLASH_BLOCK_SIZE)
+
+/* FCCOB0 command codes */
+#define FLASH_CMD_PROGRAM_PHRASE    0x07
+#define FLASH_CMD_ERASE_SECTOR      0x09
+
+#define FLASH_ERRORS    (FTFE_FSTAT_RDCOLERR_MASK | FTFE_FSTAT_ACCERR_MASK | FTFE_FSTAT_FPVIOL_MASK)
+
+static int flash_in_range(uint32_t address, uint32_t size)
+{
+    return address >= FLASH_START && size <= FLASH_SIZE && address - FLASH_START <= FLASH_SIZE - size;
+}
+
+int32_t flash_init(flash_t *obj)
+{
+    memset(obj, 0, sizeof(*obj));
+    if (FLASH_Init(&obj->config) != kStatus_FLASH_Success ||
+            FLASH_PrepareExecuteInRamFunctions(&obj->config) != kStatus_FLASH_Success) {
+        return -1;
+    }
+    return 0;
+}
+
+int32_t flash_free(flash_t *obj)
+{
+#if DEVICE_FLASH_ASYNCH
+    if (obj->command) {
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+int32_t flash_erase_sector(flash_t *obj, uint32_t address)
+{
+    status_t status;
+
+    if (!flash_in_range(address, FLASH_SECTOR_SIZE) || (address % FLASH_SECTOR_SIZE)) {
+        return -1;
+    }
+#if DEVICE_FLASH_ASYNCH
+    if (obj->command) {
+        return -1;
+    }
+#endif
+
+    /* the driver waits from RAM, the interrupt handlers mustn't run from
+     * the flash meanwhile */
+    core_util_critical_section_enter();
+    status = FLASH_Erase(&obj->config, address, FLASH_SECTOR_SIZE, kFLASH_apiEraseKey);
+    core_util_critical_section_exit();
+    return (status == kStatus_FLASH_Success) ? 0 : -1;
+}
+
+int32_t flash_program_page(flash_t *obj, uint32_t address, const uint8_t *data, uint32_t size)
+{
+    status_t status;
+
+    if (!size || !flash_in_range(address, size) || (address % FLASH_PAGE_SIZE) || (size % FLASH_PAGE_SIZE)) {
+        return -1;
+    }
+#if DEVICE_FLASH_ASYNCH
+    if (obj->command) {
+        return -1;
+    }
+#endif
+
+    core_util_critical_section_enter();
+    status = FLASH_Program(&obj->config, address, (uint32_t *)data, size);
+    core_util_critical_section_exit();
+    return (status == kStatus_FLASH_Success) ? 0 : -1;
+}
+
+uint32_t flash_get_sector_size(const flash_t *obj, uint32_t address)
+{
+    if (!flash_in_range(address, 1)) {
+        return MBED_FLASH_INVALID_SIZE;
+    }
+    return FLASH_SECTOR_SIZE;
+}
+
+uint32_t flash_get_page_size(const flash_t *obj)
+{
+    return FLASH_PAGE_SIZE;
+}
+
+uint32_t flash_get_start_address(const flash_t *obj)
+{
+    return FLASH_START;
+}
+
+uint32_t flash_get_size(const flash_t *obj)
+{
+    return FLASH_SIZE;
+}
+
+#if DEVICE_FLASH_ASYNCH
+
+static void flash_setup_address(uint32_t address)
+{
+    FTFE->FCCOB1 = (uint8_t)(address >> 16);
+    FTFE->FCCOB2 = (uint8_t)(address >> 8);
+    FTFE->FCCOB3 = (uint8_t)address;
+}
+
+/* The phrase is two little endian words, each loaded most significant byte first */
+static void flash_setup_phrase(uint32_t address, const uint8_t *data)
+{
+    FTFE->FCCOB0 = FLASH_CMD_PROGRAM_PHRASE;
+    flash_setup_address(address);
+    FTFE->FCCOB4 = data[3];
+    FTFE->FCCOB5 = data[2];
+    FTFE->FCCOB6 = data[1];
+    FTFE->FCCOB7 = data[0];
+    FTFE->FCCOB8 = data[7];
+    FTFE->FCCOB9 = data[6];
+    FTFE->FCCOBA = data[5];
+    FTFE->FCCOBB = data[4];
+}
+
+static void flash_launch(uint32_t handler)
+{
+    FTFE->FSTAT = FLASH_ERRORS;
+    NVIC_SetVector(FTFE_IRQn, handler);
+    NVIC_ClearPendingIRQ(FTFE_IRQn);
+    NVIC_EnableIRQ(FTFE_IRQn);
+    FTFE->FSTAT = FTFE_FSTAT_CCIF_MASK;
+    // the interrupt is taken while CCIF is set, once the command ends
+    FTFE->FCNFG |= FTFE_FCNFG_CCIE_MASK;
+}
+
+uint8_t flash_is_rww(const flash_t *obj, uint32_t address)
+{
+    return address >= FLASH_START + FLASH_BLOCK_SIZE && flash_in_range(address, 1);
+}
+
+int32_t flash_erase_sector_asynch(flash_t *obj, uint32_t address, uint32_t handler)
+{
+    if (obj->command || !flash_is_rww(obj, address) || (address % FLASH_SECTOR_SIZE)) {
+        return -1;
+    }
+
+    obj->command = FLASH_CMD_ERASE_SECTOR;
+    FTFE->FCCOB0 = FLASH_CMD_ERASE_SECTOR;
+    flash_setup_address(address);
+    flash_launch(handler);
+    return 0;
+}
+
+int32_t flash_program_page_asynch(flash_t *obj, uint32_t address, const uint8_t *data, uint32_t size,
+                                  uint32_t handler)
+{
+    if (obj->command || !size || !flash_in_range(address, size) || !flash_is_rww(obj, address) ||
+            (address % FLASH_PAGE_SIZE) || (size % FLASH_PAGE_SIZE)) {
+        return -1;
+    }
+
+    obj->command = FLASH_CMD_PROGRAM_PHRASE;
+    obj->address = address + FLASH_PAGE_SIZE;
+    obj->data = data + FLASH_PAGE_SIZE;
+    obj->remaining = size - FLASH_PAGE_SIZE;
+    flash_setup_phrase(address, data);
+    flash_launch(handler);
+    return 0;
+}
+
+uint32_t flash_irq_handler_asynch(flash_t *obj)
+{
+    uint32_t event;
+
+    if (!(FTFE->FSTAT & FTFE_FSTAT_CCIF_MASK)) {
+        return 0;
+    }
+
+    if (FTFE->FSTAT & (FLASH_ERRORS | FTFE_FSTAT_MGSTAT0_MASK)) {
+        event = FLASH_EVENT_ERROR;
+    } else if (obj->command == FLASH_CMD_PROGRAM_PHRASE && obj->remaining) {
+        // the next phrase, a page is a phrase
+        flash_setup_phrase(obj->address, obj->data);
+        obj->address += FLASH_PAGE_SIZE;
+        obj->data += FLASH_PAGE_SIZE;
+        obj->remaining -= FLASH_PAGE_SIZE;
+        FTFE->FSTAT = FTFE_FSTAT_CCIF_MASK;
+        return 0;
+    } else {
+        event = FLASH_EVENT_COMPLETE;
+    }
+
+    FTFE->FCNFG &= ~FTFE_FCNFG_CCIE_MASK;
+    NVIC_DisableIRQ(FTFE_IRQn);
+    // the FMC cache and prefetch buffers may hold the old content
+    FMC->PFB0CR |= FMC_PFB0CR_CINV_WAY_MASK | FMC_PFB0CR_S_B_INV_MASK;
+    obj->command = 0;
+    return event;
+}
+
+uint8_t flash_active(flash_t *obj)
+{
+    return obj->command != 0;
+}
+
+#endif
+
+#endif
@@ -22,8 +22,13 @@
 #include "pinmap.h"
 #include "fsl_ftm.h"
 #include "PeripheralPins.h"
+#if DEVICE_PWMOUT_ASYNCH
+#include "fsl_edma.h"
+#include "fsl_dmamux.h"
+#endif
 
 static float pwm_clock_mhz;
+static uint32_t pwm_clock_div;
 /* Array of FTM peripheral base address. */
 static FTM_Type *const ftm_addrs[] = FTM_BASE_PTRS;
 
@@ -46,6 +51,7 @@ void pwmout_init(pwmout_t* obj, PinName pin) {
     }
 
     pwm_clock_mhz = clkval;
+    pwm_clock_div = clkdiv;
     uint32_t channel = pwm & 0xF;
     uint32_t instance = pwm >> TPM_SHIFT;
     ftm_config_t ftmInfo;
@@ -117,6 +123,12 @@ void pwmout_period_us(pwmout_t* obj, int us) {
     FTM_Type *base = ftm_addrs[obj->pwm_name >> TPM_SHIFT];
     float dc = pwmout_read(obj);
 
+#if DEVICE_PWMOUT_ASYNCH
+    // Back from the timebase of a sequence
+    base->MODE |= FTM_MODE_FTMEN_MASK;
+    base->SC = (base->SC & ~FTM_SC_PS_MASK) | FTM_SC_PS(pwm_clock_div);
+#endif
+
     // Stop FTM clock to ensure instant update of MOD register
     base->MOD = FTM_MOD_MOD((pwm_clock_mhz * (float)us) - 1);
     pwmout_write(obj, dc);
@@ -140,4 +152,176 @@ void pwmout_pulsewidth_us(pwmout_t* obj, int us) {
     FTM_SetSoftwareTrigger(base, true);
 }
 
+#if DEVICE_PWMOUT_ASYNCH
+
+/* The match of the channel requests the DMA which writes the next pulse
+ * width into CnV. With FTMEN cleared the FTM updates CnV at the next
+ * overflow, so the new width applies from the next period on. Each FTM has
+ * its own eDMA channel after the ones the SDK drivers use by default. */
+#define PWM_SEQUENCE_DMA_CHANNEL(instance)  (12 + (instance))
+
+static const uint8_t pwm_sequence_dma_source[] = {
+    kDmaRequestMux0FTM0Channel0 & 0xFF,
+    kDmaRequestMux0FTM1Channel0 & 0xFF,
+    kDmaRequestMux0FTM2Channel0 & 0xFF,
+    kDmaRequestMux0FTM3Channel0 & 0xFF,
+};
+
+typedef struct {
+    uint32_t event_mask;
+    uint8_t running;
+    uint8_t circular;
+} pwm_sequence_t;
+
+static pwm_sequence_t pwm_sequences[sizeof(ftm_addrs) / sizeof(ftm_addrs[0])];
+static bool pwm_sequence_dma_init;
+
+// Prescaler and modulo for a sequence rate, at the finest resolution
+static int pwm_sequence_timing(uint32_t hz, uint32_t *ps, uint32_t *mod)
+{
+    uint32_t clock = CLOCK_GetFreq(kCLOCK_BusClk);
+
+    if (hz == 0 || hz > clock) {
+        return -1;
+    }
+    for (*ps = 0; *ps <= 7; (*ps)++) {
+        uint32_t counts = (clock >> *ps) / hz;
+        if (counts <= 0x10000) {
+            *mod = counts - 1;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+uint16_t pwmout_sequence_pulse(pwmout_t *obj, uint32_t hz, float percent)
+{
+    uint32_t ps;
+    uint32_t mod;
+
+    if (pwm_sequence_timing(hz, &ps, &mod) != 0) {
+        return 0;
+    }
+    if (percent < 0.0f) {
+        percent = 0.0f;
+    } else if (percent > 1.0f) {
+        percent = 1.0f;
+    }
+    // A CnV past MOD never matches and would hold the DMA requests back
+    uint32_t count = (uint32_t)((float)(mod + 1) * percent);
+    return (count > mod) ? mod : count;
+}
+
+int pwmout_sequence_start(pwmout_t *obj, const uint16_t *pulses, size_t length, uint32_t hz, uint8_t circular, uint32_t handler, uint32_t event)
+{
+    uint32_t instance = obj->pwm_name >> TPM_SHIFT;
+    uint32_t channel = obj->pwm_name & 0xF;
+    uint32_t dma_channel = PWM_SEQUENCE_DMA_CHANNEL(instance);
+    pwm_sequence_t *sequence = &pwm_sequences[instance];
+    FTM_Type *base = ftm_addrs[instance];
+    uint32_t ps;
+    uint32_t mod;
+
+    // FTM1 and FTM2 only request DMA on their first two channels
+    if (sequence->running || length == 0 || length > 0x7FFF ||
+            ((instance == 1 || instance == 2) && channel > 1) ||
+            pwm_sequence_timing(hz, &ps, &mod) != 0) {
+        return -1;
+    }
+
+    sequence->event_mask = event;
+    sequence->circular = circular;
+
+    if (!pwm_sequence_dma_init) {
+        edma_config_t config;
+        EDMA_GetDefaultConfig(&config);
+        EDMA_Init(DMA0, &config);
+        DMAMUX_Init(DMAMUX0);
+        pwm_sequence_dma_init = true;
+    }
+
+    // Sequence timebase, CnV updates at each overflow without a trigger
+    base->MODE &= ~FTM_MODE_FTMEN_MASK;
+    base->SC = (base->SC & ~FTM_SC_PS_MASK) | FTM_SC_PS(ps);
+    base->MOD = mod;
+    base->CONTROLS[channel].CnV = 0;
+
+    edma_transfer_config_t transfer = {
+        .srcAddr = (uint32_t)pulses,
+        .destAddr = (uint32_t)&base->CONTROLS[channel].CnV,
+        .srcTransferSize = kEDMA_TransferSize2Bytes,
+        .destTransferSize = kEDMA_TransferSize2Bytes,
+        .srcOffset = 2,
+        .destOffset = 0,
+        .minorLoopBytes = 2,
+        .majorLoopCounts = length
+    };
+    EDMA_ResetChannel(DMA0, dma_channel);
+    EDMA_SetTransferConfig(DMA0, dma_channel, &transfer, NULL);
+    if (circular) {
+        DMA0->TCD[dma_channel].SLAST = -(int32_t)(2 * length);
+        DMA0->TCD[dma_channel].CSR &= ~DMA_CSR_DREQ_MASK;
+    }
+    EDMA_EnableChannelInterrupts(DMA0, dma_channel, kEDMA_MajorInterruptEnable | kEDMA_HalfInterruptEnable);
+
+    DMAMUX_DisableChannel(DMAMUX0, dma_channel);
+    DMAMUX_SetSource(DMAMUX0, dma_channel, pwm_sequence_dma_source[instance] + channel);
+    DMAMUX_EnableChannel(DMAMUX0, dma_channel);
+
+    NVIC_SetVector((IRQn_Type)(DMA0_IRQn + dma_channel), handler);
+    NVIC_EnableIRQ((IRQn_Type)(DMA0_IRQn + dma_channel));
+
+    sequence->running = 1;
+    EDMA_EnableChannelRequest(DMA0, dma_channel);
+    base->CONTROLS[channel].CnSC &= ~FTM_CnSC_CHF_MASK;
+    base->CONTROLS[channel].CnSC |= FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK;
+    return 0;
+}
+
+int pwmout_sequence_irq_handler(pwmout_t *obj)
+{
+    uint32_t instance = obj->pwm_name >> TPM_SHIFT;
+    uint32_t dma_channel = PWM_SEQUENCE_DMA_CHANNEL(instance);
+    pwm_sequence_t *sequence = &pwm_sequences[instance];
+    int events;
+
+    // The half and major interrupts share the flag, DONE tells them apart
+    DMA0->CINT = dma_channel;
+    if (DMA0->TCD[dma_channel].CSR & DMA_CSR_DONE_MASK) {
+        DMA0->CDNE = dma_channel;
+        events = PWMOUT_EVENT_COMPLETE;
+        if (!sequence->circular) {
+            pwmout_sequence_stop(obj);
+        }
+    } else {
+        events = PWMOUT_EVENT_HALF_COMPLETE;
+    }
+    return events & sequence->event_mask;
+}
+
+void pwmout_sequence_stop(pwmout_t *obj)
+{
+    uint32_t instance = obj->pwm_name >> TPM_SHIFT;
+    uint32_t channel = obj->pwm_name & 0xF;
+    uint32_t dma_channel = PWM_SEQUENCE_DMA_CHANNEL(instance);
+    pwm_sequence_t *sequence = &pwm_sequences[instance];
+
+    if (!sequence->running) {
+        return;
+    }
+    sequence->running = 0;
+
+    EDMA_DisableChannelRequest(DMA0, dma_channel);
+    ftm_addrs[instance]->CONTROLS[channel].CnSC &= ~(FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK);
+    NVIC_DisableIRQ((IRQn_Type)(DMA0_IRQn + dma_channel));
+    DMAMUX_DisableChannel(DMAMUX0, dma_channel);
+}
+
+uint8_t pwmout_sequence_active(pwmout_t *obj)
+{
+    return pwm_sequences[obj->pwm_name >> TPM_SHIFT].running;
+}
+
+#endif
+
 #endif
@@ -26,6 +26,12 @@
 #include "fsl_dspi.h"
 #include "peripheral_clock_defines.h"
 #include "PeripheralPins.h"
+#if DEVICE_SPISLAVE_ASYNCH
+#include "critical.h"
+#include "gpio_irq_api.h"
+#include "fsl_edma.h"
+#include "fsl_dmamux.h"
+#endif
 
 /* Array of SPI peripheral base address. */
 static SPI_Type *const spi_address[] = SPI_BASE_PTRS;
@@ -51,9 +57,16 @@ void spi_init(spi_t *obj, PinName mosi, PinName miso, PinName sclk, PinName ssel
     if (ssel != NC) {
         pinmap_pinout(ssel, PinMap_SPI_SSEL);
     }
+#if DEVICE_SPISLAVE_ASYNCH
+    obj->ssel = ssel;
+    obj->active = 0;
+#endif
 }
 
 void spi_free(spi_t *obj) {
+#if DEVICE_SPISLAVE_ASYNCH
+    spi_slave_abort_asynch(obj);
+#endif
     DSPI_Deinit(spi_address[obj->instance]);
 }
 
@@ -112,6 +125,43 @@ int spi_master_write(spi_t *obj, int value) {
     return rx_data & 0xffff;
 }
 
+int spi_master_block_write(spi_t *obj, const char *tx_buffer, int tx_length,
+                           char *rx_buffer, int rx_length, char write_fill) {
+    SPI_Type *base = spi_address[obj->instance];
+    int total = (tx_length > rx_length) ? tx_length : rx_length;
+    // frames pushed but not read back, never more than the rx FIFO holds
+    int fifo = FSL_FEATURE_DSPI_FIFO_SIZEn(base);
+    int sent = 0;
+    int received = 0;
+    dspi_command_data_config_t command;
+
+    DSPI_GetDefaultDataCommandConfig(&command);
+    DSPI_ClearStatusFlags(base, kDSPI_TxFifoFillRequestFlag | kDSPI_RxFifoDrainRequestFlag | kDSPI_EndOfQueueFlag);
+
+    while (received < total) {
+        while (sent < total && sent - received < fifo &&
+               (DSPI_GetStatusFlags(base) & kDSPI_TxFifoFillRequestFlag)) {
+            char out = (sent < tx_length) ? tx_buffer[sent] : write_fill;
+            command.isEndOfQueue = (sent == total - 1);
+            DSPI_MasterWriteData(base, &command, (uint8_t)out);
+            DSPI_ClearStatusFlags(base, kDSPI_TxFifoFillRequestFlag);
+            sent++;
+        }
+
+        if (spi_readable(obj)) {
+            char in = DSPI_ReadData(base);
+            DSPI_ClearStatusFlags(base, kDSPI_RxFifoDrainRequestFlag);
+            if (received < rx_length) {
+                rx_buffer[received] = in;
+            }
+            received++;
+        }
+    }
+    DSPI_ClearStatusFlags(base, kDSPI_EndOfQueueFlag);
+
+    return total;
+}
+
 int spi_slave_receive(spi_t *obj) {
     return spi_readable(obj);
 }
@@ -129,4 +179,233 @@ void spi_slave_write(spi_t *obj, int value) {
     DSPI_SlaveWriteDataBlocking(spi_address[obj->instance], (uint32_t)value);
 }
 
+#if DEVICE_SPISLAVE_ASYNCH
+
+/* SPI0 requests its own DMA for each direction, SPI1 and SPI2 share one.
+ * The RX channel writes the ring through, over and over, its major loop
+ * interrupt counting the wraps. The TX channel sends the reply, then
+ * scatter-gathers to a TCD sending SPI_FILL_CHAR which loops on itself.
+ * The channels are below the ones of PwmOut sequences. */
+#define SPI_SLAVE_RX_DMA_CHANNEL    10
+#define SPI_SLAVE_TX_DMA_CHANNEL    11
+
+static spi_t *spi_slave_obj;
+static bool spi_slave_dma_init;
+static const uint8_t spi_slave_fill = SPI_FILL_CHAR;
+/* TCDs must be 32 byte aligned, one of the two is */
+static edma_tcd_t spi_slave_fill_tcds[2];
+static edma_tcd_t *spi_slave_fill_tcd;
+
+static void spi_slave_load_reply(spi_t *obj)
+{
+    SPI_Type *base = spi_address[obj->instance];
+    edma_transfer_config_t transfer = {
+        .srcAddr = (uint32_t)obj->tx,
+        .destAddr = DSPI_SlaveGetTxRegisterAddress(base),
+        .srcTransferSize = kEDMA_TransferSize1Bytes,
+        .destTransferSize = kEDMA_TransferSize1Bytes,
+        .srcOffset = 1,
+        .destOffset = 0,
+        .minorLoopBytes = 1,
+        .majorLoopCounts = obj->tx_length
+    };
+
+    EDMA_DisableChannelRequest(DMA0, SPI_SLAVE_TX_DMA_CHANNEL);
+    while (DMA0->TCD[SPI_SLAVE_TX_DMA_CHANNEL].CSR & DMA_CSR_ACTIVE_MASK);
+
+    // Frames the DMA queued ahead are from the last reply
+    DSPI_StopTransfer(base);
+    DSPI_FlushFifo(base, true, false);
+
+    if (obj->tx_length == 0) {
+        transfer.srcAddr = (uint32_t)&spi_slave_fill;
+        transfer.srcOffset = 0;
+        transfer.majorLoopCounts = 1;
+    }
+    EDMA_ResetChannel(DMA0, SPI_SLAVE_TX_DMA_CHANNEL);
+    EDMA_SetTransferConfig(DMA0, SPI_SLAVE_TX_DMA_CHANNEL, &transfer, spi_slave_fill_tcd);
+
+    EDMA_EnableChannelRequest(DMA0, SPI_SLAVE_TX_DMA_CHANNEL);
+    DSPI_StartTransfer(base);
+}
+
+static void spi_slave_rx_dma_irq(void)
+{
+    DMA0->CINT = SPI_SLAVE_RX_DMA_CHANNEL;
+    spi_slave_obj->rx_wraps++;
+}
+
+// The master deselected the slave, the next transaction starts the reply over
+static void spi_slave_ssel_irq(uint32_t id, gpio_irq_event event)
+{
+    spi_t *obj = (spi_t *)id;
+
+    if (!obj->active || event != IRQ_RISE) {
+        return;
+    }
+    spi_slave_load_reply(obj);
+    obj->events |= SPI_EVENT_COMPLETE;
+    if (obj->event & SPI_EVENT_COMPLETE) {
+        ((void (*)(void))obj->handler)();
+    }
+}
+
+int spi_slave_start_asynch(spi_t *obj, void *rx, size_t rx_length, uint32_t handler, uint32_t event)
+{
+    SPI_Type *base = spi_address[obj->instance];
+    uint32_t bits = ((base->CTAR_SLAVE[0] & SPI_CTAR_SLAVE_FMSZ_MASK) >> SPI_CTAR_SLAVE_FMSZ_SHIFT) + 1;
+
+    if (obj->active || obj->instance != 0 || obj->ssel == NC || (base->MCR & SPI_MCR_MSTR_MASK) ||
+            bits > 8 || rx_length == 0 || rx_length > 0x7FFF) {
+        return -1;
+    }
+
+    if (!spi_slave_dma_init) {
+        edma_config_t config;
+        EDMA_GetDefaultConfig(&config);
+        EDMA_Init(DMA0, &config);
+        DMAMUX_Init(DMAMUX0);
+
+        edma_transfer_config_t fill = {
+            .srcAddr = (uint32_t)&spi_slave_fill,
+            .destAddr = DSPI_SlaveGetTxRegisterAddress(base),
+            .srcTransferSize = kEDMA_TransferSize1Bytes,
+            .destTransferSize = kEDMA_TransferSize1Bytes,
+            .srcOffset = 0,
+            .destOffset = 0,
+            .minorLoopBytes = 1,
+            .majorLoopCounts = 1
+        };
+        spi_slave_fill_tcd = (edma_tcd_t *)((uint32_t)&spi_slave_fill_tcds[1] & ~0x1FU);
+        EDMA_TcdReset(spi_slave_fill_tcd);
+        EDMA_TcdSetTransferConfig(spi_slave_fill_tcd, &fill, spi_slave_fill_tcd);
+        spi_slave_dma_init = true;
+    }
+
+    spi_slave_obj = obj;
+    obj->handler = handler;
+    obj->event = event;
+    obj->events = 0;
+    obj->rx = (uint8_t *)rx;
+    obj->rx_length = rx_length;
+    obj->rx_wraps = 0;
+
+    DSPI_StopTransfer(base);
+    DSPI_FlushFifo(base, true, true);
+    DSPI_ClearStatusFlags(base, kDSPI_AllStatusFlag);
+
+    edma_transfer_config_t transfer = {
+        .srcAddr = DSPI_GetRxRegisterAddress(base),
+        .destAddr = (uint32_t)rx,
+        .srcTransferSize = kEDMA_TransferSize1Bytes,
+        .destTransferSize = kEDMA_TransferSize1Bytes,
+        .srcOffset = 0,
+        .destOffset = 1,
+        .minorLoopBytes = 1,
+        .majorLoopCounts = rx_length
+    };
+    EDMA_ResetChannel(DMA0, SPI_SLAVE_RX_DMA_CHANNEL);
+    EDMA_SetTransferConfig(DMA0, SPI_SLAVE_RX_DMA_CHANNEL, &transfer, NULL);
+    DMA0->TCD[SPI_SLAVE_RX_DMA_CHANNEL].DLAST_SGA = -(int32_t)rx_length;
+    DMA0->TCD[SPI_SLAVE_RX_DMA_CHANNEL].CSR &= ~DMA_CSR_DREQ_MASK;
+    EDMA_EnableChannelInterrupts(DMA0, SPI_SLAVE_RX_DMA_CHANNEL, kEDMA_MajorInterruptEnable);
+
+    DMAMUX_DisableChannel(DMAMUX0, SPI_SLAVE_RX_DMA_CHANNEL);
+    DMAMUX_SetSource(DMAMUX0, SPI_SLAVE_RX_DMA_CHANNEL, kDmaRequestMux0SPI0Rx & 0xFF);
+    DMAMUX_EnableChannel(DMAMUX0, SPI_SLAVE_RX_DMA_CHANNEL);
+    DMAMUX_DisableChannel(DMAMUX0, SPI_SLAVE_TX_DMA_CHANNEL);
+    DMAMUX_SetSource(DMAMUX0, SPI_SLAVE_TX_DMA_CHANNEL, kDmaRequestMux0SPI0Tx & 0xFF);
+    DMAMUX_EnableChannel(DMAMUX0, SPI_SLAVE_TX_DMA_CHANNEL);
+
+    NVIC_SetVector((IRQn_Type)(DMA0_IRQn + SPI_SLAVE_RX_DMA_CHANNEL), (uint32_t)spi_slave_rx_dma_irq);
+    NVIC_EnableIRQ((IRQn_Type)(DMA0_IRQn + SPI_SLAVE_RX_DMA_CHANNEL));
+
+    gpio_irq_init(&obj->ssel_irq, obj->ssel, spi_slave_ssel_irq, (uint32_t)obj);
+    gpio_irq_set(&obj->ssel_irq, IRQ_RISE, 1);
+
+    obj->active = 1;
+    EDMA_EnableChannelRequest(DMA0, SPI_SLAVE_RX_DMA_CHANNEL);
+    DSPI_EnableDMA(base, kDSPI_RxDmaEnable | kDSPI_TxDmaEnable);
+    spi_slave_load_reply(obj);
+    return 0;
+}
+
+void spi_slave_reply_asynch(spi_t *obj, const void *tx, size_t tx_length)
+{
+    core_util_critical_section_enter();
+    obj->tx = (const uint8_t *)tx;
+    obj->tx_length = (tx != NULL && tx_length <= 0x7FFF) ? tx_length : 0;
+    if (obj->active) {
+        spi_slave_load_reply(obj);
+    }
+    core_util_critical_section_exit();
+}
+
+uint32_t spi_slave_received(spi_t *obj)
+{
+    uint32_t pending;
+    uint32_t citer;
+    uint32_t received;
+
+    if (!obj->active) {
+        return 0;
+    }
+
+    /* The channel reloads CITER and raises its interrupt at each wrap, which
+     * the loop reads on either side of */
+    core_util_critical_section_enter();
+    pending = DMA0->INT & (1U << SPI_SLAVE_RX_DMA_CHANNEL);
+    citer = DMA0->TCD[SPI_SLAVE_RX_DMA_CHANNEL].CITER_ELINKNO & DMA_CITER_ELINKNO_CITER_MASK;
+    if (!pending && (DMA0->INT & (1U << SPI_SLAVE_RX_DMA_CHANNEL))) {
+        pending = 1;
+        citer = DMA0->TCD[SPI_SLAVE_RX_DMA_CHANNEL].CITER_ELINKNO & DMA_CITER_ELINKNO_CITER_MASK;
+    }
+    received = (obj->rx_wraps + (pending ? 1 : 0)) * obj->rx_length + (obj->rx_length - citer);
+    core_util_critical_section_exit();
+    return received;
+}
+
+uint32_t spi_slave_irq_handler_asynch(spi_t *obj)
+{
+    uint32_t events;
+
+    core_util_critical_section_enter();
+    events = obj->events & obj->event;
+    obj->events = 0;
+    core_util_critical_section_exit();
+    return events;
+}
+
+uint8_t spi_slave_active(spi_t *obj)
+{
+    return obj->active;
+}
+
+void spi_slave_abort_asynch(spi_t *obj)
+{
+    SPI_Type *base = spi_address[obj->instance];
+
+    if (!obj->active) {
+        return;
+    }
+    obj->active = 0;
+
+    gpio_irq_set(&obj->ssel_irq, IRQ_RISE, 0);
+    gpio_irq_free(&obj->ssel_irq);
+
+    DSPI_DisableDMA(base, kDSPI_RxDmaEnable | kDSPI_TxDmaEnable);
+    EDMA_DisableChannelRequest(DMA0, SPI_SLAVE_RX_DMA_CHANNEL);
+    EDMA_DisableChannelRequest(DMA0, SPI_SLAVE_TX_DMA_CHANNEL);
+    NVIC_DisableIRQ((IRQn_Type)(DMA0_IRQn + SPI_SLAVE_RX_DMA_CHANNEL));
+    DMAMUX_DisableChannel(DMAMUX0, SPI_SLAVE_RX_DMA_CHANNEL);
+    DMAMUX_DisableChannel(DMAMUX0, SPI_SLAVE_TX_DMA_CHANNEL);
+    DMA0->CINT = SPI_SLAVE_RX_DMA_CHANNEL;
+
+    DSPI_FlushFifo(base, true, true);
+    DSPI_ClearStatusFlags(base, kDSPI_AllStatusFlag);
+    spi_slave_obj = NULL;
+}
+
+#endif
+
 #endif
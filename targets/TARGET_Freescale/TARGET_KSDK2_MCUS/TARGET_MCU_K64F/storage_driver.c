@@ -233,6 +233,7 @@ struct mtd_k64f_data {
     size_t                 sizeofCurrentOperation;
     size_t                 amountLeftToOperate;
     const uint8_t         *currentOperatingData;
+    bool                   programSectionAvailable; /* sampled at the start of each program-data; see programSectionAvailable() */
 } mtd_k64f_data;
 
 /*
@@ -438,6 +439,21 @@ static inline void clearErrorStatusBits()
     }
 }
 
+/**
+ * Program-section stages its data in the FlexRAM, which is possible only while
+ * the FlexRAM is available as traditional RAM--i.e. not serving as the EEPROM
+ * of an EEPROM-partitioned FlexNVM. Otherwise the command fails with an access
+ * error, and programming has to proceed a phrase at a time.
+ */
+static inline bool programSectionAvailable(void)
+{
+#ifdef USING_KSDK2
+    return ((FTFx->FCNFG & FTFx_FCNFG_RAMRDY_MASK) != 0);
+#else
+    return (BR_FTFE_FCNFG_RAMRDY((uintptr_t)FTFE) != 0);
+#endif
+}
+
 /* The following functions are only needed if using interrupt-driven operation. */
 #if ASYNC_OPS
 static inline void enableCommandCompletionInterrupt(void)
@@ -644,7 +660,8 @@ static inline size_t sizeofLargestProgramSection(uint64_t addr, size_t size)
 static inline void setupNextProgramData(struct mtd_k64f_data *context)
 {
     if ((context->amountLeftToOperate == PROGRAM_PHRASE_SIZEOF_INLINE_DATA) ||
-        ((context->currentOperatingStorageAddress % SIZEOF_DOUBLE_PHRASE) == PROGRAM_PHRASE_SIZEOF_INLINE_DATA)) {
+        ((context->currentOperatingStorageAddress % SIZEOF_DOUBLE_PHRASE) == PROGRAM_PHRASE_SIZEOF_INLINE_DATA) ||
+        !context->programSectionAvailable) {
         setup8ByteWrite(context->currentOperatingStorageAddress, context->currentOperatingData);
         tr_debug("setupNextProgramData: W8, [%lu]", (uint32_t)context->currentOperatingStorageAddress);
 
@@ -1060,6 +1077,7 @@ static int32_t programData(uint64_t addr, const void *data, uint32_t size)
     context->amountLeftToOperate            = size;
     context->currentOperatingData           = data;
     context->currentOperatingStorageAddress = addr;
+    context->programSectionAvailable        = programSectionAvailable();
 
     clearErrorStatusBits();
     setupNextProgramData(context);
@@ -1166,6 +1184,9 @@ static ARM_STORAGE_STATUS getStatus(void)
 static int32_t getInfo(ARM_STORAGE_INFO *infoP)
 {
     memcpy(infoP, &info, sizeof(ARM_STORAGE_INFO));
+    if (!programSectionAvailable()) {
+        infoP->optimal_program_unit = PROGRAM_UNIT; /* programming proceeds phrase by phrase. */
+    }
 
     return ARM_DRIVER_OK;
 }
@@ -0,0 +1,48 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "crc_api.h"
+
+#if DEVICE_CRC
+
+#include "cmsis.h"
+#include "fsl_crc.h"
+#include "critical.h"
+
+/* The unit is started from the remainder in its own (unreflected) form, which
+ * is also what it returns as an intermediate checksum: the remainder of the
+ * reflected CRC-32 with its bits reversed. */
+uint32_t crc32_hw_update(uint32_t remainder, const uint32_t *data, size_t words)
+{
+    crc_config_t config;
+
+    config.polynomial         = 0x04C11DB7U;
+    config.seed               = __RBIT(remainder);
+    config.reflectIn          = true;
+    config.reflectOut         = false;
+    config.complementChecksum = false;
+    config.crcBits            = kCrcBits32;
+    config.crcResult          = kCrcIntermediateChecksum;
+
+    core_util_critical_section_enter();
+    CRC_Init(CRC0, &config);
+    CRC_WriteData(CRC0, (const uint8_t *)data, words * sizeof(uint32_t));
+    remainder = __RBIT(CRC_Get32bitResult(CRC0));
+    core_util_critical_section_exit();
+
+    return remainder;
+}
+
+#endif
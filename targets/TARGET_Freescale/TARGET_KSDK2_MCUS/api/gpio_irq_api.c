@@ -24,11 +24,13 @@
 #include "fsl_gpio.h"
 #include "fsl_port.h"
 #include "mbed_error.h"
+#include "critical.h"
 
 #define CHANNEL_NUM    160
 
 static uint32_t channel_ids[CHANNEL_NUM] = {0};
-static gpio_irq_handler irq_handler;
+/* Per channel, as HAL drivers like the SPI slave hook pins besides InterruptIn */
+static gpio_irq_handler channel_handlers[CHANNEL_NUM];
 /* Array of PORT peripheral base address. */
 static PORT_Type *const port_addrs[] = PORT_BASE_PTRS;
 /* Array of PORT IRQ number. */
@@ -72,7 +74,7 @@ static void handle_interrupt_in(PortName port, int ch_base) {
                     break;
             }
             if (event != IRQ_NONE) {
-                irq_handler(id, event);
+                channel_handlers[ch_base + i](id, event);
             }
         }
     }
@@ -90,7 +92,6 @@ int gpio_irq_init(gpio_irq_t *obj, PinName pin, gpio_irq_handler handler, uint32
         return -1;
     }
 
-    irq_handler = handler;
     obj->port = pin >> GPIO_PORT_SHIFT;
     obj->pin = pin & 0x7F;
 
@@ -126,6 +127,7 @@ int gpio_irq_init(gpio_irq_t *obj, PinName pin, gpio_irq_handler handler, uint32
     NVIC_EnableIRQ(port_irqs[obj->port]);
 
     obj->ch = ch_base + obj->pin;
+    channel_handlers[obj->ch] = handler;
     channel_ids[obj->ch] = id;
 
     return 0;
@@ -184,4 +186,42 @@ void gpio_irq_disable(gpio_irq_t *obj) {
     NVIC_DisableIRQ(port_irqs[obj->port]);
 }
 
+#if defined(FSL_FEATURE_PORT_HAS_DIGITAL_FILTER) && FSL_FEATURE_PORT_HAS_DIGITAL_FILTER
+/* The filter runs from the 1 kHz LPO, up to 31 cycles wide. The clock and
+ * the width are shared by the port and may only change while no pin of the
+ * port is filtered. */
+#define FILTER_CYCLE_US     1000
+#define FILTER_MAX_CYCLES   (PORT_DFWR_FILT_MASK >> PORT_DFWR_FILT_SHIFT)
+
+uint32_t gpio_irq_filter(gpio_irq_t *obj, uint32_t us) {
+    PORT_Type *base = port_addrs[obj->port];
+    uint32_t pin_mask = 1u << obj->pin;
+
+    if (us == 0) {
+        core_util_critical_section_enter();
+        PORT_EnablePinsDigitalFilter(base, pin_mask, false);
+        core_util_critical_section_exit();
+        return 0;
+    }
+
+    uint32_t cycles = (us + FILTER_CYCLE_US - 1) / FILTER_CYCLE_US;
+    if (cycles > FILTER_MAX_CYCLES) {
+        cycles = FILTER_MAX_CYCLES;
+    }
+
+    port_digital_filter_config_t config = {
+        .digitalFilterWidth = cycles,
+        .clockSource = kPORT_LpoClock,
+    };
+    core_util_critical_section_enter();
+    uint32_t filtered = base->DFER;
+    base->DFER = 0;
+    PORT_SetDigitalFilterConfig(base, &config);
+    base->DFER = filtered | pin_mask;
+    core_util_critical_section_exit();
+
+    return cycles * FILTER_CYCLE_US;
+}
+#endif
+
 #endif
@@ -28,6 +28,43 @@ static inline int gpio_is_connected(const gpio_t *obj) {
     return obj->pin != (PinName)NC;
 }
 
+/* Pin-bound access, see gpio_api.h: with a constant pin the switch folds to
+ * the address of the port, and writes and toggles to a single store to its
+ * set, clear or toggle register */
+#define GPIO_FAST 1
+
+static inline GPIO_Type *gpio_fast_port(PinName pin) {
+    switch ((uint32_t)pin >> GPIO_PORT_SHIFT) {
+        case 0:
+            return (GPIO_Type *)GPIOA_BASE;
+        case 1:
+            return (GPIO_Type *)GPIOB_BASE;
+        case 2:
+            return (GPIO_Type *)GPIOC_BASE;
+        case 3:
+            return (GPIO_Type *)GPIOD_BASE;
+        default:
+            return (GPIO_Type *)GPIOE_BASE;
+    }
+}
+
+static inline void gpio_fast_write(PinName pin, int value) {
+    uint32_t mask = 1UL << ((uint32_t)pin & 0xFF);
+    if (value) {
+        gpio_fast_port(pin)->PSOR = mask;
+    } else {
+        gpio_fast_port(pin)->PCOR = mask;
+    }
+}
+
+static inline int gpio_fast_read(PinName pin) {
+    return (gpio_fast_port(pin)->PDIR >> ((uint32_t)pin & 0xFF)) & 1;
+}
+
+static inline void gpio_fast_toggle(PinName pin) {
+    gpio_fast_port(pin)->PTOR = 1UL << ((uint32_t)pin & 0xFF);
+}
+
 #ifdef __cplusplus
 }
 #endif
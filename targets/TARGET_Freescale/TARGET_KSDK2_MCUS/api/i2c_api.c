@@ -24,6 +24,9 @@
 #include "fsl_port.h"
 #include "peripheral_clock_defines.h"
 #include "PeripheralPins.h"
+#if DEVICE_I2CSLAVE_ASYNCH
+#include "critical.h"
+#endif
 
 /* 7 bit IIC addr - R/W flag not included */
 static int i2c_address = 0;
@@ -37,6 +40,9 @@ void i2c_init(i2c_t *obj, PinName sda, PinName scl) {
     uint32_t i2c_scl = pinmap_peripheral(scl, PinMap_I2C_SCL);
     obj->instance = pinmap_merge(i2c_sda, i2c_scl);
     obj->next_repeated_start = 0;
+#if DEVICE_I2CSLAVE_ASYNCH
+    obj->active = 0;
+#endif
     MBED_ASSERT((int)obj->instance != NC);
 
     i2c_master_config_t master_config;
@@ -237,4 +243,122 @@ void i2c_slave_address(i2c_t *obj, int idx, uint32_t address, uint32_t mask) {
 }
 #endif
 
+#if DEVICE_I2CSLAVE_ASYNCH
+/* The I2C has no FIFO and a byte at a time to DMA would still take an
+ * interrupt at each address match and direction change, so the interrupt
+ * moves the bytes. STOP and repeated start detection, which ends the
+ * transfers, needs FSL_FEATURE_I2C_HAS_START_STOP_DETECT. */
+static IRQn_Type const i2c_irqs[] = I2C_IRQS;
+
+static uint8_t i2c_slave_next_tx(i2c_t *obj) {
+    return (obj->tx_index < obj->tx_length) ? obj->tx[obj->tx_index++] : 0xFF;
+}
+
+int i2c_slave_start_asynch(i2c_t *obj, void *rx, size_t rx_length, uint32_t handler, uint32_t event) {
+    I2C_Type *base = i2c_addrs[obj->instance];
+
+    if (obj->active || rx == NULL || rx_length == 0 ||
+            !(base->C1 & I2C_C1_IICEN_MASK) || (base->C1 & I2C_C1_MST_MASK)) {
+        return -1;
+    }
+
+    obj->event = event;
+    obj->events = 0;
+    obj->rx = (uint8_t *)rx;
+    obj->rx_length = rx_length;
+    obj->rx_index = 0;
+    obj->received = 0;
+    obj->transmitting = 0;
+    obj->in_transfer = 0;
+    obj->active = 1;
+
+    NVIC_SetVector(i2c_irqs[obj->instance], handler);
+    NVIC_EnableIRQ(i2c_irqs[obj->instance]);
+    base->FLT |= I2C_FLT_SSIE_MASK | I2C_FLT_STARTF_MASK | I2C_FLT_STOPF_MASK;
+    base->C1 |= I2C_C1_IICIE_MASK;
+    return 0;
+}
+
+void i2c_slave_reply_asynch(i2c_t *obj, const void *tx, size_t tx_length) {
+    core_util_critical_section_enter();
+    obj->tx = (const uint8_t *)tx;
+    obj->tx_length = (tx != NULL) ? tx_length : 0;
+    core_util_critical_section_exit();
+}
+
+uint32_t i2c_slave_received(i2c_t *obj) {
+    return obj->received;
+}
+
+uint32_t i2c_slave_irq_handler_asynch(i2c_t *obj) {
+    I2C_Type *base = i2c_addrs[obj->instance];
+    uint8_t flt = base->FLT;
+    uint8_t status;
+    uint32_t events = 0;
+
+    // STARTF and STOPF are cleared before IICIF, or IICIF can't be
+    if (flt & (I2C_FLT_STARTF_MASK | I2C_FLT_STOPF_MASK)) {
+        base->FLT = flt;
+        base->S = I2C_S_IICIF_MASK;
+        if (obj->in_transfer) {
+            events |= obj->transmitting ? I2C_EVENT_SLAVE_TRANSMITTED : I2C_EVENT_SLAVE_RECEIVED;
+            obj->in_transfer = 0;
+        }
+        // The address following a repeated start may be in already
+        if (!(base->S & I2C_S_IAAS_MASK)) {
+            return events & obj->event;
+        }
+    }
+
+    status = base->S;
+    base->S = I2C_S_IICIF_MASK | I2C_S_ARBL_MASK;
+
+    if (status & I2C_S_IAAS_MASK) {
+        obj->in_transfer = 1;
+        if (status & I2C_S_SRW_MASK) {
+            obj->transmitting = 1;
+            obj->tx_index = 0;
+            base->C1 |= I2C_C1_TX_MASK;
+            base->D = i2c_slave_next_tx(obj);
+        } else {
+            obj->transmitting = 0;
+            base->C1 &= ~(I2C_C1_TX_MASK | I2C_C1_TXAK_MASK);
+            /* Read dummy to release the bus. */
+            base->D;
+        }
+    } else if (obj->transmitting) {
+        if (status & I2C_S_RXAK_MASK) {
+            /* The master NAKed its last byte, release the bus. */
+            base->C1 &= ~(I2C_C1_TX_MASK | I2C_C1_TXAK_MASK);
+            base->D;
+        } else {
+            base->D = i2c_slave_next_tx(obj);
+        }
+    } else if (obj->in_transfer) {
+        obj->rx[obj->rx_index] = base->D;
+        if (++obj->rx_index == obj->rx_length) {
+            obj->rx_index = 0;
+        }
+        obj->received++;
+    }
+    return events & obj->event;
+}
+
+uint8_t i2c_slave_active(i2c_t *obj) {
+    return obj->active;
+}
+
+void i2c_slave_abort_asynch(i2c_t *obj) {
+    I2C_Type *base = i2c_addrs[obj->instance];
+
+    if (!obj->active) {
+        return;
+    }
+    base->C1 &= ~I2C_C1_IICIE_MASK;
+    base->FLT = (base->FLT & ~I2C_FLT_SSIE_MASK) | I2C_FLT_STARTF_MASK | I2C_FLT_STOPF_MASK;
+    NVIC_DisableIRQ(i2c_irqs[obj->instance]);
+    obj->active = 0;
+}
+#endif
+
 #endif
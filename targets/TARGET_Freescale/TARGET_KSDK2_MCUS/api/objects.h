@@ -20,6 +20,9 @@
 #include "PortNames.h"
 #include "PeripheralNames.h"
 #include "PinNames.h"
+#if DEVICE_FLASH
+#include "fsl_flash.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,10 +54,37 @@ struct analogin_s {
 struct i2c_s {
     uint32_t instance;
     uint8_t next_repeated_start;
+#if DEVICE_I2CSLAVE_ASYNCH
+    uint32_t event;
+    uint32_t events;
+    uint8_t *rx;
+    uint32_t rx_length;
+    uint32_t rx_index;
+    volatile uint32_t received;
+    const uint8_t *tx;
+    uint32_t tx_length;
+    uint32_t tx_index;
+    uint8_t transmitting;
+    uint8_t in_transfer;
+    volatile uint8_t active;
+#endif
 };
 
 struct spi_s {
     uint32_t instance;
+#if DEVICE_SPISLAVE_ASYNCH
+    PinName ssel;
+    struct gpio_irq_s ssel_irq;
+    uint32_t handler;
+    uint32_t event;
+    volatile uint32_t events;
+    uint8_t *rx;
+    uint32_t rx_length;
+    volatile uint32_t rx_wraps;
+    const uint8_t *tx;
+    uint32_t tx_length;
+    volatile uint8_t active;
+#endif
 };
 
 struct dac_s {
@@ -65,6 +95,18 @@ struct trng_s {
     uint8_t dummy;
 };
 
+#if DEVICE_FLASH
+struct flash_s {
+    flash_config_t config;
+#if DEVICE_FLASH_ASYNCH
+    uint8_t command;        /* of the operation running, 0 for none */
+    uint32_t address;       /* of the next phrase programmed */
+    const uint8_t *data;
+    uint32_t remaining;
+#endif
+};
+#endif
+
 #include "gpio_object.h"
 
 #ifdef __cplusplus
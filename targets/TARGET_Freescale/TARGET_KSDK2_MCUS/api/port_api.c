@@ -19,6 +19,7 @@
 
 #include "pinmap.h"
 #include "gpio_api.h"
+#include "critical.h"
 
 /* Array of GPIO peripheral base address. */
 static GPIO_Type *const port_addrs[] = GPIO_BASE_PTRS;
@@ -27,6 +28,14 @@ PinName port_pin(PortName port, int pin_n) {
     return (PinName)((port << GPIO_PORT_SHIFT) | pin_n);
 }
 
+int port_pin_bit(PinName pin, PortName *port) {
+    if (pin == (PinName)NC) {
+        return -1;
+    }
+    *port = (PortName)(pin >> GPIO_PORT_SHIFT);
+    return pin & 0x1F;
+}
+
 void port_init(port_t *obj, PortName port, int mask, PinDirection dir) {
     obj->port = port;
     obj->mask = mask;
@@ -68,9 +77,12 @@ void port_dir(port_t *obj, PinDirection dir) {
 
 void port_write(port_t *obj, int value) {
     GPIO_Type *base = port_addrs[obj->port];
-    uint32_t input = base->PDIR & ~obj->mask;
 
-    base->PDOR = (input | (uint32_t)(value & obj->mask));
+    // One PDOR write changes the pins together, the critical section keeps
+    // the other pins of the port from changing in between
+    core_util_critical_section_enter();
+    base->PDOR = (base->PDOR & ~obj->mask) | (uint32_t)(value & obj->mask);
+    core_util_critical_section_exit();
 }
 
 int port_read(port_t *obj) {
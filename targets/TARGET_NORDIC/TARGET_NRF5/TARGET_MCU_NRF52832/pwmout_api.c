@@ -77,11 +77,25 @@ typedef struct
     float    duty;
 } pwm_signal_t; /// PWM signal description type
 
+#if DEVICE_PWMOUT_ASYNCH
+typedef struct
+{
+    void          (*handler)(void);
+    uint32_t        event_mask;
+    volatile uint32_t events;
+    volatile bool   running;
+    bool            circular;
+} pwm_sequence_t; /// PWM sequence playback state
+#endif
+
 typedef struct
 {
     nrf_drv_pwm_t * p_pwm_driver;
     pwm_signal_t signal;
     volatile nrf_pwm_values_common_t seq_values[1];
+#if DEVICE_PWMOUT_ASYNCH
+    pwm_sequence_t sequence;
+#endif
 } pwm_t; /// internal PWM instance support type
 
 static pwm_t m_pwm[PWM_INSTANCE_COUNT] =
@@ -318,6 +332,11 @@ static void internal_pwmout_exe(pwmout_t *obj, bool new_period, bool initializat
     ret_code_t                ret_code;
     
     p_pwm_signal = &(((pwm_t*)obj->pwm_struct)->signal);
+
+#if DEVICE_PWMOUT_ASYNCH
+    // the regular output takes over from a sequence
+    ((pwm_t*)obj->pwm_struct)->sequence.running = false;
+#endif
     
     if (NRF_SUCCESS == pulsewidth_us_set_get(p_pwm_signal->period_us * 16, // base clk for PWM is 16 MHz
                                              p_pwm_signal->duty_us * 16,   // base clk for PWM is 16 MHz
@@ -373,4 +392,202 @@ static void internal_pwmout_exe(pwmout_t *obj, bool new_period, bool initializat
     
 }
 
+#if DEVICE_PWMOUT_ASYNCH
+
+/* The PWM peripheral plays sequences from RAM by itself. The two halves of
+ * the buffer are its two sequences, which tells the halves apart. The
+ * driver handler has no context, hence one per instance. */
+static void pwm_sequence_event(pwm_t * p_pwm, nrf_drv_pwm_evt_type_t event_type)
+{
+    pwm_sequence_t * p_sequence = &p_pwm->sequence;
+
+    if (!p_sequence->running)
+    {
+        return;
+    }
+
+    switch (event_type)
+    {
+        case NRF_DRV_PWM_EVT_END_SEQ0:
+            p_sequence->events |= PWMOUT_EVENT_HALF_COMPLETE;
+            break;
+        case NRF_DRV_PWM_EVT_END_SEQ1:
+        case NRF_DRV_PWM_EVT_FINISHED:
+            p_sequence->events |= PWMOUT_EVENT_COMPLETE;
+            break;
+        default:
+            return;
+    }
+
+    if (p_sequence->events & p_sequence->event_mask)
+    {
+        p_sequence->handler();
+    }
+}
+
+#if PWM0_ENABLED
+static void pwm_sequence_handler_0(nrf_drv_pwm_evt_type_t event_type)
+{
+    pwm_sequence_event(&m_pwm[PWM0_INSTANCE_INDEX], event_type);
+}
+#endif
+#if PWM1_ENABLED
+static void pwm_sequence_handler_1(nrf_drv_pwm_evt_type_t event_type)
+{
+    pwm_sequence_event(&m_pwm[PWM1_INSTANCE_INDEX], event_type);
+}
+#endif
+#if PWM2_ENABLED
+static void pwm_sequence_handler_2(nrf_drv_pwm_evt_type_t event_type)
+{
+    pwm_sequence_event(&m_pwm[PWM2_INSTANCE_INDEX], event_type);
+}
+#endif
+
+static const nrf_drv_pwm_handler_t m_pwm_sequence_handler[PWM_INSTANCE_COUNT] =
+{
+#if PWM0_ENABLED
+    pwm_sequence_handler_0,
+#endif
+#if PWM1_ENABLED
+    pwm_sequence_handler_1,
+#endif
+#if PWM2_ENABLED
+    pwm_sequence_handler_2
+#endif
+};
+
+static ret_code_t pwm_sequence_timing(uint32_t hz, pulsewidth_set_t * p_settings)
+{
+    if (hz == 0 || hz > 16000000)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    return pulsewidth_us_set_get(16000000 / hz, 0, p_settings); // base clk for PWM is 16 MHz
+}
+
+uint16_t pwmout_sequence_pulse(pwmout_t *obj, uint32_t hz, float percent)
+{
+    pulsewidth_set_t pulsewidth_set;
+
+    if (NRF_SUCCESS != pwm_sequence_timing(hz, &pulsewidth_set))
+    {
+        return 0;
+    }
+    if (percent < 0)
+    {
+        percent = 0;
+    }
+    else if (percent > 1)
+    {
+        percent = 1;
+    }
+    // same polarity as the regular output
+    return (uint16_t)((float)pulsewidth_set.period_hwu * percent) | 0x8000;
+}
+
+int pwmout_sequence_start(pwmout_t *obj, const uint16_t *pulses, size_t length, uint32_t hz, uint8_t circular, uint32_t handler, uint32_t event)
+{
+    pwm_t                   * p_pwm = (pwm_t*)obj->pwm_struct;
+    pwm_sequence_t          * p_sequence = &p_pwm->sequence;
+    pulsewidth_set_t          pulsewidth_set;
+    ret_code_t                ret_code;
+
+    // EasyDMA reads RAM only, each half is one sequence of the peripheral
+    if (p_sequence->running || length < 2 || length > 2 * 0x7FFF || !nrf_drv_is_in_RAM(pulses) ||
+        NRF_SUCCESS != pwm_sequence_timing(hz, &pulsewidth_set))
+    {
+        return -1;
+    }
+
+    p_sequence->handler    = (void (*)(void))handler;
+    p_sequence->event_mask = event;
+    p_sequence->events     = 0;
+    p_sequence->circular   = circular;
+
+    nrf_drv_pwm_config_t config0 =
+    {
+        .output_pins =
+        {
+            obj->pin | NRF_DRV_PWM_PIN_INVERTED, // channel 0
+            NRF_DRV_PWM_PIN_NOT_USED,            // channel 1
+            NRF_DRV_PWM_PIN_NOT_USED,            // channel 2
+            NRF_DRV_PWM_PIN_NOT_USED,            // channel 3
+        },
+        .irq_priority = APP_IRQ_PRIORITY_LOW,
+        .base_clock   = pulsewidth_set.pwm_clk,
+        .count_mode   = NRF_PWM_MODE_UP,
+        .top_value    = pulsewidth_set.period_hwu,
+        .load_mode    = NRF_PWM_LOAD_COMMON,
+        .step_mode    = NRF_PWM_STEP_AUTO
+    };
+
+    nrf_drv_pwm_uninit(p_pwm->p_pwm_driver);
+    ret_code = nrf_drv_pwm_init(p_pwm->p_pwm_driver, &config0, m_pwm_sequence_handler[obj->pwm_channel]);
+    if (ret_code != NRF_SUCCESS)
+    {
+        return -1;
+    }
+
+    const nrf_pwm_sequence_t seq0 =
+    {
+        .values.p_common = (nrf_pwm_values_common_t*) pulses,
+        .length          = length / 2,
+        .repeats         = 0,
+        .end_delay       = 0
+    };
+    const nrf_pwm_sequence_t seq1 =
+    {
+        .values.p_common = (nrf_pwm_values_common_t*) (pulses + length / 2),
+        .length          = length - length / 2,
+        .repeats         = 0,
+        .end_delay       = 0
+    };
+
+    // without the stop flag the last pulse width is held at the end
+    uint32_t flags = NRF_DRV_PWM_FLAG_SIGNAL_END_SEQ0;
+    if (circular)
+    {
+        flags |= NRF_DRV_PWM_FLAG_LOOP | NRF_DRV_PWM_FLAG_SIGNAL_END_SEQ1 | NRF_DRV_PWM_FLAG_NO_EVT_FINISHED;
+    }
+
+    p_sequence->running = true;
+    nrf_drv_pwm_complex_playback(p_pwm->p_pwm_driver, &seq0, &seq1, 1, flags);
+    return 0;
+}
+
+int pwmout_sequence_irq_handler(pwmout_t *obj)
+{
+    pwm_sequence_t * p_sequence = &(((pwm_t*)obj->pwm_struct)->sequence);
+
+    uint32_t events = p_sequence->events;
+    p_sequence->events = 0;
+    if (!p_sequence->circular && (events & PWMOUT_EVENT_COMPLETE))
+    {
+        p_sequence->running = false;
+    }
+    return events & p_sequence->event_mask;
+}
+
+void pwmout_sequence_stop(pwmout_t *obj)
+{
+    pwm_t * p_pwm = (pwm_t*)obj->pwm_struct;
+
+    if (!p_pwm->sequence.running)
+    {
+        return;
+    }
+    p_pwm->sequence.running = false;
+
+    // the PWM generation stops, the pin goes to its idle level
+    nrf_drv_pwm_stop(p_pwm->p_pwm_driver, false);
+}
+
+uint8_t pwmout_sequence_active(pwmout_t *obj)
+{
+    return ((pwm_t*)obj->pwm_struct)->sequence.running;
+}
+
+#endif
+
 #endif // DEVICE_PWMOUT
@@ -37,6 +37,7 @@
 #include "NUC472_442.h"
 #include "toolchain.h"
 #include "mbed_assert.h"
+#include "critical.h"
 
 //static int aes_init_done = 0;
 
@@ -92,15 +93,16 @@ static void swapInitVector(unsigned char iv[16])
 //}
 
 // AES available channel 0~3
-static unsigned char channel_flag[4]={0x00,0x00,0x00,0x00};  // 0: idle, 1: busy
+static uint8_t channel_flag[4]={0x00,0x00,0x00,0x00};  // 0: idle, 1: busy
 static int channel_alloc()
 {
 	int i;
 	for(i=0; i< (int)sizeof(channel_flag); i++)
 	{
-		if( channel_flag[i] == 0x00 )
+		// contexts are set up by several threads
+		uint8_t idle = 0x00;
+		if( core_util_atomic_cas_u8(&channel_flag[i], &idle, 0x01) )
 		{
-			channel_flag[i] = 0x01;
 			return i;
 		}	
 	}
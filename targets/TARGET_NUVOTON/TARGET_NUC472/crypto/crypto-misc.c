@@ -17,12 +17,13 @@
 
 #include "cmsis.h"
 #include "mbed_assert.h"
+#include "critical.h"
 #include "nu_modutil.h"
 #include "nu_bitutil.h"
 #include "crypto-misc.h"
 
 static int crypto_inited = 0;
-static int crypto_sha_avail = 1;
+static uint32_t crypto_sha_avail = 1;
 
 void crypto_init(void)
 {
@@ -45,14 +46,10 @@ void crypto_zeroize(void *v, size_t n)
 
 int crypto_sha_acquire(void)
 {
-    if (crypto_sha_avail) {
-        crypto_sha_avail = 0;
-        return 1;
-    }
-    else {
-        return 0;
-    }
-    
+    /* Contexts of several threads compete for the engine, the loser
+     * falls back to software */
+    uint32_t avail = 1;
+    return core_util_atomic_cas_u32(&crypto_sha_avail, &avail, 0);
 }
 
 void crypto_sha_release(void)
@@ -799,6 +799,60 @@ int ethernet_read(char *data, int dlen) {
 #endif
 }
 
+#if !NEW_LOGIC
+// Zero-copy access hands out the fragment buffers in place. MAXF keeps a
+// received frame in a single fragment, as it does for transmitted ones.
+
+void *ethernet_tx_acquire(int *size) {
+    int idx = LPC_EMAC->TxProduceIndex;
+
+    if((uint32_t)rinc(idx, NUM_TX_FRAG) == LPC_EMAC->TxConsumeIndex) {
+        return NULL;
+    }
+
+    *size = ETH_FRAG_SIZE;
+    return (void *)txdesc[idx].Packet;
+}
+
+int ethernet_tx_send(void *buffer, int size) {
+    int idx = LPC_EMAC->TxProduceIndex;
+
+    if(txdesc[idx].Packet != (uint32_t)buffer || size <= 0 || size > ETH_FRAG_SIZE) {
+        return 0;
+    }
+
+    txdesc[idx].Ctrl = (size-1) | (TCTRL_INT | TCTRL_LAST);
+    LPC_EMAC->TxProduceIndex = rinc(idx, NUM_TX_FRAG);
+    return size;
+}
+
+void *ethernet_rx_acquire(int *size) {
+    int idx = LPC_EMAC->RxConsumeIndex;
+
+    while((uint32_t)idx != LPC_EMAC->RxProduceIndex) {
+        unsigned int info = rxstat[idx].Info;
+        if((info & RINFO_LAST_FLAG) && !(info & RINFO_ERR_MASK)) {
+            *size = (info & RINFO_SIZE) - 3; // don't include checksum bytes
+            return (void *)rxdesc[idx].Packet;
+        }
+
+        /* Invalid frame, ignore it and free buffer. */
+        idx = rinc(idx, NUM_RX_FRAG);
+        LPC_EMAC->RxConsumeIndex = idx;
+    }
+
+    return NULL;
+}
+
+void ethernet_rx_release(void *buffer) {
+    int idx = LPC_EMAC->RxConsumeIndex;
+
+    if((uint32_t)idx != LPC_EMAC->RxProduceIndex && rxdesc[idx].Packet == (uint32_t)buffer) {
+        LPC_EMAC->RxConsumeIndex = rinc(idx, NUM_RX_FRAG);
+    }
+}
+#endif
+
 int ethernet_link(void) {
 
     if (phy_id == DP83848C_ID) {
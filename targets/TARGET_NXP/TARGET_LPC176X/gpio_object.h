@@ -49,6 +49,32 @@ static inline int gpio_is_connected(const gpio_t *obj) {
     return obj->pin != (PinName)NC;
 }
 
+/* Pin-bound access, see gpio_api.h: the pin names are the addresses of
+ * the port registers plus the bit */
+#define GPIO_FAST 1
+
+static inline void gpio_fast_write(PinName pin, int value) {
+    LPC_GPIO_TypeDef *port = (LPC_GPIO_TypeDef *)((uint32_t)pin & ~0x1F);
+    if (value)
+        port->FIOSET = 1UL << ((uint32_t)pin & 0x1F);
+    else
+        port->FIOCLR = 1UL << ((uint32_t)pin & 0x1F);
+}
+
+static inline int gpio_fast_read(PinName pin) {
+    LPC_GPIO_TypeDef *port = (LPC_GPIO_TypeDef *)((uint32_t)pin & ~0x1F);
+    return (port->FIOPIN >> ((uint32_t)pin & 0x1F)) & 1;
+}
+
+static inline void gpio_fast_toggle(PinName pin) {
+    LPC_GPIO_TypeDef *port = (LPC_GPIO_TypeDef *)((uint32_t)pin & ~0x1F);
+    uint32_t mask = 1UL << ((uint32_t)pin & 0x1F);
+    if (port->FIOPIN & mask)
+        port->FIOCLR = mask;
+    else
+        port->FIOSET = mask;
+}
+
 #ifdef __cplusplus
 }
 #endif
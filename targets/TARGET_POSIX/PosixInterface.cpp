@@ -0,0 +1,924 @@
+/* PosixInterface
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PosixInterface.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netdb.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <vector>
+
+struct PosixStack::posix_socket {
+    int fd;
+    int family;
+    nsapi_protocol_t proto;
+    short events;   // armed, cleared as they fire
+    void (*callback)(void *);
+    void *data;
+    uint32_t rx_bytes;
+    uint32_t tx_bytes;
+    posix_socket *next;
+};
+
+static nsapi_error_t posix_error(int err)
+{
+    switch (err) {
+        case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+        case EWOULDBLOCK:
+#endif
+            return NSAPI_ERROR_WOULD_BLOCK;
+        case ECONNREFUSED:
+        case ECONNRESET:
+        case ECONNABORTED:
+        case ENOTCONN:
+        case EPIPE:
+        case ETIMEDOUT:
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+        case ENETDOWN:
+            return NSAPI_ERROR_NO_CONNECTION;
+        case EMFILE:
+        case ENFILE:
+            return NSAPI_ERROR_NO_SOCKET;
+        case ENOMEM:
+        case ENOBUFS:
+            return NSAPI_ERROR_NO_MEMORY;
+        case EADDRINUSE:
+        case EADDRNOTAVAIL:
+        case EISCONN:
+        case EINVAL:
+        case EAFNOSUPPORT:
+        case EMSGSIZE:
+        case EDESTADDRREQ:
+            return NSAPI_ERROR_PARAMETER;
+        default:
+            return NSAPI_ERROR_DEVICE_ERROR;
+    }
+}
+
+/* The sockets are IPv6 ones accepting IPv4 too where the host allows it,
+ * IPv4 addresses then being mapped as ::ffff:a.b.c.d */
+static socklen_t posix_sockaddr(int family, const SocketAddress &address, struct sockaddr_storage *ss)
+{
+    nsapi_addr_t addr = address.get_addr();
+    memset(ss, 0, sizeof(*ss));
+
+    if (family == AF_INET) {
+        if (addr.version == NSAPI_IPv6) {
+            return 0;
+        }
+        struct sockaddr_in *sin = (struct sockaddr_in *)ss;
+        sin->sin_family = AF_INET;
+        sin->sin_port = htons(address.get_port());
+        if (addr.version == NSAPI_IPv4) {
+            memcpy(&sin->sin_addr, addr.bytes, NSAPI_IPv4_BYTES);
+        }
+        return sizeof(*sin);
+    }
+
+    struct sockaddr_in6 *sin6 = (struct sockaddr_in6 *)ss;
+    sin6->sin6_family = AF_INET6;
+    sin6->sin6_port = htons(address.get_port());
+    if (addr.version == NSAPI_IPv6) {
+        memcpy(&sin6->sin6_addr, addr.bytes, NSAPI_IPv6_BYTES);
+    } else if (addr.version == NSAPI_IPv4 && (addr.bytes[0] | addr.bytes[1] | addr.bytes[2] | addr.bytes[3])) {
+        sin6->sin6_addr.s6_addr[10] = 0xff;
+        sin6->sin6_addr.s6_addr[11] = 0xff;
+        memcpy(&sin6->sin6_addr.s6_addr[12], addr.bytes, NSAPI_IPv4_BYTES);
+    } else {
+        sin6->sin6_addr = in6addr_any;
+    }
+    return sizeof(*sin6);
+}
+
+static void posix_address(const struct sockaddr_storage *ss, SocketAddress *address)
+{
+    if (!address) {
+        return;
+    }
+
+    if (ss->ss_family == AF_INET) {
+        const struct sockaddr_in *sin = (const struct sockaddr_in *)ss;
+        address->set_ip_bytes(&sin->sin_addr, NSAPI_IPv4);
+        address->set_port(ntohs(sin->sin_port));
+    } else if (ss->ss_family == AF_INET6) {
+        const struct sockaddr_in6 *sin6 = (const struct sockaddr_in6 *)ss;
+        if (IN6_IS_ADDR_V4MAPPED(&sin6->sin6_addr)) {
+            address->set_ip_bytes(&sin6->sin6_addr.s6_addr[12], NSAPI_IPv4);
+        } else {
+            address->set_ip_bytes(&sin6->sin6_addr, NSAPI_IPv6);
+        }
+        address->set_port(ntohs(sin6->sin6_port));
+    }
+}
+
+static int posix_nonblock(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return -1;
+    }
+    return fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+
+PosixStack::PosixStack()
+    : _thread(osPriorityNormal)
+    , _started(false)
+    , _sockets(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+    _ip_address[0] = '\0';
+
+    if (pipe(_wake) < 0 || posix_nonblock(_wake[0]) < 0 || posix_nonblock(_wake[1]) < 0) {
+        _wake[0] = _wake[1] = -1;
+    }
+}
+
+PosixStack *PosixStack::get_instance()
+{
+    static PosixStack stack;
+    return &stack;
+}
+
+const char *PosixStack::get_ip_address()
+{
+    struct ifaddrs *ifaddr;
+    strcpy(_ip_address, "127.0.0.1");
+
+    if (getifaddrs(&ifaddr) == 0) {
+        for (struct ifaddrs *ifa = ifaddr; ifa; ifa = ifa->ifa_next) {
+            if (ifa->ifa_addr && ifa->ifa_addr->sa_family == AF_INET &&
+                    !(ifa->ifa_flags & IFF_LOOPBACK) && (ifa->ifa_flags & IFF_UP)) {
+                inet_ntop(AF_INET, &((struct sockaddr_in *)ifa->ifa_addr)->sin_addr,
+                          _ip_address, sizeof(_ip_address));
+                break;
+            }
+        }
+        freeifaddrs(ifaddr);
+    }
+
+    return _ip_address;
+}
+
+int PosixStack::gethostbyname(const char *host, SocketAddress *address)
+{
+    return gethostbyname(host, address, NSAPI_UNSPEC);
+}
+
+int PosixStack::gethostbyname(const char *host, SocketAddress *address, nsapi_version_t version)
+{
+    if (address->set_ip_address(host)) {
+        if (version != NSAPI_UNSPEC && address->get_ip_version() != version) {
+            return NSAPI_ERROR_DNS_FAILURE;
+        }
+        return NSAPI_ERROR_OK;
+    }
+
+    struct addrinfo hints, *res;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = (version == NSAPI_IPv4) ? AF_INET :
+                      (version == NSAPI_IPv6) ? AF_INET6 : AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    if (getaddrinfo(host, NULL, &hints, &res) != 0 || !res) {
+        return NSAPI_ERROR_DNS_FAILURE;
+    }
+
+    struct sockaddr_storage ss;
+    memset(&ss, 0, sizeof(ss));
+    memcpy(&ss, res->ai_addr, res->ai_addrlen);
+    freeaddrinfo(res);
+
+    posix_address(&ss, address);
+    address->set_port(0);
+    return NSAPI_ERROR_OK;
+}
+
+int PosixStack::get_stats(nsapi_stack_stats_t *stats)
+{
+    if (!stats) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    _lock.lock();
+    *stats = _stats;
+    for (posix_socket *s = _sockets; s; s = s->next) {
+        stats->rx_bytes += s->rx_bytes;
+        stats->tx_bytes += s->tx_bytes;
+    }
+    _lock.unlock();
+    return NSAPI_ERROR_OK;
+}
+
+PosixStack::posix_socket *PosixStack::add_socket(int fd, int family, nsapi_protocol_t proto)
+{
+    posix_socket *s = new posix_socket;
+    s->fd = fd;
+    s->family = family;
+    s->proto = proto;
+    s->events = POLLIN;
+    s->callback = 0;
+    s->data = 0;
+    s->rx_bytes = 0;
+    s->tx_bytes = 0;
+
+    _lock.lock();
+    s->next = _sockets;
+    _sockets = s;
+    if (!_started) {
+        _started = _thread.start(mbed::callback(this, &PosixStack::poll_loop)) == osOK;
+    }
+    _lock.unlock();
+
+    char c = 0;
+    (void)!write(_wake[1], &c, 1);
+    return s;
+}
+
+bool PosixStack::has_socket(posix_socket *s)
+{
+    for (posix_socket *p = _sockets; p; p = p->next) {
+        if (p == s) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PosixStack::arm(posix_socket *s, short events)
+{
+    _lock.lock();
+    bool wake = (s->events & events) != events;
+    s->events |= events;
+    _lock.unlock();
+
+    if (wake) {
+        char c = 0;
+        (void)!write(_wake[1], &c, 1);
+    }
+}
+
+void PosixStack::poll_loop()
+{
+    std::vector<struct pollfd> fds;
+    std::vector<posix_socket *> sockets;
+
+    while (true) {
+        fds.clear();
+        sockets.clear();
+
+        struct pollfd wake = {_wake[0], POLLIN, 0};
+        fds.push_back(wake);
+        sockets.push_back(0);
+
+        _lock.lock();
+        for (posix_socket *s = _sockets; s; s = s->next) {
+            if (s->events && s->callback) {
+                struct pollfd pfd = {s->fd, s->events, 0};
+                fds.push_back(pfd);
+                sockets.push_back(s);
+            }
+        }
+        _lock.unlock();
+
+        if (poll(&fds[0], fds.size(), -1) < 0) {
+            continue;
+        }
+
+        if (fds[0].revents) {
+            char buffer[64];
+            while (read(_wake[0], buffer, sizeof(buffer)) > 0);
+        }
+
+        for (size_t i = 1; i < fds.size(); i++) {
+            if (!fds[i].revents) {
+                continue;
+            }
+
+            _dispatch.lock();
+            _lock.lock();
+            posix_socket *s = sockets[i];
+            void (*callback)(void *) = 0;
+            void *data = 0;
+            if (has_socket(s) && s->fd == fds[i].fd) {
+                if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                    s->events = 0;
+                } else {
+                    s->events &= ~fds[i].revents;
+                }
+                callback = s->callback;
+                data = s->data;
+            }
+            _lock.unlock();
+
+            if (callback) {
+                callback(data);
+            }
+            _dispatch.unlock();
+        }
+    }
+}
+
+int PosixStack::socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto)
+{
+    int type = (proto == NSAPI_TCP) ? SOCK_STREAM : SOCK_DGRAM;
+    int family = AF_INET6;
+
+    int fd = socket(AF_INET6, type, 0);
+    if (fd >= 0) {
+        int v6only = 0;
+        if (::setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6only, sizeof(v6only)) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd < 0) {
+        family = AF_INET;
+        fd = socket(AF_INET, type, 0);
+    }
+    if (fd < 0) {
+        return posix_error(errno);
+    }
+    if (posix_nonblock(fd) < 0) {
+        int err = errno;
+        close(fd);
+        return posix_error(err);
+    }
+
+    *handle = add_socket(fd, family, proto);
+    return NSAPI_ERROR_OK;
+}
+
+int PosixStack::socket_close(nsapi_socket_t handle)
+{
+    posix_socket *s = (posix_socket *)handle;
+
+    _dispatch.lock();
+    _lock.lock();
+    for (posix_socket **p = &_sockets; *p; p = &(*p)->next) {
+        if (*p == s) {
+            *p = s->next;
+            break;
+        }
+    }
+    _stats.rx_bytes += s->rx_bytes;
+    _stats.tx_bytes += s->tx_bytes;
+    _lock.unlock();
+    _dispatch.unlock();
+
+    int err = close(s->fd) < 0 ? posix_error(errno) : NSAPI_ERROR_OK;
+    delete s;
+
+    char c = 0;
+    (void)!write(_wake[1], &c, 1);
+    return err;
+}
+
+int PosixStack::socket_bind(nsapi_socket_t handle, const SocketAddress &address)
+{
+    posix_socket *s = (posix_socket *)handle;
+    struct sockaddr_storage ss;
+    socklen_t len = posix_sockaddr(s->family, address, &ss);
+    if (!len) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    if (bind(s->fd, (struct sockaddr *)&ss, len) < 0) {
+        return posix_error(errno);
+    }
+    return NSAPI_ERROR_OK;
+}
+
+int PosixStack::socket_listen(nsapi_socket_t handle, int backlog)
+{
+    posix_socket *s = (posix_socket *)handle;
+    if (listen(s->fd, backlog) < 0) {
+        return posix_error(errno);
+    }
+    arm(s, POLLIN);
+    return NSAPI_ERROR_OK;
+}
+
+int PosixStack::socket_connect(nsapi_socket_t handle, const SocketAddress &address)
+{
+    posix_socket *s = (posix_socket *)handle;
+    struct sockaddr_storage ss;
+    socklen_t len = posix_sockaddr(s->family, address, &ss);
+    if (!len) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    if (connect(s->fd, (struct sockaddr *)&ss, len) < 0) {
+        if (errno != EINPROGRESS) {
+            return posix_error(errno);
+        }
+
+        // the sockets of the other stacks connect before returning
+        struct pollfd pfd = {s->fd, POLLOUT, 0};
+        while (poll(&pfd, 1, -1) < 0 && errno == EINTR);
+
+        int err = 0;
+        socklen_t errlen = sizeof(err);
+        if (::getsockopt(s->fd, SOL_SOCKET, SO_ERROR, &err, &errlen) < 0) {
+            err = errno;
+        }
+        if (err) {
+            return posix_error(err);
+        }
+    }
+
+    arm(s, POLLIN | POLLOUT);
+    return NSAPI_ERROR_OK;
+}
+
+int PosixStack::socket_accept(nsapi_socket_t server, nsapi_socket_t *handle, SocketAddress *address)
+{
+    posix_socket *s = (posix_socket *)server;
+    struct sockaddr_storage ss;
+    socklen_t len = sizeof(ss);
+
+    int fd = accept(s->fd, (struct sockaddr *)&ss, &len);
+    arm(s, POLLIN);
+    if (fd < 0) {
+        return posix_error(errno);
+    }
+    if (posix_nonblock(fd) < 0) {
+        int err = errno;
+        close(fd);
+        return posix_error(err);
+    }
+
+    posix_address(&ss, address);
+    *handle = add_socket(fd, s->family, NSAPI_TCP);
+    return NSAPI_ERROR_OK;
+}
+
+int PosixStack::socket_send(nsapi_socket_t handle, const void *data, unsigned size)
+{
+    posix_socket *s = (posix_socket *)handle;
+
+    ssize_t n = send(s->fd, data, size, MSG_NOSIGNAL);
+    if (n < 0) {
+        int err = errno;
+        if (err == EAGAIN || err == EWOULDBLOCK) {
+            arm(s, POLLOUT);
+        }
+        return posix_error(err);
+    }
+
+    s->tx_bytes += n;
+    return n;
+}
+
+int PosixStack::socket_recv(nsapi_socket_t handle, void *data, unsigned size)
+{
+    posix_socket *s = (posix_socket *)handle;
+
+    ssize_t n = recv(s->fd, data, size, 0);
+    int err = errno;
+    arm(s, POLLIN);
+    if (n < 0) {
+        return posix_error(err);
+    }
+    if (n == 0 && s->proto == NSAPI_TCP && size > 0) {
+        return NSAPI_ERROR_NO_CONNECTION;
+    }
+
+    s->rx_bytes += n;
+    return n;
+}
+
+int PosixStack::socket_sendto(nsapi_socket_t handle, const SocketAddress &address, const void *data, unsigned size)
+{
+    posix_socket *s = (posix_socket *)handle;
+    struct sockaddr_storage ss;
+    socklen_t len = posix_sockaddr(s->family, address, &ss);
+    if (!len) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    ssize_t n = sendto(s->fd, data, size, MSG_NOSIGNAL, (struct sockaddr *)&ss, len);
+    if (n < 0) {
+        int err = errno;
+        if (err == EAGAIN || err == EWOULDBLOCK) {
+            arm(s, POLLOUT);
+        }
+        return posix_error(err);
+    }
+
+    s->tx_bytes += n;
+    return n;
+}
+
+int PosixStack::socket_recvfrom(nsapi_socket_t handle, SocketAddress *address, void *buffer, unsigned size)
+{
+    posix_socket *s = (posix_socket *)handle;
+    struct sockaddr_storage ss;
+    socklen_t len = sizeof(ss);
+
+    ssize_t n = recvfrom(s->fd, buffer, size, 0, (struct sockaddr *)&ss, &len);
+    int err = errno;
+    arm(s, POLLIN);
+    if (n < 0) {
+        return posix_error(err);
+    }
+
+    posix_address(&ss, address);
+    s->rx_bytes += n;
+    return n;
+}
+
+// packets handed to the host per sendmmsg/recvmmsg system call
+#define POSIX_MMSG_BATCH 16
+
+int PosixStack::socket_sendmmsg(nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count)
+{
+    posix_socket *s = (posix_socket *)handle;
+    struct mmsghdr hdrs[POSIX_MMSG_BATCH];
+    struct iovec iovs[POSIX_MMSG_BATCH];
+    struct sockaddr_storage ss[POSIX_MMSG_BATCH];
+    unsigned sent = 0;
+
+    while (sent < count) {
+        unsigned batch = count - sent < POSIX_MMSG_BATCH ? count - sent : POSIX_MMSG_BATCH;
+
+        memset(hdrs, 0, sizeof(hdrs));
+        for (unsigned i = 0; i < batch; i++) {
+            nsapi_mmsg_t *msg = &msgs[sent + i];
+            socklen_t len = posix_sockaddr(s->family, SocketAddress(msg->addr, msg->port), &ss[i]);
+            if (!len) {
+                // send up to the bad address, which then fails on its own
+                batch = i;
+                break;
+            }
+
+            iovs[i].iov_base = msg->data;
+            iovs[i].iov_len = msg->size;
+            hdrs[i].msg_hdr.msg_name = &ss[i];
+            hdrs[i].msg_hdr.msg_namelen = len;
+            hdrs[i].msg_hdr.msg_iov = &iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen = 1;
+        }
+        if (!batch) {
+            return sent ? (int)sent : NSAPI_ERROR_PARAMETER;
+        }
+
+        int n = sendmmsg(s->fd, hdrs, batch, MSG_NOSIGNAL);
+        if (n < 0) {
+            int err = errno;
+            if (err == EAGAIN || err == EWOULDBLOCK) {
+                arm(s, POLLOUT);
+            }
+            return sent ? (int)sent : posix_error(err);
+        }
+
+        for (int i = 0; i < n; i++) {
+            msgs[sent + i].len = hdrs[i].msg_len;
+            s->tx_bytes += hdrs[i].msg_len;
+        }
+        sent += n;
+
+        if ((unsigned)n < batch) {
+            break;
+        }
+    }
+
+    return sent;
+}
+
+int PosixStack::socket_recvmmsg(nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count)
+{
+    posix_socket *s = (posix_socket *)handle;
+    struct mmsghdr hdrs[POSIX_MMSG_BATCH];
+    struct iovec iovs[POSIX_MMSG_BATCH];
+    struct sockaddr_storage ss[POSIX_MMSG_BATCH];
+    unsigned recv = 0;
+    int ret = 0;
+
+    while (recv < count) {
+        unsigned batch = count - recv < POSIX_MMSG_BATCH ? count - recv : POSIX_MMSG_BATCH;
+
+        memset(hdrs, 0, sizeof(hdrs));
+        for (unsigned i = 0; i < batch; i++) {
+            iovs[i].iov_base = msgs[recv + i].data;
+            iovs[i].iov_len = msgs[recv + i].size;
+            hdrs[i].msg_hdr.msg_name = &ss[i];
+            hdrs[i].msg_hdr.msg_namelen = sizeof(ss[i]);
+            hdrs[i].msg_hdr.msg_iov = &iovs[i];
+            hdrs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int n = recvmmsg(s->fd, hdrs, batch, MSG_DONTWAIT, NULL);
+        if (n < 0) {
+            ret = posix_error(errno);
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            nsapi_mmsg_t *msg = &msgs[recv + i];
+            SocketAddress address;
+            posix_address(&ss[i], &address);
+
+            msg->addr = address.get_addr();
+            msg->port = address.get_port();
+            msg->len = hdrs[i].msg_len;
+            msg->flags = (hdrs[i].msg_hdr.msg_flags & MSG_TRUNC) ? NSAPI_MSG_TRUNC : 0;
+            s->rx_bytes += hdrs[i].msg_len;
+        }
+        recv += n;
+
+        if ((unsigned)n < batch) {
+            break;
+        }
+    }
+
+    arm(s, POLLIN);
+    return recv ? (int)recv : ret;
+}
+
+void PosixStack::socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data)
+{
+    posix_socket *s = (posix_socket *)handle;
+
+    _dispatch.lock();
+    _lock.lock();
+    s->callback = callback;
+    s->data = data;
+    s->events |= POLLIN;
+    _lock.unlock();
+    _dispatch.unlock();
+
+    char c = 0;
+    (void)!write(_wake[1], &c, 1);
+}
+
+int PosixStack::setsockopt(nsapi_socket_t handle, int level, int optname, const void *optval, unsigned optlen)
+{
+    posix_socket *s = (posix_socket *)handle;
+    int ret;
+
+    if (level != NSAPI_SOCKET) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    if (optname == NSAPI_ADD_MEMBERSHIP || optname == NSAPI_DROP_MEMBERSHIP) {
+        if (optlen != sizeof(nsapi_ip_mreq_t)) {
+            return NSAPI_ERROR_PARAMETER;
+        }
+        const nsapi_ip_mreq_t *mreq = (const nsapi_ip_mreq_t *)optval;
+        bool add = optname == NSAPI_ADD_MEMBERSHIP;
+
+        if (mreq->imr_multiaddr.version == NSAPI_IPv4 && s->family == AF_INET) {
+            struct ip_mreq req;
+            memcpy(&req.imr_multiaddr, mreq->imr_multiaddr.bytes, NSAPI_IPv4_BYTES);
+            if (mreq->imr_interface.version == NSAPI_IPv4) {
+                memcpy(&req.imr_interface, mreq->imr_interface.bytes, NSAPI_IPv4_BYTES);
+            } else {
+                req.imr_interface.s_addr = htonl(INADDR_ANY);
+            }
+            ret = ::setsockopt(s->fd, IPPROTO_IP, add ? IP_ADD_MEMBERSHIP : IP_DROP_MEMBERSHIP, &req, sizeof(req));
+        } else if (mreq->imr_multiaddr.version == NSAPI_IPv4) {
+            // an IPv4 group on a dual-stack socket
+            struct ip_mreqn req;
+            memset(&req, 0, sizeof(req));
+            memcpy(&req.imr_multiaddr, mreq->imr_multiaddr.bytes, NSAPI_IPv4_BYTES);
+            if (mreq->imr_interface.version == NSAPI_IPv4) {
+                memcpy(&req.imr_address, mreq->imr_interface.bytes, NSAPI_IPv4_BYTES);
+            }
+            ret = ::setsockopt(s->fd, IPPROTO_IP, add ? IP_ADD_MEMBERSHIP : IP_DROP_MEMBERSHIP, &req, sizeof(req));
+        } else if (mreq->imr_multiaddr.version == NSAPI_IPv6 && s->family == AF_INET6) {
+            struct ipv6_mreq req;
+            memcpy(&req.ipv6mr_multiaddr, mreq->imr_multiaddr.bytes, NSAPI_IPv6_BYTES);
+            req.ipv6mr_interface = 0;
+            ret = ::setsockopt(s->fd, IPPROTO_IPV6, add ? IPV6_JOIN_GROUP : IPV6_LEAVE_GROUP, &req, sizeof(req));
+        } else {
+            return NSAPI_ERROR_PARAMETER;
+        }
+        return ret < 0 ? posix_error(errno) : NSAPI_ERROR_OK;
+    }
+
+    if (optlen != sizeof(int)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+    int value = *(const int *)optval;
+
+    switch (optname) {
+        case NSAPI_REUSEADDR:
+            ret = ::setsockopt(s->fd, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
+            break;
+        case NSAPI_KEEPALIVE:
+            ret = ::setsockopt(s->fd, SOL_SOCKET, SO_KEEPALIVE, &value, sizeof(value));
+            break;
+        case NSAPI_KEEPIDLE:
+        case NSAPI_KEEPINTVL:
+            // in ms, as lwip takes them; the host counts seconds
+            value = (value + 999) / 1000;
+            ret = ::setsockopt(s->fd, IPPROTO_TCP, optname == NSAPI_KEEPIDLE ? TCP_KEEPIDLE : TCP_KEEPINTVL,
+                               &value, sizeof(value));
+            break;
+        case NSAPI_NODELAY:
+            ret = ::setsockopt(s->fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value));
+            break;
+        case NSAPI_SNDBUF:
+            ret = ::setsockopt(s->fd, SOL_SOCKET, SO_SNDBUF, &value, sizeof(value));
+            break;
+        case NSAPI_RCVBUF:
+            ret = ::setsockopt(s->fd, SOL_SOCKET, SO_RCVBUF, &value, sizeof(value));
+            break;
+        default:
+            return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    return ret < 0 ? posix_error(errno) : NSAPI_ERROR_OK;
+}
+
+int PosixStack::getsockopt(nsapi_socket_t handle, int level, int optname, void *optval, unsigned *optlen)
+{
+    posix_socket *s = (posix_socket *)handle;
+    int value = 0;
+    socklen_t len = sizeof(value);
+    int ret;
+
+    if (level != NSAPI_SOCKET) {
+        return NSAPI_ERROR_UNSUPPORTED;
+    }
+    if (*optlen < sizeof(int)) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    switch (optname) {
+        case NSAPI_REUSEADDR:
+            ret = ::getsockopt(s->fd, SOL_SOCKET, SO_REUSEADDR, &value, &len);
+            break;
+        case NSAPI_KEEPALIVE:
+            ret = ::getsockopt(s->fd, SOL_SOCKET, SO_KEEPALIVE, &value, &len);
+            break;
+        case NSAPI_KEEPIDLE:
+        case NSAPI_KEEPINTVL:
+            ret = ::getsockopt(s->fd, IPPROTO_TCP, optname == NSAPI_KEEPIDLE ? TCP_KEEPIDLE : TCP_KEEPINTVL,
+                               &value, &len);
+            value *= 1000;
+            break;
+        case NSAPI_NODELAY:
+            ret = ::getsockopt(s->fd, IPPROTO_TCP, TCP_NODELAY, &value, &len);
+            break;
+        case NSAPI_SNDBUF:
+            ret = ::getsockopt(s->fd, SOL_SOCKET, SO_SNDBUF, &value, &len);
+            break;
+        case NSAPI_RCVBUF:
+            ret = ::getsockopt(s->fd, SOL_SOCKET, SO_RCVBUF, &value, &len);
+            break;
+        default:
+            return NSAPI_ERROR_UNSUPPORTED;
+    }
+
+    if (ret < 0) {
+        return posix_error(errno);
+    }
+    *(int *)optval = value;
+    *optlen = sizeof(int);
+    return NSAPI_ERROR_OK;
+}
+
+int PosixStack::socket_poll(nsapi_socket_t handle)
+{
+    posix_socket *s = (posix_socket *)handle;
+    struct pollfd pfd = {s->fd, POLLIN | POLLOUT, 0};
+
+    if (poll(&pfd, 1, 0) < 0) {
+        return posix_error(errno);
+    }
+    if (pfd.revents & POLLNVAL) {
+        return NSAPI_POLLNVAL;
+    }
+
+    int events = 0;
+    if (pfd.revents & (POLLIN | POLLHUP)) {
+        events |= NSAPI_POLLIN;
+    }
+    if (pfd.revents & POLLOUT) {
+        events |= NSAPI_POLLOUT;
+    }
+    if (pfd.revents & POLLERR) {
+        events |= NSAPI_POLLERR;
+    }
+    return events;
+}
+
+int PosixStack::socket_get_stats(nsapi_socket_t handle, nsapi_socket_stats_t *stats)
+{
+    posix_socket *s = (posix_socket *)handle;
+    if (!stats) {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->rx_bytes = s->rx_bytes;
+    stats->tx_bytes = s->tx_bytes;
+
+#ifdef TCP_INFO
+    if (s->proto == NSAPI_TCP) {
+        struct tcp_info info;
+        socklen_t len = sizeof(info);
+        if (::getsockopt(s->fd, IPPROTO_TCP, TCP_INFO, &info, &len) == 0) {
+            stats->retransmits = info.tcpi_retransmits;
+            stats->rtt_ms = info.tcpi_rtt / 1000;
+            stats->rtt_var_ms = info.tcpi_rttvar / 1000;
+            stats->rto_ms = info.tcpi_rto / 1000;
+            stats->cwnd = info.tcpi_snd_cwnd * info.tcpi_snd_mss;
+            stats->send_queue = info.tcpi_unacked;
+        }
+    }
+#endif
+
+    return NSAPI_ERROR_OK;
+}
+
+
+PosixInterface::PosixInterface()
+    : _status(NSAPI_STATUS_DISCONNECTED)
+{
+    _netmask[0] = '\0';
+}
+
+int PosixInterface::connect()
+{
+    _status = NSAPI_STATUS_GLOBAL_UP;
+    if (_status_cb) {
+        _status_cb(_status);
+    }
+    return NSAPI_ERROR_OK;
+}
+
+int PosixInterface::disconnect()
+{
+    _status = NSAPI_STATUS_DISCONNECTED;
+    if (_status_cb) {
+        _status_cb(_status);
+    }
+    return NSAPI_ERROR_OK;
+}
+
+const char *PosixInterface::get_ip_address()
+{
+    return PosixStack::get_instance()->get_ip_address();
+}
+
+const char *PosixInterface::get_netmask()
+{
+    struct ifaddrs *ifaddr;
+    strcpy(_netmask, "255.0.0.0");
+
+    if (getifaddrs(&ifaddr) == 0) {
+        for (struct ifaddrs *ifa = ifaddr; ifa; ifa = ifa->ifa_next) {
+            if (ifa->ifa_addr && ifa->ifa_netmask && ifa->ifa_addr->sa_family == AF_INET &&
+                    !(ifa->ifa_flags & IFF_LOOPBACK) && (ifa->ifa_flags & IFF_UP)) {
+                inet_ntop(AF_INET, &((struct sockaddr_in *)ifa->ifa_netmask)->sin_addr,
+                          _netmask, sizeof(_netmask));
+                break;
+            }
+        }
+        freeifaddrs(ifaddr);
+    }
+
+    return _netmask;
+}
+
+void PosixInterface::attach(nsapi_status_callback_t status_cb)
+{
+    _status_cb = status_cb;
+}
+
+nsapi_connection_status_t PosixInterface::get_connection_status() const
+{
+    return _status;
+}
+
+NetworkStack *PosixInterface::get_stack()
+{
+    return PosixStack::get_instance();
+}
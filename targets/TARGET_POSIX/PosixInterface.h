@@ -0,0 +1,112 @@
+/* PosixInterface
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef POSIX_INTERFACE_H
+#define POSIX_INTERFACE_H
+
+#include "netsocket/NetworkStack.h"
+#include "netsocket/EthInterface.h"
+#include "rtos/Mutex.h"
+#include "rtos/Thread.h"
+
+/** PosixStack class
+ *
+ *  NetworkStack on the BSD sockets of the host. The sockets are
+ *  non-blocking; a thread polls them and calls the callbacks attached
+ *  when they become readable, or writable after a send would block.
+ */
+class PosixStack : public NetworkStack
+{
+public:
+    /** The stack, shared by all the interfaces */
+    static PosixStack *get_instance();
+
+    virtual const char *get_ip_address();
+
+    /** Resolve a hostname with the resolver of the host
+     *
+     *  /etc/hosts applies, unlike the DNS queries of the other stacks.
+     */
+    virtual int gethostbyname(const char *host, SocketAddress *address);
+    virtual int gethostbyname(const char *host, SocketAddress *address, nsapi_version_t version);
+
+    virtual int get_stats(nsapi_stack_stats_t *stats);
+
+protected:
+    virtual int socket_open(nsapi_socket_t *handle, nsapi_protocol_t proto);
+    virtual int socket_close(nsapi_socket_t handle);
+    virtual int socket_bind(nsapi_socket_t handle, const SocketAddress &address);
+    virtual int socket_listen(nsapi_socket_t handle, int backlog);
+    virtual int socket_connect(nsapi_socket_t handle, const SocketAddress &address);
+    virtual int socket_accept(nsapi_socket_t server, nsapi_socket_t *handle, SocketAddress *address=0);
+    virtual int socket_send(nsapi_socket_t handle, const void *data, unsigned size);
+    virtual int socket_recv(nsapi_socket_t handle, void *data, unsigned size);
+    virtual int socket_sendto(nsapi_socket_t handle, const SocketAddress &address, const void *data, unsigned size);
+    virtual int socket_recvfrom(nsapi_socket_t handle, SocketAddress *address, void *buffer, unsigned size);
+    virtual int socket_sendmmsg(nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count);
+    virtual int socket_recvmmsg(nsapi_socket_t handle, nsapi_mmsg_t *msgs, unsigned count);
+    virtual void socket_attach(nsapi_socket_t handle, void (*callback)(void *), void *data);
+    virtual int setsockopt(nsapi_socket_t handle, int level, int optname, const void *optval, unsigned optlen);
+    virtual int getsockopt(nsapi_socket_t handle, int level, int optname, void *optval, unsigned *optlen);
+    virtual int socket_poll(nsapi_socket_t handle);
+    virtual int socket_get_stats(nsapi_socket_t handle, nsapi_socket_stats_t *stats);
+
+private:
+    struct posix_socket;
+
+    PosixStack();
+
+    posix_socket *add_socket(int fd, int family, nsapi_protocol_t proto);
+    bool has_socket(posix_socket *s);
+    void arm(posix_socket *s, short events);
+    void poll_loop();
+
+    // held around the callbacks, so none is called once detached
+    rtos::Mutex _dispatch;
+    rtos::Mutex _lock;
+    rtos::Thread _thread;
+    bool _started;
+    int _wake[2];
+    posix_socket *_sockets;
+    nsapi_stack_stats_t _stats;
+    char _ip_address[NSAPI_IP_SIZE];
+};
+
+/** PosixInterface class
+ *
+ *  The network of the host, always up.
+ */
+class PosixInterface : public EthInterface
+{
+public:
+    PosixInterface();
+
+    virtual int connect();
+    virtual int disconnect();
+    virtual const char *get_ip_address();
+    virtual const char *get_netmask();
+    virtual void attach(nsapi_status_callback_t status_cb);
+    virtual nsapi_connection_status_t get_connection_status() const;
+
+protected:
+    virtual NetworkStack *get_stack();
+
+    nsapi_status_callback_t _status_cb;
+    nsapi_connection_status_t _status;
+    char _netmask[NSAPI_IP_SIZE];
+};
+
+#endif
@@ -0,0 +1,80 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_CMSIS_H
+#define MBED_CMSIS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* There is no NVIC on the host: the interrupts are the ones of the us_ticker
+ * thread. Disabling them takes a lock which the thread holds until it enables
+ * them again, so that critical sections exclude the other threads too, as
+ * they would on a single core. */
+void posix_irq_disable(void);
+void posix_irq_enable(void);
+uint32_t posix_irq_disabled(void);
+
+static inline void __disable_irq(void)
+{
+    posix_irq_disable();
+}
+
+static inline void __enable_irq(void)
+{
+    posix_irq_enable();
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return posix_irq_disabled();
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    if (primask & 1) {
+        posix_irq_disable();
+    } else {
+        posix_irq_enable();
+    }
+}
+
+static inline void __NOP(void)
+{
+}
+
+static inline void __DMB(void)
+{
+    __sync_synchronize();
+}
+
+static inline void __DSB(void)
+{
+    __sync_synchronize();
+}
+
+static inline void __ISB(void)
+{
+    __sync_synchronize();
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,304 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* CMSIS-RTOS API of the POSIX target, implemented on pthreads by rtos_posix.c.
+ *
+ * Threads are host threads scheduled by the host: priorities are recorded
+ * but do not preempt, and the stack sizes requested are ignored. Messages
+ * are 32 bits wide as in RTX, so Queue<T> needs a 32-bit build (WORD=32).
+ * The API has no delete for pools, message and mail queues, so these are
+ * freed only when the process exits.
+ */
+#ifndef _CMSIS_OS_H
+#define _CMSIS_OS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define osCMSIS           0x10002U     ///< CMSIS-RTOS API version (main [31:16] .sub [15:0])
+
+#define osCMSIS_POSIX     0x10000U     ///< RTOS identification and version (main [31:16] .sub [15:0])
+
+#define osKernelSystemId "POSIX V1.00" ///< RTOS identification string
+
+#define osFeature_MainThread   1       ///< main can be thread
+#define osFeature_Pool         1       ///< Memory Pools available
+#define osFeature_MailQ        1       ///< Mail Queues available
+#define osFeature_MessageQ     1       ///< Message Queues available
+#define osFeature_Signals      16      ///< 16 Signal Flags available per thread
+#define osFeature_Semaphore    65535   ///< Maximum count for \ref osSemaphoreCreate function
+#define osFeature_Wait         0       ///< osWait not available
+#define osFeature_SysTick      1       ///< osKernelSysTick functions available
+
+/* Nominal, a host thread gets the default stack of the host */
+#define DEFAULT_STACK_SIZE     4096
+
+#define os_InRegs
+
+#ifdef  __cplusplus
+extern "C"
+{
+#endif
+
+//  ==== Enumeration, structures, defines ====
+
+/// Priority used for thread control.
+typedef enum  {
+  osPriorityIdle          = -3,          ///< priority: idle (lowest)
+  osPriorityLow           = -2,          ///< priority: low
+  osPriorityBelowNormal   = -1,          ///< priority: below normal
+  osPriorityNormal        =  0,          ///< priority: normal (default)
+  osPriorityAboveNormal   = +1,          ///< priority: above normal
+  osPriorityHigh          = +2,          ///< priority: high
+  osPriorityRealtime      = +3,          ///< priority: realtime (highest)
+  osPriorityError         =  0x84        ///< system cannot determine priority or thread has illegal priority
+} osPriority;
+
+/// Timeout value.
+#define osWaitForever     0xFFFFFFFFU    ///< wait forever timeout value
+
+/// Status code values returned by CMSIS-RTOS functions.
+typedef enum  {
+  osOK                    =     0,       ///< function completed; no error or event occurred.
+  osEventSignal           =  0x08,       ///< function completed; signal event occurred.
+  osEventMessage          =  0x10,       ///< function completed; message event occurred.
+  osEventMail             =  0x20,       ///< function completed; mail event occurred.
+  osEventTimeout          =  0x40,       ///< function completed; timeout occurred.
+  osErrorParameter        =  0x80,       ///< parameter error: a mandatory parameter was missing or specified an incorrect object.
+  osErrorResource         =  0x81,       ///< resource not available: a specified resource was not available.
+  osErrorTimeoutResource  =  0xC1,       ///< resource not available within given time: a specified resource was not available within the timeout period.
+  osErrorISR              =  0x82,       ///< not allowed in ISR context: the function cannot be called from interrupt service routines.
+  osErrorISRRecursive     =  0x83,       ///< function called multiple times from ISR with same object.
+  osErrorPriority         =  0x84,       ///< system cannot determine priority or thread has illegal priority.
+  osErrorNoMemory         =  0x85,       ///< system is out of memory: it was impossible to allocate or reserve memory for the operation.
+  osErrorValue            =  0x86,       ///< value of a parameter is out of range.
+  osErrorOS               =  0xFF,       ///< unspecified RTOS error: run-time error but no other error message fits.
+  os_status_reserved      =  0x7FFFFFFF  ///< prevent from enum down-size compiler optimization.
+} osStatus;
+
+/// Timer type value for the timer definition.
+typedef enum  {
+  osTimerOnce             =     0,       ///< one-shot timer
+  osTimerPeriodic         =     1        ///< repeating timer
+} os_timer_type;
+
+/// Entry point of a thread.
+typedef void (*os_pthread) (void const *argument);
+
+/// Entry point of a timer call back function.
+typedef void (*os_ptimer) (void const *argument);
+
+typedef struct os_thread_cb *osThreadId;
+typedef struct os_timer_cb *osTimerId;
+typedef struct os_mutex_cb *osMutexId;
+typedef struct os_semaphore_cb *osSemaphoreId;
+typedef struct os_pool_cb *osPoolId;
+typedef struct os_messageQ_cb *osMessageQId;
+typedef struct os_mailQ_cb *osMailQId;
+
+/// Thread Definition structure contains startup information of a thread.
+typedef struct os_thread_def  {
+  os_pthread               pthread;    ///< start address of thread function
+  osPriority             tpriority;    ///< initial thread priority
+  uint32_t               instances;    ///< maximum number of instances of that thread function
+  uint32_t               stacksize;    ///< stack size requirements in bytes; 0 is default stack size
+  uint32_t               *stack_pointer;  ///< ignored, pthreads allocate the stacks
+} osThreadDef_t;
+
+/// Timer Definition structure contains timer parameters.
+typedef struct os_timer_def  {
+  os_ptimer                 ptimer;    ///< start address of a timer function
+} osTimerDef_t;
+
+/// Mutex Definition structure contains setup information for a mutex.
+typedef struct os_mutex_def  {
+  uint32_t                   dummy;    ///< dummy value.
+} osMutexDef_t;
+
+/// Semaphore Definition structure contains setup information for a semaphore.
+typedef struct os_semaphore_def  {
+  uint32_t                   dummy;    ///< dummy value.
+} osSemaphoreDef_t;
+
+/// Definition structure for memory block allocation.
+typedef struct os_pool_def  {
+  uint32_t                 pool_sz;    ///< number of items (elements) in the pool
+  uint32_t                 item_sz;    ///< size of an item
+} osPoolDef_t;
+
+/// Definition structure for message queue.
+typedef struct os_messageQ_def  {
+  uint32_t                queue_sz;    ///< number of elements in the queue
+} osMessageQDef_t;
+
+/// Definition structure for mail queue.
+typedef struct os_mailQ_def  {
+  uint32_t                queue_sz;    ///< number of elements in the queue
+  uint32_t                 item_sz;    ///< size of an item
+} osMailQDef_t;
+
+/// Event structure contains detailed information about an event.
+typedef struct  {
+  osStatus                 status;     ///< status code: event or error information
+  union  {
+    uint32_t                    v;     ///< message as 32-bit value
+    void                       *p;     ///< message or mail as void pointer
+    int32_t               signals;     ///< signal flags
+  } value;                             ///< event value
+  union  {
+    osMailQId             mail_id;     ///< mail id obtained by \ref osMailCreate
+    osMessageQId       message_id;     ///< message id obtained by \ref osMessageCreate
+  } def;                               ///< event definition
+} osEvent;
+
+
+//  ==== Kernel Control Functions ====
+
+osStatus osKernelInitialize (void);
+osStatus osKernelStart (void);
+int32_t osKernelRunning(void);
+
+/// The RTOS kernel system timer counts microseconds.
+uint32_t osKernelSysTick (void);
+#define osKernelSysTickFrequency 1000000
+#define osKernelSysTickMicroSec(microsec) (microsec)
+
+
+//  ==== Thread Management ====
+
+#define osThreadDef(name, priority, instances, stacksz)  \
+const osThreadDef_t os_thread_def_##name = \
+{ (name), (priority), (instances), (stacksz)  }
+
+#define osThread(name)  \
+&os_thread_def_##name
+
+osThreadId osThreadCreate (const osThreadDef_t *thread_def, void *argument);
+osThreadId osThreadGetId (void);
+osStatus osThreadTerminate (osThreadId thread_id);
+osStatus osThreadYield (void);
+osStatus osThreadSetPriority (osThreadId thread_id, osPriority priority);
+osPriority osThreadGetPriority (osThreadId thread_id);
+
+/// Get current thread state, one of rtos::Thread::State.
+uint8_t osThreadGetState (osThreadId thread_id);
+
+
+//  ==== Generic Wait Functions ====
+
+osStatus osDelay (uint32_t millisec);
+
+
+//  ==== Timer Management Functions ====
+
+#define osTimerDef(name, function)  \
+const osTimerDef_t os_timer_def_##name = \
+{ (function) }
+
+#define osTimer(name) \
+&os_timer_def_##name
+
+osTimerId osTimerCreate (const osTimerDef_t *timer_def, os_timer_type type, void *argument);
+osStatus osTimerStart (osTimerId timer_id, uint32_t millisec);
+osStatus osTimerStop (osTimerId timer_id);
+osStatus osTimerDelete (osTimerId timer_id);
+
+
+//  ==== Signal Management ====
+
+int32_t osSignalSet (osThreadId thread_id, int32_t signals);
+int32_t osSignalClear (osThreadId thread_id, int32_t signals);
+os_InRegs osEvent osSignalWait (int32_t signals, uint32_t millisec);
+
+
+//  ==== Mutex Management ====
+
+#define osMutexDef(name)  \
+const osMutexDef_t os_mutex_def_##name = { 0 }
+
+#define osMutex(name)  \
+&os_mutex_def_##name
+
+osMutexId osMutexCreate (const osMutexDef_t *mutex_def);
+osStatus osMutexWait (osMutexId mutex_id, uint32_t millisec);
+osStatus osMutexRelease (osMutexId mutex_id);
+osStatus osMutexDelete (osMutexId mutex_id);
+
+
+//  ==== Semaphore Management Functions ====
+
+#define osSemaphoreDef(name)  \
+const osSemaphoreDef_t os_semaphore_def_##name = { 0 }
+
+#define osSemaphore(name)  \
+&os_semaphore_def_##name
+
+osSemaphoreId osSemaphoreCreate (const osSemaphoreDef_t *semaphore_def, int32_t count);
+int32_t osSemaphoreWait (osSemaphoreId semaphore_id, uint32_t millisec);
+osStatus osSemaphoreRelease (osSemaphoreId semaphore_id);
+osStatus osSemaphoreDelete (osSemaphoreId semaphore_id);
+
+
+//  ==== Memory Pool Management Functions ====
+
+#define osPoolDef(name, no, type)   \
+const osPoolDef_t os_pool_def_##name = \
+{ (no), sizeof(type) }
+
+#define osPool(name) \
+&os_pool_def_##name
+
+osPoolId osPoolCreate (const osPoolDef_t *pool_def);
+void *osPoolAlloc (osPoolId pool_id);
+void *osPoolCAlloc (osPoolId pool_id);
+osStatus osPoolFree (osPoolId pool_id, void *block);
+
+
+//  ==== Message Queue Management Functions ====
+
+#define osMessageQDef(name, queue_sz, type)   \
+const osMessageQDef_t os_messageQ_def_##name = \
+{ (queue_sz) }
+
+#define osMessageQ(name) \
+&os_messageQ_def_##name
+
+osMessageQId osMessageCreate (const osMessageQDef_t *queue_def, osThreadId thread_id);
+osStatus osMessagePut (osMessageQId queue_id, uint32_t info, uint32_t millisec);
+os_InRegs osEvent osMessageGet (osMessageQId queue_id, uint32_t millisec);
+
+
+//  ==== Mail Queue Management Functions ====
+
+#define osMailQDef(name, queue_sz, type) \
+const osMailQDef_t os_mailQ_def_##name =  \
+{ (queue_sz), sizeof(type) }
+
+#define osMailQ(name)  \
+&os_mailQ_def_##name
+
+osMailQId osMailCreate (const osMailQDef_t *queue_def, osThreadId thread_id);
+void *osMailAlloc (osMailQId queue_id, uint32_t millisec);
+void *osMailCAlloc (osMailQId queue_id, uint32_t millisec);
+osStatus osMailPut (osMailQId queue_id, void *mail);
+os_InRegs osEvent osMailGet (osMailQId queue_id, uint32_t millisec);
+osStatus osMailFree (osMailQId queue_id, void *mail);
+
+#ifdef  __cplusplus
+}
+#endif
+
+#endif  // _CMSIS_OS_H
@@ -0,0 +1,43 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "hal/gpio_api.h"
+
+volatile int posix_gpio_level[POSIX_GPIO_PINS];
+
+uint32_t gpio_set(PinName pin)
+{
+    return 1UL << pin;
+}
+
+void gpio_init(gpio_t *obj, PinName pin)
+{
+    obj->pin = pin;
+}
+
+void gpio_mode(gpio_t *obj, PinMode mode)
+{
+    if (mode == PullUp) {
+        posix_gpio_level[obj->pin] = 1;
+    } else if (mode == PullDown) {
+        posix_gpio_level[obj->pin] = 0;
+    }
+}
+
+void gpio_dir(gpio_t *obj, PinDirection direction)
+{
+    (void)obj;
+    (void)direction;
+}
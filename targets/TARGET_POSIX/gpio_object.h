@@ -0,0 +1,65 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_GPIO_OBJECT_H
+#define MBED_GPIO_OBJECT_H
+
+#include "mbed_assert.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Levels of the pins, as last written or pulled */
+extern volatile int posix_gpio_level[POSIX_GPIO_PINS];
+
+typedef struct {
+    PinName pin;
+} gpio_t;
+
+static inline void gpio_write(gpio_t *obj, int value) {
+    MBED_ASSERT(obj->pin != (PinName)NC);
+    posix_gpio_level[obj->pin] = value ? 1 : 0;
+}
+
+static inline int gpio_read(gpio_t *obj) {
+    MBED_ASSERT(obj->pin != (PinName)NC);
+    return posix_gpio_level[obj->pin];
+}
+
+static inline int gpio_is_connected(const gpio_t *obj) {
+    return obj->pin != (PinName)NC;
+}
+
+/* Pin-bound access, see gpio_api.h */
+#define GPIO_FAST 1
+
+static inline void gpio_fast_write(PinName pin, int value) {
+    posix_gpio_level[pin] = value ? 1 : 0;
+}
+
+static inline int gpio_fast_read(PinName pin) {
+    return posix_gpio_level[pin];
+}
+
+static inline void gpio_fast_toggle(PinName pin) {
+    posix_gpio_level[pin] ^= 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
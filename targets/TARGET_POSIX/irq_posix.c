@@ -0,0 +1,45 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cmsis.h"
+
+#include <pthread.h>
+
+static pthread_mutex_t irq_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Like PRIMASK, the mask is not nested: one enable undoes any number of
+ * disables */
+static __thread int irq_disabled;
+
+void posix_irq_disable(void)
+{
+    if (!irq_disabled) {
+        pthread_mutex_lock(&irq_lock);
+        irq_disabled = 1;
+    }
+}
+
+void posix_irq_enable(void)
+{
+    if (irq_disabled) {
+        irq_disabled = 0;
+        pthread_mutex_unlock(&irq_lock);
+    }
+}
+
+uint32_t posix_irq_disabled(void)
+{
+    return irq_disabled;
+}
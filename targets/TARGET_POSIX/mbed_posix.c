@@ -0,0 +1,55 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "platform/mbed_interface.h"
+#include "platform/wait_api.h"
+
+/* Replaces the ones of mbed_board.c, there is no stdio UART: messages go to
+ * stderr, and dying aborts so that a debugger or valgrind shows where */
+void mbed_die(void)
+{
+    fflush(stdout);
+    abort();
+}
+
+void mbed_error_printf(const char *format, ...)
+{
+    va_list arg;
+    va_start(arg, format);
+    mbed_error_vfprintf(format, arg);
+    va_end(arg);
+}
+
+void mbed_error_vfprintf(const char *format, va_list arg)
+{
+    vfprintf(stderr, format, arg);
+}
+
+/* Spins on the clock, as a short wait does on a core */
+void wait_ns(int ns)
+{
+    struct timespec start, now;
+    if (ns <= 0) {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    do {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    } while ((now.tv_sec - start.tv_sec) * 1000000000LL + (now.tv_nsec - start.tv_nsec) < ns);
+}
@@ -0,0 +1,1147 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cmsis_os.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Values of rtos::Thread::State */
+enum {
+    STATE_INACTIVE,
+    STATE_READY,
+    STATE_RUNNING,
+    STATE_WAIT_DELAY,
+    STATE_WAIT_INTERVAL,
+    STATE_WAIT_OR,
+    STATE_WAIT_AND,
+    STATE_WAIT_SEMAPHORE,
+    STATE_WAIT_MAILBOX,
+    STATE_WAIT_MUTEX,
+};
+
+struct os_thread_cb {
+    pthread_t thread;
+    os_pthread entry;
+    void *argument;
+    uint32_t serial;
+    osPriority priority;
+    volatile uint8_t state;
+    uint8_t created;                /* by osThreadCreate, rather than adopted */
+    int32_t signals;
+    pthread_cond_t signal_cond;
+    struct os_mutex_cb *mutexes;    /* held, released if the thread terminates */
+    struct os_thread_cb *next;
+};
+
+struct os_mutex_cb {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct os_thread_cb *owner;
+    uint32_t count;
+    struct os_mutex_cb *next;       /* in the list of the owner */
+};
+
+struct os_semaphore_cb {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t tokens;
+};
+
+struct os_pool_cb {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t pool_sz;
+    uint32_t item_sz;
+    void *blocks;
+    void *free;
+};
+
+/* Messages and mails */
+struct os_queue {
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uintptr_t *items;
+    uint32_t size;
+    uint32_t head;
+    uint32_t count;
+};
+
+struct os_messageQ_cb {
+    struct os_queue queue;
+};
+
+struct os_mailQ_cb {
+    struct os_queue queue;
+    struct os_pool_cb pool;
+};
+
+struct os_timer_cb {
+    os_ptimer ptimer;
+    void *argument;
+    os_timer_type type;
+    uint8_t active;
+    uint64_t period;
+    uint64_t deadline;
+    struct os_timer_cb *next;       /* in the list of the active timers */
+};
+
+/* Threads and their signals */
+static pthread_mutex_t os_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t os_exit_cond;
+static struct os_thread_cb *os_threads;
+static uint32_t os_serial;
+
+static pthread_once_t os_once = PTHREAD_ONCE_INIT;
+static pthread_key_t os_adopted_key;
+static __thread struct os_thread_cb *os_self;
+
+/* Timers, which run in a thread of their own like the RTX timer thread */
+static pthread_mutex_t os_timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t os_timer_cond;
+static pthread_cond_t os_timer_done_cond;
+static struct os_timer_cb *os_timers;
+static struct os_timer_cb *os_timer_running;
+static pthread_t os_timer_thread;
+static int os_timer_thread_started;
+
+static void os_cond_init(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static uint64_t os_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void os_deadline(struct timespec *ts, uint32_t millisec)
+{
+    clock_gettime(CLOCK_MONOTONIC, ts);
+    ts->tv_sec += millisec / 1000;
+    ts->tv_nsec += (long)(millisec % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000) {
+        ts->tv_sec += 1;
+        ts->tv_nsec -= 1000000000;
+    }
+}
+
+/* Wait for cond until the deadline, unless millisec is osWaitForever.
+ * Returns 0 once the deadline has passed. */
+static int os_wait(pthread_cond_t *cond, pthread_mutex_t *lock,
+                   uint32_t millisec, const struct timespec *deadline)
+{
+    if (millisec == osWaitForever) {
+        pthread_cond_wait(cond, lock);
+        return 1;
+    }
+    return pthread_cond_timedwait(cond, lock, deadline) != ETIMEDOUT;
+}
+
+/* Waits are where another thread may terminate this one: the lock of the
+ * object waited for must not be left held */
+static void os_unlock(void *lock)
+{
+    pthread_mutex_unlock((pthread_mutex_t *)lock);
+}
+
+static void os_thread_free(struct os_thread_cb *tcb);
+
+static void os_adopted_exit(void *arg)
+{
+    os_thread_free((struct os_thread_cb *)arg);
+}
+
+static void os_init(void)
+{
+    os_cond_init(&os_exit_cond);
+    os_cond_init(&os_timer_cond);
+    os_cond_init(&os_timer_done_cond);
+    pthread_key_create(&os_adopted_key, os_adopted_exit);
+}
+
+static struct os_thread_cb *os_thread_alloc(void)
+{
+    struct os_thread_cb *tcb = (struct os_thread_cb *)calloc(1, sizeof(struct os_thread_cb));
+    if (tcb == NULL) {
+        return NULL;
+    }
+
+    os_cond_init(&tcb->signal_cond);
+    tcb->priority = osPriorityNormal;
+    tcb->state = STATE_READY;
+
+    pthread_mutex_lock(&os_lock);
+    tcb->serial = ++os_serial;
+    tcb->next = os_threads;
+    os_threads = tcb;
+    pthread_mutex_unlock(&os_lock);
+    return tcb;
+}
+
+static void os_mutex_release_all(struct os_thread_cb *tcb);
+
+static void os_thread_free(struct os_thread_cb *tcb)
+{
+    // RTX releases the mutexes of a thread which terminates
+    os_mutex_release_all(tcb);
+
+    pthread_mutex_lock(&os_lock);
+    struct os_thread_cb **p = &os_threads;
+    while (*p != tcb) {
+        p = &(*p)->next;
+    }
+    *p = tcb->next;
+    pthread_cond_broadcast(&os_exit_cond);
+    pthread_mutex_unlock(&os_lock);
+
+    pthread_cond_destroy(&tcb->signal_cond);
+    free(tcb);
+}
+
+/* Called with os_lock held */
+static struct os_thread_cb *os_thread_find(osThreadId thread_id)
+{
+    struct os_thread_cb *tcb = os_threads;
+    while (tcb != NULL && tcb != thread_id) {
+        tcb = tcb->next;
+    }
+    return tcb;
+}
+
+/* Threads the RTOS did not create, main() first, get a thread ID when they
+ * first need one */
+static struct os_thread_cb *os_thread_self(void)
+{
+    if (os_self == NULL) {
+        pthread_once(&os_once, os_init);
+        struct os_thread_cb *tcb = os_thread_alloc();
+        if (tcb == NULL) {
+            return NULL;
+        }
+        tcb->thread = pthread_self();
+        tcb->state = STATE_RUNNING;
+        os_self = tcb;
+        pthread_setspecific(os_adopted_key, tcb);
+    }
+    return os_self;
+}
+
+static void os_thread_exit(void *arg)
+{
+    os_self = NULL;
+    os_thread_free((struct os_thread_cb *)arg);
+}
+
+static void *os_thread_entry(void *arg)
+{
+    struct os_thread_cb *tcb = (struct os_thread_cb *)arg;
+    os_self = tcb;
+    tcb->state = STATE_RUNNING;
+
+    pthread_cleanup_push(os_thread_exit, tcb);
+    tcb->entry(tcb->argument);
+    pthread_cleanup_pop(1);
+    return NULL;
+}
+
+
+//  ==== Kernel Control Functions ====
+
+osStatus osKernelInitialize(void)
+{
+    pthread_once(&os_once, os_init);
+    return osOK;
+}
+
+osStatus osKernelStart(void)
+{
+    return osOK;
+}
+
+int32_t osKernelRunning(void)
+{
+    return 1;
+}
+
+uint32_t osKernelSysTick(void)
+{
+    return (uint32_t)os_now_us();
+}
+
+
+//  ==== Thread Management ====
+
+osThreadId osThreadCreate(const osThreadDef_t *thread_def, void *argument)
+{
+    if (thread_def == NULL || thread_def->pthread == NULL) {
+        return NULL;
+    }
+
+    pthread_once(&os_once, os_init);
+    struct os_thread_cb *tcb = os_thread_alloc();
+    if (tcb == NULL) {
+        return NULL;
+    }
+    tcb->entry = thread_def->pthread;
+    tcb->argument = argument;
+    tcb->priority = thread_def->tpriority;
+    tcb->created = 1;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int err = pthread_create(&tcb->thread, &attr, os_thread_entry, tcb);
+    pthread_attr_destroy(&attr);
+    if (err) {
+        os_thread_free(tcb);
+        return NULL;
+    }
+    return tcb;
+}
+
+osThreadId osThreadGetId(void)
+{
+    return os_thread_self();
+}
+
+/* Another thread is cancelled, so it stops at its next wait; termination
+ * completes once it has */
+osStatus osThreadTerminate(osThreadId thread_id)
+{
+    if (thread_id == NULL) {
+        return osErrorParameter;
+    }
+    if (thread_id == os_self) {
+        pthread_exit(NULL);
+    }
+
+    pthread_mutex_lock(&os_lock);
+    struct os_thread_cb *tcb = os_thread_find(thread_id);
+    if (tcb == NULL || !tcb->created) {
+        pthread_mutex_unlock(&os_lock);
+        return (tcb == NULL) ? osErrorParameter : osErrorResource;
+    }
+
+    uint32_t serial = tcb->serial;
+    pthread_cancel(tcb->thread);
+    while ((tcb = os_thread_find(thread_id)) != NULL && tcb->serial == serial) {
+        pthread_cond_wait(&os_exit_cond, &os_lock);
+    }
+    pthread_mutex_unlock(&os_lock);
+    return osOK;
+}
+
+osStatus osThreadYield(void)
+{
+    sched_yield();
+    return osOK;
+}
+
+osStatus osThreadSetPriority(osThreadId thread_id, osPriority priority)
+{
+    if (priority < osPriorityIdle || priority > osPriorityRealtime) {
+        return osErrorValue;
+    }
+
+    pthread_mutex_lock(&os_lock);
+    struct os_thread_cb *tcb = os_thread_find(thread_id);
+    if (tcb != NULL) {
+        tcb->priority = priority;
+    }
+    pthread_mutex_unlock(&os_lock);
+    return (tcb != NULL) ? osOK : osErrorParameter;
+}
+
+osPriority osThreadGetPriority(osThreadId thread_id)
+{
+    osPriority priority = osPriorityError;
+
+    pthread_mutex_lock(&os_lock);
+    struct os_thread_cb *tcb = os_thread_find(thread_id);
+    if (tcb != NULL) {
+        priority = tcb->priority;
+    }
+    pthread_mutex_unlock(&os_lock);
+    return priority;
+}
+
+uint8_t osThreadGetState(osThreadId thread_id)
+{
+    uint8_t state = STATE_INACTIVE;
+
+    pthread_mutex_lock(&os_lock);
+    struct os_thread_cb *tcb = os_thread_find(thread_id);
+    if (tcb != NULL) {
+        state = (tcb == os_self) ? STATE_RUNNING : tcb->state;
+    }
+    pthread_mutex_unlock(&os_lock);
+    return state;
+}
+
+
+//  ==== Generic Wait Functions ====
+
+osStatus osDelay(uint32_t millisec)
+{
+    struct os_thread_cb *self = os_thread_self();
+    struct timespec deadline;
+    os_deadline(&deadline, millisec);
+
+    self->state = STATE_WAIT_DELAY;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) {
+    }
+    self->state = STATE_RUNNING;
+    return osEventTimeout;
+}
+
+
+//  ==== Timer Management Functions ====
+
+/* Called with os_timer_lock held */
+static void os_timer_insert(struct os_timer_cb *timer)
+{
+    struct os_timer_cb **p = &os_timers;
+    while (*p != NULL && (*p)->deadline <= timer->deadline) {
+        p = &(*p)->next;
+    }
+    timer->next = *p;
+    *p = timer;
+    timer->active = 1;
+}
+
+/* Called with os_timer_lock held */
+static void os_timer_remove(struct os_timer_cb *timer)
+{
+    if (timer->active) {
+        struct os_timer_cb **p = &os_timers;
+        while (*p != timer) {
+            p = &(*p)->next;
+        }
+        *p = timer->next;
+        timer->active = 0;
+    }
+}
+
+static void *os_timer_loop(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&os_timer_lock);
+    while (1) {
+        if (os_timers == NULL) {
+            pthread_cond_wait(&os_timer_cond, &os_timer_lock);
+            continue;
+        }
+
+        struct os_timer_cb *timer = os_timers;
+        uint64_t now = os_now_us();
+        if (timer->deadline > now) {
+            struct timespec ts;
+            ts.tv_sec = timer->deadline / 1000000;
+            ts.tv_nsec = (timer->deadline % 1000000) * 1000;
+            pthread_cond_timedwait(&os_timer_cond, &os_timer_lock, &ts);
+            continue;
+        }
+
+        os_timer_remove(timer);
+        if (timer->type == osTimerPeriodic) {
+            timer->deadline += timer->period;
+            os_timer_insert(timer);
+        }
+
+        os_timer_running = timer;
+        pthread_mutex_unlock(&os_timer_lock);
+        timer->ptimer(timer->argument);
+        pthread_mutex_lock(&os_timer_lock);
+        os_timer_running = NULL;
+        pthread_cond_broadcast(&os_timer_done_cond);
+    }
+    return NULL;
+}
+
+osTimerId osTimerCreate(const osTimerDef_t *timer_def, os_timer_type type, void *argument)
+{
+    if (timer_def == NULL || timer_def->ptimer == NULL) {
+        return NULL;
+    }
+
+    pthread_once(&os_once, os_init);
+    pthread_mutex_lock(&os_timer_lock);
+    if (!os_timer_thread_started) {
+        if (pthread_create(&os_timer_thread, NULL, os_timer_loop, NULL)) {
+            pthread_mutex_unlock(&os_timer_lock);
+            return NULL;
+        }
+        pthread_detach(os_timer_thread);
+        os_timer_thread_started = 1;
+    }
+    pthread_mutex_unlock(&os_timer_lock);
+
+    struct os_timer_cb *timer = (struct os_timer_cb *)calloc(1, sizeof(struct os_timer_cb));
+    if (timer == NULL) {
+        return NULL;
+    }
+    timer->ptimer = timer_def->ptimer;
+    timer->argument = argument;
+    timer->type = type;
+    return timer;
+}
+
+osStatus osTimerStart(osTimerId timer_id, uint32_t millisec)
+{
+    if (timer_id == NULL || millisec == 0) {
+        return (timer_id == NULL) ? osErrorParameter : osErrorValue;
+    }
+
+    pthread_mutex_lock(&os_timer_lock);
+    os_timer_remove(timer_id);
+    timer_id->period = (uint64_t)millisec * 1000;
+    timer_id->deadline = os_now_us() + timer_id->period;
+    os_timer_insert(timer_id);
+    pthread_cond_signal(&os_timer_cond);
+    pthread_mutex_unlock(&os_timer_lock);
+    return osOK;
+}
+
+osStatus osTimerStop(osTimerId timer_id)
+{
+    if (timer_id == NULL) {
+        return osErrorParameter;
+    }
+
+    pthread_mutex_lock(&os_timer_lock);
+    osStatus status = timer_id->active ? osOK : osErrorResource;
+    os_timer_remove(timer_id);
+    pthread_mutex_unlock(&os_timer_lock);
+    return status;
+}
+
+osStatus osTimerDelete(osTimerId timer_id)
+{
+    if (timer_id == NULL) {
+        return osErrorParameter;
+    }
+
+    pthread_mutex_lock(&os_timer_lock);
+    os_timer_remove(timer_id);
+    // Unless deleted by its own callback, wait for the callback to return
+    while (os_timer_running == timer_id && !pthread_equal(pthread_self(), os_timer_thread)) {
+        pthread_cond_wait(&os_timer_done_cond, &os_timer_lock);
+    }
+    pthread_mutex_unlock(&os_timer_lock);
+
+    free(timer_id);
+    return osOK;
+}
+
+
+//  ==== Signal Management ====
+
+int32_t osSignalSet(osThreadId thread_id, int32_t signals)
+{
+    int32_t previous = 0x80000000;
+
+    pthread_mutex_lock(&os_lock);
+    struct os_thread_cb *tcb = os_thread_find(thread_id);
+    if (tcb != NULL) {
+        previous = tcb->signals;
+        tcb->signals |= signals;
+        pthread_cond_signal(&tcb->signal_cond);
+    }
+    pthread_mutex_unlock(&os_lock);
+    return previous;
+}
+
+int32_t osSignalClear(osThreadId thread_id, int32_t signals)
+{
+    int32_t previous = 0x80000000;
+
+    pthread_mutex_lock(&os_lock);
+    struct os_thread_cb *tcb = os_thread_find(thread_id);
+    if (tcb != NULL) {
+        previous = tcb->signals;
+        tcb->signals &= ~signals;
+    }
+    pthread_mutex_unlock(&os_lock);
+    return previous;
+}
+
+os_InRegs osEvent osSignalWait(int32_t signals, uint32_t millisec)
+{
+    struct os_thread_cb *self = os_thread_self();
+    struct timespec deadline;
+    osEvent event;
+
+    event.status = osOK;
+    event.value.signals = 0;
+    if (millisec != 0 && millisec != osWaitForever) {
+        os_deadline(&deadline, millisec);
+    }
+
+    pthread_mutex_lock(&os_lock);
+    pthread_cleanup_push(os_unlock, &os_lock);
+    while (1) {
+        int32_t ready = signals ? (self->signals & signals) == signals : self->signals != 0;
+        if (ready) {
+            event.status = osEventSignal;
+            event.value.signals = self->signals;
+            self->signals &= signals ? ~signals : 0;
+            break;
+        }
+        if (millisec == 0) {
+            break;
+        }
+
+        self->state = signals ? STATE_WAIT_AND : STATE_WAIT_OR;
+        int woken = os_wait(&self->signal_cond, &os_lock, millisec, &deadline);
+        self->state = STATE_RUNNING;
+        if (!woken) {
+            event.status = osEventTimeout;
+            break;
+        }
+    }
+    pthread_cleanup_pop(1);
+    return event;
+}
+
+
+//  ==== Mutex Management ====
+
+osMutexId osMutexCreate(const osMutexDef_t *mutex_def)
+{
+    (void)mutex_def;
+    struct os_mutex_cb *mutex = (struct os_mutex_cb *)calloc(1, sizeof(struct os_mutex_cb));
+    if (mutex == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&mutex->lock, NULL);
+    os_cond_init(&mutex->cond);
+    return mutex;
+}
+
+osStatus osMutexWait(osMutexId mutex_id, uint32_t millisec)
+{
+    if (mutex_id == NULL) {
+        return osErrorParameter;
+    }
+
+    struct os_thread_cb *self = os_thread_self();
+    struct timespec deadline;
+    osStatus status = osOK;
+    if (millisec != 0 && millisec != osWaitForever) {
+        os_deadline(&deadline, millisec);
+    }
+
+    pthread_mutex_lock(&mutex_id->lock);
+    pthread_cleanup_push(os_unlock, &mutex_id->lock);
+    while (mutex_id->owner != NULL && mutex_id->owner != self) {
+        if (millisec == 0) {
+            status = osErrorResource;
+            break;
+        }
+
+        self->state = STATE_WAIT_MUTEX;
+        int woken = os_wait(&mutex_id->cond, &mutex_id->lock, millisec, &deadline);
+        self->state = STATE_RUNNING;
+        if (!woken && mutex_id->owner != NULL) {
+            status = osErrorTimeoutResource;
+            break;
+        }
+    }
+
+    if (status == osOK) {
+        if (mutex_id->owner == NULL) {
+            mutex_id->owner = self;
+            mutex_id->next = self->mutexes;
+            self->mutexes = mutex_id;
+        }
+        mutex_id->count++;
+    }
+    pthread_cleanup_pop(1);
+    return status;
+}
+
+/* Called with the lock of the mutex held */
+static void os_mutex_disown(struct os_mutex_cb *mutex)
+{
+    struct os_mutex_cb **p = &mutex->owner->mutexes;
+    while (*p != mutex) {
+        p = &(*p)->next;
+    }
+    *p = mutex->next;
+
+    mutex->owner = NULL;
+    mutex->count = 0;
+    pthread_cond_signal(&mutex->cond);
+}
+
+static void os_mutex_release_all(struct os_thread_cb *tcb)
+{
+    while (tcb->mutexes != NULL) {
+        struct os_mutex_cb *mutex = tcb->mutexes;
+        pthread_mutex_lock(&mutex->lock);
+        os_mutex_disown(mutex);
+        pthread_mutex_unlock(&mutex->lock);
+    }
+}
+
+osStatus osMutexRelease(osMutexId mutex_id)
+{
+    if (mutex_id == NULL) {
+        return osErrorParameter;
+    }
+
+    osStatus status = osOK;
+    pthread_mutex_lock(&mutex_id->lock);
+    if (mutex_id->owner != os_self || mutex_id->owner == NULL) {
+        status = osErrorResource;
+    } else if (--mutex_id->count == 0) {
+        os_mutex_disown(mutex_id);
+    }
+    pthread_mutex_unlock(&mutex_id->lock);
+    return status;
+}
+
+osStatus osMutexDelete(osMutexId mutex_id)
+{
+    if (mutex_id == NULL) {
+        return osErrorParameter;
+    }
+
+    pthread_mutex_lock(&mutex_id->lock);
+    if (mutex_id->owner != NULL) {
+        os_mutex_disown(mutex_id);
+    }
+    pthread_mutex_unlock(&mutex_id->lock);
+
+    pthread_cond_destroy(&mutex_id->cond);
+    pthread_mutex_destroy(&mutex_id->lock);
+    free(mutex_id);
+    return osOK;
+}
+
+/* The mutex of SingletonPtr, created before the static constructors of C++
+ * as in the pre_main() of RTX */
+osMutexId singleton_mutex_id;
+
+__attribute__((constructor(101)))
+static void os_singleton_init(void)
+{
+    singleton_mutex_id = osMutexCreate(NULL);
+}
+
+
+//  ==== Semaphore Management Functions ====
+
+osSemaphoreId osSemaphoreCreate(const osSemaphoreDef_t *semaphore_def, int32_t count)
+{
+    (void)semaphore_def;
+    if (count < 0 || count > osFeature_Semaphore) {
+        return NULL;
+    }
+
+    struct os_semaphore_cb *semaphore = (struct os_semaphore_cb *)calloc(1, sizeof(struct os_semaphore_cb));
+    if (semaphore == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_init(&semaphore->lock, NULL);
+    os_cond_init(&semaphore->cond);
+    semaphore->tokens = count;
+    return semaphore;
+}
+
+/* As RTX, returns the tokens left plus the one taken, 0 if none was */
+int32_t osSemaphoreWait(osSemaphoreId semaphore_id, uint32_t millisec)
+{
+    if (semaphore_id == NULL) {
+        return -1;
+    }
+
+    struct timespec deadline;
+    int32_t ret = 0;
+    if (millisec != 0 && millisec != osWaitForever) {
+        os_deadline(&deadline, millisec);
+    }
+
+    pthread_mutex_lock(&semaphore_id->lock);
+    pthread_cleanup_push(os_unlock, &semaphore_id->lock);
+    while (semaphore_id->tokens == 0 && millisec != 0) {
+        struct os_thread_cb *self = os_thread_self();
+        self->state = STATE_WAIT_SEMAPHORE;
+        int woken = os_wait(&semaphore_id->cond, &semaphore_id->lock, millisec, &deadline);
+        self->state = STATE_RUNNING;
+        if (!woken) {
+            break;
+        }
+    }
+
+    if (semaphore_id->tokens > 0) {
+        ret = semaphore_id->tokens--;
+    }
+    pthread_cleanup_pop(1);
+    return ret;
+}
+
+osStatus osSemaphoreRelease(osSemaphoreId semaphore_id)
+{
+    if (semaphore_id == NULL) {
+        return osErrorParameter;
+    }
+
+    osStatus status = osOK;
+    pthread_mutex_lock(&semaphore_id->lock);
+    if (semaphore_id->tokens < osFeature_Semaphore) {
+        semaphore_id->tokens++;
+        pthread_cond_signal(&semaphore_id->cond);
+    } else {
+        status = osErrorResource;
+    }
+    pthread_mutex_unlock(&semaphore_id->lock);
+    return status;
+}
+
+osStatus osSemaphoreDelete(osSemaphoreId semaphore_id)
+{
+    if (semaphore_id == NULL) {
+        return osErrorParameter;
+    }
+
+    pthread_cond_destroy(&semaphore_id->cond);
+    pthread_mutex_destroy(&semaphore_id->lock);
+    free(semaphore_id);
+    return osOK;
+}
+
+
+//  ==== Memory Pool Management Functions ====
+
+static int os_pool_init(struct os_pool_cb *pool, uint32_t pool_sz, uint32_t item_sz)
+{
+    // Blocks keep the alignment of malloc, and room for the free list link
+    uint32_t align = sizeof(void *) > sizeof(uint64_t) ? sizeof(void *) : sizeof(uint64_t);
+    pool->pool_sz = pool_sz;
+    pool->item_sz = (item_sz + align - 1) & ~(align - 1);
+    pool->blocks = malloc((size_t)pool_sz * pool->item_sz);
+    if (pool->blocks == NULL) {
+        return -1;
+    }
+
+    pool->free = NULL;
+    for (uint32_t i = pool_sz; i > 0; i--) {
+        void **block = (void **)((char *)pool->blocks + (size_t)(i - 1) * pool->item_sz);
+        *block = pool->free;
+        pool->free = block;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    os_cond_init(&pool->cond);
+    return 0;
+}
+
+static void *os_pool_alloc(struct os_pool_cb *pool, uint32_t millisec, int clear)
+{
+    struct timespec deadline;
+    void **block = NULL;
+    if (millisec != 0 && millisec != osWaitForever) {
+        os_deadline(&deadline, millisec);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cleanup_push(os_unlock, &pool->lock);
+    while (pool->free == NULL && millisec != 0) {
+        struct os_thread_cb *self = os_thread_self();
+        self->state = STATE_WAIT_MAILBOX;
+        int woken = os_wait(&pool->cond, &pool->lock, millisec, &deadline);
+        self->state = STATE_RUNNING;
+        if (!woken) {
+            break;
+        }
+    }
+
+    block = (void **)pool->free;
+    if (block != NULL) {
+        pool->free = *block;
+    }
+    pthread_cleanup_pop(1);
+
+    if (block != NULL && clear) {
+        memset(block, 0, pool->item_sz);
+    }
+    return block;
+}
+
+static osStatus os_pool_free(struct os_pool_cb *pool, void *block)
+{
+    size_t offset = (size_t)((char *)block - (char *)pool->blocks);
+    if ((char *)block < (char *)pool->blocks ||
+            offset >= (size_t)pool->pool_sz * pool->item_sz || offset % pool->item_sz != 0) {
+        return osErrorValue;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    *(void **)block = pool->free;
+    pool->free = block;
+    pthread_cond_signal(&pool->cond);
+    pthread_mutex_unlock(&pool->lock);
+    return osOK;
+}
+
+osPoolId osPoolCreate(const osPoolDef_t *pool_def)
+{
+    if (pool_def == NULL || pool_def->pool_sz == 0 || pool_def->item_sz == 0) {
+        return NULL;
+    }
+
+    struct os_pool_cb *pool = (struct os_pool_cb *)malloc(sizeof(struct os_pool_cb));
+    if (pool == NULL || os_pool_init(pool, pool_def->pool_sz, pool_def->item_sz)) {
+        free(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void *osPoolAlloc(osPoolId pool_id)
+{
+    return pool_id ? os_pool_alloc(pool_id, 0, 0) : NULL;
+}
+
+void *osPoolCAlloc(osPoolId pool_id)
+{
+    return pool_id ? os_pool_alloc(pool_id, 0, 1) : NULL;
+}
+
+osStatus osPoolFree(osPoolId pool_id, void *block)
+{
+    if (pool_id == NULL || block == NULL) {
+        return osErrorParameter;
+    }
+    return os_pool_free(pool_id, block);
+}
+
+
+//  ==== Message Queue Management Functions ====
+
+static int os_queue_init(struct os_queue *queue, uint32_t size)
+{
+    queue->items = (uintptr_t *)malloc(size * sizeof(uintptr_t));
+    if (queue->items == NULL) {
+        return -1;
+    }
+    queue->size = size;
+    queue->head = 0;
+    queue->count = 0;
+
+    pthread_mutex_init(&queue->lock, NULL);
+    os_cond_init(&queue->not_empty);
+    os_cond_init(&queue->not_full);
+    return 0;
+}
+
+static osStatus os_queue_put(struct os_queue *queue, uintptr_t item, uint32_t millisec)
+{
+    struct timespec deadline;
+    osStatus status = osOK;
+    if (millisec != 0 && millisec != osWaitForever) {
+        os_deadline(&deadline, millisec);
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    pthread_cleanup_push(os_unlock, &queue->lock);
+    while (queue->count == queue->size) {
+        if (millisec == 0) {
+            status = osErrorResource;
+            break;
+        }
+
+        struct os_thread_cb *self = os_thread_self();
+        self->state = STATE_WAIT_MAILBOX;
+        int woken = os_wait(&queue->not_full, &queue->lock, millisec, &deadline);
+        self->state = STATE_RUNNING;
+        if (!woken && queue->count == queue->size) {
+            status = osErrorTimeoutResource;
+            break;
+        }
+    }
+
+    if (status == osOK) {
+        queue->items[(queue->head + queue->count) % queue->size] = item;
+        queue->count++;
+        pthread_cond_signal(&queue->not_empty);
+    }
+    pthread_cleanup_pop(1);
+    return status;
+}
+
+/* Returns osEventMessage with the item, osOK if none was there to get
+ * right away, or osEventTimeout */
+static osStatus os_queue_get(struct os_queue *queue, uintptr_t *item, uint32_t millisec)
+{
+    struct timespec deadline;
+    osStatus status = osEventMessage;
+    if (millisec != 0 && millisec != osWaitForever) {
+        os_deadline(&deadline, millisec);
+    }
+
+    pthread_mutex_lock(&queue->lock);
+    pthread_cleanup_push(os_unlock, &queue->lock);
+    while (queue->count == 0) {
+        if (millisec == 0) {
+            status = osOK;
+            break;
+        }
+
+        struct os_thread_cb *self = os_thread_self();
+        self->state = STATE_WAIT_MAILBOX;
+        int woken = os_wait(&queue->not_empty, &queue->lock, millisec, &deadline);
+        self->state = STATE_RUNNING;
+        if (!woken && queue->count == 0) {
+            status = osEventTimeout;
+            break;
+        }
+    }
+
+    if (status == osEventMessage) {
+        *item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->size;
+        queue->count--;
+        pthread_cond_signal(&queue->not_full);
+    }
+    pthread_cleanup_pop(1);
+    return status;
+}
+
+osMessageQId osMessageCreate(const osMessageQDef_t *queue_def, osThreadId thread_id)
+{
+    (void)thread_id;
+    if (queue_def == NULL || queue_def->queue_sz == 0) {
+        return NULL;
+    }
+
+    struct os_messageQ_cb *queue = (struct os_messageQ_cb *)malloc(sizeof(struct os_messageQ_cb));
+    if (queue == NULL || os_queue_init(&queue->queue, queue_def->queue_sz)) {
+        free(queue);
+        return NULL;
+    }
+    return queue;
+}
+
+osStatus osMessagePut(osMessageQId queue_id, uint32_t info, uint32_t millisec)
+{
+    if (queue_id == NULL) {
+        return osErrorParameter;
+    }
+    return os_queue_put(&queue_id->queue, info, millisec);
+}
+
+os_InRegs osEvent osMessageGet(osMessageQId queue_id, uint32_t millisec)
+{
+    osEvent event;
+    uintptr_t item = 0;
+
+    event.def.message_id = queue_id;
+    if (queue_id == NULL) {
+        event.status = osErrorParameter;
+        return event;
+    }
+
+    event.status = os_queue_get(&queue_id->queue, &item, millisec);
+    event.value.v = (uint32_t)item;
+    return event;
+}
+
+
+//  ==== Mail Queue Management Functions ====
+
+osMailQId osMailCreate(const osMailQDef_t *queue_def, osThreadId thread_id)
+{
+    (void)thread_id;
+    if (queue_def == NULL || queue_def->queue_sz == 0 || queue_def->item_sz == 0) {
+        return NULL;
+    }
+
+    struct os_mailQ_cb *queue = (struct os_mailQ_cb *)malloc(sizeof(struct os_mailQ_cb));
+    if (queue == NULL) {
+        return NULL;
+    }
+    if (os_queue_init(&queue->queue, queue_def->queue_sz)) {
+        free(queue);
+        return NULL;
+    }
+    if (os_pool_init(&queue->pool, queue_def->queue_sz, queue_def->item_sz)) {
+        free(queue->queue.items);
+        free(queue);
+        return NULL;
+    }
+    return queue;
+}
+
+void *osMailAlloc(osMailQId queue_id, uint32_t millisec)
+{
+    return queue_id ? os_pool_alloc(&queue_id->pool, millisec, 0) : NULL;
+}
+
+void *osMailCAlloc(osMailQId queue_id, uint32_t millisec)
+{
+    return queue_id ? os_pool_alloc(&queue_id->pool, millisec, 1) : NULL;
+}
+
+osStatus osMailPut(osMailQId queue_id, void *mail)
+{
+    if (queue_id == NULL || mail == NULL) {
+        return osErrorParameter;
+    }
+    // There are as many slots in the queue as blocks in the pool
+    return os_queue_put(&queue_id->queue, (uintptr_t)mail, 0);
+}
+
+os_InRegs osEvent osMailGet(osMailQId queue_id, uint32_t millisec)
+{
+    osEvent event;
+    uintptr_t item = 0;
+
+    event.def.mail_id = queue_id;
+    if (queue_id == NULL) {
+        event.status = osErrorParameter;
+        return event;
+    }
+
+    event.status = os_queue_get(&queue_id->queue, &item, millisec);
+    if (event.status == osEventMessage) {
+        event.status = osEventMail;
+    }
+    event.value.p = (void *)item;
+    return event;
+}
+
+osStatus osMailFree(osMailQId queue_id, void *mail)
+{
+    if (queue_id == NULL || mail == NULL) {
+        return osErrorParameter;
+    }
+    return os_pool_free(&queue_id->pool, mail);
+}
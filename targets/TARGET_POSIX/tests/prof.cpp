@@ -0,0 +1,280 @@
+/*
+ * Profiling framework for the POSIX target
+ *
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#define __STDC_FORMAT_MACROS
+#include "mbed.h"
+#include "platform/CircularBuffer.h"
+#include "PosixInterface.h"
+#include <unistd.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+using namespace rtos;
+
+
+// Performance measurement utils
+#define PROF_RUNS 5
+#define PROF_INTERVAL 100000000
+
+#define prof_volatile(t) __attribute__((unused)) volatile t
+
+typedef uint64_t prof_cycle_t;
+
+static volatile prof_cycle_t prof_start_cycle;
+static volatile prof_cycle_t prof_stop_cycle;
+static prof_cycle_t prof_accum_cycle;
+static prof_cycle_t prof_baseline_cycle;
+static prof_cycle_t prof_iterations;
+static const char *prof_units;
+
+#define prof_cycle() ({                                                     \
+    uint32_t a, b;                                                          \
+    __asm__ volatile ("rdtsc" : "=a" (a), "=d" (b));                        \
+    ((uint64_t)b << 32) | (uint64_t)a;                                      \
+})
+
+#define prof_loop()                                                         \
+    for (prof_iterations = 0;                                               \
+         prof_accum_cycle < PROF_INTERVAL;                                  \
+         prof_iterations++)
+
+#define prof_start() ({                                                     \
+    prof_start_cycle = prof_cycle();                                        \
+})
+
+#define prof_stop() ({                                                      \
+    prof_stop_cycle = prof_cycle();                                         \
+    prof_accum_cycle += prof_stop_cycle - prof_start_cycle;                 \
+})
+
+#define prof_result(value, units) ({                                        \
+    prof_accum_cycle = value+prof_baseline_cycle;                           \
+    prof_iterations = 1;                                                    \
+    prof_units = units;                                                     \
+})
+
+#define prof_measure(func, ...) ({                                          \
+    printf("%s: ...", #func);                                               \
+    fflush(stdout);                                                         \
+                                                                            \
+    prof_units = "cycles";                                                  \
+    prof_cycle_t runs[PROF_RUNS];                                           \
+    for (int i = 0; i < PROF_RUNS; i++) {                                   \
+        prof_accum_cycle = 0;                                               \
+        prof_iterations = 0;                                                \
+        func(__VA_ARGS__);                                                  \
+        runs[i] = prof_accum_cycle / prof_iterations;                       \
+    }                                                                       \
+                                                                            \
+    prof_cycle_t res = runs[0];                                             \
+    for (int i = 0; i < PROF_RUNS; i++) {                                   \
+        if (runs[i] < res) {                                                \
+            res = runs[i];                                                  \
+        }                                                                   \
+    }                                                                       \
+    res -= prof_baseline_cycle;                                             \
+    printf("\r%s: %" PRIu64 " %s", #func, res, prof_units);                 \
+                                                                            \
+    if (!isatty(0)) {                                                       \
+        prof_cycle_t prev = 0;                                              \
+        while (scanf("%*[^0-9]%" PRIu64, &prev) == 0);                      \
+                                                                            \
+        if (prev) {                                                         \
+            int64_t perc = 100*((int64_t)prev - (int64_t)res)/(int64_t)prev;\
+            if (perc > 10) {                                                \
+                printf(" (\e[32m%+" PRId64 "%%\e[0m)", perc);               \
+            } else if (perc < -10) {                                        \
+                printf(" (\e[31m%+" PRId64 "%%\e[0m)", perc);               \
+            } else {                                                        \
+                printf(" (%+" PRId64 "%%)", perc);                          \
+            }                                                               \
+        }                                                                   \
+    }                                                                       \
+                                                                            \
+    printf("\n");                                                           \
+    res;                                                                    \
+})
+
+#define prof_baseline(func, ...) ({                                         \
+    prof_baseline_cycle = 0;                                                \
+    prof_baseline_cycle = prof_measure(func, __VA_ARGS__);                  \
+})
+
+
+// Various test functions
+static void no_func() {
+}
+
+static void no_func_arg(int *p) {
+    (void)p;
+}
+
+
+// Actual performance tests
+void baseline_prof() {
+    prof_loop() {
+        prof_start();
+        __asm__ volatile ("");
+        prof_stop();
+    }
+}
+
+void callback_call_prof() {
+    int x = 0;
+    Callback<void()> cb(no_func_arg, &x);
+
+    prof_loop() {
+        prof_start();
+        cb();
+        prof_stop();
+    }
+}
+
+void event_call_prof() {
+    EventQueue queue(64*EVENTS_EVENT_SIZE);
+
+    prof_loop() {
+        prof_start();
+        queue.call(no_func);
+        prof_stop();
+
+        queue.dispatch(0);
+    }
+}
+
+void event_dispatch_prof() {
+    EventQueue queue(64*EVENTS_EVENT_SIZE);
+
+    prof_loop() {
+        queue.call(no_func);
+
+        prof_start();
+        queue.dispatch(0);
+        prof_stop();
+    }
+}
+
+void critical_section_prof() {
+    prof_loop() {
+        prof_start();
+        core_util_critical_section_enter();
+        core_util_critical_section_exit();
+        prof_stop();
+    }
+}
+
+void atomic_incr_prof() {
+    uint32_t value = 0;
+
+    prof_loop() {
+        prof_start();
+        core_util_atomic_incr_u32(&value, 1);
+        prof_stop();
+    }
+}
+
+void mutex_prof() {
+    Mutex mutex;
+
+    prof_loop() {
+        prof_start();
+        mutex.lock();
+        mutex.unlock();
+        prof_stop();
+    }
+}
+
+void semaphore_prof() {
+    Semaphore sem(0);
+
+    prof_loop() {
+        prof_start();
+        sem.release();
+        sem.wait(0);
+        prof_stop();
+    }
+}
+
+void mail_prof() {
+    Mail<uint32_t, 8> mail;
+
+    prof_loop() {
+        prof_start();
+        uint32_t *m = mail.alloc();
+        mail.put(m);
+        osEvent evt = mail.get(0);
+        mail.free((uint32_t *)evt.value.p);
+        prof_stop();
+    }
+}
+
+void circular_buffer_prof() {
+    CircularBuffer<uint32_t, 16> buffer;
+    uint32_t value;
+
+    prof_loop() {
+        prof_start();
+        buffer.push(1);
+        buffer.pop(value);
+        prof_stop();
+    }
+}
+
+void udp_loopback_prof() {
+    PosixInterface net;
+    UDPSocket sender;
+    UDPSocket receiver;
+    char buffer[64] = {0};
+
+    net.connect();
+    sender.open(&net);
+    receiver.open(&net);
+    receiver.bind(47362);
+    receiver.set_timeout(1000);
+    SocketAddress to("127.0.0.1", 47362);
+
+    prof_loop() {
+        prof_start();
+        sender.sendto(to, buffer, sizeof(buffer));
+        receiver.recvfrom(NULL, buffer, sizeof(buffer));
+        prof_stop();
+    }
+
+    sender.close();
+    receiver.close();
+}
+
+
+int main() {
+    printf("beginning profiling...\n");
+
+    prof_baseline(baseline_prof);
+
+    prof_measure(callback_call_prof);
+    prof_measure(event_call_prof);
+    prof_measure(event_dispatch_prof);
+    prof_measure(critical_section_prof);
+    prof_measure(atomic_incr_prof);
+    prof_measure(mutex_prof);
+    prof_measure(semaphore_prof);
+    prof_measure(mail_prof);
+    prof_measure(circular_buffer_prof);
+    prof_measure(udp_loopback_prof);
+
+    printf("done!\n");
+}
@@ -0,0 +1,563 @@
+/*
+ * Testing framework for the POSIX target
+ *
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mbed.h"
+#include "platform/CircularBuffer.h"
+#include "PosixInterface.h"
+#include <stdio.h>
+#include <string.h>
+
+using namespace rtos;
+
+
+// Testing setup
+static int test_line;
+static int test_failure;
+
+// Threads left running by a failed test clean up after themselves, so the
+// failure is thrown up to test_run rather than jumped to
+#define test_assert(test) ({                                                \
+    if (!(test)) {                                                          \
+        test_line = __LINE__;                                               \
+        throw test_line;                                                    \
+    }                                                                       \
+})
+
+#define test_run(func, ...) ({                                              \
+    printf("%s: ...", #func);                                               \
+    fflush(stdout);                                                         \
+                                                                            \
+    try {                                                                   \
+        func(__VA_ARGS__);                                                  \
+        printf("\r%s: \e[32mpassed\e[0m\n", #func);                         \
+    } catch (int) {                                                         \
+        printf("\r%s: \e[31mfailed\e[0m at line %d\n", #func, test_line);   \
+        test_failure = true;                                                \
+    }                                                                       \
+})
+
+
+// Test functions
+static void simple_func(int *p) {
+    (*p)++;
+}
+
+static void sloth_func(int *p) {
+    Thread::wait(10);
+    (*p)++;
+}
+
+static void wait_func(Semaphore *sem) {
+    sem->wait();
+}
+
+static void release_func(Semaphore *sem) {
+    sem->release();
+}
+
+struct counter {
+    Mutex mutex;
+    int count;
+};
+
+static void counter_func(counter *c) {
+    for (int i = 0; i < 1000; i++) {
+        c->mutex.lock();
+        int count = c->count;
+        Thread::yield();
+        c->count = count + 1;
+        c->mutex.unlock();
+    }
+}
+
+struct mail_t {
+    int seq;
+    char text[16];
+};
+
+static void mail_func(Mail<mail_t, 4> *mail) {
+    for (int i = 0; i < 16; i++) {
+        mail_t *m = mail->alloc(osWaitForever);
+        m->seq = i;
+        snprintf(m->text, sizeof(m->text), "mail %d", i);
+        mail->put(m);
+    }
+}
+
+
+// Event tests
+void event_call_test() {
+    EventQueue queue;
+    int touched = 0;
+
+    queue.call(simple_func, &touched);
+    queue.dispatch(0);
+    test_assert(touched == 1);
+}
+
+void event_call_in_test() {
+    EventQueue queue;
+    int touched = 0;
+    Timer timer;
+
+    timer.start();
+    queue.call_in(20, simple_func, &touched);
+    queue.dispatch(10);
+    test_assert(touched == 0);
+    queue.dispatch(30);
+    test_assert(touched == 1);
+    test_assert(timer.read_ms() >= 20);
+}
+
+void event_call_every_test() {
+    EventQueue queue;
+    int touched = 0;
+
+    queue.call_every(10, simple_func, &touched);
+    queue.dispatch(55);
+    test_assert(touched >= 4 && touched <= 6);
+}
+
+void event_cancel_test() {
+    EventQueue queue;
+    int touched = 0;
+
+    int id = queue.call_in(10, simple_func, &touched);
+    queue.cancel(id);
+    queue.dispatch(20);
+    test_assert(touched == 0);
+}
+
+void event_background_test() {
+    EventQueue queue;
+    Thread thread;
+    int touched = 0;
+
+    thread.start(callback(&queue, &EventQueue::dispatch_forever));
+    for (int i = 0; i < 10; i++) {
+        queue.call(sloth_func, &touched);
+    }
+    Thread::wait(200);
+    queue.break_dispatch();
+    thread.join();
+    test_assert(touched == 10);
+}
+
+
+// RTOS tests
+void thread_join_test() {
+    Thread thread;
+    int touched = 0;
+
+    test_assert(thread.start(callback(sloth_func, &touched)) == osOK);
+    test_assert(thread.start(callback(sloth_func, &touched)) == osErrorParameter);
+    test_assert(thread.join() == osOK);
+    test_assert(touched == 1);
+    test_assert(thread.get_state() == Thread::Deleted);
+}
+
+void thread_terminate_test() {
+    Thread thread;
+    Semaphore sem(0);
+
+    // the thread is parked in a wait, and cancelled there
+    thread.start(callback(wait_func, &sem));
+    Thread::wait(10);
+    test_assert(thread.get_state() == Thread::WaitingSemaphore);
+    test_assert(thread.terminate() == osOK);
+    test_assert(thread.get_state() == Thread::Deleted);
+}
+
+void semaphore_test() {
+    Semaphore sem(0);
+    Thread thread;
+
+    test_assert(sem.wait(0) == 0);
+    test_assert(sem.wait(10) == 0);
+    thread.start(callback(release_func, &sem));
+    test_assert(sem.wait(1000) == 1);
+    thread.join();
+}
+
+void mutex_test() {
+    counter c;
+    c.count = 0;
+    Thread threads[4];
+
+    for (int i = 0; i < 4; i++) {
+        threads[i].start(callback(counter_func, &c));
+    }
+    for (int i = 0; i < 4; i++) {
+        threads[i].join();
+    }
+    test_assert(c.count == 4000);
+
+    // recursive, like the ones of RTX
+    test_assert(c.mutex.lock() == osOK);
+    test_assert(c.mutex.trylock());
+    c.mutex.unlock();
+    c.mutex.unlock();
+}
+
+static void signal_wait_func(int *touched) {
+    osEvent evt = Thread::signal_wait(0x2, 1000);
+    if (evt.status == osEventSignal) {
+        (*touched)++;
+    }
+}
+
+void signal_test() {
+    Thread thread;
+    int touched = 0;
+
+    thread.start(callback(signal_wait_func, &touched));
+    Thread::wait(10);
+    test_assert(thread.get_state() == Thread::WaitingAnd);
+    thread.signal_set(0x1);
+    Thread::wait(10);
+    test_assert(touched == 0);
+    thread.signal_set(0x2);
+    thread.join();
+    test_assert(touched == 1);
+}
+
+void event_flags_test() {
+    EventFlags flags;
+
+    flags.set(0x3);
+    test_assert(flags.wait_all(0x3, 0) == 0x3);
+    test_assert(flags.wait_any(0x1, 10) == 0);
+}
+
+void mail_test() {
+    Mail<mail_t, 4> mail;
+    Thread thread;
+
+    thread.start(callback(mail_func, &mail));
+    for (int i = 0; i < 16; i++) {
+        osEvent evt = mail.get(1000);
+        test_assert(evt.status == osEventMail);
+        mail_t *m = (mail_t *)evt.value.p;
+        char text[16];
+        snprintf(text, sizeof(text), "mail %d", i);
+        test_assert(m->seq == i);
+        test_assert(strcmp(m->text, text) == 0);
+        mail.free(m);
+    }
+    test_assert(mail.get(0).status == osOK);
+    thread.join();
+}
+
+void memory_pool_test() {
+    MemoryPool<uint64_t, 8> pool;
+    uint64_t *items[8];
+
+    for (int i = 0; i < 8; i++) {
+        items[i] = pool.alloc();
+        test_assert(items[i]);
+        test_assert(((uintptr_t)items[i] & 7) == 0);
+        *items[i] = i;
+    }
+    test_assert(!pool.alloc());
+    for (int i = 0; i < 8; i++) {
+        test_assert(*items[i] == (uint64_t)i);
+        test_assert(pool.free(items[i]) == osOK);
+    }
+    test_assert(pool.calloc());
+}
+
+void rtos_timer_test() {
+    int touched = 0;
+    RtosTimer timer(callback(simple_func, &touched), osTimerPeriodic);
+
+    test_assert(timer.start(10) == osOK);
+    Thread::wait(55);
+    test_assert(timer.stop() == osOK);
+    int count = touched;
+    test_assert(count >= 4 && count <= 6);
+    Thread::wait(20);
+    test_assert(touched == count);
+}
+
+
+// Platform tests
+void callback_test() {
+    int touched = 0;
+    Callback<void(int *)> cb(simple_func);
+    cb(&touched);
+    Callback<void()> bound(simple_func, &touched);
+    bound();
+    test_assert(touched == 2);
+
+    Callback<void()> empty;
+    test_assert(!empty);
+    test_assert(bound);
+}
+
+void circular_buffer_test() {
+    CircularBuffer<int, 4> buffer;
+    int value;
+
+    test_assert(buffer.empty());
+    test_assert(!buffer.pop(value));
+    for (int i = 0; i < 6; i++) {
+        buffer.push(i);
+    }
+    // the oldest are overwritten
+    test_assert(buffer.full());
+    for (int i = 2; i < 6; i++) {
+        test_assert(buffer.pop(value));
+        test_assert(value == i);
+    }
+    test_assert(buffer.empty());
+}
+
+void critical_section_test() {
+    core_util_critical_section_enter();
+    test_assert(!core_util_are_interrupts_enabled());
+    core_util_critical_section_enter();
+    core_util_critical_section_exit();
+    test_assert(!core_util_are_interrupts_enabled());
+    core_util_critical_section_exit();
+    test_assert(core_util_are_interrupts_enabled());
+
+    void *p = 0;
+    void *expected = 0;
+    test_assert(core_util_atomic_cas_ptr(&p, &expected, &p));
+    test_assert(p == &p);
+    test_assert(core_util_atomic_load_ptr(&p) == &p);
+}
+
+void fast_gpio_test() {
+    FastDigitalOut<LED1> led(1);
+    test_assert(led.read() == 1);
+    test_assert(posix_gpio_level[LED1] == 1);
+    led.toggle();
+    test_assert(led == 0);
+    led = 1;
+    test_assert(posix_gpio_level[LED1] == 1);
+
+    FastDigitalIn<P0_3, PullUp> up;
+    FastDigitalIn<P0_4, PullDown> down;
+    test_assert(up.read() == 1);
+    test_assert(down == 0);
+    posix_gpio_level[P0_4] = 1;
+    test_assert(down == 1);
+}
+
+void timer_test() {
+    Timer timer;
+
+    timer.start();
+    Thread::wait(20);
+    timer.stop();
+    test_assert(timer.read_us() >= 20000);
+    test_assert(timer.read_us() < 200000);
+}
+
+
+// Netsocket tests
+static void echo_func(TCPServer *server) {
+    TCPSocket client;
+    char buffer[256];
+
+    if (server->accept(&client) != 0) {
+        return;
+    }
+    while (true) {
+        int n = client.recv(buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
+        client.send(buffer, n);
+    }
+    client.close();
+}
+
+void tcp_echo_test() {
+    PosixInterface net;
+    test_assert(net.connect() == 0);
+    test_assert(net.get_connection_status() == NSAPI_STATUS_GLOBAL_UP);
+
+    TCPServer server;
+    test_assert(server.open(&net) == 0);
+    int reuse = 1;
+    test_assert(server.setsockopt(NSAPI_SOCKET, NSAPI_REUSEADDR, &reuse, sizeof(reuse)) == 0);
+    test_assert(server.bind(47360) == 0);
+    test_assert(server.listen(1) == 0);
+
+    Thread thread;
+    thread.start(callback(echo_func, &server));
+
+    TCPSocket socket;
+    test_assert(socket.open(&net) == 0);
+    test_assert(socket.connect("127.0.0.1", 47360) == 0);
+    socket.set_timeout(1000);
+
+    char data[1000];
+    char buffer[1000];
+    for (unsigned i = 0; i < sizeof(data); i++) {
+        data[i] = (char)i;
+    }
+    test_assert(socket.send(data, sizeof(data)) == (int)sizeof(data));
+
+    unsigned received = 0;
+    while (received < sizeof(buffer)) {
+        int n = socket.recv(buffer + received, sizeof(buffer) - received);
+        test_assert(n > 0);
+        received += n;
+    }
+    test_assert(memcmp(data, buffer, sizeof(data)) == 0);
+
+    nsapi_stack_stats_t stats;
+    test_assert(net.get_stats(&stats) == 0);
+    test_assert(stats.tx_bytes >= 2 * sizeof(data));
+
+    socket.close();
+    thread.join();
+    server.close();
+    net.disconnect();
+}
+
+void udp_echo_test() {
+    PosixInterface net;
+    test_assert(net.connect() == 0);
+
+    UDPSocket server;
+    UDPSocket client;
+    test_assert(server.open(&net) == 0);
+    test_assert(client.open(&net) == 0);
+    test_assert(server.bind(47361) == 0);
+    server.set_timeout(1000);
+    client.set_timeout(1000);
+
+    SocketAddress to("127.0.0.1", 47361);
+    test_assert(client.sendto(to, "ping", 4) == 4);
+
+    char buffer[16];
+    SocketAddress from;
+    test_assert(server.recvfrom(&from, buffer, sizeof(buffer)) == 4);
+    test_assert(memcmp(buffer, "ping", 4) == 0);
+    test_assert(strcmp(from.get_ip_address(), "127.0.0.1") == 0);
+    test_assert(server.sendto(from, "pong", 4) == 4);
+    test_assert(client.recvfrom(NULL, buffer, sizeof(buffer)) == 4);
+    test_assert(memcmp(buffer, "pong", 4) == 0);
+
+    // nothing more to receive
+    client.set_timeout(10);
+    test_assert(client.recvfrom(NULL, buffer, sizeof(buffer)) == NSAPI_ERROR_WOULD_BLOCK);
+
+    client.close();
+    server.close();
+}
+
+void udp_batch_test() {
+    PosixInterface net;
+    test_assert(net.connect() == 0);
+
+    UDPSocket server;
+    UDPSocket client;
+    test_assert(server.open(&net) == 0);
+    test_assert(client.open(&net) == 0);
+    test_assert(server.bind(47362) == 0);
+    server.set_timeout(1000);
+    client.set_timeout(1000);
+
+    // more packets than a single system call of the stack takes
+    const unsigned count = 20;
+    char out[count][8];
+    char in[count + 2][8];
+    nsapi_mmsg_t msgs[count + 2];
+
+    SocketAddress to("127.0.0.1", 47362);
+    memset(msgs, 0, sizeof(msgs));
+    for (unsigned i = 0; i < count; i++) {
+        sprintf(out[i], "msg%u", i);
+        msgs[i].data = out[i];
+        msgs[i].size = strlen(out[i]);
+        msgs[i].addr = to.get_addr();
+        msgs[i].port = to.get_port();
+    }
+    // the last one does not fit in its receive buffer
+    msgs[count - 1].size = sizeof(out[count - 1]);
+    test_assert(client.sendmmsg(msgs, count) == (int)count);
+    test_assert(msgs[0].len == 4 && msgs[count - 2].len == 5);
+
+    memset(msgs, 0, sizeof(msgs));
+    for (unsigned i = 0; i < count + 2; i++) {
+        msgs[i].data = in[i];
+        msgs[i].size = (i == count - 1) ? 4 : sizeof(in[i]);
+    }
+
+    unsigned recv = 0;
+    while (recv < count) {
+        int ret = server.recvmmsg(&msgs[recv], count + 2 - recv);
+        test_assert(ret > 0);
+        if (ret <= 0) {
+            break;
+        }
+        recv += ret;
+    }
+    test_assert(recv == count);
+
+    for (unsigned i = 0; i < count - 1; i++) {
+        test_assert(msgs[i].len == strlen(out[i]));
+        test_assert(memcmp(in[i], out[i], msgs[i].len) == 0);
+        test_assert(msgs[i].flags == 0);
+        test_assert(strcmp(SocketAddress(msgs[i].addr).get_ip_address(), "127.0.0.1") == 0);
+    }
+    test_assert(msgs[count - 1].len == 4);
+    test_assert(msgs[count - 1].flags & NSAPI_MSG_TRUNC);
+
+    // nothing more to receive
+    server.set_timeout(10);
+    test_assert(server.recvmmsg(msgs, count) == NSAPI_ERROR_WOULD_BLOCK);
+
+    client.close();
+    server.close();
+}
+
+
+int main() {
+    printf("beginning tests...\n");
+
+    test_run(event_call_test);
+    test_run(event_call_in_test);
+    test_run(event_call_every_test);
+    test_run(event_cancel_test);
+    test_run(event_background_test);
+    test_run(thread_join_test);
+    test_run(thread_terminate_test);
+    test_run(semaphore_test);
+    test_run(mutex_test);
+    test_run(signal_test);
+    test_run(event_flags_test);
+    test_run(mail_test);
+    test_run(memory_pool_test);
+    test_run(rtos_timer_test);
+    test_run(callback_test);
+    test_run(circular_buffer_test);
+    test_run(critical_section_test);
+    test_run(fast_gpio_test);
+    test_run(timer_test);
+    test_run(tcp_echo_test);
+    test_run(udp_echo_test);
+    test_run(udp_batch_test);
+
+    printf("done!\n");
+    return test_failure;
+}
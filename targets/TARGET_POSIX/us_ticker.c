@@ -0,0 +1,138 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stddef.h>
+#include "hal/us_ticker_api.h"
+#include "cmsis.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+/* The counter is the monotonic clock of the host. The match interrupt is
+ * taken by a thread, which runs the handler with the interrupts disabled. */
+static pthread_mutex_t ticker_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ticker_cond;
+static pthread_t ticker_thread;
+static uint64_t ticker_base;
+static timestamp_t ticker_match;
+static volatile int ticker_armed;
+
+int us_ticker_inited = 0;
+
+static uint64_t ticker_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Called with ticker_lock held, true once the match time has come */
+static int ticker_due(void)
+{
+    return ticker_armed && (int32_t)(ticker_match - us_ticker_read()) <= 0;
+}
+
+static void *ticker_irq_thread(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&ticker_lock);
+    while (1) {
+        if (!ticker_armed) {
+            pthread_cond_wait(&ticker_cond, &ticker_lock);
+            continue;
+        }
+
+        int32_t delta = (int32_t)(ticker_match - us_ticker_read());
+        if (delta > 0) {
+            uint64_t deadline = ticker_base + us_ticker_read() + delta;
+            struct timespec ts;
+            ts.tv_sec = deadline / 1000000;
+            ts.tv_nsec = (deadline % 1000000) * 1000;
+            pthread_cond_timedwait(&ticker_cond, &ticker_lock, &ts);
+            continue;
+        }
+
+        // The interrupt is taken as a critical section would be entered,
+        // the match may have been moved meanwhile
+        pthread_mutex_unlock(&ticker_lock);
+        __disable_irq();
+        pthread_mutex_lock(&ticker_lock);
+        int fire = ticker_due();
+        if (fire) {
+            ticker_armed = 0;
+        }
+        pthread_mutex_unlock(&ticker_lock);
+
+        if (fire) {
+            us_ticker_irq_handler();
+        }
+
+        __enable_irq();
+        pthread_mutex_lock(&ticker_lock);
+    }
+    return NULL;
+}
+
+void us_ticker_init(void)
+{
+    if (us_ticker_inited) {
+        return;
+    }
+
+    pthread_mutex_lock(&ticker_lock);
+    if (!us_ticker_inited) {
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&ticker_cond, &attr);
+        pthread_condattr_destroy(&attr);
+
+        ticker_base = ticker_now();
+        pthread_create(&ticker_thread, NULL, ticker_irq_thread, NULL);
+        pthread_detach(ticker_thread);
+        us_ticker_inited = 1;
+    }
+    pthread_mutex_unlock(&ticker_lock);
+}
+
+uint32_t us_ticker_read()
+{
+    if (!us_ticker_inited) {
+        us_ticker_init();
+    }
+
+    return (uint32_t)(ticker_now() - ticker_base);
+}
+
+void us_ticker_set_interrupt(timestamp_t timestamp)
+{
+    pthread_mutex_lock(&ticker_lock);
+    ticker_match = timestamp;
+    ticker_armed = 1;
+    pthread_cond_signal(&ticker_cond);
+    pthread_mutex_unlock(&ticker_lock);
+}
+
+void us_ticker_disable_interrupt(void)
+{
+    pthread_mutex_lock(&ticker_lock);
+    ticker_armed = 0;
+    pthread_mutex_unlock(&ticker_lock);
+}
+
+void us_ticker_clear_interrupt(void)
+{
+}
@@ -896,7 +896,7 @@ int serial_irq_handler_asynch(serial_t *obj)
         if (buf != NULL) {
             for (i = 0; i < obj->rx_buff.pos; i++) {
                 if (buf[i] == obj->char_match) {
-                    obj->rx_buff.pos = i;
+                    obj->rx_buff.pos = i + 1;
                     return_event |= (SERIAL_EVENT_RX_CHARACTER_MATCH & obj_s->events);
                     serial_rx_abort_asynch(obj);
                     break;
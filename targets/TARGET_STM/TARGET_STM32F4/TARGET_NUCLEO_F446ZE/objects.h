@@ -52,6 +52,7 @@ struct port_s {
     PinDirection direction;
     __IO uint32_t *reg_in;
     __IO uint32_t *reg_out;
+    __IO uint32_t *reg_set;
 };
 
 struct analogin_s {
@@ -38,6 +38,36 @@
 
 ADC_HandleTypeDef AdcHandle;
 
+// Single software triggered conversions
+static void adc_init_single(ADCName adc)
+{
+    AdcHandle.Instance = (ADC_TypeDef *)(adc);
+    AdcHandle.Init.ClockPrescaler        = ADC_CLOCKPRESCALER_PCLK_DIV2;
+    AdcHandle.Init.Resolution            = ADC_RESOLUTION12b;
+    AdcHandle.Init.ScanConvMode          = DISABLE;
+    AdcHandle.Init.ContinuousConvMode    = DISABLE;
+    AdcHandle.Init.DiscontinuousConvMode = DISABLE;
+    AdcHandle.Init.NbrOfDiscConversion   = 0;
+    AdcHandle.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_NONE;
+    AdcHandle.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T1_CC1;
+    AdcHandle.Init.DataAlign             = ADC_DATAALIGN_RIGHT;
+    AdcHandle.Init.NbrOfConversion       = 1;
+    AdcHandle.Init.DMAContinuousRequests = DISABLE;
+    AdcHandle.Init.EOCSelection          = DISABLE;
+
+    if (HAL_ADC_Init(&AdcHandle) != HAL_OK) {
+        error("Cannot initialize ADC\n");
+    }
+}
+
+static const uint32_t adc_channels[] = {
+    ADC_CHANNEL_0, ADC_CHANNEL_1, ADC_CHANNEL_2, ADC_CHANNEL_3,
+    ADC_CHANNEL_4, ADC_CHANNEL_5, ADC_CHANNEL_6, ADC_CHANNEL_7,
+    ADC_CHANNEL_8, ADC_CHANNEL_9, ADC_CHANNEL_10, ADC_CHANNEL_11,
+    ADC_CHANNEL_12, ADC_CHANNEL_13, ADC_CHANNEL_14, ADC_CHANNEL_15,
+    ADC_CHANNEL_TEMPSENSOR, ADC_CHANNEL_VREFINT, ADC_CHANNEL_VBAT
+};
+
 void analogin_init(analogin_t *obj, PinName pin)
 {
 #if defined(ADC1)
@@ -89,24 +119,7 @@ void analogin_init(analogin_t *obj, PinName pin)
         adc3_inited = 1;
     }
 #endif
-    // Configure ADC
-    AdcHandle.Instance = (ADC_TypeDef *)(obj->adc);
-    AdcHandle.Init.ClockPrescaler        = ADC_CLOCKPRESCALER_PCLK_DIV2;
-    AdcHandle.Init.Resolution            = ADC_RESOLUTION12b;
-    AdcHandle.Init.ScanConvMode          = DISABLE;
-    AdcHandle.Init.ContinuousConvMode    = DISABLE;
-    AdcHandle.Init.DiscontinuousConvMode = DISABLE;
-    AdcHandle.Init.NbrOfDiscConversion   = 0;
-    AdcHandle.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_NONE;
-    AdcHandle.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T1_CC1;
-    AdcHandle.Init.DataAlign             = ADC_DATAALIGN_RIGHT;
-    AdcHandle.Init.NbrOfConversion       = 1;
-    AdcHandle.Init.DMAContinuousRequests = DISABLE;
-    AdcHandle.Init.EOCSelection          = DISABLE;
-
-    if (HAL_ADC_Init(&AdcHandle) != HAL_OK) {
-        error("Cannot initialize ADC\n");
-    }
+    adc_init_single(obj->adc);
 }
 
 static inline uint16_t adc_read(analogin_t *obj)
@@ -120,67 +133,10 @@ static inline uint16_t adc_read(analogin_t *obj)
     sConfig.SamplingTime = ADC_SAMPLETIME_15CYCLES;
     sConfig.Offset       = 0;
 
-    switch (obj->channel) {
-        case 0:
-            sConfig.Channel = ADC_CHANNEL_0;
-            break;
-        case 1:
-            sConfig.Channel = ADC_CHANNEL_1;
-            break;
-        case 2:
-            sConfig.Channel = ADC_CHANNEL_2;
-            break;
-        case 3:
-            sConfig.Channel = ADC_CHANNEL_3;
-            break;
-        case 4:
-            sConfig.Channel = ADC_CHANNEL_4;
-            break;
-        case 5:
-            sConfig.Channel = ADC_CHANNEL_5;
-            break;
-        case 6:
-            sConfig.Channel = ADC_CHANNEL_6;
-            break;
-        case 7:
-            sConfig.Channel = ADC_CHANNEL_7;
-            break;
-        case 8:
-            sConfig.Channel = ADC_CHANNEL_8;
-            break;
-        case 9:
-            sConfig.Channel = ADC_CHANNEL_9;
-            break;
-        case 10:
-            sConfig.Channel = ADC_CHANNEL_10;
-            break;
-        case 11:
-            sConfig.Channel = ADC_CHANNEL_11;
-            break;
-        case 12:
-            sConfig.Channel = ADC_CHANNEL_12;
-            break;
-        case 13:
-            sConfig.Channel = ADC_CHANNEL_13;
-            break;
-        case 14:
-            sConfig.Channel = ADC_CHANNEL_14;
-            break;
-        case 15:
-            sConfig.Channel = ADC_CHANNEL_15;
-            break;
-        case 16:
-            sConfig.Channel = ADC_CHANNEL_TEMPSENSOR;
-            break;
-        case 17:
-            sConfig.Channel = ADC_CHANNEL_VREFINT;
-            break;
-        case 18:
-            sConfig.Channel = ADC_CHANNEL_VBAT;
-            break;
-        default:
-            return 0;
+    if (obj->channel >= sizeof(adc_channels) / sizeof(adc_channels[0])) {
+        return 0;
     }
+    sConfig.Channel = adc_channels[obj->channel];
 
     HAL_ADC_ConfigChannel(&AdcHandle, &sConfig);
 
@@ -208,4 +164,179 @@ float analogin_read(analogin_t *obj)
     return (float)value * (1.0f / (float)0xFFF); // 12 bits range
 }
 
+#if DEVICE_ANALOGIN_ASYNCH
+
+/* Streams run on ADC1, triggered by the TIM2 update event, with DMA2
+ * stream 0 channel 0, which every STM32F4 routes to ADC1. TIM2 cannot be
+ * used for PWM meanwhile. The handler is set on both the DMA and the ADC
+ * interrupts, the ADC one reporting overruns. */
+static DMA_HandleTypeDef AdcDmaHandle;
+static TIM_HandleTypeDef AdcTimHandle;
+static volatile uint32_t adc_stream_events;
+static uint32_t adc_stream_event_mask;
+static volatile uint8_t adc_stream_running;
+
+static void adc_stream_half(DMA_HandleTypeDef *hdma)
+{
+    adc_stream_events |= ANALOGIN_EVENT_HALF_COMPLETE;
+}
+
+static void adc_stream_full(DMA_HandleTypeDef *hdma)
+{
+    adc_stream_events |= ANALOGIN_EVENT_COMPLETE;
+}
+
+static void adc_stream_error(DMA_HandleTypeDef *hdma)
+{
+    adc_stream_events |= ANALOGIN_EVENT_ERROR;
+}
+
+// Clock of the APB1 timers, twice PCLK1 when APB1 is divided
+static uint32_t adc_stream_timer_clock(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        pclk1 *= 2;
+    }
+    return pclk1;
+}
+
+int analogin_stream_start(analogin_t *const *channels, int count, uint16_t *buffer, size_t length, uint32_t hz, uint32_t handler, uint32_t event)
+{
+    ADC_ChannelConfTypeDef sConfig = {0};
+
+    if (adc_stream_running || count < 1 || count > 16 || hz == 0 ||
+            length == 0 || length % (2 * count) != 0 || length > 0xFFFF) {
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (channels[i]->adc != ADC_1 ||
+                channels[i]->channel >= sizeof(adc_channels) / sizeof(adc_channels[0])) {
+            return -1;
+        }
+    }
+
+    // 15 sampling and 12 conversion cycles per channel, at PCLK2 / 2
+    uint32_t adc_clock = HAL_RCC_GetPCLK2Freq() / 2;
+    uint32_t timer_clock = adc_stream_timer_clock();
+    if ((uint64_t)hz * count * (15 + 12) > adc_clock || hz > timer_clock) {
+        return -1;
+    }
+
+    // Scan of all the channels on each trigger, left aligned to 16 bits
+    AdcHandle.Instance = ADC1;
+    AdcHandle.Init.ScanConvMode          = ENABLE;
+    AdcHandle.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_RISING;
+    AdcHandle.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T2_TRGO;
+    AdcHandle.Init.DataAlign             = ADC_DATAALIGN_LEFT;
+    AdcHandle.Init.NbrOfConversion       = count;
+    AdcHandle.Init.DMAContinuousRequests = ENABLE;
+    AdcHandle.Init.EOCSelection          = DISABLE;
+    if (HAL_ADC_Init(&AdcHandle) != HAL_OK) {
+        adc_init_single(ADC_1);
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        sConfig.Channel      = adc_channels[channels[i]->channel];
+        sConfig.Rank         = i + 1;
+        sConfig.SamplingTime = ADC_SAMPLETIME_15CYCLES;
+        sConfig.Offset       = 0;
+        HAL_ADC_ConfigChannel(&AdcHandle, &sConfig);
+    }
+
+    __HAL_RCC_DMA2_CLK_ENABLE();
+    AdcDmaHandle.Instance                 = DMA2_Stream0;
+    AdcDmaHandle.Init.Channel             = DMA_CHANNEL_0;
+    AdcDmaHandle.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    AdcDmaHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    AdcDmaHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    AdcDmaHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    AdcDmaHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    AdcDmaHandle.Init.Mode                = DMA_CIRCULAR;
+    AdcDmaHandle.Init.Priority            = DMA_PRIORITY_HIGH;
+    AdcDmaHandle.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    HAL_DMA_DeInit(&AdcDmaHandle);
+    if (HAL_DMA_Init(&AdcDmaHandle) != HAL_OK) {
+        adc_init_single(ADC_1);
+        return -1;
+    }
+    AdcDmaHandle.XferHalfCpltCallback = adc_stream_half;
+    AdcDmaHandle.XferCpltCallback     = adc_stream_full;
+    AdcDmaHandle.XferErrorCallback    = adc_stream_error;
+
+    adc_stream_events = 0;
+    adc_stream_event_mask = event;
+    NVIC_SetVector(DMA2_Stream0_IRQn, handler);
+    NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+    HAL_DMA_Start_IT(&AdcDmaHandle, (uint32_t)&ADC1->DR, (uint32_t)buffer, length);
+
+    ADC1->SR = ~(ADC_SR_OVR | ADC_SR_EOC | ADC_SR_STRT);
+    ADC1->CR1 |= ADC_CR1_OVRIE;
+    NVIC_SetVector(ADC_IRQn, handler);
+    NVIC_ClearPendingIRQ(ADC_IRQn);
+    NVIC_EnableIRQ(ADC_IRQn);
+    ADC1->CR2 |= ADC_CR2_DMA | ADC_CR2_DDS;
+    __HAL_ADC_ENABLE(&AdcHandle);
+
+    __HAL_RCC_TIM2_CLK_ENABLE();
+    AdcTimHandle.Instance               = TIM2;
+    AdcTimHandle.Init.Prescaler         = 0;
+    AdcTimHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    AdcTimHandle.Init.Period            = timer_clock / hz - 1;
+    AdcTimHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    AdcTimHandle.Init.RepetitionCounter = 0;
+    HAL_TIM_Base_Init(&AdcTimHandle);
+
+    TIM_MasterConfigTypeDef master = {0};
+    master.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    master.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+    HAL_TIMEx_MasterConfigSynchronization(&AdcTimHandle, &master);
+
+    adc_stream_running = 1;
+    HAL_TIM_Base_Start(&AdcTimHandle);
+    return 0;
+}
+
+int analogin_stream_irq_handler(analogin_t *obj)
+{
+    adc_stream_events = 0;
+    HAL_DMA_IRQHandler(&AdcDmaHandle);
+
+    // The ADC stops requesting DMA after an overrun, which raises the ADC
+    // interrupt rather than the DMA one
+    if ((ADC1->CR1 & ADC_CR1_OVRIE) && (ADC1->SR & ADC_SR_OVR)) {
+        adc_stream_events |= ANALOGIN_EVENT_ERROR;
+    }
+    if (adc_stream_events & ANALOGIN_EVENT_ERROR) {
+        analogin_stream_stop(obj);
+    }
+    return adc_stream_events & adc_stream_event_mask;
+}
+
+void analogin_stream_stop(analogin_t *obj)
+{
+    if (!adc_stream_running) {
+        return;
+    }
+    adc_stream_running = 0;
+
+    HAL_TIM_Base_Stop(&AdcTimHandle);
+    __HAL_ADC_DISABLE(&AdcHandle);
+    ADC1->CR2 &= ~(ADC_CR2_DMA | ADC_CR2_DDS);
+    ADC1->CR1 &= ~ADC_CR1_OVRIE;
+    NVIC_DisableIRQ(ADC_IRQn);
+    NVIC_DisableIRQ(DMA2_Stream0_IRQn);
+    HAL_DMA_Abort(&AdcDmaHandle);
+    ADC1->SR = ~(ADC_SR_OVR | ADC_SR_EOC | ADC_SR_STRT);
+
+    adc_init_single(ADC_1);
+}
+
+uint8_t analogin_stream_active(analogin_t *obj)
+{
+    return adc_stream_running;
+}
+
+#endif
+
 #endif
@@ -144,4 +144,190 @@ uint16_t analogout_read_u16(dac_t *obj) {
     return (value << 4) | ((value >> 8) & 0x000F); // Conversion from 12 to 16 bits
 }
 
+#if DEVICE_ANALOGOUT_ASYNCH
+
+/* TIM6 triggers the conversions, TIM7 is the sample timer. DMA1 stream 5
+ * feeds channel 1 and stream 6 channel 2, both on DMA channel 7. With one
+ * timer, one channel plays at a time. The handler is set on both the DMA
+ * and the TIM6_DAC interrupts, the latter reporting DMA underruns. */
+typedef struct {
+    DMA_HandleTypeDef dma;
+    TIM_HandleTypeDef tim;
+    const uint16_t *buffer;
+    size_t length;
+    uint32_t event_mask;
+    volatile uint32_t events;
+    volatile uint8_t running;
+    uint8_t circular;
+    uint8_t channel;
+} dac_stream_t;
+
+static dac_stream_t dac_stream;
+
+static void dac_stream_half(DMA_HandleTypeDef *hdma)
+{
+    dac_stream_t *stream = (dac_stream_t *)hdma->Parent;
+    stream->events |= ANALOGOUT_EVENT_HALF_COMPLETE;
+}
+
+static void dac_stream_full(DMA_HandleTypeDef *hdma)
+{
+    dac_stream_t *stream = (dac_stream_t *)hdma->Parent;
+    stream->events |= ANALOGOUT_EVENT_COMPLETE;
+}
+
+static void dac_stream_error(DMA_HandleTypeDef *hdma)
+{
+    dac_stream_t *stream = (dac_stream_t *)hdma->Parent;
+    stream->events |= ANALOGOUT_EVENT_ERROR;
+}
+
+// Clock of the APB1 timers, twice PCLK1 when APB1 is divided
+static uint32_t dac_stream_timer_clock(void)
+{
+    uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+    if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+        pclk1 *= 2;
+    }
+    return pclk1;
+}
+
+int analogout_stream_start(dac_t *obj, const uint16_t *buffer, size_t length, uint32_t hz, uint8_t circular, uint32_t handler, uint32_t event)
+{
+    dac_stream_t *stream = &dac_stream;
+    int ch1 = (obj->channel == 1);
+    uint32_t shift = ch1 ? 0 : 16;
+    IRQn_Type irq = ch1 ? DMA1_Stream5_IRQn : DMA1_Stream6_IRQn;
+    uint32_t timer_clock = dac_stream_timer_clock();
+    uint32_t prescaler = 1;
+    uint32_t period;
+
+    if (stream->running || length == 0 || length > 0xFFFF || hz == 0 || hz > timer_clock) {
+        return -1;
+    }
+    period = timer_clock / hz;
+    while (period / prescaler > 0x10000) {
+        prescaler++;
+    }
+
+    stream->buffer = buffer;
+    stream->length = length;
+    stream->event_mask = event;
+    stream->events = 0;
+    stream->circular = circular;
+    stream->channel = obj->channel;
+
+    // Timer triggered conversions
+    sConfig.DAC_Trigger = DAC_TRIGGER_T6_TRGO;
+    sConfig.DAC_OutputBuffer = DAC_OUTPUTBUFFER_ENABLE;
+    if (HAL_DAC_ConfigChannel(&DacHandle, &sConfig, ch1 ? DAC_CHANNEL_1 : DAC_CHANNEL_2) != HAL_OK) {
+        return -1;
+    }
+
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    stream->dma.Instance                 = ch1 ? DMA1_Stream5 : DMA1_Stream6;
+    stream->dma.Init.Channel             = DMA_CHANNEL_7;
+    stream->dma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    stream->dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    stream->dma.Init.MemInc              = DMA_MINC_ENABLE;
+    stream->dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    stream->dma.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    stream->dma.Init.Mode                = circular ? DMA_CIRCULAR : DMA_NORMAL;
+    stream->dma.Init.Priority            = DMA_PRIORITY_HIGH;
+    stream->dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    HAL_DMA_DeInit(&stream->dma);
+    if (HAL_DMA_Init(&stream->dma) != HAL_OK) {
+        analogout_stream_stop(obj);
+        return -1;
+    }
+    stream->dma.Parent               = stream;
+    stream->dma.XferHalfCpltCallback = dac_stream_half;
+    stream->dma.XferCpltCallback     = dac_stream_full;
+    stream->dma.XferErrorCallback    = dac_stream_error;
+
+    NVIC_SetVector(irq, handler);
+    NVIC_EnableIRQ(irq);
+    // 16-bit samples into the left aligned 12-bit register
+    HAL_DMA_Start_IT(&stream->dma, (uint32_t)buffer,
+                     ch1 ? (uint32_t)&DAC->DHR12L1 : (uint32_t)&DAC->DHR12L2, length);
+    DAC->SR = DAC_SR_DMAUDR1 << shift;
+    DAC->CR |= (DAC_CR_DMAEN1 | DAC_CR_DMAUDRIE1) << shift;
+    NVIC_SetVector(TIM6_DAC_IRQn, handler);
+    NVIC_ClearPendingIRQ(TIM6_DAC_IRQn);
+    NVIC_EnableIRQ(TIM6_DAC_IRQn);
+
+    __HAL_RCC_TIM6_CLK_ENABLE();
+    stream->tim.Instance               = TIM6;
+    stream->tim.Init.Prescaler         = prescaler - 1;
+    stream->tim.Init.CounterMode       = TIM_COUNTERMODE_UP;
+    stream->tim.Init.Period            = period / prescaler - 1;
+    stream->tim.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+    stream->tim.Init.RepetitionCounter = 0;
+    HAL_TIM_Base_Init(&stream->tim);
+
+    TIM_MasterConfigTypeDef master = {0};
+    master.MasterOutputTrigger = TIM_TRGO_UPDATE;
+    master.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+    HAL_TIMEx_MasterConfigSynchronization(&stream->tim, &master);
+
+    stream->running = 1;
+    HAL_TIM_Base_Start(&stream->tim);
+    return 0;
+}
+
+int analogout_stream_irq_handler(dac_t *obj)
+{
+    dac_stream_t *stream = &dac_stream;
+    uint32_t shift = (obj->channel == 1) ? 0 : 16;
+
+    stream->events = 0;
+    HAL_DMA_IRQHandler(&stream->dma);
+
+    // An underrun stops the DMA requests, it raises the TIM6_DAC interrupt
+    // rather than the DMA one
+    if ((DAC->CR & (DAC_CR_DMAUDRIE1 << shift)) && (DAC->SR & (DAC_SR_DMAUDR1 << shift))) {
+        stream->events |= ANALOGOUT_EVENT_ERROR;
+    }
+    uint32_t events = stream->events;
+    if ((events & ANALOGOUT_EVENT_ERROR) ||
+            (!stream->circular && (events & ANALOGOUT_EVENT_COMPLETE))) {
+        analogout_stream_stop(obj);
+    }
+    return events & stream->event_mask;
+}
+
+void analogout_stream_stop(dac_t *obj)
+{
+    dac_stream_t *stream = &dac_stream;
+    int ch1 = (obj->channel == 1);
+    uint32_t shift = ch1 ? 0 : 16;
+
+    if (!stream->running || stream->channel != obj->channel) {
+        return;
+    }
+    stream->running = 0;
+
+    HAL_TIM_Base_Stop(&stream->tim);
+    NVIC_DisableIRQ(TIM6_DAC_IRQn);
+    NVIC_DisableIRQ(ch1 ? DMA1_Stream5_IRQn : DMA1_Stream6_IRQn);
+    HAL_DMA_Abort(&stream->dma);
+    DAC->CR &= ~((DAC_CR_DMAEN1 | DAC_CR_DMAUDRIE1) << shift);
+    DAC->SR = DAC_SR_DMAUDR1 << shift;
+
+    // Back to immediate writes, the last sample the DMA loaded goes out now
+    uint32_t last = ch1 ? DAC->DHR12L1 : DAC->DHR12L2;
+    sConfig.DAC_Trigger = DAC_TRIGGER_NONE;
+    sConfig.DAC_OutputBuffer = DAC_OUTPUTBUFFER_ENABLE;
+    HAL_DAC_ConfigChannel(&DacHandle, &sConfig, ch1 ? DAC_CHANNEL_1 : DAC_CHANNEL_2);
+    __HAL_DAC_ENABLE(&DacHandle, ch1 ? DAC_CHANNEL_1 : DAC_CHANNEL_2);
+    HAL_DAC_SetValue(&DacHandle, ch1 ? DAC_CHANNEL_1 : DAC_CHANNEL_2, DAC_ALIGN_12B_L, last);
+}
+
+uint8_t analogout_stream_active(dac_t *obj)
+{
+    return dac_stream.running && dac_stream.channel == obj->channel;
+}
+
+#endif
+
 #endif // DEVICE_ANALOGOUT
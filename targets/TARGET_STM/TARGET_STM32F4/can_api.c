@@ -250,6 +250,15 @@ int can_read(can_t *obj, CAN_Message *msg, int handle)
     //handle is the FIFO number
 
     CAN_TypeDef *can = (CAN_TypeDef *)(obj->can);    
+
+    /* No message pending */
+    if (handle == CAN_FIFO0) {
+        if ((can->RF0R & CAN_RF0R_FMP0) == 0) {
+            return 0;
+        }
+    } else if ((can->RF1R & CAN_RF1R_FMP1) == 0) {
+        return 0;
+    }
     
     /* Get the Id */
     msg->format = (CANFormat)((uint8_t)0x04 & can->sFIFOMailBox[handle].RIR);
@@ -381,6 +390,67 @@ int can_filter(can_t *obj, uint32_t id, uint32_t mask, CANFormat format, int32_t
     return 0;
 }
 
+/* The 28 filter banks are in the CAN1 registers, split in half between
+ * CAN1 and CAN2. All banks are 32-bit wide and feed FIFO 0, which can_read
+ * reads by default. */
+#define CAN_BANKS_PER_CAN   14
+
+static uint32_t can_filter_reg(uint32_t id, CANFormat format)
+{
+    if (format == CANExtended) {
+        return (id << 3) | CAN_ID_EXT;
+    }
+    return id << 21;
+}
+
+int can_filter_banks(can_t *obj)
+{
+    return CAN_BANKS_PER_CAN;
+}
+
+int can_filter_bank(can_t *obj, int bank, CanFilterMode mode, uint32_t id, uint32_t mask, CANFormat format)
+{
+    CAN_TypeDef *can = CAN1;
+    uint32_t fr1, fr2;
+
+    if (bank < 0 || bank >= CAN_BANKS_PER_CAN) {
+        return 0;
+    }
+    if (mode == CAN_FILTER_LIST && format == CANAny) {
+        return 0;
+    }
+    fr1 = can_filter_reg(id, format);
+    fr2 = can_filter_reg(mask, format);
+    if (mode == CAN_FILTER_MASK && format != CANAny) {
+        // the IDE bit must match too
+        fr2 |= CAN_ID_EXT;
+    }
+
+    uint32_t n = bank + obj->index * CAN_BANKS_PER_CAN;
+    uint32_t bit = 1U << n;
+
+    can->FMR |= CAN_FMR_FINIT;
+#ifdef CAN_FMR_CAN2SB
+    can->FMR = (can->FMR & ~CAN_FMR_CAN2SB) | (CAN_BANKS_PER_CAN << 8);
+#endif
+    can->FA1R &= ~bit;
+    if (mode != CAN_FILTER_OFF) {
+        can->FS1R |= bit;
+        if (mode == CAN_FILTER_LIST) {
+            can->FM1R |= bit;
+        } else {
+            can->FM1R &= ~bit;
+        }
+        can->FFA1R &= ~bit;
+        can->sFilterRegister[n].FR1 = fr1;
+        can->sFilterRegister[n].FR2 = fr2;
+        can->FA1R |= bit;
+    }
+    can->FMR &= ~CAN_FMR_FINIT;
+
+    return 1;
+}
+
 static void can_irq(CANName name, int id) 
 {
     uint32_t tmp1 = 0, tmp2 = 0, tmp3 = 0;    
@@ -98,6 +98,17 @@ struct i2c_s {
 #endif
 };
 
+#if DEVICE_SDIO
+struct sdio_s {
+    SD_HandleTypeDef handle;
+    DMA_HandleTypeDef dma_rx;
+    DMA_HandleTypeDef dma_tx;
+    uint32_t block_count;
+    uint32_t clock_hz;
+    uint8_t bus_width;
+};
+#endif
+
 #include "gpio_object.h"
 
 #ifdef __cplusplus
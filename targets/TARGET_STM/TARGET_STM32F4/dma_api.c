@@ -0,0 +1,258 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "dma_api.h"
+#include "cmsis.h"
+#include "critical.h"
+
+/* Channels 0 to 7 are the DMA1 streams, 8 to 15 the DMA2 streams. Only
+ * DMA2 copies memory to memory. */
+#define DMA_CHANNELS        16
+#define DMA2_FIRST_CHANNEL  8
+
+/* Streams programmed directly by AnalogInStream (DMA2 S0), the DAC
+ * streams (DMA1 S5, S6), the PwmOut sequences (DMA2 S5, S1, DMA1 S2) and
+ * the SDIO host (DMA2 S3, S6) */
+#if DEVICE_SDIO
+#define DMA_RESERVED_CHANNELS   ((1 << 2) | (1 << 5) | (1 << 6) | (1 << 8) | (1 << 9) | (1 << 11) | (1 << 13) | (1 << 14))
+#else
+#define DMA_RESERVED_CHANNELS   ((1 << 2) | (1 << 5) | (1 << 6) | (1 << 8) | (1 << 9) | (1 << 13))
+#endif
+
+/* FEIF, DMEIF, TEIF, HTIF and TCIF of a stream, before shifting */
+#define DMA_STREAM_FLAGS    0x3D
+#define DMA_STREAM_TEIF     0x08
+#define DMA_STREAM_TCIF     0x20
+
+/* Most items in one stream transfer */
+#define DMA_MAX_ITEMS       0xFFFF
+
+typedef struct {
+    dma_memcpy_handler handler;
+    uint32_t id;
+    uint32_t dst;
+    uint32_t src;
+    uint32_t remaining;
+    uint8_t shift;
+    volatile uint8_t busy;
+} dma_copy_t;
+
+static uint32_t allocated;
+static dma_copy_t copies[8];
+
+static DMA_Stream_TypeDef *const dma2_streams[8] = {
+    DMA2_Stream0, DMA2_Stream1, DMA2_Stream2, DMA2_Stream3,
+    DMA2_Stream4, DMA2_Stream5, DMA2_Stream6, DMA2_Stream7
+};
+
+static const IRQn_Type dma2_irqs[8] = {
+    DMA2_Stream0_IRQn, DMA2_Stream1_IRQn, DMA2_Stream2_IRQn, DMA2_Stream3_IRQn,
+    DMA2_Stream4_IRQn, DMA2_Stream5_IRQn, DMA2_Stream6_IRQn, DMA2_Stream7_IRQn
+};
+
+static const uint8_t flag_shifts[4] = { 0, 6, 16, 22 };
+
+static uint32_t dma2_flags(int stream)
+{
+    uint32_t isr = (stream < 4) ? DMA2->LISR : DMA2->HISR;
+    return (isr >> flag_shifts[stream & 3]) & DMA_STREAM_FLAGS;
+}
+
+static void dma2_clear_flags(int stream)
+{
+    uint32_t flags = DMA_STREAM_FLAGS << flag_shifts[stream & 3];
+    if (stream < 4) {
+        DMA2->LIFCR = flags;
+    } else {
+        DMA2->HIFCR = flags;
+    }
+}
+
+static int is_dma_memory(uint32_t address)
+{
+#ifdef CCMDATARAM_BASE
+    // the core coupled memory is only on the CPU bus
+    if ((address & 0xFFFF0000) == CCMDATARAM_BASE) {
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+static void dma2_start_chunk(int stream)
+{
+    DMA_Stream_TypeDef *s = dma2_streams[stream];
+    dma_copy_t *copy = &copies[stream];
+    uint32_t items = (copy->remaining > DMA_MAX_ITEMS) ? DMA_MAX_ITEMS : copy->remaining;
+
+    dma2_clear_flags(stream);
+    // in memory to memory mode the peripheral port reads the source
+    s->PAR = copy->src;
+    s->M0AR = copy->dst;
+    s->NDTR = items;
+    s->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH;
+    s->CR = DMA_SxCR_DIR_1 | DMA_SxCR_PINC | DMA_SxCR_MINC |
+            (copy->shift ? (DMA_SxCR_PSIZE_1 | DMA_SxCR_MSIZE_1) : 0) |
+            DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+
+    copy->src += items << copy->shift;
+    copy->dst += items << copy->shift;
+    copy->remaining -= items;
+
+    s->CR |= DMA_SxCR_EN;
+}
+
+static void dma2_stop(int stream)
+{
+    DMA_Stream_TypeDef *s = dma2_streams[stream];
+    s->CR &= ~(DMA_SxCR_TCIE | DMA_SxCR_TEIE);
+    s->CR &= ~DMA_SxCR_EN;
+    while (s->CR & DMA_SxCR_EN);
+    dma2_clear_flags(stream);
+    copies[stream].remaining = 0;
+    copies[stream].busy = 0;
+}
+
+static void dma2_irq(int stream)
+{
+    dma_copy_t *copy = &copies[stream];
+    uint32_t flags = dma2_flags(stream);
+    int event = 0;
+
+    dma2_clear_flags(stream);
+    if (flags & DMA_STREAM_TEIF) {
+        dma2_stop(stream);
+        event = DMA_MEMCPY_EVENT_ERROR;
+    } else if (flags & DMA_STREAM_TCIF) {
+        if (copy->remaining) {
+            dma2_start_chunk(stream);
+            return;
+        }
+        copy->busy = 0;
+        event = DMA_MEMCPY_EVENT_COMPLETE;
+    }
+
+    if (event && copy->handler) {
+        copy->handler(copy->id, event);
+    }
+}
+
+static void dma2_stream0_irq(void) { dma2_irq(0); }
+static void dma2_stream1_irq(void) { dma2_irq(1); }
+static void dma2_stream2_irq(void) { dma2_irq(2); }
+static void dma2_stream3_irq(void) { dma2_irq(3); }
+static void dma2_stream4_irq(void) { dma2_irq(4); }
+static void dma2_stream5_irq(void) { dma2_irq(5); }
+static void dma2_stream6_irq(void) { dma2_irq(6); }
+static void dma2_stream7_irq(void) { dma2_irq(7); }
+
+static void (*const dma2_handlers[8])(void) = {
+    dma2_stream0_irq, dma2_stream1_irq, dma2_stream2_irq, dma2_stream3_irq,
+    dma2_stream4_irq, dma2_stream5_irq, dma2_stream6_irq, dma2_stream7_irq
+};
+
+void dma_init(void)
+{
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+}
+
+int dma_channel_allocate(uint32_t capabilities)
+{
+    int first = (capabilities & DMA_CAP_MEM_TO_MEM) ? DMA2_FIRST_CHANNEL : 0;
+    int channel = DMA_ERROR_OUT_OF_CHANNELS;
+
+    dma_init();
+
+    core_util_critical_section_enter();
+    for (int i = first; i < DMA_CHANNELS; i++) {
+        uint32_t mask = 1u << i;
+        if (!((allocated | DMA_RESERVED_CHANNELS) & mask)) {
+            allocated |= mask;
+            channel = i;
+            break;
+        }
+    }
+    core_util_critical_section_exit();
+
+    return channel;
+}
+
+int dma_channel_free(int channelid)
+{
+    if (channelid < 0 || channelid >= DMA_CHANNELS) {
+        return 0;
+    }
+
+    dma_memcpy_abort(channelid);
+    core_util_critical_section_enter();
+    allocated &= ~(1u << channelid);
+    core_util_critical_section_exit();
+    return 0;
+}
+
+int dma_memcpy_start(int channelid, void *dst, const void *src, size_t size, dma_memcpy_handler handler, uint32_t id)
+{
+    if (channelid < DMA2_FIRST_CHANNEL || channelid >= DMA_CHANNELS ||
+            !(allocated & (1u << channelid)) || size == 0 ||
+            !is_dma_memory((uint32_t)dst) || !is_dma_memory((uint32_t)src)) {
+        return -1;
+    }
+
+    int stream = channelid - DMA2_FIRST_CHANNEL;
+    dma_copy_t *copy = &copies[stream];
+    if (copy->busy) {
+        return -1;
+    }
+
+    // words when both ends and the size allow it, bytes otherwise
+    copy->shift = (((uint32_t)dst | (uint32_t)src | size) & 3) ? 0 : 2;
+    copy->handler = handler;
+    copy->id = id;
+    copy->dst = (uint32_t)dst;
+    copy->src = (uint32_t)src;
+    copy->remaining = size >> copy->shift;
+    copy->busy = 1;
+
+    NVIC_SetVector(dma2_irqs[stream], (uint32_t)dma2_handlers[stream]);
+    NVIC_EnableIRQ(dma2_irqs[stream]);
+
+    core_util_critical_section_enter();
+    dma2_start_chunk(stream);
+    core_util_critical_section_exit();
+    return 0;
+}
+
+int dma_memcpy_active(int channelid)
+{
+    if (channelid < DMA2_FIRST_CHANNEL || channelid >= DMA_CHANNELS) {
+        return 0;
+    }
+    return copies[channelid - DMA2_FIRST_CHANNEL].busy;
+}
+
+void dma_memcpy_abort(int channelid)
+{
+    if (channelid < DMA2_FIRST_CHANNEL || channelid >= DMA_CHANNELS) {
+        return;
+    }
+
+    int stream = channelid - DMA2_FIRST_CHANNEL;
+    core_util_critical_section_enter();
+    if (copies[stream].busy) {
+        dma2_stop(stream);
+    }
+    core_util_critical_section_exit();
+}
@@ -43,6 +43,15 @@ PinName port_pin(PortName port, int pin_n)
     return (PinName)(pin_n + (port << 4));
 }
 
+int port_pin_bit(PinName pin, PortName *port)
+{
+    if (pin == (PinName)NC) {
+        return -1;
+    }
+    *port = (PortName)STM_PORT(pin);
+    return STM_PIN(pin);
+}
+
 void port_init(port_t *obj, PortName port, int mask, PinDirection dir)
 {
     uint32_t port_index = (uint32_t)port;
@@ -57,6 +66,7 @@ void port_init(port_t *obj, PortName port, int mask, PinDirection dir)
     obj->direction = dir;
     obj->reg_in    = &gpio->IDR;
     obj->reg_out   = &gpio->ODR;
+    obj->reg_set   = &gpio->BSRR;
 
     port_dir(obj, dir);
 }
@@ -88,7 +98,8 @@ void port_mode(port_t *obj, PinMode mode)
 
 void port_write(port_t *obj, int value)
 {
-    *obj->reg_out = (*obj->reg_out & ~obj->mask) | (value & obj->mask);
+    // One BSRR write sets and resets the pins together, leaving the others alone
+    *obj->reg_set = (value & obj->mask) | ((~value & obj->mask) << 16);
 }
 
 int port_read(port_t *obj)
@@ -299,4 +299,227 @@ void pwmout_pulsewidth_us(pwmout_t* obj, int us)
     pwmout_write(obj, value);
 }
 
+#if DEVICE_PWMOUT_ASYNCH
+
+/* The update event of the timer requests the DMA which loads the next
+ * pulse width into the preloaded compare register, so it applies from the
+ * next period on. Only the 16-bit timers with an update DMA request are
+ * listed, TIM5 is the us ticker. DMA1 stream 6 is shared with the second
+ * DAC channel. */
+typedef struct {
+    PWMName pwm;
+    DMA_Stream_TypeDef *stream;
+    uint32_t channel;
+    IRQn_Type irq;
+} pwm_sequence_dma_t;
+
+static const pwm_sequence_dma_t pwm_sequence_dma[] = {
+#if defined(TIM1_BASE)
+    {PWM_1, DMA2_Stream5, DMA_CHANNEL_6, DMA2_Stream5_IRQn},
+#endif
+#if defined(TIM3_BASE)
+    {PWM_3, DMA1_Stream2, DMA_CHANNEL_5, DMA1_Stream2_IRQn},
+#endif
+#if defined(TIM4_BASE)
+    {PWM_4, DMA1_Stream6, DMA_CHANNEL_2, DMA1_Stream6_IRQn},
+#endif
+#if defined(TIM8_BASE)
+    {PWM_8, DMA2_Stream1, DMA_CHANNEL_7, DMA2_Stream1_IRQn},
+#endif
+};
+
+#define PWM_SEQUENCE_TIMERS (sizeof(pwm_sequence_dma) / sizeof(pwm_sequence_dma[0]))
+
+typedef struct {
+    DMA_HandleTypeDef dma;
+    uint32_t event_mask;
+    volatile uint32_t events;
+    volatile uint8_t running;
+    uint8_t circular;
+} pwm_sequence_t;
+
+static pwm_sequence_t pwm_sequences[PWM_SEQUENCE_TIMERS];
+
+static int pwm_sequence_index(pwmout_t *obj)
+{
+    for (int i = 0; i < (int)PWM_SEQUENCE_TIMERS; i++) {
+        if (pwm_sequence_dma[i].pwm == obj->pwm) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void pwm_sequence_half(DMA_HandleTypeDef *hdma)
+{
+    ((pwm_sequence_t *)hdma->Parent)->events |= PWMOUT_EVENT_HALF_COMPLETE;
+}
+
+static void pwm_sequence_full(DMA_HandleTypeDef *hdma)
+{
+    ((pwm_sequence_t *)hdma->Parent)->events |= PWMOUT_EVENT_COMPLETE;
+}
+
+// Timer counts per period and prescaler for a sequence rate
+static int pwm_sequence_timing(pwmout_t *obj, uint32_t hz, uint32_t *prescaler, uint32_t *period)
+{
+    RCC_ClkInitTypeDef RCC_ClkInitStruct;
+    uint32_t PclkFreq;
+    uint32_t APBxCLKDivider;
+
+    HAL_RCC_GetClockConfig(&RCC_ClkInitStruct, &PclkFreq);
+    if (obj->pwm == PWM_3 || obj->pwm == PWM_4) {
+        PclkFreq = HAL_RCC_GetPCLK1Freq();
+        APBxCLKDivider = RCC_ClkInitStruct.APB1CLKDivider;
+    } else {
+        PclkFreq = HAL_RCC_GetPCLK2Freq();
+        APBxCLKDivider = RCC_ClkInitStruct.APB2CLKDivider;
+    }
+    // TIMxCLK = PCLKx when the APB prescaler = 1 else TIMxCLK = 2 * PCLKx
+    if (APBxCLKDivider != RCC_HCLK_DIV1) {
+        PclkFreq *= 2;
+    }
+
+    if (hz == 0 || hz > PclkFreq) {
+        return -1;
+    }
+    *period = PclkFreq / hz;
+    *prescaler = 1;
+    while (*period / *prescaler > 0x10000) {
+        (*prescaler)++;
+    }
+    *period /= *prescaler;
+    return (*prescaler <= 0x10000) ? 0 : -1;
+}
+
+static __IO uint32_t *pwm_sequence_ccr(pwmout_t *obj)
+{
+    TIM_TypeDef *tim = (TIM_TypeDef *)(obj->pwm);
+    switch (obj->channel) {
+        case 1:
+            return &tim->CCR1;
+        case 2:
+            return &tim->CCR2;
+        case 3:
+            return &tim->CCR3;
+        default:
+            return &tim->CCR4;
+    }
+}
+
+uint16_t pwmout_sequence_pulse(pwmout_t *obj, uint32_t hz, float percent)
+{
+    uint32_t prescaler;
+    uint32_t period;
+
+    if (pwm_sequence_timing(obj, hz, &prescaler, &period) != 0) {
+        return 0;
+    }
+    if (percent < (float)0.0) {
+        percent = 0.0;
+    } else if (percent > (float)1.0) {
+        percent = 1.0;
+    }
+    uint32_t pulse = (uint32_t)((float)period * percent);
+    return (pulse > 0xFFFF) ? 0xFFFF : pulse;
+}
+
+int pwmout_sequence_start(pwmout_t *obj, const uint16_t *pulses, size_t length, uint32_t hz, uint8_t circular, uint32_t handler, uint32_t event)
+{
+    int index = pwm_sequence_index(obj);
+    uint32_t prescaler;
+    uint32_t period;
+
+    if (index < 0 || pwm_sequences[index].running || length == 0 || length > 0xFFFF ||
+            pwm_sequence_timing(obj, hz, &prescaler, &period) != 0) {
+        return -1;
+    }
+
+    const pwm_sequence_dma_t *map = &pwm_sequence_dma[index];
+    pwm_sequence_t *sequence = &pwm_sequences[index];
+    TIM_TypeDef *tim = (TIM_TypeDef *)(obj->pwm);
+    __IO uint32_t *ccr = pwm_sequence_ccr(obj);
+
+    sequence->event_mask = event;
+    sequence->events = 0;
+    sequence->circular = circular;
+
+    // Sequence timebase, the first period is idle while the DMA loads the first entry
+    tim->CR1 &= ~TIM_CR1_CEN;
+    tim->PSC = prescaler - 1;
+    tim->ARR = period - 1;
+    *ccr = 0;
+    tim->EGR = TIM_EGR_UG;
+
+    if (map->stream == DMA2_Stream5 || map->stream == DMA2_Stream1) {
+        __HAL_RCC_DMA2_CLK_ENABLE();
+    } else {
+        __HAL_RCC_DMA1_CLK_ENABLE();
+    }
+    sequence->dma.Instance                 = map->stream;
+    sequence->dma.Init.Channel             = map->channel;
+    sequence->dma.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    sequence->dma.Init.PeriphInc           = DMA_PINC_DISABLE;
+    sequence->dma.Init.MemInc              = DMA_MINC_ENABLE;
+    sequence->dma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    sequence->dma.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+    sequence->dma.Init.Mode                = circular ? DMA_CIRCULAR : DMA_NORMAL;
+    sequence->dma.Init.Priority            = DMA_PRIORITY_HIGH;
+    sequence->dma.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+    HAL_DMA_DeInit(&sequence->dma);
+    if (HAL_DMA_Init(&sequence->dma) != HAL_OK) {
+        return -1;
+    }
+    sequence->dma.Parent               = sequence;
+    sequence->dma.XferHalfCpltCallback = pwm_sequence_half;
+    sequence->dma.XferCpltCallback     = pwm_sequence_full;
+
+    NVIC_SetVector(map->irq, handler);
+    NVIC_EnableIRQ(map->irq);
+    HAL_DMA_Start_IT(&sequence->dma, (uint32_t)pulses, (uint32_t)ccr, length);
+
+    sequence->running = 1;
+    tim->DIER |= TIM_DIER_UDE;
+    tim->CR1 |= TIM_CR1_CEN;
+    return 0;
+}
+
+int pwmout_sequence_irq_handler(pwmout_t *obj)
+{
+    int index = pwm_sequence_index(obj);
+    pwm_sequence_t *sequence = &pwm_sequences[index];
+
+    sequence->events = 0;
+    HAL_DMA_IRQHandler(&sequence->dma);
+
+    uint32_t events = sequence->events;
+    if (sequence->dma.State == HAL_DMA_STATE_ERROR ||
+            (!sequence->circular && (events & PWMOUT_EVENT_COMPLETE))) {
+        pwmout_sequence_stop(obj);
+    }
+    return events & sequence->event_mask;
+}
+
+void pwmout_sequence_stop(pwmout_t *obj)
+{
+    int index = pwm_sequence_index(obj);
+
+    if (index < 0 || !pwm_sequences[index].running) {
+        return;
+    }
+    pwm_sequences[index].running = 0;
+
+    ((TIM_TypeDef *)(obj->pwm))->DIER &= ~TIM_DIER_UDE;
+    NVIC_DisableIRQ(pwm_sequence_dma[index].irq);
+    HAL_DMA_Abort(&pwm_sequences[index].dma);
+}
+
+uint8_t pwmout_sequence_active(pwmout_t *obj)
+{
+    int index = pwm_sequence_index(obj);
+    return (index >= 0) && pwm_sequences[index].running;
+}
+
+#endif
+
 #endif
@@ -0,0 +1,296 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sdio_api.h"
+
+#if DEVICE_SDIO
+
+#include <string.h>
+#include "cmsis.h"
+#include "pinmap.h"
+#include "us_ticker_api.h"
+
+/* The SDIO pins are the same on every package, on AF12. The data and
+ * command lines idle high. */
+#define SDIO_PERIPHERAL ((int)SDIO_BASE)
+
+static const PinMap PinMap_SDIO_CK[] = {
+    {PC_12, SDIO_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF12_SDIO)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_SDIO_CMD[] = {
+    {PD_2,  SDIO_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_PULLUP, GPIO_AF12_SDIO)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_SDIO_D0[] = {
+    {PC_8,  SDIO_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_PULLUP, GPIO_AF12_SDIO)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_SDIO_D1[] = {
+    {PC_9,  SDIO_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_PULLUP, GPIO_AF12_SDIO)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_SDIO_D2[] = {
+    {PC_10, SDIO_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_PULLUP, GPIO_AF12_SDIO)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_SDIO_D3[] = {
+    {PC_11, SDIO_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_PULLUP, GPIO_AF12_SDIO)},
+    {NC,    0,               0}
+};
+
+/* Polling iterations the HAL waits for the end of a DMA transfer */
+#define SDIO_TRANSFER_TIMEOUT   0x4000000
+/* Time a card may take to program the blocks written */
+#define SDIO_BUSY_TIMEOUT_US    500000
+
+/* The DMA reads and writes words, other buffers go through this one a
+ * block at a time */
+static uint32_t bounce[SDIO_BLOCK_SIZE / 4];
+
+static sdio_t *sdio_obj;
+
+static void sdio_irq(void)
+{
+    HAL_SD_IRQHandler(&sdio_obj->handle);
+}
+
+static void sdio_dma_rx_irq(void)
+{
+    HAL_DMA_IRQHandler(&sdio_obj->dma_rx);
+}
+
+static void sdio_dma_tx_irq(void)
+{
+    HAL_DMA_IRQHandler(&sdio_obj->dma_tx);
+}
+
+/* SDIOCLK is the 48MHz output of the main PLL, SDIO_CK is SDIOCLK / (CLKDIV + 2) */
+static uint32_t sdio_clock_source(void)
+{
+    uint32_t pllcfgr = RCC->PLLCFGR;
+    uint32_t input = (pllcfgr & RCC_PLLCFGR_PLLSRC) ? HSE_VALUE : HSI_VALUE;
+    uint32_t pllm = pllcfgr & RCC_PLLCFGR_PLLM;
+    uint32_t plln = (pllcfgr & RCC_PLLCFGR_PLLN) >> 6;
+    uint32_t pllq = (pllcfgr & RCC_PLLCFGR_PLLQ) >> 24;
+    return (uint32_t)((uint64_t)input * plln / pllm / pllq);
+}
+
+static void sdio_dma_init(DMA_HandleTypeDef *dma, DMA_Stream_TypeDef *stream, uint32_t direction)
+{
+    dma->Instance                 = stream;
+    dma->Init.Channel             = DMA_CHANNEL_4;
+    dma->Init.Direction           = direction;
+    dma->Init.PeriphInc           = DMA_PINC_DISABLE;
+    dma->Init.MemInc              = DMA_MINC_ENABLE;
+    dma->Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    dma->Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    // the SDIO counts the data, the DMA follows
+    dma->Init.Mode                = DMA_PFCTRL;
+    dma->Init.Priority            = DMA_PRIORITY_VERY_HIGH;
+    dma->Init.FIFOMode            = DMA_FIFOMODE_ENABLE;
+    dma->Init.FIFOThreshold       = DMA_FIFO_THRESHOLD_FULL;
+    dma->Init.MemBurst            = DMA_MBURST_INC4;
+    dma->Init.PeriphBurst         = DMA_PBURST_INC4;
+    HAL_DMA_DeInit(dma);
+    HAL_DMA_Init(dma);
+}
+
+int sdio_init(sdio_t *obj, PinName clk, PinName cmd, PinName d0, PinName d1, PinName d2, PinName d3, uint32_t hz)
+{
+    int wide = (d1 != NC) && (d2 != NC) && (d3 != NC);
+
+    if (pinmap_find_peripheral(clk, PinMap_SDIO_CK) == (uint32_t)NC ||
+            pinmap_find_peripheral(cmd, PinMap_SDIO_CMD) == (uint32_t)NC ||
+            pinmap_find_peripheral(d0, PinMap_SDIO_D0) == (uint32_t)NC) {
+        return -1;
+    }
+    if (wide && (pinmap_find_peripheral(d1, PinMap_SDIO_D1) == (uint32_t)NC ||
+                 pinmap_find_peripheral(d2, PinMap_SDIO_D2) == (uint32_t)NC ||
+                 pinmap_find_peripheral(d3, PinMap_SDIO_D3) == (uint32_t)NC)) {
+        return -1;
+    }
+
+    pinmap_pinout(clk, PinMap_SDIO_CK);
+    pinmap_pinout(cmd, PinMap_SDIO_CMD);
+    pinmap_pinout(d0, PinMap_SDIO_D0);
+    if (wide) {
+        pinmap_pinout(d1, PinMap_SDIO_D1);
+        pinmap_pinout(d2, PinMap_SDIO_D2);
+        pinmap_pinout(d3, PinMap_SDIO_D3);
+    }
+
+    memset(obj, 0, sizeof(*obj));
+    sdio_obj = obj;
+
+    __HAL_RCC_SDIO_CLK_ENABLE();
+    __HAL_RCC_DMA2_CLK_ENABLE();
+
+    // DMA2 S3 and S6 on channel 4 are the SDIO requests
+    sdio_dma_init(&obj->dma_rx, DMA2_Stream3, DMA_PERIPH_TO_MEMORY);
+    sdio_dma_init(&obj->dma_tx, DMA2_Stream6, DMA_MEMORY_TO_PERIPH);
+    __HAL_LINKDMA(&obj->handle, hdmarx, obj->dma_rx);
+    __HAL_LINKDMA(&obj->handle, hdmatx, obj->dma_tx);
+
+    NVIC_SetVector(SDIO_IRQn, (uint32_t)sdio_irq);
+    NVIC_SetVector(DMA2_Stream3_IRQn, (uint32_t)sdio_dma_rx_irq);
+    NVIC_SetVector(DMA2_Stream6_IRQn, (uint32_t)sdio_dma_tx_irq);
+    NVIC_EnableIRQ(SDIO_IRQn);
+    NVIC_EnableIRQ(DMA2_Stream3_IRQn);
+    NVIC_EnableIRQ(DMA2_Stream6_IRQn);
+
+    uint32_t source = sdio_clock_source();
+    uint32_t div = 0;
+    if (hz == 0) {
+        hz = 1;
+    }
+    while (source / (div + 2) > hz && div < 0xFF) {
+        div++;
+    }
+
+    // the data clock; HAL_SD_Init identifies the card at SDIO_INIT_CLK_DIV
+    obj->handle.Instance                 = SDIO;
+    obj->handle.Init.ClockEdge           = SDIO_CLOCK_EDGE_RISING;
+    obj->handle.Init.ClockBypass         = SDIO_CLOCK_BYPASS_DISABLE;
+    obj->handle.Init.ClockPowerSave      = SDIO_CLOCK_POWER_SAVE_DISABLE;
+    obj->handle.Init.BusWide             = SDIO_BUS_WIDE_1B;
+    // the hardware flow control glitches the clock (errata), the DMA keeps up
+    obj->handle.Init.HardwareFlowControl = SDIO_HARDWARE_FLOW_CONTROL_DISABLE;
+    obj->handle.Init.ClockDiv            = div;
+
+    HAL_SD_CardInfoTypedef info;
+    if (HAL_SD_Init(&obj->handle, &info) != SD_OK) {
+        sdio_free(obj);
+        return -1;
+    }
+
+    obj->bus_width = 1;
+    if (wide) {
+        if (HAL_SD_WideBusOperation_Config(&obj->handle, SDIO_BUS_WIDE_4B) != SD_OK) {
+            sdio_free(obj);
+            return -1;
+        }
+        obj->bus_width = 4;
+    }
+
+    obj->block_count = (uint32_t)(info.CardCapacity / SDIO_BLOCK_SIZE);
+    obj->clock_hz = source / (div + 2);
+    return 0;
+}
+
+void sdio_free(sdio_t *obj)
+{
+    NVIC_DisableIRQ(SDIO_IRQn);
+    NVIC_DisableIRQ(DMA2_Stream3_IRQn);
+    NVIC_DisableIRQ(DMA2_Stream6_IRQn);
+
+    HAL_SD_DeInit(&obj->handle);
+    HAL_DMA_DeInit(&obj->dma_rx);
+    HAL_DMA_DeInit(&obj->dma_tx);
+    __HAL_RCC_SDIO_CLK_DISABLE();
+
+    if (sdio_obj == obj) {
+        sdio_obj = NULL;
+    }
+}
+
+void sdio_card_info(sdio_t *obj, sdio_card_info_t *info)
+{
+    info->block_count = obj->block_count;
+    info->clock_hz = obj->clock_hz;
+    info->bus_width = obj->bus_width;
+}
+
+static int sdio_dma_buffer(const void *buffer)
+{
+    uint32_t address = (uint32_t)buffer;
+    if (address & 3) {
+        return 0;
+    }
+#ifdef CCMDATARAM_BASE
+    // the core coupled memory is only on the CPU bus
+    if ((address & 0xFFFF0000) == CCMDATARAM_BASE) {
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+static int sdio_read(sdio_t *obj, uint32_t *buffer, uint32_t block, uint32_t count)
+{
+    if (HAL_SD_ReadBlocks_DMA(&obj->handle, buffer, (uint64_t)block * SDIO_BLOCK_SIZE, SDIO_BLOCK_SIZE, count) != SD_OK) {
+        return -1;
+    }
+    if (HAL_SD_CheckReadOperation(&obj->handle, SDIO_TRANSFER_TIMEOUT) != SD_OK) {
+        return -1;
+    }
+    return 0;
+}
+
+static int sdio_write(sdio_t *obj, uint32_t *buffer, uint32_t block, uint32_t count)
+{
+    if (HAL_SD_WriteBlocks_DMA(&obj->handle, buffer, (uint64_t)block * SDIO_BLOCK_SIZE, SDIO_BLOCK_SIZE, count) != SD_OK) {
+        return -1;
+    }
+    if (HAL_SD_CheckWriteOperation(&obj->handle, SDIO_TRANSFER_TIMEOUT) != SD_OK) {
+        return -1;
+    }
+
+    // the card programs the blocks after taking them
+    uint32_t start = us_ticker_read();
+    while (HAL_SD_GetStatus(&obj->handle) != SD_TRANSFER_OK) {
+        if (us_ticker_read() - start > SDIO_BUSY_TIMEOUT_US) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int sdio_read_blocks(sdio_t *obj, uint8_t *buffer, uint32_t block, uint32_t count)
+{
+    if (sdio_dma_buffer(buffer)) {
+        return sdio_read(obj, (uint32_t *)buffer, block, count);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (sdio_read(obj, bounce, block + i, 1) != 0) {
+            return -1;
+        }
+        memcpy(buffer + i * SDIO_BLOCK_SIZE, bounce, SDIO_BLOCK_SIZE);
+    }
+    return 0;
+}
+
+int sdio_write_blocks(sdio_t *obj, const uint8_t *buffer, uint32_t block, uint32_t count)
+{
+    if (sdio_dma_buffer(buffer)) {
+        return sdio_write(obj, (uint32_t *)buffer, block, count);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        memcpy(bounce, buffer + i * SDIO_BLOCK_SIZE, SDIO_BLOCK_SIZE);
+        if (sdio_write(obj, bounce, block + i, 1) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+#endif
@@ -776,6 +776,12 @@ void serial_rx_asynch(serial_t *obj, void *rx, size_t rx_length, uint8_t rx_widt
 
     // following HAL function will enable the RXNE interrupt + error interrupts    
     HAL_UART_Receive_IT(huart, (uint8_t*)rx, rx_length);
+
+    // the idle flag only rises after a character, ending the frame it belongs to
+    if (event & SERIAL_EVENT_RX_IDLE) {
+        __HAL_UART_CLEAR_IDLEFLAG(huart);
+        __HAL_UART_ENABLE_IT(huart, UART_IT_IDLE);
+    }
 }
 
 /**
@@ -873,6 +879,16 @@ int serial_irq_handler_asynch(serial_t *obj)
     }
     
     HAL_UART_IRQHandler(huart);
+
+    // Checked once HAL_UART_IRQHandler read the data register, which the
+    // flag is cleared with
+    uint8_t idle = 0;
+    if (__HAL_UART_GET_FLAG(huart, UART_FLAG_IDLE) != RESET) {
+        if (__HAL_UART_GET_IT_SOURCE(huart, UART_IT_IDLE) != RESET) {
+            __HAL_UART_CLEAR_IDLEFLAG(huart);
+            idle = 1;
+        }
+    }
     
     // Abort if an error occurs
     if (return_event & SERIAL_EVENT_RX_PARITY_ERROR ||
@@ -894,7 +910,7 @@ int serial_irq_handler_asynch(serial_t *obj)
         if (buf != NULL) {
             for (i = 0; i < obj->rx_buff.pos; i++) {
                 if (buf[i] == obj->char_match) {
-                    obj->rx_buff.pos = i;
+                    obj->rx_buff.pos = i + 1;
                     return_event |= (SERIAL_EVENT_RX_CHARACTER_MATCH & obj_s->events);
                     serial_rx_abort_asynch(obj);
                     break;
@@ -902,6 +918,15 @@ int serial_irq_handler_asynch(serial_t *obj)
             }
         }
     }
+
+    // End the frame on an idle line, unless it ended already
+    if (return_event & SERIAL_EVENT_RX_COMPLETE) {
+        __HAL_UART_DISABLE_IT(huart, UART_IT_IDLE);
+    } else if (idle && (huart->RxXferCount > 0) && (obj->rx_buff.pos > 0) &&
+            !(return_event & SERIAL_EVENT_RX_CHARACTER_MATCH)) {
+        return_event |= (SERIAL_EVENT_RX_IDLE & obj_s->events);
+        serial_rx_abort_asynch(obj);
+    }
     
     return return_event;  
 }
@@ -948,6 +973,7 @@ void serial_rx_abort_asynch(serial_t *obj)
     __HAL_UART_DISABLE_IT(huart, UART_IT_RXNE);
     __HAL_UART_DISABLE_IT(huart, UART_IT_PE);
     __HAL_UART_DISABLE_IT(huart, UART_IT_ERR);
+    __HAL_UART_DISABLE_IT(huart, UART_IT_IDLE);
     
     // clear flags
     __HAL_UART_CLEAR_FLAG(huart, UART_FLAG_RXNE);
@@ -303,6 +303,14 @@ typedef enum {
     SPI_CS      = D10,
     PWM_OUT     = D9,
 
+    // QSPI flash
+    QSPI_FLASH_IO0 = PD_11,
+    QSPI_FLASH_IO1 = PD_12,
+    QSPI_FLASH_IO2 = PE_2,
+    QSPI_FLASH_IO3 = PD_13,
+    QSPI_FLASH_SCK = PB_2,
+    QSPI_FLASH_CSN = PB_6,
+
     // Not connected
     NC = (int)0xFFFFFFFF
 } PinName;
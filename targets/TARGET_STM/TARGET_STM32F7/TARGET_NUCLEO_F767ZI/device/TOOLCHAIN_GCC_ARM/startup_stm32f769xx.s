@@ -107,6 +107,22 @@ LoopFillZerobss:
   cmp  r2, r3
   bcc  FillZerobss
 
+/* Copy the functions run from ITCM RAM */
+  ldr  r0, =__ramfunc_start__
+  ldr  r1, =__ramfunc_end__
+  ldr  r2, =__ramfunc_load__
+  b  LoopCopyRamfunc
+
+CopyRamfunc:
+  ldr  r3, [r2], #4
+  str  r3, [r0], #4
+
+LoopCopyRamfunc:
+  cmp  r0, r1
+  bcc  CopyRamfunc
+  dsb
+  isb
+
 /* Call the clock system initialization function.*/
   bl  SystemInit   
 /* Call static constructors */
@@ -320,6 +320,45 @@ int spi_master_write(spi_t *obj, int value)
     return ssp_read(obj);
 }
 
+int spi_master_block_write(spi_t *obj, const char *tx_buffer, int tx_length,
+                           char *rx_buffer, int rx_length, char write_fill)
+{
+    SPI_TypeDef *spi = (SPI_TypeDef *)(obj->spi);
+    int total = (tx_length > rx_length) ? tx_length : rx_length;
+    // frames written but not read back, never more than the 32-bit rx FIFO holds
+    int fifo = (obj->bits == SPI_DATASIZE_8BIT) ? 4 : 2;
+    int sent = 0;
+    int received = 0;
+
+    while (received < total) {
+        while (sent < total && sent - received < fifo && (spi->SR & SPI_SR_TXE)) {
+            char out = (sent < tx_length) ? tx_buffer[sent] : write_fill;
+            if (obj->bits == SPI_DATASIZE_8BIT) {
+                // Force 8-bit access to the data register
+                *(volatile uint8_t *)&spi->DR = (uint8_t)out;
+            } else {
+                spi->DR = (uint8_t)out;
+            }
+            sent++;
+        }
+
+        if (spi->SR & SPI_SR_RXNE) {
+            char in;
+            if (obj->bits == SPI_DATASIZE_8BIT) {
+                in = *(volatile uint8_t *)&spi->DR;
+            } else {
+                in = (char)spi->DR;
+            }
+            if (received < rx_length) {
+                rx_buffer[received] = in;
+            }
+            received++;
+        }
+    }
+
+    return total;
+}
+
 int spi_slave_receive(spi_t *obj)
 {
     return ((ssp_readable(obj) && !ssp_busy(obj)) ? 1 : 0);
@@ -76,4 +76,6 @@ static inline int gpio_is_connected(const gpio_t *obj) {
 }
 #endif
 
+#include "gpio_fast.h"
+
 #endif
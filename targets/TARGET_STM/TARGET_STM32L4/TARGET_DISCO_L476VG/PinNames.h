@@ -195,6 +195,14 @@ typedef enum {
     SPI_CS      = PA_4,
     PWM_OUT     = PB_3,
 
+    // QSPI flash
+    QSPI_FLASH_IO0 = PE_12,
+    QSPI_FLASH_IO1 = PE_13,
+    QSPI_FLASH_IO2 = PE_14,
+    QSPI_FLASH_IO3 = PE_15,
+    QSPI_FLASH_SCK = PE_10,
+    QSPI_FLASH_CSN = PE_11,
+
     // Not connected
     NC = (int)0xFFFFFFFF
 } PinName;
@@ -68,6 +68,14 @@ struct serial_s {
 #endif
 };
 
+#if DEVICE_QSPI
+struct qspi_s {
+    QSPI_HandleTypeDef handle;
+    uint32_t size;
+    uint8_t mapped;
+};
+#endif
+
 #include "gpio_object.h"
 
 #ifdef __cplusplus
@@ -0,0 +1,243 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "qspi_api.h"
+
+#if DEVICE_QSPI
+
+#include <string.h>
+#include "cmsis.h"
+#include "pinmap.h"
+
+#define QSPI_PERIPHERAL ((int)QSPI_R_BASE)
+
+/* The DISCO_L476VG flash is on the port E pins */
+static const PinMap PinMap_QSPI_CLK[] = {
+    {PA_3,  QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {PB_10, QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {PE_10, QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_QSPI_NCS[] = {
+    {PA_2,  QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_PULLUP, GPIO_AF10_QUADSPI)},
+    {PB_11, QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_PULLUP, GPIO_AF10_QUADSPI)},
+    {PE_11, QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_PULLUP, GPIO_AF10_QUADSPI)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_QSPI_IO0[] = {
+    {PB_1,  QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {PE_12, QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_QSPI_IO1[] = {
+    {PB_0,  QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {PE_13, QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_QSPI_IO2[] = {
+    {PA_7,  QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {PE_14, QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {NC,    0,               0}
+};
+
+static const PinMap PinMap_QSPI_IO3[] = {
+    {PA_6,  QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {PE_15, QSPI_PERIPHERAL, STM_PIN_DATA(STM_MODE_AF_PP, GPIO_NOPULL, GPIO_AF10_QUADSPI)},
+    {NC,    0,               0}
+};
+
+/* The mode fields of a phase are two bits wide, 1, 2 and 3 for 1, 2 and 4 lines */
+static uint32_t qspi_mode(qspi_lines_t lines, uint32_t one)
+{
+    switch (lines) {
+        case QSPI_LINES_1:
+            return one;
+        case QSPI_LINES_2:
+            return one << 1;
+        case QSPI_LINES_4:
+            return one * 3;
+        default:
+            return 0;
+    }
+}
+
+static int qspi_prepare_command(const qspi_command_t *command, QSPI_CommandTypeDef *st_command)
+{
+    if (command->address_lines != QSPI_LINES_NONE &&
+            (command->address_size < 1 || command->address_size > 4)) {
+        return -1;
+    }
+
+    memset(st_command, 0, sizeof(*st_command));
+    st_command->Instruction       = command->instruction;
+    st_command->InstructionMode   = qspi_mode(command->instruction_lines, QUADSPI_CCR_IMODE_0);
+    st_command->Address           = command->address;
+    st_command->AddressMode       = qspi_mode(command->address_lines, QUADSPI_CCR_ADMODE_0);
+    st_command->AddressSize       = (command->address_lines != QSPI_LINES_NONE)
+                                    ? (uint32_t)(command->address_size - 1) * QUADSPI_CCR_ADSIZE_0 : 0;
+    st_command->AlternateByteMode = QSPI_ALTERNATE_BYTES_NONE;
+    st_command->DummyCycles       = command->dummy_cycles;
+    st_command->DataMode          = qspi_mode(command->data_lines, QUADSPI_CCR_DMODE_0);
+    st_command->DdrMode           = QSPI_DDR_MODE_DISABLE;
+    st_command->DdrHoldHalfCycle  = QSPI_DDR_HHC_ANALOG_DELAY;
+    st_command->SIOOMode          = QSPI_SIOO_INST_EVERY_CMD;
+    return 0;
+}
+
+static void qspi_unmap(qspi_t *obj)
+{
+    if (obj->mapped) {
+        HAL_QSPI_Abort(&obj->handle);
+        obj->mapped = 0;
+    }
+}
+
+int qspi_init(qspi_t *obj, PinName io0, PinName io1, PinName io2, PinName io3, PinName sclk, PinName ssel,
+              uint32_t hz, uint32_t size)
+{
+    int quad = (io2 != NC) && (io3 != NC);
+    uint32_t address_bits = 0;
+    uint32_t prescaler;
+
+    if (pinmap_find_peripheral(sclk, PinMap_QSPI_CLK) == (uint32_t)NC ||
+            pinmap_find_peripheral(ssel, PinMap_QSPI_NCS) == (uint32_t)NC ||
+            pinmap_find_peripheral(io0, PinMap_QSPI_IO0) == (uint32_t)NC ||
+            pinmap_find_peripheral(io1, PinMap_QSPI_IO1) == (uint32_t)NC) {
+        return -1;
+    }
+    if (quad && (pinmap_find_peripheral(io2, PinMap_QSPI_IO2) == (uint32_t)NC ||
+                 pinmap_find_peripheral(io3, PinMap_QSPI_IO3) == (uint32_t)NC)) {
+        return -1;
+    }
+
+    /* FlashSize is the number of address bits minus one */
+    while (address_bits < 32 && (1UL << address_bits) < size) {
+        address_bits++;
+    }
+    if (hz == 0 || address_bits < 2 || (1UL << address_bits) != size) {
+        return -1;
+    }
+
+    pinmap_pinout(sclk, PinMap_QSPI_CLK);
+    pinmap_pinout(ssel, PinMap_QSPI_NCS);
+    pinmap_pinout(io0, PinMap_QSPI_IO0);
+    pinmap_pinout(io1, PinMap_QSPI_IO1);
+    if (quad) {
+        pinmap_pinout(io2, PinMap_QSPI_IO2);
+        pinmap_pinout(io3, PinMap_QSPI_IO3);
+    }
+
+    __HAL_RCC_QSPI_CLK_ENABLE();
+    __HAL_RCC_QSPI_FORCE_RESET();
+    __HAL_RCC_QSPI_RELEASE_RESET();
+
+    /* The clock is HCLK / (ClockPrescaler + 1), rounded down to at most hz */
+    prescaler = (HAL_RCC_GetHCLKFreq() + hz - 1) / hz;
+    if (prescaler > 0) {
+        prescaler--;
+    }
+    if (prescaler > 255) {
+        prescaler = 255;
+    }
+
+    memset(obj, 0, sizeof(*obj));
+    obj->size = size;
+    obj->handle.Instance                = QUADSPI;
+    obj->handle.Init.ClockPrescaler     = prescaler;
+    obj->handle.Init.FifoThreshold      = 4;
+    obj->handle.Init.SampleShifting     = QSPI_SAMPLE_SHIFTING_HALFCYCLE;
+    obj->handle.Init.FlashSize          = address_bits - 1;
+    obj->handle.Init.ChipSelectHighTime = QSPI_CS_HIGH_TIME_2_CYCLE;
+    obj->handle.Init.ClockMode          = QSPI_CLOCK_MODE_0;
+#if defined(QUADSPI_CR_DFM)
+    obj->handle.Init.FlashID            = QSPI_FLASH_ID_1;
+    obj->handle.Init.DualFlash          = QSPI_DUALFLASH_DISABLE;
+#endif
+
+    if (HAL_QSPI_Init(&obj->handle) != HAL_OK) {
+        return -1;
+    }
+    return 0;
+}
+
+void qspi_free(qspi_t *obj)
+{
+    qspi_unmap(obj);
+    HAL_QSPI_DeInit(&obj->handle);
+    __HAL_RCC_QSPI_FORCE_RESET();
+    __HAL_RCC_QSPI_RELEASE_RESET();
+    __HAL_RCC_QSPI_CLK_DISABLE();
+}
+
+int qspi_command(qspi_t *obj, const qspi_command_t *command, const void *tx, void *rx, uint32_t length)
+{
+    QSPI_CommandTypeDef st_command;
+    HAL_StatusTypeDef status;
+
+    if (qspi_prepare_command(command, &st_command) != 0) {
+        return -1;
+    }
+    if (command->data_lines != QSPI_LINES_NONE) {
+        if (length == 0 || (tx == NULL && rx == NULL)) {
+            return -1;
+        }
+        st_command.NbData = length;
+    }
+
+    qspi_unmap(obj);
+
+    if (HAL_QSPI_Command(&obj->handle, &st_command, HAL_QPSI_TIMEOUT_DEFAULT_VALUE) != HAL_OK) {
+        return -1;
+    }
+    if (command->data_lines == QSPI_LINES_NONE) {
+        return 0;
+    }
+
+    if (tx != NULL) {
+        status = HAL_QSPI_Transmit(&obj->handle, (uint8_t *)tx, HAL_QPSI_TIMEOUT_DEFAULT_VALUE);
+    } else {
+        status = HAL_QSPI_Receive(&obj->handle, (uint8_t *)rx, HAL_QPSI_TIMEOUT_DEFAULT_VALUE);
+    }
+    return (status == HAL_OK) ? 0 : -1;
+}
+
+int qspi_memory_map(qspi_t *obj, const qspi_command_t *command, const void **base)
+{
+    QSPI_CommandTypeDef st_command;
+    QSPI_MemoryMappedTypeDef config;
+
+    if (command->address_lines == QSPI_LINES_NONE || command->data_lines == QSPI_LINES_NONE ||
+            qspi_prepare_command(command, &st_command) != 0) {
+        return -1;
+    }
+
+    qspi_unmap(obj);
+
+    config.TimeOutActivation = QSPI_TIMEOUT_COUNTER_DISABLE;
+    config.TimeOutPeriod     = 0;
+    if (HAL_QSPI_MemoryMapped(&obj->handle, &st_command, &config) != HAL_OK) {
+        return -1;
+    }
+    obj->mapped = 1;
+
+    *base = (const void *)QSPI_BASE;
+    return 0;
+}
+
+#endif
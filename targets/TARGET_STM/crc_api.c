@@ -0,0 +1,66 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "crc_api.h"
+
+#if DEVICE_CRC
+
+#include "cmsis.h"
+#include "critical.h"
+
+/* Only the CRC units with a programmable initial value and input reversal
+ * (STM32F0, F3, F7, L0, L4) can continue a running remainder; the one of the
+ * F1, F2, F4 and L1 always starts from 0xFFFFFFFF. */
+#if !defined(CRC_CR_REV_IN)
+#error "DEVICE_CRC requires a CRC unit with a programmable initial value and REV_IN"
+#endif
+
+static inline uint32_t crc_reverse_bits(uint32_t value)
+{
+#if (__CORTEX_M >= 0x03)
+    return __RBIT(value);
+#else
+    value = ((value >> 1) & 0x55555555U) | ((value & 0x55555555U) << 1);
+    value = ((value >> 2) & 0x33333333U) | ((value & 0x33333333U) << 2);
+    value = ((value >> 4) & 0x0F0F0F0FU) | ((value & 0x0F0F0F0FU) << 4);
+    return __REV(value);
+#endif
+}
+
+/* The unit divides MSB first. Reversing the bits of each (little-endian) word
+ * on input feeds its bytes in memory order, each reflected; the remainder of
+ * the unit is the reflected one with its bits reversed. */
+uint32_t crc32_hw_update(uint32_t remainder, const uint32_t *data, size_t words)
+{
+    core_util_critical_section_enter();
+
+    __HAL_RCC_CRC_CLK_ENABLE();
+#if defined(CRC_POL_POL)
+    CRC->POL  = 0x04C11DB7U;
+#endif
+    CRC->INIT = crc_reverse_bits(remainder);
+    CRC->CR   = CRC_CR_REV_IN | CRC_CR_RESET; /* 32-bit polynomial, bit reversal by word, load INIT */
+
+    while (words-- > 0) {
+        CRC->DR = *data++;
+    }
+    remainder = crc_reverse_bits(CRC->DR);
+
+    core_util_critical_section_exit();
+
+    return remainder;
+}
+
+#endif
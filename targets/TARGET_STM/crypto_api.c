@@ -0,0 +1,67 @@
+/*
+ *  Crypto accelerator for the STM32 families
+ *
+ *  Copyright (C) 2017, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ */
+
+#if defined(DEVICE_CRYPTO_AES)
+
+#include <string.h>
+#include "cmsis.h"
+#include "crypto_api.h"
+
+/* Timeout of one block in ms */
+#define CRYPTO_AES_TIMEOUT  10
+
+static CRYP_HandleTypeDef crypto_aes_handle;
+
+/* The key is kept as it is, the CRYP derives the decryption key itself */
+int crypto_aes_setkey(uint32_t *rk, const uint8_t *key, unsigned keybits, int decrypt)
+{
+    if (keybits != 128 && keybits != 192 && keybits != 256) {
+        return -1;
+    }
+
+    memcpy(rk, key, keybits / 8);
+    return 0;
+}
+
+void crypto_aes_crypt(const uint32_t *rk, unsigned keybits, int decrypt, uint32_t block[4])
+{
+    CRYP_HandleTypeDef *hcryp = &crypto_aes_handle;
+
+    if (hcryp->State == HAL_CRYP_STATE_RESET) {
+        __HAL_RCC_CRYP_CLK_ENABLE();
+        hcryp->Instance = CRYP;
+    }
+
+    /* the key of the previous caller may still be loaded, init returns
+     * the CRYP to the phase where the key is set */
+    hcryp->Init.DataType = CRYP_DATATYPE_8B;
+    hcryp->Init.KeySize = keybits == 128 ? CRYP_KEYSIZE_128B :
+                          keybits == 192 ? CRYP_KEYSIZE_192B : CRYP_KEYSIZE_256B;
+    hcryp->Init.pKey = (uint8_t *)rk;
+    HAL_CRYP_Init(hcryp);
+
+    if (decrypt) {
+        HAL_CRYP_AESECB_Decrypt(hcryp, (uint8_t *)block, 16, (uint8_t *)block, CRYPTO_AES_TIMEOUT);
+    } else {
+        HAL_CRYP_AESECB_Encrypt(hcryp, (uint8_t *)block, 16, (uint8_t *)block, CRYPTO_AES_TIMEOUT);
+    }
+}
+
+#endif
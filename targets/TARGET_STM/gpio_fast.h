@@ -0,0 +1,103 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef MBED_GPIO_FAST_H
+#define MBED_GPIO_FAST_H
+
+#include "cmsis.h"
+#include "PinNames.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Pin-bound GPIO access of all the STM32 families, see gpio_api.h. With a
+ * constant pin the switch folds to the address of the port, and a write to
+ * a single store to BSRR. */
+#define GPIO_FAST 1
+
+static inline GPIO_TypeDef *gpio_fast_port(PinName pin)
+{
+    switch (STM_PORT(pin)) {
+        case 0:
+            return GPIOA;
+        case 1:
+            return GPIOB;
+#if defined GPIOC_BASE
+        case 2:
+            return GPIOC;
+#endif
+#if defined GPIOD_BASE
+        case 3:
+            return GPIOD;
+#endif
+#if defined GPIOE_BASE
+        case 4:
+            return GPIOE;
+#endif
+#if defined GPIOF_BASE
+        case 5:
+            return GPIOF;
+#endif
+#if defined GPIOG_BASE
+        case 6:
+            return GPIOG;
+#endif
+#if defined GPIOH_BASE
+        case 7:
+            return GPIOH;
+#endif
+#if defined GPIOI_BASE
+        case 8:
+            return GPIOI;
+#endif
+#if defined GPIOJ_BASE
+        case 9:
+            return GPIOJ;
+#endif
+#if defined GPIOK_BASE
+        case 10:
+            return GPIOK;
+#endif
+        default:
+            return GPIOA;
+    }
+}
+
+static inline void gpio_fast_write(PinName pin, int value)
+{
+    uint32_t mask = 1UL << STM_PIN(pin);
+    gpio_fast_port(pin)->BSRR = value ? mask : mask << 16;
+}
+
+static inline int gpio_fast_read(PinName pin)
+{
+    return (gpio_fast_port(pin)->IDR >> STM_PIN(pin)) & 1;
+}
+
+/* BSRR sets or resets the bit alone, so only a toggle of the same pin
+ * from an interrupt can be lost between the read and the write */
+static inline void gpio_fast_toggle(PinName pin)
+{
+    GPIO_TypeDef *port = gpio_fast_port(pin);
+    uint32_t mask = 1UL << STM_PIN(pin);
+    port->BSRR = (port->ODR & mask) ? mask << 16 : mask;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+/* mbed Microcontroller Library
+ * Copyright (c) 2017 ARM Limited
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sample_timer_api.h"
+
+#if DEVICE_SAMPLE_TIMER
+
+/* TIM7 is a basic timer without pins, the us ticker and PwmOut leave it
+ * alone. It runs from the APB1 timer clock. */
+static TIM_HandleTypeDef sample_timer_handle;
+
+IRQn_Type sample_timer_init(uint32_t hz)
+{
+    RCC_ClkInitTypeDef clk_init;
+    uint32_t flash_latency;
+    uint32_t clock;
+    uint32_t prescaler = 1;
+    uint32_t period;
+
+    HAL_RCC_GetClockConfig(&clk_init, &flash_latency);
+    clock = HAL_RCC_GetPCLK1Freq();
+    // TIMxCLK = PCLKx when the APB prescaler = 1 else TIMxCLK = 2 * PCLKx
+    if (clk_init.APB1CLKDivider != RCC_HCLK_DIV1) {
+        clock *= 2;
+    }
+
+    if (hz == 0) {
+        hz = 1;
+    }
+    period = clock / hz;
+    while (period / prescaler > 0x10000) {
+        prescaler++;
+    }
+
+    __HAL_RCC_TIM7_CLK_ENABLE();
+
+    sample_timer_handle.Instance = TIM7;
+    sample_timer_handle.Init.Prescaler = prescaler - 1;
+    sample_timer_handle.Init.Period = period / prescaler - 1;
+    sample_timer_handle.Init.ClockDivision = 0;
+    sample_timer_handle.Init.CounterMode = TIM_COUNTERMODE_UP;
+    HAL_TIM_Base_Init(&sample_timer_handle);
+
+    __HAL_TIM_CLEAR_FLAG(&sample_timer_handle, TIM_FLAG_UPDATE);
+    HAL_TIM_Base_Start_IT(&sample_timer_handle);
+
+    return TIM7_IRQn;
+}
+
+void sample_timer_clear(void)
+{
+    __HAL_TIM_CLEAR_FLAG(&sample_timer_handle, TIM_FLAG_UPDATE);
+}
+
+void sample_timer_free(void)
+{
+    HAL_TIM_Base_Stop_IT(&sample_timer_handle);
+    HAL_TIM_Base_DeInit(&sample_timer_handle);
+    __HAL_RCC_TIM7_CLK_DISABLE();
+}
+
+#endif
@@ -0,0 +1,128 @@
+/***************************************************************************//**
+ * @file crypto_api.c
+ *******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2017 Silicon Labs, http://www.silabs.com</b>
+ *******************************************************************************
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "device.h"
+#if DEVICE_CRYPTO_AES || DEVICE_CRYPTO_SHA1 || DEVICE_CRYPTO_SHA256
+
+#include <string.h>
+#include "crypto_api.h"
+#include "em_cmu.h"
+#include "em_crypto.h"
+
+static int crypto_inited = 0;
+
+static void crypto_init(void)
+{
+    if (!crypto_inited) {
+        CMU_ClockEnable(cmuClock_CRYPTO, true);
+        crypto_inited = 1;
+    }
+}
+
+#if DEVICE_CRYPTO_AES
+
+/* The CRYPTO takes the decryption key of AES decryptions, it is derived
+ * once when the key is set */
+int crypto_aes_setkey(uint32_t *rk, const uint8_t *key, unsigned keybits, int decrypt)
+{
+    if (keybits != 128 && keybits != 256) {
+        return -1;
+    }
+
+    crypto_init();
+
+    memcpy(rk, key, keybits / 8);
+    if (decrypt) {
+        if (keybits == 128) {
+            CRYPTO_AES_DecryptKey128((uint8_t *)rk, (uint8_t *)rk);
+        } else {
+            CRYPTO_AES_DecryptKey256((uint8_t *)rk, (uint8_t *)rk);
+        }
+    }
+    return 0;
+}
+
+void crypto_aes_crypt(const uint32_t *rk, unsigned keybits, int decrypt, uint32_t block[4])
+{
+    crypto_init();
+
+    if (keybits == 128) {
+        CRYPTO_AES_ECB128((uint8_t *)block, (uint8_t *)block, 16, (const uint8_t *)rk, !decrypt);
+    } else {
+        CRYPTO_AES_ECB256((uint8_t *)block, (uint8_t *)block, 16, (const uint8_t *)rk, !decrypt);
+    }
+}
+
+#endif
+
+#if DEVICE_CRYPTO_SHA1 || DEVICE_CRYPTO_SHA256
+
+/* Like CRYPTO_SHA_1 and CRYPTO_SHA_256, but for a single block on the
+ * given state. The state is loaded into DDATA1, which holds the result
+ * after the block, and read back from there in the same format. */
+static void crypto_sha_process(uint32_t ctrl, uint32_t *state, size_t words, const uint32_t block[16])
+{
+    CRYPTO_DData_TypeDef ddata = {0};
+
+    crypto_init();
+
+    CRYPTO->CTRL     = ctrl;
+    CRYPTO->SEQCTRL  = 0;
+    CRYPTO->SEQCTRLB = 0;
+    CRYPTO_ResultWidthSet(cryptoResult256Bits);
+
+    memcpy(ddata, state, words * sizeof(uint32_t));
+    CRYPTO_DDataWrite(cryptoRegDDATA1, ddata);
+    CRYPTO_EXECUTE_2(CRYPTO_CMD_INSTR_DDATA1TODDATA0,
+                     CRYPTO_CMD_INSTR_SELDDATA0DDATA1);
+
+    CRYPTO_QDataWrite(cryptoRegQDATA1BIG, (uint32_t *)block);
+    CRYPTO_EXECUTE_3(CRYPTO_CMD_INSTR_SHA,
+                     CRYPTO_CMD_INSTR_MADD32,
+                     CRYPTO_CMD_INSTR_DDATA0TODDATA1);
+
+    CRYPTO_DDataRead(cryptoRegDDATA1, ddata);
+    memcpy(state, ddata, words * sizeof(uint32_t));
+}
+
+#endif
+
+#if DEVICE_CRYPTO_SHA1
+
+void crypto_sha1_process(uint32_t state[5], const uint32_t block[16])
+{
+    crypto_sha_process(CRYPTO_CTRL_SHA_SHA1, state, 5, block);
+}
+
+#endif
+
+#if DEVICE_CRYPTO_SHA256
+
+void crypto_sha256_process(uint32_t state[8], const uint32_t block[16])
+{
+    crypto_sha_process(CRYPTO_CTRL_SHA_SHA2, state, 8, block);
+}
+
+#endif
+
+#endif
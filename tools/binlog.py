@@ -0,0 +1,320 @@
+#!/usr/bin/env python
+
+"""Decoder of the deferred binary log of mbed_binlog.h
+
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+The log is a stream of packets: the magic "MBLG", the 16 bit size of the
+records and the 16 bit number of records dropped before them, followed by
+the records, all little endian. A record is a 12 byte header of the type,
+the trace level, the record size, the time and the format string, followed
+by the arguments. The format strings and the constant strings the arguments
+point to are read from the ELF file of the firmware, the same build that
+wrote the log.
+
+Usage:
+    binlog.py capture.bin --elf BUILD/app.elf
+    binlog.py --port /dev/ttyACM0 --baud 115200 --elf BUILD/app.elf
+"""
+
+import re
+import sys
+import struct
+import argparse
+
+MAGIC = b'MBLG'
+PACKET = struct.Struct('<4sHH')
+HEADER = struct.Struct('<BBHII')
+
+TYPE_ID = 1
+TYPE_WORDS = 2
+TYPE_PRINTF = 3
+TYPE_TRACE = 4
+TRUNCATED = 0x80
+
+FORMAT_SECTION = '.mbed_binlog_fmt'
+
+LEVELS = {0x01: 'CMD ', 0x02: 'ERR ', 0x04: 'WARN', 0x08: 'INFO', 0x10: 'DBG '}
+
+CONVERSION = re.compile(
+    r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|q|z|t|L)?([diouxXeEfFgGaAcspn%])')
+
+SHF_ALLOC = 2
+SHT_NOBITS = 8
+
+
+class Elf(object):
+    """ Strings of the sections of a 32 bit little endian ELF file """
+
+    def __init__(self, path):
+        self.formats = None
+        self.sections = []
+        with open(path, 'rb') as elf:
+            data = elf.read()
+        if data[:4] != b'\x7fELF' or data[4:6] != b'\x01\x01':
+            raise ValueError('%s is not a 32 bit little endian ELF file' % path)
+        shoff, = struct.unpack_from('<I', data, 32)
+        shentsize, shnum, shstrndx = struct.unpack_from('<HHH', data, 46)
+        headers = [struct.unpack_from('<IIIIIIIIII', data, shoff + i * shentsize)
+                   for i in range(shnum)]
+        names = headers[shstrndx]
+        for name, kind, flags, addr, offset, size in \
+                (h[:6] for h in headers):
+            start = names[4] + name
+            section = data[start:data.index(b'\0', start)].decode()
+            contents = data[offset:offset + size] if kind != SHT_NOBITS else b''
+            if section == FORMAT_SECTION:
+                self.formats = contents
+            elif flags & SHF_ALLOC and contents:
+                self.sections.append((addr, contents))
+
+    @staticmethod
+    def _string(contents, offset):
+        end = contents.find(b'\0', offset)
+        if end < 0:
+            return None
+        return contents[offset:end].decode('utf-8', 'replace')
+
+    def format_string(self, offset):
+        """ String at an offset of the format section """
+        if self.formats is None or offset >= len(self.formats):
+            return None
+        return self._string(self.formats, offset)
+
+    def string(self, addr):
+        """ String at an address of the image """
+        for start, contents in self.sections:
+            if start <= addr < start + len(contents):
+                return self._string(contents, addr - start)
+        return None
+
+
+class Args(object):
+    """ Reader of the arguments of a record """
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def take(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise IndexError
+        value, = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return value
+
+    def string(self):
+        length = self.take('<B')
+        if self.pos + length > len(self.data):
+            raise IndexError
+        value = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return value.decode('utf-8', 'replace')
+
+
+def render(fmt, args, words, elf):
+    """ Format a message like printf, with the arguments of a record
+
+    With words, every argument is a 32 bit word and %s arguments are
+    addresses of strings of the image.
+    """
+    out = []
+    last = 0
+    for match in CONVERSION.finditer(fmt):
+        out.append(fmt[last:match.start()])
+        last = match.end()
+        flags, width, precision, length, conv = match.groups()
+        if conv == '%':
+            out.append('%')
+            continue
+        try:
+            if width == '*':
+                width = str(args.take('<i'))
+            if precision == '*':
+                precision = str(args.take('<i'))
+            spec = '%' + flags + (width or '') + \
+                   ('.' + precision if precision is not None else '')
+            wide = length in ('ll', 'j', 'q') and not words
+            if conv in 'di':
+                value = args.take('<q' if wide else '<i')
+                if length == 'hh':
+                    value = struct.unpack('<b', struct.pack('<B', value & 0xff))[0]
+                elif length == 'h':
+                    value = struct.unpack('<h', struct.pack('<H', value & 0xffff))[0]
+                out.append((spec + 'd') % value)
+            elif conv in 'ouxX':
+                value = args.take('<Q' if wide else '<I')
+                if length == 'hh':
+                    value &= 0xff
+                elif length == 'h':
+                    value &= 0xffff
+                out.append((spec + conv.replace('u', 'd')) % value)
+            elif conv == 'c':
+                out.append((spec + 'c') % chr(args.take('<I') & 0xff))
+            elif conv == 'p':
+                out.append('0x%x' % args.take('<I'))
+            elif conv == 's':
+                if words:
+                    addr = args.take('<I')
+                    value = elf.string(addr) if elf else None
+                    if value is None:
+                        value = '<0x%08x>' % addr
+                else:
+                    value = args.string()
+                out.append((spec + 's') % value)
+            elif conv == 'n':
+                pass
+            else:
+                value = args.take('<I') if words else args.take('<d')
+                if conv in 'aA':
+                    out.append(float(value).hex())
+                else:
+                    out.append((spec + conv) % value)
+        except IndexError:
+            out.append('<missing>')
+    out.append(fmt[last:])
+    return ''.join(out)
+
+
+def read_chunks(stream, size=4096):
+    while True:
+        data = stream.read(size)
+        if not data:
+            return
+        yield data
+
+
+def packets(chunks):
+    """ Yield the records and dropped counts of a byte stream
+
+    Yields ('record', header, args) and ('dropped', count) tuples.
+    """
+    buf = b''
+    for chunk in chunks:
+        buf += chunk
+        while True:
+            start = buf.find(MAGIC)
+            if start < 0:
+                # Keep what may be the start of a split magic
+                buf = buf[-(len(MAGIC) - 1):]
+                break
+            if len(buf) < start + PACKET.size:
+                buf = buf[start:]
+                break
+            _, size, dropped = PACKET.unpack_from(buf, start)
+            end = start + PACKET.size + size
+            if len(buf) < end:
+                buf = buf[start:]
+                break
+
+            if dropped:
+                yield ('dropped', dropped)
+            pos = start + PACKET.size
+            while pos + HEADER.size <= end:
+                header = HEADER.unpack_from(buf, pos)
+                rsize = header[2]
+                if rsize < HEADER.size or pos + rsize > end:
+                    sys.stderr.write('corrupt packet skipped\n')
+                    break
+                yield ('record', header, buf[pos + HEADER.size:pos + rsize])
+                pos += rsize
+            buf = buf[end:]
+
+
+def decode(events, elf, out):
+    """ Print the messages of the records """
+    last_time = None
+    epoch = 0
+    for event in events:
+        if event[0] == 'dropped':
+            out.write('--- %d messages dropped ---\n' % event[1])
+            continue
+        _, (rtype, level, _, time, fmt_id), data = event
+        # us_ticker_read wraps every 71 minutes
+        if last_time is not None and last_time - time > 1 << 31:
+            epoch += 1 << 32
+        last_time = time
+        stamp = '[%12.6f]' % ((epoch + time) / 1e6)
+
+        kind = rtype & ~TRUNCATED
+        args = Args(data)
+        if kind == TYPE_ID:
+            fmt = elf.format_string(fmt_id) if elf else None
+        else:
+            fmt = elf.string(fmt_id) if elf else None
+        prefix = ''
+        if kind == TYPE_TRACE:
+            try:
+                group_addr = args.take('<I')
+                group = elf.string(group_addr) if elf else None
+            except IndexError:
+                group = None
+            prefix = '[%s][%-4s]: ' % (LEVELS.get(level, '%02x' % level),
+                                       group or '?')
+        if fmt is None:
+            message = '<unknown format 0x%08x> %s' % (
+                fmt_id, ' '.join('%02x' % b for b in bytearray(data)))
+        else:
+            message = render(fmt, args, kind in (TYPE_ID, TYPE_WORDS), elf)
+        if rtype & TRUNCATED:
+            message += ' <truncated>'
+        text = (prefix + message).rstrip('\r\n')
+        for line in text.split('\n'):
+            out.write('%s %s\n' % (stamp, line.rstrip('\r')))
+
+
+def open_input(args):
+    if args.port:
+        import serial
+        port = serial.Serial(args.port, args.baud, timeout=1)
+
+        def serial_chunks():
+            # Until interrupted
+            try:
+                while True:
+                    data = port.read(port.in_waiting or 1)
+                    if data:
+                        yield data
+            except KeyboardInterrupt:
+                return
+        return serial_chunks()
+
+    if args.file == '-':
+        stream = getattr(sys.stdin, 'buffer', sys.stdin)
+        return read_chunks(stream)
+    return read_chunks(open(args.file, 'rb'))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode the deferred binary log of mbed_binlog.h')
+    parser.add_argument('file', nargs='?', default='-',
+                        help='captured log, - for stdin')
+    parser.add_argument('--elf', required=True,
+                        help='ELF file of the firmware that wrote the log')
+    parser.add_argument('--port', help='read the log from a serial port '
+                        'until interrupted, instead of file')
+    parser.add_argument('--baud', type=int, default=9600,
+                        help='baud rate of --port')
+    args = parser.parse_args()
+
+    elf = Elf(args.elf)
+    decode(packets(open_input(args)), elf, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,263 @@
+#!/usr/bin/env python
+
+"""Decoder of the binary memory trace of mbed_mem_trace_binary_start
+
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+The trace is a stream of packets: the magic "MTRK", the 16 bit number of
+records and the 16 bit number of records dropped before them, followed by
+the records of 16 bytes, all little endian. The stream is read from a file,
+from stdin with '-', or from a serial port with --port. Bytes up to the
+next magic are skipped, so a capture may start in the middle of a packet.
+
+Usage:
+    mem_trace.py capture.bin --elf BUILD/app.elf
+    mem_trace.py --port /dev/ttyACM0 --baud 115200 --report timeline > timeline.csv
+"""
+
+import sys
+import struct
+import argparse
+import subprocess
+from collections import defaultdict
+
+MAGIC = b'MTRK'
+HEADER = struct.Struct('<4sHH')
+RECORD = struct.Struct('<IIII')
+
+OPS = {0: 'malloc', 1: 'realloc', 2: 'calloc', 3: 'free'}
+OP_FREE = 3
+
+
+class Record(object):
+    """ One traced operation, with the time unwrapped to 64 bits """
+    __slots__ = ('time', 'op', 'ptr', 'size', 'caller')
+
+    def __init__(self, time, op, ptr, size, caller):
+        self.time = time
+        self.op = op
+        self.ptr = ptr
+        self.size = size
+        self.caller = caller
+
+
+def read_chunks(stream, size=4096):
+    while True:
+        data = stream.read(size)
+        if not data:
+            return
+        yield data
+
+
+def decode(chunks):
+    """ Yield the records and the dropped counts of a byte stream
+
+    Yields ('record', Record) and ('dropped', count) tuples in stream order.
+    """
+    buf = b''
+    last_time = None
+    epoch = 0
+    for chunk in chunks:
+        buf += chunk
+        while True:
+            start = buf.find(MAGIC)
+            if start < 0:
+                # Keep what may be the start of a split magic
+                buf = buf[-(len(MAGIC) - 1):]
+                break
+            if len(buf) < start + HEADER.size:
+                buf = buf[start:]
+                break
+            _, count, dropped = HEADER.unpack_from(buf, start)
+            end = start + HEADER.size + count * RECORD.size
+            if len(buf) < end:
+                buf = buf[start:]
+                break
+
+            if dropped:
+                yield ('dropped', dropped)
+            for i in range(count):
+                time, ptr, caller, size_op = RECORD.unpack_from(
+                    buf, start + HEADER.size + i * RECORD.size)
+                # us_ticker_read wraps every 71 minutes. Records of threads
+                # preempted while tracing may be a little out of order.
+                if last_time is not None and last_time - time > 1 << 31:
+                    epoch += 1 << 32
+                last_time = time
+                yield ('record', Record(epoch + time, size_op & 7, ptr,
+                                        size_op >> 3, caller))
+            buf = buf[end:]
+
+
+class Symbolizer(object):
+    """ Caller addresses to function names with addr2line """
+
+    def __init__(self, elf, addr2line):
+        self.elf = elf
+        self.addr2line = addr2line
+        self.names = {}
+
+    def resolve(self, addresses):
+        todo = sorted(set(a for a in addresses if a not in self.names))
+        if not self.elf or not todo:
+            return
+        # The return address is after the call, and bit 0 is set for Thumb
+        args = [self.addr2line, '-f', '-s', '-e', self.elf] + \
+               ['0x%x' % ((a & ~1) - 2) for a in todo]
+        try:
+            out = subprocess.check_output(args).decode().splitlines()
+        except (OSError, subprocess.CalledProcessError) as exc:
+            sys.stderr.write('addr2line failed: %s\n' % exc)
+            self.elf = None
+            return
+        for i, addr in enumerate(todo):
+            func, line = out[2 * i], out[2 * i + 1]
+            self.names[addr] = '%s (%s)' % (func, line)
+
+    def name(self, addr):
+        return self.names.get(addr, '')
+
+
+def leaks(events, symbolizer, out):
+    """ Print the blocks still allocated at the end, grouped by caller """
+    live = {}
+    allocs = frees = unknown_frees = dropped = failed = 0
+    live_bytes = peak_bytes = 0
+
+    for kind, value in events:
+        if kind == 'dropped':
+            dropped += value
+            continue
+        rec = value
+        if rec.op == OP_FREE:
+            if rec.ptr == 0:
+                continue
+            block = live.pop(rec.ptr, None)
+            if block is None:
+                unknown_frees += 1
+            else:
+                frees += 1
+                live_bytes -= block.size
+        elif rec.ptr == 0:
+            if rec.size != 0:
+                failed += 1
+        else:
+            allocs += 1
+            live[rec.ptr] = rec
+            live_bytes += rec.size
+            peak_bytes = max(peak_bytes, live_bytes)
+
+    by_caller = defaultdict(lambda: [0, 0])
+    for rec in live.values():
+        by_caller[rec.caller][0] += 1
+        by_caller[rec.caller][1] += rec.size
+    symbolizer.resolve(by_caller.keys())
+
+    out.write('allocations %d, frees %d, failed %d, peak %d bytes\n'
+              % (allocs, frees, failed, peak_bytes))
+    if dropped or unknown_frees:
+        out.write('%d records dropped, %d frees of unknown blocks, the '
+                  'report is incomplete\n' % (dropped, unknown_frees))
+    out.write('%d blocks of %d bytes still allocated\n'
+              % (len(live), live_bytes))
+    out.write('%10s %8s %10s  %s\n' % ('caller', 'blocks', 'bytes', 'function'))
+    for caller, (count, size) in sorted(by_caller.items(),
+                                        key=lambda item: -item[1][1]):
+        out.write('0x%08x %8d %10d  %s\n'
+                  % (caller, count, size, symbolizer.name(caller)))
+
+
+def timeline(events, symbolizer, out):
+    """ Print every operation as CSV, with the live heap after it """
+    live = {}
+    live_bytes = 0
+    rows = []
+
+    for kind, value in events:
+        if kind == 'dropped':
+            rows.append((None, value))
+            continue
+        rec = value
+        if rec.op == OP_FREE:
+            block = live.pop(rec.ptr, None)
+            if block is not None:
+                live_bytes -= block.size
+        elif rec.ptr != 0:
+            live[rec.ptr] = rec
+            live_bytes += rec.size
+        rows.append((rec, (live_bytes, len(live))))
+
+    symbolizer.resolve(rec.caller for rec, _ in rows if rec is not None)
+    out.write('time_us,op,ptr,size,caller,function,live_bytes,live_blocks\n')
+    for rec, extra in rows:
+        if rec is None:
+            out.write(',dropped,,%d,,,,\n' % extra)
+            continue
+        out.write('%d,%s,0x%08x,%d,0x%08x,"%s",%d,%d\n'
+                  % (rec.time, OPS.get(rec.op, rec.op), rec.ptr, rec.size,
+                     rec.caller, symbolizer.name(rec.caller),
+                     extra[0], extra[1]))
+
+
+def open_input(args):
+    if args.port:
+        import serial
+        port = serial.Serial(args.port, args.baud, timeout=1)
+
+        def serial_chunks():
+            # Until interrupted
+            try:
+                while True:
+                    data = port.read(port.in_waiting or 1)
+                    if data:
+                        yield data
+            except KeyboardInterrupt:
+                return
+        return serial_chunks()
+
+    if args.file == '-':
+        stream = getattr(sys.stdin, 'buffer', sys.stdin)
+        return read_chunks(stream)
+    return read_chunks(open(args.file, 'rb'))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Decode the binary mbed memory trace')
+    parser.add_argument('file', nargs='?', default='-',
+                        help='captured trace, - for stdin')
+    parser.add_argument('--report', default='leaks',
+                        choices=['leaks', 'timeline'],
+                        help='leak report or CSV timeline, default leaks')
+    parser.add_argument('--port', help='read the trace from a serial port '
+                        'until interrupted, instead of file')
+    parser.add_argument('--baud', type=int, default=9600,
+                        help='baud rate of --port')
+    parser.add_argument('--elf', help='ELF file to name the callers with')
+    parser.add_argument('--addr2line', default='arm-none-eabi-addr2line',
+                        help='addr2line of the toolchain')
+    args = parser.parse_args()
+
+    events = decode(open_input(args))
+    symbolizer = Symbolizer(args.elf, args.addr2line)
+    if args.report == 'leaks':
+        leaks(events, symbolizer, sys.stdout)
+    else:
+        timeline(events, symbolizer, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
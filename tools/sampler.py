@@ -0,0 +1,162 @@
+#!/usr/bin/env python
+
+"""Flat profile of the dump of mbed_sampler_dump
+
+mbed SDK
+Copyright (c) 2017 ARM Limited
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+The dump is read from a log of the serial console, lines without the
+"sampler:" tag are ignored. The last complete dump of the log is used,
+unless --all adds all of them up. The program counters are named with
+addr2line, and the samples are added up by function, or by source line
+with --lines.
+
+Usage:
+    sampler.py console.log --elf BUILD/app.elf
+    sampler.py console.log --elf BUILD/app.elf --threads --lines
+"""
+
+import re
+import sys
+import argparse
+import subprocess
+from collections import defaultdict
+
+BEGIN = re.compile(r'sampler: begin hz=(\d+) samples=(\d+) dropped=(\d+)')
+ENTRY = re.compile(r'sampler: ([0-9a-fA-F]{8}) ([0-9a-fA-F]{8}) (\d+)')
+END = re.compile(r'sampler: end')
+
+INTERRUPT = 0xffffffff
+
+
+class Dump(object):
+    """ One dump of the sample table """
+
+    def __init__(self, hz, samples, dropped):
+        self.hz = hz
+        self.samples = samples
+        self.dropped = dropped
+        self.entries = []
+
+
+def parse(lines):
+    """ Return the complete dumps of a log """
+    dumps = []
+    dump = None
+    for line in lines:
+        match = BEGIN.search(line)
+        if match:
+            dump = Dump(*[int(x) for x in match.groups()])
+            continue
+        if dump is None:
+            continue
+        match = ENTRY.search(line)
+        if match:
+            dump.entries.append((int(match.group(1), 16),
+                                 int(match.group(2), 16),
+                                 int(match.group(3))))
+        elif END.search(line):
+            dumps.append(dump)
+            dump = None
+    return dumps
+
+
+def symbolize(elf, addr2line, addresses):
+    """ Map each address to (function, file:line) """
+    names = {}
+    todo = sorted(set(addresses))
+    if elf and todo:
+        args = [addr2line, '-f', '-s', '-e', elf] + ['0x%x' % a for a in todo]
+        try:
+            out = subprocess.check_output(args).decode().splitlines()
+            for i, addr in enumerate(todo):
+                names[addr] = (out[2 * i], out[2 * i + 1])
+        except (OSError, subprocess.CalledProcessError) as exc:
+            sys.stderr.write('addr2line failed: %s\n' % exc)
+    for addr in todo:
+        if addr not in names:
+            names[addr] = ('0x%08x' % addr, '??:0')
+    return names
+
+
+def thread_name(thread):
+    if thread == INTERRUPT:
+        return 'interrupt'
+    if thread == 0:
+        return 'thread mode'
+    return 'thread 0x%08x' % thread
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Flat profile of the mbed sampling profiler')
+    parser.add_argument('file', nargs='?', default='-',
+                        help='console log with the dump, - for stdin')
+    parser.add_argument('--elf', help='ELF file of the firmware')
+    parser.add_argument('--addr2line', default='arm-none-eabi-addr2line',
+                        help='addr2line of the toolchain')
+    parser.add_argument('--all', action='store_true',
+                        help='add up all the dumps of the log')
+    parser.add_argument('--lines', action='store_true',
+                        help='profile source lines instead of functions')
+    parser.add_argument('--threads', action='store_true',
+                        help='profile each thread separately')
+    parser.add_argument('--limit', type=int, default=0,
+                        help='print only the first rows')
+    args = parser.parse_args()
+
+    stream = sys.stdin if args.file == '-' else open(args.file)
+    dumps = parse(stream)
+    if not dumps:
+        sys.stderr.write('no complete sampler dump found\n')
+        sys.exit(1)
+    if not args.all:
+        dumps = dumps[-1:]
+
+    samples = sum(d.samples for d in dumps)
+    dropped = sum(d.dropped for d in dumps)
+    names = symbolize(args.elf, args.addr2line,
+                      [pc for d in dumps for pc, _, _ in d.entries])
+
+    profile = defaultdict(int)
+    for dump in dumps:
+        for pc, thread, count in dump.entries:
+            func, line = names[pc]
+            key = '%s (%s)' % (func, line) if args.lines else func
+            if args.threads:
+                key = (thread_name(thread), key)
+            else:
+                key = ('', key)
+            profile[key] += count
+
+    print('%d samples at %d Hz, %d dropped'
+          % (samples, dumps[-1].hz, dropped))
+    print('%8s %7s  %s' % ('samples', '%', 'function'))
+    rows = sorted(profile.items(), key=lambda item: (item[0][0], -item[1]))
+    last_thread = None
+    printed = defaultdict(int)
+    for (thread, name), count in rows:
+        if args.threads and thread != last_thread:
+            thread_total = sum(c for (t, _), c in profile.items() if t == thread)
+            print('%s, %d samples' % (thread, thread_total))
+            last_thread = thread
+        if args.limit and printed[thread] >= args.limit:
+            continue
+        printed[thread] += 1
+        print('%8d %6.2f%%  %s' % (count, 100.0 * count / max(samples, 1), name))
+
+
+if __name__ == '__main__':
+    main()
@@ -405,6 +405,16 @@ TESTS = [
         "source_dir": join(BENCHMARKS_DIR, "all"),
         "dependencies": [MBED_LIBRARIES]
     },
+    {
+        "id": "BENCHMARK_6", "description": "DSP filters (cycles per sample)",
+        "source_dir": join(BENCHMARKS_DIR, "dsp_filters"),
+        "dependencies": [MBED_LIBRARIES, DSP_LIBRARIES]
+    },
+    {
+        "id": "BENCHMARK_7", "description": "DSP matrices (cycles per operation)",
+        "source_dir": join(BENCHMARKS_DIR, "dsp_matrix"),
+        "dependencies": [MBED_LIBRARIES, DSP_LIBRARIES]
+    },
 
     # performance related tests
     {
@@ -431,6 +441,14 @@ TESTS = [
         "duration": 15,
         "peripherals": ["SD"]
     },
+    {
+        "id": "PERF_4", "description": "SD Block Size R/W Speed",
+        "source_dir": join(TEST_DIR, "mbed", "sd_perf_blocks"),
+        "dependencies": [MBED_LIBRARIES, TEST_MBED_LIB, FS_LIBRARY],
+        "automated": True,
+        "duration": 60,
+        "peripherals": ["SD"]
+    },
 
 
     # Not automated MBED tests
@@ -1060,6 +1078,16 @@ TESTS = [
         "source_dir": join(TEST_DIR, "dsp", "mbed", "fir_f32"),
         "dependencies": [MBED_LIBRARIES, DSP_LIBRARIES],
     },
+    {
+        "id": "DSP_2", "description": "Spectrum",
+        "source_dir": join(TEST_DIR, "dsp", "mbed", "spectrum_f32"),
+        "dependencies": [MBED_LIBRARIES, DSP_LIBRARIES],
+    },
+    {
+        "id": "DSP_3", "description": "Matrix, vector and quaternion",
+        "source_dir": join(TEST_DIR, "dsp", "mbed", "matrix_f32"),
+        "dependencies": [MBED_LIBRARIES, DSP_LIBRARIES],
+    },
 
     # KL25Z
     {